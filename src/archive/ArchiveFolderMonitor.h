@@ -0,0 +1,47 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ArchiveFolderMonitor class watches the archive folder and
+/// invokes a handler when entries are added to, removed from or renamed in the
+/// folder.
+///
+/// ArchiveFolderMonitor uses a dispatch source of type
+/// DISPATCH_SOURCE_TYPE_VNODE on the folder, so it does not poll and it also
+/// notices changes that are made from outside the app, e.g. via the Files app.
+/// The file system only reports that the folder changed, not which entries
+/// changed, so the handler is responsible for determining the actual changes.
+///
+/// Because a single operation often causes several events (e.g. saving a game
+/// writes a temporary file and then moves it into the archive folder), events
+/// are coalesced: The handler is invoked once, a short time after the first
+/// event of a burst.
+///
+/// The handler is invoked on the main thread.
+// -----------------------------------------------------------------------------
+@interface ArchiveFolderMonitor : NSObject
+{
+}
+
+- (id) initWithFolder:(NSString*)folder changeHandler:(void (^)(void))changeHandler;
+- (void) startMonitoring;
+- (void) stopMonitoring;
+
+/// @brief The full path of the folder that is monitored.
+@property(nonatomic, retain, readonly) NSString* folder;
+
+@end
@@ -0,0 +1,154 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ArchiveFolderMonitor.h"
+
+// System includes
+#include <fcntl.h>
+#include <unistd.h>
+
+/// @brief The delay in seconds with which the change handler is invoked after
+/// the first event of a burst of events.
+static const NSTimeInterval coalescingDelay = 0.3;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for ArchiveFolderMonitor.
+// -----------------------------------------------------------------------------
+@interface ArchiveFolderMonitor()
+@property(nonatomic, retain, readwrite) NSString* folder;
+@property(nonatomic, copy) void (^changeHandler)(void);
+@property(nonatomic, retain) dispatch_source_t dispatchSource;
+/// @brief Is accessed only on the main thread.
+@property(nonatomic, assign) bool changeHandlerIsScheduled;
+@end
+
+
+@implementation ArchiveFolderMonitor
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes an ArchiveFolderMonitor object that invokes
+/// @a changeHandler when the folder @a folder changes. Monitoring does not
+/// begin until startMonitoring() is invoked.
+///
+/// @note This is the designated initializer of ArchiveFolderMonitor.
+// -----------------------------------------------------------------------------
+- (id) initWithFolder:(NSString*)folder changeHandler:(void (^)(void))changeHandler
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.folder = folder;
+  self.changeHandler = changeHandler;
+  self.dispatchSource = nil;
+  self.changeHandlerIsScheduled = false;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ArchiveFolderMonitor object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self stopMonitoring];
+  self.folder = nil;
+  self.changeHandler = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Begins monitoring the folder. Does nothing if monitoring is already
+/// in progress, or if the folder cannot be opened.
+// -----------------------------------------------------------------------------
+- (void) startMonitoring
+{
+  if (self.dispatchSource)
+    return;
+
+  // O_EVTONLY opens the folder only for receiving events, this does not
+  // prevent the volume from being unmounted
+  int fileDescriptor = open(self.folder.fileSystemRepresentation, O_EVTONLY);
+  if (fileDescriptor < 0)
+  {
+    DDLogError(@"%@: Failed to open folder %@ for monitoring, errno = %d", self, self.folder, errno);
+    return;
+  }
+
+  dispatch_source_t dispatchSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_VNODE,
+                                                            fileDescriptor,
+                                                            DISPATCH_VNODE_WRITE | DISPATCH_VNODE_DELETE | DISPATCH_VNODE_RENAME,
+                                                            dispatch_get_main_queue());
+  if (! dispatchSource)
+  {
+    DDLogError(@"%@: Failed to create dispatch source for folder %@", self, self.folder);
+    close(fileDescriptor);
+    return;
+  }
+
+  // The event handler runs on the main queue, and so does stopMonitoring(),
+  // so the source cannot be cancelled while the handler is running. The block
+  // must not retain self, otherwise self would never be deallocated.
+  __block ArchiveFolderMonitor* blockSelf = self;
+  dispatch_source_set_event_handler(dispatchSource, ^{
+    [blockSelf scheduleChangeHandler];
+  });
+  dispatch_source_set_cancel_handler(dispatchSource, ^{
+    close(fileDescriptor);
+  });
+
+  self.dispatchSource = dispatchSource;
+  dispatch_release(dispatchSource);
+  dispatch_resume(dispatchSource);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Ends monitoring the folder. Does nothing if monitoring is not in
+/// progress.
+// -----------------------------------------------------------------------------
+- (void) stopMonitoring
+{
+  if (! self.dispatchSource)
+    return;
+
+  dispatch_source_cancel(self.dispatchSource);
+  self.dispatchSource = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Schedules the change handler to be invoked after
+/// #coalescingDelay, unless it is already scheduled.
+// -----------------------------------------------------------------------------
+- (void) scheduleChangeHandler
+{
+  if (self.changeHandlerIsScheduled)
+    return;
+  self.changeHandlerIsScheduled = true;
+
+  // Retaining self keeps the object alive until the handler has run, even if
+  // the owner releases it in the meantime
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(coalescingDelay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+    self.changeHandlerIsScheduled = false;
+    if (self.dispatchSource && self.changeHandler)
+      self.changeHandler();
+  });
+}
+
+@end
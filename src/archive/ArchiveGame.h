@@ -29,7 +29,7 @@
 
 - (id) init;
 - (id) initWithFileName:(NSString*)aFileName fileAttributes:(NSDictionary*)fileAttributes;
-- (void) updateFileAttributes:(NSDictionary*)fileAttributes;
+- (bool) updateFileAttributes:(NSDictionary*)fileAttributes;
 - (NSComparisonResult) compare:(ArchiveGame*)aGame;
 
 /// @brief The name of the archived game. The value of this property should be
@@ -41,5 +41,16 @@
 @property(nonatomic, retain) NSString* fileDate;
 /// @brief The size of the .sgf file.
 @property(nonatomic, retain) NSString* fileSize;
+/// @brief The raw file modification date from which @e fileDate was generated.
+@property(nonatomic, retain, readonly) NSDate* fileModificationDate;
+/// @brief The messages (SGFCMessage objects) that were generated the last
+/// time the .sgf file was loaded, or nil if the file has not been loaded since
+/// it was last modified.
+///
+/// This is a memo of the outcome of the most recent load operation, it allows
+/// the archive view to show a load result indicator without having to parse
+/// the .sgf file again. The value is reset to nil by updateFileAttributes:()
+/// when the file modification date or the file size changes.
+@property(nonatomic, retain) NSArray* loadResultMessages;
 
 @end
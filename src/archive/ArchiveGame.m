@@ -19,6 +19,19 @@
 #import "ArchiveGame.h"
 
 
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for ArchiveGame.
+// -----------------------------------------------------------------------------
+@interface ArchiveGame()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, retain, readwrite) NSDate* fileModificationDate;
+//@}
+/// @brief The raw file size from which @e fileSize was generated.
+@property(nonatomic, assign) unsigned long long fileSizeInBytes;
+@end
+
+
 @implementation ArchiveGame
 
 // -----------------------------------------------------------------------------
@@ -53,6 +66,10 @@
   else
     self.fileName = aFileName;
 
+  self.fileModificationDate = nil;
+  self.fileSizeInBytes = 0;
+  self.loadResultMessages = nil;
+
   if (! fileAttributes)
   {
     self.fileDate = @"";
@@ -72,26 +89,54 @@
   self.fileName = nil;
   self.fileDate = nil;
   self.fileSize = nil;
+  self.fileModificationDate = nil;
+  self.loadResultMessages = nil;
   [super dealloc];
 }
 
 // -----------------------------------------------------------------------------
 /// @brief Updates the attributes of this ArchiveGame object with values from
 /// @a fileAttributes.
+///
+/// The display strings are regenerated only if the file modification date or
+/// the file size actually changed. ArchiveViewModel invokes this method for
+/// every game each time the archive content changes, but usually only one or
+/// two files have really changed. A change also discards the memoized load
+/// result messages.
+///
+/// Returns true if the attributes changed, false if they did not change.
 // -----------------------------------------------------------------------------
-- (void) updateFileAttributes:(NSDictionary*)fileAttributes
+- (bool) updateFileAttributes:(NSDictionary*)fileAttributes
 {
   NSDate* fileModificationDate = [fileAttributes fileModificationDate];
-  NSDateFormatter* dateFormatter = [[NSDateFormatter alloc] init];
-  [dateFormatter setLocale:[NSLocale currentLocale]];
-  [dateFormatter setTimeStyle:NSDateFormatterShortStyle];
-  [dateFormatter setDateStyle:NSDateFormatterShortStyle];
+  unsigned long long fileSizeInBytes = [fileAttributes fileSize];
+  if (self.fileModificationDate &&
+      [self.fileModificationDate isEqualToDate:fileModificationDate] &&
+      self.fileSizeInBytes == fileSizeInBytes)
+  {
+    return false;
+  }
+  self.fileModificationDate = fileModificationDate;
+  self.fileSizeInBytes = fileSizeInBytes;
+  // The file content has changed, the memoized load result no longer applies
+  self.loadResultMessages = nil;
+
+  // Creating an NSDateFormatter is expensive, so we create only one and reuse
+  // it for all ArchiveGame objects
+  static NSDateFormatter* dateFormatter = nil;
+  if (! dateFormatter)
+  {
+    dateFormatter = [[NSDateFormatter alloc] init];
+    [dateFormatter setLocale:[NSLocale currentLocale]];
+    [dateFormatter setTimeStyle:NSDateFormatterShortStyle];
+    [dateFormatter setDateStyle:NSDateFormatterShortStyle];
+  }
   self.fileDate = [dateFormatter stringFromDate:fileModificationDate];
-  [dateFormatter release];
 
-  unsigned long long fileSizeInBytes = [fileAttributes fileSize];
   float fileSizeInKB = fileSizeInBytes / 1024.0;
   self.fileSize = [NSString stringWithFormat:@"%0.1f", fileSizeInKB];
+
+  return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,43 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../go/GoBoardCore.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ArchiveGameReplay class replays the main variation of archived
+/// games on a GoBoardCore object, without loading the games into the Go
+/// model.
+///
+/// ArchiveGameReplay is used by clients that need the board positions of many
+/// archived games quickly, e.g. ArchiveGameThumbnailCache and
+/// ArchivePatternIndex. Clients read the .sgf file with SgfcKit themselves,
+/// then pass the move and setup properties of each node to
+/// replayProperty:onBoardCore:().
+///
+/// Because the interface uses C++ types, this header can only be imported by
+/// Objective-C++ implementation files. All methods are thread-safe.
+// -----------------------------------------------------------------------------
+@interface ArchiveGameReplay : NSObject
+{
+}
+
++ (enum GoBoardSize) boardSizeOfSgfGame:(SGFCGame*)sgfGame;
++ (void) replayProperty:(SGFCProperty*)sgfProperty onBoardCore:(GoBoardCore&)boardCore;
+
+@end
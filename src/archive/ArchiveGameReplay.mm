@@ -0,0 +1,109 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ArchiveGameReplay.h"
+#import "../go/GoVertex.h"
+#import "../sgf/SgfUtilities.h"
+
+
+@implementation ArchiveGameReplay
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board size of @a sgfGame. Returns #GoBoardSizeUndefined
+/// if @a sgfGame is not a game of Go, or if its board size is not supported.
+// -----------------------------------------------------------------------------
++ (enum GoBoardSize) boardSizeOfSgfGame:(SGFCGame*)sgfGame
+{
+  SGFCNode* sgfGameInfoNode = sgfGame.gameInfoNodes.firstObject;
+  if (! sgfGameInfoNode)
+    sgfGameInfoNode = sgfGame.rootNode;
+  SGFCGameInfo* sgfGameInfo = sgfGameInfoNode.gameInfo;
+  if (sgfGameInfo.gameType != SGFCGameTypeGo)
+    return GoBoardSizeUndefined;
+
+  return [SgfUtilities goBoardSizeForSgfBoardSize:sgfGameInfo.boardSize errorMessage:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Applies the move or setup property @a sgfProperty to @a boardCore.
+/// Ignores all other properties.
+///
+/// The replay does not check the game rules. A move that SgfcKit accepts is
+/// simply played with GoBoardCore::playStone().
+// -----------------------------------------------------------------------------
++ (void) replayProperty:(SGFCProperty*)sgfProperty onBoardCore:(GoBoardCore&)boardCore
+{
+  SGFCPropertyType propertyType = sgfProperty.propertyType;
+  if (propertyType == SGFCPropertyTypeB || propertyType == SGFCPropertyTypeW)
+  {
+    SGFCGoMove* sgfGoMove = sgfProperty.propertyValue.toSingleValue.toMoveValue.toGoMoveValue.goMove;
+    if (! sgfGoMove || sgfGoMove.isPassMove)
+      return;
+
+    int index = [ArchiveGameReplay indexOfSgfGoPoint:sgfGoMove.stone.location onBoardCore:boardCore];
+    if (index < 0)
+      return;
+
+    GoBoardCore::StoneState color = (propertyType == SGFCPropertyTypeB) ? GoBoardCore::StoneStateBlack : GoBoardCore::StoneStateWhite;
+    boardCore.playStone(index, color);
+  }
+  else if (propertyType == SGFCPropertyTypeAB || propertyType == SGFCPropertyTypeAW || propertyType == SGFCPropertyTypeAE)
+  {
+    GoBoardCore::StoneState stoneState;
+    if (propertyType == SGFCPropertyTypeAB)
+      stoneState = GoBoardCore::StoneStateBlack;
+    else if (propertyType == SGFCPropertyTypeAW)
+      stoneState = GoBoardCore::StoneStateWhite;
+    else
+      stoneState = GoBoardCore::StoneStateNone;
+
+    for (id<SGFCPropertyValue> sgfPropertyValue in sgfProperty.propertyValues)
+    {
+      SGFCGoPoint* sgfGoPoint;
+      if (propertyType == SGFCPropertyTypeAE)
+        sgfGoPoint = sgfPropertyValue.toSingleValue.toPointValue.toGoPointValue.goPoint;
+      else
+        sgfGoPoint = sgfPropertyValue.toSingleValue.toStoneValue.toGoStoneValue.goStone.location;
+
+      int index = [ArchiveGameReplay indexOfSgfGoPoint:sgfGoPoint onBoardCore:boardCore];
+      if (index >= 0)
+        boardCore.setStoneState(index, stoneState);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for replayProperty:onBoardCore:(). Returns the index
+/// of the intersection referred to by @a sgfGoPoint, or -1 if @a sgfGoPoint
+/// does not refer to an intersection on @a boardCore.
+// -----------------------------------------------------------------------------
++ (int) indexOfSgfGoPoint:(SGFCGoPoint*)sgfGoPoint onBoardCore:(const GoBoardCore&)boardCore
+{
+  if (! sgfGoPoint || ! [sgfGoPoint hasPositionInGoPointNotation:SGFCGoPointNotationHybrid])
+    return -1;
+
+  NSString* vertexString = [sgfGoPoint positionInGoPointNotation:SGFCGoPointNotationHybrid];
+  struct GoVertexNumeric numericVertex = [GoVertex vertexFromString:vertexString].numeric;
+  int boardSize = boardCore.getBoardSize();
+  if (numericVertex.x < 1 || numericVertex.x > boardSize || numericVertex.y < 1 || numericVertex.y > boardSize)
+    return -1;
+
+  return boardCore.getIndexOfVertex(numericVertex.x, numericVertex.y);
+}
+
+@end
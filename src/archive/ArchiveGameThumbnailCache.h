@@ -0,0 +1,49 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class ArchiveGame;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ArchiveGameThumbnailCache class provides small images that show
+/// the final board position of archived games. ArchiveViewController displays
+/// the images in the cells of its table view.
+///
+/// A thumbnail is generated without loading the game into the Go model. The
+/// .sgf file is read with SgfcKit, then the moves and setup properties of the
+/// main variation are replayed on a GoBoardCore object, and finally the
+/// resulting stones are drawn with Core Graphics. All of this happens on a
+/// background queue, so that the table view can scroll without interruption.
+///
+/// Generated thumbnails are stored as PNG files in a folder in the Caches
+/// directory (see PathUtilities::thumbnailCacheFolderPath()). A thumbnail file
+/// is reused for as long as it is newer than the .sgf file of the game, i.e.
+/// the thumbnail cache is keyed by the modification date of the .sgf file.
+/// Thumbnails that were recently used are also kept in memory.
+///
+/// ArchiveGameThumbnailCache must be used from the main thread only.
+// -----------------------------------------------------------------------------
+@interface ArchiveGameThumbnailCache : NSObject
+{
+}
+
+- (id) initWithArchiveFolder:(NSString*)archiveFolder;
+- (UIImage*) thumbnailForGame:(ArchiveGame*)game
+            completionHandler:(void (^)(void))completionHandler;
+
+@end
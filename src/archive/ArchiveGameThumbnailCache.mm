@@ -0,0 +1,377 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ArchiveGameThumbnailCache.h"
+#import "ArchiveGame.h"
+#import "ArchiveGameReplay.h"
+#import "../go/GoBoardCore.h"
+#import "../sgf/SgfFileCompression.h"
+#import "../shared/MemoryBudgetManager.h"
+#import "../utility/PathUtilities.h"
+
+
+// Constants
+static const CGFloat thumbnailSideLength = 40.0;
+static const NSUInteger thumbnailMemoryCacheCountLimit = 200;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// ArchiveGameThumbnailCache.
+// -----------------------------------------------------------------------------
+@interface ArchiveGameThumbnailCache() <MemoryBudgetClient>
+@property(nonatomic, retain) NSString* archiveFolder;
+@property(nonatomic, retain) NSString* thumbnailFolder;
+/// @brief The scale factor of the thumbnail images. This is obtained from
+/// UIScreen when ArchiveGameThumbnailCache is initialized, because UIScreen
+/// must not be used on the background queue.
+@property(nonatomic, assign) CGFloat thumbnailScale;
+/// @brief Keys are cache keys generated by cacheKeyForGame:(), values are
+/// either UIImage objects or NSNull if no thumbnail could be generated.
+@property(nonatomic, retain) NSCache* memoryCache;
+/// @brief The number of thumbnails that were stored in @e memoryCache since it
+/// was last emptied, but no more than the count limit of @e memoryCache. This
+/// is an upper bound because NSCache may evict thumbnails on its own.
+@property(nonatomic, assign) NSUInteger numberOfThumbnailsInMemoryCache;
+/// @brief Keys are cache keys of thumbnails that are currently being
+/// generated, values are NSMutableArray objects with the completion handlers
+/// to invoke when the thumbnail becomes available.
+@property(nonatomic, retain) NSMutableDictionary* pendingCompletionHandlers;
+@property(nonatomic, retain) NSOperationQueue* thumbnailQueue;
+@end
+
+
+@implementation ArchiveGameThumbnailCache
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes an ArchiveGameThumbnailCache object that generates
+/// thumbnails for the .sgf files located in @a archiveFolder.
+///
+/// @note This is the designated initializer of ArchiveGameThumbnailCache.
+// -----------------------------------------------------------------------------
+- (id) initWithArchiveFolder:(NSString*)archiveFolder
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.archiveFolder = archiveFolder;
+  self.thumbnailFolder = [PathUtilities thumbnailCacheFolderPath];
+  [PathUtilities createFolder:self.thumbnailFolder removeIfExists:false];
+  self.thumbnailScale = [UIScreen mainScreen].scale;
+  self.memoryCache = [[[NSCache alloc] init] autorelease];
+  self.memoryCache.countLimit = thumbnailMemoryCacheCountLimit;
+  self.numberOfThumbnailsInMemoryCache = 0;
+  self.pendingCompletionHandlers = [NSMutableDictionary dictionary];
+  self.thumbnailQueue = [[[NSOperationQueue alloc] init] autorelease];
+  // Thumbnails are generated one after the other, in the order in which table
+  // view cells request them
+  self.thumbnailQueue.maxConcurrentOperationCount = 1;
+  self.thumbnailQueue.qualityOfService = NSQualityOfServiceUtility;
+
+  [[MemoryBudgetManager sharedManager] registerClient:self withPriority:MemoryBudgetEvictionPriorityFirst];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ArchiveGameThumbnailCache
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [[MemoryBudgetManager sharedManager] unregisterClient:self];
+  self.archiveFolder = nil;
+  self.thumbnailFolder = nil;
+  self.memoryCache = nil;
+  self.pendingCompletionHandlers = nil;
+  [self.thumbnailQueue cancelAllOperations];
+  self.thumbnailQueue = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the thumbnail of @a game if it is available in memory.
+///
+/// If the thumbnail is not available in memory, this method returns @e nil
+/// and starts to generate the thumbnail (or to load it from the disk cache)
+/// on a background queue. When the thumbnail becomes available,
+/// @a completionHandler is invoked on the main thread. The client is then
+/// expected to invoke this method again to obtain the thumbnail.
+///
+/// If no thumbnail can be generated for @a game, e.g. because the .sgf file
+/// is not valid, this method returns @e nil and does not invoke
+/// @a completionHandler. This remains so until the .sgf file is modified.
+// -----------------------------------------------------------------------------
+- (UIImage*) thumbnailForGame:(ArchiveGame*)game
+            completionHandler:(void (^)(void))completionHandler
+{
+  NSString* cacheKey = [self cacheKeyForGame:game];
+  id cachedThumbnail = [self.memoryCache objectForKey:cacheKey];
+  if (cachedThumbnail)
+  {
+    if (cachedThumbnail == [NSNull null])
+      return nil;
+    else
+      return cachedThumbnail;
+  }
+
+  NSMutableArray* completionHandlers = [self.pendingCompletionHandlers objectForKey:cacheKey];
+  if (completionHandlers)
+  {
+    if (completionHandler)
+      [completionHandlers addObject:[[completionHandler copy] autorelease]];
+    return nil;
+  }
+
+  completionHandlers = [NSMutableArray array];
+  if (completionHandler)
+    [completionHandlers addObject:[[completionHandler copy] autorelease]];
+  [self.pendingCompletionHandlers setObject:completionHandlers forKey:cacheKey];
+
+  NSString* sgfFilePath = [self.archiveFolder stringByAppendingPathComponent:game.fileName];
+  NSString* thumbnailFilePath = [self.thumbnailFolder stringByAppendingPathComponent:[game.fileName stringByAppendingString:@".png"]];
+  NSDate* sgfFileModificationDate = game.fileModificationDate;
+  CGFloat thumbnailScale = self.thumbnailScale;
+
+  [self.thumbnailQueue addOperationWithBlock:^{
+    UIImage* thumbnail = [ArchiveGameThumbnailCache thumbnailFromFile:thumbnailFilePath
+                                                            orSgfFile:sgfFilePath
+                                              sgfFileModificationDate:sgfFileModificationDate
+                                                       thumbnailScale:thumbnailScale];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [self thumbnail:thumbnail didBecomeAvailableForCacheKey:cacheKey];
+    });
+  }];
+
+  return nil;
+}
+
+#pragma mark - MemoryBudgetClient overrides
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method. Returns an estimate of the number of bytes
+/// used by the thumbnails in the memory cache.
+// -----------------------------------------------------------------------------
+- (unsigned long long) evictableMemoryUsage
+{
+  // Assume 4 bytes per pixel
+  CGFloat thumbnailSideLengthInPixels = thumbnailSideLength * self.thumbnailScale;
+  unsigned long long numberOfBytesPerThumbnail = (unsigned long long)(thumbnailSideLengthInPixels * thumbnailSideLengthInPixels * 4);
+  return self.numberOfThumbnailsInMemoryCache * numberOfBytesPerThumbnail;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method. NSCache does not allow to remove the
+/// least recently used objects, so the memory cache is emptied entirely.
+/// Thumbnails can be loaded again cheaply from the disk cache.
+// -----------------------------------------------------------------------------
+- (void) reduceEvictableMemoryUsageTo:(unsigned long long)numberOfBytes
+{
+  if ([self evictableMemoryUsage] <= numberOfBytes)
+    return;
+
+  [self.memoryCache removeAllObjects];
+  self.numberOfThumbnailsInMemoryCache = 0;
+}
+
+#pragma mark - Private helpers - Main thread
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the key under which the thumbnail of @a game is cached in
+/// memory. The key changes when the .sgf file of @a game is modified.
+// -----------------------------------------------------------------------------
+- (NSString*) cacheKeyForGame:(ArchiveGame*)game
+{
+  return [NSString stringWithFormat:@"%@-%f", game.fileName, game.fileModificationDate.timeIntervalSinceReferenceDate];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked on the main thread when the background queue has finished
+/// generating or loading the thumbnail with key @a cacheKey. @a thumbnail is
+/// @e nil if no thumbnail could be generated.
+// -----------------------------------------------------------------------------
+- (void) thumbnail:(UIImage*)thumbnail didBecomeAvailableForCacheKey:(NSString*)cacheKey
+{
+  if (thumbnail)
+  {
+    [self.memoryCache setObject:thumbnail forKey:cacheKey];
+    if (self.numberOfThumbnailsInMemoryCache < thumbnailMemoryCacheCountLimit)
+      self.numberOfThumbnailsInMemoryCache++;
+  }
+  else
+    [self.memoryCache setObject:[NSNull null] forKey:cacheKey];
+
+  NSArray* completionHandlers = [[[self.pendingCompletionHandlers objectForKey:cacheKey] retain] autorelease];
+  [self.pendingCompletionHandlers removeObjectForKey:cacheKey];
+
+  if (! thumbnail)
+    return;
+
+  for (void (^completionHandler)(void) in completionHandlers)
+    completionHandler();
+}
+
+#pragma mark - Private helpers - Background queue
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the thumbnail stored in @a thumbnailFilePath if the file is
+/// not older than @a sgfFileModificationDate. Otherwise generates a new
+/// thumbnail from the .sgf file @a sgfFilePath and stores it in
+/// @a thumbnailFilePath. Returns @e nil if no thumbnail could be generated.
+///
+/// This method is invoked on the background queue.
+// -----------------------------------------------------------------------------
++ (UIImage*) thumbnailFromFile:(NSString*)thumbnailFilePath
+                     orSgfFile:(NSString*)sgfFilePath
+       sgfFileModificationDate:(NSDate*)sgfFileModificationDate
+                thumbnailScale:(CGFloat)thumbnailScale
+{
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSDictionary* thumbnailFileAttributes = [fileManager attributesOfItemAtPath:thumbnailFilePath error:nil];
+  if (thumbnailFileAttributes &&
+      sgfFileModificationDate &&
+      [[thumbnailFileAttributes fileModificationDate] compare:sgfFileModificationDate] != NSOrderedAscending)
+  {
+    NSData* thumbnailData = [NSData dataWithContentsOfFile:thumbnailFilePath];
+    UIImage* thumbnail = [UIImage imageWithData:thumbnailData scale:thumbnailScale];
+    if (thumbnail)
+      return thumbnail;
+  }
+
+  UIImage* thumbnail = nil;
+  @try
+  {
+    thumbnail = [ArchiveGameThumbnailCache thumbnailForSgfFile:sgfFilePath thumbnailScale:thumbnailScale];
+  }
+  @catch (NSException* exception)
+  {
+    DDLogError(@"%@: Exception while generating thumbnail for %@: %@", self, sgfFilePath, exception);
+  }
+
+  if (thumbnail)
+    [UIImagePNGRepresentation(thumbnail) writeToFile:thumbnailFilePath atomically:YES];
+
+  return thumbnail;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reads the .sgf file @a sgfFilePath, replays the main variation of
+/// the first game in the file, and returns a thumbnail of the resulting board
+/// position. Returns @e nil if the file does not contain a Go game with a
+/// supported board size.
+///
+/// See ArchiveGameReplay for details how the game is replayed.
+// -----------------------------------------------------------------------------
++ (UIImage*) thumbnailForSgfFile:(NSString*)sgfFilePath thumbnailScale:(CGFloat)thumbnailScale
+{
+  SGFCDocumentReader* documentReader = [SGFCDocumentReader documentReader];
+  // Warnings are irrelevant for a thumbnail
+  [documentReader.arguments addArgumentWithType:SGFCArgumentTypeDisableWarningMessages];
+  SGFCDocumentReadResult* readResult = [SgfFileCompression readSgfFile:sgfFilePath withDocumentReader:documentReader];
+  if (! readResult.isSgfDataValid)
+    return nil;
+
+  SGFCGame* sgfGame = readResult.document.games.firstObject;
+  if (! sgfGame || ! sgfGame.hasRootNode)
+    return nil;
+
+  enum GoBoardSize boardSize = [ArchiveGameReplay boardSizeOfSgfGame:sgfGame];
+  if (boardSize == GoBoardSizeUndefined)
+    return nil;
+
+  GoBoardCore boardCore(boardSize);
+  for (SGFCNode* sgfNode = sgfGame.rootNode; sgfNode; sgfNode = sgfNode.firstChild)
+  {
+    for (SGFCProperty* sgfProperty in sgfNode.properties)
+      [ArchiveGameReplay replayProperty:sgfProperty onBoardCore:boardCore];
+  }
+
+  return [ArchiveGameThumbnailCache thumbnailForBoardCore:boardCore thumbnailScale:thumbnailScale];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for thumbnailForSgfFile:thumbnailScale:(). Draws the
+/// grid and the stones of @a boardCore into a new image.
+// -----------------------------------------------------------------------------
++ (UIImage*) thumbnailForBoardCore:(const GoBoardCore&)boardCore thumbnailScale:(CGFloat)thumbnailScale
+{
+  const GoBoardCore* boardCorePointer = &boardCore;
+  int boardSize = boardCore.getBoardSize();
+  CGFloat pointDistance = thumbnailSideLength / boardSize;
+
+  UIGraphicsImageRendererFormat* format = [[[UIGraphicsImageRendererFormat alloc] init] autorelease];
+  format.scale = thumbnailScale;
+  format.opaque = YES;
+  UIGraphicsImageRenderer* renderer = [[[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(thumbnailSideLength, thumbnailSideLength)
+                                                                              format:format] autorelease];
+
+  return [renderer imageWithActions:^(UIGraphicsImageRendererContext* rendererContext)
+  {
+    CGContextRef context = rendererContext.CGContext;
+
+    CGContextSetFillColorWithColor(context, [UIColor colorWithRed:0.86 green:0.70 blue:0.45 alpha:1.0].CGColor);
+    CGContextFillRect(context, CGRectMake(0, 0, thumbnailSideLength, thumbnailSideLength));
+
+    CGFloat firstLineCoordinate = pointDistance / 2.0;
+    CGFloat lastLineCoordinate = thumbnailSideLength - (pointDistance / 2.0);
+    for (int lineIndex = 0; lineIndex < boardSize; ++lineIndex)
+    {
+      CGFloat lineCoordinate = firstLineCoordinate + (lineIndex * pointDistance);
+      CGContextMoveToPoint(context, firstLineCoordinate, lineCoordinate);
+      CGContextAddLineToPoint(context, lastLineCoordinate, lineCoordinate);
+      CGContextMoveToPoint(context, lineCoordinate, firstLineCoordinate);
+      CGContextAddLineToPoint(context, lineCoordinate, lastLineCoordinate);
+    }
+    CGContextSetStrokeColorWithColor(context, [UIColor colorWithWhite:0.0 alpha:0.5].CGColor);
+    CGContextSetLineWidth(context, 1.0 / thumbnailScale);
+    CGContextStrokePath(context);
+
+    for (int y = 1; y <= boardSize; ++y)
+    {
+      for (int x = 1; x <= boardSize; ++x)
+      {
+        GoBoardCore::StoneState stoneState = boardCorePointer->getStoneState(boardCorePointer->getIndexOfVertex(x, y));
+        if (stoneState == GoBoardCore::StoneStateNone)
+          continue;
+
+        // Vertex y = 1 is the bottom row of the board
+        CGRect stoneRect = CGRectMake((x - 1) * pointDistance, (boardSize - y) * pointDistance, pointDistance, pointDistance);
+        if (stoneState == GoBoardCore::StoneStateBlack)
+        {
+          CGContextSetFillColorWithColor(context, [UIColor blackColor].CGColor);
+          CGContextFillEllipseInRect(context, stoneRect);
+        }
+        else
+        {
+          CGContextSetFillColorWithColor(context, [UIColor whiteColor].CGColor);
+          CGContextFillEllipseInRect(context, stoneRect);
+          CGContextSetStrokeColorWithColor(context, [UIColor darkGrayColor].CGColor);
+          CGContextStrokeEllipseInRect(context, stoneRect);
+        }
+      }
+    }
+  }];
+}
+
+@end
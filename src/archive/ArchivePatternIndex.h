@@ -0,0 +1,82 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ArchivePatternIndex class searches the games in the archive for
+/// local patterns, e.g. joseki or fuseki patterns.
+///
+/// A pattern is specified as an array of strings, one string per row of the
+/// pattern, starting with the top row. Each character in a row is one cell of
+/// the pattern:
+/// - "X" requires a black stone
+/// - "O" requires a white stone
+/// - "." requires an empty intersection
+/// - "?" is a wildcard that accepts any intersection
+///
+/// A first or last row consisting only of "-" and "+" characters, and a first
+/// or last column consisting only of "|" and "+" characters, require that the
+/// corresponding side of the pattern lies on the edge of the board. Space
+/// characters are ignored. Example for a corner pattern that finds a black
+/// stone on the 3-4 point, approached by White on the 5-3 point:
+/// @verbatim
+/// |.......
+/// |.......
+/// |..X....
+/// |....O..
+/// |.......
+/// |.......
+/// +-------
+/// @endverbatim
+///
+/// A pattern matches in all 8 orientations that result from rotating and
+/// reflecting the pattern. Optionally a pattern also matches with black and
+/// white swapped. The search covers every board position in the main
+/// variation of every game in every .sgf file in the archive, and reports for
+/// each game the first board position in which the pattern matches.
+///
+/// To make searches fast, ArchivePatternIndex maintains an index of the
+/// archive. The index contains a compact game record for every game, i.e. the
+/// sequence of stone changes that leads from one board position to the next,
+/// with captures already resolved (see GoPatternMatcher). Building the index
+/// entry of an .sgf file requires reading the file with SgfcKit, which is by
+/// far the most expensive part of a search. The index entry is therefore
+/// stored in a file in the Caches directory (see
+/// PathUtilities::patternIndexFolderPath()) and reused for as long as it is
+/// newer than the .sgf file, in the same way as ArchiveGameThumbnailCache
+/// reuses thumbnails. The search itself replays the game records in parallel
+/// on all CPU cores.
+///
+/// ArchivePatternIndex is not thread-safe. It does not access UIKit and can be
+/// used on a secondary thread.
+// -----------------------------------------------------------------------------
+@interface ArchivePatternIndex : NSObject
+{
+}
+
++ (bool) isValidPattern:(NSArray*)patternRows errorMessage:(NSString**)errorMessage;
+
+- (id) initWithArchiveFolder:(NSString*)archiveFolder;
+- (void) updateWithProgressHandler:(void (^)(int numberOfFilesUpdated, int numberOfFiles))progressHandler;
+- (NSArray*) searchPattern:(NSArray*)patternRows matchSwappedColors:(bool)matchSwappedColors;
+
+/// @brief The folder that contains the .sgf files to search.
+@property(nonatomic, retain, readonly) NSString* archiveFolder;
+/// @brief The number of games in the index. Is 0 until
+/// updateWithProgressHandler:() has been invoked.
+@property(nonatomic, assign, readonly) int numberOfGames;
+
+@end
@@ -0,0 +1,548 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ArchivePatternIndex.h"
+#import "ArchiveGameReplay.h"
+#import "../go/GoPatternMatcher.h"
+#import "../sgf/SgfFileCompression.h"
+#import "../utility/PathUtilities.h"
+
+// C++ standard library
+#include <memory>
+#include <utility>  // for std::pair
+#include <vector>
+
+
+/// @brief The version of the format of index files. Must be incremented every
+/// time the format changes, so that index files that were written by an
+/// earlier version of the app are rebuilt.
+static const unsigned short indexFileFormatVersion = 1;
+/// @brief The number of values in the header of an index file.
+static const int indexFileHeaderLength = 2;
+/// @brief The number of values in the header of a game in an index file.
+static const int indexFileGameHeaderLength = 4;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for ArchivePatternIndex.
+// -----------------------------------------------------------------------------
+@interface ArchivePatternIndex()
+@property(nonatomic, retain, readwrite) NSString* archiveFolder;
+@property(nonatomic, assign, readwrite) int numberOfGames;
+@property(nonatomic, retain) NSString* indexFolder;
+/// @brief Keys are the names of the .sgf files in the archive, values are
+/// NSData objects with the index entries of the files.
+@property(nonatomic, retain) NSMutableDictionary* indexEntries;
+@end
+
+
+@implementation ArchivePatternIndex
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes an ArchivePatternIndex object that searches the .sgf
+/// files located in @a archiveFolder.
+///
+/// @note This is the designated initializer of ArchivePatternIndex.
+// -----------------------------------------------------------------------------
+- (id) initWithArchiveFolder:(NSString*)archiveFolder
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.archiveFolder = archiveFolder;
+  self.numberOfGames = 0;
+  self.indexFolder = [PathUtilities patternIndexFolderPath];
+  [PathUtilities createFolder:self.indexFolder removeIfExists:false];
+  self.indexEntries = [NSMutableDictionary dictionary];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ArchivePatternIndex object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.archiveFolder = nil;
+  self.indexFolder = nil;
+  self.indexEntries = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a patternRows is a valid pattern. Returns false if
+/// @a patternRows is not a valid pattern, in which case the out parameter
+/// @a errorMessage is filled with a description of the problem.
+// -----------------------------------------------------------------------------
++ (bool) isValidPattern:(NSArray*)patternRows errorMessage:(NSString**)errorMessage
+{
+  int patternWidth;
+  int patternHeight;
+  std::vector<GoPatternMatcher::PatternCell> patternCells;
+  int patternEdges;
+  return [ArchivePatternIndex parsePatternRows:patternRows
+                                  patternWidth:&patternWidth
+                                 patternHeight:&patternHeight
+                                  patternCells:patternCells
+                                  patternEdges:&patternEdges
+                                  errorMessage:errorMessage];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Brings the index up-to-date with the .sgf files that are currently
+/// in the archive folder. Index entries of .sgf files that are new or that
+/// have been modified are rebuilt, the index entries of all other files are
+/// loaded from the index folder. Index entries of files that no longer exist
+/// are discarded.
+///
+/// @a progressHandler is invoked after each .sgf file. It may be nil.
+// -----------------------------------------------------------------------------
+- (void) updateWithProgressHandler:(void (^)(int numberOfFilesUpdated, int numberOfFiles))progressHandler
+{
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSMutableArray* sgfFileNames = [NSMutableArray array];
+  for (NSString* fileName in [fileManager contentsOfDirectoryAtPath:self.archiveFolder error:nil])
+  {
+    if ([fileName.pathExtension caseInsensitiveCompare:@"sgf"] == NSOrderedSame)
+      [sgfFileNames addObject:fileName];
+  }
+
+  NSMutableDictionary* indexEntries = [NSMutableDictionary dictionaryWithCapacity:sgfFileNames.count];
+  int numberOfGames = 0;
+  int numberOfFiles = (int)sgfFileNames.count;
+  int numberOfFilesUpdated = 0;
+  for (NSString* sgfFileName in sgfFileNames)
+  {
+    @autoreleasepool
+    {
+      NSData* indexEntry = [self indexEntryForSgfFileName:sgfFileName];
+      if (indexEntry)
+      {
+        indexEntries[sgfFileName] = indexEntry;
+        numberOfGames += [ArchivePatternIndex numberOfGamesInIndexEntry:indexEntry];
+      }
+    }
+
+    ++numberOfFilesUpdated;
+    if (progressHandler)
+      progressHandler(numberOfFilesUpdated, numberOfFiles);
+  }
+
+  self.indexEntries = indexEntries;
+  self.numberOfGames = numberOfGames;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Searches all games in the index for the pattern @a patternRows and
+/// returns an array with one NSDictionary object for each game in which the
+/// pattern matches. If @a matchSwappedColors is true the pattern also matches
+/// with black and white swapped. Returns nil if @a patternRows is not a valid
+/// pattern (see isValidPattern:errorMessage:()).
+///
+/// The dictionaries in the returned array have these keys:
+/// - "fileName": The name of the .sgf file (NSString)
+/// - "gameNumber": The number of the game in the .sgf file, starting with 1
+///   (NSNumber)
+/// - "boardPosition": The first board position in the main variation of the
+///   game in which the pattern matches. 0 is the board position that contains
+///   the handicap and setup stones of the game's root node (NSNumber)
+///
+/// The array is sorted by file name and game number.
+///
+/// The search only covers the games that were in the archive when
+/// updateWithProgressHandler:() was last invoked.
+// -----------------------------------------------------------------------------
+- (NSArray*) searchPattern:(NSArray*)patternRows matchSwappedColors:(bool)matchSwappedColors
+{
+  int patternWidth;
+  int patternHeight;
+  std::vector<GoPatternMatcher::PatternCell> patternCells;
+  int patternEdges;
+  bool isValidPattern = [ArchivePatternIndex parsePatternRows:patternRows
+                                                 patternWidth:&patternWidth
+                                                patternHeight:&patternHeight
+                                                 patternCells:patternCells
+                                                 patternEdges:&patternEdges
+                                                 errorMessage:nil];
+  if (! isValidPattern)
+    return nil;
+
+  // One matcher per board size. The matchers are immutable and are shared by
+  // all threads.
+  std::vector<std::unique_ptr<GoPatternMatcher>> patternMatchers(GoBoardSizeMax + 1);
+  for (int boardSize = GoBoardSizeMin; boardSize <= GoBoardSizeMax; boardSize += 2)
+  {
+    patternMatchers[boardSize].reset(new GoPatternMatcher(boardSize,
+                                                          patternWidth,
+                                                          patternHeight,
+                                                          patternCells,
+                                                          patternEdges,
+                                                          matchSwappedColors));
+  }
+
+  NSArray* sgfFileNames = [self.indexEntries.allKeys sortedArrayUsingSelector:@selector(compare:)];
+  NSUInteger numberOfFiles = sgfFileNames.count;
+  // Each iteration of the concurrent loop writes only to its own element, so
+  // no synchronization is required. The elements are pairs of game number and
+  // board position.
+  std::vector<std::vector<std::pair<int, int>>> matchesPerFile(numberOfFiles);
+  NSDictionary* indexEntries = self.indexEntries;
+  dispatch_apply(numberOfFiles, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t indexOfFile)
+  {
+    NSData* indexEntry = indexEntries[sgfFileNames[indexOfFile]];
+    [ArchivePatternIndex searchIndexEntry:indexEntry
+                      withPatternMatchers:patternMatchers
+                                  matches:matchesPerFile[indexOfFile]];
+  });
+
+  NSMutableArray* searchResults = [NSMutableArray array];
+  for (NSUInteger indexOfFile = 0; indexOfFile < numberOfFiles; ++indexOfFile)
+  {
+    for (const std::pair<int, int>& match : matchesPerFile[indexOfFile])
+    {
+      [searchResults addObject:@{@"fileName" : sgfFileNames[indexOfFile],
+                                 @"gameNumber" : [NSNumber numberWithInt:match.first],
+                                 @"boardPosition" : [NSNumber numberWithInt:match.second]}];
+    }
+  }
+
+  return searchResults;
+}
+
+#pragma mark - Private helpers - Index entries
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index entry for the .sgf file @a sgfFileName. The index
+/// entry is loaded from the index folder if the index file is not older than
+/// the .sgf file, otherwise it is built from the .sgf file and stored in the
+/// index folder. Returns nil if the .sgf file cannot be read.
+// -----------------------------------------------------------------------------
+- (NSData*) indexEntryForSgfFileName:(NSString*)sgfFileName
+{
+  NSString* sgfFilePath = [self.archiveFolder stringByAppendingPathComponent:sgfFileName];
+  NSString* indexFilePath = [self.indexFolder stringByAppendingPathComponent:[sgfFileName stringByAppendingPathExtension:@"index"]];
+
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSDate* sgfFileModificationDate = [[fileManager attributesOfItemAtPath:sgfFilePath error:nil] fileModificationDate];
+  NSDate* indexFileModificationDate = [[fileManager attributesOfItemAtPath:indexFilePath error:nil] fileModificationDate];
+  if (sgfFileModificationDate &&
+      indexFileModificationDate &&
+      [indexFileModificationDate compare:sgfFileModificationDate] != NSOrderedAscending)
+  {
+    NSData* indexEntry = [NSData dataWithContentsOfFile:indexFilePath];
+    if ([ArchivePatternIndex isValidIndexEntry:indexEntry])
+      return indexEntry;
+  }
+
+  NSData* indexEntry = nil;
+  @try
+  {
+    indexEntry = [ArchivePatternIndex indexEntryForSgfFile:sgfFilePath];
+  }
+  @catch (NSException* exception)
+  {
+    DDLogError(@"%@: Exception while indexing %@: %@", self, sgfFilePath, exception);
+  }
+
+  if (indexEntry)
+    [indexEntry writeToFile:indexFilePath atomically:YES];
+
+  return indexEntry;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reads the .sgf file @a sgfFilePath and returns a new index entry
+/// for it. Returns nil if the file cannot be read.
+///
+/// An index entry is a sequence of 16-bit values. The header consists of the
+/// format version and the number of games. It is followed by the games, each
+/// of which starts with a header that consists of the game number, the board
+/// size, and the low and high 16 bits of the number of values in the game
+/// record. The game record follows the header, its format is defined by
+/// GoPatternMatcher. Games that are not games of Go, or whose board size is
+/// not supported, are not in the index entry.
+// -----------------------------------------------------------------------------
++ (NSData*) indexEntryForSgfFile:(NSString*)sgfFilePath
+{
+  SGFCDocumentReader* documentReader = [SGFCDocumentReader documentReader];
+  // Warnings are irrelevant for the index
+  [documentReader.arguments addArgumentWithType:SGFCArgumentTypeDisableWarningMessages];
+  SGFCDocumentReadResult* readResult = [SgfFileCompression readSgfFile:sgfFilePath withDocumentReader:documentReader];
+  if (! readResult.isSgfDataValid)
+    return nil;
+
+  std::vector<unsigned short> indexEntry(indexFileHeaderLength, 0);
+  indexEntry[0] = indexFileFormatVersion;
+  int gameNumber = 0;
+  for (SGFCGame* sgfGame in readResult.document.games)
+  {
+    ++gameNumber;
+    if (! sgfGame.hasRootNode)
+      continue;
+    enum GoBoardSize boardSize = [ArchiveGameReplay boardSizeOfSgfGame:sgfGame];
+    if (boardSize == GoBoardSizeUndefined)
+      continue;
+
+    size_t indexOfGameHeader = indexEntry.size();
+    indexEntry.resize(indexOfGameHeader + indexFileGameHeaderLength);
+    [ArchivePatternIndex appendGameRecordForSgfGame:sgfGame boardSize:boardSize toIndexEntry:indexEntry];
+
+    size_t gameRecordLength = indexEntry.size() - indexOfGameHeader - indexFileGameHeaderLength;
+    indexEntry[indexOfGameHeader] = static_cast<unsigned short>(gameNumber);
+    indexEntry[indexOfGameHeader + 1] = static_cast<unsigned short>(boardSize);
+    indexEntry[indexOfGameHeader + 2] = static_cast<unsigned short>(gameRecordLength & 0xFFFF);
+    indexEntry[indexOfGameHeader + 3] = static_cast<unsigned short>(gameRecordLength >> 16);
+    indexEntry[1]++;
+  }
+
+  return [NSData dataWithBytes:indexEntry.data() length:indexEntry.size() * sizeof(unsigned short)];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Replays the main variation of @a sgfGame and appends the resulting
+/// game record to @a indexEntry. The game record contains one board position
+/// per node.
+// -----------------------------------------------------------------------------
++ (void) appendGameRecordForSgfGame:(SGFCGame*)sgfGame
+                          boardSize:(enum GoBoardSize)boardSize
+                       toIndexEntry:(std::vector<unsigned short>&)indexEntry
+{
+  GoBoardCore boardCore(boardSize);
+  int numberOfPoints = boardCore.getNumberOfPoints();
+  std::vector<GoBoardCore::StoneState> previousStoneStates(numberOfPoints, GoBoardCore::StoneStateNone);
+
+  for (SGFCNode* sgfNode = sgfGame.rootNode; sgfNode; sgfNode = sgfNode.firstChild)
+  {
+    for (SGFCProperty* sgfProperty in sgfNode.properties)
+      [ArchiveGameReplay replayProperty:sgfProperty onBoardCore:boardCore];
+
+    // Comparing the entire board catches captures and setup without having to
+    // track them individually
+    for (int index = 0; index < numberOfPoints; ++index)
+    {
+      GoBoardCore::StoneState stoneState = boardCore.getStoneState(index);
+      if (stoneState == previousStoneStates[index])
+        continue;
+      indexEntry.push_back(GoPatternMatcher::getGameRecordEntry(index, stoneState));
+      previousStoneStates[index] = stoneState;
+    }
+    indexEntry.push_back(GoPatternMatcher::endOfBoardPosition);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a indexEntry has the current format version and
+/// its structure is consistent.
+// -----------------------------------------------------------------------------
++ (bool) isValidIndexEntry:(NSData*)indexEntry
+{
+  if (indexEntry.length < indexFileHeaderLength * sizeof(unsigned short))
+    return false;
+
+  const unsigned short* values = static_cast<const unsigned short*>(indexEntry.bytes);
+  if (values[0] != indexFileFormatVersion)
+    return false;
+
+  size_t numberOfValues = indexEntry.length / sizeof(unsigned short);
+  size_t indexOfValue = indexFileHeaderLength;
+  for (int indexOfGame = 0; indexOfGame < values[1]; ++indexOfGame)
+  {
+    if (indexOfValue + indexFileGameHeaderLength > numberOfValues)
+      return false;
+    size_t gameRecordLength = values[indexOfValue + 2] | (static_cast<size_t>(values[indexOfValue + 3]) << 16);
+    indexOfValue += indexFileGameHeaderLength + gameRecordLength;
+  }
+
+  return (indexOfValue == numberOfValues);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of games in @a indexEntry.
+// -----------------------------------------------------------------------------
++ (int) numberOfGamesInIndexEntry:(NSData*)indexEntry
+{
+  const unsigned short* values = static_cast<const unsigned short*>(indexEntry.bytes);
+  return values[1];
+}
+
+#pragma mark - Private helpers - Search
+
+// -----------------------------------------------------------------------------
+/// @brief Searches the games in @a indexEntry with the pattern matcher for the
+/// board size of each game, and appends a pair of game number and board
+/// position to @a matches for each game in which the pattern matches.
+///
+/// This method is invoked concurrently on several threads.
+// -----------------------------------------------------------------------------
++ (void) searchIndexEntry:(NSData*)indexEntry
+      withPatternMatchers:(const std::vector<std::unique_ptr<GoPatternMatcher>>&)patternMatchers
+                  matches:(std::vector<std::pair<int, int>>&)matches
+{
+  const unsigned short* values = static_cast<const unsigned short*>(indexEntry.bytes);
+  size_t indexOfValue = indexFileHeaderLength;
+  for (int indexOfGame = 0; indexOfGame < values[1]; ++indexOfGame)
+  {
+    int gameNumber = values[indexOfValue];
+    int boardSize = values[indexOfValue + 1];
+    int gameRecordLength = values[indexOfValue + 2] | (values[indexOfValue + 3] << 16);
+    const unsigned short* gameRecord = values + indexOfValue + indexFileGameHeaderLength;
+    indexOfValue += indexFileGameHeaderLength + gameRecordLength;
+
+    if (boardSize >= static_cast<int>(patternMatchers.size()) || ! patternMatchers[boardSize])
+      continue;
+    int boardPosition = patternMatchers[boardSize]->findFirstMatch(gameRecord, gameRecordLength);
+    if (boardPosition >= 0)
+      matches.push_back(std::make_pair(gameNumber, boardPosition));
+  }
+}
+
+#pragma mark - Private helpers - Pattern parsing
+
+// -----------------------------------------------------------------------------
+/// @brief Parses @a patternRows and fills the out parameters with the
+/// dimensions, the cells (bottom row first) and the edge flags of the pattern.
+/// Returns true if parsing was successful. Returns false if @a patternRows is
+/// not a valid pattern, in which case @a errorMessage is filled with a
+/// description of the problem (unless @a errorMessage is nil).
+///
+/// See the class documentation for the pattern syntax.
+// -----------------------------------------------------------------------------
++ (bool) parsePatternRows:(NSArray*)patternRows
+             patternWidth:(int*)patternWidth
+            patternHeight:(int*)patternHeight
+             patternCells:(std::vector<GoPatternMatcher::PatternCell>&)patternCells
+             patternEdges:(int*)patternEdges
+             errorMessage:(NSString**)errorMessage
+{
+  NSMutableArray* rows = [NSMutableArray array];
+  for (NSString* patternRow in patternRows)
+  {
+    NSString* row = [patternRow stringByReplacingOccurrencesOfString:@" " withString:@""];
+    if (row.length > 0)
+      [rows addObject:row];
+  }
+
+  *patternEdges = GoPatternMatcher::PatternEdgeNone;
+  NSCharacterSet* horizontalEdgeCharacters = [NSCharacterSet characterSetWithCharactersInString:@"-+"];
+  if (rows.count > 0 && [ArchivePatternIndex string:rows.firstObject consistsOfCharactersInSet:horizontalEdgeCharacters])
+  {
+    *patternEdges |= GoPatternMatcher::PatternEdgeTop;
+    [rows removeObjectAtIndex:0];
+  }
+  if (rows.count > 0 && [ArchivePatternIndex string:rows.lastObject consistsOfCharactersInSet:horizontalEdgeCharacters])
+  {
+    *patternEdges |= GoPatternMatcher::PatternEdgeBottom;
+    [rows removeLastObject];
+  }
+
+  bool isLeftEdge = (rows.count > 0);
+  bool isRightEdge = (rows.count > 0);
+  for (NSString* row in rows)
+  {
+    isLeftEdge = isLeftEdge && ([row hasPrefix:@"|"] || [row hasPrefix:@"+"]);
+    isRightEdge = isRightEdge && ([row hasSuffix:@"|"] || [row hasSuffix:@"+"]);
+  }
+  for (NSUInteger indexOfRow = 0; indexOfRow < rows.count; ++indexOfRow)
+  {
+    NSString* row = rows[indexOfRow];
+    if (isLeftEdge && row.length > 0)
+      row = [row substringFromIndex:1];
+    if (isRightEdge && row.length > 0)
+      row = [row substringToIndex:row.length - 1];
+    rows[indexOfRow] = row;
+  }
+  if (isLeftEdge)
+    *patternEdges |= GoPatternMatcher::PatternEdgeLeft;
+  if (isRightEdge)
+    *patternEdges |= GoPatternMatcher::PatternEdgeRight;
+
+  NSString* firstRow = rows.firstObject;
+  if (firstRow.length == 0)
+  {
+    if (errorMessage)
+      *errorMessage = @"The pattern has no cells.";
+    return false;
+  }
+
+  *patternWidth = (int)firstRow.length;
+  *patternHeight = (int)rows.count;
+  patternCells.assign(*patternWidth * *patternHeight, GoPatternMatcher::PatternCellAny);
+  for (int indexOfRow = 0; indexOfRow < *patternHeight; ++indexOfRow)
+  {
+    NSString* row = rows[indexOfRow];
+    if (row.length != firstRow.length)
+    {
+      if (errorMessage)
+        *errorMessage = @"All rows of the pattern must have the same number of cells.";
+      return false;
+    }
+
+    // The first row is the top row, but the cells start with the bottom row
+    int y = *patternHeight - 1 - indexOfRow;
+    for (int x = 0; x < *patternWidth; ++x)
+    {
+      GoPatternMatcher::PatternCell patternCell;
+      unichar character = [row characterAtIndex:x];
+      switch (character)
+      {
+        case 'X':
+        case 'x':
+          patternCell = GoPatternMatcher::PatternCellBlack;
+          break;
+        case 'O':
+        case 'o':
+          patternCell = GoPatternMatcher::PatternCellWhite;
+          break;
+        case '.':
+          patternCell = GoPatternMatcher::PatternCellEmpty;
+          break;
+        case '?':
+          patternCell = GoPatternMatcher::PatternCellAny;
+          break;
+        default:
+        {
+          if (errorMessage)
+            *errorMessage = [NSString stringWithFormat:@"The pattern contains the invalid character \"%C\".", character];
+          return false;
+        }
+      }
+      patternCells[y * *patternWidth + x] = patternCell;
+    }
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a string is not empty and consists only of
+/// characters in @a characterSet.
+// -----------------------------------------------------------------------------
++ (bool) string:(NSString*)string consistsOfCharactersInSet:(NSCharacterSet*)characterSet
+{
+  if (string.length == 0)
+    return false;
+  return ([string rangeOfCharacterFromSet:characterSet.invertedSet].location == NSNotFound);
+}
+
+@end
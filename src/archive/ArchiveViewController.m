@@ -19,9 +19,12 @@
 #import "ArchiveViewController.h"
 #import "ArchiveViewModel.h"
 #import "ArchiveGame.h"
+#import "ArchiveGameThumbnailCache.h"
 #import "ViewGameController.h"
 #import "../command/game/DeleteGameCommand.h"
+#import "../command/game/MergeGamesCommand.h"
 #import "../main/ApplicationDelegate.h"
+#import "../sgf/SgfUtilities.h"
 #import "../ui/AutoLayoutUtility.h"
 #import "../ui/PlaceholderView.h"
 #import "../ui/TableViewCellFactory.h"
@@ -52,10 +55,19 @@ enum DeleteAllSectionItem
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for ArchiveViewController.
 // -----------------------------------------------------------------------------
-@interface ArchiveViewController()
+@interface ArchiveViewController() <UISearchResultsUpdating>
 @property(nonatomic, retain) PlaceholderView* placeholderView;
 @property(nonatomic, retain) UITableViewController* tableViewController;
 @property(nonatomic, retain) NSArray* autoLayoutConstraints;
+@property(nonatomic, retain) UISearchController* searchController;
+/// @brief The games that match the search text entered by the user. Is nil if
+/// the user has not entered any search text, in which case all games of
+/// ArchiveViewModel are displayed.
+@property(nonatomic, retain) NSArray* filteredGameList;
+@property(nonatomic, retain) ArchiveGameThumbnailCache* thumbnailCache;
+/// @brief The button that merges the games that the user selected while the
+/// table view is in editing mode.
+@property(nonatomic, retain) UIBarButtonItem* mergeButton;
 @end
 
 
@@ -78,7 +90,14 @@ enum DeleteAllSectionItem
   self.placeholderView = nil;
   self.tableViewController = nil;
   self.autoLayoutConstraints = nil;
+  self.searchController = nil;
+  self.filteredGameList = nil;
   self.archiveViewModel = [ApplicationDelegate sharedDelegate].archiveViewModel;
+  self.thumbnailCache = [[[ArchiveGameThumbnailCache alloc] initWithArchiveFolder:self.archiveViewModel.archiveFolder] autorelease];
+  self.mergeButton = [[[UIBarButtonItem alloc] initWithTitle:@"Merge"
+                                                       style:UIBarButtonItemStylePlain
+                                                      target:self
+                                                      action:@selector(mergeSelectedGames:)] autorelease];
   [self.archiveViewModel addObserver:self forKeyPath:@"gameList" options:0 context:NULL];
 
   return self;
@@ -92,6 +111,11 @@ enum DeleteAllSectionItem
   self.placeholderView = nil;
   self.tableViewController = nil;
   self.autoLayoutConstraints = nil;
+  self.searchController.searchResultsUpdater = nil;
+  self.searchController = nil;
+  self.filteredGameList = nil;
+  self.thumbnailCache = nil;
+  self.mergeButton = nil;
   [self.archiveViewModel removeObserver:self forKeyPath:@"gameList"];
   self.archiveViewModel = nil;
 
@@ -143,6 +167,7 @@ enum DeleteAllSectionItem
 
   [self setupViewHierarchy];
   [self setupAutoLayoutConstraints];
+  [self setupSearchController];
 
   [self updateVisibleStateOfEditButton];
 }
@@ -150,10 +175,23 @@ enum DeleteAllSectionItem
 // -----------------------------------------------------------------------------
 /// @brief UIViewController method
 // -----------------------------------------------------------------------------
+- (void) viewWillAppear:(BOOL)animated
+{
+  [super viewWillAppear:animated];
+
+  // The user may have loaded a game in ViewGameController since the table
+  // view cells were last configured. This updates the load result indicators.
+  [self.tableViewController.tableView reloadData];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief UIViewController method.
+// -----------------------------------------------------------------------------
 - (void) setEditing:(BOOL)editing animated:(BOOL)animated
 {
   [super setEditing:editing animated:animated];
   [self.tableViewController setEditing:editing animated:animated];
+  [self updateMergeButton];
 }
 
 #pragma mark - View hierarchy handling
@@ -222,6 +260,24 @@ enum DeleteAllSectionItem
 
   tableView.delegate = self;
   tableView.dataSource = self;
+  // In editing mode the user selects the games to merge. Games can still be
+  // deleted by swiping outside of editing mode.
+  tableView.allowsMultipleSelectionDuringEditing = YES;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Sets up the search controller that lets the user filter the list of
+/// games by name.
+// -----------------------------------------------------------------------------
+- (void) setupSearchController
+{
+  self.searchController = [[[UISearchController alloc] initWithSearchResultsController:nil] autorelease];
+  self.searchController.searchResultsUpdater = self;
+  self.searchController.obscuresBackgroundDuringPresentation = NO;
+  self.searchController.searchBar.placeholder = @"Search games";
+
+  self.navigationItem.searchController = self.searchController;
+  self.definesPresentationContext = YES;
 }
 
 #pragma mark - Auto Layout constraints
@@ -272,6 +328,136 @@ enum DeleteAllSectionItem
   [self.tableViewController.tableView reloadData];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Shows the "Merge" button while the table view is in editing mode,
+/// and hides it otherwise. The button is enabled only if the user selected at
+/// least two games.
+// -----------------------------------------------------------------------------
+- (void) updateMergeButton
+{
+  if (! self.editing || ! self.tableViewController)
+  {
+    self.navigationItem.leftBarButtonItem = nil;
+    return;
+  }
+
+  self.navigationItem.leftBarButtonItem = self.mergeButton;
+  self.mergeButton.enabled = ([self selectedGames].count >= 2);
+}
+
+#pragma mark - Private helpers for searching
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the games that are currently displayed in the games section,
+/// i.e. either all games or only those that match the search text.
+// -----------------------------------------------------------------------------
+- (NSArray*) displayedGameList
+{
+  if (self.filteredGameList)
+    return self.filteredGameList;
+  else
+    return self.archiveViewModel.gameList;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the game that is displayed in the games section in the row
+/// specified by @a indexPath.
+// -----------------------------------------------------------------------------
+- (ArchiveGame*) gameAtIndexPath:(NSIndexPath*)indexPath
+{
+  return [self displayedGameList][indexPath.row];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the games that the user selected in the games section, in
+/// the order in which they are displayed.
+// -----------------------------------------------------------------------------
+- (NSArray*) selectedGames
+{
+  NSArray* indexPaths = [self.tableViewController.tableView.indexPathsForSelectedRows sortedArrayUsingSelector:@selector(compare:)];
+  NSMutableArray* selectedGames = [NSMutableArray array];
+  for (NSIndexPath* indexPath in indexPaths)
+  {
+    if (GamesSection == indexPath.section)
+      [selectedGames addObject:[self gameAtIndexPath:indexPath]];
+  }
+  return selectedGames;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the list of games that match the search text currently
+/// entered by the user. Does not reload the table view.
+// -----------------------------------------------------------------------------
+- (void) updateFilteredGameList
+{
+  NSString* searchText = self.searchController.searchBar.text;
+  if (searchText.length == 0)
+    self.filteredGameList = nil;
+  else
+    self.filteredGameList = [self.archiveViewModel gamesMatchingSearchText:searchText];
+}
+
+#pragma mark - Private helpers for thumbnails
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked by ArchiveGameThumbnailCache when the thumbnail of
+/// @a game has become available. Reloads the table view cell of @a game if it
+/// is visible.
+// -----------------------------------------------------------------------------
+- (void) thumbnailDidBecomeAvailableForGame:(ArchiveGame*)game
+{
+  UITableView* tableView = self.tableViewController.tableView;
+  if (! tableView)
+    return;
+
+  NSUInteger row = [[self displayedGameList] indexOfObject:game];
+  if (row == NSNotFound)
+    return;
+
+  NSIndexPath* indexPath = [NSIndexPath indexPathForRow:row inSection:GamesSection];
+  if (! [tableView.indexPathsForVisibleRows containsObject:indexPath])
+    return;
+
+  [tableView reloadRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationNone];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the image to display in the table view cell of @a game.
+/// The image is the thumbnail of @a game, with the load result indicator drawn
+/// over its bottom-right corner if @a game was loaded since it was last
+/// modified. Returns nil if the thumbnail is not yet available.
+// -----------------------------------------------------------------------------
+- (UIImage*) imageForGame:(ArchiveGame*)game
+{
+  UIImage* thumbnail = [self.thumbnailCache thumbnailForGame:game completionHandler:^{
+    [self thumbnailDidBecomeAvailableForGame:game];
+  }];
+  if (! thumbnail || ! game.loadResultMessages)
+    return thumbnail;
+
+  UIImage* indicator = [SgfUtilities coloredIndicatorForLoadResultMessages:game.loadResultMessages];
+  UIGraphicsImageRenderer* renderer = [[[UIGraphicsImageRenderer alloc] initWithSize:thumbnail.size] autorelease];
+  return [renderer imageWithActions:^(UIGraphicsImageRendererContext* rendererContext)
+  {
+    [thumbnail drawAtPoint:CGPointZero];
+    CGPoint indicatorOrigin = CGPointMake(thumbnail.size.width - indicator.size.width,
+                                          thumbnail.size.height - indicator.size.height);
+    [indicator drawAtPoint:indicatorOrigin];
+  }];
+}
+
+#pragma mark - UISearchResultsUpdating overrides
+
+// -----------------------------------------------------------------------------
+/// @brief UISearchResultsUpdating protocol method.
+// -----------------------------------------------------------------------------
+- (void) updateSearchResultsForSearchController:(UISearchController*)searchController
+{
+  [self updateFilteredGameList];
+  [self.tableViewController.tableView reloadData];
+  [self updateMergeButton];
+}
+
 #pragma mark - UITableViewDataSource overrides
 
 // -----------------------------------------------------------------------------
@@ -291,11 +477,13 @@ enum DeleteAllSectionItem
   {
     case GamesSection:
     {
-      return self.archiveViewModel.gameCount;
+      return [self displayedGameList].count;
     }
     case DeleteAllSection:
     {
-      if (0 == self.archiveViewModel.gameCount)
+      // "Delete all" is not offered while the user is searching because it
+      // would also delete the games that are not displayed
+      if (0 == self.archiveViewModel.gameCount || self.filteredGameList)
         return 0;
       else
         return MaxDeleteAllSectionItem;
@@ -320,12 +508,10 @@ enum DeleteAllSectionItem
     case GamesSection:
     {
       cell = [TableViewCellFactory cellWithType:SubtitleCellType tableView:tableView];
-      // Cast is required because NSInteger and int differ in size in 64-bit.
-      // Cast is safe because this app was not made to handle more than
-      // pow(2, 31) files.
-      ArchiveGame* game = [self.archiveViewModel gameAtIndex:(int)indexPath.row];
+      ArchiveGame* game = [self gameAtIndexPath:indexPath];
       cell.textLabel.text = game.name;
       cell.detailTextLabel.text = [@"Last saved: " stringByAppendingString:game.fileDate];
+      cell.imageView.image = [self imageForGame:game];
       cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
       break;
     }
@@ -345,6 +531,16 @@ enum DeleteAllSectionItem
   return cell;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief UITableViewDataSource protocol method.
+// -----------------------------------------------------------------------------
+- (BOOL) tableView:(UITableView*)tableView canEditRowAtIndexPath:(NSIndexPath*)indexPath
+{
+  // Prevents the "Delete all" row from showing a selection control in
+  // editing mode
+  return (GamesSection == indexPath.section);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief UITableViewDataSource protocol method.
 // -----------------------------------------------------------------------------
@@ -360,10 +556,7 @@ enum DeleteAllSectionItem
     return;
   }
 
-  // Cast is required because NSInteger and int differ in size in 64-bit.
-  // Cast is safe because this app was not made to handle more than
-  // pow(2, 31) files.
-  ArchiveGame* game = [self.archiveViewModel gameAtIndex:(int)indexPath.row];
+  ArchiveGame* game = [self gameAtIndexPath:indexPath];
   DeleteGameCommand* command = [[[DeleteGameCommand alloc] initWithGame:game] autorelease];
   // Temporarily disable KVO observer mechanism so that no table view update
   // is triggered during command execution. Purpose: In a minute, we are going
@@ -375,6 +568,8 @@ enum DeleteAllSectionItem
   // a reloadData().
   if (success)
   {
+    if (self.filteredGameList)
+      [self updateFilteredGameList];
     if (0 == self.archiveViewModel.gameCount)
       [self updateArchiveViewAfterLastGameWasDeleted];
     else
@@ -389,15 +584,19 @@ enum DeleteAllSectionItem
 // -----------------------------------------------------------------------------
 - (void) tableView:(UITableView*)tableView didSelectRowAtIndexPath:(NSIndexPath*)indexPath
 {
+  if (tableView.editing && GamesSection == indexPath.section)
+  {
+    // The user selects a game to merge
+    [self updateMergeButton];
+    return;
+  }
+
   [tableView deselectRowAtIndexPath:indexPath animated:NO];
   switch (indexPath.section)
   {
     case GamesSection:
     {
-      // Cast is required because NSInteger and int differ in size in 64-bit.
-      // Cast is safe because this app was not made to handle more than
-      // pow(2, 31) files.
-      [self viewGame:[self.archiveViewModel gameAtIndex:(int)indexPath.row]];
+      [self viewGame:[self gameAtIndexPath:indexPath]];
       break;
     }
     case DeleteAllSection:
@@ -413,6 +612,15 @@ enum DeleteAllSectionItem
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief UITableViewDelegate protocol method.
+// -----------------------------------------------------------------------------
+- (void) tableView:(UITableView*)tableView didDeselectRowAtIndexPath:(NSIndexPath*)indexPath
+{
+  if (tableView.editing)
+    [self updateMergeButton];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief UITableViewDelegate protocol method.
 // -----------------------------------------------------------------------------
@@ -434,10 +642,14 @@ enum DeleteAllSectionItem
 // -----------------------------------------------------------------------------
 - (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
 {
+  if (self.filteredGameList)
+    [self updateFilteredGameList];
   [self updateViewHierarchy];
   [self updateVisibleStateOfEditButton];
   // "Delete All" button may need to be shown if game count goes from 0 to 1
   [self.tableViewController.tableView reloadData];
+  // Reloading discards the selection
+  [self updateMergeButton];
 }
 
 #pragma mark - Action handlers
@@ -453,6 +665,33 @@ enum DeleteAllSectionItem
   [viewGameController release];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Reacts to a tap on the "Merge" button. Merges the games that the
+/// user selected into a new game. The game that is displayed topmost is the
+/// base of the merge.
+// -----------------------------------------------------------------------------
+- (void) mergeSelectedGames:(id)sender
+{
+  NSArray* selectedGames = [self selectedGames];
+  if (selectedGames.count < 2)
+    return;
+
+  ArchiveGame* baseGame = selectedGames.firstObject;
+  NSString* preferredGameName = [baseGame.name stringByAppendingString:@" (merged)"];
+  MergeGamesCommand* command = [[[MergeGamesCommand alloc] initWithGames:selectedGames
+                                                       preferredGameName:preferredGameName] autorelease];
+  bool success = [command submit];
+  if (success)
+  {
+    [self setEditing:NO animated:YES];
+  }
+  else
+  {
+    NSString* message = command.errorMessage ? command.errorMessage : @"The games could not be merged.";
+    [self presentOkAlertWithTitle:@"Merge failed" message:message];
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Initiates the process to delete all entries. First displays an alert
 /// that asks the user to confirm that she really wants to do this.
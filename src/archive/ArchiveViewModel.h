@@ -29,6 +29,11 @@
 /// Although archived games ultimately refer to files, the UI presented to the
 /// user should not refer to them as such. With this in mind, most of the public
 /// interface of ArchiveViewModel refers to "games" and "game names".
+///
+/// ArchiveViewModel keeps the game list up-to-date with the archive folder. It
+/// updates the list when the #archiveContentChanged notification is posted,
+/// and when ArchiveFolderMonitor reports that the folder has changed, which
+/// also covers changes that are made from outside the app.
 // -----------------------------------------------------------------------------
 @interface ArchiveViewModel : NSObject
 {
@@ -39,6 +44,7 @@
 - (void) writeUserDefaults;
 - (ArchiveGame*) gameAtIndex:(int)index;
 - (ArchiveGame*) gameWithName:(NSString*)name;
+- (NSArray*) gamesMatchingSearchText:(NSString*)searchText;
 - (NSString*) uniqueGameNameForGame:(GoGame*)game;
 - (NSString*) uniqueGameNameForName:(NSString*)preferredGameName;
 - (NSString*) filePathForGameWithName:(NSString*)name;
@@ -58,5 +64,10 @@
 /// @brief True if objects in gameList are sorted ascending, false if they are
 /// sorted descending.
 @property(nonatomic, assign) bool sortAscending;
+/// @brief True if games are stored gzip compressed when they are saved to the
+/// archive, false if they are stored uncompressed. Games that are already in
+/// the archive are not affected when this changes, compressed and uncompressed
+/// games can coexist in the archive.
+@property(nonatomic, assign) bool compressGames;
 
 @end
@@ -17,6 +17,7 @@
 
 // Project includes
 #import "ArchiveViewModel.h"
+#import "ArchiveFolderMonitor.h"
 #import "ArchiveGame.h"
 #import "../go/GoGame.h"
 #import "../go/GoPlayer.h"
@@ -33,6 +34,7 @@
 //@{
 @property(nonatomic, retain, readwrite) NSArray* gameList;
 //@}
+@property(nonatomic, retain) ArchiveFolderMonitor* archiveFolderMonitor;
 @end
 
 
@@ -55,12 +57,21 @@
   self.gameList = [NSMutableArray arrayWithCapacity:0];
   self.sortCriteria = ArchiveSortCriteriaFileName;
   self.sortAscending = true;
+  self.compressGames = false;
 
   [self updateGameList];
 
   NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
   [center addObserver:self selector:@selector(archiveContentChanged:) name:archiveContentChanged object:nil];
 
+  // The monitor notices changes that are made from outside the app, e.g. via
+  // the Files app. The block must not retain self, otherwise there would be a
+  // retain cycle.
+  __block ArchiveViewModel* blockSelf = self;
+  self.archiveFolderMonitor = [[[ArchiveFolderMonitor alloc] initWithFolder:self.archiveFolder
+                                                             changeHandler:^{ [blockSelf updateGameList]; }] autorelease];
+  [self.archiveFolderMonitor startMonitoring];
+
   return self;
 }
 
@@ -69,6 +80,8 @@
 // -----------------------------------------------------------------------------
 - (void) dealloc
 {
+  [self.archiveFolderMonitor stopMonitoring];
+  self.archiveFolderMonitor = nil;
   self.archiveFolder = nil;
   self.gameList = nil;
   [super dealloc];
@@ -83,6 +96,7 @@
   NSDictionary* dictionary = [userDefaults dictionaryForKey:archiveViewKey];
   self.sortCriteria = [[dictionary valueForKey:sortCriteriaKey] intValue];
   self.sortAscending = [[dictionary valueForKey:sortAscendingKey] boolValue];
+  self.compressGames = [[dictionary valueForKey:compressGamesKey] boolValue];
 }
 
 // -----------------------------------------------------------------------------
@@ -94,6 +108,7 @@
   NSMutableDictionary* dictionary = [NSMutableDictionary dictionary];
   [dictionary setValue:[NSNumber numberWithInt:self.sortCriteria] forKey:sortCriteriaKey];
   [dictionary setValue:[NSNumber numberWithBool:self.sortAscending] forKey:sortAscendingKey];
+  [dictionary setValue:[NSNumber numberWithBool:self.compressGames] forKey:compressGamesKey];
   NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
   [userDefaults setObject:dictionary forKey:archiveViewKey];
 }
@@ -147,36 +162,146 @@
   return nil;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns an array with those ArchiveGame objects in gameList whose
+/// name matches @a searchText. The array has the same order as gameList.
+///
+/// @a searchText is split into words at whitespace characters. A game matches
+/// if its name contains every word. The comparison is case and diacritic
+/// insensitive. Because the default name of a game is made up of the player
+/// names (see uniqueGameNameForGame:()), this allows to search for games by
+/// player name.
+///
+/// Returns gameList if @a searchText contains no words.
+// -----------------------------------------------------------------------------
+- (NSArray*) gamesMatchingSearchText:(NSString*)searchText
+{
+  NSMutableArray* searchWords = [NSMutableArray array];
+  for (NSString* word in [searchText componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]])
+  {
+    if (word.length > 0)
+      [searchWords addObject:word];
+  }
+  if (0 == searchWords.count)
+    return self.gameList;
+
+  NSStringCompareOptions compareOptions = NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch;
+  NSMutableArray* matchingGames = [NSMutableArray array];
+  for (ArchiveGame* game in self.gameList)
+  {
+    NSString* gameName = game.name;
+    bool gameMatches = true;
+    for (NSString* searchWord in searchWords)
+    {
+      if ([gameName rangeOfString:searchWord options:compareOptions].location == NSNotFound)
+      {
+        gameMatches = false;
+        break;
+      }
+    }
+    if (gameMatches)
+      [matchingGames addObject:game];
+  }
+  return matchingGames;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Updates the game list array so that its content matches the content
 /// of the document folder.
+///
+/// The update applies only the changes that actually occurred: ArchiveGame
+/// objects are created only for files that were added, objects of files that
+/// were removed are dropped, and objects of files that are still present are
+/// reused and their attributes updated. A rename is a removal plus an
+/// addition. ArchiveGame objects are looked up in a dictionary keyed by file
+/// name, instead of via gameWithFileName:(), so that the update remains linear
+/// in the number of games even when the archive contains thousands of games.
+///
+/// The file attributes are prefetched together with the folder listing instead
+/// of being queried file by file. If nothing changed, the game list array is
+/// not replaced, so that observers are not triggered needlessly. This is
+/// important because the update runs every time the content of the folder
+/// changes, including changes that are not archived games (e.g. log files).
+///
+/// This method may be invoked on the main thread by ArchiveFolderMonitor and
+/// on other threads by the #archiveContentChanged notification. Concurrent
+/// updates are serialized.
 // -----------------------------------------------------------------------------
 - (void) updateGameList
 {
-  NSArray* fileList = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.archiveFolder error:nil];
-  NSMutableArray* localGameList = [NSMutableArray arrayWithCapacity:fileList.count];
-  for (NSString* fileName in fileList)
+  @synchronized(self)
   {
-    if ([self shouldIgnoreFileName:fileName])
-      continue;
-    NSString* filePath = [self.archiveFolder stringByAppendingPathComponent:fileName];
-    NSDictionary* fileAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:filePath error:nil];
-    ArchiveGame* game = [self gameWithFileName:fileName];
-    if (game)
-      [game updateFileAttributes:fileAttributes];
-    else
-      game = [[[ArchiveGame alloc] initWithFileName:fileName fileAttributes:fileAttributes] autorelease];
-    [localGameList addObject:game];
+    NSMutableDictionary* existingGames = [NSMutableDictionary dictionaryWithCapacity:self.gameList.count];
+    for (ArchiveGame* game in self.gameList)
+      existingGames[game.fileName] = game;
+
+    NSArray* resourceKeys = @[NSURLContentModificationDateKey, NSURLFileSizeKey];
+    NSURL* archiveFolderURL = [NSURL fileURLWithPath:self.archiveFolder isDirectory:YES];
+    NSArray* fileURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:archiveFolderURL
+                                                      includingPropertiesForKeys:resourceKeys
+                                                                         options:0
+                                                                           error:nil];
+
+    NSMutableArray* localGameList = [NSMutableArray arrayWithCapacity:fileURLs.count];
+    bool gameListDidChange = false;
+    for (NSURL* fileURL in fileURLs)
+    {
+      NSString* fileName = fileURL.lastPathComponent;
+      if ([self shouldIgnoreFileName:fileName])
+        continue;
+      NSDictionary* fileAttributes = [self fileAttributesForFileURL:fileURL resourceKeys:resourceKeys];
+      ArchiveGame* game = existingGames[fileName];
+      if (game)
+      {
+        if ([game updateFileAttributes:fileAttributes])
+          gameListDidChange = true;
+      }
+      else
+      {
+        game = [[[ArchiveGame alloc] initWithFileName:fileName fileAttributes:fileAttributes] autorelease];
+        gameListDidChange = true;
+      }
+      [localGameList addObject:game];
+    }
+
+    // Every game in the new list is either new, which was detected above, or
+    // was taken from the old list. If the counts differ, games were removed.
+    if (localGameList.count != self.gameList.count)
+      gameListDidChange = true;
+    if (! gameListDidChange)
+      return;
+
+    // TODO: sort by file date if self.sortCriteria says so. It might be
+    // interesting to have a look at NSComparator and blocks.
+    NSSortDescriptor* sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:nil
+                                                                     ascending:self.sortAscending
+                                                                      selector:@selector(compare:)];
+    [localGameList sortUsingDescriptors:[NSArray arrayWithObject:sortDescriptor]];
+
+    // Replace entire array to trigger KVO
+    self.gameList = localGameList;
   }
-  // TODO: sort by file date if self.sortCriteria says so. It might be
-  // interesting to have a look at NSComparator and blocks.
-  NSSortDescriptor* sortDescriptor = [NSSortDescriptor sortDescriptorWithKey:nil
-                                                                   ascending:self.sortAscending
-                                                                    selector:@selector(compare:)];
-  [localGameList sortUsingDescriptors:[NSArray arrayWithObject:sortDescriptor]];
-
-  // Replace entire array to trigger KVO
-  self.gameList = localGameList;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for updateGameList(). Returns a dictionary with the
+/// file attributes of @a fileURL in the format expected by ArchiveGame, i.e.
+/// the format returned by NSFileManager's attributesOfItemAtPath:error:(). The
+/// attributes are taken from the resource values that were prefetched for
+/// @a resourceKeys.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) fileAttributesForFileURL:(NSURL*)fileURL resourceKeys:(NSArray*)resourceKeys
+{
+  NSDictionary* resourceValues = [fileURL resourceValuesForKeys:resourceKeys error:nil];
+  NSMutableDictionary* fileAttributes = [NSMutableDictionary dictionaryWithCapacity:2];
+  NSDate* fileModificationDate = resourceValues[NSURLContentModificationDateKey];
+  if (fileModificationDate)
+    fileAttributes[NSFileModificationDate] = fileModificationDate;
+  // Is missing for folders
+  NSNumber* fileSize = resourceValues[NSURLFileSizeKey];
+  if (fileSize)
+    fileAttributes[NSFileSize] = fileSize;
+  return fileAttributes;
 }
 
 // -----------------------------------------------------------------------------
@@ -25,10 +25,13 @@
 #import "ViewLoadResultController.h"
 #import "../command/game/RenameGameCommand.h"
 #import "../command/game/LoadGameCommand.h"
+#import "../command/game/SwitchToResidentGameCommand.h"
 #import "../command/sgf/LoadSgfCommand.h"
 #import "../go/GoGame.h"
+#import "../go/GoGameWorkspace.h"
 #import "../main/ApplicationDelegate.h"
 #import "../main/MainUtility.h"
+#import "../sgf/SgfFileCompression.h"
 #import "../sgf/SgfSettingsModel.h"
 #import "../sgf/SgfUtilities.h"
 #import "../ui/TableViewCellFactory.h"
@@ -135,6 +138,9 @@ enum LoadResultType
 @property(nonatomic, retain) GameInfoItem* gameInfoItemBeingLoaded;
 @property(nonatomic, retain) SGFCNode* gameInfoNodeBeingLoaded;
 @property(nonatomic, retain) SGFCGame* gameBeingLoaded;
+/// @brief The uncompressed temporary copy of a compressed .sgf file that was
+/// handed out to UIActivityViewController. Is nil if no such copy exists.
+@property(nonatomic, retain) NSString* uncompressedSgfFilePathForActivity;
 @end
 
 
@@ -163,6 +169,7 @@ enum LoadResultType
     controller.gameInfoItemBeingLoaded = nil;
     controller.gameInfoNodeBeingLoaded = nil;
     controller.gameBeingLoaded = nil;
+    controller.uncompressedSgfFilePathForActivity = nil;
   }
   return controller;
 }
@@ -185,6 +192,9 @@ enum LoadResultType
   self.gameInfoNodeBeingLoaded = nil;
   self.gameBeingLoaded = nil;
   self.actionButton = nil;
+  if (self.uncompressedSgfFilePathForActivity)
+    [SgfFileCompression removeUncompressedSgfFile:self.uncompressedSgfFilePathForActivity];
+  self.uncompressedSgfFilePathForActivity = nil;
   [super dealloc];
 }
 
@@ -719,8 +729,19 @@ enum LoadResultType
 
     [MainUtility activateUIArea:UIAreaPlay];
 
-    LoadGameCommand* command = [[[LoadGameCommand alloc] initWithGameInfoNode:self.gameInfoNodeBeingLoaded goGameInfo:self.gameInfoItemBeingLoaded.goGameInfo game:self.gameBeingLoaded] autorelease];
-    [command submit];
+    NSString* workspaceKey = [self workspaceKeyForGameBeingLoaded];
+    if ([[ApplicationDelegate sharedDelegate].gameWorkspace hasResidentGameForKey:workspaceKey])
+    {
+      SwitchToResidentGameCommand* command = [[[SwitchToResidentGameCommand alloc] initWithWorkspaceKey:workspaceKey] autorelease];
+      [command submit];
+    }
+    else
+    {
+      LoadGameCommand* command = [[[LoadGameCommand alloc] initWithGameInfoNode:self.gameInfoNodeBeingLoaded goGameInfo:self.gameInfoItemBeingLoaded.goGameInfo game:self.gameBeingLoaded] autorelease];
+      command.workspaceKey = workspaceKey;
+      [self releaseSgfDataNotNeededForLoadingGame];
+      [command submit];
+    }
   }
 
   self.gameInfoItemBeingLoaded = nil;
@@ -728,6 +749,46 @@ enum LoadResultType
   self.gameBeingLoaded = nil;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for newGameController:didStartNewGame:rematch:().
+/// Returns the key under which the game being loaded is registered with
+/// GoGameWorkspace.
+///
+/// The key consists of the .sgf file path, the file's modification date and
+/// the index of the game within the file. The key therefore changes when the
+/// file is renamed or overwritten, which makes sure that a resident game is
+/// never used in place of a game whose source has changed.
+// -----------------------------------------------------------------------------
+- (NSString*) workspaceKeyForGameBeingLoaded
+{
+  NSString* sgfFilePath = [self.model filePathForGameWithName:self.game.name];
+  NSUInteger gameIndex = [self.gameInfoItems indexOfObject:self.gameInfoItemBeingLoaded];
+  return [NSString stringWithFormat:@"%@|%f|%lu",
+          sgfFilePath,
+          self.game.fileModificationDate.timeIntervalSinceReferenceDate,
+          (unsigned long)gameIndex];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for newGameController:didStartNewGame:rematch:().
+/// Releases the SGF data of all games except the one being loaded.
+///
+/// An .sgf file can contain a collection of hundreds of games. SgfcKit always
+/// reads the entire collection, but LoadGameCommand needs only the game that
+/// the user selected, which it retains. Releasing everything else before
+/// LoadGameCommand starts building the Go model limits the memory in use while
+/// the game is loaded to the size of the selected game. This controller has
+/// already been popped from the navigation stack at this point, so it does not
+/// need the data anymore for display purposes.
+// -----------------------------------------------------------------------------
+- (void) releaseSgfDataNotNeededForLoadingGame
+{
+  self.sgfDocumentReadResultSingleEncoding = nil;
+  self.sgfDocumentReadResultMultipleEncodings = nil;
+  self.gameInfoNodes = nil;
+  self.games = nil;
+}
+
 #pragma mark - Action button - Action handlers
 
 // -----------------------------------------------------------------------------
@@ -792,6 +853,31 @@ enum LoadResultType
   return @"SGF file";
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// activityViewController:itemForActivityType:(). Returns the full path of
+/// the .sgf file of @a game in a form that other apps can read.
+///
+/// Other apps cannot read a compressed .sgf file, so if the file is
+/// compressed, an uncompressed temporary copy is made and its path is returned.
+/// The copy is removed when this controller is deallocated.
+// -----------------------------------------------------------------------------
+- (NSString*) sgfFilePathForActivityWithGame:(ArchiveGame*)game
+{
+  NSString* sgfFilePath = [self.model filePathForGameWithName:game.name];
+  if (! [SgfFileCompression isCompressedSgfFile:sgfFilePath])
+    return sgfFilePath;
+
+  if (self.uncompressedSgfFilePathForActivity)
+    [SgfFileCompression removeUncompressedSgfFile:self.uncompressedSgfFilePathForActivity];
+  self.uncompressedSgfFilePathForActivity = [SgfFileCompression uncompressedSgfFileForSgfFile:sgfFilePath];
+
+  // If decompression fails the compressed file is better than nothing
+  if (! self.uncompressedSgfFilePathForActivity)
+    return sgfFilePath;
+  return self.uncompressedSgfFilePathForActivity;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief UIActivityItemSource method.
 ///
@@ -837,7 +923,7 @@ enum LoadResultType
 - (id) activityViewController:(UIActivityViewController*)activityViewController
           itemForActivityType:(UIActivityType)activityType;
 {
-  NSString* sgfFilePath = [self.model filePathForGameWithName:self.game.name];
+  NSString* sgfFilePath = [self sgfFilePathForActivityWithGame:self.game];
   NSURL* sgfFileURL = [NSURL fileURLWithPath:sgfFilePath isDirectory:NO];
 
   if ([activityType isEqualToString:UIActivityTypeCopyToPasteboard] ||
@@ -1184,6 +1270,9 @@ enum LoadResultType
       self.numberOfLoadResults = 1;
     SGFCDocumentReadResult* effectiveLoadResult = [self effectiveLoadResult];
     self.loadResultType = [self loadResultTypeBasedOnLoadResult:effectiveLoadResult];
+    // Memoize the outcome so that the archive view can display it without
+    // having to parse the file again
+    self.game.loadResultMessages = effectiveLoadResult.parseResult;
   }
 }
 
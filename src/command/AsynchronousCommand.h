@@ -25,6 +25,41 @@
 @protocol AsynchronousCommandDelegate;
 
 
+// -----------------------------------------------------------------------------
+/// @brief Enumerates the execution lanes in which CommandProcessor executes
+/// asynchronous commands. Each lane has its own secondary thread. Commands in
+/// the same lane are executed one after the other in the order in which they
+/// were submitted, commands in different lanes are executed in parallel.
+// -----------------------------------------------------------------------------
+enum AsynchronousCommandExecutionLane
+{
+  /// @brief The lane for commands that access the Go model, the GTP engine or
+  /// any other application state. This is the default lane.
+  AsynchronousCommandExecutionLaneGoModel,
+  /// @brief The lane for commands that are independent of the Go model and
+  /// the rest of the application state, e.g. because they only access the
+  /// file system.
+  AsynchronousCommandExecutionLaneIndependent,
+  AsynchronousCommandExecutionLaneMax = AsynchronousCommandExecutionLaneIndependent
+};
+
+// -----------------------------------------------------------------------------
+/// @brief Enumerates the priorities with which CommandProcessor executes
+/// asynchronous commands that are waiting in the same execution lane. A
+/// command is executed before all waiting commands that have a lower priority.
+/// Commands with the same priority are executed in the order in which they were
+/// submitted.
+// -----------------------------------------------------------------------------
+enum AsynchronousCommandPriority
+{
+  /// @brief The priority of background work whose result does not depend on
+  /// when exactly it is executed.
+  AsynchronousCommandPriorityLow,
+  /// @brief The default priority.
+  AsynchronousCommandPriorityNormal
+};
+
+
 // -----------------------------------------------------------------------------
 /// @brief The AsynchronousCommand protocol must be adopted by classes that
 /// already adopt the Command protocol if they want to be executed
@@ -39,6 +74,22 @@
 /// the property is @e false then the command must not call any
 /// AsynchronousCommandDelegate methods related to the progress HUD.
 @property(nonatomic, assign) bool showProgressHUD;
+
+@optional
+/// @brief The lane in which the command is executed. If the command does not
+/// implement this property it is executed in
+/// #AsynchronousCommandExecutionLaneGoModel.
+@property(nonatomic, assign, readonly) enum AsynchronousCommandExecutionLane executionLane;
+/// @brief The priority with which the command is executed. If the command does
+/// not implement this property it is executed with
+/// #AsynchronousCommandPriorityNormal.
+@property(nonatomic, assign, readonly) enum AsynchronousCommandPriority priority;
+/// @brief Returns true if submitting the command makes @a command obsolete.
+/// @a command is a command in the same execution lane that was submitted
+/// earlier and that is still waiting to be executed. CommandProcessor cancels
+/// @a command if this method returns true. If the command does not implement
+/// this method it does not cancel any other commands.
+- (bool) supersedesCommand:(id<AsynchronousCommand>)command;
 @end
 
 // -----------------------------------------------------------------------------
@@ -54,6 +54,25 @@
 /// the command into the HUD. Progress updates are delivered via the
 /// AsynchronousCommandDelegate protocol.
 ///
+/// CommandProcessor has one secondary thread for each execution lane listed in
+/// the enumeration #AsynchronousCommandExecutionLane. Asynchronous commands in
+/// the same lane are executed serially, in the order in which they were
+/// submitted. Asynchronous commands in different lanes are executed in
+/// parallel. Most commands are executed in
+/// #AsynchronousCommandExecutionLaneGoModel, which serializes all changes to
+/// the Go model. There are no ordering constraints between lanes - a command
+/// that must be executed after a command in a different lane must be
+/// submitted by that command, or by its completion handler.
+///
+/// Asynchronous commands that are waiting to be executed in the same lane are
+/// ordered by their priority (see #AsynchronousCommandPriority). A newly
+/// submitted command can cancel commands that are waiting in the same lane by
+/// declaring that it supersedes them (see the AsynchronousCommand method
+/// supersedesCommand:()). CommandProcessor does not invoke doIt() on a
+/// cancelled command, but it does execute the completion handler, with the
+/// success flag set to false. Commands whose execution has already begun are
+/// never cancelled.
+///
 /// @see submitCommand:()
 // -----------------------------------------------------------------------------
 @interface CommandProcessor : NSObject <AsynchronousCommandDelegate, MBProgressHUDDelegate>
@@ -70,7 +89,12 @@
 /// thread used for asynchronous command execution.
 @property(assign, getter=shouldExit, setter=exit:) bool shouldExit;
 /// @brief Is true if the code querying this property is running in the context
-/// of this CommandProcessor's secondary thread.
+/// of this CommandProcessor's secondary thread for
+/// #AsynchronousCommandExecutionLaneGoModel.
 @property(assign, readonly) bool currentThreadIsCommandProcessorThread;
+/// @brief The number of asynchronous commands, summed over all execution
+/// lanes, that are waiting to be executed. Commands that are currently being
+/// executed are not counted.
+@property(assign, readonly) int numberOfPendingCommands;
 
 @end
@@ -18,18 +18,60 @@
 // Project includes
 #import "CommandProcessor.h"
 #import "Command.h"
+#import "../diagnostics/SessionRecorder.h"
+#import "../diagnostics/SignpostLog.h"
 #import "../main/ApplicationDelegate.h"
 
+// System includes
+#import <objc/runtime.h>
+#import <os/signpost.h>
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for CommandProcessor.
 // -----------------------------------------------------------------------------
 @interface CommandProcessor()
-@property(nonatomic, retain) NSThread* thread;
+/// @brief The secondary threads of the execution lanes. The index position of
+/// a thread is the #AsynchronousCommandExecutionLane value of its lane.
+@property(nonatomic, retain) NSArray* threads;
+/// @brief The commands that are waiting to be executed, one NSMutableArray
+/// for each execution lane, in the order in which they will be executed. The
+/// index position of an array is the #AsynchronousCommandExecutionLane value of
+/// its lane. Access must be synchronized.
+@property(nonatomic, retain) NSArray* pendingCommands;
+/// @brief The commands in @e pendingCommands that were cancelled. Access must
+/// be synchronized.
+@property(nonatomic, retain) NSMutableArray* cancelledCommands;
 @property(nonatomic, retain) MBProgressHUD* progressHUD;
+/// @brief The number of asynchronous commands that were submitted with
+/// @e showProgressHUD true, and whose execution has not ended yet.
+@property(nonatomic, assign) int numberOfCommandsShowingProgressHUD;
+/// @name Coalescing of progress updates
+/// @brief Access to these properties must be synchronized.
+//@{
+/// @brief The most recent progress reported by a command that has not yet
+/// been displayed by the HUD.
+@property(nonatomic, assign) float pendingProgress;
+/// @brief The most recent step message reported by a command that has not yet
+/// been displayed by the HUD. Is @e nil if there is no such message.
+@property(nonatomic, retain) NSString* pendingProgressMessage;
+/// @brief True if an update of the HUD with @e pendingProgress and
+/// @e pendingProgressMessage has been scheduled on the main thread.
+@property(nonatomic, assign) bool progressHUDUpdateIsScheduled;
+/// @brief The time when the HUD was last updated.
+@property(nonatomic, assign) CFAbsoluteTime timeOfLastProgressHUDUpdate;
+//@}
 @end
 
 
+// -----------------------------------------------------------------------------
+/// @brief The minimum interval between two updates of the progress HUD. Progress
+/// updates that commands report more frequently are coalesced, the most recent
+/// one wins.
+// -----------------------------------------------------------------------------
+static const CFTimeInterval progressHUDUpdateInterval = 1.0 / 30.0;
+
+
 @implementation CommandProcessor
 
 // -----------------------------------------------------------------------------
@@ -71,8 +113,14 @@ static CommandProcessor* sharedProcessor = nil;
   self = [super init];
   if (! self)
     return nil;
-  [self setupThread];
+  [self setupThreads];
   self.progressHUD = nil;
+  self.cancelledCommands = [NSMutableArray array];
+  self.numberOfCommandsShowingProgressHUD = 0;
+  self.pendingProgress = 0.0f;
+  self.pendingProgressMessage = nil;
+  self.progressHUDUpdateIsScheduled = false;
+  self.timeOfLastProgressHUDUpdate = 0;
   return self;
 }
 
@@ -82,7 +130,10 @@ static CommandProcessor* sharedProcessor = nil;
 - (void) dealloc
 {
   self.progressHUD = nil;
-  self.thread = nil;
+  self.pendingProgressMessage = nil;
+  self.threads = nil;
+  self.pendingCommands = nil;
+  self.cancelledCommands = nil;
   if (sharedProcessor == self)
     sharedProcessor = nil;
   [super dealloc];
@@ -91,13 +142,52 @@ static CommandProcessor* sharedProcessor = nil;
 // -----------------------------------------------------------------------------
 /// @brief Private helper for the initializer.
 // -----------------------------------------------------------------------------
-- (void) setupThread
+- (void) setupThreads
 {
   self.shouldExit = false;
-  self.thread = [[[NSThread alloc] initWithTarget:self
-                                         selector:@selector(mainLoop:)
-                                           object:nil] autorelease];
-  [self.thread start];
+  NSMutableArray* threads = [NSMutableArray array];
+  NSMutableArray* pendingCommands = [NSMutableArray array];
+  for (int lane = 0; lane <= AsynchronousCommandExecutionLaneMax; ++lane)
+  {
+    NSThread* thread = [[[NSThread alloc] initWithTarget:self
+                                                selector:@selector(mainLoop:)
+                                                  object:nil] autorelease];
+    [threads addObject:thread];
+    [pendingCommands addObject:[NSMutableArray array]];
+    [thread start];
+  }
+  self.threads = threads;
+  self.pendingCommands = pendingCommands;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the execution lane in which @a command is executed.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandExecutionLane) laneForCommand:(id<AsynchronousCommand>)command
+{
+  if ([command respondsToSelector:@selector(executionLane)])
+    return command.executionLane;
+  else
+    return AsynchronousCommandExecutionLaneGoModel;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the priority with which @a command is executed.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandPriority) priorityForCommand:(id<AsynchronousCommand>)command
+{
+  if ([command respondsToSelector:@selector(priority)])
+    return command.priority;
+  else
+    return AsynchronousCommandPriorityNormal;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the secondary thread in which @a command is executed.
+// -----------------------------------------------------------------------------
+- (NSThread*) threadForCommand:(id<AsynchronousCommand>)command
+{
+  return [self.threads objectAtIndex:[self laneForCommand:command]];
 }
 
 // -----------------------------------------------------------------------------
@@ -134,14 +224,14 @@ static CommandProcessor* sharedProcessor = nil;
 ///
 /// If @a command conforms to the AsynchronousCommand protocol, what happens
 /// next depends on the current thread context:
-/// - If the current thread already is the secondary thread in which all
-///   asynchronous commands are executed, then the command is executed
-///   synchronously. This occurs if an asynchronous command submits another
-///   command.
+/// - If the current thread already is the secondary thread of the execution
+///   lane of @a command, then the command is executed synchronously. This
+///   occurs if an asynchronous command submits another command in the same
+///   lane.
 /// - If the current thread is the main thread (or any other secondary thread
-///   that is not the command execution thread), then control immediately
-///   returns to the caller and the command is executed in the context of the
-///   command execution secondary thread.
+///   that is not the command execution thread of the lane of @a command), then
+///   control immediately returns to the caller and the command is executed in
+///   the context of the command execution secondary thread of its lane.
 ///
 /// If @a command is executed synchronously (which as noted above may be the
 /// case even if a command conform to the AsynchronousCommand protocol), this
@@ -160,13 +250,15 @@ static CommandProcessor* sharedProcessor = nil;
 // -----------------------------------------------------------------------------
 - (bool) submitCommand:(id<Command>)command
 {
+  [[SessionRecorder sharedRecorder] recordCommand:command];
+
   bool executionResult = true;
   if ([command conformsToProtocol:@protocol(AsynchronousCommand)])
   {
     id<AsynchronousCommand> asynchronousCommand = (NSObject<AsynchronousCommand>*)command;
     asynchronousCommand.asynchronousCommandDelegate = self;
 
-    if ([NSThread currentThread] == self.thread)
+    if ([NSThread currentThread] == [self threadForCommand:asynchronousCommand])
       executionResult = [self executeCommand:command];
     else
       [self submitAsynchronousCommand:asynchronousCommand];
@@ -182,6 +274,10 @@ static CommandProcessor* sharedProcessor = nil;
 /// @brief Initializes the HUD, then submits @a command to the command execution
 /// secondary thread. Returns immediately before command execution begins.
 ///
+/// @a command is inserted into the list of commands waiting in its lane
+/// according to its priority. Waiting commands that @a command supersedes are
+/// cancelled.
+///
 /// This helper method can be executed in arbitrary thread contexts (except for
 /// the context of the command execution secondary thread).
 // -----------------------------------------------------------------------------
@@ -189,41 +285,98 @@ static CommandProcessor* sharedProcessor = nil;
 {
   if (command.showProgressHUD)
   {
+    @synchronized(self)
+    {
+      self.numberOfCommandsShowingProgressHUD++;
+    }
     BOOL animated = YES;
     [self.progressHUD showAnimated:animated];
   }
 
-  // Retain to make sure that object is still alive when it "arrives" in
-  // the secondary thread
-  [command retain];
-  [self performSelector:@selector(executeCommandAsynchronously:)
-               onThread:self.thread
-             withObject:command
+  enum AsynchronousCommandExecutionLane lane = [self laneForCommand:command];
+  enum AsynchronousCommandPriority priority = [self priorityForCommand:command];
+  bool commandCanSupersede = [command respondsToSelector:@selector(supersedesCommand:)];
+  @synchronized(self)
+  {
+    NSMutableArray* pendingCommandsInLane = [self.pendingCommands objectAtIndex:lane];
+    NSUInteger insertionIndex = pendingCommandsInLane.count;
+    for (NSUInteger index = pendingCommandsInLane.count; index > 0; --index)
+    {
+      id<AsynchronousCommand> pendingCommand = [pendingCommandsInLane objectAtIndex:index - 1];
+      if ([self priorityForCommand:pendingCommand] >= priority)
+        break;
+      insertionIndex = index - 1;
+    }
+    for (id<AsynchronousCommand> pendingCommand in pendingCommandsInLane)
+    {
+      if (! commandCanSupersede)
+        break;
+      if ([self.cancelledCommands indexOfObjectIdenticalTo:pendingCommand] != NSNotFound)
+        continue;
+      if ([command supersedesCommand:pendingCommand])
+      {
+        DDLogInfo(@"Cancelling %@, it is superseded by %@", pendingCommand, command);
+        [self.cancelledCommands addObject:pendingCommand];
+      }
+    }
+    [pendingCommandsInLane insertObject:command atIndex:insertionIndex];
+  }
+
+  // Every submitted command, including commands that are cancelled later on,
+  // triggers exactly one execution in the secondary thread
+  [self performSelector:@selector(executeNextPendingCommandInLane:)
+               onThread:[self threadForCommand:command]
+             withObject:[NSNumber numberWithInt:lane]
           waitUntilDone:NO];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Invokes executeCommand:() to execute the asynchronous @a command.
+/// @brief Removes the next command from the list of commands waiting in
+/// @a lane, then invokes executeCommand:() to execute the command, or
+/// cancelCommand:() if the command was cancelled.
 ///
 /// This helper method is always executed in the command execution secondary
-/// thread.
+/// thread of @a lane.
 // -----------------------------------------------------------------------------
-- (void) executeCommandAsynchronously:(id<AsynchronousCommand>)command
+- (void) executeNextPendingCommandInLane:(NSNumber*)lane
 {
-  // Undo retain message sent to the command object by
-  // submitAsynchronousCommand:()
-  [command autorelease];
-  [self executeCommand:command];
+  id<AsynchronousCommand> command;
+  bool commandIsCancelled;
+  @synchronized(self)
+  {
+    NSMutableArray* pendingCommandsInLane = [self.pendingCommands objectAtIndex:[lane intValue]];
+    // Keep the object alive after it has been removed from the array
+    command = [[[pendingCommandsInLane objectAtIndex:0] retain] autorelease];
+    [pendingCommandsInLane removeObjectAtIndex:0];
+    NSUInteger indexOfCancelledCommand = [self.cancelledCommands indexOfObjectIdenticalTo:command];
+    commandIsCancelled = (indexOfCancelledCommand != NSNotFound);
+    if (commandIsCancelled)
+      [self.cancelledCommands removeObjectAtIndex:indexOfCancelledCommand];
+  }
+
+  if (commandIsCancelled)
+    [self cancelCommand:command];
+  else
+    [self executeCommand:command];
   if (command.showProgressHUD)
     [self performSelectorOnMainThread:@selector(hideProgressHUDOnMainThread) withObject:nil waitUntilDone:YES];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper method for executeCommandAsynchronously that must run
-/// in the context of the main thread.
+/// @brief Private helper method for executeNextPendingCommandInLane:() that
+/// must run in the context of the main thread.
 // -----------------------------------------------------------------------------
 - (void) hideProgressHUDOnMainThread
 {
+  // Commands in different lanes share the HUD, it must remain visible until
+  // the last of them ends
+  @synchronized(self)
+  {
+    self.numberOfCommandsShowingProgressHUD--;
+    if (self.numberOfCommandsShowingProgressHUD > 0)
+      return;
+  }
+
   // UI operations must occur on the main thread
   [self.progressHUD removeFromSuperview];
   self.progressHUD = nil;
@@ -238,9 +391,31 @@ static CommandProcessor* sharedProcessor = nil;
 /// for synchronous and asynchronous command execution, thus it can be executed
 /// in arbitrary thread contexts.
 ///
+/// The execution is wrapped in an os_signpost interval of category
+/// #SignpostCategoryCommands.
+///
 /// @see submitCommand:()
 // -----------------------------------------------------------------------------
 - (bool) executeCommand:(id<Command>)command
+{
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryCommands];
+  os_signpost_id_t signpostID = os_signpost_id_make_with_pointer(signpostLog, command);
+  os_signpost_interval_begin(signpostLog, signpostID, "ExecuteCommand", "%{public}s", object_getClassName(command));
+  @try
+  {
+    return [self doExecuteCommand:command];
+  }
+  @finally
+  {
+    os_signpost_interval_end(signpostLog, signpostID, "ExecuteCommand");
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for executeCommand:(). Executes @a command and its
+/// completion handler.
+// -----------------------------------------------------------------------------
+- (bool) doExecuteCommand:(id<Command>)command
 {
   DDLogInfo(@"Executing %@", command);
   bool result;
@@ -284,8 +459,22 @@ static CommandProcessor* sharedProcessor = nil;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief The command execution secondary thread's main loop method. Returns
-/// only after the @e shouldExit property has been set to true.
+/// @brief Executes the completion handler of the cancelled @a command, without
+/// invoking doIt() on @a command.
+///
+/// This is a private helper for executeNextPendingCommandInLane:().
+// -----------------------------------------------------------------------------
+- (void) cancelCommand:(id<Command>)command
+{
+  DDLogInfo(@"Command execution cancelled (%@)", command);
+  if (command.completionHandler)
+    command.completionHandler(command, false);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief The main loop method of the command execution secondary thread of
+/// each execution lane. Returns only after the @e shouldExit property has been
+/// set to true.
 // -----------------------------------------------------------------------------
 - (void) mainLoop:(id)object
 {
@@ -321,16 +510,30 @@ static CommandProcessor* sharedProcessor = nil;
 
 // -----------------------------------------------------------------------------
 /// @brief AsynchronousCommandDelegate method
+///
+/// Does not wait for the HUD to be updated. Updates are coalesced so that the
+/// HUD is updated at most once per #progressHUDUpdateInterval, regardless of
+/// how often commands report progress. The most recent progress and the most
+/// recent step message win.
 // -----------------------------------------------------------------------------
 - (void) asynchronousCommand:(id<AsynchronousCommand>)command didProgress:(float)progress nextStepMessage:(NSString*)message
 {
-  NSNumber* progressAsNSNumber = [NSNumber numberWithFloat:progress];
-  NSArray* progressInfo;
-  if (message)
-    progressInfo = [NSArray arrayWithObjects:progressAsNSNumber, message, nil];
-  else
-    progressInfo = [NSArray arrayWithObjects:progressAsNSNumber, nil];
-  [self performSelectorOnMainThread:@selector(updateProgressHUDOnMainThread:) withObject:progressInfo waitUntilDone:YES];
+  NSTimeInterval delay;
+  @synchronized(self)
+  {
+    self.pendingProgress = progress;
+    if (message)
+      self.pendingProgressMessage = message;
+    if (self.progressHUDUpdateIsScheduled)
+      return;
+    self.progressHUDUpdateIsScheduled = true;
+    CFTimeInterval timeSinceLastProgressHUDUpdate = CFAbsoluteTimeGetCurrent() - self.timeOfLastProgressHUDUpdate;
+    delay = MAX(0.0, progressHUDUpdateInterval - timeSinceLastProgressHUDUpdate);
+  }
+
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+    [self updateProgressHUDOnMainThread];
+  });
 }
 
 // -----------------------------------------------------------------------------
@@ -338,13 +541,28 @@ static CommandProcessor* sharedProcessor = nil;
 /// asynchronousCommand:didProgress:nextStepMessage: that must run in the
 /// context of the main thread.
 // -----------------------------------------------------------------------------
-- (void) updateProgressHUDOnMainThread:(NSArray*)progressInfo
+- (void) updateProgressHUDOnMainThread
 {
+  float progress;
+  NSString* message;
+  @synchronized(self)
+  {
+    progress = self.pendingProgress;
+    message = [[self.pendingProgressMessage retain] autorelease];
+    self.pendingProgressMessage = nil;
+    self.progressHUDUpdateIsScheduled = false;
+    self.timeOfLastProgressHUDUpdate = CFAbsoluteTimeGetCurrent();
+  }
+
+  // The command may have ended while the update was scheduled. Don't use the
+  // property getter, it would create a new HUD.
+  if (! _progressHUD)
+    return;
+
   // UI operations must occur on the main thread
-  NSNumber* progressAsNSNumber = [progressInfo objectAtIndex:0];
-  self.progressHUD.progress = [progressAsNSNumber floatValue];
-  if (progressInfo.count > 1)
-    self.progressHUD.label.text = (NSString*)[progressInfo objectAtIndex:1];
+  _progressHUD.progress = progress;
+  if (message)
+    _progressHUD.label.text = message;
 }
 
 // -----------------------------------------------------------------------------
@@ -372,7 +590,21 @@ static CommandProcessor* sharedProcessor = nil;
 // -----------------------------------------------------------------------------
 - (bool) currentThreadIsCommandProcessorThread
 {
-  return ([NSThread currentThread] == self.thread);
+  return ([NSThread currentThread] == [self.threads objectAtIndex:AsynchronousCommandExecutionLaneGoModel]);
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (int) numberOfPendingCommands
+{
+  NSUInteger numberOfPendingCommands = 0;
+  @synchronized(self)
+  {
+    for (NSArray* pendingCommandsInLane in self.pendingCommands)
+      numberOfPendingCommands += pendingCommandsInLane.count;
+  }
+  return (int)numberOfPendingCommands;
 }
 
 @end
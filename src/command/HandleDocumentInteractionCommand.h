@@ -30,6 +30,15 @@
 /// HandleDocumentInteractionCommand displays an alert to the user informing
 /// her under which name the imported .sgf file can be found in the archive.
 /// Command execution returns while the alert is still displayed.
+///
+/// The import is a single file move from the Inbox folder into the archive
+/// folder. Both folders are located in the Documents folder, so the move is a
+/// rename that takes the same time regardless of the size of the .sgf file.
+/// The .sgf file is neither decompressed nor parsed nor validated during the
+/// import. SgfcKit validates the content only when the user views the game in
+/// the archive (see ViewGameController), so importing never blocks the
+/// archive, and a file with invalid content is still imported so that the
+/// user can see what is wrong with it.
 // -----------------------------------------------------------------------------
 @interface HandleDocumentInteractionCommand : CommandBase
 {
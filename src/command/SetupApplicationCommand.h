@@ -26,6 +26,20 @@
 ///
 /// SetupApplicationCommand is executed asynchronously (unless the executor is
 /// another asynchronous command).
+///
+/// The GTP engine boots in its own thread while the application sets up the
+/// GUI and SetupApplicationCommand restores the application state. The only
+/// steps that must wait for each other are:
+/// - Restoring the application state must wait for the GTP engine, because
+///   the GTP engine must be synchronized with the restored game.
+/// - Setting the additive knowledge type must occur after restoring the
+///   application state has submitted the initial "uct_max_memory" GTP command
+///   (see SetAdditiveKnowledgeTypeCommand).
+///
+/// SetupApplicationCommand submits GTP commands that only configure the GTP
+/// engine without waiting for them, and it ends its long-running action as
+/// soon as the Go model is ready, so that the UI can display the restored
+/// board without waiting for the GTP engine to finish setting itself up.
 // -----------------------------------------------------------------------------
 @interface SetupApplicationCommand : CommandBase <AsynchronousCommand>
 {
@@ -22,6 +22,7 @@
 #import "diagnostics/RestoreBugReportApplicationStateCommand.h"
 #import "gtp/LoadOpeningBookCommand.h"
 #import "gtp/SetAdditiveKnowledgeTypeCommand.h"
+#import "../diagnostics/SignpostLog.h"
 #import "../go/GoBoardPosition.h"
 #import "../go/GoGame.h"
 #import "../go/GoScore.h"
@@ -30,6 +31,9 @@
 #import "../shared/LongRunningActionCounter.h"
 #import "../ui/UiSettingsModel.h"
 
+// System includes
+#import <os/signpost.h>
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for SetupApplicationCommand.
@@ -80,6 +84,10 @@
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryLaunch];
+  os_signpost_id_t signpostID = os_signpost_id_generate(signpostLog);
+  os_signpost_interval_begin(signpostLog, signpostID, "SetupApplication");
+
   @try
   {
     [self.asynchronousCommandDelegate asynchronousCommand:self
@@ -115,7 +123,9 @@
     }
     else
     {
+      os_signpost_interval_begin(signpostLog, signpostID, "RestoreApplicationState");
       [[ApplicationStateManager sharedManager] restoreApplicationState];
+      os_signpost_interval_end(signpostLog, signpostID, "RestoreApplicationState");
 
       // Board position vs. UIAreaPlayMode
       // - The documentation block below describes, with relevance to scoring,
@@ -175,17 +185,20 @@
         [[[[HandleDocumentInteractionCommand alloc] init] autorelease] submit];
       }
     }
-
-    // Run this command *AFTER* the initial "uct_max_memory" GTP command has
-    // been submitted to the GTP engine. See the command's class documentation
-    // for details.
-    [[[[SetAdditiveKnowledgeTypeCommand alloc] init] autorelease] submit];
   }
   @finally
   {
+    // The Go model is ready, the UI can now display it
     [[LongRunningActionCounter sharedCounter] decrement];
+
+    os_signpost_interval_end(signpostLog, signpostID, "SetupApplication");
   }
 
+  // Run this command *AFTER* the initial "uct_max_memory" GTP command has
+  // been submitted to the GTP engine. See the command's class documentation
+  // for details.
+  [[[[SetAdditiveKnowledgeTypeCommand alloc] init] autorelease] submit];
+
   return true;
 }
 
@@ -27,6 +27,11 @@
 ///
 /// The user manual content is obtained from the resource bundle.
 ///
+/// SetupUserManualCommand only accesses the file system, it is therefore
+/// executed in #AsynchronousCommandExecutionLaneIndependent. This allows the
+/// setup to proceed while a long-running command that accesses the Go model
+/// (e.g. loading a game during application launch) is executing.
+///
 /// @note Even though command execution occurs asynchronously this command
 /// does not disable a progress HUD. The submitter of the command is responsible
 /// to handle UI feedback during command execution.
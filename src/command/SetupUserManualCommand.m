@@ -49,6 +49,14 @@
   return self;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand property.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandExecutionLane) executionLane
+{
+  return AsynchronousCommandExecutionLaneIndependent;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Executes this command. See the class documentation for details.
 // -----------------------------------------------------------------------------
@@ -36,6 +36,19 @@
 /// is overwritten. If an error occurs BackupGameToSgfCommand does not display
 /// an alert, this is the task of whoever invokes BackupGameToSgfCommand.
 ///
+/// BackupGameToSgfCommand lets SaveSgfCommand skip its validation step,
+/// because the .sgf file is written while the application goes to the
+/// background, and an invalid backup file is never written anyway.
+///
+/// By default BackupGameToSgfCommand does not write the .sgf file right away.
+/// Instead it notifies ApplicationStateManager that the .sgf file is stale, and
+/// ApplicationStateManager invokes BackupGameToSgfCommand again with
+/// @e writeImmediately set to true when the application goes to the
+/// background. Clients can therefore execute BackupGameToSgfCommand after every
+/// change to the game without having to worry about the cost of rewriting the
+/// entire .sgf file every time. See the ApplicationStateManager class
+/// documentation for details.
+///
 /// BackupGameToSgfCommand executes synchronously.
 ///
 /// @see SaveSgfCommand
@@ -46,4 +59,9 @@
 {
 }
 
+/// @brief True if the .sgf file should be written right away, false if writing
+/// the .sgf file should be delayed until the application goes to the
+/// background. This is false by default.
+@property(nonatomic, assign) bool writeImmediately;
+
 @end
@@ -18,20 +18,47 @@
 // Project includes
 #import "BackupGameToSgfCommand.h"
 #import "../sgf/SaveSgfCommand.h"
+#import "../../shared/ApplicationStateManager.h"
 #import "../../utility/PathUtilities.h"
 
 
 @implementation BackupGameToSgfCommand
 
+// -----------------------------------------------------------------------------
+/// @brief Initializes a BackupGameToSgfCommand object.
+///
+/// @note This is the designated initializer of BackupGameToSgfCommand.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.writeImmediately = false;
+
+  return self;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Executes this command. See the class documentation for details.
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
+  if (! self.writeImmediately)
+  {
+    [[ApplicationStateManager sharedManager] sgfBackupDidBecomeStale];
+    return true;
+  }
+
   NSString* backupFolderPath = [PathUtilities backupFolderPath];
   NSString* filePath = [backupFolderPath stringByAppendingPathComponent:sgfBackupFileName];
 
   SaveSgfCommand* saveSgfCommand = [[[SaveSgfCommand alloc] initWithSgfFilePath:filePath sgfFileAlreadyExists:true] autorelease];
+  // The backup is written while the application goes to the background, where
+  // time is short, so we skip the validation dry run
+  saveSgfCommand.validateSgfContent = false;
   bool success = [saveSgfCommand submit];
 
   return success;
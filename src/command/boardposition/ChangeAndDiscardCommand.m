@@ -27,8 +27,7 @@
 #import "../../go/GoPlayer.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../player/Player.h"
-#import "../../shared/ApplicationStateManager.h"
-#import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../play/model/BoardPositionModel.h"
 
 
@@ -46,8 +45,7 @@
 
   @try
   {
-    [[ApplicationStateManager sharedManager] beginSavePoint];
-    [[LongRunningActionCounter sharedCounter] increment];
+    [[ModelMutationTransaction sharedTransaction] begin];
 
     bool success;
 
@@ -94,9 +92,9 @@
   }
   @finally
   {
-    [[ApplicationStateManager sharedManager] applicationStateDidChange];
-    [[ApplicationStateManager sharedManager] commitSavePoint];
-    [[LongRunningActionCounter sharedCounter] decrement];
+    ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
+    [transaction applicationStateDidChange];
+    [transaction commit];
   }
 }
 
@@ -233,10 +231,10 @@
   bool newNodesWillBeMergedIntoCurrentGameVariation = (firstNodeToDiscard.hasNextSibling ||
                                                        firstNodeToDiscard.hasPreviousSibling);
 
-  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
 
   if (newNodesWillBeMergedIntoCurrentGameVariation)
-    [center postNotificationName:currentGameVariationWillChange object:nil];
+    [transaction postNotificationName:currentGameVariationWillChange object:nil];
 
   // This counts only the direct descendant nodes in the current game variation.
   // If any of the children of the first discarded node has siblings then
@@ -255,13 +253,13 @@
   if (oldNumberOfBoardPositions != newNumberOfBoardPositions)
   {
     boardPosition.numberOfBoardPositions = newNumberOfBoardPositions;
-    [center postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
+    [transaction postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
   }
 
   if (newNodesWillBeMergedIntoCurrentGameVariation)
-    [center postNotificationName:currentGameVariationDidChange object:nil];
+    [transaction postNotificationName:currentGameVariationDidChange object:nil];
 
-  [center postNotificationName:goNodeTreeLayoutDidChange object:nil];
+  [transaction postNotificationName:goNodeTreeLayoutDidChange object:[nodeModel finishTreeChangeBatch]];
 
   return true;
 }
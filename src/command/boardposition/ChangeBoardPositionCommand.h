@@ -33,7 +33,9 @@
 /// new board position is more than this limit away from the current board
 /// position. To achieve this effect, the various initializers will sometimes
 /// return an object that is an instance of a private subclass of
-/// ChangeBoardPositionCommand.
+/// ChangeBoardPositionCommand. An asynchronous ChangeBoardPositionCommand that
+/// is still waiting to be executed is cancelled when a newer asynchronous
+/// ChangeBoardPositionCommand is submitted.
 ///
 /// @note initSynchronousExecutionWithBoardPosition:() can be used to enforce
 /// synchronous execution.
@@ -58,6 +60,14 @@
 ///   can be restored when the application launches the next time. Whoever
 ///   executes ChangeBoardPositionCommand is responsible for actually saving the
 ///   application state to disk.
+///
+/// When the user steps through a game one board position at a time, each step
+/// replays a single node via GoNode::modifyBoard() and the board view redraws
+/// only those intersections whose stone state changed (see
+/// StonesLayerDelegate). Board positions are not computed or rendered ahead of
+/// time on a secondary thread: GoNode::modifyBoard() records state that
+/// GoNode::revertBoard() later depends on, and neither the Go model nor the
+/// GTP engine synchronization are thread-safe.
 // -----------------------------------------------------------------------------
 @interface ChangeBoardPositionCommand : CommandBase
 {
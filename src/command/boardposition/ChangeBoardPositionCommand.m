@@ -26,6 +26,7 @@
 #import "../../main/ApplicationDelegate.h"
 #import "../../shared/ApplicationStateManager.h"
 #import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../ui/UiSettingsModel.h"
 
 
@@ -201,8 +202,10 @@
     int oldCurrentBoardPosition = boardPosition.currentBoardPosition;
     boardPosition.currentBoardPosition = self.newBoardPosition;
 
-    NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
-    [center postNotificationName:currentBoardPositionDidChange object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:self.newBoardPosition]]];
+    ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
+    [transaction postNotificationName:currentBoardPositionDidChange
+                               object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:self.newBoardPosition]]
+                             userInfo:@{changedPointsKey: [boardPosition finishChangedPointsBatch]}];
 
     SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
     bool syncSuccess = [syncCommand submit];
@@ -281,6 +284,19 @@
   return result;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand method.
+///
+/// The new board position is always given as an absolute value that was
+/// determined from what the user saw when the command was created. A board
+/// position change that is still waiting to be executed is therefore made
+/// obsolete by a newer one.
+// -----------------------------------------------------------------------------
+- (bool) supersedesCommand:(id<AsynchronousCommand>)command
+{
+  return [(NSObject*)command isKindOfClass:[AsynchronousChangeBoardPositionCommand class]];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Private helper for doIt().
 // -----------------------------------------------------------------------------
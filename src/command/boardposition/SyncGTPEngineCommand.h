@@ -43,6 +43,23 @@ enum SyncBoardPositionType
 ///
 /// Board positions for nodes that contain neither setup nor a move are ignored.
 ///
+/// If possible SyncGTPEngineCommand synchronizes the GTP engine incrementally,
+/// i.e. it takes back only those moves that the GTP engine knows about but
+/// that are no longer needed, then plays only the moves that the GTP engine
+/// does not know about yet. This requires that GtpEngineState knows the board
+/// state of the GTP engine, and that the GTP engine already has the same setup.
+/// An incremental sync preserves the GTP engine's search tree, so moving back
+/// and forth between board positions does not force the GTP engine to start
+/// every search from scratch.
+/// If this is not the case, e.g. after a game variation change that crosses a
+/// setup node, the GTP engine is synchronized from scratch by clearing the
+/// board and replaying the entire setup and all moves.
+///
+/// The commands are submitted to the GTP engine as a pipeline. If one of the
+/// commands fails, SyncGTPEngineCommand falls back to synchronizing the GTP
+/// engine from scratch, submitting one command at a time and stopping at the
+/// first command that fails.
+///
 /// If execution of SyncGTPEngineCommand fails, the GTP engine is left in an
 /// unknown state.
 // -----------------------------------------------------------------------------
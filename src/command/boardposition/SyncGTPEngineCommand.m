@@ -27,8 +27,11 @@
 #import "../../go/GoPoint.h"
 #import "../../go/GoUtilities.h"
 #import "../../go/GoVertex.h"
+#import "../../gtp/GtpClient.h"
 #import "../../gtp/GtpCommand.h"
+#import "../../gtp/GtpEngineState.h"
 #import "../../gtp/GtpResponse.h"
+#import "../../main/ApplicationDelegate.h"
 
 
 // -----------------------------------------------------------------------------
@@ -77,38 +80,71 @@
   GoNodeSetup* nodeSetupUpToWhichToSync = [self findeNodeSetupUpToWhichToSync:syncUpToThisNode];
   GoMove* syncUpToThisMove = [self findeMoveUpToWhichToSync:syncUpToThisNode];
 
-  // This clears all board state related parameters (handicap, komi, setup
-  // stones, setup player, moves) but leaves board size, game rules and player
-  // configuration (e.g. UCT parameters) untouched
-  if (! [self syncGTPEngineClearBoard])
+  // The setup and the moves that the GTP engine must know about when the sync
+  // is complete
+  NSMutableArray* setupCommandStrings = [NSMutableArray array];
+  [self addSetupStonesCommandString:setupCommandStrings nodeSetupUpToWhichToSync:nodeSetupUpToWhichToSync];
+  [self addSetupPlayerCommandString:setupCommandStrings nodeSetupUpToWhichToSync:nodeSetupUpToWhichToSync];
+  NSMutableArray* moves = [NSMutableArray array];
+  if (! [self addMoves:moves syncUpToThisMove:syncUpToThisMove])
   {
-    DDLogError(@"%@: Aborting because syncGTPEngineClearBoard failed: %@", [self shortDescription], self.errorDescription);
+    DDLogError(@"%@: Aborting because addMoves failed", [self shortDescription]);
     return false;
   }
 
-  if (! [self syncGTPEngineKomi])
-  {
-    DDLogError(@"%@: Aborting because syncGTPEngineKomi failed: %@", [self shortDescription], self.errorDescription);
-    return false;
-  }
+  // All commands are submitted as a pipeline so that the entire sync takes
+  // only one round-trip to the GTP engine
+  NSArray* commands = [self gtpCommandsToSyncSetupCommandStrings:setupCommandStrings moves:moves];
 
-  if (! [self syncGTPEngineHandicapAndSetupStones:nodeSetupUpToWhichToSync])
-  {
-    DDLogError(@"%@: Aborting because syncGTPEngineHandicapAndSetupStones failed: %@", [self shortDescription], self.errorDescription);
-    return false;
-  }
+  [GtpCommand submitCommands:commands];
 
-  if (! [self syncGTPEngineSetupPlayer:nodeSetupUpToWhichToSync])
+  // The responses are evaluated in the order in which the commands were
+  // submitted. Because the commands were pipelined, a failed command does not
+  // prevent the GTP engine from executing the commands that follow it. These
+  // commands were executed on top of a board state that is not the expected
+  // one, so the board state of the GTP engine is now unknown and the GTP
+  // engine must be synchronized from scratch.
+  for (GtpCommand* command in commands)
   {
-    DDLogError(@"%@: Aborting because syncGTPEngineSetupPlayer failed: %@", [self shortDescription], self.errorDescription);
-    return false;
+    if (! command.response.status)
+    {
+      DDLogWarn(@"%@: Pipelined GTP command %@ failed: %@, falling back to full sync", [self shortDescription], command.command, command.response.parsedResponse);
+      return [self syncGTPEngineFromScratchWithSetupCommandStrings:setupCommandStrings moves:moves];
+    }
   }
 
-  if (! [self syncGTPEngineMoves:syncUpToThisMove])
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Synchronizes the GTP engine from scratch
+/// with the setup in @a setupCommandStrings and the moves in @a moves. Returns
+/// true on success, false on failure.
+///
+/// The commands are submitted one by one, not as a pipeline, so that the first
+/// failed command prevents the commands that follow it from being executed.
+/// On failure the property @e errorDescription is set to the response of the
+/// failed command.
+// -----------------------------------------------------------------------------
+- (bool) syncGTPEngineFromScratchWithSetupCommandStrings:(NSArray*)setupCommandStrings moves:(NSArray*)moves
+{
+  // Forget about the board state of the GTP engine so that the commands start
+  // with "clear_board"
+  [[ApplicationDelegate sharedDelegate].gtpClient.engineState invalidate];
+
+  NSArray* commands = [self gtpCommandsToSyncSetupCommandStrings:setupCommandStrings moves:moves];
+  for (GtpCommand* command in commands)
   {
-    DDLogError(@"%@: Aborting because syncGTPEngineMoves failed: %@", [self shortDescription], self.errorDescription);
-    return false;
+    [command submit];
+    assert(command.response.status);
+    if (! command.response.status)
+    {
+      self.errorDescription = command.response.parsedResponse;
+      DDLogError(@"%@: Aborting because GTP command %@ failed: %@", [self shortDescription], command.command, self.errorDescription);
+      return false;
+    }
   }
+
   return true;
 }
 
@@ -186,39 +222,105 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt(). Returns true on success, false on failure.
+/// @brief Private helper for doIt(). Returns the GTP commands that need to be
+/// submitted so that the GTP engine afterwards knows about the setup in
+/// @a setupCommandStrings and the moves in @a moves.
+///
+/// If GtpEngineState knows the current board state of the GTP engine, and the
+/// GTP engine already has the same setup, the GTP engine is synchronized
+/// incrementally: Moves that the GTP engine knows about but that are not in
+/// @a moves are taken back with "undo", then the moves from @a moves that the
+/// GTP engine does not know about yet are played. For instance, navigating one
+/// board position back or forward requires only a single "undo" or a single
+/// move to be played, regardless of how many moves the game has. The "komi"
+/// command is omitted if the GTP engine already has the right komi. Because
+/// the board is not cleared, the GTP engine keeps its search tree, so that a
+/// later search can reuse it when the "reuse subtree" setting is enabled.
+///
+/// Otherwise, e.g. if the new board position is in a game variation with a
+/// different setup, the GTP engine is synchronized from scratch: The board is
+/// cleared, then the entire setup and all moves are replayed.
 // -----------------------------------------------------------------------------
-- (bool) syncGTPEngineClearBoard
+- (NSArray*) gtpCommandsToSyncSetupCommandStrings:(NSArray*)setupCommandStrings moves:(NSArray*)moves
 {
-  GtpCommand* commandClearBoard = [GtpCommand command:@"clear_board"];
-  [commandClearBoard submit];
-  assert(commandClearBoard.response.status);
-  if (commandClearBoard.response.status)
-    self.errorDescription = commandClearBoard.response.parsedResponse;
-  return commandClearBoard.response.status;
+  NSMutableArray* commandStrings = [NSMutableArray array];
+  NSUInteger numberOfMovesKnownByEngine = 0;
+
+  GtpEngineState* engineState = [ApplicationDelegate sharedDelegate].gtpClient.engineState;
+  NSArray* engineSetupCommandStrings;
+  NSArray* engineMoves;
+  bool canSyncIncrementally = ([engineState getSetupCommands:&engineSetupCommandStrings moves:&engineMoves] &&
+                               [engineSetupCommandStrings isEqualToArray:setupCommandStrings]);
+  if (canSyncIncrementally)
+  {
+    NSUInteger numberOfMovesInCommonPrefix = 0;
+    while (numberOfMovesInCommonPrefix < engineMoves.count &&
+           numberOfMovesInCommonPrefix < moves.count &&
+           [engineMoves[numberOfMovesInCommonPrefix] isEqualToString:moves[numberOfMovesInCommonPrefix]])
+    {
+      numberOfMovesInCommonPrefix++;
+    }
+
+    NSString* komiCommandString = [self komiCommandString];
+    if (! [engineState isKomiCommand:komiCommandString])
+      [commandStrings addObject:komiCommandString];
+    for (NSUInteger indexOfMove = numberOfMovesInCommonPrefix; indexOfMove < engineMoves.count; ++indexOfMove)
+      [commandStrings addObject:@"undo"];
+
+    numberOfMovesKnownByEngine = numberOfMovesInCommonPrefix;
+  }
+  else
+  {
+    // This clears all board state related parameters (handicap, komi, setup
+    // stones, setup player, moves) but leaves board size, game rules and
+    // player configuration (e.g. UCT parameters) untouched
+    [commandStrings addObject:@"clear_board"];
+    [commandStrings addObject:[self komiCommandString]];
+    [commandStrings addObjectsFromArray:setupCommandStrings];
+  }
+
+  if (moves.count > numberOfMovesKnownByEngine)
+  {
+    // The command string is assembled in a single buffer that is large enough
+    // for typical moves ("B D4" plus separator), so that building the string
+    // for a long game is linear and does not allocate intermediate strings
+    static const NSUInteger typicalMoveLength = 5;
+    NSUInteger numberOfMovesToPlay = moves.count - numberOfMovesKnownByEngine;
+    NSMutableString* commandString = [NSMutableString stringWithCapacity:20 + numberOfMovesToPlay * typicalMoveLength];
+    [commandString appendString:@"gogui-play_sequence"];
+    for (NSUInteger indexOfMove = numberOfMovesKnownByEngine; indexOfMove < moves.count; ++indexOfMove)
+    {
+      [commandString appendString:@" "];
+      [commandString appendString:moves[indexOfMove]];
+    }
+    [commandStrings addObject:commandString];
+  }
+
+  NSMutableArray* commands = [NSMutableArray arrayWithCapacity:commandStrings.count];
+  for (NSString* commandString in commandStrings)
+    [commands addObject:[GtpCommand command:commandString]];
+  return commands;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt(). Returns true on success, false on failure.
+/// @brief Private helper for gtpCommandsToSyncSetupCommandStrings:moves:().
+/// Returns the string for the GTP command "komi".
 // -----------------------------------------------------------------------------
-- (bool) syncGTPEngineKomi
+- (NSString*) komiCommandString
 {
   GoGame* game = [GoGame sharedGame];
 
-  // The previously sent GTP command "clear_board" has caused Fuego to reset
-  // komi to the last value that was explicitly set with the GTP command "komi"
-  // (or to the built-in default komi value, in case no "komi" command was ever
-  // sent). Therefore, unlike handicap we always have to setup komi.
-  GtpCommand* command = [GtpCommand command:[NSString stringWithFormat:@"komi %.1f", game.komi]];
-  [command submit];
-  assert(command.response.status);
-  if (! command.response.status)
-    self.errorDescription = command.response.parsedResponse;
-  return command.response.status;
+  // A "clear_board" command causes Fuego to reset komi to the last value that
+  // was explicitly set with the GTP command "komi" (or to the built-in default
+  // komi value, in case no "komi" command was ever sent). Therefore, unlike
+  // handicap we always have to setup komi.
+  return [NSString stringWithFormat:@"komi %.1f", game.komi];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt(). Returns true on success, false on failure.
+/// @brief Private helper for doIt(). Adds the string for the GTP command
+/// "gogui-setup" to @a setupCommandStrings if handicap or setup stones must be
+/// synchronized.
 ///
 /// The "gogui-setup" command does not allow to clear stones, so we can't just
 /// submit one "gogui-setup" command for each GoNodeSetup. Also we can't submit
@@ -235,7 +337,8 @@
 /// has shown that Fuego does not use the @e number of handicap stones for the
 /// evaluation of the board position.
 // -----------------------------------------------------------------------------
-- (bool) syncGTPEngineHandicapAndSetupStones:(GoNodeSetup*)nodeSetupUpToWhichToSync
+- (void) addSetupStonesCommandString:(NSMutableArray*)setupCommandStrings
+            nodeSetupUpToWhichToSync:(GoNodeSetup*)nodeSetupUpToWhichToSync
 {
   NSMutableArray* blackSetupPoints = [NSMutableArray array];
   NSMutableArray* whiteSetupPoints = [NSMutableArray array];
@@ -264,9 +367,15 @@
   }
 
   if (blackSetupPoints.count == 0 && whiteSetupPoints.count == 0)
-    return true;
-
-  NSString* commandString = @"gogui-setup";
+    return;
+
+  // The command string is assembled in a single buffer that is large enough
+  // for typical setup stones (" B D4"), so that building the string is linear
+  // and does not allocate intermediate strings
+  static const NSUInteger typicalSetupStoneLength = 5;
+  NSUInteger numberOfSetupStones = blackSetupPoints.count + whiteSetupPoints.count;
+  NSMutableString* commandString = [NSMutableString stringWithCapacity:20 + numberOfSetupStones * typicalSetupStoneLength];
+  [commandString appendString:@"gogui-setup"];
   for (NSNumber* stoneColorAsNumber in @[[NSNumber numberWithInt:GoColorBlack], [NSNumber numberWithInt:GoColorWhite]])
   {
     enum GoColor stoneColor = [stoneColorAsNumber intValue];
@@ -286,33 +395,33 @@
 
     for (GoPoint* setupPoint in setupPoints)
     {
-      NSString* setupStoneString = [NSString stringWithFormat:@" %@ %@", colorString, setupPoint.vertex.string];
-      commandString = [commandString stringByAppendingString:setupStoneString];
+      [commandString appendString:@" "];
+      [commandString appendString:colorString];
+      [commandString appendString:@" "];
+      [commandString appendString:setupPoint.vertex.string];
     }
   }
 
-  GtpCommand* command = [GtpCommand command:commandString];
-  [command submit];
-  assert(command.response.status);
-  if (! command.response.status)
-    self.errorDescription = command.response.parsedResponse;
-  return command.response.status;
+  [setupCommandStrings addObject:commandString];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt(). Returns true on success, false on failure.
+/// @brief Private helper for doIt(). Adds the string for the GTP command
+/// "gogui-setup_player" to @a setupCommandStrings if a setup player must be
+/// synchronized.
 // -----------------------------------------------------------------------------
-- (bool) syncGTPEngineSetupPlayer:(GoNodeSetup*)nodeSetupUpToWhichToSync
+- (void) addSetupPlayerCommandString:(NSMutableArray*)setupCommandStrings
+            nodeSetupUpToWhichToSync:(GoNodeSetup*)nodeSetupUpToWhichToSync
 {
   if (! nodeSetupUpToWhichToSync)
-    return true;
+    return;
 
   enum GoColor setupFirstMoveColor = nodeSetupUpToWhichToSync.setupFirstMoveColor;
   if (setupFirstMoveColor == GoColorNone)
   {
     setupFirstMoveColor = nodeSetupUpToWhichToSync.previousSetupFirstMoveColor;
     if (setupFirstMoveColor == GoColorNone)
-      return true;
+      return;
   }
 
   NSString* colorString;
@@ -323,25 +432,22 @@
 
   NSString* commandString = [NSString stringWithFormat:@"gogui-setup_player %@", colorString];
 
-  GtpCommand* command = [GtpCommand command:commandString];
-  [command submit];
-  assert(command.response.status);
-  if (! command.response.status)
-    self.errorDescription = command.response.parsedResponse;
-  return command.response.status;
+  [setupCommandStrings addObject:commandString];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt(). Returns true on success, false on failure.
+/// @brief Private helper for doIt(). Adds the moves that must be synchronized
+/// to @a moves, in the format used by GtpEngineState. Returns true on success,
+/// false on failure.
 // -----------------------------------------------------------------------------
-- (bool) syncGTPEngineMoves:(GoMove*)syncUpToThisMove
+- (bool) addMoves:(NSMutableArray*)moves
+ syncUpToThisMove:(GoMove*)syncUpToThisMove
 {
   if (! syncUpToThisMove)
     return true;
 
   GoNodeModel* nodeModel = [GoGame sharedGame].nodeModel;
 
-  NSString* commandString = @"gogui-play_sequence";
   int numberOfNodes = nodeModel.numberOfNodes;
   for (int indexOfNode = 0; indexOfNode < numberOfNodes; ++indexOfNode)
   {
@@ -350,17 +456,14 @@
     GoMove* move = node.goMove;
     if (move)
     {
-      if (move.player.black)
-        commandString = [commandString stringByAppendingString:@" B "];
-      else
-        commandString = [commandString stringByAppendingString:@" W "];
+      NSString* colorString = move.player.black ? @"B" : @"W";
       switch (move.type)
       {
         case GoMoveTypePlay:
-          commandString = [commandString stringByAppendingString:move.point.vertex.string];
+          [moves addObject:[NSString stringWithFormat:@"%@ %@", colorString, [move.point.vertex.string uppercaseString]]];
           break;
         case GoMoveTypePass:
-          commandString = [commandString stringByAppendingString:@" PASS"];
+          [moves addObject:[NSString stringWithFormat:@"%@ PASS", colorString]];
           break;
         default:
           DDLogError(@"%@: Unexpected move type %d", [self shortDescription], move.type);
@@ -373,12 +476,7 @@
     }
   }
 
-  GtpCommand* commandSetup = [GtpCommand command:commandString];
-  [commandSetup submit];
-  assert(commandSetup.response.status);
-  if (! commandSetup.response.status)
-    self.errorDescription = commandSetup.response.parsedResponse;
-  return commandSetup.response.status;
+  return true;
 }
 
 @end
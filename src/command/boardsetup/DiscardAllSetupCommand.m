@@ -23,8 +23,7 @@
 #import "../../go/GoGame.h"
 #import "../../go/GoBoardPosition.h"
 #import "../../main/ApplicationDelegate.h"
-#import "../../shared/ApplicationStateManager.h"
-#import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../ui/UiSettingsModel.h"
 #import "../../ui/UIViewControllerAdditions.h"
 
@@ -111,8 +110,7 @@
 
   @try
   {
-    [[ApplicationStateManager sharedManager] beginSavePoint];
-    [[LongRunningActionCounter sharedCounter] increment];
+    [[ModelMutationTransaction sharedTransaction] begin];
 
     GoBoardPosition* boardPosition = game.boardPosition;
     if (boardPosition.numberOfBoardPositions > 0 || game.state == GoGameStateGameHasEnded)
@@ -133,7 +131,7 @@
 
     [[NSNotificationCenter defaultCenter] postNotificationName:allSetupStonesDidDiscard object:nil];
     GoNode* nodeWithChangedSetupData = boardPosition.currentNode;
-    [[NSNotificationCenter defaultCenter] postNotificationName:nodeSetupDataDidChange object:nodeWithChangedSetupData];
+    [[ModelMutationTransaction sharedTransaction] postNotificationName:nodeSetupDataDidChange object:nodeWithChangedSetupData];
 
     SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
     bool syncSuccess = [syncCommand submit];
@@ -151,9 +149,9 @@
   }
   @finally
   {
-    [[ApplicationStateManager sharedManager] applicationStateDidChange];
-    [[ApplicationStateManager sharedManager] commitSavePoint];
-    [[LongRunningActionCounter sharedCounter] decrement];
+    ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
+    [transaction applicationStateDidChange];
+    [transaction commit];
   }
 }
 
@@ -29,6 +29,7 @@
 #import "../../main/ApplicationDelegate.h"
 #import "../../shared/ApplicationStateManager.h"
 #import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../ui/UiSettingsModel.h"
 #import "../../ui/UIViewControllerAdditions.h"
 #import "../../utility/NSStringAdditions.h"
@@ -193,7 +194,7 @@
       [game changeSetupPoint:self.point toStoneState:newStoneState];
 
     GoNode* nodeWithChangedSetupData = boardPosition.currentNode;
-    [[NSNotificationCenter defaultCenter] postNotificationName:nodeSetupDataDidChange object:nodeWithChangedSetupData];
+    [[ModelMutationTransaction sharedTransaction] postNotificationName:nodeSetupDataDidChange object:nodeWithChangedSetupData];
 
     SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
     bool syncSuccess = [syncCommand submit];
@@ -17,6 +17,7 @@
 
 // Project includes
 #import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
 
 
 // -----------------------------------------------------------------------------
@@ -31,8 +32,24 @@
 /// archive file from the collected information. The full path where the file
 /// has been stored is available from the property
 /// @e diagnosticsInformationFilePath.
+///
+/// Command execution occurs asynchronously so that generating the file does
+/// not stall the app, even for big games. Clients that need to know when the
+/// file is ready must submit the command with a completion handler. The
+/// completion handler is not invoked on the main thread.
+///
+/// The only step that requires the main thread is taking the screenshot of
+/// #UIAreaPlay. It is taken when the command is initialized, i.e. before the
+/// progress HUD covers the UI. The screenshot is encoded as PNG only later
+/// during command execution.
+///
+/// Each piece of information is written to a temporary file and its in-memory
+/// representation is discarded before the next piece is collected, so that
+/// at most one piece is held in memory at any time. ZipKit then compresses
+/// the temporary files into the archive file by streaming them from disk in
+/// chunks.
 // -----------------------------------------------------------------------------
-@interface GenerateDiagnosticsInformationFileCommand : CommandBase
+@interface GenerateDiagnosticsInformationFileCommand : CommandBase <AsynchronousCommand>
 {
 }
 
@@ -19,6 +19,7 @@
 #import "GenerateDiagnosticsInformationFileCommand.h"
 #import "../sgf/SaveSgfCommand.h"
 #import "../../diagnostics/BugReportUtilities.h"
+#import "../../diagnostics/SessionRecorder.h"
 #import "../../go/GoGame.h"
 #import "../../gtp/GtpCommand.h"
 #import "../../gtp/GtpResponse.h"
@@ -39,11 +40,16 @@
 @interface GenerateDiagnosticsInformationFileCommand()
 @property(nonatomic, retain) NSString* diagnosticsInformationFolderPath;
 @property(nonatomic, retain) NSDictionary* registrationDomainDefaults;
+@property(nonatomic, retain) UIImage* boardScreenshot;
+@property(nonatomic, assign) float progress;
 @end
 
 
 @implementation GenerateDiagnosticsInformationFileCommand
 
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
 // -----------------------------------------------------------------------------
 /// @brief Initializes a GenerateDiagnosticsInformationFileCommand object.
 ///
@@ -77,6 +83,12 @@
   self.diagnosticsInformationFilePath = [[paths objectAtIndex:0] stringByAppendingPathComponent:bugReportDiagnosticsInformationFileName];
 
   self.registrationDomainDefaults = nil;
+  self.showProgressHUD = true;
+  self.progress = 0.0f;
+
+  // UIKit must be accessed on the main thread. Also we want to capture the
+  // board before the progress HUD is displayed on top of it.
+  [self captureBoardScreenshot];
 
   return self;
 }
@@ -90,6 +102,7 @@
   self.diagnosticsInformationFolderPath = nil;
   self.diagnosticsInformationFilePath = nil;
   self.registrationDomainDefaults = nil;
+  self.boardScreenshot = nil;
   [super dealloc];
 }
 
@@ -101,17 +114,33 @@
   bool success = true;
   @try
   {
-    [self setup];
+    [self.asynchronousCommandDelegate asynchronousCommand:self
+                                              didProgress:0.0
+                                          nextStepMessage:@"Generating diagnostics information..."];
 
-    [self saveBugReportInfo];
-    [self saveInMemoryObjects];
-    [self saveUserDefaults];
-    [self saveCurrentGameAsSgf];
-    [self saveBoardScreenshot];
-    [self saveBoardAsSeenByGtpEngine];
-    [self zipLogFiles];
+    [self setup];
 
-    [self zipDiagnosticsInformationFolder];
+    // Each step runs in its own autorelease pool so that the memory taken up
+    // by the information that the step collects is released before the next
+    // step begins
+    @autoreleasepool { [self saveBugReportInfo]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self saveInMemoryObjects]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self saveUserDefaults]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self saveCurrentGameAsSgf]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self saveBoardScreenshot]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self saveBoardAsSeenByGtpEngine]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self saveSessionRecording]; }
+    [self increaseProgressAndNotifyDelegate];
+    @autoreleasepool { [self zipLogFiles]; }
+    [self increaseProgressAndNotifyDelegate];
+
+    @autoreleasepool { [self zipDiagnosticsInformationFolder]; }
   }
   @catch (NSException* exception)
   {
@@ -140,6 +169,7 @@
   [bugReportInfoDictionary setValue:[device systemName] forKey:@"SystemName"];
   [bugReportInfoDictionary setValue:[device systemVersion] forKey:@"SystemVersion"];
   [bugReportInfoDictionary setValue:[device model] forKey:@"DeviceModel"];
+  [bugReportInfoDictionary setValue:[[ApplicationDelegate sharedDelegate] gtpTransportStatistics] forKey:@"GtpTransportStatistics"];
 
   NSString* bugReportInfoFilePath = [self.diagnosticsInformationFolderPath stringByAppendingPathComponent:bugReportInfoFileName];
   BOOL success = [bugReportInfoDictionary writeToFile:bugReportInfoFilePath atomically:YES];
@@ -243,16 +273,27 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Creates a screenshot of the views visible in #UIAreaPlay and saves
-/// that screenshot to file.
+/// @brief Creates a screenshot of the views visible in #UIAreaPlay.
+///
+/// This method must be invoked in the context of the main thread.
 // -----------------------------------------------------------------------------
-- (void) saveBoardScreenshot
+- (void) captureBoardScreenshot
 {
   DDLogVerbose(@"%@: Creating screen shot of Go board", [self shortDescription]);
 
   UIView* rootView = [MainUtility rootViewForUIAreaPlay];
-  UIImage* image = [UiUtilities captureView:rootView];
-  NSData* data = UIImagePNGRepresentation(image);
+  self.boardScreenshot = [UiUtilities captureView:rootView];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Saves the screenshot of the views visible in #UIAreaPlay to file.
+// -----------------------------------------------------------------------------
+- (void) saveBoardScreenshot
+{
+  DDLogVerbose(@"%@: Writing screen shot of Go board to file", [self shortDescription]);
+
+  NSData* data = UIImagePNGRepresentation(self.boardScreenshot);
+  self.boardScreenshot = nil;
   NSString* screenshotPath = [self.diagnosticsInformationFolderPath stringByAppendingPathComponent:bugReportScreenshotFileName];
   BOOL success = [data writeToFile:screenshotPath atomically:YES];
   if (! success)
@@ -279,6 +320,35 @@
                              toFile:[self.diagnosticsInformationFolderPath stringByAppendingPathComponent:bugReportBoardAsSeenByGtpEngineFileName]];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Saves the session recording to a .plist file. The file is not
+/// created if the session is not being recorded.
+///
+/// The session recording continues, so that a second diagnostics information
+/// file generated later in the same session contains everything recorded up
+/// to that point.
+// -----------------------------------------------------------------------------
+- (void) saveSessionRecording
+{
+  SessionRecorder* sessionRecorder = [SessionRecorder sharedRecorder];
+  if (! sessionRecorder.isRecording)
+    return;
+
+  DDLogVerbose(@"%@: Writing session recording to file", [self shortDescription]);
+
+  NSString* sessionRecordingPath = [self.diagnosticsInformationFolderPath stringByAppendingPathComponent:bugReportSessionRecordingFileName];
+  bool success = [SessionRecorder writeRecording:sessionRecorder.recordedEntries toFile:sessionRecordingPath];
+  if (! success)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Failed to write session recording to file %@", sessionRecordingPath];
+    DDLogError(@"%@: %@", [self shortDescription], errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSGenericException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Creates a .zip archive in the diagnostics information folder that
 /// contains the application log files. The .zip archive is not created if no
@@ -287,6 +357,8 @@
 - (void) zipLogFiles
 {
   DDLogVerbose(@"%@: Zipping log files", [self shortDescription]);
+  // Log messages may still be queued for the file logger
+  [DDLog flushLog];
   NSString* logFolder = [[ApplicationDelegate sharedDelegate] logFolder];
   NSFileManager* fileManager = [NSFileManager defaultManager];
   if (! [fileManager fileExistsAtPath:logFolder])
@@ -371,6 +443,16 @@
   [PathUtilities deleteItemIfExists:self.diagnosticsInformationFolderPath];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Increases the progress by one step.
+// -----------------------------------------------------------------------------
+- (void) increaseProgressAndNotifyDelegate
+{
+  // There are 9 steps, the last step completes the command
+  self.progress += 1.0f / 9;
+  [self.asynchronousCommandDelegate asynchronousCommand:self didProgress:self.progress nextStepMessage:nil];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Internal helper for saveBoardAsSeenByGtpEngine().
 // -----------------------------------------------------------------------------
@@ -76,7 +76,6 @@
   }
   [self fixObjectReferences];
   [GoUtilities relinkMoves:self.unarchivedGame];
-  [GoUtilities recalculateZobristHashes:self.unarchivedGame];
 
   [self postNotifications];
   [self syncGtpEngine];
@@ -0,0 +1,60 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ExportBoardDiagramsCommand class is responsible for exporting a
+/// range of board positions of the current game variation as board diagrams.
+/// Command execution occurs asynchronously.
+///
+/// The diagrams are exported in one of the formats listed in the enumeration
+/// #BoardDiagramExportFormat into a folder in the temporary folder (see
+/// PathUtilities::boardDiagramExportFolderPath()). The folder is emptied
+/// before each export. When the command has finished, the property
+/// @e exportedFilePaths lists the files that were written, e.g. so that the
+/// caller can share them.
+///
+/// ExportBoardDiagramsCommand captures the stones and the markup of all
+/// board positions in the range when it is initialized. This happens on the
+/// main thread and uses GoBoardPositionPreview, so the current board position
+/// does not change. The actual drawing then takes place in the background,
+/// independently of the Go model and of the board view: Each diagram is drawn
+/// by a BoardDiagram object, and bitmap images for several diagrams are drawn
+/// concurrently. Only the pages of a .pdf file are drawn one after the other
+/// because they all go into the same file.
+// -----------------------------------------------------------------------------
+@interface ExportBoardDiagramsCommand : CommandBase <AsynchronousCommand>
+{
+}
+
+- (id) initWithFirstBoardPosition:(int)firstBoardPosition
+                lastBoardPosition:(int)lastBoardPosition
+                     exportFormat:(enum BoardDiagramExportFormat)exportFormat;
+
+/// @brief The format into which the board diagrams are exported.
+@property(nonatomic, assign, readonly) enum BoardDiagramExportFormat exportFormat;
+/// @brief The base name of the exported files. The default is "Diagram".
+@property(nonatomic, retain) NSString* fileBaseName;
+/// @brief List of NSString objects with the full paths of the exported files.
+/// Is nil until the command has been executed successfully.
+@property(nonatomic, retain, readonly) NSArray* exportedFilePaths;
+
+@end
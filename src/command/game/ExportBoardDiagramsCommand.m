@@ -0,0 +1,390 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ExportBoardDiagramsCommand.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoBoardPositionPreview.h"
+#import "../../go/GoGame.h"
+#import "../../go/GoNodeModel.h"
+#import "../../play/boardview/BoardDiagram.h"
+#import "../../utility/PathUtilities.h"
+
+// System includes
+#import <ImageIO/ImageIO.h>
+#import <UniformTypeIdentifiers/UniformTypeIdentifiers.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// ExportBoardDiagramsCommand.
+// -----------------------------------------------------------------------------
+@interface ExportBoardDiagramsCommand()
+@property(nonatomic, assign, readwrite) enum BoardDiagramExportFormat exportFormat;
+@property(nonatomic, retain, readwrite) NSArray* exportedFilePaths;
+/// @brief The BoardDiagram objects to export, in the order of board positions.
+@property(nonatomic, retain) NSArray* diagrams;
+/// @brief The board position of the first diagram in @e diagrams.
+@property(nonatomic, assign) int firstBoardPosition;
+/// @brief The number of diagrams that have been drawn so far. Is accessed
+/// concurrently, so access must be synchronized.
+@property(nonatomic, assign) int numberOfDiagramsDrawn;
+@end
+
+
+@implementation ExportBoardDiagramsCommand
+
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes an ExportBoardDiagramsCommand object that will export
+/// the board positions from @a firstBoardPosition to @a lastBoardPosition
+/// (inclusive) of the current game variation into the format
+/// @a exportFormat.
+///
+/// This initializer must be invoked on the main thread because it captures
+/// the board positions from the Go model.
+///
+/// Raises @e NSRangeException if one of the board positions is outside the
+/// range of board positions of the current game variation, or if
+/// @a firstBoardPosition is greater than @a lastBoardPosition.
+///
+/// @note This is the designated initializer of ExportBoardDiagramsCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithFirstBoardPosition:(int)firstBoardPosition
+                lastBoardPosition:(int)lastBoardPosition
+                     exportFormat:(enum BoardDiagramExportFormat)exportFormat
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  if (firstBoardPosition > lastBoardPosition)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"First board position %d is greater than last board position %d", firstBoardPosition, lastBoardPosition];
+    DDLogError(@"%@: %@", self, errorMessage);
+    [self release];
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  self.exportFormat = exportFormat;
+  self.fileBaseName = @"Diagram";
+  self.exportedFilePaths = nil;
+  self.firstBoardPosition = firstBoardPosition;
+  self.numberOfDiagramsDrawn = 0;
+  self.showProgressHUD = true;
+
+  GoGame* game = [GoGame sharedGame];
+  GoBoardTopology* topology = game.board.topology;
+  GoNodeModel* nodeModel = game.nodeModel;
+  // Board positions are previewed in ascending order, so that each preview
+  // only has to replay a single node
+  GoBoardPositionPreview* preview = [[[GoBoardPositionPreview alloc] initWithGame:game] autorelease];
+  NSMutableArray* diagrams = [NSMutableArray arrayWithCapacity:lastBoardPosition - firstBoardPosition + 1];
+  @try
+  {
+    for (int boardPosition = firstBoardPosition; boardPosition <= lastBoardPosition; ++boardPosition)
+    {
+      NSData* stoneStates = [preview stoneStatesAtBoardPosition:boardPosition];
+      BoardDiagram* diagram = [[[BoardDiagram alloc] initWithNode:[nodeModel nodeAtIndex:boardPosition]
+                                                      stoneStates:stoneStates
+                                                         topology:topology] autorelease];
+      [diagrams addObject:diagram];
+    }
+  }
+  @catch (NSException* exception)
+  {
+    [self release];
+    @throw;
+  }
+  self.diagrams = diagrams;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ExportBoardDiagramsCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.fileBaseName = nil;
+  self.exportedFilePaths = nil;
+  self.diagrams = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand property.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandExecutionLane) executionLane
+{
+  // The diagrams were captured when the command was initialized, the export
+  // does not touch the Go model
+  return AsynchronousCommandExecutionLaneIndependent;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  NSString* exportFolderPath = [PathUtilities boardDiagramExportFolderPath];
+  [PathUtilities createFolder:exportFolderPath removeIfExists:true];
+
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:0.0
+                                        nextStepMessage:@"Exporting diagrams..."];
+
+  NSArray* exportedFilePaths = nil;
+  switch (self.exportFormat)
+  {
+    case BoardDiagramExportFormatPNG:
+    {
+      exportedFilePaths = [self exportPNGFilesToFolder:exportFolderPath];
+      break;
+    }
+    case BoardDiagramExportFormatPDF:
+    {
+      exportedFilePaths = [self exportPDFFileToFolder:exportFolderPath];
+      break;
+    }
+    case BoardDiagramExportFormatAnimatedGIF:
+    {
+      exportedFilePaths = [self exportAnimatedGIFFileToFolder:exportFolderPath];
+      break;
+    }
+    default:
+    {
+      DDLogError(@"%@: Unexpected export format %d", [self shortDescription], self.exportFormat);
+      assert(0);
+      break;
+    }
+  }
+
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:1.0
+                                        nextStepMessage:nil];
+
+  if (! exportedFilePaths)
+    return false;
+
+  DDLogInfo(@"%@: Exported %lu diagrams to %lu files", [self shortDescription], (unsigned long)self.diagrams.count, (unsigned long)exportedFilePaths.count);
+  self.exportedFilePaths = exportedFilePaths;
+  return true;
+}
+
+#pragma mark - Private helpers - Export formats
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes one .png file per diagram into
+/// the folder @a exportFolderPath. Returns the paths of the files, or nil if
+/// a file could not be written.
+// -----------------------------------------------------------------------------
+- (NSArray*) exportPNGFilesToFolder:(NSString*)exportFolderPath
+{
+  NSUInteger numberOfDiagrams = self.diagrams.count;
+  NSMutableArray* filePaths = [NSMutableArray arrayWithCapacity:numberOfDiagrams];
+  for (NSUInteger indexOfDiagram = 0; indexOfDiagram < numberOfDiagrams; ++indexOfDiagram)
+    [filePaths addObject:[self filePathForDiagramAtIndex:indexOfDiagram folder:exportFolderPath extension:@"png"]];
+
+  __block bool success = true;
+  dispatch_apply(numberOfDiagrams, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t indexOfDiagram)
+  {
+    @autoreleasepool
+    {
+      UIImage* image = [self imageForDiagram:self.diagrams[indexOfDiagram]];
+      NSString* filePath = filePaths[indexOfDiagram];
+      if (! [UIImagePNGRepresentation(image) writeToFile:filePath atomically:YES])
+      {
+        DDLogError(@"%@: Failed to write file %@", [self shortDescription], filePath);
+        @synchronized(self)
+        {
+          success = false;
+        }
+      }
+      [self diagramWasDrawn];
+    }
+  });
+
+  return success ? filePaths : nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes a single .pdf file with one page
+/// per diagram into the folder @a exportFolderPath. Returns an array with the
+/// path of the file, or nil if the file could not be written.
+///
+/// The diagrams are drawn as vector graphics, one after the other.
+// -----------------------------------------------------------------------------
+- (NSArray*) exportPDFFileToFolder:(NSString*)exportFolderPath
+{
+  NSString* filePath = [self filePathForFileWithExtension:@"pdf" folder:exportFolderPath];
+  CGRect pageRect = CGRectMake(0, 0, boardDiagramExportSideLength, boardDiagramExportSideLength);
+  UIGraphicsPDFRenderer* renderer = [[[UIGraphicsPDFRenderer alloc] initWithBounds:pageRect] autorelease];
+
+  NSError* error = nil;
+  BOOL success = [renderer writePDFToURL:[NSURL fileURLWithPath:filePath]
+                             withActions:^(UIGraphicsPDFRendererContext* rendererContext)
+  {
+    for (BoardDiagram* diagram in self.diagrams)
+    {
+      @autoreleasepool
+      {
+        [rendererContext beginPage];
+        [diagram drawWithContext:rendererContext.CGContext sideLength:boardDiagramExportSideLength];
+        [self diagramWasDrawn];
+      }
+    }
+  }
+                                   error:&error];
+  if (! success)
+  {
+    DDLogError(@"%@: Failed to write file %@, error = %@", [self shortDescription], filePath, error);
+    return nil;
+  }
+
+  return @[filePath];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes a single animated .gif file with
+/// one frame per diagram into the folder @a exportFolderPath. Returns an
+/// array with the path of the file, or nil if the file could not be written.
+///
+/// The frames are drawn concurrently, then they are added to the file in the
+/// order of board positions.
+// -----------------------------------------------------------------------------
+- (NSArray*) exportAnimatedGIFFileToFolder:(NSString*)exportFolderPath
+{
+  NSUInteger numberOfDiagrams = self.diagrams.count;
+  NSMutableArray* images = [NSMutableArray arrayWithCapacity:numberOfDiagrams];
+  for (NSUInteger indexOfDiagram = 0; indexOfDiagram < numberOfDiagrams; ++indexOfDiagram)
+    [images addObject:[NSNull null]];
+
+  dispatch_apply(numberOfDiagrams, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t indexOfDiagram)
+  {
+    @autoreleasepool
+    {
+      UIImage* image = [self imageForDiagram:self.diagrams[indexOfDiagram]];
+      @synchronized(images)
+      {
+        images[indexOfDiagram] = image;
+      }
+      [self diagramWasDrawn];
+    }
+  });
+
+  NSString* filePath = [self filePathForFileWithExtension:@"gif" folder:exportFolderPath];
+  CGImageDestinationRef destination = CGImageDestinationCreateWithURL((CFURLRef)[NSURL fileURLWithPath:filePath],
+                                                                      (CFStringRef)UTTypeGIF.identifier,
+                                                                      numberOfDiagrams,
+                                                                      NULL);
+  if (! destination)
+  {
+    DDLogError(@"%@: Failed to create file %@", [self shortDescription], filePath);
+    return nil;
+  }
+
+  // A loop count of 0 repeats the animation forever
+  NSDictionary* fileProperties = @{ (NSString*)kCGImagePropertyGIFDictionary : @{ (NSString*)kCGImagePropertyGIFLoopCount : @0 } };
+  NSDictionary* frameProperties = @{ (NSString*)kCGImagePropertyGIFDictionary : @{ (NSString*)kCGImagePropertyGIFDelayTime : [NSNumber numberWithDouble:boardDiagramExportFrameDuration] } };
+  CGImageDestinationSetProperties(destination, (CFDictionaryRef)fileProperties);
+  for (UIImage* image in images)
+    CGImageDestinationAddImage(destination, image.CGImage, (CFDictionaryRef)frameProperties);
+
+  bool success = CGImageDestinationFinalize(destination);
+  CFRelease(destination);
+  if (! success)
+  {
+    DDLogError(@"%@: Failed to write file %@", [self shortDescription], filePath);
+    return nil;
+  }
+
+  return @[filePath];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a new bitmap image with the content of @a diagram.
+///
+/// This method is invoked concurrently for several diagrams.
+// -----------------------------------------------------------------------------
+- (UIImage*) imageForDiagram:(BoardDiagram*)diagram
+{
+  UIGraphicsImageRendererFormat* format = [[[UIGraphicsImageRendererFormat alloc] init] autorelease];
+  format.scale = boardDiagramExportImageScale;
+  format.opaque = YES;
+  UIGraphicsImageRenderer* renderer = [[[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(boardDiagramExportSideLength, boardDiagramExportSideLength)
+                                                                              format:format] autorelease];
+
+  return [renderer imageWithActions:^(UIGraphicsImageRendererContext* rendererContext)
+  {
+    [diagram drawWithContext:rendererContext.CGContext sideLength:boardDiagramExportSideLength];
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Counts a diagram that was drawn and reports the progress of the
+/// export.
+///
+/// This method is invoked concurrently for several diagrams.
+// -----------------------------------------------------------------------------
+- (void) diagramWasDrawn
+{
+  float progress;
+  @synchronized(self)
+  {
+    self.numberOfDiagramsDrawn++;
+    progress = (float)self.numberOfDiagramsDrawn / self.diagrams.count;
+  }
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:progress
+                                        nextStepMessage:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path of the .png file for the diagram at index
+/// @a indexOfDiagram in @e diagrams. The file name contains the board
+/// position of the diagram, padded with zeros so that the files sort in the
+/// order of board positions.
+// -----------------------------------------------------------------------------
+- (NSString*) filePathForDiagramAtIndex:(NSUInteger)indexOfDiagram folder:(NSString*)folderPath extension:(NSString*)extension
+{
+  int boardPosition = self.firstBoardPosition + (int)indexOfDiagram;
+  NSString* fileName = [NSString stringWithFormat:@"%@-%03d.%@", self.fileBaseName, boardPosition, extension];
+  return [folderPath stringByAppendingPathComponent:fileName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path of the single file that contains all
+/// diagrams.
+// -----------------------------------------------------------------------------
+- (NSString*) filePathForFileWithExtension:(NSString*)extension folder:(NSString*)folderPath
+{
+  NSString* fileName = [self.fileBaseName stringByAppendingPathExtension:extension];
+  return [folderPath stringByAppendingPathComponent:fileName];
+}
+
+@end
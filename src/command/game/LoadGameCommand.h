@@ -62,6 +62,19 @@
 /// An exception that is raised while the moves in the .sgf file are replayed
 /// is caught and handled. The result is the same as if one of the sanitary
 /// checks had failed.
+///
+///
+/// @par Threading
+///
+/// LoadGameCommand builds and validates the entire tree of GoNode objects on
+/// the single thread that executes the command, including all variations. The
+/// work cannot be distributed over several threads, not even for sibling
+/// variations that are independent of each other after their branching point:
+/// Validating a move requires the board to be in the state of the move's
+/// predecessor node, but there is only one board. GoBoard, GoPoint and
+/// GoBoardRegion objects represent the state of the shared GoGame and cannot be
+/// cloned to give each thread its own copy. Also, none of the Go model objects
+/// are thread-safe.
 // -----------------------------------------------------------------------------
 @interface LoadGameCommand : CommandBase <AsynchronousCommand>
 {
@@ -74,5 +87,9 @@
 @property(nonatomic, assign) bool restoreMode;
 /// @brief True if the command triggered the computer player, false if not.
 @property(nonatomic, assign) bool didTriggerComputerPlayer;
+/// @brief The key under which the loaded game is registered with
+/// GoGameWorkspace. Is nil (the default) if the loaded game should not be
+/// kept resident when it is replaced by another game.
+@property(nonatomic, retain) NSString* workspaceKey;
 
 @end
@@ -26,6 +26,7 @@
 #import "../../go/GoBoardPosition.h"
 #import "../../go/GoGame.h"
 #import "../../go/GoGameDocument.h"
+#import "../../go/GoGameWorkspace.h"
 #import "../../go/GoMove.h"
 #import "../../go/GoNode.h"
 #import "../../go/GoNodeAdditions.h"
@@ -33,6 +34,7 @@
 #import "../../go/GoNodeMarkup.h"
 #import "../../go/GoNodeModel.h"
 #import "../../go/GoNodeSetup.h"
+#import "../../go/GoNodeTextIndex.h"
 #import "../../go/GoPlayer.h"
 #import "../../go/GoPoint.h"
 #import "../../go/GoUtilities.h"
@@ -41,14 +43,37 @@
 #import "../../main/ApplicationDelegate.h"
 #import "../../newgame/NewGameModel.h"
 #import "../../sgf/SgfUtilities.h"
-#import "../../shared/ApplicationStateManager.h"
-#import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../ui/UIViewControllerAdditions.h"
 #import "../../utility/NSStringAdditions.h"
 
 // Constants
 static const int maxStepsForCreateNodes = 9;
 
+/// @brief An entry of the stack that drives the depth-first iteration in
+/// createNodes:errorMessage:(). The stack is an NSMutableData that stores the
+/// entries by value, so that pushing an entry for every node in the tree does
+/// not cause any allocations except when the stack needs to grow. The stack
+/// does not retain the objects. They are kept alive by the SGFCNode and GoNode
+/// trees, and by the autorelease pool, for the duration of the iteration.
+struct CreateNodesStackEntry
+{
+  SGFCNode* sgfNode;
+  GoNode* goParentNode;
+  int numberOfMovesFoundBeforeNode;
+  GoMove* previousMove;
+};
+
+/// @brief An entry of the stack that drives the depth-first iteration in
+/// validateSetupAndMoveNodes:errorMessage:(). See CreateNodesStackEntry for
+/// details how the stack is managed.
+struct ValidateNodesStackEntry
+{
+  GoNode* node;
+  bool nodeIsOnMainVariation;
+  bool parentNodeIsOnMainVariation;
+};
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for LoadGameCommand.
@@ -61,6 +86,18 @@ static const int maxStepsForCreateNodes = 9;
 @property(nonatomic, assign) int totalSteps;
 @property(nonatomic, assign) float stepIncrease;
 @property(nonatomic, assign) float progress;
+/// @brief Objects that populateGoNode:withPropertiesFromSgfNode:previousMove:errorMessage:()
+/// fills with data from the current SGF node. An object is handed over to the
+/// GoNode only if data was actually found, and only then is it replaced with a
+/// new object. Nodes that contain no setup, annotation or markup - the vast
+/// majority of nodes in a typical game - therefore cause no allocations.
+@property(nonatomic, retain) GoNodeSetup* unusedGoNodeSetup;
+@property(nonatomic, retain) GoNodeAnnotation* unusedGoNodeAnnotation;
+@property(nonatomic, retain) GoNodeMarkup* unusedGoNodeMarkup;
+/// @brief Annotation texts found so far. Collections of problems typically
+/// repeat the same short comments (e.g. "Correct" or "Wrong") in many nodes.
+/// All nodes that have the same text share the same NSString object.
+@property(nonatomic, retain) NSMutableSet* sharedAnnotationTexts;
 @end
 
 
@@ -94,6 +131,7 @@ static const int maxStepsForCreateNodes = 9;
 
   self.restoreMode = false;
   self.didTriggerComputerPlayer = false;
+  self.workspaceKey = nil;
 
   self.totalSteps = (6 + maxStepsForCreateNodes);  // 6 steps before node creation begins
   self.stepIncrease = 1.0 / self.totalSteps;
@@ -111,6 +149,11 @@ static const int maxStepsForCreateNodes = 9;
   self.sgfGoGameInfo = nil;
   self.sgfGame = nil;
   self.sgfRootNode = nil;
+  self.unusedGoNodeSetup = nil;
+  self.unusedGoNodeAnnotation = nil;
+  self.unusedGoNodeMarkup = nil;
+  self.sharedAnnotationTexts = nil;
+  self.workspaceKey = nil;
 
   [super dealloc];
 }
@@ -122,14 +165,14 @@ static const int maxStepsForCreateNodes = 9;
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
   @try
   {
-    [[LongRunningActionCounter sharedCounter] increment];
+    [transaction begin];
     [self setupProgressHUD];
     [GtpUtilities stopPondering];
     @try
     {
-      [[ApplicationStateManager sharedManager] beginSavePoint];
       [self increaseProgressAndNotifyDelegate];
       NSString* errorMessage;
       bool success = [self setupGoGame:&errorMessage];
@@ -151,13 +194,12 @@ static const int maxStepsForCreateNodes = 9;
     }
     @finally
     {
-      [[ApplicationStateManager sharedManager] applicationStateDidChange];
-      [[ApplicationStateManager sharedManager] commitSavePoint];
+      [transaction applicationStateDidChange];
     }
   }
   @finally
   {
-    [[LongRunningActionCounter sharedCounter] decrement];
+    [transaction commit];
   }
 
   // We should never get here - unless an exception occurs, all paths in the
@@ -234,8 +276,13 @@ static const int maxStepsForCreateNodes = 9;
   else
   {
     [self notifyGoGameDocument];
+    [[ApplicationDelegate sharedDelegate].gameWorkspace activateGame:[GoGame sharedGame]
+                                                              forKey:self.workspaceKey];
     [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
   }
+  // Game files with extensive commentary can have thousands of comments, so
+  // they are indexed in the background before the user starts searching them
+  [[GoGame sharedGame].nodeTextIndex buildIndex];
   [GtpUtilities setupComputerPlayer];
   [self performSelector:@selector(triggerComputerPlayerOnMainThread)
                onThread:[NSThread mainThread]
@@ -596,8 +643,7 @@ static const int maxStepsForCreateNodes = 9;
   int numberOfMovesFoundBeforeCurrentNode = 0;
   GoMove* previousMove = nil;
 
-  NSMutableArray* stack = [NSMutableArray array];
-  NSNull* nullValue = [NSNull null];
+  NSMutableData* stack = [NSMutableData data];
 
   bool sgfCurrentNodeIsRootNode = true;
   SGFCNode* sgfCurrentNode = self.sgfRootNode;
@@ -667,6 +713,7 @@ static const int maxStepsForCreateNodes = 9;
             rootNode.goMove = goNewNode.goMove;
             rootNode.goNodeAnnotation = goNewNode.goNodeAnnotation;
             rootNode.goNodeMarkup = goNewNode.goNodeMarkup;
+            [nodeModel updateJumpTargetsOfNode:rootNode];
 
             goMostRecentContentNode = rootNode;
             goParentNode = nil;
@@ -689,7 +736,8 @@ static const int maxStepsForCreateNodes = 9;
       // - The number of moves found so far in this branch of the tree
       // - The move that will be the parent move (or previous move) of the next
       //   move found in the next sibling branch
-      [stack addObject:@[sgfCurrentNode, goParentNode ? goParentNode : nullValue, [NSNumber numberWithInt:numberOfMovesFoundBeforeCurrentNode], previousMove ? previousMove : nullValue]];
+      struct CreateNodesStackEntry stackEntry = { sgfCurrentNode, goParentNode, numberOfMovesFoundBeforeCurrentNode, previousMove };
+      [stack appendBytes:&stackEntry length:sizeof(stackEntry)];
 
       goParentNode = goMostRecentContentNode;
       if (goMostRecentContentNode.goMove)
@@ -713,20 +761,17 @@ static const int maxStepsForCreateNodes = 9;
       sgfCurrentNode = sgfCurrentNode.firstChild;
     }
 
-    if (stack.count > 0)
+    if (stack.length > 0)
     {
-      NSArray* tuple = stack.lastObject;
-      [stack removeLastObject];
-
-      sgfCurrentNode = [tuple objectAtIndex:0];
-      goParentNode = [tuple objectAtIndex:1];
-      if ((id)goParentNode == nullValue)
-        goParentNode = nil;
-      NSNumber* numberOfMovesFoundBeforeCurrentNodeAsNumber = [tuple objectAtIndex:2];
-      numberOfMovesFoundBeforeCurrentNode = numberOfMovesFoundBeforeCurrentNodeAsNumber.intValue;
-      previousMove = [tuple objectAtIndex:3];
-      if ((id)previousMove == nullValue)
-        previousMove = nil;
+      struct CreateNodesStackEntry stackEntry;
+      NSUInteger newStackLength = stack.length - sizeof(stackEntry);
+      [stack getBytes:&stackEntry range:NSMakeRange(newStackLength, sizeof(stackEntry))];
+      stack.length = newStackLength;
+
+      sgfCurrentNode = stackEntry.sgfNode;
+      goParentNode = stackEntry.goParentNode;
+      numberOfMovesFoundBeforeCurrentNode = stackEntry.numberOfMovesFoundBeforeNode;
+      previousMove = stackEntry.previousMove;
 
       sgfCurrentNode = sgfCurrentNode.nextSibling;
     }
@@ -740,6 +785,31 @@ static const int maxStepsForCreateNodes = 9;
   return true;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns an NSString object with the same content as @a text that is
+/// shared by all annotations that have the same text. Returns @e nil if
+/// @a text is @e nil.
+///
+/// This is a helper function for
+/// populateGoNode:withPropertiesFromSgfNode:previousMove:errorMessage:().
+// -----------------------------------------------------------------------------
+- (NSString*) sharedAnnotationText:(NSString*)text
+{
+  if (! text)
+    return nil;
+
+  if (! self.sharedAnnotationTexts)
+    self.sharedAnnotationTexts = [NSMutableSet set];
+
+  NSString* sharedText = [self.sharedAnnotationTexts member:text];
+  if (! sharedText)
+  {
+    sharedText = [[text copy] autorelease];
+    [self.sharedAnnotationTexts addObject:sharedText];
+  }
+  return sharedText;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Populates @a goNode with data found in @a sgfNode that comes from
 /// SGF properties that are recognized by the app.
@@ -761,12 +831,19 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
   GoGame* game = [GoGame sharedGame];
   bool sgfNodeIsGameInfoNode = [sgfNode isEqualToNode:self.sgfGameInfoNode];
 
-  GoNodeSetup* goNodeSetup = [[[GoNodeSetup alloc] initWithGame:game] autorelease];
+  if (! self.unusedGoNodeSetup)
+    self.unusedGoNodeSetup = [[[GoNodeSetup alloc] initWithGame:game] autorelease];
+  if (! self.unusedGoNodeAnnotation)
+    self.unusedGoNodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+  if (! self.unusedGoNodeMarkup)
+    self.unusedGoNodeMarkup = [[[GoNodeMarkup alloc] init] autorelease];
+
+  GoNodeSetup* goNodeSetup = self.unusedGoNodeSetup;
   GoMove* goMove = nil;
   enum GoMoveValuation goMoveValuation = GoMoveValuationNone;
-  GoNodeAnnotation* goNodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+  GoNodeAnnotation* goNodeAnnotation = self.unusedGoNodeAnnotation;
   bool atLeastOneAnnotationPropertyWasFound = false;
-  GoNodeMarkup* goNodeMarkup = [[[GoNodeMarkup alloc] init] autorelease];
+  GoNodeMarkup* goNodeMarkup = self.unusedGoNodeMarkup;
 
   for (SGFCProperty* sgfProperty in sgfNode.properties)
   {
@@ -790,12 +867,12 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
     }
     else if (propertyType == SGFCPropertyTypeN)
     {
-      goNodeAnnotation.shortDescription = sgfProperty.propertyValue.toSingleValue.toSimpleTextValue.simpleTextValue;
+      goNodeAnnotation.shortDescription = [self sharedAnnotationText:sgfProperty.propertyValue.toSingleValue.toSimpleTextValue.simpleTextValue];
       atLeastOneAnnotationPropertyWasFound = true;
     }
     else if (propertyType == SGFCPropertyTypeC)
     {
-      goNodeAnnotation.longDescription = sgfProperty.propertyValue.toSingleValue.toTextValue.textValue;
+      goNodeAnnotation.longDescription = [self sharedAnnotationText:sgfProperty.propertyValue.toSingleValue.toTextValue.textValue];
       atLeastOneAnnotationPropertyWasFound = true;
     }
     else if (propertyType == SGFCPropertyTypeGB)
@@ -951,16 +1028,25 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
   }
 
   if (! goNodeSetup.isEmpty)
+  {
     goNode.goNodeSetup = goNodeSetup;
+    self.unusedGoNodeSetup = nil;
+  }
 
   if (goMove)
     goNode.goMove = goMove;
 
   if (atLeastOneAnnotationPropertyWasFound)
+  {
     goNode.goNodeAnnotation = goNodeAnnotation;
+    self.unusedGoNodeAnnotation = nil;
+  }
 
   if (goNodeMarkup.hasMarkup)
+  {
     goNode.goNodeMarkup = goNodeMarkup;
+    self.unusedGoNodeMarkup = nil;
+  }
 
   return true;
 }
@@ -1249,6 +1335,16 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
 /// another iteration over the main game variation to set up the board, which
 /// is the most expensive operation of LoadGameCommand.
 ///
+/// Validation is deliberately not fused into createNodes:errorMessage:(),
+/// although that would save one walk over the tree. createNodes must iterate
+/// branches in their natural order so that child nodes are appended in the
+/// correct order, so a fused walk would leave the board in the state of the
+/// @e last variation and the caller would then have to replay the main
+/// variation - which costs more than the second walk. Also, a walk over the
+/// tree itself is cheap because it allocates nothing: almost all of the time
+/// is spent in playing moves and applying setup, which happens only once per
+/// node either way.
+///
 /// The following validation is performed by this method when it encounters a
 /// GoNode:
 /// - If the GoNode contains a GoNodeSetup, the setup information is applied to
@@ -1298,7 +1394,7 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
   bool parentNodeIsOnMainVariation = true;
   bool currentNodeIsOnMainVariation = true;
 
-  NSMutableArray* stack = [NSMutableArray array];
+  NSMutableData* stack = [NSMutableData data];
 
   GoNode* currentNode = nodeModel.rootNode;
 
@@ -1341,7 +1437,8 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
         [self increaseProgressAndNotifyDelegate];
       }
 
-      [stack addObject:@[currentNode, [NSNumber numberWithBool:currentNodeIsOnMainVariation], [NSNumber numberWithBool:parentNodeIsOnMainVariation]]];
+      struct ValidateNodesStackEntry stackEntry = { currentNode, currentNodeIsOnMainVariation, parentNodeIsOnMainVariation };
+      [stack appendBytes:&stackEntry length:sizeof(stackEntry)];
 
       // currentNode becomes parent node
       GoNode* newCurrentNode = currentNode.lastChild;
@@ -1351,16 +1448,16 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
       currentNode = newCurrentNode;
     }
 
-    if (stack.count > 0)
+    if (stack.length > 0)
     {
-      NSArray* tuple = stack.lastObject;
-      [stack removeLastObject];
+      struct ValidateNodesStackEntry stackEntry;
+      NSUInteger newStackLength = stack.length - sizeof(stackEntry);
+      [stack getBytes:&stackEntry range:NSMakeRange(newStackLength, sizeof(stackEntry))];
+      stack.length = newStackLength;
 
-      currentNode = [tuple objectAtIndex:0];
-      NSNumber* currentNodeIsOnMainVariationAsNumber = [tuple objectAtIndex:1];
-      currentNodeIsOnMainVariation = currentNodeIsOnMainVariationAsNumber.boolValue;
-      NSNumber* parentNodeIsOnMainVariationAsNumber = [tuple objectAtIndex:2];
-      parentNodeIsOnMainVariation = parentNodeIsOnMainVariationAsNumber.boolValue;
+      currentNode = stackEntry.node;
+      currentNodeIsOnMainVariation = stackEntry.nodeIsOnMainVariation;
+      parentNodeIsOnMainVariation = stackEntry.parentNodeIsOnMainVariation;
 
       if (currentNodeIsOnMainVariation)
       {
@@ -1551,7 +1648,7 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
 // -----------------------------------------------------------------------------
 - (bool) notifyApplicationAboutFinalGoModelState:(NSString**)errorMessage
 {
-  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
   GoGame* game = [GoGame sharedGame];
   GoNodeModel* nodeModel = game.nodeModel;
   GoBoardPosition* boardPosition = game.boardPosition;
@@ -1572,14 +1669,18 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
   int newCurrentBoardPosition = boardPosition.currentBoardPosition;
 
   // Needs to be posted because the node tree does not consist of only the root
-  // node
-  [center postNotificationName:goNodeTreeLayoutDidChange object:nil];
+  // node. The tree was built without GoNodeModel, so there is no tree change
+  // journal => the nil object tells observers that the entire tree changed.
+  [transaction postNotificationName:goNodeTreeLayoutDidChange object:nil];
 
   if (oldNumberOfBoardPositions != newNumberOfBoardPositions)
-    [center postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
+    [transaction postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
 
+  // The Go objects were updated without the setter of currentBoardPosition,
+  // so there are no changed points => no user info tells observers that the
+  // stone state of any intersection may have changed.
   if (oldCurrentBoardPosition != newCurrentBoardPosition)
-    [center postNotificationName:currentBoardPositionDidChange object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:newCurrentBoardPosition]]];
+    [transaction postNotificationName:currentBoardPositionDidChange object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:newCurrentBoardPosition]]];
 
   return true;
 }
@@ -1739,6 +1840,8 @@ withPropertiesFromSgfNode:(SGFCNode*)sgfNode
   self.sgfGame = [SGFCGame game];
   self.sgfGameInfoNode = self.sgfGame.rootNode;
   self.sgfRootNode = nil;  // will be set as a side-effect
+  // The default data does not match the source of the game anymore
+  self.workspaceKey = nil;
 
   // Setup board size before creating an SGFCGoGameInfo object, because that
   // object will be initialized with the board size from the game info node
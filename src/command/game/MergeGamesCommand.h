@@ -0,0 +1,71 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The MergeGamesCommand class is responsible for merging the game
+/// trees of several games in the archive into a single game tree, and for
+/// saving the result as a new game in the archive.
+///
+/// MergeGamesCommand is intended for the typical situation where several
+/// people have reviewed the same game, and each review exists as a separate
+/// .sgf file with its own variations, comments and markup. The first game in
+/// @e games is the base of the merge. The game trees of the other games are
+/// merged into the base in a single pass over each tree:
+/// - A node matches a child of the already matched parent node if both nodes
+///   contain the same move and the same setup. Because the parents match,
+///   this also means that both nodes describe the same board position.
+///   Matching is done via a dictionary lookup, so the merge takes time linear
+///   in the number of nodes.
+/// - Comments of matching nodes are concatenated, unless one comment already
+///   contains the other.
+/// - Markup of matching nodes is combined.
+/// - Other properties are taken from the base if it has them, otherwise from
+///   the node that is merged into the base.
+/// - A node without a match becomes a new variation, together with all of its
+///   descendants.
+///
+/// Only the first game of each .sgf file is merged. All games must use the
+/// same board size and must start with the same position, otherwise the
+/// command fails. In that case the property @e errorMessage describes the
+/// problem.
+///
+/// The merge operates on the SGF data. Loading the merged game with
+/// LoadGameCommand creates the GoNode tree.
+// -----------------------------------------------------------------------------
+@interface MergeGamesCommand : CommandBase
+{
+}
+
+- (id) initWithGames:(NSArray*)games preferredGameName:(NSString*)preferredGameName;
+
+/// @brief The ArchiveGame objects to merge. The first game is the base of the
+/// merge.
+@property(nonatomic, retain) NSArray* games;
+/// @brief The preferred name of the merged game. The actual name is made
+/// unique if necessary.
+@property(nonatomic, retain) NSString* preferredGameName;
+/// @brief The name under which the merged game was saved. Is nil until the
+/// command has been executed successfully.
+@property(nonatomic, retain, readonly) NSString* mergedGameName;
+/// @brief Describes why the merge failed. Is nil if the merge succeeded.
+@property(nonatomic, retain, readonly) NSString* errorMessage;
+
+@end
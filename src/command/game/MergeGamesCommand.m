@@ -0,0 +1,431 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "MergeGamesCommand.h"
+#import "../../archive/ArchiveGame.h"
+#import "../../archive/ArchiveViewModel.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../sgf/SgfFileCompression.h"
+#import "../../sgf/SgfUtilities.h"
+#import "../../utility/PathUtilities.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for MergeGamesCommand.
+// -----------------------------------------------------------------------------
+@interface MergeGamesCommand()
+@property(nonatomic, retain, readwrite) NSString* mergedGameName;
+@property(nonatomic, retain, readwrite) NSString* errorMessage;
+@end
+
+
+@implementation MergeGamesCommand
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a MergeGamesCommand object.
+///
+/// @note This is the designated initializer of MergeGamesCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithGames:(NSArray*)games preferredGameName:(NSString*)preferredGameName
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.games = games;
+  self.preferredGameName = preferredGameName;
+  self.mergedGameName = nil;
+  self.errorMessage = nil;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this MergeGamesCommand object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.games = nil;
+  self.preferredGameName = nil;
+  self.mergedGameName = nil;
+  self.errorMessage = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  if (self.games.count < 2)
+  {
+    self.errorMessage = @"At least two games are required for merging.";
+    return false;
+  }
+
+  ArchiveViewModel* model = [ApplicationDelegate sharedDelegate].archiveViewModel;
+
+  SGFCDocument* targetDocument = nil;
+  SGFCGame* targetGame = nil;
+  for (ArchiveGame* archiveGame in self.games)
+  {
+    NSString* sgfFilePath = [model.archiveFolder stringByAppendingPathComponent:archiveGame.fileName];
+    SGFCDocument* sgfDocument = [self readSgfFile:sgfFilePath];
+    SGFCGame* sgfGame = sgfDocument.games.firstObject;
+    if (! sgfGame || ! sgfGame.hasRootNode)
+    {
+      self.errorMessage = [NSString stringWithFormat:@"The game \"%@\" could not be read.", archiveGame.name];
+      return false;
+    }
+
+    if (! targetGame)
+    {
+      targetDocument = sgfDocument;
+      targetGame = sgfGame;
+      continue;
+    }
+
+    if (! [self canMergeGame:sgfGame intoGame:targetGame])
+    {
+      self.errorMessage = [NSString stringWithFormat:@"The game \"%@\" does not start with the same position as the game \"%@\", or it uses a different board size.",
+                           archiveGame.name,
+                           ((ArchiveGame*)self.games.firstObject).name];
+      return false;
+    }
+
+    [self mergeGame:sgfGame intoGame:targetGame];
+  }
+
+  NSString* gameName = [model uniqueGameNameForName:self.preferredGameName];
+  NSString* sgfFilePath = [model filePathForGameWithName:gameName];
+  bool success = [self saveSgfDocument:targetDocument
+                         toSgfFilePath:sgfFilePath
+                            compressed:model.compressGames];
+  if (! success)
+    return false;
+
+  self.mergedGameName = gameName;
+  [[NSNotificationCenter defaultCenter] postNotificationName:archiveContentChanged object:nil];
+
+  return true;
+}
+
+#pragma mark - Read and save
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Returns the SGF document read from
+/// @a sgfFilePath, or nil if the file could not be read.
+// -----------------------------------------------------------------------------
+- (SGFCDocument*) readSgfFile:(NSString*)sgfFilePath
+{
+  SGFCDocumentReader* documentReader = [SGFCDocumentReader documentReader];
+  // Warnings are irrelevant for merging, and the result is validated when it
+  // is written
+  [documentReader.arguments addArgumentWithType:SGFCArgumentTypeDisableWarningMessages];
+  SGFCDocumentReadResult* readResult = [SgfFileCompression readSgfFile:sgfFilePath withDocumentReader:documentReader];
+  if (! readResult.isSgfDataValid)
+  {
+    DDLogError(@"%@: Failed to read file %@", [self shortDescription], sgfFilePath);
+    return nil;
+  }
+
+  return readResult.document;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes @a sgfDocument to
+/// @a sgfFilePath, compressing the file if @a compressed is true.
+// -----------------------------------------------------------------------------
+- (bool) saveSgfDocument:(SGFCDocument*)sgfDocument
+           toSgfFilePath:(NSString*)sgfFilePath
+              compressed:(bool)compressed
+{
+  NSString* temporaryFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:sgfTemporaryFileName];
+
+  SGFCDocumentWriter* documentWriter = [SGFCDocumentWriter documentWriter];
+  SGFCDocumentWriteResult* result = nil;
+  @try
+  {
+    result = [documentWriter writeSgfContent:sgfDocument toFile:temporaryFilePath];
+  }
+  @catch (NSException* exception)
+  {
+    DDLogError(@"%@: Exception while writing the merged game: %@", [self shortDescription], exception);
+  }
+
+  if (! result || result.exitCode == SGFCExitCodeFatalError)
+  {
+    [PathUtilities deleteItemIfExists:temporaryFilePath];
+    self.errorMessage = @"An unexpected error occurred while writing the merged game.";
+    return false;
+  }
+
+  if (compressed)
+  {
+    // SgfcKit can only write uncompressed files
+    NSString* compressedFilePath = [temporaryFilePath stringByAppendingPathExtension:@"gz"];
+    bool compressSuccess = [SgfFileCompression copySgfFile:temporaryFilePath
+                                                    toPath:compressedFilePath
+                                                compressed:true];
+    [PathUtilities deleteItemIfExists:temporaryFilePath];
+    if (! compressSuccess)
+    {
+      self.errorMessage = @"An unexpected error occurred while compressing the merged game.";
+      return false;
+    }
+    temporaryFilePath = compressedFilePath;
+  }
+
+  NSError* error;
+  BOOL success = [PathUtilities moveItemAtPath:temporaryFilePath
+                                 overwritePath:sgfFilePath
+                                         error:&error];
+  if (! success)
+  {
+    [PathUtilities deleteItemIfExists:temporaryFilePath];
+    self.errorMessage = [NSString stringWithFormat:@"Writing the merged game to the archive failed. Reason:\n\n%@", [error localizedDescription]];
+    return false;
+  }
+
+  // The merged file is written by the app, it can use the trusted fast path
+  [SgfUtilities writeContentHashToSgfFile:sgfFilePath];
+
+  return true;
+}
+
+#pragma mark - Merge
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Returns true if @a sourceGame and
+/// @a targetGame have the same board size and their root nodes set up the
+/// same position.
+// -----------------------------------------------------------------------------
+- (bool) canMergeGame:(SGFCGame*)sourceGame intoGame:(SGFCGame*)targetGame
+{
+  NSString* sourceBoardSize = [self boardSizeOfGame:sourceGame];
+  NSString* targetBoardSize = [self boardSizeOfGame:targetGame];
+  if (! [sourceBoardSize isEqualToString:targetBoardSize])
+    return false;
+
+  NSString* sourceKey = [self matchKeyForNode:sourceGame.rootNode];
+  NSString* targetKey = [self matchKeyForNode:targetGame.rootNode];
+  return [sourceKey isEqualToString:targetKey];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Merges the game tree of @a sourceGame
+/// into the game tree of @a targetGame. Nodes without a match are moved from
+/// the source tree to the target tree.
+///
+/// The root nodes must match, which canMergeGame:intoGame:() has already
+/// verified.
+// -----------------------------------------------------------------------------
+- (void) mergeGame:(SGFCGame*)sourceGame intoGame:(SGFCGame*)targetGame
+{
+  SGFCTreeBuilder* targetTreeBuilder = targetGame.treeBuilder;
+
+  // Each pair consists of a source node and the target node it matches. An
+  // explicit stack instead of recursion because game trees can be deep.
+  NSMutableArray* stack = [NSMutableArray arrayWithObject:@[sourceGame.rootNode, targetGame.rootNode]];
+  while (stack.count > 0)
+  {
+    NSArray* nodePair = stack.lastObject;
+    [stack removeLastObject];
+    SGFCNode* sourceNode = nodePair[0];
+    SGFCNode* targetNode = nodePair[1];
+
+    [self mergePropertiesOfNode:sourceNode intoNode:targetNode];
+
+    if (! sourceNode.firstChild)
+      continue;
+
+    NSMutableDictionary* targetChildren = [NSMutableDictionary dictionary];
+    for (SGFCNode* targetChild = targetNode.firstChild; targetChild; targetChild = targetChild.nextSibling)
+    {
+      NSString* matchKey = [self matchKeyForNode:targetChild];
+      // If the target already has duplicate variations, the first one wins
+      if (! targetChildren[matchKey])
+        targetChildren[matchKey] = targetChild;
+    }
+
+    // Collect the source children first, moving a child to the target tree
+    // breaks the sibling chain
+    NSMutableArray* sourceChildren = [NSMutableArray array];
+    for (SGFCNode* sourceChild = sourceNode.firstChild; sourceChild; sourceChild = sourceChild.nextSibling)
+      [sourceChildren addObject:sourceChild];
+
+    for (SGFCNode* sourceChild in sourceChildren)
+    {
+      NSString* matchKey = [self matchKeyForNode:sourceChild];
+      SGFCNode* targetChild = targetChildren[matchKey];
+      if (targetChild)
+      {
+        [stack addObject:@[sourceChild, targetChild]];
+      }
+      else
+      {
+        // Moves the entire subtree
+        [targetTreeBuilder appendChild:sourceChild toNode:targetNode];
+        targetChildren[matchKey] = sourceChild;
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for mergeGame:intoGame:(). Returns a key that is
+/// equal for two nodes if, and only if, the nodes contain the same move and
+/// the same setup.
+// -----------------------------------------------------------------------------
+- (NSString*) matchKeyForNode:(SGFCNode*)node
+{
+  NSMutableArray* keyParts = [NSMutableArray array];
+  for (SGFCProperty* property in node.properties)
+  {
+    switch (property.propertyType)
+    {
+      case SGFCPropertyTypeB:
+      case SGFCPropertyTypeW:
+      case SGFCPropertyTypeAB:
+      case SGFCPropertyTypeAW:
+      case SGFCPropertyTypeAE:
+      case SGFCPropertyTypePL:
+      {
+        // Setup properties are unordered lists, SGFC does not sort them
+        NSMutableArray* valueKeys = [NSMutableArray array];
+        for (id<SGFCPropertyValue> propertyValue in property.propertyValues)
+          [valueKeys addObject:[self keyForPropertyValue:propertyValue]];
+        [valueKeys sortUsingSelector:@selector(compare:)];
+        [keyParts addObject:[NSString stringWithFormat:@"%ld[%@]",
+                             (long)property.propertyType,
+                             [valueKeys componentsJoinedByString:@"]["]]];
+        break;
+      }
+      default:
+      {
+        break;
+      }
+    }
+  }
+
+  [keyParts sortUsingSelector:@selector(compare:)];
+  return [keyParts componentsJoinedByString:@""];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for mergeGame:intoGame:(). Merges the properties of
+/// @a sourceNode into @a targetNode. See the class documentation for details.
+///
+/// Move and setup properties are not touched because they are equal in
+/// matching nodes.
+// -----------------------------------------------------------------------------
+- (void) mergePropertiesOfNode:(SGFCNode*)sourceNode intoNode:(SGFCNode*)targetNode
+{
+  for (SGFCProperty* sourceProperty in sourceNode.properties)
+  {
+    enum SGFCPropertyType propertyType = sourceProperty.propertyType;
+    SGFCProperty* targetProperty = [targetNode propertyWithType:propertyType];
+    if (! targetProperty)
+    {
+      [targetNode setProperty:sourceProperty];
+      continue;
+    }
+
+    switch (propertyType)
+    {
+      case SGFCPropertyTypeC:
+      {
+        NSString* sourceComment = sourceProperty.propertyValue.toSingleValue.toTextValue.textValue;
+        NSString* targetComment = targetProperty.propertyValue.toSingleValue.toTextValue.textValue;
+        if (sourceComment.length == 0 || [targetComment rangeOfString:sourceComment].location != NSNotFound)
+          break;
+        NSString* mergedComment;
+        if (targetComment.length == 0 || [sourceComment rangeOfString:targetComment].location != NSNotFound)
+          mergedComment = sourceComment;
+        else
+          mergedComment = [NSString stringWithFormat:@"%@\n\n%@", targetComment, sourceComment];
+        SGFCTextPropertyValue* propertyValue = [SGFCPropertyValueFactory propertyValueWithText:mergedComment];
+        [targetNode setProperty:[SGFCPropertyFactory propertyWithType:propertyType value:propertyValue]];  // overwrite!
+        break;
+      }
+      case SGFCPropertyTypeCR:
+      case SGFCPropertyTypeSQ:
+      case SGFCPropertyTypeTR:
+      case SGFCPropertyTypeMA:
+      case SGFCPropertyTypeSL:
+      case SGFCPropertyTypeAR:
+      case SGFCPropertyTypeLN:
+      case SGFCPropertyTypeLB:
+      case SGFCPropertyTypeDD:
+      {
+        NSMutableSet* targetValueKeys = [NSMutableSet set];
+        for (id<SGFCPropertyValue> propertyValue in targetProperty.propertyValues)
+          [targetValueKeys addObject:[self keyForPropertyValue:propertyValue]];
+        for (id<SGFCPropertyValue> propertyValue in sourceProperty.propertyValues)
+        {
+          NSString* valueKey = [self keyForPropertyValue:propertyValue];
+          if ([targetValueKeys containsObject:valueKey])
+            continue;
+          [targetValueKeys addObject:valueKey];
+          [targetProperty appendPropertyValue:propertyValue];
+        }
+        break;
+      }
+      default:
+      {
+        // The target value has precedence
+        break;
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a string that identifies the value
+/// @a propertyValue.
+// -----------------------------------------------------------------------------
+- (NSString*) keyForPropertyValue:(id<SGFCPropertyValue>)propertyValue
+{
+  if (propertyValue.isComposedValue)
+  {
+    SGFCComposedPropertyValue* composedValue = propertyValue.toComposedValue;
+    return [NSString stringWithFormat:@"%@:%@",
+            composedValue.value1.rawValue,
+            composedValue.value2.rawValue];
+  }
+  else
+  {
+    return propertyValue.toSingleValue.rawValue;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for canMergeGame:intoGame:(). Returns the raw value
+/// of the SZ property of @a sgfGame.
+// -----------------------------------------------------------------------------
+- (NSString*) boardSizeOfGame:(SGFCGame*)sgfGame
+{
+  SGFCProperty* property = [sgfGame.rootNode propertyWithType:SGFCPropertyTypeSZ];
+  // The SGF standard defines 19 as the default board size for Go
+  if (! property)
+    return @"19";
+  return property.propertyValue.toSingleValue.rawValue;
+}
+
+@end
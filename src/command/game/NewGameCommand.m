@@ -26,6 +26,7 @@
 #import "../../go/GoBoard.h"
 #import "../../go/GoGame.h"
 #import "../../go/GoGameRules.h"
+#import "../../go/GoGameWorkspace.h"
 #import "../../go/GoPlayer.h"
 #import "../../go/GoScore.h"
 #import "../../go/GoUtilities.h"
@@ -33,6 +34,7 @@
 #import "../../player/Player.h"
 #import "../../player/PlayerModel.h"
 #import "../../newgame/NewGameModel.h"
+#import "../../shared/DeferredDeallocationQueue.h"
 
 
 // -----------------------------------------------------------------------------
@@ -148,8 +150,13 @@
     DDLogVerbose(@"%@: Using pre-fabricated game %@", [self shortDescription], newGame);
   }
 
-  // Replace the delegate's reference; an old GoGame object is now deallocated
+  // Replace the delegate's reference; an old GoGame object is now deallocated,
+  // unless the workspace keeps it resident. Deallocating a large game takes
+  // time, so we hand the old game over to be deallocated piece by piece while
+  // the main thread is idle.
   ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
+  [appDelegate.gameWorkspace deactivateGame:oldGame];
+  [[DeferredDeallocationQueue sharedQueue] releaseObjectsWhenIdle:[GoUtilities objectsInDeallocationOrderForGame:oldGame]];
   appDelegate.game = newGame;
   DDLogVerbose(@"%@: Assigned game object to app delegate", [self shortDescription]);
 
@@ -314,100 +321,9 @@
 // -----------------------------------------------------------------------------
 - (void) setupGtpRules
 {
-  [self setupKoRule];
-  [self setupScoringSystem];
-  [self setupHandicapCompensation];
-}
-
-// -----------------------------------------------------------------------------
-/// @brief Configures the GTP engine with the ko rule to use.
-// -----------------------------------------------------------------------------
-- (void) setupKoRule
-{
-  enum GoKoRule koRule = [GoGame sharedGame].rules.koRule;
-  NSString* gtpKoRuleName;
-  switch (koRule)
-  {
-    case GoKoRuleSimple:
-      gtpKoRuleName = @"simple";
-      break;
-    case GoKoRuleSuperkoPositional:
-      gtpKoRuleName = @"pos_superko";
-      break;
-    case GoKoRuleSuperkoSituational:
-      gtpKoRuleName = @"superko";
-      break;
-    default:
-    {
-      NSString* errorMessage = [NSString stringWithFormat:@"Illegal GoKoRule value %d", koRule];
-      DDLogError(@"%@: %@", self, errorMessage);
-      NSException* exception = [NSException exceptionWithName:NSGenericException
-                                                       reason:errorMessage
-                                                     userInfo:nil];
-      @throw exception;
-    }
-  }
-  NSString* commandString = [NSString stringWithFormat:@"go_param_rules ko_rule %@", gtpKoRuleName];
-  [[GtpCommand command:commandString] submit];
-}
-
-// -----------------------------------------------------------------------------
-/// @brief Configures the GTP engine with the scoring system to use.
-// -----------------------------------------------------------------------------
-- (void) setupScoringSystem
-{
-  enum GoScoringSystem scoringSystem = [GoGame sharedGame].rules.scoringSystem;
-  int japaneseScoring;
-  switch (scoringSystem)
-  {
-    case GoScoringSystemAreaScoring:
-      japaneseScoring = 0;
-      break;
-    case GoScoringSystemTerritoryScoring:
-      japaneseScoring = 1;
-      break;
-    default:
-    {
-      NSString* errorMessage = [NSString stringWithFormat:@"Illegal GoScoringSystem value %d", scoringSystem];
-      DDLogError(@"%@: %@", self, errorMessage);
-      NSException* exception = [NSException exceptionWithName:NSGenericException
-                                                       reason:errorMessage
-                                                     userInfo:nil];
-      @throw exception;
-    }
-  }
-  NSString* commandString = [NSString stringWithFormat:@"go_param_rules japanese_scoring %d", japaneseScoring];
-  [[GtpCommand command:commandString] submit];
-  
-}
-
-// -----------------------------------------------------------------------------
-/// @brief Configures the GTP engine with the handicap compensation rule to use.
-// -----------------------------------------------------------------------------
-- (void) setupHandicapCompensation
-{
-  enum GoScoringSystem scoringSystem = [GoGame sharedGame].rules.scoringSystem;
-  int handicapCompensation;
-  switch (scoringSystem)
-  {
-    case GoScoringSystemAreaScoring:
-      handicapCompensation = 1;
-      break;
-    case GoScoringSystemTerritoryScoring:
-      handicapCompensation = 0;
-      break;
-    default:
-    {
-      NSString* errorMessage = [NSString stringWithFormat:@"Illegal GoScoringSystem value %d", scoringSystem];
-      DDLogError(@"%@: %@", self, errorMessage);
-      NSException* exception = [NSException exceptionWithName:NSGenericException
-                                                       reason:errorMessage
-                                                     userInfo:nil];
-      @throw exception;
-    }
-  }
-  NSString* commandString = [NSString stringWithFormat:@"go_param_rules extra_handicap_komi %d", handicapCompensation];
-  [[GtpCommand command:commandString] submit];
+  GoGameRules* rules = [GoGame sharedGame].rules;
+  for (NSString* commandString in [GtpUtilities rulesCommandStrings:rules])
+    [[GtpCommand command:commandString] submit];
 }
 
 // -----------------------------------------------------------------------------
@@ -65,6 +65,7 @@
   NSString* filePath = [model.archiveFolder stringByAppendingPathComponent:fileName];
 
   SaveSgfCommand* saveSgfCommand = [[[SaveSgfCommand alloc] initWithSgfFilePath:filePath sgfFileAlreadyExists:self.gameAlreadyExists] autorelease];
+  saveSgfCommand.compressSgfContent = model.compressGames;
   bool success = [saveSgfCommand submit];
   if (success)
   {
@@ -0,0 +1,55 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SearchArchiveForPatternCommand class is responsible for
+/// searching all games in the archive for a board pattern. Command execution
+/// occurs asynchronously.
+///
+/// SearchArchiveForPatternCommand first brings the pattern index of the
+/// archive up-to-date, then searches the index. See ArchivePatternIndex for
+/// the pattern syntax and for details how the search works. Only the first
+/// search after .sgf files were added to or modified in the archive has to
+/// read the .sgf files, subsequent searches only read the index.
+///
+/// The command fails if the pattern is not valid. In that case the property
+/// @e errorMessage describes the problem.
+// -----------------------------------------------------------------------------
+@interface SearchArchiveForPatternCommand : CommandBase <AsynchronousCommand>
+{
+}
+
+- (id) initWithPatternRows:(NSArray*)patternRows matchSwappedColors:(bool)matchSwappedColors;
+
+/// @brief The rows of the pattern, top row first.
+@property(nonatomic, retain) NSArray* patternRows;
+/// @brief True if the pattern also matches with black and white swapped.
+@property(nonatomic, assign) bool matchSwappedColors;
+/// @brief The search results. Is nil until the command has been executed
+/// successfully. See ArchivePatternIndex::searchPattern:matchSwappedColors:()
+/// for the content of the array.
+@property(nonatomic, retain, readonly) NSArray* searchResults;
+/// @brief Describes why the pattern is not valid. Is nil if the pattern is
+/// valid.
+@property(nonatomic, retain, readonly) NSString* errorMessage;
+
+@end
@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "SearchArchiveForPatternCommand.h"
+#import "../../archive/ArchivePatternIndex.h"
+#import "../../archive/ArchiveViewModel.h"
+#import "../../main/ApplicationDelegate.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// SearchArchiveForPatternCommand.
+// -----------------------------------------------------------------------------
+@interface SearchArchiveForPatternCommand()
+@property(nonatomic, retain, readwrite) NSArray* searchResults;
+@property(nonatomic, retain, readwrite) NSString* errorMessage;
+@end
+
+
+@implementation SearchArchiveForPatternCommand
+
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SearchArchiveForPatternCommand object that will search
+/// the archive for the pattern @a patternRows.
+///
+/// @note This is the designated initializer of SearchArchiveForPatternCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithPatternRows:(NSArray*)patternRows matchSwappedColors:(bool)matchSwappedColors
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.patternRows = patternRows;
+  self.matchSwappedColors = matchSwappedColors;
+  self.searchResults = nil;
+  self.errorMessage = nil;
+  self.showProgressHUD = true;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this SearchArchiveForPatternCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.patternRows = nil;
+  self.searchResults = nil;
+  self.errorMessage = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand property.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandExecutionLane) executionLane
+{
+  // The search only reads files in the archive and writes files in the index
+  // folder, it does not touch the Go model
+  return AsynchronousCommandExecutionLaneIndependent;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  NSString* errorMessage = nil;
+  if (! [ArchivePatternIndex isValidPattern:self.patternRows errorMessage:&errorMessage])
+  {
+    DDLogError(@"%@: Invalid pattern: %@", [self shortDescription], errorMessage);
+    self.errorMessage = errorMessage;
+    return false;
+  }
+
+  ArchiveViewModel* model = [ApplicationDelegate sharedDelegate].archiveViewModel;
+  ArchivePatternIndex* patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:model.archiveFolder] autorelease];
+
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:0.0
+                                        nextStepMessage:@"Indexing archive..."];
+  // The search is fast compared to indexing, so indexing gets most of the
+  // progress range
+  [patternIndex updateWithProgressHandler:^(int numberOfFilesUpdated, int numberOfFiles)
+  {
+    float progress = 0.9f * numberOfFilesUpdated / numberOfFiles;
+    NSString* nextStepMessage = (numberOfFilesUpdated == numberOfFiles) ? @"Searching..." : nil;
+    [self.asynchronousCommandDelegate asynchronousCommand:self
+                                              didProgress:progress
+                                          nextStepMessage:nextStepMessage];
+  }];
+
+  self.searchResults = [patternIndex searchPattern:self.patternRows matchSwappedColors:self.matchSwappedColors];
+
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:1.0
+                                        nextStepMessage:nil];
+
+  return (self.searchResults != nil);
+}
+
+@end
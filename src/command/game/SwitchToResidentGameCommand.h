@@ -0,0 +1,50 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SwitchToResidentGameCommand class is responsible for making a
+/// game that is resident in GoGameWorkspace the current game again.
+///
+/// SwitchToResidentGameCommand is the fast alternative to LoadGameCommand for
+/// a game that the user has viewed recently. The resident GoGame object
+/// already contains the fully built and validated node tree, so no SGF data
+/// needs to be parsed. The sequence of operations is this:
+/// - Apply the players and game type selected in the "New Game" screen to the
+///   resident game
+/// - Replace the current game with the resident game by executing a
+///   NewGameCommand instance with the resident game as the pre-fabricated game
+/// - Invoke SyncGTPEngineCommand to synchronize the computer player with the
+///   resident game
+/// - Make a backup
+/// - Notify observers about the state of the resident game
+///
+/// The command fails if GoGameWorkspace does not have a resident game for the
+/// key specified during initialization.
+// -----------------------------------------------------------------------------
+@interface SwitchToResidentGameCommand : CommandBase
+{
+}
+
+- (id) initWithWorkspaceKey:(NSString*)workspaceKey;
+
+@property(nonatomic, retain) NSString* workspaceKey;
+
+@end
@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "SwitchToResidentGameCommand.h"
+#import "NewGameCommand.h"
+#import "../backup/BackupGameToSgfCommand.h"
+#import "../backup/CleanBackupSgfCommand.h"
+#import "../boardposition/SyncGTPEngineCommand.h"
+#import "../../go/GoBoardPosition.h"
+#import "../../go/GoGame.h"
+#import "../../go/GoGameWorkspace.h"
+#import "../../go/GoNode.h"
+#import "../../go/GoNodeModel.h"
+#import "../../go/GoPlayer.h"
+#import "../../gtp/GtpUtilities.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../newgame/NewGameModel.h"
+#import "../../shared/ApplicationStateManager.h"
+#import "../../shared/ModelMutationTransaction.h"
+
+
+@implementation SwitchToResidentGameCommand
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SwitchToResidentGameCommand object that switches to
+/// the resident game identified by @a workspaceKey.
+///
+/// @note This is the designated initializer of SwitchToResidentGameCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithWorkspaceKey:(NSString*)workspaceKey
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.workspaceKey = workspaceKey;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this SwitchToResidentGameCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.workspaceKey = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  GoGameWorkspace* gameWorkspace = [ApplicationDelegate sharedDelegate].gameWorkspace;
+  GoGame* residentGame = [gameWorkspace takeResidentGameForKey:self.workspaceKey];
+  if (! residentGame)
+  {
+    DDLogError(@"%@: No resident game for key %@", [self shortDescription], self.workspaceKey);
+    return false;
+  }
+
+  [GtpUtilities stopPondering];
+  @try
+  {
+    [[ApplicationStateManager sharedManager] beginSavePoint];
+
+    [[[[CleanBackupSgfCommand alloc] init] autorelease] submit];
+
+    [self applyNewGameSettingsToGame:residentGame];
+
+    NewGameCommand* command = [[[NewGameCommand alloc] initWithGame:residentGame] autorelease];
+    // Same reasons as in LoadGameCommand: The resident game already contains
+    // handicap, komi and moves, SyncGTPEngineCommand sets these up
+    command.shouldHonorAutoEnableBoardSetupMode = false;
+    command.shouldSetupGtpHandicapAndKomi = false;
+    command.shouldTriggerComputerPlayerIfItIsTheirTurn = false;
+    command.shouldSetupComputerPlayer = false;
+    bool success = [command submit];
+    if (! success)
+    {
+      DDLogError(@"%@: Replacing the current game with the resident game failed", [self shortDescription]);
+      return false;
+    }
+
+    [gameWorkspace activateGame:residentGame forKey:self.workspaceKey];
+
+    SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
+    success = [syncCommand submit];
+    if (! success)
+    {
+      DDLogError(@"%@: Failed to synchronize the GTP engine state with the resident game, error message = %@", [self shortDescription], syncCommand.errorDescription);
+      return false;
+    }
+
+    [self notifyApplicationAboutGoModelState:residentGame];
+    [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
+    [GtpUtilities setupComputerPlayer];
+
+    return true;
+  }
+  @finally
+  {
+    [[ApplicationStateManager sharedManager] applicationStateDidChange];
+    [[ApplicationStateManager sharedManager] commitSavePoint];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Applies the players and game type that the user selected in the
+/// "New Game" screen to @a game, in the same way as NewGameCommand does for a
+/// game that it creates itself.
+///
+/// This is a private helper for doIt().
+// -----------------------------------------------------------------------------
+- (void) applyNewGameSettingsToGame:(GoGame*)game
+{
+  GoPlayer* playerBlack = [GoPlayer defaultBlackPlayer];
+  GoPlayer* playerWhite = [GoPlayer defaultWhitePlayer];
+  if (! playerBlack || ! playerWhite)
+  {
+    DDLogWarn(@"%@: Default players not found, resident game keeps its players", [self shortDescription]);
+    return;
+  }
+
+  game.playerBlack = playerBlack;
+  game.playerWhite = playerWhite;
+  game.type = [ApplicationDelegate sharedDelegate].theNewGameModel.gameType;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Posts a number of notifications to the default notification center to
+/// inform the rest of the application about the state of @a game. Observers
+/// have seen #goGameDidCreate, so they expect a game with only a root node.
+///
+/// This is a private helper for doIt(). It does the same as
+/// LoadGameCommand::notifyApplicationAboutFinalGoModelState:().
+// -----------------------------------------------------------------------------
+- (void) notifyApplicationAboutGoModelState:(GoGame*)game
+{
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
+  GoNodeModel* nodeModel = game.nodeModel;
+  GoBoardPosition* boardPosition = game.boardPosition;
+
+  if (! nodeModel.rootNode.hasChildren)
+    return;
+
+  int oldNumberOfBoardPositions = 1;
+  int oldCurrentBoardPosition = 0;
+  int newNumberOfBoardPositions = boardPosition.numberOfBoardPositions;
+  int newCurrentBoardPosition = boardPosition.currentBoardPosition;
+
+  [transaction postNotificationName:goNodeTreeLayoutDidChange object:nil];
+
+  if (oldNumberOfBoardPositions != newNumberOfBoardPositions)
+    [transaction postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
+
+  if (oldCurrentBoardPosition != newCurrentBoardPosition)
+    [transaction postNotificationName:currentBoardPositionDidChange object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:newCurrentBoardPosition]]];
+}
+
+@end
@@ -0,0 +1,85 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The AnalyzeSgfFileCommand class is responsible for letting the GTP
+/// engine evaluate every move of the games in an .sgf file, and for storing the
+/// evaluations in a sidecar file. Command execution occurs asynchronously.
+///
+/// AnalyzeSgfFileCommand is intended for batch analysis of many archived games,
+/// e.g. overnight. A client processes a queue of .sgf files by submitting one
+/// AnalyzeSgfFileCommand per file. Because the command executes with
+/// #AsynchronousCommandPriorityLow, commands that the user triggers in the
+/// meantime are executed between two files instead of waiting until the entire
+/// queue has been processed.
+///
+/// AnalyzeSgfFileCommand does not use the Go model of the current game, and it
+/// does not access UIKit. It reads the .sgf file with LoadSgfCommand, then
+/// for each game in the file replays the main variation in the GTP engine. The
+/// sequence of GTP commands is this:
+/// - "boardsize", "clear_board" and "komi" to set up the game
+/// - "gogui-setup" if the game contains setup stones before the first move
+/// - For each move: "play", then "reg_genmove" for the player whose turn it is
+///   next, then "uct_value_black". "reg_genmove" runs a search without playing
+///   the move it generates, "uct_value_black" returns the result of that
+///   search as the probability that Black wins.
+///
+/// The analysis of a game stops at the first node that contains setup stones
+/// after a move has been played, because the GTP engine cannot set up stones
+/// after a move.
+///
+/// The search of each move uses the settings of the active GTP engine profile,
+/// which therefore determine how long the analysis takes. The GTP engine is an
+/// in-process library that can only run as a single instance, so files are
+/// processed one after the other. The number of search threads in the active
+/// GTP engine profile determines how many CPU cores the analysis uses.
+///
+/// The evaluations are written to a property list file with the name of the
+/// .sgf file plus the extension ".plist", in the folder returned by
+/// PathUtilities::analysisFolderPath(). The property list contains an array
+/// with one array per analyzed game. A game's array contains one dictionary
+/// per move, with these keys:
+/// - "moveNumber": The move number, starting with 1 (NSNumber)
+/// - "move": The move as "<color> <vertex>", e.g. "B D4" or "W PASS"
+///   (NSString)
+/// - "suggestedMove": The move that the GTP engine would play next (NSString)
+/// - "blackWinProbability": The probability that Black wins after the move was
+///   played, between 0.0 and 1.0 (NSNumber)
+///
+/// When the analysis is complete, AnalyzeSgfFileCommand synchronizes the GTP
+/// engine with the current game again.
+///
+/// The command fails if the computer player is thinking when the command is
+/// executed, or if the .sgf file cannot be loaded.
+// -----------------------------------------------------------------------------
+@interface AnalyzeSgfFileCommand : CommandBase <AsynchronousCommand>
+{
+}
+
+- (id) initWithSgfFilePath:(NSString*)sgfFilePath;
+
+@property(nonatomic, retain) NSString* sgfFilePath;
+/// @brief The full path of the property list file that contains the analysis
+/// results. Is nil until the command has been executed successfully.
+@property(nonatomic, retain, readonly) NSString* analysisFilePath;
+
+@end
@@ -0,0 +1,373 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "AnalyzeSgfFileCommand.h"
+#import "../boardposition/SyncGTPEngineCommand.h"
+#import "../sgf/LoadSgfCommand.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoGame.h"
+#import "../../gtp/GtpCommand.h"
+#import "../../gtp/GtpEnergyGovernor.h"
+#import "../../gtp/GtpResponse.h"
+#import "../../gtp/GtpUtilities.h"
+#import "../../sgf/SgfUtilities.h"
+#import "../../utility/PathUtilities.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for AnalyzeSgfFileCommand.
+// -----------------------------------------------------------------------------
+@interface AnalyzeSgfFileCommand()
+@property(nonatomic, retain, readwrite) NSString* analysisFilePath;
+@end
+
+
+@implementation AnalyzeSgfFileCommand
+
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes an AnalyzeSgfFileCommand object that will analyze the
+/// games in the .sgf file identified by the full file path @a sgfFilePath.
+///
+/// @note This is the designated initializer of AnalyzeSgfFileCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithSgfFilePath:(NSString*)sgfFilePath
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.sgfFilePath = sgfFilePath;
+  self.analysisFilePath = nil;
+  // A batch analysis runs for a long time, the user must be able to continue
+  // working with the app in the meantime
+  self.showProgressHUD = false;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this AnalyzeSgfFileCommand object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.sgfFilePath = nil;
+  self.analysisFilePath = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand property.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandPriority) priority
+{
+  return AsynchronousCommandPriorityLow;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  if ([GoGame sharedGame].isComputerThinking)
+  {
+    DDLogError(@"%@: Cannot analyze %@ while the computer player is thinking", [self shortDescription], self.sgfFilePath);
+    return false;
+  }
+
+  SGFCDocument* document = [self loadSgfDocument];
+  if (! document)
+    return false;
+
+  NSMutableArray* analysis = [NSMutableArray array];
+
+  GtpEnergyGovernor* energyGovernor = [GtpEnergyGovernor sharedGovernor];
+  [energyGovernor beginBackgroundAnalysis];
+  [GtpUtilities stopPondering];
+  @try
+  {
+    for (SGFCGame* sgfGame in document.games)
+    {
+      if (! sgfGame.hasRootNode)
+        continue;
+      [analysis addObject:[self analyzeGame:sgfGame]];
+    }
+  }
+  @finally
+  {
+    [self syncGtpEngineWithCurrentGame];
+    [energyGovernor endBackgroundAnalysis];
+    [GtpUtilities restorePondering];
+  }
+
+  return [self writeAnalysis:analysis];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Loads the .sgf file and returns the
+/// resulting SGFCDocument. Returns nil if loading fails.
+// -----------------------------------------------------------------------------
+- (SGFCDocument*) loadSgfDocument
+{
+  LoadSgfCommand* loadSgfCommand = [[[LoadSgfCommand alloc] initWithSgfFilePath:self.sgfFilePath] autorelease];
+  if (! [loadSgfCommand submit])
+    return nil;
+
+  // LoadSgfCommand sets up the multiple encodings result only if it is the
+  // effective result
+  SGFCDocumentReadResult* readResult = loadSgfCommand.sgfDocumentReadResultMultipleEncodings;
+  if (! readResult)
+    readResult = loadSgfCommand.sgfDocumentReadResultSingleEncoding;
+
+  if (! [SgfUtilities isLoadOperationSuccessful:readResult withLoadSuccessType:SgfLoadSuccessTypeDefault])
+  {
+    DDLogError(@"%@: Failed to load %@", [self shortDescription], self.sgfFilePath);
+    return nil;
+  }
+
+  return readResult.document;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Replays the main variation of
+/// @a sgfGame in the GTP engine and returns an array with the evaluation of
+/// each move. Returns an empty array if the game cannot be analyzed.
+// -----------------------------------------------------------------------------
+- (NSArray*) analyzeGame:(SGFCGame*)sgfGame
+{
+  NSMutableArray* moveEvaluations = [NSMutableArray array];
+
+  SGFCNode* gameInfoNode = sgfGame.gameInfoNodes.firstObject;
+  if (! gameInfoNode)
+    gameInfoNode = sgfGame.rootNode;
+  SGFCGameInfo* gameInfo = gameInfoNode.gameInfo;
+  if (gameInfo.gameType != SGFCGameTypeGo)
+    return moveEvaluations;
+
+  NSString* errorMessage;
+  enum GoBoardSize goBoardSize = [SgfUtilities goBoardSizeForSgfBoardSize:gameInfo.boardSize
+                                                             errorMessage:&errorMessage];
+  if (goBoardSize == GoBoardSizeUndefined)
+  {
+    DDLogWarn(@"%@: Skipping game in %@: %@", [self shortDescription], self.sgfFilePath, errorMessage);
+    return moveEvaluations;
+  }
+
+  if (! [self submitGtpCommand:[NSString stringWithFormat:@"boardsize %d", goBoardSize]] ||
+      ! [self submitGtpCommand:@"clear_board"] ||
+      ! [self submitGtpCommand:[self komiCommandStringForGameInfoNode:gameInfoNode]])
+  {
+    return moveEvaluations;
+  }
+
+  NSMutableString* setupCommandString = [NSMutableString stringWithString:@"gogui-setup"];
+  bool hasSetupStones = false;
+  int moveNumber = 0;
+
+  for (SGFCNode* sgfNode = sgfGame.rootNode; sgfNode; sgfNode = sgfNode.firstChild)
+  {
+    for (SGFCProperty* sgfProperty in sgfNode.properties)
+    {
+      SGFCPropertyType propertyType = sgfProperty.propertyType;
+      if (propertyType == SGFCPropertyTypeAB || propertyType == SGFCPropertyTypeAW)
+      {
+        if (moveNumber > 0)
+        {
+          DDLogWarn(@"%@: Stopping analysis of game in %@ at move %d, setup after a move is not supported", [self shortDescription], self.sgfFilePath, moveNumber);
+          return moveEvaluations;
+        }
+
+        NSString* colorString = (propertyType == SGFCPropertyTypeAB) ? @"B" : @"W";
+        for (id<SGFCPropertyValue> setupPropertyValue in sgfProperty.propertyValues)
+        {
+          SGFCGoPoint* sgfGoPoint = setupPropertyValue.toSingleValue.toStoneValue.toGoStoneValue.goStone.location;
+          NSString* vertexString = [self vertexForSgfGoPoint:sgfGoPoint];
+          if (! vertexString)
+            return moveEvaluations;
+          [setupCommandString appendFormat:@" %@ %@", colorString, vertexString];
+          hasSetupStones = true;
+        }
+      }
+      else if (propertyType == SGFCPropertyTypeB || propertyType == SGFCPropertyTypeW)
+      {
+        if (moveNumber == 0 && hasSetupStones)
+        {
+          if (! [self submitGtpCommand:setupCommandString])
+            return moveEvaluations;
+        }
+
+        NSDictionary* moveEvaluation = [self evaluateMoveWithProperty:sgfProperty moveNumber:++moveNumber];
+        if (! moveEvaluation)
+          return moveEvaluations;
+        [moveEvaluations addObject:moveEvaluation];
+      }
+    }
+  }
+
+  return moveEvaluations;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for analyzeGame:(). Plays the move in
+/// @a sgfMoveProperty in the GTP engine, then lets the GTP engine evaluate the
+/// resulting position. Returns a dictionary with the evaluation, or nil if a
+/// GTP command failed.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) evaluateMoveWithProperty:(SGFCProperty*)sgfMoveProperty moveNumber:(int)moveNumber
+{
+  SGFCGoMove* sgfGoMove = sgfMoveProperty.propertyValue.toSingleValue.toMoveValue.toGoMoveValue.goMove;
+  if (! sgfGoMove)
+    return nil;
+
+  NSString* colorString;
+  NSString* nextColorString;
+  if (sgfMoveProperty.propertyType == SGFCPropertyTypeB)
+  {
+    colorString = @"B";
+    nextColorString = @"W";
+  }
+  else
+  {
+    colorString = @"W";
+    nextColorString = @"B";
+  }
+
+  NSString* vertexString;
+  if (sgfGoMove.isPassMove)
+    vertexString = @"PASS";
+  else
+    vertexString = [self vertexForSgfGoPoint:sgfGoMove.stone.location];
+  if (! vertexString)
+    return nil;
+
+  NSString* moveString = [NSString stringWithFormat:@"%@ %@", colorString, vertexString];
+  if (! [self submitGtpCommand:[@"play " stringByAppendingString:moveString]])
+    return nil;
+
+  [[GtpEnergyGovernor sharedGovernor] waitUntilBackgroundAnalysisIsAllowed];
+  GtpCommand* genMoveCommand = [GtpCommand command:[@"reg_genmove " stringByAppendingString:nextColorString]];
+  genMoveCommand.qualityOfService = NSQualityOfServiceUtility;
+  [genMoveCommand submit];
+  if (! genMoveCommand.response.status)
+    return nil;
+
+  GtpCommand* valueCommand = [GtpCommand command:@"uct_value_black"];
+  [valueCommand submit];
+  if (! valueCommand.response.status)
+    return nil;
+
+  NSString* suggestedMove = [NSString stringWithFormat:@"%@ %@", nextColorString, [genMoveCommand.response.parsedResponse uppercaseString]];
+  double blackWinProbability = [valueCommand.response.parsedResponse doubleValue];
+
+  return @{@"moveNumber" : [NSNumber numberWithInt:moveNumber],
+           @"move" : moveString,
+           @"suggestedMove" : suggestedMove,
+           @"blackWinProbability" : [NSNumber numberWithDouble:blackWinProbability]};
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the vertex string in the hybrid notation
+/// (e.g. "D4") that corresponds to @a sgfGoPoint. Returns nil if
+/// @a sgfGoPoint cannot be represented in the hybrid notation.
+// -----------------------------------------------------------------------------
+- (NSString*) vertexForSgfGoPoint:(SGFCGoPoint*)sgfGoPoint
+{
+  if (! sgfGoPoint || ! [sgfGoPoint hasPositionInGoPointNotation:SGFCGoPointNotationHybrid])
+  {
+    DDLogWarn(@"%@: Invalid intersection in %@", [self shortDescription], self.sgfFilePath);
+    return nil;
+  }
+
+  return [sgfGoPoint positionInGoPointNotation:SGFCGoPointNotationHybrid];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for analyzeGame:(). Returns the string for the GTP
+/// command "komi", using the komi value found in @a gameInfoNode.
+// -----------------------------------------------------------------------------
+- (NSString*) komiCommandStringForGameInfoNode:(SGFCNode*)gameInfoNode
+{
+  double komi = 0.0;
+  SGFCProperty* komiProperty = [gameInfoNode propertyWithType:SGFCPropertyTypeKM];
+  if (komiProperty)
+    komi = [komiProperty.propertyValue.toSingleValue.rawValue doubleValue];
+  return [NSString stringWithFormat:@"komi %.1f", komi];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the GTP command @a commandString and waits
+/// for the response. Returns true if the command was successful.
+// -----------------------------------------------------------------------------
+- (bool) submitGtpCommand:(NSString*)commandString
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+  [command submit];
+  if (! command.response.status)
+  {
+    DDLogError(@"%@: GTP command %@ failed while analyzing %@: %@", [self shortDescription], commandString, self.sgfFilePath, command.response.parsedResponse);
+    return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Restores the board size of the current
+/// game in the GTP engine, then synchronizes the GTP engine with the current
+/// game. The "boardsize" command has put GtpEngineState into an unknown state,
+/// so SyncGTPEngineCommand replays the current game from scratch.
+// -----------------------------------------------------------------------------
+- (void) syncGtpEngineWithCurrentGame
+{
+  GoGame* game = [GoGame sharedGame];
+  [self submitGtpCommand:[NSString stringWithFormat:@"boardsize %d", game.board.size]];
+
+  SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
+  bool success = [syncCommand submit];
+  if (! success)
+    DDLogError(@"%@: Failed to synchronize the GTP engine state with the current game, error message = %@", [self shortDescription], syncCommand.errorDescription);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes @a analysis to the property list
+/// file in the analysis folder. Returns true if writing was successful.
+// -----------------------------------------------------------------------------
+- (bool) writeAnalysis:(NSArray*)analysis
+{
+  NSString* analysisFolderPath = [PathUtilities analysisFolderPath];
+  [PathUtilities createFolder:analysisFolderPath removeIfExists:false];
+
+  NSString* analysisFileName = [self.sgfFilePath.lastPathComponent stringByAppendingPathExtension:@"plist"];
+  NSString* analysisFilePath = [analysisFolderPath stringByAppendingPathComponent:analysisFileName];
+  BOOL success = [analysis writeToFile:analysisFilePath atomically:YES];
+  if (! success)
+  {
+    DDLogError(@"%@: Failed to write analysis to %@", [self shortDescription], analysisFilePath);
+    return false;
+  }
+
+  self.analysisFilePath = analysisFilePath;
+  return true;
+}
+
+@end
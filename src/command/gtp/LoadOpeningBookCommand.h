@@ -21,8 +21,21 @@
 
 // -----------------------------------------------------------------------------
 /// @brief The LoadOpeningBookCommand class is responsible for submitting a
-/// "book_load" command to the GTP engine. Command execution occurs
-/// synchronously.
+/// "book_load" command to the GTP engine. The GTP command is executed
+/// asynchronously, i.e. LoadOpeningBookCommand returns before the GTP engine
+/// has loaded the opening book. Because the GTP engine processes commands in
+/// FIFO order, all GTP commands that are submitted later are executed with the
+/// opening book already loaded.
+///
+/// LoadOpeningBookCommand also loads the same opening book into the shared
+/// GoOpeningBook object, on a background queue. Until that has finished,
+/// ComputerPlayMoveCommand leaves all book lookups to the GTP engine.
+/// GoOpeningBook parses the opening book only on the first launch (and after
+/// the opening book has changed). On later launches it memory-maps the
+/// compiled index that it stored in the Caches folder.
+///
+/// LoadOpeningBookCommand fails only if the opening book file cannot be found.
+/// If the GTP engine fails to load the opening book, this is logged.
 ///
 /// The opening book file used as the command argument is a project resource
 /// with hard-coded name, i.e. there is no support for variable opening books.
@@ -20,6 +20,8 @@
 #import "../../main/ApplicationDelegate.h"
 #import "../../gtp/GtpCommand.h"
 #import "../../gtp/GtpResponse.h"
+#import "../../go/GoOpeningBook.h"
+#import "../../utility/PathUtilities.h"
 
 
 @implementation LoadOpeningBookCommand
@@ -36,6 +38,15 @@
     DDLogError(@"%@: Opening book file not found: %@", [self shortDescription], bookFilePath);
     return false;
   }
+
+  // The app looks up book moves itself (see ComputerPlayMoveCommand), so that
+  // it does not have to wait for the GTP engine to do so. The compiled index
+  // is kept in a file so that the book is parsed only once.
+  NSString* indexFilePath = [PathUtilities openingBookIndexFilePath];
+  dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+    [[GoOpeningBook sharedOpeningBook] loadBookFileAtPath:bookFilePath indexFilePath:indexFilePath];
+  });
+
   NSString* bookFileName = [bookFilePath lastPathComponent];
   NSString* bookFileFolder = [bookFilePath stringByDeletingLastPathComponent];
 
@@ -43,14 +54,25 @@
   [fileManager changeCurrentDirectoryPath:bookFileFolder];
   DDLogVerbose(@"%@: Working directory changed to %@", [self shortDescription], bookFileFolder);
 
+  // The command is not waited for, so that application startup can continue
+  // while the GTP engine is still setting itself up and parsing the book.
+  // The GTP engine processes commands in FIFO order, so the book is loaded
+  // before any command that is submitted later. The working directory must
+  // remain changed until the GTP engine has opened the file.
   NSString* commandString = [NSString stringWithFormat:@"book_load %@", bookFileName];
-  GtpCommand* command = [GtpCommand command:commandString];
+  NSString* shortDescription = [self shortDescription];
+  GtpCommand* command = [GtpCommand asynchronousCommand:commandString
+                                        completionQueue:nil
+                                      completionHandler:^(GtpResponse* response)
+  {
+    [fileManager changeCurrentDirectoryPath:oldCurrentDirectory];
+    DDLogVerbose(@"%@: Working directory changed to %@", shortDescription, oldCurrentDirectory);
+    if (! response.status)
+      DDLogError(@"%@: Loading the opening book failed: %@", shortDescription, response.parsedResponse);
+  }];
   [command submit];
 
-  [fileManager changeCurrentDirectoryPath:oldCurrentDirectory];
-  DDLogVerbose(@"%@: Working directory changed to %@", [self shortDescription], oldCurrentDirectory);
-
-  return command.response.status;
+  return true;
 }
 
 @end
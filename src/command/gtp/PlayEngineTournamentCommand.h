@@ -0,0 +1,80 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
+
+// Forward declarations
+@class GtpEngineProfile;
+@class GtpEngineTournamentResult;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The PlayEngineTournamentCommand class is responsible for letting the
+/// GTP engine play a number of games against itself, with two different
+/// GtpEngineProfile objects taking turns, and for collecting statistics that
+/// help to pick the best profile for a device. Command execution occurs
+/// asynchronously.
+///
+/// The two profiles alternate colors from game to game, the first profile
+/// plays Black in the first game. Games are played entirely inside the GTP
+/// engine, the Go model of the current game is not involved. Before each move
+/// the GTP engine is configured with the search parameters of the profile whose
+/// turn it is (see GtpEngineProfile::searchParameterCommandStringsForBoardSize:()),
+/// but neither profile is activated. Pondering is disabled for the duration of
+/// the tournament.
+///
+/// A game ends when a player resigns, or when both players pass in succession,
+/// in which case the GTP command "final_score" determines the winner. A game
+/// that exceeds a maximum number of moves is counted as tied.
+///
+/// After each move PlayEngineTournamentCommand obtains the search statistics
+/// from the GTP engine with GtpUctSearchStatistics. GtpEngineTournamentResult
+/// uses them to report playouts per second.
+///
+/// The GTP engine is an in-process library that can only run as a single
+/// instance, so the games are played one after the other. Each profile's
+/// thread count determines how many CPU cores its searches use.
+///
+/// When the tournament is over, PlayEngineTournamentCommand re-applies the
+/// active profile and synchronizes the GTP engine with the current game. It
+/// then posts #engineTournamentDidFinish.
+///
+/// The command fails if the computer player is thinking when the command is
+/// executed.
+// -----------------------------------------------------------------------------
+@interface PlayEngineTournamentCommand : CommandBase <AsynchronousCommand>
+{
+}
+
+- (id) initWithFirstProfile:(GtpEngineProfile*)firstProfile
+              secondProfile:(GtpEngineProfile*)secondProfile
+              numberOfGames:(int)numberOfGames;
+
+/// @brief The board size of the tournament games. The default is the board
+/// size in NewGameModel.
+@property(nonatomic, assign) enum GoBoardSize boardSize;
+/// @brief The komi of the tournament games. The default is the komi in
+/// NewGameModel.
+@property(nonatomic, assign) double komi;
+/// @brief The number of games to play.
+@property(nonatomic, assign) int numberOfGames;
+/// @brief The outcome of the tournament. Is updated after each game.
+@property(nonatomic, retain, readonly) GtpEngineTournamentResult* result;
+
+@end
@@ -0,0 +1,335 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "PlayEngineTournamentCommand.h"
+#import "../boardposition/SyncGTPEngineCommand.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoGame.h"
+#import "../../gtp/GtpCommand.h"
+#import "../../gtp/GtpEnergyGovernor.h"
+#import "../../gtp/GtpResponse.h"
+#import "../../gtp/GtpUctSearchStatistics.h"
+#import "../../gtp/GtpUtilities.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../newgame/NewGameModel.h"
+#import "../../player/GtpEngineProfile.h"
+#import "../../player/GtpEngineProfileModel.h"
+#import "../../player/GtpEngineTournamentResult.h"
+
+
+/// @brief Enumerates the possible outcomes of a tournament game.
+enum TournamentGameOutcome
+{
+  TournamentGameOutcomeBlackWins,
+  TournamentGameOutcomeWhiteWins,
+  TournamentGameOutcomeTie,
+  TournamentGameOutcomeFailed
+};
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// PlayEngineTournamentCommand.
+// -----------------------------------------------------------------------------
+@interface PlayEngineTournamentCommand()
+@property(nonatomic, retain, readwrite) GtpEngineTournamentResult* result;
+/// @brief The profile whose search parameters the GTP engine is currently
+/// configured with. Is nil if the GTP engine is configured with the active
+/// profile.
+@property(nonatomic, assign) GtpEngineProfile* configuredProfile;
+@end
+
+
+@implementation PlayEngineTournamentCommand
+
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a PlayEngineTournamentCommand object that will play
+/// @a numberOfGames games between @a firstProfile and @a secondProfile.
+///
+/// @note This is the designated initializer of PlayEngineTournamentCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithFirstProfile:(GtpEngineProfile*)firstProfile
+              secondProfile:(GtpEngineProfile*)secondProfile
+              numberOfGames:(int)numberOfGames
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  NewGameModel* newGameModel = [ApplicationDelegate sharedDelegate].theNewGameModel;
+  self.boardSize = newGameModel.boardSize;
+  self.komi = newGameModel.komi;
+  self.numberOfGames = numberOfGames;
+  self.result = [[[GtpEngineTournamentResult alloc] initWithFirstProfile:firstProfile
+                                                           secondProfile:secondProfile] autorelease];
+  self.configuredProfile = nil;
+  // A tournament runs for a long time, the user must be able to continue
+  // working with the app in the meantime
+  self.showProgressHUD = false;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this PlayEngineTournamentCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.result = nil;
+  self.configuredProfile = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand property.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandPriority) priority
+{
+  return AsynchronousCommandPriorityLow;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  if ([GoGame sharedGame].isComputerThinking)
+  {
+    DDLogError(@"%@: Cannot play a tournament while the computer player is thinking", [self shortDescription]);
+    return false;
+  }
+
+  GtpEnergyGovernor* energyGovernor = [GtpEnergyGovernor sharedGovernor];
+  [energyGovernor beginBackgroundAnalysis];
+  [GtpUtilities stopPondering];
+  @try
+  {
+    for (int gameIndex = 0; gameIndex < self.numberOfGames; ++gameIndex)
+    {
+      bool firstProfilePlaysBlack = (0 == gameIndex % 2);
+      enum TournamentGameOutcome outcome = [self playGameWithFirstProfilePlayingBlack:firstProfilePlaysBlack];
+      if (outcome == TournamentGameOutcomeFailed)
+        return false;
+      [self recordOutcome:outcome firstProfilePlaysBlack:firstProfilePlaysBlack];
+      DDLogInfo(@"%@: Game %d of %d is over, %@", [self shortDescription], gameIndex + 1, self.numberOfGames, self.result);
+    }
+  }
+  @finally
+  {
+    [energyGovernor endBackgroundAnalysis];
+    [self restoreGtpEngineState];
+  }
+
+  GtpEngineTournamentResult* result = self.result;
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [[NSNotificationCenter defaultCenter] postNotificationName:engineTournamentDidFinish object:result];
+  });
+
+  return true;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Plays a single game and returns its
+/// outcome.
+// -----------------------------------------------------------------------------
+- (enum TournamentGameOutcome) playGameWithFirstProfilePlayingBlack:(bool)firstProfilePlaysBlack
+{
+  GtpEngineTournamentResult* result = self.result;
+
+  if (! [self submitGtpCommand:[NSString stringWithFormat:@"boardsize %d", self.boardSize]] ||
+      ! [self submitGtpCommand:@"clear_board"] ||
+      ! [self submitGtpCommand:[NSString stringWithFormat:@"komi %.1f", self.komi]])
+  {
+    return TournamentGameOutcomeFailed;
+  }
+
+  // Generous limit that is reached only if something goes wrong, e.g. if the
+  // players are stuck in an endless sequence of captures and recaptures
+  int maximumNumberOfMoves = self.boardSize * self.boardSize * 3;
+  int numberOfConsecutivePasses = 0;
+  bool blackToMove = true;
+
+  for (int moveNumber = 1; moveNumber <= maximumNumberOfMoves; ++moveNumber)
+  {
+    bool isFirstProfile = (blackToMove == firstProfilePlaysBlack);
+    GtpEngineProfile* profile = isFirstProfile ? result.firstProfile : result.secondProfile;
+    [self configureGtpEngineWithProfile:profile];
+
+    [[GtpEnergyGovernor sharedGovernor] waitUntilBackgroundAnalysisIsAllowed];
+    NSString* colorString = blackToMove ? @"B" : @"W";
+    GtpCommand* genMoveCommand = [GtpCommand command:[@"genmove " stringByAppendingString:colorString]];
+    genMoveCommand.qualityOfService = NSQualityOfServiceUtility;
+    CFAbsoluteTime thinkingStartTime = CFAbsoluteTimeGetCurrent();
+    [genMoveCommand submit];
+    CFAbsoluteTime thinkingTime = CFAbsoluteTimeGetCurrent() - thinkingStartTime;
+    if (! genMoveCommand.response.status)
+    {
+      DDLogError(@"%@: genmove failed: %@", [self shortDescription], genMoveCommand.response.parsedResponse);
+      return TournamentGameOutcomeFailed;
+    }
+
+    GtpCommand* statisticsCommand = [GtpCommand command:@"uct_stat_search"];
+    [statisticsCommand submit];
+    GtpUctSearchStatistics* statistics = [GtpUctSearchStatistics statisticsWithResponse:statisticsCommand.response];
+
+    if (isFirstProfile)
+    {
+      result.numberOfMovesByFirstProfile++;
+      result.thinkingTimeOfFirstProfile += thinkingTime;
+      result.playoutsOfFirstProfile += statistics.gamesPlayed;
+      result.searchTimeOfFirstProfile += statistics.searchTime;
+    }
+    else
+    {
+      result.numberOfMovesBySecondProfile++;
+      result.thinkingTimeOfSecondProfile += thinkingTime;
+      result.playoutsOfSecondProfile += statistics.gamesPlayed;
+      result.searchTimeOfSecondProfile += statistics.searchTime;
+    }
+
+    NSString* move = [genMoveCommand.response.parsedResponse lowercaseString];
+    if ([move isEqualToString:@"resign"])
+      return blackToMove ? TournamentGameOutcomeWhiteWins : TournamentGameOutcomeBlackWins;
+
+    if ([move isEqualToString:@"pass"])
+    {
+      numberOfConsecutivePasses++;
+      if (numberOfConsecutivePasses == 2)
+        return [self outcomeOfFinalScore];
+    }
+    else
+    {
+      numberOfConsecutivePasses = 0;
+    }
+
+    blackToMove = ! blackToMove;
+  }
+
+  DDLogWarn(@"%@: Game exceeded %d moves, counting it as tied", [self shortDescription], maximumNumberOfMoves);
+  return TournamentGameOutcomeTie;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for playGameWithFirstProfilePlayingBlack:().
+/// Configures the GTP engine with the search parameters of @a profile, unless
+/// it is already configured with them.
+// -----------------------------------------------------------------------------
+- (void) configureGtpEngineWithProfile:(GtpEngineProfile*)profile
+{
+  if (profile == self.configuredProfile)
+    return;
+
+  NSMutableArray* commands = [NSMutableArray array];
+  for (NSString* commandString in [profile searchParameterCommandStringsForBoardSize:self.boardSize])
+    [commands addObject:[GtpCommand command:commandString]];
+  [GtpCommand submitCommands:commands];
+
+  self.configuredProfile = profile;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for playGameWithFirstProfilePlayingBlack:(). Asks the
+/// GTP engine to score the game and returns the outcome.
+// -----------------------------------------------------------------------------
+- (enum TournamentGameOutcome) outcomeOfFinalScore
+{
+  GtpCommand* command = [GtpCommand command:@"final_score"];
+  [command submit];
+  if (! command.response.status)
+  {
+    DDLogError(@"%@: final_score failed: %@", [self shortDescription], command.response.parsedResponse);
+    return TournamentGameOutcomeFailed;
+  }
+
+  // The GTP specification defines the response format as "B+<score>",
+  // "W+<score>" or "0"
+  NSString* finalScore = [command.response.parsedResponse uppercaseString];
+  if ([finalScore hasPrefix:@"B+"])
+    return TournamentGameOutcomeBlackWins;
+  else if ([finalScore hasPrefix:@"W+"])
+    return TournamentGameOutcomeWhiteWins;
+  else
+    return TournamentGameOutcomeTie;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Adds the outcome of a game to the
+/// tournament result.
+// -----------------------------------------------------------------------------
+- (void) recordOutcome:(enum TournamentGameOutcome)outcome firstProfilePlaysBlack:(bool)firstProfilePlaysBlack
+{
+  GtpEngineTournamentResult* result = self.result;
+  result.gamesPlayed++;
+
+  if (outcome == TournamentGameOutcomeTie)
+    result.gamesTied++;
+  else if ((outcome == TournamentGameOutcomeBlackWins) == firstProfilePlaysBlack)
+    result.gamesWonByFirstProfile++;
+  else
+    result.gamesWonBySecondProfile++;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Re-applies the active profile and
+/// synchronizes the GTP engine with the current game. The "boardsize" commands
+/// of the tournament have put GtpEngineState into an unknown state, so
+/// SyncGTPEngineCommand replays the current game from scratch.
+///
+/// Re-applying the active profile also restores pondering, as far as
+/// GtpEnergyGovernor allows it.
+// -----------------------------------------------------------------------------
+- (void) restoreGtpEngineState
+{
+  GtpEngineProfile* activeProfile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  [activeProfile applyProfile];
+  self.configuredProfile = nil;
+
+  GoGame* game = [GoGame sharedGame];
+  [self submitGtpCommand:[NSString stringWithFormat:@"boardsize %d", game.board.size]];
+
+  SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
+  bool success = [syncCommand submit];
+  if (! success)
+    DDLogError(@"%@: Failed to synchronize the GTP engine state with the current game, error message = %@", [self shortDescription], syncCommand.errorDescription);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the GTP command @a commandString and waits
+/// for the response. Returns true if the command was successful.
+// -----------------------------------------------------------------------------
+- (bool) submitGtpCommand:(NSString*)commandString
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+  [command submit];
+  if (! command.response.status)
+  {
+    DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], commandString, command.response.parsedResponse);
+    return false;
+  }
+  return true;
+}
+
+@end
@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The RunSustainedLoadBenchmarkCommand class is responsible for
+/// keeping the GTP engine busy with a fixed analysis workload for a long
+/// period of time, and for recording how the playout rate, the thermal state
+/// and the energy consumption of the device develop over that period. Command
+/// execution occurs asynchronously.
+///
+/// RunSustainedLoadBenchmarkCommand is intended to be run on real hardware,
+/// to find out how long pondering or background analysis sessions are
+/// affected by thermal throttling, and to compare different configurations.
+/// The app runs the command after launch if it is launched with
+/// #sustainedLoadBenchmarkLaunchArgument. The configuration can be varied
+/// with launch environment keys, see initWithLaunchEnvironment:().
+///
+/// The workload is the same on every run: The GTP engine sets up a 19x19
+/// board with a short fixed opening, then repeatedly generates a move with
+/// "reg_genmove" for alternating colors. "reg_genmove" searches without
+/// playing the move, so every search starts from the same position. Each
+/// search is limited to #sustainedLoadBenchmarkMaxGames playouts, so that the
+/// duration of a search reflects the speed of the device. After each search
+/// RunSustainedLoadBenchmarkCommand obtains the search statistics with
+/// GtpUctSearchStatistics and records a sample. Searches are started until
+/// @e duration has elapsed.
+///
+/// While the benchmark runs, RunSustainedLoadBenchmarkCommand records the
+/// transitions of the device's thermal state. The energy consumption is
+/// obtained from the kernel's task power information, which provides it only
+/// on ARM hardware. On other hardware (e.g. the simulator) energy is reported
+/// as 0.
+///
+/// If @e cooperatesWithEnergyGovernor is true, the benchmark waits before
+/// each search until GtpEnergyGovernor allows background analysis, like
+/// AnalyzeSgfFileCommand does. The time spent waiting is part of the report.
+///
+/// The report is written to a property list file in the folder returned by
+/// PathUtilities::benchmarkFolderPath(). The property list contains a
+/// dictionary with these keys:
+/// - "configuration": A dictionary with the benchmark configuration and the
+///   device model.
+/// - "samples": An array with one dictionary per search, with the keys
+///   "elapsedTime", "gamesPlayed", "searchTime", "gamesPerSecond",
+///   "thermalState", "energyGovernorLevel", "cpuTime" and "energy". Times are
+///   in seconds since the benchmark started, "energy" is in joules since the
+///   benchmark started.
+/// - "thermalStateTransitions": An array with one dictionary per transition,
+///   with the keys "elapsedTime" and "thermalState". The first entry is the
+///   thermal state at the start of the benchmark.
+/// - "summary": A dictionary with the averages over the entire benchmark and
+///   over the first and last #sustainedLoadBenchmarkComparisonPeriod seconds.
+///
+/// The device's idle timer is disabled while the benchmark runs, otherwise
+/// the screen would lock and the system would suspend the app.
+///
+/// When the benchmark is over, RunSustainedLoadBenchmarkCommand re-applies the
+/// active profile and synchronizes the GTP engine with the current game.
+///
+/// The command fails if the computer player is thinking when the command is
+/// executed, or if a GTP command fails.
+// -----------------------------------------------------------------------------
+@interface RunSustainedLoadBenchmarkCommand : CommandBase <AsynchronousCommand>
+{
+}
+
+- (id) init;
+- (id) initWithLaunchEnvironment:(NSDictionary*)launchEnvironment;
+
+/// @brief The duration of the benchmark in seconds. The default is
+/// #sustainedLoadBenchmarkDurationDefault.
+@property(nonatomic, assign) double duration;
+/// @brief The number of threads that the GTP engine uses. The default is the
+/// thread count of the active profile.
+@property(nonatomic, assign) int numberOfThreads;
+/// @brief The quality of service of the searches. The default is
+/// NSQualityOfServiceUtility, which is what background analysis uses.
+@property(nonatomic, assign) NSQualityOfService qualityOfService;
+/// @brief True if the benchmark waits for GtpEnergyGovernor before each
+/// search. The default is true.
+@property(nonatomic, assign) bool cooperatesWithEnergyGovernor;
+/// @brief The full path of the property list file that contains the report.
+/// Is nil until the command has been executed successfully.
+@property(nonatomic, retain, readonly) NSString* reportFilePath;
+
+@end
@@ -0,0 +1,480 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "RunSustainedLoadBenchmarkCommand.h"
+#import "../boardposition/SyncGTPEngineCommand.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoGame.h"
+#import "../../gtp/GtpCommand.h"
+#import "../../gtp/GtpEnergyGovernor.h"
+#import "../../gtp/GtpResponse.h"
+#import "../../gtp/GtpUctSearchStatistics.h"
+#import "../../gtp/GtpUtilities.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../player/GtpEngineProfile.h"
+#import "../../player/GtpEngineProfileModel.h"
+#import "../../utility/PathUtilities.h"
+#import "../../utility/UIDeviceAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// RunSustainedLoadBenchmarkCommand.
+// -----------------------------------------------------------------------------
+@interface RunSustainedLoadBenchmarkCommand()
+@property(nonatomic, retain, readwrite) NSString* reportFilePath;
+/// @brief Time (CACurrentMediaTime()) when the benchmark started.
+@property(nonatomic, assign) CFTimeInterval startTime;
+/// @brief CPU time consumed by the app when the benchmark started.
+@property(nonatomic, assign) double startCpuTime;
+/// @brief Energy consumed by the app when the benchmark started.
+@property(nonatomic, assign) unsigned long long startEnergy;
+/// @brief The samples recorded so far, one per search.
+@property(nonatomic, retain) NSMutableArray* samples;
+/// @brief The thermal state transitions recorded so far. Is accessed from the
+/// thread that posts NSProcessInfoThermalStateDidChangeNotification, access
+/// must therefore be synchronized.
+@property(nonatomic, retain) NSMutableArray* thermalStateTransitions;
+/// @brief The total time in seconds that the benchmark waited for
+/// GtpEnergyGovernor.
+@property(nonatomic, assign) double energyGovernorWaitTime;
+@end
+
+
+@implementation RunSustainedLoadBenchmarkCommand
+
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a RunSustainedLoadBenchmarkCommand object with the
+/// default configuration.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  return [self initWithLaunchEnvironment:@{}];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a RunSustainedLoadBenchmarkCommand object with the
+/// configuration found in @a launchEnvironment. Keys that are missing from
+/// @a launchEnvironment, or whose values are not valid, result in the default
+/// configuration value.
+///
+/// @see #sustainedLoadBenchmarkDurationLaunchEnvironmentKey,
+/// #sustainedLoadBenchmarkThreadCountLaunchEnvironmentKey,
+/// #sustainedLoadBenchmarkQualityOfServiceLaunchEnvironmentKey,
+/// #sustainedLoadBenchmarkEnergyGovernorLaunchEnvironmentKey.
+///
+/// @note This is the designated initializer of
+/// RunSustainedLoadBenchmarkCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithLaunchEnvironment:(NSDictionary*)launchEnvironment
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.duration = sustainedLoadBenchmarkDurationDefault;
+  NSString* durationString = launchEnvironment[sustainedLoadBenchmarkDurationLaunchEnvironmentKey];
+  if (durationString.doubleValue > 0.0)
+    self.duration = durationString.doubleValue;
+
+  self.numberOfThreads = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile.fuegoThreadCount;
+  NSString* threadCountString = launchEnvironment[sustainedLoadBenchmarkThreadCountLaunchEnvironmentKey];
+  int threadCount = threadCountString.intValue;
+  if (threadCount >= fuegoThreadCountMinimum && threadCount <= fuegoThreadCountMaximum)
+    self.numberOfThreads = threadCount;
+
+  self.qualityOfService = NSQualityOfServiceUtility;
+  NSString* qualityOfServiceString = launchEnvironment[sustainedLoadBenchmarkQualityOfServiceLaunchEnvironmentKey];
+  NSNumber* qualityOfService = [self qualityOfServiceByName][qualityOfServiceString];
+  if (qualityOfService)
+    self.qualityOfService = (NSQualityOfService)qualityOfService.integerValue;
+
+  self.cooperatesWithEnergyGovernor = true;
+  NSString* energyGovernorString = launchEnvironment[sustainedLoadBenchmarkEnergyGovernorLaunchEnvironmentKey];
+  if ([energyGovernorString isEqualToString:@"0"])
+    self.cooperatesWithEnergyGovernor = false;
+
+  self.reportFilePath = nil;
+  self.samples = [NSMutableArray array];
+  self.thermalStateTransitions = [NSMutableArray array];
+  self.energyGovernorWaitTime = 0.0;
+  // The benchmark keeps the GTP engine busy for a long time. The progress HUD
+  // prevents the user from interfering with the measurements.
+  self.showProgressHUD = true;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this RunSustainedLoadBenchmarkCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.reportFilePath = nil;
+  self.samples = nil;
+  self.thermalStateTransitions = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  if ([GoGame sharedGame].isComputerThinking)
+  {
+    DDLogError(@"%@: Cannot run the benchmark while the computer player is thinking", [self shortDescription]);
+    return false;
+  }
+
+  DDLogInfo(@"%@: Starting benchmark, configuration = %@", [self shortDescription], [self configuration]);
+
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:0.0
+                                        nextStepMessage:@"Running benchmark..."];
+
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [UIApplication sharedApplication].idleTimerDisabled = YES;
+  });
+
+  GtpEnergyGovernor* energyGovernor = [GtpEnergyGovernor sharedGovernor];
+  [energyGovernor beginBackgroundAnalysis];
+  [GtpUtilities stopPondering];
+  id thermalStateObserver = nil;
+  bool success = false;
+  @try
+  {
+    if (! [self setupWorkload])
+      return false;
+
+    self.startTime = CACurrentMediaTime();
+    self.startCpuTime = [UIDevice applicationCpuTime];
+    self.startEnergy = [UIDevice applicationEnergy];
+    [self recordThermalState:[NSProcessInfo processInfo].thermalState];
+    thermalStateObserver = [[NSNotificationCenter defaultCenter] addObserverForName:NSProcessInfoThermalStateDidChangeNotification
+                                                                             object:nil
+                                                                              queue:nil
+                                                                         usingBlock:^(NSNotification* notification)
+    {
+      [self recordThermalState:[NSProcessInfo processInfo].thermalState];
+    }];
+
+    success = [self runWorkload];
+  }
+  @finally
+  {
+    if (thermalStateObserver)
+      [[NSNotificationCenter defaultCenter] removeObserver:thermalStateObserver];
+    [energyGovernor endBackgroundAnalysis];
+    [self restoreGtpEngineState];
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [UIApplication sharedApplication].idleTimerDisabled = NO;
+    });
+  }
+
+  if (! success)
+    return false;
+  return [self writeReport];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Configures the GTP engine and sets up the
+/// position that every search starts from. Returns true if all GTP commands
+/// were successful.
+// -----------------------------------------------------------------------------
+- (bool) setupWorkload
+{
+  NSArray* commandStrings = @[
+    [NSString stringWithFormat:@"uct_param_search number_threads %d", self.numberOfThreads],
+    [NSString stringWithFormat:@"uct_param_player max_games %llu", sustainedLoadBenchmarkMaxGames],
+    // The playout limit, not the clock, must end each search
+    @"go_param timelimit 3600",
+    @"time_settings 0 1 0",
+    @"boardsize 19",
+    @"clear_board",
+    @"komi 6.5",
+    @"play B Q16",
+    @"play W D4",
+    @"play B Q3",
+    @"play W D16",
+  ];
+
+  for (NSString* commandString in commandStrings)
+  {
+    if (! [self submitGtpCommand:commandString])
+      return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Runs searches until the benchmark
+/// duration has elapsed. Returns true if all GTP commands were successful.
+// -----------------------------------------------------------------------------
+- (bool) runWorkload
+{
+  GtpEnergyGovernor* energyGovernor = [GtpEnergyGovernor sharedGovernor];
+  NSArray* colors = @[@"B", @"W"];
+  int searchIndex = 0;
+
+  double elapsedTime = 0.0;
+  while (elapsedTime < self.duration)
+  {
+    if (self.cooperatesWithEnergyGovernor)
+    {
+      CFTimeInterval waitStartTime = CACurrentMediaTime();
+      [energyGovernor waitUntilBackgroundAnalysisIsAllowed];
+      self.energyGovernorWaitTime += CACurrentMediaTime() - waitStartTime;
+    }
+
+    GtpCommand* genMoveCommand = [GtpCommand command:[@"reg_genmove " stringByAppendingString:colors[searchIndex % 2]]];
+    genMoveCommand.qualityOfService = self.qualityOfService;
+    [genMoveCommand submit];
+    if (! genMoveCommand.response.status)
+    {
+      DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], genMoveCommand.command, genMoveCommand.response.parsedResponse);
+      return false;
+    }
+
+    GtpCommand* statisticsCommand = [GtpCommand command:@"uct_stat_search"];
+    [statisticsCommand submit];
+    if (! statisticsCommand.response.status)
+    {
+      DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], statisticsCommand.command, statisticsCommand.response.parsedResponse);
+      return false;
+    }
+
+    elapsedTime = CACurrentMediaTime() - self.startTime;
+    [self recordSampleWithStatistics:[GtpUctSearchStatistics statisticsWithResponse:statisticsCommand.response]
+                         elapsedTime:elapsedTime];
+    searchIndex++;
+
+    float progress = MIN(elapsedTime / self.duration, 1.0);
+    [self.asynchronousCommandDelegate asynchronousCommand:self didProgress:progress nextStepMessage:nil];
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for runWorkload(). Records a sample with the search
+/// statistics @a statistics and the current device conditions.
+// -----------------------------------------------------------------------------
+- (void) recordSampleWithStatistics:(GtpUctSearchStatistics*)statistics elapsedTime:(double)elapsedTime
+{
+  [self.samples addObject:@{@"elapsedTime" : [NSNumber numberWithDouble:elapsedTime],
+                            @"gamesPlayed" : [NSNumber numberWithUnsignedLongLong:statistics.gamesPlayed],
+                            @"searchTime" : [NSNumber numberWithDouble:statistics.searchTime],
+                            @"gamesPerSecond" : [NSNumber numberWithDouble:statistics.gamesPerSecond],
+                            @"thermalState" : [NSNumber numberWithInteger:[NSProcessInfo processInfo].thermalState],
+                            @"energyGovernorLevel" : [NSNumber numberWithInt:[GtpEnergyGovernor sharedGovernor].level],
+                            @"cpuTime" : [NSNumber numberWithDouble:[UIDevice applicationCpuTime] - self.startCpuTime],
+                            @"energy" : [NSNumber numberWithDouble:[self energySinceStart]]}];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Records a transition to the thermal state
+/// @a thermalState.
+// -----------------------------------------------------------------------------
+- (void) recordThermalState:(NSProcessInfoThermalState)thermalState
+{
+  double elapsedTime = CACurrentMediaTime() - self.startTime;
+  @synchronized(self.thermalStateTransitions)
+  {
+    [self.thermalStateTransitions addObject:@{@"elapsedTime" : [NSNumber numberWithDouble:elapsedTime],
+                                              @"thermalState" : [NSNumber numberWithInteger:thermalState]}];
+  }
+  DDLogInfo(@"%@: Thermal state changed to %ld after %.1f seconds", [self shortDescription], (long)thermalState, elapsedTime);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the energy in joules that the app has
+/// consumed since the benchmark started.
+// -----------------------------------------------------------------------------
+- (double) energySinceStart
+{
+  return ([UIDevice applicationEnergy] - self.startEnergy) / 1000000000.0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a dictionary that maps the names of quality
+/// of service classes that can be used in the launch environment to
+/// NSQualityOfService values.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) qualityOfServiceByName
+{
+  return @{@"userInteractive" : [NSNumber numberWithInteger:NSQualityOfServiceUserInteractive],
+           @"userInitiated" : [NSNumber numberWithInteger:NSQualityOfServiceUserInitiated],
+           @"utility" : [NSNumber numberWithInteger:NSQualityOfServiceUtility],
+           @"background" : [NSNumber numberWithInteger:NSQualityOfServiceBackground]};
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a dictionary that describes the benchmark
+/// configuration and the device that runs the benchmark.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) configuration
+{
+  NSString* qualityOfServiceName = [[self qualityOfServiceByName] allKeysForObject:[NSNumber numberWithInteger:self.qualityOfService]].firstObject;
+
+  return @{@"duration" : [NSNumber numberWithDouble:self.duration],
+           @"numberOfThreads" : [NSNumber numberWithInt:self.numberOfThreads],
+           @"qualityOfService" : qualityOfServiceName ? qualityOfServiceName : @"default",
+           @"cooperatesWithEnergyGovernor" : [NSNumber numberWithBool:self.cooperatesWithEnergyGovernor],
+           @"maxGames" : [NSNumber numberWithUnsignedLongLong:sustainedLoadBenchmarkMaxGames],
+           @"deviceModel" : [UIDevice hardwareModel],
+           @"systemVersion" : [UIDevice currentDevice].systemVersion,
+           @"processorCount" : [NSNumber numberWithUnsignedInteger:[NSProcessInfo processInfo].activeProcessorCount]};
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for writeReport(). Returns a dictionary with the
+/// averages over the entire benchmark and over the first and last
+/// #sustainedLoadBenchmarkComparisonPeriod seconds of the benchmark.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) summary
+{
+  double elapsedTime = [self.samples.lastObject[@"elapsedTime"] doubleValue];
+  double lastPeriodStartTime = elapsedTime - sustainedLoadBenchmarkComparisonPeriod;
+
+  unsigned long long totalGamesPlayed = 0;
+  double totalSearchTime = 0.0;
+  unsigned long long firstPeriodGamesPlayed = 0;
+  double firstPeriodSearchTime = 0.0;
+  unsigned long long lastPeriodGamesPlayed = 0;
+  double lastPeriodSearchTime = 0.0;
+
+  for (NSDictionary* sample in self.samples)
+  {
+    unsigned long long gamesPlayed = [sample[@"gamesPlayed"] unsignedLongLongValue];
+    double searchTime = [sample[@"searchTime"] doubleValue];
+    double sampleTime = [sample[@"elapsedTime"] doubleValue];
+
+    totalGamesPlayed += gamesPlayed;
+    totalSearchTime += searchTime;
+    if (sampleTime <= sustainedLoadBenchmarkComparisonPeriod)
+    {
+      firstPeriodGamesPlayed += gamesPlayed;
+      firstPeriodSearchTime += searchTime;
+    }
+    if (sampleTime >= lastPeriodStartTime)
+    {
+      lastPeriodGamesPlayed += gamesPlayed;
+      lastPeriodSearchTime += searchTime;
+    }
+  }
+
+  double energy = [self energySinceStart];
+
+  return @{@"numberOfSearches" : [NSNumber numberWithUnsignedInteger:self.samples.count],
+           @"elapsedTime" : [NSNumber numberWithDouble:elapsedTime],
+           @"averageGamesPerSecond" : [NSNumber numberWithDouble:(totalSearchTime > 0.0 ? totalGamesPlayed / totalSearchTime : 0.0)],
+           @"firstPeriodGamesPerSecond" : [NSNumber numberWithDouble:(firstPeriodSearchTime > 0.0 ? firstPeriodGamesPlayed / firstPeriodSearchTime : 0.0)],
+           @"lastPeriodGamesPerSecond" : [NSNumber numberWithDouble:(lastPeriodSearchTime > 0.0 ? lastPeriodGamesPlayed / lastPeriodSearchTime : 0.0)],
+           @"energyGovernorWaitTime" : [NSNumber numberWithDouble:self.energyGovernorWaitTime],
+           @"cpuTime" : [NSNumber numberWithDouble:[UIDevice applicationCpuTime] - self.startCpuTime],
+           @"energy" : [NSNumber numberWithDouble:energy],
+           @"averagePower" : [NSNumber numberWithDouble:(elapsedTime > 0.0 ? energy / elapsedTime : 0.0)]};
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Re-applies the active profile and
+/// synchronizes the GTP engine with the current game. The "boardsize" command
+/// of the benchmark has put GtpEngineState into an unknown state, so
+/// SyncGTPEngineCommand replays the current game from scratch.
+///
+/// Re-applying the active profile also restores pondering, as far as
+/// GtpEnergyGovernor allows it.
+// -----------------------------------------------------------------------------
+- (void) restoreGtpEngineState
+{
+  GtpEngineProfile* activeProfile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  [activeProfile applyProfile];
+
+  GoGame* game = [GoGame sharedGame];
+  [self submitGtpCommand:[NSString stringWithFormat:@"boardsize %d", game.board.size]];
+
+  SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
+  bool success = [syncCommand submit];
+  if (! success)
+    DDLogError(@"%@: Failed to synchronize the GTP engine state with the current game, error message = %@", [self shortDescription], syncCommand.errorDescription);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes the report to a property list file
+/// in the benchmark folder. Returns true if writing was successful.
+// -----------------------------------------------------------------------------
+- (bool) writeReport
+{
+  NSDictionary* summary = [self summary];
+  NSArray* thermalStateTransitions;
+  @synchronized(self.thermalStateTransitions)
+  {
+    thermalStateTransitions = [[self.thermalStateTransitions copy] autorelease];
+  }
+
+  NSDictionary* report = @{@"configuration" : [self configuration],
+                           @"samples" : self.samples,
+                           @"thermalStateTransitions" : thermalStateTransitions,
+                           @"summary" : summary};
+
+  NSString* benchmarkFolderPath = [PathUtilities benchmarkFolderPath];
+  [PathUtilities createFolder:benchmarkFolderPath removeIfExists:false];
+
+  NSDateFormatter* dateFormatter = [[[NSDateFormatter alloc] init] autorelease];
+  dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+  dateFormatter.dateFormat = @"yyyy-MM-dd'T'HHmmss";
+  NSString* reportFileName = [NSString stringWithFormat:@"sustained-load-%@.plist", [dateFormatter stringFromDate:[NSDate date]]];
+  NSString* reportFilePath = [benchmarkFolderPath stringByAppendingPathComponent:reportFileName];
+  BOOL success = [report writeToFile:reportFilePath atomically:YES];
+  if (! success)
+  {
+    DDLogError(@"%@: Failed to write benchmark report to %@", [self shortDescription], reportFilePath);
+    return false;
+  }
+
+  DDLogInfo(@"%@: Benchmark finished, report written to %@, summary = %@", [self shortDescription], reportFilePath, summary);
+  self.reportFilePath = reportFilePath;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the GTP command @a commandString and waits
+/// for the response. Returns true if the command was successful.
+// -----------------------------------------------------------------------------
+- (bool) submitGtpCommand:(NSString*)commandString
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+  [command submit];
+  if (! command.response.status)
+  {
+    DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], commandString, command.response.parsedResponse);
+    return false;
+  }
+  return true;
+}
+
+@end
@@ -0,0 +1,104 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+#import "../AsynchronousCommand.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The RunThreadScalingBenchmarkCommand class is responsible for
+/// measuring how the GTP engine's search scales with the number of threads on
+/// the device, and for feeding the result into the auto-tuning of the number
+/// of threads (see GtpEngineProfile). Command execution occurs
+/// asynchronously.
+///
+/// RunThreadScalingBenchmarkCommand is intended to be run on real hardware,
+/// where a mix of performance and efficiency cores makes it hard to predict how
+/// many threads are worth using. The app runs the command after launch if it is
+/// launched with #threadScalingBenchmarkLaunchArgument. The configuration can
+/// be varied with launch environment keys, see initWithLaunchEnvironment:().
+///
+/// The workload is the same for every number of threads: The GTP engine sets
+/// up a 19x19 board with a short fixed opening, then repeatedly generates a
+/// move with "reg_genmove" for black. "reg_genmove" searches without playing
+/// the move, and subtree reuse is turned off, so every search starts from
+/// scratch from the same position. Each search is limited by the clock to
+/// @e searchTime seconds. The searches are repeated @e repetitions times for
+/// every number of threads from 1 up to the number of active processor cores.
+/// After each search RunThreadScalingBenchmarkCommand obtains the search
+/// statistics with GtpUctSearchStatistics.
+///
+/// For each number of threads the benchmark reports:
+/// - The playouts per second, summed up over all repetitions.
+/// - The speedup, i.e. the playouts per second relative to a single thread.
+/// - The efficiency per thread, i.e. the speedup divided by the number of
+///   threads. Perfect scaling has an efficiency of 1.0.
+/// - The search result stability, i.e. the fraction of repetitions that
+///   generated the move that was generated most often. A search that is
+///   stable across repetitions is one whose result does not depend on the
+///   vagaries of thread scheduling.
+///
+/// The recommended number of threads is the largest number of threads whose
+/// efficiency is at least #threadScalingBenchmarkMinimumEfficiency. Additional
+/// threads beyond that number typically run on efficiency cores, where they
+/// add little to the search but a lot to the energy consumption. The
+/// recommendation is stored in the user defaults under
+/// #threadScalingBenchmarkResultKey, together with the device model, where
+/// GtpEngineProfile::benchmarkedFuegoThreadCount() picks it up for the
+/// auto-tuning.
+///
+/// The report is written to a property list file in the folder returned by
+/// PathUtilities::benchmarkFolderPath(). The property list contains a
+/// dictionary with these keys:
+/// - "configuration": A dictionary with the benchmark configuration and the
+///   device model.
+/// - "results": An array with one dictionary per number of threads, with the
+///   keys "numberOfThreads", "gamesPlayed", "searchTime", "gamesPerSecond",
+///   "speedup", "efficiency", "mostFrequentMove" and "stability".
+/// - "recommendedNumberOfThreads": The recommended number of threads.
+///
+/// The device's idle timer is disabled while the benchmark runs, otherwise
+/// the screen would lock and the system would suspend the app.
+///
+/// When the benchmark is over, RunThreadScalingBenchmarkCommand re-applies the
+/// active profile and synchronizes the GTP engine with the current game.
+///
+/// The command fails if the computer player is thinking when the command is
+/// executed, or if a GTP command fails.
+// -----------------------------------------------------------------------------
+@interface RunThreadScalingBenchmarkCommand : CommandBase <AsynchronousCommand>
+{
+}
+
+- (id) init;
+- (id) initWithLaunchEnvironment:(NSDictionary*)launchEnvironment;
+
+/// @brief The time in seconds of each search. The default is
+/// #threadScalingBenchmarkSearchTimeDefault.
+@property(nonatomic, assign) unsigned int searchTime;
+/// @brief The number of searches for each number of threads. The default is
+/// #threadScalingBenchmarkRepetitionsDefault.
+@property(nonatomic, assign) int repetitions;
+/// @brief The largest number of threads that the benchmark measures. The
+/// default is the number of active processor cores.
+@property(nonatomic, assign) int maximumNumberOfThreads;
+/// @brief The full path of the property list file that contains the report.
+/// Is nil until the command has been executed successfully.
+@property(nonatomic, retain, readonly) NSString* reportFilePath;
+
+@end
@@ -0,0 +1,416 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "RunThreadScalingBenchmarkCommand.h"
+#import "../boardposition/SyncGTPEngineCommand.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoGame.h"
+#import "../../gtp/GtpCommand.h"
+#import "../../gtp/GtpEnergyGovernor.h"
+#import "../../gtp/GtpResponse.h"
+#import "../../gtp/GtpUctSearchStatistics.h"
+#import "../../gtp/GtpUtilities.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../player/GtpEngineProfile.h"
+#import "../../player/GtpEngineProfileModel.h"
+#import "../../utility/PathUtilities.h"
+#import "../../utility/UIDeviceAdditions.h"
+
+// System includes
+#include <sys/sysctl.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// RunThreadScalingBenchmarkCommand.
+// -----------------------------------------------------------------------------
+@interface RunThreadScalingBenchmarkCommand()
+@property(nonatomic, retain, readwrite) NSString* reportFilePath;
+/// @brief The results recorded so far, one per number of threads.
+@property(nonatomic, retain) NSMutableArray* results;
+@end
+
+
+@implementation RunThreadScalingBenchmarkCommand
+
+@synthesize asynchronousCommandDelegate;
+@synthesize showProgressHUD;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a RunThreadScalingBenchmarkCommand object with the
+/// default configuration.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  return [self initWithLaunchEnvironment:@{}];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a RunThreadScalingBenchmarkCommand object with the
+/// configuration found in @a launchEnvironment. Keys that are missing from
+/// @a launchEnvironment, or whose values are not valid, result in the default
+/// configuration value.
+///
+/// @see #threadScalingBenchmarkSearchTimeLaunchEnvironmentKey,
+/// #threadScalingBenchmarkRepetitionsLaunchEnvironmentKey.
+///
+/// @note This is the designated initializer of
+/// RunThreadScalingBenchmarkCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithLaunchEnvironment:(NSDictionary*)launchEnvironment
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.searchTime = threadScalingBenchmarkSearchTimeDefault;
+  NSString* searchTimeString = launchEnvironment[threadScalingBenchmarkSearchTimeLaunchEnvironmentKey];
+  if (searchTimeString.intValue > 0)
+    self.searchTime = searchTimeString.intValue;
+
+  self.repetitions = threadScalingBenchmarkRepetitionsDefault;
+  NSString* repetitionsString = launchEnvironment[threadScalingBenchmarkRepetitionsLaunchEnvironmentKey];
+  if (repetitionsString.intValue > 0)
+    self.repetitions = repetitionsString.intValue;
+
+  // Cast is safe, no device has more than pow(2, 31) cores
+  self.maximumNumberOfThreads = MAX((int)[NSProcessInfo processInfo].activeProcessorCount, 1);
+
+  self.reportFilePath = nil;
+  self.results = [NSMutableArray array];
+  // The benchmark keeps the GTP engine busy for a long time. The progress HUD
+  // prevents the user from interfering with the measurements.
+  self.showProgressHUD = true;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this RunThreadScalingBenchmarkCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.reportFilePath = nil;
+  self.results = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  if ([GoGame sharedGame].isComputerThinking)
+  {
+    DDLogError(@"%@: Cannot run the benchmark while the computer player is thinking", [self shortDescription]);
+    return false;
+  }
+
+  DDLogInfo(@"%@: Starting benchmark, configuration = %@", [self shortDescription], [self configuration]);
+
+  [self.asynchronousCommandDelegate asynchronousCommand:self
+                                            didProgress:0.0
+                                        nextStepMessage:@"Running benchmark..."];
+
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [UIApplication sharedApplication].idleTimerDisabled = YES;
+  });
+
+  GtpEnergyGovernor* energyGovernor = [GtpEnergyGovernor sharedGovernor];
+  [energyGovernor beginBackgroundAnalysis];
+  [GtpUtilities stopPondering];
+  bool success = false;
+  @try
+  {
+    if (! [self setupWorkload])
+      return false;
+    success = [self runWorkload];
+    // Must happen before the active profile is re-applied, so that the
+    // auto-tuning already uses the new recommendation
+    if (success)
+      [self storeRecommendedNumberOfThreads];
+  }
+  @finally
+  {
+    [energyGovernor endBackgroundAnalysis];
+    [self restoreGtpEngineState];
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [UIApplication sharedApplication].idleTimerDisabled = NO;
+    });
+  }
+
+  if (! success)
+    return false;
+  return [self writeReport];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Configures the GTP engine and sets up the
+/// position that every search starts from. Returns true if all GTP commands
+/// were successful.
+// -----------------------------------------------------------------------------
+- (bool) setupWorkload
+{
+  NSArray* commandStrings = @[
+    // Every search must start from scratch, otherwise later searches would
+    // profit from the work of earlier searches
+    @"uct_param_player reuse_subtree 0",
+    // The clock, not the playout limit, must end each search
+    @"uct_param_player ignore_clock 0",
+    [NSString stringWithFormat:@"uct_param_player max_games %llu", fuegoMaxGamesMaximum],
+    [NSString stringWithFormat:@"go_param timelimit %u", self.searchTime],
+    @"time_settings 0 1 0",
+    @"boardsize 19",
+    @"clear_board",
+    @"komi 6.5",
+    @"play B Q16",
+    @"play W D4",
+    @"play B Q3",
+    @"play W D16",
+  ];
+
+  for (NSString* commandString in commandStrings)
+  {
+    if (! [self submitGtpCommand:commandString])
+      return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Runs the searches for every number of
+/// threads. Returns true if all GTP commands were successful.
+// -----------------------------------------------------------------------------
+- (bool) runWorkload
+{
+  int numberOfSearches = self.maximumNumberOfThreads * self.repetitions;
+  int searchIndex = 0;
+
+  for (int numberOfThreads = 1; numberOfThreads <= self.maximumNumberOfThreads; ++numberOfThreads)
+  {
+    if (! [self submitGtpCommand:[NSString stringWithFormat:@"uct_param_search number_threads %d", numberOfThreads]])
+      return false;
+
+    unsigned long long gamesPlayed = 0;
+    double searchTime = 0.0;
+    NSCountedSet* moves = [NSCountedSet set];
+
+    for (int repetition = 0; repetition < self.repetitions; ++repetition)
+    {
+      // Searches run with the same quality of service as the computer
+      // player's regular moves (the GtpCommand default), so that the system
+      // schedules the threads in the same way
+      GtpCommand* genMoveCommand = [GtpCommand command:@"reg_genmove B"];
+      genMoveCommand.qualityOfService = NSQualityOfServiceUserInitiated;
+      [genMoveCommand submit];
+      if (! genMoveCommand.response.status)
+      {
+        DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], genMoveCommand.command, genMoveCommand.response.parsedResponse);
+        return false;
+      }
+
+      GtpCommand* statisticsCommand = [GtpCommand command:@"uct_stat_search"];
+      [statisticsCommand submit];
+      if (! statisticsCommand.response.status)
+      {
+        DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], statisticsCommand.command, statisticsCommand.response.parsedResponse);
+        return false;
+      }
+
+      GtpUctSearchStatistics* statistics = [GtpUctSearchStatistics statisticsWithResponse:statisticsCommand.response];
+      gamesPlayed += statistics.gamesPlayed;
+      searchTime += statistics.searchTime;
+      [moves addObject:[genMoveCommand.response.parsedResponse uppercaseString]];
+
+      searchIndex++;
+      float progress = (float)searchIndex / numberOfSearches;
+      [self.asynchronousCommandDelegate asynchronousCommand:self didProgress:progress nextStepMessage:nil];
+    }
+
+    [self recordResultForNumberOfThreads:numberOfThreads gamesPlayed:gamesPlayed searchTime:searchTime moves:moves];
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for runWorkload(). Records the result of all
+/// searches with @a numberOfThreads threads. The result for a single thread
+/// must already have been recorded, unless @a numberOfThreads is 1.
+// -----------------------------------------------------------------------------
+- (void) recordResultForNumberOfThreads:(int)numberOfThreads
+                            gamesPlayed:(unsigned long long)gamesPlayed
+                             searchTime:(double)searchTime
+                                  moves:(NSCountedSet*)moves
+{
+  double gamesPerSecond = (searchTime > 0.0) ? gamesPlayed / searchTime : 0.0;
+  double singleThreadGamesPerSecond = (1 == numberOfThreads) ? gamesPerSecond : [self.results.firstObject[@"gamesPerSecond"] doubleValue];
+  double speedup = (singleThreadGamesPerSecond > 0.0) ? gamesPerSecond / singleThreadGamesPerSecond : 0.0;
+  double efficiency = speedup / numberOfThreads;
+
+  NSString* mostFrequentMove = nil;
+  NSUInteger mostFrequentMoveCount = 0;
+  for (NSString* move in moves)
+  {
+    NSUInteger moveCount = [moves countForObject:move];
+    if (moveCount > mostFrequentMoveCount)
+    {
+      mostFrequentMove = move;
+      mostFrequentMoveCount = moveCount;
+    }
+  }
+  double stability = (self.repetitions > 0) ? (double)mostFrequentMoveCount / self.repetitions : 0.0;
+
+  NSDictionary* result = @{@"numberOfThreads" : [NSNumber numberWithInt:numberOfThreads],
+                           @"gamesPlayed" : [NSNumber numberWithUnsignedLongLong:gamesPlayed],
+                           @"searchTime" : [NSNumber numberWithDouble:searchTime],
+                           @"gamesPerSecond" : [NSNumber numberWithDouble:gamesPerSecond],
+                           @"speedup" : [NSNumber numberWithDouble:speedup],
+                           @"efficiency" : [NSNumber numberWithDouble:efficiency],
+                           @"mostFrequentMove" : mostFrequentMove ? mostFrequentMove : @"",
+                           @"stability" : [NSNumber numberWithDouble:stability]};
+  [self.results addObject:result];
+
+  DDLogInfo(@"%@: Result for %d threads = %@", [self shortDescription], numberOfThreads, result);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the largest number of threads whose
+/// efficiency is at least #threadScalingBenchmarkMinimumEfficiency. A single
+/// thread is always recommended, regardless of its efficiency.
+// -----------------------------------------------------------------------------
+- (int) recommendedNumberOfThreads
+{
+  int recommendedNumberOfThreads = 1;
+  for (NSDictionary* result in self.results)
+  {
+    if ([result[@"efficiency"] doubleValue] >= threadScalingBenchmarkMinimumEfficiency)
+      recommendedNumberOfThreads = MAX(recommendedNumberOfThreads, [result[@"numberOfThreads"] intValue]);
+  }
+  return recommendedNumberOfThreads;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Stores the recommended number of threads
+/// in the user defaults, where the auto-tuning of GtpEngineProfile picks it
+/// up.
+// -----------------------------------------------------------------------------
+- (void) storeRecommendedNumberOfThreads
+{
+  NSDictionary* benchmarkResult = @{@"deviceModel" : [UIDevice hardwareModel],
+                                    @"recommendedNumberOfThreads" : [NSNumber numberWithInt:[self recommendedNumberOfThreads]]};
+  [[NSUserDefaults standardUserDefaults] setObject:benchmarkResult forKey:threadScalingBenchmarkResultKey];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a dictionary that describes the benchmark
+/// configuration and the device that runs the benchmark.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) configuration
+{
+  int numberOfPerformanceCores = 0;
+  size_t size = sizeof(numberOfPerformanceCores);
+  if (0 != sysctlbyname("hw.perflevel0.logicalcpu", &numberOfPerformanceCores, &size, NULL, 0))
+    numberOfPerformanceCores = 0;
+
+  return @{@"searchTime" : [NSNumber numberWithUnsignedInt:self.searchTime],
+           @"repetitions" : [NSNumber numberWithInt:self.repetitions],
+           @"maximumNumberOfThreads" : [NSNumber numberWithInt:self.maximumNumberOfThreads],
+           @"minimumEfficiency" : [NSNumber numberWithDouble:threadScalingBenchmarkMinimumEfficiency],
+           @"deviceModel" : [UIDevice hardwareModel],
+           @"systemVersion" : [UIDevice currentDevice].systemVersion,
+           @"processorCount" : [NSNumber numberWithUnsignedInteger:[NSProcessInfo processInfo].activeProcessorCount],
+           @"performanceCoreCount" : [NSNumber numberWithInt:numberOfPerformanceCores]};
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Re-applies the active profile and
+/// synchronizes the GTP engine with the current game. The "boardsize" command
+/// of the benchmark has put GtpEngineState into an unknown state, so
+/// SyncGTPEngineCommand replays the current game from scratch.
+///
+/// Re-applying the active profile also restores pondering, as far as
+/// GtpEnergyGovernor allows it. The auto-tuned number of threads of the
+/// active profile may already take the new benchmark result into account.
+// -----------------------------------------------------------------------------
+- (void) restoreGtpEngineState
+{
+  GtpEngineProfile* activeProfile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  [activeProfile applyProfile];
+
+  GoGame* game = [GoGame sharedGame];
+  [self submitGtpCommand:[NSString stringWithFormat:@"boardsize %d", game.board.size]];
+
+  SyncGTPEngineCommand* syncCommand = [[[SyncGTPEngineCommand alloc] init] autorelease];
+  bool success = [syncCommand submit];
+  if (! success)
+    DDLogError(@"%@: Failed to synchronize the GTP engine state with the current game, error message = %@", [self shortDescription], syncCommand.errorDescription);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Writes the report to a property list file
+/// in the benchmark folder. Returns true if writing was successful.
+// -----------------------------------------------------------------------------
+- (bool) writeReport
+{
+  NSDictionary* report = @{@"configuration" : [self configuration],
+                           @"results" : self.results,
+                           @"recommendedNumberOfThreads" : [NSNumber numberWithInt:[self recommendedNumberOfThreads]]};
+
+  NSString* benchmarkFolderPath = [PathUtilities benchmarkFolderPath];
+  [PathUtilities createFolder:benchmarkFolderPath removeIfExists:false];
+
+  NSDateFormatter* dateFormatter = [[[NSDateFormatter alloc] init] autorelease];
+  dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+  dateFormatter.dateFormat = @"yyyy-MM-dd'T'HHmmss";
+  NSString* reportFileName = [NSString stringWithFormat:@"thread-scaling-%@.plist", [dateFormatter stringFromDate:[NSDate date]]];
+  NSString* reportFilePath = [benchmarkFolderPath stringByAppendingPathComponent:reportFileName];
+  BOOL success = [report writeToFile:reportFilePath atomically:YES];
+  if (! success)
+  {
+    DDLogError(@"%@: Failed to write benchmark report to %@", [self shortDescription], reportFilePath);
+    return false;
+  }
+
+  DDLogInfo(@"%@: Benchmark finished, report written to %@, recommended number of threads = %d", [self shortDescription], reportFilePath, [self recommendedNumberOfThreads]);
+  self.reportFilePath = reportFilePath;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the GTP command @a commandString and waits
+/// for the response. Returns true if the command was successful.
+// -----------------------------------------------------------------------------
+- (bool) submitGtpCommand:(NSString*)commandString
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+  [command submit];
+  if (! command.response.status)
+  {
+    DDLogError(@"%@: GTP command %@ failed: %@", [self shortDescription], commandString, command.response.parsedResponse);
+    return false;
+  }
+  return true;
+}
+
+@end
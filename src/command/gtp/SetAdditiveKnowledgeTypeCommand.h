@@ -22,7 +22,9 @@
 // -----------------------------------------------------------------------------
 /// @brief The SetAdditiveKnowledgeTypeCommand class is responsible for
 /// submitting a "uct_param_policy knowledge_type" command to the GTP engine.
-/// Command execution occurs synchronously.
+/// The GTP command is executed asynchronously, i.e.
+/// SetAdditiveKnowledgeTypeCommand returns before the GTP engine has processed
+/// the command. If the GTP engine fails to process the command, this is logged.
 ///
 /// The additive knowledge type used as the command argument is determined by
 /// looking at the device memory:
@@ -47,10 +47,22 @@
   NSString* commandString = [self commandStringForKnowledgeType:additiveKnowledgeType];
   if (! commandString)
     return false;
-  GtpCommand* command = [GtpCommand command:commandString];
+
+  // The command is not waited for, because the GTP engine may still be busy
+  // setting itself up and parsing the opening book. The GTP engine processes
+  // commands in FIFO order, so the knowledge type is set before any command
+  // that is submitted later.
+  NSString* shortDescription = [self shortDescription];
+  GtpCommand* command = [GtpCommand asynchronousCommand:commandString
+                                        completionQueue:nil
+                                      completionHandler:^(GtpResponse* response)
+  {
+    if (! response.status)
+      DDLogError(@"%@: Setting the additive knowledge type failed: %@", shortDescription, response.parsedResponse);
+  }];
   [command submit];
 
-  return command.response.status;
+  return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -22,6 +22,8 @@
 #import "../../go/GoBoardPosition.h"
 #import "../../go/GoNode.h"
 #import "../../go/GoNodeMarkup.h"
+#import "../../go/GoNodeModel.h"
+#import "../../go/GoNodeTextIndex.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../shared/ApplicationStateManager.h"
 #import "../../ui/UiSettingsModel.h"
@@ -109,6 +111,8 @@
     {
       applicationStateDidChange = nodeMarkup.hasMarkup;
       currentNode.goNodeMarkup = nil;
+      [game.nodeModel updateJumpTargetsOfNode:currentNode];
+      [game.nodeTextIndex updateNode:currentNode];
     }
 
     if (applicationStateDidChange)
@@ -17,7 +17,6 @@
 
 // Project includes
 #import "HandleMarkupEditingInteractionCommand.h"
-#import "../backup/BackupGameToSgfCommand.h"
 #import "../../go/GoGame.h"
 #import "../../go/GoBoard.h"
 #import "../../go/GoBoardPosition.h"
@@ -29,6 +28,7 @@
 #import "../../main/ApplicationDelegate.h"
 #import "../../play/model/MarkupModel.h"
 #import "../../shared/ApplicationStateManager.h"
+#import "../../shared/MarkupEditingTransaction.h"
 #import "../../ui/UiSettingsModel.h"
 #import "../../ui/UIViewControllerAdditions.h"
 #import "../../utility/MarkupUtilities.h"
@@ -465,7 +465,7 @@ enum MarkupEditingInteraction
     {
       applicationStateDidChange = true;
       [self postNotificationsWithNode:node pointsWithChangedMarkup:pointsWithChangedMarkup];
-      [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
+      [[MarkupEditingTransaction sharedTransaction] backupGameWhenCommitted];
     }
   }
   @finally
@@ -484,10 +484,11 @@ enum MarkupEditingInteraction
 /// on the data in @a pointsWithChangedMarkup.
 ///
 /// #nodeMarkupDataDidChange is posted with @a node as the notification object.
+/// If a MarkupEditingTransaction is in progress, #nodeMarkupDataDidChange is
+/// deferred until the transaction is committed.
 // -----------------------------------------------------------------------------
 - (void) postNotificationsWithNode:(GoNode*)node pointsWithChangedMarkup:(NSArray*)pointsWithChangedMarkup
 {
-  NSObject* notificationObjectNodeMarkupDataDidChange = node;
   NSArray* notificationObjectMarkupOnPointsDidChange;
 
   if (pointsWithChangedMarkup.count == 2 &&
@@ -507,7 +508,7 @@ enum MarkupEditingInteraction
   }
 
   [[NSNotificationCenter defaultCenter] postNotificationName:markupOnPointsDidChange object:notificationObjectMarkupOnPointsDidChange];
-  [[NSNotificationCenter defaultCenter] postNotificationName:nodeMarkupDataDidChange object:notificationObjectNodeMarkupDataDidChange];
+  [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
 }
 
 // -----------------------------------------------------------------------------
@@ -31,6 +31,12 @@
 /// updates GoGame so that it generates a GoMove of the appropriate type for
 /// the player whose turn it is (not necessarily a computer player).
 ///
+/// If the opening book contains the current board position (see
+/// GoOpeningBook), ComputerPlayMoveCommand plays the book move instead of
+/// submitting "genmove". The GTP engine is only told about the move with a
+/// "play" command, so book moves are played without waiting for the GTP engine
+/// to search or to consult its own copy of the book.
+///
 /// Another ComputerPlayMoveCommand is submitted automatically if it is now
 /// the computer player's turn to move.
 ///
@@ -27,13 +27,17 @@
 #import "../../go/GoBoard.h"
 #import "../../go/GoGame.h"
 #import "../../go/GoMoveNodeCreationOptions.h"
+#import "../../go/GoOpeningBook.h"
 #import "../../go/GoPlayer.h"
 #import "../../go/GoPoint.h"
 #import "../../go/GoVertex.h"
 #import "../../gtp/GtpCommand.h"
 #import "../../gtp/GtpResponse.h"
+#import "../../gtp/GtpSearchMetrics.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../play/model/GameVariationModel.h"
+#import "../../player/GtpEngineProfile.h"
+#import "../../player/GtpEngineProfileModel.h"
 #import "../../shared/ApplicationStateManager.h"
 #import "../../shared/LongRunningActionCounter.h"
 #import "../../ui/UIViewControllerAdditions.h"
@@ -53,9 +57,22 @@ enum AlertType
 // -----------------------------------------------------------------------------
 @interface ComputerPlayMoveCommand()
 @property(nonatomic, retain) GoPoint* illegalMove;
+@property(nonatomic, assign) bool computerGoesOnPlaying;
+@property(nonatomic, retain) GoPlayer* thinkingPlayer;
+@property(nonatomic, assign) CFAbsoluteTime thinkingStartTime;
+/// @brief The move found in the opening book, or nil if the GTP engine
+/// generates the move.
+@property(nonatomic, retain) GoPoint* bookMove;
 @end
 
 
+/// @brief True while the UI updates for the moves of a computer vs. computer
+/// game are being held back. See updateSelfPlayUIRefreshBatch() for details.
+static bool selfPlayUIRefreshBatchInProgress = false;
+/// @brief The time when the current self-play UI refresh batch started.
+static CFAbsoluteTime selfPlayUIRefreshBatchStartTime = 0;
+
+
 @implementation ComputerPlayMoveCommand
 
 // -----------------------------------------------------------------------------
@@ -89,6 +106,10 @@ enum AlertType
 
   self.game = sharedGame;
   self.illegalMove = nil;
+  self.computerGoesOnPlaying = false;
+  self.thinkingPlayer = nil;
+  self.thinkingStartTime = 0;
+  self.bookMove = nil;
 
   return self;
 }
@@ -100,6 +121,8 @@ enum AlertType
 {
   self.game = nil;
   self.illegalMove = nil;
+  self.thinkingPlayer = nil;
+  self.bookMove = nil;
   [super dealloc];
 }
 
@@ -108,24 +131,90 @@ enum AlertType
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
+  self.thinkingPlayer = self.game.nextMovePlayer;
+
+  self.bookMove = [[GoOpeningBook sharedOpeningBook] moveForGame:self.game];
+  if (self.bookMove)
+  {
+    [self submitBookMove];
+    return true;
+  }
+
+  [self submitTimeLeftCommand];
+
   // It's important that we do not wait for the GTP command to complete. This
   // gives the UI the time to update (e.g. status view, activity indicator).
   NSString* commandString = @"genmove ";
-  commandString = [commandString stringByAppendingString:self.game.nextMovePlayer.colorString];
+  commandString = [commandString stringByAppendingString:self.thinkingPlayer.colorString];
   GtpCommand* command = [GtpCommand asynchronousCommand:commandString
                                          responseTarget:self
                                                selector:@selector(gtpResponseReceived:)];
+  // The user is waiting for the computer's move
+  command.qualityOfService = NSQualityOfServiceUserInteractive;
+  self.thinkingStartTime = CFAbsoluteTimeGetCurrent();
   [command submit];
   self.game.reasonForComputerIsThinking = GoGameComputerIsThinkingReasonComputerPlay;
   return true;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Tells the GTP engine to play the move found in the opening book,
+/// instead of letting the GTP engine generate a move.
+///
+/// The GTP engine does not search when it receives a "play" command, so the
+/// response arrives almost immediately. The command is nevertheless not
+/// waited for, for the same reason as the "genmove" command in doIt(). If
+/// pondering is enabled the GTP engine ponders on the new board position
+/// while it waits for the next command, just as after a move that it
+/// generated itself.
+///
+/// This is a private helper for doIt().
+// -----------------------------------------------------------------------------
+- (void) submitBookMove
+{
+  DDLogInfo(@"%@: Playing %@ from the opening book", [self shortDescription], self.bookMove.vertex.string);
+
+  NSString* commandString = [NSString stringWithFormat:@"play %@ %@", self.thinkingPlayer.colorString, self.bookMove.vertex.string];
+  GtpCommand* command = [GtpCommand asynchronousCommand:commandString
+                                         responseTarget:self
+                                               selector:@selector(bookMoveResponseReceived:)];
+  command.qualityOfService = NSQualityOfServiceUserInteractive;
+  [command submit];
+  self.game.reasonForComputerIsThinking = GoGameComputerIsThinkingReasonComputerPlay;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Tells the GTP engine how much of the game's time budget is left for
+/// the player who is about to move. Does nothing if the active GTP engine
+/// profile has no time budget for the game.
+///
+/// This is a private helper for doIt().
+// -----------------------------------------------------------------------------
+- (void) submitTimeLeftCommand
+{
+  GtpEngineProfile* profile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  if (! profile || 0 == profile.fuegoMaxGameTime)
+    return;
+
+  // Fuego's time management needs at least one second to work with
+  int timeLeft = (int)(profile.fuegoMaxGameTime - self.thinkingPlayer.thinkingTime);
+  if (timeLeft < 1)
+    timeLeft = 1;
+
+  NSString* commandString = [NSString stringWithFormat:@"time_left %@ %d 0", self.thinkingPlayer.colorString, timeLeft];
+  GtpCommand* command = [GtpCommand command:commandString];
+  command.waitUntilDone = false;
+  [command submit];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Is triggered when the GTP engine responds to the command submitted
 /// in doIt().
 // -----------------------------------------------------------------------------
 - (void) gtpResponseReceived:(GtpResponse*)response
 {
+  self.thinkingPlayer.thinkingTime += CFAbsoluteTimeGetCurrent() - self.thinkingStartTime;
+
   @try
   {
     [[ApplicationStateManager sharedManager] beginSavePoint];
@@ -143,6 +232,10 @@ enum AlertType
     if (! success)
       return;
 
+    // Must be submitted before the next ComputerPlayMoveCommand submits its
+    // "genmove", otherwise the statistics describe the wrong search
+    [[ApplicationDelegate sharedDelegate].gtpSearchMetrics collectMetricsOfMostRecentSearch];
+
     // Don't check command execution result, it is irrelevant for us whether the
     // command succeeds or not. There is a known case where the command fails:
     // If statistics collection was enabled while the "genmove" command above
@@ -160,6 +253,86 @@ enum AlertType
     [[ApplicationStateManager sharedManager] applicationStateDidChange];
     [[ApplicationStateManager sharedManager] commitSavePoint];
     [[LongRunningActionCounter sharedCounter] decrement];
+    [self updateSelfPlayUIRefreshBatch];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is triggered when the GTP engine responds to the command submitted
+/// in submitBookMove().
+// -----------------------------------------------------------------------------
+- (void) bookMoveResponseReceived:(GtpResponse*)response
+{
+  @try
+  {
+    [[ApplicationStateManager sharedManager] beginSavePoint];
+    [[LongRunningActionCounter sharedCounter] increment];
+
+    if (! response.status)
+    {
+      DDLogError(@"%@: Aborting due to failed GTP command", [self shortDescription]);
+      assert(0);
+      [self handleComputerFailedToPlay:response.parsedResponse];
+      return;
+    }
+
+    bool success = [self playStoneAtPoint:self.bookMove withMoveNodeCreationOptions:[self moveNodeCreationOptions]];
+    if (! success)
+      return;
+    [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
+
+    // The GTP engine did not search, so there are neither search metrics nor
+    // new territory statistics to collect
+    [self continuePlayingIfNecessary];
+  }
+  @finally
+  {
+    [[ApplicationStateManager sharedManager] applicationStateDidChange];
+    [[ApplicationStateManager sharedManager] commitSavePoint];
+    [[LongRunningActionCounter sharedCounter] decrement];
+    [self updateSelfPlayUIRefreshBatch];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Holds back UI updates while the computer plays against itself, so
+/// that the game proceeds at the speed of the GTP engine instead of at the
+/// speed of the UI.
+///
+/// A self-play UI refresh batch is a long-running action (see
+/// LongRunningActionCounter) that spans several moves. It starts when the
+/// computer goes on playing in a computer vs. computer game. It ends when
+/// #selfPlayUIRefreshInterval has elapsed, or when the computer stops playing,
+/// at which point all UI updates that have accumulated are performed at once.
+/// If the computer goes on playing a new batch starts immediately. If the GTP
+/// engine takes longer than #selfPlayUIRefreshInterval to generate a move, as
+/// is typical with the default thinking times, the UI therefore still shows
+/// every move.
+///
+/// This is a private helper for gtpResponseReceived:(). It must be invoked
+/// after the long-running action of the current move has ended, so that ending
+/// the batch actually triggers the UI update.
+// -----------------------------------------------------------------------------
+- (void) updateSelfPlayUIRefreshBatch
+{
+  bool shouldHoldBackUIUpdates = (self.computerGoesOnPlaying &&
+                                  self.game.type == GoGameTypeComputerVsComputer);
+
+  if (selfPlayUIRefreshBatchInProgress)
+  {
+    CFAbsoluteTime elapsedTime = CFAbsoluteTimeGetCurrent() - selfPlayUIRefreshBatchStartTime;
+    if (! shouldHoldBackUIUpdates || elapsedTime >= selfPlayUIRefreshInterval)
+    {
+      selfPlayUIRefreshBatchInProgress = false;
+      [[LongRunningActionCounter sharedCounter] decrement];
+    }
+  }
+
+  if (shouldHoldBackUIUpdates && ! selfPlayUIRefreshBatchInProgress)
+  {
+    selfPlayUIRefreshBatchInProgress = true;
+    selfPlayUIRefreshBatchStartTime = CFAbsoluteTimeGetCurrent();
+    [[LongRunningActionCounter sharedCounter] increment];
   }
 }
 
@@ -171,15 +344,18 @@ enum AlertType
 // -----------------------------------------------------------------------------
 - (bool) playMoveInsideResponse:(GtpResponse*)response
 {
-  GoMoveNodeCreationOptions* options;
-  GameVariationModel* gameVariationModel = [ApplicationDelegate sharedDelegate].gameVariationModel;
-  if (gameVariationModel.newMoveInsertPolicy == GoNewMoveInsertPolicyRetainFutureBoardPositions)
-    options = [GoMoveNodeCreationOptions moveNodeCreationOptionsWithInsertPolicyRetainFutureBoardPositionsAndInsertPosition:gameVariationModel.newMoveInsertPosition];
-  else
-    options = [GoMoveNodeCreationOptions moveNodeCreationOptionsWithInsertPolicyReplaceFutureBoardPositions];
+  GoMoveNodeCreationOptions* options = [self moveNodeCreationOptions];
+
+  enum GtpResponseMoveType moveType;
+  struct GoVertexNumeric numericVertex;
+  if (! [response parseMoveType:&moveType vertex:&numericVertex])
+  {
+    DDLogError(@"%@: Invalid move %@", [self shortDescription], response.parsedResponse);
+    assert(0);
+    return false;
+  }
 
-  NSString* responseString = [response.parsedResponse lowercaseString];
-  if ([responseString isEqualToString:@"pass"])
+  if (moveType == GtpResponseMoveTypePass)
   {
     enum GoMoveIsIllegalReason illegalReason;
     if ([self.game isLegalPassMoveIllegalReason:&illegalReason])
@@ -192,30 +368,21 @@ enum AlertType
       return false;
     }
   }
-  else if ([responseString isEqualToString:@"resign"])
+  else if (moveType == GtpResponseMoveTypeResign)
   {
     [self.game resign];
   }
   else
   {
-    GoPoint* point = [self.game.board pointAtVertex:responseString];
+    GoPoint* point = [self.game.board pointAtNumericVertex:numericVertex];
     if (point)
     {
-      enum GoMoveIsIllegalReason illegalReason;
-      if ([self.game isLegalMove:point isIllegalReason:&illegalReason])
-      {
-        [self.game play:point withMoveNodeCreationOptions:options];
-      }
-      else
-      {
-        self.illegalMove = point;
-        [self handleComputerPlayedIllegalMove1:illegalReason];
+      if (! [self playStoneAtPoint:point withMoveNodeCreationOptions:options])
         return false;
-      }
     }
     else
     {
-      DDLogError(@"%@: Invalid vertex %@", [self shortDescription], responseString);
+      DDLogError(@"%@: Invalid vertex %@", [self shortDescription], response.parsedResponse);
       assert(0);
       return false;
     }
@@ -225,6 +392,45 @@ enum AlertType
   return true;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Instructs GoGame to play a stone on @a point, using @a options.
+/// Returns true on success, false if the move is illegal.
+///
+/// This is a private helper for playMoveInsideResponse:() and
+/// bookMoveResponseReceived:().
+// -----------------------------------------------------------------------------
+- (bool) playStoneAtPoint:(GoPoint*)point withMoveNodeCreationOptions:(GoMoveNodeCreationOptions*)options
+{
+  enum GoMoveIsIllegalReason illegalReason;
+  if ([self.game isLegalMove:point isIllegalReason:&illegalReason])
+  {
+    [self.game play:point withMoveNodeCreationOptions:options];
+    return true;
+  }
+  else
+  {
+    self.illegalMove = point;
+    [self handleComputerPlayedIllegalMove1:illegalReason];
+    return false;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the options for creating the node of the computer player's
+/// move, according to the user's preferences.
+///
+/// This is a private helper for playMoveInsideResponse:() and
+/// bookMoveResponseReceived:().
+// -----------------------------------------------------------------------------
+- (GoMoveNodeCreationOptions*) moveNodeCreationOptions
+{
+  GameVariationModel* gameVariationModel = [ApplicationDelegate sharedDelegate].gameVariationModel;
+  if (gameVariationModel.newMoveInsertPolicy == GoNewMoveInsertPolicyRetainFutureBoardPositions)
+    return [GoMoveNodeCreationOptions moveNodeCreationOptionsWithInsertPolicyRetainFutureBoardPositionsAndInsertPosition:gameVariationModel.newMoveInsertPosition];
+  else
+    return [GoMoveNodeCreationOptions moveNodeCreationOptionsWithInsertPolicyReplaceFutureBoardPositions];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Is invoked when the GTP engine plays a move that Little Go thinks
 /// is illegal. Part 1: Offers the user a chance to submit a bug report before
@@ -450,6 +656,7 @@ enum AlertType
         computerGoesOnPlaying = true;
       break;
   }
+  self.computerGoesOnPlaying = computerGoesOnPlaying;
   if (computerGoesOnPlaying)
     [[[[ComputerPlayMoveCommand alloc] init] autorelease] submit];
   else
@@ -31,6 +31,20 @@
 /// ComputerSuggestMoveCommand initiates the display of the received suggestion
 /// by sending the notification #computerPlayerGeneratedMoveSuggestion.
 ///
+/// ComputerSuggestMoveCommand stores the move suggestion in the GoNode that is
+/// current when the command is executed. If the user requests another move
+/// suggestion for the same board position, e.g. after navigating away and
+/// coming back, ComputerSuggestMoveCommand does not submit a GTP command but
+/// immediately sends #computerPlayerGeneratedMoveSuggestion with the stored
+/// move suggestion. The stored move suggestion is discarded together with the
+/// GoNode.
+///
+/// If the GoNode has no valid move suggestion, the "reg_genmove" command is
+/// set up for response caching. When the same board position is reached in a
+/// different GoNode, e.g. in a different game variation or in a new game,
+/// GtpClient can then deliver the response from GtpResponseCache and the GTP
+/// engine does not have to search again.
+///
 /// While the GTP command is executing GoGame::reasonForComputerIsThinking()
 /// property is set so that observers can react and disable user interaction
 /// where appropriate.
@@ -18,9 +18,14 @@
 // Project includes
 #import "ComputerSuggestMoveCommand.h"
 #import "../../go/GoBoard.h"
+#import "../../go/GoBoardPosition.h"
 #import "../../go/GoGame.h"
+#import "../../go/GoNode.h"
 #import "../../gtp/GtpCommand.h"
 #import "../../gtp/GtpResponse.h"
+#import "../../gtp/GtpSearchMetrics.h"
+#import "../../gtp/GtpUtilities.h"
+#import "../../main/ApplicationDelegate.h"
 #import "../../utility/ExceptionUtility.h"
 #import "../../utility/NSStringAdditions.h"
 
@@ -31,6 +36,8 @@
 // -----------------------------------------------------------------------------
 @interface ComputerSuggestMoveCommand()
 @property(nonatomic, assign) enum GoColor color;
+@property(nonatomic, retain) GoNode* node;
+@property(nonatomic, assign) double komi;
 @end
 
 
@@ -63,6 +70,8 @@
   }
 
   self.color = color;
+  self.node = nil;
+  self.komi = 0.0;
 
   return self;
 }
@@ -73,6 +82,7 @@
 // -----------------------------------------------------------------------------
 - (void) dealloc
 {
+  self.node = nil;
   [super dealloc];
 }
 
@@ -81,6 +91,22 @@
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
+  GoGame* sharedGame = [GoGame sharedGame];
+
+  // The node is retained so that the move suggestion can be stored in the node
+  // even if the user navigates away from the node before the GTP response
+  // arrives
+  self.node = sharedGame.boardPosition.currentNode;
+  self.komi = sharedGame.komi;
+
+  NSDictionary* storedMoveSuggestion = [self.node moveSuggestionForColor:self.color
+                                                                    komi:self.komi];
+  if (storedMoveSuggestion)
+  {
+    [[NSNotificationCenter defaultCenter] postNotificationName:computerPlayerGeneratedMoveSuggestion object:nil userInfo:storedMoveSuggestion];
+    return true;
+  }
+
   NSString* colorString;
   if (self.color == GoColorBlack)
     colorString = @"B";
@@ -94,9 +120,11 @@
   GtpCommand* command = [GtpCommand asynchronousCommand:commandString
                                          responseTarget:self
                                                selector:@selector(gtpResponseReceived:)];
+  [GtpUtilities setupResponseCachingForCommand:command
+                                          game:sharedGame];
   [command submit];
 
-  [GoGame sharedGame].reasonForComputerIsThinking = GoGameComputerIsThinkingReasonMoveSuggestion;
+  sharedGame.reasonForComputerIsThinking = GoGameComputerIsThinkingReasonMoveSuggestion;
 
   return true;
 }
@@ -120,6 +148,8 @@
   }
   else
   {
+    [[ApplicationDelegate sharedDelegate].gtpSearchMetrics collectMetricsOfMostRecentSearch];
+
     NSString* responseString = [response.parsedResponse lowercaseString];
     if ([responseString isEqualToString:@"pass"])
     {
@@ -177,6 +207,10 @@
     moveSuggestionPointKey : (point ? point : (id)[NSNull null]),
     moveSuggestionErrorMessageKey : (errorMessage ? errorMessage : (id)[NSNull null]),
   };
+  // Failed move suggestions are not stored so that the user can try again
+  if (! errorMessage)
+    [self.node storeMoveSuggestion:dictionary komi:self.komi];
+
   [[NSNotificationCenter defaultCenter] postNotificationName:computerPlayerGeneratedMoveSuggestion object:nil userInfo:dictionary];
 }
 
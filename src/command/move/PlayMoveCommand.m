@@ -30,8 +30,7 @@
 #import "../../gtp/GtpResponse.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../play/model/GameVariationModel.h"
-#import "../../shared/ApplicationStateManager.h"
-#import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../ui/UIViewControllerAdditions.h"
 
 
@@ -162,8 +161,7 @@ enum AlertType
 
   @try
   {
-    [[ApplicationStateManager sharedManager] beginSavePoint];
-    [[LongRunningActionCounter sharedCounter] increment];
+    [[ModelMutationTransaction sharedTransaction] begin];
 
     GoMoveNodeCreationOptions* options;
     GameVariationModel* gameVariationModel = [ApplicationDelegate sharedDelegate].gameVariationModel;
@@ -203,9 +201,9 @@ enum AlertType
   }
   @finally
   {
-    [[ApplicationStateManager sharedManager] applicationStateDidChange];
-    [[ApplicationStateManager sharedManager] commitSavePoint];
-    [[LongRunningActionCounter sharedCounter] decrement];
+    ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
+    [transaction applicationStateDidChange];
+    [transaction commit];
   }
 
   [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
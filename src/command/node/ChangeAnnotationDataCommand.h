@@ -37,6 +37,7 @@
 ///   valuation change, in the GoMove object.
 /// - Remove the GoNodeAnnotation object if it only contains default data.
 /// - Set the document dirty flag.
+/// - Update the full-text index of the game if the descriptions changed.
 /// - Post a #nodeAnnotationDataDidChange notification.
 /// - Save the application state
 // -----------------------------------------------------------------------------
@@ -23,7 +23,10 @@
 #import "../../go/GoMove.h"
 #import "../../go/GoNode.h"
 #import "../../go/GoNodeAnnotation.h"
+#import "../../go/GoNodeModel.h"
+#import "../../go/GoNodeTextIndex.h"
 #import "../../shared/ApplicationStateManager.h"
+#import "../../shared/ModelMutationTransaction.h"
 #import "../../utility/NSStringAdditions.h"
 
 
@@ -216,9 +219,13 @@ enum AnnotationDataChangeType
 
     if (dataDidChange)
     {
-      [GoGame sharedGame].document.dirty = true;
+      GoGame* game = [GoGame sharedGame];
+      game.document.dirty = true;
+      [game.nodeModel updateJumpTargetsOfNode:self.node];
+      if (self.annotationDataChangeType == AnnotationDataChangeTypeDescriptions)
+        [game.nodeTextIndex updateNode:self.node];
       [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
-      [[NSNotificationCenter defaultCenter] postNotificationName:nodeAnnotationDataDidChange object:self.node];
+      [[ModelMutationTransaction sharedTransaction] postNotificationName:nodeAnnotationDataDidChange object:self.node];
     }
   }
   @finally
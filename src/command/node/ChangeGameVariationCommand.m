@@ -21,6 +21,7 @@
 #import "../../go/GoGame.h"
 #import "../../go/GoNodeModel.h"
 #import "../../shared/ApplicationStateManager.h"
+#import "../../shared/ModelMutationTransaction.h"
 
 
 // -----------------------------------------------------------------------------
@@ -84,7 +85,7 @@
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
-  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
   GoGame* game = [GoGame sharedGame];
   GoNodeModel* nodeModel = game.nodeModel;
   GoBoardPosition* boardPosition = game.boardPosition;
@@ -107,7 +108,7 @@
 
   @try
   {
-    [center postNotificationName:currentGameVariationWillChange object:nil];
+    [transaction postNotificationName:currentGameVariationWillChange object:nil];
 
     if (game.state == GoGameStateGameHasEnded)
       [game revertStateFromEndedToInProgress];
@@ -134,12 +135,12 @@
     if (oldNumberOfBoardPositions != newNumberOfBoardPositions)
     {
       boardPosition.numberOfBoardPositions = newNumberOfBoardPositions;
-      [center postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
+      [transaction postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
     }
 
     [game endGameDueToPassMovesIfGameRulesRequireIt];
 
-    [center postNotificationName:currentGameVariationDidChange object:nil];
+    [transaction postNotificationName:currentGameVariationDidChange object:nil];
   }
   @finally
   {
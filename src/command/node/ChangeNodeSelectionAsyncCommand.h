@@ -28,7 +28,9 @@
 /// directing the change of the selected node to a given GoNode.
 ///
 /// ChangeNodeSelectionAsyncCommand is executed asynchronously (unless the
-/// executor is another asynchronous command).
+/// executor is another asynchronous command). A ChangeNodeSelectionAsyncCommand
+/// that is still waiting to be executed is cancelled when a newer
+/// ChangeNodeSelectionAsyncCommand is submitted.
 ///
 /// The process consists of the following steps:
 /// - Find out if the current game variation in GoNodeModel contains the GoNode
@@ -137,6 +137,16 @@
   return true;
 }
 
+#pragma mark - AsynchronousCommand methods
+
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand method.
+// -----------------------------------------------------------------------------
+- (bool) supersedesCommand:(id<AsynchronousCommand>)command
+{
+  return [(NSObject*)command isKindOfClass:[ChangeNodeSelectionAsyncCommand class]];
+}
+
 #pragma mark - Private helpers
 
 // -----------------------------------------------------------------------------
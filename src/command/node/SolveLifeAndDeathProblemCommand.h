@@ -0,0 +1,55 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "../CommandBase.h"
+
+// Forward declarations
+@class GoPoint;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SolveLifeAndDeathProblemCommand class is responsible for solving
+/// the life-and-death problem in the current board position and for adding
+/// the solution to the game tree as a new game variation.
+///
+/// SolveLifeAndDeathProblemCommand creates a GoLifeAndDeathProblem for the
+/// current board position, with the side whose turn it is playing the first
+/// move. The target stone group is either specified by the client, or it is
+/// selected automatically (see GoLifeAndDeathProblem::problemWithBoard:()).
+///
+/// The problem is solved on a secondary thread, i.e. control returns to the
+/// submitter of SolveLifeAndDeathProblemCommand before the problem is solved.
+/// When the solution arrives on the main thread SolveLifeAndDeathProblemCommand
+/// plays the main line as a new game variation below the node that was
+/// current when the command was executed, and adds an annotation with the
+/// solve status to the first node of the new game variation. The GTP engine is
+/// then synchronized with the new board position.
+///
+/// If the user has navigated away from the board position, or has changed the
+/// game in the meantime, the solution is discarded. If the solution contains
+/// no moves, e.g. because the solver gave up, SolveLifeAndDeathProblemCommand
+/// displays the solve status in an alert instead.
+// -----------------------------------------------------------------------------
+@interface SolveLifeAndDeathProblemCommand : CommandBase
+{
+}
+
+- (id) init;
+- (id) initWithTargetPoint:(GoPoint*)targetPoint;
+
+@end
@@ -0,0 +1,266 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "SolveLifeAndDeathProblemCommand.h"
+#import "../backup/BackupGameToSgfCommand.h"
+#import "../boardposition/SyncGTPEngineCommand.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoBoardPosition.h"
+#import "../../go/GoGame.h"
+#import "../../go/GoLifeAndDeathProblem.h"
+#import "../../go/GoMoveNodeCreationOptions.h"
+#import "../../go/GoNode.h"
+#import "../../go/GoNodeAnnotation.h"
+#import "../../go/GoNodeModel.h"
+#import "../../go/GoPoint.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../shared/ModelMutationTransaction.h"
+#import "../../ui/UIViewControllerAdditions.h"
+#import "../../utility/NSStringAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// SolveLifeAndDeathProblemCommand.
+// -----------------------------------------------------------------------------
+@interface SolveLifeAndDeathProblemCommand()
+@property(nonatomic, retain) GoPoint* targetPoint;
+@property(nonatomic, retain) GoLifeAndDeathProblem* problem;
+@property(nonatomic, retain) GoNode* node;
+@end
+
+
+@implementation SolveLifeAndDeathProblemCommand
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SolveLifeAndDeathProblemCommand object that selects
+/// the target stone group automatically.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  return [self initWithTargetPoint:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SolveLifeAndDeathProblemCommand object whose target
+/// stone group is the stone group that the stone on @a targetPoint belongs to.
+/// If @a targetPoint is nil the target stone group is selected automatically.
+///
+/// @note This is the designated initializer of
+/// SolveLifeAndDeathProblemCommand.
+// -----------------------------------------------------------------------------
+- (id) initWithTargetPoint:(GoPoint*)targetPoint
+{
+  // Call designated initializer of superclass (CommandBase)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.targetPoint = targetPoint;
+  self.problem = nil;
+  self.node = nil;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this SolveLifeAndDeathProblemCommand
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.targetPoint = nil;
+  self.problem = nil;
+  self.node = nil;
+  [super dealloc];
+}
+
+#pragma mark - CommandBase methods
+
+// -----------------------------------------------------------------------------
+/// @brief Executes this command. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (bool) doIt
+{
+  GoGame* game = [GoGame sharedGame];
+  if (GoGameStateGameHasEnded == game.state || game.isComputerThinking || ! game.alternatingPlay)
+  {
+    DDLogError(@"%@: Unable to solve life-and-death problem in current game state", [self shortDescription]);
+    return false;
+  }
+
+  if (self.targetPoint)
+  {
+    self.problem = [[[GoLifeAndDeathProblem alloc] initWithBoard:game.board
+                                                     targetPoint:self.targetPoint
+                                                     colorToMove:game.nextMoveColor] autorelease];
+  }
+  else
+  {
+    self.problem = [GoLifeAndDeathProblem problemWithBoard:game.board colorToMove:game.nextMoveColor];
+  }
+
+  if (! self.problem)
+  {
+    [self showAlertWithMessage:@"There are no stones on the board, so there is no life-and-death problem to solve."];
+    return false;
+  }
+  if (self.problem.regionSize > lifeAndDeathSolverMaximumRegionSize)
+  {
+    NSString* message = [NSString stringWithFormat:@"The stone group at %@ has too much room to make eyes. Only problems with up to %d empty intersections can be solved.",
+                         self.problem.targetVertex,
+                         lifeAndDeathSolverMaximumRegionSize];
+    [self showAlertWithMessage:message];
+    return false;
+  }
+
+  // The node is retained so that we can recognize later on whether the user
+  // has navigated away from the board position
+  self.node = game.boardPosition.currentNode;
+
+  [self retain];  // must survive until the problem is solved
+  dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+    [self.problem solve];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [self problemDidSolve];
+      [self autorelease];  // balance retain that is sent before the problem is solved
+    });
+  });
+
+  return true;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked on the main thread when the problem has been solved.
+/// Adds the main line to the game tree, or displays the solve status if there
+/// is no main line.
+// -----------------------------------------------------------------------------
+- (void) problemDidSolve
+{
+  NSString* statusDescription = [self statusDescription];
+  DDLogInfo(@"%@: %@ Nodes visited: %d", [self shortDescription], statusDescription, self.problem.numberOfNodes);
+
+  GoGame* game = [GoGame sharedGame];
+  if (game.boardPosition.currentNode != self.node || GoGameStateGameHasEnded == game.state)
+  {
+    DDLogInfo(@"%@: Board position has changed, discarding solution", [self shortDescription]);
+    return;
+  }
+
+  if (self.problem.mainLine.count == 0)
+  {
+    [self showAlertWithMessage:statusDescription];
+    return;
+  }
+
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
+  @try
+  {
+    [transaction begin];
+
+    // Only the first move creates a new game variation. Because the new game
+    // variation becomes the current game variation, the remaining moves are
+    // appended to it.
+    GoMoveNodeCreationOptions* options = [GoMoveNodeCreationOptions moveNodeCreationOptionsWithInsertPolicyRetainFutureBoardPositionsAndInsertPosition:GoNewMoveInsertPositionNewVariationAtBottom];
+    bool isFirstMove = true;
+    for (id move in self.problem.mainLine)
+    {
+      if (move == [NSNull null])
+        [game passWithMoveNodeCreationOptions:options];
+      else
+        [game play:[game.board pointAtVertex:move] withMoveNodeCreationOptions:options];
+
+      if (isFirstMove)
+      {
+        isFirstMove = false;
+        GoNode* firstNode = game.boardPosition.currentNode;
+        GoNodeAnnotation* nodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+        nodeAnnotation.shortDescription = [self statusShortDescription];
+        nodeAnnotation.longDescription = statusDescription;
+        firstNode.goNodeAnnotation = nodeAnnotation;
+        [game.nodeModel updateJumpTargetsOfNode:firstNode];
+        [transaction postNotificationName:nodeAnnotationDataDidChange object:firstNode];
+      }
+    }
+  }
+  @catch (NSException* exception)
+  {
+    DDLogError(@"%@: Exception name: %@. Exception reason: %@.", [self shortDescription], [exception name], [exception reason]);
+  }
+  @finally
+  {
+    [transaction applicationStateDidChange];
+    [transaction commit];
+  }
+
+  [[[[SyncGTPEngineCommand alloc] init] autorelease] submit];
+  [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a short description of the solve status, suitable for the
+/// name of a node.
+// -----------------------------------------------------------------------------
+- (NSString*) statusShortDescription
+{
+  NSString* targetColorName = [NSString stringWithGoColor:self.problem.targetColor];
+  switch (self.problem.status)
+  {
+    case GoLifeAndDeathStatusDead:
+      return [NSString stringWithFormat:@"%@ dies", targetColorName];
+    case GoLifeAndDeathStatusAlive:
+      return [NSString stringWithFormat:@"%@ lives", targetColorName];
+    default:
+      return @"Unsolved";
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a description of the solve status, suitable for a node
+/// comment or an alert message.
+// -----------------------------------------------------------------------------
+- (NSString*) statusDescription
+{
+  NSString* colorToMoveName = [NSString stringWithGoColor:self.problem.colorToMove];
+  NSString* targetColorName = [[NSString stringWithGoColor:self.problem.targetColor] lowercaseString];
+  NSString* targetVertex = self.problem.targetVertex;
+  switch (self.problem.status)
+  {
+    case GoLifeAndDeathStatusDead:
+      return [NSString stringWithFormat:@"%@ to play: The %@ stone group at %@ dies.", colorToMoveName, targetColorName, targetVertex];
+    case GoLifeAndDeathStatusAlive:
+      return [NSString stringWithFormat:@"%@ to play: The %@ stone group at %@ lives.", colorToMoveName, targetColorName, targetVertex];
+    default:
+      return [NSString stringWithFormat:@"%@ to play: The solver gave up before it could find out whether the %@ stone group at %@ lives or dies.", colorToMoveName, targetColorName, targetVertex];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Displays an alert with message @a message.
+// -----------------------------------------------------------------------------
+- (void) showAlertWithMessage:(NSString*)message
+{
+  [[ApplicationDelegate sharedDelegate].window.rootViewController presentOkAlertWithTitle:@"Life & death"
+                                                                                  message:message];
+}
+
+@end
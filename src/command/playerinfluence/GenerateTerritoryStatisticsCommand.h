@@ -32,6 +32,13 @@
 /// be able to make the suggestion, the GTP engine is forced to calculate
 /// playouts, and that, as a side effect, generates the desired territory
 /// statistics.
+///
+/// GenerateTerritoryStatisticsCommand limits the search to a fixed batch of
+/// #territoryStatisticsMaxGames playouts, regardless of the playing strength
+/// of the active GTP engine profile. The statistics are therefore generated in
+/// a predictable amount of time. When "reg_genmove" has finished,
+/// GenerateTerritoryStatisticsCommand restores the number of playouts
+/// configured in the active GTP engine profile.
 // -----------------------------------------------------------------------------
 @interface GenerateTerritoryStatisticsCommand : CommandBase
 {
@@ -20,6 +20,9 @@
 #import "UpdateTerritoryStatisticsCommand.h"
 #import "../../go/GoGame.h"
 #import "../../go/GoPlayer.h"
+#import "../../main/ApplicationDelegate.h"
+#import "../../player/GtpEngineProfile.h"
+#import "../../player/GtpEngineProfileModel.h"
 #import "../../gtp/GtpCommand.h"
 #import "../../gtp/GtpResponse.h"
 
@@ -34,11 +37,17 @@
   GoGame* game = [GoGame sharedGame];
   if (! game)
     return false;
+  bool success = [self submitMaxGamesCommand:territoryStatisticsMaxGames];
+  if (! success)
+    return false;
   NSString* commandString = @"reg_genmove ";
   commandString = [commandString stringByAppendingString:game.nextMovePlayer.colorString];
   GtpCommand* command = [GtpCommand asynchronousCommand:commandString
                                          responseTarget:self
                                                selector:@selector(gtpResponseReceived:)];
+  // Territory statistics are a background analysis, the user is not waiting
+  // for them
+  command.qualityOfService = NSQualityOfServiceUtility;
   [command submit];
   game.reasonForComputerIsThinking = GoGameComputerIsThinkingReasonPlayerInfluence;
   return true;
@@ -50,6 +59,9 @@
 // -----------------------------------------------------------------------------
 - (void) gtpResponseReceived:(GtpResponse*)response
 {
+  GtpEngineProfile* activeProfile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  if (activeProfile)
+    [self submitMaxGamesCommand:activeProfile.fuegoMaxGames];
   if (! response.status)
   {
     DDLogError(@"%@: Aborting due to failed GTP command", [self shortDescription]);
@@ -60,4 +72,19 @@
   [GoGame sharedGame].reasonForComputerIsThinking = GoGameComputerIsThinkingReasonIsNotThinking;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt() and gtpResponseReceived:(). Limits the
+/// number of playouts that the GTP engine runs during a search to
+/// @a maxGames.
+// -----------------------------------------------------------------------------
+- (bool) submitMaxGamesCommand:(unsigned long long)maxGames
+{
+  NSString* commandString = [NSString stringWithFormat:@"uct_param_player max_games %llu", maxGames];
+  GtpCommand* command = [GtpCommand command:commandString];
+  [command submit];
+  if (! command.response.status)
+    DDLogError(@"%@: Failed to set the number of playouts to %llu", [self shortDescription], maxGames);
+  return command.response.status;
+}
+
 @end
@@ -41,7 +41,9 @@
 /// ToggleTerritoryStatisticsCommand will block until the GTP engine has
 /// finished processing the other command. ToggleTerritoryStatisticsCommand is
 /// asynchronous so that the command processor displays the progress HUD while
-/// the operation blocks.
+/// the operation blocks. ToggleTerritoryStatisticsCommand is executed with
+/// #AsynchronousCommandPriorityLow, i.e. board position changes and other user
+/// actions that are submitted after it may be executed before it.
 // -----------------------------------------------------------------------------
 @interface ToggleTerritoryStatisticsCommand : CommandBase <AsynchronousCommand>
 {
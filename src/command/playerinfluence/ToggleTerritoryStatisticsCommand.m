@@ -21,7 +21,6 @@
 #import "../../play/model/BoardViewModel.h"
 #import "../../go/GoBoard.h"
 #import "../../go/GoGame.h"
-#import "../../go/GoPoint.h"
 #import "../../gtp/GtpCommand.h"
 #import "../../gtp/GtpResponse.h"
 
@@ -50,6 +49,14 @@
   return self;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief AsynchronousCommand property.
+// -----------------------------------------------------------------------------
+- (enum AsynchronousCommandPriority) priority
+{
+  return AsynchronousCommandPriorityLow;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Executes this command. See the class documentation for details.
 // -----------------------------------------------------------------------------
@@ -83,16 +90,11 @@
 // -----------------------------------------------------------------------------
 - (void) updateBoardWithZeroStatistics
 {
-  GoBoard* board = [GoGame sharedGame].board;
-  GoPoint* point = [board pointAtVertex:@"A1"];
-  while (point)
-  {
-    // Zero = no influence = nothing will be drawn on that intersection. Without
-    // this initialization, the Go board would draw player influence with data
-    // from the last time that the display of player influence was enabled.
-    point.territoryStatisticsScore = 0.0f;
-    point = point.next;
-  }
+  // Zero = no influence = nothing will be drawn on that intersection. Without
+  // this initialization, the Go board would draw player influence with data
+  // from the last time that the display of player influence was enabled. This
+  // also discards the accumulated scores, they are outdated as well.
+  [[GoGame sharedGame].board resetTerritoryStatisticsScores];
 }
 
 // -----------------------------------------------------------------------------
@@ -24,6 +24,11 @@
 /// updating the territory statistics property in all GoPoint objects with
 /// values obtained from the GTP engine. Command execution occurs synchronously.
 ///
+/// The values obtained from the GTP engine are not taken over directly, they
+/// are blended into the values of the previous board position (see
+/// GoOwnershipAccumulator). Only intersections near the last move are
+/// re-weighted, so the display of player influence remains stable.
+///
 /// UpdateTerritoryStatisticsCommand posts the notification
 /// #territoryStatisticsChanged after all GoPoint objects have been updated.
 ///
@@ -19,7 +19,10 @@
 #import "UpdateTerritoryStatisticsCommand.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../go/GoBoard.h"
+#import "../../go/GoBoardPosition.h"
 #import "../../go/GoGame.h"
+#import "../../go/GoMove.h"
+#import "../../go/GoNode.h"
 #import "../../go/GoPoint.h"
 #import "../../go/GoVertex.h"
 #import "../../gtp/GtpCommand.h"
@@ -44,7 +47,7 @@
   [command submit];
   if (! command.response.status)
     return false;
-  bool success = [self updateBoardWithGtpResponse:command.response.parsedResponse];
+  bool success = [self updateBoardWithGtpResponse:command.response];
   if (! success)
     return false;
   [[NSNotificationCenter defaultCenter] postNotificationName:territoryStatisticsChanged object:nil];
@@ -54,53 +57,51 @@
 // -----------------------------------------------------------------------------
 /// @brief Private helper
 // -----------------------------------------------------------------------------
-- (bool) updateBoardWithGtpResponse:(NSString*)gtpResponse
+- (bool) updateBoardWithGtpResponse:(GtpResponse*)gtpResponse
 {
-  GoBoard* board = [GoGame sharedGame].board;
+  GoGame* game = [GoGame sharedGame];
+  GoBoard* board = game.board;
+  int boardSize = board.size;
+
+  // The response has one line per board row, starting at the top of the
+  // board, and one number per intersection in each line, starting at the left
+  // edge of the board
+  float territoryStatisticsScores[GoBoardSizeMax * GoBoardSizeMax];
+  bool success = [gtpResponse parseNumberMatrixWithNumberOfRows:boardSize
+                                                numberOfColumns:boardSize
+                                                         values:territoryStatisticsScores];
+  if (! success)
+  {
+    assert(false);
+    DDLogError(@"%@: GTP response does not have the expected format", [self shortDescription]);
+    return false;
+  }
+
+  // Convert from the response's order to the order of intersection indexes
+  float scores[GoBoardSizeMax * GoBoardSizeMax];
   struct GoVertexNumeric vertexNumeric;
-  vertexNumeric.x = 1;
-  vertexNumeric.y = board.size;  // start at the top of the board
-  NSArray* responseLines = [gtpResponse componentsSeparatedByString:@"\n"];
-  for (NSString* responseLine in responseLines)
+  int indexOfScore = 0;
+  for (vertexNumeric.y = boardSize; vertexNumeric.y > 0; vertexNumeric.y--)  // start at the top of the board
   {
-    if (0 == vertexNumeric.y)
-    {
-      assert(false);
-      DDLogError(@"%@: GTP response has too many lines", [self shortDescription]);
-      return false;
-    }
-    NSMutableArray* territoryStatisticScores = [NSMutableArray arrayWithArray:[responseLine componentsSeparatedByString:@" "]];
-    [territoryStatisticScores removeObject:@""];
-    if (territoryStatisticScores.count != board.size)
-      continue;  // skip the first line which is empty
-    // Start at the left edge of the board
-    NSString* vertexLeftEdge = [GoVertex vertexFromNumeric:vertexNumeric].string;
-    GoPoint* point = [board pointAtVertex:vertexLeftEdge];
-    for (NSString* territoryStatisticScore in territoryStatisticScores)
+    for (vertexNumeric.x = 1; vertexNumeric.x <= boardSize; vertexNumeric.x++)  // start at the left edge of the board
     {
-      if (! point)
-      {
-        assert(false);
-        DDLogError(@"%@: Line in GTP response has too many elements", [self shortDescription]);
-        return false;
-      }
-      point.territoryStatisticsScore = [territoryStatisticScore floatValue];
-      point = point.right;  // continue on the same line to the right
+      GoPoint* point = [board pointAtNumericVertex:vertexNumeric];
+      scores[[board indexOfPoint:point]] = territoryStatisticsScores[indexOfScore++];
     }
-    if (point)
-    {
-      assert(false);
-      DDLogError(@"%@: Line in GTP response has not enough elements", [self shortDescription]);
-      return false;
-    }
-    vertexNumeric.y--;  // move down one line
-  }
-  if (0 != vertexNumeric.y)
-  {
-    assert(false);
-    DDLogError(@"%@: GTP response has not enough lines", [self shortDescription]);
-    return false;
   }
+
+  // The statistics describe the current board position. The previous
+  // statistics are used as a prior if they describe the same or the preceding
+  // board position.
+  GoNode* currentNode = game.boardPosition.currentNode;
+  GoMove* lastMove = currentNode.goMove;
+  GoPoint* lastMovePoint = (lastMove && lastMove.type == GoMoveTypePlay) ? lastMove.point : nil;
+  long long previousZobristHash = currentNode.parent ? currentNode.parent.zobristHash : 0;
+  [board accumulateTerritoryStatisticsScores:scores
+                               lastMovePoint:lastMovePoint
+                                 zobristHash:currentNode.zobristHash
+                         previousZobristHash:previousZobristHash];
+
   return true;
 }
 
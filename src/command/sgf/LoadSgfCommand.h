@@ -41,6 +41,17 @@
 /// evaluating the messages in the SGFCDocumentReadResult and taking the
 /// appropriate action.
 ///
+/// If the SGF file is compressed (see SgfFileCompression), LoadSgfCommand
+/// decompresses it into a temporary file before it is read. Command execution
+/// fails if decompression fails.
+///
+/// LoadSgfCommand has a fast path for .sgf files that the app wrote itself.
+/// SaveSgfCommand stores a content hash in such files. If the content hash
+/// matches the file content, LoadSgfCommand performs only a single read
+/// attempt, and it disables warning messages as well as the checks and
+/// encoding options that are configured in the SGF user preferences. See
+/// property @e sgfFileIsTrusted.
+///
 /// LoadSgfCommand executes synchronously.
 // -----------------------------------------------------------------------------
 @interface LoadSgfCommand : CommandBase
@@ -57,6 +68,10 @@
 ///
 /// When true the command uses #SgfEncodingModeSingleEncoding for reading.
 @property(nonatomic, assign) bool ignoreSgfSettings;
+/// @brief True if the .sgf file was written by the app and was loaded with the
+/// trusted fast path, false if not. Is false until the command has been
+/// executed.
+@property(nonatomic, assign, readonly) bool sgfFileIsTrusted;
 /// @brief SgfcKit object that encapsulates the result of the read operation
 /// that was performed with #SgfEncodingModeSingleEncoding.
 ///
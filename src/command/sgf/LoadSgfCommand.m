@@ -18,7 +18,9 @@
 // Project includes
 #import "LoadSgfCommand.h"
 #import "../../main/ApplicationDelegate.h"
+#import "../../sgf/SgfFileCompression.h"
 #import "../../sgf/SgfSettingsModel.h"
+#import "../../sgf/SgfUtilities.h"
 
 
 // -----------------------------------------------------------------------------
@@ -26,6 +28,10 @@
 // -----------------------------------------------------------------------------
 @interface LoadSgfCommand()
 @property(nonatomic, retain) NSString* sgfFilePath;
+/// @brief The file that is actually read. Is different from @e sgfFilePath
+/// if the .sgf file is compressed.
+@property(nonatomic, retain) NSString* sgfFilePathToRead;
+@property(nonatomic, assign, readwrite) bool sgfFileIsTrusted;
 @end
 
 
@@ -45,7 +51,9 @@
     return nil;
 
   self.sgfFilePath = sgfFilePath;
+  self.sgfFilePathToRead = nil;
   self.ignoreSgfSettings = false;
+  self.sgfFileIsTrusted = false;
   self.sgfDocumentReadResultSingleEncoding = nil;
   self.sgfDocumentReadResultMultipleEncodings = nil;
 
@@ -58,6 +66,7 @@
 - (void) dealloc
 {
   self.sgfFilePath = nil;
+  self.sgfFilePathToRead = nil;
   self.sgfDocumentReadResultSingleEncoding = nil;
   self.sgfDocumentReadResultMultipleEncodings = nil;
   [super dealloc];
@@ -75,10 +84,57 @@
   }
   DDLogVerbose(@"%@: Loading SGF file %@", [self shortDescription], self.sgfFilePath);
 
+  // Decompress only once, even if two read attempts are made
+  bool sgfFileIsCompressed = [SgfFileCompression isCompressedSgfFile:self.sgfFilePath];
+  if (sgfFileIsCompressed)
+  {
+    self.sgfFilePathToRead = [SgfFileCompression uncompressedSgfFileForSgfFile:self.sgfFilePath];
+    if (! self.sgfFilePathToRead)
+    {
+      DDLogError(@"%@: Failed to decompress SGF file %@", [self shortDescription], self.sgfFilePath);
+      return false;
+    }
+  }
+  else
+  {
+    self.sgfFilePathToRead = self.sgfFilePath;
+  }
+
+  @try
+  {
+    [self readSgfFile];
+  }
+  @finally
+  {
+    if (sgfFileIsCompressed)
+      [SgfFileCompression removeUncompressedSgfFile:self.sgfFilePathToRead];
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt().
+// -----------------------------------------------------------------------------
+- (void) readSgfFile
+{
   SgfSettingsModel* sgfSettingsModel = [ApplicationDelegate sharedDelegate].sgfSettingsModel;
   SGFCDocumentReader* documentReader = [SGFCDocumentReader documentReader];
 
-  if (self.ignoreSgfSettings)
+  self.sgfFileIsTrusted = [SgfUtilities hasSgfFileValidContentHash:self.sgfFilePath];
+  if (self.sgfFileIsTrusted)
+  {
+    DDLogVerbose(@"%@: SGF file was written by the app, using trusted fast path", [self shortDescription]);
+    [self setupTrustedReaderArguments:documentReader withValuesFromModel:sgfSettingsModel];
+    // The result must be stored in the property that clients expect when they
+    // evaluate the encoding mode user preference
+    enum SgfEncodingMode encodingMode = SgfEncodingModeSingleEncoding;
+    if (! self.ignoreSgfSettings && sgfSettingsModel.encodingMode == SgfEncodingModeMultipleEncodings)
+      encodingMode = SgfEncodingModeMultipleEncodings;
+    [self performReadOperatonWithReader:documentReader
+                       withEncodingMode:encodingMode];
+  }
+  else if (self.ignoreSgfSettings)
   {
     [self performReadOperatonWithReader:documentReader
                        withEncodingMode:SgfEncodingModeSingleEncoding];
@@ -106,7 +162,6 @@
     }
   }
 
-  return true;
 }
 
 #pragma mark - Private helpers
@@ -120,7 +175,7 @@
   else
     [arguments addArgumentWithType:SGFCArgumentTypeEncodingMode withIntParameter:2];
 
-  SGFCDocumentReadResult* readResult = [documentReader readSgfContentFromFile:self.sgfFilePath];
+  SGFCDocumentReadResult* readResult = [documentReader readSgfContentFromFile:self.sgfFilePathToRead];
 
   if (encodingMode == SgfEncodingModeSingleEncoding)
     self.sgfDocumentReadResultSingleEncoding = readResult;
@@ -164,4 +219,31 @@
   [arguments addArgumentWithType:SGFCArgumentTypeDeleteEmptyNodes];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Sets up the arguments of @a documentReader for reading an .sgf file
+/// that the app wrote itself. SGF user preferences that affect only the
+/// checks performed by SgfcKit, or the encoding, are ignored because the file
+/// is known to contain valid UTF-8 encoded SGF data. Warning messages are
+/// disabled so that clients do not have to go through messages that can only
+/// be about how SaveSgfCommand formats the data.
+// -----------------------------------------------------------------------------
+- (void) setupTrustedReaderArguments:(SGFCDocumentReader*)documentReader
+                 withValuesFromModel:(SgfSettingsModel*)sgfSettingsModel
+{
+  SGFCArguments* arguments = documentReader.arguments;
+
+  [arguments clearArguments];
+
+  [arguments addArgumentWithType:SGFCArgumentTypeDisableWarningMessages];
+
+  // This affects the structure of the game tree, not the checks, so it must
+  // be honored
+  if (! self.ignoreSgfSettings && sgfSettingsModel.reverseVariationOrdering)
+    [arguments addArgumentWithType:SGFCArgumentTypeReverseVariationOrdering];
+
+  // SaveSgfCommand writes empty nodes. Same as in
+  // setupReaderArguments:withValuesFromModel:() they must be deleted.
+  [arguments addArgumentWithType:SGFCArgumentTypeDeleteEmptyNodes];
+}
+
 @end
@@ -37,10 +37,28 @@
 /// - It first validates the generated SGF content using SgfcKit's validation
 ///   mechanism. This is essentially a dry run of a full write cycle, the only
 ///   exception being that the SGF content is not written to disk but to memory.
+///   Clients for which the cost of the dry run outweighs its benefit can
+///   disable the validation step, see property @e validateSgfContent.
 /// - If validation is successful the SGF content is then written to a temporary
 ///   file. Only if that filesystem interaction succeeds is the existing .sgf
 ///   file overwritten with the temporary file.
 ///
+/// After the .sgf file has been written, SaveSgfCommand stores a hash of the
+/// file content in an extended attribute of the file. LoadSgfCommand uses the
+/// hash to recognize files that the app wrote itself and that were not
+/// modified since.
+///
+/// Serializing a game is expensive, and the same game is often written to
+/// several destinations without being changed in between, e.g. when the user
+/// saves the game to the archive and the application then goes to the
+/// background and writes the backup .sgf file. SaveSgfCommand therefore
+/// remembers in GoGameDocument which file it wrote last, and for which
+/// generation of the document. If the document generation has not changed
+/// since then, and the file's content hash shows that the file has not been
+/// modified, SaveSgfCommand copies that file instead of serializing the game
+/// again. Validation is skipped in that case because the file was already
+/// validated when it was written.
+///
 /// SaveSgfCommand executes synchronously.
 ///
 /// The resulting SGF file is structured as follows:
@@ -81,6 +99,24 @@
 /// false if no .sgf file exists.
 @property(nonatomic, assign) bool sgfFileAlreadyExists;
 
+/// @brief True if the generated SGF content should be validated before it is
+/// written to the temporary file, false if validation should be skipped. This
+/// is true by default.
+///
+/// Skipping validation considerably reduces the time it takes to save a game,
+/// because SgfcKit's validation is a full write cycle of its own. The SGF
+/// content still undergoes the same checks when it is written to the temporary
+/// file, so an already existing .sgf file is never overwritten with bad
+/// content. The only difference is that problems are detected after, instead
+/// of before, the temporary file was written.
+@property(nonatomic, assign) bool validateSgfContent;
+
+/// @brief True if the .sgf file should be stored gzip compressed, false if it
+/// should be stored uncompressed. This is false by default.
+///
+/// See SgfFileCompression for details.
+@property(nonatomic, assign) bool compressSgfContent;
+
 /// @brief True if the command has touched the folder to which the destination
 /// .sgf file should be written. False if the command has not touched the
 /// folder.
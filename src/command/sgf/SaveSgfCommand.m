@@ -19,6 +19,7 @@
 #import "SaveSgfCommand.h"
 #import "../../go/GoBoard.h"
 #import "../../go/GoGame.h"
+#import "../../go/GoGameDocument.h"
 #import "../../go/GoMove.h"
 #import "../../go/GoNode.h"
 #import "../../go/GoNodeAnnotation.h"
@@ -30,6 +31,7 @@
 #import "../../go/GoUtilities.h"
 #import "../../go/GoVertex.h"
 #import "../../player/Player.h"
+#import "../../sgf/SgfFileCompression.h"
 #import "../../sgf/SgfUtilities.h"
 #import "../../utility/PathUtilities.h"
 
@@ -52,6 +54,8 @@
 
   self.sgfFilePath = sgfFilePath;
   self.sgfFileAlreadyExists = sgfFileAlreadyExists;
+  self.validateSgfContent = true;
+  self.compressSgfContent = false;
   self.destinationFolderWasTouched = false;
   self.errorMessage = nil;
 
@@ -75,33 +79,122 @@
 // -----------------------------------------------------------------------------
 - (bool) doIt
 {
-  SGFCDocument* sgfDocument;
+  GoGameDocument* goGameDocument = [GoGame sharedGame].document;
+  // Capture the generation before serialization starts so that a change that
+  // occurs while the file is being written is not attributed to the file
+  unsigned long long generation = goGameDocument.generation;
+
   NSString* errorMessage = @"Internal error";
+  bool success;
+  NSString* reusableSgfFilePath = [self reusableSgfFilePathForGoGameDocument:goGameDocument];
+  if (reusableSgfFilePath)
+  {
+    success = [self copySgfFile:reusableSgfFilePath
+                   errorMessage:&errorMessage];
+  }
+  else
+  {
+    success = [self serializeAndSaveWithErrorMessage:&errorMessage];
+  }
+
+  if (success)
+  {
+    goGameDocument.lastWrittenSgfFilePath = self.sgfFilePath;
+    goGameDocument.lastWrittenSgfFileGeneration = generation;
+  }
+  else
+  {
+    self.errorMessage = errorMessage;
+  }
+
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt()
+// -----------------------------------------------------------------------------
+- (bool) serializeAndSaveWithErrorMessage:(NSString**)errorMessage
+{
+  SGFCDocument* sgfDocument;
   bool success = [self createSgfDocument:&sgfDocument
-                            errorMessage:&errorMessage];
+                            errorMessage:errorMessage];
 
   if (success)
   {
-    success = [self validateSgfDocument:sgfDocument
-                         errorMessage:&errorMessage];
+    if (self.validateSgfContent)
+    {
+      success = [self validateSgfDocument:sgfDocument
+                             errorMessage:errorMessage];
+    }
 
     if (success)
     {
       success = [self saveSgfDocument:sgfDocument
-                         errorMessage:&errorMessage];
+                         errorMessage:errorMessage];
     }
   }
 
+  return success;
+}
+
+#pragma mark - Reuse previously written SGF file
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Returns the full path of an .sgf file
+/// that was previously written with the current content of @a goGameDocument
+/// and that can be copied instead of serializing the game again. Returns nil
+/// if no such file exists.
+///
+/// The file is reusable only if @a goGameDocument has not changed since the
+/// file was written, and if the file still exists and has not been modified
+/// since it was written.
+// -----------------------------------------------------------------------------
+- (NSString*) reusableSgfFilePathForGoGameDocument:(GoGameDocument*)goGameDocument
+{
+  NSString* lastWrittenSgfFilePath = goGameDocument.lastWrittenSgfFilePath;
+  if (! lastWrittenSgfFilePath)
+    return nil;
+  if (goGameDocument.lastWrittenSgfFileGeneration != goGameDocument.generation)
+    return nil;
+  if (! [SgfUtilities hasSgfFileValidContentHash:lastWrittenSgfFilePath])
+    return nil;
+
+  DDLogVerbose(@"%@: Game has not changed since %@ was written, reusing the file", [self shortDescription], lastWrittenSgfFilePath);
+  return lastWrittenSgfFilePath;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doIt(). Copies the .sgf file @a sgfFilePath to
+/// the destination. The same precautions are taken as when a newly serialized
+/// game is saved, i.e. the file is first copied to a temporary file which is
+/// then moved to the destination.
+// -----------------------------------------------------------------------------
+- (bool) copySgfFile:(NSString*)sgfFilePath
+        errorMessage:(NSString**)errorMessage
+{
+  NSString* temporaryDirectory = NSTemporaryDirectory();
+  NSString* temporaryFilePath = [temporaryDirectory stringByAppendingPathComponent:sgfTemporaryFileName];
+  [PathUtilities deleteItemIfExists:temporaryFilePath];
+
+  // Compresses or decompresses the data if the source file was written with
+  // a different setting
+  bool success = [SgfFileCompression copySgfFile:sgfFilePath
+                                          toPath:temporaryFilePath
+                                      compressed:self.compressSgfContent];
   if (! success)
-    self.errorMessage = errorMessage;
+  {
+    *errorMessage = @"An unexpected error occurred while writing the game data to a temporary file.";
+    return false;
+  }
 
-  return success;
+  return [self moveTemporaryFilePathToDestination:temporaryFilePath
+                                     errorMessage:errorMessage];
 }
 
 #pragma mark - Create SGF document
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt()
+/// @brief Private helper for serializeAndSaveWithErrorMessage:()
 // -----------------------------------------------------------------------------
 - (bool) createSgfDocument:(SGFCDocument**)sgfDocument
               errorMessage:(NSString**)errorMessage
@@ -718,7 +811,7 @@
 #pragma mark - Validate SGF document
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt()
+/// @brief Private helper for serializeAndSaveWithErrorMessage:()
 // -----------------------------------------------------------------------------
 - (bool) validateSgfDocument:(SGFCDocument*)sgfDocument
                 errorMessage:(NSString**)errorMessage
@@ -746,7 +839,7 @@
 #pragma mark - Save SGF document
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for doIt()
+/// @brief Private helper for serializeAndSaveWithErrorMessage:()
 // -----------------------------------------------------------------------------
 - (bool) saveSgfDocument:(SGFCDocument*)sgfDocument
             errorMessage:(NSString**)errorMessage
@@ -760,11 +853,45 @@
   if (! saveSuccess)
     return false;
 
+  if (self.compressSgfContent)
+  {
+    // SgfcKit can only write uncompressed files
+    NSString* compressedFilePath = [temporaryFilePath stringByAppendingPathExtension:@"gz"];
+    bool compressSuccess = [SgfFileCompression copySgfFile:temporaryFilePath
+                                                    toPath:compressedFilePath
+                                                compressed:true];
+    [PathUtilities deleteItemIfExists:temporaryFilePath];
+    if (! compressSuccess)
+    {
+      *errorMessage = @"An unexpected error occurred while compressing the game data.";
+      return false;
+    }
+    temporaryFilePath = compressedFilePath;
+  }
+
+  return [self moveTemporaryFilePathToDestination:temporaryFilePath
+                                     errorMessage:errorMessage];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for saveSgfDocument:errorMessage:() and
+/// copySgfFile:errorMessage:()
+// -----------------------------------------------------------------------------
+- (bool) moveTemporaryFilePathToDestination:(NSString*)temporaryFilePath
+                               errorMessage:(NSString**)errorMessage
+{
   self.destinationFolderWasTouched = true;
 
   bool moveSuccess = [self moveTemporaryFilePathToArchiveFilePath:temporaryFilePath
                                                      errorMessage:errorMessage];
-  return moveSuccess;
+  if (! moveSuccess)
+    return false;
+
+  // Failure is not an error, the file is then merely loaded without the
+  // trusted fast path, and it cannot be reused by a later SaveSgfCommand
+  [SgfUtilities writeContentHashToSgfFile:self.sgfFilePath];
+
+  return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -808,7 +935,7 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for saveSgfDocument:errorMessage:()
+/// @brief Private helper for moveTemporaryFilePathToDestination:errorMessage:()
 // -----------------------------------------------------------------------------
 - (bool) moveTemporaryFilePathToArchiveFilePath:(NSString*)temporaryFilePath
                                    errorMessage:(NSString**)errorMessage
@@ -22,9 +22,12 @@
 #import "GtpLogSettingsController.h"
 #import "GtpCommandViewController.h"
 #import "LoggingModel.h"
+#import "PerformanceHUD.h"
 #import "SendBugReportController.h"
 #import "../go/GoGame.h"
 #import "../go/GoScore.h"
+#import "../gtp/GtpSearchMetrics.h"
+#import "../gtp/GtpUctSearchStatistics.h"
 #import "../main/ApplicationDelegate.h"
 #import "../ui/TableViewCellFactory.h"
 #import "../ui/UiSettingsModel.h"
@@ -36,6 +39,8 @@
 enum DiagnosticsTableViewSection
 {
   GtpSection,
+  SearchPerformanceSection,
+  PerformanceHUDSection,
   CrashReportSection,
   LoggingSection,
   BugReportSection,
@@ -53,6 +58,27 @@ enum GtpSectionItem
   MaxGtpSectionItem
 };
 
+// -----------------------------------------------------------------------------
+/// @brief Enumerates items in the SearchPerformanceSection.
+// -----------------------------------------------------------------------------
+enum SearchPerformanceSectionItem
+{
+  MostRecentSearchItem,
+  AverageAndPeakPlayoutRateItem,
+  NumberOfThreadsItem,
+  MemoryFootprintItem,
+  MaxSearchPerformanceSectionItem
+};
+
+// -----------------------------------------------------------------------------
+/// @brief Enumerates items in the PerformanceHUDSection.
+// -----------------------------------------------------------------------------
+enum PerformanceHUDSectionItem
+{
+  PerformanceHUDVisibleItem,
+  MaxPerformanceHUDSectionItem
+};
+
 // -----------------------------------------------------------------------------
 /// @brief Enumerates items in the CrashReportSection.
 // -----------------------------------------------------------------------------
@@ -152,6 +178,7 @@ enum BugReportSectionItem
   [center addObserver:self selector:@selector(computerPlayerThinkingChanged:) name:computerPlayerThinkingStops object:nil];
   [center addObserver:self selector:@selector(goScoreCalculationStarts:) name:goScoreCalculationStarts object:nil];
   [center addObserver:self selector:@selector(goScoreCalculationEnds:) name:goScoreCalculationEnds object:nil];
+  [center addObserver:self selector:@selector(gtpSearchMetricsDidChange:) name:gtpSearchMetricsDidChange object:nil];
   LoggingModel* loggingModel = [ApplicationDelegate sharedDelegate].loggingModel;
   [loggingModel addObserver:self forKeyPath:@"loggingEnabled" options:0 context:NULL];
 }
@@ -189,6 +216,10 @@ enum BugReportSectionItem
   {
     case GtpSection:
       return MaxGtpSectionItem;
+    case SearchPerformanceSection:
+      return MaxSearchPerformanceSectionItem;
+    case PerformanceHUDSection:
+      return MaxPerformanceHUDSectionItem;
     case CrashReportSection:
       return MaxCrashReportSectionItem;
     case LoggingSection:
@@ -214,6 +245,10 @@ enum BugReportSectionItem
   {
     case GtpSection:
       return @"GTP (Go Text Protocol)";
+    case SearchPerformanceSection:
+      return @"Search performance";
+    case PerformanceHUDSection:
+      return @"Performance overlay";
     case CrashReportSection:
       return @"Crash Report";
     case LoggingSection:
@@ -233,6 +268,10 @@ enum BugReportSectionItem
 {
   if (GtpSection == section)
     return @"Observe the flow of communication between Little Go (GTP client) and Fuego (GTP engine), or inject your own GTP commands (dangerous!).";
+  else if (SearchPerformanceSection == section)
+    return @"How fast Fuego searches on this device. If the playout rate of the most recent search is far below the peak rate, the device may be hot and throttled, or the search may have run out of memory.";
+  else if (PerformanceHUDSection == section)
+    return @"Shows frame times, main thread stalls, the number of pending commands, the GTP response time, memory usage and cache hit rates on top of all other views. The overlay is hidden again when the app is restarted.";
   else if (LoggingSection == section)
     return @"If you plan to send a bug report (see below) you should enable logging BEFORE you reproduce the error. The data collected in the log file will be sent along with the bug report and maximize the chance that the developer can fix the problem.";
   else if (BugReportSection == section)
@@ -276,6 +315,13 @@ enum BugReportSectionItem
       }
       break;
     }
+    case SearchPerformanceSection:
+    {
+      cell = [TableViewCellFactory cellWithType:Value1CellType tableView:tableView];
+      cell.selectionStyle = UITableViewCellSelectionStyleNone;
+      [self configureSearchPerformanceCell:cell forRow:indexPath.row];
+      break;
+    }
     case CrashReportSection:
     {
       switch (indexPath.row)
@@ -296,6 +342,15 @@ enum BugReportSectionItem
       }
       break;
     }
+    case PerformanceHUDSection:
+    {
+      cell = [TableViewCellFactory cellWithType:SwitchCellType tableView:tableView];
+      UISwitch* accessoryView = (UISwitch*)cell.accessoryView;
+      cell.textLabel.text = @"Show performance overlay";
+      accessoryView.on = [PerformanceHUD sharedHUD].visible;
+      [accessoryView addTarget:self action:@selector(togglePerformanceHUDVisible:) forControlEvents:UIControlEventValueChanged];
+      break;
+    }
     case LoggingSection:
     {
       cell = [TableViewCellFactory cellWithType:SwitchCellType tableView:tableView];
@@ -493,6 +548,16 @@ enum BugReportSectionItem
   [appDelegate setupLogging];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Reacts to a tap gesture on the "Show performance overlay" switch.
+/// Shows or hides the overlay. The setting is not persisted.
+// -----------------------------------------------------------------------------
+- (void) togglePerformanceHUDVisible:(id)sender
+{
+  UISwitch* accessoryView = (UISwitch*)sender;
+  [PerformanceHUD sharedHUD].visible = accessoryView.on;
+}
+
 #pragma mark - Notification responders
 
 // -----------------------------------------------------------------------------
@@ -520,6 +585,15 @@ enum BugReportSectionItem
   [self updateBugReportSection];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #gtpSearchMetricsDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) gtpSearchMetricsDidChange:(NSNotification*)notification
+{
+  NSIndexSet* indexSet = [NSIndexSet indexSetWithIndex:SearchPerformanceSection];
+  [self.tableView reloadSections:indexSet withRowAnimation:UITableViewRowAnimationNone];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Responds to KVO notifications.
 // -----------------------------------------------------------------------------
@@ -539,6 +613,52 @@ enum BugReportSectionItem
 
 #pragma mark - Private helpers
 
+// -----------------------------------------------------------------------------
+/// @brief Configures @a cell with the search metric that is displayed in row
+/// @a row of the SearchPerformanceSection.
+// -----------------------------------------------------------------------------
+- (void) configureSearchPerformanceCell:(UITableViewCell*)cell forRow:(NSInteger)row
+{
+  GtpSearchMetrics* metrics = [ApplicationDelegate sharedDelegate].gtpSearchMetrics;
+  GtpUctSearchStatistics* statistics = metrics.mostRecentSearchStatistics;
+
+  switch (row)
+  {
+    case MostRecentSearchItem:
+      cell.textLabel.text = @"Most recent search";
+      if (statistics)
+        cell.detailTextLabel.text = [NSString stringWithFormat:@"%.0f playouts/s", statistics.gamesPerSecond];
+      else
+        cell.detailTextLabel.text = @"n/a";
+      break;
+    case AverageAndPeakPlayoutRateItem:
+      cell.textLabel.text = @"Average / peak";
+      if (statistics)
+        cell.detailTextLabel.text = [NSString stringWithFormat:@"%.0f / %.0f", metrics.averageGamesPerSecond, metrics.peakGamesPerSecond];
+      else
+        cell.detailTextLabel.text = @"n/a";
+      break;
+    case NumberOfThreadsItem:
+      cell.textLabel.text = @"Threads";
+      if (statistics)
+        cell.detailTextLabel.text = [NSString stringWithFormat:@"%d", metrics.mostRecentSearchNumberOfThreads];
+      else
+        cell.detailTextLabel.text = @"n/a";
+      break;
+    case MemoryFootprintItem:
+      cell.textLabel.text = @"Memory used / limit";
+      if (statistics)
+        cell.detailTextLabel.text = [NSString stringWithFormat:@"%llu / %d MB", metrics.mostRecentSearchMemoryFootprint / 1024 / 1024, metrics.mostRecentSearchMaximumMemory];
+      else
+        cell.detailTextLabel.text = @"n/a";
+      break;
+    default:
+      assert(0);
+      @throw [NSException exceptionWithName:NSInternalInconsistencyException reason:[NSString stringWithFormat:@"invalid row %ld", (long)row] userInfo:nil];
+      break;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Enables or disables the features in the "Send bug report" section,
 /// depending on the current state of the application.
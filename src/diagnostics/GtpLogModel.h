@@ -28,8 +28,8 @@
 /// receives responses from, the GTP engine. These notifications are delivered
 /// in the context of a secondary thread. The notifications carry with them the
 /// GtpCommand and GtpResponse objects which were used in the GTP client/engine
-/// communication, and which are now evaluated by GtpLogModel to generate
-/// entries in the log. Entries are represented by GtpLogItem objects.
+/// communication, and which are now recorded by GtpLogModel as entries in the
+/// log. Clients see entries as GtpLogItem objects.
 ///
 /// Because regular clients access GtpLogModel from the main thread, but
 /// notifications are delivered in a secondary thread, there is a potential for
@@ -43,6 +43,14 @@
 /// activities that occur around GTP client and engine. There is a guarantee,
 /// though, that items will pop up in the log in the same order that commands
 /// were submitted to the GTP engine.
+///
+/// Because the GTP log is recorded all the time, even when nobody looks at
+/// it, recording must be cheap. GtpLogModel therefore stores only the raw
+/// GtpCommand and GtpResponse objects and a timestamp in a fixed-capacity ring
+/// buffer whose capacity is @e gtpLogSize. When the buffer is full the oldest
+/// entry is overwritten. The GtpLogItem objects with their display strings are
+/// created only when a client asks for them via itemAtIndex:(), i.e. when the
+/// "GTP Log" view actually displays an item.
 // -----------------------------------------------------------------------------
 @interface GtpLogModel : NSObject
 {
@@ -54,19 +62,14 @@
 - (GtpLogItem*) itemAtIndex:(int)index;
 - (void) clearLog;
 
-/// @brief Number of objects in @e itemList.
-///
-/// This property exists purely as a convenience to clients, since the object
-/// count is also available from the itemList array.
+/// @brief Number of items in the log. Items are numbered in the order that
+/// their corresponding commands were submitted, the oldest item has index 0.
 @property(nonatomic, assign, readonly) int itemCount;
-/// @brief Array stores objects of type GtpLogItem. Items appear in the array
-/// in the order that their corresponding commands were submitted.
-@property(nonatomic, retain, readonly) NSArray* itemList;
-/// @brief The size of the GTP log, i.e. the maximum number of objects that can
-/// be in @e itemList.
+/// @brief The size of the GTP log, i.e. the maximum number of items that can
+/// be in the log.
 ///
-/// If a new item is about to be added to @e itemList that would exceed the
-/// limit, the oldest item is discarded first.
+/// If a new item is about to be added to the log that would exceed the limit,
+/// the oldest item is discarded first.
 @property(nonatomic, assign) int gtpLogSize;
 /// @brief True if the "GTP Log" view currently displays the frontside view,
 /// false if it displays the backside view.
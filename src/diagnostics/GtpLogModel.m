@@ -22,32 +22,56 @@
 #import "../gtp/GtpResponse.h"
 
 
+// -----------------------------------------------------------------------------
+/// @brief The GtpLogEntry struct is an entry in the ring buffer of GtpLogModel.
+/// It stores the raw data of one GTP command/response exchange.
+///
+/// The struct has ownership of the objects it refers to. The entry does not
+/// refer to the GtpCommand object because that would also keep alive the
+/// command's response target and completion handler.
+// -----------------------------------------------------------------------------
+struct GtpLogEntry
+{
+  NSString* commandString;
+  /// @brief Is nil while the response is still outstanding.
+  GtpResponse* response;
+  /// @brief The time when the command was submitted.
+  CFAbsoluteTime timeStamp;
+  /// @brief Is nil until a client asks for the item via itemAtIndex:().
+  GtpLogItem* item;
+};
+
+
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for GtpLogModel.
 // -----------------------------------------------------------------------------
 @interface GtpLogModel()
-/// @name Re-declaration of properties to make them readwrite privately
-//@{
-@property(nonatomic, retain, readwrite) NSArray* itemList;
-//@}
+{
+@private
+  /// @brief The ring buffer. Has @e gtpLogSize elements.
+  struct GtpLogEntry* m_entries;
+}
 /// @name Private properties
 //@{
-/// @brief Stores GtpLogItem objects for which a GTP response is still
-/// outstanding.
+/// @brief Index in @e m_entries of the oldest entry in the log.
+@property(nonatomic, assign) int indexOfOldestEntry;
+/// @brief The number of entries in the log.
+@property(nonatomic, assign) int numberOfEntries;
+/// @brief Sequence number of the next command that is added to the log.
 ///
-/// The array acts as a fifo queue. enqueueItemWithNoResponse() and
-/// dequeueItemWithNoResponse() are used to modify the queue.
+/// Commands are numbered in the order that they are submitted. The oldest
+/// entry in the log therefore has the sequence number
+/// @e nextCommandSequenceNumber - @e numberOfEntries.
+@property(nonatomic, assign) unsigned long long nextCommandSequenceNumber;
+/// @brief Sequence number of the command to which the next GTP response
+/// belongs.
 ///
-/// The assumption behind this is that the GTP engine also works as a queue: It
+/// The assumption behind this is that the GTP engine works as a queue: It
 /// processes GTP commands in the order that they are submitted, and does not
 /// start processing a new command before it has sent the response to the
-/// preceding command.
-///
-/// Based on this assumption, GtpLogItem objects can simply be added to the
-/// queue as the GTP command submissions are pouring in. Whenever a GTP response
-/// is received, the GtpLogItem object at the front of the queue must be the
-/// one with the command that the response belongs to.
-@property(nonatomic, retain) NSMutableArray* itemQueueNoResponses;
+/// preceding command. Based on this assumption, GTP responses can simply be
+/// counted as they come in to find the command that they belong to.
+@property(nonatomic, assign) unsigned long long nextResponseSequenceNumber;
 @property(nonatomic, retain) NSDateFormatter* dateFormatter;
 //@}
 @end
@@ -76,10 +100,14 @@
                                                name:gtpResponseWasReceivedNotification
                                              object:nil];
 
-  self.itemList = [NSMutableArray arrayWithCapacity:0];
+  m_entries = NULL;
+  _gtpLogSize = 0;
+  self.indexOfOldestEntry = 0;
+  self.numberOfEntries = 0;
+  self.nextCommandSequenceNumber = 0;
+  self.nextResponseSequenceNumber = 0;
   self.gtpLogSize = 100;
   self.gtpLogViewFrontSideIsVisible = true;
-  self.itemQueueNoResponses = [NSMutableArray arrayWithCapacity:0];
 
   self.dateFormatter = [[[NSDateFormatter alloc] init] autorelease];
   [self.dateFormatter setLocale:[NSLocale currentLocale]];
@@ -97,8 +125,12 @@
 - (void) dealloc
 {
   [[NSNotificationCenter defaultCenter] removeObserver:self];
-  self.itemList = nil;
-  self.itemQueueNoResponses = nil;
+  [self removeAllEntries];
+  if (m_entries)
+  {
+    free(m_entries);
+    m_entries = NULL;
+  }
   self.dateFormatter = nil;
   [super dealloc];
 }
@@ -156,8 +188,7 @@
   // gtpCommandWillBeSubmitted:()
   [command autorelease];
 
-  [self addItemToLog:command];
-  [self trimLog];
+  [self addEntryWithCommandString:command.command];
   [[NSNotificationCenter defaultCenter] postNotificationName:gtpLogContentChanged
                                                       object:nil];
 }
@@ -183,31 +214,43 @@
 // -----------------------------------------------------------------------------
 - (void) gtpResponseWasReceivedDelegate:(GtpResponse*)response
 {
-  // Undo retain message sent to the response object by
-  // gtpResponseWasReceived:()
-  [response autorelease];
+  unsigned long long responseSequenceNumber = self.nextResponseSequenceNumber;
+  self.nextResponseSequenceNumber++;
 
-  GtpLogItem* logItem = [self dequeueItemWithNoResponse];
-  assert(logItem != nil);
-  if (! logItem)
-    DDLogError(@"%@: GtpLogItem object is nil", self);
+  assert(responseSequenceNumber < self.nextCommandSequenceNumber);
+  if (responseSequenceNumber >= self.nextCommandSequenceNumber)
+  {
+    DDLogError(@"%@: Received GTP response without command", self);
+    [response release];
+    return;
+  }
 
-  // Check if the item was kicked out of the log while the response was still
+  // Check if the entry was kicked out of the log while the response was still
   // outstanding. Stuff like clearing the log, or a massive amount of trimming,
   // might have happened.
-  if (! [_itemList containsObject:logItem])
+  unsigned long long oldestCommandSequenceNumber = self.nextCommandSequenceNumber - self.numberOfEntries;
+  if (responseSequenceNumber < oldestCommandSequenceNumber)
   {
     DDLogInfo(@"Discarding GTP response");
+    [response release];
     return;
   }
 
-  logItem.hasResponse = true;
-  logItem.responseStatus = response.status;
-  logItem.parsedResponseString = [response parsedResponse];
-  logItem.rawResponseString = response.rawResponse;
+  // Cast is safe because the difference is less than numberOfEntries
+  int index = (int)(responseSequenceNumber - oldestCommandSequenceNumber);
+  struct GtpLogEntry* entry = [self entryAtIndex:index];
+  // Takes over the retain message sent to the response object by
+  // gtpResponseWasReceived:()
+  entry->response = response;
+  // The item, if it exists, must be re-created to pick up the response
+  if (entry->item)
+  {
+    [entry->item release];
+    entry->item = nil;
+  }
 
   [[NSNotificationCenter defaultCenter] postNotificationName:gtpLogItemChanged
-                                                      object:logItem];
+                                                      object:[NSNumber numberWithInt:index]];
 }
 
 // -----------------------------------------------------------------------------
@@ -215,10 +258,7 @@
 // -----------------------------------------------------------------------------
 - (int) itemCount
 {
-  // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
-  // is safe because this app was not made to handle more than pow(2, 31) log
-  // items.
-  return (int)_itemList.count;
+  return self.numberOfEntries;
 }
 
 // -----------------------------------------------------------------------------
@@ -234,107 +274,152 @@
   }
 
   int oldSize = _gtpLogSize;
+  if (newSize == oldSize)
+    return;
+
+  // Discard the oldest entries that do not fit into the new ring buffer
+  while (self.numberOfEntries > newSize)
+    [self removeOldestEntry];
+
+  // Copy the remaining entries into the new ring buffer so that the oldest
+  // entry is located at index 0
+  struct GtpLogEntry* newEntries = (struct GtpLogEntry*)malloc(sizeof(struct GtpLogEntry) * newSize);
+  for (int index = 0; index < self.numberOfEntries; ++index)
+    newEntries[index] = *[self entryAtIndex:index];
+  if (m_entries)
+    free(m_entries);
+  m_entries = newEntries;
+  self.indexOfOldestEntry = 0;
   _gtpLogSize = newSize;
 
   if (newSize < oldSize)
   {
-    [self trimLog];
     [[NSNotificationCenter defaultCenter] postNotificationName:gtpLogContentChanged
                                                         object:nil];
   }
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Returns the log item object located at position @a index in the
-/// itemList array.
+/// @brief Returns the log item located at position @a index in the log. The
+/// oldest item has index 0.
+///
+/// The GtpLogItem object and its display strings are created when this method
+/// is invoked for the first time for a given item.
 // -----------------------------------------------------------------------------
 - (GtpLogItem*) itemAtIndex:(int)index
 {
-  return [_itemList objectAtIndex:index];
+  if (index < 0 || index >= self.numberOfEntries)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Index %d is out of range, number of items in GTP log is %d", index, self.numberOfEntries];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  struct GtpLogEntry* entry = [self entryAtIndex:index];
+  if (! entry->item)
+    entry->item = [[self itemForEntry:entry] retain];
+  return entry->item;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Adds an item that represents @a command to the log.
+/// @brief Clears the entire log, i.e. all log items are removed.
 // -----------------------------------------------------------------------------
-- (void) addItemToLog:(GtpCommand*)command
+- (void) clearLog
 {
-  GtpLogItem* logItem = [[GtpLogItem alloc] init];
-  [(NSMutableArray*)_itemList addObject:logItem];  // _itemList has ownership
-  [logItem release];
+  // Note: Sequence numbers are not reset by design! Responses that are still
+  // outstanding will be discarded when they come in because their command is
+  // no longer in the log.
+  [self removeAllEntries];
+
+  [[NSNotificationCenter defaultCenter] postNotificationName:gtpLogContentChanged
+                                                      object:nil];
+}
 
-  [self enqueueItemWithNoResponse:logItem];
+#pragma mark - Private helpers
 
-  logItem.commandString = command.command;
-  logItem.timeStamp = [self.dateFormatter stringFromDate:[NSDate date]];
+// -----------------------------------------------------------------------------
+/// @brief Returns the ring buffer entry for the log item located at position
+/// @a index in the log. The oldest item has index 0.
+// -----------------------------------------------------------------------------
+- (struct GtpLogEntry*) entryAtIndex:(int)index
+{
+  return &m_entries[(self.indexOfOldestEntry + index) % _gtpLogSize];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Removes as many of the oldest items from the log as are needed to
-/// bring the log size down to its maximum allowed size (property
-/// @e gtpLogSize).
-///
-/// Does nothing if the log size currently does not exceed the limit.
+/// @brief Adds an entry for @a commandString to the log. Discards the oldest
+/// entry if the log is full.
 // -----------------------------------------------------------------------------
-- (void) trimLog
+- (void) addEntryWithCommandString:(NSString*)commandString
 {
-  // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
-  // is safe because this app was not made to handle more than pow(2, 31) log
-  // items.
-  int numberOfItemsToDiscard = (int)_itemList.count - self.gtpLogSize;
-  if (numberOfItemsToDiscard <= 0)
-    return;
+  if (self.numberOfEntries == _gtpLogSize)
+    [self removeOldestEntry];
 
-  NSRange rangeToRemove;
-  rangeToRemove.location = 0;  // oldest items are at the front of the array
-  rangeToRemove.length = numberOfItemsToDiscard;
-  [(NSMutableArray*)_itemList removeObjectsInRange:rangeToRemove];
+  struct GtpLogEntry* entry = [self entryAtIndex:self.numberOfEntries];
+  entry->commandString = [commandString retain];
+  entry->response = nil;
+  entry->timeStamp = CFAbsoluteTimeGetCurrent();
+  entry->item = nil;
+
+  self.numberOfEntries++;
+  self.nextCommandSequenceNumber++;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Adds @a item to the end of the queue with log items for which the
-/// response is still outstanding.
+/// @brief Removes the oldest entry from the log.
 // -----------------------------------------------------------------------------
-- (void) enqueueItemWithNoResponse:(GtpLogItem*)logItem
+- (void) removeOldestEntry
 {
-  [_itemQueueNoResponses addObject:logItem];
+  [self releaseEntry:[self entryAtIndex:0]];
+  self.indexOfOldestEntry = (self.indexOfOldestEntry + 1) % _gtpLogSize;
+  self.numberOfEntries--;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Removes an item from the front of the queue with log items for which
-/// the response is still outstanding, then returns that item.
-///
-/// Returns nil if the queue is currently empty.
+/// @brief Removes all entries from the log.
 // -----------------------------------------------------------------------------
-- (GtpLogItem*) dequeueItemWithNoResponse
+- (void) removeAllEntries
 {
-  if (_itemQueueNoResponses.count == 0)
-    return nil;
-  GtpLogItem* logItem = [_itemQueueNoResponses objectAtIndex:0];
-  [_itemQueueNoResponses removeObjectAtIndex:0];
-  return logItem;
+  for (int index = 0; index < self.numberOfEntries; ++index)
+    [self releaseEntry:[self entryAtIndex:index]];
+  self.indexOfOldestEntry = 0;
+  self.numberOfEntries = 0;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Removes all items from the queue with items for which the GTP
-/// response is still outstanding.
+/// @brief Releases the objects referred to by @a entry.
 // -----------------------------------------------------------------------------
-- (void) clearItemQueueWithNoResponse
+- (void) releaseEntry:(struct GtpLogEntry*)entry
 {
-  [_itemQueueNoResponses removeAllObjects];
+  [entry->commandString release];
+  entry->commandString = nil;
+  [entry->response release];
+  entry->response = nil;
+  [entry->item release];
+  entry->item = nil;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Clears the entire log, i.e. all log items are removed.
+/// @brief Returns a newly created GtpLogItem object that represents the data
+/// in @a entry.
 // -----------------------------------------------------------------------------
-- (void) clearLog
+- (GtpLogItem*) itemForEntry:(struct GtpLogEntry*)entry
 {
-  [(NSMutableArray*)_itemList removeAllObjects];
-  // Note: _itemQueueNoResponses is not modified by design! If we were removing
-  // items from that queue, outstanding responses might become associated with
-  // the wrong GtpLogItem objects when they come in.
-
-  [[NSNotificationCenter defaultCenter] postNotificationName:gtpLogContentChanged
-                                                      object:nil];
+  GtpLogItem* logItem = [[[GtpLogItem alloc] init] autorelease];
+  logItem.commandString = entry->commandString;
+  NSDate* timeStamp = [NSDate dateWithTimeIntervalSinceReferenceDate:entry->timeStamp];
+  logItem.timeStamp = [self.dateFormatter stringFromDate:timeStamp];
+  if (entry->response)
+  {
+    logItem.hasResponse = true;
+    logItem.responseStatus = entry->response.status;
+    logItem.parsedResponseString = [entry->response parsedResponse];
+    logItem.rawResponseString = entry->response.rawResponse;
+  }
+  return logItem;
 }
 
 @end
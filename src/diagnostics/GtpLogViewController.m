@@ -237,8 +237,10 @@
 - (void) reloadBackSideView
 {
   NSString* contentString = @"";
-  for (GtpLogItem* logItem in self.model.itemList)
+  int itemCount = self.model.itemCount;
+  for (int index = 0; index < itemCount; ++index)
   {
+    GtpLogItem* logItem = [self.model itemAtIndex:index];
     // Ignore items with outstanding responses. This should happen only for the
     // last item in the list. Information for that item will be appended to the
     // backside view when the response comes in.
@@ -426,11 +428,12 @@
     return;
   }
 
-  GtpLogItem* logItem = [notification object];
+  NSNumber* indexOfItemAsNumber = [notification object];
+  int indexOfItem = [indexOfItemAsNumber intValue];
 
   // Ignore updateScheduledByGtpLogContentChanged for backside view updating
   if (! self.model.gtpLogViewFrontSideIsVisible)
-    [self appendToBackSideView:logItem];
+    [self appendToBackSideView:[self.model itemAtIndex:indexOfItem]];
 
   // If an update has already been scheduled by gtpLogContentChanged:() we don't
   // have to do anything - in fact the number of cells in self.tableView at this
@@ -444,7 +447,6 @@
   self.updateScheduledByGtpLogItemChanged = true;
 
   NSUInteger sectionIndex = 0;
-  NSUInteger indexOfItem = [self.model.itemList indexOfObject:logItem];
   NSIndexPath* indexPath = [NSIndexPath indexPathForRow:indexOfItem inSection:sectionIndex];
   NSArray* indexPaths = [NSArray arrayWithObject:indexPath];
   [self.frontSideView reloadRowsAtIndexPaths:indexPaths
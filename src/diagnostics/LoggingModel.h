@@ -27,5 +27,10 @@
 - (void) writeUserDefaults;
 
 @property(nonatomic, assign) bool loggingEnabled;
+/// @brief The categories of os_signpost intervals that the app emits. This is
+/// a combination of #SignpostCategory values.
+///
+/// Setting this property immediately switches the categories on or off.
+@property(nonatomic, assign) int signpostCategories;
 
 @end
@@ -17,6 +17,7 @@
 
 // Project includes
 #import "LoggingModel.h"
+#import "SignpostLog.h"
 
 
 @implementation LoggingModel
@@ -33,6 +34,7 @@
   if (! self)
     return nil;
   self.loggingEnabled = false;
+  self.signpostCategories = SignpostCategoryAll;
   return self;
 }
 
@@ -45,6 +47,9 @@
   NSDictionary* dictionary = [userDefaults dictionaryForKey:loggingKey];
 
   self.loggingEnabled = [[dictionary valueForKey:loggingEnabledKey] boolValue];
+  // User defaults written by older versions of the app do not have the value
+  NSNumber* signpostCategories = [dictionary valueForKey:signpostCategoriesKey];
+  self.signpostCategories = signpostCategories ? [signpostCategories intValue] : SignpostCategoryAll;
 }
 
 // -----------------------------------------------------------------------------
@@ -55,9 +60,19 @@
 {
   NSMutableDictionary* dictionary = [NSMutableDictionary dictionary];
   [dictionary setValue:[NSNumber numberWithBool:self.loggingEnabled] forKey:loggingEnabledKey];
+  [dictionary setValue:[NSNumber numberWithInt:self.signpostCategories] forKey:signpostCategoriesKey];
 
   NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
   [userDefaults setObject:dictionary forKey:loggingKey];
 }
 
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setSignpostCategories:(int)newValue
+{
+  _signpostCategories = newValue;
+  [SignpostLog setEnabledCategories:newValue];
+}
+
 @end
@@ -0,0 +1,56 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The PerformanceHUD class manages an overlay that displays live
+/// performance figures on top of the application's UI. Testers can read the
+/// figures off a real device without attaching Instruments.
+///
+/// The overlay shows
+/// - The mean and the maximum frame time over the last update interval.
+/// - The number of main thread stalls since the overlay was shown. A stall is
+///   a frame that took longer than #performanceHUDStallThreshold, i.e. a frame
+///   during which the main thread was unable to process UI updates.
+/// - The number of asynchronous commands that are waiting to be executed by
+///   CommandProcessor.
+/// - The time the GTP engine took to respond to the most recent command.
+/// - The application's memory footprint.
+/// - The hit rates of BoardViewCGLayerCache, NodeTreeViewCGLayerCache and
+///   GtpResponseCache. A hit rate is calculated over the lookups that were
+///   made since the overlay was shown.
+///
+/// The overlay is updated every #performanceHUDUpdateInterval seconds. Frame
+/// times are measured with a CADisplayLink, which runs only while the overlay
+/// is shown. The overlay does not accept user interaction, so it does not
+/// interfere with the UI below it.
+///
+/// The overlay is switched on and off on the Diagnostics view. The setting is
+/// not persisted, the overlay is always hidden when the application launches.
+///
+/// PerformanceHUD must be used from the main thread only.
+// -----------------------------------------------------------------------------
+@interface PerformanceHUD : NSObject
+{
+}
+
++ (PerformanceHUD*) sharedHUD;
++ (void) releaseSharedHUD;
+
+/// @brief True if the overlay is shown, false if it is hidden.
+@property(nonatomic, assign, getter=isVisible) bool visible;
+
+@end
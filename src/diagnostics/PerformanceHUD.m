@@ -0,0 +1,290 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "PerformanceHUD.h"
+#import "../command/CommandProcessor.h"
+#import "../gtp/GtpClient.h"
+#import "../gtp/GtpResponseCache.h"
+#import "../main/ApplicationDelegate.h"
+#import "../play/boardview/layer/BoardViewCGLayerCache.h"
+#import "../play/nodetreeview/layer/NodeTreeViewCGLayerCache.h"
+#import "../utility/UIDeviceAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for PerformanceHUD.
+// -----------------------------------------------------------------------------
+@interface PerformanceHUD()
+/// @name Private properties
+//@{
+@property(nonatomic, retain) UILabel* overlayLabel;
+@property(nonatomic, retain) CADisplayLink* displayLink;
+@property(nonatomic, assign) CFTimeInterval previousFrameTimestamp;
+@property(nonatomic, assign) CFTimeInterval previousUpdateTimestamp;
+@property(nonatomic, assign) CFTimeInterval frameTimeSum;
+@property(nonatomic, assign) CFTimeInterval frameTimeMaximum;
+@property(nonatomic, assign) int numberOfFrames;
+@property(nonatomic, assign) int numberOfStalls;
+@property(nonatomic, assign) unsigned long long boardViewCacheHitsBaseline;
+@property(nonatomic, assign) unsigned long long boardViewCacheMissesBaseline;
+@property(nonatomic, assign) unsigned long long nodeTreeViewCacheHitsBaseline;
+@property(nonatomic, assign) unsigned long long nodeTreeViewCacheMissesBaseline;
+@property(nonatomic, assign) unsigned long long gtpResponseCacheHitsBaseline;
+@property(nonatomic, assign) unsigned long long gtpResponseCacheMissesBaseline;
+//@}
+@end
+
+
+@implementation PerformanceHUD
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of PerformanceHUD.
+// -----------------------------------------------------------------------------
+static PerformanceHUD* sharedHUD = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared PerformanceHUD object.
+// -----------------------------------------------------------------------------
++ (PerformanceHUD*) sharedHUD
+{
+  if (! sharedHUD)
+    sharedHUD = [[PerformanceHUD alloc] init];
+  return sharedHUD;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared PerformanceHUD object. Hides the overlay if it
+/// is currently shown.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedHUD
+{
+  if (sharedHUD)
+  {
+    // Must hide the overlay first because the CADisplayLink retains its target
+    sharedHUD.visible = false;
+    [sharedHUD release];
+    sharedHUD = nil;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a PerformanceHUD object.
+///
+/// @note This is the designated initializer of PerformanceHUD.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+  _visible = false;
+  self.overlayLabel = nil;
+  self.displayLink = nil;
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this PerformanceHUD object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self.displayLink invalidate];
+  self.displayLink = nil;
+  [self.overlayLabel removeFromSuperview];
+  self.overlayLabel = nil;
+  [super dealloc];
+}
+
+#pragma mark - Property accessors
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setVisible:(bool)visible
+{
+  if (_visible == visible)
+    return;
+  _visible = visible;
+  if (visible)
+    [self showOverlay];
+  else
+    [self hideOverlay];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setVisible:().
+// -----------------------------------------------------------------------------
+- (void) showOverlay
+{
+  UIWindow* window = [ApplicationDelegate sharedDelegate].window;
+
+  UILabel* label = [[[UILabel alloc] initWithFrame:CGRectZero] autorelease];
+  label.userInteractionEnabled = NO;
+  label.numberOfLines = 0;
+  label.font = [UIFont monospacedSystemFontOfSize:11 weight:UIFontWeightRegular];
+  label.textColor = [UIColor whiteColor];
+  label.backgroundColor = [[UIColor blackColor] colorWithAlphaComponent:0.6];
+  label.layer.cornerRadius = 4;
+  label.layer.masksToBounds = YES;
+  self.overlayLabel = label;
+  [window addSubview:label];
+
+  [self resetMeasurements];
+  [self updateOverlay];
+
+  self.displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkDidFire:)];
+  [self.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setVisible:().
+// -----------------------------------------------------------------------------
+- (void) hideOverlay
+{
+  [self.displayLink invalidate];
+  self.displayLink = nil;
+  [self.overlayLabel removeFromSuperview];
+  self.overlayLabel = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for showOverlay(). Resets frame time measurements and
+/// remembers the current cache counters so that hit rates can be calculated
+/// over the lookups made while the overlay is shown.
+// -----------------------------------------------------------------------------
+- (void) resetMeasurements
+{
+  self.previousFrameTimestamp = 0;
+  self.previousUpdateTimestamp = CACurrentMediaTime();
+  self.frameTimeSum = 0;
+  self.frameTimeMaximum = 0;
+  self.numberOfFrames = 0;
+  self.numberOfStalls = 0;
+
+  BoardViewCGLayerCache* boardViewCache = [BoardViewCGLayerCache sharedCache];
+  self.boardViewCacheHitsBaseline = boardViewCache.numberOfHits;
+  self.boardViewCacheMissesBaseline = boardViewCache.numberOfMisses;
+  NodeTreeViewCGLayerCache* nodeTreeViewCache = [NodeTreeViewCGLayerCache sharedCache];
+  self.nodeTreeViewCacheHitsBaseline = nodeTreeViewCache.numberOfHits;
+  self.nodeTreeViewCacheMissesBaseline = nodeTreeViewCache.numberOfMisses;
+  GtpResponseCache* gtpResponseCache = [ApplicationDelegate sharedDelegate].gtpClient.responseCache;
+  self.gtpResponseCacheHitsBaseline = gtpResponseCache.numberOfHits;
+  self.gtpResponseCacheMissesBaseline = gtpResponseCache.numberOfMisses;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Invoked once per frame while the overlay is shown. Measures the time
+/// that elapsed since the previous frame.
+// -----------------------------------------------------------------------------
+- (void) displayLinkDidFire:(CADisplayLink*)displayLink
+{
+  CFTimeInterval frameTimestamp = displayLink.timestamp;
+  if (self.previousFrameTimestamp > 0)
+  {
+    CFTimeInterval frameTime = frameTimestamp - self.previousFrameTimestamp;
+    self.frameTimeSum += frameTime;
+    self.numberOfFrames++;
+    if (frameTime > self.frameTimeMaximum)
+      self.frameTimeMaximum = frameTime;
+    if (frameTime > performanceHUDStallThreshold)
+      self.numberOfStalls++;
+  }
+  self.previousFrameTimestamp = frameTimestamp;
+
+  if (frameTimestamp - self.previousUpdateTimestamp >= performanceHUDUpdateInterval)
+  {
+    [self updateOverlay];
+    self.previousUpdateTimestamp = frameTimestamp;
+    self.frameTimeSum = 0;
+    self.frameTimeMaximum = 0;
+    self.numberOfFrames = 0;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the overlay with the current performance figures.
+// -----------------------------------------------------------------------------
+- (void) updateOverlay
+{
+  double frameTimeMean = (self.numberOfFrames > 0) ? (self.frameTimeSum / self.numberOfFrames) : 0;
+
+  BoardViewCGLayerCache* boardViewCache = [BoardViewCGLayerCache sharedCache];
+  NSString* boardViewCacheHitRate = [self hitRateWithHits:boardViewCache.numberOfHits - self.boardViewCacheHitsBaseline
+                                                   misses:boardViewCache.numberOfMisses - self.boardViewCacheMissesBaseline];
+  NodeTreeViewCGLayerCache* nodeTreeViewCache = [NodeTreeViewCGLayerCache sharedCache];
+  NSString* nodeTreeViewCacheHitRate = [self hitRateWithHits:nodeTreeViewCache.numberOfHits - self.nodeTreeViewCacheHitsBaseline
+                                                      misses:nodeTreeViewCache.numberOfMisses - self.nodeTreeViewCacheMissesBaseline];
+  GtpClient* gtpClient = [ApplicationDelegate sharedDelegate].gtpClient;
+  GtpResponseCache* gtpResponseCache = gtpClient.responseCache;
+  NSString* gtpResponseCacheHitRate = [self hitRateWithHits:gtpResponseCache.numberOfHits - self.gtpResponseCacheHitsBaseline
+                                                     misses:gtpResponseCache.numberOfMisses - self.gtpResponseCacheMissesBaseline];
+
+  double memoryFootprintMegabytes = [UIDevice applicationMemoryFootprint] / (1024.0 * 1024.0);
+
+  self.overlayLabel.text = [NSString stringWithFormat:
+                            @" Frame    %5.1f ms / max %5.1f ms \n"
+                            @" Stalls   %d \n"
+                            @" Commands %d pending \n"
+                            @" GTP      %5.1f ms \n"
+                            @" Memory   %5.1f MB \n"
+                            @" Cache    board %@ / tree %@ / gtp %@ ",
+                            frameTimeMean * 1000,
+                            self.frameTimeMaximum * 1000,
+                            self.numberOfStalls,
+                            [CommandProcessor sharedProcessor].numberOfPendingCommands,
+                            gtpClient.lastResponseTime * 1000,
+                            memoryFootprintMegabytes,
+                            boardViewCacheHitRate,
+                            nodeTreeViewCacheHitRate,
+                            gtpResponseCacheHitRate];
+  [self layoutOverlay];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for updateOverlay(). Returns a hit rate in percent
+/// formatted for display, or a dash if no lookups have been made.
+// -----------------------------------------------------------------------------
+- (NSString*) hitRateWithHits:(unsigned long long)hits misses:(unsigned long long)misses
+{
+  unsigned long long lookups = hits + misses;
+  if (0 == lookups)
+    return @"-";
+  return [NSString stringWithFormat:@"%.0f%%", 100.0 * hits / lookups];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for updateOverlay(). Positions the overlay at the top
+/// of the window, inside the safe area, and keeps it above all other views.
+// -----------------------------------------------------------------------------
+- (void) layoutOverlay
+{
+  UIView* window = self.overlayLabel.superview;
+  if (! window)
+    return;
+  [self.overlayLabel sizeToFit];
+  CGRect frame = self.overlayLabel.frame;
+  frame.origin.x = window.safeAreaInsets.left + 4;
+  frame.origin.y = window.safeAreaInsets.top + 4;
+  self.overlayLabel.frame = frame;
+  [window bringSubviewToFront:self.overlayLabel];
+}
+
+@end
@@ -75,6 +75,8 @@
 ///
 /// Invoke generateDiagnosticsInformationFile() to just generate the file with
 /// diagnostics information (part one of the whole "send a bug report" process).
+/// This method, too, returns before the process has finished because the file
+/// is generated asynchronously.
 // -----------------------------------------------------------------------------
 @interface SendBugReportController : NSObject <MFMailComposeViewControllerDelegate>
 {
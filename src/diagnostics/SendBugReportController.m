@@ -94,9 +94,7 @@
   self.sendBugReportMode = true;
   if (! [self canSendMail])
     return;
-  if (! [self generateDiagnosticsInformationFileInternal])
-    return;
-  [self presentMailComposeController];
+  [self generateDiagnosticsInformationFileInternalWithSuccessHandler:@selector(presentMailComposeController)];
 }
 
 // -----------------------------------------------------------------------------
@@ -107,9 +105,14 @@
 - (void) generateDiagnosticsInformationFile
 {
   self.sendBugReportMode = false;
-  if (! [self generateDiagnosticsInformationFileInternal])
-    return;
+  [self generateDiagnosticsInformationFileInternalWithSuccessHandler:@selector(presentDiagnosticsInformationFileGeneratedAlert)];
+}
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for generateDiagnosticsInformationFile().
+// -----------------------------------------------------------------------------
+- (void) presentDiagnosticsInformationFileGeneratedAlert
+{
   NSString* alertTitle = @"Information generated";
   NSString* alertMessage = [NSString stringWithFormat:@"Diagnostics information has been generated and is ready for transfer to your computer via iTunes file sharing. In iTunes look for the file named '%@'.", bugReportDiagnosticsInformationFileName];
   NSString* buttonTitle = @"Ok";
@@ -136,23 +139,38 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Generates the diagnostics information file. Returns true on success,
-/// false on failure. Displays an alert on failure, but remains silent on
-/// success.
+/// @brief Generates the diagnostics information file. Returns before the file
+/// has been generated. Invokes @a successHandler on the main thread when the
+/// file has been generated successfully. Displays an alert on failure.
 // -----------------------------------------------------------------------------
-- (bool) generateDiagnosticsInformationFileInternal
+- (void) generateDiagnosticsInformationFileInternalWithSuccessHandler:(SEL)successHandler
 {
   GenerateDiagnosticsInformationFileCommand* command = [[[GenerateDiagnosticsInformationFileCommand alloc] init] autorelease];
-  bool success = [command submit];
   self.diagnosticsInformationFilePath = command.diagnosticsInformationFilePath;
-  if (! success)
-  {
-    NSString* alertTitle = @"Operation failed";
-    NSString* alertMessage = @"An error occurred while generating diagnostics information.";
-    NSString* buttonTitle = @"Very funny!";
-    [self presentAlertWithTitle:alertTitle message:alertMessage buttonTitle:buttonTitle];
-  }
-  return success;
+  // The block retains self, so this controller survives until the command
+  // has finished
+  [command submitWithCompletionHandler:^(NSObject<Command>* command, bool success)
+   {
+    // UIKit manipulations must occur on the main thread. This completion
+    // handler is not invoked on the main thread because
+    // GenerateDiagnosticsInformationFileCommand is an asynchronous command.
+    SEL handler = (success
+                   ? successHandler
+                   : @selector(presentDiagnosticsInformationFileFailedAlert));
+    [self performSelectorOnMainThread:handler withObject:nil waitUntilDone:YES];
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// generateDiagnosticsInformationFileInternalWithSuccessHandler:().
+// -----------------------------------------------------------------------------
+- (void) presentDiagnosticsInformationFileFailedAlert
+{
+  NSString* alertTitle = @"Operation failed";
+  NSString* alertMessage = @"An error occurred while generating diagnostics information.";
+  NSString* buttonTitle = @"Very funny!";
+  [self presentAlertWithTitle:alertTitle message:alertMessage buttonTitle:buttonTitle];
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,68 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@protocol Command;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SessionRecorder class records a user session as a stream of
+/// submitted commands and GTP commands, so that the session can later be
+/// replayed with SessionReplay.
+///
+/// SessionRecorder does nothing until startRecording() is invoked. From then
+/// on CommandProcessor reports every Command that is submitted to it, and
+/// GtpClient reports every GTP command that is submitted to it. Each report
+/// becomes one entry in the recording. An entry is an NSDictionary with these
+/// keys:
+/// - #sessionRecordingEntryTypeKey: Either #sessionRecordingEntryTypeCommand
+///   or #sessionRecordingEntryTypeGtpCommand.
+/// - #sessionRecordingEntryTimeKey: An NSNumber with the number of seconds
+///   since recording started.
+/// - #sessionRecordingEntryContentKey: The name of the command, or the GTP
+///   command string.
+///
+/// The recording is a property list, so it can be written to and read from a
+/// file as is. The diagnostics information file includes the recording.
+///
+/// The app starts recording at launch if it is launched with
+/// #recordSessionLaunchArgument, which is also how UI tests can record a
+/// session.
+///
+/// SessionRecorder methods can be invoked from any thread.
+// -----------------------------------------------------------------------------
+@interface SessionRecorder : NSObject
+{
+}
+
++ (SessionRecorder*) sharedRecorder;
++ (void) releaseSharedRecorder;
++ (bool) writeRecording:(NSArray*)recording toFile:(NSString*)filePath;
++ (NSArray*) recordingWithContentsOfFile:(NSString*)filePath;
+
+- (void) startRecording;
+- (NSArray*) stopRecording;
+- (void) recordCommand:(id<Command>)command;
+- (void) recordGtpCommand:(NSString*)commandString;
+
+/// @brief True if SessionRecorder is currently recording.
+@property(atomic, assign, readonly, getter=isRecording) bool recording;
+/// @brief A copy of the entries recorded so far. Is an empty array if
+/// SessionRecorder is not recording.
+@property(nonatomic, retain, readonly) NSArray* recordedEntries;
+
+@end
@@ -0,0 +1,217 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "SessionRecorder.h"
+#import "../command/Command.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for SessionRecorder.
+// -----------------------------------------------------------------------------
+@interface SessionRecorder()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(atomic, assign, readwrite, getter=isRecording) bool recording;
+//@}
+/// @brief The entries recorded so far. Access must be synchronized.
+@property(nonatomic, retain) NSMutableArray* entries;
+/// @brief The time when recording started, obtained from CACurrentMediaTime().
+@property(nonatomic, assign) CFTimeInterval recordingStartTime;
+@end
+
+
+@implementation SessionRecorder
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of SessionRecorder.
+// -----------------------------------------------------------------------------
+static SessionRecorder* sharedRecorder = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared SessionRecorder object.
+// -----------------------------------------------------------------------------
++ (SessionRecorder*) sharedRecorder
+{
+  @synchronized(self)
+  {
+    if (! sharedRecorder)
+      sharedRecorder = [[SessionRecorder alloc] init];
+    return sharedRecorder;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared SessionRecorder object.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedRecorder
+{
+  @synchronized(self)
+  {
+    if (sharedRecorder)
+    {
+      [sharedRecorder release];
+      sharedRecorder = nil;
+    }
+  }
+}
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SessionRecorder object that is not recording.
+///
+/// @note This is the designated initializer of SessionRecorder.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.recording = false;
+  self.entries = nil;
+  self.recordingStartTime = 0;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this SessionRecorder object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.entries = nil;
+  [super dealloc];
+}
+
+#pragma mark - Recording
+
+// -----------------------------------------------------------------------------
+/// @brief Starts a new recording. Discards entries recorded so far if
+/// SessionRecorder is already recording.
+// -----------------------------------------------------------------------------
+- (void) startRecording
+{
+  @synchronized(self)
+  {
+    self.entries = [NSMutableArray array];
+    self.recordingStartTime = CACurrentMediaTime();
+    self.recording = true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Stops recording and returns the entries recorded. Returns an empty
+/// array if SessionRecorder is not recording.
+// -----------------------------------------------------------------------------
+- (NSArray*) stopRecording
+{
+  @synchronized(self)
+  {
+    NSArray* recordedEntries = self.recordedEntries;
+    self.recording = false;
+    self.entries = nil;
+    return recordedEntries;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Records the submission of @a command. Does nothing if
+/// SessionRecorder is not recording.
+// -----------------------------------------------------------------------------
+- (void) recordCommand:(id<Command>)command
+{
+  if (! self.isRecording)
+    return;
+  [self recordEntryWithType:sessionRecordingEntryTypeCommand content:command.name];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Records the submission of the GTP command @a commandString. Does
+/// nothing if SessionRecorder is not recording.
+// -----------------------------------------------------------------------------
+- (void) recordGtpCommand:(NSString*)commandString
+{
+  if (! self.isRecording)
+    return;
+  [self recordEntryWithType:sessionRecordingEntryTypeGtpCommand content:commandString];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for recordCommand:() and recordGtpCommand:().
+// -----------------------------------------------------------------------------
+- (void) recordEntryWithType:(NSString*)type content:(NSString*)content
+{
+  if (! content)
+    return;
+
+  @synchronized(self)
+  {
+    // Recording may have stopped since the caller checked
+    if (! self.entries)
+      return;
+
+    NSNumber* time = [NSNumber numberWithDouble:CACurrentMediaTime() - self.recordingStartTime];
+    [self.entries addObject:@{
+      sessionRecordingEntryTypeKey : type,
+      sessionRecordingEntryTimeKey : time,
+      sessionRecordingEntryContentKey : [[content copy] autorelease],
+    }];
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSArray*) recordedEntries
+{
+  @synchronized(self)
+  {
+    if (! self.entries)
+      return @[];
+    return [[self.entries copy] autorelease];
+  }
+}
+
+#pragma mark - Persistence
+
+// -----------------------------------------------------------------------------
+/// @brief Writes @a recording to the file @a filePath in property list
+/// format. Returns true if successful, false if not.
+// -----------------------------------------------------------------------------
++ (bool) writeRecording:(NSArray*)recording toFile:(NSString*)filePath
+{
+  BOOL success = [recording writeToFile:filePath atomically:YES];
+  if (! success)
+    DDLogError(@"%@: Failed to write session recording to file %@", self, filePath);
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reads a recording from the file @a filePath. Returns @e nil if the
+/// file cannot be read.
+// -----------------------------------------------------------------------------
++ (NSArray*) recordingWithContentsOfFile:(NSString*)filePath
+{
+  NSArray* recording = [NSArray arrayWithContentsOfFile:filePath];
+  if (! recording)
+    DDLogError(@"%@: Failed to read session recording from file %@", self, filePath);
+  return recording;
+}
+
+@end
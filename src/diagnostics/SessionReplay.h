@@ -0,0 +1,74 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GtpClient;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SessionReplay class replays a session that was recorded by
+/// SessionRecorder, as fast as possible and with a deterministic GTP engine
+/// configuration, so that the same workload can be timed on every build.
+///
+/// SessionReplay replays the GTP commands of the recording. It submits them
+/// one after the other to a GtpClient, each time waiting for the response,
+/// and ignores the recorded timestamps. Before the first recorded GTP command
+/// SessionReplay configures the GTP engine so that its searches are
+/// reproducible: A fixed random seed, a single search thread, a fixed number
+/// of playouts per move, no pondering and no time limit. Recorded GTP commands
+/// that would change this configuration are skipped.
+///
+/// Recorded commands (as opposed to GTP commands) are not replayed because a
+/// Command object cannot be recreated from its name. They are counted and
+/// their names are available to the client, e.g. to correlate a slow replay
+/// with the user actions that were recorded.
+///
+/// replayWithGtpClient:() blocks until the replay is complete, so it should
+/// not be invoked on the main thread of the app. It can be invoked on the main
+/// thread of a unit or UI test.
+// -----------------------------------------------------------------------------
+@interface SessionReplay : NSObject
+{
+}
+
+- (id) initWithRecording:(NSArray*)recording;
+- (double) replayWithGtpClient:(GtpClient*)gtpClient;
+
+/// @brief The random seed that the GTP engine is configured with. The default
+/// is 1.
+@property(nonatomic, assign) unsigned int randomSeed;
+/// @brief The number of playouts that the GTP engine is allowed per move. The
+/// default is 1000.
+@property(nonatomic, assign) unsigned long long maxGames;
+/// @brief The names of the recorded commands, in the order in which they were
+/// recorded.
+@property(nonatomic, retain, readonly) NSArray* recordedCommandNames;
+/// @brief The time in seconds between the first and the last entry of the
+/// recording.
+@property(nonatomic, assign, readonly) double recordedDuration;
+/// @brief The number of recorded GTP commands that were replayed by the most
+/// recent invocation of replayWithGtpClient:().
+@property(nonatomic, assign, readonly) int numberOfReplayedGtpCommands;
+/// @brief The number of recorded GTP commands that were skipped by the most
+/// recent invocation of replayWithGtpClient:() because they would have changed
+/// the deterministic engine configuration.
+@property(nonatomic, assign, readonly) int numberOfSkippedGtpCommands;
+/// @brief The number of replayed GTP commands whose response indicated an
+/// error in the most recent invocation of replayWithGtpClient:().
+@property(nonatomic, assign, readonly) int numberOfFailedGtpCommands;
+
+@end
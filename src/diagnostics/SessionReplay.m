@@ -0,0 +1,204 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "SessionReplay.h"
+#import "../gtp/GtpClient.h"
+#import "../gtp/GtpCommand.h"
+#import "../gtp/GtpResponse.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for SessionReplay.
+// -----------------------------------------------------------------------------
+@interface SessionReplay()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, retain, readwrite) NSArray* recordedCommandNames;
+@property(nonatomic, assign, readwrite) double recordedDuration;
+@property(nonatomic, assign, readwrite) int numberOfReplayedGtpCommands;
+@property(nonatomic, assign, readwrite) int numberOfSkippedGtpCommands;
+@property(nonatomic, assign, readwrite) int numberOfFailedGtpCommands;
+//@}
+/// @brief The GTP command strings of the recording.
+@property(nonatomic, retain) NSArray* recordedGtpCommands;
+@end
+
+
+@implementation SessionReplay
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SessionReplay object that replays @a recording.
+/// @a recording must have the format described in the SessionRecorder class
+/// documentation.
+///
+/// @note This is the designated initializer of SessionReplay.
+// -----------------------------------------------------------------------------
+- (id) initWithRecording:(NSArray*)recording
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.randomSeed = 1;
+  self.maxGames = 1000;
+  self.numberOfReplayedGtpCommands = 0;
+  self.numberOfSkippedGtpCommands = 0;
+  self.numberOfFailedGtpCommands = 0;
+
+  NSMutableArray* recordedCommandNames = [NSMutableArray array];
+  NSMutableArray* recordedGtpCommands = [NSMutableArray array];
+  for (NSDictionary* entry in recording)
+  {
+    NSString* type = entry[sessionRecordingEntryTypeKey];
+    NSString* content = entry[sessionRecordingEntryContentKey];
+    if ([type isEqualToString:sessionRecordingEntryTypeCommand])
+      [recordedCommandNames addObject:content];
+    else if ([type isEqualToString:sessionRecordingEntryTypeGtpCommand])
+      [recordedGtpCommands addObject:content];
+  }
+  self.recordedCommandNames = recordedCommandNames;
+  self.recordedGtpCommands = recordedGtpCommands;
+
+  if (recording.count > 0)
+  {
+    double firstEntryTime = [recording.firstObject[sessionRecordingEntryTimeKey] doubleValue];
+    double lastEntryTime = [recording.lastObject[sessionRecordingEntryTimeKey] doubleValue];
+    self.recordedDuration = lastEntryTime - firstEntryTime;
+  }
+  else
+  {
+    self.recordedDuration = 0.0;
+  }
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this SessionReplay object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.recordedCommandNames = nil;
+  self.recordedGtpCommands = nil;
+  [super dealloc];
+}
+
+#pragma mark - Replay
+
+// -----------------------------------------------------------------------------
+/// @brief Replays the recorded GTP commands by submitting them to
+/// @a gtpClient. Returns the time in seconds that the replay took, excluding
+/// the time needed to configure the GTP engine.
+// -----------------------------------------------------------------------------
+- (double) replayWithGtpClient:(GtpClient*)gtpClient
+{
+  self.numberOfReplayedGtpCommands = 0;
+  self.numberOfSkippedGtpCommands = 0;
+  self.numberOfFailedGtpCommands = 0;
+
+  for (NSString* commandString in [self engineConfigurationCommands])
+    [self submitCommand:commandString toGtpClient:gtpClient];
+  // Configuration commands are not part of the replay
+  self.numberOfFailedGtpCommands = 0;
+
+  CFTimeInterval replayStartTime = CACurrentMediaTime();
+
+  for (NSString* commandString in self.recordedGtpCommands)
+  {
+    if ([self shouldSkipCommand:commandString])
+    {
+      self.numberOfSkippedGtpCommands++;
+      continue;
+    }
+
+    [self submitCommand:commandString toGtpClient:gtpClient];
+    self.numberOfReplayedGtpCommands++;
+  }
+
+  double replayDuration = CACurrentMediaTime() - replayStartTime;
+
+  DDLogInfo(@"%@: Replayed %d GTP commands in %.3f seconds (recorded duration %.3f seconds), %d commands skipped, %d commands failed",
+            self,
+            self.numberOfReplayedGtpCommands,
+            replayDuration,
+            self.recordedDuration,
+            self.numberOfSkippedGtpCommands,
+            self.numberOfFailedGtpCommands);
+
+  return replayDuration;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for replayWithGtpClient:(). Submits the GTP command
+/// @a commandString to @a gtpClient and waits for the response.
+// -----------------------------------------------------------------------------
+- (void) submitCommand:(NSString*)commandString toGtpClient:(GtpClient*)gtpClient
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+  [gtpClient submit:command];
+  if (! command.response.status)
+    self.numberOfFailedGtpCommands++;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for replayWithGtpClient:(). Returns the GTP commands
+/// that configure the GTP engine for a deterministic replay.
+// -----------------------------------------------------------------------------
+- (NSArray*) engineConfigurationCommands
+{
+  return @[
+    [NSString stringWithFormat:@"set_random_seed %u", self.randomSeed],
+    @"uct_param_search number_threads 1",
+    [NSString stringWithFormat:@"uct_param_player max_games %llu", self.maxGames],
+    @"uct_param_player ignore_clock 1",
+    @"uct_param_player ponder 0",
+  ];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for replayWithGtpClient:(). Returns true if the GTP
+/// command @a commandString would change the deterministic engine
+/// configuration, or would end the replay prematurely.
+// -----------------------------------------------------------------------------
+- (bool) shouldSkipCommand:(NSString*)commandString
+{
+  static NSArray* skippedCommandPrefixes = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    skippedCommandPrefixes = [@[
+      @"set_random_seed",
+      @"uct_param_search number_threads",
+      @"uct_param_player max_games",
+      @"uct_param_player ignore_clock",
+      @"uct_param_player ponder",
+      @"uct_param_player max_ponder_time",
+      @"quit",
+    ] retain];
+  });
+
+  for (NSString* prefix in skippedCommandPrefixes)
+  {
+    if ([commandString hasPrefix:prefix])
+      return true;
+  }
+  return false;
+}
+
+@end
@@ -0,0 +1,45 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// System includes
+#import <os/log.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SignpostLog class provides the log handles that the app uses to
+/// emit os_signpost intervals.
+///
+/// There is one log handle for each #SignpostCategory. If the user has
+/// switched off a category (see LoggingModel), logForCategory:() returns
+/// @e OS_LOG_DISABLED for that category. The os_signpost macros test whether
+/// the log handle is enabled before they evaluate their arguments, so a
+/// disabled category costs no more than that test.
+///
+/// Signpost names must be string literals, this is a requirement of the
+/// os_signpost API. See the Constants.h section "Signpost constants" for the
+/// subsystem and category names.
+///
+/// SignpostLog can be accessed from any thread.
+// -----------------------------------------------------------------------------
+@interface SignpostLog : NSObject
+{
+}
+
++ (os_log_t) logForCategory:(enum SignpostCategory)category;
++ (void) setEnabledCategories:(int)enabledCategories;
+
+@end
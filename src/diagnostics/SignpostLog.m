@@ -0,0 +1,83 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "SignpostLog.h"
+
+// System includes
+#include <stdatomic.h>
+
+
+/// @brief The categories that are currently enabled. Until LoggingModel
+/// provides the user preference all categories are enabled.
+static atomic_int enabledSignpostCategories = SignpostCategoryAll;
+
+
+@implementation SignpostLog
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the log handle to use for emitting signposts in @a category.
+/// Returns @e OS_LOG_DISABLED if @a category is switched off.
+// -----------------------------------------------------------------------------
++ (os_log_t) logForCategory:(enum SignpostCategory)category
+{
+  static os_log_t commandsLog = NULL;
+  static os_log_t gtpLog = NULL;
+  static os_log_t goModelLog = NULL;
+  static os_log_t drawingLog = NULL;
+  static os_log_t launchLog = NULL;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    const char* subsystem = [drawingSignpostSubsystem UTF8String];
+    commandsLog = os_log_create(subsystem, [commandsSignpostCategory UTF8String]);
+    gtpLog = os_log_create(subsystem, [gtpSignpostCategory UTF8String]);
+    goModelLog = os_log_create(subsystem, [goModelSignpostCategory UTF8String]);
+    drawingLog = os_log_create(subsystem, [drawingSignpostCategory UTF8String]);
+    launchLog = os_log_create(subsystem, [launchSignpostCategory UTF8String]);
+  });
+
+  if (0 == (atomic_load_explicit(&enabledSignpostCategories, memory_order_relaxed) & category))
+    return OS_LOG_DISABLED;
+
+  switch (category)
+  {
+    case SignpostCategoryCommands:
+      return commandsLog;
+    case SignpostCategoryGtp:
+      return gtpLog;
+    case SignpostCategoryGoModel:
+      return goModelLog;
+    case SignpostCategoryDrawing:
+      return drawingLog;
+    case SignpostCategoryLaunch:
+      return launchLog;
+    default:
+      return OS_LOG_DISABLED;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Switches on the categories whose bits are set in
+/// @a enabledCategories, and switches off all other categories.
+/// @a enabledCategories is a combination of #SignpostCategory values.
+// -----------------------------------------------------------------------------
++ (void) setEnabledCategories:(int)enabledCategories
+{
+  atomic_store_explicit(&enabledSignpostCategories, enabledCategories, memory_order_relaxed);
+}
+
+@end
@@ -15,7 +15,11 @@
 // -----------------------------------------------------------------------------
 
 
+// Project includes
+#import "GoVertexNumeric.h"
+
 // Forward declarations
+@class GoBoardTopology;
 @class GoPoint;
 @class GoZobristTable;
 
@@ -33,6 +37,47 @@
 /// these objects. A GoPoint object is identified by the coordinates of the
 /// intersection it is located on, or by its association with its neighbouring
 /// GoPoint objects in one of several directions (see #GoBoardDirection).
+///
+/// Everything about the board that depends only on the board size (vertexes,
+/// neighbour relationships, star points) is taken from the GoBoardTopology
+/// object that is shared by all boards of the same size. The GoPoint objects
+/// that GoBoard creates hold only the per-game stone state.
+///
+///
+/// @par Board state queries
+///
+/// GoBoard internally maintains a compact C++ representation of the stones on
+/// the board (see GoBoardCore). The representation is kept up-to-date by
+/// GoPoint whenever the @e stoneState property of a GoPoint changes. GoBoard
+/// makes the representation available through a number of query methods (e.g.
+/// numberOfLibertiesOfStoneGroupAtPoint:()) whose results are computed with a
+/// few bit operations instead of walking through GoPoint and GoBoardRegion
+/// objects. Clients that are concerned with performance, such as move legality
+/// checks or capture detection, should prefer these methods. Stone groups in
+/// atari are kept in an index that is maintained incrementally, so capture
+/// detection and queries such as stonesInAtariWithColor:() are lookups.
+///
+///
+/// @par Territory maps
+///
+/// territoryMapWithScoringSystem:() uses the territory kernel of GoBoardCore
+/// to calculate the territory of both colors for the current stone group
+/// states. The result is a territory map with one byte per intersection, in
+/// the same order as a board snapshot. indexOfPoint:() returns the position
+/// of an intersection in the map. The bits of each byte are described by the
+/// enumeration #GoTerritoryMapEntry.
+///
+/// stonesInSeki() uses the local seki analysis of GoBoardCore to find the
+/// stone groups that are in seki, so that GoScore can mark them before the
+/// territory is calculated.
+///
+///
+/// @par Territory statistics
+///
+/// accumulateTerritoryStatisticsScores:lastMovePoint:zobristHash:previousZobristHash:()
+/// carries the territory statistics scores reported by the GTP engine from one
+/// board position to the next, so that the player influence display remains
+/// stable. The accumulated scores are stored in GoPoint objects.
 // -----------------------------------------------------------------------------
 @interface GoBoard : NSObject <NSSecureCoding>
 {
@@ -46,15 +91,68 @@
 + (NSString*) stringForSize:(enum GoBoardSize)size;
 - (NSEnumerator*) pointEnumerator;
 - (GoPoint*) pointAtVertex:(NSString*)vertex;
+- (GoPoint*) pointAtNumericVertex:(struct GoVertexNumeric)numericVertex;
+- (GoPoint*) pointAtIndex:(int)index;
 - (GoPoint*) neighbourOf:(GoPoint*)point inDirection:(enum GoBoardDirection)direction;
 - (GoPoint*) pointAtCorner:(enum GoBoardCorner)corner;
 
+/// @name Board state queries
+//@{
+- (void) updateStoneStateAtPoint:(GoPoint*)point;
+- (int) numberOfEmptyNeighboursOfPoint:(GoPoint*)point;
+- (int) numberOfLibertiesOfStoneGroupAtPoint:(GoPoint*)point;
+- (int) numberOfStonesWithColor:(enum GoColor)color;
+- (NSArray*) stonesCapturedByStoneWithColor:(enum GoColor)color atPoint:(GoPoint*)point;
+- (bool) areStones:(NSArray*)stones capturedByStoneWithColor:(enum GoColor)color atPoint:(GoPoint*)point;
+- (bool) isSuicideMoveAtPoint:(GoPoint*)point
+                      byColor:(enum GoColor)color
+           simpleKoIsPossible:(bool*)simpleKoIsPossible;
+- (NSArray*) stonesWithoutLiberties;
+- (NSArray*) stonesInAtariWithColor:(enum GoColor)color;
+- (NSArray*) stonesWithColor:(enum GoColor)color inAtariWithLibertyAtPoint:(GoPoint*)point;
+//@}
+
+/// @name Board snapshots
+//@{
+- (NSData*) stoneStateSnapshot;
+- (void) restoreStoneStateSnapshot:(NSData*)snapshot;
+- (int) indexOfPoint:(GoPoint*)point;
+//@}
+
+/// @name Zobrist hashes
+//@{
+- (long long) canonicalZobristHashWithSymmetry:(enum GoBoardSymmetry*)symmetry;
+//@}
+
+/// @name Territory maps
+//@{
+- (NSData*) territoryMapWithScoringSystem:(enum GoScoringSystem)scoringSystem;
+- (NSArray*) stonesInSeki;
+//@}
+
+/// @name Territory statistics
+//@{
+- (void) accumulateTerritoryStatisticsScores:(const float*)scores
+                               lastMovePoint:(GoPoint*)lastMovePoint
+                                 zobristHash:(long long)zobristHash
+                         previousZobristHash:(long long)previousZobristHash;
+- (void) resetTerritoryStatisticsScores;
+//@}
+
+/// @name Tactical reading
+//@{
+- (bool) isStoneGroupAtPointCapturableInLadder:(GoPoint*)point;
+- (NSArray*) capturableStonesWithNextMoveColor:(enum GoColor)color;
+//@}
+
 /// @brief The board size, specifying the horizontal and vertical board
 /// dimensions.
 @property(nonatomic, assign, readonly) enum GoBoardSize size;
 /// @brief A list of GoPoint objects that refer to the star points for the
 /// current board size. The list has no particular order.
 @property(nonatomic, retain, readonly) NSArray* starPoints;
+/// @brief The shared GoBoardTopology object for the board size.
+@property(nonatomic, retain, readonly) GoBoardTopology* topology;
 /// @brief A list of all GoBoardRegion objects on this board. The list has no
 /// particular order.
 @property(nonatomic, assign, readonly) NSArray* regions;
@@ -0,0 +1,1037 @@
+// -----------------------------------------------------------------------------
+// Copyright 2011-2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @defgroup go Go module
+///
+/// Classes in this module directly relate to an aspect of the actual Go game
+/// (e.g. GoBoard represents the Go board).
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoBoard.h"
+#import "GoBoardCore.h"
+#import "GoBoardRegion.h"
+#import "GoBoardTopology.h"
+#import "GoOwnershipAccumulator.h"
+#import "GoTacticalReader.h"
+#import "GoPoint.h"
+#import "GoUtilities.h"
+#import "GoVertex.h"
+#import "GoZobristTable.h"
+#import "../main/ApplicationDelegate.h"
+#import "../newgame/NewGameModel.h"
+
+// C++ standard library
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoBoard.
+// -----------------------------------------------------------------------------
+@interface GoBoard()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign) GoBoardCore* boardCore;
+@property(nonatomic, assign) GoPoint** pointsByIndex;
+/// @brief Accumulates territory statistics scores across board positions.
+/// Is created when it is needed for the first time.
+@property(nonatomic, assign) GoOwnershipAccumulator* ownershipAccumulator;
+/// @brief #GoBoardSymmetryMax symmetry hashes that are kept up-to-date
+/// incrementally as stones are added to or removed from the board.
+@property(nonatomic, assign) long long* symmetryHashes;
+@property(nonatomic, assign, readwrite) enum GoBoardSize size;
+@property(nonatomic, retain, readwrite) NSArray* starPoints;
+@property(nonatomic, retain, readwrite) GoBoardTopology* topology;
+@property(nonatomic, retain, readwrite) GoZobristTable* zobristTable;
+//@}
+@end
+
+
+@implementation GoBoard
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GoBoard instance which uses the
+/// "New Game" default board size.
+// -----------------------------------------------------------------------------
++ (GoBoard*) boardWithDefaultSize
+{
+  NewGameModel* model = [ApplicationDelegate sharedDelegate].theNewGameModel;
+  return [GoBoard boardWithSize:model.boardSize];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GoBoard instance of size @a size.
+///
+/// Raises an @e NSInvalidArgumentException if @a size is #GoBoardSizeUndefined
+/// or otherwise invalid.
+// -----------------------------------------------------------------------------
++ (GoBoard*) boardWithSize:(enum GoBoardSize)size;
+{
+  switch (size)
+  {
+    case GoBoardSize7:
+    case GoBoardSize9:
+    case GoBoardSize11:
+    case GoBoardSize13:
+    case GoBoardSize15:
+    case GoBoardSize17:
+    case GoBoardSize19:
+    {
+      break;
+    }
+    case GoBoardSizeUndefined:
+    default:
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Board size %d is invalid", size];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+  }
+
+  GoBoard* board = [[GoBoard alloc] initWithSize:size];
+  if (board)
+    [board autorelease];
+  return board;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a string representation of @a size that is suitable
+/// for displaying in the UI.
+///
+/// Returns the string "Undefined" if @a size is #GoBoardSizeUndefined.
+/// 
+/// Raises an @e NSInvalidArgumentException if @a size is otherwise invalid.
+// -----------------------------------------------------------------------------
++ (NSString*) stringForSize:(enum GoBoardSize)size
+{
+  switch (size)
+  {
+    case GoBoardSize7:
+    case GoBoardSize9:
+    case GoBoardSize11:
+    case GoBoardSize13:
+    case GoBoardSize15:
+    case GoBoardSize17:
+    case GoBoardSize19:
+    {
+      return [NSString stringWithFormat:@"%d", size];
+    }
+    case GoBoardSizeUndefined:
+    {
+      return @"Undefined";
+    }
+    default:
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Board size %d is invalid", size];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoBoard object with size @a boardSize.
+///
+/// @note This is the designated initializer of GoBoard.
+// -----------------------------------------------------------------------------
+- (id) initWithSize:(enum GoBoardSize)boardSize
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.size = boardSize;
+  m_vertexDict = [[NSMutableDictionary dictionary] retain];
+  self.starPoints = nil;
+  self.topology = [GoBoardTopology sharedTopologyForBoardSize:self.size];
+  self.zobristTable = [GoZobristTable sharedZobristTableForBoardSize:self.size];
+  // Must be created before the GoPoint objects because the GoPoint objects
+  // report their stone state to the board core while they are initialized
+  _boardCore = new GoBoardCore(self.size);
+  _pointsByIndex = nullptr;
+  _symmetryHashes = new long long[GoBoardSymmetryMax]();
+  _ownershipAccumulator = nullptr;
+
+  [self setupBoard];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief NSCoding protocol method.
+// -----------------------------------------------------------------------------
+- (id) initWithCoder:(NSCoder*)decoder
+{
+  self = [super init];
+  if (! self)
+    return nil;
+
+  if ([decoder decodeIntForKey:nscodingVersionKey] != nscodingVersion)
+    return nil;
+
+  self.size = [decoder decodeIntForKey:goBoardSizeKey];
+  m_vertexDict = [[decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSString class], [GoPoint class]]] forKey:goBoardVertexDictKey] retain];
+  self.starPoints = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSArray class], [GoPoint class]]] forKey:goBoardStarPointsKey];
+  self.topology = [GoBoardTopology sharedTopologyForBoardSize:self.size];
+  self.zobristTable = [GoZobristTable sharedZobristTableForBoardSize:self.size];
+  // The board core was not archived, we rebuild it from the GoPoint objects.
+  // GoPoint objects that were unarchived above could not report their stone
+  // state because the board core did not exist yet.
+  _boardCore = new GoBoardCore(self.size);
+  _pointsByIndex = nullptr;
+  _symmetryHashes = new long long[GoBoardSymmetryMax]();
+  _ownershipAccumulator = nullptr;
+  [self setupPointsByIndex];
+  for (GoPoint* point in [m_vertexDict allValues])
+    [self updateStoneStateAtPoint:point];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief NSSecureCoding protocol method.
+// -----------------------------------------------------------------------------
++ (BOOL) supportsSecureCoding
+{
+  return YES;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoBoard object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  // Trigger the breaking of retain cycles in all GoPoint objects
+  // TODO: Obviously, it would be nicer if we didn't have any retain cycles to
+  // worry about...
+  for (GoPoint* point in [m_vertexDict allValues])
+    [point prepareForDealloc];
+  [m_vertexDict release];
+  self.starPoints = nil;
+  self.topology = nil;
+  self.zobristTable = nil;
+  delete _boardCore;
+  _boardCore = nullptr;
+  delete[] _pointsByIndex;
+  _pointsByIndex = nullptr;
+  delete[] _symmetryHashes;
+  _symmetryHashes = nullptr;
+  delete _ownershipAccumulator;
+  _ownershipAccumulator = nullptr;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Sets up this GoBoard.
+///
+/// This is an internal helper invoked during initialization.
+// -----------------------------------------------------------------------------
+- (void) setupBoard
+{
+  // Order of invocation is important
+  [self setupGoPoints];
+  [self setupStarPoints];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Creates all GoPoint objects that belong to a single GoBoardRegion,
+/// and the lookup table that maps board core indexes to GoPoint objects.
+///
+/// The GoPoint objects share the immutable GoVertex objects of the board
+/// topology, so the only thing that is created here is per-game stone state.
+///
+/// This is an internal helper invoked during initialization.
+// -----------------------------------------------------------------------------
+- (void) setupGoPoints
+{
+  int numberOfPoints = _topology.numberOfPoints;
+  delete[] _pointsByIndex;
+  _pointsByIndex = new GoPoint*[numberOfPoints];
+
+  // On a clear board, the initial region contains all GoPoint objects
+  GoBoardRegion* region = [GoBoardRegion region];
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    GoVertex* vertex = [_topology vertexAtIndex:index];
+    GoPoint* point = [GoPoint pointAtVertex:vertex onBoard:self];
+    [m_vertexDict setObject:point forKey:vertex.string];
+    _pointsByIndex[index] = point;
+    [region addPoint:point];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Creates the lookup table that maps board core indexes to GoPoint
+/// objects. The table does not retain the GoPoint objects, they are retained
+/// by m_vertexDict.
+///
+/// This is an internal helper invoked during initialization.
+// -----------------------------------------------------------------------------
+- (void) setupPointsByIndex
+{
+  delete[] _pointsByIndex;
+  _pointsByIndex = new GoPoint*[_boardCore->getNumberOfPoints()];
+  for (GoPoint* point in [m_vertexDict allValues])
+    _pointsByIndex[[self indexOfPoint:point]] = point;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Determines all GoPoint objects that are star points. The star
+/// points are defined by the board topology.
+///
+/// This is an internal helper invoked during initialization.
+// -----------------------------------------------------------------------------
+- (void) setupStarPoints
+{
+  NSMutableArray* starPointsLocal = [NSMutableArray arrayWithCapacity:_topology.starPointIndexes.count];
+  for (NSNumber* starPointIndex in _topology.starPointIndexes)
+  {
+    GoPoint* starPoint = _pointsByIndex[starPointIndex.intValue];
+    starPoint.starPoint = true;
+    [starPointsLocal addObject:starPoint];
+  }
+  // Make a copy that is immutable because we hand out references to the
+  // array, and we don't want clients to be able to change the array
+  self.starPoints = [NSArray arrayWithArray:starPointsLocal];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a description for this GoBoard object.
+///
+/// This method is invoked when GoBoard needs to be represented as a string,
+/// i.e. by NSLog, or when the debugger command "po" is used on the object.
+// -----------------------------------------------------------------------------
+- (NSString*) description
+{
+  // Don't use self to access properties to avoid unnecessary overhead during
+  // debugging
+  return [NSString stringWithFormat:@"GoBoard(%p): size = %d", self, _size];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an enumerator that can be used to iterate over all existing
+/// GoPoint objects
+///
+/// @todo Remove this method, clients should instead use GoPoint::next() or
+/// GoPoint::previous() for iteration.
+// -----------------------------------------------------------------------------
+- (NSEnumerator*) pointEnumerator
+{
+  // The value array including the enumerator will be destroyed as soon as
+  // the current execution path finishes
+  return [[m_vertexDict allValues] objectEnumerator];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint object located at @a vertex. Returns @e nil if
+/// no such GoPoint exists (can happen only if the vertex is invalid or outside
+/// the board size boundaries).
+///
+/// See the GoVertex class documentation for a discussion of what a vertex is.
+///
+/// Raises an @e NSInvalidArgumentException if @a stringValue is nil.
+// -----------------------------------------------------------------------------
+- (GoPoint*) pointAtVertex:(NSString*)vertex
+{
+  if (! vertex)
+  {
+    NSString* errorMessage = @"String vertex is nil";
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  return [m_vertexDict objectForKey:[vertex uppercaseString]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint object located at the intersection identified
+/// by @a numericVertex. Returns nil if @a numericVertex is outside the board.
+///
+/// This is faster than pointAtVertex:() because no vertex string needs to be
+/// created and looked up. Clients that already have numeric vertex data, e.g.
+/// from parsing a GTP response, should prefer this method.
+// -----------------------------------------------------------------------------
+- (GoPoint*) pointAtNumericVertex:(struct GoVertexNumeric)numericVertex
+{
+  if (numericVertex.x < 1 || numericVertex.x > _size || numericVertex.y < 1 || numericVertex.y > _size)
+    return nil;
+  return _pointsByIndex[_boardCore->getIndexOfVertex(numericVertex.x, numericVertex.y)];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint object whose index in a board snapshot is
+/// @a index (see indexOfPoint:()). Returns nil if @a index is outside the
+/// board.
+///
+/// This is the fastest way to look up a GoPoint object. Clients that iterate
+/// over a board snapshot or a territory map should prefer this method.
+// -----------------------------------------------------------------------------
+- (GoPoint*) pointAtIndex:(int)index
+{
+  if (index < 0 || index >= _boardCore->getNumberOfPoints())
+    return nil;
+  return _pointsByIndex[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint object that is a direct neighbour of @a point
+/// located in direction @a direction.
+///
+/// Returns nil if no neighbour exists in the specified direction. For instance,
+/// if @a point is at the left edge of the board, it has no left neighbour,
+/// which will cause a nil value to be returned.
+///
+/// @note #GoBoardDirectionNext and #GoBoardDirectionPrevious are intended to
+/// iterate over all existing GoPoint objects.
+///
+/// @internal This is the backend for the GoPoint directional properties (e.g.
+/// GoPoint::left()).
+// -----------------------------------------------------------------------------
+- (GoPoint*) neighbourOf:(GoPoint*)point inDirection:(enum GoBoardDirection)direction
+{
+  int neighbourIndex = [_topology indexOfNeighbourOfIndex:[self indexOfPoint:point] inDirection:direction];
+  if (neighbourIndex < 0)
+    return nil;
+  return _pointsByIndex[neighbourIndex];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint object located at the corner of the board
+/// defined by @a corner.
+// -----------------------------------------------------------------------------
+- (GoPoint*) pointAtCorner:(enum GoBoardCorner)corner
+{
+  return _pointsByIndex[[_topology indexOfCorner:corner]];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSArray*) regions
+{
+  NSMutableArray* regionList = [NSMutableArray arrayWithCapacity:0];
+  GoPoint* point = [self pointAtVertex:@"A1"];
+  for (; point != nil; point = point.next)
+  {
+    GoBoardRegion* region = point.region;
+    if (! [regionList containsObject:region])
+      [regionList addObject:region];
+  }
+  return regionList;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Synchronizes the internal board state representation with the
+/// current value of the @e stoneState property of @a point.
+///
+/// This method is invoked by GoPoint every time that its @e stoneState property
+/// changes. Clients should never need to invoke this method.
+///
+/// The symmetry hashes that back canonicalZobristHashWithSymmetry:() are
+/// updated here as well.
+// -----------------------------------------------------------------------------
+- (void) updateStoneStateAtPoint:(GoPoint*)point
+{
+  // The board core does not exist yet while GoPoint objects are unarchived
+  if (! _boardCore)
+    return;
+
+  int index = [self indexOfPoint:point];
+  enum GoColor oldStoneState = static_cast<enum GoColor>(_boardCore->getStoneState(index));
+  enum GoColor newStoneState = point.stoneState;
+  if (oldStoneState == newStoneState)
+    return;
+
+  _boardCore->setStoneState(index, static_cast<GoBoardCore::StoneState>(newStoneState));
+  [_zobristTable updateSymmetryHashes:_symmetryHashes forStoneAtIndex:index withColor:oldStoneState];
+  [_zobristTable updateSymmetryHashes:_symmetryHashes forStoneAtIndex:index withColor:newStoneState];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the canonical Zobrist hash of the current board position.
+/// The canonical Zobrist hash is the same for all board positions that are
+/// rotations or reflections of each other. Clients can use it to recognize
+/// the same board position regardless of the board orientation.
+///
+/// If @a symmetry is not NULL, this method fills the out variable with the
+/// board symmetry that transforms the current board position into the
+/// canonical board position. Clients can use GoBoardTopology to transform
+/// intersections between the two board positions.
+///
+/// This method is cheap because the symmetry hashes are kept up-to-date
+/// incrementally. It only considers the stones on the board, not the side to
+/// move or the ko state.
+// -----------------------------------------------------------------------------
+- (long long) canonicalZobristHashWithSymmetry:(enum GoBoardSymmetry*)symmetry
+{
+  return [GoZobristTable canonicalHashForSymmetryHashes:_symmetryHashes symmetry:symmetry];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of direct neighbours of @a point that are not
+/// occupied by a stone.
+// -----------------------------------------------------------------------------
+- (int) numberOfEmptyNeighboursOfPoint:(GoPoint*)point
+{
+  return _boardCore->getNumberOfEmptyNeighbours([self indexOfPoint:point]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of liberties of the stone group that the stone
+/// on @a point belongs to. Returns 0 if @a point is not occupied by a stone.
+// -----------------------------------------------------------------------------
+- (int) numberOfLibertiesOfStoneGroupAtPoint:(GoPoint*)point
+{
+  return _boardCore->getNumberOfLiberties([self indexOfPoint:point]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of stones with color @a color that are currently
+/// on the board.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (int) numberOfStonesWithColor:(enum GoColor)color
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+  return _boardCore->getNumberOfStones(static_cast<GoBoardCore::StoneState>(color));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects of all stone groups that are captured
+/// when a stone of color @a color is placed on @a point. The array is empty if
+/// no stones are captured. The array has no particular order and contains no
+/// duplicates.
+///
+/// This method can be invoked both before and after the stone is actually
+/// placed on @a point.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (NSArray*) stonesCapturedByStoneWithColor:(enum GoColor)color atPoint:(GoPoint*)point
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+
+  std::vector<int> capturedStones;
+  _boardCore->getStonesCapturedByStone([self indexOfPoint:point],
+                                       static_cast<GoBoardCore::StoneState>(color),
+                                       capturedStones);
+
+  NSMutableArray* capturedPoints = [NSMutableArray arrayWithCapacity:capturedStones.size()];
+  for (int index : capturedStones)
+    [capturedPoints addObject:_pointsByIndex[index]];
+  return capturedPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a stones, an array of GoPoint objects, contains
+/// exactly those intersections whose stones are captured when a stone of color
+/// @a color is placed on @a point. Returns false otherwise.
+///
+/// If @a stones is empty, this method returns true if placing the stone does
+/// not capture anything.
+///
+/// This method can be invoked both before and after the stone is actually
+/// placed on @a point. Unlike stonesCapturedByStoneWithColor:atPoint:() this
+/// method does not create any objects, it is therefore suitable for checking
+/// a known result (e.g. when a move is redone) on a hot path.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (bool) areStones:(NSArray*)stones capturedByStoneWithColor:(enum GoColor)color atPoint:(GoPoint*)point
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+
+  GoBoardCore::PointSet capturedStones;
+  _boardCore->getStonesCapturedByStone([self indexOfPoint:point],
+                                       static_cast<GoBoardCore::StoneState>(color),
+                                       capturedStones);
+
+  // Fast path for the most common case, a move that does not capture
+  // anything
+  if (stones.count != capturedStones.count())
+    return false;
+
+  for (GoPoint* stone in stones)
+  {
+    if (! capturedStones.test([self indexOfPoint:stone]))
+      return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if placing a stone of color @a color on the empty
+/// intersection @a point would be a suicide. Ko is not taken into account.
+///
+/// If this method returns false, it also fills the out parameter
+/// @a simpleKoIsPossible with true or false to indicate whether the move could
+/// possibly be a simple ko. If this method returns true, the value of
+/// @a simpleKoIsPossible is undefined.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (bool) isSuicideMoveAtPoint:(GoPoint*)point
+                      byColor:(enum GoColor)color
+           simpleKoIsPossible:(bool*)simpleKoIsPossible
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+
+  return _boardCore->isSuicide([self indexOfPoint:point],
+                               static_cast<GoBoardCore::StoneState>(color),
+                               simpleKoIsPossible);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects of all stones whose stone group has no
+/// liberties. The array is empty if there are no such stones. The array is
+/// sorted in the same order in which GoPoint objects are iterated via
+/// GoPoint::next().
+///
+/// Stones without liberties cannot occur during normal play, only during board
+/// setup. The result is maintained incrementally by the board core, invoking
+/// this method after each setup change is therefore cheap.
+// -----------------------------------------------------------------------------
+- (NSArray*) stonesWithoutLiberties
+{
+  const GoBoardCore::PointSet& stonesWithoutLiberties = _boardCore->getStonesWithoutLiberties();
+
+  NSMutableArray* stones = [NSMutableArray arrayWithCapacity:stonesWithoutLiberties.count()];
+  if (stonesWithoutLiberties.none())
+    return stones;
+
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (stonesWithoutLiberties.test(index))
+      [stones addObject:_pointsByIndex[index]];
+  }
+  return stones;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects of all stones with color @a color whose
+/// stone group has exactly one liberty, i.e. that are in atari. The array is
+/// empty if there are no such stones. The array is sorted in the same order in
+/// which GoPoint objects are iterated via GoPoint::next().
+///
+/// The board core maintains an atari index incrementally, invoking this method
+/// after each move is therefore cheap.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (NSArray*) stonesInAtariWithColor:(enum GoColor)color
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+
+  GoBoardCore::PointSet stonesInAtari = _boardCore->getStonesInAtari(static_cast<GoBoardCore::StoneState>(color));
+
+  NSMutableArray* stones = [NSMutableArray arrayWithCapacity:stonesInAtari.count()];
+  if (stonesInAtari.none())
+    return stones;
+
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (stonesInAtari.test(index))
+      [stones addObject:_pointsByIndex[index]];
+  }
+  return stones;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects of all stone groups with color @a color
+/// whose single liberty is the empty intersection @a point. The array is empty
+/// if no such stone groups exist. The array is sorted in the same order in
+/// which GoPoint objects are iterated via GoPoint::next().
+///
+/// The stone groups are looked up in the atari index of the board core, no
+/// liberties need to be counted.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (NSArray*) stonesWithColor:(enum GoColor)color inAtariWithLibertyAtPoint:(GoPoint*)point
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+
+  GoBoardCore::PointSet stonesInAtari;
+  _boardCore->getStonesInAtariWithLibertyAt([self indexOfPoint:point],
+                                            static_cast<GoBoardCore::StoneState>(color),
+                                            stonesInAtari);
+
+  NSMutableArray* stones = [NSMutableArray arrayWithCapacity:stonesInAtari.count()];
+  if (stonesInAtari.none())
+    return stones;
+
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (stonesInAtari.test(index))
+      [stones addObject:_pointsByIndex[index]];
+  }
+  return stones;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a compact snapshot of the stone state of all intersections on
+/// the board. The snapshot can later be passed to restoreStoneStateSnapshot:()
+/// to bring the board back to the current state.
+///
+/// The snapshot contains one byte per intersection, in the same order in which
+/// GoPoint objects are iterated via GoPoint::next(). Each byte holds a value
+/// of the enumeration #GoColor.
+// -----------------------------------------------------------------------------
+- (NSData*) stoneStateSnapshot
+{
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  NSMutableData* snapshot = [NSMutableData dataWithLength:numberOfPoints];
+  unsigned char* stoneStates = static_cast<unsigned char*>(snapshot.mutableBytes);
+  for (int index = 0; index < numberOfPoints; ++index)
+    stoneStates[index] = static_cast<unsigned char>(_boardCore->getStoneState(index));
+  return snapshot;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Changes the stone state of all intersections on the board to the
+/// values in @a snapshot, which must have been obtained from
+/// stoneStateSnapshot(). GoBoardRegion objects are updated as a side-effect.
+///
+/// Only intersections whose stone state differs from the snapshot are touched.
+/// Restoring a snapshot of a board position that is close to the current board
+/// position is therefore cheap. @a snapshot may contain additional bytes after
+/// the bytes for the intersections, these are ignored.
+///
+/// Raises an @e NSInvalidArgumentException if @a snapshot is too short for the
+/// size of this GoBoard.
+// -----------------------------------------------------------------------------
+- (void) restoreStoneStateSnapshot:(NSData*)snapshot
+{
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  if (snapshot.length < numberOfPoints)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Snapshot length %lu is too short for %d intersections", (unsigned long)snapshot.length, numberOfPoints];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  const unsigned char* stoneStates = static_cast<const unsigned char*>(snapshot.bytes);
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    enum GoColor stoneState = static_cast<enum GoColor>(stoneStates[index]);
+    if (stoneState == static_cast<enum GoColor>(_boardCore->getStoneState(index)))
+      continue;
+
+    // Same approach as board setup: Each intersection that changes is moved
+    // to a new region individually
+    GoPoint* point = _pointsByIndex[index];
+    point.stoneState = stoneState;
+    [GoUtilities movePointToNewRegion:point];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a territory map for the current board position. Stone group
+/// states are taken from the @e stoneGroupState property of GoBoardRegion
+/// objects. @a scoringSystem decides whether stones in seki count as territory.
+///
+/// The territory map contains one byte per intersection, in the same order as
+/// the snapshot returned by stoneStateSnapshot(). Each byte holds a #GoColor
+/// value that identifies the owner of the intersection, possibly combined with
+/// #GoTerritoryMapEntryInconsistentFlag. See the enumeration
+/// #GoTerritoryMapEntry for details.
+///
+/// This method performs a full territory calculation with GoBoardCore's
+/// territory kernel. It does not read or modify the territory information
+/// stored in GoBoardRegion objects.
+// -----------------------------------------------------------------------------
+- (NSData*) territoryMapWithScoringSystem:(enum GoScoringSystem)scoringSystem
+{
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+
+  GoBoardCore::PointSet deadStones;
+  GoBoardCore::PointSet sekiStones;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! _boardCore->hasStone(index))
+      continue;
+    switch (_pointsByIndex[index].region.stoneGroupState)
+    {
+      case GoStoneGroupStateDead:
+        deadStones.set(index);
+        break;
+      case GoStoneGroupStateSeki:
+        sekiStones.set(index);
+        break;
+      default:
+        break;
+    }
+  }
+
+  GoBoardCore::TerritoryResult territoryResult;
+  _boardCore->calculateTerritory(deadStones,
+                                 sekiStones,
+                                 GoScoringSystemAreaScoring == scoringSystem,
+                                 territoryResult);
+
+  NSMutableData* territoryMap = [NSMutableData dataWithLength:numberOfPoints];
+  unsigned char* territoryMapEntries = static_cast<unsigned char*>(territoryMap.mutableBytes);
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (territoryResult.blackTerritory.test(index))
+      territoryMapEntries[index] = GoColorBlack;
+    else if (territoryResult.whiteTerritory.test(index))
+      territoryMapEntries[index] = GoColorWhite;
+    else if (territoryResult.inconsistentTerritory.test(index))
+      territoryMapEntries[index] = GoColorNone | GoTerritoryMapEntryInconsistentFlag;
+    else
+      territoryMapEntries[index] = GoColorNone;
+  }
+  return territoryMap;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects of all stones that are in seki. The
+/// array is empty if there are no such stones. The array is sorted in the same
+/// order in which GoPoint objects are iterated via GoPoint::next().
+///
+/// Stones whose GoBoardRegion has the stone group state
+/// #GoStoneGroupStateDead are treated as if they had already been captured.
+/// All other stone group states are ignored, i.e. a stone group that is
+/// currently marked as alive can be found to be in seki. See
+/// GoBoardCore::findSekiStones() for the details of the analysis.
+// -----------------------------------------------------------------------------
+- (NSArray*) stonesInSeki
+{
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+
+  GoBoardCore::PointSet deadStones;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (_boardCore->hasStone(index) && GoStoneGroupStateDead == _pointsByIndex[index].region.stoneGroupState)
+      deadStones.set(index);
+  }
+
+  GoBoardCore::PointSet sekiStones;
+  _boardCore->findSekiStones(deadStones, sekiStones);
+
+  NSMutableArray* stones = [NSMutableArray arrayWithCapacity:sekiStones.count()];
+  if (sekiStones.none())
+    return stones;
+
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (sekiStones.test(index))
+      [stones addObject:_pointsByIndex[index]];
+  }
+  return stones;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Blends the territory statistics scores in @a scores into the scores
+/// that were accumulated for previous board positions, and stores the result
+/// in the @e territoryStatisticsScore property of all GoPoint objects.
+///
+/// @a scores must contain one score per intersection, in the same order as
+/// the snapshot returned by stoneStateSnapshot(). @a lastMovePoint is the
+/// GoPoint of the move that led to the board position that @a scores describe,
+/// or nil if there is no such move. @a zobristHash identifies that board
+/// position, @a previousZobristHash the board position before it. See
+/// GoOwnershipAccumulator for details.
+// -----------------------------------------------------------------------------
+- (void) accumulateTerritoryStatisticsScores:(const float*)scores
+                               lastMovePoint:(GoPoint*)lastMovePoint
+                                 zobristHash:(long long)zobristHash
+                         previousZobristHash:(long long)previousZobristHash
+{
+  if (! _ownershipAccumulator)
+  {
+    _ownershipAccumulator = new GoOwnershipAccumulator(self.size,
+                                                       territoryStatisticsReweightRadius,
+                                                       territoryStatisticsPriorWeight);
+  }
+
+  int lastMoveIndex = lastMovePoint ? [self indexOfPoint:lastMovePoint] : -1;
+  _ownershipAccumulator->accumulate(scores, lastMoveIndex, zobristHash, previousZobristHash);
+
+  const float* accumulatedScores = _ownershipAccumulator->getScores();
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+    _pointsByIndex[index].territoryStatisticsScore = accumulatedScores[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the territory statistics scores that were accumulated by
+/// accumulateTerritoryStatisticsScores:lastMovePoint:zobristHash:previousZobristHash:()
+/// and sets the @e territoryStatisticsScore property of all GoPoint objects to
+/// zero.
+// -----------------------------------------------------------------------------
+- (void) resetTerritoryStatisticsScores
+{
+  if (_ownershipAccumulator)
+    _ownershipAccumulator->reset();
+
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+    _pointsByIndex[index].territoryStatisticsScore = 0.0f;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the stone group at @a point can be captured in a
+/// ladder when the opponent of the stone group is to move. Returns false if
+/// the stone group escapes, or if GoTacticalReader exhausts its node budget
+/// of #tacticalReaderNodeBudget nodes before it can prove the capture.
+///
+/// Raises an @e NSInvalidArgumentException if @a point is not occupied by a
+/// stone.
+// -----------------------------------------------------------------------------
+- (bool) isStoneGroupAtPointCapturableInLadder:(GoPoint*)point
+{
+  if (! point.hasStone)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Point %@ is not occupied by a stone", point.vertex.string];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  enum GoColor attackerColor = [GoUtilities alternatingColorForColor:point.stoneState];
+  GoTacticalReader tacticalReader(*_boardCore, tacticalReaderNodeBudget);
+  GoTacticalReader::Result result = tacticalReader.readLadder([self indexOfPoint:point],
+                                                              static_cast<GoBoardCore::StoneState>(attackerColor),
+                                                              nullptr);
+  return (GoTacticalReader::ResultCaptured == result);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects of all stones whose stone group can be
+/// captured if the side with color @a color is to move. Stone groups of both
+/// colors are included: Stone groups of the opponent of @a color can be
+/// captured by @a color, stone groups of @a color cannot be saved by
+/// @a color. The array is empty if there are no such stones. The array is
+/// sorted in the same order in which GoPoint objects are iterated via
+/// GoPoint::next().
+///
+/// Only stone groups with one or two liberties are examined. For each of them
+/// GoTacticalReader performs a capture search with a node budget of
+/// #tacticalReaderNodeBudget nodes. Stone groups for which the search
+/// exhausts its node budget are not included.
+///
+/// Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (NSArray*) capturableStonesWithNextMoveColor:(enum GoColor)color
+{
+  [self throwIfColorIsNotBlackOrWhite:color];
+
+  GoTacticalReader tacticalReader(*_boardCore, tacticalReaderNodeBudget);
+  GoBoardCore::PointSet examinedStones;
+  GoBoardCore::PointSet capturableStones;
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! _boardCore->hasStone(index) || examinedStones.test(index))
+      continue;
+
+    GoBoardCore::PointSet stoneGroup;
+    GoBoardCore::PointSet liberties;
+    _boardCore->getStoneGroupAndLiberties(index, stoneGroup, liberties);
+    examinedStones |= stoneGroup;
+    if (liberties.count() > 2)
+      continue;
+
+    GoTacticalReader::Result result = tacticalReader.readCapture(index,
+                                                                 static_cast<GoBoardCore::StoneState>(color),
+                                                                 nullptr);
+    if (GoTacticalReader::ResultCaptured == result)
+      capturableStones |= stoneGroup;
+  }
+
+  NSMutableArray* stones = [NSMutableArray arrayWithCapacity:capturableStones.count()];
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (capturableStones.test(index))
+      [stones addObject:_pointsByIndex[index]];
+  }
+  return stones;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of @a point in a board snapshot (see
+/// stoneStateSnapshot()) or a territory map (see
+/// territoryMapWithScoringSystem:()). The index is also used internally to
+/// address @a point in the board core.
+// -----------------------------------------------------------------------------
+- (int) indexOfPoint:(GoPoint*)point
+{
+  struct GoVertexNumeric numericVertex = point.vertex.numeric;
+  return _boardCore->getIndexOfVertex(numericVertex.x, numericVertex.y);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Raises an @e NSInvalidArgumentException if @a color is neither
+/// #GoColorBlack nor #GoColorWhite.
+///
+/// This is an internal helper.
+// -----------------------------------------------------------------------------
+- (void) throwIfColorIsNotBlackOrWhite:(enum GoColor)color
+{
+  if (color != GoColorBlack && color != GoColorWhite)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Invalid color argument %d", color];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief NSCoding protocol method.
+// -----------------------------------------------------------------------------
+- (void) encodeWithCoder:(NSCoder*)encoder
+{
+  [encoder encodeInt:nscodingVersion forKey:nscodingVersionKey];
+  [encoder encodeInt:self.size forKey:goBoardSizeKey];
+  [encoder encodeObject:m_vertexDict forKey:goBoardVertexDictKey];
+  [encoder encodeObject:self.starPoints forKey:goBoardStarPointsKey];
+}
+
+@end
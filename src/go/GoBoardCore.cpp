@@ -0,0 +1,1029 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoBoardCore.h"
+
+// System includes
+#include <cassert>  // for assert()
+#include <stdexcept>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoBoardCore object for a board of size @a boardSize.
+/// The board is initially empty.
+///
+/// Throws std::invalid_argument if @a boardSize is not one of the board sizes
+/// supported by the application.
+// -----------------------------------------------------------------------------
+GoBoardCore::GoBoardCore(int boardSize) :
+  boardSize(boardSize),
+  numberOfPoints(boardSize * boardSize),
+  neighbourTable(GoBoardCore::getNeighbourTable(boardSize)),
+  blackStones(),
+  whiteStones(),
+  changedPoints(),
+  stonesWithoutLiberties(),
+  stonesInAtari(),
+  atariLiberties(boardSize * boardSize, -1)
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoBoardCore object.
+// -----------------------------------------------------------------------------
+GoBoardCore::~GoBoardCore()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board size.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getBoardSize() const
+{
+  return this->boardSize;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of intersections on the board.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getNumberOfPoints() const
+{
+  return this->numberOfPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection identified by the numeric
+/// vertex coordinates @a x and @a y. Both coordinates are one-based, i.e.
+/// vertex A1 has coordinates x=1 and y=1.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getIndexOfVertex(int x, int y) const
+{
+  assert(x >= 1 && x <= this->boardSize);
+  assert(y >= 1 && y <= this->boardSize);
+  return ((y - 1) * this->boardSize) + (x - 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the neighbours of the intersection with index @a index.
+// -----------------------------------------------------------------------------
+const GoBoardCore::NeighbourList& GoBoardCore::getNeighbours(int index) const
+{
+  return this->neighbourTable[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone state of the intersection with index @a index.
+// -----------------------------------------------------------------------------
+GoBoardCore::StoneState GoBoardCore::getStoneState(int index) const
+{
+  if (this->blackStones.test(index))
+    return StoneStateBlack;
+  else if (this->whiteStones.test(index))
+    return StoneStateWhite;
+  else
+    return StoneStateNone;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Sets the stone state of the intersection with index @a index to
+/// @a stoneState.
+// -----------------------------------------------------------------------------
+void GoBoardCore::setStoneState(int index, StoneState stoneState)
+{
+  if (getStoneState(index) == stoneState)
+    return;
+
+  // A stone group's liberties can only change if a stone is placed or removed
+  // on one of its own intersections or on one of its liberties
+  this->changedPoints.set(index);
+  const NeighbourList& neighbourList = this->neighbourTable[index];
+  for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+    this->changedPoints.set(neighbourList.neighbours[indexOfNeighbour]);
+
+  switch (stoneState)
+  {
+    case StoneStateBlack:
+      this->blackStones.set(index);
+      this->whiteStones.reset(index);
+      break;
+    case StoneStateWhite:
+      this->blackStones.reset(index);
+      this->whiteStones.set(index);
+      break;
+    default:
+      this->blackStones.reset(index);
+      this->whiteStones.reset(index);
+      break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Places a stone of color @a color on the intersection with index
+/// @a index, then removes the opposing stones that the stone captures. If the
+/// stone captures nothing and has no liberties, the stone group that the stone
+/// is part of is removed (suicide).
+///
+/// The game rules are not checked, the caller is responsible for replaying
+/// only moves that were legal when they were played.
+// -----------------------------------------------------------------------------
+void GoBoardCore::playStone(int index, StoneState color)
+{
+  PointSet capturedStones;
+  getStonesCapturedByStone(index, color, capturedStones);
+  setStoneState(index, color);
+
+  if (capturedStones.none())
+  {
+    if (getNumberOfLiberties(index) > 0)
+      return;
+    getStoneGroup(index, capturedStones);
+  }
+
+  for (int indexOfStone = 0; indexOfStone < this->numberOfPoints; ++indexOfStone)
+  {
+    if (capturedStones.test(indexOfStone))
+      setStoneState(indexOfStone, StoneStateNone);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the intersection with index @a index is occupied by
+/// a stone.
+// -----------------------------------------------------------------------------
+bool GoBoardCore::hasStone(int index) const
+{
+  return this->blackStones.test(index) || this->whiteStones.test(index);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the set of intersections that are occupied by stones of
+/// color @a color.
+///
+/// Throws std::invalid_argument if @a color is neither #StoneStateBlack nor
+/// #StoneStateWhite.
+// -----------------------------------------------------------------------------
+const GoBoardCore::PointSet& GoBoardCore::getStones(StoneState color) const
+{
+  switch (color)
+  {
+    case StoneStateBlack:
+      return this->blackStones;
+    case StoneStateWhite:
+      return this->whiteStones;
+    default:
+      throw std::invalid_argument("Color must be either black or white");
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of stones of color @a color that are on the
+/// board.
+///
+/// Throws std::invalid_argument if @a color is neither #StoneStateBlack nor
+/// #StoneStateWhite.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getNumberOfStones(StoneState color) const
+{
+  return static_cast<int>(getStones(color).count());
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of neighbours of the intersection with index
+/// @a index that are not occupied by a stone.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getNumberOfEmptyNeighbours(int index) const
+{
+  const NeighbourList& neighbourList = this->neighbourTable[index];
+  int numberOfEmptyNeighbours = 0;
+  for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+  {
+    if (! hasStone(neighbourList.neighbours[indexOfNeighbour]))
+      numberOfEmptyNeighbours++;
+  }
+  return numberOfEmptyNeighbours;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a stoneGroup with the intersections of the stone group that
+/// the stone on the intersection with index @a index belongs to. @a stoneGroup
+/// is cleared if the intersection is not occupied by a stone.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getStoneGroup(int index, PointSet& stoneGroup) const
+{
+  PointSet liberties;
+  getStoneGroupAndLiberties(index, stoneGroup, liberties);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of liberties of the stone group that the stone
+/// on the intersection with index @a index belongs to. Returns 0 if the
+/// intersection is not occupied by a stone.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getNumberOfLiberties(int index) const
+{
+  PointSet stoneGroup;
+  PointSet liberties;
+  getStoneGroupAndLiberties(index, stoneGroup, liberties);
+  return static_cast<int>(liberties.count());
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a capturedStones with the intersections of all stone groups
+/// that are captured when a stone of color @a color is placed on the
+/// intersection with index @a index. @a capturedStones is cleared before it is
+/// filled.
+///
+/// This method can be invoked both before and after the stone is actually
+/// placed on the board. Before the stone is placed, the captured stone groups
+/// are the opposing stone groups that are in atari with their single liberty
+/// on the intersection with index @a index. After the stone is placed, the
+/// captured stone groups are the adjacent opposing stone groups without
+/// liberties. In both cases the result is looked up in the liberty indexes
+/// (see updateLibertyIndexes()), only the captured stone groups themselves
+/// need to be collected.
+///
+/// This overload does not allocate any memory on the heap.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getStonesCapturedByStone(int index, StoneState color, PointSet& capturedStones)
+{
+  StoneState opponentColor = GoBoardCore::getOpponentColor(color);
+  if (! hasStone(index))
+  {
+    getStonesInAtariWithLibertyAt(index, opponentColor, capturedStones);
+    return;
+  }
+
+  capturedStones.reset();
+  updateLibertyIndexes();
+  const PointSet& opponentStones = getStones(opponentColor);
+  const NeighbourList& neighbourList = this->neighbourTable[index];
+  for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+  {
+    int neighbour = neighbourList.neighbours[indexOfNeighbour];
+    if (! opponentStones.test(neighbour) || ! this->stonesWithoutLiberties.test(neighbour) || capturedStones.test(neighbour))
+      continue;
+
+    PointSet stoneGroup;
+    getStoneGroup(neighbour, stoneGroup);
+    capturedStones |= stoneGroup;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Same as the PointSet overload of getStonesCapturedByStone(), but
+/// appends the indexes of the captured intersections to @a capturedStones in
+/// ascending order. @a capturedStones is not cleared before it is filled.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getStonesCapturedByStone(int index, StoneState color, std::vector<int>& capturedStones)
+{
+  PointSet capturedStoneSet;
+  getStonesCapturedByStone(index, color, capturedStoneSet);
+  if (capturedStoneSet.none())
+    return;
+
+  for (int indexOfStone = 0; indexOfStone < this->numberOfPoints; ++indexOfStone)
+  {
+    if (capturedStoneSet.test(indexOfStone))
+      capturedStones.push_back(indexOfStone);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if placing a stone of color @a color on the empty
+/// intersection with index @a index would be a suicide, i.e. if the stone
+/// itself (or the stone group it becomes part of) would have no liberties and
+/// the stone would not capture any opposing stones. Returns false if the move
+/// would not be a suicide. Ko is not taken into account.
+///
+/// If this method returns false, it also fills the out parameter
+/// @a simpleKoIsPossible with true or false to indicate whether the move could
+/// possibly be a simple ko. A simple ko is possible only if the stone captures
+/// opposing stones, does not have empty neighbours, and is not connected to a
+/// friendly stone group. If this method returns true, the value of
+/// @a simpleKoIsPossible is undefined.
+///
+/// Apart from the immediate neighbourhood of the intersection, this method
+/// only consults the liberty indexes (see updateLibertyIndexes()), it does not
+/// have to determine any stone groups unless stones are captured.
+// -----------------------------------------------------------------------------
+bool GoBoardCore::isSuicide(int index, StoneState color, bool* simpleKoIsPossible)
+{
+  // The intersection has at least one empty neighbour
+  if (getNumberOfEmptyNeighbours(index) > 0)
+  {
+    *simpleKoIsPossible = false;
+    return false;
+  }
+
+  // All neighbours are occupied. Check if we can connect to a friendly stone
+  // group without killing it. The friendly stone group has a liberty on the
+  // intersection, if it is not in atari it has at least one more liberty and
+  // we are sure that we are not killing it.
+  updateLibertyIndexes();
+  const PointSet& friendlyStones = getStones(color);
+  bool hasFriendlyNeighbour = false;
+  const NeighbourList& neighbourList = this->neighbourTable[index];
+  for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+  {
+    int neighbour = neighbourList.neighbours[indexOfNeighbour];
+    if (! friendlyStones.test(neighbour))
+      continue;
+    hasFriendlyNeighbour = true;
+    if (! this->stonesInAtari.test(neighbour))
+    {
+      *simpleKoIsPossible = false;
+      return false;
+    }
+  }
+
+  // Check if we can capture opposing stone groups
+  PointSet capturedStones;
+  getStonesCapturedByStone(index, color, capturedStones);
+  if (capturedStones.any())
+  {
+    *simpleKoIsPossible = ! hasFriendlyNeighbour;
+    return false;
+  }
+
+  // No opposing stones can be captured and there are no friendly groups with
+  // sufficient liberties to connect to
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the set of intersections that are occupied by stones whose
+/// stone group has no liberties. This can only happen during board setup.
+///
+/// The set is part of the liberty indexes, see updateLibertyIndexes().
+// -----------------------------------------------------------------------------
+const GoBoardCore::PointSet& GoBoardCore::getStonesWithoutLiberties()
+{
+  updateLibertyIndexes();
+  return this->stonesWithoutLiberties;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the set of intersections that are occupied by stones of
+/// color @a color whose stone group has exactly one liberty, i.e. that are in
+/// atari.
+///
+/// The set is part of the liberty indexes, see updateLibertyIndexes().
+// -----------------------------------------------------------------------------
+GoBoardCore::PointSet GoBoardCore::getStonesInAtari(StoneState color)
+{
+  updateLibertyIndexes();
+  return this->stonesInAtari & getStones(color);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a stonesInAtari with the intersections of all stone groups
+/// of color @a color whose single liberty is the intersection with index
+/// @a index. @a stonesInAtari is cleared before it is filled.
+///
+/// These are exactly the stone groups that are captured when a stone of the
+/// opposing color is placed on the empty intersection with index @a index.
+/// Only the stone groups adjacent to the intersection are looked up in the
+/// liberty indexes (see updateLibertyIndexes()), no liberties need to be
+/// counted.
+///
+/// This method does not allocate any memory on the heap.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getStonesInAtariWithLibertyAt(int index, StoneState color, PointSet& stonesInAtari)
+{
+  stonesInAtari.reset();
+  updateLibertyIndexes();
+
+  const PointSet& stones = getStones(color);
+  const NeighbourList& neighbourList = this->neighbourTable[index];
+  for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+  {
+    int neighbour = neighbourList.neighbours[indexOfNeighbour];
+    // A stone group with several stones adjacent to the intersection must be
+    // collected only once
+    if (! stones.test(neighbour) || stonesInAtari.test(neighbour))
+      continue;
+    if (! this->stonesInAtari.test(neighbour) || this->atariLiberties[neighbour] != index)
+      continue;
+
+    PointSet stoneGroup;
+    getStoneGroup(neighbour, stoneGroup);
+    stonesInAtari |= stoneGroup;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Brings the liberty indexes up-to-date with the current stone state
+/// of the board.
+///
+/// The liberty indexes are the set of stones without liberties, the set of
+/// stones in atari, and for every stone in atari the index of the single
+/// liberty of its stone group. They are maintained incrementally: Only the
+/// stone groups that contain an intersection whose stone state changed since
+/// the last update, or a neighbour of such an intersection, can have gained or
+/// lost liberties, so only those stone groups are examined. The cost of an
+/// update is therefore proportional to the size of the affected stone groups,
+/// not to the number of stone groups on the board, and there is no cost at
+/// all if nothing changed since the last update.
+// -----------------------------------------------------------------------------
+void GoBoardCore::updateLibertyIndexes()
+{
+  if (this->changedPoints.none())
+    return;
+
+  PointSet examinedStones;
+  PointSet stoneGroup;
+  PointSet liberties;
+  for (int index = 0; index < this->numberOfPoints; ++index)
+  {
+    if (! this->changedPoints.test(index))
+      continue;
+
+    if (! hasStone(index))
+    {
+      this->stonesWithoutLiberties.reset(index);
+      this->stonesInAtari.reset(index);
+      continue;
+    }
+    if (examinedStones.test(index))
+      continue;
+
+    getStoneGroupAndLiberties(index, stoneGroup, liberties);
+    examinedStones |= stoneGroup;
+    if (liberties.none())
+    {
+      this->stonesWithoutLiberties |= stoneGroup;
+      this->stonesInAtari &= ~stoneGroup;
+    }
+    else if (liberties.count() == 1)
+    {
+      this->stonesWithoutLiberties &= ~stoneGroup;
+      this->stonesInAtari |= stoneGroup;
+      int liberty = getFirstIndexInSet(liberties);
+      for (int indexOfStone = 0; indexOfStone < this->numberOfPoints; ++indexOfStone)
+      {
+        if (stoneGroup.test(indexOfStone))
+          this->atariLiberties[indexOfStone] = liberty;
+      }
+    }
+    else
+    {
+      this->stonesWithoutLiberties &= ~stoneGroup;
+      this->stonesInAtari &= ~stoneGroup;
+    }
+  }
+
+  this->changedPoints.reset();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the lowest index in @a pointSet. Returns -1 if @a pointSet
+/// is empty.
+// -----------------------------------------------------------------------------
+int GoBoardCore::getFirstIndexInSet(const PointSet& pointSet) const
+{
+  for (int index = 0; index < this->numberOfPoints; ++index)
+  {
+    if (pointSet.test(index))
+      return index;
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a emptyArea with the empty intersections that are connected
+/// to the empty intersection identified by @a index, and @a adjacentStones
+/// with the intersections of the stones that border on @a emptyArea. Both
+/// sets are empty if the intersection identified by @a index is occupied by
+/// a stone.
+///
+/// This is a scanline flood fill: Each iteration fills an entire horizontal
+/// run of empty intersections, then remembers one seed intersection for each
+/// run of empty intersections in the rows above and below. A run of
+/// intersections is therefore examined only once, and the stack holds at
+/// most two seeds per intersection.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getEmptyArea(int index, PointSet& emptyArea, PointSet& adjacentStones) const
+{
+  getEmptyArea(index, this->blackStones | this->whiteStones, emptyArea, adjacentStones);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Same as the public overload of getEmptyArea(), but the intersections
+/// that are occupied by stones are taken from @a stones instead of from the
+/// board. This allows to examine a board from which some stones have been
+/// removed.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getEmptyArea(int index, const PointSet& stones, PointSet& emptyArea, PointSet& adjacentStones) const
+{
+  emptyArea.reset();
+  adjacentStones.reset();
+
+  if (stones.test(index))
+    return;
+
+  int stack[2 * maximumNumberOfPoints];
+  int stackSize = 0;
+  stack[stackSize++] = index;
+
+  while (stackSize > 0)
+  {
+    int seed = stack[--stackSize];
+    if (emptyArea.test(seed))
+      continue;
+
+    int row = seed / this->boardSize;
+    int firstIndexInRow = row * this->boardSize;
+    int lastIndexInRow = firstIndexInRow + this->boardSize - 1;
+
+    int left = seed;
+    while (left > firstIndexInRow && ! stones.test(left - 1))
+      --left;
+    int right = seed;
+    while (right < lastIndexInRow && ! stones.test(right + 1))
+      ++right;
+    if (left > firstIndexInRow)
+      adjacentStones.set(left - 1);
+    if (right < lastIndexInRow)
+      adjacentStones.set(right + 1);
+    for (int indexInRun = left; indexInRun <= right; ++indexInRun)
+      emptyArea.set(indexInRun);
+
+    // Examine the rows below and above the run
+    for (int rowOffset = -1; rowOffset <= 1; rowOffset += 2)
+    {
+      int neighbourRow = row + rowOffset;
+      if (neighbourRow < 0 || neighbourRow >= this->boardSize)
+        continue;
+      int indexOffset = rowOffset * this->boardSize;
+      bool previousIntersectionIsEmpty = false;
+      for (int indexInRun = left; indexInRun <= right; ++indexInRun)
+      {
+        int neighbour = indexInRun + indexOffset;
+        if (stones.test(neighbour))
+        {
+          adjacentStones.set(neighbour);
+          previousIntersectionIsEmpty = false;
+        }
+        else
+        {
+          // One seed is sufficient for a run of empty intersections
+          if (! previousIntersectionIsEmpty && ! emptyArea.test(neighbour))
+            stack[stackSize++] = neighbour;
+          previousIntersectionIsEmpty = true;
+        }
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Calculates the territory of both colors and stores the result in
+/// @a territoryResult.
+///
+/// @a deadStones and @a sekiStones identify the stones that are dead and in
+/// seki, respectively. All other stones are considered to be alive. Bits for
+/// intersections that are not occupied by a stone are ignored. @a areaScoring
+/// is true if the game uses area scoring, false if it uses territory scoring.
+///
+/// These are the rules, see the GoScore class documentation, paragraph
+/// "Determining territory color", for the reasoning behind them:
+/// - Alive stones belong to the color that played them. Dead stones belong to
+///   the opposing color. Stones in seki belong to the color that played them
+///   under area scoring, and are neutral under territory scoring.
+/// - An empty area belongs to a color if it is bordered only by alive stones
+///   of that color, or only by stones in seki of that color (the latter only
+///   under area scoring), or if it borders on dead stones of the opposing
+///   color and not on dead stones of its own color.
+/// - An empty area is neutral if it borders on stones of both colors that are
+///   alive or in seki, but not on a mix of alive and seki stones.
+/// - Any other combination is an inconsistency.
+// -----------------------------------------------------------------------------
+void GoBoardCore::calculateTerritory(const PointSet& deadStones, const PointSet& sekiStones, bool areaScoring, TerritoryResult& territoryResult) const
+{
+  territoryResult.blackTerritory.reset();
+  territoryResult.whiteTerritory.reset();
+  territoryResult.inconsistentTerritory.reset();
+
+  const PointSet stones = this->blackStones | this->whiteStones;
+  const PointSet dead = deadStones & stones;
+  const PointSet seki = sekiStones & stones & ~dead;
+  const PointSet alive = stones & ~dead & ~seki;
+
+  const PointSet blackAliveStones = this->blackStones & alive;
+  const PointSet whiteAliveStones = this->whiteStones & alive;
+  const PointSet blackDeadStones = this->blackStones & dead;
+  const PointSet whiteDeadStones = this->whiteStones & dead;
+  const PointSet blackSekiStones = this->blackStones & seki;
+  const PointSet whiteSekiStones = this->whiteStones & seki;
+
+  // Stones
+  territoryResult.blackTerritory |= blackAliveStones | whiteDeadStones;
+  territoryResult.whiteTerritory |= whiteAliveStones | blackDeadStones;
+  if (areaScoring)
+  {
+    territoryResult.blackTerritory |= blackSekiStones;
+    territoryResult.whiteTerritory |= whiteSekiStones;
+  }
+
+  // Empty areas
+  PointSet visited = stones;
+  PointSet emptyArea;
+  PointSet adjacentStones;
+  for (int index = 0; index < this->numberOfPoints; ++index)
+  {
+    if (visited.test(index))
+      continue;
+    getEmptyArea(index, emptyArea, adjacentStones);
+    visited |= emptyArea;
+
+    bool blackAliveSeen = (adjacentStones & blackAliveStones).any();
+    bool whiteAliveSeen = (adjacentStones & whiteAliveStones).any();
+    bool blackDeadSeen = (adjacentStones & blackDeadStones).any();
+    bool whiteDeadSeen = (adjacentStones & whiteDeadStones).any();
+    bool blackSekiSeen = (adjacentStones & blackSekiStones).any();
+    bool whiteSekiSeen = (adjacentStones & whiteSekiStones).any();
+    bool aliveSeen = blackAliveSeen || whiteAliveSeen;
+    bool deadSeen = blackDeadSeen || whiteDeadSeen;
+    bool sekiSeen = blackSekiSeen || whiteSekiSeen;
+
+    StoneState territoryColor = StoneStateNone;
+    bool territoryInconsistencyFound = false;
+    if (! deadSeen)
+    {
+      if (! aliveSeen && ! sekiSeen)
+        territoryColor = StoneStateNone;
+      else if ((blackSekiSeen && blackAliveSeen) || (whiteSekiSeen && whiteAliveSeen))
+        territoryInconsistencyFound = true;
+      else if ((blackSekiSeen && whiteAliveSeen) || (whiteSekiSeen && blackAliveSeen))
+        territoryInconsistencyFound = true;
+      else if ((blackSekiSeen && whiteSekiSeen) || (blackAliveSeen && whiteAliveSeen))
+        territoryColor = StoneStateNone;
+      else if (sekiSeen)
+        territoryColor = areaScoring ? (blackSekiSeen ? StoneStateBlack : StoneStateWhite) : StoneStateNone;
+      else
+        territoryColor = blackAliveSeen ? StoneStateBlack : StoneStateWhite;
+    }
+    else
+    {
+      if (sekiSeen)
+        territoryInconsistencyFound = true;
+      else if (blackDeadSeen && whiteDeadSeen)
+        territoryInconsistencyFound = true;
+      else if ((blackDeadSeen && blackAliveSeen) || (whiteDeadSeen && whiteAliveSeen))
+        territoryInconsistencyFound = true;
+      else
+        territoryColor = blackDeadSeen ? StoneStateWhite : StoneStateBlack;
+    }
+
+    if (territoryInconsistencyFound)
+      territoryResult.inconsistentTerritory |= emptyArea;
+    else if (StoneStateBlack == territoryColor)
+      territoryResult.blackTerritory |= emptyArea;
+    else if (StoneStateWhite == territoryColor)
+      territoryResult.whiteTerritory |= emptyArea;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a sekiStones with the intersections of the stone groups that
+/// are in seki. @a deadStones identifies the stones that are dead, these are
+/// treated as if they had already been captured. @a sekiStones is cleared
+/// before it is filled.
+///
+/// The analysis is local and does not read out fights. It finds the typical
+/// seki of a finished game in four steps:
+/// - Shared liberties: An empty intersection that borders on stones of both
+///   colors is a shared liberty if neither color can play there without
+///   putting its own stone group into atari (i.e. the move captures nothing
+///   and the resulting stone group has at most one liberty).
+/// - Eyes: An empty area that borders only on stones of one color is an eye of
+///   that color.
+/// - Seki groups: A stone group that borders on a shared liberty is in seki if
+///   it has at least two liberties, and if each of its liberties is either a
+///   shared liberty or an eye of its own color. A shared liberty remains
+///   shared only as long as all stone groups that border on it are in seki.
+///   This is repeated until nothing changes anymore.
+/// - Consistency with calculateTerritory(): An empty area that borders on
+///   stones in seki must not also border on other stones, otherwise the
+///   territory kernel would report an inconsistency. Stone groups in seki that
+///   violate this rule are removed from the result, again repeatedly until
+///   nothing changes anymore.
+///
+/// The result errs on the side of caution: A stone group that is not in seki
+/// is never reported, but a seki in a complicated shape may be missed.
+// -----------------------------------------------------------------------------
+void GoBoardCore::findSekiStones(const PointSet& deadStones, PointSet& sekiStones) const
+{
+  sekiStones.reset();
+
+  const PointSet stones = this->blackStones | this->whiteStones;
+  const PointSet dead = deadStones & stones;
+  const PointSet blackLiveStones = this->blackStones & ~dead;
+  const PointSet whiteLiveStones = this->whiteStones & ~dead;
+  const PointSet liveStones = blackLiveStones | whiteLiveStones;
+
+  // Shared liberties
+  PointSet sharedLiberties;
+  for (int index = 0; index < this->numberOfPoints; ++index)
+  {
+    if (liveStones.test(index))
+      continue;
+
+    bool blackNeighbourSeen = false;
+    bool whiteNeighbourSeen = false;
+    const NeighbourList& neighbourList = this->neighbourTable[index];
+    for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+    {
+      int neighbour = neighbourList.neighbours[indexOfNeighbour];
+      if (blackLiveStones.test(neighbour))
+        blackNeighbourSeen = true;
+      else if (whiteLiveStones.test(neighbour))
+        whiteNeighbourSeen = true;
+    }
+    if (! blackNeighbourSeen || ! whiteNeighbourSeen)
+      continue;
+
+    if (isSelfAtari(index, blackLiveStones, whiteLiveStones) && isSelfAtari(index, whiteLiveStones, blackLiveStones))
+      sharedLiberties.set(index);
+  }
+  if (sharedLiberties.none())
+    return;
+
+  // Eyes
+  PointSet blackEyes;
+  PointSet whiteEyes;
+  PointSet visited = liveStones;
+  PointSet emptyArea;
+  PointSet adjacentStones;
+  for (int index = 0; index < this->numberOfPoints; ++index)
+  {
+    if (visited.test(index))
+      continue;
+    getEmptyArea(index, liveStones, emptyArea, adjacentStones);
+    visited |= emptyArea;
+
+    if (adjacentStones.none())
+      continue;
+    else if ((adjacentStones & whiteLiveStones).none())
+      blackEyes |= emptyArea;
+    else if ((adjacentStones & blackLiveStones).none())
+      whiteEyes |= emptyArea;
+  }
+
+  // Seki groups
+  PointSet stoneGroup;
+  PointSet liberties;
+  bool sharedLibertiesChanged = true;
+  while (sharedLibertiesChanged)
+  {
+    sharedLibertiesChanged = false;
+    sekiStones.reset();
+    PointSet examinedStones;
+    PointSet rejectedStones;
+    for (int index = 0; index < this->numberOfPoints; ++index)
+    {
+      if (! sharedLiberties.test(index))
+        continue;
+
+      const NeighbourList& neighbourList = this->neighbourTable[index];
+      for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+      {
+        int neighbour = neighbourList.neighbours[indexOfNeighbour];
+        if (! liveStones.test(neighbour) || examinedStones.test(neighbour))
+          continue;
+
+        bool isBlack = blackLiveStones.test(neighbour);
+        getStoneGroupAndLiberties(neighbour, isBlack ? blackLiveStones : whiteLiveStones, liveStones, stoneGroup, liberties);
+        examinedStones |= stoneGroup;
+
+        const PointSet& eyes = isBlack ? blackEyes : whiteEyes;
+        if (liberties.count() >= 2 && (liberties & ~sharedLiberties & ~eyes).none())
+          sekiStones |= stoneGroup;
+        else
+          rejectedStones |= stoneGroup;
+      }
+    }
+
+    for (int index = 0; index < this->numberOfPoints; ++index)
+    {
+      if (! sharedLiberties.test(index))
+        continue;
+
+      const NeighbourList& neighbourList = this->neighbourTable[index];
+      for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+      {
+        if (rejectedStones.test(neighbourList.neighbours[indexOfNeighbour]))
+        {
+          sharedLiberties.reset(index);
+          sharedLibertiesChanged = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // Consistency with calculateTerritory()
+  bool sekiStonesChanged = true;
+  while (sekiStonesChanged && sekiStones.any())
+  {
+    sekiStonesChanged = false;
+    visited = stones;
+    for (int index = 0; index < this->numberOfPoints; ++index)
+    {
+      if (visited.test(index))
+        continue;
+      getEmptyArea(index, emptyArea, adjacentStones);
+      visited |= emptyArea;
+
+      PointSet adjacentSekiStones = adjacentStones & sekiStones;
+      if (adjacentSekiStones.none() || (adjacentStones & ~sekiStones).none())
+        continue;
+
+      for (int indexOfStone = 0; indexOfStone < this->numberOfPoints; ++indexOfStone)
+      {
+        if (! adjacentSekiStones.test(indexOfStone))
+          continue;
+        const PointSet& friendlyStones = this->blackStones.test(indexOfStone) ? this->blackStones : this->whiteStones;
+        getStoneGroupAndLiberties(indexOfStone, friendlyStones & sekiStones, stones, stoneGroup, liberties);
+        sekiStones &= ~stoneGroup;
+        adjacentSekiStones &= ~stoneGroup;
+      }
+      sekiStonesChanged = true;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a stoneGroup with the intersections of the stone group that
+/// the stone on the intersection with index @a index belongs to, and
+/// @a liberties with the liberties of that stone group. Both sets are cleared
+/// if the intersection is not occupied by a stone.
+///
+/// This is the workhorse of GoBoardCore. It performs a flood fill that uses an
+/// explicit stack on the stack frame instead of recursion, and a bitset
+/// instead of a search in a list to check whether an intersection has already
+/// been visited.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getStoneGroupAndLiberties(int index, PointSet& stoneGroup, PointSet& liberties) const
+{
+  stoneGroup.reset();
+  liberties.reset();
+
+  StoneState color = getStoneState(index);
+  if (StoneStateNone == color)
+    return;
+
+  getStoneGroupAndLiberties(index, getStones(color), this->blackStones | this->whiteStones, stoneGroup, liberties);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Same as the public overload of getStoneGroupAndLiberties(), but the
+/// stones of the group's color are taken from @a friendlyStones, and the
+/// intersections occupied by stones of any color are taken from @a stones.
+/// The intersection with index @a index must be in @a friendlyStones.
+// -----------------------------------------------------------------------------
+void GoBoardCore::getStoneGroupAndLiberties(int index, const PointSet& friendlyStones, const PointSet& stones, PointSet& stoneGroup, PointSet& liberties) const
+{
+  stoneGroup.reset();
+  liberties.reset();
+
+  int stack[maximumNumberOfPoints];
+  int stackSize = 0;
+  stack[stackSize++] = index;
+  stoneGroup.set(index);
+
+  while (stackSize > 0)
+  {
+    int currentIndex = stack[--stackSize];
+    const NeighbourList& neighbourList = this->neighbourTable[currentIndex];
+    for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+    {
+      int neighbour = neighbourList.neighbours[indexOfNeighbour];
+      if (friendlyStones.test(neighbour))
+      {
+        if (! stoneGroup.test(neighbour))
+        {
+          stoneGroup.set(neighbour);
+          stack[stackSize++] = neighbour;
+        }
+      }
+      else if (! stones.test(neighbour))
+      {
+        liberties.set(neighbour);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if placing a stone on the empty intersection with
+/// index @a index puts the resulting stone group into atari, or leaves it
+/// without liberties, without capturing anything. The stones of the color
+/// that plays are taken from @a friendlyStones, the stones of the opposing
+/// color from @a opponentStones. Helper for findSekiStones().
+// -----------------------------------------------------------------------------
+bool GoBoardCore::isSelfAtari(int index, const PointSet& friendlyStones, const PointSet& opponentStones) const
+{
+  const PointSet stones = friendlyStones | opponentStones;
+  PointSet stoneGroup;
+  PointSet liberties;
+
+  const NeighbourList& neighbourList = this->neighbourTable[index];
+  for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+  {
+    int neighbour = neighbourList.neighbours[indexOfNeighbour];
+    if (! opponentStones.test(neighbour))
+      continue;
+    getStoneGroupAndLiberties(neighbour, opponentStones, stones, stoneGroup, liberties);
+    if (liberties.count() == 1)
+      return false;
+  }
+
+  PointSet friendlyStonesAfterMove = friendlyStones;
+  friendlyStonesAfterMove.set(index);
+  PointSet stonesAfterMove = stones;
+  stonesAfterMove.set(index);
+  getStoneGroupAndLiberties(index, friendlyStonesAfterMove, stonesAfterMove, stoneGroup, liberties);
+  return liberties.count() <= 1;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the color that opposes @a color.
+// -----------------------------------------------------------------------------
+GoBoardCore::StoneState GoBoardCore::getOpponentColor(StoneState color)
+{
+  switch (color)
+  {
+    case StoneStateBlack:
+      return StoneStateWhite;
+    case StoneStateWhite:
+      return StoneStateBlack;
+    default:
+      throw std::invalid_argument("Color must be either black or white");
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the neighbour table for board size @a boardSize. The table
+/// is indexed with intersection indexes. GoBoardTopology also uses the table.
+///
+/// The tables for all board sizes are created when this method is invoked for
+/// the first time. The tables are immutable after creation, so they can be
+/// shared. Initialization of the local static variable is thread-safe.
+///
+/// Throws std::invalid_argument if @a boardSize is not one of the board sizes
+/// supported by the application.
+// -----------------------------------------------------------------------------
+const std::vector<GoBoardCore::NeighbourList>& GoBoardCore::getNeighbourTable(int boardSize)
+{
+  static const int minimumBoardSize = 7;
+
+  static const std::vector<std::vector<NeighbourList>> neighbourTables = []()
+  {
+    std::vector<std::vector<NeighbourList>> tables(maximumBoardSize + 1);
+    for (int size = minimumBoardSize; size <= maximumBoardSize; size += 2)
+    {
+      std::vector<NeighbourList>& table = tables[size];
+      table.resize(size * size);
+      for (int y = 0; y < size; ++y)
+      {
+        for (int x = 0; x < size; ++x)
+        {
+          NeighbourList& neighbourList = table[y * size + x];
+          // Same order as GoPoint::neighbours(): left, right, above, below
+          neighbourList.neighbourInDirection[0] = (x > 0) ? y * size + x - 1 : -1;
+          neighbourList.neighbourInDirection[1] = (x < size - 1) ? y * size + x + 1 : -1;
+          neighbourList.neighbourInDirection[2] = (y < size - 1) ? (y + 1) * size + x : -1;
+          neighbourList.neighbourInDirection[3] = (y > 0) ? (y - 1) * size + x : -1;
+          neighbourList.numberOfNeighbours = 0;
+          for (int neighbour : neighbourList.neighbourInDirection)
+          {
+            if (neighbour != -1)
+              neighbourList.neighbours[neighbourList.numberOfNeighbours++] = neighbour;
+          }
+        }
+      }
+    }
+    return tables;
+  }();
+
+  if (boardSize < minimumBoardSize || boardSize > maximumBoardSize || (boardSize % 2) == 0)
+    throw std::invalid_argument("Board size is not supported");
+
+  return neighbourTables[boardSize];
+}
@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// System includes
+#include <bitset>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoBoardCore class is a compact representation of the stones on
+/// a Go board. It is designed to answer the questions that are asked most
+/// often during play (liberties, captures, suicide) without having to walk
+/// GoPoint and GoBoardRegion objects.
+///
+/// @ingroup go
+///
+/// GoBoardCore is owned by GoBoard. Clients do not use GoBoardCore directly,
+/// they use the GoBoard methods that act as a façade for GoBoardCore. The
+/// reason is that GoBoardCore is a C++ class that cannot be used by the many
+/// pure Objective-C source files of the project.
+///
+/// Intersections are identified by a zero-based index. The intersection at
+/// vertex A1 has index 0, the intersection to the right of A1 has index 1, and
+/// so on, row by row. This is the same order in which GoPoint objects are
+/// iterated via GoPoint::next().
+///
+/// The stones of each color are stored in a bitset. The neighbours of each
+/// intersection are precomputed once per board size and shared by all
+/// GoBoardCore objects of that board size.
+///
+/// GoBoardCore also contains the territory kernel that is used for scoring
+/// (see calculateTerritory()). The kernel classifies empty areas with a
+/// scanline flood fill and expresses stone group states and territories as
+/// bitset masks, so that it does not depend on GoBoardRegion objects. A local
+/// seki analysis (see findSekiStones()) complements the kernel.
+///
+/// GoBoardCore keeps track of the intersections whose stone state changed
+/// since the last query. This allows it to maintain liberty indexes
+/// incrementally: the set of stones without liberties, which is important
+/// during board setup where many stones are placed in a row and each of them
+/// may create such stones, and an atari index that records for each stone
+/// group with a single liberty where that liberty is. Capture detection and
+/// suicide detection are direct lookups in the atari index.
+///
+/// GoBoardCore is not thread-safe. The shared neighbour tables, however, are
+/// immutable and can be used from any thread.
+// -----------------------------------------------------------------------------
+class GoBoardCore
+{
+public:
+  /// @brief Enumerates the possible states of an intersection. The numeric
+  /// values are the same as those of the Objective-C enumeration GoColor.
+  enum StoneState
+  {
+    StoneStateNone = 0,
+    StoneStateBlack = 1,
+    StoneStateWhite = 2
+  };
+
+  /// @brief The largest board size supported by GoBoardCore.
+  static const int maximumBoardSize = 19;
+  /// @brief The largest number of intersections supported by GoBoardCore.
+  static const int maximumNumberOfPoints = maximumBoardSize * maximumBoardSize;
+
+  /// @brief A set of intersections, each bit representing one intersection
+  /// index.
+  typedef std::bitset<maximumNumberOfPoints> PointSet;
+
+  /// @brief The neighbours of a single intersection. There are at most 4
+  /// neighbours, intersections on the edge or in the corner of the board have
+  /// fewer neighbours.
+  struct NeighbourList
+  {
+    int numberOfNeighbours;
+    int neighbours[4];
+    /// @brief The neighbours by direction, in the order left, right, above,
+    /// below. An entry is -1 if the intersection has no neighbour in that
+    /// direction. The order matches the first four values of the enumeration
+    /// #GoBoardDirection.
+    int neighbourInDirection[4];
+  };
+
+  /// @brief The result of a territory calculation made by
+  /// calculateTerritory(). Each intersection is in at most one of the sets.
+  /// Intersections that are in none of the sets are neutral.
+  struct TerritoryResult
+  {
+    /// @brief The intersections that belong to Black's territory.
+    PointSet blackTerritory;
+    /// @brief The intersections that belong to White's territory.
+    PointSet whiteTerritory;
+    /// @brief The empty intersections whose territory cannot be determined
+    /// because the states of the adjacent stone groups are inconsistent.
+    /// These intersections are neutral for scoring purposes.
+    PointSet inconsistentTerritory;
+  };
+
+public:
+  explicit GoBoardCore(int boardSize);
+  ~GoBoardCore();
+
+  int getBoardSize() const;
+  int getNumberOfPoints() const;
+  int getIndexOfVertex(int x, int y) const;
+  const NeighbourList& getNeighbours(int index) const;
+
+  StoneState getStoneState(int index) const;
+  void setStoneState(int index, StoneState stoneState);
+  void playStone(int index, StoneState color);
+  bool hasStone(int index) const;
+  const PointSet& getStones(StoneState color) const;
+  int getNumberOfStones(StoneState color) const;
+
+  int getNumberOfEmptyNeighbours(int index) const;
+  void getStoneGroup(int index, PointSet& stoneGroup) const;
+  void getStoneGroupAndLiberties(int index, PointSet& stoneGroup, PointSet& liberties) const;
+  int getNumberOfLiberties(int index) const;
+  void getStonesCapturedByStone(int index, StoneState color, PointSet& capturedStones);
+  void getStonesCapturedByStone(int index, StoneState color, std::vector<int>& capturedStones);
+  bool isSuicide(int index, StoneState color, bool* simpleKoIsPossible);
+
+  const PointSet& getStonesWithoutLiberties();
+  PointSet getStonesInAtari(StoneState color);
+  void getStonesInAtariWithLibertyAt(int index, StoneState color, PointSet& stonesInAtari);
+
+  void getEmptyArea(int index, PointSet& emptyArea, PointSet& adjacentStones) const;
+  void calculateTerritory(const PointSet& deadStones, const PointSet& sekiStones, bool areaScoring, TerritoryResult& territoryResult) const;
+  void findSekiStones(const PointSet& deadStones, PointSet& sekiStones) const;
+
+  int getFirstIndexInSet(const PointSet& pointSet) const;
+  static StoneState getOpponentColor(StoneState color);
+  static const std::vector<NeighbourList>& getNeighbourTable(int boardSize);
+
+private:
+  void updateLibertyIndexes();
+  void getStoneGroupAndLiberties(int index, const PointSet& friendlyStones, const PointSet& stones, PointSet& stoneGroup, PointSet& liberties) const;
+  void getEmptyArea(int index, const PointSet& stones, PointSet& emptyArea, PointSet& adjacentStones) const;
+  bool isSelfAtari(int index, const PointSet& friendlyStones, const PointSet& opponentStones) const;
+
+private:
+  /// @brief The board size.
+  int boardSize;
+  /// @brief The number of intersections, i.e. boardSize * boardSize.
+  int numberOfPoints;
+  /// @brief The neighbour table for @e boardSize. This is shared with other
+  /// GoBoardCore objects, GoBoardCore does not own the table.
+  const std::vector<NeighbourList>& neighbourTable;
+  /// @brief The intersections that are occupied by black stones.
+  PointSet blackStones;
+  /// @brief The intersections that are occupied by white stones.
+  PointSet whiteStones;
+  /// @brief The intersections whose stone state changed, and their
+  /// neighbours, since updateLibertyIndexes() was last invoked.
+  PointSet changedPoints;
+  /// @brief The stones without liberties as of the last invocation of
+  /// updateLibertyIndexes().
+  PointSet stonesWithoutLiberties;
+  /// @brief The stones of both colors whose stone group has exactly one
+  /// liberty, as of the last invocation of updateLibertyIndexes().
+  PointSet stonesInAtari;
+  /// @brief For each stone in @e stonesInAtari, the index of the single
+  /// liberty of its stone group. Entries for other intersections are
+  /// meaningless.
+  std::vector<int> atariLiberties;
+};
@@ -93,6 +93,17 @@
 /// case can observe the default notification center for the notification
 /// #boardPositionChangeProgress. The setter of @e currentBoardPosition posts
 /// this notification (B-A) times for a board position change from A to B.
+///
+///
+/// @par Changed points
+///
+/// The setter of @e currentBoardPosition records the intersections whose stone
+/// state it changes. Whoever posts the #currentBoardPositionDidChange
+/// notification invokes finishChangedPointsBatch() to obtain the recorded
+/// intersections and passes them along with the notification, so that
+/// observers do not have to examine the entire board to find out what has
+/// changed. If several board position changes are made before the notification
+/// is posted, the recorded intersections of all changes are combined.
 // -----------------------------------------------------------------------------
 @interface GoBoardPosition : NSObject <NSSecureCoding>
 {
@@ -101,6 +112,7 @@
 - (id) initWithGame:(GoGame*)game;
 
 - (void) changeToLastBoardPositionWithoutUpdatingGoObjects;
+- (NSArray*) finishChangedPointsBatch;
 
 /// @brief The current board position as described in the GoBoardPosition class
 /// documentation.
@@ -17,6 +17,7 @@
 
 // Project includes
 #import "GoBoardPosition.h"
+#import "../go/GoBoard.h"
 #import "../go/GoGame.h"
 #import "../go/GoNode.h"
 #import "../go/GoNodeModel.h"
@@ -29,6 +30,10 @@
 // -----------------------------------------------------------------------------
 @interface GoBoardPosition()
 @property(nonatomic, assign) GoGame* game;
+/// @brief Indexes of the intersections whose stone state was changed by the
+/// setter of @e currentBoardPosition since finishChangedPointsBatch() was last
+/// invoked.
+@property(nonatomic, retain) NSMutableIndexSet* changedPointIndexes;
 @end
 
 
@@ -52,6 +57,7 @@
   self.game = aGame;
   _currentBoardPosition = 0;  // don't use self to avoid the setter
   _numberOfBoardPositions = self.game.nodeModel.numberOfNodes;
+  self.changedPointIndexes = [NSMutableIndexSet indexSet];
 
   return self;
 }
@@ -72,6 +78,7 @@
   // Don't use self, otherwise we trigger the setter!
   _currentBoardPosition = [decoder decodeIntForKey:goBoardPositionCurrentBoardPositionKey];
   self.numberOfBoardPositions = [decoder decodeIntForKey:goBoardPositionNumberOfBoardPositionsKey];
+  self.changedPointIndexes = [NSMutableIndexSet indexSet];
 
   return self;
 }
@@ -90,6 +97,7 @@
 - (void) dealloc
 {
   self.game = nil;
+  self.changedPointIndexes = nil;
 
   [super dealloc];
 }
@@ -128,6 +136,27 @@
   _currentBoardPosition = lastBoardPosition;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoPoint objects whose stone state was changed by the
+/// setter of @e currentBoardPosition since this method was last invoked.
+/// Returns an empty array if no stone state was changed. Starts a new batch,
+/// i.e. no intersections are recorded after this method returns.
+///
+/// The caller is expected to pass the returned array along with the
+/// #currentBoardPositionDidChange notification.
+// -----------------------------------------------------------------------------
+- (NSArray*) finishChangedPointsBatch
+{
+  GoBoard* board = self.game.board;
+  NSMutableArray* changedPoints = [NSMutableArray arrayWithCapacity:self.changedPointIndexes.count];
+  [self.changedPointIndexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL* stop)
+  {
+    [changedPoints addObject:[board pointAtIndex:(int)index]];
+  }];
+  [self.changedPointIndexes removeAllIndexes];
+  return changedPoints;
+}
+
 #pragma mark - Properties
 
 // -----------------------------------------------------------------------------
@@ -168,6 +197,16 @@
 
 // -----------------------------------------------------------------------------
 /// @brief Private helper method for setCurrentBoardPosition:()
+///
+/// If GoNodeModel has a board snapshot that is sufficiently close to
+/// @a newBoardPosition, this method restores the snapshot and then replays only
+/// the nodes between the snapshot and @a newBoardPosition. Otherwise it replays
+/// all nodes between the current board position and @a newBoardPosition. In
+/// both cases #boardPositionChangeProgress is posted once for every board
+/// position between the current board position and @a newBoardPosition.
+///
+/// While replaying forward this method stores new board snapshots in
+/// GoNodeModel as requested by GoNodeModel.
 // -----------------------------------------------------------------------------
 - (void) updateGoObjectsToNewPosition:(int)newBoardPosition
 {
@@ -175,12 +214,32 @@
   GoNodeModel* nodeModel = self.game.nodeModel;
   int indexOfTargetNode = newBoardPosition;
   int indexOfCurrentNode = self.currentBoardPosition;
-  if (newBoardPosition > self.currentBoardPosition)
+  int numberOfBoardPositionChanges = abs(indexOfTargetNode - indexOfCurrentNode);
+  NSData* stoneStatesBeforeChange = [self.game.board stoneStateSnapshot];
+
+  // Restoring a snapshot costs roughly as much as replaying one snapshot
+  // interval's worth of nodes, so we use the snapshot only if it saves more
+  // than that
+  int indexOfSnapshot = [nodeModel indexOfBoardSnapshotNearestToIndex:indexOfTargetNode];
+  if (indexOfSnapshot != -1 &&
+      indexOfSnapshot != indexOfCurrentNode &&
+      (indexOfTargetNode - indexOfSnapshot) + nodeModel.boardSnapshotInterval < numberOfBoardPositionChanges)
+  {
+    [self restoreBoardSnapshot:[nodeModel boardSnapshotAtIndex:indexOfSnapshot]];
+    int numberOfSkippedBoardPositionChanges = numberOfBoardPositionChanges - (indexOfTargetNode - indexOfSnapshot);
+    for (int counter = 0; counter < numberOfSkippedBoardPositionChanges; ++counter)
+      [center postNotificationName:boardPositionChangeProgress object:nil];
+    indexOfCurrentNode = indexOfSnapshot;
+  }
+
+  if (indexOfTargetNode > indexOfCurrentNode)
   {
     for (int indexOfNode = indexOfCurrentNode + 1; indexOfNode <= indexOfTargetNode; ++indexOfNode)
     {
       GoNode* node = [nodeModel nodeAtIndex:indexOfNode];
       [node modifyBoard];
+      if ([nodeModel shouldStoreBoardSnapshotAtIndex:indexOfNode])
+        [nodeModel storeBoardSnapshot:[self boardSnapshot] atIndex:indexOfNode];
       [center postNotificationName:boardPositionChangeProgress object:nil];
     }
   }
@@ -193,6 +252,57 @@
       [center postNotificationName:boardPositionChangeProgress object:nil];
     }
   }
+
+  [self recordChangedPointsSinceStoneStates:stoneStatesBeforeChange];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Adds the indexes of the intersections whose stone state differs from
+/// @a stoneStates, which must have been obtained from the GoBoard method
+/// stoneStateSnapshot(), to @e changedPointIndexes.
+///
+/// This is an internal helper for updateGoObjectsToNewPosition:().
+// -----------------------------------------------------------------------------
+- (void) recordChangedPointsSinceStoneStates:(NSData*)stoneStates
+{
+  NSData* currentStoneStates = [self.game.board stoneStateSnapshot];
+  const unsigned char* oldBytes = (const unsigned char*)stoneStates.bytes;
+  const unsigned char* newBytes = (const unsigned char*)currentStoneStates.bytes;
+  NSUInteger numberOfPoints = currentStoneStates.length;
+  for (NSUInteger index = 0; index < numberOfPoints; ++index)
+  {
+    if (oldBytes[index] != newBytes[index])
+      [self.changedPointIndexes addIndex:index];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a board snapshot of the current state of the Go objects.
+/// The snapshot consists of the stone state of all intersections, followed by
+/// one byte for the value of the GoGame property @e setupFirstMoveColor,
+/// because GoNode::modifyBoard() may change that property as well.
+///
+/// This is an internal helper for updateGoObjectsToNewPosition:().
+// -----------------------------------------------------------------------------
+- (NSData*) boardSnapshot
+{
+  NSMutableData* snapshot = [NSMutableData dataWithData:[self.game.board stoneStateSnapshot]];
+  unsigned char setupFirstMoveColor = (unsigned char)self.game.setupFirstMoveColor;
+  [snapshot appendBytes:&setupFirstMoveColor length:1];
+  return snapshot;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Restores the state of the Go objects from @a snapshot, which must
+/// have been obtained from boardSnapshot().
+///
+/// This is an internal helper for updateGoObjectsToNewPosition:().
+// -----------------------------------------------------------------------------
+- (void) restoreBoardSnapshot:(NSData*)snapshot
+{
+  [self.game.board restoreStoneStateSnapshot:snapshot];
+  const unsigned char* bytes = (const unsigned char*)snapshot.bytes;
+  self.game.setupFirstMoveColor = (enum GoColor)bytes[snapshot.length - 1];
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+@class GoNode;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoBoardPositionPreview class determines the stones on the board
+/// for any board position of the current game variation, without changing
+/// the board position that is displayed by GoBoardPosition.
+///
+/// @ingroup go
+///
+/// Changing the current board position with GoBoardPosition modifies the
+/// state of all Go model objects, synchronizes the GTP engine and posts
+/// notifications that cause the UI to update. GoBoardPositionPreview is
+/// intended for situations where the user quickly browses many board
+/// positions and only the stones need to be shown for the intermediate board
+/// positions, e.g. while scrubbing through the list of board positions.
+///
+/// GoBoardPositionPreview replays the nodes of the current game variation on
+/// a private GoBoardCore object. The replay starts from whichever of the
+/// following is closest to the requested board position, without exceeding
+/// it: The board position that was previewed last, the current board position
+/// of GoBoardPosition, the nearest board snapshot in GoNodeModel, or the
+/// start of the game. Scrubbing forward therefore replays only the nodes
+/// between two consecutive previews.
+///
+/// stoneStatesAtNode:() extends the preview to nodes of other game
+/// variations. It previews the node in the current game variation from which
+/// the other game variation branches off, then replays the remaining nodes of
+/// the other game variation.
+///
+/// The stone states returned by stoneStatesAtBoardPosition:() and
+/// stoneStatesAtNode:() have the format of a board snapshot (see
+/// GoBoard::stoneStateSnapshot()).
+///
+/// GoBoardPositionPreview must be used from the main thread only. The Go
+/// model must not change while a GoBoardPositionPreview object is in use,
+/// except for changes of the current board position.
+// -----------------------------------------------------------------------------
+@interface GoBoardPositionPreview : NSObject
+{
+}
+
+- (id) initWithGame:(GoGame*)game;
+- (NSData*) stoneStatesAtBoardPosition:(int)boardPosition;
+- (NSData*) stoneStatesAtNode:(GoNode*)node;
+
+/// @brief The game whose board positions are previewed.
+@property(nonatomic, assign, readonly) GoGame* game;
+
+@end
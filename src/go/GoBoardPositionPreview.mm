@@ -0,0 +1,251 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoBoardPositionPreview.h"
+#import "GoBoard.h"
+#import "GoBoardCore.h"
+#import "GoBoardPosition.h"
+#import "GoGame.h"
+#import "GoMove.h"
+#import "GoNode.h"
+#import "GoNodeModel.h"
+#import "GoNodeSetup.h"
+#import "GoPlayer.h"
+#import "GoPoint.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoBoardPositionPreview.
+// -----------------------------------------------------------------------------
+@interface GoBoardPositionPreview()
+@property(nonatomic, assign, readwrite) GoGame* game;
+@property(nonatomic, assign) GoBoardCore* boardCore;
+/// @brief The board position whose stones are currently on @e boardCore. Is
+/// -1 if @e boardCore does not contain a board position yet.
+@property(nonatomic, assign) int boardPositionOfBoardCore;
+@end
+
+
+@implementation GoBoardPositionPreview
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoBoardPositionPreview object that previews board
+/// positions of @a game.
+///
+/// @note This is the designated initializer of GoBoardPositionPreview.
+// -----------------------------------------------------------------------------
+- (id) initWithGame:(GoGame*)game
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.game = game;
+  _boardCore = new GoBoardCore(game.board.size);
+  self.boardPositionOfBoardCore = -1;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoBoardPositionPreview object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  delete _boardCore;
+  _boardCore = nullptr;
+  self.game = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone states of all intersections for the board position
+/// @a boardPosition of the current game variation. See the class
+/// documentation for details.
+///
+/// Raises @e NSRangeException if @a boardPosition is outside the range of
+/// board positions of the current game variation.
+// -----------------------------------------------------------------------------
+- (NSData*) stoneStatesAtBoardPosition:(int)boardPosition
+{
+  GoNodeModel* nodeModel = self.game.nodeModel;
+  if (boardPosition < 0 || boardPosition >= nodeModel.numberOfNodes)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Board position %d is out of range", boardPosition];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  [self moveBoardCoreToBoardPosition:boardPosition];
+  return [self stoneStatesOfBoardCore];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone states of all intersections for the board position
+/// that is described by @a node. @a node may be in any game variation. See
+/// the class documentation for details.
+///
+/// Raises @e NSInvalidArgumentException if @a node is @e nil or if @a node is
+/// not in the game tree of the game whose board positions are previewed.
+// -----------------------------------------------------------------------------
+- (NSData*) stoneStatesAtNode:(GoNode*)node
+{
+  GoNodeModel* nodeModel = self.game.nodeModel;
+  GoNode* ancestorNode = [nodeModel ancestorOfNodeInCurrentVariation:node];
+  [self moveBoardCoreToBoardPosition:[nodeModel indexOfNode:ancestorNode]];
+  if (ancestorNode == node)
+    return [self stoneStatesOfBoardCore];
+
+  NSMutableArray* nodesToReplay = [NSMutableArray array];
+  for (GoNode* nodeToReplay = node; nodeToReplay != ancestorNode; nodeToReplay = nodeToReplay.parent)
+    [nodesToReplay insertObject:nodeToReplay atIndex:0];
+  for (GoNode* nodeToReplay in nodesToReplay)
+    [self replayNode:nodeToReplay];
+
+  // The board core no longer contains a board position of the current game
+  // variation
+  self.boardPositionOfBoardCore = -1;
+
+  return [self stoneStatesOfBoardCore];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the stone states on @e boardCore in the
+/// format of a board snapshot.
+// -----------------------------------------------------------------------------
+- (NSData*) stoneStatesOfBoardCore
+{
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  NSMutableData* stoneStates = [NSMutableData dataWithLength:numberOfPoints];
+  unsigned char* bytes = static_cast<unsigned char*>(stoneStates.mutableBytes);
+  for (int index = 0; index < numberOfPoints; ++index)
+    bytes[index] = static_cast<unsigned char>(_boardCore->getStoneState(index));
+  return stoneStates;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for stoneStatesAtBoardPosition:() and
+/// stoneStatesAtNode:(). Brings
+/// @e boardCore to the board position @a boardPosition, starting from the
+/// closest known board position.
+// -----------------------------------------------------------------------------
+- (void) moveBoardCoreToBoardPosition:(int)boardPosition
+{
+  GoGame* game = self.game;
+  GoNodeModel* nodeModel = game.nodeModel;
+
+  int startBoardPosition = -1;
+  NSData* startStoneStates = nil;
+
+  int currentBoardPosition = game.boardPosition.currentBoardPosition;
+  if (currentBoardPosition <= boardPosition)
+  {
+    startBoardPosition = currentBoardPosition;
+    startStoneStates = [game.board stoneStateSnapshot];
+  }
+
+  int indexOfSnapshot = [nodeModel indexOfBoardSnapshotNearestToIndex:boardPosition];
+  if (indexOfSnapshot > startBoardPosition)
+  {
+    startBoardPosition = indexOfSnapshot;
+    startStoneStates = [nodeModel boardSnapshotAtIndex:indexOfSnapshot];
+  }
+
+  // The stones of the previous preview are already on the board core, so
+  // they are preferred if they are as close as the other candidates
+  if (self.boardPositionOfBoardCore != -1 &&
+      self.boardPositionOfBoardCore <= boardPosition &&
+      self.boardPositionOfBoardCore >= startBoardPosition)
+  {
+    startBoardPosition = self.boardPositionOfBoardCore;
+  }
+  else if (startStoneStates)
+  {
+    [self setStoneStates:startStoneStates];
+  }
+  else
+  {
+    // The board position before the root node has modified the board
+    [self setStoneStates:nil];
+    for (GoPoint* handicapPoint in game.handicapPoints)
+      _boardCore->setStoneState([game.board indexOfPoint:handicapPoint], GoBoardCore::StoneStateBlack);
+  }
+
+  for (int indexOfNode = startBoardPosition + 1; indexOfNode <= boardPosition; ++indexOfNode)
+    [self replayNode:[nodeModel nodeAtIndex:indexOfNode]];
+
+  self.boardPositionOfBoardCore = boardPosition;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for moveBoardCoreToBoardPosition:(). Changes the
+/// stone states on @e boardCore to @a stoneStates, which have the format of a
+/// board snapshot. Removes all stones if @a stoneStates is nil.
+// -----------------------------------------------------------------------------
+- (void) setStoneStates:(NSData*)stoneStates
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(stoneStates.bytes);
+  int numberOfPoints = _boardCore->getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    GoBoardCore::StoneState stoneState = GoBoardCore::StoneStateNone;
+    if (bytes)
+      stoneState = static_cast<GoBoardCore::StoneState>(bytes[index]);
+    _boardCore->setStoneState(index, stoneState);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for moveBoardCoreToBoardPosition:() and
+/// stoneStatesAtNode:(). Applies the
+/// board modifications of @a node to @e boardCore, in the same way as
+/// GoNode::modifyBoard() applies them to the Go model.
+// -----------------------------------------------------------------------------
+- (void) replayNode:(GoNode*)node
+{
+  GoBoard* board = self.game.board;
+
+  GoMove* move = node.goMove;
+  if (move)
+  {
+    if (move.type != GoMoveTypePlay)
+      return;
+    GoBoardCore::StoneState color = move.player.isBlack ? GoBoardCore::StoneStateBlack : GoBoardCore::StoneStateWhite;
+    _boardCore->playStone([board indexOfPoint:move.point], color);
+    return;
+  }
+
+  GoNodeSetup* nodeSetup = node.goNodeSetup;
+  if (nodeSetup)
+  {
+    for (GoPoint* point in nodeSetup.blackSetupStones)
+      _boardCore->setStoneState([board indexOfPoint:point], GoBoardCore::StoneStateBlack);
+    for (GoPoint* point in nodeSetup.whiteSetupStones)
+      _boardCore->setStoneState([board indexOfPoint:point], GoBoardCore::StoneStateWhite);
+    for (GoPoint* point in nodeSetup.noSetupStones)
+      _boardCore->setStoneState([board indexOfPoint:point], GoBoardCore::StoneStateNone);
+  }
+}
+
+@end
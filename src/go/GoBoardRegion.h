@@ -51,6 +51,22 @@
 ///
 /// Clients do not need to know or care about which pieces of information are
 /// cached, this is an implementation detail.
+///
+/// Scoring mode and the cached information are not archived. A GoBoardRegion
+/// that was unarchived is never in scoring mode. The cache is rebuilt only
+/// when scoring mode is enabled again.
+///
+///
+/// @par Liberties
+///
+/// Outside of scoring mode a GoBoardRegion that represents a stone group keeps
+/// track of its liberties incrementally. The set of liberties is built when
+/// liberties() is invoked for the first time, and from then on is updated
+/// whenever a point is added to the GoBoardRegion, or whenever the stone state
+/// of an adjacent point changes (see
+/// updateLibertiesAfterStoneStateChangeOfPoint:()). When a point is removed
+/// from a stone group, or when the stone group is split, the set is discarded
+/// and will be rebuilt the next time liberties() is invoked.
 // -----------------------------------------------------------------------------
 @interface GoBoardRegion : NSObject <NSSecureCoding>
 {
@@ -65,6 +81,7 @@
 - (bool) isStoneGroup;
 - (enum GoColor) color;
 - (int) liberties;
+- (void) updateLibertiesAfterStoneStateChangeOfPoint:(GoPoint*)point;
 - (NSArray*) adjacentRegions;
 - (bool) isStoneConnectingSuicidalSubgroups:(GoPoint*)point
                            suicidalSubgroup:(NSMutableArray*)suicidalSubgroup;
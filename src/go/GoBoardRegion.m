@@ -36,6 +36,7 @@
 @property(nonatomic, assign) enum GoColor cachedColor;
 @property(nonatomic, assign) int cachedLiberties;
 @property(nonatomic, retain) NSArray* cachedAdjacentRegions;
+@property(nonatomic, retain) NSMutableSet* libertyPoints;
 //@}
 @end
 
@@ -122,11 +123,11 @@
 
   self.points = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableArray class], [GoPoint class]]] forKey:goBoardRegionPointsKey];
   self.randomColor = [UIColor randomColor];
-  // Don't use self.scoringMode, otherwise we trigger the setter!
-  if ([decoder containsValueForKey:goBoardRegionScoringModeKey])
-    _scoringMode = true;
-  else
-    _scoringMode = false;
+  // Scoring mode and the information cached while scoring mode is enabled
+  // were not archived. Whoever needs scoring mode after unarchiving enables it
+  // again, which rebuilds the cache from the unarchived points. Don't use
+  // self.scoringMode, otherwise we trigger the setter!
+  _scoringMode = false;
   if ([decoder containsValueForKey:goBoardRegionTerritoryColorKey])
     self.territoryColor = [decoder decodeIntForKey:goBoardRegionTerritoryColorKey];
   else
@@ -139,26 +140,11 @@
     self.stoneGroupState = [decoder decodeIntForKey:goBoardRegionStoneGroupStateKey];
   else
     self.stoneGroupState = GoStoneGroupStateUndefined;
-  if ([decoder containsValueForKey:goBoardRegionCachedSizeKey])
-    self.cachedSize = [decoder decodeIntForKey:goBoardRegionCachedSizeKey];
-  else
-    self.cachedSize = -1;
-  if ([decoder containsValueForKey:goBoardRegionCachedIsStoneGroupKey])
-    self.cachedIsStoneGroup = true;
-  else
-    self.cachedIsStoneGroup = false;
-  if ([decoder containsValueForKey:goBoardRegionCachedColorKey])
-    self.cachedColor = [decoder decodeIntForKey:goBoardRegionCachedColorKey];
-  else
-    self.cachedColor = GoColorNone;
-  if ([decoder containsValueForKey:goBoardRegionCachedLibertiesKey])
-    self.cachedLiberties = [decoder decodeIntForKey:goBoardRegionCachedLibertiesKey];
-  else
-    self.cachedLiberties = -1;
-  if ([decoder containsValueForKey:goBoardRegionCachedAdjacentRegionsKey])
-    self.cachedAdjacentRegions = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableArray class], [GoBoardRegion class]]] forKey:goBoardRegionCachedAdjacentRegionsKey];
-  else
-    self.cachedAdjacentRegions = nil;
+  self.cachedSize = -1;
+  self.cachedIsStoneGroup = false;
+  self.cachedColor = GoColorNone;
+  self.cachedLiberties = -1;
+  self.cachedAdjacentRegions = nil;
 
   return self;
 }
@@ -178,6 +164,7 @@
 {
   self.points = nil;
   self.randomColor = nil;
+  self.libertyPoints = nil;
   [self invalidateCache];
   [super dealloc];
 }
@@ -263,6 +250,19 @@
     [previousRegion removePoint:point];  // side-effect: sets point.region to nil
   [(NSMutableArray*)_points addObject:point];
   point.region = self;
+
+  // Incrementally update the liberties, but only if they have already been
+  // calculated. The new stone fills one of our liberties and adds its own
+  // empty neighbours.
+  if (_libertyPoints)
+  {
+    [_libertyPoints removeObject:point];
+    for (GoPoint* neighbour in point.neighbours)
+    {
+      if (! [neighbour hasStone])
+        [_libertyPoints addObject:neighbour];
+    }
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -292,6 +292,11 @@
   }
 
   [(NSMutableArray*)_points removeObject:point];
+  // The removed point may have been the only link between some of our
+  // liberties and the stone group. Rebuilding the liberties from scratch when
+  // they are needed next time is cheaper than finding out which liberties are
+  // affected.
+  self.libertyPoints = nil;
   // Check _points array NOW because the next statement might deallocate this
   // GoBoardRegion, including the array
   bool lastPoint = (0 == _points.count);
@@ -338,18 +343,49 @@
     @throw exception;
   }
 
-  // Iterate over a copy of the array to be safe from modifications of the
-  // array. Such modifications occur because addPoint:() below causes the point
-  // to be removed from the other region.
-  // Note: The copy, by the way, also solves the problem that the array is
-  // deallocated when the last point is removed from the other region. If we
-  // were using the original array, the loop would access the deallocated array
-  // in its final iteration (the one where it would normally find out that the
-  // loop condition has been reached), causing the application to crash.
-  NSArray* pointsCopy = [region.points copy];
-  for (GoPoint* point in pointsCopy)
-    [self addPoint:point];
-  [pointsCopy release];
+  NSMutableArray* regionPoints = (NSMutableArray*)region->_points;
+  if (0 == regionPoints.count)
+    return;
+
+  // We only check the attributes of the first point of both regions, assuming
+  // that they are representative for the other points. We don't check all
+  // points for efficiency reasons!
+  if (_points.count > 0)
+  {
+    GoPoint* otherPoint = [_points objectAtIndex:0];
+    GoPoint* firstPointOfRegion = [regionPoints objectAtIndex:0];
+    if (otherPoint.stoneState != firstPointOfRegion.stoneState)
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Region argument points' stoneState (%d) does not match stoneState of points already in this GoBoardRegion (%d)", firstPointOfRegion.stoneState, otherPoint.stoneState];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+  }
+
+  // All points of the other region are moved, so the other region cannot
+  // fragment. This allows us to bulk-move the points instead of invoking
+  // addPoint:() for each point, which would apply the expensive
+  // region-fragmentation logic to the other region once for every point.
+  // Note: We must retain the other region while we update the region
+  // references, because the region is deallocated as soon as the last point
+  // stops referencing it.
+  [region retain];
+  [(NSMutableArray*)_points addObjectsFromArray:regionPoints];
+  for (GoPoint* point in regionPoints)
+    point.region = self;
+  // The liberties of the joined stone group are the union of the liberties of
+  // both stone groups. The point that connects the two stone groups is already
+  // part of this GoBoardRegion, i.e. it is not a liberty of either group.
+  if (_libertyPoints && region->_libertyPoints)
+    [_libertyPoints unionSet:region->_libertyPoints];
+  else
+    self.libertyPoints = nil;
+  [regionPoints removeAllObjects];
+  region.libertyPoints = nil;
+  [region release];
 }
 
 // -----------------------------------------------------------------------------
@@ -385,6 +421,10 @@
 /// @brief Returns the number of liberties of the stone group that this
 /// GoBoardRegion represents.
 ///
+/// The first invocation builds the set of liberties, subsequent invocations
+/// are O(1) because the set is kept up-to-date incrementally. See the class
+/// documentation for details.
+///
 /// Raises an @e NSInternalInconsistencyException if this GoBoardRegion does not
 /// represent a stone group.
 // -----------------------------------------------------------------------------
@@ -403,22 +443,67 @@
     @throw exception;
   }
 
-  NSMutableArray* libertyPoints = [NSMutableArray arrayWithCapacity:0];
-  for (GoPoint* point in _points)
+  if (! _libertyPoints)
   {
-    for (GoPoint* neighbour in point.neighbours)
+    self.libertyPoints = [NSMutableSet setWithCapacity:0];
+    for (GoPoint* point in _points)
     {
-      // Is it a liberty?
-      if ([neighbour hasStone])
-        continue;  // no
-      // Count the liberty if it hasn't been counted already
-      if (! [libertyPoints containsObject:neighbour])
-        [libertyPoints addObject:neighbour];
+      for (GoPoint* neighbour in point.neighbours)
+      {
+        // Is it a liberty?
+        if ([neighbour hasStone])
+          continue;  // no
+        [_libertyPoints addObject:neighbour];
+      }
     }
   }
   // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
   // is safe because a region's liberties can never exceed pow(2, 32).
-  return (int)[libertyPoints count];
+  return (int)[_libertyPoints count];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the liberties of the stone groups that are adjacent to
+/// @a point after the stone state of @a point has changed.
+///
+/// @a point must be part of this GoBoardRegion. GoPoint invokes this method
+/// every time its @e stoneState property is set. The stone state already must
+/// have its new value at the time this method is invoked.
+///
+/// Effects of this method are:
+/// - If @a point is now empty, it becomes a liberty of all adjacent stone
+///   groups
+/// - If @a point now has a stone, it is no longer a liberty of any adjacent
+///   stone group
+/// - The liberties of this GoBoardRegion are discarded. The stone state of
+///   @a point no longer matches the stone state of the other points in this
+///   GoBoardRegion, so the liberties cannot be determined until @a point has
+///   been moved to its new GoBoardRegion (or the other points have changed
+///   their stone state as well, as is the case when a stone group is
+///   captured).
+// -----------------------------------------------------------------------------
+- (void) updateLibertiesAfterStoneStateChangeOfPoint:(GoPoint*)point
+{
+  self.libertyPoints = nil;
+
+  bool isLiberty = ! [point hasStone];
+  for (GoPoint* neighbour in point.neighbours)
+  {
+    GoBoardRegion* neighbourRegion = neighbour.region;
+    if (neighbourRegion == self || ! neighbourRegion)
+      continue;
+    // We directly access the _libertyPoints member of the neighbourRegion
+    // instance for efficiency reasons. The member is nil if the neighbour
+    // region's liberties have not yet been calculated, or if the neighbour
+    // region is not a stone group.
+    NSMutableSet* neighbourLibertyPoints = neighbourRegion->_libertyPoints;
+    if (! neighbourLibertyPoints)
+      continue;
+    if (isLiberty)
+      [neighbourLibertyPoints addObject:point];
+    else
+      [neighbourLibertyPoints removeObject:point];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -486,7 +571,7 @@
     // Check if the current neighbour is connected to one of the other
     // neighbours that have been previously processed
     bool isNeighbourConnected = false;
-    for (NSArray* subRegion in subRegions)
+    for (NSSet* subRegion in subRegions)
     {
       if ([subRegion containsObject:neighbourOfRemovedPoint])
       {
@@ -499,7 +584,7 @@
     // If the neighbour is not connected, we can create a new subregion that
     // contains the current neighbour and its neighbours that are also in self
     // (the main region)
-    NSMutableArray* newSubRegion = [NSMutableArray arrayWithCapacity:0];
+    NSMutableSet* newSubRegion = [NSMutableSet setWithCapacity:0];
     [subRegions addObject:newSubRegion];
     [self fillSubRegion:newSubRegion containingPoint:neighbourOfRemovedPoint];
 
@@ -541,8 +626,12 @@
 ///   instrumentation as above shows that on an iPhone 3GS the current order of
 ///   checks makes this method ~15% faster (1678ms instead of 1956ms for the
 ///   reversed order of checks).
+/// - @a subRegion is an NSMutableSet instead of an NSMutableArray. This makes
+///   the membership check inside the for-loop O(1) instead of O(n), which
+///   matters a lot for the large empty regions that are split when a stone is
+///   placed.
 // -----------------------------------------------------------------------------
-- (void) fillSubRegion:(NSMutableArray*)subRegion containingPoint:(GoPoint*)point
+- (void) fillSubRegion:(NSMutableSet*)subRegion containingPoint:(GoPoint*)point
 {
   [subRegion addObject:point];
   for (GoPoint* neighbour in point.neighbours)
@@ -589,7 +678,7 @@
 /// @note This is a private backend helper method for
 /// splitRegionAfterRemovingPoint:().
 // -----------------------------------------------------------------------------
-- (void) moveSubRegion:(NSArray*)subRegion fromMainRegion:(GoBoardRegion*)mainRegion
+- (void) moveSubRegion:(NSSet*)subRegion fromMainRegion:(GoBoardRegion*)mainRegion
 {
   if (! subRegion)
   {
@@ -613,10 +702,10 @@
   if (0 == subRegion.count)
     return;
   
-  // We only check the attributes of the first point of the subregion, assuming
-  // that it is representative for the other points in the array. We don't check
-  // all points for efficiency reasons!
-  GoPoint* firstPointOfSubRegion = [subRegion objectAtIndex:0];
+  // We only check the attributes of one point of the subregion, assuming that
+  // it is representative for the other points in the set. We don't check all
+  // points for efficiency reasons!
+  GoPoint* firstPointOfSubRegion = [subRegion anyObject];
   GoBoardRegion* previousRegion = firstPointOfSubRegion.region;
   if (mainRegion != previousRegion)
   {
@@ -641,11 +730,23 @@
     }
   }
 
+  // The liberties of both regions are rebuilt when they are needed next time
+  self.libertyPoints = nil;
+  mainRegion.libertyPoints = nil;
+
   // Bulk-remove subRegion. We directly access the _points member of the
-  // mainRegion instance for efficiency reasons
-  [(NSMutableArray*)mainRegion->_points removeObjectsInArray:subRegion];
+  // mainRegion instance for efficiency reasons. We don't use
+  // removeObjectsInArray:() because that needs a linear search in subRegion
+  // for every point of mainRegion.
+  NSMutableArray* remainingPoints = [NSMutableArray arrayWithCapacity:mainRegion->_points.count];
+  for (GoPoint* point in mainRegion->_points)
+  {
+    if (! [subRegion containsObject:point])
+      [remainingPoints addObject:point];
+  }
+  mainRegion.points = remainingPoints;
   // Bulk-add subRegion
-  [(NSMutableArray*)_points addObjectsFromArray:subRegion];
+  [(NSMutableArray*)_points addObjectsFromArray:[subRegion allObjects]];
   // Update region references. Note that mainRegion may be deallocated by this
   // operation, so we must not use it after the loop completes.
   for (GoPoint* point in subRegion)
@@ -845,24 +946,16 @@
 {
   [encoder encodeInt:nscodingVersion forKey:nscodingVersionKey];
   [encoder encodeObject:self.points forKey:goBoardRegionPointsKey];
-  if (self.scoringMode)
-    [encoder encodeBool:self.scoringMode forKey:goBoardRegionScoringModeKey];
+  // Scoring mode and the cached information are not archived. Rebuilding the
+  // cache is cheap compared to unarchiving it - adjacent regions in particular
+  // make the archive a dense graph of GoBoardRegion references - and the cache
+  // is only needed if the user is in scoring mode when the app launches.
   if (self.territoryColor != GoColorNone)
     [encoder encodeInt:self.territoryColor forKey:goBoardRegionTerritoryColorKey];
   if (self.territoryInconsistencyFound)
     [encoder encodeBool:self.territoryInconsistencyFound forKey:goBoardRegionTerritoryInconsistencyFoundKey];
   if (self.stoneGroupState != GoStoneGroupStateUndefined)
     [encoder encodeInt:self.stoneGroupState forKey:goBoardRegionStoneGroupStateKey];
-  if (self.cachedSize != -1)
-    [encoder encodeInt:self.cachedSize forKey:goBoardRegionCachedSizeKey];
-  if (self.cachedIsStoneGroup)
-    [encoder encodeBool:self.cachedIsStoneGroup forKey:goBoardRegionCachedIsStoneGroupKey];
-  if (self.cachedColor != GoColorNone)
-    [encoder encodeInt:self.cachedColor forKey:goBoardRegionCachedColorKey];
-  if (self.cachedLiberties != -1)
-    [encoder encodeInt:self.cachedLiberties forKey:goBoardRegionCachedLibertiesKey];
-  if (self.cachedAdjacentRegions)
-    [encoder encodeObject:self.cachedAdjacentRegions forKey:goBoardRegionCachedAdjacentRegionsKey];
 }
 
 @end
@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoVertex;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoBoardTopology class stores the parts of a Go board that depend
+/// only on the board size and never change: the vertexes of all
+/// intersections, the neighbour relationships between intersections, the star
+/// points, the classification of intersections into edge and corner
+/// intersections, and the mapping of intersections under the board
+/// symmetries.
+///
+/// @ingroup go
+///
+/// GoBoardTopology objects are immutable. Because all boards of the same size
+/// have the same topology, clients should use the shared instance provided by
+/// sharedTopologyForBoardSize:() instead of creating their own
+/// GoBoardTopology objects. GoBoard uses the shared topology when it creates
+/// its GoPoint objects, and when it navigates between GoPoint objects. As a
+/// result creating a GoBoard does little more than allocating the GoPoint
+/// objects that hold the per-game stone state.
+///
+/// Intersections are identified by the same zero-based index that is used by
+/// GoBoardCore and by GoBoard::indexOfPoint:(), i.e. the intersection at
+/// vertex A1 has index 0, the intersection to the right of A1 has index 1,
+/// and so on, row by row.
+// -----------------------------------------------------------------------------
+@interface GoBoardTopology : NSObject
+{
+}
+
++ (GoBoardTopology*) sharedTopologyForBoardSize:(enum GoBoardSize)boardSize;
+- (id) initWithBoardSize:(enum GoBoardSize)boardSize;
+
+- (GoVertex*) vertexAtIndex:(int)index;
+- (int) indexOfNeighbourOfIndex:(int)index inDirection:(enum GoBoardDirection)direction;
+- (int) indexOfCorner:(enum GoBoardCorner)corner;
+- (bool) isStarPointAtIndex:(int)index;
+- (bool) isEdgeAtIndex:(int)index;
+- (bool) isCornerAtIndex:(int)index;
+- (int) indexOfIndex:(int)index transformedBySymmetry:(enum GoBoardSymmetry)symmetry;
++ (enum GoBoardSymmetry) inverseOfSymmetry:(enum GoBoardSymmetry)symmetry;
+
+/// @brief The board size that this GoBoardTopology describes.
+@property(nonatomic, assign, readonly) enum GoBoardSize boardSize;
+/// @brief The number of intersections, i.e. @e boardSize * @e boardSize.
+@property(nonatomic, assign, readonly) int numberOfPoints;
+/// @brief A list of GoVertex objects, one for each intersection. The list is
+/// sorted by intersection index.
+@property(nonatomic, retain, readonly) NSArray* vertexes;
+/// @brief A list of NSNumber objects with the indexes of the star points for
+/// the board size. The list is sorted by intersection index. The list is
+/// empty if the board size does not have any star points.
+@property(nonatomic, retain, readonly) NSArray* starPointIndexes;
+
+@end
@@ -0,0 +1,398 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoBoardTopology.h"
+#import "GoBoardCore.h"
+#import "GoVertex.h"
+
+
+// GoBoardCore::NeighbourList::neighbourInDirection is indexed with these values
+static_assert(GoBoardDirectionLeft == 0 && GoBoardDirectionRight == 1 && GoBoardDirectionUp == 2 && GoBoardDirectionDown == 3,
+              "GoBoardDirection values do not match the GoBoardCore neighbour table");
+
+/// @brief Shared GoBoardTopology objects, keyed by board size. Is protected by
+/// @synchronized([GoBoardTopology class]).
+static NSMutableDictionary* sharedTopologies = nil;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoBoardTopology.
+// -----------------------------------------------------------------------------
+@interface GoBoardTopology()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) enum GoBoardSize boardSize;
+@property(nonatomic, assign, readwrite) int numberOfPoints;
+@property(nonatomic, retain, readwrite) NSArray* vertexes;
+@property(nonatomic, retain, readwrite) NSArray* starPointIndexes;
+//@}
+/// @name Private properties
+//@{
+/// @brief The neighbour table that GoBoardCore maintains for the board size.
+/// The table is shared and lives until the process terminates.
+@property(nonatomic, assign) const GoBoardCore::NeighbourList* neighbourLists;
+@property(nonatomic, assign) bool* starPointFlags;
+@property(nonatomic, assign) bool* edgeFlags;
+@property(nonatomic, assign) bool* cornerFlags;
+/// @brief #GoBoardSymmetryMax entries per intersection, one for each board
+/// symmetry.
+@property(nonatomic, assign) int* symmetricIndexes;
+//@}
+@end
+
+
+@implementation GoBoardTopology
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared GoBoardTopology object for board size
+/// @a boardSize. The object is created when it is requested for the first
+/// time and then lives until the process terminates.
+///
+/// GoBoardTopology objects are immutable after initialization. It is
+/// therefore safe to share them between GoBoard objects and between threads.
+// -----------------------------------------------------------------------------
++ (GoBoardTopology*) sharedTopologyForBoardSize:(enum GoBoardSize)boardSize
+{
+  @synchronized(self)
+  {
+    if (! sharedTopologies)
+      sharedTopologies = [[NSMutableDictionary alloc] init];
+    NSNumber* key = [NSNumber numberWithInt:boardSize];
+    GoBoardTopology* topology = [sharedTopologies objectForKey:key];
+    if (! topology)
+    {
+      topology = [[[GoBoardTopology alloc] initWithBoardSize:boardSize] autorelease];
+      [sharedTopologies setObject:topology forKey:key];
+    }
+    return topology;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoBoardTopology object for board size @a boardSize.
+///
+/// @note This is the designated initializer of GoBoardTopology.
+// -----------------------------------------------------------------------------
+- (id) initWithBoardSize:(enum GoBoardSize)boardSize
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.boardSize = boardSize;
+  self.numberOfPoints = boardSize * boardSize;
+  _starPointFlags = new bool[_numberOfPoints];
+  _edgeFlags = new bool[_numberOfPoints];
+  _cornerFlags = new bool[_numberOfPoints];
+  _symmetricIndexes = new int[_numberOfPoints * GoBoardSymmetryMax];
+
+  [self setupVertexes];
+  self.neighbourLists = GoBoardCore::getNeighbourTable(boardSize).data();
+  [self setupStarPoints];
+  [self setupSymmetricIndexes];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoBoardTopology object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.vertexes = nil;
+  self.starPointIndexes = nil;
+  _neighbourLists = nullptr;
+  delete[] _starPointFlags;
+  _starPointFlags = nullptr;
+  delete[] _edgeFlags;
+  _edgeFlags = nullptr;
+  delete[] _cornerFlags;
+  _cornerFlags = nullptr;
+  delete[] _symmetricIndexes;
+  _symmetricIndexes = nullptr;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Creates the GoVertex objects of all intersections, and classifies
+/// intersections into edge and corner intersections.
+///
+/// This is an internal helper invoked during initialization.
+// -----------------------------------------------------------------------------
+- (void) setupVertexes
+{
+  NSMutableArray* vertexesLocal = [NSMutableArray arrayWithCapacity:_numberOfPoints];
+  struct GoVertexNumeric numericVertex;
+  for (numericVertex.y = 1; numericVertex.y <= _boardSize; ++numericVertex.y)
+  {
+    bool isHorizontalEdge = (numericVertex.y == 1 || numericVertex.y == _boardSize);
+    for (numericVertex.x = 1; numericVertex.x <= _boardSize; ++numericVertex.x)
+    {
+      bool isVerticalEdge = (numericVertex.x == 1 || numericVertex.x == _boardSize);
+      int index = [self indexOfNumericVertex:numericVertex];
+      _edgeFlags[index] = (isHorizontalEdge || isVerticalEdge);
+      _cornerFlags[index] = (isHorizontalEdge && isVerticalEdge);
+      [vertexesLocal addObject:[GoVertex vertexFromNumeric:numericVertex]];
+    }
+  }
+  // Make a copy that is immutable because we hand out references to the
+  // array, and we don't want clients to be able to change the array
+  self.vertexes = [NSArray arrayWithArray:vertexesLocal];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Determines the star points for the board size.
+///
+/// Star point definitions are read from the user defaults system. The
+/// definitions are immutable and are available only through the application
+/// defaults registered at application startup.
+///
+/// @note Star point definitions vary depending on which information source is
+/// queried. Fuego and Goban.app, for instance, do not have the same definitions
+/// for some board sizes. Sensei's Library only has definitions for 9x9, 13x13
+/// and 19x19. The current star point definitions in Little Go match those
+/// provided by Fuego.
+///
+/// This is an internal helper invoked during initialization.
+// -----------------------------------------------------------------------------
+- (void) setupStarPoints
+{
+  for (int index = 0; index < _numberOfPoints; ++index)
+    _starPointFlags[index] = false;
+
+  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSDictionary* dictionary = [userDefaults dictionaryForKey:starPointsKey];
+  NSString* boardSizeKey = [NSString stringWithFormat:@"%d", _boardSize];
+  NSString* starPointVertexListAsString = [dictionary valueForKey:boardSizeKey];
+  if (starPointVertexListAsString.length > 0)
+  {
+    for (NSString* starPointVertex in [starPointVertexListAsString componentsSeparatedByString:@","])
+    {
+      GoVertex* vertex = [GoVertex vertexFromString:starPointVertex];
+      _starPointFlags[[self indexOfNumericVertex:vertex.numeric]] = true;
+    }
+  }
+
+  NSMutableArray* starPointIndexesLocal = [NSMutableArray arrayWithCapacity:0];
+  for (int index = 0; index < _numberOfPoints; ++index)
+  {
+    if (_starPointFlags[index])
+      [starPointIndexesLocal addObject:[NSNumber numberWithInt:index]];
+  }
+  self.starPointIndexes = [NSArray arrayWithArray:starPointIndexesLocal];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Determines for each intersection the index of the intersection onto
+/// which it is mapped by each of the board symmetries.
+// -----------------------------------------------------------------------------
+- (void) setupSymmetricIndexes
+{
+  int maximumCoordinate = _boardSize - 1;
+  for (int index = 0; index < _numberOfPoints; ++index)
+  {
+    int x = index % _boardSize;
+    int y = index / _boardSize;
+    for (int symmetry = 0; symmetry < GoBoardSymmetryMax; ++symmetry)
+    {
+      int symmetricX;
+      int symmetricY;
+      switch (symmetry)
+      {
+        case GoBoardSymmetryRotate90:
+          symmetricX = maximumCoordinate - y;
+          symmetricY = x;
+          break;
+        case GoBoardSymmetryRotate180:
+          symmetricX = maximumCoordinate - x;
+          symmetricY = maximumCoordinate - y;
+          break;
+        case GoBoardSymmetryRotate270:
+          symmetricX = y;
+          symmetricY = maximumCoordinate - x;
+          break;
+        case GoBoardSymmetryMirrorHorizontal:
+          symmetricX = maximumCoordinate - x;
+          symmetricY = y;
+          break;
+        case GoBoardSymmetryMirrorVertical:
+          symmetricX = x;
+          symmetricY = maximumCoordinate - y;
+          break;
+        case GoBoardSymmetryTranspose:
+          symmetricX = y;
+          symmetricY = x;
+          break;
+        case GoBoardSymmetryAntiTranspose:
+          symmetricX = maximumCoordinate - y;
+          symmetricY = maximumCoordinate - x;
+          break;
+        default:
+          symmetricX = x;
+          symmetricY = y;
+          break;
+      }
+      _symmetricIndexes[(index * GoBoardSymmetryMax) + symmetry] = (symmetricY * _boardSize) + symmetricX;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a description for this GoBoardTopology object.
+///
+/// This method is invoked when GoBoardTopology needs to be represented as a
+/// string, i.e. by NSLog, or when the debugger command "po" is used on the
+/// object.
+// -----------------------------------------------------------------------------
+- (NSString*) description
+{
+  // Don't use self to access properties to avoid unnecessary overhead during
+  // debugging
+  return [NSString stringWithFormat:@"GoBoardTopology(%p): size = %d", self, _boardSize];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoVertex object of the intersection with index
+/// @a index.
+// -----------------------------------------------------------------------------
+- (GoVertex*) vertexAtIndex:(int)index
+{
+  return [_vertexes objectAtIndex:index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection that is a direct neighbour of
+/// the intersection with index @a index, located in direction @a direction.
+/// Returns -1 if no neighbour exists in the specified direction.
+// -----------------------------------------------------------------------------
+- (int) indexOfNeighbourOfIndex:(int)index inDirection:(enum GoBoardDirection)direction
+{
+  switch (direction)
+  {
+    case GoBoardDirectionLeft:
+    case GoBoardDirectionRight:
+    case GoBoardDirectionUp:
+    case GoBoardDirectionDown:
+      return _neighbourLists[index].neighbourInDirection[direction];
+    case GoBoardDirectionNext:
+      return (index < _numberOfPoints - 1) ? index + 1 : -1;
+    case GoBoardDirectionPrevious:
+      return (index > 0) ? index - 1 : -1;
+    default:
+      return -1;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection located at the corner of the
+/// board defined by @a corner.
+///
+/// Raises an @e NSInvalidArgumentException if @a corner is invalid.
+// -----------------------------------------------------------------------------
+- (int) indexOfCorner:(enum GoBoardCorner)corner
+{
+  switch (corner)
+  {
+    case GoBoardCornerBottomLeft:
+      return 0;
+    case GoBoardCornerBottomRight:
+      return _boardSize - 1;
+    case GoBoardCornerTopLeft:
+      return _numberOfPoints - _boardSize;
+    case GoBoardCornerTopRight:
+      return _numberOfPoints - 1;
+    default:
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Invalid board corner %d", corner];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the intersection with index @a index is a star
+/// point.
+// -----------------------------------------------------------------------------
+- (bool) isStarPointAtIndex:(int)index
+{
+  return _starPointFlags[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the intersection with index @a index is located on
+/// one of the edges of the board. Corner intersections are also edge
+/// intersections.
+// -----------------------------------------------------------------------------
+- (bool) isEdgeAtIndex:(int)index
+{
+  return _edgeFlags[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the intersection with index @a index is located in
+/// one of the corners of the board.
+// -----------------------------------------------------------------------------
+- (bool) isCornerAtIndex:(int)index
+{
+  return _cornerFlags[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection onto which the intersection
+/// with index @a index is mapped by the board symmetry @a symmetry.
+// -----------------------------------------------------------------------------
+- (int) indexOfIndex:(int)index transformedBySymmetry:(enum GoBoardSymmetry)symmetry
+{
+  return _symmetricIndexes[(index * GoBoardSymmetryMax) + symmetry];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board symmetry that undoes the board symmetry
+/// @a symmetry. The rotations by 90 and 270 degrees undo each other, all other
+/// symmetries undo themselves.
+// -----------------------------------------------------------------------------
++ (enum GoBoardSymmetry) inverseOfSymmetry:(enum GoBoardSymmetry)symmetry
+{
+  switch (symmetry)
+  {
+    case GoBoardSymmetryRotate90:
+      return GoBoardSymmetryRotate270;
+    case GoBoardSymmetryRotate270:
+      return GoBoardSymmetryRotate90;
+    default:
+      return symmetry;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection identified by
+/// @a numericVertex.
+///
+/// This is an internal helper.
+// -----------------------------------------------------------------------------
+- (int) indexOfNumericVertex:(struct GoVertexNumeric)numericVertex
+{
+  return ((numericVertex.y - 1) * _boardSize) + (numericVertex.x - 1);
+}
+
+@end
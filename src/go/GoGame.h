@@ -19,11 +19,13 @@
 @class GoBoard;
 @class GoBoardPosition;
 @class GoGameDocument;
+@class GoGameSnapshot;
 @class GoGameRules;
 @class GoMove;
 @class GoMoveNodeCreationOptions;
 @class GoNode;
 @class GoNodeModel;
+@class GoNodeTextIndex;
 @class GoPlayer;
 @class GoPoint;
 @class GoScore;
@@ -76,6 +78,7 @@
 - (bool) isLegalMove:(GoPoint*)point isIllegalReason:(enum GoMoveIsIllegalReason*)reason;
 - (bool) isLegalMove:(GoPoint*)point byColor:(enum GoColor)color isIllegalReason:(enum GoMoveIsIllegalReason*)reason;
 - (bool) isLegalMove:(GoPoint*)point byColor:(enum GoColor)color afterNode:(GoNode*)node isIllegalReason:(enum GoMoveIsIllegalReason*)reason;
+- (NSDictionary*) legalMoveMapForColor:(enum GoColor)color;
 - (bool) isLegalPassMoveIllegalReason:(enum GoMoveIsIllegalReason*)reason;
 - (bool) isLegalPassMoveByColor:(enum GoColor)color illegalReason:(enum GoMoveIsIllegalReason*)reason;
 - (bool) isLegalPassMoveByColor:(enum GoColor)color afterNode:(GoNode*)node illegalReason:(enum GoMoveIsIllegalReason*)reason;
@@ -87,6 +90,7 @@
 - (void) changeSetupFirstMoveColor:(enum GoColor)newValue;
 - (void) changeSetupPoint:(GoPoint*)point toStoneState:(enum GoColor)stoneState;
 - (void) discardAllSetup;
+- (GoGameSnapshot*) snapshotAtCurrentNode;
 
 /// @brief The type of this GoGame object.
 @property(nonatomic, assign) enum GoGameType type;
@@ -215,5 +219,10 @@
 /// @brief The Zobrist hash after handicap stones are placed. Is recalculated
 /// every time the property @e handicapPoints changes.
 @property(nonatomic, assign) long long zobristHashAfterHandicap;
+/// @brief The full-text index over the comments and labels of the nodes in
+/// this game's game tree. The index is not archived, it is built by
+/// LoadGameCommand after a game was loaded, or when it is searched for the
+/// first time.
+@property(nonatomic, retain, readonly) GoNodeTextIndex* nodeTextIndex;
 
 @end
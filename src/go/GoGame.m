@@ -23,22 +23,52 @@
 #import "GoGameAdditions.h"
 #import "GoGameDocument.h"
 #import "GoGameRules.h"
+#import "GoGameSnapshot.h"
 #import "GoMove.h"
 #import "GoMoveNodeCreationOptions.h"
 #import "GoNode.h"
 #import "GoNodeModel.h"
 #import "GoNodeSetup.h"
+#import "GoNodeTextIndex.h"
 #import "GoPlayer.h"
 #import "GoPoint.h"
 #import "GoScore.h"
+#import "GoSuperkoHistory.h"
 #import "GoUtilities.h"
 #import "GoVertex.h"
 #import "GoZobristTable.h"
+#import "../diagnostics/SignpostLog.h"
 #import "../main/ApplicationDelegate.h"
 #import "../player/Player.h"
+#import "../shared/ModelMutationTransaction.h"
 #import "../utility/ExceptionUtility.h"
 #import "../utility/NSArrayAdditions.h"
 
+// System includes
+#import <os/signpost.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoGame.
+// -----------------------------------------------------------------------------
+@interface GoGame()
+/// @name Privately declared properties
+//@{
+@property(nonatomic, retain) GoSuperkoHistory* superkoHistory;
+@property(nonatomic, retain, readwrite) GoNodeTextIndex* nodeTextIndex;
+/// @brief The result of the most recent invocation of legalMoveMapForColor:().
+@property(nonatomic, retain) NSDictionary* legalMoveMap;
+/// @brief The node of the board position for which @e legalMoveMap was
+/// determined.
+@property(nonatomic, retain) GoNode* legalMoveMapNode;
+/// @brief The Zobrist hash of @e legalMoveMapNode at the time when
+/// @e legalMoveMap was determined.
+@property(nonatomic, assign) long long legalMoveMapZobristHash;
+/// @brief The color for which @e legalMoveMap was determined.
+@property(nonatomic, assign) enum GoColor legalMoveMapColor;
+//@}
+@end
+
 
 @implementation GoGame
 
@@ -85,6 +115,8 @@
   _score = [[GoScore alloc] initWithGame:self];
   self.setupFirstMoveColor = GoColorNone;
   _zobristHashAfterHandicap = 0;
+  _superkoHistory = [[GoSuperkoHistory alloc] initWithGame:self];
+  _nodeTextIndex = [[GoNodeTextIndex alloc] initWithRootNode:_nodeModel.rootNode];
 
   return self;
 }
@@ -120,9 +152,9 @@
   _document = [[decoder decodeObjectOfClass:[GoGameDocument class] forKey:goGameDocumentKey] retain];
   _score = [[decoder decodeObjectOfClass:[GoScore class] forKey:goGameScoreKey] retain];
   self.setupFirstMoveColor = [decoder decodeIntForKey:goGameSetupFirstMoveColorKey];
-  // The hash was not archived. Whoever is unarchiving this GoGame is
-  // responsible for re-calculating the hash.
-  _zobristHashAfterHandicap = 0;
+  _zobristHashAfterHandicap = [decoder decodeInt64ForKey:goGameZobristHashAfterHandicapKey];
+  _superkoHistory = [[GoSuperkoHistory alloc] initWithGame:self];
+  _nodeTextIndex = [[GoNodeTextIndex alloc] initWithRootNode:_nodeModel.rootNode];
 
   return self;
 }
@@ -158,6 +190,10 @@
   self.rules = nil;
   self.document = nil;
   self.score = nil;
+  self.superkoHistory = nil;
+  self.nodeTextIndex = nil;
+  self.legalMoveMap = nil;
+  self.legalMoveMapNode = nil;
 
   [super dealloc];
 }
@@ -195,7 +231,7 @@
   if (_state == newValue)
     return;
   _state = newValue;
-  [[NSNotificationCenter defaultCenter] postNotificationName:goGameStateChanged object:self];
+  [[ModelMutationTransaction sharedTransaction] postNotificationName:goGameStateChanged object:self];
 }
 
 // -----------------------------------------------------------------------------
@@ -326,28 +362,38 @@
     @throw exception;
   }
 
-  // The new move is the successor of the most recent move at the current board
-  // position, so we must not use self.lastMove
-  GoNode* nodeWithMostRecentMove = [GoUtilities nodeWithMostRecentMove:self.boardPosition.currentNode];
-  GoMove* mostRecentMove = nodeWithMostRecentMove ? nodeWithMostRecentMove.goMove : nil;
-  GoMove* move = [GoMove move:GoMoveTypePlay by:self.nextMovePlayer after:mostRecentMove];
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryGoModel];
+  os_signpost_id_t signpostID = os_signpost_id_make_with_pointer(signpostLog, self);
+  os_signpost_interval_begin(signpostLog, signpostID, "GoGamePlay", "%{public}@", point.vertex.string);
   @try
   {
-    move.point = point;
+    // The new move is the successor of the most recent move at the current
+    // board position, so we must not use self.lastMove
+    GoNode* nodeWithMostRecentMove = [GoUtilities nodeWithMostRecentMove:self.boardPosition.currentNode];
+    GoMove* mostRecentMove = nodeWithMostRecentMove ? nodeWithMostRecentMove.goMove : nil;
+    GoMove* move = [GoMove move:GoMoveTypePlay by:self.nextMovePlayer after:mostRecentMove];
+    @try
+    {
+      move.point = point;
+    }
+    @catch (NSException* exception)
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Exception occurred while playing on intersection %@. Exception = %@", point.vertex.string, exception];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* newException = [NSException exceptionWithName:NSInvalidArgumentException
+                                                          reason:errorMessage
+                                                        userInfo:nil];
+      @throw newException;
+    }
+
+    GoNode* node = [GoNode node];
+    node.goMove = move;
+    [self addNodeToTreeAndUpdateBoardPosition:node withMoveNodeCreationOptions:moveNodeCreationOptions];
   }
-  @catch (NSException* exception)
+  @finally
   {
-    NSString* errorMessage = [NSString stringWithFormat:@"Exception occurred while playing on intersection %@. Exception = %@", point.vertex.string, exception];
-    DDLogError(@"%@: %@", self, errorMessage);
-    NSException* newException = [NSException exceptionWithName:NSInvalidArgumentException
-                                                        reason:errorMessage
-                                                      userInfo:nil];
-    @throw newException;
+    os_signpost_interval_end(signpostLog, signpostID, "GoGamePlay");
   }
-
-  GoNode* node = [GoNode node];
-  node.goMove = move;
-  [self addNodeToTreeAndUpdateBoardPosition:node withMoveNodeCreationOptions:moveNodeCreationOptions];
 }
 
 // -----------------------------------------------------------------------------
@@ -486,6 +532,10 @@
 /// posts the notifications to the default notification center that are required
 /// to inform the rest of the system about the changes that took place.
 ///
+/// The notifications are posted via ModelMutationTransaction, so if a
+/// transaction is in progress they are merged with the notifications of other
+/// changes and posted only when the transaction is committed.
+///
 /// This is a private helper for play:withMoveNodeCreationOptions:() and
 /// passWithMoveNodeCreationOptions:(). See the documentation of these methods
 /// for details about how @a newNode is being inserted, when nodes are
@@ -595,15 +645,15 @@
   // At this point the new node exists in the node tree, but it is still missing
   // the Zobrist hash.
 
-  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  ModelMutationTransaction* transaction = [ModelMutationTransaction sharedTransaction];
 
   // Must be sent first so that observers get a chance to incorporate the new
   // node into their models before it becomes the new current board position.
-  [center postNotificationName:goNodeTreeLayoutDidChange object:nil];
+  [transaction postNotificationName:goNodeTreeLayoutDidChange object:[self.nodeModel finishTreeChangeBatch]];
 
   if (shouldChangeCurrentGameVariation)
   {
-    [center postNotificationName:currentGameVariationWillChange object:nil];
+    [transaction postNotificationName:currentGameVariationWillChange object:nil];
     [self.nodeModel changeToVariationContainingNode:newNode];
   }
 
@@ -612,7 +662,7 @@
   if (oldNumberOfBoardPositions != newNumberOfBoardPositions)
   {
     self.boardPosition.numberOfBoardPositions = newNumberOfBoardPositions;
-    [center postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
+    [transaction postNotificationName:numberOfBoardPositionsDidChange object:@[[NSNumber numberWithInt:oldNumberOfBoardPositions], [NSNumber numberWithInt:newNumberOfBoardPositions]]];
   }
 
   // Changing the current board position has the following effects:
@@ -636,11 +686,13 @@
   // the notification about the board position change.
   [newNode calculateZobristHash:self];
 
-  [center postNotificationName:currentBoardPositionDidChange object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:newCurrentBoardPosition]]];
+  [transaction postNotificationName:currentBoardPositionDidChange
+                        object:@[[NSNumber numberWithInt:oldCurrentBoardPosition], [NSNumber numberWithInt:newCurrentBoardPosition]]
+                      userInfo:@{changedPointsKey: [self.boardPosition finishChangedPointsBatch]}];
 
   if (shouldChangeCurrentGameVariation)
   {
-    [center postNotificationName:currentGameVariationDidChange object:nil];
+    [transaction postNotificationName:currentGameVariationDidChange object:nil];
   }
 }
 
@@ -924,31 +976,31 @@
 ///
 /// If this method returns @e false, the out parameter
 /// @a suicidalIntersectionsString is filled with a comma-separated list of
-/// vertices that contain suicidal stones with no liberties. If this method
-/// returns @e true, the value of @a reason is undefined.
+/// vertices that contain suicidal stones with no liberties. The vertices are
+/// sorted by row, then by column. If this method returns @e true,
+/// @a suicidalIntersectionsString is an empty string.
+///
+/// This method is cheap to invoke repeatedly (e.g. after each setup node while
+/// a game is loaded) because only the stone groups that were affected by
+/// stone state changes since the last invocation are re-examined.
 // -----------------------------------------------------------------------------
 - (bool) isLegalBoardSetup:(NSString**)suicidalIntersectionsString
 {
-  int numberOfSuicidalIntersections = 0;
-  *suicidalIntersectionsString = @"";
-
-  for (GoBoardRegion* region in self.board.regions)
+  // GoBoard maintains the stones without liberties incrementally, so we don't
+  // have to examine every stone group on the board
+  NSArray* suicidalPoints = [self.board stonesWithoutLiberties];
+  if (suicidalPoints.count == 0)
   {
-    if (! region.isStoneGroup)
-      continue;
-    if (region.liberties > 0)
-      continue;
-
-    for (GoPoint* suicidalPoint in region.points)
-    {
-      if (numberOfSuicidalIntersections > 0)
-        *suicidalIntersectionsString = [*suicidalIntersectionsString stringByAppendingString:@", "];
-      *suicidalIntersectionsString = [*suicidalIntersectionsString stringByAppendingString:suicidalPoint.vertex.string];
-      numberOfSuicidalIntersections++;
-    }
+    *suicidalIntersectionsString = @"";
+    return true;
   }
 
-  return (numberOfSuicidalIntersections == 0);
+  NSMutableArray* suicidalVertices = [NSMutableArray arrayWithCapacity:suicidalPoints.count];
+  for (GoPoint* suicidalPoint in suicidalPoints)
+    [suicidalVertices addObject:suicidalPoint.vertex.string];
+  *suicidalIntersectionsString = [suicidalVertices componentsJoinedByString:@", "];
+
+  return false;
 }
 
 // -----------------------------------------------------------------------------
@@ -1039,6 +1091,98 @@
     @throw exception;
   }
 
+  // IMPORTANT: The specified node might be a non-move node, so we have to
+  // search through the variation backwards until we find a move.
+  GoNode* nodeWithMostRecentMove = [GoUtilities nodeWithMostRecentMove:node];
+
+  return [self isLegalMove:point
+                   byColor:color
+   nodeWithMostRecentMove:nodeWithMostRecentMove
+           isIllegalReason:reason];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a dictionary that describes which intersections are legal
+/// for the player who plays @a color in the current board position. The
+/// dictionary is the result of invoking isLegalMove:byColor:isIllegalReason:()
+/// for all intersections, but is determined in a single sweep over the board.
+///
+/// The keys of the dictionary are the vertex strings (e.g. "A1") of the
+/// intersections on which playing a stone would be illegal. The values are
+/// NSNumber objects with the corresponding GoMoveIsIllegalReason value.
+/// Intersections that do not appear in the dictionary are legal.
+///
+/// The dictionary is cached: As long as the current board position does not
+/// change, repeated invocations with the same @a color return the same
+/// dictionary object without doing any work. The cache is keyed by the
+/// Zobrist hash of the current board position, but also by the node of the
+/// current board position because ko detection depends on how the board
+/// position came about.
+///
+/// Raises @e NSInvalidArgumentException if @a color is neither #GoColorBlack
+/// nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) legalMoveMapForColor:(enum GoColor)color
+{
+  if (color != GoColorBlack && color != GoColorWhite)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Invalid color argument %d", color];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  GoNode* node = self.boardPosition.currentNode;
+  if (self.legalMoveMap &&
+      self.legalMoveMapNode == node &&
+      self.legalMoveMapZobristHash == node.zobristHash &&
+      self.legalMoveMapColor == color)
+  {
+    return self.legalMoveMap;
+  }
+
+  // The work that does not depend on the intersection is done only once
+  GoNode* nodeWithMostRecentMove = [GoUtilities nodeWithMostRecentMove:node];
+
+  NSMutableDictionary* legalMoveMap = [NSMutableDictionary dictionary];
+  enum GoMoveIsIllegalReason reason;
+  GoPoint* point = [self.board pointAtVertex:@"A1"];
+  for (; point; point = point.next)
+  {
+    bool isLegalMove = [self isLegalMove:point
+                                 byColor:color
+                 nodeWithMostRecentMove:nodeWithMostRecentMove
+                         isIllegalReason:&reason];
+    if (! isLegalMove)
+      [legalMoveMap setObject:[NSNumber numberWithInt:reason] forKey:point.vertex.string];
+  }
+
+  self.legalMoveMap = legalMoveMap;
+  self.legalMoveMapNode = node;
+  self.legalMoveMapZobristHash = node.zobristHash;
+  self.legalMoveMapColor = color;
+
+  return legalMoveMap;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if playing a stone on the intersection represented by
+/// @a point would be legal for the player who plays @a color in the board
+/// position after @a nodeWithMostRecentMove. @a nodeWithMostRecentMove is nil
+/// if no moves have been played yet.
+///
+/// This is an internal helper for
+/// isLegalMove:byColor:afterNode:isIllegalReason:() and
+/// legalMoveMapForColor:(). Unlike those methods, this method does not check
+/// its arguments.
+// -----------------------------------------------------------------------------
+  - (bool) isLegalMove:(GoPoint*)point
+               byColor:(enum GoColor)color
+nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
+       isIllegalReason:(enum GoMoveIsIllegalReason*)reason
+{
   // We could use the Fuego-specific GTP command "go_point_info" to obtain
   // the desired information, but parsing the response would require some
   // effort, is prone to fail when Fuego changes its response format, and
@@ -1052,9 +1196,6 @@
     return false;
   }
 
-  // IMPORTANT: The specified node might be a non-move node, so we have to
-  // search through the variation backwards until we find a move.
-  GoNode* nodeWithMostRecentMove = [GoUtilities nodeWithMostRecentMove:node];
   if (nodeWithMostRecentMove)
   {
     if (nodeWithMostRecentMove.goMove.moveNumber == maximumNumberOfMoves)
@@ -1064,64 +1205,30 @@
     }
   }
 
-  // Point is an empty intersection with at least one other empty intersection
-  // as neighbour
-  if ([point liberties] > 0)
-  {
-    // Because the point has liberties a simple ko is not possible
-    bool isSuperko;
-    bool isKoMove = [self isKoMove:point moveColor:color simpleKoIsPossible:false isSuperko:&isSuperko nodeWithMostRecentMove:nodeWithMostRecentMove];
-    if (isKoMove)
-      *reason = isSuperko ? GoMoveIsIllegalReasonSuperko : GoMoveIsIllegalReasonSimpleKo;
-    return !isKoMove;
-  }
-  // Point is an empty intersection that is surrounded by stones
-  else
+  // The board examines the neighbourhood of the point in a single query:
+  // - If the point has at least one empty neighbour, or if we can connect to a
+  //   friendly colored stone group without killing it, the move is not a
+  //   suicide and a simple ko is not possible
+  // - If we can capture opposing stone groups the move is also not a suicide,
+  //   but a simple ko is possible if we are NOT connecting
+  // - Otherwise no opposing stones can be captured and there are no friendly
+  //   groups with sufficient liberties to connect to, so the move is a suicide
+  bool simpleKoIsPossible;
+  bool isSuicide = [self.board isSuicideMoveAtPoint:point
+                                            byColor:color
+                                 simpleKoIsPossible:&simpleKoIsPossible];
+  if (isSuicide)
   {
-    // Pass 1: Check if we can connect to a friendly colored stone group
-    // without killing it
-    NSArray* neighbourRegionsFriendly = [point neighbourRegionsWithColor:color];
-    for (GoBoardRegion* neighbourRegion in neighbourRegionsFriendly)
-    {
-      // If the friendly stone group has more than one liberty, we are sure that
-      // we are not killing it. The only thing that can still make the move
-      // illegal is a ko (but since we are connecting, a simple ko is not
-      // possible here).
-      if ([neighbourRegion liberties] > 1)
-      {
-        bool isSuperko;
-        bool isKoMove = [self isKoMove:point moveColor:color simpleKoIsPossible:false isSuperko:&isSuperko nodeWithMostRecentMove:nodeWithMostRecentMove];
-        if (isKoMove)
-          *reason = isSuperko ? GoMoveIsIllegalReasonSuperko : GoMoveIsIllegalReasonSimpleKo;
-        return !isKoMove;
-      }
-    }
-
-    // Pass 2: Check if we can capture opposing stone groups
-    enum GoColor opponentColor = (color == GoColorBlack ? GoColorWhite : GoColorBlack);
-    NSArray* neighbourRegionsOpponent = [point neighbourRegionsWithColor:opponentColor];
-    for (GoBoardRegion* neighbourRegion in neighbourRegionsOpponent)
-    {
-      // If the opposing stone group has only one liberty left we can capture
-      // it. The only thing that can still make the move illegal is a ko.
-      if ([neighbourRegion liberties] == 1)
-      {
-        // A simple Ko situation is possible only if we are NOT connecting
-        bool isSimpleKoStillPossible = (0 == neighbourRegionsFriendly.count);
-        bool isSuperko;
-        bool isKoMove = [self isKoMove:point moveColor:color simpleKoIsPossible:isSimpleKoStillPossible isSuperko:&isSuperko nodeWithMostRecentMove:nodeWithMostRecentMove];
-        if (isKoMove)
-          *reason = isSuperko ? GoMoveIsIllegalReasonSuperko : GoMoveIsIllegalReasonSimpleKo;
-        return !isKoMove;
-      }
-    }
-
-    // If we arrive here, no opposing stones can be captured and there are no
-    // friendly groups with sufficient liberties to connect to
-    // -> the move is a suicide and therefore illegal
     *reason = GoMoveIsIllegalReasonSuicide;
     return false;
   }
+
+  // The only thing that can still make the move illegal is a ko
+  bool isSuperko;
+  bool isKoMove = [self isKoMove:point moveColor:color simpleKoIsPossible:simpleKoIsPossible isSuperko:&isSuperko nodeWithMostRecentMove:nodeWithMostRecentMove];
+  if (isKoMove)
+    *reason = isSuperko ? GoMoveIsIllegalReasonSuperko : GoMoveIsIllegalReasonSimpleKo;
+  return !isKoMove;
 }
 
 // -----------------------------------------------------------------------------
@@ -1217,73 +1324,19 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
         return false;
 
       // nodeWithMostRecentBoardStateChangeBeforeMostRecentMove contained a
-      // move, so there are potential more moves before that => find and examine
-      // all of them here
-      GoNode* nodeWithMostRecentBoardStateChange = [GoUtilities nodeWithMostRecentBoardStateChange:nodeWithMostRecentBoardStateChangeBeforeMostRecentMove.parent];
-      // Remember the node with the first move here and in the loop, so that
-      // we don't have to search for it unnecessarily after the loop
-      GoNode* nodeWithFirstMove = nodeWithMostRecentBoardStateChangeBeforeMostRecentMove;
-      for (;
-           nodeWithMostRecentBoardStateChange && nodeWithMostRecentBoardStateChange.goMove;
-           nodeWithMostRecentBoardStateChange = [GoUtilities nodeWithMostRecentBoardStateChange:nodeWithMostRecentBoardStateChange.parent])
-      {
-        nodeWithFirstMove = nodeWithMostRecentBoardStateChange;
-
-        // Situational superko only examines board positions that resulted from
-        // moves made by the same color
-        if (GoKoRuleSuperkoSituational == koRule && nodeWithMostRecentBoardStateChange.goMove.player.color != moveColor)
-            continue;
-
-        if (zobristHashOfHypotheticalMove == nodeWithMostRecentBoardStateChange.zobristHash)
-        {
-          *isSuperko = true;
-          return true;
-        }
-      }
-
-      // At this point nodeWithMostRecentBoardStateChange is either the node
-      // before the first move that contains setup, or it is nil if no such
-      // setup node exists.
-      long long zobristHashPriorToFirstMove;
-      if (nodeWithMostRecentBoardStateChange)
-        zobristHashPriorToFirstMove = nodeWithMostRecentBoardStateChange.zobristHash;
-      else
-        zobristHashPriorToFirstMove = self.zobristHashAfterHandicap;
-
-      // Situational superko only examines board positions that resulted from
-      // moves made by the same color. But which color did the board position
-      // prior to the first move result from? The only possible answer can be:
-      // The opposing color of the first move. There are two ways how to
-      // determine the color of the first move:
-      // - Find out which color a logical first move would have had, i.e.
-      //   without looking at the actually played first move. The color of the
-      //   logical first move is this:
-      //   - self.setupFirstMoveColor, if it is not GoColorNone
-      //   - GoColorBlack, if handicap is 0
-      //   - GoColorWhite, if handicap is >0
-      // - Look at the first move as it was actually played. If we think about
-      //   what's possible in an .sgf file, we see that the first move can be
-      //   any color - even if it defies the game logic (handicap) or
-      //   contradicts the .sgf file's own data (first move color is != setup
-      //   player color).
-      // Both approaches have their merits, but to be on the safe side we
-      // choose the same implementation as Fuego: Look at the first move as it
-      // was actually played.
-      if (GoKoRuleSuperkoSituational == koRule)
-      {
-        enum GoColor colorOfZobristHashPriorToFirstMove =
-          [GoUtilities alternatingColorForColor:nodeWithFirstMove.goMove.player.color];
-        if (colorOfZobristHashPriorToFirstMove != moveColor)
-          return false;
-      }
-
-      if (zobristHashOfHypotheticalMove == zobristHashPriorToFirstMove)
-      {
+      // move, so there are potential more moves before that. GoSuperkoHistory
+      // remembers the Zobrist hashes of all of them, and of the board position
+      // prior to the first move. The hashes also include the board position
+      // after nodeWithMostRecentMove, but the hypothetical move can never
+      // recreate that board position because it places a stone on an
+      // intersection that is empty in that board position.
+      bool isSuperkoMove = [self.superkoHistory isSuperko:zobristHashOfHypotheticalMove
+                                                  byColor:moveColor
+                                                   koRule:koRule
+                                                afterNode:nodeWithMostRecentMove];
+      if (isSuperkoMove)
         *isSuperko = true;
-        return true;
-      }
-
-      return false;
+      return isSuperkoMove;
     }
     default:
     {
@@ -1328,15 +1381,7 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
 // -----------------------------------------------------------------------------
 - (NSArray*) stonesWithColor:(enum GoColor)color withSingleLibertyAt:(GoPoint*)point
 {
-  NSMutableArray* stonesWithSingleLiberty = [NSMutableArray arrayWithCapacity:0];
-  // The array we get is guaranteed to have no duplicates
-  NSArray* neighbourRegionsOpponent = [point neighbourRegionsWithColor:color];
-  for (GoBoardRegion* neighbourRegion in neighbourRegionsOpponent)
-  {
-    if ([neighbourRegion liberties] == 1)
-      [stonesWithSingleLiberty addObjectsFromArray:neighbourRegion.points];
-  }
-  return stonesWithSingleLiberty;
+  return [self.board stonesWithColor:color inAtariWithLibertyAtPoint:point];
 }
 
 // -----------------------------------------------------------------------------
@@ -1587,7 +1632,9 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
   if (rootNode.goNodeSetup)
     [rootNode.goNodeSetup updatePreviousSetupInformationAfterHandicapStonesDidChange:self];
 
-  rootNode.zobristHash = [self.board.zobristTable hashForNode:rootNode inGame:self];
+  [rootNode updateZobristHashAndPropagateToSubtree:self];
+  [self.superkoHistory invalidate];
+  [self.nodeModel discardBoardSnapshotsFromIndex:0];
 }
 
 // -----------------------------------------------------------------------------
@@ -1614,13 +1661,9 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
   [encoder encodeObject:self.document forKey:goGameDocumentKey];
   [encoder encodeObject:self.score forKey:goGameScoreKey];
   [encoder encodeInt:self.setupFirstMoveColor forKey:goGameSetupFirstMoveColorKey];
-  // GoZobristTable is not archived, instead a new GoZobristTable object with
-  // random values is created each time when a game is unarchived. Zobrist
-  // hashes created by the previous GoZobristTable object are thus invalid.
-  // This is the reason why we don't archive self.zobristHashAfterHandicap
-  // here - it doesn't make sense to archive an invalid value. A side effect of
-  // not archiving self.zobristHashAfterHandicap is that the overall archive
-  // becomes smaller.
+  // GoZobristTable is not archived, but because it always generates the same
+  // values for a given board size the hash remains valid after unarchiving.
+  [encoder encodeInt64:self.zobristHashAfterHandicap forKey:goGameZobristHashAfterHandicapKey];
 }
 
 // -----------------------------------------------------------------------------
@@ -1894,7 +1937,7 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
     }
   }
 
-  [[NSNotificationCenter defaultCenter] postNotificationName:handicapPointDidChange object:point];
+  [[ModelMutationTransaction sharedTransaction] postNotificationName:handicapPointDidChange object:point];
 }
 
 // -----------------------------------------------------------------------------
@@ -1968,6 +2011,8 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
     self.setupFirstMoveColor = newValue;
   else
     self.setupFirstMoveColor = nodeSetup.previousSetupFirstMoveColor;
+  [self.nodeModel discardBoardSnapshotsFromIndex:self.boardPosition.currentBoardPosition];
+  [self.nodeModel updateJumpTargetsOfNode:currentNode];
 
   if (self.setupFirstMoveColor != GoColorNone)
     self.nextMoveColor = self.setupFirstMoveColor;
@@ -2099,9 +2144,12 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
   point.stoneState = stoneState;
   [GoUtilities movePointToNewRegion:point];
 
-  currentNode.zobristHash = [self.board.zobristTable hashForNode:currentNode inGame:self];
+  [currentNode updateZobristHashAndPropagateToSubtree:self];
+  [self.superkoHistory invalidate];
+  [self.nodeModel discardBoardSnapshotsFromIndex:self.boardPosition.currentBoardPosition];
+  [self.nodeModel updateJumpTargetsOfNode:currentNode];
 
-  [[NSNotificationCenter defaultCenter] postNotificationName:setupPointDidChange object:point];
+  [[ModelMutationTransaction sharedTransaction] postNotificationName:setupPointDidChange object:point];
 }
 
 // -----------------------------------------------------------------------------
@@ -2139,7 +2187,22 @@ nodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
   [nodeSetup revertSetup];
   currentNode.goNodeSetup = nil;
 
-  currentNode.zobristHash = [self.board.zobristTable hashForNode:currentNode inGame:self];
+  [currentNode updateZobristHashAndPropagateToSubtree:self];
+  [self.superkoHistory invalidate];
+  [self.nodeModel discardBoardSnapshotsFromIndex:self.boardPosition.currentBoardPosition];
+  [self.nodeModel updateJumpTargetsOfNode:currentNode];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an immutable snapshot of the current board position and of
+/// the moves that led to it. The snapshot can be read from any thread. See
+/// GoGameSnapshot for details.
+///
+/// This method must be invoked in the context of the main thread.
+// -----------------------------------------------------------------------------
+- (GoGameSnapshot*) snapshotAtCurrentNode
+{
+  return [GoGameSnapshot snapshotAtCurrentNodeOfGame:self];
 }
 
 @end
@@ -50,5 +50,24 @@
 /// invoked. The value supplied to those methods is used as the new document
 /// name, the previous document name is lost.
 @property(nonatomic, retain, readonly) NSString* documentName;
+/// @brief A counter that is incremented every time the dirty flag is set to
+/// true, i.e. every time a change occurs that can be saved to disk.
+///
+/// The generation allows to determine whether the content of the document has
+/// changed between two points in time, even if the document was saved in the
+/// meantime. The generation is not archived, it starts with 0 for every new
+/// GoGameDocument object, including objects that are restored from an
+/// NSCoding archive.
+@property(nonatomic, assign, readonly) unsigned long long generation;
+/// @brief The full path of the .sgf file that SaveSgfCommand wrote most
+/// recently with the content of this document. Is nil if no .sgf file has been
+/// written yet.
+///
+/// Together with @e lastWrittenSgfFileGeneration this allows SaveSgfCommand to
+/// reuse the file instead of serializing the document again.
+@property(nonatomic, retain) NSString* lastWrittenSgfFilePath;
+/// @brief The value of @e generation at the time when the .sgf file
+/// @e lastWrittenSgfFilePath was written.
+@property(nonatomic, assign) unsigned long long lastWrittenSgfFileGeneration;
 
 @end
@@ -26,6 +26,7 @@
 /// @name Re-declaration of properties to make them readwrite privately
 //@{
 @property(nonatomic, retain, readwrite) NSString* documentName;
+@property(nonatomic, assign, readwrite) unsigned long long generation;
 //@}
 @end
 
@@ -45,6 +46,9 @@
     return nil;
   self.dirty = false;
   self.documentName = nil;
+  self.generation = 0;
+  self.lastWrittenSgfFilePath = nil;
+  self.lastWrittenSgfFileGeneration = 0;
   return self;
 }
 
@@ -62,6 +66,9 @@
 
   _dirty = [decoder decodeBoolForKey:goGameDocumentDirtyKey];
   _documentName = [[decoder decodeObjectOfClass:[NSString class] forKey:goGameDocumentDocumentNameKey] retain];
+  _generation = 0;
+  _lastWrittenSgfFilePath = nil;
+  _lastWrittenSgfFileGeneration = 0;
   
   return self;
 }
@@ -80,9 +87,20 @@
 - (void) dealloc
 {
   self.documentName = nil;
+  self.lastWrittenSgfFilePath = nil;
   [super dealloc];
 }
 
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setDirty:(bool)dirty
+{
+  _dirty = dirty;
+  if (dirty)
+    self.generation++;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief NSCoding protocol method.
 // -----------------------------------------------------------------------------
@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoGameEvaluationTimeline class evaluates all board positions of
+/// the current game variation in the background, so that clients can display
+/// how the score developed over the course of the game and can find the moves
+/// that caused the largest swings.
+///
+/// @ingroup go
+///
+/// evaluateGame:progressHandler:() uses GoBoardPositionPreview in the context
+/// of the main thread to take a snapshot of the stones of every board position
+/// of the current game variation. This is cheap enough that it does not
+/// noticeably delay the main thread, and the board position that the user is
+/// viewing does not change. The snapshots are then evaluated concurrently on a background
+/// queue, using the same geometric area count as GoScoreEstimator. Each result
+/// is delivered to the main thread as soon as it is available, and the
+/// progress handler is invoked so that a client can update its display
+/// progressively.
+///
+/// Board positions are evaluated in coarse-to-fine order: First every 16th
+/// board position (or so, depending on the length of the game), then the
+/// board positions in between, and so on. A client that draws a timeline can
+/// therefore show the outline of the whole game early on and refine it as more
+/// results arrive.
+///
+/// Results are cached by the Zobrist hash of the board position's node. When
+/// the game is evaluated again, e.g. after a move was played or after the
+/// user switched to a different game variation, only board positions that
+/// were not evaluated before need to be evaluated. The cache is discarded when
+/// the board size, komi, handicap or scoring system change.
+///
+/// GoGameEvaluationTimeline must be used from the main thread only.
+// -----------------------------------------------------------------------------
+@interface GoGameEvaluationTimeline : NSObject
+{
+}
+
+- (id) init;
+- (void) evaluateGame:(GoGame*)game progressHandler:(void (^)(void))progressHandler;
+- (void) cancel;
+- (bool) hasEvaluationAtBoardPosition:(int)boardPosition;
+- (double) blackLeadAtBoardPosition:(int)boardPosition;
+- (NSArray*) boardPositionsWithLargestSwings:(int)maximumNumberOfSwings;
+
+/// @brief The number of board positions of the game variation that was most
+/// recently evaluated.
+@property(nonatomic, assign, readonly) int numberOfBoardPositions;
+/// @brief The number of board positions for which an evaluation is available.
+@property(nonatomic, assign, readonly) int numberOfEvaluations;
+/// @brief True if evaluations are still outstanding.
+@property(nonatomic, assign, readonly, getter=isEvaluating) bool evaluating;
+
+@end
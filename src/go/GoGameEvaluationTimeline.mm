@@ -0,0 +1,317 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "GoGameEvaluationTimeline.h"
+#import "GoBoard.h"
+#import "GoBoardPositionPreview.h"
+#import "GoGame.h"
+#import "GoGameRules.h"
+#import "GoNode.h"
+#import "GoNodeModel.h"
+#import "GoScoreEstimator.h"
+
+// System includes
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// GoGameEvaluationTimeline.
+// -----------------------------------------------------------------------------
+@interface GoGameEvaluationTimeline()
+{
+@private
+  /// @brief The evaluation of each board position, NAN if the board position
+  /// has not been evaluated yet.
+  std::vector<double> m_blackLeads;
+  /// @brief Maps the Zobrist hash of a board position's node to its
+  /// evaluation.
+  std::unordered_map<long long, double> m_cache;
+}
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) int numberOfBoardPositions;
+@property(nonatomic, assign, readwrite) int numberOfEvaluations;
+//@}
+/// @brief Concurrent queue on which board positions are evaluated.
+@property(nonatomic, retain) NSOperationQueue* operationQueue;
+/// @brief Is incremented for each requested evaluation. A result is accepted
+/// only if no newer evaluation has been requested in the meantime.
+@property(nonatomic, assign) int evaluationGeneration;
+/// @name The parameters that the cached evaluations depend on
+//@{
+@property(nonatomic, assign) enum GoBoardSize cacheBoardSize;
+@property(nonatomic, assign) double cacheKomi;
+@property(nonatomic, assign) int cacheHandicap;
+@property(nonatomic, assign) enum GoScoringSystem cacheScoringSystem;
+//@}
+@end
+
+
+@implementation GoGameEvaluationTimeline
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoGameEvaluationTimeline object. No evaluations are
+/// available until evaluateGame:progressHandler:() is invoked.
+///
+/// @note This is the designated initializer of GoGameEvaluationTimeline.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.numberOfBoardPositions = 0;
+  self.numberOfEvaluations = 0;
+  self.evaluationGeneration = 0;
+  self.cacheBoardSize = GoBoardSizeUndefined;
+  self.cacheKomi = 0;
+  self.cacheHandicap = 0;
+  self.cacheScoringSystem = GoScoringSystemAreaScoring;
+  self.operationQueue = [[[NSOperationQueue alloc] init] autorelease];
+  self.operationQueue.qualityOfService = NSQualityOfServiceUtility;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoGameEvaluationTimeline
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self.operationQueue cancelAllOperations];
+  self.operationQueue = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Starts evaluating all board positions of the current game variation
+/// of @a game. Invokes @a progressHandler in the context of the main thread
+/// every time that the evaluation of a board position becomes available.
+///
+/// Evaluations that were started by an earlier invocation of this method and
+/// that have not finished yet are cancelled. Board positions whose evaluation
+/// is found in the cache are available immediately when this method returns.
+// -----------------------------------------------------------------------------
+- (void) evaluateGame:(GoGame*)game progressHandler:(void (^)(void))progressHandler
+{
+  [self cancel];
+  int evaluationGeneration = self.evaluationGeneration;
+
+  enum GoBoardSize boardSize = game.board.size;
+  double komi = game.komi;
+  int handicap = (int)game.handicapPoints.count;
+  enum GoScoringSystem scoringSystem = game.rules.scoringSystem;
+  if (boardSize != self.cacheBoardSize || komi != self.cacheKomi || handicap != self.cacheHandicap || scoringSystem != self.cacheScoringSystem)
+  {
+    m_cache.clear();
+    self.cacheBoardSize = boardSize;
+    self.cacheKomi = komi;
+    self.cacheHandicap = handicap;
+    self.cacheScoringSystem = scoringSystem;
+  }
+
+  GoNodeModel* nodeModel = game.nodeModel;
+  int numberOfBoardPositions = nodeModel.numberOfNodes;
+  m_blackLeads.assign(numberOfBoardPositions, NAN);
+  self.numberOfBoardPositions = numberOfBoardPositions;
+  self.numberOfEvaluations = 0;
+
+  // GoBoardPositionPreview determines the stones without changing the board
+  // position that the user is viewing. Board positions are previewed in
+  // ascending order, so that each preview only has to replay a few nodes.
+  GoBoardPositionPreview* preview = [[[GoBoardPositionPreview alloc] initWithGame:game] autorelease];
+  NSMutableArray* stoneStatesOfBoardPositions = [NSMutableArray arrayWithCapacity:numberOfBoardPositions];
+  std::vector<long long> zobristHashes(numberOfBoardPositions);
+  for (int boardPosition = 0; boardPosition < numberOfBoardPositions; ++boardPosition)
+  {
+    GoNode* node = [nodeModel nodeAtIndex:boardPosition];
+    zobristHashes[boardPosition] = node.zobristHash;
+    auto cacheEntry = m_cache.find(node.zobristHash);
+    if (cacheEntry != m_cache.end())
+    {
+      m_blackLeads[boardPosition] = cacheEntry->second;
+      self.numberOfEvaluations++;
+      [stoneStatesOfBoardPositions addObject:[NSNull null]];
+    }
+    else
+    {
+      [stoneStatesOfBoardPositions addObject:[preview stoneStatesAtBoardPosition:boardPosition]];
+    }
+  }
+
+  for (int boardPosition : [GoGameEvaluationTimeline evaluationOrderForNumberOfBoardPositions:numberOfBoardPositions])
+  {
+    id stoneStates = [stoneStatesOfBoardPositions objectAtIndex:boardPosition];
+    if (stoneStates == [NSNull null])
+      continue;
+
+    long long zobristHash = zobristHashes[boardPosition];
+    [self.operationQueue addOperationWithBlock:^(void)
+    {
+      double blackLead = [GoScoreEstimator blackLeadForStoneStates:stoneStates
+                                                         boardSize:boardSize
+                                                              komi:komi
+                                                          handicap:handicap
+                                                     scoringSystem:scoringSystem];
+      dispatch_async(dispatch_get_main_queue(), ^(void)
+      {
+        if (evaluationGeneration != self.evaluationGeneration)
+          return;
+        self->m_blackLeads[boardPosition] = blackLead;
+        self->m_cache[zobristHash] = blackLead;
+        self.numberOfEvaluations++;
+        progressHandler();
+      });
+    }];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Cancels all evaluations that have not finished yet. Evaluations that
+/// are already available remain available.
+// -----------------------------------------------------------------------------
+- (void) cancel
+{
+  self.evaluationGeneration++;
+  [self.operationQueue cancelAllOperations];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the evaluation of board position @a boardPosition is
+/// available, false if not.
+// -----------------------------------------------------------------------------
+- (bool) hasEvaluationAtBoardPosition:(int)boardPosition
+{
+  if (boardPosition < 0 || boardPosition >= self.numberOfBoardPositions)
+    return false;
+  return ! std::isnan(m_blackLeads[boardPosition]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of points by which black leads at board position
+/// @a boardPosition. The value is negative if white leads.
+///
+/// Raises @e NSRangeException if no evaluation is available for
+/// @a boardPosition.
+// -----------------------------------------------------------------------------
+- (double) blackLeadAtBoardPosition:(int)boardPosition
+{
+  if (! [self hasEvaluationAtBoardPosition:boardPosition])
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"No evaluation available for board position %d", boardPosition];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+  return m_blackLeads[boardPosition];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board positions at which the evaluation changed the most
+/// compared to the previous board position, largest change first. The array
+/// contains at most @a maximumNumberOfSwings NSNumber objects.
+///
+/// Only board positions for which both the evaluation and the evaluation of
+/// the previous board position are available are taken into account.
+// -----------------------------------------------------------------------------
+- (NSArray*) boardPositionsWithLargestSwings:(int)maximumNumberOfSwings
+{
+  std::vector<std::pair<double, int>> swings;
+  for (int boardPosition = 1; boardPosition < self.numberOfBoardPositions; ++boardPosition)
+  {
+    double swing = std::fabs(m_blackLeads[boardPosition] - m_blackLeads[boardPosition - 1]);
+    if (! std::isnan(swing))
+      swings.push_back(std::make_pair(swing, boardPosition));
+  }
+
+  int numberOfSwings = std::min(maximumNumberOfSwings, static_cast<int>(swings.size()));
+  if (numberOfSwings <= 0)
+    return @[];
+
+  // Larger swings first, for equal swings earlier board positions first
+  std::partial_sort(swings.begin(), swings.begin() + numberOfSwings, swings.end(),
+                    [](const std::pair<double, int>& lhs, const std::pair<double, int>& rhs)
+                    {
+                      return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+                    });
+
+  NSMutableArray* boardPositions = [NSMutableArray arrayWithCapacity:numberOfSwings];
+  for (int indexOfSwing = 0; indexOfSwing < numberOfSwings; ++indexOfSwing)
+    [boardPositions addObject:[NSNumber numberWithInt:swings[indexOfSwing].second]];
+  return boardPositions;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (bool) isEvaluating
+{
+  return self.numberOfEvaluations < self.numberOfBoardPositions;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board positions 0 to @a numberOfBoardPositions - 1 in
+/// coarse-to-fine order: First the board positions that are a multiple of the
+/// largest power of 2 that is smaller than @a numberOfBoardPositions, then
+/// the board positions that are a multiple of half that power of 2, and so
+/// on, down to the odd board positions. The last board position is moved to
+/// the front because it is usually the most interesting one.
+// -----------------------------------------------------------------------------
++ (std::vector<int>) evaluationOrderForNumberOfBoardPositions:(int)numberOfBoardPositions
+{
+  std::vector<int> evaluationOrder;
+  if (numberOfBoardPositions <= 0)
+    return evaluationOrder;
+
+  evaluationOrder.reserve(numberOfBoardPositions);
+  int lastBoardPosition = numberOfBoardPositions - 1;
+  evaluationOrder.push_back(lastBoardPosition);
+
+  int stride = 1;
+  while (stride * 2 < numberOfBoardPositions)
+    stride *= 2;
+  for (; stride >= 1; stride /= 2)
+  {
+    for (int boardPosition = 0; boardPosition < lastBoardPosition; boardPosition += stride)
+    {
+      // Board positions that are a multiple of twice the stride were already
+      // added in an earlier pass
+      bool isMultipleOfLargerStride = (boardPosition % (stride * 2) == 0) && (stride * 2 < numberOfBoardPositions);
+      if (! isMultipleOfLargerStride)
+        evaluationOrder.push_back(boardPosition);
+    }
+  }
+
+  return evaluationOrder;
+}
+
+@end
@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoVertexNumeric.h"
+
+// Forward declarations
+@class GoGame;
+@class GoVertex;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Describes a single move in a GoGameSnapshot.
+///
+/// @ingroup go
+// -----------------------------------------------------------------------------
+struct GoGameSnapshotMove
+{
+  enum GoMoveType type;            ///< @brief The type of the move.
+  enum GoColor color;              ///< @brief The color of the player who made the move.
+  struct GoVertexNumeric vertex;   ///< @brief The intersection on which the stone was played. Both compounds are 0 if @e type is #GoMoveTypePass.
+};
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoGameSnapshot class is an immutable copy of the board position
+/// that is current at the time when the snapshot is taken, and of the moves
+/// that led to this board position in the current game variation.
+///
+/// @ingroup go
+///
+/// GoGame, GoBoard and the other classes of the Go model must be used from the
+/// main thread only. A GoGameSnapshot can be taken in the context of the main
+/// thread (see GoGame::snapshotAtCurrentNode()) and then be handed over to any
+/// number of background threads, which can read it freely without any
+/// synchronization while the main thread continues to change the Go model.
+///
+/// A GoGameSnapshot does not reference any Go model objects. The stone states
+/// are stored in the same compact format as a board snapshot (see
+/// GoBoard::stoneStateSnapshot()), the moves are stored as an array of plain
+/// structs. Taking a snapshot is therefore cheap enough to be done after every
+/// move.
+// -----------------------------------------------------------------------------
+@interface GoGameSnapshot : NSObject
+{
+}
+
++ (GoGameSnapshot*) snapshotAtCurrentNodeOfGame:(GoGame*)game;
+
+- (enum GoColor) stoneStateAtNumericVertex:(struct GoVertexNumeric)numericVertex;
+- (enum GoColor) stoneStateAtVertex:(GoVertex*)vertex;
+- (struct GoGameSnapshotMove) moveAtIndex:(int)index;
+
+/// @brief The board size.
+@property(nonatomic, assign, readonly) enum GoBoardSize boardSize;
+/// @brief The stone state of all intersections, in the format of a board
+/// snapshot (see GoBoard::stoneStateSnapshot()).
+@property(nonatomic, retain, readonly) NSData* stoneStates;
+/// @brief The komi.
+@property(nonatomic, assign, readonly) double komi;
+/// @brief The number of handicap stones.
+@property(nonatomic, assign, readonly) int handicap;
+/// @brief The scoring system of the game rules.
+@property(nonatomic, assign, readonly) enum GoScoringSystem scoringSystem;
+/// @brief The color of the player who makes the next move.
+@property(nonatomic, assign, readonly) enum GoColor nextMoveColor;
+/// @brief The Zobrist hash of the board position.
+@property(nonatomic, assign, readonly) long long zobristHash;
+/// @brief The board position of which this is a snapshot. Is 0 for the board
+/// position that displays the root node.
+@property(nonatomic, assign, readonly) int boardPosition;
+/// @brief The number of moves that led to the board position. Use
+/// moveAtIndex:() to access the moves.
+@property(nonatomic, assign, readonly) int numberOfMoves;
+
+@end
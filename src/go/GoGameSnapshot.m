@@ -0,0 +1,215 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoGameSnapshot.h"
+#import "GoBoard.h"
+#import "GoBoardPosition.h"
+#import "GoGame.h"
+#import "GoGameRules.h"
+#import "GoMove.h"
+#import "GoNode.h"
+#import "GoPlayer.h"
+#import "GoPoint.h"
+#import "GoVertex.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoGameSnapshot.
+// -----------------------------------------------------------------------------
+@interface GoGameSnapshot()
+{
+@private
+  /// @brief The moves that led to the board position, the first move at index
+  /// 0. Is NULL if there are no moves.
+  struct GoGameSnapshotMove* m_moves;
+}
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) enum GoBoardSize boardSize;
+@property(nonatomic, retain, readwrite) NSData* stoneStates;
+@property(nonatomic, assign, readwrite) double komi;
+@property(nonatomic, assign, readwrite) int handicap;
+@property(nonatomic, assign, readwrite) enum GoScoringSystem scoringSystem;
+@property(nonatomic, assign, readwrite) enum GoColor nextMoveColor;
+@property(nonatomic, assign, readwrite) long long zobristHash;
+@property(nonatomic, assign, readwrite) int boardPosition;
+@property(nonatomic, assign, readwrite) int numberOfMoves;
+//@}
+@end
+
+
+@implementation GoGameSnapshot
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GoGameSnapshot instance that
+/// captures the current board position of @a game.
+///
+/// This method must be invoked in the context of the main thread.
+///
+/// Raises @e NSInvalidArgumentException if @a game is nil.
+// -----------------------------------------------------------------------------
++ (GoGameSnapshot*) snapshotAtCurrentNodeOfGame:(GoGame*)game
+{
+  if (! game)
+  {
+    NSString* errorMessage = @"Game argument is nil";
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSInvalidArgumentException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  GoGameSnapshot* snapshot = [[GoGameSnapshot alloc] initWithGame:game];
+  if (snapshot)
+    [snapshot autorelease];
+  return snapshot;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoGameSnapshot object that captures the current board
+/// position of @a game.
+///
+/// @note This is the designated initializer of GoGameSnapshot.
+// -----------------------------------------------------------------------------
+- (id) initWithGame:(GoGame*)game
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  GoNode* currentNode = game.boardPosition.currentNode;
+
+  self.boardSize = game.board.size;
+  self.stoneStates = [game.board stoneStateSnapshot];
+  self.komi = game.komi;
+  self.handicap = (int)game.handicapPoints.count;
+  self.scoringSystem = game.rules.scoringSystem;
+  self.nextMoveColor = game.nextMoveColor;
+  self.zobristHash = currentNode.zobristHash;
+  self.boardPosition = game.boardPosition.currentBoardPosition;
+
+  GoNode* nodeWithMostRecentMove = currentNode;
+  while (nodeWithMostRecentMove && ! nodeWithMostRecentMove.goMove)
+    nodeWithMostRecentMove = nodeWithMostRecentMove.parent;
+  GoMove* mostRecentMove = nodeWithMostRecentMove.goMove;
+
+  self.numberOfMoves = mostRecentMove ? mostRecentMove.moveNumber : 0;
+  m_moves = NULL;
+  if (self.numberOfMoves > 0)
+  {
+    m_moves = (struct GoGameSnapshotMove*)malloc(sizeof(struct GoGameSnapshotMove) * self.numberOfMoves);
+
+    // Walk backwards via the moves' back references, this is much cheaper than
+    // walking the node tree
+    int indexOfMove = self.numberOfMoves - 1;
+    for (GoMove* move = mostRecentMove; move && indexOfMove >= 0; move = move.previous, --indexOfMove)
+    {
+      struct GoGameSnapshotMove* snapshotMove = &m_moves[indexOfMove];
+      snapshotMove->type = move.type;
+      snapshotMove->color = move.player.color;
+      if (move.type == GoMoveTypePlay)
+      {
+        snapshotMove->vertex = move.point.vertex.numeric;
+      }
+      else
+      {
+        snapshotMove->vertex.x = 0;
+        snapshotMove->vertex.y = 0;
+      }
+    }
+  }
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoGameSnapshot object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.stoneStates = nil;
+  if (m_moves)
+  {
+    free(m_moves);
+    m_moves = NULL;
+  }
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone state of the intersection identified by
+/// @a numericVertex.
+///
+/// Raises @e NSRangeException if @a numericVertex is outside the board.
+// -----------------------------------------------------------------------------
+- (enum GoColor) stoneStateAtNumericVertex:(struct GoVertexNumeric)numericVertex
+{
+  if (numericVertex.x < 1 || numericVertex.x > self.boardSize || numericVertex.y < 1 || numericVertex.y > self.boardSize)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Numeric vertex x=%d, y=%d is outside the board", numericVertex.x, numericVertex.y];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  // Same order as GoBoard::indexOfPoint:()
+  int index = ((numericVertex.y - 1) * self.boardSize) + (numericVertex.x - 1);
+  const unsigned char* stoneStates = (const unsigned char*)self.stoneStates.bytes;
+  return (enum GoColor)stoneStates[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone state of the intersection identified by @a vertex.
+///
+/// Raises @e NSRangeException if @a vertex is outside the board.
+// -----------------------------------------------------------------------------
+- (enum GoColor) stoneStateAtVertex:(GoVertex*)vertex
+{
+  return [self stoneStateAtNumericVertex:vertex.numeric];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the move at index position @a index. The first move is at
+/// index position 0.
+///
+/// Raises @e NSRangeException if @a index is outside the range of moves.
+// -----------------------------------------------------------------------------
+- (struct GoGameSnapshotMove) moveAtIndex:(int)index
+{
+  if (index < 0 || index >= self.numberOfMoves)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Move index %d is out of range, number of moves = %d", index, self.numberOfMoves];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  return m_moves[index];
+}
+
+@end
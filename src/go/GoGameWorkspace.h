@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoGameWorkspace class keeps recently viewed GoGame objects
+/// resident in memory so that the user can switch back to them without having
+/// to load them again from an .sgf file.
+///
+/// @ingroup go
+///
+/// At any given time at most one of the games in the workspace is the @e active
+/// game. This is the game that is available via GoGame::sharedGame(). All
+/// other games in the workspace are @e resident games. Resident games are not
+/// observed by anyone and do not participate in any activity of the app.
+///
+/// Each game is identified by a key that is chosen by the client. The client
+/// must make sure that the key changes when the source of the game (e.g. the
+/// .sgf file) changes.
+///
+/// The lifecycle of a game in the workspace is this:
+/// - activateGame:forKey:() makes a game the active game.
+/// - deactivateGame:() turns the active game into a resident game when it is
+///   replaced by another game. A game whose document is dirty is discarded
+///   instead, because it no longer matches its source.
+/// - takeResidentGameForKey:() removes a resident game from the workspace so
+///   that it can become the active game again.
+///
+/// Resident games are kept in least-recently-used order. If the estimated
+/// memory usage of all resident games exceeds @e memoryBudget, the least
+/// recently used games are discarded until the budget is met again. Resident
+/// games are also discarded, the least recently used first, when
+/// MemoryBudgetManager asks GoGameWorkspace to give up memory. Because
+/// resident games are expensive to recreate, MemoryBudgetManager does this
+/// only after cheaper caches have given up their memory.
+///
+/// GoGameWorkspace must be used from the main thread only.
+// -----------------------------------------------------------------------------
+@interface GoGameWorkspace : NSObject
+{
+}
+
+- (void) activateGame:(GoGame*)game forKey:(NSString*)key;
+- (void) deactivateGame:(GoGame*)game;
+- (bool) hasResidentGameForKey:(NSString*)key;
+- (GoGame*) takeResidentGameForKey:(NSString*)key;
+- (void) discardAllResidentGames;
++ (unsigned long long) estimatedMemoryUsageOfGame:(GoGame*)game;
+
+/// @brief The maximum number of bytes that resident games are allowed to use,
+/// according to estimatedMemoryUsageOfGame:(). The default is
+/// #gDefaultGameWorkspaceMemoryBudget.
+@property(nonatomic, assign) unsigned long long memoryBudget;
+/// @brief The estimated number of bytes used by all resident games.
+@property(nonatomic, assign, readonly) unsigned long long memoryUsage;
+/// @brief The number of resident games.
+@property(nonatomic, assign, readonly) int numberOfResidentGames;
+/// @brief The key of the active game. Is nil if there is no active game, or if
+/// the active game has no key.
+@property(nonatomic, retain, readonly) NSString* activeGameKey;
+
+@end
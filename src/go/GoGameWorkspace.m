@@ -0,0 +1,273 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoGameWorkspace.h"
+#import "GoBoard.h"
+#import "GoGame.h"
+#import "GoGameDocument.h"
+#import "GoNodeModel.h"
+#import "GoUtilities.h"
+#import "../shared/DeferredDeallocationQueue.h"
+#import "../shared/MemoryBudgetManager.h"
+
+
+/// @brief Rough estimate of the number of bytes used by a GoNode object,
+/// including its GoMove or GoNodeSetup object and the objects that these refer
+/// to.
+static const unsigned long long estimatedBytesPerNode = 512;
+/// @brief Rough estimate of the number of bytes used per intersection by a
+/// GoBoard object, including the GoPoint and GoBoardRegion objects.
+static const unsigned long long estimatedBytesPerIntersection = 256;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoGameWorkspace.
+// -----------------------------------------------------------------------------
+@interface GoGameWorkspace() <MemoryBudgetClient>
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) unsigned long long memoryUsage;
+@property(nonatomic, retain, readwrite) NSString* activeGameKey;
+//@}
+/// @brief The active game. Is not retained, the app delegate owns the active
+/// game.
+@property(nonatomic, assign) GoGame* activeGame;
+/// @brief Keys = Keys chosen by the client, values = Resident GoGame objects.
+@property(nonatomic, retain) NSMutableDictionary* residentGames;
+/// @brief Keys = Keys chosen by the client, values = NSNumber objects with the
+/// estimated memory usage of the resident game.
+@property(nonatomic, retain) NSMutableDictionary* residentGameMemoryUsage;
+/// @brief The keys of all resident games, the least recently used game first.
+@property(nonatomic, retain) NSMutableArray* residentGameKeys;
+@end
+
+
+@implementation GoGameWorkspace
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoGameWorkspace object that contains no games.
+///
+/// @note This is the designated initializer of GoGameWorkspace.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.memoryBudget = gDefaultGameWorkspaceMemoryBudget;
+  self.memoryUsage = 0;
+  self.activeGameKey = nil;
+  self.activeGame = nil;
+  self.residentGames = [NSMutableDictionary dictionary];
+  self.residentGameMemoryUsage = [NSMutableDictionary dictionary];
+  self.residentGameKeys = [NSMutableArray array];
+
+  // Resident games must be loaded again from an .sgf file, so they are the
+  // last thing that we want to give up
+  [[MemoryBudgetManager sharedManager] registerClient:self withPriority:MemoryBudgetEvictionPriorityLast];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoGameWorkspace object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [[MemoryBudgetManager sharedManager] unregisterClient:self];
+
+  self.activeGameKey = nil;
+  self.activeGame = nil;
+  self.residentGames = nil;
+  self.residentGameMemoryUsage = nil;
+  self.residentGameKeys = nil;
+
+  [super dealloc];
+}
+
+#pragma mark - Memory management
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method.
+// -----------------------------------------------------------------------------
+- (unsigned long long) evictableMemoryUsage
+{
+  return self.memoryUsage;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method.
+// -----------------------------------------------------------------------------
+- (void) reduceEvictableMemoryUsageTo:(unsigned long long)numberOfBytes
+{
+  [self discardLeastRecentlyUsedGamesExceedingNumberOfBytes:numberOfBytes];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Makes @a game the active game and associates it with @a key. @a key
+/// may be nil if @a game has no key, in which case @a game will be discarded
+/// when it is deactivated.
+///
+/// If a resident game with the same key exists it is discarded, because it is
+/// superseded by @a game.
+// -----------------------------------------------------------------------------
+- (void) activateGame:(GoGame*)game forKey:(NSString*)key
+{
+  if (key)
+    [self discardResidentGameForKey:key];
+
+  self.activeGame = game;
+  self.activeGameKey = key;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Notifies the workspace that @a game is about to be replaced by
+/// another game. If @a game is the active game, and it has a key, and its
+/// document is not dirty, then @a game becomes the most recently used resident
+/// game. Otherwise @a game is not retained by the workspace.
+///
+/// Resident games are discarded if necessary to stay within @e memoryBudget.
+// -----------------------------------------------------------------------------
+- (void) deactivateGame:(GoGame*)game
+{
+  if (! game || game != self.activeGame)
+    return;
+
+  NSString* key = [[self.activeGameKey retain] autorelease];
+  self.activeGame = nil;
+  self.activeGameKey = nil;
+
+  if (! key || game.document.isDirty)
+    return;
+
+  unsigned long long estimatedMemoryUsage = [GoGameWorkspace estimatedMemoryUsageOfGame:game];
+  if (estimatedMemoryUsage > self.memoryBudget)
+    return;
+
+  self.residentGames[key] = game;
+  self.residentGameMemoryUsage[key] = [NSNumber numberWithUnsignedLongLong:estimatedMemoryUsage];
+  [self.residentGameKeys addObject:key];
+  self.memoryUsage += estimatedMemoryUsage;
+
+  [self discardLeastRecentlyUsedGamesExceedingNumberOfBytes:self.memoryBudget];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if a resident game exists for @a key.
+// -----------------------------------------------------------------------------
+- (bool) hasResidentGameForKey:(NSString*)key
+{
+  return (key && self.residentGames[key]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the resident game for @a key from the workspace and returns
+/// it. Returns nil if no resident game exists for @a key.
+///
+/// The caller is expected to make the game the active game, by invoking
+/// activateGame:forKey:() after the game has replaced the current active
+/// game.
+// -----------------------------------------------------------------------------
+- (GoGame*) takeResidentGameForKey:(NSString*)key
+{
+  if (! [self hasResidentGameForKey:key])
+    return nil;
+
+  GoGame* game = [[self.residentGames[key] retain] autorelease];
+  [self discardResidentGameForKey:key];
+  return game;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards all resident games. The active game is not affected.
+// -----------------------------------------------------------------------------
+- (void) discardAllResidentGames
+{
+  [self.residentGames removeAllObjects];
+  [self.residentGameMemoryUsage removeAllObjects];
+  [self.residentGameKeys removeAllObjects];
+  self.memoryUsage = 0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a rough estimate of the number of bytes that @a game uses.
+/// The estimate is based on the number of nodes and the board size.
+// -----------------------------------------------------------------------------
++ (unsigned long long) estimatedMemoryUsageOfGame:(GoGame*)game
+{
+  unsigned long long numberOfIntersections = game.board.size * game.board.size;
+  return (game.nodeModel.numberOfNodes * estimatedBytesPerNode +
+          numberOfIntersections * estimatedBytesPerIntersection);
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setMemoryBudget:(unsigned long long)memoryBudget
+{
+  _memoryBudget = memoryBudget;
+  [self discardLeastRecentlyUsedGamesExceedingNumberOfBytes:memoryBudget];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (int) numberOfResidentGames
+{
+  return (int)self.residentGameKeys.count;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the resident game for @a key. Does nothing if no resident
+/// game exists for @a key.
+// -----------------------------------------------------------------------------
+- (void) discardResidentGameForKey:(NSString*)key
+{
+  NSNumber* estimatedMemoryUsage = self.residentGameMemoryUsage[key];
+  if (! estimatedMemoryUsage)
+    return;
+
+  self.memoryUsage -= estimatedMemoryUsage.unsignedLongLongValue;
+  [self.residentGameKeys removeObject:key];
+  [self.residentGameMemoryUsage removeObjectForKey:key];
+  [[DeferredDeallocationQueue sharedQueue] releaseObjectsWhenIdle:[GoUtilities objectsInDeallocationOrderForGame:self.residentGames[key]]];
+  [self.residentGames removeObjectForKey:key];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the least recently used resident games until the memory
+/// usage is no more than @a numberOfBytes.
+// -----------------------------------------------------------------------------
+- (void) discardLeastRecentlyUsedGamesExceedingNumberOfBytes:(unsigned long long)numberOfBytes
+{
+  while (self.memoryUsage > numberOfBytes && self.residentGameKeys.count > 0)
+  {
+    NSString* leastRecentlyUsedKey = [[self.residentGameKeys.firstObject retain] autorelease];
+    [self discardResidentGameForKey:leastRecentlyUsedKey];
+  }
+}
+
+@end
@@ -0,0 +1,75 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoBoard;
+@class GoPoint;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoLifeAndDeathProblem class represents a life-and-death problem
+/// on a GoBoard, and solves the problem with GoLifeAndDeathSolver.
+///
+/// @ingroup go
+///
+/// GoLifeAndDeathProblem is the Objective-C façade for GoLifeAndDeathSolver,
+/// which is a C++ class that cannot be used by the many pure Objective-C
+/// source files of the project.
+///
+/// A GoLifeAndDeathProblem object must be created on the main thread, because
+/// it takes a snapshot of the GoBoard when it is initialized. After that the
+/// GoBoard may change freely. The problem can then be solved by invoking
+/// solve() on a secondary thread, which is recommended because solving a
+/// problem may take a while. The result properties must not be accessed
+/// while solve() is running.
+///
+/// The problem consists of a target stone group, the side that plays the
+/// first move, and a region of empty intersections on which moves may be
+/// played (see GoLifeAndDeathSolver::getRegion()). If the side to move is the
+/// color of the target stone group, the question is whether the stone group
+/// can live, otherwise the question is whether it can be killed.
+// -----------------------------------------------------------------------------
+@interface GoLifeAndDeathProblem : NSObject
+{
+}
+
++ (GoLifeAndDeathProblem*) problemWithBoard:(GoBoard*)board colorToMove:(enum GoColor)colorToMove;
+- (id) initWithBoard:(GoBoard*)board targetPoint:(GoPoint*)targetPoint colorToMove:(enum GoColor)colorToMove;
+- (void) solve;
+
+/// @brief The vertex of the intersection that identifies the target stone
+/// group.
+@property(nonatomic, retain, readonly) NSString* targetVertex;
+/// @brief The color of the target stone group.
+@property(nonatomic, assign, readonly) enum GoColor targetColor;
+/// @brief The side that plays the first move.
+@property(nonatomic, assign, readonly) enum GoColor colorToMove;
+/// @brief The number of empty intersections on which moves may be played.
+@property(nonatomic, assign, readonly) int regionSize;
+/// @brief The outcome of solving the problem. Is #GoLifeAndDeathStatusNotSolved
+/// until solve() has been invoked.
+@property(nonatomic, assign, readonly) enum GoLifeAndDeathStatus status;
+/// @brief The sequence of moves that proves @e status, starting with a move of
+/// @e colorToMove. Elements are NSString objects with the vertex of a play
+/// move, or NSNull objects for pass moves. The array is empty if the problem
+/// has not been solved yet, if the target stone group is already dead or
+/// alive, or if the solver gave up before it could prove a single move.
+@property(nonatomic, retain, readonly) NSArray* mainLine;
+/// @brief The number of nodes that GoLifeAndDeathSolver visited.
+@property(nonatomic, assign, readonly) int numberOfNodes;
+
+@end
@@ -0,0 +1,300 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoLifeAndDeathProblem.h"
+#import "GoBoard.h"
+#import "GoBoardCore.h"
+#import "GoLifeAndDeathSolver.h"
+#import "GoPoint.h"
+#import "GoVertex.h"
+#import "GoZobristTable.h"
+#import "../utility/ExceptionUtility.h"
+
+// C++ standard library
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoLifeAndDeathProblem.
+// -----------------------------------------------------------------------------
+@interface GoLifeAndDeathProblem()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, retain, readwrite) NSString* targetVertex;
+@property(nonatomic, assign, readwrite) enum GoColor targetColor;
+@property(nonatomic, assign, readwrite) enum GoColor colorToMove;
+@property(nonatomic, assign, readwrite) int regionSize;
+@property(nonatomic, assign, readwrite) enum GoLifeAndDeathStatus status;
+@property(nonatomic, retain, readwrite) NSArray* mainLine;
+@property(nonatomic, assign, readwrite) int numberOfNodes;
+//@}
+/// @name Private properties
+//@{
+@property(nonatomic, assign) enum GoBoardSize boardSize;
+@property(nonatomic, retain) NSData* stoneStateSnapshot;
+@property(nonatomic, retain) GoZobristTable* zobristTable;
+//@}
+@end
+
+
+@implementation GoLifeAndDeathProblem
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GoLifeAndDeathProblem instance
+/// for @a board with @a colorToMove playing the first move, and selects the
+/// target stone group automatically. Returns nil if @a board has no stones.
+///
+/// The target stone group is the stone group with the smallest region, i.e.
+/// usually the stone group whose eye space is being contested. If several
+/// stone groups have the same region size, the one with fewer liberties is
+/// selected, and if that is also the same, the stone group of the opponent of
+/// @a colorToMove is selected, because problems of the kind "play and kill"
+/// are more common than "play and live".
+///
+/// Raises @e NSInvalidArgumentException if @a board is nil, or if
+/// @a colorToMove is neither #GoColorBlack nor #GoColorWhite.
+// -----------------------------------------------------------------------------
++ (GoLifeAndDeathProblem*) problemWithBoard:(GoBoard*)board colorToMove:(enum GoColor)colorToMove
+{
+  [GoLifeAndDeathProblem throwIfBoard:board orColorToMoveIsInvalid:colorToMove];
+
+  NSData* stoneStateSnapshot = [board stoneStateSnapshot];
+  GoBoardCore boardCore(board.size);
+  [GoLifeAndDeathProblem setupBoardCore:boardCore withStoneStateSnapshot:stoneStateSnapshot];
+
+  int targetIndex = -1;
+  size_t targetRegionSize = 0;
+  int targetNumberOfLiberties = 0;
+  bool targetIsOpponent = false;
+  GoBoardCore::PointSet examinedStones;
+  int numberOfPoints = boardCore.getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! boardCore.hasStone(index) || examinedStones.test(index))
+      continue;
+
+    GoBoardCore::PointSet stoneGroup;
+    GoBoardCore::PointSet liberties;
+    boardCore.getStoneGroupAndLiberties(index, stoneGroup, liberties);
+    examinedStones |= stoneGroup;
+
+    GoBoardCore::PointSet region;
+    GoLifeAndDeathSolver::getRegion(boardCore, index, lifeAndDeathSolverRegionMargin, region);
+    size_t regionSize = region.count();
+    int numberOfLiberties = static_cast<int>(liberties.count());
+    bool isOpponent = (static_cast<enum GoColor>(boardCore.getStoneState(index)) != colorToMove);
+
+    bool isBetterTarget;
+    if (-1 == targetIndex)
+      isBetterTarget = true;
+    else if (regionSize != targetRegionSize)
+      isBetterTarget = (regionSize < targetRegionSize);
+    else if (numberOfLiberties != targetNumberOfLiberties)
+      isBetterTarget = (numberOfLiberties < targetNumberOfLiberties);
+    else
+      isBetterTarget = (isOpponent && ! targetIsOpponent);
+    if (! isBetterTarget)
+      continue;
+
+    targetIndex = index;
+    targetRegionSize = regionSize;
+    targetNumberOfLiberties = numberOfLiberties;
+    targetIsOpponent = isOpponent;
+  }
+
+  if (-1 == targetIndex)
+    return nil;
+
+  GoPoint* targetPoint = [board pointAtVertex:[GoLifeAndDeathProblem vertexForIndex:targetIndex boardSize:board.size]];
+  GoLifeAndDeathProblem* problem = [[GoLifeAndDeathProblem alloc] initWithBoard:board
+                                                                    targetPoint:targetPoint
+                                                                    colorToMove:colorToMove];
+  if (problem)
+    [problem autorelease];
+
+  return problem;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoLifeAndDeathProblem object for the stone group on
+/// @a board that the stone on @a targetPoint belongs to. @a colorToMove plays
+/// the first move.
+///
+/// @note This is the designated initializer of GoLifeAndDeathProblem.
+///
+/// Raises @e NSInvalidArgumentException if @a board is nil, if @a targetPoint
+/// is not occupied by a stone, or if @a colorToMove is neither #GoColorBlack
+/// nor #GoColorWhite.
+// -----------------------------------------------------------------------------
+- (id) initWithBoard:(GoBoard*)board targetPoint:(GoPoint*)targetPoint colorToMove:(enum GoColor)colorToMove
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  [GoLifeAndDeathProblem throwIfBoard:board orColorToMoveIsInvalid:colorToMove];
+  if (! targetPoint.hasStone)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Target point %@ is not occupied by a stone", targetPoint.vertex.string];
+    [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:errorMessage];
+    [self release];
+    return nil;
+  }
+
+  self.targetVertex = targetPoint.vertex.string;
+  self.targetColor = targetPoint.stoneState;
+  self.colorToMove = colorToMove;
+  self.status = GoLifeAndDeathStatusNotSolved;
+  self.mainLine = @[];
+  self.numberOfNodes = 0;
+  self.boardSize = board.size;
+  self.stoneStateSnapshot = [board stoneStateSnapshot];
+  self.zobristTable = board.zobristTable;
+
+  GoBoardCore boardCore(self.boardSize);
+  [GoLifeAndDeathProblem setupBoardCore:boardCore withStoneStateSnapshot:self.stoneStateSnapshot];
+  GoBoardCore::PointSet region;
+  GoLifeAndDeathSolver::getRegion(boardCore, [self targetIndex], lifeAndDeathSolverRegionMargin, region);
+  self.regionSize = static_cast<int>(region.count());
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoLifeAndDeathProblem object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.targetVertex = nil;
+  self.mainLine = nil;
+  self.stoneStateSnapshot = nil;
+  self.zobristTable = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Solves the problem with GoLifeAndDeathSolver and updates the result
+/// properties. The search is limited to #lifeAndDeathSolverNodeBudget nodes.
+///
+/// This method may be invoked on any thread.
+// -----------------------------------------------------------------------------
+- (void) solve
+{
+  GoBoardCore boardCore(self.boardSize);
+  [GoLifeAndDeathProblem setupBoardCore:boardCore withStoneStateSnapshot:self.stoneStateSnapshot];
+
+  int targetIndex = [self targetIndex];
+  GoBoardCore::PointSet region;
+  GoLifeAndDeathSolver::getRegion(boardCore, targetIndex, lifeAndDeathSolverRegionMargin, region);
+
+  GoLifeAndDeathSolver solver(boardCore, [self.zobristTable zobristValues], lifeAndDeathSolverNodeBudget);
+  std::vector<int> mainLine;
+  GoLifeAndDeathSolver::Result result = solver.solve(targetIndex,
+                                                     region,
+                                                     static_cast<GoBoardCore::StoneState>(self.colorToMove),
+                                                     mainLine);
+
+  switch (result)
+  {
+    case GoLifeAndDeathSolver::ResultDead:
+      self.status = GoLifeAndDeathStatusDead;
+      break;
+    case GoLifeAndDeathSolver::ResultAlive:
+      self.status = GoLifeAndDeathStatusAlive;
+      break;
+    default:
+      self.status = GoLifeAndDeathStatusUnknown;
+      break;
+  }
+
+  NSMutableArray* moves = [NSMutableArray arrayWithCapacity:mainLine.size()];
+  for (int move : mainLine)
+  {
+    if (GoLifeAndDeathSolver::passMove == move)
+      [moves addObject:[NSNull null]];
+    else
+      [moves addObject:[GoLifeAndDeathProblem vertexForIndex:move boardSize:self.boardSize]];
+  }
+  self.mainLine = moves;
+  self.numberOfNodes = solver.getNumberOfNodes();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board core index of the intersection identified by
+/// @e targetVertex.
+///
+/// This is an internal helper.
+// -----------------------------------------------------------------------------
+- (int) targetIndex
+{
+  struct GoVertexNumeric numericVertex = [GoVertex vertexFromString:self.targetVertex].numeric;
+  return (numericVertex.y - 1) * self.boardSize + (numericVertex.x - 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the vertex of the intersection with board core index
+/// @a index on a board of size @a boardSize.
+///
+/// This is an internal helper.
+// -----------------------------------------------------------------------------
++ (NSString*) vertexForIndex:(int)index boardSize:(enum GoBoardSize)boardSize
+{
+  struct GoVertexNumeric numericVertex;
+  numericVertex.x = index % boardSize + 1;
+  numericVertex.y = index / boardSize + 1;
+  return [GoVertex vertexFromNumeric:numericVertex].string;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Places the stones in @a stoneStateSnapshot, which must have been
+/// obtained from GoBoard::stoneStateSnapshot(), on the empty board
+/// @a boardCore.
+///
+/// This is an internal helper.
+// -----------------------------------------------------------------------------
++ (void) setupBoardCore:(GoBoardCore&)boardCore withStoneStateSnapshot:(NSData*)stoneStateSnapshot
+{
+  const unsigned char* stoneStates = static_cast<const unsigned char*>(stoneStateSnapshot.bytes);
+  int numberOfPoints = boardCore.getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    GoBoardCore::StoneState stoneState = static_cast<GoBoardCore::StoneState>(stoneStates[index]);
+    if (GoBoardCore::StoneStateNone != stoneState)
+      boardCore.setStoneState(index, stoneState);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Raises an @e NSInvalidArgumentException if @a board is nil, or if
+/// @a colorToMove is neither #GoColorBlack nor #GoColorWhite.
+///
+/// This is an internal helper.
+// -----------------------------------------------------------------------------
++ (void) throwIfBoard:(GoBoard*)board orColorToMoveIsInvalid:(enum GoColor)colorToMove
+{
+  if (! board)
+    [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:@"Board argument is nil"];
+  if (colorToMove != GoColorBlack && colorToMove != GoColorWhite)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Color to move has invalid value %d", colorToMove];
+    [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:errorMessage];
+  }
+}
+
+@end
@@ -0,0 +1,624 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoLifeAndDeathSolver.h"
+
+// System includes
+#include <algorithm>  // for std::min(), std::max(), std::stable_sort()
+#include <stdexcept>
+#include <utility>  // for std::pair
+
+
+// -----------------------------------------------------------------------------
+/// @brief The value that is mixed into the transposition table key if White
+/// is to move.
+// -----------------------------------------------------------------------------
+static const unsigned long long whiteToMoveKey = 0x9E3779B97F4A7C15ULL;
+
+// -----------------------------------------------------------------------------
+/// @brief The multiplier that spreads the simple ko point over the bits of the
+/// transposition table key.
+// -----------------------------------------------------------------------------
+static const unsigned long long koPointKeyMultiplier = 0xBF58476D1CE4E5B9ULL;
+
+// Definition is required because passMove is passed by reference to
+// std::vector::push_back()
+const int GoLifeAndDeathSolver::passMove;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoLifeAndDeathSolver object that searches on a copy of
+/// @a boardCore. @a zobristValues are the random values of GoZobristTable for
+/// the board size of @a boardCore. The values must remain valid for the
+/// lifetime of the GoLifeAndDeathSolver object. Each search may visit at most
+/// @a nodeBudget nodes.
+// -----------------------------------------------------------------------------
+GoLifeAndDeathSolver::GoLifeAndDeathSolver(const GoBoardCore& boardCore, const long long* zobristValues, int nodeBudget) :
+  boardCore(boardCore),
+  zobristValues(zobristValues),
+  nodeBudget(nodeBudget),
+  numberOfNodes(0),
+  maximumSearchDepth(0),
+  targetStones(),
+  region(),
+  defenderColor(GoBoardCore::StoneStateNone),
+  attackerColor(GoBoardCore::StoneStateNone),
+  koPoint(-1),
+  hash(0),
+  undoStack(),
+  transpositionTable()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoLifeAndDeathSolver object.
+// -----------------------------------------------------------------------------
+GoLifeAndDeathSolver::~GoLifeAndDeathSolver()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Solves the life-and-death problem of the stone group that the stone
+/// on the intersection with index @a targetIndex belongs to. Moves may only be
+/// played on the empty intersections in @a region (see getRegion()).
+/// @a colorToMove is the color that plays the first move.
+///
+/// If @a colorToMove is the color of the target stone group, the result
+/// indicates whether the stone group can live. Otherwise the result indicates
+/// whether the attacker can kill the stone group.
+///
+/// @a mainLine is filled with the sequence of moves that proves the result,
+/// starting with a move of @a colorToMove. The side that wins plays its best
+/// move, the side that loses plays the move that resists longest. A pass move
+/// is represented by #passMove. If the result is #ResultUnknown, @a mainLine
+/// contains only the part of the sequence that could be proven, which may be
+/// nothing at all.
+///
+/// Throws std::invalid_argument if the intersection is not occupied by a
+/// stone, or if @a colorToMove is neither black nor white.
+// -----------------------------------------------------------------------------
+GoLifeAndDeathSolver::Result GoLifeAndDeathSolver::solve(int targetIndex, const GoBoardCore::PointSet& region, GoBoardCore::StoneState colorToMove, std::vector<int>& mainLine)
+{
+  this->defenderColor = this->boardCore.getStoneState(targetIndex);
+  if (GoBoardCore::StoneStateNone == this->defenderColor)
+    throw std::invalid_argument("Intersection must be occupied by a stone");
+  // Throws if the color is neither black nor white
+  GoBoardCore::getOpponentColor(colorToMove);
+
+  this->attackerColor = GoBoardCore::getOpponentColor(this->defenderColor);
+  this->boardCore.getStoneGroup(targetIndex, this->targetStones);
+  this->region = region;
+  this->region &= ~(this->boardCore.getStones(GoBoardCore::StoneStateBlack) | this->boardCore.getStones(GoBoardCore::StoneStateWhite));
+  // Every move of the attacker fills one intersection of the region, captures
+  // can empty intersections again. The defender may pass in between.
+  this->maximumSearchDepth = 4 * static_cast<int>(this->region.count()) + 4;
+  this->numberOfNodes = 0;
+  this->koPoint = -1;
+  this->transpositionTable.clear();
+
+  this->hash = 0;
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    GoBoardCore::StoneState stoneState = this->boardCore.getStoneState(index);
+    if (GoBoardCore::StoneStateNone != stoneState)
+      this->hash ^= this->zobristValues[getZobristIndex(index, stoneState)];
+  }
+
+  Result result = search(colorToMove, 0);
+
+  mainLine.clear();
+  getMainLine(colorToMove, mainLine);
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of nodes that the last search visited.
+// -----------------------------------------------------------------------------
+int GoLifeAndDeathSolver::getNumberOfNodes() const
+{
+  return this->numberOfNodes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a region with the empty intersections that belong to the
+/// life-and-death problem of the stone group that the stone on the
+/// intersection with index @a targetIndex belongs to.
+///
+/// The region consists of the empty intersections that can be reached from the
+/// target stone group without crossing a stone of the opponent, and that lie
+/// within the bounding box of the target stone group enlarged by @a margin
+/// lines on each side. Typically this is the eye space of the target stone
+/// group and the surrounding intersections on which the attacker can
+/// approach.
+///
+/// Throws std::invalid_argument if the intersection is not occupied by a
+/// stone.
+// -----------------------------------------------------------------------------
+void GoLifeAndDeathSolver::getRegion(const GoBoardCore& boardCore, int targetIndex, int margin, GoBoardCore::PointSet& region)
+{
+  GoBoardCore::StoneState targetColor = boardCore.getStoneState(targetIndex);
+  if (GoBoardCore::StoneStateNone == targetColor)
+    throw std::invalid_argument("Intersection must be occupied by a stone");
+
+  int boardSize = boardCore.getBoardSize();
+  int numberOfPoints = boardCore.getNumberOfPoints();
+
+  GoBoardCore::PointSet stoneGroup;
+  boardCore.getStoneGroup(targetIndex, stoneGroup);
+  int minimumX = boardSize;
+  int maximumX = -1;
+  int minimumY = boardSize;
+  int maximumY = -1;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! stoneGroup.test(index))
+      continue;
+    int x = index % boardSize;
+    int y = index / boardSize;
+    minimumX = std::min(minimumX, x);
+    maximumX = std::max(maximumX, x);
+    minimumY = std::min(minimumY, y);
+    maximumY = std::max(maximumY, y);
+  }
+  minimumX = std::max(0, minimumX - margin);
+  maximumX = std::min(boardSize - 1, maximumX + margin);
+  minimumY = std::max(0, minimumY - margin);
+  maximumY = std::min(boardSize - 1, maximumY + margin);
+
+  const GoBoardCore::PointSet& opponentStones = boardCore.getStones(GoBoardCore::getOpponentColor(targetColor));
+  GoBoardCore::PointSet visitedPoints = stoneGroup;
+  std::vector<int> pointsToVisit;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (stoneGroup.test(index))
+      pointsToVisit.push_back(index);
+  }
+
+  region.reset();
+  while (! pointsToVisit.empty())
+  {
+    int index = pointsToVisit.back();
+    pointsToVisit.pop_back();
+    if (! boardCore.hasStone(index))
+      region.set(index);
+
+    const GoBoardCore::NeighbourList& neighbourList = boardCore.getNeighbours(index);
+    for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+    {
+      int neighbour = neighbourList.neighbours[indexOfNeighbour];
+      if (visitedPoints.test(neighbour) || opponentStones.test(neighbour))
+        continue;
+      int x = neighbour % boardSize;
+      int y = neighbour / boardSize;
+      if (x < minimumX || x > maximumX || y < minimumY || y > maximumY)
+        continue;
+      visitedPoints.set(neighbour);
+      pointsToVisit.push_back(neighbour);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the proven result of the current position on the private
+/// board, with @a colorToMove to move. @a depth is the number of moves that
+/// the search has played so far.
+// -----------------------------------------------------------------------------
+GoLifeAndDeathSolver::Result GoLifeAndDeathSolver::search(GoBoardCore::StoneState colorToMove, int depth)
+{
+  Result terminalResult = getTerminalResult();
+  if (ResultUnknown != terminalResult)
+    return terminalResult;
+  if (depth >= this->maximumSearchDepth)
+    return ResultUnknown;
+
+  long long key = getKey(colorToMove);
+  auto iterator = this->transpositionTable.find(key);
+  if (iterator != this->transpositionTable.end())
+    return iterator->second.result;
+
+  bool isAttackerToMove = (colorToMove == this->attackerColor);
+  Result winningResult = isAttackerToMove ? ResultDead : ResultAlive;
+  Result losingResult = isAttackerToMove ? ResultAlive : ResultDead;
+  GoBoardCore::StoneState opponentColor = GoBoardCore::getOpponentColor(colorToMove);
+
+  std::vector<int> moves;
+  getMoves(colorToMove, moves);
+
+  bool resultIsUnknown = false;
+  int longestResistanceMove = passMove;
+  int longestResistanceNumberOfNodes = -1;
+  for (int move : moves)
+  {
+    if (this->numberOfNodes >= this->nodeBudget)
+      return ResultUnknown;
+    if (! play(move, colorToMove))
+      continue;
+
+    int numberOfNodesBeforeMove = this->numberOfNodes;
+    Result result = search(opponentColor, depth + 1);
+    undo();
+
+    if (result == winningResult)
+    {
+      this->transpositionTable[key] = { winningResult, move };
+      return winningResult;
+    }
+    else if (ResultUnknown == result)
+    {
+      resultIsUnknown = true;
+    }
+    else if (this->numberOfNodes - numberOfNodesBeforeMove > longestResistanceNumberOfNodes)
+    {
+      longestResistanceMove = move;
+      longestResistanceNumberOfNodes = this->numberOfNodes - numberOfNodesBeforeMove;
+    }
+  }
+
+  if (resultIsUnknown)
+    return ResultUnknown;
+
+  // If the attacker has no legal move the search ends here without a move.
+  // The defender always has at least the pass move.
+  if (longestResistanceNumberOfNodes < 0)
+    return losingResult;
+
+  this->transpositionTable[key] = { losingResult, longestResistanceMove };
+  return losingResult;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns #ResultDead if the target stone group has been captured,
+/// #ResultAlive if it is unconditionally alive, or #ResultUnknown if neither
+/// is the case.
+// -----------------------------------------------------------------------------
+GoLifeAndDeathSolver::Result GoLifeAndDeathSolver::getTerminalResult() const
+{
+  if (isTargetCaptured())
+    return ResultDead;
+  else if (isTargetUnconditionallyAlive())
+    return ResultAlive;
+  else
+    return ResultUnknown;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if at least one of the target stones has been
+/// captured.
+// -----------------------------------------------------------------------------
+bool GoLifeAndDeathSolver::isTargetCaptured() const
+{
+  GoBoardCore::PointSet remainingTargetStones = this->targetStones & this->boardCore.getStones(this->defenderColor);
+  return (remainingTargetStones != this->targetStones);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if all target stones belong to stone groups that are
+/// unconditionally alive according to Benson's algorithm.
+///
+/// The algorithm divides the board into the stone groups of the defender and
+/// the regions that are left when the defender's stones are taken away. A
+/// region is vital to a stone group if all empty intersections of the region
+/// are liberties of the stone group. Stone groups with fewer than two vital
+/// regions are discarded, as are the regions adjacent to a discarded stone
+/// group, until nothing changes anymore. The stone groups that are left are
+/// unconditionally alive.
+// -----------------------------------------------------------------------------
+bool GoLifeAndDeathSolver::isTargetUnconditionallyAlive() const
+{
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  const GoBoardCore::PointSet& defenderStones = this->boardCore.getStones(this->defenderColor);
+  GoBoardCore::PointSet emptyPoints = ~(defenderStones | this->boardCore.getStones(this->attackerColor));
+
+  std::vector<GoBoardCore::PointSet> stoneGroups;
+  std::vector<GoBoardCore::PointSet> stoneGroupLiberties;
+  GoBoardCore::PointSet examinedStones;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! defenderStones.test(index) || examinedStones.test(index))
+      continue;
+    GoBoardCore::PointSet stoneGroup;
+    GoBoardCore::PointSet liberties;
+    this->boardCore.getStoneGroupAndLiberties(index, stoneGroup, liberties);
+    examinedStones |= stoneGroup;
+    stoneGroups.push_back(stoneGroup);
+    stoneGroupLiberties.push_back(liberties);
+  }
+
+  // The regions are flood filled across everything that is not a stone of
+  // the defender. For each region we remember its empty intersections and the
+  // defender stones that it borders on.
+  std::vector<GoBoardCore::PointSet> regionEmptyPoints;
+  std::vector<GoBoardCore::PointSet> regionBorders;
+  GoBoardCore::PointSet examinedPoints = defenderStones;
+  std::vector<int> pointsToVisit;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (examinedPoints.test(index))
+      continue;
+
+    GoBoardCore::PointSet regionPoints;
+    GoBoardCore::PointSet border;
+    examinedPoints.set(index);
+    pointsToVisit.push_back(index);
+    while (! pointsToVisit.empty())
+    {
+      int indexOfPoint = pointsToVisit.back();
+      pointsToVisit.pop_back();
+      regionPoints.set(indexOfPoint);
+
+      const GoBoardCore::NeighbourList& neighbourList = this->boardCore.getNeighbours(indexOfPoint);
+      for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+      {
+        int neighbour = neighbourList.neighbours[indexOfNeighbour];
+        if (defenderStones.test(neighbour))
+        {
+          border.set(neighbour);
+        }
+        else if (! examinedPoints.test(neighbour))
+        {
+          examinedPoints.set(neighbour);
+          pointsToVisit.push_back(neighbour);
+        }
+      }
+    }
+
+    regionEmptyPoints.push_back(regionPoints & emptyPoints);
+    regionBorders.push_back(border);
+  }
+
+  size_t numberOfStoneGroups = stoneGroups.size();
+  size_t numberOfRegions = regionBorders.size();
+  std::vector<std::pair<size_t, size_t>> vitalRegions;
+  for (size_t indexOfStoneGroup = 0; indexOfStoneGroup < numberOfStoneGroups; ++indexOfStoneGroup)
+  {
+    for (size_t indexOfRegion = 0; indexOfRegion < numberOfRegions; ++indexOfRegion)
+    {
+      if ((regionBorders[indexOfRegion] & stoneGroups[indexOfStoneGroup]).none())
+        continue;
+      if ((regionEmptyPoints[indexOfRegion] & ~stoneGroupLiberties[indexOfStoneGroup]).any())
+        continue;
+      vitalRegions.push_back(std::make_pair(indexOfStoneGroup, indexOfRegion));
+    }
+  }
+
+  std::vector<bool> stoneGroupIsAlive(numberOfStoneGroups, true);
+  std::vector<bool> regionIsHealthy(numberOfRegions, true);
+  bool didChange = true;
+  while (didChange)
+  {
+    didChange = false;
+
+    std::vector<int> numberOfVitalRegions(numberOfStoneGroups, 0);
+    for (const auto& vitalRegion : vitalRegions)
+    {
+      if (regionIsHealthy[vitalRegion.second])
+        numberOfVitalRegions[vitalRegion.first]++;
+    }
+
+    GoBoardCore::PointSet discardedStones;
+    for (size_t indexOfStoneGroup = 0; indexOfStoneGroup < numberOfStoneGroups; ++indexOfStoneGroup)
+    {
+      if (stoneGroupIsAlive[indexOfStoneGroup] && numberOfVitalRegions[indexOfStoneGroup] < 2)
+      {
+        stoneGroupIsAlive[indexOfStoneGroup] = false;
+        didChange = true;
+      }
+      if (! stoneGroupIsAlive[indexOfStoneGroup])
+        discardedStones |= stoneGroups[indexOfStoneGroup];
+    }
+
+    for (size_t indexOfRegion = 0; indexOfRegion < numberOfRegions; ++indexOfRegion)
+    {
+      if (regionIsHealthy[indexOfRegion] && (regionBorders[indexOfRegion] & discardedStones).any())
+      {
+        regionIsHealthy[indexOfRegion] = false;
+        didChange = true;
+      }
+    }
+  }
+
+  GoBoardCore::PointSet aliveStones;
+  for (size_t indexOfStoneGroup = 0; indexOfStoneGroup < numberOfStoneGroups; ++indexOfStoneGroup)
+  {
+    if (stoneGroupIsAlive[indexOfStoneGroup])
+      aliveStones |= stoneGroups[indexOfStoneGroup];
+  }
+  return (this->targetStones & ~aliveStones).none();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a moves with the candidate moves of @a colorToMove in the
+/// current position on the private board, in the order in which they should
+/// be searched.
+///
+/// Moves that capture stones and moves on a liberty of the target stone group
+/// come first, because they are the most forcing. Among the remaining moves,
+/// those with more empty neighbours come first, because the vital point of an
+/// eye space is usually in its centre. The defender's pass move comes last.
+// -----------------------------------------------------------------------------
+void GoLifeAndDeathSolver::getMoves(GoBoardCore::StoneState colorToMove, std::vector<int>& moves)
+{
+  bool isAttackerToMove = (colorToMove == this->attackerColor);
+
+  GoBoardCore::PointSet targetLiberties;
+  if (! isTargetCaptured())
+  {
+    GoBoardCore::PointSet stoneGroup;
+    this->boardCore.getStoneGroupAndLiberties(this->boardCore.getFirstIndexInSet(this->targetStones), stoneGroup, targetLiberties);
+  }
+
+  std::vector<std::pair<int, int>> scoredMoves;
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! this->region.test(index) || this->boardCore.hasStone(index) || index == this->koPoint)
+      continue;
+    bool simpleKoIsPossible;
+    if (this->boardCore.isSuicide(index, colorToMove, &simpleKoIsPossible))
+      continue;
+
+    GoBoardCore::PointSet capturedStones;
+    this->boardCore.getStonesCapturedByStone(index, colorToMove, capturedStones);
+
+    int score = this->boardCore.getNumberOfEmptyNeighbours(index);
+    if (targetLiberties.test(index))
+      score += isAttackerToMove ? 8 : 4;
+    if (capturedStones.any())
+      score += isAttackerToMove ? 4 : 8;
+    scoredMoves.push_back(std::make_pair(score, index));
+  }
+
+  std::stable_sort(scoredMoves.begin(), scoredMoves.end(),
+                   [](const std::pair<int, int>& lhs, const std::pair<int, int>& rhs) { return lhs.first > rhs.first; });
+
+  moves.clear();
+  for (const auto& scoredMove : scoredMoves)
+    moves.push_back(scoredMove.second);
+  if (! isAttackerToMove)
+    moves.push_back(passMove);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a mainLine by following the best moves stored in the
+/// transposition table, starting with a move of @a colorToMove. The private
+/// board is left unchanged.
+// -----------------------------------------------------------------------------
+void GoLifeAndDeathSolver::getMainLine(GoBoardCore::StoneState colorToMove, std::vector<int>& mainLine)
+{
+  while (static_cast<int>(mainLine.size()) < this->maximumSearchDepth)
+  {
+    if (ResultUnknown != getTerminalResult())
+      break;
+    auto iterator = this->transpositionTable.find(getKey(colorToMove));
+    if (iterator == this->transpositionTable.end())
+      break;
+    int move = iterator->second.bestMove;
+    if (! play(move, colorToMove))
+      break;
+    mainLine.push_back(move);
+    colorToMove = GoBoardCore::getOpponentColor(colorToMove);
+  }
+
+  for (size_t indexOfMove = 0; indexOfMove < mainLine.size(); ++indexOfMove)
+    undo();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Plays a stone of color @a color on the intersection with index
+/// @a index, or a pass move if @a index is #passMove. Returns false if the
+/// move is illegal, in which case the private board is not modified.
+// -----------------------------------------------------------------------------
+bool GoLifeAndDeathSolver::play(int index, GoBoardCore::StoneState color)
+{
+  UndoRecord undoRecord;
+  undoRecord.index = index;
+  undoRecord.previousKoPoint = this->koPoint;
+  undoRecord.previousHash = this->hash;
+
+  if (passMove == index)
+  {
+    this->numberOfNodes++;
+    this->koPoint = -1;
+    this->undoStack.push_back(undoRecord);
+    return true;
+  }
+
+  if (this->boardCore.hasStone(index) || index == this->koPoint)
+    return false;
+  bool simpleKoIsPossible;
+  if (this->boardCore.isSuicide(index, color, &simpleKoIsPossible))
+    return false;
+
+  this->numberOfNodes++;
+
+  this->boardCore.getStonesCapturedByStone(index, color, undoRecord.capturedStones);
+
+  GoBoardCore::StoneState opponentColor = GoBoardCore::getOpponentColor(color);
+  this->boardCore.setStoneState(index, color);
+  this->hash ^= this->zobristValues[getZobristIndex(index, color)];
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int indexOfStone = 0; indexOfStone < numberOfPoints; ++indexOfStone)
+  {
+    if (undoRecord.capturedStones.test(indexOfStone))
+    {
+      this->boardCore.setStoneState(indexOfStone, GoBoardCore::StoneStateNone);
+      this->hash ^= this->zobristValues[getZobristIndex(indexOfStone, opponentColor)];
+    }
+  }
+
+  // The opponent may not immediately retake a single stone if the capturing
+  // stone is itself left with a single liberty
+  this->koPoint = -1;
+  if (simpleKoIsPossible && 1 == undoRecord.capturedStones.count() && 1 == this->boardCore.getNumberOfLiberties(index))
+    this->koPoint = this->boardCore.getFirstIndexInSet(undoRecord.capturedStones);
+
+  this->undoStack.push_back(undoRecord);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Takes back the move that was last played by play().
+// -----------------------------------------------------------------------------
+void GoLifeAndDeathSolver::undo()
+{
+  const UndoRecord& undoRecord = this->undoStack.back();
+
+  if (passMove != undoRecord.index)
+  {
+    GoBoardCore::StoneState opponentColor = GoBoardCore::getOpponentColor(this->boardCore.getStoneState(undoRecord.index));
+    this->boardCore.setStoneState(undoRecord.index, GoBoardCore::StoneStateNone);
+    int numberOfPoints = this->boardCore.getNumberOfPoints();
+    for (int indexOfStone = 0; indexOfStone < numberOfPoints; ++indexOfStone)
+    {
+      if (undoRecord.capturedStones.test(indexOfStone))
+        this->boardCore.setStoneState(indexOfStone, opponentColor);
+    }
+  }
+
+  this->koPoint = undoRecord.previousKoPoint;
+  this->hash = undoRecord.previousHash;
+  this->undoStack.pop_back();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the transposition table key of the current position on the
+/// private board, with @a colorToMove to move.
+// -----------------------------------------------------------------------------
+long long GoLifeAndDeathSolver::getKey(GoBoardCore::StoneState colorToMove) const
+{
+  unsigned long long key = static_cast<unsigned long long>(this->hash);
+  if (GoBoardCore::StoneStateWhite == colorToMove)
+    key ^= whiteToMoveKey;
+  if (this->koPoint >= 0)
+    key ^= static_cast<unsigned long long>(this->koPoint + 1) * koPointKeyMultiplier;
+  return static_cast<long long>(key);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index into the table of Zobrist values for a stone of
+/// color @a color on the intersection with index @a index. The layout is the
+/// same as in GoZobristTable: first all intersections for black stones, then
+/// all intersections for white stones.
+// -----------------------------------------------------------------------------
+int GoLifeAndDeathSolver::getZobristIndex(int index, GoBoardCore::StoneState color) const
+{
+  int colorOffset = (GoBoardCore::StoneStateBlack == color) ? 0 : this->boardCore.getNumberOfPoints();
+  return colorOffset + index;
+}
@@ -0,0 +1,154 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoBoardCore.h"
+
+// System includes
+#include <unordered_map>
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoLifeAndDeathSolver class solves life-and-death problems in a
+/// bounded region of the board, i.e. it answers whether a stone group can be
+/// killed, or whether it can live, and which sequence of moves proves the
+/// answer.
+///
+/// @ingroup go
+///
+/// GoLifeAndDeathSolver is meant for problems of the kind found in tsumego
+/// collections, where the Fuego whole-board search is both slow and
+/// unreliable. Like GoTacticalReader it searches on a private copy of a
+/// GoBoardCore object, so the original board is never modified, and a search
+/// can safely run on a secondary thread.
+///
+/// The search is a depth-first AND/OR search, i.e. an alpha-beta search with
+/// the two values "dead" and "alive". The side that owns the target stone
+/// group is the defender, the other side is the attacker.
+/// - The attacker wins as soon as one of the target stones is captured.
+/// - The defender wins as soon as all target stones belong to stone groups
+///   that are unconditionally alive (Benson's algorithm), or when the
+///   attacker has no legal move left inside the region (this covers seki).
+/// - The attacker may only play on empty intersections inside the region.
+///   The defender may play inside the region, or pass.
+///
+/// Positions whose value has been proven are stored in a transposition table.
+/// The key is the position's Zobrist hash, calculated with the random values
+/// of GoZobristTable (see GoZobristTable::zobristValues()), combined with the
+/// side to move and the simple ko point. Simple ko is taken into account,
+/// superko is not, instead the search depth is limited.
+///
+/// The search is limited by a node budget, each move played during the search
+/// counts as one node. If the budget is exhausted before the search reaches a
+/// conclusion, or if the search depth limit was hit, the result is
+/// #ResultUnknown.
+///
+/// GoLifeAndDeathSolver is not thread-safe, but different objects can be used
+/// on different threads at the same time.
+// -----------------------------------------------------------------------------
+class GoLifeAndDeathSolver
+{
+public:
+  /// @brief Enumerates the possible outcomes of a search.
+  enum Result
+  {
+    /// @brief The target stone group dies, i.e. the attacker wins.
+    ResultDead,
+    /// @brief The target stone group lives, i.e. the defender wins.
+    ResultAlive,
+    /// @brief The node budget was exhausted, or the search depth limit was
+    /// hit, before the search could reach a conclusion.
+    ResultUnknown
+  };
+
+  /// @brief The value that represents a pass move in a main line.
+  static const int passMove = -1;
+
+public:
+  GoLifeAndDeathSolver(const GoBoardCore& boardCore, const long long* zobristValues, int nodeBudget);
+  ~GoLifeAndDeathSolver();
+
+  Result solve(int targetIndex, const GoBoardCore::PointSet& region, GoBoardCore::StoneState colorToMove, std::vector<int>& mainLine);
+  int getNumberOfNodes() const;
+
+  static void getRegion(const GoBoardCore& boardCore, int targetIndex, int margin, GoBoardCore::PointSet& region);
+
+private:
+  Result search(GoBoardCore::StoneState colorToMove, int depth);
+  Result getTerminalResult() const;
+  bool isTargetCaptured() const;
+  bool isTargetUnconditionallyAlive() const;
+  void getMoves(GoBoardCore::StoneState colorToMove, std::vector<int>& moves);
+  void getMainLine(GoBoardCore::StoneState colorToMove, std::vector<int>& mainLine);
+  bool play(int index, GoBoardCore::StoneState color);
+  void undo();
+  long long getKey(GoBoardCore::StoneState colorToMove) const;
+  int getZobristIndex(int index, GoBoardCore::StoneState color) const;
+
+private:
+  /// @brief Information required to take back a move played during the
+  /// search.
+  struct UndoRecord
+  {
+    int index;
+    int previousKoPoint;
+    long long previousHash;
+    GoBoardCore::PointSet capturedStones;
+  };
+
+  /// @brief An entry in the transposition table.
+  struct TranspositionTableEntry
+  {
+    /// @brief The proven result of the position. Is never #ResultUnknown.
+    Result result;
+    /// @brief The move that proves the result if the side to move wins, or
+    /// the move that resists longest if the side to move loses.
+    int bestMove;
+  };
+
+  /// @brief The private copy of the board on which the search is performed.
+  GoBoardCore boardCore;
+  /// @brief The random values of GoZobristTable for the board size of
+  /// @e boardCore. GoLifeAndDeathSolver does not own the values.
+  const long long* zobristValues;
+  /// @brief The maximum number of nodes that a single search may visit.
+  int nodeBudget;
+  /// @brief The number of nodes that the last search visited.
+  int numberOfNodes;
+  /// @brief The maximum number of moves that the search may play in
+  /// sequence. Depends on the size of the region.
+  int maximumSearchDepth;
+  /// @brief The stones of the target stone group at the start of the search.
+  GoBoardCore::PointSet targetStones;
+  /// @brief The empty intersections on which moves may be played.
+  GoBoardCore::PointSet region;
+  /// @brief The color of the target stone group.
+  GoBoardCore::StoneState defenderColor;
+  /// @brief The opponent of @e defenderColor.
+  GoBoardCore::StoneState attackerColor;
+  /// @brief The index of the intersection on which the side to move may not
+  /// play because of simple ko. Is -1 if there is no such intersection.
+  int koPoint;
+  /// @brief The Zobrist hash of the current position on @e boardCore.
+  long long hash;
+  /// @brief The moves played during the search that have not yet been taken
+  /// back.
+  std::vector<UndoRecord> undoStack;
+  /// @brief The transposition table. Contains only proven results.
+  std::unordered_map<long long, TranspositionTableEntry> transpositionTable;
+};
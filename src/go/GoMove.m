@@ -18,6 +18,7 @@
 // Project includes
 #import "GoMove.h"
 #import "GoMoveAdditions.h"
+#import "GoBoard.h"
 #import "GoPlayer.h"
 #import "GoPoint.h"
 #import "GoBoardRegion.h"
@@ -258,10 +259,8 @@
   }
 
   // Update the point's stone state *BEFORE* moving it to a new region
-  if (self.player.black)
-    self.point.stoneState = GoColorBlack;
-  else
-    self.point.stoneState = GoColorWhite;
+  enum GoColor playedStoneColor = (self.player.black ? GoColorBlack : GoColorWhite);
+  self.point.stoneState = playedStoneColor;
   [GoUtilities movePointToNewRegion:self.point];
 
   // If the captured stones array already contains entries we assume that this
@@ -269,40 +268,33 @@
   // invoked for this GoMove
   bool redo = (_capturedStones.count > 0);
 
-  // Check neighbours for captures
-  for (GoPoint* neighbour in self.point.neighbours)
+  // The board determines the captured stones in a single query. The stones of
+  // a captured group all belong to the same GoBoardRegion, which turns back
+  // into an empty area when their stone state is reset.
+  //
+  // On a redo, and for the vast majority of moves that capture nothing, the
+  // captured stones array already has the correct content, so we merely
+  // verify it against the board. This avoids creating a temporary array of
+  // GoPoint objects each time the user navigates through the game.
+  GoBoard* board = self.point.board;
+  if (! [board areStones:_capturedStones capturedByStoneWithColor:playedStoneColor atPoint:self.point])
   {
-    if (! neighbour.hasStone)
-      continue;
-    if (neighbour.blackStone == self.point.blackStone)
-      continue;
-    if ([neighbour liberties] > 0)
-      continue;
-    // The stone made a capture!!!
-    for (GoPoint* capture in neighbour.region.points)
+    if (redo)
     {
-      // If in the next iteration of the outer loop we find a neighbour in the
-      // same captured group, the neighbour will already have its state reset,
-      // and we will skip it
-      capture.stoneState = GoColorNone;
-      if (redo)
-      {
-        if (! [_capturedStones containsObject:capture])
-        {
-          NSString* message = [NSString stringWithFormat:@"Redo of %@: Captured stone on point %@ is not in array", self, capture];
-          DDLogError(@"%@", message);
-          NSException* exception = [NSException exceptionWithName:NSInternalInconsistencyException
-                                                           reason:message
-                                                         userInfo:nil];
-          @throw exception;
-        }
-      }
-      else
-      {
-        [(NSMutableArray*)_capturedStones addObject:capture];
-      }
+      NSString* message = [NSString stringWithFormat:@"Redo of %@: Captured stones on the board do not match the stones in array", self];
+      DDLogError(@"%@", message);
+      NSException* exception = [NSException exceptionWithName:NSInternalInconsistencyException
+                                                       reason:message
+                                                     userInfo:nil];
+      @throw exception;
     }
+
+    [(NSMutableArray*)_capturedStones addObjectsFromArray:[board stonesCapturedByStoneWithColor:playedStoneColor
+                                                                                        atPoint:self.point]];
   }
+
+  for (GoPoint* capture in _capturedStones)
+    capture.stoneState = GoColorNone;
 }
 
 // -----------------------------------------------------------------------------
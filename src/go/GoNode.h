@@ -37,10 +37,26 @@
 /// The linking between nodes in the game tree is effected by the three
 /// primitive properties @e firstChild, @e nextSibling and @e parent. These
 /// three primitive properties are cheap to use and do not incur any calculation
-/// overhead. All other properties (e.g. @e previousSibling, @e lastChild,
-/// @e children) and methods (e.g. isDescendantOfNode:(), isAncestorOfNode:())
-/// are in some way or other based on the three primitive properties and require
-/// a certain amount of processing time for calculation.
+/// overhead. A fourth link, the weak back-link @e previousSibling, is
+/// maintained alongside @e nextSibling and is equally cheap to use. All other
+/// properties (e.g. @e lastChild, @e children) are in some way or other based
+/// on the primitive properties and require a certain amount of processing time
+/// for calculation.
+///
+/// The ancestor relationship methods (isDescendantOfNode:(),
+/// isAncestorOfNode:(), commonAncestorWithNode:()) do not walk the parent
+/// links one by one. Instead they use the cached ancestor information (see
+/// @e numberOfAncestors), which includes a so-called jump pointer to an
+/// ancestor node further up in the game tree. The jump pointers are laid out
+/// in a skew-binary pattern, so any ancestor of a node can be reached in a
+/// number of steps that is logarithmic in the depth of the node. Because the
+/// jump pointers are part of the cached ancestor information, they are only
+/// recalculated for nodes whose position in the game tree actually changes.
+///
+/// Clients that need to visit many nodes should prefer the enumeration methods
+/// (e.g. enumerateChildrenUsingBlock:()) over the @e children property: The
+/// enumeration methods walk the primitive links directly and do not allocate
+/// any memory, whereas @e children creates a new collection on every access.
 // -----------------------------------------------------------------------------
 @interface GoNode : NSObject <NSSecureCoding>
 {
@@ -64,6 +80,10 @@
 /// @brief Returns a collection of child nodes of the node. The collection
 /// is ordered, beginning with the first child node and ending with the
 /// last child node. The collection is empty if the node has no children.
+///
+/// A new collection is created every time this property is accessed. Use
+/// enumerateChildrenUsingBlock:() to iterate over the child nodes without
+/// this overhead.
 @property(nonatomic, retain, readonly) NSArray* children;
 
 /// @brief Returns @e true if the node has one or more children. Returns
@@ -88,18 +108,15 @@
 /// the node has no previous sibling node, i.e. if the node is the first
 /// child of its parent.
 ///
-/// Use this property with care. Unlike the properties @e firstChild,
-/// @e nextSibling and @e parent the implementation of this property has
-/// a substantial processing cost.
-@property(nonatomic, retain, readonly) GoNode* previousSibling;
+/// The reference to the previous sibling node is weak, i.e. nodes do not
+/// retain their previous sibling node. The back-link is maintained whenever
+/// the @e nextSibling link of the previous sibling changes, so accessing this
+/// property is as cheap as accessing @e nextSibling.
+@property(nonatomic, assign, readonly) GoNode* previousSibling;
 
 /// @brief Returns @e true if the node has a previous sibling node. Returns
 /// @e false if the node has no previous sibling node, i.e. if the node is the
 /// first child of its parent.
-///
-/// Use this property with care. Unlike the properties @e hasFirstChild,
-/// @e hasNextSibling and @e hasParent the implementation of this property has
-/// a substantial processing cost.
 @property(nonatomic, readonly) bool hasPreviousSibling;
 
 /// @brief Returns the node's parent node. Returns @e nil if the node
@@ -129,6 +146,14 @@
 /// @exception NSInvalidArgumentException Is raised if @a node is @e nil.
 - (bool) isAncestorOfNode:(GoNode*)node;
 
+/// @brief Returns the nearest node that is both the node itself or one of its
+/// ancestors, and @a node or one of its ancestors. Returns the node itself if
+/// it is the same as @a node, or an ancestor of @a node. Returns @e nil if
+/// the node and @a node are not in the same node tree.
+///
+/// @exception NSInvalidArgumentException Is raised if @a node is @e nil.
+- (GoNode*) commonAncestorWithNode:(GoNode*)node;
+
 /// @brief Returns @e true if the node is the root node of a node tree, i.e. if
 /// the node has no parent. Returns @e false if the node is not the root node
 /// of a node tree.
@@ -139,6 +164,31 @@
 @property(nonatomic, readonly) bool isLeaf;
 //@}
 
+/// @name Node tree enumeration
+///
+/// The enumeration methods walk the primitive links of the game tree
+/// and do not allocate any memory, regardless of the size of the game tree.
+/// The block can set its @a stop argument to @e true to end the enumeration
+/// early. The block must not modify the game tree while the enumeration is in
+/// progress.
+//@{
+/// @brief Invokes @a block once for every child node of the node, beginning
+/// with the first child node and ending with the last child node.
+- (void) enumerateChildrenUsingBlock:(void (^)(GoNode* child, bool* stop))block;
+
+/// @brief Invokes @a block once for every node in the sub tree that has the
+/// node as its root, including the node itself. Nodes are visited in
+/// depth-first pre-order, i.e. a node is visited before its children, and
+/// the sub tree of a child node is visited completely before the next sibling
+/// of the child node.
+- (void) enumerateSubtreeInPreorderUsingBlock:(void (^)(GoNode* node, bool* stop))block;
+
+/// @brief Invokes @a block once for every ancestor node of the node (excluding
+/// the node itself), beginning with the parent node and ending with the root
+/// node of the game tree.
+- (void) enumerateAncestorsUsingBlock:(void (^)(GoNode* ancestor, bool* stop))block;
+//@}
+
 /// @name Node data
 //@{
 /// @brief @e true if the node is empty and contains no data, @e false if the
@@ -168,10 +218,72 @@
 @property(nonatomic, retain) GoNodeMarkup* goNodeMarkup;
 //@}
 
+/// @name Ancestor information
+//@{
+/// @brief Returns the number of ancestor nodes (excluding the node itself),
+/// i.e. the depth of the node in the node tree. Returns zero if the node is
+/// the root node.
+///
+/// The value is cached in the same way as @e numberOfMovesBeforeNode.
+@property(nonatomic, assign, readonly) int numberOfAncestors;
+
+/// @brief Returns the number of ancestor nodes (excluding the node itself)
+/// that contain a move. Returns zero if the node is the root node.
+///
+/// The value is calculated on first access and then cached. The cached value
+/// is discarded when the node, or one of its ancestors, is moved to a new
+/// location in the game tree, or when the @e goMove property of the node, or
+/// of one of its ancestors, changes.
+@property(nonatomic, assign, readonly) int numberOfMovesBeforeNode;
+
+/// @brief Returns the first node among the node itself and its ancestors that
+/// contains a move. Returns @e nil if no move can be found.
+///
+/// The value is cached in the same way as @e numberOfMovesBeforeNode.
+@property(nonatomic, assign, readonly) GoNode* nodeWithMostRecentMove;
+
+/// @brief Returns the first node among the node itself and its ancestors that
+/// changes the board state, i.e. that contains either a move or setup
+/// information. Returns @e nil if no such node can be found.
+///
+/// The value is cached in the same way as @e numberOfMovesBeforeNode. The
+/// cached value is also discarded when the @e goNodeSetup property of the
+/// node, or of one of its ancestors, changes.
+@property(nonatomic, assign, readonly) GoNode* nodeWithMostRecentBoardStateChange;
+//@}
+
 /// @brief Zobrist hash that identifies the board position created by this node.
 /// Zobrist hashes are used to detect ko, and especially superko.
 @property(nonatomic, assign) long long zobristHash;
 
+/// @name Analysis data
+//@{
+/// @brief Stores @a moveSuggestion in this GoNode so that the move suggestion
+/// can be reused when the user requests a move suggestion for the same board
+/// position again, e.g. after navigating away and coming back.
+///
+/// @a moveSuggestion has the same content as the user info dictionary of the
+/// notification #computerPlayerGeneratedMoveSuggestion. @a komi is the komi
+/// that was in effect when the move suggestion was generated. The stored move
+/// suggestion replaces any move suggestion that was stored previously. The
+/// move suggestion is not archived.
+- (void) storeMoveSuggestion:(NSDictionary*)moveSuggestion komi:(double)komi;
+/// @brief Returns the move suggestion that was most recently stored in this
+/// GoNode. Returns @e nil if no move suggestion was stored, or if the stored
+/// move suggestion is not valid for a player of color @a color and a game with
+/// komi @a komi.
+///
+/// A stored move suggestion is also not valid anymore if the Zobrist hash of
+/// this GoNode changed after the move suggestion was stored, e.g. because the
+/// setup of this GoNode or of one of its ancestors changed. The ko situation
+/// does not need to be checked because the GoNode and its ancestors determine
+/// the entire history of the board position.
+- (NSDictionary*) moveSuggestionForColor:(enum GoColor)color komi:(double)komi;
+/// @brief Discards the move suggestion that was stored in this GoNode, if
+/// any.
+- (void) discardMoveSuggestion;
+//@}
+
 /// @name Changing the board based upon the node's data
 //@{
 /// @brief Modifies the board to reflect the data that is present in this
@@ -195,6 +307,19 @@
 /// @attention A new node must have been added to the node tree when this method
 /// is invoked, otherwise the parent node is not known.
 - (void) calculateZobristHash:(GoGame*)game;
+/// @brief Recalculates the node's Zobrist hash after the node's setup (or, for
+/// the root node, the game's handicap) changed, and propagates the change to
+/// all nodes in the sub tree below the node.
+///
+/// A Zobrist hash is the XOR of the random numbers of all stones on the board.
+/// The difference between the old and the new Zobrist hash of the node is
+/// therefore the same for every descendant node, as long as the descendant
+/// nodes do not themselves change the stones that make up that difference.
+/// The descendant nodes are updated by XOR'ing them with the difference,
+/// which is much cheaper than invoking calculateZobristHash:() for each of
+/// them. Does nothing beyond updating the node itself if the Zobrist hash of
+/// the node did not change.
+- (void) updateZobristHashAndPropagateToSubtree:(GoGame*)game;
 //@}
 
 @end
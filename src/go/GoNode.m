@@ -35,6 +35,23 @@
 @property(nonatomic, assign) unsigned int firstChildNodeID;
 @property(nonatomic, assign) unsigned int nextSiblingNodeID;
 @property(nonatomic, assign) unsigned int parentNodeID;
+/// @brief True if the cached ancestor information is valid. If this is true
+/// then it is also true for all ancestors of the node.
+@property(nonatomic, assign) bool ancestorInformationIsValid;
+@property(nonatomic, assign, readwrite) int numberOfAncestors;
+/// @brief The ancestor node that is the target of the node's jump pointer. Is
+/// the node itself if the node is the root node. Is part of the cached
+/// ancestor information.
+@property(nonatomic, assign) GoNode* jumpAncestor;
+@property(nonatomic, assign, readwrite) int numberOfMovesBeforeNode;
+@property(nonatomic, assign, readwrite) GoNode* nodeWithMostRecentMove;
+@property(nonatomic, assign, readwrite) GoNode* nodeWithMostRecentBoardStateChange;
+/// @name Analysis data
+//@{
+@property(nonatomic, retain) NSDictionary* moveSuggestion;
+@property(nonatomic, assign) long long moveSuggestionZobristHash;
+@property(nonatomic, assign) double moveSuggestionKomi;
+//@}
 @end
 
 
@@ -67,6 +84,7 @@
   // Don't use "self" to avoid the setter methods
   _firstChild = nil;
   _nextSibling = nil;
+  _previousSibling = nil;
   _parent = nil;
 
   self.goNodeSetup = nil;
@@ -76,6 +94,17 @@
 
   self.zobristHash = 0;
 
+  self.moveSuggestion = nil;
+  self.moveSuggestionZobristHash = 0;
+  self.moveSuggestionKomi = 0.0;
+
+  _ancestorInformationIsValid = false;
+  _numberOfAncestors = 0;
+  _jumpAncestor = nil;
+  _numberOfMovesBeforeNode = 0;
+  _nodeWithMostRecentMove = nil;
+  _nodeWithMostRecentBoardStateChange = nil;
+
   self.nodeID = gNoObjectReferenceNodeID;
   self.firstChildNodeID = gNoObjectReferenceNodeID;
   self.nextSiblingNodeID = gNoObjectReferenceNodeID;
@@ -97,9 +126,14 @@
   }
   if (_nextSibling)
   {
+    // The next sibling may survive us if someone else holds a reference to it
+    if (_nextSibling->_previousSibling == self)
+      _nextSibling->_previousSibling = nil;
     [_nextSibling release];
     _nextSibling = nil;
   }
+  // No need to release the previous sibling because it is not retained
+  _previousSibling = nil;
   if (_parent)
   {
     // No need to release the parent because it is not retained. We don't
@@ -111,6 +145,7 @@
   self.goMove = nil;
   self.goNodeAnnotation = nil;
   self.goNodeMarkup = nil;
+  self.moveSuggestion = nil;
 
   [super dealloc];
 }
@@ -168,9 +203,24 @@
   self.goNodeAnnotation = [decoder decodeObjectOfClass:[GoNodeAnnotation class] forKey:goNodeGoNodeAnnotationKey];
   self.goNodeMarkup = [decoder decodeObjectOfClass:[GoNodeMarkup class] forKey:goNodeGoNodeMarkupKey];
 
-  // The hash was not archived. Whoever is unarchiving this GoNode is
-  // responsible for re-calculating the hash.
-  self.zobristHash = 0;
+  // GoZobristTable always generates the same values for a given board size,
+  // so the archived hash is still valid and need not be re-calculated. When
+  // the hash is not present in the archive, decodeInt64ForKey returns the
+  // default value 0 (zero), which is also the value that was not archived.
+  self.zobristHash = [decoder decodeInt64ForKey:goNodeZobristHashKey];
+
+  // The move suggestion was not archived, it is generated on demand
+  self.moveSuggestion = nil;
+  self.moveSuggestionZobristHash = 0;
+  self.moveSuggestionKomi = 0.0;
+
+  // The ancestor information was not archived, it is calculated on demand
+  _ancestorInformationIsValid = false;
+  _numberOfAncestors = 0;
+  _jumpAncestor = nil;
+  _numberOfMovesBeforeNode = 0;
+  _nodeWithMostRecentMove = nil;
+  _nodeWithMostRecentBoardStateChange = nil;
 
   return self;
 }
@@ -214,12 +264,13 @@
   if (self.goNodeMarkup)
     [encoder encodeObject:self.goNodeMarkup forKey:goNodeGoNodeMarkupKey];
 
-  // GoZobristTable is not archived, instead a new GoZobristTable object with
-  // random values is created each time when a game is unarchived. Zobrist
-  // hashes created by the previous GoZobristTable object are thus invalid.
-  // This is the reason why we don't archive self.zobristHash here - it doesn't
-  // make sense to archive an invalid value. A side effect of not archiving
-  // self.zobristHash is that the overall archive becomes smaller.
+  // GoZobristTable is not archived, but because it always generates the same
+  // values for a given board size the hash remains valid after unarchiving.
+  // Archiving the hash saves a full pass over the node tree when the game is
+  // unarchived. A hash 0 (zero), e.g. of a root node without handicap, is
+  // omitted like the node IDs above - decoding restores it as the default.
+  if (self.zobristHash != 0)
+    [encoder encodeInt64:self.zobristHash forKey:goNodeZobristHashKey];
 }
 
 #pragma mark - Public API - Node tree navigation
@@ -285,37 +336,12 @@
   return (self.nextSibling != nil);
 }
 
-// -----------------------------------------------------------------------------
-// Property is documented in the header file.
-// -----------------------------------------------------------------------------
-- (GoNode*) previousSibling
-{
-  GoNode* parent = self.parent;
-  if (! parent)
-    return nil;
-
-  GoNode* child = parent.firstChild;
-  if (child == self)
-    return nil;
-
-  while (child)
-  {
-    GoNode* nextSibling = child.nextSibling;
-    if (nextSibling == self)
-      return child;
-    else
-      child = nextSibling;
-  }
-
-  return nil;
-}
-
 // -----------------------------------------------------------------------------
 // Property is documented in the header file.
 // -----------------------------------------------------------------------------
 - (bool) hasPreviousSibling
 {
-  return (self.previousSibling != nil);
+  return (_previousSibling != nil);
 }
 
 // -----------------------------------------------------------------------------
@@ -339,17 +365,11 @@
     return false;
   }
 
-  GoNode* parent = self.parent;
-
-  while (parent)
-  {
-    if (parent == node)
-      return true;
-    else
-      parent = parent.parent;
-  }
+  int numberOfAncestorsOfNode = node.numberOfAncestors;
+  if (self.numberOfAncestors <= numberOfAncestorsOfNode)
+    return false;
 
-  return false;
+  return ([self ancestorWithNumberOfAncestors:numberOfAncestorsOfNode] == node);
 }
 
 // -----------------------------------------------------------------------------
@@ -365,17 +385,61 @@
     return false;
   }
 
-  GoNode* parent = node.parent;
+  int numberOfAncestors = self.numberOfAncestors;
+  if (node.numberOfAncestors <= numberOfAncestors)
+    return false;
+
+  return ([node ancestorWithNumberOfAncestors:numberOfAncestors] == self);
+}
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (GoNode*) commonAncestorWithNode:(GoNode*)node
+{
+  if (! node)
+  {
+    [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:@"commonAncestorWithNode: failed: Node argument is nil"];
+    // Dummy return to make compiler happy (compiler does not see that an
+    // exception is thrown)
+    return nil;
+  }
 
-  while (parent)
+  GoNode* node1 = self;
+  GoNode* node2 = node;
+  int numberOfAncestors1 = node1.numberOfAncestors;
+  int numberOfAncestors2 = node2.numberOfAncestors;
+  if (numberOfAncestors1 > numberOfAncestors2)
+    node1 = [node1 ancestorWithNumberOfAncestors:numberOfAncestors2];
+  else if (numberOfAncestors2 > numberOfAncestors1)
+    node2 = [node2 ancestorWithNumberOfAncestors:numberOfAncestors1];
+
+  // The target of a jump pointer depends only on the depth of a node, so two
+  // nodes at the same depth always jump to the same depth. If the jump
+  // targets differ the common ancestor must be further up, so it is safe to
+  // jump. If the jump targets are the same the common ancestor may be
+  // somewhere in between, so we can only move up by one node.
+  while (node1 != node2)
   {
-    if (parent == self)
-      return true;
+    // Both nodes are root nodes of different node trees
+    if (! node1.parent)
+      return nil;
+
+    GoNode* jumpAncestor1 = node1.jumpAncestor;
+    GoNode* jumpAncestor2 = node2.jumpAncestor;
+    if (jumpAncestor1 != jumpAncestor2)
+    {
+      node1 = jumpAncestor1;
+      node2 = jumpAncestor2;
+    }
     else
-      parent = parent.parent;
+    {
+      node1 = node1.parent;
+      node2 = node2.parent;
+    }
   }
 
-  return false;
+  return node1;
 }
 
 // -----------------------------------------------------------------------------
@@ -394,6 +458,61 @@
   return (self.firstChild == nil);
 }
 
+#pragma mark - Public API - Node tree enumeration
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) enumerateChildrenUsingBlock:(void (^)(GoNode* child, bool* stop))block
+{
+  bool stop = false;
+  for (GoNode* child = _firstChild; child && ! stop; child = child->_nextSibling)
+    block(child, &stop);
+}
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) enumerateSubtreeInPreorderUsingBlock:(void (^)(GoNode* node, bool* stop))block
+{
+  // The sub tree is walked iteratively without an explicit stack: When a
+  // branch is exhausted we climb back up via the parent links until we find
+  // a node that has a next sibling. This works because the tree must not be
+  // modified during the enumeration.
+  bool stop = false;
+  GoNode* node = self;
+  while (true)
+  {
+    block(node, &stop);
+    if (stop)
+      break;
+
+    if (node->_firstChild)
+    {
+      node = node->_firstChild;
+      continue;
+    }
+
+    // Don't look at the receiver node's siblings, they are not part of the
+    // sub tree
+    while (node != self && ! node->_nextSibling)
+      node = node->_parent;
+    if (node == self)
+      break;
+    node = node->_nextSibling;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) enumerateAncestorsUsingBlock:(void (^)(GoNode* ancestor, bool* stop))block
+{
+  bool stop = false;
+  for (GoNode* ancestor = _parent; ancestor && ! stop; ancestor = ancestor->_parent)
+    block(ancestor, &stop);
+}
+
 #pragma mark - Public API - Node tree navigation
 
 // -----------------------------------------------------------------------------
@@ -407,6 +526,219 @@
           (! self.goNodeMarkup || ! self.goNodeMarkup.hasMarkup));
 }
 
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setGoNodeSetup:(GoNodeSetup*)goNodeSetup
+{
+  if (_goNodeSetup == goNodeSetup)
+    return;
+
+  if ((_goNodeSetup == nil) != (goNodeSetup == nil))
+    [self invalidateAncestorInformation];
+
+  [_goNodeSetup release];
+  _goNodeSetup = [goNodeSetup retain];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setGoMove:(GoMove*)goMove
+{
+  if (_goMove == goMove)
+    return;
+
+  if ((_goMove == nil) != (goMove == nil))
+    [self invalidateAncestorInformation];
+
+  [_goMove release];
+  _goMove = [goMove retain];
+}
+
+#pragma mark - Public API - Ancestor information
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (int) numberOfAncestors
+{
+  if (! _ancestorInformationIsValid)
+    [self updateAncestorInformation];
+  return _numberOfAncestors;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (int) numberOfMovesBeforeNode
+{
+  if (! _ancestorInformationIsValid)
+    [self updateAncestorInformation];
+  return _numberOfMovesBeforeNode;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (GoNode*) nodeWithMostRecentMove
+{
+  if (! _ancestorInformationIsValid)
+    [self updateAncestorInformation];
+  return _nodeWithMostRecentMove;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (GoNode*) nodeWithMostRecentBoardStateChange
+{
+  if (! _ancestorInformationIsValid)
+    [self updateAncestorInformation];
+  return _nodeWithMostRecentBoardStateChange;
+}
+
+#pragma mark - Private helpers - Ancestor information
+
+// -----------------------------------------------------------------------------
+// Property is documented in the class extension.
+// -----------------------------------------------------------------------------
+- (GoNode*) jumpAncestor
+{
+  if (! _ancestorInformationIsValid)
+    [self updateAncestorInformation];
+  return _jumpAncestor;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the receiver node itself or the ancestor of the receiver
+/// node whose @e numberOfAncestors property has the value
+/// @a numberOfAncestors.
+///
+/// The jump pointers are followed whenever they do not overshoot the target,
+/// otherwise the parent link is followed. The jump pointers are laid out in a
+/// skew-binary pattern, which guarantees that the target is reached in a
+/// logarithmic number of steps.
+///
+/// This is an internal helper. The caller must make sure that
+/// @a numberOfAncestors is not greater than the receiver node's
+/// @e numberOfAncestors and not negative.
+// -----------------------------------------------------------------------------
+- (GoNode*) ancestorWithNumberOfAncestors:(int)numberOfAncestors
+{
+  GoNode* node = self;
+  while (node.numberOfAncestors > numberOfAncestors)
+  {
+    GoNode* jumpAncestor = node.jumpAncestor;
+    if (jumpAncestor.numberOfAncestors >= numberOfAncestors)
+      node = jumpAncestor;
+    else
+      node = node.parent;
+  }
+  return node;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Calculates the ancestor information of the receiver node and of all
+/// of its ancestors whose ancestor information is not valid.
+///
+/// The calculation starts at the nearest ancestor whose ancestor information
+/// is still valid and proceeds downwards towards the receiver node, so that
+/// each node only has to look at its parent. This is done iteratively rather
+/// than recursively because the game tree can be very deep.
+///
+/// This is an internal helper for the ancestor information property getters.
+// -----------------------------------------------------------------------------
+- (void) updateAncestorInformation
+{
+  NSMutableArray* nodesToUpdate = [NSMutableArray array];
+
+  GoNode* node = self;
+  while (node && ! node.ancestorInformationIsValid)
+  {
+    [nodesToUpdate addObject:node];
+    node = node.parent;
+  }
+
+  for (node in [nodesToUpdate reverseObjectEnumerator])
+  {
+    GoNode* parent = node.parent;
+    if (parent)
+    {
+      // A node jumps over twice the distance of its parent's jump if the
+      // parent's jump target itself jumps over the same distance as the
+      // parent. Otherwise the node jumps to its parent. The resulting jump
+      // distances follow the skew-binary number system.
+      GoNode* parentJumpAncestor = parent.jumpAncestor;
+      GoNode* parentJumpAncestorJumpAncestor = parentJumpAncestor.jumpAncestor;
+      int parentNumberOfAncestors = parent.numberOfAncestors;
+      int parentJumpAncestorNumberOfAncestors = parentJumpAncestor.numberOfAncestors;
+      if (parentNumberOfAncestors - parentJumpAncestorNumberOfAncestors == parentJumpAncestorNumberOfAncestors - parentJumpAncestorJumpAncestor.numberOfAncestors)
+        node.jumpAncestor = parentJumpAncestorJumpAncestor;
+      else
+        node.jumpAncestor = parent;
+      node.numberOfAncestors = parentNumberOfAncestors + 1;
+
+      node.numberOfMovesBeforeNode = parent.numberOfMovesBeforeNode + (parent.goMove ? 1 : 0);
+      node.nodeWithMostRecentMove = node.goMove ? node : parent.nodeWithMostRecentMove;
+      node.nodeWithMostRecentBoardStateChange = (node.goMove || node.goNodeSetup) ? node : parent.nodeWithMostRecentBoardStateChange;
+    }
+    else
+    {
+      node.jumpAncestor = node;
+      node.numberOfAncestors = 0;
+
+      node.numberOfMovesBeforeNode = 0;
+      node.nodeWithMostRecentMove = node.goMove ? node : nil;
+      node.nodeWithMostRecentBoardStateChange = (node.goMove || node.goNodeSetup) ? node : nil;
+    }
+    node.ancestorInformationIsValid = true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the cached ancestor information of the receiver node and of
+/// all nodes in the sub tree dangling from it.
+///
+/// Because a node's ancestor information is only ever valid if its parent's
+/// ancestor information is also valid, the traversal does not need to descend
+/// below nodes whose ancestor information is already invalid. The traversal is
+/// done iteratively rather than recursively because the game tree can be very
+/// deep.
+///
+/// This is an internal helper for the goMove and goNodeSetup property setters,
+/// and for setParentInternal:().
+// -----------------------------------------------------------------------------
+- (void) invalidateAncestorInformation
+{
+  GoNode* node = self;
+  while (node)
+  {
+    GoNode* nextNode = nil;
+    if (node.ancestorInformationIsValid)
+    {
+      node.ancestorInformationIsValid = false;
+      node.jumpAncestor = nil;
+      node.nodeWithMostRecentMove = nil;
+      node.nodeWithMostRecentBoardStateChange = nil;
+      nextNode = node.firstChild;
+    }
+
+    if (! nextNode)
+    {
+      // Don't look at the receiver node's siblings, they are not part of the
+      // sub tree
+      while (node != self && ! node.nextSibling)
+        node = node.parent;
+      if (node == self)
+        break;
+      nextNode = node.nextSibling;
+    }
+
+    node = nextNode;
+  }
+}
+
 #pragma mark - Public API - Changing the board based upon the node's data
 
 // -----------------------------------------------------------------------------
@@ -444,6 +776,80 @@
                                                    inGame:game];
 }
 
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) updateZobristHashAndPropagateToSubtree:(GoGame*)game
+{
+  long long oldZobristHash = self.zobristHash;
+  [self calculateZobristHash:game];
+  long long zobristHashDifference = oldZobristHash ^ self.zobristHash;
+  if (zobristHashDifference == 0)
+    return;
+
+  // Iterative depth-first traversal of the sub tree to avoid a stack overflow
+  // in deep trees. The traversal does not need any bookkeeping because it can
+  // always find its way back up via the parent node.
+  GoNode* node = self.firstChild;
+  while (node)
+  {
+    node.zobristHash ^= zobristHashDifference;
+
+    if (node.firstChild)
+    {
+      node = node.firstChild;
+      continue;
+    }
+
+    while (node != self && ! node.nextSibling)
+      node = node.parent;
+    if (node == self)
+      break;
+    node = node.nextSibling;
+  }
+}
+
+#pragma mark - Public API - Analysis data
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) storeMoveSuggestion:(NSDictionary*)moveSuggestion komi:(double)komi
+{
+  self.moveSuggestion = moveSuggestion;
+  self.moveSuggestionZobristHash = self.zobristHash;
+  self.moveSuggestionKomi = komi;
+}
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) moveSuggestionForColor:(enum GoColor)color komi:(double)komi
+{
+  if (! self.moveSuggestion)
+    return nil;
+  if (self.moveSuggestionZobristHash != self.zobristHash)
+    return nil;
+  if (self.moveSuggestionKomi != komi)
+    return nil;
+
+  NSNumber* colorAsNumber = self.moveSuggestion[moveSuggestionColorKey];
+  if ([colorAsNumber intValue] != color)
+    return nil;
+
+  return self.moveSuggestion;
+}
+
+// -----------------------------------------------------------------------------
+// Method is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) discardMoveSuggestion
+{
+  self.moveSuggestion = nil;
+  self.moveSuggestionZobristHash = 0;
+  self.moveSuggestionKomi = 0.0;
+}
+
 @end
 
 #pragma mark - Implementation of GoNodeAdditions
@@ -800,6 +1206,7 @@
   else
   {
     GoNode* previousSibling = self.previousSibling;
+    // Also resets our own previousSibling back-link
     [previousSibling setNextSiblingInternal:self.nextSibling];
   }
 
@@ -829,9 +1236,6 @@
   if (previousSibling)
     [previousSibling setNextSiblingInternal:nil];
 
-  // We must set the parent's first child only after GetPreviousSibling()
-  // has been invoked (see above). Reason: GetPreviousSibling() requires the
-  // parent-to-first child link to be intact.
   GoNode* parent = self.parent;
   if (parent)
   {
@@ -894,6 +1298,9 @@
 /// retains @a child. The old first child node, if there is one, is released.
 /// @a child may be @e nil.
 ///
+/// A first child node by definition has no previous sibling, so this setter
+/// also resets the @e previousSibling back-link of @a child.
+///
 /// Along with setNextSiblingInternal:() and setParentInternal:() this is
 /// one of the three core setter methods used internally by all GoNodeAdditions
 /// methods to achieve their tree manipulation tasks. This setter does not
@@ -942,6 +1349,7 @@
   {
     _firstChild = child;
     [_firstChild retain];
+    _firstChild->_previousSibling = nil;
   }
 }
 
@@ -950,6 +1358,10 @@
 /// retains @a nextSibling. The old next sibling node, if there is one, is
 /// released. @a nextSibling may be @e nil.
 ///
+/// This setter also maintains the @e previousSibling back-link: The old next
+/// sibling node loses its back-link to the receiver node, and @a nextSibling
+/// gains a back-link to the receiver node.
+///
 /// Along with setFirstChildInternal:() and setParentInternal:() this is
 /// one of the three core setter methods used internally by all GoNodeAdditions
 /// methods to achieve their tree manipulation tasks. This setter does not
@@ -962,6 +1374,8 @@
   {
     // See the implementation of setFirstChildInternal:() for the detailed
     // reason why we use autorelease here instead of release.
+    if (_nextSibling->_previousSibling == self)
+      _nextSibling->_previousSibling = nil;
     [_nextSibling autorelease];
     _nextSibling = nil;
   }
@@ -970,6 +1384,7 @@
   {
     _nextSibling = nextSibling;
     [_nextSibling retain];
+    _nextSibling->_previousSibling = self;
   }
 }
 
@@ -988,14 +1403,21 @@
   // Unlike setFirstChildInternal:() and setNextSiblingInternal:() this does
   // NOT retain the parent, to avoid a retain cycle between a parent node and
   // its first child node.
+  if (_parent == parent)
+    return;
+
   _parent = parent;
+
+  // The receiver node has new ancestors, so the ancestor information of the
+  // entire sub tree dangling from it is no longer valid
+  [self invalidateAncestorInformation];
 }
 
 #pragma mark - GoNodeAdditions - NSCoding support
 
 // -----------------------------------------------------------------------------
 /// @brief Restores the object references in the properties @e firstChild,
-/// @e nextSibling and @e parent by looking up the GoNode objects in
+/// @e nextSibling, @e previousSibling and @e parent by looking up the GoNode objects in
 /// @a nodeDictionary using the node IDs stored in a number of private
 /// properties.
 ///
@@ -1007,7 +1429,10 @@
   if (self.firstChildNodeID > gNoObjectReferenceNodeID)
     _firstChild = [nodeDictionary[[NSNumber numberWithUnsignedInt:self.firstChildNodeID]] retain];
   if (self.nextSiblingNodeID > gNoObjectReferenceNodeID)
+  {
     _nextSibling = [nodeDictionary[[NSNumber numberWithUnsignedInt:self.nextSiblingNodeID]] retain];
+    _nextSibling->_previousSibling = self;  // the back-link is not archived
+  }
   if (self.parentNodeID > gNoObjectReferenceNodeID)
     _parent = nodeDictionary[[NSNumber numberWithUnsignedInt:self.parentNodeID]];  // do not retain to avoid retain cycle between parent and its first child
 
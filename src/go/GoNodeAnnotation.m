@@ -158,7 +158,14 @@
     _shortDescription = nil;
   }
 
-  if (shortDescription)
+  if (! shortDescription)
+    return;
+
+  // Avoid creating a new string if there is nothing to replace. The value may
+  // be a string that is shared by many nodes.
+  if ([shortDescription rangeOfString:@"\n"].location == NSNotFound)
+    _shortDescription = [shortDescription copy];
+  else
     _shortDescription = [[shortDescription stringByReplacingOccurrencesOfString:@"\n" withString:@" "] retain];
 }
 
@@ -14,6 +14,12 @@
 // limitations under the License.
 // -----------------------------------------------------------------------------
 
+// Project includes
+#import "GoVertexNumeric.h"
+
+// Forward declarations
+@class GoPoint;
+
 
 // -----------------------------------------------------------------------------
 /// @brief The GoNodeMarkup class extends a game tree node with properties that
@@ -21,12 +27,27 @@
 /// information, for the board position defined by the node.
 ///
 /// @ingroup go
+///
+/// GoNodeMarkup internally stores symbols, labels and connections in compact
+/// tables that are indexed by intersection, so that drawing and hit-testing can
+/// query the markup of an intersection without creating and comparing vertex
+/// strings. The methods and properties that work with vertex strings remain
+/// available for SGF I/O and for markup editing; they convert between vertex
+/// strings and the internal tables.
 // -----------------------------------------------------------------------------
 @interface GoNodeMarkup : NSObject <NSSecureCoding>
 {
 }
 
 - (bool) hasMarkup;
+- (bool) hasSymbols;
+- (bool) hasConnections;
+- (bool) hasLabels;
+
+- (bool) hasSymbolAtPoint:(GoPoint*)point symbol:(enum GoMarkupSymbol*)symbol;
+- (bool) hasLabelAtPoint:(GoPoint*)point labelType:(enum GoMarkupLabel*)labelType labelText:(NSString**)labelText;
+- (void) enumerateLabelsUsingBlock:(void (^)(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop))block;
+- (void) enumerateConnectionsUsingBlock:(void (^)(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop))block;
 
 - (void) setSymbol:(enum GoMarkupSymbol)symbol atVertex:(NSString*)vertex;
 - (void) removeSymbolAtVertex:(NSString*)vertex;
@@ -42,6 +63,7 @@
 - (void) removeLabelAtVertex:(NSString*)vertex;
 - (void) replaceLabels:(NSDictionary*)labels;
 - (void) removeAllLabels;
+- (unsigned long long) usedMarkersOfType:(enum GoMarkupLabel)labelType;
 + (NSString*) removeNewlinesAndTrimLabel:(NSString*)labelText;
 + (enum GoMarkupLabel) labelTypeOfLabel:(NSString*)labelText;
 + (enum GoMarkupLabel) labelTypeOfLabel:(NSString*)labelText
@@ -17,21 +17,132 @@
 
 // Project includes
 #import "GoNodeMarkup.h"
+#import "GoPoint.h"
+#import "GoVertex.h"
 #import "../utility/ExceptionUtility.h"
 
 
+/// @brief The number of entries in the point-indexed tables. The tables are
+/// large enough for the largest board size, so that GoNodeMarkup does not have
+/// to know the size of the board that its markup is drawn on.
+static const int numberOfPointIndexes = GoBoardSizeMax * GoBoardSizeMax;
+/// @brief The number of letter marker values, i.e. the lowercase letters "a-z"
+/// followed by the uppercase letters "A-Z".
+static const int numberOfLetterMarkerValues = 52;
+/// @brief The number of entries in the number marker usage table. This must be
+/// at least the number of values between #gMinimumNumberMarkerValue and
+/// #gMaximumNumberMarkerValue, and at most the number of bits in the used
+/// markers bitset.
+static const int maximumNumberOfNumberMarkerValues = 64;
+
+/// @brief An entry in the point-indexed label table. An entry whose
+/// @e labelText is @e nil indicates that there is no label at the point.
+struct GoNodeMarkupLabelEntry
+{
+  enum GoMarkupLabel labelType;
+  NSString* labelText;
+  /// @brief The index of the marker in the used markers bitset of the label
+  /// type, or -1 if the label is not a marker.
+  int markerIndex;
+};
+
+/// @brief An entry in the connection list.
+struct GoNodeMarkupConnectionEntry
+{
+  short fromPointIndex;
+  short toPointIndex;
+  enum GoMarkupConnection connection;
+};
+
+
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for GoNodeMarkup.
 // -----------------------------------------------------------------------------
 @interface GoNodeMarkup()
-@property(nonatomic, retain) NSMutableDictionary* mutableSymbols;
-@property(nonatomic, retain) NSMutableDictionary* mutableConnections;
-@property(nonatomic, retain) NSMutableDictionary* mutableLabels;
+{
+@private
+  /// @brief Point-indexed symbol table, one byte per point. A value of 0
+  /// indicates that there is no symbol at the point, other values are a value
+  /// from the enumeration #GoMarkupSymbol plus 1. Is NULL if there are no
+  /// symbols.
+  unsigned char* m_symbolTable;
+  /// @brief The number of non-zero entries in m_symbolTable.
+  int m_numberOfSymbols;
+  /// @brief Point-indexed label table. The label texts are retained. Is NULL
+  /// if there are no labels.
+  struct GoNodeMarkupLabelEntry* m_labelTable;
+  /// @brief The number of entries in m_labelTable that have a label text.
+  int m_numberOfLabels;
+  /// @brief List of connections, stored as pairs of point indexes. Is NULL if
+  /// there are no connections.
+  struct GoNodeMarkupConnectionEntry* m_connectionList;
+  /// @brief The number of entries in m_connectionList.
+  int m_numberOfConnections;
+  /// @brief The number of entries that m_connectionList has room for.
+  int m_connectionListCapacity;
+  /// @brief Bitset of the letter markers that are in use. See
+  /// usedMarkersOfType:() for the meaning of the bits.
+  unsigned long long m_usedLetterMarkers;
+  /// @brief Bitset of the number markers that are in use. See
+  /// usedMarkersOfType:() for the meaning of the bits.
+  unsigned long long m_usedNumberMarkers;
+  /// @brief The number of labels that use each letter marker. A letter marker
+  /// can be placed on more than one intersection, so a bit in
+  /// m_usedLetterMarkers can only be cleared when its count drops to zero.
+  unsigned short m_letterMarkerUseCount[numberOfLetterMarkerValues];
+  /// @brief The number of labels that use each number marker.
+  unsigned short m_numberMarkerUseCount[maximumNumberOfNumberMarkerValues];
+}
 @property(nonatomic, retain) NSMutableArray* mutableDimmings;
 //@}
 @end
 
 
+#pragma mark - Point index helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index into the point-indexed tables of the intersection
+/// identified by @a numericVertex.
+// -----------------------------------------------------------------------------
+static int pointIndexOfNumericVertex(struct GoVertexNumeric numericVertex)
+{
+  return (numericVertex.y - 1) * GoBoardSizeMax + (numericVertex.x - 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the numeric vertex of the intersection identified by
+/// @a pointIndex. This is the inverse of pointIndexOfNumericVertex().
+// -----------------------------------------------------------------------------
+static struct GoVertexNumeric numericVertexOfPointIndex(int pointIndex)
+{
+  struct GoVertexNumeric numericVertex;
+  numericVertex.x = pointIndex % GoBoardSizeMax + 1;
+  numericVertex.y = pointIndex / GoBoardSizeMax + 1;
+  return numericVertex;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index into the point-indexed tables of the intersection
+/// identified by the vertex string @a vertex.
+///
+/// @exception NSInvalidArgumentException, NSRangeException Are raised by
+/// GoVertex if @a vertex is not a valid vertex string.
+// -----------------------------------------------------------------------------
+static int pointIndexOfVertexString(NSString* vertex)
+{
+  return pointIndexOfNumericVertex([GoVertex vertexFromString:vertex].numeric);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the vertex string of the intersection identified by
+/// @a pointIndex.
+// -----------------------------------------------------------------------------
+static NSString* vertexStringOfPointIndex(int pointIndex)
+{
+  return [GoVertex vertexFromNumeric:numericVertexOfPointIndex(pointIndex)].string;
+}
+
+
 @implementation GoNodeMarkup
 
 #pragma mark - Initialization and deallocation
@@ -48,9 +159,15 @@
   if (! self)
     return nil;
 
-  self.mutableSymbols = nil;
-  self.mutableConnections = nil;
-  self.mutableLabels = nil;
+  m_symbolTable = NULL;
+  m_numberOfSymbols = 0;
+  m_labelTable = NULL;
+  m_numberOfLabels = 0;
+  m_connectionList = NULL;
+  m_numberOfConnections = 0;
+  m_connectionListCapacity = 0;
+  m_usedLetterMarkers = 0;
+  m_usedNumberMarkers = 0;
   self.mutableDimmings = nil;
 
   return self;
@@ -68,9 +185,22 @@
   if ([decoder decodeIntForKey:nscodingVersionKey] != nscodingVersion)
     return nil;
 
-  self.mutableSymbols = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSString class], [NSNumber class]]] forKey:goNodeMarkupSymbolsKey];
-  self.mutableConnections = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSArray class], [NSString class], [NSNumber class]]] forKey:goNodeMarkupConnectionsKey];
-  self.mutableLabels = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSString class], [NSArray class], [NSNumber class]]] forKey:goNodeMarkupLabelsKey];
+  m_symbolTable = NULL;
+  m_numberOfSymbols = 0;
+  m_labelTable = NULL;
+  m_numberOfLabels = 0;
+  m_connectionList = NULL;
+  m_numberOfConnections = 0;
+  m_connectionListCapacity = 0;
+  m_usedLetterMarkers = 0;
+  m_usedNumberMarkers = 0;
+
+  // The archive format stores markup keyed by vertex strings, just like the
+  // string API. This keeps the archive format independent of the in-memory
+  // layout of the point-indexed tables.
+  [self replaceSymbols:[decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSString class], [NSNumber class]]] forKey:goNodeMarkupSymbolsKey]];
+  [self replaceConnections:[decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSArray class], [NSString class], [NSNumber class]]] forKey:goNodeMarkupConnectionsKey]];
+  [self replaceLabels:[decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableDictionary class], [NSString class], [NSArray class], [NSNumber class]]] forKey:goNodeMarkupLabelsKey]];
   self.mutableDimmings = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableArray class], [NSString class]]] forKey:goNodeMarkupDimmingsKey];
 
   return self;
@@ -89,9 +219,9 @@
 // -----------------------------------------------------------------------------
 - (void) dealloc
 {
-  self.mutableSymbols = nil;
-  self.mutableConnections = nil;
-  self.mutableLabels = nil;
+  [self removeAllSymbols];
+  [self removeAllConnections];
+  [self removeAllLabels];
   self.mutableDimmings = nil;
 
   [super dealloc];
@@ -103,9 +233,9 @@
 - (void) encodeWithCoder:(NSCoder*)encoder
 {
   [encoder encodeInt:nscodingVersion forKey:nscodingVersionKey];
-  [encoder encodeObject:self.mutableSymbols forKey:goNodeMarkupSymbolsKey];
-  [encoder encodeObject:self.mutableConnections forKey:goNodeMarkupConnectionsKey];
-  [encoder encodeObject:self.mutableLabels forKey:goNodeMarkupLabelsKey];
+  [encoder encodeObject:self.symbols forKey:goNodeMarkupSymbolsKey];
+  [encoder encodeObject:self.connections forKey:goNodeMarkupConnectionsKey];
+  [encoder encodeObject:self.labels forKey:goNodeMarkupLabelsKey];
   [encoder encodeObject:self.mutableDimmings forKey:goNodeMarkupDimmingsKey];
 }
 
@@ -117,12 +247,40 @@
 // -----------------------------------------------------------------------------
 - (bool) hasMarkup
 {
-  return (self.mutableSymbols != nil ||
-          self.mutableConnections != nil ||
-          self.mutableLabels != nil ||
+  return (m_numberOfSymbols > 0 ||
+          m_numberOfConnections > 0 ||
+          m_numberOfLabels > 0 ||
           self.mutableDimmings != nil);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the GoNodeMarkup object contains at least one
+/// symbol. Returns false if the GoNodeMarkup object contains no symbols.
+// -----------------------------------------------------------------------------
+- (bool) hasSymbols
+{
+  return (m_numberOfSymbols > 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the GoNodeMarkup object contains at least one
+/// connection. Returns false if the GoNodeMarkup object contains no
+/// connections.
+// -----------------------------------------------------------------------------
+- (bool) hasConnections
+{
+  return (m_numberOfConnections > 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the GoNodeMarkup object contains at least one
+/// label. Returns false if the GoNodeMarkup object contains no labels.
+// -----------------------------------------------------------------------------
+- (bool) hasLabels
+{
+  return (m_numberOfLabels > 0);
+}
+
 #pragma mark - Symbol methods
 
 // -----------------------------------------------------------------------------
@@ -130,7 +288,41 @@
 // -----------------------------------------------------------------------------
 - (NSDictionary*) symbols
 {
-  return self.mutableSymbols;
+  if (m_numberOfSymbols == 0)
+    return nil;
+
+  NSMutableDictionary* symbols = [NSMutableDictionary dictionaryWithCapacity:m_numberOfSymbols];
+  for (int pointIndex = 0; pointIndex < numberOfPointIndexes; ++pointIndex)
+  {
+    unsigned char symbolTableEntry = m_symbolTable[pointIndex];
+    if (symbolTableEntry != 0)
+      symbols[vertexStringOfPointIndex(pointIndex)] = [NSNumber numberWithInt:symbolTableEntry - 1];
+  }
+  return symbols;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if there is a symbol at the intersection @a point.
+/// Returns false if there is no symbol at the intersection @a point.
+///
+/// If this method returns true and @a symbol is not NULL, @a symbol is filled
+/// with the type of the symbol.
+///
+/// This is much faster than looking up the symbol in the dictionary that is
+/// the value of property @e symbols, because no vertex strings are involved.
+// -----------------------------------------------------------------------------
+- (bool) hasSymbolAtPoint:(GoPoint*)point symbol:(enum GoMarkupSymbol*)symbol
+{
+  if (m_numberOfSymbols == 0)
+    return false;
+
+  unsigned char symbolTableEntry = m_symbolTable[pointIndexOfNumericVertex(point.vertex.numeric)];
+  if (symbolTableEntry == 0)
+    return false;
+
+  if (symbol)
+    *symbol = (enum GoMarkupSymbol)(symbolTableEntry - 1);
+  return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -152,12 +344,20 @@
     return;
   }
 
-  NSNumber* symbolAsNumber = [NSNumber numberWithInt:symbol];
+  [self setSymbol:symbol atPointIndex:pointIndexOfVertexString(vertex)];
+}
 
-  if (self.mutableSymbols)
-    self.mutableSymbols[vertex] = symbolAsNumber;
-  else
-    self.mutableSymbols = [NSMutableDictionary dictionaryWithObject:symbolAsNumber forKey:vertex];
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setSymbol:atVertex:() and replaceSymbols:().
+// -----------------------------------------------------------------------------
+- (void) setSymbol:(enum GoMarkupSymbol)symbol atPointIndex:(int)pointIndex
+{
+  if (! m_symbolTable)
+    m_symbolTable = calloc(numberOfPointIndexes, sizeof(unsigned char));
+
+  if (m_symbolTable[pointIndex] == 0)
+    m_numberOfSymbols++;
+  m_symbolTable[pointIndex] = symbol + 1;
 }
 
 // -----------------------------------------------------------------------------
@@ -181,13 +381,18 @@
     return;
   }
 
-  if (! self.mutableSymbols)
+  if (m_numberOfSymbols == 0)
     return;
 
-  [self.mutableSymbols removeObjectForKey:vertex];
+  int pointIndex = pointIndexOfVertexString(vertex);
+  if (m_symbolTable[pointIndex] == 0)
+    return;
+
+  m_symbolTable[pointIndex] = 0;
+  m_numberOfSymbols--;
 
-  if (self.mutableSymbols.count == 0)
-    self.mutableSymbols = nil;
+  if (m_numberOfSymbols == 0)
+    [self removeAllSymbols];
 }
 
 // -----------------------------------------------------------------------------
@@ -204,10 +409,14 @@
 // -----------------------------------------------------------------------------
 - (void) replaceSymbols:(NSDictionary*)symbols
 {
-  if (! symbols || symbols.count == 0)
-    [self removeAllSymbols];
-  else
-    self.mutableSymbols = [NSMutableDictionary dictionaryWithDictionary:symbols];
+  [self removeAllSymbols];
+  if (! symbols)
+    return;
+
+  [symbols enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* symbolAsNumber, BOOL* stop)
+  {
+    [self setSymbol:(enum GoMarkupSymbol)symbolAsNumber.intValue atPointIndex:pointIndexOfVertexString(vertexString)];
+  }];
 }
 
 // -----------------------------------------------------------------------------
@@ -219,7 +428,12 @@
 // -----------------------------------------------------------------------------
 - (void) removeAllSymbols
 {
-  self.mutableSymbols = nil;
+  if (m_symbolTable)
+  {
+    free(m_symbolTable);
+    m_symbolTable = NULL;
+  }
+  m_numberOfSymbols = 0;
 }
 
 #pragma mark - Connection methods
@@ -229,7 +443,40 @@
 // -----------------------------------------------------------------------------
 - (NSDictionary*) connections
 {
-  return self.mutableConnections;
+  if (m_numberOfConnections == 0)
+    return nil;
+
+  NSMutableDictionary* connections = [NSMutableDictionary dictionaryWithCapacity:m_numberOfConnections];
+  for (int connectionIndex = 0; connectionIndex < m_numberOfConnections; ++connectionIndex)
+  {
+    struct GoNodeMarkupConnectionEntry* connectionEntry = &m_connectionList[connectionIndex];
+    NSArray* vertices = @[vertexStringOfPointIndex(connectionEntry->fromPointIndex),
+                          vertexStringOfPointIndex(connectionEntry->toPointIndex)];
+    connections[vertices] = [NSNumber numberWithInt:connectionEntry->connection];
+  }
+  return connections;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Invokes @a block once for each connection. The block arguments are
+/// the start and end intersections of the connection, and the type of the
+/// connection. The block can set @a stop to true to stop the enumeration.
+///
+/// This is much faster than enumerating the dictionary that is the value of
+/// property @e connections, because no vertex strings are involved. The
+/// connections must not be modified while the enumeration is in progress.
+// -----------------------------------------------------------------------------
+- (void) enumerateConnectionsUsingBlock:(void (^)(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop))block
+{
+  bool stop = false;
+  for (int connectionIndex = 0; connectionIndex < m_numberOfConnections && ! stop; ++connectionIndex)
+  {
+    struct GoNodeMarkupConnectionEntry* connectionEntry = &m_connectionList[connectionIndex];
+    block(numericVertexOfPointIndex(connectionEntry->fromPointIndex),
+          numericVertexOfPointIndex(connectionEntry->toPointIndex),
+          connectionEntry->connection,
+          &stop);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -266,13 +513,51 @@
     return;
   }
 
-  NSArray* vertices = @[fromVertex, toVertex];
-  NSNumber* connectionAsNumber = [NSNumber numberWithInt:connection];
+  [self setConnection:connection
+        fromPointIndex:pointIndexOfVertexString(fromVertex)
+          toPointIndex:pointIndexOfVertexString(toVertex)];
+}
 
-  if (self.mutableConnections)
-    self.mutableConnections[vertices] = connectionAsNumber;
-  else
-    self.mutableConnections = [NSMutableDictionary dictionaryWithObject:connectionAsNumber forKey:vertices];
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setConnection:fromVertex:toVertex:() and
+/// replaceConnections:().
+// -----------------------------------------------------------------------------
+- (void) setConnection:(enum GoMarkupConnection)connection fromPointIndex:(int)fromPointIndex toPointIndex:(int)toPointIndex
+{
+  int connectionIndex = [self indexOfConnectionFromPointIndex:fromPointIndex toPointIndex:toPointIndex];
+  if (connectionIndex != -1)
+  {
+    m_connectionList[connectionIndex].connection = connection;
+    return;
+  }
+
+  if (m_numberOfConnections == m_connectionListCapacity)
+  {
+    m_connectionListCapacity = (m_connectionListCapacity == 0) ? 4 : m_connectionListCapacity * 2;
+    m_connectionList = realloc(m_connectionList, m_connectionListCapacity * sizeof(struct GoNodeMarkupConnectionEntry));
+  }
+
+  struct GoNodeMarkupConnectionEntry* connectionEntry = &m_connectionList[m_numberOfConnections];
+  connectionEntry->fromPointIndex = fromPointIndex;
+  connectionEntry->toPointIndex = toPointIndex;
+  connectionEntry->connection = connection;
+  m_numberOfConnections++;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the index in the connection list of the
+/// connection from @a fromPointIndex to @a toPointIndex. Returns -1 if there
+/// is no such connection.
+// -----------------------------------------------------------------------------
+- (int) indexOfConnectionFromPointIndex:(int)fromPointIndex toPointIndex:(int)toPointIndex
+{
+  for (int connectionIndex = 0; connectionIndex < m_numberOfConnections; ++connectionIndex)
+  {
+    struct GoNodeMarkupConnectionEntry* connectionEntry = &m_connectionList[connectionIndex];
+    if (connectionEntry->fromPointIndex == fromPointIndex && connectionEntry->toPointIndex == toPointIndex)
+      return connectionIndex;
+  }
+  return -1;
 }
 
 // -----------------------------------------------------------------------------
@@ -303,15 +588,21 @@
     return;
   }
 
-  if (! self.mutableConnections)
+  if (m_numberOfConnections == 0)
     return;
 
-  NSArray* vertices = @[fromVertex, toVertex];
+  int connectionIndex = [self indexOfConnectionFromPointIndex:pointIndexOfVertexString(fromVertex)
+                                                 toPointIndex:pointIndexOfVertexString(toVertex)];
+  if (connectionIndex == -1)
+    return;
 
-  [self.mutableConnections removeObjectForKey:vertices];
+  // The order of connections is not significant, so we can fill the gap with
+  // the last entry
+  m_numberOfConnections--;
+  m_connectionList[connectionIndex] = m_connectionList[m_numberOfConnections];
 
-  if (self.mutableConnections.count == 0)
-    self.mutableConnections = nil;
+  if (m_numberOfConnections == 0)
+    [self removeAllConnections];
 }
 
 // -----------------------------------------------------------------------------
@@ -350,7 +641,14 @@
         return;
       }
     }
-    self.mutableConnections = [NSMutableDictionary dictionaryWithDictionary:connections];
+
+    [self removeAllConnections];
+    [connections enumerateKeysAndObjectsUsingBlock:^(NSArray* vertices, NSNumber* connectionAsNumber, BOOL* stop)
+    {
+      [self setConnection:(enum GoMarkupConnection)connectionAsNumber.intValue
+           fromPointIndex:pointIndexOfVertexString(vertices.firstObject)
+             toPointIndex:pointIndexOfVertexString(vertices.lastObject)];
+    }];
   }
 }
 
@@ -363,7 +661,13 @@
 // -----------------------------------------------------------------------------
 - (void) removeAllConnections
 {
-  self.mutableConnections = nil;
+  if (m_connectionList)
+  {
+    free(m_connectionList);
+    m_connectionList = NULL;
+  }
+  m_numberOfConnections = 0;
+  m_connectionListCapacity = 0;
 }
 
 #pragma mark - Label methods
@@ -373,7 +677,66 @@
 // -----------------------------------------------------------------------------
 - (NSDictionary*) labels
 {
-  return self.mutableLabels;
+  if (m_numberOfLabels == 0)
+    return nil;
+
+  NSMutableDictionary* labels = [NSMutableDictionary dictionaryWithCapacity:m_numberOfLabels];
+  for (int pointIndex = 0; pointIndex < numberOfPointIndexes; ++pointIndex)
+  {
+    struct GoNodeMarkupLabelEntry* labelEntry = &m_labelTable[pointIndex];
+    if (labelEntry->labelText)
+      labels[vertexStringOfPointIndex(pointIndex)] = @[[NSNumber numberWithInt:labelEntry->labelType], labelEntry->labelText];
+  }
+  return labels;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if there is a label at the intersection @a point.
+/// Returns false if there is no label at the intersection @a point.
+///
+/// If this method returns true, @a labelType and @a labelText are filled with
+/// the type and the text of the label, unless they are NULL.
+///
+/// This is much faster than looking up the label in the dictionary that is
+/// the value of property @e labels, because no vertex strings are involved.
+// -----------------------------------------------------------------------------
+- (bool) hasLabelAtPoint:(GoPoint*)point labelType:(enum GoMarkupLabel*)labelType labelText:(NSString**)labelText
+{
+  if (m_numberOfLabels == 0)
+    return false;
+
+  struct GoNodeMarkupLabelEntry* labelEntry = &m_labelTable[pointIndexOfNumericVertex(point.vertex.numeric)];
+  if (! labelEntry->labelText)
+    return false;
+
+  if (labelType)
+    *labelType = labelEntry->labelType;
+  if (labelText)
+    *labelText = labelEntry->labelText;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Invokes @a block once for each label. The block arguments are the
+/// intersection of the label, and the type and the text of the label. The
+/// block can set @a stop to true to stop the enumeration.
+///
+/// This is much faster than enumerating the dictionary that is the value of
+/// property @e labels, because no vertex strings are involved. The labels
+/// must not be modified while the enumeration is in progress.
+// -----------------------------------------------------------------------------
+- (void) enumerateLabelsUsingBlock:(void (^)(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop))block
+{
+  if (m_numberOfLabels == 0)
+    return;
+
+  bool stop = false;
+  for (int pointIndex = 0; pointIndex < numberOfPointIndexes && ! stop; ++pointIndex)
+  {
+    struct GoNodeMarkupLabelEntry* labelEntry = &m_labelTable[pointIndex];
+    if (labelEntry->labelText)
+      block(numericVertexOfPointIndex(pointIndex), labelEntry->labelType, labelEntry->labelText, &stop);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -424,12 +787,120 @@
     return;
   }
 
-  NSArray* dictionaryValue = @[[NSNumber numberWithInt:label], labelText];
+  [self setLabel:label labelText:labelText atPointIndex:pointIndexOfVertexString(vertex)];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setLabel:labelText:atVertex:() and
+/// replaceLabels:(). @a labelText must already have been trimmed and
+/// validated.
+// -----------------------------------------------------------------------------
+- (void) setLabel:(enum GoMarkupLabel)label labelText:(NSString*)labelText atPointIndex:(int)pointIndex
+{
+  if (! m_labelTable)
+    m_labelTable = calloc(numberOfPointIndexes, sizeof(struct GoNodeMarkupLabelEntry));
 
-  if (self.mutableLabels)
-    self.mutableLabels[vertex] = dictionaryValue;
+  struct GoNodeMarkupLabelEntry* labelEntry = &m_labelTable[pointIndex];
+  if (labelEntry->labelText)
+  {
+    [self releaseMarkerOfLabelEntry:labelEntry];
+    [labelEntry->labelText release];
+  }
   else
-    self.mutableLabels = [NSMutableDictionary dictionaryWithObject:dictionaryValue forKey:vertex];
+  {
+    m_numberOfLabels++;
+  }
+  labelEntry->labelType = label;
+  labelEntry->labelText = [labelText copy];
+  [self useMarkerOfLabelEntry:labelEntry];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setLabel:labelText:atPointIndex:(). Determines
+/// the marker index of the label in @a labelEntry and marks the marker as
+/// being in use.
+// -----------------------------------------------------------------------------
+- (void) useMarkerOfLabelEntry:(struct GoNodeMarkupLabelEntry*)labelEntry
+{
+  labelEntry->markerIndex = -1;
+  if (labelEntry->labelType == GoMarkupLabelLabel)
+    return;
+
+  char letterMarkerValue;
+  int numberMarkerValue;
+  [GoNodeMarkup labelTypeOfLabel:labelEntry->labelText
+               letterMarkerValue:&letterMarkerValue
+               numberMarkerValue:&numberMarkerValue];
+
+  if (labelEntry->labelType == GoMarkupLabelMarkerLetter)
+  {
+    int markerIndex;
+    if (letterMarkerValue >= 'a' && letterMarkerValue <= 'z')
+      markerIndex = letterMarkerValue - 'a';
+    else
+      markerIndex = letterMarkerValue - 'A' + 26;
+    labelEntry->markerIndex = markerIndex;
+    m_letterMarkerUseCount[markerIndex]++;
+    m_usedLetterMarkers |= (1ULL << markerIndex);
+  }
+  else
+  {
+    int markerIndex = numberMarkerValue - gMinimumNumberMarkerValue;
+    labelEntry->markerIndex = markerIndex;
+    m_numberMarkerUseCount[markerIndex]++;
+    m_usedNumberMarkers |= (1ULL << markerIndex);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Marks the marker of the label in @a labelEntry as no
+/// longer being in use by that label.
+// -----------------------------------------------------------------------------
+- (void) releaseMarkerOfLabelEntry:(struct GoNodeMarkupLabelEntry*)labelEntry
+{
+  int markerIndex = labelEntry->markerIndex;
+  if (markerIndex == -1)
+    return;
+
+  if (labelEntry->labelType == GoMarkupLabelMarkerLetter)
+  {
+    if (--m_letterMarkerUseCount[markerIndex] == 0)
+      m_usedLetterMarkers &= ~(1ULL << markerIndex);
+  }
+  else
+  {
+    if (--m_numberMarkerUseCount[markerIndex] == 0)
+      m_usedNumberMarkers &= ~(1ULL << markerIndex);
+  }
+  labelEntry->markerIndex = -1;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a bitset that indicates which markers of the marker type
+/// @a labelType are in use. A bit is set if at least one label uses the
+/// corresponding marker.
+///
+/// For #GoMarkupLabelMarkerLetter bit 0 corresponds to the letter marker "a",
+/// bit 25 to "z", bit 26 to "A" and bit 51 to "Z". For
+/// #GoMarkupLabelMarkerNumber bit 0 corresponds to the number marker
+/// #gMinimumNumberMarkerValue, bit 1 to the next higher number marker, and so
+/// on up to #gMaximumNumberMarkerValue.
+///
+/// The bitset is updated whenever labels are set or removed, so querying it
+/// does not require an analysis of the label texts.
+///
+/// @exception NSInvalidArgumentException Is raised if @a labelType is neither
+/// #GoMarkupLabelMarkerLetter nor #GoMarkupLabelMarkerNumber.
+// -----------------------------------------------------------------------------
+- (unsigned long long) usedMarkersOfType:(enum GoMarkupLabel)labelType
+{
+  if (labelType == GoMarkupLabelMarkerLetter)
+    return m_usedLetterMarkers;
+  else if (labelType == GoMarkupLabelMarkerNumber)
+    return m_usedNumberMarkers;
+
+  [ExceptionUtility throwInvalidArgumentExceptionWithFormat:@"usedMarkersOfType: failed: invalid label type %d" argumentValue:labelType];
+  return 0;  // dummy return to make compiler happy
 }
 
 // -----------------------------------------------------------------------------
@@ -453,13 +924,20 @@
     return;
   }
 
-  if (! self.mutableLabels)
+  if (m_numberOfLabels == 0)
     return;
 
-  [self.mutableLabels removeObjectForKey:vertex];
+  struct GoNodeMarkupLabelEntry* labelEntry = &m_labelTable[pointIndexOfVertexString(vertex)];
+  if (! labelEntry->labelText)
+    return;
 
-  if (self.mutableLabels.count == 0)
-    self.mutableLabels = nil;
+  [self releaseMarkerOfLabelEntry:labelEntry];
+  [labelEntry->labelText release];
+  labelEntry->labelText = nil;
+  m_numberOfLabels--;
+
+  if (m_numberOfLabels == 0)
+    [self removeAllLabels];
 }
 
 // -----------------------------------------------------------------------------
@@ -490,8 +968,8 @@
   }
   else
   {
-    NSMutableDictionary* newMutableLabels = [NSMutableDictionary dictionary];
-
+    // Validate all label texts before the existing labels are discarded
+    NSMutableDictionary* trimmedLabelTexts = [NSMutableDictionary dictionaryWithCapacity:labels.count];
     [labels enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSArray* labelTypeAndText, BOOL* stop)
     {
       NSString* labelText = labelTypeAndText.lastObject;
@@ -502,11 +980,15 @@
         return;
       }
 
-      enum GoMarkupLabel labelType = [GoNodeMarkup labelTypeOfLabel:labelText];
-      newMutableLabels[vertexString] = @[[NSNumber numberWithInt:labelType], labelText];
+      trimmedLabelTexts[vertexString] = labelText;
     }];
 
-    self.mutableLabels = newMutableLabels;
+    [self removeAllLabels];
+    [trimmedLabelTexts enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSString* labelText, BOOL* stop)
+    {
+      enum GoMarkupLabel labelType = [GoNodeMarkup labelTypeOfLabel:labelText];
+      [self setLabel:labelType labelText:labelText atPointIndex:pointIndexOfVertexString(vertexString)];
+    }];
   }
 }
 
@@ -519,7 +1001,19 @@
 // -----------------------------------------------------------------------------
 - (void) removeAllLabels
 {
-  self.mutableLabels = nil;
+  if (m_labelTable)
+  {
+    for (int pointIndex = 0; pointIndex < numberOfPointIndexes; ++pointIndex)
+      [m_labelTable[pointIndex].labelText release];
+    free(m_labelTable);
+    m_labelTable = NULL;
+  }
+  m_numberOfLabels = 0;
+
+  m_usedLetterMarkers = 0;
+  m_usedNumberMarkers = 0;
+  memset(m_letterMarkerUseCount, 0, sizeof(m_letterMarkerUseCount));
+  memset(m_numberMarkerUseCount, 0, sizeof(m_numberMarkerUseCount));
 }
 
 // -----------------------------------------------------------------------------
@@ -39,6 +39,45 @@
 ///
 /// Invoking GoNodeModel methods that add or discard nodes generally sets the
 /// GoGameDocument dirty flag.
+///
+///
+/// @par Board snapshots
+///
+/// GoNodeModel also acts as a cache for board snapshots of the current
+/// variation. A board snapshot is an opaque NSData object that captures the
+/// state of the board after the node at a given index position has modified
+/// the board. GoBoardPosition stores a snapshot every
+/// @e boardSnapshotInterval nodes while it moves forward through the current
+/// variation and restores the nearest snapshot when the user jumps to a
+/// distant board position, so that at most @e boardSnapshotInterval nodes
+/// need to be replayed.
+///
+/// Snapshots are not archived. GoNodeModel discards snapshots whose index
+/// position is no longer valid when nodes are discarded or when the current
+/// variation changes. Clients that change the board state of a node in the
+/// current variation (e.g. by changing its setup) must invoke
+/// discardBoardSnapshotsFromIndex:().
+///
+///
+/// @par Jump targets
+///
+/// GoNodeModel maintains sorted indexes of the nodes in the current variation
+/// that are of interest for jump navigation (see enumeration
+/// #GoNodeJumpTarget), and a map from move numbers to the nodes in the current
+/// variation that contain the moves. Clients can therefore jump to the next or
+/// previous node with a comment, a hotspot, markup or setup, or to the node of
+/// a given move number, without walking the game tree. The indexes are updated
+/// incrementally together with the current variation. Clients that change the
+/// annotation, markup or setup data of a node, or the valuation of a node's
+/// move, must invoke updateJumpTargetsOfNode:().
+///
+///
+/// @par Tree change journal
+///
+/// GoNodeModel records a GoNodeTreeChange object for every node that it
+/// inserts into, or removes from, the game tree. Whoever posts the
+/// #goNodeTreeLayoutDidChange notification invokes finishTreeChangeBatch() to
+/// obtain the recorded changes and passes them along with the notification.
 // -----------------------------------------------------------------------------
 @interface GoNodeModel : NSObject <NSSecureCoding>
 {
@@ -60,6 +99,24 @@
 - (void) discardNodesFromIndex:(int)index;
 - (void) discardLeafNode;
 - (void) discardAllNodes;
+- (NSArray*) finishTreeChangeBatch;
+
+/// @name Jump targets
+//@{
+- (int) indexOfNextNodeWithJumpTarget:(enum GoNodeJumpTarget)jumpTarget afterIndex:(int)index;
+- (int) indexOfPreviousNodeWithJumpTarget:(enum GoNodeJumpTarget)jumpTarget beforeIndex:(int)index;
+- (int) indexOfNodeWithMoveNumber:(int)moveNumber;
+- (void) updateJumpTargetsOfNode:(GoNode*)node;
+//@}
+
+/// @name Board snapshots
+//@{
+- (bool) shouldStoreBoardSnapshotAtIndex:(int)index;
+- (void) storeBoardSnapshot:(NSData*)snapshot atIndex:(int)index;
+- (int) indexOfBoardSnapshotNearestToIndex:(int)index;
+- (NSData*) boardSnapshotAtIndex:(int)index;
+- (void) discardBoardSnapshotsFromIndex:(int)index;
+//@}
 
 /// @brief The game tree's root node. This always returns a non-nil value, i.e.
 /// when a new game is created it already has a root node.
@@ -86,4 +143,16 @@
 /// change value after property @e numberOfNodes.
 @property(nonatomic, assign, readonly) int numberOfMoves;
 
+/// @brief The number of nodes between two board snapshots. The default value
+/// is #gDefaultBoardSnapshotInterval. Setting a value <= 0 disables board
+/// snapshots. Changing the value discards all board snapshots.
+@property(nonatomic, assign) int boardSnapshotInterval;
+
+/// @brief The maximum number of board snapshots that GoNodeModel keeps. The
+/// default value is #gDefaultMaximumNumberOfBoardSnapshots. Once the maximum
+/// is reached, board snapshots at greater index positions displace those at
+/// smaller index positions, because the former save more replaying. Changing
+/// the value discards all board snapshots.
+@property(nonatomic, assign) int maximumNumberOfBoardSnapshots;
+
 @end
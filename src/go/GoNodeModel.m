@@ -19,7 +19,12 @@
 #import "GoNodeModel.h"
 #import "GoGame.h"
 #import "GoNodeAdditions.h"
+#import "GoNodeMarkup.h"
+#import "GoNodeSetup.h"
+#import "GoNodeTreeChange.h"
 #import "GoGameDocument.h"
+#import "GoUtilities.h"
+#import "../shared/DeferredDeallocationQueue.h"
 #import "../utility/ExceptionUtility.h"
 
 
@@ -31,6 +36,25 @@
 //@{
 @property(nonatomic, assign) GoGame* game;
 @property(nonatomic, retain) NSMutableArray* nodeList;
+/// @brief Keys = GoNode objects in @e nodeList wrapped in NSValue objects,
+/// values = Index positions of the GoNode objects in @e nodeList as NSNumber
+/// objects. Allows indexOfNode:() to find a node without scanning
+/// @e nodeList.
+@property(nonatomic, retain) NSMutableDictionary* nodeIndexes;
+/// @brief Index = Value from the enumeration #GoNodeJumpTarget, value =
+/// NSMutableIndexSet with the index positions of the GoNode objects in
+/// @e nodeList that are jump targets of that kind.
+@property(nonatomic, retain) NSArray* jumpTargetIndexes;
+/// @brief Index positions of the GoNode objects in @e nodeList that contain a
+/// move, as NSNumber objects in ascending order. The element at index position
+/// N is the node with move number N+1.
+@property(nonatomic, retain) NSMutableArray* moveNodeIndexes;
+/// @brief Keys = Index positions as NSNumber objects, values = Board snapshots
+/// as NSData objects.
+@property(nonatomic, retain) NSMutableDictionary* boardSnapshots;
+/// @brief GoNodeTreeChange objects that describe the structural changes made
+/// to the game tree since finishTreeChangeBatch() was last invoked.
+@property(nonatomic, retain) NSMutableArray* treeChangeJournal;
 //@}
 /// @name Re-declaration of properties to make them readwrite privately
 //@{
@@ -61,8 +85,16 @@
   self.game = game;
   self.rootNode = [GoNode node];
   self.nodeList = [NSMutableArray arrayWithObject:self.rootNode];
+  self.nodeIndexes = [NSMutableDictionary dictionary];
+  self.jumpTargetIndexes = [self emptyJumpTargetIndexes];
+  self.moveNodeIndexes = [NSMutableArray array];
+  [self addNodeIndexesFromIndex:0];
   self.numberOfNodes = 1;
   self.numberOfMoves = 0;
+  self.boardSnapshots = [NSMutableDictionary dictionary];
+  _boardSnapshotInterval = gDefaultBoardSnapshotInterval;
+  _maximumNumberOfBoardSnapshots = gDefaultMaximumNumberOfBoardSnapshots;
+  self.treeChangeJournal = [NSMutableArray array];
 
   return self;
 }
@@ -75,6 +107,11 @@
   self.game = nil;
   self.rootNode = nil;
   self.nodeList = nil;
+  self.nodeIndexes = nil;
+  self.jumpTargetIndexes = nil;
+  self.moveNodeIndexes = nil;
+  self.boardSnapshots = nil;
+  self.treeChangeJournal = nil;
 
   [super dealloc];
 }
@@ -99,8 +136,21 @@
   self.game = [decoder decodeObjectOfClass:[GoGame class] forKey:goNodeModelGameKey];
   self.rootNode = [decoder decodeObjectOfClass:[GoNode class] forKey:goNodeModelRootNodeKey];
   self.nodeList = [decoder decodeObjectOfClasses:[NSSet setWithArray:@[[NSMutableArray class], [GoNode class]]] forKey:goNodeModelNodeListKey];
+  // Node indexes and jump target indexes are not archived, they are rebuilt
+  // from the node list
+  self.nodeIndexes = [NSMutableDictionary dictionary];
+  self.jumpTargetIndexes = [self emptyJumpTargetIndexes];
+  self.moveNodeIndexes = [NSMutableArray array];
+  [self addNodeIndexesFromIndex:0];
   self.numberOfNodes = [decoder decodeIntForKey:goNodeModelNumberOfNodesKey];
   self.numberOfMoves = [decoder decodeIntForKey:goNodeModelNumberOfMovesKey];
+  // Board snapshots are not archived, they are re-created on demand
+  self.boardSnapshots = [NSMutableDictionary dictionary];
+  _boardSnapshotInterval = gDefaultBoardSnapshotInterval;
+  _maximumNumberOfBoardSnapshots = gDefaultMaximumNumberOfBoardSnapshots;
+  // The tree change journal is not archived, unarchiving is a change of the
+  // entire tree anyway
+  self.treeChangeJournal = [NSMutableArray array];
 
   return self;
 }
@@ -172,38 +222,15 @@
   // with the root node, because node IDs are simply looked up in the
   // dictionary upon unarchiving.
 
-  NSMutableArray* stack = [NSMutableArray array];
+  __block unsigned int nodeID = gNoObjectReferenceNodeID;
 
-  GoNode* currentNode = self.rootNode;
-  unsigned int nodeID = gNoObjectReferenceNodeID;
-
-  while (true)
+  [self.rootNode enumerateSubtreeInPreorderUsingBlock:^(GoNode* node, bool* stop)
   {
-    while (currentNode)
-    {
-      nodeID++;
-      currentNode.nodeID = nodeID;
-      NSNumber* nodeIDAsNumber = [NSNumber numberWithUnsignedInt:nodeID];
-      nodeDictionaryForEncoding[nodeIDAsNumber] = currentNode;
-
-      [stack addObject:currentNode];
-
-      currentNode = currentNode.firstChild;
-    }
-
-    if (stack.count > 0)
-    {
-      currentNode = stack.lastObject;
-      [stack removeLastObject];
-
-      currentNode = currentNode.nextSibling;
-    }
-    else
-    {
-      // We're done
-      break;
-    }
-  }
+    nodeID++;
+    node.nodeID = nodeID;
+    NSNumber* nodeIDAsNumber = [NSNumber numberWithUnsignedInt:nodeID];
+    nodeDictionaryForEncoding[nodeIDAsNumber] = node;
+  }];
 
   return nodeDictionaryForEncoding;
 }
@@ -265,6 +292,8 @@
 
   // GoNode performs most of the error handling for us
   [parent insertChild:node beforeReferenceChild:nextSibling];
+
+  [self.treeChangeJournal addObject:[GoNodeTreeChange treeChangeWithType:GoNodeTreeChangeTypeInsert node:node parent:parent]];
 }
 
 // -----------------------------------------------------------------------------
@@ -282,6 +311,12 @@
 /// consists of @a node, all of @a node's ancestors up to the root node of the
 /// game tree, and all of @a node's @e firstChild descendants.
 ///
+/// Only the part of the current variation that follows the branching node,
+/// i.e. the nearest ancestor of @a node that is in the current variation, is
+/// replaced. This assumes that the linkage of the nodes up to and including
+/// the branching node has not been changed since the current variation was
+/// configured.
+///
 /// Raises @e NSInvalidArgumentException if @a node is @e nil, or if @a node is
 /// not in the same game tree as the root node accessible via property
 /// @e rootNode.
@@ -296,21 +331,14 @@
     return;
   }
 
-  NSMutableArray* newNodeList = [NSMutableArray arrayWithObject:node];
-  int newNumberOfMoves = node.goMove ? 1 : 0;
-
-  GoNode* parent = node.parent;
-  while (parent)
-  {
-    [newNodeList insertObject:parent atIndex:0];
-
-    if (parent.goMove)
-      newNumberOfMoves++;
-
-    parent = parent.parent;
-  }
-
-  if (newNodeList.firstObject != self.rootNode)
+  // The new variation shares all nodes up to and including the branching node
+  // with the current variation, so we only have to determine the divergent
+  // suffix. The branching node is the nearest ancestor of the node (or the
+  // node itself) that is in the current variation. Collecting the suffix and
+  // splicing it into the node list is proportional to the length of the
+  // branches involved, not to the length of the game.
+  GoNode* branchingNode = [self nearestAncestorInCurrentVariation:node];
+  if (! branchingNode)
   {
     [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:@"changeToVariationContainingNode: failed: root node is not at the variation start"];
     // Dummy return to make compiler happy (compiler does not see that an
@@ -318,20 +346,63 @@
     return;
   }
 
+  NSMutableArray* divergentAncestors = [NSMutableArray array];
+  for (GoNode* divergentAncestor = node; divergentAncestor != branchingNode; divergentAncestor = divergentAncestor.parent)
+    [divergentAncestors addObject:divergentAncestor];
+
+  NSMutableArray* newSuffix = [NSMutableArray arrayWithArray:[[divergentAncestors reverseObjectEnumerator] allObjects]];
   GoNode* firstChild = node.firstChild;
   while (firstChild)
   {
-    [newNodeList addObject:firstChild];
+    [newSuffix addObject:firstChild];
+    firstChild = firstChild.firstChild;
+  }
 
-    if (firstChild.goMove)
-      newNumberOfMoves++;
+  // If the node is itself in the current variation, the new suffix may begin
+  // with nodes that are already at the right index position. Keeping these
+  // nodes also keeps their board snapshots.
+  int indexOfFirstDifferentNode = [self indexOfNode:branchingNode] + 1;
+  // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
+  // is safe because this app was not made to handle more than pow(2, 31) nodes.
+  int oldNumberOfNodes = (int)_nodeList.count;
+  int newSuffixCount = (int)newSuffix.count;
+  int indexInNewSuffix = 0;
+  while (indexInNewSuffix < newSuffixCount &&
+         indexOfFirstDifferentNode < oldNumberOfNodes &&
+         [_nodeList objectAtIndex:indexOfFirstDifferentNode] == [newSuffix objectAtIndex:indexInNewSuffix])
+  {
+    indexOfFirstDifferentNode++;
+    indexInNewSuffix++;
+  }
 
-    firstChild = firstChild.firstChild;
+  int newNumberOfMoves = self.numberOfMoves;
+  for (int indexOfNodeToDiscard = indexOfFirstDifferentNode; indexOfNodeToDiscard < oldNumberOfNodes; ++indexOfNodeToDiscard)
+  {
+    GoNode* nodeToDiscard = [_nodeList objectAtIndex:indexOfNodeToDiscard];
+    if (nodeToDiscard.goMove)
+      newNumberOfMoves--;
+  }
+
+  // Board snapshots remain valid only for the nodes that the old and the new
+  // variation have in common
+  [self discardBoardSnapshotsFromIndex:indexOfFirstDifferentNode];
+  [self removeNodeIndexesFromIndex:indexOfFirstDifferentNode];
+
+  NSRange rangeToDiscard = NSMakeRange(indexOfFirstDifferentNode, oldNumberOfNodes - indexOfFirstDifferentNode);
+  [_nodeList removeObjectsInRange:rangeToDiscard];
+  for (; indexInNewSuffix < newSuffixCount; ++indexInNewSuffix)
+  {
+    GoNode* nodeToAdd = [newSuffix objectAtIndex:indexInNewSuffix];
+    [_nodeList addObject:nodeToAdd];
+    if (nodeToAdd.goMove)
+      newNumberOfMoves++;
   }
 
-  int newNumberOfNodes = (int)newNodeList.count;
+  [self addNodeIndexesFromIndex:indexOfFirstDifferentNode];
 
-  self.nodeList = newNodeList;
+  // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
+  // is safe because this app was not made to handle more than pow(2, 31) nodes.
+  int newNumberOfNodes = (int)_nodeList.count;
 
   self.numberOfNodes = newNumberOfNodes;
   self.numberOfMoves = newNumberOfMoves;
@@ -357,13 +428,9 @@
     return nil;
   }
 
-  while (node)
-  {
-    NSUInteger index = [_nodeList indexOfObject:node];
-    if (index != NSNotFound)
-      return node;
-    node = node.parent;
-  }
+  GoNode* ancestor = [self nearestAncestorInCurrentVariation:node];
+  if (ancestor)
+    return ancestor;
 
   [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:@"ancestorOfNodeInCurrentVariation: failed: node is not in the game tree that contains the current variation"];
   // Dummy return to make compiler happy (compiler does not see that an
@@ -404,14 +471,11 @@
     return -1;
   }
 
-  NSUInteger index = [_nodeList indexOfObject:node];
-  if (index == NSNotFound)
+  NSNumber* index = [_nodeIndexes objectForKey:[NSValue valueWithNonretainedObject:node]];
+  if (! index)
     return -1;
 
-  // Cast is required because NSUInteger and int differ in size in 64-bit.
-  // Cast is safe because this app was not made to handle more than
-  // pow(2, 31) nodes.
-  return (int)index;
+  return index.intValue;
 }
 
 // -----------------------------------------------------------------------------
@@ -441,12 +505,14 @@
   // performs validation that detects e.g. if the node is already an ancestor
   // of the leaf node, i.e. if it is already part of the variation.
   [_nodeList addObject:node];
+  [self.treeChangeJournal addObject:[GoNodeTreeChange treeChangeWithType:GoNodeTreeChangeTypeInsert node:node parent:leafNode]];
 
   self.game.document.dirty = true;
 
   // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
   // is safe because this app was not made to handle more than pow(2, 31) nodes.
   self.numberOfNodes = (int)_nodeList.count;
+  [self addNodeIndexesFromIndex:self.numberOfNodes - 1];
   if (node.goMove)
     self.numberOfMoves = self.numberOfMoves + 1;
 }
@@ -463,6 +529,9 @@
 /// discarded) or exceeds the number of GoNode objects in the current variation.
 ///
 /// Invoking this method sets the GoGameDocument dirty flag.
+///
+/// The discarded GoNode objects are deallocated piece by piece while the main
+/// thread is idle, by DeferredDeallocationQueue.
 // -----------------------------------------------------------------------------
 - (void) discardNodesFromIndex:(int)index
 {
@@ -524,6 +593,12 @@
   GoNode* previousSiblingOfFirstNodeToDiscard = nil;
   if (! nextSiblingOfFirstNodeToDiscard)
     previousSiblingOfFirstNodeToDiscard = firstNodeToDiscard.previousSibling;
+  // The journal entry retains the discarded nodes, so they must be recorded
+  // before they are unlinked from the game tree
+  [self.treeChangeJournal addObject:[GoNodeTreeChange treeChangeWithType:GoNodeTreeChangeTypeRemove node:firstNodeToDiscard parent:parentNode]];
+  // The discarded sub tree can contain thousands of nodes, deallocating them
+  // must not block the caller
+  [[DeferredDeallocationQueue sharedQueue] releaseObjectsWhenIdle:[GoUtilities objectsInDeallocationOrderForSubtree:firstNodeToDiscard]];
   [parentNode removeChild:firstNodeToDiscard];
   // No GoMove unlinking necessary here, this is done in GoMove::dealloc()
 
@@ -531,9 +606,11 @@
   // unlinking performs validation. There is currently no known reason why this
   // should fail, but at least we are consistent with how things are done in
   // appendNode:().
+  [self removeNodeIndexesFromIndex:index];
   NSUInteger numberOfNodesToDiscard = _nodeList.count - index;
   NSRange rangeToDiscard = NSMakeRange(index, numberOfNodesToDiscard);
   [_nodeList removeObjectsInRange:rangeToDiscard];
+  [self discardBoardSnapshotsFromIndex:index];
 
   GoNode* nodeToAdd = nextSiblingOfFirstNodeToDiscard ? nextSiblingOfFirstNodeToDiscard : previousSiblingOfFirstNodeToDiscard;
   while (nodeToAdd)
@@ -545,6 +622,7 @@
 
     nodeToAdd = nodeToAdd.firstChild;
   }
+  [self addNodeIndexesFromIndex:index];
 
   self.game.document.dirty = true;
 
@@ -594,6 +672,390 @@
   [self discardNodesFromIndex:1];  // raises exception for us
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoNodeTreeChange objects that describe, in the order in
+/// which they occurred, the structural changes made to the game tree since
+/// this method was last invoked. Returns an empty array if there were no
+/// changes. Starts a new batch, i.e. the journal is empty after this method
+/// returns.
+///
+/// The caller is expected to pass the returned array along with the
+/// #goNodeTreeLayoutDidChange notification.
+// -----------------------------------------------------------------------------
+- (NSArray*) finishTreeChangeBatch
+{
+  NSArray* treeChanges = [[self.treeChangeJournal retain] autorelease];
+  self.treeChangeJournal = [NSMutableArray array];
+  return treeChanges;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns @a node itself if it is part of the current variation,
+/// otherwise the nearest ancestor of @a node that is part of the current
+/// variation. Returns @e nil if @a node is not in the same game tree as the
+/// current variation.
+///
+/// As long as the linkage of the nodes in the current variation has not
+/// changed, the current variation is the path from the root node to the leaf
+/// node. The result is then the common ancestor of @a node and the leaf node,
+/// which GoNode can find without visiting every ancestor of @a node. A node's
+/// depth in the game tree must match its index position, otherwise the
+/// linkage has changed and the ancestors of @a node are examined one by one.
+// -----------------------------------------------------------------------------
+- (GoNode*) nearestAncestorInCurrentVariation:(GoNode*)node
+{
+  GoNode* commonAncestor = [node commonAncestorWithNode:_nodeList.lastObject];
+  if (commonAncestor)
+  {
+    NSNumber* indexOfCommonAncestor = [_nodeIndexes objectForKey:[NSValue valueWithNonretainedObject:commonAncestor]];
+    if (indexOfCommonAncestor && indexOfCommonAncestor.intValue == commonAncestor.numberOfAncestors)
+      return commonAncestor;
+  }
+
+  while (node)
+  {
+    if ([_nodeIndexes objectForKey:[NSValue valueWithNonretainedObject:node]])
+      return node;
+    node = node.parent;
+  }
+
+  return nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Adds the GoNode objects in @e nodeList at index position @a index
+/// and beyond to @e nodeIndexes.
+// -----------------------------------------------------------------------------
+- (void) addNodeIndexesFromIndex:(int)index
+{
+  // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
+  // is safe because this app was not made to handle more than pow(2, 31) nodes.
+  int numberOfNodes = (int)_nodeList.count;
+  for (int indexOfNode = index; indexOfNode < numberOfNodes; ++indexOfNode)
+  {
+    GoNode* node = [_nodeList objectAtIndex:indexOfNode];
+    NSNumber* indexOfNodeAsNumber = [NSNumber numberWithInt:indexOfNode];
+    NSValue* key = [NSValue valueWithNonretainedObject:node];
+    [_nodeIndexes setObject:indexOfNodeAsNumber forKey:key];
+
+    [self updateJumpTargetIndexesOfNode:node atIndex:indexOfNode];
+    // Nodes are added in ascending order, so this keeps the list sorted
+    if (node.goMove)
+      [_moveNodeIndexes addObject:indexOfNodeAsNumber];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the GoNode objects in @e nodeList at index position @a index
+/// and beyond from @e nodeIndexes. Must be invoked before the GoNode objects
+/// are removed from @e nodeList.
+// -----------------------------------------------------------------------------
+- (void) removeNodeIndexesFromIndex:(int)index
+{
+  // Cast is required because NSUInteger and int differ in size in 64-bit. Cast
+  // is safe because this app was not made to handle more than pow(2, 31) nodes.
+  int numberOfNodes = (int)_nodeList.count;
+  for (int indexOfNode = index; indexOfNode < numberOfNodes; ++indexOfNode)
+  {
+    NSValue* key = [NSValue valueWithNonretainedObject:[_nodeList objectAtIndex:indexOfNode]];
+    [_nodeIndexes removeObjectForKey:key];
+  }
+
+  if (index >= numberOfNodes)
+    return;
+
+  NSRange rangeToRemove = NSMakeRange(index, numberOfNodes - index);
+  for (NSMutableIndexSet* indexSet in _jumpTargetIndexes)
+    [indexSet removeIndexesInRange:rangeToRemove];
+
+  NSUInteger indexOfFirstMoveNodeToRemove = [_moveNodeIndexes indexOfObject:[NSNumber numberWithInt:index]
+                                                              inSortedRange:NSMakeRange(0, _moveNodeIndexes.count)
+                                                                    options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual
+                                                            usingComparator:^(NSNumber* number1, NSNumber* number2)
+  {
+    return [number1 compare:number2];
+  }];
+  [_moveNodeIndexes removeObjectsInRange:NSMakeRange(indexOfFirstMoveNodeToRemove, _moveNodeIndexes.count - indexOfFirstMoveNodeToRemove)];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a new array with one empty NSMutableIndexSet for each value
+/// in the enumeration #GoNodeJumpTarget.
+// -----------------------------------------------------------------------------
+- (NSArray*) emptyJumpTargetIndexes
+{
+  NSMutableArray* jumpTargetIndexes = [NSMutableArray arrayWithCapacity:GoNodeJumpTargetMax];
+  for (int jumpTarget = 0; jumpTarget < GoNodeJumpTargetMax; ++jumpTarget)
+    [jumpTargetIndexes addObject:[NSMutableIndexSet indexSet]];
+  return jumpTargetIndexes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Adds @a index to, or removes @a index from, each of the index sets
+/// in @e jumpTargetIndexes, depending on whether @a node, which is located at
+/// index position @a index in @e nodeList, is a jump target of the index set's
+/// kind.
+// -----------------------------------------------------------------------------
+- (void) updateJumpTargetIndexesOfNode:(GoNode*)node atIndex:(int)index
+{
+  for (int jumpTarget = 0; jumpTarget < GoNodeJumpTargetMax; ++jumpTarget)
+  {
+    NSMutableIndexSet* indexSet = [_jumpTargetIndexes objectAtIndex:jumpTarget];
+    if ([self isNode:node jumpTarget:jumpTarget])
+      [indexSet addIndex:index];
+    else
+      [indexSet removeIndex:index];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a node is a jump target of kind @a jumpTarget.
+// -----------------------------------------------------------------------------
+- (bool) isNode:(GoNode*)node jumpTarget:(enum GoNodeJumpTarget)jumpTarget
+{
+  switch (jumpTarget)
+  {
+    case GoNodeJumpTargetInfo:
+      return [GoUtilities showInfoIndicatorForNode:node];
+    case GoNodeJumpTargetHotspot:
+      return [GoUtilities showHotspotIndicatorForNode:node];
+    case GoNodeJumpTargetMarkup:
+      return (node.goNodeMarkup && node.goNodeMarkup.hasMarkup);
+    case GoNodeJumpTargetSetup:
+      return (node.goNodeSetup && ! node.goNodeSetup.isEmpty);
+    default:
+      return false;
+  }
+}
+
+#pragma mark - Public interface - Jump targets
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index position of the first node in the current
+/// variation after index position @a index that is a jump target of kind
+/// @a jumpTarget. Returns -1 if there is no such node.
+///
+/// Invoking this method with @a index -1 returns the first jump target of the
+/// current variation.
+// -----------------------------------------------------------------------------
+- (int) indexOfNextNodeWithJumpTarget:(enum GoNodeJumpTarget)jumpTarget afterIndex:(int)index
+{
+  NSIndexSet* indexSet = [_jumpTargetIndexes objectAtIndex:jumpTarget];
+  NSUInteger indexOfNextNode = [indexSet indexGreaterThanOrEqualToIndex:(index < 0 ? 0 : index + 1)];
+  if (indexOfNextNode == NSNotFound)
+    return -1;
+  // Cast is safe because this app was not made to handle more than pow(2, 31)
+  // nodes
+  return (int)indexOfNextNode;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index position of the last node in the current
+/// variation before index position @a index that is a jump target of kind
+/// @a jumpTarget. Returns -1 if there is no such node.
+///
+/// Invoking this method with @a index equal to @e numberOfNodes returns the
+/// last jump target of the current variation.
+// -----------------------------------------------------------------------------
+- (int) indexOfPreviousNodeWithJumpTarget:(enum GoNodeJumpTarget)jumpTarget beforeIndex:(int)index
+{
+  if (index <= 0)
+    return -1;
+
+  NSIndexSet* indexSet = [_jumpTargetIndexes objectAtIndex:jumpTarget];
+  NSUInteger indexOfPreviousNode = [indexSet indexLessThanIndex:index];
+  if (indexOfPreviousNode == NSNotFound)
+    return -1;
+  // Cast is safe because this app was not made to handle more than pow(2, 31)
+  // nodes
+  return (int)indexOfPreviousNode;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index position of the node in the current variation that
+/// contains the move with move number @a moveNumber. Returns -1 if
+/// @a moveNumber is < 1 or exceeds @e numberOfMoves.
+// -----------------------------------------------------------------------------
+- (int) indexOfNodeWithMoveNumber:(int)moveNumber
+{
+  if (moveNumber < 1 || moveNumber > _moveNodeIndexes.count)
+    return -1;
+
+  NSNumber* indexOfNode = [_moveNodeIndexes objectAtIndex:moveNumber - 1];
+  return indexOfNode.intValue;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the jump target indexes after the annotation, markup or
+/// setup data of @a node, or the valuation of @a node's move, has changed.
+/// Does nothing if @a node is not in the current variation, because the
+/// indexes of such a node are determined when it becomes part of the current
+/// variation.
+///
+/// Raises @e NSInvalidArgumentException if @a node is @e nil.
+// -----------------------------------------------------------------------------
+- (void) updateJumpTargetsOfNode:(GoNode*)node
+{
+  int index = [self indexOfNode:node];  // raises exception for us
+  if (index == -1)
+    return;
+
+  [self updateJumpTargetIndexesOfNode:node atIndex:index];
+}
+
+#pragma mark - Public interface - Board snapshots
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if a board snapshot should be stored for the node at
+/// index position @a index in the current variation. Returns false if board
+/// snapshots are disabled, if @a index is not a multiple of
+/// @e boardSnapshotInterval, or if a snapshot already exists for @a index.
+///
+/// The root node at index position 0 never gets a snapshot.
+// -----------------------------------------------------------------------------
+- (bool) shouldStoreBoardSnapshotAtIndex:(int)index
+{
+  if (_boardSnapshotInterval <= 0 || _maximumNumberOfBoardSnapshots <= 0)
+    return false;
+  if (index <= 0 || (index % _boardSnapshotInterval) != 0)
+    return false;
+  return ([_boardSnapshots objectForKey:[NSNumber numberWithInt:index]] == nil);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Stores @a snapshot as the board snapshot for the node at index
+/// position @a index in the current variation, replacing any snapshot that
+/// may already exist for that index position.
+///
+/// If the maximum number of board snapshots has already been reached, the
+/// snapshot with the smallest index position is discarded first. Does nothing
+/// if @a index is smaller than the index positions of all existing snapshots
+/// in that case.
+///
+/// Raises @e NSInvalidArgumentException if @a snapshot is @e nil. Raises
+/// @e NSRangeException if @a index is < 1 or exceeds the number of GoNode
+/// objects in the current variation.
+// -----------------------------------------------------------------------------
+- (void) storeBoardSnapshot:(NSData*)snapshot atIndex:(int)index
+{
+  if (! snapshot)
+  {
+    [ExceptionUtility throwInvalidArgumentExceptionWithErrorMessage:@"storeBoardSnapshot:atIndex: failed: snapshot is nil object"];
+    // Dummy return to make compiler happy (compiler does not see that an
+    // exception is thrown)
+    return;
+  }
+  if (index < 1 || index >= _nodeList.count)
+  {
+    NSString* errorMessage = [NSString stringWithFormat:@"Index %d must be >= 1 and must not exceed number of nodes %lu", index, (unsigned long)_nodeList.count];
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSRangeException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  NSNumber* key = [NSNumber numberWithInt:index];
+  if (! [_boardSnapshots objectForKey:key] && _boardSnapshots.count >= _maximumNumberOfBoardSnapshots)
+  {
+    NSNumber* smallestKey = nil;
+    for (NSNumber* existingKey in _boardSnapshots)
+    {
+      if (! smallestKey || existingKey.intValue < smallestKey.intValue)
+        smallestKey = existingKey;
+    }
+    if (smallestKey.intValue > index)
+      return;
+    [_boardSnapshots removeObjectForKey:smallestKey];
+  }
+
+  [_boardSnapshots setObject:snapshot forKey:key];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index position of the board snapshot that is nearest to
+/// the index position @a index, without exceeding it. Returns -1 if no such
+/// board snapshot exists.
+// -----------------------------------------------------------------------------
+- (int) indexOfBoardSnapshotNearestToIndex:(int)index
+{
+  if (_boardSnapshots.count == 0 || _boardSnapshotInterval <= 0)
+    return -1;
+
+  // Snapshots are stored only at multiples of the interval, so we can probe
+  // the candidate index positions downwards instead of iterating over all
+  // snapshots
+  for (int indexOfSnapshot = index - (index % _boardSnapshotInterval);
+       indexOfSnapshot > 0;
+       indexOfSnapshot -= _boardSnapshotInterval)
+  {
+    if ([_boardSnapshots objectForKey:[NSNumber numberWithInt:indexOfSnapshot]])
+      return indexOfSnapshot;
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the board snapshot for the node at index position @a index
+/// in the current variation. Returns @e nil if no snapshot exists for that
+/// index position.
+// -----------------------------------------------------------------------------
+- (NSData*) boardSnapshotAtIndex:(int)index
+{
+  return [_boardSnapshots objectForKey:[NSNumber numberWithInt:index]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards all board snapshots whose index position is equal to or
+/// greater than @a index. Invoking this method with @a index 0 discards all
+/// board snapshots.
+// -----------------------------------------------------------------------------
+- (void) discardBoardSnapshotsFromIndex:(int)index
+{
+  if (_boardSnapshots.count == 0)
+    return;
+
+  if (index <= 0)
+  {
+    [_boardSnapshots removeAllObjects];
+    return;
+  }
+
+  NSMutableArray* keysToDiscard = [NSMutableArray array];
+  for (NSNumber* key in _boardSnapshots)
+  {
+    if (key.intValue >= index)
+      [keysToDiscard addObject:key];
+  }
+  [_boardSnapshots removeObjectsForKeys:keysToDiscard];
+}
+
+#pragma mark - Properties
+
+// -----------------------------------------------------------------------------
+// Property is documented in header file
+// -----------------------------------------------------------------------------
+- (void) setBoardSnapshotInterval:(int)boardSnapshotInterval
+{
+  if (_boardSnapshotInterval == boardSnapshotInterval)
+    return;
+  _boardSnapshotInterval = boardSnapshotInterval;
+  [self discardBoardSnapshotsFromIndex:0];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in header file
+// -----------------------------------------------------------------------------
+- (void) setMaximumNumberOfBoardSnapshots:(int)maximumNumberOfBoardSnapshots
+{
+  if (_maximumNumberOfBoardSnapshots == maximumNumberOfBoardSnapshots)
+    return;
+  _maximumNumberOfBoardSnapshots = maximumNumberOfBoardSnapshots;
+  [self discardBoardSnapshotsFromIndex:0];
+}
+
 // -----------------------------------------------------------------------------
 // Property is documented in header file
 // -----------------------------------------------------------------------------
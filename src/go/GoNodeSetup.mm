@@ -18,6 +18,7 @@
 // Project includes
 #import "GoNodeSetup.h"
 #import "GoBoard.h"
+#import "GoBoardCore.h"
 #import "GoGame.h"
 #import "GoPoint.h"
 #import "GoVertex.h"
@@ -29,6 +30,22 @@
 /// @brief Class extension with private properties for GoNodeSetup.
 // -----------------------------------------------------------------------------
 @interface GoNodeSetup()
+{
+@private
+  /// @name Point sets
+  ///
+  /// @brief The point sets mirror the content of the arrays with the same name.
+  /// They make it possible to answer the question whether an intersection is
+  /// listed in one of the arrays with a single bit test, instead of having to
+  /// search the array. Bits are indexed with GoBoard::indexOfPoint:().
+  //@{
+  GoBoardCore::PointSet _blackSetupStonesSet;
+  GoBoardCore::PointSet _whiteSetupStonesSet;
+  GoBoardCore::PointSet _noSetupStonesSet;
+  GoBoardCore::PointSet _previousBlackSetupStonesSet;
+  GoBoardCore::PointSet _previousWhiteSetupStonesSet;
+  //@}
+}
 /// @name Re-declaration of properties to make them readwrite privately
 //@{
 @property(nonatomic, assign, readwrite) enum GoColor previousSetupFirstMoveColor;
@@ -278,21 +295,27 @@
   }
 
   NSMutableArray* mutableBlackSetupStones = self.mutableBlackSetupStones;
+  int pointIndex = [self indexOfPoint:point];
 
-  if (mutableBlackSetupStones && [mutableBlackSetupStones containsObject:point])
+  if (_blackSetupStonesSet.test(pointIndex))
     return;
-  else if (_mutableWhiteSetupStones && [_mutableWhiteSetupStones containsObject:point])
+  else if (_whiteSetupStonesSet.test(pointIndex))
     [self removeWhiteSetupStone:point];
-  else if (_mutableNoSetupStones && [_mutableNoSetupStones containsObject:point])
+  else if (_noSetupStonesSet.test(pointIndex))
     [self removeNoSetupStone:point];
 
-  if (_mutablePreviousBlackSetupStones && [_mutablePreviousBlackSetupStones containsObject:point])
+  if (_previousBlackSetupStonesSet.test(pointIndex))
     return;
 
   if (mutableBlackSetupStones)
+  {
     [mutableBlackSetupStones addObject:point];
+    _blackSetupStonesSet.set(pointIndex);
+  }
   else
+  {
     self.mutableBlackSetupStones = [NSMutableArray arrayWithObject:point];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -309,21 +332,27 @@
   }
 
   NSMutableArray* mutableWhiteSetupStones = self.mutableWhiteSetupStones;
+  int pointIndex = [self indexOfPoint:point];
 
-  if (_mutableBlackSetupStones && [_mutableBlackSetupStones containsObject:point])
+  if (_blackSetupStonesSet.test(pointIndex))
     [self removeBlackSetupStone:point];
-  else if (mutableWhiteSetupStones && [mutableWhiteSetupStones containsObject:point])
+  else if (_whiteSetupStonesSet.test(pointIndex))
     return;
-  else if (_mutableNoSetupStones && [_mutableNoSetupStones containsObject:point])
+  else if (_noSetupStonesSet.test(pointIndex))
     [self removeNoSetupStone:point];
 
-  if (_mutablePreviousWhiteSetupStones && [_mutablePreviousWhiteSetupStones containsObject:point])
+  if (_previousWhiteSetupStonesSet.test(pointIndex))
     return;
 
   if (mutableWhiteSetupStones)
+  {
     [mutableWhiteSetupStones addObject:point];
+    _whiteSetupStonesSet.set(pointIndex);
+  }
   else
+  {
     self.mutableWhiteSetupStones = [NSMutableArray arrayWithObject:point];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -340,21 +369,27 @@
   }
 
   NSMutableArray* mutableNoSetupStones = self.mutableNoSetupStones;
+  int pointIndex = [self indexOfPoint:point];
 
-  if (_mutableBlackSetupStones && [_mutableBlackSetupStones containsObject:point])
+  if (_blackSetupStonesSet.test(pointIndex))
     [self removeBlackSetupStone:point];
-  else if (_mutableWhiteSetupStones && [_mutableWhiteSetupStones containsObject:point])
+  else if (_whiteSetupStonesSet.test(pointIndex))
     [self removeWhiteSetupStone:point];
-  else if (mutableNoSetupStones && [mutableNoSetupStones containsObject:point])
+  else if (_noSetupStonesSet.test(pointIndex))
     return;
 
-  if ((_mutablePreviousBlackSetupStones && [_mutablePreviousBlackSetupStones containsObject:point]) ||
-      (_mutablePreviousWhiteSetupStones && [_mutablePreviousWhiteSetupStones containsObject:point]))
+  if (_previousBlackSetupStonesSet.test(pointIndex) ||
+      _previousWhiteSetupStonesSet.test(pointIndex))
   {
     if (mutableNoSetupStones)
+    {
       [mutableNoSetupStones addObject:point];
+      _noSetupStonesSet.set(pointIndex);
+    }
     else
+    {
       self.mutableNoSetupStones = [NSMutableArray arrayWithObject:point];
+    }
   }
 }
 
@@ -411,12 +446,14 @@
 // -----------------------------------------------------------------------------
 - (enum GoColor) stoneStateAfterSetup:(GoPoint*)point
 {
+  int pointIndex = [self indexOfPoint:point];
+
   // First check if the stone state is explicitly set in this GoNodeSetup
-  if (_mutableBlackSetupStones && [_mutableBlackSetupStones containsObject:point])
+  if (_blackSetupStonesSet.test(pointIndex))
     return GoColorBlack;
-  else if (_mutableWhiteSetupStones && [_mutableWhiteSetupStones containsObject:point])
+  else if (_whiteSetupStonesSet.test(pointIndex))
     return GoColorWhite;
-  else if (_mutableNoSetupStones && [_mutableNoSetupStones containsObject:point])
+  else if (_noSetupStonesSet.test(pointIndex))
     return GoColorNone;
 
   // Only now that we know that the stone state is not explicitly set in this
@@ -431,9 +468,11 @@
 // -----------------------------------------------------------------------------
 - (enum GoColor) stoneStatePreviousToSetup:(GoPoint*)point
 {
-  if (_mutablePreviousBlackSetupStones && [_mutablePreviousBlackSetupStones containsObject:point])
+  int pointIndex = [self indexOfPoint:point];
+
+  if (_previousBlackSetupStonesSet.test(pointIndex))
     return GoColorBlack;
-  else if (_mutablePreviousWhiteSetupStones && [_mutablePreviousWhiteSetupStones containsObject:point])
+  else if (_previousWhiteSetupStonesSet.test(pointIndex))
     return GoColorWhite;
   else
     return GoColorNone;
@@ -493,8 +532,78 @@
   return self.mutablePreviousWhiteSetupStones;
 }
 
+#pragma mark - Private setters
+
+// -----------------------------------------------------------------------------
+// Private setter implementation. Keeps the point set in sync with the array.
+// -----------------------------------------------------------------------------
+- (void) setMutableBlackSetupStones:(NSMutableArray*)mutableBlackSetupStones
+{
+  [self replaceArray:&_mutableBlackSetupStones withArray:mutableBlackSetupStones pointSet:_blackSetupStonesSet];
+}
+
+// -----------------------------------------------------------------------------
+// Private setter implementation. Keeps the point set in sync with the array.
+// -----------------------------------------------------------------------------
+- (void) setMutableWhiteSetupStones:(NSMutableArray*)mutableWhiteSetupStones
+{
+  [self replaceArray:&_mutableWhiteSetupStones withArray:mutableWhiteSetupStones pointSet:_whiteSetupStonesSet];
+}
+
+// -----------------------------------------------------------------------------
+// Private setter implementation. Keeps the point set in sync with the array.
+// -----------------------------------------------------------------------------
+- (void) setMutableNoSetupStones:(NSMutableArray*)mutableNoSetupStones
+{
+  [self replaceArray:&_mutableNoSetupStones withArray:mutableNoSetupStones pointSet:_noSetupStonesSet];
+}
+
+// -----------------------------------------------------------------------------
+// Private setter implementation. Keeps the point set in sync with the array.
+// -----------------------------------------------------------------------------
+- (void) setMutablePreviousBlackSetupStones:(NSMutableArray*)mutablePreviousBlackSetupStones
+{
+  [self replaceArray:&_mutablePreviousBlackSetupStones withArray:mutablePreviousBlackSetupStones pointSet:_previousBlackSetupStonesSet];
+}
+
+// -----------------------------------------------------------------------------
+// Private setter implementation. Keeps the point set in sync with the array.
+// -----------------------------------------------------------------------------
+- (void) setMutablePreviousWhiteSetupStones:(NSMutableArray*)mutablePreviousWhiteSetupStones
+{
+  [self replaceArray:&_mutablePreviousWhiteSetupStones withArray:mutablePreviousWhiteSetupStones pointSet:_previousWhiteSetupStonesSet];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the setters of the properties that store
+/// GoPoint arrays. Replaces the array pointed to by @a array with
+/// @a newArray, using the retain/release semantics of a @e retain property,
+/// and rebuilds @a pointSet so that it contains the points in @a newArray.
+// -----------------------------------------------------------------------------
+- (void) replaceArray:(NSMutableArray**)array withArray:(NSMutableArray*)newArray pointSet:(GoBoardCore::PointSet&)pointSet
+{
+  if (*array != newArray)
+  {
+    [newArray retain];
+    [*array release];
+    *array = newArray;
+  }
+
+  pointSet.reset();
+  for (GoPoint* point in newArray)
+    pointSet.set([self indexOfPoint:point]);
+}
+
 #pragma mark - Private helpers
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of @a point in the point sets.
+// -----------------------------------------------------------------------------
+- (int) indexOfPoint:(GoPoint*)point
+{
+  return [point.board indexOfPoint:point];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Removes @a point from the list of black setup stones in property
 /// @e blackSetupStones. Deallocates the array if it is empty after the removal.
@@ -506,6 +615,7 @@
     return;
 
   [mutableBlackSetupStones removeObject:point];
+  _blackSetupStonesSet.reset([self indexOfPoint:point]);
   if (mutableBlackSetupStones.count == 0)
     self.mutableBlackSetupStones = nil;
 }
@@ -521,6 +631,7 @@
     return;
 
   [mutableWhiteSetupStones removeObject:point];
+  _whiteSetupStonesSet.reset([self indexOfPoint:point]);
   if (mutableWhiteSetupStones.count == 0)
     self.mutableWhiteSetupStones = nil;
 }
@@ -536,6 +647,7 @@
     return;
 
   [mutableNoSetupStones removeObject:point];
+  _noSetupStonesSet.reset([self indexOfPoint:point]);
   if (mutableNoSetupStones.count == 0)
     self.mutableNoSetupStones = nil;
 }
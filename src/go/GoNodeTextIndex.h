@@ -0,0 +1,64 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoNode;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoNodeTextIndex class maintains an inverted full-text index over
+/// the texts of the nodes of a game tree, so that clients can search those
+/// texts without walking the entire game tree.
+///
+/// @ingroup go
+///
+/// The text of a node consists of the short and long descriptions of the
+/// node's GoNodeAnnotation, and of the label texts of the node's GoNodeMarkup.
+/// Number and letter markers are not indexed. The text is split into words,
+/// and the words are folded to lowercase without diacritics. The index maps
+/// each word to the set of nodes whose text contains the word.
+///
+/// buildIndex() takes a snapshot of the node texts in the context of the
+/// calling thread, which is cheap, then splits the texts into words and builds
+/// the index on a private serial queue. updateNode:() must be invoked whenever
+/// the text of a node changes, it updates the index incrementally on the same
+/// queue. Because the queue is serial, an update that is requested after a
+/// build request is always applied after the build has finished.
+///
+/// A search query is split into words in the same way as the node texts. A
+/// node matches if its text contains, for each query word, a word that begins
+/// with the query word. The last word of a query that is still being typed
+/// therefore already finds matches. Prefix lookups use binary search on a
+/// sorted list of all indexed words.
+///
+/// If no search has been requested and buildIndex() has not been invoked yet,
+/// updateNode:() does nothing. The first search builds the index if necessary.
+///
+/// Nodes that are discarded from the game tree remain in the index, but they
+/// are filtered out of search results.
+// -----------------------------------------------------------------------------
+@interface GoNodeTextIndex : NSObject
+{
+}
+
+- (id) initWithRootNode:(GoNode*)rootNode;
+- (void) buildIndex;
+- (void) updateNode:(GoNode*)node;
+- (void) searchForText:(NSString*)searchText completionHandler:(void (^)(NSArray* nodes))completionHandler;
+- (NSArray*) nodesMatchingText:(NSString*)searchText;
+
+@end
@@ -0,0 +1,451 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "GoNodeTextIndex.h"
+#import "GoNode.h"
+#import "GoNodeAnnotation.h"
+#import "GoNodeMarkup.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoNodeTextIndex.
+// -----------------------------------------------------------------------------
+@interface GoNodeTextIndex()
+/// @name Privately declared properties
+//@{
+/// @brief The root node of the game tree whose nodes are indexed. Search
+/// results are restricted to nodes that are still attached to this node.
+@property(nonatomic, retain) GoNode* rootNode;
+/// @brief True if buildIndex() has been invoked.
+@property(nonatomic, assign) bool indexRequested;
+/// @brief Is incremented every time that
+/// searchForText:completionHandler:() is invoked. Must be accessed only on the
+/// main thread.
+@property(nonatomic, assign) unsigned long long searchGeneration;
+/// @brief The serial queue on which the index is built, updated and searched.
+/// All of the properties below @e indexQueue must be accessed only on this
+/// queue.
+@property(nonatomic, retain) dispatch_queue_t indexQueue;
+/// @brief The indexed nodes. The position of a node in this array is the
+/// node's number in @e nodeNumbers and @e postings.
+@property(nonatomic, retain) NSMutableArray* nodes;
+/// @brief Maps GoNode objects (compared by identity) to NSNumber objects with
+/// the node's position in @e nodes.
+@property(nonatomic, retain) NSMapTable* nodeNumbers;
+/// @brief The words that are currently indexed for each node in @e nodes.
+/// Element n is an NSSet with the words of the node at position n in
+/// @e nodes.
+@property(nonatomic, retain) NSMutableArray* wordsOfNodes;
+/// @brief The inverted index. Key = indexed word, value = NSMutableIndexSet
+/// with the numbers of the nodes whose text contains the word.
+@property(nonatomic, retain) NSMutableDictionary* postings;
+/// @brief The keys of @e postings, sorted so that prefix lookups can use
+/// binary search. Is nil if the list must be sorted again because words were
+/// added or removed.
+@property(nonatomic, retain) NSArray* sortedWords;
+//@}
+@end
+
+
+@implementation GoNodeTextIndex
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoNodeTextIndex object that indexes the nodes in the
+/// game tree that starts with @a rootNode. The index is empty until
+/// buildIndex() is invoked.
+///
+/// @note This is the designated initializer of GoNodeTextIndex.
+// -----------------------------------------------------------------------------
+- (id) initWithRootNode:(GoNode*)rootNode
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.rootNode = rootNode;
+  dispatch_queue_attr_t queueAttributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+  dispatch_queue_t indexQueue = dispatch_queue_create("ch.herzbube.littlego.nodetextindex", queueAttributes);
+  self.indexQueue = indexQueue;
+  dispatch_release(indexQueue);
+  self.indexRequested = false;
+  self.searchGeneration = 0;
+  self.nodes = [NSMutableArray arrayWithCapacity:0];
+  self.nodeNumbers = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality
+                                           valueOptions:NSPointerFunctionsStrongMemory];
+  self.wordsOfNodes = [NSMutableArray arrayWithCapacity:0];
+  self.postings = [NSMutableDictionary dictionaryWithCapacity:0];
+  self.sortedWords = nil;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoNodeTextIndex object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.rootNode = nil;
+  self.indexQueue = nil;
+  self.nodes = nil;
+  self.nodeNumbers = nil;
+  self.wordsOfNodes = nil;
+  self.postings = nil;
+  self.sortedWords = nil;
+
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the current content of the index and builds the index anew
+/// from the texts of all nodes in the game tree. Returns immediately, the
+/// index is built in the background.
+///
+/// The node texts are collected in the context of the calling thread. The
+/// game tree must not be modified concurrently.
+// -----------------------------------------------------------------------------
+- (void) buildIndex
+{
+  self.indexRequested = true;
+
+  NSMutableArray* nodesWithText = [NSMutableArray arrayWithCapacity:0];
+  NSMutableArray* texts = [NSMutableArray arrayWithCapacity:0];
+  [self.rootNode enumerateSubtreeInPreorderUsingBlock:^(GoNode* node, bool* stop)
+  {
+    NSString* text = [GoNodeTextIndex textOfNode:node];
+    if (text)
+    {
+      [nodesWithText addObject:node];
+      [texts addObject:text];
+    }
+  }];
+
+  dispatch_async(self.indexQueue, ^{
+    [self.nodes removeAllObjects];
+    [self.nodeNumbers removeAllObjects];
+    [self.wordsOfNodes removeAllObjects];
+    [self.postings removeAllObjects];
+    self.sortedWords = nil;
+
+    NSUInteger numberOfNodes = nodesWithText.count;
+    for (NSUInteger indexOfNode = 0; indexOfNode < numberOfNodes; ++indexOfNode)
+    {
+      @autoreleasepool
+      {
+        NSSet* words = [GoNodeTextIndex wordsInText:[texts objectAtIndex:indexOfNode]];
+        [self indexWords:words ofNode:[nodesWithText objectAtIndex:indexOfNode]];
+      }
+    }
+  });
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the index with the current text of @a node. Returns
+/// immediately, the index is updated in the background.
+///
+/// Must be invoked after the descriptions in the node's GoNodeAnnotation or
+/// the labels in the node's GoNodeMarkup have changed, or after the node's
+/// GoNodeAnnotation or GoNodeMarkup has been replaced.
+///
+/// Does nothing if the index has not been built yet.
+// -----------------------------------------------------------------------------
+- (void) updateNode:(GoNode*)node
+{
+  if (! self.indexRequested)
+    return;
+
+  NSString* text = [GoNodeTextIndex textOfNode:node];
+  dispatch_async(self.indexQueue, ^{
+    NSSet* words = [GoNodeTextIndex wordsInText:text];
+    [self indexWords:words ofNode:node];
+  });
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Searches the index for nodes whose text matches @a searchText, then
+/// invokes @a completionHandler on the main thread with an NSArray of GoNode
+/// objects. The NSArray is empty if no nodes match.
+///
+/// This method must be invoked on the main thread. It returns immediately,
+/// the search takes place in the background. If this method is invoked again
+/// before the search has finished, @a completionHandler of the earlier search
+/// is not invoked, so that clients that search as the user types receive only
+/// the results for the most recent text.
+///
+/// The nodes are ordered in game tree preorder, except that nodes which
+/// received their first text after the index was built are at the end.
+// -----------------------------------------------------------------------------
+- (void) searchForText:(NSString*)searchText completionHandler:(void (^)(NSArray* nodes))completionHandler
+{
+  if (! self.indexRequested)
+    [self buildIndex];
+
+  unsigned long long searchGeneration = ++self.searchGeneration;
+  NSArray* searchWords = [GoNodeTextIndex orderedWordsInText:searchText];
+  void (^completionHandlerCopy)(NSArray* nodes) = [[completionHandler copy] autorelease];
+
+  dispatch_async(self.indexQueue, ^{
+    NSArray* matchingNodes = [self nodesMatchingWords:searchWords];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      if (searchGeneration != self.searchGeneration)
+        return;
+      completionHandlerCopy([self nodesAttachedToGameTree:matchingNodes]);
+    });
+  });
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Searches the index for nodes whose text matches @a searchText and
+/// returns an NSArray of GoNode objects. The NSArray is empty if no nodes
+/// match.
+///
+/// Unlike searchForText:completionHandler:() this method blocks until all
+/// pending build and update work has finished and the search is complete.
+// -----------------------------------------------------------------------------
+- (NSArray*) nodesMatchingText:(NSString*)searchText
+{
+  if (! self.indexRequested)
+    [self buildIndex];
+
+  NSArray* searchWords = [GoNodeTextIndex orderedWordsInText:searchText];
+
+  __block NSArray* matchingNodes = nil;
+  dispatch_sync(self.indexQueue, ^{
+    matchingNodes = [[self nodesMatchingWords:searchWords] retain];
+  });
+  [matchingNodes autorelease];
+
+  return [self nodesAttachedToGameTree:matchingNodes];
+}
+
+#pragma mark - Private helpers - Index queue
+
+// -----------------------------------------------------------------------------
+/// @brief Replaces the words currently indexed for @a node with @a words.
+/// Must be invoked on @e indexQueue.
+// -----------------------------------------------------------------------------
+- (void) indexWords:(NSSet*)words ofNode:(GoNode*)node
+{
+  NSNumber* nodeNumberObject = [self.nodeNumbers objectForKey:node];
+  NSSet* oldWords;
+  NSUInteger nodeNumber;
+  if (nodeNumberObject)
+  {
+    nodeNumber = nodeNumberObject.unsignedIntegerValue;
+    oldWords = [self.wordsOfNodes objectAtIndex:nodeNumber];
+  }
+  else
+  {
+    if (words.count == 0)
+      return;
+    nodeNumber = self.nodes.count;
+    oldWords = [NSSet set];
+    [self.nodes addObject:node];
+    [self.wordsOfNodes addObject:oldWords];
+    [self.nodeNumbers setObject:[NSNumber numberWithUnsignedInteger:nodeNumber] forKey:node];
+  }
+
+  for (NSString* oldWord in oldWords)
+  {
+    if ([words containsObject:oldWord])
+      continue;
+    NSMutableIndexSet* nodeNumbersOfWord = [self.postings objectForKey:oldWord];
+    [nodeNumbersOfWord removeIndex:nodeNumber];
+    if (nodeNumbersOfWord.count == 0)
+    {
+      [self.postings removeObjectForKey:oldWord];
+      self.sortedWords = nil;
+    }
+  }
+
+  for (NSString* word in words)
+  {
+    if ([oldWords containsObject:word])
+      continue;
+    NSMutableIndexSet* nodeNumbersOfWord = [self.postings objectForKey:word];
+    if (! nodeNumbersOfWord)
+    {
+      nodeNumbersOfWord = [NSMutableIndexSet indexSet];
+      [self.postings setObject:nodeNumbersOfWord forKey:word];
+      self.sortedWords = nil;
+    }
+    [nodeNumbersOfWord addIndex:nodeNumber];
+  }
+
+  [self.wordsOfNodes replaceObjectAtIndex:nodeNumber withObject:words];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an NSArray with the indexed nodes whose text contains, for
+/// each of the words in @a searchWords, a word that begins with that word.
+/// Must be invoked on @e indexQueue.
+// -----------------------------------------------------------------------------
+- (NSArray*) nodesMatchingWords:(NSArray*)searchWords
+{
+  NSMutableArray* matchingNodes = [NSMutableArray arrayWithCapacity:0];
+  if (searchWords.count == 0)
+    return matchingNodes;
+
+  NSMutableIndexSet* matchingNodeNumbers = nil;
+  for (NSString* searchWord in searchWords)
+  {
+    NSMutableIndexSet* nodeNumbersOfSearchWord = [NSMutableIndexSet indexSet];
+    for (NSString* word in [self indexedWordsWithPrefix:searchWord])
+      [nodeNumbersOfSearchWord addIndexes:[self.postings objectForKey:word]];
+
+    if (! matchingNodeNumbers)
+    {
+      matchingNodeNumbers = nodeNumbersOfSearchWord;
+    }
+    else
+    {
+      NSIndexSet* nodeNumbersToRemove = [matchingNodeNumbers indexesPassingTest:^BOOL(NSUInteger nodeNumber, BOOL* stop)
+      {
+        return ! [nodeNumbersOfSearchWord containsIndex:nodeNumber];
+      }];
+      [matchingNodeNumbers removeIndexes:nodeNumbersToRemove];
+    }
+
+    if (matchingNodeNumbers.count == 0)
+      break;
+  }
+
+  [matchingNodeNumbers enumerateIndexesUsingBlock:^(NSUInteger nodeNumber, BOOL* stop)
+  {
+    [matchingNodes addObject:[self.nodes objectAtIndex:nodeNumber]];
+  }];
+
+  return matchingNodes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an NSArray with the indexed words that begin with
+/// @a prefix. Must be invoked on @e indexQueue.
+// -----------------------------------------------------------------------------
+- (NSArray*) indexedWordsWithPrefix:(NSString*)prefix
+{
+  NSComparator literalComparator = ^NSComparisonResult(NSString* word1, NSString* word2)
+  {
+    return [word1 compare:word2 options:NSLiteralSearch];
+  };
+
+  if (! self.sortedWords)
+    self.sortedWords = [self.postings.allKeys sortedArrayUsingComparator:literalComparator];
+
+  NSArray* sortedWords = self.sortedWords;
+  NSUInteger numberOfWords = sortedWords.count;
+  NSUInteger indexOfFirstCandidate = [sortedWords indexOfObject:prefix
+                                                  inSortedRange:NSMakeRange(0, numberOfWords)
+                                                        options:NSBinarySearchingFirstEqual | NSBinarySearchingInsertionIndex
+                                                usingComparator:literalComparator];
+
+  NSMutableArray* wordsWithPrefix = [NSMutableArray arrayWithCapacity:0];
+  for (NSUInteger indexOfWord = indexOfFirstCandidate; indexOfWord < numberOfWords; ++indexOfWord)
+  {
+    NSString* word = [sortedWords objectAtIndex:indexOfWord];
+    if (! [word hasPrefix:prefix])
+      break;
+    [wordsWithPrefix addObject:word];
+  }
+
+  return wordsWithPrefix;
+}
+
+#pragma mark - Private helpers - Any thread
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the subset of @a nodes that are still attached to the game
+/// tree, in the same order.
+// -----------------------------------------------------------------------------
+- (NSArray*) nodesAttachedToGameTree:(NSArray*)nodes
+{
+  NSMutableArray* attachedNodes = [NSMutableArray arrayWithCapacity:nodes.count];
+  GoNode* rootNode = self.rootNode;
+  for (GoNode* node in nodes)
+  {
+    if (node == rootNode || [node isDescendantOfNode:rootNode])
+      [attachedNodes addObject:node];
+  }
+  return attachedNodes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the text of @a node that is indexed, or nil if @a node has
+/// no such text.
+// -----------------------------------------------------------------------------
++ (NSString*) textOfNode:(GoNode*)node
+{
+  NSMutableArray* textParts = [NSMutableArray arrayWithCapacity:0];
+
+  GoNodeAnnotation* nodeAnnotation = node.goNodeAnnotation;
+  if (nodeAnnotation.shortDescription)
+    [textParts addObject:nodeAnnotation.shortDescription];
+  if (nodeAnnotation.longDescription)
+    [textParts addObject:nodeAnnotation.longDescription];
+
+  GoNodeMarkup* nodeMarkup = node.goNodeMarkup;
+  if (nodeMarkup.hasLabels)
+  {
+    [nodeMarkup enumerateLabelsUsingBlock:^(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop)
+    {
+      if (labelType == GoMarkupLabelLabel)
+        [textParts addObject:labelText];
+    }];
+  }
+
+  if (textParts.count == 0)
+    return nil;
+  return [textParts componentsJoinedByString:@"\n"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an NSSet with the distinct words in @a text. See the class
+/// documentation for details. Returns an empty set if @a text is nil.
+// -----------------------------------------------------------------------------
++ (NSSet*) wordsInText:(NSString*)text
+{
+  return [NSSet setWithArray:[GoNodeTextIndex orderedWordsInText:text]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an NSArray with the words in @a text, in the order in which
+/// they appear in @a text. The words are folded to lowercase without
+/// diacritics. Returns an empty array if @a text is nil.
+// -----------------------------------------------------------------------------
++ (NSArray*) orderedWordsInText:(NSString*)text
+{
+  NSMutableArray* words = [NSMutableArray arrayWithCapacity:0];
+  if (! text)
+    return words;
+
+  NSString* foldedText = [text stringByFoldingWithOptions:NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch
+                                                   locale:nil];
+  [foldedText enumerateSubstringsInRange:NSMakeRange(0, foldedText.length)
+                                 options:NSStringEnumerationByWords
+                              usingBlock:^(NSString* word, NSRange wordRange, NSRange enclosingRange, BOOL* stop)
+  {
+    [words addObject:word];
+  }];
+
+  return words;
+}
+
+@end
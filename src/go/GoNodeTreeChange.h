@@ -0,0 +1,54 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoNode;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoNodeTreeChange class describes a single structural change to
+/// the game tree, i.e. the insertion or removal of a sub tree.
+///
+/// @ingroup go
+///
+/// GoNodeModel records a GoNodeTreeChange object for every structural change
+/// it makes to the game tree. The objects are collected in a journal until the
+/// next #goNodeTreeLayoutDidChange notification is posted, which carries the
+/// journal so that observers can update their models incrementally instead of
+/// rebuilding them from scratch.
+///
+/// A GoNodeTreeChange object retains the node at the top of the inserted or
+/// removed sub tree, so that observers can still examine a removed sub tree
+/// while they process the notification. The parent node is not retained.
+// -----------------------------------------------------------------------------
+@interface GoNodeTreeChange : NSObject
+{
+}
+
++ (GoNodeTreeChange*) treeChangeWithType:(enum GoNodeTreeChangeType)changeType
+                                    node:(GoNode*)node
+                                  parent:(GoNode*)parent;
+
+/// @brief The type of the change.
+@property(nonatomic, assign, readonly) enum GoNodeTreeChangeType changeType;
+/// @brief The node at the top of the sub tree that was inserted or removed.
+@property(nonatomic, retain, readonly) GoNode* node;
+/// @brief The node that is the parent of @e node after the sub tree was
+/// inserted, or that was the parent of @e node before the sub tree was removed.
+@property(nonatomic, assign, readonly) GoNode* parent;
+
+@end
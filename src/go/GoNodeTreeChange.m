@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoNodeTreeChange.h"
+#import "GoNode.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoNodeTreeChange.
+// -----------------------------------------------------------------------------
+@interface GoNodeTreeChange()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) enum GoNodeTreeChangeType changeType;
+@property(nonatomic, retain, readwrite) GoNode* node;
+@property(nonatomic, assign, readwrite) GoNode* parent;
+//@}
+@end
+
+
+@implementation GoNodeTreeChange
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GoNodeTreeChange instance that
+/// describes a change of type @a changeType to the sub tree dangling from
+/// @a node, whose parent is @a parent.
+// -----------------------------------------------------------------------------
++ (GoNodeTreeChange*) treeChangeWithType:(enum GoNodeTreeChangeType)changeType
+                                    node:(GoNode*)node
+                                  parent:(GoNode*)parent
+{
+  GoNodeTreeChange* treeChange = [[GoNodeTreeChange alloc] init];
+  if (treeChange)
+  {
+    treeChange.changeType = changeType;
+    treeChange.node = node;
+    treeChange.parent = parent;
+
+    [treeChange autorelease];
+  }
+
+  return treeChange;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoNodeTreeChange object of type
+/// #GoNodeTreeChangeTypeInsert that refers to no nodes.
+///
+/// @note This is the designated initializer of GoNodeTreeChange.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.changeType = GoNodeTreeChangeTypeInsert;
+  self.node = nil;
+  self.parent = nil;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoNodeTreeChange object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.node = nil;
+  self.parent = nil;
+
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a description for this GoNodeTreeChange object.
+///
+/// This method is invoked when GoNodeTreeChange needs to be represented as a
+/// string, i.e. by NSLog, or when the debugger command "po" is used on the
+/// object.
+// -----------------------------------------------------------------------------
+- (NSString*) description
+{
+  // Don't use self to access properties to avoid unnecessary overhead during
+  // debugging
+  return [NSString stringWithFormat:@"GoNodeTreeChange(%p): changeType = %d, node = %p, parent = %p", self, _changeType, _node, _parent];
+}
+
+@end
@@ -0,0 +1,77 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+@class GoPoint;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoOpeningBook class looks up the move that the opening book
+/// recommends for the current board position of a game, without involving
+/// the GTP engine.
+///
+/// @ingroup go
+///
+/// The opening book is the same file that the GTP engine loads with the
+/// "book_load" command (see LoadOpeningBookCommand). Each line of the file
+/// consists of the board size, a sequence of moves played alternately by
+/// black and white on an empty board, a separator "|", and one or more
+/// replies to the sequence.
+///
+/// loadBookFileAtPath:() memory-maps the file, replays each sequence on a
+/// GoBoardCore object and indexes the replies by the canonical Zobrist hash of
+/// the resulting board position (see GoBoard::canonicalZobristHashWithSymmetry:()).
+/// Like the GTP engine, moveForGame:() therefore finds a book position in all
+/// rotations and reflections of the board, and picks one of several replies
+/// at random. Because the canonical Zobrist hash describes only the stones on
+/// the board, the index also remembers which side is to move in each book
+/// position.
+///
+/// The result of parsing the file is a compiled index, i.e. a table of board
+/// positions sorted by board size and canonical Zobrist hash, in which
+/// moveForGame:() looks up a board position with a binary search.
+///
+/// Zobrist hashes are the same after every app launch because GoZobristTable
+/// generates its random numbers from a fixed seed. The compiled index can
+/// therefore be written to a file and reused, which is what
+/// loadBookFileAtPath:indexFilePath:() does: If the file contains an index that
+/// was compiled from the same opening book file, the index is memory-mapped
+/// and the opening book file is not parsed again.
+///
+/// Both loading methods can be invoked on any thread, usually on a
+/// background queue because parsing the file takes a moment. moveForGame:()
+/// must be invoked on the main thread. It returns nil until the book has been
+/// loaded.
+// -----------------------------------------------------------------------------
+@interface GoOpeningBook : NSObject
+{
+}
+
++ (GoOpeningBook*) sharedOpeningBook;
+
+- (id) init;
+- (bool) loadBookFileAtPath:(NSString*)path;
+- (bool) loadBookFileAtPath:(NSString*)path indexFilePath:(NSString*)indexFilePath;
+- (GoPoint*) moveForGame:(GoGame*)game;
+
+/// @brief The number of distinct board positions in the opening book, counting
+/// all rotations and reflections of a board position only once. Is 0 if the
+/// book has not been loaded yet.
+@property(nonatomic, assign, readonly) int numberOfPositions;
+
+@end
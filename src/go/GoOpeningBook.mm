@@ -0,0 +1,511 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "GoOpeningBook.h"
+#import "GoBoard.h"
+#import "GoBoardCore.h"
+#import "GoBoardTopology.h"
+#import "GoGame.h"
+#import "GoPoint.h"
+#import "GoZobristTable.h"
+
+// C++ standard library
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/// @brief A board position of the opening book, while the opening book file
+/// is being parsed.
+struct GoOpeningBookEntry
+{
+  /// @brief The side to move in the board position.
+  enum GoColor nextMoveColor;
+  /// @brief The indexes of the replies, in the orientation of the canonical
+  /// board position.
+  std::vector<int> replyIndexes;
+};
+
+/// @brief Key = Canonical Zobrist hash of a board position.
+typedef std::unordered_map<long long, GoOpeningBookEntry> GoOpeningBookPositions;
+/// @brief Key = Board size.
+typedef std::unordered_map<int, GoOpeningBookPositions> GoOpeningBookIndex;
+
+/// @brief The header of a compiled opening book index. The header is followed
+/// by @e numberOfEntries GoOpeningBookCompiledEntry structs, sorted by board
+/// size and canonical Zobrist hash, which in turn are followed by
+/// @e numberOfReplyIndexes int32_t reply indexes.
+struct GoOpeningBookCompiledHeader
+{
+  uint32_t magic;
+  uint32_t formatVersion;
+  /// @brief The size of the opening book file from which the index was
+  /// compiled.
+  uint64_t bookFileSize;
+  /// @brief The modification date of the opening book file from which the
+  /// index was compiled, as a time interval since the reference date.
+  double bookFileModificationTime;
+  uint32_t numberOfEntries;
+  uint32_t numberOfReplyIndexes;
+};
+
+/// @brief A board position in a compiled opening book index.
+struct GoOpeningBookCompiledEntry
+{
+  int64_t canonicalZobristHash;
+  int32_t boardSize;
+  int32_t nextMoveColor;
+  /// @brief The index of the first reply in the reply indexes that follow the
+  /// entries.
+  uint32_t indexOfFirstReply;
+  uint32_t numberOfReplies;
+};
+
+static const uint32_t compiledIndexMagic = 0x4C47424B;  // "LGBK"
+/// @brief Must be incremented whenever the layout of the compiled index
+/// changes, or whenever the canonical Zobrist hash of a board position or the
+/// canonical orientation of a reply change (e.g. when GoZobristTable or the
+/// board symmetries in GoBoardTopology change).
+static const uint32_t compiledIndexFormatVersion = 1;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a entry sorts before the board position identified
+/// by @a boardSize and @a canonicalZobristHash.
+// -----------------------------------------------------------------------------
+static bool CompiledEntryIsLess(const GoOpeningBookCompiledEntry& entry, int boardSize, long long canonicalZobristHash)
+{
+  if (entry.boardSize != boardSize)
+    return entry.boardSize < boardSize;
+  return entry.canonicalZobristHash < canonicalZobristHash;
+}
+
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection identified by @a vertexString
+/// (e.g. "D4") on a board of size @a boardSize. Returns -1 if @a vertexString
+/// is not a valid vertex. The index has the same meaning as in GoBoardCore.
+// -----------------------------------------------------------------------------
+static int IndexOfVertexString(const std::string& vertexString, int boardSize)
+{
+  if (vertexString.size() < 2)
+    return -1;
+
+  // The letter "I" is not used for vertexes
+  char letter = static_cast<char>(toupper(vertexString[0]));
+  if (letter < 'A' || letter > 'T' || letter == 'I')
+    return -1;
+  int x = letter - 'A' + (letter > 'I' ? 0 : 1);
+
+  int y = 0;
+  for (size_t index = 1; index < vertexString.size(); ++index)
+  {
+    char digit = vertexString[index];
+    if (digit < '0' || digit > '9')
+      return -1;
+    y = (y * 10) + (digit - '0');
+  }
+
+  if (x < 1 || x > boardSize || y < 1 || y > boardSize)
+    return -1;
+  return ((y - 1) * boardSize) + (x - 1);
+}
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoOpeningBook.
+// -----------------------------------------------------------------------------
+@interface GoOpeningBook()
+@property(nonatomic, assign, readwrite) int numberOfPositions;
+/// @brief The compiled opening book index. Is nil until the book has been
+/// loaded. Access is synchronized on self, because the book is usually loaded
+/// on a background queue.
+@property(nonatomic, retain) NSData* compiledIndex;
+@end
+
+
+@implementation GoOpeningBook
+
+#pragma mark - Handle shared object
+
+static GoOpeningBook* sharedOpeningBook = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared GoOpeningBook object. The shared object is
+/// loaded by LoadOpeningBookCommand.
+// -----------------------------------------------------------------------------
++ (GoOpeningBook*) sharedOpeningBook
+{
+  @synchronized(self)
+  {
+    if (! sharedOpeningBook)
+      sharedOpeningBook = [[GoOpeningBook alloc] init];
+    return sharedOpeningBook;
+  }
+}
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoOpeningBook object that contains no board positions.
+///
+/// @note This is the designated initializer of GoOpeningBook.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.compiledIndex = nil;
+  self.numberOfPositions = 0;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoOpeningBook object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.compiledIndex = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Loads the opening book file at @a path, replacing the board
+/// positions that were loaded previously. Returns true on success, false if
+/// the file cannot be read. Lines that cannot be parsed, or whose board size
+/// is not supported, are skipped.
+///
+/// This method can be invoked on any thread.
+// -----------------------------------------------------------------------------
+- (bool) loadBookFileAtPath:(NSString*)path
+{
+  return [self loadBookFileAtPath:path indexFilePath:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Loads the opening book file at @a path, replacing the board
+/// positions that were loaded previously, and keeps the compiled index of the
+/// opening book in the file @a indexFilePath. Returns true on success, false if
+/// the file at @a path cannot be read.
+///
+/// If the file @a indexFilePath contains an index that was compiled from the
+/// same opening book file (same size and modification date), the index is
+/// memory-mapped and the opening book file is not parsed at all. Otherwise
+/// the opening book file is parsed, and the compiled index is written to
+/// @a indexFilePath for the next time. If @a indexFilePath is nil the opening
+/// book file is always parsed.
+///
+/// This method can be invoked on any thread.
+// -----------------------------------------------------------------------------
+- (bool) loadBookFileAtPath:(NSString*)path indexFilePath:(NSString*)indexFilePath
+{
+  NSError* error = nil;
+  NSDictionary* bookFileAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:&error];
+  if (! bookFileAttributes)
+  {
+    DDLogError(@"%@: Failed to read opening book %@, error = %@", self, path, [error localizedDescription]);
+    return false;
+  }
+  uint64_t bookFileSize = [bookFileAttributes fileSize];
+  double bookFileModificationTime = [[bookFileAttributes fileModificationDate] timeIntervalSinceReferenceDate];
+
+  NSData* compiledIndex = nil;
+  if (indexFilePath)
+  {
+    compiledIndex = [self mappedIndexFileAtPath:indexFilePath
+                                   bookFileSize:bookFileSize
+                       bookFileModificationTime:bookFileModificationTime];
+    if (compiledIndex)
+      DDLogInfo(@"%@: Mapped compiled index of opening book %@", self, [path lastPathComponent]);
+  }
+
+  if (! compiledIndex)
+  {
+    compiledIndex = [self compileBookFileAtPath:path
+                                   bookFileSize:bookFileSize
+                       bookFileModificationTime:bookFileModificationTime];
+    if (! compiledIndex)
+      return false;
+
+    if (indexFilePath && ! [compiledIndex writeToFile:indexFilePath atomically:YES])
+      DDLogError(@"%@: Failed to write compiled opening book index %@", self, indexFilePath);
+  }
+
+  const GoOpeningBookCompiledHeader* header = static_cast<const GoOpeningBookCompiledHeader*>(compiledIndex.bytes);
+  @synchronized(self)
+  {
+    self.compiledIndex = compiledIndex;
+    self.numberOfPositions = static_cast<int>(header->numberOfEntries);
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the point on which the opening book recommends to play in
+/// the current board position of @a game. Returns nil if the book has not
+/// been loaded yet, if the board position is not in the book, or if the
+/// recommended move is not legal in @a game (e.g. because of a ko).
+///
+/// This method must be invoked on the main thread.
+// -----------------------------------------------------------------------------
+- (GoPoint*) moveForGame:(GoGame*)game
+{
+  GoBoard* board = game.board;
+  enum GoBoardSymmetry symmetry;
+  long long canonicalZobristHash = [board canonicalZobristHashWithSymmetry:&symmetry];
+
+  int boardSize = board.size;
+  int canonicalReplyIndex;
+  @synchronized(self)
+  {
+    if (! self.compiledIndex)
+      return nil;
+
+    const GoOpeningBookCompiledHeader* header = static_cast<const GoOpeningBookCompiledHeader*>(self.compiledIndex.bytes);
+    const GoOpeningBookCompiledEntry* entries = reinterpret_cast<const GoOpeningBookCompiledEntry*>(header + 1);
+    const GoOpeningBookCompiledEntry* endOfEntries = entries + header->numberOfEntries;
+    const int32_t* replyIndexes = reinterpret_cast<const int32_t*>(endOfEntries);
+
+    const GoOpeningBookCompiledEntry* entry = std::lower_bound(entries, endOfEntries, canonicalZobristHash,
+                                                               [boardSize](const GoOpeningBookCompiledEntry& entry, long long hash)
+    {
+      return CompiledEntryIsLess(entry, boardSize, hash);
+    });
+    if (entry == endOfEntries || entry->boardSize != boardSize || entry->canonicalZobristHash != canonicalZobristHash)
+      return nil;
+    if (entry->nextMoveColor != game.nextMoveColor)
+      return nil;
+
+    // The GTP engine also picks one of several replies at random
+    uint32_t indexOfReply = arc4random_uniform(entry->numberOfReplies);
+    canonicalReplyIndex = replyIndexes[entry->indexOfFirstReply + indexOfReply];
+  }
+
+  enum GoBoardSymmetry inverseSymmetry = [GoBoardTopology inverseOfSymmetry:symmetry];
+  int replyIndex = [board.topology indexOfIndex:canonicalReplyIndex transformedBySymmetry:inverseSymmetry];
+  GoPoint* point = [board pointAtIndex:replyIndex];
+
+  enum GoMoveIsIllegalReason illegalReason;
+  if (! point || ! [game isLegalMove:point isIllegalReason:&illegalReason])
+    return nil;
+  return point;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for loadBookFileAtPath:indexFilePath:(). Parses the
+/// opening book file at @a path and returns the compiled index. Returns nil if
+/// the file cannot be read.
+// -----------------------------------------------------------------------------
+- (NSData*) compileBookFileAtPath:(NSString*)path
+                     bookFileSize:(uint64_t)bookFileSize
+         bookFileModificationTime:(double)bookFileModificationTime
+{
+  NSError* error = nil;
+  // Mapping the file avoids reading it into memory as a whole
+  NSData* bookData = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:&error];
+  if (! bookData)
+  {
+    DDLogError(@"%@: Failed to read opening book %@, error = %@", self, path, [error localizedDescription]);
+    return nil;
+  }
+
+  GoOpeningBookIndex index;
+  int numberOfSkippedLines = 0;
+
+  const char* bytes = static_cast<const char*>(bookData.bytes);
+  const char* endOfBytes = bytes + bookData.length;
+  while (bytes < endOfBytes)
+  {
+    const char* endOfLine = std::find(bytes, endOfBytes, '\n');
+    std::string line(bytes, endOfLine);
+    bytes = (endOfLine < endOfBytes) ? endOfLine + 1 : endOfLine;
+
+    if (! line.empty() && ! [self addLine:line toIndex:&index])
+      ++numberOfSkippedLines;
+  }
+
+  // Several lines may lead to the same board position, this is resolved by
+  // the index, so each entry is a distinct board position
+  std::vector<GoOpeningBookCompiledEntry> entries;
+  std::vector<int32_t> replyIndexes;
+  for (const auto& positionsOfBoardSize : index)
+  {
+    for (const auto& position : positionsOfBoardSize.second)
+    {
+      GoOpeningBookCompiledEntry entry;
+      entry.canonicalZobristHash = position.first;
+      entry.boardSize = positionsOfBoardSize.first;
+      entry.nextMoveColor = position.second.nextMoveColor;
+      entry.indexOfFirstReply = static_cast<uint32_t>(replyIndexes.size());
+      entry.numberOfReplies = static_cast<uint32_t>(position.second.replyIndexes.size());
+      replyIndexes.insert(replyIndexes.end(), position.second.replyIndexes.begin(), position.second.replyIndexes.end());
+      entries.push_back(entry);
+    }
+  }
+  std::sort(entries.begin(), entries.end(), [](const GoOpeningBookCompiledEntry& entry1, const GoOpeningBookCompiledEntry& entry2)
+  {
+    return CompiledEntryIsLess(entry1, entry2.boardSize, entry2.canonicalZobristHash);
+  });
+
+  GoOpeningBookCompiledHeader header;
+  header.magic = compiledIndexMagic;
+  header.formatVersion = compiledIndexFormatVersion;
+  header.bookFileSize = bookFileSize;
+  header.bookFileModificationTime = bookFileModificationTime;
+  header.numberOfEntries = static_cast<uint32_t>(entries.size());
+  header.numberOfReplyIndexes = static_cast<uint32_t>(replyIndexes.size());
+
+  NSMutableData* compiledIndex = [NSMutableData dataWithCapacity:sizeof(header) + entries.size() * sizeof(GoOpeningBookCompiledEntry) + replyIndexes.size() * sizeof(int32_t)];
+  [compiledIndex appendBytes:&header length:sizeof(header)];
+  [compiledIndex appendBytes:entries.data() length:entries.size() * sizeof(GoOpeningBookCompiledEntry)];
+  [compiledIndex appendBytes:replyIndexes.data() length:replyIndexes.size() * sizeof(int32_t)];
+
+  DDLogInfo(@"%@: Loaded %d board positions from opening book %@, skipped %d lines", self, static_cast<int>(entries.size()), [path lastPathComponent], numberOfSkippedLines);
+  return compiledIndex;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for loadBookFileAtPath:indexFilePath:(). Returns the
+/// memory-mapped compiled index in the file @a indexFilePath. Returns nil if
+/// the file does not exist, if it is damaged, if it has a different format
+/// version, or if it was compiled from an opening book file whose size or
+/// modification date do not match @a bookFileSize and
+/// @a bookFileModificationTime.
+// -----------------------------------------------------------------------------
+- (NSData*) mappedIndexFileAtPath:(NSString*)indexFilePath
+                     bookFileSize:(uint64_t)bookFileSize
+         bookFileModificationTime:(double)bookFileModificationTime
+{
+  NSData* compiledIndex = [NSData dataWithContentsOfFile:indexFilePath options:NSDataReadingMappedAlways error:nil];
+  if (! compiledIndex || compiledIndex.length < sizeof(GoOpeningBookCompiledHeader))
+    return nil;
+
+  const GoOpeningBookCompiledHeader* header = static_cast<const GoOpeningBookCompiledHeader*>(compiledIndex.bytes);
+  if (header->magic != compiledIndexMagic ||
+      header->formatVersion != compiledIndexFormatVersion ||
+      header->bookFileSize != bookFileSize ||
+      header->bookFileModificationTime != bookFileModificationTime)
+  {
+    return nil;
+  }
+
+  uint64_t expectedLength = (sizeof(GoOpeningBookCompiledHeader) +
+                             static_cast<uint64_t>(header->numberOfEntries) * sizeof(GoOpeningBookCompiledEntry) +
+                             static_cast<uint64_t>(header->numberOfReplyIndexes) * sizeof(int32_t));
+  if (compiledIndex.length != expectedLength)
+    return nil;
+
+  // Guard against reading beyond the end of the file when a reply is looked up
+  const GoOpeningBookCompiledEntry* entries = reinterpret_cast<const GoOpeningBookCompiledEntry*>(header + 1);
+  for (uint32_t indexOfEntry = 0; indexOfEntry < header->numberOfEntries; ++indexOfEntry)
+  {
+    const GoOpeningBookCompiledEntry& entry = entries[indexOfEntry];
+    if (entry.numberOfReplies == 0 ||
+        static_cast<uint64_t>(entry.indexOfFirstReply) + entry.numberOfReplies > header->numberOfReplyIndexes)
+    {
+      return nil;
+    }
+  }
+
+  return compiledIndex;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for compileBookFileAtPath:bookFileSize:bookFileModificationTime:().
+/// Parses @a line and adds
+/// the board position that it describes to @a index. Returns true if the line
+/// could be parsed, false if not.
+// -----------------------------------------------------------------------------
+- (bool) addLine:(const std::string&)line toIndex:(GoOpeningBookIndex*)index
+{
+  std::istringstream lineStream(line);
+  int boardSize = 0;
+  if (! (lineStream >> boardSize))
+    return false;
+  // The book also contains board sizes that the app does not support
+  if (boardSize < GoBoardSizeMin || boardSize > GoBoardSizeMax || boardSize % 2 == 0)
+    return false;
+
+  std::vector<int> moveIndexes;
+  std::vector<int> replyIndexes;
+  bool separatorFound = false;
+  std::string token;
+  while (lineStream >> token)
+  {
+    if (token == "|")
+    {
+      separatorFound = true;
+      continue;
+    }
+    int vertexIndex = IndexOfVertexString(token, boardSize);
+    if (vertexIndex == -1)
+      return false;
+    if (separatorFound)
+      replyIndexes.push_back(vertexIndex);
+    else
+      moveIndexes.push_back(vertexIndex);
+  }
+  if (! separatorFound || replyIndexes.empty())
+    return false;
+
+  GoBoardCore boardCore(boardSize);
+  GoBoardCore::StoneState color = GoBoardCore::StoneStateBlack;
+  for (int moveIndex : moveIndexes)
+  {
+    if (boardCore.hasStone(moveIndex))
+      return false;
+    boardCore.playStone(moveIndex, color);
+    color = (color == GoBoardCore::StoneStateBlack) ? GoBoardCore::StoneStateWhite : GoBoardCore::StoneStateBlack;
+  }
+
+  GoZobristTable* zobristTable = [GoZobristTable sharedZobristTableForBoardSize:(enum GoBoardSize)boardSize];
+  long long symmetryHashes[GoBoardSymmetryMax] = {0};
+  int numberOfPoints = boardCore.getNumberOfPoints();
+  for (int pointIndex = 0; pointIndex < numberOfPoints; ++pointIndex)
+  {
+    [zobristTable updateSymmetryHashes:symmetryHashes
+                       forStoneAtIndex:pointIndex
+                             withColor:static_cast<enum GoColor>(boardCore.getStoneState(pointIndex))];
+  }
+  enum GoBoardSymmetry symmetry;
+  long long canonicalZobristHash = [GoZobristTable canonicalHashForSymmetryHashes:symmetryHashes symmetry:&symmetry];
+
+  GoBoardTopology* topology = [GoBoardTopology sharedTopologyForBoardSize:(enum GoBoardSize)boardSize];
+  GoOpeningBookEntry& entry = (*index)[boardSize][canonicalZobristHash];
+  entry.nextMoveColor = static_cast<enum GoColor>(color);
+  for (int replyIndex : replyIndexes)
+  {
+    int canonicalReplyIndex = [topology indexOfIndex:replyIndex transformedBySymmetry:symmetry];
+    if (std::find(entry.replyIndexes.begin(), entry.replyIndexes.end(), canonicalReplyIndex) == entry.replyIndexes.end())
+      entry.replyIndexes.push_back(canonicalReplyIndex);
+  }
+
+  return true;
+}
+
+@end
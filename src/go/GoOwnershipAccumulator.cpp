@@ -0,0 +1,145 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#include "GoOwnershipAccumulator.h"
+
+// System includes
+#include <algorithm>
+#include <stdexcept>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoOwnershipAccumulator object for a board of size
+/// @a boardSize. The object initially has no accumulated scores.
+///
+/// @a reweightRadius and @a priorWeight control how new scores are blended
+/// into the accumulated scores. See the class documentation for details.
+///
+/// Throws std::invalid_argument if @a boardSize is larger than
+/// GoBoardCore::maximumBoardSize, or if @a priorWeight is not in the range
+/// [0, 1].
+// -----------------------------------------------------------------------------
+GoOwnershipAccumulator::GoOwnershipAccumulator(int boardSize, int reweightRadius, float priorWeight) :
+  boardSize(boardSize),
+  numberOfPoints(boardSize * boardSize),
+  reweightRadius(reweightRadius),
+  priorWeight(priorWeight),
+  scoresAreValid(false),
+  zobristHash(0),
+  weightsLastMoveIndex(-2),
+  scores(),
+  weights()
+{
+  if (boardSize <= 0 || boardSize > GoBoardCore::maximumBoardSize)
+    throw std::invalid_argument("Board size is not supported");
+  if (priorWeight < 0.0f || priorWeight > 1.0f)
+    throw std::invalid_argument("Prior weight must be in the range [0, 1]");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoOwnershipAccumulator object.
+// -----------------------------------------------------------------------------
+GoOwnershipAccumulator::~GoOwnershipAccumulator()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Blends @a scores into the accumulated scores. @a scores must contain
+/// one score per intersection, in the order of intersection indexes.
+///
+/// @a lastMoveIndex is the intersection index of the move that led to the
+/// board position that @a scores describe, or -1 if there is no such move
+/// (e.g. because the move was a pass). @a zobristHash identifies the board
+/// position that @a scores describe, @a previousZobristHash the board position
+/// before the last move.
+// -----------------------------------------------------------------------------
+void GoOwnershipAccumulator::accumulate(const float* scores, int lastMoveIndex, long long zobristHash, long long previousZobristHash)
+{
+  bool usePrior = this->scoresAreValid && (this->zobristHash == zobristHash || this->zobristHash == previousZobristHash);
+  if (usePrior)
+  {
+    updateWeights(lastMoveIndex);
+    const float* weights = this->weights;
+    float* accumulatedScores = this->scores;
+    for (int index = 0; index < this->numberOfPoints; ++index)
+      accumulatedScores[index] += weights[index] * (scores[index] - accumulatedScores[index]);
+  }
+  else
+  {
+    std::copy(scores, scores + this->numberOfPoints, this->scores);
+  }
+
+  this->scoresAreValid = true;
+  this->zobristHash = zobristHash;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the accumulated scores.
+// -----------------------------------------------------------------------------
+void GoOwnershipAccumulator::reset()
+{
+  this->scoresAreValid = false;
+  this->zobristHash = 0;
+  std::fill(this->scores, this->scores + this->numberOfPoints, 0.0f);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if this GoOwnershipAccumulator object has accumulated
+/// scores.
+// -----------------------------------------------------------------------------
+bool GoOwnershipAccumulator::hasScores() const
+{
+  return this->scoresAreValid;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the accumulated scores, one per intersection, in the order
+/// of intersection indexes. All scores are 0.0 if hasScores() returns false.
+// -----------------------------------------------------------------------------
+const float* GoOwnershipAccumulator::getScores() const
+{
+  return this->scores;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Calculates the weight of a new score for each intersection, for a
+/// last move on the intersection with index @a lastMoveIndex. Does nothing if
+/// the weights for that move are already known.
+// -----------------------------------------------------------------------------
+void GoOwnershipAccumulator::updateWeights(int lastMoveIndex)
+{
+  if (this->weightsLastMoveIndex == lastMoveIndex)
+    return;
+  this->weightsLastMoveIndex = lastMoveIndex;
+
+  float farWeight = 1.0f - this->priorWeight;
+  std::fill(this->weights, this->weights + this->numberOfPoints, farWeight);
+  if (lastMoveIndex < 0 || lastMoveIndex >= this->numberOfPoints)
+    return;
+
+  int lastMoveX = lastMoveIndex % this->boardSize;
+  int lastMoveY = lastMoveIndex / this->boardSize;
+  int firstY = std::max(0, lastMoveY - this->reweightRadius);
+  int lastY = std::min(this->boardSize - 1, lastMoveY + this->reweightRadius);
+  int firstX = std::max(0, lastMoveX - this->reweightRadius);
+  int lastX = std::min(this->boardSize - 1, lastMoveX + this->reweightRadius);
+  for (int y = firstY; y <= lastY; ++y)
+  {
+    float* weightsInRow = this->weights + y * this->boardSize;
+    std::fill(weightsInRow + firstX, weightsInRow + lastX + 1, 1.0f);
+  }
+}
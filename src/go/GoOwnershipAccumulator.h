@@ -0,0 +1,90 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoBoardCore.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoOwnershipAccumulator class carries ownership estimates
+/// (territory statistics scores) from one board position to the next.
+///
+/// @ingroup go
+///
+/// Each time the GTP engine reports territory statistics, the new scores are
+/// not simply taken over. Instead they are blended into the scores that were
+/// accumulated so far, which act as a prior:
+/// - Intersections whose Chebyshev distance to the last move is at most
+///   @e reweightRadius are strongly affected by the move. They take over the
+///   new scores.
+/// - All other intersections are mostly unaffected by the move. Their
+///   accumulated score moves only by the fraction (1 - @e priorWeight)
+///   towards the new score.
+///
+/// The result is an ownership map that remains stable across moves in areas
+/// where nothing happens, even if the GTP engine's search is short and its
+/// statistics are noisy.
+///
+/// The prior is used only if the new scores describe the same board position
+/// as the accumulated scores, or the board position immediately after it.
+/// Board positions are identified by their Zobrist hashes. In all other cases
+/// (e.g. the user navigated to a different game variation) the new scores
+/// replace the accumulated scores.
+///
+/// Scores are stored in flat float arrays in the order of intersection
+/// indexes (see GoBoardCore). The blending loop operates on plain arrays
+/// without branches, so that the compiler can vectorize it.
+///
+/// GoOwnershipAccumulator is not thread-safe.
+// -----------------------------------------------------------------------------
+class GoOwnershipAccumulator
+{
+public:
+  GoOwnershipAccumulator(int boardSize, int reweightRadius, float priorWeight);
+  ~GoOwnershipAccumulator();
+
+  void accumulate(const float* scores, int lastMoveIndex, long long zobristHash, long long previousZobristHash);
+  void reset();
+  bool hasScores() const;
+  const float* getScores() const;
+
+private:
+  void updateWeights(int lastMoveIndex);
+
+private:
+  /// @brief The board size.
+  int boardSize;
+  /// @brief The number of intersections, i.e. boardSize * boardSize.
+  int numberOfPoints;
+  /// @brief The Chebyshev distance from the last move within which new scores
+  /// are taken over unchanged.
+  int reweightRadius;
+  /// @brief The weight of the accumulated score for intersections that are
+  /// farther away from the last move than @e reweightRadius.
+  float priorWeight;
+  /// @brief True if @e scores contains accumulated scores.
+  bool scoresAreValid;
+  /// @brief The Zobrist hash of the board position that @e scores describe.
+  long long zobristHash;
+  /// @brief The intersection index of the last move for which @e weights was
+  /// calculated. -2 if @e weights was not yet calculated.
+  int weightsLastMoveIndex;
+  /// @brief The accumulated scores, one per intersection.
+  float scores[GoBoardCore::maximumNumberOfPoints];
+  /// @brief The weight of a new score, one per intersection.
+  float weights[GoBoardCore::maximumNumberOfPoints];
+};
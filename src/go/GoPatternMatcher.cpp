@@ -0,0 +1,348 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoPatternMatcher.h"
+
+// System includes
+#include <cstdlib>  // for std::abs()
+#include <stdexcept>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The linear part of the 8 board symmetries, in the same order as the
+/// enumeration #GoBoardSymmetry. A symmetry maps the coordinates (x, y) to
+/// (a * x + b * y, c * x + d * y), followed by a translation that brings the
+/// result back into the first quadrant.
+// -----------------------------------------------------------------------------
+static const int symmetryMatrices[8][4] =
+{
+  { 1,  0,  0,  1},  // Identity
+  { 0, -1,  1,  0},  // Rotate90
+  {-1,  0,  0, -1},  // Rotate180
+  { 0,  1, -1,  0},  // Rotate270
+  {-1,  0,  0,  1},  // MirrorHorizontal
+  { 1,  0,  0, -1},  // MirrorVertical
+  { 0,  1,  1,  0},  // Transpose
+  { 0, -1, -1,  0},  // AntiTranspose
+};
+
+// -----------------------------------------------------------------------------
+/// @brief The number of bits in a game record entry that hold the index of
+/// the intersection. The remaining bits hold the stone state.
+// -----------------------------------------------------------------------------
+static const int gameRecordEntryIndexBits = 9;
+static const unsigned short gameRecordEntryIndexMask = (1 << gameRecordEntryIndexBits) - 1;
+
+// Definition is required because the constant is odr-used by clients that
+// compare against it
+const unsigned short GoPatternMatcher::endOfBoardPosition;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoPatternMatcher object that finds the pattern
+/// described by the remaining parameters on a board of size @a boardSize.
+///
+/// @a patternCells contains @a patternWidth * @a patternHeight cells, row by
+/// row, starting with the bottom row. @a patternEdges is a combination of
+/// #PatternEdge flags. If @a matchSwappedColors is true the pattern also
+/// matches if black and white are swapped.
+///
+/// If the pattern is larger than the board, or if its edge requirements cannot
+/// be satisfied (e.g. both left and right edge on a pattern that is narrower
+/// than the board), the pattern has no placements and never matches.
+///
+/// Throws std::invalid_argument if @a patternWidth or @a patternHeight is less
+/// than 1, or if the number of elements in @a patternCells does not match
+/// the pattern dimensions.
+// -----------------------------------------------------------------------------
+GoPatternMatcher::GoPatternMatcher(int boardSize,
+                                   int patternWidth,
+                                   int patternHeight,
+                                   const std::vector<PatternCell>& patternCells,
+                                   int patternEdges,
+                                   bool matchSwappedColors)
+: boardSize(boardSize)
+{
+  if (patternWidth < 1 || patternHeight < 1)
+    throw std::invalid_argument("Pattern dimensions must be at least 1");
+  if (patternCells.size() != static_cast<size_t>(patternWidth * patternHeight))
+    throw std::invalid_argument("Number of pattern cells does not match pattern dimensions");
+
+  std::vector<Variant> variants;
+  addVariants(patternWidth, patternHeight, patternCells, patternEdges, false, variants);
+  if (matchSwappedColors)
+    addVariants(patternWidth, patternHeight, patternCells, patternEdges, true, variants);
+
+  for (const Variant& variant : variants)
+    addPlacements(variant);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Destroys the GoPatternMatcher object.
+// -----------------------------------------------------------------------------
+GoPatternMatcher::~GoPatternMatcher()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the size of the board on which the pattern is searched.
+// -----------------------------------------------------------------------------
+int GoPatternMatcher::getBoardSize() const
+{
+  return this->boardSize;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of placements of all orientations of the pattern
+/// on the board. Is 0 if the pattern does not fit onto the board.
+// -----------------------------------------------------------------------------
+int GoPatternMatcher::getNumberOfPlacements() const
+{
+  return static_cast<int>(this->placements.size());
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Replays the game record @a gameRecord, which consists of
+/// @a gameRecordLength entries, and returns the number of the first board
+/// position in which the pattern matches. Returns -1 if the pattern does not
+/// match in any board position.
+///
+/// A game record is a sequence of entries produced by getGameRecordEntry(),
+/// each of which changes the stone state of one intersection. The changes that
+/// lead to a board position are terminated by #endOfBoardPosition. Board
+/// positions are numbered starting with 0, which is the board position of the
+/// first #endOfBoardPosition entry (typically the board position that
+/// contains the handicap or setup stones). Changes after the last
+/// #endOfBoardPosition entry are ignored.
+// -----------------------------------------------------------------------------
+int GoPatternMatcher::findFirstMatch(const unsigned short* gameRecord, int gameRecordLength) const
+{
+  GoBoardCore::PointSet blackStonesEver;
+  GoBoardCore::PointSet whiteStonesEver;
+  for (int indexOfEntry = 0; indexOfEntry < gameRecordLength; ++indexOfEntry)
+  {
+    unsigned short entry = gameRecord[indexOfEntry];
+    if (entry == endOfBoardPosition)
+      continue;
+    int stoneState = entry >> gameRecordEntryIndexBits;
+    if (stoneState == GoBoardCore::StoneStateBlack)
+      blackStonesEver.set(entry & gameRecordEntryIndexMask);
+    else if (stoneState == GoBoardCore::StoneStateWhite)
+      whiteStonesEver.set(entry & gameRecordEntryIndexMask);
+  }
+
+  std::vector<const Placement*> candidatePlacements;
+  for (const Placement& placement : this->placements)
+  {
+    if ((placement.blackStones & blackStonesEver) == placement.blackStones &&
+        (placement.whiteStones & whiteStonesEver) == placement.whiteStones)
+    {
+      candidatePlacements.push_back(&placement);
+    }
+  }
+  if (candidatePlacements.empty())
+    return -1;
+
+  GoBoardCore::PointSet blackStones;
+  GoBoardCore::PointSet whiteStones;
+  // Initially all intersections are considered changed so that all candidate
+  // placements are tested in the first board position
+  GoBoardCore::PointSet changedIntersections;
+  changedIntersections.set();
+  int boardPosition = 0;
+  for (int indexOfEntry = 0; indexOfEntry < gameRecordLength; ++indexOfEntry)
+  {
+    unsigned short entry = gameRecord[indexOfEntry];
+    if (entry == endOfBoardPosition)
+    {
+      for (const Placement* placement : candidatePlacements)
+      {
+        if ((placement->area & changedIntersections).any() && isMatch(*placement, blackStones, whiteStones))
+          return boardPosition;
+      }
+      changedIntersections.reset();
+      ++boardPosition;
+      continue;
+    }
+
+    int index = entry & gameRecordEntryIndexMask;
+    int stoneState = entry >> gameRecordEntryIndexBits;
+    blackStones.set(index, stoneState == GoBoardCore::StoneStateBlack);
+    whiteStones.set(index, stoneState == GoBoardCore::StoneStateWhite);
+    changedIntersections.set(index);
+  }
+
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the game record entry that changes the stone state of the
+/// intersection with index @a index to @a stoneState.
+// -----------------------------------------------------------------------------
+unsigned short GoPatternMatcher::getGameRecordEntry(int index, GoBoardCore::StoneState stoneState)
+{
+  return static_cast<unsigned short>((stoneState << gameRecordEntryIndexBits) | index);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Adds the 8 orientations of the pattern described by the parameters
+/// to @a variants, swapping black and white if @a swapColors is true.
+/// Orientations that are identical to a variant already in @a variants (i.e.
+/// because the pattern itself is symmetric) are not added.
+// -----------------------------------------------------------------------------
+void GoPatternMatcher::addVariants(int patternWidth,
+                                   int patternHeight,
+                                   const std::vector<PatternCell>& patternCells,
+                                   int patternEdges,
+                                   bool swapColors,
+                                   std::vector<Variant>& variants) const
+{
+  for (const int* matrix : symmetryMatrices)
+  {
+    int a = matrix[0];
+    int b = matrix[1];
+    int c = matrix[2];
+    int d = matrix[3];
+
+    Variant variant;
+    variant.width = std::abs(a) * patternWidth + std::abs(b) * patternHeight;
+    variant.height = std::abs(c) * patternWidth + std::abs(d) * patternHeight;
+    variant.cells.assign(patternCells.size(), PatternCellAny);
+    int offsetX = (a < 0 ? patternWidth - 1 : 0) + (b < 0 ? patternHeight - 1 : 0);
+    int offsetY = (c < 0 ? patternWidth - 1 : 0) + (d < 0 ? patternHeight - 1 : 0);
+
+    for (int y = 0; y < patternHeight; ++y)
+    {
+      for (int x = 0; x < patternWidth; ++x)
+      {
+        PatternCell cell = patternCells[y * patternWidth + x];
+        if (swapColors && cell == PatternCellBlack)
+          cell = PatternCellWhite;
+        else if (swapColors && cell == PatternCellWhite)
+          cell = PatternCellBlack;
+
+        int variantX = a * x + b * y + offsetX;
+        int variantY = c * x + d * y + offsetY;
+        variant.cells[variantY * variant.width + variantX] = cell;
+      }
+    }
+
+    // An edge is transformed by transforming the outward pointing normal
+    // vector of the side of the pattern that must lie on the edge
+    variant.edges = PatternEdgeNone;
+    const int edgeNormals[4][3] =
+    {
+      {PatternEdgeLeft, -1, 0},
+      {PatternEdgeRight, 1, 0},
+      {PatternEdgeBottom, 0, -1},
+      {PatternEdgeTop, 0, 1},
+    };
+    for (const int* edgeNormal : edgeNormals)
+    {
+      if (! (patternEdges & edgeNormal[0]))
+        continue;
+      int normalX = a * edgeNormal[1] + b * edgeNormal[2];
+      int normalY = c * edgeNormal[1] + d * edgeNormal[2];
+      if (normalX < 0)
+        variant.edges |= PatternEdgeLeft;
+      else if (normalX > 0)
+        variant.edges |= PatternEdgeRight;
+      else if (normalY < 0)
+        variant.edges |= PatternEdgeBottom;
+      else
+        variant.edges |= PatternEdgeTop;
+    }
+
+    bool isDuplicate = false;
+    for (const Variant& existingVariant : variants)
+    {
+      if (existingVariant.width == variant.width &&
+          existingVariant.height == variant.height &&
+          existingVariant.edges == variant.edges &&
+          existingVariant.cells == variant.cells)
+      {
+        isDuplicate = true;
+        break;
+      }
+    }
+    if (! isDuplicate)
+      variants.push_back(variant);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Adds all placements of @a variant on the board to @e placements.
+// -----------------------------------------------------------------------------
+void GoPatternMatcher::addPlacements(const Variant& variant)
+{
+  int lastX = this->boardSize - variant.width;
+  int lastY = this->boardSize - variant.height;
+  if (lastX < 0 || lastY < 0)
+    return;
+
+  // If a pattern must lie on two opposite edges the loops below only run if
+  // the pattern spans the entire board
+  int minimumX = (variant.edges & PatternEdgeRight) ? lastX : 0;
+  int maximumX = (variant.edges & PatternEdgeLeft) ? 0 : lastX;
+  int minimumY = (variant.edges & PatternEdgeTop) ? lastY : 0;
+  int maximumY = (variant.edges & PatternEdgeBottom) ? 0 : lastY;
+
+  for (int placementY = minimumY; placementY <= maximumY; ++placementY)
+  {
+    for (int placementX = minimumX; placementX <= maximumX; ++placementX)
+    {
+      Placement placement;
+      for (int y = 0; y < variant.height; ++y)
+      {
+        for (int x = 0; x < variant.width; ++x)
+        {
+          int index = (placementY + y) * this->boardSize + (placementX + x);
+          switch (variant.cells[y * variant.width + x])
+          {
+            case PatternCellEmpty:
+              placement.emptyIntersections.set(index);
+              break;
+            case PatternCellBlack:
+              placement.blackStones.set(index);
+              break;
+            case PatternCellWhite:
+              placement.whiteStones.set(index);
+              break;
+            default:
+              break;
+          }
+        }
+      }
+      placement.area = placement.blackStones | placement.whiteStones | placement.emptyIntersections;
+      this->placements.push_back(placement);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a placement matches the board position that
+/// consists of @a blackStones and @a whiteStones.
+// -----------------------------------------------------------------------------
+bool GoPatternMatcher::isMatch(const Placement& placement,
+                               const GoBoardCore::PointSet& blackStones,
+                               const GoBoardCore::PointSet& whiteStones) const
+{
+  return ((placement.blackStones & blackStones) == placement.blackStones &&
+          (placement.whiteStones & whiteStones) == placement.whiteStones &&
+          (placement.emptyIntersections & (blackStones | whiteStones)).none());
+}
@@ -0,0 +1,141 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoBoardCore.h"
+
+// System includes
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoPatternMatcher class finds the first board position in a game
+/// record in which a local rectangular pattern occurs.
+///
+/// @ingroup go
+///
+/// A pattern is a rectangle of cells. Each cell requires the intersection it
+/// is placed on to be empty, to be occupied by a black stone, to be occupied by
+/// a white stone, or it is a wildcard that accepts any intersection. In
+/// addition each side of the rectangle may be required to lie on the edge of
+/// the board, which is how corner and side patterns (joseki, fuseki) are
+/// expressed.
+///
+/// A pattern matches a board position if it fits onto the board in any of the
+/// 8 orientations that result from rotating and reflecting the pattern (see
+/// #GoBoardSymmetry). Optionally the pattern also matches with black and white
+/// swapped. GoPatternMatcher precomputes all orientations and all placements
+/// of the pattern on the board when it is constructed. Each placement is a set
+/// of three PointSet masks (black, white and empty cells), so testing a
+/// placement against a board position is a handful of word-wide bit
+/// operations instead of a cell-by-cell comparison.
+///
+/// Game records are compact streams of stone changes (see getGameRecordEntry())
+/// that are produced once per game, e.g. by ArchivePatternIndex, so that a
+/// search does not need to parse .sgf files or to resolve captures. Before a
+/// game record is replayed, findFirstMatch() discards all placements that
+/// require a stone on an intersection that never has a stone of that color in
+/// the entire game. Most games are rejected by this filter without being
+/// replayed. During the replay a placement is only tested after a board
+/// position in which one of its intersections has changed.
+///
+/// GoPatternMatcher is immutable after construction. Its const methods can be
+/// invoked on different threads at the same time.
+// -----------------------------------------------------------------------------
+class GoPatternMatcher
+{
+public:
+  /// @brief Enumerates the requirements that a pattern cell can have.
+  enum PatternCell
+  {
+    /// @brief The cell matches any intersection.
+    PatternCellAny,
+    /// @brief The cell matches an empty intersection.
+    PatternCellEmpty,
+    /// @brief The cell matches an intersection occupied by a black stone.
+    PatternCellBlack,
+    /// @brief The cell matches an intersection occupied by a white stone.
+    PatternCellWhite
+  };
+
+  /// @brief Flags that require a side of the pattern to lie on the edge of
+  /// the board. The flags can be combined.
+  enum PatternEdge
+  {
+    PatternEdgeNone = 0,
+    PatternEdgeLeft = 1,
+    PatternEdgeRight = 2,
+    PatternEdgeBottom = 4,
+    PatternEdgeTop = 8
+  };
+
+  /// @brief The game record entry that ends a board position.
+  static const unsigned short endOfBoardPosition = 0xFFFF;
+
+public:
+  GoPatternMatcher(int boardSize,
+                   int patternWidth,
+                   int patternHeight,
+                   const std::vector<PatternCell>& patternCells,
+                   int patternEdges,
+                   bool matchSwappedColors);
+  ~GoPatternMatcher();
+
+  int getBoardSize() const;
+  int getNumberOfPlacements() const;
+  int findFirstMatch(const unsigned short* gameRecord, int gameRecordLength) const;
+
+  static unsigned short getGameRecordEntry(int index, GoBoardCore::StoneState stoneState);
+
+private:
+  /// @brief One orientation of the pattern.
+  struct Variant
+  {
+    int width;
+    int height;
+    std::vector<PatternCell> cells;
+    int edges;
+  };
+
+  /// @brief One orientation of the pattern, placed at a specific location on
+  /// the board.
+  struct Placement
+  {
+    GoBoardCore::PointSet blackStones;
+    GoBoardCore::PointSet whiteStones;
+    GoBoardCore::PointSet emptyIntersections;
+    /// @brief The union of the three other sets.
+    GoBoardCore::PointSet area;
+  };
+
+  void addVariants(int patternWidth,
+                   int patternHeight,
+                   const std::vector<PatternCell>& patternCells,
+                   int patternEdges,
+                   bool swapColors,
+                   std::vector<Variant>& variants) const;
+  void addPlacements(const Variant& variant);
+  bool isMatch(const Placement& placement,
+               const GoBoardCore::PointSet& blackStones,
+               const GoBoardCore::PointSet& whiteStones) const;
+
+private:
+  /// @brief The size of the board on which the pattern is searched.
+  int boardSize;
+  /// @brief All placements of all orientations of the pattern.
+  std::vector<Placement> placements;
+};
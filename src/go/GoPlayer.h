@@ -47,5 +47,12 @@
 /// @brief Returns a string that corresponds to the color taken by the
 /// player. "B" for black, "W" for white.
 @property(nonatomic, assign, readonly) NSString* colorString;
+/// @brief The total time in seconds that the computer spent thinking about the
+/// moves of this player in the current game. Is used to tell the GTP engine
+/// how much of the game's time budget is left.
+///
+/// This property is not archived, so the time spent is forgotten when the app
+/// is restarted.
+@property(nonatomic, assign) NSTimeInterval thinkingTime;
 
 @end
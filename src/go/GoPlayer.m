@@ -138,6 +138,7 @@
 
   self.player = aPlayer;
   self.black = true;
+  self.thinkingTime = 0;
 
   return self;
 }
@@ -164,6 +165,7 @@
   NSString* uuid = [decoder decodeObjectOfClass:[NSString class] forKey:goPlayerPlayerUUIDKey];
   self.player = [GoPlayer playerWithUUID:uuid];
   self.black = [decoder decodeBoolForKey:goPlayerIsBlackKey];
+  self.thinkingTime = 0;
 
   if (! self.player)
   {
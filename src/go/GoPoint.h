@@ -72,6 +72,11 @@
 @property(nonatomic, assign, getter=isStarPoint) bool starPoint;
 /// @brief Denotes whether a stone has been placed on the intersection that the
 /// GoPoint represents, and which color the stone has.
+///
+/// Setting this property also updates the internal board state representation
+/// of the GoBoard that the GoPoint is associated with, and the liberties of
+/// adjacent stone groups. See
+/// GoBoardRegion::updateLibertiesAfterStoneStateChangeOfPoint:().
 @property(nonatomic, assign) enum GoColor stoneState;
 /// @brief The score assigned to this point by the most recent territory
 /// statistics evaluation.
@@ -320,6 +320,19 @@
   return _previous;
 }
 
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setStoneState:(enum GoColor)stoneState
+{
+  _stoneState = stoneState;
+  // Keep the board's internal board state representation in sync
+  [_board updateStoneStateAtPoint:self];
+  // Keep the liberties of adjacent stone groups in sync. The region is nil
+  // while this GoPoint is being decoded.
+  [_region updateLibertiesAfterStoneStateChangeOfPoint:self];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns true if the intersection represented by this GoPoint is
 /// occupied by a stone.
@@ -351,17 +364,9 @@
 - (int) liberties
 {
   if ([self hasStone])
-    return [self.region liberties];
+    return [self.board numberOfLibertiesOfStoneGroupAtPoint:self];
   else
-  {
-    int liberties = 0;
-    for (GoPoint* neighbour in self.neighbours)
-    {
-      if (! [neighbour hasStone])
-        liberties++;
-    }
-    return liberties;
-  }
+    return [self.board numberOfEmptyNeighboursOfPoint:self];
 }
 
 // -----------------------------------------------------------------------------
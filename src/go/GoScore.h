@@ -47,6 +47,12 @@
 /// information is available. Both notifications are delivered in the context
 /// of the main thread.
 ///
+/// Requests for a calculation that arrive while a calculation is in progress
+/// are not lost. They supersede the calculation in progress: When it ends,
+/// GoScore calculates again against the latest state before it posts
+/// #goScoreCalculationEnds. Each request increments @e calculationGeneration,
+/// and @e resultGeneration tells which request the available score reflects.
+///
 /// By default GoScore does not collect scoring information because this is a
 /// potentially time-consuming operation. A controller may enable the collection
 /// of scoring information by setting the @e scoringEnabled property to true. In
@@ -64,9 +70,17 @@
 /// Score calculation depends on the scoring system in effect for the current
 /// game. The score can only be calculated after the status of all stones on the
 /// board has been determined to be either dead, alive or in seki. Neither
-/// Little Go nor the GTP engine are "clever" enough to find out this status on
-/// their own. This means that the user must help out by interactively marking
-/// stones as dead, alive or in seki.
+/// Little Go nor the GTP engine are "clever" enough to reliably find out this
+/// status on their own. This means that the user must help out by
+/// interactively marking stones as dead, alive or in seki.
+///
+/// To reduce the amount of manual work, the first calculation after scoring
+/// is enabled asks the GTP engine for an initial set of dead stones, and it
+/// runs a local seki analysis in GoBoardCore (see GoBoard::stonesInSeki()).
+/// Stone groups that the analysis finds to be in seki are marked as such if
+/// they are currently alive. The analysis is repeated once when the GTP
+/// engine's dead stones arrive. After that only the user changes stone group
+/// states, so the analysis never overrides a manual mark.
 ///
 /// An updated score is calculated every time that the user marks a stone group
 /// as dead, alive or in seki. This is the sequence of events:
@@ -81,13 +95,17 @@
 ///     that is passed as a parameter, but also of adjacent GoBoardRegion
 ///     objects. See the "Mark dead stones intelligently" section below for
 ///     details.
-///   - No such assistance is available for toggleSekiStateOfStoneGroup:().
+///   - No such assistance is available for toggleSekiStateOfStoneGroup:(),
+///     but see above for the automatic seki analysis at the start of scoring.
 /// # calculateWaitUntilDone:() is invoked by the controller object that handles
 ///   user input. This initiates the actual scoring process which consists of
 ///   two more steps.
 /// # updateTerritoryColor() (a private helper method invoked as part of the
 ///   scoring process) calculates the color that "owns" each GoBoardRegion
-///   - updateTerritoryColor() stores the "owning" color in GoBoardRegion
+///   - updateTerritoryColor() obtains a territory map from GoBoard, which
+///     calculates it with the territory kernel of GoBoardCore. The territory
+///     map is made available in the @e territoryMap property.
+///   - updateTerritoryColor() also stores the "owning" color in GoBoardRegion
 ///     objects' @e territoryColor property.
 ///   - Calculation of the territory color entirely depends on the
 ///     @e stoneGroupState property of all GoBoardRegion objects having been
@@ -103,6 +121,11 @@
 /// engine for an initial list of dead stones. It is expected that the GTP
 /// engine at least detects dead stones surrounded by unconditionally alive
 /// groups. This query can be suppressed by the user in the user preferences.
+/// The query does not block the calculation: GoScore first calculates a
+/// geometric score with all stones alive, then updates the stone group states
+/// and calculates again when the GTP engine's response arrives. If the user
+/// marks a stone group before that, or the board position changes, the query
+/// is aborted and the response is discarded.
 ///
 ///
 /// @par Mark dead stones intelligently
@@ -134,8 +157,9 @@
 ///
 /// @par Determining territory color
 ///
-/// The implementation of updateTerritoryColor() is rather simple and consists
-/// of two passes:
+/// The territory kernel in GoBoardCore works on bitset masks of dead stones
+/// and stones in seki, and finds empty areas with a scanline flood fill. The
+/// rules that the kernel applies are these:
 /// # Territory colors for stone groups can easily be determined by looking at
 ///   the stone group's color
 ///   - If the group is alive, the points in the group belong to the color
@@ -160,7 +184,7 @@
 ///     is neutral and consists of dame points.
 ///   - If at least one adjacent stone group is dead, the empty region belongs
 ///     to the opposing color's territory.
-///   - In the last case, updateTerritoryColor() makes a final check to see
+///   - In the last case, the territory kernel makes a final check to see
 ///     if there are any inconsistencies (stone groups of the same color that
 ///     are alive, or stones groups of the opposing color that are also dead).
 ///   - An inconsistency is also detected if at least one of the adjacent stone
@@ -169,6 +193,25 @@
 ///   - If inconsistencies are found the empty region is marked accordingly so
 ///     that the problem can be made visible to user. For scoring purposes, the
 ///     empty region is considered to be neutral.
+///
+///
+/// @par Incremental scoring
+///
+/// Toggling the state of a stone group can only change the territory color of
+/// the stone group itself and of the empty regions adjacent to it. For this
+/// reason, after a full calculation has taken place, toggleDeadStateOfStoneGroup:()
+/// and toggleSekiStateOfStoneGroup:() remember which GoBoardRegion objects are
+/// affected by the toggle operation, together with the contribution that these
+/// regions made to the area, territory and dead stone counts. The next
+/// calculation then updates the territory color only of these regions, and
+/// adjusts the counts by the difference between the old and the new
+/// contribution of these regions. This keeps the cost of a toggle operation
+/// independent of the total number of regions on the board.
+///
+/// Any operation that may change the regions themselves (enabling or disabling
+/// scoring, changing the board position, asking the GTP engine for dead
+/// stones) discards this information, and the next calculation is a full
+/// calculation again.
 // -----------------------------------------------------------------------------
 @interface GoScore : NSObject <NSSecureCoding>
 {
@@ -196,6 +239,8 @@
 //@{
 @property(nonatomic, assign) bool scoringInProgress;         ///< @brief Is true if a scoring operation is currently in progress.
 @property(nonatomic, assign) bool askGtpEngineForDeadStonesInProgress; ///< @brief Is true if the GTP engine is currently being queried for dead stones.
+@property(nonatomic, assign, readonly) int calculationGeneration;  ///< @brief Is incremented each time that calculateWaitUntilDone:() is invoked.
+@property(nonatomic, assign, readonly) int resultGeneration;       ///< @brief The value of @e calculationGeneration that the currently available score reflects.
 //@}
 // -----------------------------------------------------------------------------
 /// @name Scoring properties (for the current board position)
@@ -215,6 +260,12 @@
 @property(nonatomic, assign) double totalScoreBlack;    ///< @brief The total score for black
 @property(nonatomic, assign) double totalScoreWhite;    ///< @brief The total score for white
 @property(nonatomic, assign) enum GoGameResult result;  ///< @brief The overall result of comparing @e totalScoreBlack and @e totalScoreWhite
+/// @brief The territory map of the last successful calculation, or nil if no
+/// calculation has taken place since scoring was enabled or the board position
+/// changed. See GoBoard::territoryMapWithScoringSystem:() for the format.
+/// Clients that draw territory can use the map directly instead of querying
+/// GoBoardRegion objects.
+@property(nonatomic, retain, readonly) NSData* territoryMap;
 //@}
 // -----------------------------------------------------------------------------
 /// @name Move statistics (for the entire game)
@@ -28,14 +28,35 @@
 #import "GoPlayer.h"
 #import "GoPoint.h"
 #import "GoUtilities.h"
+#import "../diagnostics/SignpostLog.h"
 #import "../main/ApplicationDelegate.h"
 #import "../gtp/GtpCommand.h"
 #import "../gtp/GtpResponse.h"
+#import "../gtp/GtpUtilities.h"
 #import "../play/model/ScoringModel.h"
 #import "../sgf/SgfUtilities.h"
 #import "../ui/UiSettingsModel.h"
 #import "../utility/NSStringAdditions.h"
 
+// System includes
+#import <os/signpost.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoScoreRegionContribution struct holds the area, territory and
+/// dead stone counts that one or more GoBoardRegion objects contribute to the
+/// score.
+// -----------------------------------------------------------------------------
+struct GoScoreRegionContribution
+{
+  int territoryBlack;
+  int territoryWhite;
+  int aliveBlack;
+  int aliveWhite;
+  int deadBlack;
+  int deadWhite;
+};
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for GoScore.
@@ -44,7 +65,29 @@
 @property(nonatomic, assign) GoGame* game;
 @property(nonatomic, retain) NSOperationQueue* operationQueue;
 @property(nonatomic, assign) bool didAskGtpEngineForDeadStones;
+/// @brief True if markStoneGroupsInSeki() has already examined the board for
+/// the current scoring session.
+@property(nonatomic, assign) bool didMarkStoneGroupsInSeki;
 @property(nonatomic, assign) bool lastCalculationHadError;
+/// @brief Identifies the current dead stones query. Is incremented when the
+/// query is aborted, so that the response can be recognized as obsolete.
+@property(nonatomic, assign) int deadStonesQueryID;
+/// @brief The response to the dead stones query that arrived while a score
+/// calculation was in progress, or nil if there is no such response.
+@property(nonatomic, retain) GtpResponse* pendingDeadStonesResponse;
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, retain, readwrite) NSData* territoryMap;
+@property(nonatomic, assign, readwrite) int calculationGeneration;
+@property(nonatomic, assign, readwrite) int resultGeneration;
+//@}
+/// @brief The GoBoardRegion objects whose territory color must be updated by
+/// the next calculation. Is nil if the next calculation must be a full
+/// calculation. See the class documentation, section "Incremental scoring".
+@property(nonatomic, retain) NSMutableArray* regionsToUpdate;
+/// @brief The contribution that the GoBoardRegion objects in
+/// @e regionsToUpdate made to the score when the last calculation took place.
+@property(nonatomic, assign) struct GoScoreRegionContribution contributionOfRegionsToUpdate;
 @end
 
 
@@ -67,7 +110,15 @@
   _game = game;
   _operationQueue = [[NSOperationQueue alloc] init];
   _didAskGtpEngineForDeadStones = false;
+  _didMarkStoneGroupsInSeki = false;
   _lastCalculationHadError = false;
+  _regionsToUpdate = nil;
+  _contributionOfRegionsToUpdate = (struct GoScoreRegionContribution){0};
+  _territoryMap = nil;
+  _calculationGeneration = 0;
+  _resultGeneration = 0;
+  _deadStonesQueryID = 0;
+  _pendingDeadStonesResponse = nil;
   [self resetValues];
 
   return self;
@@ -106,6 +157,7 @@
   _passesPlayedByWhite = [decoder decodeIntForKey:goScorePassesPlayedByWhiteKey];
   _game = [decoder decodeObjectOfClass:[GoGame class] forKey:goScoreGameKey];
   _didAskGtpEngineForDeadStones = [decoder decodeBoolForKey:goScoreDidAskGtpEngineForDeadStonesKey];
+  _didMarkStoneGroupsInSeki = false;
   _lastCalculationHadError = [decoder decodeBoolForKey:goScoreLastCalculationHadErrorKey];
 
   // If we wanted to restore the two "in progress" states we would need to
@@ -116,6 +168,15 @@
   _scoringInProgress = false;
   _askGtpEngineForDeadStonesInProgress = false;
   _operationQueue = [[NSOperationQueue alloc] init];
+  // The first calculation after unarchiving is always a full calculation
+  _regionsToUpdate = nil;
+  _contributionOfRegionsToUpdate = (struct GoScoreRegionContribution){0};
+  // Not archived, the next calculation creates a new territory map
+  _territoryMap = nil;
+  _calculationGeneration = 0;
+  _resultGeneration = 0;
+  _deadStonesQueryID = 0;
+  _pendingDeadStonesResponse = nil;
 
   return self;
 }
@@ -135,6 +196,9 @@
 {
   [[NSNotificationCenter defaultCenter] removeObserver:self];
   self.operationQueue = nil;
+  self.regionsToUpdate = nil;
+  self.territoryMap = nil;
+  self.pendingDeadStonesResponse = nil;
   [super dealloc];
 }
 
@@ -180,6 +244,7 @@
   [self initializeRegionsRetainTerritory:false];
 
   self.didAskGtpEngineForDeadStones = false;
+  self.didMarkStoneGroupsInSeki = false;
 
   [self postScoringModeNotification];
 }
@@ -193,20 +258,23 @@
 // -----------------------------------------------------------------------------
 - (void) enableScoringOnAppLaunch
 {
-  // This does nothing if GoBoardRegion objects are already in scoring mode.
-  // Otherwise they are put into scoring mode but still retain the territory
-  // information that they loaded from the NSCoding archive. Because of this
-  // it's important that uninitializeRegions() resets the territory
-  // information.
+  // GoBoardRegion objects are never in scoring mode after they were loaded
+  // from the NSCoding archive. This puts them into scoring mode, which
+  // rebuilds their scoring caches, but they still retain the territory
+  // information that they loaded from the archive. Because of this it's
+  // important that uninitializeRegions() resets the territory information.
   [self initializeRegionsRetainTerritory:true];
 
-  // If GoBoardRegion objects are already in scoring mode, the GTP engine
-  // must not be asked for dead stones. If GoBoardRegion objects are not in
-  // scoring mode, we forego asking because that would delay app launch.
+  // If the territory information was loaded from the archive, the GTP engine
+  // must not be asked for dead stones. If there is no territory information,
+  // we forego asking because that would delay app launch.
   self.didAskGtpEngineForDeadStones = true;
+  // Same for seki, the stone group states loaded from the archive may contain
+  // manual marks that must not be overridden
+  self.didMarkStoneGroupsInSeki = true;
 
   // Make sure that this object does not contain outdated information.
-  [self doCalculate];
+  [self doCalculate:[NSNumber numberWithInt:self.calculationGeneration]];
 
   // No need to post notification. Clients already know whether or not scoring
   // mode is enabled because they obtained this information from
@@ -234,6 +302,10 @@
 // -----------------------------------------------------------------------------
 - (void) disableScoringOnAppLaunch
 {
+  // GoBoardRegion objects are not in scoring mode after they were loaded from
+  // the NSCoding archive, so this only resets territory information that may
+  // have been archived while scoring mode was enabled. There is no cache to
+  // forget, and the cache is not built until scoring mode is enabled.
   [self uninitializeRegions];
 
   // No need to post notification. Clients already know whether or not scoring
@@ -247,6 +319,11 @@
 // -----------------------------------------------------------------------------
 - (void) initializeRegionsRetainTerritory:(bool)retainTerritory
 {
+  // The regions may have changed, so the next calculation must be a full one
+  self.regionsToUpdate = nil;
+  self.territoryMap = nil;
+  [self abortDeadStonesQuery];
+
   NSArray* allRegions = self.game.board.regions;
   DDLogVerbose(@"%@: initializing GoBoardRegion objects, number of regions = %lu", self, (unsigned long)allRegions.count);
   for (GoBoardRegion* region in allRegions)
@@ -264,6 +341,10 @@
 // -----------------------------------------------------------------------------
 - (void) uninitializeRegions
 {
+  self.regionsToUpdate = nil;
+  self.territoryMap = nil;
+  [self abortDeadStonesQuery];
+
   NSArray* allRegions = self.game.board.regions;
   DDLogVerbose(@"%@: uninitializing GoBoardRegion objects, number of regions = %lu", self, (unsigned long)allRegions.count);
   for (GoBoardRegion* region in allRegions)
@@ -322,6 +403,7 @@
     return;
   [self initializeRegionsRetainTerritory:false];
   self.didAskGtpEngineForDeadStones = false;
+  self.didMarkStoneGroupsInSeki = false;
 }
 
 // -----------------------------------------------------------------------------
@@ -335,8 +417,17 @@
 /// are posted on the application's default NSNotificationCentre in the context
 /// of the main thread.
 ///
-/// @note This method does nothing if a scoring operation is already in
-/// progress.
+/// Each invocation of this method increments @e calculationGeneration. If a
+/// scoring operation is already in progress, this method does not start a new
+/// one but returns immediately, regardless of the value of @a waitUntilDone.
+/// The scoring operation in progress cannot be interrupted because it modifies
+/// GoBoardRegion objects, but when it ends it notices that a newer calculation
+/// has been requested, and it immediately calculates again against the latest
+/// state. Any number of requests that arrive in the meantime are merged into
+/// this one calculation. #goScoreCalculationEnds is posted only after the
+/// newest request has been satisfied.
+///
+/// This method must be invoked in the context of the main thread.
 // -----------------------------------------------------------------------------
 - (void) calculateWaitUntilDone:(bool)waitUntilDone
 {
@@ -345,22 +436,65 @@
                waitUntilDone,
                self.scoringInProgress,
                self.game);
+  self.calculationGeneration++;
   if (self.scoringInProgress)
+  {
+    DDLogVerbose(@"%@: calculation generation %d supersedes the calculation in progress", self, self.calculationGeneration);
     return;
+  }
   self.scoringInProgress = true;  // notify while we're still in the main thread context
 
+  [self startCalculationWaitUntilDone:waitUntilDone];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for calculateWaitUntilDone:() and
+/// calculationDidEnd:(). Starts a calculation for the current value of
+/// @e calculationGeneration. Is invoked in the context of the main thread.
+// -----------------------------------------------------------------------------
+- (void) startCalculationWaitUntilDone:(bool)waitUntilDone
+{
+  NSNumber* generation = [NSNumber numberWithInt:self.calculationGeneration];
   if (waitUntilDone)
-    [self doCalculate];
+    [self doCalculate:generation];
   else
   {
     NSInvocationOperation* operation = [[NSInvocationOperation alloc] initWithTarget:self
-                                                                            selector:@selector(doCalculate)
-                                                                              object:nil];
+                                                                            selector:@selector(doCalculate:)
+                                                                              object:generation];
     [self.operationQueue addOperation:operation];
     [operation release];
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for doCalculate:(). Is invoked in the context of the
+/// main thread when the calculation for @a generation has ended.
+///
+/// Starts another calculation if a newer one was requested, or if the GTP
+/// engine's dead stones have arrived, while the calculation for @a generation
+/// was in progress. Otherwise ends the scoring operation.
+// -----------------------------------------------------------------------------
+- (void) calculationDidEnd:(NSNumber*)generation
+{
+  self.resultGeneration = [generation intValue];
+  if (self.pendingDeadStonesResponse)
+  {
+    // The dead stones arrived while the calculation was in progress. They
+    // require another calculation.
+    [self applyDeadStonesResponse:self.pendingDeadStonesResponse];
+    self.pendingDeadStonesResponse = nil;
+    self.calculationGeneration++;
+  }
+  if (self.resultGeneration != self.calculationGeneration)
+  {
+    DDLogVerbose(@"%@: calculation generation %d was superseded by generation %d, calculating again", self, self.resultGeneration, self.calculationGeneration);
+    [self startCalculationWaitUntilDone:false];
+    return;
+  }
+  self.scoringInProgress = false;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Calculates a new score.
 ///
@@ -368,31 +502,93 @@
 /// was invoked with value @e true for the @e waitUntilDone argument. If the
 /// argument value was @e false, though, this method runs in the context of a
 /// secondary thread.
+///
+/// The territory color and the area, territory and dead stone counts are
+/// updated incrementally if possible. See the class documentation, section
+/// "Incremental scoring".
+///
+/// @a generation is the value of @e calculationGeneration for which the
+/// calculation is made.
 // -----------------------------------------------------------------------------
-- (void) doCalculate
+- (void) doCalculate:(NSNumber*)generation
 {
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryGoModel];
+  os_signpost_id_t signpostID = os_signpost_id_make_with_pointer(signpostLog, self);
+  os_signpost_interval_begin(signpostLog, signpostID, "GoScoreCalculation", "generation %d", [generation intValue]);
   @try
   {
     self.lastCalculationHadError = false;
+    // Must be obtained before resetValues() discards the counts
+    struct GoScoreRegionContribution previousContribution = [self contributionOfScoringProperties];
     [self resetValues];
 
     if ([ApplicationDelegate sharedDelegate].uiSettingsModel.uiAreaPlayMode == UIAreaPlayModeScoring)
     {
       [self askGtpEngineForDeadStones];
-      bool success = [self updateTerritoryColor];
-      DDLogVerbose(@"%@: updateTerritoryColor returned with result = %d", self, success);
+      if ([self markStoneGroupsInSeki])
+        self.regionsToUpdate = nil;
+
+      bool isIncrementalCalculation = (self.regionsToUpdate != nil);
+      bool success;
+      if (isIncrementalCalculation)
+        success = [self updateTerritoryColorOfRegions:self.regionsToUpdate];
+      else
+        success = [self updateTerritoryColor];
+      DDLogVerbose(@"%@: updating territory color returned with result = %d, incremental = %d", self, success, isIncrementalCalculation);
       if (! success)
       {
+        self.regionsToUpdate = nil;
+        self.territoryMap = nil;
         self.lastCalculationHadError = true;
         return;
       }
+
+      struct GoScoreRegionContribution contribution;
+      if (isIncrementalCalculation)
+      {
+        struct GoScoreRegionContribution oldContribution = self.contributionOfRegionsToUpdate;
+        struct GoScoreRegionContribution newContribution = [self contributionOfRegions:self.regionsToUpdate];
+        contribution.territoryBlack = previousContribution.territoryBlack - oldContribution.territoryBlack + newContribution.territoryBlack;
+        contribution.territoryWhite = previousContribution.territoryWhite - oldContribution.territoryWhite + newContribution.territoryWhite;
+        contribution.aliveBlack = previousContribution.aliveBlack - oldContribution.aliveBlack + newContribution.aliveBlack;
+        contribution.aliveWhite = previousContribution.aliveWhite - oldContribution.aliveWhite + newContribution.aliveWhite;
+        contribution.deadBlack = previousContribution.deadBlack - oldContribution.deadBlack + newContribution.deadBlack;
+        contribution.deadWhite = previousContribution.deadWhite - oldContribution.deadWhite + newContribution.deadWhite;
+      }
+      else
+      {
+        contribution = [self contributionOfRegions:self.game.board.regions];
+      }
+      self.territoryBlack = contribution.territoryBlack;
+      self.territoryWhite = contribution.territoryWhite;
+      self.aliveBlack = contribution.aliveBlack;
+      self.aliveWhite = contribution.aliveWhite;
+      self.deadBlack = contribution.deadBlack;
+      self.deadWhite = contribution.deadWhite;
+
+      // The counts are now up-to-date, so from now on toggle operations can
+      // record the regions they affect
+      self.regionsToUpdate = [NSMutableArray arrayWithCapacity:0];
+      self.contributionOfRegionsToUpdate = (struct GoScoreRegionContribution){0};
     }
 
     [self updateScoringProperties];
   }
   @finally
   {
-    self.scoringInProgress = false;
+    os_signpost_interval_end(signpostLog, signpostID, "GoScoreCalculation");
+
+    if ([NSThread isMainThread])
+    {
+      [self calculationDidEnd:generation];
+    }
+    else
+    {
+      [self performSelector:@selector(calculationDidEnd:)
+                   onThread:[NSThread mainThread]
+                 withObject:generation
+              waitUntilDone:YES];
+    }
   }
 }
 
@@ -467,8 +663,13 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Queries the GTP engine for an initial set of dead stones. Updates
-/// GoBoardRegion objects with the result of the query.
+/// @brief Queries the GTP engine for an initial set of dead stones. Does not
+/// wait for the GTP engine's response.
+///
+/// The score calculation that invokes this method continues with the stone
+/// group states as they are, so that a geometric score can be displayed
+/// immediately. When the response arrives, deadStonesQuery:didReceiveResponse:()
+/// updates GoBoardRegion objects and triggers another calculation.
 // -----------------------------------------------------------------------------
 - (void) askGtpEngineForDeadStones
 {
@@ -478,49 +679,168 @@
     return;
   self.didAskGtpEngineForDeadStones = true;
 
-  @try
+  self.askGtpEngineForDeadStonesInProgress = true;
+  [self performSelector:@selector(postNotificationOnMainThread:)
+               onThread:[NSThread mainThread]
+             withObject:askGtpEngineForDeadStonesStarts
+          waitUntilDone:YES];
+
+  int deadStonesQueryID = self.deadStonesQueryID;
+  NSString* commandString = @"final_status_list dead";
+  GtpCommand* command = [GtpCommand asynchronousCommand:commandString
+                                        completionQueue:nil
+                                      completionHandler:^(GtpResponse* response)
   {
-    self.askGtpEngineForDeadStonesInProgress = true;
-    [self performSelector:@selector(postNotificationOnMainThread:)
-                 onThread:[NSThread mainThread]
-               withObject:askGtpEngineForDeadStonesStarts
-            waitUntilDone:YES];
-    GtpCommand* command = [GtpCommand command:@"final_status_list dead"];
-    [command submit];
-    if (command.response.status)
-    {
-      NSArray* deadStoneVertexList = [self parseDeadStoneGtpResponse:command.response.parsedResponse];
-      for (NSString* vertex in deadStoneVertexList)
-      {
-        GoPoint* point = [self.game.board pointAtVertex:vertex];
-        if (! [point hasStone])
-        {
-          DDLogError(@"%@: GTP engine reports vertex %@ is dead stone, but point %@ has no stone", self, vertex, point);
-          assert(0);
-          continue;
-        }
-        // TODO The next statement is problematic in two respects: 1) If the
-        // region has more than one point, we repeatedly set it to be dead,
-        // once for each vertex reported by the GTP engine. 2) We don't perform
-        // any kind of check if the vertex list reported by the GTP engine
-        // matches our regions.
-        point.region.stoneGroupState = GoStoneGroupStateDead;
-      }
-    }
-    else
+    [self deadStonesQuery:deadStonesQueryID didReceiveResponse:response];
+  }];
+  [GtpUtilities setupResponseCachingForCommand:command
+                                          game:self.game];
+  [command submit];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked in the context of the main thread when @a response to the
+/// dead stones query identified by @a deadStonesQueryID has been received.
+///
+/// The response is discarded if the query was aborted in the meantime (see
+/// abortDeadStonesQuery()). If a score calculation is currently in progress,
+/// the response is kept until the calculation has ended, because the
+/// calculation works on the same GoBoardRegion objects that the response
+/// modifies.
+// -----------------------------------------------------------------------------
+- (void) deadStonesQuery:(int)deadStonesQueryID didReceiveResponse:(GtpResponse*)response
+{
+  if (deadStonesQueryID != self.deadStonesQueryID)
+  {
+    DDLogVerbose(@"%@: Discarding response to aborted query for initial set of dead stones", self);
+    return;
+  }
+  self.askGtpEngineForDeadStonesInProgress = false;
+  [self postNotificationOnMainThread:askGtpEngineForDeadStonesEnds];
+
+  // The game may have been replaced while the GTP engine was busy
+  if ([GoGame sharedGame].score != self)
+    return;
+
+  if (! response.status)
+  {
+    DDLogError(@"%@: Querying GTP engine for initial set of dead stones failed", self);
+    assert(0);
+    return;
+  }
+
+  if (self.scoringInProgress)
+  {
+    self.pendingDeadStonesResponse = response;
+    return;
+  }
+
+  [self applyDeadStonesResponse:response];
+  [self calculateWaitUntilDone:false];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates GoBoardRegion objects with the initial set of dead stones in
+/// @a response. Is invoked in the context of the main thread when no score
+/// calculation is in progress.
+// -----------------------------------------------------------------------------
+- (void) applyDeadStonesResponse:(GtpResponse*)response
+{
+  struct GoVertexNumeric deadStoneVertexes[GoBoardSizeMax * GoBoardSizeMax];
+  int numberOfDeadStoneVertexes;
+  bool success = [response parseVertexListWithMaximumNumberOfVertexes:GoBoardSizeMax * GoBoardSizeMax
+                                                              vertexes:deadStoneVertexes
+                                                      numberOfVertexes:&numberOfDeadStoneVertexes];
+  if (! success)
+  {
+    DDLogError(@"%@: GTP response for initial set of dead stones does not have the expected format", self);
+    assert(0);
+    numberOfDeadStoneVertexes = 0;
+  }
+
+  // The GTP engine may mark any stone group as dead
+  self.regionsToUpdate = nil;
+
+  // The user has not marked anything yet (otherwise the query would have been
+  // aborted), so all stone groups in seki were marked by
+  // markStoneGroupsInSeki(). Their seki may no longer exist when the GTP
+  // engine's dead stones are taken into account.
+  for (GoBoardRegion* region in self.game.board.regions)
+  {
+    if (region.stoneGroupState == GoStoneGroupStateSeki)
+      region.stoneGroupState = GoStoneGroupStateAlive;
+  }
+
+  for (int indexOfVertex = 0; indexOfVertex < numberOfDeadStoneVertexes; indexOfVertex++)
+  {
+    GoPoint* point = [self.game.board pointAtNumericVertex:deadStoneVertexes[indexOfVertex]];
+    if (! [point hasStone])
     {
-      DDLogError(@"%@: Querying GTP engine for initial set of dead stones failed", self);
+      DDLogError(@"%@: GTP engine reports vertex %d/%d is dead stone, but point %@ has no stone", self, deadStoneVertexes[indexOfVertex].x, deadStoneVertexes[indexOfVertex].y, point);
       assert(0);
+      continue;
     }
+    // TODO The next statement is problematic in two respects: 1) If the
+    // region has more than one point, we repeatedly set it to be dead,
+    // once for each vertex reported by the GTP engine. 2) We don't perform
+    // any kind of check if the vertex list reported by the GTP engine
+    // matches our regions.
+    point.region.stoneGroupState = GoStoneGroupStateDead;
   }
-  @finally
+
+  // The seki analysis must be repeated with the GTP engine's dead stones
+  self.didMarkStoneGroupsInSeki = false;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Marks the stone groups that GoBoard::stonesInSeki() finds to be in
+/// seki as being in seki. Returns true if the state of at least one stone
+/// group was changed, false if not. Is invoked in the context of a score
+/// calculation.
+///
+/// Only stone groups that are currently alive are marked, stone groups that
+/// are dead (e.g. because the GTP engine says so) are left alone. This method
+/// does nothing if it has already been invoked for the current scoring
+/// session, so that the user's manual marks are never overridden.
+// -----------------------------------------------------------------------------
+- (bool) markStoneGroupsInSeki
+{
+  if (self.didMarkStoneGroupsInSeki)
+    return false;
+  self.didMarkStoneGroupsInSeki = true;
+
+  bool stoneGroupStateDidChange = false;
+  for (GoPoint* point in [self.game.board stonesInSeki])
   {
-    self.askGtpEngineForDeadStonesInProgress = false;
-    [self performSelector:@selector(postNotificationOnMainThread:)
-                 onThread:[NSThread mainThread]
-               withObject:askGtpEngineForDeadStonesEnds
-            waitUntilDone:YES];
+    GoBoardRegion* stoneGroup = point.region;
+    if (stoneGroup.stoneGroupState != GoStoneGroupStateAlive)
+      continue;
+    stoneGroup.stoneGroupState = GoStoneGroupStateSeki;
+    stoneGroupStateDidChange = true;
   }
+  DDLogVerbose(@"%@: seki analysis changed stone group states = %d", self, stoneGroupStateDidChange);
+  return stoneGroupStateDidChange;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Aborts the dead stones query that is currently in progress, if
+/// there is one. The GTP engine's response will be discarded when it arrives.
+/// Is invoked in the context of the main thread.
+///
+/// This is invoked when the user starts marking stone groups manually, and
+/// when the GoBoardRegion objects that the response refers to are no longer
+/// valid.
+// -----------------------------------------------------------------------------
+- (void) abortDeadStonesQuery
+{
+  self.pendingDeadStonesResponse = nil;
+  if (! self.askGtpEngineForDeadStonesInProgress)
+    return;
+
+  DDLogVerbose(@"%@: Aborting query for initial set of dead stones", self);
+  self.deadStonesQueryID++;
+  self.askGtpEngineForDeadStonesInProgress = false;
+  [self postNotificationOnMainThread:askGtpEngineForDeadStonesEnds];
 }
 
 // -----------------------------------------------------------------------------
@@ -580,32 +900,6 @@
   [[NSNotificationCenter defaultCenter] postNotificationName:notificationName object:nil];
 }
 
-// -----------------------------------------------------------------------------
-/// @brief Parses @a gtpResponse, which is expected to be the response to the
-/// command "final_status_list dead", for strings that denote vertexes. Returns
-/// a list with all vertexes found.
-// -----------------------------------------------------------------------------
-- (NSArray*) parseDeadStoneGtpResponse:(NSString*)gtpResponse
-{
-  NSMutableArray* deadStoneVertexList = [NSMutableArray arrayWithCapacity:0];
-  if (0 == gtpResponse.length)
-    return deadStoneVertexList;
-  NSArray* responseLines = [gtpResponse componentsSeparatedByString:@"\n"];
-  for (NSString* responseLine in responseLines)
-  {
-    if (0 == responseLine.length)
-      continue;
-    NSArray* vertexList = [responseLine componentsSeparatedByString:@" "];
-    for (NSString* vertex in vertexList)
-    {
-      if (0 == vertex.length)
-        continue;
-      [deadStoneVertexList addObject:vertex];
-    }
-  }
-  return deadStoneVertexList;
-}
-
 // -----------------------------------------------------------------------------
 /// @brief Toggles the status of the stone group @a stoneGroup from alive to
 /// dead, or vice versa. If @a stoneGroup is in seki, its status is changed to
@@ -634,6 +928,10 @@
   if (! [stoneGroup isStoneGroup])
     return;
 
+  // The user has started to mark stones manually, the GTP engine's opinion
+  // is no longer wanted
+  [self abortDeadStonesQuery];
+
   bool markDeadStonesIntelligently = [ApplicationDelegate sharedDelegate].scoringModel.markDeadStonesIntelligently;
 
   // We use this array like a queue: We add GoBoardRegion objects to it that
@@ -672,6 +970,7 @@
         assert(0);
         continue;
     }
+    [self addRegionsAffectedByTogglingStoneGroup:stoneGroupToToggle];
     stoneGroupToToggle.stoneGroupState = newStoneGroupState;
     enum GoColor colorOfStoneGroupToToggle = [stoneGroupToToggle color];
 
@@ -748,6 +1047,7 @@
     return;
   if (! [stoneGroup isStoneGroup])
     return;
+  [self abortDeadStonesQuery];
   enum GoStoneGroupState newStoneGroupState;
   switch (stoneGroup.stoneGroupState)
   {
@@ -765,6 +1065,7 @@
       assert(0);
       return;
   }
+  [self addRegionsAffectedByTogglingStoneGroup:stoneGroup];
   stoneGroup.stoneGroupState = newStoneGroupState;
 }
 
@@ -781,9 +1082,25 @@
 /// more dead stones, or turn them back to alive.
 // -----------------------------------------------------------------------------
 - (bool) updateTerritoryColor
+{
+  return [self updateTerritoryColorOfRegions:self.game.board.regions];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief (Re)Calculates the territory color of the GoBoardRegion objects in
+/// @a regions. Returns true if calculation was successful, false if not.
+/// Updates the @e territoryMap property as a side-effect.
+///
+/// The territory of the entire board is calculated by GoBoard's territory
+/// kernel, which is cheap because it works on bitsets. Only the GoBoardRegion
+/// objects in @a regions are updated with the result, though. The caller is
+/// responsible for passing all regions whose territory color may have changed.
+/// See the class documentation, section "Incremental scoring".
+// -----------------------------------------------------------------------------
+- (bool) updateTerritoryColorOfRegions:(NSArray*)regions
 {
   // Preliminary sanity check. The fact that only two scoring systems can occur
-  // makes some of the logic further down a lot simpler.
+  // makes the logic in the territory kernel a lot simpler.
   enum GoScoringSystem scoringSystem = self.game.rules.scoringSystem;
   if (GoScoringSystemAreaScoring != scoringSystem &&
       GoScoringSystemTerritoryScoring != scoringSystem)
@@ -792,230 +1109,20 @@
     return false;
   }
 
-  // Regions that are truly empty, i.e. that do not have dead stones
-  NSMutableArray* emptyRegions = [NSMutableArray arrayWithCapacity:0];
-
-  // Pass 1: Set territory colors for stone groups. This is easy and can be
-  // done both for groups that are alive and dead. While we are at it, we can
-  // also collect empty regions, which will be processed in pass 2.
-  NSArray* allRegions = self.game.board.regions;
-  for (GoBoardRegion* region in allRegions)
-  {
-    if (! [region isStoneGroup])
-    {
-      // Setting territory color here is temporary, the final color will be
-      // determined in pass 2. We still need to do it, though, to erase traces
-      // from a previous scoring calculation.
-      region.territoryColor = GoColorNone;
-      [emptyRegions addObject:region];
-    }
-    else
-    {
-      switch (region.stoneGroupState)
-      {
-        case GoStoneGroupStateAlive:
-        {
-          // If the group is alive, it belongs to the territory of the color who
-          // played the stones in the group. This is important only for area
-          // scoring.
-          region.territoryColor = [region color];
-          break;
-        }
-        case GoStoneGroupStateDead:
-        {
-          // If the group is dead, it belongs to the territory of the opposing
-          // color
-          switch ([region color])
-          {
-            case GoColorBlack:
-              region.territoryColor = GoColorWhite;
-              break;
-            case GoColorWhite:
-              region.territoryColor = GoColorBlack;
-              break;
-            default:
-              DDLogError(@"%@: Stone groups must be either black or white, region %@ has color %d", self, region, [region color]);
-              return false;
-          }
-          break;
-        }
-        case GoStoneGroupStateSeki:
-        {
-          // If the group is in seki, the scoring system decides the territory
-          // that the group belongs to
-          if (GoScoringSystemAreaScoring == scoringSystem)
-            region.territoryColor = [region color];
-          else
-            region.territoryColor = GoColorNone;
-          break;
-        }
-        default:
-        {
-          DDLogError(@"%@: Unknown stone group state = %d", self, region.stoneGroupState);
-          return false;
-        }
-      }
-    }
-  }
-
-  // Pass 2: Process empty regions. Here we examine the stone groups adjacent
-  // to each empty region to determine the empty region's final territory color.
-  for (GoBoardRegion* emptyRegion in emptyRegions)
+  GoBoard* board = self.game.board;
+  NSData* territoryMap = [board territoryMapWithScoringSystem:scoringSystem];
+  const unsigned char* territoryMapEntries = territoryMap.bytes;
+  for (GoBoardRegion* region in regions)
   {
-    bool aliveSeen = false;
-    bool blackAliveSeen = false;
-    bool whiteAliveSeen = false;
-    bool deadSeen = false;
-    bool blackDeadSeen = false;
-    bool whiteDeadSeen = false;
-    bool sekiSeen = false;
-    bool blackSekiSeen = false;
-    bool whiteSekiSeen = false;
-    for (GoBoardRegion* adjacentRegion in [emptyRegion adjacentRegions])
-    {
-      if (! [adjacentRegion isStoneGroup])
-      {
-        DDLogError(@"%@: Regions adjacent to an empty region can only be stone groups, adjacent region = %@", self, adjacentRegion);
-        return false;
-      }
-
-      // Preliminary sanity check. The fact that only two colors can occur makes
-      // the subsequent logic simpler.
-      enum GoColor adjacentRegionColor = [adjacentRegion color];
-      if (GoColorBlack != adjacentRegionColor && GoColorWhite != adjacentRegionColor)
-      {
-        DDLogError(@"%@: Stone groups must be either black or white, adjacent stone group region %@ has color %d", self, adjacentRegion, adjacentRegionColor);
-        return false;
-      }
-
-      switch (adjacentRegion.stoneGroupState)
-      {
-        case GoStoneGroupStateAlive:
-        {
-          aliveSeen = true;
-          if (GoColorBlack == adjacentRegionColor)
-            blackAliveSeen = true;
-          else
-            whiteAliveSeen = true;
-          break;
-        }
-        case GoStoneGroupStateDead:
-        {
-          deadSeen = true;
-          if (GoColorBlack == adjacentRegionColor)
-            blackDeadSeen = true;
-          else
-            whiteDeadSeen = true;
-          break;
-        }
-        case GoStoneGroupStateSeki:
-        {
-          sekiSeen = true;
-          if (GoColorBlack == adjacentRegionColor)
-            blackSekiSeen = true;
-          else
-            whiteSekiSeen = true;
-          break;
-        }
-        default:
-        {
-          DDLogError(@"%@: Unknown stone group state = %d", self, adjacentRegion.stoneGroupState);
-          return false;
-        }
-      }
-    }
-
-    bool territoryInconsistencyFound = false;
-    enum GoColor territoryColor = GoColorNone;
-    if (! deadSeen)
-    {
-      if (! aliveSeen && ! sekiSeen)
-      {
-        // Ok, empty board, neutral territory
-        territoryColor = GoColorNone;
-      }
-      else if ((blackSekiSeen && blackAliveSeen) || (whiteSekiSeen && whiteAliveSeen))
-      {
-        // Rules violation! Cannot see alive and seki stones of the same
-        // color. In such a position, the seki stones could, theoretically,
-        // be connected to the alive stones. The opposing player therefore
-        // MUST play so that no connection is possible and this position
-        // cannot occur.
-        territoryInconsistencyFound = true;
-      }
-      else if ((blackSekiSeen && whiteAliveSeen) || (whiteSekiSeen && blackAliveSeen))
-      {
-        // Rules violation! Cannot see alive and seki stones of different
-        // colors. In all seki positions and examples that I could find,
-        // seki stones are always completely surrounded, the only liberties
-        // being their own eyes, or liberties shared with seki stones of
-        // the other color. The opposing player therefore MUST play and fill
-        // in all liberties around the seki stones.
-        territoryInconsistencyFound = true;
-      }
-      else if ((blackSekiSeen && whiteSekiSeen) || (blackAliveSeen && whiteAliveSeen))
-      {
-        // Ok, dame, neutral territory
-        territoryColor = GoColorNone;
-      }
-      else if (sekiSeen)
-      {
-        // Ok, only one color has been seen, and all groups were in seki
-        if (GoScoringSystemAreaScoring == scoringSystem)
-        {
-          // Area scoring counts this as territory
-          if (blackSekiSeen)
-            territoryColor = GoColorBlack;
-          else
-            territoryColor = GoColorWhite;
-        }
-        else
-        {
-          // Territory scoring counts this as neutral territory
-          territoryColor = GoColorNone;
-        }
-      }
-      else
-      {
-        // Ok, only one color has been seen, and all groups were alive
-        if (blackAliveSeen)
-          territoryColor = GoColorBlack;
-        else
-          territoryColor = GoColorWhite;
-      }
-    }
-    else
-    {
-      if (sekiSeen)
-      {
-        // Rules violation! Cannot see dead and seki stones at the same time
-        territoryInconsistencyFound = true;
-      }
-      else if (blackDeadSeen && whiteDeadSeen)
-      {
-        // Rules violation! Cannot see dead stones of both colors
-        territoryInconsistencyFound = true;
-      }
-      else if ((blackDeadSeen && blackAliveSeen) || (whiteDeadSeen && whiteAliveSeen))
-      {
-        // Rules violation! Cannot see both dead and alive stones of the same
-        // color
-        territoryInconsistencyFound = true;
-      }
-      else
-      {
-        // Ok, only dead stones of one color seen (we don't care whether the
-        // opposing color has alive stones)
-        if (blackDeadSeen)
-          territoryColor = GoColorWhite;
-        else
-          territoryColor = GoColorBlack;
-      }
-    }
-
-    emptyRegion.territoryColor = territoryColor;
-    emptyRegion.territoryInconsistencyFound = territoryInconsistencyFound;
+    // All points of a region have the same territory
+    GoPoint* point = region.points.firstObject;
+    if (! point)
+      continue;
+    unsigned char territoryMapEntry = territoryMapEntries[[board indexOfPoint:point]];
+    region.territoryColor = (enum GoColor)(territoryMapEntry & GoTerritoryMapEntryColorMask);
+    region.territoryInconsistencyFound = (territoryMapEntry & GoTerritoryMapEntryInconsistentFlag) != 0;
   }
+  self.territoryMap = territoryMap;
 
   return true;
 }
@@ -1024,9 +1131,8 @@
 /// @brief (Re)Calculates the scoring and move statistics properties of this
 /// GoScore object.
 ///
-/// If territory scoring is enabled, this method requires that the
-/// @e deadStoneGroup and @e territoryColor properties of GoBoardRegion objects
-/// are correct and up-to-date.
+/// If scoring mode is enabled, this method requires that the area, territory
+/// and dead stone properties have already been updated by doCalculate:().
 // -----------------------------------------------------------------------------
 - (void) updateScoringProperties
 {
@@ -1096,71 +1202,8 @@
     node = node.parent;
   }
 
-  // Area, territory & dead stones (for current board position)
-  if ([ApplicationDelegate sharedDelegate].uiSettingsModel.uiAreaPlayMode == UIAreaPlayModeScoring)
-  {
-    NSArray* allRegions = self.game.board.regions;
-    for (GoBoardRegion* region in allRegions)
-    {
-      int regionSize = [region size];
-      bool regionIsStoneGroup = [region isStoneGroup];
-      enum GoStoneGroupState stoneGroupState = region.stoneGroupState;
-      bool regionIsDeadStoneGroup = (GoStoneGroupStateDead == stoneGroupState);
-      enum GoColor regionTerritoryColor = region.territoryColor;
-
-      // Territory: We count dead stones and intersections in empty regions. An
-      // empty region could be an eye in seki, which only counts when area
-      // scoring is in effect. We don't have to check the scoring system,
-      // though, this was already done when the empty region's territory color
-      // was determined.
-      if (regionIsDeadStoneGroup || ! regionIsStoneGroup)
-      {
-        switch (regionTerritoryColor)
-        {
-          case GoColorBlack:
-            self.territoryBlack += regionSize;
-            break;
-          case GoColorWhite:
-            self.territoryWhite += regionSize;
-            break;
-          default:
-            break;
-        }
-      }
-
-      // Alive stones + stones in seki
-      if (regionIsStoneGroup && ! regionIsDeadStoneGroup)
-      {
-        switch (regionTerritoryColor)
-        {
-          case GoColorBlack:
-            self.aliveBlack += regionSize;
-            break;
-          case GoColorWhite:
-            self.aliveWhite += regionSize;
-            break;
-          default:
-            break;
-        }
-      }
-
-      // Dead stones
-      if (regionIsDeadStoneGroup)
-      {
-        switch ([region color])
-        {
-          case GoColorBlack:
-            self.deadBlack += regionSize;
-            break;
-          case GoColorWhite:
-            self.deadWhite += regionSize;
-            break;
-          default:
-            break;
-        }
-      }
-    }
-  }
+  // Area, territory & dead stones (for current board position) were already
+  // updated by doCalculate:()
 
   // Handicap
   // Cast is required because NSUInteger and int differ in size in 64-bit.
@@ -1202,6 +1245,135 @@
     self.result = GoGameResultTie;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the area, territory and dead stone counts that the
+/// GoBoardRegion objects in @a regions contribute to the score.
+///
+/// This method requires that the @e stoneGroupState and @e territoryColor
+/// properties of the GoBoardRegion objects are correct and up-to-date.
+// -----------------------------------------------------------------------------
+- (struct GoScoreRegionContribution) contributionOfRegions:(NSArray*)regions
+{
+  struct GoScoreRegionContribution contribution = {0};
+  for (GoBoardRegion* region in regions)
+  {
+    int regionSize = [region size];
+    bool regionIsStoneGroup = [region isStoneGroup];
+    enum GoStoneGroupState stoneGroupState = region.stoneGroupState;
+    bool regionIsDeadStoneGroup = (GoStoneGroupStateDead == stoneGroupState);
+    enum GoColor regionTerritoryColor = region.territoryColor;
+
+    // Territory: We count dead stones and intersections in empty regions. An
+    // empty region could be an eye in seki, which only counts when area
+    // scoring is in effect. We don't have to check the scoring system,
+    // though, this was already done when the empty region's territory color
+    // was determined.
+    if (regionIsDeadStoneGroup || ! regionIsStoneGroup)
+    {
+      switch (regionTerritoryColor)
+      {
+        case GoColorBlack:
+          contribution.territoryBlack += regionSize;
+          break;
+        case GoColorWhite:
+          contribution.territoryWhite += regionSize;
+          break;
+        default:
+          break;
+      }
+    }
+
+    // Alive stones + stones in seki
+    if (regionIsStoneGroup && ! regionIsDeadStoneGroup)
+    {
+      switch (regionTerritoryColor)
+      {
+        case GoColorBlack:
+          contribution.aliveBlack += regionSize;
+          break;
+        case GoColorWhite:
+          contribution.aliveWhite += regionSize;
+          break;
+        default:
+          break;
+      }
+    }
+
+    // Dead stones
+    if (regionIsDeadStoneGroup)
+    {
+      switch ([region color])
+      {
+        case GoColorBlack:
+          contribution.deadBlack += regionSize;
+          break;
+        case GoColorWhite:
+          contribution.deadWhite += regionSize;
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  return contribution;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the area, territory and dead stone counts that are currently
+/// stored in the scoring properties of this GoScore object.
+// -----------------------------------------------------------------------------
+- (struct GoScoreRegionContribution) contributionOfScoringProperties
+{
+  struct GoScoreRegionContribution contribution;
+  contribution.territoryBlack = self.territoryBlack;
+  contribution.territoryWhite = self.territoryWhite;
+  contribution.aliveBlack = self.aliveBlack;
+  contribution.aliveWhite = self.aliveWhite;
+  contribution.deadBlack = self.deadBlack;
+  contribution.deadWhite = self.deadWhite;
+  return contribution;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for toggleDeadStateOfStoneGroup:() and
+/// toggleSekiStateOfStoneGroup:(). Records @a stoneGroup and its adjacent
+/// empty regions as regions whose territory color must be updated by the next
+/// calculation, together with the contribution that they currently make to the
+/// score. Must be invoked before the state of @a stoneGroup is changed.
+///
+/// Does nothing if the next calculation is a full calculation anyway.
+// -----------------------------------------------------------------------------
+- (void) addRegionsAffectedByTogglingStoneGroup:(GoBoardRegion*)stoneGroup
+{
+  if (! self.regionsToUpdate)
+    return;
+
+  NSMutableArray* newRegionsToUpdate = [NSMutableArray arrayWithCapacity:0];
+  if (! [self.regionsToUpdate containsObject:stoneGroup])
+    [newRegionsToUpdate addObject:stoneGroup];
+  for (GoBoardRegion* adjacentRegion in [stoneGroup adjacentRegions])
+  {
+    if ([adjacentRegion isStoneGroup])
+      continue;
+    if ([self.regionsToUpdate containsObject:adjacentRegion])
+      continue;
+    [newRegionsToUpdate addObject:adjacentRegion];
+  }
+  if (newRegionsToUpdate.count == 0)
+    return;
+
+  struct GoScoreRegionContribution contribution = self.contributionOfRegionsToUpdate;
+  struct GoScoreRegionContribution additionalContribution = [self contributionOfRegions:newRegionsToUpdate];
+  contribution.territoryBlack += additionalContribution.territoryBlack;
+  contribution.territoryWhite += additionalContribution.territoryWhite;
+  contribution.aliveBlack += additionalContribution.aliveBlack;
+  contribution.aliveWhite += additionalContribution.aliveWhite;
+  contribution.deadBlack += additionalContribution.deadBlack;
+  contribution.deadWhite += additionalContribution.deadWhite;
+  self.contributionOfRegionsToUpdate = contribution;
+  [self.regionsToUpdate addObjectsFromArray:newRegionsToUpdate];
+}
+
 
 // -----------------------------------------------------------------------------
 /// @brief NSCoding protocol method.
@@ -0,0 +1,65 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoScoreEstimator class calculates a cheap estimate of the score
+/// for the current board position while the game is being played, i.e. when
+/// scoring mode is not enabled.
+///
+/// @ingroup go
+///
+/// The estimate is a geometric area count: All stones on the board are deemed
+/// alive, and an empty area counts as territory only if it borders on stones
+/// of a single color. Komi and, under area scoring, handicap compensation are
+/// taken into account. Captured stones are not counted, so under territory
+/// scoring the estimate is less accurate.
+///
+/// updateEstimateForGame:completionHandler:() takes a snapshot of the game
+/// (see GoGame::snapshotAtCurrentNode()) in the context of the main thread,
+/// which is cheap enough to be done after every move. The actual calculation
+/// is made on a background queue with the territory kernel of GoBoardCore, so
+/// that it never delays move entry. If a new estimate is requested before an
+/// earlier one has been calculated, the earlier one is superseded.
+///
+/// GoScoreEstimator must be used from the main thread only.
+// -----------------------------------------------------------------------------
+@interface GoScoreEstimator : NSObject
+{
+}
+
+- (id) init;
+- (void) updateEstimateForGame:(GoGame*)game completionHandler:(void (^)(void))completionHandler;
++ (double) blackLeadForStoneStates:(NSData*)stoneStates
+                         boardSize:(enum GoBoardSize)boardSize
+                              komi:(double)komi
+                          handicap:(int)handicap
+                     scoringSystem:(enum GoScoringSystem)scoringSystem;
+
+/// @brief True if an estimate is available, false if not.
+@property(nonatomic, assign, readonly) bool estimateIsAvailable;
+/// @brief The number of points by which black leads according to the estimate.
+/// The value is negative if white leads.
+@property(nonatomic, assign, readonly) double blackLead;
+/// @brief The estimate in a format that can be displayed to the user, e.g.
+/// "B+3.5". Is nil if no estimate is available.
+@property(nonatomic, retain, readonly) NSString* estimateString;
+
+@end
@@ -0,0 +1,183 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoScoreEstimator.h"
+#import "GoBoardCore.h"
+#import "GoGame.h"
+#import "GoGameSnapshot.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoScoreEstimator.
+// -----------------------------------------------------------------------------
+@interface GoScoreEstimator()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) bool estimateIsAvailable;
+@property(nonatomic, assign, readwrite) double blackLead;
+//@}
+/// @brief Serial queue on which estimates are calculated.
+@property(nonatomic, retain) NSOperationQueue* operationQueue;
+/// @brief Is incremented for each requested estimate. An estimate is published
+/// only if no newer estimate has been requested in the meantime.
+@property(nonatomic, assign) int estimateGeneration;
+@end
+
+
+@implementation GoScoreEstimator
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoScoreEstimator object. No estimate is available
+/// until updateEstimateForGame:completionHandler:() is invoked.
+///
+/// @note This is the designated initializer of GoScoreEstimator.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.estimateIsAvailable = false;
+  self.blackLead = 0;
+  self.estimateGeneration = 0;
+  self.operationQueue = [[[NSOperationQueue alloc] init] autorelease];
+  self.operationQueue.maxConcurrentOperationCount = 1;
+  self.operationQueue.qualityOfService = NSQualityOfServiceUtility;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoScoreEstimator object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self.operationQueue cancelAllOperations];
+  self.operationQueue = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Starts calculating a new estimate for the current board position of
+/// @a game. Invokes @a completionHandler in the context of the main thread
+/// when the estimate is available. @a completionHandler is not invoked if the
+/// estimate is superseded by a newer one.
+// -----------------------------------------------------------------------------
+- (void) updateEstimateForGame:(GoGame*)game completionHandler:(void (^)(void))completionHandler
+{
+  self.estimateGeneration++;
+  int estimateGeneration = self.estimateGeneration;
+
+  // Take the snapshot while we are still in the main thread. The background
+  // queue must not access the Go model.
+  GoGameSnapshot* snapshot = [game snapshotAtCurrentNode];
+
+  // Estimates that have not started yet are obsolete
+  [self.operationQueue cancelAllOperations];
+  [self.operationQueue addOperationWithBlock:^(void)
+  {
+    double blackLead = [GoScoreEstimator blackLeadForSnapshot:snapshot];
+    dispatch_async(dispatch_get_main_queue(), ^(void)
+    {
+      if (estimateGeneration != self.estimateGeneration)
+        return;
+      self.blackLead = blackLead;
+      self.estimateIsAvailable = true;
+      completionHandler();
+    });
+  }];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSString*) estimateString
+{
+  if (! self.estimateIsAvailable)
+    return nil;
+  if (self.blackLead > 0)
+    return [NSString stringWithFormat:@"B+%.1f", self.blackLead];
+  else if (self.blackLead < 0)
+    return [NSString stringWithFormat:@"W+%.1f", -self.blackLead];
+  else
+    return @"Jigo";
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of points by which black leads on a board of size
+/// @a boardSize whose stones are described by @a stoneStates, in the format of
+/// a board snapshot (see GoBoard::stoneStateSnapshot()). The value is negative
+/// if white leads.
+///
+/// This method does not access the Go model and can therefore be invoked in
+/// the context of any thread.
+// -----------------------------------------------------------------------------
++ (double) blackLeadForStoneStates:(NSData*)stoneStates
+                         boardSize:(enum GoBoardSize)boardSize
+                              komi:(double)komi
+                          handicap:(int)handicap
+                     scoringSystem:(enum GoScoringSystem)scoringSystem
+{
+  double handicapCompensationWhite = 0;
+  if (GoScoringSystemAreaScoring == scoringSystem)
+    handicapCompensationWhite = handicap;
+
+  GoBoardCore boardCore(boardSize);
+  int numberOfPoints = boardCore.getNumberOfPoints();
+  const unsigned char* stoneStatesBytes = static_cast<const unsigned char*>(stoneStates.bytes);
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    GoBoardCore::StoneState stoneState = static_cast<GoBoardCore::StoneState>(stoneStatesBytes[index]);
+    if (GoBoardCore::StoneStateNone != stoneState)
+      boardCore.setStoneState(index, stoneState);
+  }
+
+  // All stones are deemed alive. Under area scoring rules the territory
+  // includes the stones.
+  GoBoardCore::PointSet noStones;
+  GoBoardCore::TerritoryResult territoryResult;
+  boardCore.calculateTerritory(noStones, noStones, true, territoryResult);
+
+  double scoreBlack = territoryResult.blackTerritory.count();
+  double scoreWhite = territoryResult.whiteTerritory.count() + komi + handicapCompensationWhite;
+  return scoreBlack - scoreWhite;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of points by which black leads on the board
+/// described by @a snapshot. Is invoked in the context of the background
+/// queue.
+// -----------------------------------------------------------------------------
++ (double) blackLeadForSnapshot:(GoGameSnapshot*)snapshot
+{
+  return [GoScoreEstimator blackLeadForStoneStates:snapshot.stoneStates
+                                         boardSize:snapshot.boardSize
+                                              komi:snapshot.komi
+                                          handicap:snapshot.handicap
+                                     scoringSystem:snapshot.scoringSystem];
+}
+
+@end
@@ -0,0 +1,66 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+@class GoNode;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoSuperkoHistory class keeps track of the Zobrist hashes of the
+/// board positions that superko detection must examine.
+///
+/// @ingroup go
+///
+/// For a given node that contains a move, superko detection must examine the
+/// board positions created by that move and by all preceding moves, up to the
+/// most recent node that contains setup (or up to the root node if there is no
+/// such node). In addition it must examine the board position prior to the
+/// first of those moves. GoSuperkoHistory remembers the Zobrist hashes of these
+/// board positions in hash sets, one for each move color, so that a superko
+/// check becomes a simple hash lookup instead of a walk through the game
+/// variation.
+///
+/// The hash sets always describe the game variation that ends with the node
+/// most recently passed to isSuperko:byColor:koRule:afterNode:(). When a
+/// different node is passed, GoSuperkoHistory updates the hash sets
+/// incrementally:
+/// - If the new node follows the previous node in the same game variation
+///   (i.e. a new move was played, or the board position was advanced), the
+///   moves between the two nodes are added.
+/// - If the new node precedes the previous node in the same game variation
+///   (i.e. nodes were discarded, or the board position was rewound), the moves
+///   after the new node are removed.
+/// - Both cases can occur at the same time, e.g. when the new node is located
+///   in a game variation that branches off from the previous game variation.
+///
+/// GoSuperkoHistory assumes that the Zobrist hash of a node does not change
+/// after GoSuperkoHistory has seen the node. Whoever changes Zobrist hashes
+/// must invoke invalidate().
+// -----------------------------------------------------------------------------
+@interface GoSuperkoHistory : NSObject
+{
+}
+
+- (id) initWithGame:(GoGame*)game;
+- (bool) isSuperko:(long long)zobristHash
+           byColor:(enum GoColor)color
+            koRule:(enum GoKoRule)koRule
+         afterNode:(GoNode*)nodeWithMostRecentMove;
+- (void) invalidate;
+
+@end
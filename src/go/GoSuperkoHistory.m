@@ -0,0 +1,238 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GoSuperkoHistory.h"
+#import "GoGame.h"
+#import "GoMove.h"
+#import "GoNode.h"
+#import "GoPlayer.h"
+#import "GoUtilities.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoSuperkoHistory.
+// -----------------------------------------------------------------------------
+@interface GoSuperkoHistory()
+/// @name Privately declared properties
+//@{
+@property(nonatomic, assign) GoGame* game;
+/// @brief The nodes with moves whose Zobrist hashes are currently in the hash
+/// sets, in the order in which they appear in the game variation.
+@property(nonatomic, retain) NSMutableArray* moveNodes;
+/// @brief The Zobrist hashes of the nodes in @e moveNodes, at the time when
+/// the nodes were added. The hashes are stored so that the exact same values
+/// can be removed from the hash sets later on.
+@property(nonatomic, retain) NSMutableArray* moveNodeHashes;
+/// @brief Same content as @e moveNodes, for fast lookup.
+@property(nonatomic, retain) NSMutableSet* moveNodesSet;
+/// @brief Zobrist hashes of the board positions that resulted from moves made
+/// by black.
+@property(nonatomic, retain) NSCountedSet* hashesBlack;
+/// @brief Zobrist hashes of the board positions that resulted from moves made
+/// by white.
+@property(nonatomic, retain) NSCountedSet* hashesWhite;
+/// @brief The node that contains the board position prior to the first move
+/// in @e moveNodes. Is nil if that board position is the one after handicap.
+@property(nonatomic, retain) GoNode* nodePriorToFirstMove;
+//@}
+@end
+
+
+@implementation GoSuperkoHistory
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoSuperkoHistory object that examines moves made in
+/// @a game.
+///
+/// @note This is the designated initializer of GoSuperkoHistory.
+// -----------------------------------------------------------------------------
+- (id) initWithGame:(GoGame*)game
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.game = game;
+  self.moveNodes = [NSMutableArray arrayWithCapacity:0];
+  self.moveNodeHashes = [NSMutableArray arrayWithCapacity:0];
+  self.moveNodesSet = [NSMutableSet setWithCapacity:0];
+  self.hashesBlack = [NSCountedSet setWithCapacity:0];
+  self.hashesWhite = [NSCountedSet setWithCapacity:0];
+  self.nodePriorToFirstMove = nil;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoSuperkoHistory object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.game = nil;
+  self.moveNodes = nil;
+  self.moveNodeHashes = nil;
+  self.moveNodesSet = nil;
+  self.hashesBlack = nil;
+  self.hashesWhite = nil;
+  self.nodePriorToFirstMove = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a zobristHash matches the Zobrist hash of one of
+/// the board positions that superko detection for a move by @a color after
+/// @a nodeWithMostRecentMove must examine under the ko rule @a koRule. Returns
+/// false if there is no match.
+///
+/// @a nodeWithMostRecentMove must be a node that contains a move.
+/// @a koRule must be either #GoKoRuleSuperkoPositional or
+/// #GoKoRuleSuperkoSituational.
+///
+/// Situational superko only examines board positions that resulted from moves
+/// made by @a color. This includes the board position prior to the first move,
+/// which is regarded as the result of a move made by the opposing color of the
+/// first move. As in Fuego, the color of the first move is taken from the
+/// move as it was actually played.
+// -----------------------------------------------------------------------------
+- (bool) isSuperko:(long long)zobristHash
+           byColor:(enum GoColor)color
+            koRule:(enum GoKoRule)koRule
+         afterNode:(GoNode*)nodeWithMostRecentMove
+{
+  [self updateWithNodeWithMostRecentMove:nodeWithMostRecentMove];
+
+  NSNumber* hash = [NSNumber numberWithLongLong:zobristHash];
+  if (GoKoRuleSuperkoSituational == koRule)
+  {
+    NSCountedSet* hashes = (GoColorBlack == color) ? _hashesBlack : _hashesWhite;
+    if ([hashes containsObject:hash])
+      return true;
+  }
+  else
+  {
+    if ([_hashesBlack containsObject:hash] || [_hashesWhite containsObject:hash])
+      return true;
+  }
+
+  if (GoKoRuleSuperkoSituational == koRule)
+  {
+    GoNode* nodeWithFirstMove = _moveNodes.firstObject;
+    enum GoColor colorOfZobristHashPriorToFirstMove =
+      [GoUtilities alternatingColorForColor:nodeWithFirstMove.goMove.player.color];
+    if (colorOfZobristHashPriorToFirstMove != color)
+      return false;
+  }
+
+  long long zobristHashPriorToFirstMove;
+  if (_nodePriorToFirstMove)
+    zobristHashPriorToFirstMove = _nodePriorToFirstMove.zobristHash;
+  else
+    zobristHashPriorToFirstMove = self.game.zobristHashAfterHandicap;
+  return (zobristHash == zobristHashPriorToFirstMove);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards all Zobrist hashes. The next invocation of
+/// isSuperko:byColor:koRule:afterNode:() rebuilds the hash sets from scratch.
+// -----------------------------------------------------------------------------
+- (void) invalidate
+{
+  [_moveNodes removeAllObjects];
+  [_moveNodeHashes removeAllObjects];
+  [_moveNodesSet removeAllObjects];
+  [_hashesBlack removeAllObjects];
+  [_hashesWhite removeAllObjects];
+  self.nodePriorToFirstMove = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the hash sets so that they describe the game variation that
+/// ends with @a nodeWithMostRecentMove.
+///
+/// This is an internal helper for isSuperko:byColor:koRule:afterNode:().
+// -----------------------------------------------------------------------------
+- (void) updateWithNodeWithMostRecentMove:(GoNode*)nodeWithMostRecentMove
+{
+  if (nodeWithMostRecentMove == _moveNodes.lastObject)
+    return;
+
+  // Walk back from the new node until we find a node that we already know, or
+  // until we reach the beginning of the sequence of moves
+  NSMutableArray* newMoveNodes = [NSMutableArray arrayWithCapacity:0];
+  GoNode* node = nodeWithMostRecentMove;
+  while (node && node.goMove && ! [_moveNodesSet containsObject:node])
+  {
+    [newMoveNodes addObject:node];
+    node = [GoUtilities nodeWithMostRecentBoardStateChange:node.parent];
+  }
+
+  if (node && node.goMove)
+  {
+    // The node is known => remove the nodes that follow it
+    while (_moveNodes.lastObject != node)
+      [self removeLastMoveNode];
+  }
+  else
+  {
+    // The sequence of moves starts anew, either because a setup node was
+    // found, or because the root node was reached
+    [self invalidate];
+    self.nodePriorToFirstMove = node;
+  }
+
+  for (GoNode* newMoveNode in [newMoveNodes reverseObjectEnumerator])
+    [self addMoveNode:newMoveNode];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Adds @a moveNode to the end of the sequence of moves.
+///
+/// This is an internal helper for updateWithNodeWithMostRecentMove:().
+// -----------------------------------------------------------------------------
+- (void) addMoveNode:(GoNode*)moveNode
+{
+  NSNumber* hash = [NSNumber numberWithLongLong:moveNode.zobristHash];
+  [_moveNodes addObject:moveNode];
+  [_moveNodeHashes addObject:hash];
+  [_moveNodesSet addObject:moveNode];
+  if (moveNode.goMove.player.isBlack)
+    [_hashesBlack addObject:hash];
+  else
+    [_hashesWhite addObject:hash];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the last node from the sequence of moves.
+///
+/// This is an internal helper for updateWithNodeWithMostRecentMove:().
+// -----------------------------------------------------------------------------
+- (void) removeLastMoveNode
+{
+  GoNode* moveNode = _moveNodes.lastObject;
+  NSNumber* hash = _moveNodeHashes.lastObject;
+  if (moveNode.goMove.player.isBlack)
+    [_hashesBlack removeObject:hash];
+  else
+    [_hashesWhite removeObject:hash];
+  [_moveNodesSet removeObject:moveNode];
+  [_moveNodeHashes removeLastObject];
+  [_moveNodes removeLastObject];
+}
+
+@end
@@ -0,0 +1,422 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoTacticalReader.h"
+
+// System includes
+#include <algorithm>  // for std::min()
+#include <stdexcept>
+#include <utility>  // for std::swap()
+
+
+// -----------------------------------------------------------------------------
+/// @brief The number of moves into the search after which a capture search no
+/// longer considers net moves. Without this limit every attacker move in a
+/// long ladder would branch into net moves, and the search would exhaust its
+/// node budget long before the ladder reaches the edge of the board.
+// -----------------------------------------------------------------------------
+static const size_t maximumSearchDepthForNetMoves = 4;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GoTacticalReader object that searches on a copy of
+/// @a boardCore. Each search may visit at most @a nodeBudget nodes.
+// -----------------------------------------------------------------------------
+GoTacticalReader::GoTacticalReader(const GoBoardCore& boardCore, int nodeBudget) :
+  boardCore(boardCore),
+  nodeBudget(nodeBudget),
+  numberOfNodes(0),
+  nodeBudgetIsExhausted(false),
+  isLadderSearch(true),
+  koPoint(-1),
+  undoStack()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GoTacticalReader object.
+// -----------------------------------------------------------------------------
+GoTacticalReader::~GoTacticalReader()
+{
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Performs a ladder search for the stone group that the stone on the
+/// intersection with index @a index belongs to. @a colorToMove is the color
+/// that plays the first move.
+///
+/// If @a colorToMove is the color of the stone group, the result indicates
+/// whether the stone group can escape from the ladder. Otherwise the result
+/// indicates whether the attacker can capture the stone group in a ladder.
+///
+/// If @a keyMove is not null, it is filled with the index of the first move of
+/// the side to move that achieves the result, i.e. the attacker's first
+/// atari if the result is #ResultCaptured and the attacker is to move, or the
+/// defender's escape move if the result is #ResultEscapes and the defender is
+/// to move. In all other cases @a keyMove is filled with -1.
+///
+/// Throws std::invalid_argument if the intersection is not occupied by a
+/// stone, or if @a colorToMove is neither black nor white.
+// -----------------------------------------------------------------------------
+GoTacticalReader::Result GoTacticalReader::readLadder(int index, GoBoardCore::StoneState colorToMove, int* keyMove)
+{
+  this->isLadderSearch = true;
+  return read(index, colorToMove, keyMove);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Performs a capture search for the stone group that the stone on the
+/// intersection with index @a index belongs to. Other than that this method
+/// works the same as readLadder().
+// -----------------------------------------------------------------------------
+GoTacticalReader::Result GoTacticalReader::readCapture(int index, GoBoardCore::StoneState colorToMove, int* keyMove)
+{
+  this->isLadderSearch = false;
+  return read(index, colorToMove, keyMove);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of nodes that the last search visited.
+// -----------------------------------------------------------------------------
+int GoTacticalReader::getNumberOfNodes() const
+{
+  return this->numberOfNodes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for readLadder() and readCapture().
+// -----------------------------------------------------------------------------
+GoTacticalReader::Result GoTacticalReader::read(int index, GoBoardCore::StoneState colorToMove, int* keyMove)
+{
+  GoBoardCore::StoneState targetColor = this->boardCore.getStoneState(index);
+  if (GoBoardCore::StoneStateNone == targetColor)
+    throw std::invalid_argument("Intersection must be occupied by a stone");
+  // Throws if the color is neither black nor white
+  GoBoardCore::getOpponentColor(colorToMove);
+
+  this->numberOfNodes = 0;
+  this->nodeBudgetIsExhausted = false;
+  this->koPoint = -1;
+
+  int move = -1;
+  Result result;
+  if (colorToMove == targetColor)
+  {
+    bool escapes = defend(index, &move);
+    if (! escapes)
+      result = ResultCaptured;
+    else if (this->nodeBudgetIsExhausted)
+      result = ResultUnknown;
+    else
+      result = ResultEscapes;
+    if (result != ResultEscapes)
+      move = -1;
+  }
+  else
+  {
+    bool captured = attack(index, &move);
+    if (captured)
+      result = ResultCaptured;
+    else if (this->nodeBudgetIsExhausted)
+      result = ResultUnknown;
+    else
+      result = ResultEscapes;
+  }
+
+  if (keyMove)
+    *keyMove = move;
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the attacker, who is to move, can capture the stone
+/// group that the stone on the intersection with index @a target belongs to.
+/// Fills @a attackMove with the index of the attacker's first move if this
+/// method returns true, otherwise with -1.
+///
+/// If the node budget is exhausted this method returns false, i.e. it decides
+/// in favour of the defender, so that a result "captured" is always proven.
+// -----------------------------------------------------------------------------
+bool GoTacticalReader::attack(int target, int* attackMove)
+{
+  *attackMove = -1;
+  if (this->nodeBudgetIsExhausted)
+    return false;
+
+  GoBoardCore::PointSet stoneGroup;
+  GoBoardCore::PointSet liberties;
+  this->boardCore.getStoneGroupAndLiberties(target, stoneGroup, liberties);
+  size_t numberOfLiberties = liberties.count();
+
+  if (1 == numberOfLiberties)
+  {
+    // Capturing is never a suicide, only ko can prevent the capture
+    int liberty = this->boardCore.getFirstIndexInSet(liberties);
+    if (liberty == this->koPoint)
+      return false;
+    *attackMove = liberty;
+    return true;
+  }
+  else if (2 != numberOfLiberties)
+  {
+    return false;
+  }
+
+  GoBoardCore::StoneState attackerColor = GoBoardCore::getOpponentColor(this->boardCore.getStoneState(target));
+  std::vector<int> moves;
+  getAttackMoves(liberties, moves);
+  for (int move : moves)
+  {
+    if (! play(move, attackerColor))
+      continue;
+    int defenceMove;
+    bool escapes = defend(target, &defenceMove);
+    undo();
+
+    if (! escapes)
+    {
+      *attackMove = move;
+      return true;
+    }
+    if (this->nodeBudgetIsExhausted)
+      return false;
+  }
+
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the defender, who is to move, can save the stone
+/// group that the stone on the intersection with index @a target belongs to.
+/// Fills @a defenceMove with the index of the defender's saving move if this
+/// method returns true and a move is required, otherwise with -1.
+///
+/// If the node budget is exhausted this method returns true, i.e. it decides
+/// in favour of the defender, so that a result "captured" is always proven.
+// -----------------------------------------------------------------------------
+bool GoTacticalReader::defend(int target, int* defenceMove)
+{
+  *defenceMove = -1;
+  if (this->nodeBudgetIsExhausted)
+    return true;
+
+  GoBoardCore::PointSet stoneGroup;
+  GoBoardCore::PointSet liberties;
+  this->boardCore.getStoneGroupAndLiberties(target, stoneGroup, liberties);
+  if (liberties.count() >= 3)
+    return true;
+
+  GoBoardCore::StoneState defenderColor = this->boardCore.getStoneState(target);
+  GoBoardCore::StoneState attackerColor = GoBoardCore::getOpponentColor(defenderColor);
+  std::vector<int> moves;
+  getDefenceMoves(stoneGroup, liberties, attackerColor, moves);
+  for (int move : moves)
+  {
+    if (! play(move, defenderColor))
+      continue;
+    int attackMove;
+    bool escapes = (this->boardCore.getNumberOfLiberties(target) >= 3 ||
+                    ! attack(target, &attackMove));
+    undo();
+
+    if (escapes)
+    {
+      *defenceMove = move;
+      return true;
+    }
+  }
+
+  // If the node budget was exhausted some moves may not have been examined
+  return this->nodeBudgetIsExhausted;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a moves with the candidate moves of the attacker against a
+/// stone group with the two liberties @a liberties.
+///
+/// The candidates are the two liberties. In a capture search the candidates
+/// also include the empty intersections next to the liberties, which is where
+/// net moves are played, as long as the search is no deeper than
+/// #maximumSearchDepthForNetMoves.
+// -----------------------------------------------------------------------------
+void GoTacticalReader::getAttackMoves(const GoBoardCore::PointSet& liberties, std::vector<int>& moves) const
+{
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (liberties.test(index))
+      moves.push_back(index);
+  }
+
+  // The defender answers the atari by extending on the other liberty. Try
+  // first the atari that leaves the defender with the fewest empty
+  // intersections to extend to, and if that is a tie, the atari that drives
+  // the defender towards the edge. In a ladder this is almost always the
+  // correct atari, so the search does not have to explore the defender's
+  // escape after the wrong atari at every step of the ladder.
+  int emptyNeighboursOfFirstLiberty = this->boardCore.getNumberOfEmptyNeighbours(moves[0]);
+  int emptyNeighboursOfSecondLiberty = this->boardCore.getNumberOfEmptyNeighbours(moves[1]);
+  if (emptyNeighboursOfFirstLiberty < emptyNeighboursOfSecondLiberty)
+    std::swap(moves[0], moves[1]);
+  else if (emptyNeighboursOfFirstLiberty == emptyNeighboursOfSecondLiberty && getLine(moves[0]) < getLine(moves[1]))
+    std::swap(moves[0], moves[1]);
+
+  if (this->isLadderSearch || this->undoStack.size() >= maximumSearchDepthForNetMoves)
+    return;
+
+  GoBoardCore::PointSet secondOrderLiberties;
+  size_t numberOfLiberties = moves.size();
+  for (size_t indexOfLiberty = 0; indexOfLiberty < numberOfLiberties; ++indexOfLiberty)
+  {
+    int liberty = moves[indexOfLiberty];
+    const GoBoardCore::NeighbourList& neighbourList = this->boardCore.getNeighbours(liberty);
+    for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+    {
+      int neighbour = neighbourList.neighbours[indexOfNeighbour];
+      if (this->boardCore.hasStone(neighbour) || liberties.test(neighbour) || secondOrderLiberties.test(neighbour))
+        continue;
+      secondOrderLiberties.set(neighbour);
+      moves.push_back(neighbour);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Fills @a moves with the candidate moves of the defender whose stone
+/// group @a stoneGroup has the liberties @a liberties. @a attackerColor is the
+/// color of the attacker.
+///
+/// The candidates are the moves that capture an adjacent attacker stone group
+/// that is in atari, followed by the moves that extend the stone group on one
+/// of its liberties.
+// -----------------------------------------------------------------------------
+void GoTacticalReader::getDefenceMoves(const GoBoardCore::PointSet& stoneGroup, const GoBoardCore::PointSet& liberties, GoBoardCore::StoneState attackerColor, std::vector<int>& moves) const
+{
+  GoBoardCore::PointSet candidates;
+  GoBoardCore::PointSet examinedAttackerStones;
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (! stoneGroup.test(index))
+      continue;
+
+    const GoBoardCore::NeighbourList& neighbourList = this->boardCore.getNeighbours(index);
+    for (int indexOfNeighbour = 0; indexOfNeighbour < neighbourList.numberOfNeighbours; ++indexOfNeighbour)
+    {
+      int neighbour = neighbourList.neighbours[indexOfNeighbour];
+      if (this->boardCore.getStoneState(neighbour) != attackerColor || examinedAttackerStones.test(neighbour))
+        continue;
+
+      GoBoardCore::PointSet attackerStoneGroup;
+      GoBoardCore::PointSet attackerLiberties;
+      this->boardCore.getStoneGroupAndLiberties(neighbour, attackerStoneGroup, attackerLiberties);
+      examinedAttackerStones |= attackerStoneGroup;
+      if (attackerLiberties.count() != 1)
+        continue;
+
+      int capturingMove = this->boardCore.getFirstIndexInSet(attackerLiberties);
+      if (candidates.test(capturingMove))
+        continue;
+      candidates.set(capturingMove);
+      moves.push_back(capturingMove);
+    }
+  }
+
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    if (liberties.test(index) && ! candidates.test(index))
+      moves.push_back(index);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the line on which the intersection with index @a index is
+/// located, i.e. its distance to the nearest edge of the board plus one.
+/// Intersections on the edge are on the first line.
+// -----------------------------------------------------------------------------
+int GoTacticalReader::getLine(int index) const
+{
+  int boardSize = this->boardCore.getBoardSize();
+  int x = index % boardSize + 1;
+  int y = index / boardSize + 1;
+  return std::min(std::min(x, boardSize + 1 - x), std::min(y, boardSize + 1 - y));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Plays a stone of color @a color on the intersection with index
+/// @a index and removes the stones that the move captures. Returns true if the
+/// move was played. Returns false if the move is illegal, or if the node
+/// budget is exhausted.
+// -----------------------------------------------------------------------------
+bool GoTacticalReader::play(int index, GoBoardCore::StoneState color)
+{
+  if (this->boardCore.hasStone(index) || index == this->koPoint)
+    return false;
+  bool simpleKoIsPossible;
+  if (this->boardCore.isSuicide(index, color, &simpleKoIsPossible))
+    return false;
+
+  if (this->numberOfNodes >= this->nodeBudget)
+  {
+    this->nodeBudgetIsExhausted = true;
+    return false;
+  }
+  this->numberOfNodes++;
+
+  UndoRecord undoRecord;
+  undoRecord.index = index;
+  undoRecord.previousKoPoint = this->koPoint;
+  this->boardCore.getStonesCapturedByStone(index, color, undoRecord.capturedStones);
+
+  this->boardCore.setStoneState(index, color);
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int indexOfStone = 0; indexOfStone < numberOfPoints; ++indexOfStone)
+  {
+    if (undoRecord.capturedStones.test(indexOfStone))
+      this->boardCore.setStoneState(indexOfStone, GoBoardCore::StoneStateNone);
+  }
+
+  // The opponent may not immediately retake a single stone if the capturing
+  // stone is itself left with a single liberty
+  this->koPoint = -1;
+  if (simpleKoIsPossible && 1 == undoRecord.capturedStones.count() && 1 == this->boardCore.getNumberOfLiberties(index))
+    this->koPoint = this->boardCore.getFirstIndexInSet(undoRecord.capturedStones);
+
+  this->undoStack.push_back(undoRecord);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Takes back the move that was last played by play().
+// -----------------------------------------------------------------------------
+void GoTacticalReader::undo()
+{
+  const UndoRecord& undoRecord = this->undoStack.back();
+  GoBoardCore::StoneState opponentColor = GoBoardCore::getOpponentColor(this->boardCore.getStoneState(undoRecord.index));
+
+  this->boardCore.setStoneState(undoRecord.index, GoBoardCore::StoneStateNone);
+  int numberOfPoints = this->boardCore.getNumberOfPoints();
+  for (int indexOfStone = 0; indexOfStone < numberOfPoints; ++indexOfStone)
+  {
+    if (undoRecord.capturedStones.test(indexOfStone))
+      this->boardCore.setStoneState(indexOfStone, opponentColor);
+  }
+
+  this->koPoint = undoRecord.previousKoPoint;
+  this->undoStack.pop_back();
+}
@@ -0,0 +1,119 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#include "GoBoardCore.h"
+
+// System includes
+#include <vector>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoTacticalReader class performs a small tactical search that
+/// answers whether a stone group can be captured in a ladder, or with a short
+/// sequence of moves while it has no more than two liberties.
+///
+/// @ingroup go
+///
+/// GoTacticalReader is meant to give instant tactical insight, e.g. for board
+/// overlays, without having to wait for the GTP engine. It searches on a
+/// private copy of a GoBoardCore object, so the original board is never
+/// modified. The search is single-threaded and depth-first. It is limited by a
+/// node budget, each move played during the search counts as one node.
+///
+/// Two kinds of search are supported:
+/// - readLadder(): The attacker may only play atari, the defender may only
+///   extend on its single liberty or capture an adjacent attacker stone group
+///   that is in atari.
+/// - readCapture(): In addition to the ladder moves, the attacker may play on
+///   the second-order liberties of a stone group with two liberties (net
+///   moves, also known as "geta"), and the defender may extend on either of
+///   its two liberties.
+///
+/// In both kinds of search a stone group with three or more liberties counts
+/// as having escaped. Simple ko is taken into account, superko is not.
+///
+/// If the node budget is exhausted the search stops and the result is
+/// #ResultUnknown, unless the stone group was proven to be captured before.
+/// A result #ResultCaptured is therefore always reliable.
+///
+/// GoTacticalReader is not thread-safe. A single object can be used for any
+/// number of searches on the same board position.
+// -----------------------------------------------------------------------------
+class GoTacticalReader
+{
+public:
+  /// @brief Enumerates the possible outcomes of a search.
+  enum Result
+  {
+    /// @brief The stone group can be captured.
+    ResultCaptured,
+    /// @brief The stone group cannot be captured within the limits of the
+    /// search.
+    ResultEscapes,
+    /// @brief The node budget was exhausted before the search could reach a
+    /// conclusion.
+    ResultUnknown
+  };
+
+public:
+  GoTacticalReader(const GoBoardCore& boardCore, int nodeBudget);
+  ~GoTacticalReader();
+
+  Result readLadder(int index, GoBoardCore::StoneState colorToMove, int* keyMove);
+  Result readCapture(int index, GoBoardCore::StoneState colorToMove, int* keyMove);
+  int getNumberOfNodes() const;
+
+private:
+  Result read(int index, GoBoardCore::StoneState colorToMove, int* keyMove);
+  bool attack(int target, int* attackMove);
+  bool defend(int target, int* defenceMove);
+  void getAttackMoves(const GoBoardCore::PointSet& liberties, std::vector<int>& moves) const;
+  void getDefenceMoves(const GoBoardCore::PointSet& stoneGroup, const GoBoardCore::PointSet& liberties, GoBoardCore::StoneState attackerColor, std::vector<int>& moves) const;
+  int getLine(int index) const;
+  bool play(int index, GoBoardCore::StoneState color);
+  void undo();
+
+private:
+  /// @brief Information required to take back a move played during the
+  /// search.
+  struct UndoRecord
+  {
+    int index;
+    int previousKoPoint;
+    GoBoardCore::PointSet capturedStones;
+  };
+
+  /// @brief The private copy of the board on which the search is performed.
+  GoBoardCore boardCore;
+  /// @brief The maximum number of nodes that a single search may visit.
+  int nodeBudget;
+  /// @brief The number of nodes that the last search visited.
+  int numberOfNodes;
+  /// @brief True if the last search was stopped because it exhausted
+  /// @e nodeBudget.
+  bool nodeBudgetIsExhausted;
+  /// @brief True if the current search is a ladder search, false if it is a
+  /// capture search.
+  bool isLadderSearch;
+  /// @brief The index of the intersection on which the side to move may not
+  /// play because of simple ko. Is -1 if there is no such intersection.
+  int koPoint;
+  /// @brief The moves played during the search that have not yet been taken
+  /// back.
+  std::vector<UndoRecord> undoStack;
+};
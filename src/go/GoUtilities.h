@@ -40,6 +40,7 @@
 + (void) movePointToNewRegion:(GoPoint*)thePoint;
 + (NSArray*) verticesForHandicap:(int)handicap boardSize:(enum GoBoardSize)boardSize;
 + (NSArray*) pointsForHandicap:(int)handicap inGame:(GoGame*)game;
++ (const int*) pointIndexesForHandicap:(int)handicap boardSize:(enum GoBoardSize)boardSize;
 + (int) maximumHandicapForBoardSize:(enum GoBoardSize)boardSize;
 + (GoPlayer*) playerAfter:(GoMove*)move inCurrentGameVariation:(GoGame*)game;
 + (NSArray*) pointsInRectangleDelimitedByCornerPoint:(GoPoint*)pointA
@@ -56,7 +57,6 @@
 + (bool) isGameInResumedPlayState:(GoGame*)game;
 + (bool) shouldAllowResumePlay:(GoGame*)game;
 + (NSString*) verticesStringForPoints:(NSArray*)points;
-+ (void) recalculateZobristHashes:(GoGame*)game;
 + (void) relinkMoves:(GoGame*)game;
 + (GoNode*) nodeWithMostRecentMove:(GoNode*)node;
 + (GoNode*) nodeWithNextMove:(GoNode*)node inCurrentGameVariation:(GoGame*)game;
@@ -68,5 +68,7 @@
 + (bool) showInfoIndicatorForNode:(GoNode*)node;
 + (bool) showHotspotIndicatorForNode:(GoNode*)node;
 + (enum NodeTreeViewCellSymbol) symbolForNode:(GoNode*)node inGame:(GoGame*)game;
++ (NSArray*) objectsInDeallocationOrderForGame:(GoGame*)game;
++ (NSArray*) objectsInDeallocationOrderForSubtree:(GoNode*)node;
 
 @end
@@ -30,7 +30,6 @@
 #import "GoPlayer.h"
 #import "GoPoint.h"
 #import "GoVertex.h"
-#import "GoZobristTable.h"
 
 
 @implementation GoUtilities
@@ -50,7 +49,8 @@
 /// - @a thePoint's old GoBoardRegion may become fragmented if @a thePoint
 ///   has been the only link between two or more sub-regions
 /// - @a thePoint's new GoBoardRegion may merge with other regions if
-///   @a thePoint joins them together
+///   @a thePoint joins them together. The smaller regions are always merged
+///   into the largest region.
 // -----------------------------------------------------------------------------
 + (void) movePointToNewRegion:(GoPoint*)thePoint
 {
@@ -65,7 +65,10 @@
                                      // split into multiple GoBoardRegion objects
 
   // Step 2: Attempt to add the point to the same region as one of its
-  // neighbours. At the same time, merge regions if they can be joined.
+  // neighbours. If there are several such neighbouring regions, the point is
+  // added to the largest region and the other regions are merged into it.
+  // Always merging the smaller regions into the larger one keeps the number of
+  // points that change their region reference to a minimum.
   GoBoardRegion* newRegion = nil;
   for (GoPoint* neighbour in thePoint.neighbours)
   {
@@ -73,16 +76,18 @@
     // state also includes stone color)
     if (neighbour.stoneState != thePoint.stoneState)
       continue;
-    if (! newRegion)
-    {
-      // Join the region of one of the neighbours
-      newRegion = neighbour.region;
-      [newRegion addPoint:thePoint];
-    }
-    else
+    GoBoardRegion* neighbourRegion = neighbour.region;
+    if (! newRegion || [neighbourRegion size] > [newRegion size])
+      newRegion = neighbourRegion;
+  }
+  if (newRegion)
+  {
+    [newRegion addPoint:thePoint];
+    // Now check if entire regions can be merged
+    for (GoPoint* neighbour in thePoint.neighbours)
     {
-      // The stone has already joined a neighbouring region
-      // -> now check if entire regions can be merged
+      if (neighbour.stoneState != thePoint.stoneState)
+        continue;
       GoBoardRegion* neighbourRegion = neighbour.region;
       if (neighbourRegion != newRegion)
         [newRegion joinRegion:neighbourRegion];
@@ -102,8 +107,72 @@
 /// board size 7x7, @a handicap must be between 2 and 4. The limits are
 /// inclusive.
 ///
-/// The handicap positions returned by this method correspond to those specified
-/// in section 4.1.1 of the GTP v2 specification.
+/// See pointIndexesForHandicap:boardSize:() for details.
+// -----------------------------------------------------------------------------
++ (NSArray*) verticesForHandicap:(int)handicap boardSize:(enum GoBoardSize)boardSize
+{
+  const int* handicapPointIndexes = [GoUtilities pointIndexesForHandicap:handicap boardSize:boardSize];
+
+  NSMutableArray* handicapVertices = [NSMutableArray arrayWithCapacity:handicap];
+  for (int handicapStoneIndex = 0; handicapStoneIndex < handicap; ++handicapStoneIndex)
+  {
+    struct GoVertexNumeric numericVertex;
+    numericVertex.x = handicapPointIndexes[handicapStoneIndex] % boardSize + 1;
+    numericVertex.y = handicapPointIndexes[handicapStoneIndex] / boardSize + 1;
+    GoVertex* vertex = [GoVertex vertexFromNumeric:numericVertex];
+    [handicapVertices addObject:vertex.string];
+  }
+
+  return handicapVertices;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an (unordered) list of GoPoint objects for the specified
+/// @a handicap and board associated with @a game.
+///
+/// The GoPoint objects are looked up by their point index, so unlike
+/// verticesForHandicap:boardSize:() this does not involve any string
+/// processing. The list has the same order as the point indexes returned by
+/// pointIndexesForHandicap:boardSize:().
+///
+/// See pointIndexesForHandicap:boardSize:() for details.
+// -----------------------------------------------------------------------------
++ (NSArray*) pointsForHandicap:(int)handicap inGame:(GoGame*)game
+{
+  GoBoard* board = game.board;
+  if (! board)
+  {
+    NSString* errorMessage = @"No GoBoard object associated with specified GoGame";
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSGenericException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  const int* handicapPointIndexes = [GoUtilities pointIndexesForHandicap:handicap boardSize:board.size];
+
+  NSMutableArray* handicapPoints = [NSMutableArray arrayWithCapacity:handicap];
+  for (int handicapStoneIndex = 0; handicapStoneIndex < handicap; ++handicapStoneIndex)
+  {
+    GoPoint* point = [board pointAtIndex:handicapPointIndexes[handicapStoneIndex]];
+    [handicapPoints addObject:point];
+  }
+  return handicapPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a C array with the point indexes of the handicap stones for
+/// the specified @a handicap and @a boardSize. The array has @a handicap
+/// elements. A point index is the index that GoBoard::pointAtIndex:() expects.
+///
+/// For board sizes greater than 7x7, @a handicap must be between 2 and 9. For
+/// board size 7x7, @a handicap must be between 2 and 4. The limits are
+/// inclusive. @a handicap may also be 0, in which case the array is empty.
+/// Raises @e NSRangeException for any other value of @a handicap.
+///
+/// The handicap positions correspond to those specified in section 4.1.1 of
+/// the GTP v2 specification.
 /// https://www.lysator.liu.se/~gunnar/gtp/gtp2-spec-draft2/gtp2-spec.html#sec:fixed-handicap-placement
 ///
 /// Handicap stone distribution for handicaps 1-5:
@@ -126,19 +195,40 @@
 /// 5 9 6
 /// 1 7 4
 /// @endverbatim
+///
+/// The point indexes for all board sizes and handicaps are calculated only
+/// once and then stored in a static table. The array returned by this method
+/// points into that table and is valid until the process terminates.
 // -----------------------------------------------------------------------------
-+ (NSArray*) verticesForHandicap:(int)handicap boardSize:(enum GoBoardSize)boardSize
++ (const int*) pointIndexesForHandicap:(int)handicap boardSize:(enum GoBoardSize)boardSize
 {
-  static const int numberOfBoardSizes = (GoBoardSizeMax - GoBoardSizeMin) / 2 + 1;
-  static const int maxHandicaps[numberOfBoardSizes] = {4, 9, 9, 9, 9, 9, 9};
-  static const int edgeDistances[numberOfBoardSizes] = {3, 3, 3, 4, 4, 4, 4};
-
-  NSMutableArray* handicapVertices = [NSMutableArray arrayWithCapacity:0];
-  if (0 == handicap)
-    return handicapVertices;
+  enum
+  {
+    NumberOfBoardSizes = (GoBoardSizeMax - GoBoardSizeMin) / 2 + 1,
+    MaximumHandicap = 9
+  };
+  static int handicapPointIndexes[NumberOfBoardSizes][MaximumHandicap + 1][MaximumHandicap];
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    for (int boardSizeIndex = 0; boardSizeIndex < NumberOfBoardSizes; ++boardSizeIndex)
+    {
+      enum GoBoardSize tableBoardSize = (enum GoBoardSize)(GoBoardSizeMin + boardSizeIndex * 2);
+      int maximumHandicap = [GoUtilities maximumHandicapForBoardSize:tableBoardSize];
+      for (int tableHandicap = 2; tableHandicap <= maximumHandicap; ++tableHandicap)
+      {
+        for (int handicapStone = 1; handicapStone <= tableHandicap; ++handicapStone)
+        {
+          struct GoVertexNumeric numericVertex = [GoUtilities numericVertexOfHandicapStone:handicapStone
+                                                                                 handicap:tableHandicap
+                                                                                boardSize:tableBoardSize];
+          handicapPointIndexes[boardSizeIndex][tableHandicap][handicapStone - 1] = (numericVertex.y - 1) * tableBoardSize + (numericVertex.x - 1);
+        }
+      }
+    }
+  });
 
-  int boardSizeArrayIndex = (boardSize - GoBoardSizeMin) / 2;
-  if (handicap < 2 || handicap > maxHandicaps[boardSizeArrayIndex])
+  int boardSizeIndex = (boardSize - GoBoardSizeMin) / 2;
+  if (0 != handicap && (handicap < 2 || handicap > [GoUtilities maximumHandicapForBoardSize:boardSize]))
   {
     NSString* errorMessage = [NSString stringWithFormat:@"Specified handicap %d is out of range for GoBoardSize %d", handicap, boardSize];
     DDLogError(@"%@: %@", self, errorMessage);
@@ -148,129 +238,109 @@
     @throw exception;
   }
 
-  int edgeDistance = edgeDistances[boardSizeArrayIndex];
+  return handicapPointIndexes[boardSizeIndex][handicap];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the numeric vertex of the handicap stone number
+/// @a handicapStone (1-based) for the specified @a handicap and @a boardSize.
+/// See pointIndexesForHandicap:boardSize:() for the distribution of the
+/// handicap stones.
+///
+/// This is a private helper for pointIndexesForHandicap:boardSize:().
+// -----------------------------------------------------------------------------
++ (struct GoVertexNumeric) numericVertexOfHandicapStone:(int)handicapStone
+                                               handicap:(int)handicap
+                                              boardSize:(enum GoBoardSize)boardSize
+{
+  int edgeDistance = (boardSize >= GoBoardSize13) ? 4 : 3;
   int lineClose = edgeDistance;
   int lineFar = boardSize - edgeDistance + 1;
   int lineMiddle = lineClose + ((lineFar - lineClose) / 2);
 
-  for (int handicapIter = 1; handicapIter <= handicap; ++handicapIter)
+  struct GoVertexNumeric numericVertex;
+  switch (handicapStone)
   {
-    struct GoVertexNumeric numericVertex;
-    switch (handicapIter)
+    case 1:
     {
-      case 1:
-      {
-        numericVertex.x = lineClose;
-        numericVertex.y = lineClose;
-        break;
-      }
-      case 2:
+      numericVertex.x = lineClose;
+      numericVertex.y = lineClose;
+      break;
+    }
+    case 2:
+    {
+      numericVertex.x = lineFar;
+      numericVertex.y = lineFar;
+      break;
+    }
+    case 3:
+    {
+      numericVertex.x = lineClose;
+      numericVertex.y = lineFar;
+      break;
+    }
+    case 4:
+    {
+      numericVertex.x = lineFar;
+      numericVertex.y = lineClose;
+      break;
+    }
+    case 5:
+    {
+      if (handicapStone == handicap)
       {
-        numericVertex.x = lineFar;
-        numericVertex.y = lineFar;
-        break;
+        numericVertex.x = lineMiddle;
+        numericVertex.y = lineMiddle;
       }
-      case 3:
+      else
       {
         numericVertex.x = lineClose;
-        numericVertex.y = lineFar;
-        break;
-      }
-      case 4:
-      {
-        numericVertex.x = lineFar;
-        numericVertex.y = lineClose;
-        break;
-      }
-      case 5:
-      {
-        if (handicapIter == handicap)
-        {
-          numericVertex.x = lineMiddle;
-          numericVertex.y = lineMiddle;
-        }
-        else
-        {
-          numericVertex.x = lineClose;
-          numericVertex.y = lineMiddle;
-        }
-        break;
-      }
-      case 6:
-      {
-        numericVertex.x = lineFar;
         numericVertex.y = lineMiddle;
-        break;
       }
-      case 7:
-      {
-        if (handicapIter == handicap)
-        {
-          numericVertex.x = lineMiddle;
-          numericVertex.y = lineMiddle;
-        }
-        else
-        {
-          numericVertex.x = lineMiddle;
-          numericVertex.y = lineClose;
-        }
-        break;
-      }
-      case 8:
-      {
-        numericVertex.x = lineMiddle;
-        numericVertex.y = lineFar;
-        break;
-      }
-      case 9:
+      break;
+    }
+    case 6:
+    {
+      numericVertex.x = lineFar;
+      numericVertex.y = lineMiddle;
+      break;
+    }
+    case 7:
+    {
+      if (handicapStone == handicap)
       {
         numericVertex.x = lineMiddle;
         numericVertex.y = lineMiddle;
-        break;
       }
-      default:
+      else
       {
-        DDLogError(@"%@: Unsupported handicap %d", [self class], handicapIter);
-        assert(0);
-        numericVertex.x = -1;
-        numericVertex.y = -1;
-        break;
+        numericVertex.x = lineMiddle;
+        numericVertex.y = lineClose;
       }
+      break;
+    }
+    case 8:
+    {
+      numericVertex.x = lineMiddle;
+      numericVertex.y = lineFar;
+      break;
+    }
+    case 9:
+    {
+      numericVertex.x = lineMiddle;
+      numericVertex.y = lineMiddle;
+      break;
+    }
+    default:
+    {
+      DDLogError(@"%@: Unsupported handicap stone %d", [self class], handicapStone);
+      assert(0);
+      numericVertex.x = -1;
+      numericVertex.y = -1;
+      break;
     }
-    GoVertex* vertex = [GoVertex vertexFromNumeric:numericVertex];
-    [handicapVertices addObject:vertex.string];
-  }
-
-  return handicapVertices;
-}
-
-// -----------------------------------------------------------------------------
-/// @brief Returns an (unordered) list of GoPoint objects for the specified
-/// @a handicap and board associated with @a game.
-///
-/// See verticesForHandicap:boardSize:() for details.
-// -----------------------------------------------------------------------------
-+ (NSArray*) pointsForHandicap:(int)handicap inGame:(GoGame*)game
-{
-  GoBoard* board = game.board;
-  if (! board)
-  {
-    NSString* errorMessage = @"No GoBoard object associated with specified GoGame";
-    DDLogError(@"%@: %@", self, errorMessage);
-    NSException* exception = [NSException exceptionWithName:NSGenericException
-                                                     reason:errorMessage
-                                                   userInfo:nil];
-    @throw exception;
-  }
-
-  NSMutableArray* handicapPoints = [NSMutableArray arrayWithCapacity:0];
-  NSArray* handicapVertices = [GoUtilities verticesForHandicap:handicap boardSize:board.size];
-  for (NSString* vertex in handicapVertices)
-  {
-    GoPoint* point = [board pointAtVertex:vertex];
-    [handicapPoints addObject:point];
   }
-  return handicapPoints;
+  return numericVertex;
 }
 
 // -----------------------------------------------------------------------------
@@ -372,8 +442,7 @@
   {
     while (numericVertexIteration.x <= numericVertexTopRight.x)
     {
-      GoVertex* vertexIteration = [GoVertex vertexFromNumeric:numericVertexIteration];
-      GoPoint* point = [board pointAtVertex:vertexIteration.string];
+      GoPoint* point = [board pointAtNumericVertex:numericVertexIteration];
       [pointsInRectangle addObject:point];
       numericVertexIteration.x++;
     }
@@ -739,53 +808,6 @@
   return verticesString;
 }
 
-// -----------------------------------------------------------------------------
-/// @brief Recalculates all Zobrist hashes of the specified game.
-///
-/// GoZobristTable is not archived when a game is archived, instead a new
-/// GoZobristTable object with random values is created each time when a game
-/// is unarchived. Zobrist hashes created by the previous GoZobristTable object
-/// are thus invalid and must be re-calculated when a game is unarchived.
-/// This method performs the necessary re-calculations.
-///
-/// @note Because Zobrist hashes would be invalid after unarchiving, they are
-/// not even archived in the first place. This has the benefit that the archive
-/// becomes smaller.
-// -----------------------------------------------------------------------------
-+ (void) recalculateZobristHashes:(GoGame*)game
-{
-  GoZobristTable* zobristTable = game.board.zobristTable;
-
-  game.zobristHashAfterHandicap = [zobristTable hashForHandicapStonesInGame:game];
-
-  NSMutableArray* stack = [NSMutableArray array];
-  GoNode* currentNode = game.nodeModel.rootNode;
-  while (true)
-  {
-    while (currentNode)
-    {
-      [currentNode calculateZobristHash:game];
-
-      [stack addObject:currentNode];
-
-      currentNode = currentNode.firstChild;
-    }
-
-    if (stack.count > 0)
-    {
-      currentNode = stack.lastObject;
-      [stack removeLastObject];
-
-      currentNode = currentNode.nextSibling;
-    }
-    else
-    {
-      // We're done
-      break;
-    }
-  }
-}
-
 // -----------------------------------------------------------------------------
 /// @brief Relinks all moves of the specified game. The source is the
 /// GoNodeModel contained by @a game.
@@ -844,13 +866,9 @@
 // -----------------------------------------------------------------------------
 + (GoNode*) nodeWithMostRecentMove:(GoNode*)node
 {
-  while (node)
-  {
-    if (node.goMove)
-      return node;
-    node = node.parent;
-  }
-  return nil;
+  // GoNode caches the result, so repeated invocations do not have to walk the
+  // ancestors each time
+  return node.nodeWithMostRecentMove;
 }
 
 // -----------------------------------------------------------------------------
@@ -904,18 +922,9 @@
 // -----------------------------------------------------------------------------
 + (int) numberOfMovesBeforeNode:(GoNode*)node
 {
-  int numberOfMovesBeforeNode = 0;
-
-  if (node)
-    node = node.parent;
-  while (node)
-  {
-    if (node.goMove)
-      numberOfMovesBeforeNode++;
-    node = node.parent;
-  }
-
-  return numberOfMovesBeforeNode;
+  // GoNode caches the result, so repeated invocations do not have to walk the
+  // ancestors each time. Messaging nil returns zero.
+  return node.numberOfMovesBeforeNode;
 }
 
 // -----------------------------------------------------------------------------
@@ -1002,13 +1011,9 @@
 // -----------------------------------------------------------------------------
 + (GoNode*) nodeWithMostRecentBoardStateChange:(GoNode*)node
 {
-  while (node)
-  {
-    if (node.goMove || node.goNodeSetup)
-      return node;
-    node = node.parent;
-  }
-  return nil;
+  // GoNode caches the result, so repeated invocations do not have to walk the
+  // ancestors each time
+  return node.nodeWithMostRecentBoardStateChange;
 }
 
 // -----------------------------------------------------------------------------
@@ -1131,4 +1136,43 @@
   return NodeTreeViewCellSymbolEmpty;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns @a game and all GoNode objects of its game tree, in an order
+/// that is suitable for DeferredDeallocationQueue::releaseObjectsWhenIdle:().
+///
+/// @a game is the first object, so that GoGame is deallocated before its game
+/// tree, while GoNodeModel and GoBoardPosition still refer to nodes that
+/// exist. The GoNode objects follow in depth-first pre-order, see
+/// objectsInDeallocationOrderForSubtree:().
+// -----------------------------------------------------------------------------
++ (NSArray*) objectsInDeallocationOrderForGame:(GoGame*)game
+{
+  if (! game)
+    return @[];
+
+  NSMutableArray* objects = [NSMutableArray arrayWithObject:game];
+  [objects addObjectsFromArray:[GoUtilities objectsInDeallocationOrderForSubtree:game.nodeModel.rootNode]];
+  return objects;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GoNode objects of the sub tree that has @a node as its
+/// root, in an order that is suitable for
+/// DeferredDeallocationQueue::releaseObjectsWhenIdle:().
+///
+/// The nodes are in depth-first pre-order. A node retains only its first
+/// child and its next sibling, both of which come after the node in
+/// pre-order, so deallocating a node never deallocates another node that has
+/// not yet been handed over. Returns an empty array if @a node is @e nil.
+// -----------------------------------------------------------------------------
++ (NSArray*) objectsInDeallocationOrderForSubtree:(GoNode*)node
+{
+  NSMutableArray* objects = [NSMutableArray array];
+  [node enumerateSubtreeInPreorderUsingBlock:^(GoNode* nodeInSubtree, bool* stop)
+  {
+    [objects addObject:nodeInSubtree];
+  }];
+  return objects;
+}
+
 @end
@@ -19,6 +19,15 @@
 #import "GoVertex.h"
 
 
+/// @brief The largest value supported on both axis.
+static const int maximumAxisValue = 19;
+/// @brief The interned GoVertex objects, one for each supported combination of
+/// numeric compounds. The table is created once and lives for the lifetime of
+/// the process. The GoVertex object for x/y is at index
+/// (y - 1) * maximumAxisValue + (x - 1).
+static GoVertex** internedVertices = NULL;
+
+
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for GoVertex.
 // -----------------------------------------------------------------------------
@@ -36,15 +45,66 @@
 @implementation GoVertex
 
 // -----------------------------------------------------------------------------
-/// @brief Convenience constructor. Creates a GoVertex instance from the numeric
+/// @brief Returns the interned GoVertex object for the numeric compounds in
+/// @a numericValue. The numeric compounds must be within the supported range
+/// of values.
+///
+/// The intern table is created the first time this method is invoked. Because
+/// GoVertex objects are immutable and the table does not change after it was
+/// created, the table can be used from any thread. The table covers the
+/// largest board size, smaller board sizes use a subset of the table.
+// -----------------------------------------------------------------------------
++ (GoVertex*) internedVertexForNumeric:(struct GoVertexNumeric)numericValue
+{
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    internedVertices = (GoVertex**)malloc(sizeof(GoVertex*) * maximumAxisValue * maximumAxisValue);
+
+    unichar charA = [@"A" characterAtIndex:0];
+    unichar charH = [@"H" characterAtIndex:0];
+    NSString* letterAxisCompounds[maximumAxisValue];
+    NSString* numberAxisCompounds[maximumAxisValue];
+    for (int axisValue = 1; axisValue <= maximumAxisValue; ++axisValue)
+    {
+      unichar charLetterAxisCompound = charA + axisValue - 1; // -1 because numeric vertex is not zero-based
+      if (charLetterAxisCompound > charH)
+        charLetterAxisCompound++;                             // +1 because "I" is never used
+      letterAxisCompounds[axisValue - 1] = [NSString stringWithCharacters:&charLetterAxisCompound length:1];
+      numberAxisCompounds[axisValue - 1] = [NSString stringWithFormat:@"%d", axisValue];
+    }
+
+    for (int y = 1; y <= maximumAxisValue; ++y)
+    {
+      for (int x = 1; x <= maximumAxisValue; ++x)
+      {
+        struct GoVertexNumeric numericVertex;
+        numericVertex.x = x;
+        numericVertex.y = y;
+        // Never released
+        internedVertices[(y - 1) * maximumAxisValue + (x - 1)] = [[GoVertex alloc] initWithLetterAxisCompound:letterAxisCompounds[x - 1]
+                                                                                          numberAxisCompound:numberAxisCompounds[y - 1]
+                                                                                                     numeric:numericVertex];
+      }
+    }
+  });
+
+  return internedVertices[(numericValue.y - 1) * maximumAxisValue + (numericValue.x - 1)];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Returns a GoVertex instance for the numeric
 /// compounds in @a numericValue.
 ///
+/// GoVertex objects are interned, i.e. this method always returns the same
+/// object for the same numeric compounds and never allocates memory (except
+/// once for the intern table).
+///
 /// Raises an @e NSRangeException if one of the vertex compounds stored in
 /// @a numericValue is outside the supported range of values.
 // -----------------------------------------------------------------------------
 + (GoVertex*) vertexFromNumeric:(struct GoVertexNumeric)numericValue
 {
-  if (numericValue.x < 1 || numericValue.x > 19 || numericValue.y < 1 || numericValue.y > 19)
+  if (numericValue.x < 1 || numericValue.x > maximumAxisValue || numericValue.y < 1 || numericValue.y > maximumAxisValue)
   {
     NSString* errorMessage = @"Numeric vertex is invalid";
 #ifndef LITTLEGO_UITESTS
@@ -56,26 +116,17 @@
     @throw exception;
   }
 
-  unichar charA = [@"A" characterAtIndex:0];
-  unichar charH = [@"H" characterAtIndex:0];
-  unichar charLetterAxisCompound = charA + numericValue.x - 1; // -1 because numeric vertex is not zero-based
-  if (charLetterAxisCompound > charH)
-    charLetterAxisCompound++;                                // +1 because "I" is never used
-  NSString* letterAxisCompound = [NSString stringWithCharacters:&charLetterAxisCompound length:1];
-  NSString* numberAxisCompound = [NSString stringWithFormat:@"%d", numericValue.y];
-
-  GoVertex* vertex = [[GoVertex alloc] initWithLetterAxisCompound:letterAxisCompound
-                                               numberAxisCompound:numberAxisCompound
-                                                          numeric:numericValue];
-  if (vertex)
-    [vertex autorelease];
-  return vertex;
+  return [GoVertex internedVertexForNumeric:numericValue];
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Convenience constructor. Creates a GoVertex instance from
+/// @brief Convenience constructor. Returns a GoVertex instance for
 /// @a stringValue.
 ///
+/// GoVertex objects are interned, i.e. this method always returns the same
+/// object for the same vertex. Parsing @a stringValue does not allocate
+/// memory if @a stringValue is well-formed.
+///
 /// Raises an @e NSRangeException if one of the vertex compounds stored in
 /// @a stringValue are outside the supported range of values. Raises an
 /// @e NSInvalidArgumentException if @a stringValue is nil or otherwise
@@ -95,13 +146,17 @@
     @throw exception;
   }
 
-  stringValue = [stringValue uppercaseString];
-  NSString* letterAxisCompound = [stringValue substringWithRange:NSMakeRange(0, 1)];
-  NSString* numberAxisCompound = [stringValue substringFromIndex:1];
-  unichar charLetterAxisCompound = [letterAxisCompound characterAtIndex:0];
   const unichar charA = [@"A" characterAtIndex:0];
   const unichar charH = [@"H" characterAtIndex:0];
   const unichar charI = [@"I" characterAtIndex:0];
+  const unichar charLowercaseA = [@"a" characterAtIndex:0];
+  const unichar charLowercaseZ = [@"z" characterAtIndex:0];
+  const unichar char0 = [@"0" characterAtIndex:0];
+  const unichar char9 = [@"9" characterAtIndex:0];
+
+  unichar charLetterAxisCompound = [stringValue characterAtIndex:0];
+  if (charLetterAxisCompound >= charLowercaseA && charLetterAxisCompound <= charLowercaseZ)
+    charLetterAxisCompound = charLetterAxisCompound - charLowercaseA + charA;
 
   if (charLetterAxisCompound == charI)
   {
@@ -119,9 +174,24 @@
   numericValue.x = charLetterAxisCompound - charA + 1;  // +1 because vertex is not zero-based
   if (charLetterAxisCompound > charH)
     numericValue.x--;                               // -1 because "I" is never used
-  numericValue.y = [numberAxisCompound intValue];   // no @try needed, intValue does not throw any exceptions
+  // Fast path for the number axis compound consisting only of digits, which
+  // is the only well-formed case. The slow path retains the lenient parsing of
+  // intValue for everything else.
+  NSUInteger stringLength = stringValue.length;
+  numericValue.y = 0;
+  for (NSUInteger indexOfCharacter = 1; indexOfCharacter < stringLength; ++indexOfCharacter)
+  {
+    unichar character = [stringValue characterAtIndex:indexOfCharacter];
+    if (character < char0 || character > char9)
+    {
+      NSString* numberAxisCompound = [stringValue substringFromIndex:1];
+      numericValue.y = [numberAxisCompound intValue];   // no @try needed, intValue does not throw any exceptions
+      break;
+    }
+    numericValue.y = numericValue.y * 10 + (character - char0);
+  }
 
-  if (numericValue.x < 1 || numericValue.x > 19 || numericValue.y < 1 || numericValue.y > 19)
+  if (numericValue.x < 1 || numericValue.x > maximumAxisValue || numericValue.y < 1 || numericValue.y > maximumAxisValue)
   {
     NSString* errorMessage = @"String vertex is invalid";
 #ifndef LITTLEGO_UITESTS
@@ -133,12 +203,7 @@
     @throw exception;
   }
 
-  GoVertex* vertex = [[GoVertex alloc] initWithLetterAxisCompound:letterAxisCompound
-                                               numberAxisCompound:numberAxisCompound
-                                                          numeric:numericValue];
-  if (vertex)
-    [vertex autorelease];
-  return vertex;
+  return [GoVertex internedVertexForNumeric:numericValue];
 }
 
 // -----------------------------------------------------------------------------
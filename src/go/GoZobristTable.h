@@ -39,6 +39,15 @@
 /// universally accepted that the chance for a hash collision is extremely (!)
 /// small when 64 bit values are used (e.g. [3]).
 ///
+/// The random values are generated by a SplitMix64 pseudo random number
+/// generator that always starts with the same seed. The table for a given
+/// board size, and therefore also the Zobrist hashes calculated with it, are
+/// the same in every process. This makes it possible to persist Zobrist hashes
+/// and to compare them later on. Because the tables never change, clients
+/// should use the shared instance provided by
+/// sharedZobristTableForBoardSize:() instead of creating their own
+/// GoZobristTable objects.
+///
 /// [1] https://en.wikipedia.org/wiki/Zobrist_hashing
 /// [2] http://www.cwi.nl/~tromp/java/go/GoGame.java (URL defunct)
 /// [3] http://osdir.com/ml/games.devel.go/2002-09/msg00006.html (URL defunct)
@@ -47,6 +56,7 @@
 {
 }
 
++ (GoZobristTable*) sharedZobristTableForBoardSize:(enum GoBoardSize)boardSize;
 - (id) initWithBoardSize:(enum GoBoardSize)boardSize;
 
 - (long long) hashForBoard:(GoBoard*)board;
@@ -65,5 +75,12 @@
                         capturingStones:(NSArray*)capturedStones
                               afterNode:(GoNode*)node
                                  inGame:(GoGame*)game;
+- (void) symmetryHashes:(long long*)symmetryHashes forBoard:(GoBoard*)board;
+- (void) updateSymmetryHashes:(long long*)symmetryHashes
+              forStoneAtIndex:(int)index
+                    withColor:(enum GoColor)color;
++ (long long) canonicalHashForSymmetryHashes:(const long long*)symmetryHashes
+                                    symmetry:(enum GoBoardSymmetry*)symmetry;
+- (const long long*) zobristValues;
 
 @end
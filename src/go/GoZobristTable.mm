@@ -18,17 +18,27 @@
 // Project includes
 #import "GoZobristTable.h"
 #import "GoBoard.h"
+#import "GoBoardTopology.h"
 #import "GoGame.h"
 #import "GoMove.h"
 #import "GoNode.h"
 #import "GoNodeSetup.h"
 #import "GoPlayer.h"
 #import "GoPoint.h"
+#import "GoUtilities.h"
 #import "GoVertex.h"
 
 // C++ standard library
-#include <cstdlib>
-#include <ctime>
+#include <cstdint>
+
+
+/// @brief The seed of the pseudo random number generator that fills all
+/// Zobrist tables. The seed must never change, otherwise Zobrist hashes that
+/// were calculated by earlier versions of the app are no longer comparable.
+static const uint64_t zobristTableSeed = 0x4C6974746C65476FULL;
+/// @brief Shared GoZobristTable objects, keyed by board size. Is protected by
+/// @synchronized([GoZobristTable class]).
+static NSMutableDictionary* sharedZobristTables = nil;
 
 
 // -----------------------------------------------------------------------------
@@ -37,11 +47,39 @@
 @interface GoZobristTable()
 @property(nonatomic, assign) enum GoBoardSize boardSize;
 @property(nonatomic, assign) long long* zobristTable;
+@property(nonatomic, assign) long long* handicapHashes;
+@property(nonatomic, assign) GoBoardTopology* topology;
 @end
 
 
 @implementation GoZobristTable
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared GoZobristTable object for use with a board of
+/// size @a boardSize. The object is created when it is requested for the first
+/// time and then lives until the process terminates.
+///
+/// GoZobristTable objects are immutable after initialization, and all
+/// GoZobristTable objects for a given board size contain the same values. It is
+/// therefore safe to share them between GoBoard objects and between threads.
+// -----------------------------------------------------------------------------
++ (GoZobristTable*) sharedZobristTableForBoardSize:(enum GoBoardSize)boardSize
+{
+  @synchronized(self)
+  {
+    if (! sharedZobristTables)
+      sharedZobristTables = [[NSMutableDictionary alloc] init];
+    NSNumber* key = [NSNumber numberWithInt:boardSize];
+    GoZobristTable* zobristTable = [sharedZobristTables objectForKey:key];
+    if (! zobristTable)
+    {
+      zobristTable = [[[GoZobristTable alloc] initWithBoardSize:boardSize] autorelease];
+      [sharedZobristTables setObject:zobristTable forKey:key];
+    }
+    return zobristTable;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Initializes a GoZobristTable object for use with a board of size
 /// @a boardSize.
@@ -55,6 +93,9 @@
   if (! self)
     return nil;
   self.boardSize = boardSize;
+  // GoBoardTopology objects live until the process terminates, so there is no
+  // need to retain the object
+  self.topology = [GoBoardTopology sharedTopologyForBoardSize:boardSize];
   [self setupZobristTable];
   return self;
 }
@@ -65,6 +106,7 @@
 - (void) dealloc
 {
   delete[] _zobristTable;
+  delete[] _handicapHashes;
   [super dealloc];
 }
 
@@ -76,6 +118,35 @@
   [self throwIfLongLongIsLessThan8Bytes];
   _zobristTable = new long long[_boardSize * _boardSize * 2];
   [self fillZobristTableWithRandomNumbers];
+  [self setupHandicapHashes];
+}
+
+// -----------------------------------------------------------------------------
+/// Private helper invoked during initialization.
+///
+/// Precomputes the hashes for all fixed handicap layouts that are possible on
+/// the board size of this GoZobristTable, so that hashForHandicapStonesInGame:()
+/// does not have to calculate them over and over again when a new game is
+/// started. The hash for handicap 0 is 0.
+// -----------------------------------------------------------------------------
+- (void) setupHandicapHashes
+{
+  int maximumHandicap = [GoUtilities maximumHandicapForBoardSize:_boardSize];
+  _handicapHashes = new long long[maximumHandicap + 1];
+  _handicapHashes[0] = 0;
+  _handicapHashes[1] = 0;
+
+  for (int handicap = 2; handicap <= maximumHandicap; ++handicap)
+  {
+    const int* handicapPointIndexes = [GoUtilities pointIndexesForHandicap:handicap boardSize:_boardSize];
+    long long hash = 0;
+    for (int handicapStoneIndex = 0; handicapStoneIndex < handicap; ++handicapStoneIndex)
+    {
+      // Black is color index 0, so the point index is also the table index
+      hash ^= _zobristTable[handicapPointIndexes[handicapStoneIndex]];
+    }
+    _handicapHashes[handicap] = hash;
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -100,38 +171,30 @@
 // -----------------------------------------------------------------------------
 - (void) fillZobristTableWithRandomNumbers
 {
-  // Cast is required because time_t (the result of time()) and unsigned (the
-  // parameter of srand()) differ in size in 64-bit. Cast is safe because we
-  // don't care about the exact time_t value, we just want a number that is
-  // not always the same to initialize the random number generator so that we
-  // won't get the same sequence of random numbers every time.
-  srand((unsigned)time(NULL));
-  for (int vertexX = 0; vertexX < _boardSize; ++vertexX)
-  {
-    for (int vertexY = 0; vertexY < _boardSize; ++vertexY)
-    {
-      for (int color = 0; color < 2; ++color)
-      {
-        int index = (color * _boardSize * _boardSize) + (vertexY * _boardSize) + vertexX;
-        _zobristTable[index] = [self random64BitNumber];
-      }
-    }
-  }
+  // Always start with the same seed so that the table, and therefore also the
+  // Zobrist hashes, are the same across app launches
+  uint64_t state = zobristTableSeed;
+  int numberOfValues = _boardSize * _boardSize * 2;
+  for (int index = 0; index < numberOfValues; ++index)
+    _zobristTable[index] = [self random64BitNumber:&state];
 }
 
 // -----------------------------------------------------------------------------
-/// Private helper for fillZobristTableWithRandomNumbers:()
+/// Private helper for fillZobristTableWithRandomNumbers:(). Returns the next
+/// value of the SplitMix64 pseudo random number generator whose state is
+/// @a state, and advances @a state.
+///
+/// SplitMix64 is the generator that is commonly used to seed the xorshift
+/// family of generators. Its output passes BigCrush, i.e. the quality of the
+/// 64 bit values is more than sufficient for Zobrist hashing. See
+/// https://prng.di.unimi.it/splitmix64.c for the reference implementation.
 // -----------------------------------------------------------------------------
-- (long long) random64BitNumber
+- (long long) random64BitNumber:(uint64_t*)state
 {
-  // Implementation taken from
-  // https://stackoverflow.com/questions/8120062/generate-random-64-bit-integer
-  // TODO switch to an algorithm from <random> once we are allowed to use C++11
-  long long r30 = RAND_MAX*rand()+rand();
-  long long s30 = RAND_MAX*rand()+rand();
-  long long t4  = rand() & 0xf;
-  long long res = (r30 << 34) + (s30 << 4) + t4;
-  return res;
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return static_cast<long long>(z ^ (z >> 31));
 }
 
 // -----------------------------------------------------------------------------
@@ -178,6 +241,12 @@
 /// @brief Generates the Zobrist hash for a board that is empty except for the
 /// black handicap stones obtained from @a game.
 ///
+/// If the handicap stones are in the fixed handicap layout that
+/// GoUtilities::pointIndexesForHandicap:boardSize:() specifies (which is the
+/// case for all new games), the precomputed hash is returned. Otherwise, e.g.
+/// for games loaded from .sgf files that place handicap stones freely, the hash
+/// is calculated from the individual handicap stones.
+///
 /// Raises @e NSInvalidArgumentException if @a game is @e nil.
 ///
 /// Raises @e NSGenericException if the board size with which this
@@ -198,9 +267,13 @@
 
   [self throwIfTableSizeDoesNotMatchSizeOfBoard:game.board];
 
+  NSArray* handicapPoints = game.handicapPoints;
+  if ([self isFixedHandicapLayout:handicapPoints onBoard:game.board])
+    return _handicapHashes[handicapPoints.count];
+
   long long hash = 0;
 
-  for (GoPoint* handicapPoint in game.handicapPoints)
+  for (GoPoint* handicapPoint in handicapPoints)
   {
     int index = [self indexForStoneAt:handicapPoint playedByColor:GoColorBlack];
     hash ^= _zobristTable[index];
@@ -209,6 +282,31 @@
   return hash;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a handicapPoints contains exactly the GoPoint
+/// objects of the fixed handicap layout for the number of handicap stones in
+/// @a handicapPoints, in the order that
+/// GoUtilities::pointIndexesForHandicap:boardSize:() specifies. Returns false
+/// otherwise.
+///
+/// This is a private helper for hashForHandicapStonesInGame:().
+// -----------------------------------------------------------------------------
+- (bool) isFixedHandicapLayout:(NSArray*)handicapPoints onBoard:(GoBoard*)board
+{
+  int handicap = (int)handicapPoints.count;
+  if (handicap == 1 || handicap > [GoUtilities maximumHandicapForBoardSize:_boardSize])
+    return false;
+
+  const int* handicapPointIndexes = [GoUtilities pointIndexesForHandicap:handicap boardSize:_boardSize];
+  for (int handicapStoneIndex = 0; handicapStoneIndex < handicap; ++handicapStoneIndex)
+  {
+    if ([handicapPoints objectAtIndex:handicapStoneIndex] != [board pointAtIndex:handicapPointIndexes[handicapStoneIndex]])
+      return false;
+  }
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Generates the Zobrist hash for @a node.
 ///
@@ -479,6 +577,108 @@
   return hash;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the random values of this GoZobristTable. This is intended
+/// for C++ search code (e.g. GoLifeAndDeathSolver) that needs to calculate
+/// Zobrist hashes incrementally without going through GoPoint objects.
+///
+/// The array has 2 * boardSize * boardSize elements. The first half contains
+/// the values for black stones, the second half the values for white stones.
+/// Within each half the values are ordered by intersection index, i.e. in the
+/// same order as the intersections in GoBoardCore. The array remains valid for
+/// the lifetime of this GoZobristTable and never changes.
+// -----------------------------------------------------------------------------
+- (const long long*) zobristValues
+{
+  return _zobristTable;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Calculates the symmetry hashes for the current board position
+/// represented by @a board and stores them in @a symmetryHashes, which must
+/// have room for #GoBoardSymmetryMax elements.
+///
+/// Symmetry hash number @e s is the Zobrist hash of the board position that
+/// results when the board symmetry @e s is applied to the board position
+/// represented by @a board. Symmetry hash #GoBoardSymmetryIdentity is
+/// therefore the same as the hash returned by hashForBoard:(). Applying any
+/// of the board symmetries to a board position only permutes its symmetry
+/// hashes, which is why the smallest symmetry hash is a canonical hash for all
+/// board positions that are rotations or reflections of each other. See
+/// canonicalHashForSymmetryHashes:symmetry:().
+///
+/// Raises @e NSGenericException if the board size with which this
+/// GoZobristTable was initialized does not match the board size of @a board.
+// -----------------------------------------------------------------------------
+- (void) symmetryHashes:(long long*)symmetryHashes forBoard:(GoBoard*)board
+{
+  [self throwIfTableSizeDoesNotMatchSizeOfBoard:board];
+
+  for (int symmetry = 0; symmetry < GoBoardSymmetryMax; ++symmetry)
+    symmetryHashes[symmetry] = 0;
+
+  GoPoint* point = [board pointAtVertex:@"A1"];
+  while (point)
+  {
+    if (point.hasStone)
+    {
+      [self updateSymmetryHashes:symmetryHashes
+                 forStoneAtIndex:[board indexOfPoint:point]
+                       withColor:point.stoneState];
+    }
+    point = point.next;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Incrementally updates the symmetry hashes in @a symmetryHashes for a
+/// stone of color @a color that is either added to or removed from the
+/// intersection with index @a index. Adding and removing a stone are the same
+/// operation. Does nothing if @a color is #GoColorNone.
+///
+/// See symmetryHashes:forBoard:() for details about symmetry hashes.
+// -----------------------------------------------------------------------------
+- (void) updateSymmetryHashes:(long long*)symmetryHashes
+              forStoneAtIndex:(int)index
+                    withColor:(enum GoColor)color
+{
+  if (color == GoColorNone)
+    return;
+
+  int colorOffset = [self colorOfStonePlayedByColor:color] * _boardSize * _boardSize;
+  for (int symmetry = 0; symmetry < GoBoardSymmetryMax; ++symmetry)
+  {
+    int symmetricIndex = [_topology indexOfIndex:index transformedBySymmetry:(enum GoBoardSymmetry)symmetry];
+    symmetryHashes[symmetry] ^= _zobristTable[colorOffset + symmetricIndex];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the canonical hash for the board position whose symmetry
+/// hashes are @a symmetryHashes. The canonical hash is the same for all board
+/// positions that are rotations or reflections of each other.
+///
+/// If @a symmetry is not NULL, this method fills the out variable with the
+/// board symmetry that transforms the board position into the canonical board
+/// position, i.e. the board position whose Zobrist hash is the canonical hash.
+/// If several symmetries result in the same canonical hash (because the board
+/// position itself is symmetric), the first of those symmetries is returned.
+// -----------------------------------------------------------------------------
++ (long long) canonicalHashForSymmetryHashes:(const long long*)symmetryHashes
+                                    symmetry:(enum GoBoardSymmetry*)symmetry
+{
+  int canonicalSymmetry = GoBoardSymmetryIdentity;
+  for (int candidateSymmetry = 1; candidateSymmetry < GoBoardSymmetryMax; ++candidateSymmetry)
+  {
+    if (symmetryHashes[candidateSymmetry] < symmetryHashes[canonicalSymmetry])
+      canonicalSymmetry = candidateSymmetry;
+  }
+
+  if (symmetry)
+    *symmetry = (enum GoBoardSymmetry)canonicalSymmetry;
+  return symmetryHashes[canonicalSymmetry];
+}
+
 // -----------------------------------------------------------------------------
 /// Private helper
 // -----------------------------------------------------------------------------
@@ -20,6 +20,9 @@
 
 // Forward declarations
 @class GtpCommand;
+@class GtpEngine;
+@class GtpEngineState;
+@class GtpResponseCache;
 
 
 // -----------------------------------------------------------------------------
@@ -38,6 +41,16 @@
 /// property is true, submit:() blocks and waits until after the command has
 /// been processed and its answer was received.
 ///
+/// Several commands can be submitted at once via submitCommands:(). The
+/// commands are then passed on to the GtpEngine back to back, and the
+/// responses are matched to the commands in FIFO order.
+///
+/// Each GtpClient object has its own streams and its own secondary thread.
+/// Several GtpClient objects, each with its own pair of stream buffers and
+/// its own counterpart GtpEngine, can therefore be used at the same time. The
+/// only state that GtpClient objects share is the number of notification
+/// observers (see below).
+///
 /// @note As a convenience, GtpCommand is capable of submitting itself so that
 /// clients do not have to concern themselves with where to obtain an instance
 /// of GtpClient.
@@ -57,6 +70,38 @@
 /// the secondary thread that processes commands.
 ///
 ///
+/// @par Starting the engine on demand
+///
+/// GtpClient does not require its counterpart GtpEngine to be running when
+/// the GtpClient is created. If the @e engineLauncher property is set,
+/// GtpClient invokes the launcher block just before it writes the first
+/// command to the command stream. Commands that are submitted before that
+/// point are queued by the secondary thread as usual. Commands that are
+/// answered from the response cache do not cause the engine to be started.
+///
+///
+/// @par Transport failure
+///
+/// A stream buffer that transports characters to a GtpEngine on another
+/// machine (e.g. SocketStreamBuffer) can fail, in which case the response
+/// stream goes into failure state. GtpClient then invalidates its
+/// GtpEngineState and invokes the @e transportFailureHandler block, once.
+/// The command that was waiting for a response, and all commands that are
+/// processed afterwards, receive a failed response. The owner of the
+/// GtpClient is expected to replace it with a new GtpClient.
+///
+///
+/// @par Quality of service
+///
+/// The secondary thread processes each command with the quality of service
+/// requested by the command (GtpCommand's @e qualityOfService property). If
+/// the @e engine property is set, GtpClient also asks the GtpEngine to raise
+/// its quality of service while it processes a command that requests a higher
+/// quality of service than the GtpEngine normally has. Commands that are
+/// processed as a pipeline via submitCommands:() are processed with the
+/// highest quality of service requested by any of the commands.
+///
+///
 /// @par Private notification of response target
 ///
 /// In addition to #gtpResponseWasReceived, which is sent to the general public,
@@ -72,6 +117,13 @@
 ///
 /// Specification of a response target is optional. If no response target is
 /// specified for a GtpCommand, no private notification is sent.
+///
+/// Instead of a response target, a GtpCommand may also specify a completion
+/// handler block and a dispatch queue (GtpCommand's @e completionHandler and
+/// @e completionQueue properties). The completion handler is then executed
+/// asynchronously on the dispatch queue, without going through the run loop
+/// of the submitting thread. If a completion handler is specified, the
+/// response target is ignored.
 // -----------------------------------------------------------------------------
 @interface GtpClient : NSObject
 {
@@ -79,10 +131,35 @@
 
 + (GtpClient*) clientWithStreamBuffers:(NSArray*)streamBuffers;
 - (void) submit:(GtpCommand*)command;
+- (void) submitCommands:(NSArray*)commands;
 - (void) interrupt;
 
 /// @brief Set this property to true to trigger termination of the secondary
 /// thread.
 @property(assign, getter=shouldExit, setter=exit:) bool shouldExit;
+/// @brief The board state of the GTP engine, as far as it can be deduced from
+/// the GTP commands that were processed so far. Is updated with every response
+/// received from the GTP engine, before any observers are notified.
+@property(retain, readonly) GtpEngineState* engineState;
+/// @brief A block that starts the counterpart GtpEngine. Is invoked once, in
+/// the context of the secondary thread, before the first command is written
+/// to the command stream. Is @e nil if the GtpEngine has already been started,
+/// or if the GtpEngine is started by someone else.
+@property(copy) void (^engineLauncher)(void);
+/// @brief A block that is invoked when the transport to the counterpart
+/// GtpEngine has failed. Is invoked at most once, in the context of the main
+/// thread. Is @e nil if the transport cannot fail, as is the case when the
+/// GtpEngine runs in the same process.
+@property(copy) void (^transportFailureHandler)(void);
+/// @brief The counterpart GtpEngine. Is used only to adjust the quality of
+/// service of the GtpEngine. Is @e nil if the GtpEngine has not been started
+/// yet, or if it is not known to GtpClient.
+@property(retain) GtpEngine* engine;
+/// @brief The cache of GTP responses. Must be used only in the context of the
+/// secondary thread, except for reading the cache's hit and miss counters.
+@property(retain, readonly) GtpResponseCache* responseCache;
+/// @brief The time in seconds that the GtpEngine took to respond to the most
+/// recent command that was not answered from the response cache.
+@property(assign, readonly) double lastResponseTime;
 
 @end
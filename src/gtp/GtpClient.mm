@@ -25,24 +25,69 @@
 // Project includes
 #import "GtpClient.h"
 #import "GtpCommand.h"
+#import "GtpEngine.h"
+#import "GtpEngineState.h"
 #import "GtpResponse.h"
+#import "GtpResponseCache.h"
+#import "GtpUtilities.h"
+#import "../go/GoBoardTopology.h"
+#import "../diagnostics/SessionRecorder.h"
+#import "../diagnostics/SignpostLog.h"
+#import "../utility/PathUtilities.h"
 
 // System includes
+#import <os/signpost.h>
+#include <atomic>
 #include <istream>
+#include <mutex>
 #include <ostream>
+#include <pthread/qos.h>
 #include <streambuf>
+#include <string>
 
-// It would be much nicer to make these variables members of the GtpClient
-// class, but they are C++ and GtpClient.h is also #import'ed by pure
-// Objective-C implementations.
-static std::ostream* commandStream = nullptr;
-static std::istream* responseStream = nullptr;
+// The maximum number of responses that a GtpClient caches
+static const NSUInteger responseCacheCapacity = 100;
+
+// The quality of service class of the secondary thread while it does not
+// process a command
+static const NSQualityOfService clientThreadQualityOfService = NSQualityOfServiceUserInitiated;
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for GtpClient.
+///
+/// The C++ members are declared here instead of in GtpClient.h because
+/// GtpClient.h is also #import'ed by pure Objective-C implementations. Every
+/// GtpClient object has its own set of streams, so that several GtpClient
+/// objects can talk to several GtpEngine objects at the same time.
 // -----------------------------------------------------------------------------
 @interface GtpClient()
+{
+@private
+  /// @brief Stream to write commands for the GTP engine. Is valid only while
+  /// the secondary thread is running.
+  std::ostream* m_commandStream;
+  /// @brief Stream to read responses from the GTP engine. Is valid only while
+  /// the secondary thread is running.
+  std::istream* m_responseStream;
+  /// @brief Protects m_commandStream against concurrent writes by the
+  /// secondary thread (which sends commands) and other threads (which send
+  /// interrupts).
+  std::mutex m_commandStreamMutex;
+  /// @brief Each command gets a number when the secondary thread starts
+  /// waiting for its response. m_commandNumberAwaitingResponse holds that
+  /// number while the secondary thread waits, and 0 when it does not wait.
+  /// This is used to make sure that a deadline interrupts only the command it
+  /// belongs to.
+  unsigned long m_lastCommandNumber;
+  std::atomic<unsigned long> m_commandNumberAwaitingResponse;
+  /// @brief Is true after the response stream has failed. Is used only by the
+  /// secondary thread.
+  bool m_transportDidFail;
+}
 @property(retain) NSThread* thread;
+@property(retain, readwrite) GtpEngineState* engineState;
+@property(retain, readwrite) GtpResponseCache* responseCache;
+@property(assign, readwrite) double lastResponseTime;
 @end
 
 
@@ -71,10 +116,23 @@ static std::istream* responseStream = nullptr;
   if (! self)
     return nil;
 
+  m_commandStream = nullptr;
+  m_responseStream = nullptr;
+  m_lastCommandNumber = 0;
+  m_commandNumberAwaitingResponse = 0;
+  m_transportDidFail = false;
   self.shouldExit = false;
+  self.engineLauncher = nil;
+  self.transportFailureHandler = nil;
+  self.engine = nil;
+  self.engineState = [[[GtpEngineState alloc] init] autorelease];
+  self.responseCache = [[[GtpResponseCache alloc] initWithCapacity:responseCacheCapacity
+                                                           filePath:[PathUtilities gtpResponseCacheFilePath]] autorelease];
+  self.lastResponseTime = 0.0;
 
   // Create and start the thread
   self.thread = [[[NSThread alloc] initWithTarget:self selector:@selector(mainLoop:) object:streamBuffers] autorelease];
+  self.thread.qualityOfService = clientThreadQualityOfService;
   [self.thread start];
 
   // TODO: Clients that work with self returned here will invoke methods in
@@ -91,6 +149,11 @@ static std::istream* responseStream = nullptr;
 {
   // TODO implement stuff
   self.thread = nil;
+  self.engineState = nil;
+  self.engineLauncher = nil;
+  self.transportFailureHandler = nil;
+  self.engine = nil;
+  self.responseCache = nil;
   [super dealloc];
 }
 
@@ -107,13 +170,13 @@ static std::istream* responseStream = nullptr;
   NSValue* inputStreamBufferAsNSValue = [streamBuffers objectAtIndex:0];
   std::streambuf* inputStreamBuffer = reinterpret_cast<std::streambuf*>([inputStreamBufferAsNSValue pointerValue]);
   std::ostream inputStream(inputStreamBuffer);
-  commandStream = &inputStream;
+  m_commandStream = &inputStream;
 
   // Stream to read responses from the GTP engine
   NSValue* outputStreamBufferAsNSValue = [streamBuffers objectAtIndex:1];
   std::streambuf* outputStreamBuffer = reinterpret_cast<std::streambuf*>([outputStreamBufferAsNSValue pointerValue]);
   std::istream outputStream(outputStreamBuffer);
-  responseStream = &outputStream;
+  m_responseStream = &outputStream;
 
   // The timer is required because otherwise the run loop has no input source
   NSDate* distantFuture = [NSDate distantFuture];
@@ -139,9 +202,9 @@ static std::istream* responseStream = nullptr;
   }
 
   // The local objects are auto-destroyed when they go out of scope. Here we
-  // forget the global references to these local objects
-  commandStream = nullptr;
-  responseStream = nullptr;
+  // forget the member references to these local objects
+  m_commandStream = nullptr;
+  m_responseStream = nullptr;
 
   // Deallocate the autorelease pool as the very last thing in this thread
   [mainPool drain];
@@ -152,6 +215,8 @@ static std::istream* responseStream = nullptr;
 /// secondary thread's context.
 ///
 /// Performs the following operations:
+/// - If a response to @a command is cached, uses the cached response and
+///   skips the next two steps
 /// - Pass @a command to the GtpEngine
 /// - Wait for the response from the GtpEngine (blocks)
 /// - Creates a GtpResponse object using the response received from the
@@ -159,28 +224,237 @@ static std::istream* responseStream = nullptr;
 /// - If requested, invokes notifyResponseTarget:() to notify an observer
 ///   object that the response has been received; the notification occurs in
 ///   the context of the thread that submitted the command
+///
+/// The processing is wrapped in an os_signpost interval "GtpProcessCommand" of
+/// category #SignpostCategoryGtp. Nested intervals "GtpTransport" measure the
+/// time spent on passing the command to the GtpEngine and on handling the
+/// response, nested interval "GtpEngine" measures the time the GtpEngine takes
+/// to respond.
 // -----------------------------------------------------------------------------
 - (void) processCommand:(GtpCommand*)command
 {
   // Undo retain message sent to the command object by submit:()
   [command autorelease];
 
-  // Notify observers in the secondary thread context
-  [[NSNotificationCenter defaultCenter] postNotificationName:gtpCommandWillBeSubmittedNotification
-                                                      object:command];
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryGtp];
+  os_signpost_id_t signpostID = os_signpost_id_generate(signpostLog);
+  os_signpost_interval_begin(signpostLog, signpostID, "GtpProcessCommand", "%{public}@", command.command);
+  [self setThreadQualityOfService:command.qualityOfService];
+
+  NSString* cachedResponse = [self cachedResponseToCommand:command];
+  if (cachedResponse)
+  {
+    [self handleResponse:[GtpResponse response:cachedResponse toCommand:command]];
+    [self setThreadQualityOfService:clientThreadQualityOfService];
+    os_signpost_interval_end(signpostLog, signpostID, "GtpProcessCommand", "cached");
+    return;
+  }
+
+  os_signpost_interval_begin(signpostLog, signpostID, "GtpTransport");
+  bool commandWasSent = [self sendCommand:command];
+  if (commandWasSent)
+    [self flushCommandStream];  // this wakes up the engine
+  os_signpost_interval_end(signpostLog, signpostID, "GtpTransport");
+
+  if (commandWasSent)
+    [self receiveResponseToCommand:command];
+
+  [self setThreadQualityOfService:clientThreadQualityOfService];
+  os_signpost_interval_end(signpostLog, signpostID, "GtpProcessCommand");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Processes the GTP commands in @a commands as a pipeline. This method
+/// is executed in the secondary thread's context.
+///
+/// All commands are passed to the GtpEngine back to back, without waiting for
+/// a response in between. Only then are the responses read, in the same order
+/// in which the commands were passed to the GtpEngine. The GTP protocol
+/// guarantees that the GtpEngine processes commands in FIFO order. Each
+/// response is processed in the same way as processCommand:() does. Commands
+/// whose response is cached are not passed to the GtpEngine, but their cached
+/// response is still processed in the original order.
+// -----------------------------------------------------------------------------
+- (void) processCommands:(NSArray*)commands
+{
+  // Undo retain message sent to the array by submitCommands:()
+  [commands autorelease];
+
+  NSQualityOfService qualityOfService = NSQualityOfServiceBackground;
+  for (GtpCommand* command in commands)
+    qualityOfService = MAX(qualityOfService, command.qualityOfService);
+  [self setThreadQualityOfService:qualityOfService];
+
+  // For each command that expects a response, the cached response or NSNull
+  // if the response must be read from the engine
+  NSMutableArray* commandsSent = [NSMutableArray arrayWithCapacity:commands.count];
+  NSMutableArray* cachedResponses = [NSMutableArray arrayWithCapacity:commands.count];
+  bool engineMustBeWokenUp = false;
+  for (GtpCommand* command in commands)
+  {
+    NSString* cachedResponse = [self cachedResponseToCommand:command];
+    if (cachedResponse)
+    {
+      [commandsSent addObject:command];
+      [cachedResponses addObject:cachedResponse];
+    }
+    else if ([self sendCommand:command])
+    {
+      [commandsSent addObject:command];
+      [cachedResponses addObject:[NSNull null]];
+      engineMustBeWokenUp = true;
+    }
+  }
+  if (engineMustBeWokenUp)
+    [self flushCommandStream];  // this wakes up the engine
+
+  NSUInteger numberOfCommandsSent = commandsSent.count;
+  for (NSUInteger index = 0; index < numberOfCommandsSent; ++index)
+  {
+    GtpCommand* command = [commandsSent objectAtIndex:index];
+    id cachedResponse = [cachedResponses objectAtIndex:index];
+    if (cachedResponse == [NSNull null])
+      [self receiveResponseToCommand:command];
+    else
+      [self handleResponse:[GtpResponse response:cachedResponse toCommand:command]];
+  }
+
+  [self setThreadQualityOfService:clientThreadQualityOfService];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for processCommand:() and processCommands:(). Sets
+/// the quality of service of the secondary thread to @a qualityOfService.
+/// This method is executed in the secondary thread's context.
+// -----------------------------------------------------------------------------
+- (void) setThreadQualityOfService:(NSQualityOfService)qualityOfService
+{
+  qos_class_t qosClass = (qualityOfService == NSQualityOfServiceDefault)
+    ? QOS_CLASS_DEFAULT
+    : static_cast<qos_class_t>(qualityOfService);  // the numeric values are the same
+  pthread_set_qos_class_self_np(qosClass, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for processCommand:() and processCommands:(). Writes
+/// @a command to the command stream, but does not flush the stream. Returns
+/// true if the command was written, false if @a command is empty and no
+/// response must be expected.
+///
+/// Starts the GtpEngine if this is the first command that is written to the
+/// command stream.
+// -----------------------------------------------------------------------------
+- (bool) sendCommand:(GtpCommand*)command
+{
+  [self postCommandWillBeSubmittedNotification:command];
 
   // Send the command to the engine
   if (nil == command.command || 0 == [command.command length])
-    return;
+    return false;
+  [self launchEngineIfNecessary];
   const char* pchCommand = [command.command cStringUsingEncoding:[NSString defaultCStringEncoding]];
-  (*commandStream) << pchCommand << std::endl;  // this wakes up the engine
-  
+  std::lock_guard<std::mutex> lock(m_commandStreamMutex);
+  (*m_commandStream) << pchCommand << '\n';
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for sendCommand:(). Invokes the engine launcher
+/// block, if there is one, and then forgets about it so that the GtpEngine is
+/// started only once.
+// -----------------------------------------------------------------------------
+- (void) launchEngineIfNecessary
+{
+  void (^engineLauncher)(void) = self.engineLauncher;
+  if (! engineLauncher)
+    return;
+
+  DDLogInfo(@"Starting GTP engine on demand");
+  engineLauncher();
+  self.engineLauncher = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for processCommand:() and processCommands:().
+/// Returns the cached response to @a command, or @e nil if @a command has no
+/// cache key or if no response is cached under the cache key.
+///
+/// If a cached response is returned, observers are notified in the same way
+/// as if @a command were passed on to the engine.
+// -----------------------------------------------------------------------------
+- (NSString*) cachedResponseToCommand:(GtpCommand*)command
+{
+  NSString* cachedResponse = [self.responseCache responseForKey:command.cacheKey];
+  if (! cachedResponse)
+    return nil;
+  [self postCommandWillBeSubmittedNotification:command];
+  // The cached response is in the orientation of the canonical board position
+  enum GoBoardSymmetry inverseSymmetry = [GoBoardTopology inverseOfSymmetry:command.cacheSymmetry];
+  return [GtpUtilities response:cachedResponse
+          transformedBySymmetry:inverseSymmetry
+                      boardSize:command.cacheBoardSize];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for sendCommand:() and cachedResponseToCommand:().
+// -----------------------------------------------------------------------------
+- (void) postCommandWillBeSubmittedNotification:(GtpCommand*)command
+{
+  // Notify observers in the secondary thread context
+  [[NSNotificationCenter defaultCenter] postNotificationName:gtpCommandWillBeSubmittedNotification
+                                                      object:command];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for processCommand:() and processCommands:(). Makes
+/// the commands written by sendCommand:() available to the engine.
+// -----------------------------------------------------------------------------
+- (void) flushCommandStream
+{
+  std::lock_guard<std::mutex> lock(m_commandStreamMutex);
+  m_commandStream->flush();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for processCommand:() and processCommands:(). Reads
+/// the engine's response to @a command, blocking if necessary, then invokes
+/// handleResponse:().
+///
+/// Waiting for and reading the response is wrapped in an os_signpost interval
+/// "GtpEngine", handling the response in an interval "GtpTransport".
+// -----------------------------------------------------------------------------
+- (void) receiveResponseToCommand:(GtpCommand*)command
+{
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryGtp];
+  os_signpost_id_t signpostID = os_signpost_id_generate(signpostLog);
+
+  unsigned long commandNumber = ++m_lastCommandNumber;
+  m_commandNumberAwaitingResponse = commandNumber;
+
+  // The deadline is measured from the moment we start waiting for the
+  // response. For pipelined commands this is roughly the moment when the
+  // engine starts to process the command.
+  if (command.deadline > 0)
+  {
+    dispatch_time_t when = dispatch_time(DISPATCH_TIME_NOW, command.deadline * NSEC_PER_SEC);
+    dispatch_after(when, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+      [self interruptCommandWithNumber:commandNumber];
+    });
+  }
+
+  // The engine processes the command while we wait for the response
+  GtpEngine* engine = self.engine;
+  [engine beginQualityOfServiceOverride:command.qualityOfService];
+
   // Read the engine's response (blocking if necessary)
+  os_signpost_interval_begin(signpostLog, signpostID, "GtpEngine", "%{public}@", command.command);
+  CFAbsoluteTime responseWaitStartTime = CFAbsoluteTimeGetCurrent();
   std::string fullResponse;
   std::string singleLineResponse;
   while (true)
   {
-    getline(*responseStream, singleLineResponse);
+    getline(*m_responseStream, singleLineResponse);
     if (singleLineResponse.empty())
       break;
     if (! fullResponse.empty())
@@ -188,13 +462,73 @@ static std::istream* responseStream = nullptr;
     fullResponse += singleLineResponse;
   }
 
-  // Create the response object
-  NSString* nsResponse = [NSString stringWithCString:fullResponse.c_str()
-                                            encoding:[NSString defaultCStringEncoding]];
-  GtpResponse* response = [GtpResponse response:nsResponse toCommand:command];
+  m_commandNumberAwaitingResponse = 0;
+  [engine endQualityOfServiceOverride];
+  self.lastResponseTime = CFAbsoluteTimeGetCurrent() - responseWaitStartTime;
+  os_signpost_interval_end(signpostLog, signpostID, "GtpEngine");
+
+  // A failed stream never delivers anything, so the loop above ended with an
+  // empty response that GtpResponse treats as a failed response
+  if (m_responseStream->fail())
+    [self handleTransportFailure];
+
+  os_signpost_interval_begin(signpostLog, signpostID, "GtpTransport");
+  // GtpResponse creates strings only if a client asks for them
+  GtpResponse* response = [GtpResponse responseWithCString:fullResponse.c_str() toCommand:command];
+  [self handleResponse:response];
+  if (command.cacheKey && response.status)
+  {
+    NSString* canonicalResponse = [GtpUtilities response:response.rawResponse
+                                   transformedBySymmetry:command.cacheSymmetry
+                                               boardSize:command.cacheBoardSize];
+    [self.responseCache setResponse:canonicalResponse forKey:command.cacheKey];
+  }
+  os_signpost_interval_end(signpostLog, signpostID, "GtpTransport");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for receiveResponseToCommand:(). Is invoked every time
+/// that a response could not be read because the response stream has failed.
+/// Notifies the owner of the GtpClient only the first time.
+///
+/// The GtpEngineState is invalidated so that a client that still holds on to
+/// this GtpClient does not attempt an incremental synchronization.
+// -----------------------------------------------------------------------------
+- (void) handleTransportFailure
+{
+  if (m_transportDidFail)
+    return;
+  m_transportDidFail = true;
+
+  DDLogError(@"%@: GTP transport has failed", self);
+  [self.engineState invalidate];
+
+  void (^transportFailureHandler)(void) = self.transportFailureHandler;
+  if (transportFailureHandler)
+    dispatch_async(dispatch_get_main_queue(), transportFailureHandler);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for processCommand:(), processCommands:() and
+/// receiveResponseToCommand:(). Attaches @a response to the command that it
+/// belongs to, then notifies observers.
+// -----------------------------------------------------------------------------
+- (void) handleResponse:(GtpResponse*)response
+{
+  GtpCommand* command = response.command;
   command.response = response;
+  [self.engineState updateWithResponse:response];
 
-  if (response.command.responseTarget)
+  if (command.completionHandler)
+  {
+    // The block retains both the command and the completion handler, so both
+    // are still alive when the block is executed on the completion queue
+    dispatch_queue_t completionQueue = command.completionQueue ? command.completionQueue : dispatch_get_main_queue();
+    dispatch_async(completionQueue, ^{
+      command.completionHandler(command.response);
+    });
+  }
+  else if (response.command.responseTarget)
   {
     // Retain to make sure that object is still alive when it "arrives" in
     // the submitting thread
@@ -232,6 +566,9 @@ static std::istream* responseStream = nullptr;
 // -----------------------------------------------------------------------------
 - (void) submit:(GtpCommand*)command
 {
+  [[SessionRecorder sharedRecorder] recordGtpCommand:command.command];
+  [self.engineState willSubmitCommand:command];
+
   command.submittingThread = [NSThread currentThread];
   // Retain to make sure that object is still alive when it "arrives" in
   // the secondary thread
@@ -242,6 +579,45 @@ static std::istream* responseStream = nullptr;
           waitUntilDone:command.waitUntilDone];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Submits the commands in @a commands to the GtpEngine as a pipeline,
+/// i.e. the commands are passed to the GtpEngine back to back and the
+/// responses are matched to the commands in FIFO order. Submitting N commands
+/// in this way takes one round-trip to the GtpEngine instead of N.
+///
+/// This method is executed in the same thread context as submit:(). If at
+/// least one of the commands in @a commands has its @e waitUntilDone property
+/// set to true, this method does not return until the responses to all
+/// commands have been received. Otherwise this method returns immediately.
+///
+/// Because all commands are passed to the GtpEngine before the first response
+/// is read, a command that fails does not prevent the commands that follow it
+/// from being executed. The "quit" command must not be followed by other
+/// commands.
+// -----------------------------------------------------------------------------
+- (void) submitCommands:(NSArray*)commands
+{
+  bool waitUntilDone = false;
+  NSThread* submittingThread = [NSThread currentThread];
+  SessionRecorder* sessionRecorder = [SessionRecorder sharedRecorder];
+  for (GtpCommand* command in commands)
+  {
+    [sessionRecorder recordGtpCommand:command.command];
+    [self.engineState willSubmitCommand:command];
+    command.submittingThread = submittingThread;
+    if (command.waitUntilDone)
+      waitUntilDone = true;
+  }
+
+  // Retain (in the form of a copy) to make sure that the array is still alive
+  // and unchanged when it "arrives" in the secondary thread
+  NSArray* commandsCopy = [commands copy];
+  [self performSelector:@selector(processCommands:)
+               onThread:self.thread
+             withObject:commandsCopy
+          waitUntilDone:waitUntilDone];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Notifies the observer object @e command.responseTarget that a
 /// response to @a command has been received from the GtpEngine.
@@ -268,9 +644,10 @@ static std::istream* responseStream = nullptr;
 /// @brief Interrupts the GTP command currently being processed by the
 /// GtpEngine.
 ///
-/// This method is always executed in the main thread's context, in response to
-/// user interaction in the GUI. This method does not return until the
-/// interruption has been sent to the GtpEngine.
+/// This method is usually executed in the main thread's context, in response
+/// to user interaction in the GUI. It is also executed in the context of a GCD
+/// global queue when the deadline of a GtpCommand expires. This method does not
+/// return until the interruption has been sent to the GtpEngine.
 ///
 /// @note The current thread architecture does not allow the interrupt to be
 /// sent in the context of the secondary thread, because the secondary thread
@@ -291,7 +668,26 @@ static std::istream* responseStream = nullptr;
 - (void) interrupt
 {
   const char* pchCommand = "# interrupt";
-  (*commandStream) << pchCommand << std::endl;
+  std::lock_guard<std::mutex> lock(m_commandStreamMutex);
+  (*m_commandStream) << pchCommand << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Interrupts the GTP command with number @a commandNumber if the
+/// secondary thread is still waiting for the GtpEngine's response to that
+/// command. Does nothing if the response has already been received.
+///
+/// This is an internal helper that is invoked when the deadline of a
+/// GtpCommand expires. This method is executed in the context of a GCD
+/// global queue.
+// -----------------------------------------------------------------------------
+- (void) interruptCommandWithNumber:(unsigned long)commandNumber
+{
+  if (m_commandNumberAwaitingResponse != commandNumber)
+    return;
+
+  DDLogInfo(@"Deadline expired, interrupting GTP command number %lu", commandNumber);
+  [self interrupt];
 }
 
 @end
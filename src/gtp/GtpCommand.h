@@ -35,7 +35,8 @@
 /// In the latter case, a target object and selector may be specified that
 /// are invoked when the response to the command has been received. This
 /// callback always occurs in the context of the thread that the command was
-/// submitted in.
+/// submitted in. Alternatively a completion handler block may be specified
+/// that is executed on a dispatch queue chosen by the caller.
 // -----------------------------------------------------------------------------
 @interface GtpCommand : NSObject
 {
@@ -43,6 +44,10 @@
 
 + (GtpCommand*) command:(NSString*)command;
 + (GtpCommand*) asynchronousCommand:(NSString*)command responseTarget:(id)target selector:(SEL)selector;
++ (GtpCommand*) asynchronousCommand:(NSString*)command
+                    completionQueue:(dispatch_queue_t)queue
+                  completionHandler:(void (^)(GtpResponse* response))completionHandler;
++ (void) submitCommands:(NSArray*)commands;
 - (void) submit;
 
 /// @brief The GTP command string, including arguments.
@@ -72,5 +77,65 @@
 /// for this command is received. The selector must take a single GtpResponse*
 /// argument.
 @property(nonatomic, assign) SEL responseTargetSelector;
+/// @brief The block that is executed on @e completionQueue when the GTP
+/// response for this command is received. The block receives the GtpResponse
+/// object as its argument.
+///
+/// This property is ignored if @e waitUntilDone is true. If this property is
+/// set, @e responseTarget and @e responseTargetSelector are ignored.
+@property(nonatomic, copy) void (^completionHandler)(GtpResponse* response);
+/// @brief The dispatch queue on which @e completionHandler is executed. If
+/// this is @e nil, the main queue is used.
+@property(nonatomic, retain) dispatch_queue_t completionQueue;
+/// @brief The maximum time in seconds that the GTP engine may spend on
+/// processing this command. When the deadline expires while the GTP engine is
+/// still processing the command, GtpClient interrupts the GTP engine, in the
+/// same way as GtpClient::interrupt() does. For a command such as "genmove"
+/// this means that the GTP engine stops searching and responds with the best
+/// move it has found so far.
+///
+/// The default for this property is 0, which means that the command has no
+/// deadline.
+@property(nonatomic, assign) NSTimeInterval deadline;
+/// @brief The key under which GtpClient caches the response to this command.
+/// If a response is already cached under this key, GtpClient does not pass
+/// the command on to the GTP engine but uses the cached response.
+///
+/// The default for this property is @e nil, which means that the response is
+/// not cached. Only commands that do not change the state of the GTP engine
+/// may have a cache key. See GtpResponseCache for details about what the key
+/// must consist of.
+@property(nonatomic, retain) NSString* cacheKey;
+/// @brief The board symmetry that transforms the board position for which this
+/// command is submitted into the canonical board position identified by
+/// @e cacheKey. GtpClient uses this to store the response in the orientation
+/// of the canonical board position, and to transform a cached response back
+/// into the orientation of the board position for which this command is
+/// submitted.
+///
+/// The default for this property is #GoBoardSymmetryIdentity. This property is
+/// ignored if @e cacheKey is @e nil.
+@property(nonatomic, assign) enum GoBoardSymmetry cacheSymmetry;
+/// @brief The size of the board for which this command is submitted. Is
+/// required to apply @e cacheSymmetry.
+///
+/// The default for this property is #GoBoardSizeUndefined. This property is
+/// ignored if @e cacheKey is @e nil.
+@property(nonatomic, assign) enum GoBoardSize cacheBoardSize;
+/// @brief The quality of service with which GtpClient processes this command.
+/// GtpClient's secondary thread runs with this quality of service while it
+/// passes the command on to the GTP engine and waits for the response. If the
+/// quality of service is higher than the one of the GTP engine's thread,
+/// GtpClient also raises the quality of service of the GTP engine's thread
+/// for as long as the GTP engine is processing the command (see GtpEngine).
+///
+/// Commands that the user is actively waiting for, e.g. the computer
+/// generating a move for the user, should use
+/// NSQualityOfServiceUserInteractive. Commands that are part of a background
+/// analysis should use NSQualityOfServiceUtility or
+/// NSQualityOfServiceBackground.
+///
+/// The default for this property is NSQualityOfServiceUserInitiated.
+@property(nonatomic, assign) NSQualityOfService qualityOfService;
 
 @end
@@ -57,6 +57,28 @@
   return cmd;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GtpCommand instance that wraps
+/// the command string @a command, is executed asynchronously, and executes
+/// @a completionHandler on @a queue when the GTP response to this command is
+/// received. If @a queue is @e nil, the main queue is used.
+// -----------------------------------------------------------------------------
++ (GtpCommand*) asynchronousCommand:(NSString*)command
+                    completionQueue:(dispatch_queue_t)queue
+                  completionHandler:(void (^)(GtpResponse* response))completionHandler
+{
+  GtpCommand* cmd = [[GtpCommand alloc] init];
+  if (cmd)
+  {
+    cmd.command = command;
+    cmd.waitUntilDone = false;
+    cmd.completionQueue = queue;
+    cmd.completionHandler = completionHandler;
+    [cmd autorelease];
+  }
+  return cmd;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Initializes a GtpCommand object.
 ///
@@ -75,6 +97,13 @@
   self.response = nil;
   self.responseTarget = nil;
   self.responseTargetSelector = nil;
+  self.completionHandler = nil;
+  self.completionQueue = nil;
+  self.deadline = 0;
+  self.cacheKey = nil;
+  self.cacheSymmetry = GoBoardSymmetryIdentity;
+  self.cacheBoardSize = GoBoardSizeUndefined;
+  self.qualityOfService = NSQualityOfServiceUserInitiated;
 
   return self;
 }
@@ -89,6 +118,9 @@
   self.response = nil;
   self.responseTarget = nil;
   self.responseTargetSelector = nil;
+  self.completionHandler = nil;
+  self.completionQueue = nil;
+  self.cacheKey = nil;
   [super dealloc];
 }
 
@@ -118,4 +150,18 @@
   [client submit:self];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Submits the GtpCommand instances in @a commands to the application's
+/// GtpClient as a pipeline. See GtpClient::submitCommands:() for details.
+///
+/// This is a convenience method so that clients do not need to know GtpClient,
+/// or how to obtain an instance of GtpClient.
+// -----------------------------------------------------------------------------
++ (void) submitCommands:(NSArray*)commands
+{
+  DDLogInfo(@"Submitting %@", commands);
+  GtpClient* client = [ApplicationDelegate sharedDelegate].gtpClient;
+  [client submitCommands:commands];
+}
+
 @end
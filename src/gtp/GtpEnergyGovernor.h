@@ -0,0 +1,96 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GtpEngineProfile;
+
+
+/// @brief Enumerates the levels at which GtpEnergyGovernor allows the GTP
+/// engine to do work that the user is not actively waiting for.
+enum GtpEnergyGovernorLevel
+{
+  /// @brief Pondering and background analysis run as configured.
+  GtpEnergyGovernorLevelUnrestricted,
+  /// @brief Pondering runs for a reduced amount of time, background analysis
+  /// runs as configured.
+  GtpEnergyGovernorLevelReduced,
+  /// @brief Pondering is turned off, background analysis is suspended.
+  GtpEnergyGovernorLevelSuspended,
+};
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpEnergyGovernor class limits the work that the GTP engine does
+/// while the user is not waiting for it, depending on the energy and thermal
+/// conditions of the device.
+///
+/// @ingroup gtp
+///
+/// Pondering and background analysis (e.g. AnalyzeSgfFileCommand) keep the
+/// CPU busy for long periods of time. During a long review session this
+/// drains the battery and heats up the device until the system throttles the
+/// CPU, which then also slows down interactive play. GtpEnergyGovernor
+/// therefore determines a #GtpEnergyGovernorLevel from the following
+/// conditions:
+/// - The thermal state of the device (NSProcessInfo). A serious or critical
+///   thermal state suspends, a fair thermal state reduces.
+/// - Low Power Mode. If it is enabled the level is reduced.
+/// - The battery level while the device is not charging. A battery level
+///   below #energyGovernorSuspendedBatteryLevel suspends, a battery level
+///   below #energyGovernorReducedBatteryLevel reduces.
+///
+/// The most restrictive condition determines the level. When the level
+/// changes, GtpEnergyGovernor reconfigures pondering of the GTP engine
+/// according to the active GTP engine profile and the new level.
+/// GtpUtilities::restorePondering() and GtpEngineProfile::applyProfile() also
+/// consult GtpEnergyGovernor, so the profile settings are never applied in a
+/// way that contradicts the level.
+///
+/// Background analysis cooperates with GtpEnergyGovernor: It brackets its
+/// work with beginBackgroundAnalysis() and endBackgroundAnalysis(), and
+/// invokes waitUntilBackgroundAnalysisIsAllowed() before each search, which
+/// blocks while the level is #GtpEnergyGovernorLevelSuspended. While a
+/// background analysis is in progress, GtpEnergyGovernor does not touch
+/// pondering because the background analysis has turned it off.
+///
+///
+/// @par GtpEnergyGovernor life-cycle
+///
+/// GtpEnergyGovernor is a singleton. Its shared instance is created when the
+/// application sets up the GTP client, and deallocated when the application
+/// terminates. All methods can be invoked from any thread. The conditions that
+/// determine the level are monitored on the main thread.
+// -----------------------------------------------------------------------------
+@interface GtpEnergyGovernor : NSObject
+{
+}
+
++ (GtpEnergyGovernor*) sharedGovernor;
++ (void) releaseSharedGovernor;
+
+- (bool) shouldPonderWithProfile:(GtpEngineProfile*)profile;
+- (unsigned int) maxPonderTimeWithProfile:(GtpEngineProfile*)profile;
+
+- (void) beginBackgroundAnalysis;
+- (void) endBackgroundAnalysis;
+- (void) waitUntilBackgroundAnalysisIsAllowed;
+
+/// @brief The current level. Is updated whenever one of the conditions that
+/// GtpEnergyGovernor monitors changes.
+@property(atomic, assign, readonly) enum GtpEnergyGovernorLevel level;
+
+@end
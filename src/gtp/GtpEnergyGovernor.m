@@ -0,0 +1,302 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GtpEnergyGovernor.h"
+#import "GtpCommand.h"
+#import "GtpResponse.h"
+#import "GtpUtilities.h"
+#import "../main/ApplicationDelegate.h"
+#import "../player/GtpEngineProfile.h"
+#import "../player/GtpEngineProfileModel.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GtpEnergyGovernor.
+// -----------------------------------------------------------------------------
+@interface GtpEnergyGovernor()
+// Re-declare property as readwrite
+@property(atomic, assign, readwrite) enum GtpEnergyGovernorLevel level;
+/// @brief Protects @e numberOfBackgroundAnalyses, and is signalled when
+/// @e level changes.
+@property(nonatomic, retain) NSCondition* levelCondition;
+/// @brief The number of background analyses that are currently in progress.
+@property(nonatomic, assign) int numberOfBackgroundAnalyses;
+@end
+
+
+@implementation GtpEnergyGovernor
+
+#pragma mark - Handle shared object
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of GtpEnergyGovernor.
+// -----------------------------------------------------------------------------
+static GtpEnergyGovernor* sharedGovernor = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared GtpEnergyGovernor object.
+// -----------------------------------------------------------------------------
++ (GtpEnergyGovernor*) sharedGovernor
+{
+  if (! sharedGovernor)
+    sharedGovernor = [[GtpEnergyGovernor alloc] init];
+  return sharedGovernor;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared GtpEnergyGovernor object.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedGovernor
+{
+  if (sharedGovernor)
+  {
+    [sharedGovernor release];
+    sharedGovernor = nil;
+  }
+}
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpEnergyGovernor object.
+///
+/// @note This is the designated initializer of GtpEnergyGovernor.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.levelCondition = [[[NSCondition alloc] init] autorelease];
+  self.numberOfBackgroundAnalyses = 0;
+
+  [UIDevice currentDevice].batteryMonitoringEnabled = YES;
+  self.level = [self currentLevel];
+
+  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  [center addObserver:self selector:@selector(conditionDidChange:) name:NSProcessInfoThermalStateDidChangeNotification object:nil];
+  [center addObserver:self selector:@selector(conditionDidChange:) name:NSProcessInfoPowerStateDidChangeNotification object:nil];
+  [center addObserver:self selector:@selector(conditionDidChange:) name:UIDeviceBatteryLevelDidChangeNotification object:nil];
+  [center addObserver:self selector:@selector(conditionDidChange:) name:UIDeviceBatteryStateDidChangeNotification object:nil];
+
+  DDLogInfo(@"%@: Initial level is %d", self, self.level);
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GtpEnergyGovernor object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [UIDevice currentDevice].batteryMonitoringEnabled = NO;
+  self.levelCondition = nil;
+  [super dealloc];
+}
+
+#pragma mark - Pondering
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the GTP engine should ponder when it is configured
+/// with @a profile. Returns false if @a profile has pondering turned off, or
+/// if the current level is #GtpEnergyGovernorLevelSuspended.
+// -----------------------------------------------------------------------------
+- (bool) shouldPonderWithProfile:(GtpEngineProfile*)profile
+{
+  if (! profile.fuegoPondering)
+    return false;
+  return (self.level != GtpEnergyGovernorLevelSuspended);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the maximum time in seconds that the GTP engine should
+/// ponder when it is configured with @a profile. At level
+/// #GtpEnergyGovernorLevelReduced this is a fraction of the time configured in
+/// @a profile, but not less than #fuegoMaxPonderTimeMinimum.
+// -----------------------------------------------------------------------------
+- (unsigned int) maxPonderTimeWithProfile:(GtpEngineProfile*)profile
+{
+  unsigned int maxPonderTime = profile.fuegoMaxPonderTime;
+  if (self.level != GtpEnergyGovernorLevelReduced)
+    return maxPonderTime;
+
+  unsigned int reducedMaxPonderTime = maxPonderTime * energyGovernorReducedPonderTimeFraction;
+  reducedMaxPonderTime = MAX(reducedMaxPonderTime, fuegoMaxPonderTimeMinimum);
+  return MIN(reducedMaxPonderTime, maxPonderTime);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reconfigures pondering of the GTP engine according to the active GTP
+/// engine profile and the current level. Does nothing while a background
+/// analysis is in progress.
+// -----------------------------------------------------------------------------
+- (void) reconfigurePondering
+{
+  [self.levelCondition lock];
+  bool isBackgroundAnalysisInProgress = (self.numberOfBackgroundAnalyses > 0);
+  [self.levelCondition unlock];
+  if (isBackgroundAnalysisInProgress)
+    return;
+
+  GtpEngineProfile* profile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  if (! profile)
+    return;
+
+  NSString* commandString = [NSString stringWithFormat:@"uct_param_player max_ponder_time %u", [self maxPonderTimeWithProfile:profile]];
+  GtpCommand* command = [GtpCommand asynchronousCommand:commandString
+                                        completionQueue:dispatch_get_main_queue()
+                                      completionHandler:^(GtpResponse* response)
+  {
+    if (! response.status)
+      DDLogError(@"%@: Failed to change GTP engine max. ponder time: %@", self, response.rawResponse);
+  }];
+  [command submit];
+
+  [GtpUtilities restorePondering];
+}
+
+#pragma mark - Background analysis
+
+// -----------------------------------------------------------------------------
+/// @brief Notifies GtpEnergyGovernor that a background analysis begins. The
+/// caller is expected to have turned off pondering.
+// -----------------------------------------------------------------------------
+- (void) beginBackgroundAnalysis
+{
+  [self.levelCondition lock];
+  self.numberOfBackgroundAnalyses++;
+  [self.levelCondition unlock];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Notifies GtpEnergyGovernor that a background analysis has ended.
+/// The caller is expected to restore pondering afterwards.
+// -----------------------------------------------------------------------------
+- (void) endBackgroundAnalysis
+{
+  [self.levelCondition lock];
+  if (self.numberOfBackgroundAnalyses > 0)
+    self.numberOfBackgroundAnalyses--;
+  else
+    DDLogError(@"%@: endBackgroundAnalysis invoked without matching beginBackgroundAnalysis", self);
+  [self.levelCondition unlock];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Blocks the calling thread while the current level is
+/// #GtpEnergyGovernorLevelSuspended. Returns immediately if the level is
+/// different.
+///
+/// Must not be invoked on the main thread, because the main thread must
+/// remain free to receive the notifications that change the level.
+// -----------------------------------------------------------------------------
+- (void) waitUntilBackgroundAnalysisIsAllowed
+{
+  if ([NSThread isMainThread])
+  {
+    DDLogError(@"%@: waitUntilBackgroundAnalysisIsAllowed invoked on the main thread", self);
+    assert(0);
+    return;
+  }
+
+  [self.levelCondition lock];
+  if (self.level == GtpEnergyGovernorLevelSuspended)
+  {
+    DDLogInfo(@"%@: Suspending background analysis", self);
+    while (self.level == GtpEnergyGovernorLevelSuspended)
+      [self.levelCondition wait];
+    DDLogInfo(@"%@: Resuming background analysis", self);
+  }
+  [self.levelCondition unlock];
+}
+
+#pragma mark - Level determination
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the level that corresponds to the current energy and thermal
+/// conditions of the device.
+// -----------------------------------------------------------------------------
+- (enum GtpEnergyGovernorLevel) currentLevel
+{
+  NSProcessInfo* processInfo = [NSProcessInfo processInfo];
+  UIDevice* device = [UIDevice currentDevice];
+
+  bool isOnBatteryPower = (device.batteryState == UIDeviceBatteryStateUnplugged);
+  // batteryLevel is -1 if the battery level is unknown
+  float batteryLevel = device.batteryLevel;
+  bool isBatteryLevelKnown = (batteryLevel >= 0.0f);
+
+  switch (processInfo.thermalState)
+  {
+    case NSProcessInfoThermalStateSerious:
+    case NSProcessInfoThermalStateCritical:
+      return GtpEnergyGovernorLevelSuspended;
+    default:
+      break;
+  }
+  if (isOnBatteryPower && isBatteryLevelKnown && batteryLevel < energyGovernorSuspendedBatteryLevel)
+    return GtpEnergyGovernorLevelSuspended;
+
+  if (processInfo.thermalState == NSProcessInfoThermalStateFair)
+    return GtpEnergyGovernorLevelReduced;
+  if (processInfo.isLowPowerModeEnabled)
+    return GtpEnergyGovernorLevelReduced;
+  if (isOnBatteryPower && isBatteryLevelKnown && batteryLevel < energyGovernorReducedBatteryLevel)
+    return GtpEnergyGovernorLevelReduced;
+
+  return GtpEnergyGovernorLevelUnrestricted;
+}
+
+#pragma mark - Notification responders
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to all notifications that signal a change of one of the
+/// conditions that GtpEnergyGovernor monitors. Updates @e level and, if the
+/// level changed, reconfigures pondering and wakes up background analyses
+/// that are waiting.
+///
+/// The NSProcessInfo notifications are delivered on an arbitrary thread, so
+/// the work is always done on the main thread.
+// -----------------------------------------------------------------------------
+- (void) conditionDidChange:(NSNotification*)notification
+{
+  if (! [NSThread isMainThread])
+  {
+    [self performSelectorOnMainThread:@selector(conditionDidChange:) withObject:notification waitUntilDone:NO];
+    return;
+  }
+
+  enum GtpEnergyGovernorLevel newLevel = [self currentLevel];
+
+  [self.levelCondition lock];
+  enum GtpEnergyGovernorLevel oldLevel = self.level;
+  self.level = newLevel;
+  [self.levelCondition broadcast];
+  [self.levelCondition unlock];
+
+  if (newLevel == oldLevel)
+    return;
+
+  DDLogInfo(@"%@: Level changed from %d to %d", self, oldLevel, newLevel);
+  [self reconfigurePondering];
+}
+
+@end
@@ -21,12 +21,39 @@
 ///
 /// @ingroup gtp
 ///
-/// GtpClient communicates with its counterpart GtpClient via C++ Standard
-/// Library I/O streams. When GtpClient is instantiated using
+/// GtpEngine communicates with its counterpart GtpClient via C++ Standard
+/// Library I/O streams. When GtpEngine is instantiated using
 /// engineWithStreamBuffers:() it spawns a new secondary thread, then invokes
 /// the engine's main method, and finally blocks and waits for the engine's
 /// main method to return. It is expected that this happens when the engine
 /// receives a "quit" command.
+///
+/// Each GtpEngine object has its own thread and its own I/O streams, so
+/// several GtpEngine objects can be created with different pairs of stream
+/// buffers. Be aware, though, that Fuego keeps some of its state in global
+/// variables that are shared by all engine instances in the process. Most
+/// notably an interrupt sent to one engine instance aborts the search of all
+/// engine instances, and Fuego's global initialization is run again whenever
+/// an engine instance is started. A secondary engine instance should
+/// therefore be started while no other engine instance is searching, and it
+/// should not be interrupted.
+///
+///
+/// @par Quality of service
+///
+/// The secondary thread runs with the quality of service class
+/// NSQualityOfServiceUserInitiated. Fuego creates its own threads (e.g. the
+/// UCT search worker threads and the pondering thread) from within the
+/// secondary thread, these threads inherit the quality of service class of the
+/// secondary thread when they are created.
+///
+/// While a command is processed that the user is actively waiting for (e.g.
+/// the computer generating a move for the user), GtpClient can temporarily
+/// raise the quality of service of the secondary thread by invoking
+/// beginQualityOfServiceOverride:(). The override ends when GtpClient invokes
+/// endQualityOfServiceOverride(). An override can only raise, never lower the
+/// quality of service, and it does not reach the threads that Fuego has
+/// already created.
 // -----------------------------------------------------------------------------
 @interface GtpEngine : NSObject
 {
@@ -36,5 +63,7 @@
 }
 
 + (GtpEngine*) engineWithStreamBuffers:(NSArray*)streamBuffers;
+- (void) beginQualityOfServiceOverride:(NSQualityOfService)qualityOfService;
+- (void) endQualityOfServiceOverride;
 
 @end
@@ -27,8 +27,35 @@
 #include <exception>
 #include <istream>
 #include <ostream>
+#include <pthread.h>
+#include <pthread/qos.h>
 #include <streambuf>
 
+// The quality of service class of the secondary thread. Fuego's own threads
+// inherit this when they are created.
+static const NSQualityOfService engineThreadQualityOfService = NSQualityOfServiceUserInitiated;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private members for GtpEngine.
+// -----------------------------------------------------------------------------
+@interface GtpEngine()
+{
+@private
+  /// @brief The POSIX thread that underlies m_thread. Is valid only while
+  /// m_threadIsRunning is true. Is protected by @synchronized(self).
+  pthread_t m_pthread;
+  /// @brief True while the secondary thread executes mainLoop:(). Is
+  /// protected by @synchronized(self).
+  bool m_threadIsRunning;
+  /// @brief The quality of service override that is currently in effect for
+  /// the secondary thread, or NULL if there is none. Is protected by
+  /// @synchronized(self).
+  pthread_override_t m_qualityOfServiceOverride;
+}
+@end
+
+
 @implementation GtpEngine
 
 // -----------------------------------------------------------------------------
@@ -54,8 +81,12 @@
   if (! self)
     return nil;
 
+  m_threadIsRunning = false;
+  m_qualityOfServiceOverride = NULL;
+
   // Create and start the thread
   m_thread = [[NSThread alloc] initWithTarget:self selector:@selector(mainLoop:) object:streamBuffers];
+  m_thread.qualityOfService = engineThreadQualityOfService;
   [m_thread start];
 
   // TODO: Clients that work with self returned here will invoke methods in
@@ -71,6 +102,7 @@
 - (void) dealloc
 {
   // TODO implement stuff
+  [self endQualityOfServiceOverride];
   [m_thread release];
   [super dealloc];
 }
@@ -84,6 +116,12 @@
   // Create an autorelease pool as the very first thing in this thread
   NSAutoreleasePool* mainPool = [[NSAutoreleasePool alloc] init];
 
+  @synchronized(self)
+  {
+    m_pthread = pthread_self();
+    m_threadIsRunning = true;
+  }
+
   // Stream to read commands from the GTP client
   NSValue* inputStreamBufferAsNSValue = [streamBuffers objectAtIndex:0];
   std::streambuf* inputStreamBuffer = reinterpret_cast<std::streambuf*>([inputStreamBufferAsNSValue pointerValue]);
@@ -121,8 +159,56 @@
   {
   }
 
+  [self endQualityOfServiceOverride];
+  @synchronized(self)
+  {
+    m_threadIsRunning = false;
+  }
+
   // Deallocate the autorelease pool as the very last thing in this thread
   [mainPool release];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Raises the quality of service of the secondary thread to
+/// @a qualityOfService until endQualityOfServiceOverride() is invoked. Ends an
+/// override that is already in effect.
+///
+/// Does nothing if @a qualityOfService is not higher than the quality of
+/// service that the secondary thread has anyway, or if the secondary thread
+/// is not running. This method can be invoked from any thread.
+// -----------------------------------------------------------------------------
+- (void) beginQualityOfServiceOverride:(NSQualityOfService)qualityOfService
+{
+  @synchronized(self)
+  {
+    [self endQualityOfServiceOverride];
+    if (! m_threadIsRunning)
+      return;
+    if (qualityOfService == NSQualityOfServiceDefault || qualityOfService <= engineThreadQualityOfService)
+      return;
+
+    // The numeric values of NSQualityOfService and qos_class_t are the same
+    m_qualityOfServiceOverride = pthread_override_qos_class_start_np(m_pthread,
+                                                                     static_cast<qos_class_t>(qualityOfService),
+                                                                     0);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Ends the quality of service override started by
+/// beginQualityOfServiceOverride:(). Does nothing if no override is in effect.
+/// This method can be invoked from any thread.
+// -----------------------------------------------------------------------------
+- (void) endQualityOfServiceOverride
+{
+  @synchronized(self)
+  {
+    if (! m_qualityOfServiceOverride)
+      return;
+    pthread_override_qos_class_end_np(m_qualityOfServiceOverride);
+    m_qualityOfServiceOverride = NULL;
+  }
+}
+
 @end
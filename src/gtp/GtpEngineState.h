@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GtpCommand;
+@class GtpResponse;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpEngineState class keeps track of the board state of the GTP
+/// engine, as far as it can be deduced from the GTP commands that were
+/// processed by the GTP engine.
+///
+/// @ingroup gtp
+///
+/// GtpClient updates GtpEngineState with every response that it receives from
+/// the GTP engine. GtpEngineState evaluates the command that the response
+/// belongs to. A successful "clear_board" command puts GtpEngineState into a
+/// known state with an empty board. Setup commands ("gogui-setup",
+/// "gogui-setup_player") that follow are remembered as long as no moves have
+/// been played. Moves resulting from "play", "genmove" and
+/// "gogui-play_sequence" are added to the list of moves, "undo" removes the
+/// last move from the list. All other commands that change the board state of
+/// the GTP engine (e.g. "boardsize", "loadsgf"), as well as failed board
+/// state changing commands, put GtpEngineState into an unknown state.
+/// Commands that do not change the board state are ignored.
+///
+/// GtpEngineState also remembers the most recent successful "komi" command.
+/// The GTP engine keeps its komi value across "clear_board", so this is tracked
+/// separately from the board state.
+///
+/// GtpEngineState is used by SyncGTPEngineCommand to find out whether the GTP
+/// engine can be synchronized incrementally, instead of replaying the entire
+/// game.
+///
+/// GtpEngineState also keeps track of the search parameters of the GTP engine
+/// (e.g. "uct_param_player max_games 1000"). Other than the board state, the
+/// parameters are recorded when a command is submitted, not when its response
+/// is received, because GtpEngineProfile must be able to compare the
+/// parameters that it wants to apply with those that the GTP engine will
+/// have after it has processed all commands that were submitted so far. A
+/// failed parameter command causes the parameter to become unknown. Board
+/// state changes do not affect the parameters. "time_settings" is not tracked
+/// because it also resets the GTP engine's clock.
+///
+/// Moves are stored as strings of the form "<color> <vertex>", where color is
+/// "B" or "W" and vertex is either a vertex string such as "D4" or "PASS".
+/// All characters are uppercase.
+///
+/// GtpEngineState is thread-safe. It is updated in the context of the
+/// secondary thread that is used by GtpClient, but it is usually queried in
+/// the context of the main thread.
+// -----------------------------------------------------------------------------
+@interface GtpEngineState : NSObject
+{
+}
+
+- (void) updateWithResponse:(GtpResponse*)response;
+- (void) invalidate;
+- (bool) getSetupCommands:(NSArray**)setupCommands moves:(NSArray**)moves;
+- (bool) isKomiCommand:(NSString*)komiCommand;
+- (void) willSubmitCommand:(GtpCommand*)command;
+- (NSArray*) unappliedParameterCommands:(NSArray*)parameterCommands;
+
+@end
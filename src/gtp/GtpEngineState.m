@@ -0,0 +1,360 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GtpEngineState.h"
+#import "GtpCommand.h"
+#import "GtpResponse.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GtpEngineState.
+// -----------------------------------------------------------------------------
+@interface GtpEngineState()
+@property(nonatomic, assign) bool boardStateIsKnown;
+@property(nonatomic, retain) NSMutableArray* setupCommands;
+@property(nonatomic, retain) NSMutableArray* moves;
+/// @brief The most recent successful "komi" command, uppercase. @e nil if
+/// the komi value of the GTP engine is unknown.
+@property(nonatomic, retain) NSString* komiCommand;
+/// @brief Keys = Parameter names such as "UCT_PARAM_PLAYER MAX_GAMES",
+/// values = The most recently submitted command that sets the parameter,
+/// uppercase.
+@property(nonatomic, retain) NSMutableDictionary* parameterCommands;
+@end
+
+
+@implementation GtpEngineState
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpEngineState object. The board state of the GTP
+/// engine is initially unknown.
+///
+/// @note This is the designated initializer of GtpEngineState.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.boardStateIsKnown = false;
+  self.setupCommands = [NSMutableArray array];
+  self.moves = [NSMutableArray array];
+  self.komiCommand = nil;
+  self.parameterCommands = [NSMutableDictionary dictionary];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GtpEngineState object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.setupCommands = nil;
+  self.moves = nil;
+  self.komiCommand = nil;
+  self.parameterCommands = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the tracked board state with the command that @a response
+/// belongs to.
+// -----------------------------------------------------------------------------
+- (void) updateWithResponse:(GtpResponse*)response
+{
+  NSString* commandString = response.command.command;
+  if (! commandString)
+    return;
+
+  NSArray* words = [GtpEngineState wordsOfCommandString:commandString];
+  if (words.count == 0)
+    return;
+  NSString* commandName = words[0];
+
+  @synchronized(self)
+  {
+    if ([commandName isEqualToString:@"CLEAR_BOARD"])
+    {
+      if (response.status)
+      {
+        self.boardStateIsKnown = true;
+        [self.setupCommands removeAllObjects];
+        [self.moves removeAllObjects];
+      }
+      else
+      {
+        [self invalidateInternal];
+      }
+    }
+    else if ([commandName isEqualToString:@"GOGUI-SETUP"] || [commandName isEqualToString:@"GOGUI-SETUP_PLAYER"])
+    {
+      if (response.status && self.moves.count == 0)
+        [self.setupCommands addObject:commandString];
+      else
+        [self invalidateInternal];
+    }
+    else if ([commandName isEqualToString:@"PLAY"] || [commandName isEqualToString:@"GOGUI-PLAY_SEQUENCE"])
+    {
+      if (response.status && words.count % 2 == 1)
+      {
+        for (NSUInteger indexOfWord = 1; indexOfWord < words.count; indexOfWord += 2)
+          [self addMoveWithColor:words[indexOfWord] vertex:words[indexOfWord + 1]];
+      }
+      else
+      {
+        [self invalidateInternal];
+      }
+    }
+    else if ([commandName isEqualToString:@"GENMOVE"])
+    {
+      NSString* vertex = [[response.parsedResponse uppercaseString] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+      if (response.status && words.count == 2 && vertex.length > 0)
+      {
+        // The computer player resigning does not change the board state
+        if (! [vertex isEqualToString:@"RESIGN"])
+          [self addMoveWithColor:words[1] vertex:vertex];
+      }
+      else
+      {
+        [self invalidateInternal];
+      }
+    }
+    else if ([commandName isEqualToString:@"KOMI"])
+    {
+      self.komiCommand = response.status ? [commandString uppercaseString] : nil;
+    }
+    else if ([GtpEngineState parameterNameWithWords:words])
+    {
+      // The parameter was recorded by willSubmitCommand:()
+      if (! response.status)
+      {
+        NSString* parameterName = [GtpEngineState parameterNameWithWords:words];
+        NSString* parameterCommand = [words componentsJoinedByString:@" "];
+        if ([self.parameterCommands[parameterName] isEqualToString:parameterCommand])
+          [self.parameterCommands removeObjectForKey:parameterName];
+      }
+    }
+    else if ([commandName isEqualToString:@"UNDO"])
+    {
+      if (response.status && self.moves.count > 0)
+        [self.moves removeLastObject];
+      else
+        [self invalidateInternal];
+    }
+    else if ([[GtpEngineState otherBoardStateChangingCommands] containsObject:commandName])
+    {
+      [self invalidateInternal];
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Puts GtpEngineState into an unknown state. The next synchronization
+/// of the GTP engine will replay the entire game.
+// -----------------------------------------------------------------------------
+- (void) invalidate
+{
+  @synchronized(self)
+  {
+    [self invalidateInternal];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the board state of the GTP engine is known, false if
+/// it is unknown. If the board state is known, fills the out parameters
+/// @a setupCommands and @a moves with copies of the setup commands and the
+/// moves that were processed by the GTP engine since the last "clear_board"
+/// command. If the board state is unknown, the out parameters are not
+/// touched.
+// -----------------------------------------------------------------------------
+- (bool) getSetupCommands:(NSArray**)setupCommands moves:(NSArray**)moves
+{
+  @synchronized(self)
+  {
+    if (! self.boardStateIsKnown)
+      return false;
+
+    *setupCommands = [[self.setupCommands copy] autorelease];
+    *moves = [[self.moves copy] autorelease];
+    return true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a komiCommand is the same as the most recent
+/// successful "komi" command, i.e. if submitting @a komiCommand would not
+/// change the komi value of the GTP engine. Returns false if the komi value of
+/// the GTP engine is unknown.
+// -----------------------------------------------------------------------------
+- (bool) isKomiCommand:(NSString*)komiCommand
+{
+  @synchronized(self)
+  {
+    return [self.komiCommand isEqualToString:[komiCommand uppercaseString]];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Records the search parameter that @a command sets, if @a command is
+/// a parameter command. Is invoked by GtpClient when @a command is submitted,
+/// before the command is processed.
+// -----------------------------------------------------------------------------
+- (void) willSubmitCommand:(GtpCommand*)command
+{
+  NSArray* words = [GtpEngineState wordsOfCommandString:command.command];
+  NSString* parameterName = [GtpEngineState parameterNameWithWords:words];
+  if (! parameterName)
+    return;
+
+  @synchronized(self)
+  {
+    self.parameterCommands[parameterName] = [words componentsJoinedByString:@" "];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns those command strings in @a parameterCommands that would
+/// change the search parameters of the GTP engine, in their original order.
+/// A command string is omitted only if it is known to set a parameter to the
+/// value that the parameter already has. Command strings that are not
+/// parameter commands are always returned.
+// -----------------------------------------------------------------------------
+- (NSArray*) unappliedParameterCommands:(NSArray*)parameterCommands
+{
+  NSMutableArray* unappliedParameterCommands = [NSMutableArray arrayWithCapacity:parameterCommands.count];
+  @synchronized(self)
+  {
+    for (NSString* commandString in parameterCommands)
+    {
+      NSArray* words = [GtpEngineState wordsOfCommandString:commandString];
+      NSString* parameterName = [GtpEngineState parameterNameWithWords:words];
+      if (parameterName && [self.parameterCommands[parameterName] isEqualToString:[words componentsJoinedByString:@" "]])
+        continue;
+      [unappliedParameterCommands addObject:commandString];
+    }
+  }
+  return unappliedParameterCommands;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Must be invoked while holding the lock on @e self.
+// -----------------------------------------------------------------------------
+- (void) invalidateInternal
+{
+  self.boardStateIsKnown = false;
+  [self.setupCommands removeAllObjects];
+  [self.moves removeAllObjects];
+  self.komiCommand = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for updateWithResponse:(). Must be invoked while
+/// holding the lock on @e self. @a color and @a vertex must be uppercase.
+// -----------------------------------------------------------------------------
+- (void) addMoveWithColor:(NSString*)color vertex:(NSString*)vertex
+{
+  if (! self.boardStateIsKnown)
+    return;
+
+  // GTP allows both "B" and "BLACK" (and the same for white)
+  NSString* colorString = [color substringToIndex:1];
+  [self.moves addObject:[NSString stringWithFormat:@"%@ %@", colorString, vertex]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for updateWithResponse:(). Returns the uppercase names
+/// of those GTP commands that change the board state of the GTP engine in a
+/// way that GtpEngineState does not track.
+// -----------------------------------------------------------------------------
++ (NSSet*) otherBoardStateChangingCommands
+{
+  static NSSet* otherBoardStateChangingCommands = nil;
+  if (! otherBoardStateChangingCommands)
+  {
+    otherBoardStateChangingCommands = [[NSSet setWithObjects:
+                                        @"BOARDSIZE",
+                                        @"FIXED_HANDICAP",
+                                        @"PLACE_FREE_HANDICAP",
+                                        @"SET_FREE_HANDICAP",
+                                        @"LOADSGF",
+                                        @"GG-UNDO",
+                                        @"KGS-GENMOVE_CLEANUP",
+                                        @"QUIT",
+                                        nil] retain];
+  }
+  return otherBoardStateChangingCommands;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the words of @a commandString, uppercase.
+/// Returns an empty array if @a commandString is @e nil.
+// -----------------------------------------------------------------------------
++ (NSArray*) wordsOfCommandString:(NSString*)commandString
+{
+  if (! commandString)
+    return @[];
+  NSArray* words = [[commandString uppercaseString] componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+  return [words filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"length > 0"]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the name of the search parameter that is set
+/// by the command that consists of @a words, or @e nil if the command is not a
+/// parameter command. @a words must be uppercase.
+///
+/// Commands such as "uct_param_player" set one of several parameters, the
+/// parameter name then also includes the first argument (e.g.
+/// "UCT_PARAM_PLAYER MAX_GAMES"). A command that only queries a parameter
+/// (i.e. that has no value argument) is not a parameter command.
+// -----------------------------------------------------------------------------
++ (NSString*) parameterNameWithWords:(NSArray*)words
+{
+  static NSSet* singleParameterCommands = nil;
+  static NSSet* multiParameterCommands = nil;
+  if (! singleParameterCommands)
+  {
+    singleParameterCommands = [[NSSet setWithObjects:
+                                @"UCT_MAX_MEMORY",
+                                nil] retain];
+    multiParameterCommands = [[NSSet setWithObjects:
+                               @"GO_PARAM",
+                               @"GO_PARAM_RULES",
+                               @"UCT_PARAM_GLOBALSEARCH",
+                               @"UCT_PARAM_PLAYER",
+                               @"UCT_PARAM_POLICY",
+                               @"UCT_PARAM_SEARCH",
+                               nil] retain];
+  }
+
+  if (words.count == 2 && [singleParameterCommands containsObject:words[0]])
+    return words[0];
+  else if (words.count == 3 && [multiParameterCommands containsObject:words[0]])
+    return [NSString stringWithFormat:@"%@ %@", words[0], words[1]];
+  else
+    return nil;
+}
+
+@end
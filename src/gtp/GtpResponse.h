@@ -15,27 +15,60 @@
 // -----------------------------------------------------------------------------
 
 
+// Project includes
+#import "../go/GoVertexNumeric.h"
+
 // Forward declarations
 @class GtpCommand;
 
 
+/// @brief Enumerates the kinds of moves that a GTP engine can respond with,
+/// e.g. to the GTP command "genmove".
+enum GtpResponseMoveType
+{
+  GtpResponseMoveTypePlay,     ///< @brief The response is a vertex.
+  GtpResponseMoveTypePass,     ///< @brief The response is "pass".
+  GtpResponseMoveTypeResign,   ///< @brief The response is "resign".
+};
+
+
 // -----------------------------------------------------------------------------
 /// @brief The GtpResponse class represents a Go Text Protocol (GTP) response.
 ///
 /// @ingroup gtp
 ///
-/// GtpResponse is mainly a wrapper around a string that forms the actual GTP
+/// GtpResponse is a wrapper around the bytes that form the actual GTP
 /// response. The raw response includes the status prefix, while the parsed
 /// response does not.
+///
+/// GtpResponse does not process the bytes until a client asks for something.
+/// Many responses are only checked for their status (e.g. the responses to
+/// the commands that SyncGTPEngineCommand submits to set up a game), which
+/// GtpResponse determines from the first byte without creating a string. The
+/// @e rawResponse and @e parsedResponse strings are created on first access
+/// and then kept. The parse...() methods scan the bytes directly, they are
+/// the preferred way to obtain structured data from a response.
+///
+/// GtpResponse is immutable and can be used from any thread.
 // -----------------------------------------------------------------------------
 @interface GtpResponse : NSObject
 {
 }
 
 + (GtpResponse*) response:(NSString*)response toCommand:(GtpCommand*)command;
++ (GtpResponse*) responseWithCString:(const char*)response toCommand:(GtpCommand*)command;
 - (NSString*) parsedResponse;
+- (bool) parseMoveType:(enum GtpResponseMoveType*)moveType
+                vertex:(struct GoVertexNumeric*)vertex;
+- (bool) parseNumberMatrixWithNumberOfRows:(int)numberOfRows
+                           numberOfColumns:(int)numberOfColumns
+                                    values:(float*)values;
+- (bool) parseVertexListWithMaximumNumberOfVertexes:(int)maximumNumberOfVertexes
+                                           vertexes:(struct GoVertexNumeric*)vertexes
+                                   numberOfVertexes:(int*)numberOfVertexes;
 
-/// @brief The raw response string, which includes the status prefix.
+/// @brief The raw response string, which includes the status prefix. The
+/// string is created on first access.
 @property(nonatomic, retain, readonly) NSString* rawResponse;
 /// @brief The GtpCommand object that this GtpResponse "belongs" to.
 ///
@@ -28,9 +28,67 @@
 @property(nonatomic, retain, readwrite) NSString* rawResponse;
 @property(nonatomic, assign, readwrite) GtpCommand* command;
 //@}
+/// @brief The bytes of the raw response, including the status prefix. The
+/// data object contains a terminating zero byte that is not part of the
+/// response, so that the bytes can be scanned as a C string.
+@property(nonatomic, retain) NSData* responseData;
+/// @brief Cache for the string returned by parsedResponse().
+@property(nonatomic, retain) NSString* parsedResponseCache;
 @end
 
 
+// -----------------------------------------------------------------------------
+/// @brief Returns true if @a character is a whitespace character that can
+/// separate the elements of a GTP response.
+// -----------------------------------------------------------------------------
+static inline bool isResponseWhitespace(char character)
+{
+  return (character == ' ' || character == '\t' || character == '\r' || character == '\n');
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Parses the vertex at @a *cursor, e.g. "C13", using the same
+/// conversion rules as GoVertex. The vertex must be followed by whitespace or
+/// by the end of the response. Returns true and advances @a *cursor to the
+/// character after the vertex if parsing was successful. Returns false if
+/// @a *cursor does not point to a vertex.
+// -----------------------------------------------------------------------------
+static bool parseVertex(const char** cursor, struct GoVertexNumeric* vertex)
+{
+  const char* position = *cursor;
+
+  // Letter axis compound. The letter "I" is not used, so letters after "H"
+  // are shifted by one to close the gap.
+  char letter = toupper(*position);
+  if (letter < 'A' || letter > 'Z' || letter == 'I')
+    return false;
+  int x = letter - 'A' + 1;
+  if (letter > 'H')
+    x--;
+  position++;
+
+  // Number axis compound
+  int y = 0;
+  const char* numberStart = position;
+  while (*position >= '0' && *position <= '9')
+  {
+    y = y * 10 + (*position - '0');
+    position++;
+    if (y > 19)
+      return false;
+  }
+  if (position == numberStart || y < 1 || x > 19)
+    return false;
+  if (*position != '\0' && ! isResponseWhitespace(*position))
+    return false;
+
+  vertex->x = x;
+  vertex->y = y;
+  *cursor = position;
+  return true;
+}
+
+
 @implementation GtpResponse
 
 // -----------------------------------------------------------------------------
@@ -38,11 +96,26 @@
 /// the response string @a response, and is a response to @a command.
 // -----------------------------------------------------------------------------
 + (GtpResponse*) response:(NSString*)response toCommand:(GtpCommand*)command
+{
+  GtpResponse* resp = [GtpResponse responseWithCString:[response UTF8String] toCommand:command];
+  // Save the work of converting the bytes back into a string
+  resp.rawResponse = response;
+  return resp;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GtpResponse instance that holds a
+/// copy of the zero-terminated response bytes @a response, and is a response
+/// to @a command.
+// -----------------------------------------------------------------------------
++ (GtpResponse*) responseWithCString:(const char*)response toCommand:(GtpCommand*)command
 {
   GtpResponse* resp = [[GtpResponse alloc] init];
   if (resp)
   {
-    resp.rawResponse = response;
+    // Include the terminating zero byte
+    if (response)
+      resp.responseData = [NSData dataWithBytes:response length:strlen(response) + 1];
     resp.command = command;
     [resp autorelease];
     DDLogInfo(@"Received %@ (to %@)", resp, command);
@@ -64,6 +137,8 @@
 
   self.rawResponse = nil;
   self.command = nil;
+  self.responseData = nil;
+  self.parsedResponseCache = nil;
 
   return self;
 }
@@ -75,6 +150,8 @@
 {
   self.rawResponse = nil;
   self.command = nil;
+  self.responseData = nil;
+  self.parsedResponseCache = nil;
   [super dealloc];
 }
 
@@ -88,7 +165,42 @@
 {
   // Don't use self to access properties to avoid unnecessary overhead during
   // debugging
-  return [NSString stringWithFormat:@"GtpResponse(%p): %@", self, _rawResponse];
+  return [NSString stringWithFormat:@"GtpResponse(%p): %s", self, (const char*)_responseData.bytes];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the zero-terminated response bytes, or NULL
+/// if this GtpResponse has no response.
+// -----------------------------------------------------------------------------
+- (const char*) responseBytes
+{
+  return (const char*)self.responseData.bytes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the zero-terminated response bytes without
+/// the status prefix, or NULL if this GtpResponse has no response or the
+/// response is too short to have a status prefix.
+// -----------------------------------------------------------------------------
+- (const char*) responseBytesWithoutStatus
+{
+  // The data includes the terminating zero byte
+  if (self.responseData.length < 3)
+    return NULL;
+  return [self responseBytes] + 2;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSString*) rawResponse
+{
+  @synchronized(self)
+  {
+    if (! _rawResponse && _responseData)
+      _rawResponse = [[NSString alloc] initWithCString:[self responseBytes] encoding:[NSString defaultCStringEncoding]];
+    return [[_rawResponse retain] autorelease];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -97,25 +209,198 @@
 // -----------------------------------------------------------------------------
 - (NSString*) parsedResponse
 {
-  if (! self.rawResponse)
+  if (! self.responseData)
     return nil;
-  // Remove status
-  NSString* parsedResponse = [self.rawResponse substringFromIndex:2];
-  return [[parsedResponse retain] autorelease];
+
+  @synchronized(self)
+  {
+    if (! _parsedResponseCache)
+    {
+      const char* bytes = [self responseBytesWithoutStatus];
+      if (bytes)
+        _parsedResponseCache = [[NSString alloc] initWithCString:bytes encoding:[NSString defaultCStringEncoding]];
+      else
+        _parsedResponseCache = [@"" retain];
+    }
+    return [[_parsedResponseCache retain] autorelease];
+  }
 }
 
 // -----------------------------------------------------------------------------
-// Property is documented in the header file.
+/// @brief Parses the response as a matrix of numbers that has @a numberOfRows
+/// lines, each line consisting of @a numberOfColumns numbers separated by
+/// whitespace. Lines that are empty are ignored. Returns true if parsing was
+/// successful, false if the response does not have the expected format.
+///
+/// The numbers are stored in @a values in row-major order, i.e. the first
+/// @a numberOfColumns elements of @a values receive the numbers from the first
+/// line. The caller must make sure that @a values has room for
+/// @a numberOfRows * @a numberOfColumns elements. If parsing fails the content
+/// of @a values is undefined.
+///
+/// This is much faster than splitting the parsed response string into lines
+/// and words, because the response is scanned only once and no intermediate
+/// objects are created. This matters for responses that contain one number
+/// for each intersection of the board, such as the response to the GTP
+/// command "uct_stat_territory".
 // -----------------------------------------------------------------------------
-- (bool) status
+- (bool) parseNumberMatrixWithNumberOfRows:(int)numberOfRows
+                           numberOfColumns:(int)numberOfColumns
+                                    values:(float*)values
 {
-  if (! self.rawResponse)
+  const char* cursor = [self responseBytesWithoutStatus];
+  if (! cursor)
     return false;
-  NSString* statusString = [self.rawResponse substringWithRange:NSMakeRange(0, 1)];
-  if (NSOrderedSame == [statusString compare:@"="])
-    return true;
+
+  int row = 0;
+  while (*cursor != '\0')
+  {
+    const char* lineEnd = strchr(cursor, '\n');
+    if (! lineEnd)
+      lineEnd = cursor + strlen(cursor);
+
+    int column = 0;
+    while (cursor < lineEnd)
+    {
+      if (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')
+      {
+        cursor++;
+        continue;
+      }
+
+      if (row >= numberOfRows || column >= numberOfColumns)
+        return false;
+
+      char* numberEnd;
+      float value = strtof(cursor, &numberEnd);
+      if (numberEnd == cursor || numberEnd > lineEnd)
+        return false;
+
+      values[row * numberOfColumns + column] = value;
+      column++;
+      cursor = numberEnd;
+    }
+
+    if (column > 0)
+    {
+      if (column != numberOfColumns)
+        return false;
+      row++;
+    }
+
+    if (*lineEnd != '\0')
+      cursor = lineEnd + 1;
+    else
+      cursor = lineEnd;
+  }
+
+  return (row == numberOfRows);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Parses the response as a list of vertexes separated by whitespace,
+/// e.g. "A1 C13 T19". The list may span several lines. Returns true if parsing
+/// was successful, false if the response does not have the expected format or
+/// contains more than @a maximumNumberOfVertexes vertexes.
+///
+/// The vertexes are stored in @a vertexes in the order in which they appear in
+/// the response, using the same conversion rules as GoVertex. The number of
+/// vertexes found is stored in @a numberOfVertexes. The caller must make sure
+/// that @a vertexes has room for @a maximumNumberOfVertexes elements. If
+/// parsing fails the content of @a vertexes and @a numberOfVertexes is
+/// undefined.
+///
+/// Like parseNumberMatrixWithNumberOfRows:numberOfColumns:values:(), this
+/// scans the response once and creates no intermediate objects. This matters
+/// for responses such as the one to the GTP command "final_status_list dead".
+// -----------------------------------------------------------------------------
+- (bool) parseVertexListWithMaximumNumberOfVertexes:(int)maximumNumberOfVertexes
+                                           vertexes:(struct GoVertexNumeric*)vertexes
+                                   numberOfVertexes:(int*)numberOfVertexes
+{
+  const char* cursor = [self responseBytesWithoutStatus];
+  if (! cursor)
+    return false;
+
+  int vertexCount = 0;
+  while (*cursor != '\0')
+  {
+    if (isResponseWhitespace(*cursor))
+    {
+      cursor++;
+      continue;
+    }
+
+    if (vertexCount >= maximumNumberOfVertexes)
+      return false;
+    if (! parseVertex(&cursor, &vertexes[vertexCount]))
+      return false;
+    vertexCount++;
+  }
+
+  *numberOfVertexes = vertexCount;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Parses the response as a single move, i.e. a vertex such as "C13",
+/// or one of the words "pass" or "resign" (case insensitive). Leading and
+/// trailing whitespace is ignored. Returns true if parsing was successful,
+/// false if the response does not have the expected format.
+///
+/// The kind of move is stored in @a moveType. If the move is
+/// #GtpResponseMoveTypePlay the vertex is stored in @a vertex, using the same
+/// conversion rules as GoVertex, otherwise the content of @a vertex is
+/// undefined. If parsing fails the content of @a moveType and @a vertex is
+/// undefined.
+///
+/// Like the other parse...() methods, this scans the response without
+/// creating intermediate objects. This is the method to use for responses to
+/// the GTP command "genmove".
+// -----------------------------------------------------------------------------
+- (bool) parseMoveType:(enum GtpResponseMoveType*)moveType
+                vertex:(struct GoVertexNumeric*)vertex
+{
+  const char* cursor = [self responseBytesWithoutStatus];
+  if (! cursor)
+    return false;
+
+  while (isResponseWhitespace(*cursor))
+    cursor++;
+
+  if (strncasecmp(cursor, "pass", 4) == 0)
+  {
+    *moveType = GtpResponseMoveTypePass;
+    cursor += 4;
+  }
+  else if (strncasecmp(cursor, "resign", 6) == 0)
+  {
+    *moveType = GtpResponseMoveTypeResign;
+    cursor += 6;
+  }
+  else if (parseVertex(&cursor, vertex))
+  {
+    *moveType = GtpResponseMoveTypePlay;
+  }
   else
+  {
+    return false;
+  }
+
+  while (isResponseWhitespace(*cursor))
+    cursor++;
+  return (*cursor == '\0');
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (bool) status
+{
+  const char* bytes = [self responseBytes];
+  if (! bytes)
     return false;
+  return (bytes[0] == '=');
 }
 
 @end
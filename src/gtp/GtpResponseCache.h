@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpResponseCache class remembers the raw responses of GTP
+/// commands, so that GtpClient does not have to ask the GTP engine again for a
+/// response it has already received.
+///
+/// @ingroup gtp
+///
+/// Responses are cached under a key that the submitter of a GtpCommand stores
+/// in the command's @e cacheKey property. Only the responses of successful
+/// commands are cached. The key must identify everything that influences the
+/// response: The command string, the board position (usually in the form of a
+/// Zobrist hash), and the GTP engine settings that are relevant for the
+/// command. The cache only makes sense for commands that do not change the
+/// state of the GTP engine, because a cached command is never passed on to
+/// the GTP engine.
+///
+/// GtpResponseCache holds a limited number of responses. When the limit is
+/// reached, the least recently used response is discarded.
+///
+/// If GtpResponseCache is initialized with a file path, it stores its content
+/// in that file so that cached responses survive an app restart. This works
+/// because Zobrist hashes are deterministic: GoZobristTable generates its
+/// random numbers from a fixed seed, so the same board position has the same
+/// Zobrist hash in every game and after every app launch. The file is read
+/// lazily when the cache is used for the first time, and it is written when
+/// the app enters the background, and when the cache is deallocated. The file
+/// is tagged with the app version. Its content is discarded after the app has
+/// been updated, because a different GTP engine build may respond differently.
+///
+/// GtpClient uses GtpResponseCache in the context of its secondary thread,
+/// the content is written to the file in the context of the main thread. All
+/// methods are therefore synchronized.
+// -----------------------------------------------------------------------------
+@interface GtpResponseCache : NSObject
+{
+}
+
+- (id) initWithCapacity:(NSUInteger)capacity;
+- (id) initWithCapacity:(NSUInteger)capacity filePath:(NSString*)filePath;
+- (NSString*) responseForKey:(NSString*)key;
+- (void) setResponse:(NSString*)response forKey:(NSString*)key;
+- (void) removeAllResponses;
+- (void) writeToFileIfNecessary;
+
+/// @brief The maximum number of responses that the cache holds.
+@property(nonatomic, assign, readonly) NSUInteger capacity;
+/// @brief The full path to the file in which the cache stores its content.
+/// @e nil if the content is not stored in a file.
+@property(nonatomic, retain, readonly) NSString* filePath;
+/// @brief The number of times that responseForKey:() found a response.
+@property(atomic, assign, readonly) unsigned long long numberOfHits;
+/// @brief The number of times that responseForKey:() was invoked with a key
+/// and did not find a response.
+@property(atomic, assign, readonly) unsigned long long numberOfMisses;
+
+@end
@@ -0,0 +1,295 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GtpResponseCache.h"
+#import "../utility/VersionInfoUtilities.h"
+
+
+// Keys of the dictionary that is stored in the cache file
+static NSString* applicationVersionKey = @"ApplicationVersion";
+static NSString* responseKeysKey = @"ResponseKeys";
+static NSString* responsesKey = @"Responses";
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GtpResponseCache.
+// -----------------------------------------------------------------------------
+@interface GtpResponseCache()
+@property(nonatomic, assign, readwrite) NSUInteger capacity;
+@property(nonatomic, retain, readwrite) NSString* filePath;
+@property(atomic, assign, readwrite) unsigned long long numberOfHits;
+@property(atomic, assign, readwrite) unsigned long long numberOfMisses;
+@property(nonatomic, retain) NSMutableDictionary* responses;
+/// @brief The keys of all cached responses, ordered from least recently used
+/// to most recently used.
+@property(nonatomic, retain) NSMutableArray* keysInUsageOrder;
+/// @brief True if the cache file still has to be read.
+@property(nonatomic, assign) bool needsReadFromFile;
+/// @brief True if the in-memory content has changes that have not yet been
+/// written to the cache file.
+@property(nonatomic, assign) bool needsWriteToFile;
+@end
+
+
+@implementation GtpResponseCache
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpResponseCache object that holds at most
+/// @a capacity responses. The content of the cache is not stored in a file.
+// -----------------------------------------------------------------------------
+- (id) initWithCapacity:(NSUInteger)capacity
+{
+  return [self initWithCapacity:capacity filePath:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpResponseCache object that holds at most
+/// @a capacity responses and that stores its content in the file
+/// @a filePath. If @a filePath is @e nil the content is not stored in a file.
+///
+/// @note This is the designated initializer of GtpResponseCache.
+// -----------------------------------------------------------------------------
+- (id) initWithCapacity:(NSUInteger)capacity filePath:(NSString*)filePath
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.capacity = capacity;
+  self.filePath = filePath;
+  self.responses = [NSMutableDictionary dictionaryWithCapacity:capacity];
+  self.keysInUsageOrder = [NSMutableArray arrayWithCapacity:capacity];
+  self.needsReadFromFile = (filePath != nil);
+  self.needsWriteToFile = false;
+  self.numberOfHits = 0;
+  self.numberOfMisses = 0;
+
+  if (filePath)
+  {
+    NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+    [center addObserver:self selector:@selector(applicationDidEnterBackground:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+  }
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GtpResponseCache object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [self writeToFileIfNecessary];
+
+  self.filePath = nil;
+  self.responses = nil;
+  self.keysInUsageOrder = nil;
+  [super dealloc];
+}
+
+#pragma mark - Notification responders
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #UIApplicationDidEnterBackgroundNotification
+/// notification.
+// -----------------------------------------------------------------------------
+- (void) applicationDidEnterBackground:(NSNotification*)notification
+{
+  [self writeToFileIfNecessary];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the response that is cached under @a key. Returns @e nil if
+/// no response is cached under @a key, or if @a key is @e nil.
+///
+/// The response becomes the most recently used response.
+// -----------------------------------------------------------------------------
+- (NSString*) responseForKey:(NSString*)key
+{
+  if (! key)
+    return nil;
+
+  @synchronized(self)
+  {
+    [self readFromFileIfNecessary];
+
+    NSString* response = [self.responses objectForKey:key];
+    if (response)
+    {
+      [self.keysInUsageOrder removeObject:key];
+      [self.keysInUsageOrder addObject:key];
+      self.numberOfHits++;
+    }
+    else
+    {
+      self.numberOfMisses++;
+    }
+
+    // The caller may use the response after another thread has discarded it
+    return [[response retain] autorelease];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Caches @a response under @a key. If the cache is full, discards the
+/// least recently used response to make room.
+///
+/// The response becomes the most recently used response.
+// -----------------------------------------------------------------------------
+- (void) setResponse:(NSString*)response forKey:(NSString*)key
+{
+  if (! key || ! response || 0 == self.capacity)
+    return;
+
+  @synchronized(self)
+  {
+    [self readFromFileIfNecessary];
+
+    if ([self.responses objectForKey:key])
+    {
+      [self.keysInUsageOrder removeObject:key];
+    }
+    else if (self.keysInUsageOrder.count >= self.capacity)
+    {
+      NSString* leastRecentlyUsedKey = [self.keysInUsageOrder objectAtIndex:0];
+      [self.responses removeObjectForKey:leastRecentlyUsedKey];
+      [self.keysInUsageOrder removeObjectAtIndex:0];
+    }
+
+    [self.responses setObject:response forKey:key];
+    [self.keysInUsageOrder addObject:key];
+    self.needsWriteToFile = (self.filePath != nil);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards all cached responses.
+// -----------------------------------------------------------------------------
+- (void) removeAllResponses
+{
+  @synchronized(self)
+  {
+    // The content of the file is discarded, too
+    self.needsReadFromFile = false;
+    [self.responses removeAllObjects];
+    [self.keysInUsageOrder removeAllObjects];
+    self.needsWriteToFile = (self.filePath != nil);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Writes the content of the cache to the cache file if the content has
+/// changed since the file was last written. Does nothing if the content has
+/// not changed, or if the content of the cache is not stored in a file.
+// -----------------------------------------------------------------------------
+- (void) writeToFileIfNecessary
+{
+  @synchronized(self)
+  {
+    if (! self.needsWriteToFile)
+      return;
+
+    NSDictionary* fileContent = @{applicationVersionKey: [self applicationVersion],
+                                  responseKeysKey: self.keysInUsageOrder,
+                                  responsesKey: self.responses};
+    NSError* error;
+    NSData* data = [NSPropertyListSerialization dataWithPropertyList:fileContent
+                                                              format:NSPropertyListBinaryFormat_v1_0
+                                                             options:0
+                                                               error:&error];
+    if (! data)
+    {
+      DDLogError(@"%@: Failed to serialize GTP response cache, error: %@", self, error);
+      return;
+    }
+
+    NSString* folderPath = [self.filePath stringByDeletingLastPathComponent];
+    [[NSFileManager defaultManager] createDirectoryAtPath:folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+
+    if ([data writeToFile:self.filePath atomically:YES])
+      self.needsWriteToFile = false;
+    else
+      DDLogError(@"%@: Failed to write GTP response cache file %@", self, self.filePath);
+  }
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Reads the cache file if it has not been read yet. A missing or
+/// unreadable cache file, or a cache file that was written by a different
+/// version of the app, results in an empty cache. If the cache file contains
+/// more responses than the cache can hold, the least recently used responses
+/// are discarded.
+///
+/// The caller must synchronize on self.
+// -----------------------------------------------------------------------------
+- (void) readFromFileIfNecessary
+{
+  if (! self.needsReadFromFile)
+    return;
+  self.needsReadFromFile = false;
+
+  NSData* data = [NSData dataWithContentsOfFile:self.filePath];
+  if (! data)
+    return;
+
+  NSDictionary* fileContent = [NSPropertyListSerialization propertyListWithData:data
+                                                                        options:NSPropertyListImmutable
+                                                                         format:NULL
+                                                                          error:nil];
+  if (! [fileContent isKindOfClass:[NSDictionary class]])
+    return;
+  if (! [[fileContent objectForKey:applicationVersionKey] isEqual:[self applicationVersion]])
+    return;
+
+  NSArray* responseKeys = [fileContent objectForKey:responseKeysKey];
+  NSDictionary* responses = [fileContent objectForKey:responsesKey];
+  if (! [responseKeys isKindOfClass:[NSArray class]] || ! [responses isKindOfClass:[NSDictionary class]])
+    return;
+
+  NSUInteger indexOfFirstKey = (responseKeys.count > self.capacity) ? responseKeys.count - self.capacity : 0;
+  for (NSUInteger indexOfKey = indexOfFirstKey; indexOfKey < responseKeys.count; ++indexOfKey)
+  {
+    NSString* responseKey = [responseKeys objectAtIndex:indexOfKey];
+    NSString* response = [responses objectForKey:responseKey];
+    if (! [responseKey isKindOfClass:[NSString class]] || ! [response isKindOfClass:[NSString class]])
+      continue;
+    if ([self.responses objectForKey:responseKey])
+      continue;
+
+    [self.keysInUsageOrder addObject:responseKey];
+    [self.responses setObject:response forKey:responseKey];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the version of the app with which the cache file is tagged.
+// -----------------------------------------------------------------------------
+- (NSString*) applicationVersion
+{
+  NSString* applicationVersion = [VersionInfoUtilities applicationVersion];
+  return applicationVersion ? applicationVersion : @"";
+}
+
+@end
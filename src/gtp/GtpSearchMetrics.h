@@ -0,0 +1,80 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GtpUctSearchStatistics;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpSearchMetrics class collects metrics that describe how fast
+/// the GTP engine searches on the current device.
+///
+/// @ingroup gtp
+///
+/// Clients invoke collectMetricsOfMostRecentSearch() after the GTP engine has
+/// generated a move. GtpSearchMetrics then asynchronously queries the GTP
+/// engine for the statistics of its most recent UCT search, and complements
+/// them with the number of threads and the memory limit that the GTP engine
+/// was configured with, and with the app's current memory footprint. When the
+/// metrics have been updated GtpSearchMetrics posts #gtpSearchMetricsDidChange.
+///
+/// The GTP engine does not always search to generate a move (e.g. if it takes
+/// the move from its opening book, or if a response was cached), in which case
+/// it still reports the statistics of an older search. GtpSearchMetrics
+/// recognizes this and does not count the same search twice.
+///
+/// By comparing the playout rate of the most recent search with the peak
+/// playout rate, a user can see whether searches slow down, e.g. because the
+/// device is thermally throttled, or because the search tree has hit the
+/// memory limit.
+///
+/// All GtpSearchMetrics members must be accessed from the main thread.
+// -----------------------------------------------------------------------------
+@interface GtpSearchMetrics : NSObject
+{
+}
+
+- (void) collectMetricsOfMostRecentSearch;
+- (void) reset;
+
+/// @brief The statistics of the most recent search. Is @e nil if no search
+/// has been recorded yet.
+@property(nonatomic, retain, readonly) GtpUctSearchStatistics* mostRecentSearchStatistics;
+/// @brief The number of threads that the GTP engine was configured to use for
+/// the most recent search.
+@property(nonatomic, assign, readonly) int mostRecentSearchNumberOfThreads;
+/// @brief The maximum amount of memory in MB that the GTP engine was
+/// configured to use for the most recent search.
+@property(nonatomic, assign, readonly) int mostRecentSearchMaximumMemory;
+/// @brief The app's memory footprint in bytes, measured after the most recent
+/// search.
+@property(nonatomic, assign, readonly) unsigned long long mostRecentSearchMemoryFootprint;
+/// @brief The number of searches that have been recorded.
+@property(nonatomic, assign, readonly) int numberOfSearches;
+/// @brief The sum of the playouts of all searches that have been recorded.
+@property(nonatomic, assign, readonly) unsigned long long totalGamesPlayed;
+/// @brief The sum of the durations in seconds of all searches that have been
+/// recorded.
+@property(nonatomic, assign, readonly) double totalSearchTime;
+/// @brief The average number of playouts per second over all searches that
+/// have been recorded.
+@property(nonatomic, assign, readonly) double averageGamesPerSecond;
+/// @brief The highest number of playouts per second of any search that has
+/// been recorded.
+@property(nonatomic, assign, readonly) double peakGamesPerSecond;
+
+@end
@@ -0,0 +1,163 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GtpSearchMetrics.h"
+#import "GtpCommand.h"
+#import "GtpResponse.h"
+#import "GtpUctSearchStatistics.h"
+#import "../main/ApplicationDelegate.h"
+#import "../player/GtpEngineProfile.h"
+#import "../player/GtpEngineProfileModel.h"
+#import "../utility/UIDeviceAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GtpSearchMetrics.
+// -----------------------------------------------------------------------------
+@interface GtpSearchMetrics()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, retain, readwrite) GtpUctSearchStatistics* mostRecentSearchStatistics;
+@property(nonatomic, assign, readwrite) int mostRecentSearchNumberOfThreads;
+@property(nonatomic, assign, readwrite) int mostRecentSearchMaximumMemory;
+@property(nonatomic, assign, readwrite) unsigned long long mostRecentSearchMemoryFootprint;
+@property(nonatomic, assign, readwrite) int numberOfSearches;
+@property(nonatomic, assign, readwrite) unsigned long long totalGamesPlayed;
+@property(nonatomic, assign, readwrite) double totalSearchTime;
+@property(nonatomic, assign, readwrite) double peakGamesPerSecond;
+//@}
+@end
+
+
+@implementation GtpSearchMetrics
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpSearchMetrics object that has no searches recorded.
+///
+/// @note This is the designated initializer of GtpSearchMetrics.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.mostRecentSearchStatistics = nil;
+  [self reset];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GtpSearchMetrics object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.mostRecentSearchStatistics = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards all metrics that have been collected so far.
+// -----------------------------------------------------------------------------
+- (void) reset
+{
+  self.mostRecentSearchStatistics = nil;
+  self.mostRecentSearchNumberOfThreads = 0;
+  self.mostRecentSearchMaximumMemory = 0;
+  self.mostRecentSearchMemoryFootprint = 0;
+  self.numberOfSearches = 0;
+  self.totalGamesPlayed = 0;
+  self.totalSearchTime = 0.0;
+  self.peakGamesPerSecond = 0.0;
+
+  [[NSNotificationCenter defaultCenter] postNotificationName:gtpSearchMetricsDidChange object:self];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Queries the GTP engine for the statistics of its most recent search
+/// and records them. Returns immediately, the metrics are updated when the GTP
+/// engine responds.
+// -----------------------------------------------------------------------------
+- (void) collectMetricsOfMostRecentSearch
+{
+  GtpCommand* command = [GtpCommand asynchronousCommand:@"uct_stat_search"
+                                        completionQueue:dispatch_get_main_queue()
+                                      completionHandler:^(GtpResponse* response)
+  {
+    GtpUctSearchStatistics* statistics = [GtpUctSearchStatistics statisticsWithResponse:response];
+    if (statistics)
+      [self recordSearchStatistics:statistics];
+  }];
+  [command submit];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for collectMetricsOfMostRecentSearch().
+// -----------------------------------------------------------------------------
+- (void) recordSearchStatistics:(GtpUctSearchStatistics*)statistics
+{
+  if (statistics.gamesPlayed == 0)
+    return;
+
+  // The GTP engine did not search for the move, the statistics are those of a
+  // search we already know about
+  GtpUctSearchStatistics* previousStatistics = self.mostRecentSearchStatistics;
+  if (previousStatistics &&
+      previousStatistics.gamesPlayed == statistics.gamesPlayed &&
+      previousStatistics.numberOfNodes == statistics.numberOfNodes &&
+      previousStatistics.searchTime == statistics.searchTime)
+  {
+    return;
+  }
+
+  GtpEngineProfile* profile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+
+  self.mostRecentSearchStatistics = statistics;
+  self.mostRecentSearchNumberOfThreads = [profile effectiveFuegoThreadCount];
+  self.mostRecentSearchMaximumMemory = [profile effectiveFuegoMaxMemory];
+  self.mostRecentSearchMemoryFootprint = [UIDevice applicationMemoryFootprint];
+  self.numberOfSearches++;
+  self.totalGamesPlayed += statistics.gamesPlayed;
+  self.totalSearchTime += statistics.searchTime;
+  if (statistics.gamesPerSecond > self.peakGamesPerSecond)
+    self.peakGamesPerSecond = statistics.gamesPerSecond;
+
+  DDLogInfo(@"%@: Search with %llu games in %.2f seconds (%.0f games/s), %d threads, memory footprint %llu MB",
+            self,
+            statistics.gamesPlayed,
+            statistics.searchTime,
+            statistics.gamesPerSecond,
+            self.mostRecentSearchNumberOfThreads,
+            self.mostRecentSearchMemoryFootprint / 1024 / 1024);
+
+  [[NSNotificationCenter defaultCenter] postNotificationName:gtpSearchMetricsDidChange object:self];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (double) averageGamesPerSecond
+{
+  if (self.totalSearchTime <= 0.0)
+    return 0.0;
+  return self.totalGamesPlayed / self.totalSearchTime;
+}
+
+@end
@@ -0,0 +1,53 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GtpResponse;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpUctSearchStatistics class represents the statistics of the
+/// most recent UCT search of the GTP engine, as reported by the GTP command
+/// "uct_stat_search".
+///
+/// @ingroup gtp
+///
+/// Fuego writes the statistics as one "label value" pair per line, e.g.
+/// "GamesPlayed 12345". GtpUctSearchStatistics extracts the values it knows
+/// about and ignores all other lines. A value that is missing from the response
+/// remains 0.
+///
+/// The command "uct_stat_search" succeeds even if the most recent move was not
+/// generated by a search, e.g. because it was taken from the opening book. In
+/// that case the statistics describe an older search.
+// -----------------------------------------------------------------------------
+@interface GtpUctSearchStatistics : NSObject
+{
+}
+
++ (GtpUctSearchStatistics*) statisticsWithResponse:(GtpResponse*)response;
+
+/// @brief The number of playouts that the search performed.
+@property(nonatomic, assign, readonly) unsigned long long gamesPlayed;
+/// @brief The number of nodes in the search tree.
+@property(nonatomic, assign, readonly) unsigned long long numberOfNodes;
+/// @brief The duration of the search in seconds.
+@property(nonatomic, assign, readonly) double searchTime;
+/// @brief The number of playouts per second.
+@property(nonatomic, assign, readonly) double gamesPerSecond;
+
+@end
@@ -0,0 +1,125 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GtpUctSearchStatistics.h"
+#import "GtpResponse.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GtpUctSearchStatistics.
+// -----------------------------------------------------------------------------
+@interface GtpUctSearchStatistics()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, assign, readwrite) unsigned long long gamesPlayed;
+@property(nonatomic, assign, readwrite) unsigned long long numberOfNodes;
+@property(nonatomic, assign, readwrite) double searchTime;
+@property(nonatomic, assign, readwrite) double gamesPerSecond;
+//@}
+@end
+
+
+@implementation GtpUctSearchStatistics
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a GtpUctSearchStatistics instance
+/// with the values found in @a response, which must be the response to the GTP
+/// command "uct_stat_search". Returns nil if @a response indicates that the
+/// command failed.
+// -----------------------------------------------------------------------------
++ (GtpUctSearchStatistics*) statisticsWithResponse:(GtpResponse*)response
+{
+  if (! response.status)
+    return nil;
+
+  GtpUctSearchStatistics* statistics = [[[GtpUctSearchStatistics alloc] init] autorelease];
+  [statistics parseResponse:response.parsedResponse];
+  return statistics;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpUctSearchStatistics object with all values set to
+/// zero.
+///
+/// @note This is the designated initializer of GtpUctSearchStatistics.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.gamesPlayed = 0;
+  self.numberOfNodes = 0;
+  self.searchTime = 0.0;
+  self.gamesPerSecond = 0.0;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for statisticsWithResponse:(). Extracts the values
+/// from the "label value" lines in @a responseString.
+///
+/// Only the first two words of each line are looked at, because a few labels
+/// are followed by more than one value (e.g. a mean and a deviation).
+// -----------------------------------------------------------------------------
+- (void) parseResponse:(NSString*)responseString
+{
+  NSCharacterSet* whitespaceCharacterSet = [NSCharacterSet whitespaceCharacterSet];
+
+  for (NSString* line in [responseString componentsSeparatedByString:@"\n"])
+  {
+    NSScanner* scanner = [NSScanner scannerWithString:line];
+    NSString* label;
+    if (! [scanner scanUpToCharactersFromSet:whitespaceCharacterSet intoString:&label])
+      continue;
+
+    if ([label isEqualToString:@"GamesPlayed"])
+    {
+      unsigned long long gamesPlayed;
+      if ([scanner scanUnsignedLongLong:&gamesPlayed])
+        self.gamesPlayed = gamesPlayed;
+    }
+    else if ([label isEqualToString:@"Nodes"])
+    {
+      unsigned long long numberOfNodes;
+      if ([scanner scanUnsignedLongLong:&numberOfNodes])
+        self.numberOfNodes = numberOfNodes;
+    }
+    else if ([label isEqualToString:@"Time"])
+    {
+      double searchTime;
+      if ([scanner scanDouble:&searchTime])
+        self.searchTime = searchTime;
+    }
+    else if ([label isEqualToString:@"Games/s"])
+    {
+      double gamesPerSecond;
+      if ([scanner scanDouble:&gamesPerSecond])
+        self.gamesPerSecond = gamesPerSecond;
+    }
+  }
+
+  // Calculate the rate ourselves if the response does not contain it
+  if (self.gamesPerSecond == 0.0 && self.searchTime > 0.0)
+    self.gamesPerSecond = self.gamesPlayed / self.searchTime;
+}
+
+@end
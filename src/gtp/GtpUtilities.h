@@ -16,6 +16,9 @@
 
 
 // Forward classes
+@class GoGame;
+@class GoGameRules;
+@class GtpCommand;
 @class Player;
 
 
@@ -37,5 +40,9 @@
 + (void) startPondering;
 + (void) stopPondering;
 + (void) restorePondering;
++ (NSString*) ponderingCommandString:(bool)ponder;
++ (NSArray*) rulesCommandStrings:(GoGameRules*)rules;
++ (void) setupResponseCachingForCommand:(GtpCommand*)command game:(GoGame*)game;
++ (NSString*) response:(NSString*)response transformedBySymmetry:(enum GoBoardSymmetry)symmetry boardSize:(enum GoBoardSize)boardSize;
 
 @end
@@ -18,7 +18,17 @@
 // Project includes
 #import "GtpUtilities.h"
 #import "GtpCommand.h"
+#import "GtpEnergyGovernor.h"
+#import "../go/GoBoard.h"
+#import "../go/GoBoardPosition.h"
+#import "../go/GoBoardTopology.h"
 #import "../go/GoGame.h"
+#import "../go/GoGameRules.h"
+#import "../go/GoMove.h"
+#import "../go/GoNode.h"
+#import "../go/GoNodeSetup.h"
+#import "../go/GoPoint.h"
+#import "../go/GoVertex.h"
 #import "../go/GoPlayer.h"
 #import "../main/ApplicationDelegate.h"
 #import "../player/GtpEngineProfileModel.h"
@@ -90,7 +100,7 @@
 // -----------------------------------------------------------------------------
 + (void) startPondering
 {
-  GtpCommand* command = [GtpCommand command:@"uct_param_player ponder 1"];
+  GtpCommand* command = [GtpCommand command:[GtpUtilities ponderingCommandString:true]];
   command.waitUntilDone = false;
   [command submit];
 }
@@ -100,25 +110,259 @@
 // -----------------------------------------------------------------------------
 + (void) stopPondering
 {
-  GtpCommand* command = [GtpCommand command:@"uct_param_player ponder 0"];
+  GtpCommand* command = [GtpCommand command:[GtpUtilities ponderingCommandString:false]];
   command.waitUntilDone = false;
   [command submit];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the GTP command string that tells the GTP engine to start
+/// pondering (@a ponder is true) or to stop pondering (@a ponder is false).
+// -----------------------------------------------------------------------------
++ (NSString*) ponderingCommandString:(bool)ponder
+{
+  return [NSString stringWithFormat:@"uct_param_player ponder %d", (ponder ? 1 : 0)];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the GTP command strings that configure the GTP engine with
+/// the ko rule, the scoring system and the handicap compensation rule in
+/// @a rules.
+///
+/// Raises @e NSGenericException if @a rules contains an illegal ko rule or
+/// scoring system.
+// -----------------------------------------------------------------------------
++ (NSArray*) rulesCommandStrings:(GoGameRules*)rules
+{
+  NSString* gtpKoRuleName;
+  switch (rules.koRule)
+  {
+    case GoKoRuleSimple:
+      gtpKoRuleName = @"simple";
+      break;
+    case GoKoRuleSuperkoPositional:
+      gtpKoRuleName = @"pos_superko";
+      break;
+    case GoKoRuleSuperkoSituational:
+      gtpKoRuleName = @"superko";
+      break;
+    default:
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Illegal GoKoRule value %d", rules.koRule];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSGenericException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+  }
+
+  int japaneseScoring;
+  int handicapCompensation;
+  switch (rules.scoringSystem)
+  {
+    case GoScoringSystemAreaScoring:
+      japaneseScoring = 0;
+      handicapCompensation = 1;
+      break;
+    case GoScoringSystemTerritoryScoring:
+      japaneseScoring = 1;
+      handicapCompensation = 0;
+      break;
+    default:
+    {
+      NSString* errorMessage = [NSString stringWithFormat:@"Illegal GoScoringSystem value %d", rules.scoringSystem];
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSGenericException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+  }
+
+  return @[[NSString stringWithFormat:@"go_param_rules ko_rule %@", gtpKoRuleName],
+           [NSString stringWithFormat:@"go_param_rules japanese_scoring %d", japaneseScoring],
+           [NSString stringWithFormat:@"go_param_rules extra_handicap_komi %d", handicapCompensation]];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Restores the GTP engine's "pondering" state to the state prescribed
-/// by the active GTP engine profile.
+/// by the active GTP engine profile, unless GtpEnergyGovernor currently does
+/// not allow pondering.
 // -----------------------------------------------------------------------------
 + (void) restorePondering
 {
   GtpEngineProfile* profile = [[ApplicationDelegate sharedDelegate].gtpEngineProfileModel activeProfile];
   if (! profile)
     DDLogError(@"GtpUtilities::restorePondering(): Unable to determine profile with computer player settings");
-  else if (profile.fuegoPondering)
+  else if ([[GtpEnergyGovernor sharedGovernor] shouldPonderWithProfile:profile])
     [GtpUtilities startPondering];
   else
     [GtpUtilities stopPondering];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Sets up @a command so that GtpClient caches the response to the
+/// command, when the command is submitted for the board position that the
+/// board of @a game currently represents. Leaves the cache key of @a command
+/// unset if there is no active GTP engine profile.
+///
+/// The key consists of
+/// - The command string, the board size and the canonical Zobrist hash of the
+///   board.
+/// - The komi, the number of handicap stones, the scoring system and the ko
+///   rule of @a game. All of these are submitted to the GTP engine and
+///   influence its responses.
+/// - The ko state of the board position. See koStateForGame:symmetry:() for
+///   details. Without the ko state a cached response could suggest a move
+///   that is illegal in the current board position, e.g. an immediate ko
+///   retake.
+/// - The settings of the active GTP engine profile that influence the playing
+///   strength of the GTP engine.
+///
+/// The key therefore changes whenever a different profile becomes active, or
+/// when the active profile's settings change. Zobrist hashes and profile UUIDs
+/// do not change between app launches, so the key is also suitable for the
+/// cache file of GtpResponseCache.
+///
+/// Because the canonical Zobrist hash is used, board positions that are
+/// rotations or reflections of each other share the same cached response.
+/// GtpClient stores the response in the orientation of the canonical board
+/// position and transforms it back into the orientation of the board of
+/// @a game when the cached response is used. For this to work, this method
+/// also sets up the @e cacheSymmetry and @e cacheBoardSize properties of
+/// @a command.
+///
+/// @see GtpResponseCache.
+// -----------------------------------------------------------------------------
++ (void) setupResponseCachingForCommand:(GtpCommand*)command game:(GoGame*)game
+{
+  GtpEngineProfile* profile = [[ApplicationDelegate sharedDelegate].gtpEngineProfileModel activeProfile];
+  if (! profile)
+    return;
+
+  GoBoard* board = game.board;
+  enum GoBoardSymmetry symmetry;
+  long long canonicalZobristHash = [board canonicalZobristHashWithSymmetry:&symmetry];
+
+  command.cacheKey = [NSString stringWithFormat:@"%@|%d|%lld|%.1f|%lu|%d|%d|%@|%@|%d|%d|%d|%u|%llu",
+                      command.command,
+                      board.size,
+                      canonicalZobristHash,
+                      game.komi,
+                      (unsigned long)game.handicapPoints.count,
+                      game.rules.scoringSystem,
+                      game.rules.koRule,
+                      [GtpUtilities koStateForGame:game symmetry:symmetry],
+                      profile.uuid,
+                      profile.fuegoMaxMemory,
+                      profile.fuegoThreadCount,
+                      profile.fuegoReuseSubtree,
+                      profile.fuegoMaxThinkingTime,
+                      profile.fuegoMaxGames];
+  command.cacheSymmetry = symmetry;
+  command.cacheBoardSize = board.size;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a string that describes the ko state of the current board
+/// position of @a game, for use in the cache key that
+/// setupResponseCachingForCommand:game:() generates. @a symmetry is the board
+/// symmetry that transforms the board position into the canonical board
+/// position.
+///
+/// If the game uses the simple ko rule, a move is illegal because of ko only
+/// if it recreates the board position before the most recent move. That board
+/// position is fully determined by the current board position, the
+/// intersection of the most recent move and the stone that the most recent
+/// move captured. The ko state therefore consists of the indexes of these two
+/// intersections, in the orientation of the canonical board position. If the
+/// most recent move did not capture exactly one stone, no ko is possible and
+/// the ko state is "-".
+///
+/// If the game uses a superko rule, all board positions since the most recent
+/// setup are relevant. The ko state then is a hash over the Zobrist hashes of
+/// these board positions and the colors of the moves that created them. The
+/// Zobrist hashes are not canonical, so board positions that are rotations or
+/// reflections of each other share a cached response only if they were
+/// reached in the same orientation. This is fine because in that case the
+/// board symmetry is also the same.
+///
+/// This method only reads the game's node tree, so it can be invoked from a
+/// secondary thread as long as the game is not modified concurrently.
+// -----------------------------------------------------------------------------
++ (NSString*) koStateForGame:(GoGame*)game symmetry:(enum GoBoardSymmetry)symmetry
+{
+  GoNode* currentNode = game.boardPosition.currentNode;
+
+  if (game.rules.koRule == GoKoRuleSimple)
+  {
+    GoMove* move = currentNode.goMove;
+    if (! move || move.type != GoMoveTypePlay || move.capturedStones.count != 1)
+      return @"-";
+
+    GoBoard* board = game.board;
+    GoBoardTopology* topology = board.topology;
+    GoPoint* capturedStone = move.capturedStones.firstObject;
+    int moveIndex = [topology indexOfIndex:[board indexOfPoint:move.point] transformedBySymmetry:symmetry];
+    int capturedStoneIndex = [topology indexOfIndex:[board indexOfPoint:capturedStone] transformedBySymmetry:symmetry];
+    return [NSString stringWithFormat:@"%d:%d", moveIndex, capturedStoneIndex];
+  }
+  else
+  {
+    unsigned long long historyHash = 0;
+    for (GoNode* node = currentNode; node; node = node.parent)
+    {
+      // Multiplying with a large odd number is a cheap way to mix the bits,
+      // so that the order of the board positions matters
+      unsigned long long colorOfMove = node.goMove ? node.goMove.player.color : GoColorNone;
+      historyHash = (historyHash * 0x100000001B3ULL) ^ (unsigned long long)node.zobristHash ^ colorOfMove;
+      if (node.goNodeSetup)
+        break;
+    }
+    return [NSString stringWithFormat:@"%llx", historyHash];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a copy of the raw GTP response @a response in which every
+/// vertex (e.g. "D4") is replaced by the vertex onto which it is mapped by the
+/// board symmetry @a symmetry, on a board of size @a boardSize. Everything else
+/// in @a response remains unchanged, notably "pass" and "resign".
+// -----------------------------------------------------------------------------
++ (NSString*) response:(NSString*)response transformedBySymmetry:(enum GoBoardSymmetry)symmetry boardSize:(enum GoBoardSize)boardSize
+{
+  if (symmetry == GoBoardSymmetryIdentity)
+    return response;
+
+  static NSRegularExpression* vertexRegex = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    vertexRegex = [[NSRegularExpression alloc] initWithPattern:@"\\b[A-HJ-Ta-hj-t][0-9]{1,2}\\b" options:0 error:nil];
+  });
+
+  GoBoardTopology* topology = [GoBoardTopology sharedTopologyForBoardSize:boardSize];
+  NSMutableString* transformedResponse = [NSMutableString stringWithString:response];
+  NSArray* matches = [vertexRegex matchesInString:response options:0 range:NSMakeRange(0, response.length)];
+  // Replace back to front so that the ranges of the remaining matches stay
+  // valid
+  for (NSTextCheckingResult* match in [matches reverseObjectEnumerator])
+  {
+    NSString* vertexString = [response substringWithRange:match.range];
+    // Check the number axis compound before it is parsed, because GoVertex
+    // raises an exception for values that are out of range
+    int numberAxisCompound = [[vertexString substringFromIndex:1] intValue];
+    if (numberAxisCompound < 1 || numberAxisCompound > boardSize)
+      continue;
+    struct GoVertexNumeric numericVertex = [GoVertex vertexFromString:vertexString].numeric;
+    if (numericVertex.x > boardSize)
+      continue;
+    int index = ((numericVertex.y - 1) * boardSize) + (numericVertex.x - 1);
+    int transformedIndex = [topology indexOfIndex:index transformedBySymmetry:symmetry];
+    GoVertex* transformedVertex = [topology vertexAtIndex:transformedIndex];
+    [transformedResponse replaceCharactersInRange:match.range withString:transformedVertex.string];
+  }
+  return transformedResponse;
+}
 
 @end
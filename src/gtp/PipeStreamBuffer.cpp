@@ -18,220 +18,296 @@
 #include "PipeStreamBuffer.h"
 
 // System includes
+#include <algorithm>  // for std::min()
 #include <cassert>  // for assert()
+#include <chrono>
+#include <cstring>  // for memset()
 
 // Global constants
 // At the moment this is a rather arbitrary value. It was chosen because it is
 // small enough that on modern iOS devices it uses up a negligible amount of
 // memory, and large enough so that thread context switches due to the buffer
-// filling up should occur infrequently.
-static const int LINEBUFFERSIZE = 16384;
+// filling up should occur infrequently. The value must be a power of 2 so that
+// mapping a position to a buffer offset remains correct when a position
+// counter wraps around.
+static const std::size_t RINGBUFFERSIZE = 16384;
 
 
 // -----------------------------------------------------------------------------
 /// @brief Initializes a PipeStreamBuffer object.
 // -----------------------------------------------------------------------------
 PipeStreamBuffer::PipeStreamBuffer() :
-  lineBufferSize(LINEBUFFERSIZE),
-  lineBuffer(new char[LINEBUFFERSIZE]),
-  endReadingPositionNeedsUpdate(false),
-  newEndReadingPosition(nullptr),
-  currentReadingPositionNeedsUpdate(false),
-  newCurrentReadingPosition(nullptr)
+  ringBufferSize(RINGBUFFERSIZE),
+  ringBuffer(new char[RINGBUFFERSIZE]),
+  publishedWritePosition(0),
+  publishedReadPosition(0),
+  putAreaStartPosition(0),
+  getAreaStartPosition(0),
+  readerIsWaiting(false),
+  writerIsWaiting(false),
+  numberOfSyncCalls(0),
+  numberOfReaderWaits(0),
+  numberOfWriterWaits(0),
+  readerWaitTime(0),
+  writerWaitTime(0)
 {
+  static_assert((RINGBUFFERSIZE & (RINGBUFFERSIZE - 1)) == 0, "RINGBUFFERSIZE must be a power of 2");
+
   // This initialization is not strictly necessary since reading from
   // the buffer cannot occur before it's written to
-  memset(this->lineBuffer, 0, this->lineBufferSize);
-  
+  memset(this->ringBuffer, 0, this->ringBufferSize);
+
   // The end pointers for reading (egptr) and writing (epptr) must point
   // to a memory location that is 1 character BEHIND the last valid
   // reading/writing location.
   setg(
-       this->lineBuffer,
-       this->lineBuffer,
-       this->lineBuffer);
+       this->ringBuffer,
+       this->ringBuffer,
+       this->ringBuffer);
   setp(
-       this->lineBuffer,
-       this->lineBuffer + this->lineBufferSize);
+       this->ringBuffer,
+       this->ringBuffer + this->ringBufferSize);
 }
-  
+
 // -----------------------------------------------------------------------------
 /// @brief Deallocates memory allocated by this PipeStreamBuffer object.
 // -----------------------------------------------------------------------------
 PipeStreamBuffer::~PipeStreamBuffer()
 {
   sync();
-  delete[] this->lineBuffer;
+  delete[] this->ringBuffer;
 }
 
 // -----------------------------------------------------------------------------
 /// @brief Is invoked when a reader wants to consume data but there is none
-/// available from the current read window. If a writer has already written
-/// more data into the internal buffer this method extends the read window and
-/// returns immediately. Otherwise this method blocks the caller.
+/// available from the current read window. If a writer has already made more
+/// data available this method moves the read window and returns immediately.
+/// Otherwise this method blocks the caller.
 // -----------------------------------------------------------------------------
 std::streambuf::int_type PipeStreamBuffer::underflow()
 {
-  // Acquire the mutex before we change any of our internal state
-  std::unique_lock<std::mutex> lock(this->mutexReadWriteLock);
-  
-  // Signal writing thread in case it is currently blocked by overflow().
-  // The writing read will remain blocked until we unlock the mutex.
-  this->waitConditionWriteLock.notify_all();
-  
-  while (! this->endReadingPositionNeedsUpdate && ! this->currentReadingPositionNeedsUpdate)
-  {
-    // We have to wait until there is some content to read. Entering
-    // the wait condition will release the mutex so that the writing
-    // thread is unblocked (if it is currently blocked by overflow()).
-    // The writing thread will signal us as soon as it has new content,
-    // which can happen in two events:
-    // - The writing thread is told to sync (e.g. by an std::endl sent
-    //   to the ostream, or by flushing the ostream)
-    // - The writing thread has completely filled the buffer.
-    this->waitConditionReadLock.wait(lock);
-  }
-  
-  // We are now again in possession of the mutex and can start to
-  // change our internal state
+  if (gptr() < egptr())
+    return traits_type::to_int_type(*gptr());
+
+  // Let the writing thread know that the space we have read so far can be
+  // overwritten. This also unblocks the writing thread if it is currently
+  // waiting in overflow() for free space.
+  publishReadPosition();
+
+  std::size_t readPosition = getReadPosition();
+  waitForDataAvailable(readPosition);
+
+  // The acquire semantics of the load make sure that all characters up to
+  // writePosition that were written by the writing thread are visible to us
+  std::size_t writePosition = this->publishedWritePosition.load(std::memory_order_acquire);
+  std::size_t readOffset = readPosition & (this->ringBufferSize - 1);
+  std::size_t numberOfCharactersAvailable = writePosition - readPosition;
+  // The get area must be contiguous, so it cannot extend beyond the physical
+  // end of the ring buffer. Content after the wraparound will be read on the
+  // next underflow.
+  std::size_t getAreaSize = std::min(numberOfCharactersAvailable,
+                                     this->ringBufferSize - readOffset);
+
+  this->getAreaStartPosition = readPosition;
   setg(
-       // Always read from the beginning of the internal buffer
-       this->lineBuffer,
-       // Unless a change is necessary, continue to read from the current
-       // position gptr
-       this->currentReadingPositionNeedsUpdate ? this->newCurrentReadingPosition : gptr(),
-       // Unless a change is necessary, read up to the current end end
-       // position egptr
-       this->endReadingPositionNeedsUpdate ? this->newEndReadingPosition : egptr());
-  this->endReadingPositionNeedsUpdate = false;
-  this->newEndReadingPosition = nullptr;
-  this->currentReadingPositionNeedsUpdate = false;
-  this->newCurrentReadingPosition = nullptr;
-  
-  // Release the mutex because we have finished changing our internal
-  // state and no longer need it. This will unblock the writing thread
-  // (if it is currently blocked by overflow()).
-  lock.unlock();
-  
-  // It's safe to invoke sgetc(), it won't call underflow() again because
-  // we now have content in the buffer.
-  return sgetc();
+       this->ringBuffer + readOffset,
+       this->ringBuffer + readOffset,
+       this->ringBuffer + readOffset + getAreaSize);
+
+  return traits_type::to_int_type(*gptr());
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Is invoked when a writer wants to provide data but the internal
-/// buffer is full. This method makes sure that the next reader that underflows
-/// will extend the read window to the end of the internal buffer. This method
-/// then blocks the caller until a reader has actually consumed everything
-/// up to the end of the read windows (= internal buffer).
+/// @brief Is invoked when a writer wants to provide data but the current write
+/// window is full. This method makes everything written so far available to
+/// the reader, then moves the write window to the free space that follows. If
+/// the ring buffer is completely full this method blocks the caller until a
+/// reader has consumed at least some of the content.
 // -----------------------------------------------------------------------------
 std::streambuf::int_type PipeStreamBuffer::overflow(std::streambuf::int_type value)
 {
-  // Acquire the mutex before we change any of our internal state
-  std::unique_lock<std::mutex> lock(this->mutexReadWriteLock);
-  
-  // The internal buffer is full, we cannot continue until the reading
-  // thread has read everything. Notes:
-  // - Unlike the implementation of sync(), this must happen
-  //   unconditionally.
-  // - Read the comments in the member variable section of the class to
-  //   understand why we must not invoke setg() at this point.
-  this->endReadingPositionNeedsUpdate = true;
-  this->newEndReadingPosition = this->lineBuffer + this->lineBufferSize;
-  
-  // Logically the write position should now match the end position
-  // of the buffer
-  assert(this->newEndReadingPosition == pptr());
-  
-  // Signal reading thread in case it is currently blocked by underflow().
-  // The reading read will remain blocked until we unlock the mutex.
-  this->waitConditionReadLock.notify_all();
-  
-  // Enter our own wait condition. This will release the mutex and unblock
-  // the reading thread. The reading thread will signal us back when it
-  // enters underflow() and is about to block again. This happens when it
-  // has run out of content to read, i.e. when it has reached the end of
-  // the buffer.
-  this->waitConditionWriteLock.wait(lock);
-  
-  // We are now again in possession of the mutex and can continue to
-  // change our internal state. Since the reading thread has finished
-  // reading to the end of the buffer, we are now free to begin
-  // overwriting the old content.
+  // Unlike the implementation of sync(), this must happen unconditionally
+  publishWritePosition();
+
+  std::size_t writePosition = getWritePosition();
+  waitForSpaceAvailable(writePosition);
+
+  // The acquire semantics of the load make sure that the reading thread has
+  // finished reading all characters up to readPosition before we overwrite
+  // them
+  std::size_t readPosition = this->publishedReadPosition.load(std::memory_order_acquire);
+  std::size_t writeOffset = writePosition & (this->ringBufferSize - 1);
+  std::size_t numberOfCharactersFree = this->ringBufferSize - (writePosition - readPosition);
+  // The put area must be contiguous, so it cannot extend beyond the physical
+  // end of the ring buffer. When the put area reaches the end, the next
+  // overflow wraps around to the beginning of the ring buffer.
+  std::size_t putAreaSize = std::min(numberOfCharactersFree,
+                                     this->ringBufferSize - writeOffset);
+
+  this->putAreaStartPosition = writePosition;
   setp(
-       this->lineBuffer,
-       this->lineBuffer + this->lineBufferSize);
-  
-  // The reading thread is still blocked, but when it wakes up the next
-  // time it must begin reading from the beginning of the buffer. We don't
-  // signal the reading thread here, though, because there's no new
-  // content to read yet. The reading thread will be signalled as soon as
-  // the next sync or overflow occurs. Notes:
-  // - Setting this->newEndReadingPosition here is pointless because the
-  //   value we set here will be overwritten by the next sync or overflow.
-  //   Nevertheless, setting a new value for this->newEndReadingPosition
-  //   here is formally correct, so we do it just in case the
-  //   implementation changes in some way in the future.
-  this->currentReadingPositionNeedsUpdate = true;
-  this->newCurrentReadingPosition = this->lineBuffer;
-  this->endReadingPositionNeedsUpdate = true;
-  this->newEndReadingPosition = this->lineBuffer;
-  
-  // Release the mutex because we have finished changing our internal
-  // state and no longer need it
-  lock.unlock();
-  
+       this->ringBuffer + writeOffset,
+       this->ringBuffer + writeOffset + putAreaSize);
+
+  if (traits_type::eq_int_type(value, traits_type::eof()))
+    return traits_type::not_eof(value);
+
   // It's safe to invoke sputc(), it won't call overflow() again because
-  // the buffer is now empty again.
-  sputc(value);
-  
-  // Although we never want to return EOF, because that indicates failure,
-  // there's no sensible way to protect against the caller passing EOF as
-  // parameter value.
-  return traits_type::to_int_type(value);
-};
+  // the put area now has room for at least one character.
+  sputc(traits_type::to_char_type(value));
+
+  return value;
+}
 
 // -----------------------------------------------------------------------------
 /// @brief Is invoked when a writer wants to make data written up until now
-/// available to the reader. This method makes sure that the next reader that
-/// underflows will extend the read window to the last character currently in
-/// the internal buffer. This method does not block the caller.
+/// available to the reader. This method does not block the caller.
 // -----------------------------------------------------------------------------
 int PipeStreamBuffer::sync()
 {
-  // Acquire the mutex before we change any of our internal state
-  std::unique_lock<std::mutex> lock(this->mutexReadWriteLock);
-  
-  // Check if new content is available. The key to this is the write
-  // position pptr, which may, or may not, have advanced since the last
-  // sync. Notes:
-  // - This check is not necessary for the correctness of the stream
-  //   buffer's working, but it is important because it prevents
-  //   unnecessary thread context switches.
-  // - Read the comments in the member variable section of the class to
-  //   understand why we must not invoke setg() at this point, but why
-  //   it is safe to check egptr().
-  if (pptr() != egptr())
+  this->numberOfSyncCalls.fetch_add(1, std::memory_order_relaxed);
+
+  // Checking whether new content is available is not necessary for the
+  // correctness of the stream buffer's working, but it prevents unnecessary
+  // signalling of the reading thread
+  if (getWritePosition() != this->publishedWritePosition.load(std::memory_order_relaxed))
+    publishWritePosition();
+
+  // 0 = success, -1 = failure
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a snapshot of the statistics counters of this
+/// PipeStreamBuffer. Can be invoked from any thread.
+///
+/// The number of characters written includes only characters that the writing
+/// thread has made available to the reading thread. The number of characters
+/// read includes only characters that the reading thread has released for
+/// overwriting, which happens the next time that it wants to read more
+/// characters.
+// -----------------------------------------------------------------------------
+PipeStreamBuffer::Statistics PipeStreamBuffer::getStatistics() const
+{
+  Statistics statistics;
+  statistics.numberOfCharactersWritten = this->publishedWritePosition.load(std::memory_order_relaxed);
+  statistics.numberOfCharactersRead = this->publishedReadPosition.load(std::memory_order_relaxed);
+  statistics.numberOfSyncCalls = this->numberOfSyncCalls.load(std::memory_order_relaxed);
+  statistics.numberOfReaderWaits = this->numberOfReaderWaits.load(std::memory_order_relaxed);
+  statistics.numberOfWriterWaits = this->numberOfWriterWaits.load(std::memory_order_relaxed);
+  statistics.readerWaitTime = this->readerWaitTime.load(std::memory_order_relaxed);
+  statistics.writerWaitTime = this->writerWaitTime.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the size of the ring buffer used by all PipeStreamBuffer
+/// objects.
+// -----------------------------------------------------------------------------
+std::size_t PipeStreamBuffer::getRingBufferSize()
+{
+  return RINGBUFFERSIZE;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the position up to which the writing thread has written
+/// content. Must be invoked only by the writing thread.
+// -----------------------------------------------------------------------------
+std::size_t PipeStreamBuffer::getWritePosition() const
+{
+  return this->putAreaStartPosition + (pptr() - pbase());
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the position up to which the reading thread has consumed
+/// content. Must be invoked only by the reading thread.
+// -----------------------------------------------------------------------------
+std::size_t PipeStreamBuffer::getReadPosition() const
+{
+  return this->getAreaStartPosition + (gptr() - eback());
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Makes the content written so far available to the reading thread.
+/// Signals the reading thread if it is currently blocked in underflow(). Must
+/// be invoked only by the writing thread.
+// -----------------------------------------------------------------------------
+void PipeStreamBuffer::publishWritePosition()
+{
+  // The store must be sequentially consistent with the load of the flag
+  // below, and with the corresponding store/load pair in
+  // waitForDataAvailable(), otherwise a wakeup could get lost.
+  this->publishedWritePosition.store(getWritePosition());
+
+  if (this->readerIsWaiting.load())
   {
-    this->endReadingPositionNeedsUpdate = true;
-    this->newEndReadingPosition = pptr();
-    
-    // Signal reading thread in case it is currently blocked by
-    // underflow(). The reading read will remain blocked until we
-    // unlock the mutex.
-    this->waitConditionReadLock.notify_all();
+    // Acquiring the mutex guarantees that the reading thread has either
+    // already entered the wait condition, or that it will see the new
+    // position before it enters the wait condition
+    std::lock_guard<std::mutex> lock(this->mutexWaitLock);
+    this->waitConditionDataAvailable.notify_all();
   }
-  else
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Makes the space consumed so far available to the writing thread.
+/// Signals the writing thread if it is currently blocked in overflow(). Must
+/// be invoked only by the reading thread.
+// -----------------------------------------------------------------------------
+void PipeStreamBuffer::publishReadPosition()
+{
+  // See publishWritePosition() for details about memory ordering
+  this->publishedReadPosition.store(getReadPosition());
+
+  if (this->writerIsWaiting.load())
   {
-    // No new content available, therefore no need to signal the
-    // reading thread
+    std::lock_guard<std::mutex> lock(this->mutexWaitLock);
+    this->waitConditionSpaceAvailable.notify_all();
   }
-  
-  // Release the mutex because we have finished changing our internal
-  // state and no longer need it. This will unblock the reading thread.
-  lock.unlock();
-  
-  // 0 = success, -1 = failure
-  return 0;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Blocks the reading thread until the writing thread has made content
+/// available beyond @a readPosition. Returns immediately without touching the
+/// mutex if content is already available.
+// -----------------------------------------------------------------------------
+void PipeStreamBuffer::waitForDataAvailable(std::size_t readPosition)
+{
+  if (this->publishedWritePosition.load(std::memory_order_acquire) != readPosition)
+    return;
+
+  auto waitStartTime = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lock(this->mutexWaitLock);
+  this->readerIsWaiting.store(true);
+  while (this->publishedWritePosition.load() == readPosition)
+    this->waitConditionDataAvailable.wait(lock);
+  this->readerIsWaiting.store(false);
+
+  auto waitDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStartTime);
+  this->numberOfReaderWaits.fetch_add(1, std::memory_order_relaxed);
+  this->readerWaitTime.fetch_add(waitDuration.count(), std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Blocks the writing thread until the reading thread has consumed
+/// content so that there is free space beyond @a writePosition. Returns
+/// immediately without touching the mutex if free space is already available.
+// -----------------------------------------------------------------------------
+void PipeStreamBuffer::waitForSpaceAvailable(std::size_t writePosition)
+{
+  if (writePosition - this->publishedReadPosition.load(std::memory_order_acquire) != this->ringBufferSize)
+    return;
+
+  auto waitStartTime = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lock(this->mutexWaitLock);
+  this->writerIsWaiting.store(true);
+  while (writePosition - this->publishedReadPosition.load() == this->ringBufferSize)
+    this->waitConditionSpaceAvailable.wait(lock);
+  this->writerIsWaiting.store(false);
+
+  auto waitDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStartTime);
+  this->numberOfWriterWaits.fetch_add(1, std::memory_order_relaxed);
+  this->writerWaitTime.fetch_add(waitDuration.count(), std::memory_order_relaxed);
+}
@@ -1,5 +1,5 @@
 // -----------------------------------------------------------------------------
-// Copyright 2018-2019 Patrick Näf (herzbube@herzbube.ch)
+// Copyright 2018-2024 Patrick Näf (herzbube@herzbube.ch)
 //
 // Licensed under the Apache License, Version 2.0 (the "License");
 // you may not use this file except in compliance with the License.
@@ -16,15 +16,19 @@
 
 
 // System includes
-#include <streambuf>
-#include <mutex>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <streambuf>
 
 // -----------------------------------------------------------------------------
 /// @brief The PipeStreamBuffer class is a custom I/O stream buffer that acts
 /// as an in-memory pipe. PipeStreamBuffer was designed to enable two threads to
 /// communicate with each other via a text-based protocol. There may be other
-/// uses. PipeStreamBuffer is thread-safe but @b not reentrant.
+/// uses. PipeStreamBuffer is thread-safe for exactly one writing thread and
+/// exactly one reading thread, but it is @b not reentrant.
 ///
 /// @ingroup gtp
 ///
@@ -59,41 +63,112 @@
 /// threadA.join();
 /// threadB.join();
 /// @endverbatim
+///
+///
+/// @par Implementation notes
+///
+/// Internally PipeStreamBuffer uses a fixed-size ring buffer. The writing
+/// thread owns the put area of std::streambuf, the reading thread owns the get
+/// area. Neither thread ever touches the other thread's pointers. The two
+/// threads communicate only via two atomic positions: The writing thread
+/// publishes how far it has written (on sync or overflow), the reading thread
+/// publishes how far it has read (on underflow). Positions are counted in
+/// characters since the buffer was created and are mapped to buffer offsets
+/// modulo the buffer size.
+///
+/// Because the std::streambuf get and put areas must be contiguous, a window
+/// never extends beyond the physical end of the ring buffer. When a window
+/// reaches the physical end, the next window simply wraps around to the
+/// beginning of the buffer. As a consequence the writing thread does not have
+/// to wait until the reading thread has drained the entire buffer - it can
+/// continue to write as long as there is @e any free space.
+///
+/// The mutex and the condition variables are used only when a thread actually
+/// has to block, i.e. when the reading thread finds the buffer empty or the
+/// writing thread finds the buffer full. Publishing a position never acquires
+/// the mutex unless the other thread has announced that it is waiting.
+///
+///
+/// @par Statistics
+///
+/// PipeStreamBuffer counts how often and for how long the two threads had to
+/// block, how many characters were transferred and how often the writing
+/// thread synchronized. getStatistics() can be invoked from any thread to
+/// obtain a snapshot of the counters. Each counter is updated by only one of
+/// the two threads, and updates are made without additional synchronization,
+/// so the values in a snapshot are not necessarily consistent with each other.
 // -----------------------------------------------------------------------------
 class PipeStreamBuffer : public std::streambuf
 {
 public:
+  /// @brief Snapshot of the counters of a PipeStreamBuffer. Wait times are
+  /// measured in nanoseconds.
+  struct Statistics
+  {
+    std::uint64_t numberOfCharactersWritten;
+    std::uint64_t numberOfCharactersRead;
+    std::uint64_t numberOfSyncCalls;
+    std::uint64_t numberOfReaderWaits;
+    std::uint64_t numberOfWriterWaits;
+    std::uint64_t readerWaitTime;
+    std::uint64_t writerWaitTime;
+  };
+
   PipeStreamBuffer();
   virtual ~PipeStreamBuffer();
-  
+
+  Statistics getStatistics() const;
+  static std::size_t getRingBufferSize();
+
+
 protected:
   virtual std::streambuf::int_type underflow();
   virtual std::streambuf::int_type overflow(std::streambuf::int_type value);
   virtual int sync();
-  
+
 private:
-  int lineBufferSize;
-  char* lineBuffer;
-  
-  std::mutex mutexReadWriteLock;
-  std::condition_variable waitConditionReadLock;
-  std::condition_variable waitConditionWriteLock;
-  
-  // These member variables are used by the writing thread to communicate
-  // to the reading thread when new content is available for reading. The
-  // writing thread is not allowed to directly invoke setg() to change
-  // egptr because setg() requires the caller to supply a new value for
-  // gptr. The writing thread does not want to change gptr, so in theory
-  // it could just call gptr() to obtain the current value - but gptr()
-  // is NOT protected by mutexReadWriteLock because most of the reading
-  // is done by the default implementation of std::streambuf, and that
-  // default implementation does not use mutexReadWriteLock when it
-  // advances gptr. It is, however, safe to check egptr() in the writing
-  // thread because the reading thread (or maybe better: the default
-  // implementation of std::streambuf) never changes this pointer on its own,
-  // so there's no need to protect it.
-  bool endReadingPositionNeedsUpdate;
-  char* newEndReadingPosition;
-  bool currentReadingPositionNeedsUpdate;
-  char* newCurrentReadingPosition;
+  std::size_t getWritePosition() const;
+  std::size_t getReadPosition() const;
+  void publishWritePosition();
+  void publishReadPosition();
+  void waitForDataAvailable(std::size_t readPosition);
+  void waitForSpaceAvailable(std::size_t writePosition);
+
+private:
+  std::size_t ringBufferSize;
+  char* ringBuffer;
+
+  // The position up to which the writing thread has made content available
+  // for reading. Is written only by the writing thread.
+  std::atomic<std::size_t> publishedWritePosition;
+  // The position up to which the reading thread has consumed content. Is
+  // written only by the reading thread.
+  std::atomic<std::size_t> publishedReadPosition;
+
+  // The positions that correspond to the start of the put area (pbase) and
+  // the start of the get area (eback). The first is used only by the writing
+  // thread, the second only by the reading thread.
+  std::size_t putAreaStartPosition;
+  std::size_t getAreaStartPosition;
+
+  // These member variables are used only when one of the threads must block
+  // because the ring buffer is empty (reading thread) or full (writing
+  // thread). A thread that is about to block first announces this via its
+  // ...IsWaiting flag, so that the other thread knows that it must signal the
+  // wait condition after it has published a new position.
+  std::mutex mutexWaitLock;
+  std::condition_variable waitConditionDataAvailable;
+  std::condition_variable waitConditionSpaceAvailable;
+  std::atomic<bool> readerIsWaiting;
+  std::atomic<bool> writerIsWaiting;
+
+  // Statistics counters. The ...Writer... and sync counters are updated only
+  // by the writing thread, the ...Reader... counters only by the reading
+  // thread. The number of characters transferred need no counters of their
+  // own, they are equal to the published positions.
+  std::atomic<std::uint64_t> numberOfSyncCalls;
+  std::atomic<std::uint64_t> numberOfReaderWaits;
+  std::atomic<std::uint64_t> numberOfWriterWaits;
+  std::atomic<std::uint64_t> readerWaitTime;
+  std::atomic<std::uint64_t> writerWaitTime;
 };
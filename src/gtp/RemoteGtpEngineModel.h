@@ -0,0 +1,55 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The RemoteGtpEngineModel class provides user defaults data to its
+/// clients that describes a GTP engine that runs on another machine.
+///
+/// @ingroup gtp
+///
+/// If @e remoteGtpEngineEnabled is true, the app connects to the remote GTP
+/// engine at launch instead of using the embedded Fuego engine. If the
+/// connection cannot be established, or if it fails later on, the app falls
+/// back to the embedded Fuego engine. See ApplicationDelegate's setupFuego().
+///
+/// There is no user interface yet to edit these settings. Changes become
+/// effective only when the app is launched the next time.
+// -----------------------------------------------------------------------------
+@interface RemoteGtpEngineModel : NSObject
+{
+}
+
+- (void) readUserDefaults;
+- (void) writeUserDefaults;
+
+/// @brief True if the app should use the remote GTP engine.
+@property(nonatomic, assign) bool remoteGtpEngineEnabled;
+/// @brief The host name or IP address of the machine on which the remote GTP
+/// engine runs.
+@property(nonatomic, retain) NSString* host;
+/// @brief The TCP port on which the remote GTP engine listens.
+@property(nonatomic, assign) int port;
+/// @brief The time in seconds that the app waits for a connection to the
+/// remote GTP engine to be established.
+@property(nonatomic, assign) double connectTimeout;
+/// @brief The time in seconds that the app waits for the remote GTP engine to
+/// respond to a command, not including the round trip time of the network.
+/// Must be longer than the longest time that the remote GTP engine may think
+/// about a move.
+@property(nonatomic, assign) double responseTimeout;
+
+@end
@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "RemoteGtpEngineModel.h"
+
+
+@implementation RemoteGtpEngineModel
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a RemoteGtpEngineModel object with user defaults data.
+///
+/// @note This is the designated initializer of RemoteGtpEngineModel.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+  self.remoteGtpEngineEnabled = false;
+  self.host = @"";
+  self.port = 0;
+  self.connectTimeout = 0.0;
+  self.responseTimeout = 0.0;
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this RemoteGtpEngineModel object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.host = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes default values in this model with user defaults data.
+// -----------------------------------------------------------------------------
+- (void) readUserDefaults
+{
+  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSDictionary* dictionary = [userDefaults dictionaryForKey:remoteGtpEngineKey];
+
+  self.remoteGtpEngineEnabled = [[dictionary valueForKey:remoteGtpEngineEnabledKey] boolValue];
+  NSString* host = [dictionary valueForKey:remoteGtpEngineHostKey];
+  self.host = host ? host : @"";
+  self.port = [[dictionary valueForKey:remoteGtpEnginePortKey] intValue];
+  self.connectTimeout = [[dictionary valueForKey:remoteGtpEngineConnectTimeoutKey] doubleValue];
+  self.responseTimeout = [[dictionary valueForKey:remoteGtpEngineResponseTimeoutKey] doubleValue];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Writes current values in this model to the user default system's
+/// application domain.
+// -----------------------------------------------------------------------------
+- (void) writeUserDefaults
+{
+  NSMutableDictionary* dictionary = [NSMutableDictionary dictionary];
+  [dictionary setValue:[NSNumber numberWithBool:self.remoteGtpEngineEnabled] forKey:remoteGtpEngineEnabledKey];
+  [dictionary setValue:self.host forKey:remoteGtpEngineHostKey];
+  [dictionary setValue:[NSNumber numberWithInt:self.port] forKey:remoteGtpEnginePortKey];
+  [dictionary setValue:[NSNumber numberWithDouble:self.connectTimeout] forKey:remoteGtpEngineConnectTimeoutKey];
+  [dictionary setValue:[NSNumber numberWithDouble:self.responseTimeout] forKey:remoteGtpEngineResponseTimeoutKey];
+
+  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  [userDefaults setObject:dictionary forKey:remoteGtpEngineKey];
+}
+
+@end
@@ -0,0 +1,337 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#include "SocketStreamBuffer.h"
+
+// System includes
+#include <algorithm>  // for std::min()
+#include <cerrno>
+#include <chrono>
+#include <cmath>  // for std::llround()
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Global constants
+// The response timeout includes this many round trip times on top of the
+// fixed timeout. A single round trip time would be enough in theory, but on
+// a cellular network the latency fluctuates considerably.
+static const int ROUNDTRIPTIMEFACTOR = 4;
+
+// send() must not raise SIGPIPE when the peer has closed the connection. On
+// Apple platforms this is prevented via the SO_NOSIGPIPE socket option.
+#ifdef MSG_NOSIGNAL
+static const int SENDFLAGS = MSG_NOSIGNAL;
+#else
+static const int SENDFLAGS = 0;
+#endif
+
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a SocketStreamBuffer object that is not yet connected.
+/// @a connectTimeout and @a responseTimeout are specified in seconds.
+// -----------------------------------------------------------------------------
+SocketStreamBuffer::SocketStreamBuffer(const std::string& host, unsigned short port, double connectTimeout, double responseTimeout) :
+  host(host),
+  port(port),
+  connectTimeout(connectTimeout),
+  responseTimeout(responseTimeout),
+  socketDescriptor(-1),
+  connected(false),
+  flushTime(0),
+  roundTripTime(0)
+{
+  // The end pointers for reading (egptr) and writing (epptr) must point
+  // to a memory location that is 1 character BEHIND the last valid
+  // reading/writing location.
+  setg(
+       this->getBuffer,
+       this->getBuffer,
+       this->getBuffer);
+  setp(
+       this->putBuffer,
+       this->putBuffer + bufferSize);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this SocketStreamBuffer object.
+// -----------------------------------------------------------------------------
+SocketStreamBuffer::~SocketStreamBuffer()
+{
+  sync();
+  disconnect();
+  if (this->socketDescriptor >= 0)
+    close(this->socketDescriptor);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Establishes the connection to the remote GTP engine. Blocks the
+/// caller for at most the connect timeout per address that the host name
+/// resolves to (name resolution itself may take longer). Returns true if the
+/// connection was established, false if not.
+///
+/// Does nothing and returns false if this method was already invoked before.
+// -----------------------------------------------------------------------------
+bool SocketStreamBuffer::connect()
+{
+  if (this->socketDescriptor >= 0)
+    return false;
+
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+  struct addrinfo* addresses = nullptr;
+  std::string service = std::to_string(this->port);
+  if (getaddrinfo(this->host.c_str(), service.c_str(), &hints, &addresses) != 0)
+    return false;
+
+  int timeoutMilliseconds = static_cast<int>(this->connectTimeout * 1000);
+  for (struct addrinfo* address = addresses; address; address = address->ai_next)
+  {
+    int descriptor = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (descriptor < 0)
+      continue;
+
+    // Connect in non-blocking mode so that we can apply our own timeout
+    // instead of the system's, which is typically more than a minute
+    int flags = fcntl(descriptor, F_GETFL, 0);
+    fcntl(descriptor, F_SETFL, flags | O_NONBLOCK);
+    std::int64_t handshakeStartTime = currentTime();
+    int result = ::connect(descriptor, address->ai_addr, address->ai_addrlen);
+    if (result != 0 && errno == EINPROGRESS)
+    {
+      struct pollfd pollDescriptor = { descriptor, POLLOUT, 0 };
+      if (poll(&pollDescriptor, 1, timeoutMilliseconds) == 1)
+      {
+        int error = 0;
+        socklen_t errorLength = sizeof(error);
+        getsockopt(descriptor, SOL_SOCKET, SO_ERROR, &error, &errorLength);
+        result = error == 0 ? 0 : -1;
+      }
+    }
+    if (result != 0)
+    {
+      close(descriptor);
+      continue;
+    }
+    fcntl(descriptor, F_SETFL, flags);
+
+    int enabled = 1;
+    // GTP commands are short and the client waits for each response, so
+    // Nagle's algorithm would only add latency
+    setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+    setsockopt(descriptor, SOL_SOCKET, SO_KEEPALIVE, &enabled, sizeof(enabled));
+#ifdef SO_NOSIGPIPE
+    setsockopt(descriptor, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+    this->roundTripTime = currentTime() - handshakeStartTime;
+    this->socketDescriptor = descriptor;
+    this->connected = true;
+    break;
+  }
+
+  freeaddrinfo(addresses);
+  return this->connected;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Shuts down the connection to the remote GTP engine. A reader that
+/// is currently blocked in underflow() wakes up and receives EOF. Can be
+/// invoked from any thread.
+// -----------------------------------------------------------------------------
+void SocketStreamBuffer::disconnect()
+{
+  bool wasConnected = this->connected.exchange(false);
+  if (wasConnected)
+    shutdown(this->socketDescriptor, SHUT_RDWR);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the connection to the remote GTP engine is
+/// established and has not failed so far.
+// -----------------------------------------------------------------------------
+bool SocketStreamBuffer::isConnected() const
+{
+  return this->connected;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the current estimate of the round trip time of the
+/// connection, in seconds.
+// -----------------------------------------------------------------------------
+double SocketStreamBuffer::getRoundTripTime() const
+{
+  return static_cast<double>(this->roundTripTime.load()) / 1000000000.0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the time in seconds that underflow() currently waits for the
+/// remote GTP engine before it gives up.
+// -----------------------------------------------------------------------------
+double SocketStreamBuffer::getEffectiveResponseTimeout() const
+{
+  return this->responseTimeout + ROUNDTRIPTIMEFACTOR * getRoundTripTime();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked when a reader wants to consume data but there is none
+/// available in the get area. Blocks the caller until data arrives from the
+/// remote GTP engine, the response timeout expires or the connection fails.
+/// In the latter two cases the connection is shut down and EOF is returned.
+// -----------------------------------------------------------------------------
+std::streambuf::int_type SocketStreamBuffer::underflow()
+{
+  if (gptr() < egptr())
+    return traits_type::to_int_type(*gptr());
+
+  if (! this->connected)
+    return traits_type::eof();
+
+  int timeoutMilliseconds = static_cast<int>(std::llround(getEffectiveResponseTimeout() * 1000));
+  struct pollfd pollDescriptor = { this->socketDescriptor, POLLIN, 0 };
+  int pollResult;
+  do
+  {
+    pollResult = poll(&pollDescriptor, 1, timeoutMilliseconds);
+  }
+  while (pollResult < 0 && errno == EINTR);
+
+  ssize_t numberOfCharactersReceived = -1;
+  if (pollResult == 1)
+  {
+    do
+    {
+      numberOfCharactersReceived = recv(this->socketDescriptor, this->getBuffer, bufferSize, 0);
+    }
+    while (numberOfCharactersReceived < 0 && errno == EINTR);
+  }
+
+  // 0 means that the peer has closed the connection, < 0 covers timeout and
+  // errors
+  if (numberOfCharactersReceived <= 0)
+  {
+    disconnect();
+    return traits_type::eof();
+  }
+
+  updateRoundTripTime();
+
+  setg(
+       this->getBuffer,
+       this->getBuffer,
+       this->getBuffer + numberOfCharactersReceived);
+
+  return traits_type::to_int_type(*gptr());
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked when a writer wants to provide data but the put area is
+/// full. Sends the content of the put area to the remote GTP engine, then
+/// stores @a value at the beginning of the now empty put area.
+// -----------------------------------------------------------------------------
+std::streambuf::int_type SocketStreamBuffer::overflow(std::streambuf::int_type value)
+{
+  if (! sendPendingOutput())
+    return traits_type::eof();
+
+  if (! traits_type::eq_int_type(value, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(value);
+    pbump(1);
+  }
+  return traits_type::not_eof(value);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked when a writer flushes the stream. Sends the content of the
+/// put area to the remote GTP engine. Returns 0 on success, -1 on failure.
+// -----------------------------------------------------------------------------
+int SocketStreamBuffer::sync()
+{
+  if (pptr() == pbase())
+    return 0;
+
+  if (! sendPendingOutput())
+    return -1;
+
+  // Only start a new measurement if there is none in progress. If several
+  // commands are pipelined, the first response belongs to the first command.
+  std::int64_t noMeasurement = 0;
+  this->flushTime.compare_exchange_strong(noMeasurement, currentTime());
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for overflow() and sync(). Sends the content of the
+/// put area to the remote GTP engine, blocking if necessary, then empties the
+/// put area. Returns true on success, false if the connection has failed. In
+/// the latter case the content of the put area is discarded.
+// -----------------------------------------------------------------------------
+bool SocketStreamBuffer::sendPendingOutput()
+{
+  const char* data = pbase();
+  std::size_t numberOfCharactersPending = pptr() - pbase();
+  setp(
+       this->putBuffer,
+       this->putBuffer + bufferSize);
+
+  while (numberOfCharactersPending > 0)
+  {
+    if (! this->connected)
+      return false;
+    ssize_t numberOfCharactersSent = send(this->socketDescriptor, data, numberOfCharactersPending, SENDFLAGS);
+    if (numberOfCharactersSent < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      disconnect();
+      return false;
+    }
+    data += numberOfCharactersSent;
+    numberOfCharactersPending -= numberOfCharactersSent;
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for underflow(). Completes the round trip time
+/// measurement that is currently in progress, if there is one.
+// -----------------------------------------------------------------------------
+void SocketStreamBuffer::updateRoundTripTime()
+{
+  std::int64_t measurementStartTime = this->flushTime.exchange(0);
+  if (measurementStartTime == 0)
+    return;
+
+  std::int64_t sample = currentTime() - measurementStartTime;
+  this->roundTripTime = std::min(this->roundTripTime.load(), sample);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a monotonic timestamp in nanoseconds.
+// -----------------------------------------------------------------------------
+std::int64_t SocketStreamBuffer::currentTime()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,114 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// System includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SocketStreamBuffer class is a custom I/O stream buffer that
+/// transports characters over a TCP connection. SocketStreamBuffer was designed
+/// to let GtpClient talk to a GTP engine that runs on another machine, e.g. a
+/// desktop computer on the local network or a server in the cloud, in the same
+/// way as it talks to the embedded GTP engine via PipeStreamBuffer.
+///
+/// @ingroup gtp
+///
+/// A single SocketStreamBuffer object is used for both directions: GtpClient
+/// writes commands into the put area and reads responses from the get area.
+/// SocketStreamBuffer is thread-safe for exactly one writing thread and
+/// exactly one reading thread, just like PipeStreamBuffer. The writing thread
+/// may be a different thread for each write, as long as the writes are
+/// serialized (GtpClient uses a mutex for this).
+///
+/// The connection must be established by invoking connect() before the stream
+/// buffer is handed to GtpClient. A SocketStreamBuffer object cannot be
+/// reconnected - once the connection has failed a new object must be created.
+///
+///
+/// @par Failure handling
+///
+/// A reader waiting for data does not wait forever. If the remote GTP engine
+/// does not send anything within the response timeout, or if the connection
+/// fails, underflow() shuts down the connection and returns EOF. The input
+/// stream that uses the stream buffer therefore goes into failure state, which
+/// GtpClient recognizes as a transport failure. Writes to a failed connection
+/// are silently discarded.
+///
+/// The response timeout is latency-aware: It is the sum of the fixed timeout
+/// specified in the constructor, which must cover the longest time that the
+/// GTP engine is expected to think about a move, and a multiple of the round
+/// trip time of the connection. The round trip time is initially estimated
+/// from the time the TCP handshake took. It is then refined with the time
+/// between flushing a command and receiving the first character of the
+/// response. Because that time also includes the time the GTP engine spends
+/// processing the command, only the minimum of all samples is used.
+///
+/// Independently of the response timeout, TCP keep-alive is enabled so that
+/// a dead peer is eventually detected even if the timeout is large.
+// -----------------------------------------------------------------------------
+class SocketStreamBuffer : public std::streambuf
+{
+public:
+  SocketStreamBuffer(const std::string& host, unsigned short port, double connectTimeout, double responseTimeout);
+  virtual ~SocketStreamBuffer();
+
+  bool connect();
+  void disconnect();
+  bool isConnected() const;
+  double getRoundTripTime() const;
+  double getEffectiveResponseTimeout() const;
+
+
+protected:
+  virtual std::streambuf::int_type underflow();
+  virtual std::streambuf::int_type overflow(std::streambuf::int_type value);
+  virtual int sync();
+
+private:
+  bool sendPendingOutput();
+  void updateRoundTripTime();
+  static std::int64_t currentTime();
+
+private:
+  std::string host;
+  unsigned short port;
+  double connectTimeout;
+  double responseTimeout;
+
+  static const std::size_t bufferSize = 4096;
+  char getBuffer[bufferSize];
+  char putBuffer[bufferSize];
+
+  // The socket descriptor remains valid until the object is destroyed, even
+  // after the connection has failed, so that the reading and the writing
+  // thread never operate on a descriptor that has been closed (and possibly
+  // re-used) by the other thread.
+  int socketDescriptor;
+  std::atomic<bool> connected;
+
+  // All times are measured in nanoseconds. flushTime is the time when the
+  // writing thread most recently sent a command to the GTP engine that was not
+  // followed by a response yet. It is 0 if no round trip time measurement is
+  // in progress.
+  std::atomic<std::int64_t> flushTime;
+  std::atomic<std::int64_t> roundTripTime;
+};
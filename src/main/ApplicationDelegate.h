@@ -24,17 +24,20 @@
 @class CrashReportingModel;
 @class GameVariationModel;
 @class GoGame;
+@class GoGameWorkspace;
 @class GtpClient;
 @class GtpCommandModel;
 @class GtpEngine;
 @class GtpEngineProfileModel;
 @class GtpLogModel;
+@class GtpSearchMetrics;
 @class LoggingModel;
 @class MagnifyingViewModel;
 @class MarkupModel;
 @class NewGameModel;
 @class NodeTreeViewModel;
 @class PlayerModel;
+@class RemoteGtpEngineModel;
 @class ScoringModel;
 @class SgfSettingsModel;
 @class SoundHandling;
@@ -76,6 +79,8 @@
 - (void) writeUserDefaults;
 - (NSString*) contentOfTextResource:(NSString*)resourceName;
 - (NSString*) logFolder;
+- (NSDictionary*) gtpTransportStatistics;
+- (void) logGtpTransportStatistics;
 
 /// @brief The main application window.
 @property(nonatomic, retain) UIWindow* window;
@@ -107,8 +112,13 @@
 @property(nonatomic, assign) NSBundle* resourceBundle;
 /// @brief The GTP client instance.
 @property(nonatomic, retain) GtpClient* gtpClient;
-/// @brief The GTP engine instance.
+/// @brief The GTP engine instance. Is @e nil until the GTP client starts the
+/// engine on demand (see setupFuego()). Is also @e nil while the GTP client
+/// talks to a remote GTP engine.
 @property(nonatomic, retain) GtpEngine* gtpEngine;
+/// @brief Model object that stores the connection settings of a remote GTP
+/// engine.
+@property(nonatomic, retain) RemoteGtpEngineModel* remoteGtpEngineModel;
 /// @brief Model object that stores attributes of a new game.
 @property(nonatomic, retain) NewGameModel* theNewGameModel;
 /// @brief Model object that stores player data.
@@ -130,6 +140,8 @@
 @property(nonatomic, retain) SoundHandling* soundHandling;
 /// @brief Object that represents the game that is currently in progress.
 @property(nonatomic, retain) GoGame* game;
+/// @brief Object that keeps recently viewed games resident in memory.
+@property(nonatomic, retain) GoGameWorkspace* gameWorkspace;
 /// @brief Model object that stores attributes used to manage the Archive view.
 @property(nonatomic, retain) ArchiveViewModel* archiveViewModel;
 /// @brief Model object that stores information about the GTP log, viewable on
@@ -138,6 +150,9 @@
 /// @brief Model object that stores canned GTP commands that can be managed and
 /// submitted on the Diagnostics view.
 @property(nonatomic, retain) GtpCommandModel* gtpCommandModel;
+/// @brief Object that collects metrics about the searches of the GTP engine,
+/// viewable on the Diagnostics view.
+@property(nonatomic, retain) GtpSearchMetrics* gtpSearchMetrics;
 /// @brief Model object that stores attributes that describe the behaviour of
 /// the crash reporting service.
 @property(nonatomic, retain) CrashReportingModel* crashReportingModel;
@@ -31,9 +31,14 @@
 #import "ApplicationDelegate.h"
 #import "MainTabBarController.h"
 #import "../gtp/GtpClient.h"
+#import "../gtp/GtpCommand.h"
+#import "../gtp/GtpEnergyGovernor.h"
 #import "../gtp/GtpEngine.h"
+#import "../gtp/GtpSearchMetrics.h"
 #import "../gtp/GtpUtilities.h"
 #import "../gtp/PipeStreamBuffer.h"
+#import "../gtp/RemoteGtpEngineModel.h"
+#import "../gtp/SocketStreamBuffer.h"
 #import "../newgame/NewGameModel.h"
 #import "../player/GtpEngineProfileModel.h"
 #import "../player/GtpEngineProfile.h"
@@ -59,16 +64,27 @@
 #import "../diagnostics/GtpCommandModel.h"
 #import "../diagnostics/GtpLogModel.h"
 #import "../diagnostics/LoggingModel.h"
+#import "../diagnostics/PerformanceHUD.h"
+#import "../diagnostics/SessionRecorder.h"
+#import "../diagnostics/SignpostLog.h"
 #import "../command/CommandProcessor.h"
 #import "../command/HandleDocumentInteractionCommand.h"
 #import "../command/SetupApplicationCommand.h"
 #import "../command/backup/CleanBackupSgfCommand.h"
+#import "../command/boardposition/SyncGTPEngineCommand.h"
 #import "../command/diagnostics/RestoreBugReportUserDefaultsCommand.h"
 #import "../command/game/PauseGameCommand.h"
+#import "../command/gtp/RunSustainedLoadBenchmarkCommand.h"
+#import "../command/gtp/RunThreadScalingBenchmarkCommand.h"
+#import "../go/GoBoard.h"
 #import "../go/GoGame.h"
+#import "../go/GoGameWorkspace.h"
 #import "../shared/ApplicationStateManager.h"
+#import "../shared/DeferredDeallocationQueue.h"
 #import "../shared/LayoutManager.h"
 #import "../shared/LongRunningActionCounter.h"
+#import "../shared/MemoryBudgetManager.h"
+#import "../shared/ModelMutationTransaction.h"
 #import "../sgf/SgfSettingsModel.h"
 #import "../ui/MagnifyingViewModel.h"
 #import "../ui/UiElementMetrics.h"
@@ -77,6 +93,9 @@
 #import "../utility/PathUtilities.h"
 #import "../utility/UserDefaultsUpdater.h"
 
+// System includes
+#import <os/signpost.h>
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for ApplicationDelegate.
@@ -98,6 +117,7 @@
 static ApplicationDelegate* sharedDelegate = nil;
 static std::streambuf* inputPipeStreamBuffer = nullptr;
 static std::streambuf* outputPipeStreamBuffer = nullptr;
+static SocketStreamBuffer* socketStreamBuffer = nullptr;
 
 // -----------------------------------------------------------------------------
 /// @brief Returns the shared application delegate object.
@@ -145,14 +165,17 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   self.theNewGameModel = nil;
   self.playerModel = nil;
   self.gtpEngineProfileModel = nil;
+  self.remoteGtpEngineModel = nil;
   self.boardViewModel = nil;
   self.boardPositionModel = nil;
   self.scoringModel = nil;
   self.soundHandling = nil;
   self.game = nil;
+  self.gameWorkspace = nil;
   self.archiveViewModel = nil;
   self.gtpLogModel = nil;
   self.gtpCommandModel = nil;
+  self.gtpSearchMetrics = nil;
   self.crashReportingModel = nil;
   self.loggingModel = nil;
   self.uiSettingsModel = nil;
@@ -163,13 +186,21 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   self.nodeTreeViewModel = nil;
   self.gameVariationModel = nil;
   self.fileLogger = nil;
+  [PerformanceHUD releaseSharedHUD];
   [BoardPositionNavigationManager releaseSharedNavigationManager];
   [GameActionManager releaseSharedGameActionManager];
   [BoardViewCGLayerCache releaseSharedCache];
   [CommandProcessor releaseSharedProcessor];
+  [ModelMutationTransaction releaseSharedTransaction];
   [LongRunningActionCounter releaseSharedCounter];
   [ApplicationStateManager releaseSharedManager];
   [LayoutManager releaseSharedManager];
+  [GtpEnergyGovernor releaseSharedGovernor];
+  [SessionRecorder releaseSharedRecorder];
+  // Clients unregister when they are deallocated, so this must be released
+  // after the clients
+  [MemoryBudgetManager releaseSharedManager];
+  [DeferredDeallocationQueue releaseSharedQueue];
   if (self == sharedDelegate)
     sharedDelegate = nil;
 
@@ -183,6 +214,11 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
     delete outputPipeStreamBuffer;
     outputPipeStreamBuffer = nullptr;
   }
+  if (socketStreamBuffer)
+  {
+    delete socketStreamBuffer;
+    socketStreamBuffer = nullptr;
+  }
 
   [super dealloc];
 }
@@ -209,12 +245,23 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   NSProcessInfo* processInfo = [NSProcessInfo processInfo];
   if ([processInfo.arguments containsObject:uiTestModeLaunchArgument])
     [self prepareForUiTests];
+  // Start recording before anything submits a command
+  if ([processInfo.arguments containsObject:recordSessionLaunchArgument])
+    [[SessionRecorder sharedRecorder] startRecording];
+
+  // The launch phases are emitted as os_signpost intervals so that launch
+  // performance tests can measure them. The names must match the launch
+  // signpost name constants.
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryLaunch];
+  os_signpost_id_t signpostID = os_signpost_id_generate(signpostLog);
 
   // Don't change the following sequence without thoroughly checking the
   // dependencies
   // The following steps have no dependencies
   [self setupResourceBundle];
+  os_signpost_interval_begin(signpostLog, signpostID, "SetupLogging");
   [self setupLogging];
+  os_signpost_interval_end(signpostLog, signpostID, "SetupLogging");
   [self setupApplicationLaunchMode];
   bool setupDocumentInteractionSuccess = [self setupDocumentInteraction:launchOptions];
   [self setupFolders];
@@ -222,14 +269,20 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   [self setupRegistrationDomain];
   // Depends on setupRegistrationDomain to provide fallback values if no user
   // preferences exist
+  os_signpost_interval_begin(signpostLog, signpostID, "SetupUserDefaults");
   [self setupUserDefaults];
+  os_signpost_interval_end(signpostLog, signpostID, "SetupUserDefaults");
   // Depends on setupUserDefaults (for boardViewModel)
   [self setupSound];
-  // Has no dependencies
+  // Depends on setupUserDefaults (for remoteGtpEngineModel)
+  os_signpost_interval_begin(signpostLog, signpostID, "SetupFuego");
   [self setupFuego];
+  os_signpost_interval_end(signpostLog, signpostID, "SetupFuego");
   // Depends on setupUserDefaults (e.g. MainTabBarController wants to restore
   // tab order)
+  os_signpost_interval_begin(signpostLog, signpostID, "SetupGUI");
   [self setupGUI];
+  os_signpost_interval_end(signpostLog, signpostID, "SetupGUI");
   // Depends on
   // - setupUserDefaults, for crashReportingModel
   // - setupGUI, for setting up self.window and its rootViewController property,
@@ -240,6 +293,12 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   // Further setup steps are executed in a secondary thread so that we can
   // display a progress HUD
   [[[[SetupApplicationCommand alloc] init] autorelease] submit];
+  // Is executed after SetupApplicationCommand because both commands are
+  // executed in the same lane
+  if ([processInfo.arguments containsObject:sustainedLoadBenchmarkLaunchArgument])
+    [[[[RunSustainedLoadBenchmarkCommand alloc] initWithLaunchEnvironment:processInfo.environment] autorelease] submit];
+  if ([processInfo.arguments containsObject:threadScalingBenchmarkLaunchArgument])
+    [[[[RunThreadScalingBenchmarkCommand alloc] initWithLaunchEnvironment:processInfo.environment] autorelease] submit];
 
   BOOL canHandleURL = setupDocumentInteractionSuccess ? YES : NO;
   return canHandleURL;
@@ -304,6 +363,8 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
 
   [self writeUserDefaults];
   [[ApplicationStateManager sharedManager] applicationDidEnterBackground];
+  [self logGtpTransportStatistics];
+  [DDLog flushLog];
 }
 
 // -----------------------------------------------------------------------------
@@ -322,9 +383,10 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
 // -----------------------------------------------------------------------------
 - (void) applicationDidReceiveMemoryWarning:(UIApplication*)application
 {
-  // We can't do anything about the situation since it's Fuego that uses up too
-  // much memory, probably due to an "enthusiastic" maximum memory setting
-  // in the current GTP engine profile.
+  // MemoryBudgetManager responds to the memory warning by emptying caches and
+  // by reducing the memory available to Fuego. Most likely it's Fuego that
+  // uses up too much memory, probably due to an "enthusiastic" maximum memory
+  // setting in the current GTP engine profile.
   DDLogWarn(@"ApplicationDelegate received memory warning");
   GtpEngineProfile* profile = self.gtpEngineProfileModel.activeProfile;
   if (profile)
@@ -363,6 +425,10 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
 
 // -----------------------------------------------------------------------------
 /// @brief Prepares the app for launching in UI test mode.
+///
+/// If the UI test passes SGF content via the launch environment, the SGF
+/// content is written to the backup .sgf file so that the app restores the
+/// game from that file during the normal application startup.
 // -----------------------------------------------------------------------------
 - (void) prepareForUiTests
 {
@@ -371,6 +437,18 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   [[NSUserDefaults standardUserDefaults] synchronize];
 
   [[[[CleanBackupSgfCommand alloc] init] autorelease] submit];
+
+  NSString* sgfContent = [[[NSProcessInfo processInfo] environment] objectForKey:uiTestSgfContentLaunchEnvironmentKey];
+  if (sgfContent)
+  {
+    [PathUtilities createFolder:[PathUtilities backupFolderPath] removeIfExists:false];
+    BOOL fileExists;
+    NSString* backupFilePath = [PathUtilities filePathForBackupFileNamed:sgfBackupFileName fileExists:&fileExists];
+    NSError* error;
+    BOOL success = [sgfContent writeToFile:backupFilePath atomically:YES encoding:NSUTF8StringEncoding error:&error];
+    if (! success)
+      DDLogError(@"%@: Failed to write SGF content for UI tests, error = %@", self, [error localizedDescription]);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -420,8 +498,12 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
     loggingEnabled = [[[NSUserDefaults standardUserDefaults] valueForKey:loggingEnabledKey] boolValue];
   if (loggingEnabled)
   {
-    [DDLog addLogger:self.fileLogger withLevel:ddLogLevel];
+    ddLogLevel = DDLogLevelAll;
     self.fileLogger.logFormatter = [[[LogFormatter alloc] init] autorelease];
+    // The file logger is deliberately not wrapped with a buffer. The log file
+    // is most valuable after a crash, and messages that are still in a buffer
+    // when the app crashes are lost.
+    [DDLog addLogger:self.fileLogger withLevel:DDLogLevelAll];
     id<DDLogger> logger = [DDOSLogger sharedInstance];  // uses os_log
     // The Xcode console adds its own timestamp
     logger.logFormatter = [[[LogFormatter alloc] initWithLogFormatStyle:LogFormatStyleWithoutTimestamp] autorelease];
@@ -432,7 +514,9 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   else
   {
     DDLogInfo(@"Logging disabled");
+    [DDLog flushLog];
     [DDLog removeAllLoggers];
+    ddLogLevel = DDLogLevelOff;
   }
 }
 
@@ -550,12 +634,14 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   self.theNewGameModel = [[[NewGameModel alloc] init] autorelease];
   self.playerModel = [[[PlayerModel alloc] init] autorelease];
   self.gtpEngineProfileModel = [[[GtpEngineProfileModel alloc] init] autorelease];
+  self.remoteGtpEngineModel = [[[RemoteGtpEngineModel alloc] init] autorelease];
   self.boardViewModel = [[[BoardViewModel alloc] init] autorelease];
   self.boardPositionModel = [[[BoardPositionModel alloc] init] autorelease];
   self.scoringModel = [[[ScoringModel alloc] init] autorelease];
   self.archiveViewModel = [[[ArchiveViewModel alloc] init] autorelease];
   self.gtpLogModel = [[[GtpLogModel alloc] init] autorelease];
   self.gtpCommandModel = [[[GtpCommandModel alloc] init] autorelease];
+  self.gtpSearchMetrics = [[[GtpSearchMetrics alloc] init] autorelease];
   self.crashReportingModel = [[[CrashReportingModel alloc] init] autorelease];
   self.loggingModel = [[[LoggingModel alloc] init] autorelease];
   self.uiSettingsModel = [[[UiSettingsModel alloc] init] autorelease];
@@ -565,9 +651,11 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   self.markupModel = [[[MarkupModel alloc] init] autorelease];
   self.nodeTreeViewModel = [[[NodeTreeViewModel alloc] init] autorelease];
   self.gameVariationModel = [[[GameVariationModel alloc] init] autorelease];
+  self.gameWorkspace = [[[GoGameWorkspace alloc] init] autorelease];
   [self.theNewGameModel readUserDefaults];
   [self.playerModel readUserDefaults];
   [self.gtpEngineProfileModel readUserDefaults];
+  [self.remoteGtpEngineModel readUserDefaults];
   [self.boardViewModel readUserDefaults];
   [self.boardPositionModel readUserDefaults];
   [self.scoringModel readUserDefaults];
@@ -606,6 +694,7 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   [self.theNewGameModel writeUserDefaults];
   [self.playerModel writeUserDefaults];
   [self.gtpEngineProfileModel writeUserDefaults];
+  [self.remoteGtpEngineModel writeUserDefaults];
   [self.boardViewModel writeUserDefaults];
   [self.boardPositionModel writeUserDefaults];
   [self.scoringModel writeUserDefaults];
@@ -632,15 +721,49 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Sets up the GTP engine and client (always Fuego).
+/// @brief Sets up the GTP engine and client.
 ///
 /// In a regular desktop environment, engine and client would be launched in
 /// separate processes, which would then communicate via stdin/stdout. Since
 /// there is no way to launch separate processes under iOS, engine and client
 /// run in separate threads, and they communicate via C++ Standard Library
 /// I/O streams.
+///
+/// Only the client is created here. The engine is started on demand by the
+/// client when the first GTP command is written to the command stream. Until
+/// then Fuego does not consume any launch time or memory.
+///
+/// If RemoteGtpEngineModel says so, the client instead talks to a GTP engine
+/// that runs on another machine. The connection is attempted only once,
+/// because the application launch must not be delayed for too long. If the
+/// connection cannot be established the embedded Fuego engine is used.
 // -----------------------------------------------------------------------------
 - (void) setupFuego
+{
+  bool didSetupRemoteGtpClient = false;
+  if (self.remoteGtpEngineModel.remoteGtpEngineEnabled)
+  {
+    SocketStreamBuffer* streamBuffer = [self connectToRemoteGtpEngineWithAttempts:1];
+    if (streamBuffer)
+    {
+      [self setupRemoteGtpClientWithStreamBuffer:streamBuffer];
+      didSetupRemoteGtpClient = true;
+    }
+  }
+  if (! didSetupRemoteGtpClient)
+    [self setupLocalGtpClient];
+
+  // Start monitoring the energy and thermal conditions before the first GTP
+  // engine profile is applied
+  [GtpEnergyGovernor sharedGovernor];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setupFuego() and
+/// handleRemoteGtpEngineTransportFailure(). Creates a GTP client that talks to
+/// the embedded Fuego engine.
+// -----------------------------------------------------------------------------
+- (void) setupLocalGtpClient
 {
   // Create objects on the heap, not the stack, so that they remain alive after
   // control leaves this method. It would be much nicer to make these variables
@@ -656,7 +779,152 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
                             nil];
 
   self.gtpClient = [GtpClient clientWithStreamBuffers:streamBuffers];
-  self.gtpEngine = [GtpEngine engineWithStreamBuffers:streamBuffers];
+  // The block is executed in the context of the client's secondary thread.
+  // The engine reads from the stream buffers only after it has been started,
+  // so commands written earlier are not lost.
+  self.gtpClient.engineLauncher = ^{
+    self.gtpEngine = [GtpEngine engineWithStreamBuffers:streamBuffers];
+    self.gtpClient.engine = self.gtpEngine;
+  };
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setupFuego() and
+/// handleRemoteGtpEngineTransportFailure(). Creates a GTP client that talks to
+/// a remote GTP engine via @a streamBuffer, which must already be connected.
+/// Takes ownership of @a streamBuffer.
+// -----------------------------------------------------------------------------
+- (void) setupRemoteGtpClientWithStreamBuffer:(SocketStreamBuffer*)streamBuffer
+{
+  socketStreamBuffer = streamBuffer;
+
+  // SocketStreamBuffer transports both commands and responses
+  NSValue* streamBufferAsNSValue = [NSValue valueWithPointer:static_cast<std::streambuf*>(socketStreamBuffer)];
+  NSArray* streamBuffers = [NSArray arrayWithObjects:streamBufferAsNSValue, streamBufferAsNSValue, nil];
+
+  self.gtpClient = [GtpClient clientWithStreamBuffers:streamBuffers];
+  self.gtpClient.transportFailureHandler = ^{
+    [self handleRemoteGtpEngineTransportFailure];
+  };
+
+  DDLogInfo(@"%@: Connected to remote GTP engine %@:%d, round trip time = %.1f ms",
+            self,
+            self.remoteGtpEngineModel.host,
+            self.remoteGtpEngineModel.port,
+            socketStreamBuffer->getRoundTripTime() * 1000);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Tries up to @a attempts times to connect to the
+/// remote GTP engine described by RemoteGtpEngineModel. Returns a connected
+/// SocketStreamBuffer that the caller must delete, or @e nullptr if no
+/// connection could be established.
+///
+/// This method blocks the caller while it tries to connect. It can be invoked
+/// in the context of any thread.
+// -----------------------------------------------------------------------------
+- (SocketStreamBuffer*) connectToRemoteGtpEngineWithAttempts:(int)attempts
+{
+  RemoteGtpEngineModel* model = self.remoteGtpEngineModel;
+  std::string host = [model.host UTF8String];
+  unsigned short port = static_cast<unsigned short>(model.port);
+
+  for (int attempt = 1; attempt <= attempts; ++attempt)
+  {
+    if (attempt > 1)
+      [NSThread sleepForTimeInterval:remoteGtpEngineConnectRetryDelay];
+
+    SocketStreamBuffer* streamBuffer = new SocketStreamBuffer(host, port, model.connectTimeout, model.responseTimeout);
+    if (streamBuffer->connect())
+      return streamBuffer;
+    delete streamBuffer;
+
+    DDLogWarn(@"%@: Attempt %d to connect to remote GTP engine %@:%d failed", self, attempt, model.host, model.port);
+  }
+
+  return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked in the context of the main thread when the connection to
+/// the remote GTP engine has failed. Tries to reconnect to the remote GTP
+/// engine, or falls back to the embedded Fuego engine if reconnecting fails.
+/// Then brings the new GTP engine into the same state as the old one.
+///
+/// Reconnecting takes place in the background so that the UI remains
+/// responsive. Until the new GTP client is in place, commands submitted to the
+/// old GTP client immediately receive a failed response. The same is true for
+/// the command that was waiting for a response when the connection failed.
+// -----------------------------------------------------------------------------
+- (void) handleRemoteGtpEngineTransportFailure
+{
+  DDLogWarn(@"%@: Connection to remote GTP engine has failed, trying to reconnect", self);
+
+  dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+    SocketStreamBuffer* streamBuffer = [self connectToRemoteGtpEngineWithAttempts:remoteGtpEngineConnectAttempts];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [self discardRemoteGtpClient];
+      if (streamBuffer)
+      {
+        [self setupRemoteGtpClientWithStreamBuffer:streamBuffer];
+      }
+      else
+      {
+        DDLogWarn(@"%@: Unable to reconnect to remote GTP engine, falling back to embedded GTP engine", self);
+        [self setupLocalGtpClient];
+      }
+      [self restoreGtpEngineState];
+    });
+  });
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for handleRemoteGtpEngineTransportFailure(). Stops
+/// the secondary thread of the GTP client that talks to the remote GTP engine,
+/// then deletes the stream buffer.
+// -----------------------------------------------------------------------------
+- (void) discardRemoteGtpClient
+{
+  // The client's secondary thread still uses the stream buffer while it
+  // processes the "quit" command. The connection has failed, so the command
+  // is answered immediately with a failed response, and the secondary thread
+  // then terminates. The completion handler runs after the response has been
+  // handled, at which point the stream buffer is no longer used.
+  SocketStreamBuffer* streamBuffer = socketStreamBuffer;
+  socketStreamBuffer = nullptr;
+  GtpCommand* command = [GtpCommand command:@"quit"];
+  command.waitUntilDone = false;
+  command.completionHandler = ^(GtpResponse* response) {
+    delete streamBuffer;
+  };
+  [self.gtpClient submit:command];
+  self.gtpClient = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for handleRemoteGtpEngineTransportFailure(). Brings
+/// a newly connected or started GTP engine into the state that is expected by
+/// the current game: Rules, board size, the active GTP engine profile, and
+/// the setup and moves of the current game variation.
+///
+/// Does nothing if there is no game yet. In that case NewGameCommand sets up
+/// the GTP engine when it creates the first game.
+// -----------------------------------------------------------------------------
+- (void) restoreGtpEngineState
+{
+  GoGame* game = [GoGame sharedGame];
+  if (! game)
+    return;
+
+  for (NSString* commandString in [GtpUtilities rulesCommandStrings:game.rules])
+    [[GtpCommand command:commandString] submit];
+  [[GtpCommand command:[NSString stringWithFormat:@"boardsize %d", game.board.size]] submit];
+  [GtpUtilities setupComputerPlayer];
+
+  SyncGTPEngineCommand* command = [[[SyncGTPEngineCommand alloc] init] autorelease];
+  bool success = [command submit];
+  if (! success)
+    DDLogError(@"%@: Failed to synchronize GTP engine after transport failure: %@", self, command.errorDescription);
 }
 
 // -----------------------------------------------------------------------------
@@ -744,4 +1012,78 @@ static std::streambuf* outputPipeStreamBuffer = nullptr;
   return [self.fileLogger.logFileManager logsDirectory];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the statistics counters of the two PipeStreamBuffer objects
+/// that transport GTP commands and GTP responses between GTP client and GTP
+/// engine. Returns an empty dictionary if setupFuego() has not been invoked
+/// yet.
+///
+/// The dictionary has two entries with keys "Commands" and "Responses". The
+/// value of each entry is a dictionary with one entry per counter. The values
+/// are NSNumber objects. Wait times are in milliseconds.
+///
+/// The counters accumulate since application launch, so the values describe
+/// the current application session.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) gtpTransportStatistics
+{
+  NSMutableDictionary* gtpTransportStatistics = [NSMutableDictionary dictionary];
+  if (inputPipeStreamBuffer)
+    gtpTransportStatistics[@"Commands"] = [self statisticsOfPipeStreamBuffer:inputPipeStreamBuffer];
+  if (outputPipeStreamBuffer)
+    gtpTransportStatistics[@"Responses"] = [self statisticsOfPipeStreamBuffer:outputPipeStreamBuffer];
+  return gtpTransportStatistics;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for gtpTransportStatistics().
+// -----------------------------------------------------------------------------
+- (NSDictionary*) statisticsOfPipeStreamBuffer:(std::streambuf*)streamBuffer
+{
+  PipeStreamBuffer::Statistics statistics = static_cast<PipeStreamBuffer*>(streamBuffer)->getStatistics();
+  return @{
+    @"RingBufferSize" : @(PipeStreamBuffer::getRingBufferSize()),
+    @"CharactersWritten" : @(statistics.numberOfCharactersWritten),
+    @"CharactersRead" : @(statistics.numberOfCharactersRead),
+    @"SyncCalls" : @(statistics.numberOfSyncCalls),
+    @"ReaderWaits" : @(statistics.numberOfReaderWaits),
+    @"ReaderWaitTime" : @(statistics.readerWaitTime / 1000000.0),
+    @"WriterWaits" : @(statistics.numberOfWriterWaits),
+    @"WriterWaitTime" : @(statistics.writerWaitTime / 1000000.0),
+  };
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Writes the statistics counters returned by gtpTransportStatistics()
+/// to the application log.
+///
+/// The reader of the log can use the counters to judge whether the size of
+/// the ring buffer or the locking scheme of PipeStreamBuffer are a bottleneck.
+/// A writer that blocks frequently indicates that the ring buffer is too small.
+/// A reader that blocks is normal, it simply waits for the next command or
+/// response.
+// -----------------------------------------------------------------------------
+- (void) logGtpTransportStatistics
+{
+  NSDictionary* gtpTransportStatistics = [self gtpTransportStatistics];
+  for (NSString* channelName in @[@"Commands", @"Responses"])
+  {
+    NSDictionary* statistics = gtpTransportStatistics[channelName];
+    if (! statistics)
+      continue;
+
+    DDLogInfo(@"%@: GTP transport statistics for channel %@: ring buffer size = %@, characters written = %@, characters read = %@, sync calls = %@, reader waits = %@ (%.3f ms), writer waits = %@ (%.3f ms)",
+              self,
+              channelName,
+              statistics[@"RingBufferSize"],
+              statistics[@"CharactersWritten"],
+              statistics[@"CharactersRead"],
+              statistics[@"SyncCalls"],
+              statistics[@"ReaderWaits"],
+              [statistics[@"ReaderWaitTime"] doubleValue],
+              statistics[@"WriterWaits"],
+              [statistics[@"WriterWaitTime"] doubleValue]);
+  }
+}
+
 @end
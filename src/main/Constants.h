@@ -144,6 +144,8 @@ enum MoreGameActionsButton
   MoreGameActionsButtonMarkAsSeki,
   MoreGameActionsButtonMarkAsDead,
   MoreGameActionsButtonUpdatePlayerInfluence,
+  MoreGameActionsButtonSolveLifeAndDeath,
+  MoreGameActionsButtonCompareVariations,
   MoreGameActionsButtonSetBlackToMove,
   MoreGameActionsButtonSetWhiteToMove,
   MoreGameActionsButtonResumePlay,
@@ -279,13 +281,17 @@ enum AlertButtonType
 /// @name Logging constants
 // -----------------------------------------------------------------------------
 //@{
-/// @brief The log level used by the application. This is always set to the
-/// highest possible value. Whether or not logging is actually enabled is a user
-/// preference that can be changed at runtime from within the application. If
-/// logging is enabled the log output goes to a DDFileLogger with default
-/// values.
+/// @brief The log level used by the application. Whether or not logging is
+/// enabled is a user preference that can be changed at runtime from within the
+/// application. If logging is enabled this is set to the highest possible
+/// value and the log output goes to a DDFileLogger. If logging is
+/// disabled this is set to #DDLogLevelOff so that log statements do not even
+/// evaluate their arguments.
+///
+/// The log level is additionally capped at compile time by
+/// LITTLEGO_LOG_LEVEL_MAXIMUM, see Prefix.pch.
 #ifndef LITTLEGO_UITESTS
-extern const DDLogLevel ddLogLevel;
+extern DDLogLevel ddLogLevel;
 #endif
 //@}
 
@@ -459,6 +465,24 @@ enum GoBoardCorner
   GoBoardCornerTopRight      ///< @brief T19 on a 19x19 board
 };
 
+/// @brief Enumerates the 8 symmetries of the Go board, i.e. the rotations and
+/// reflections that map the board onto itself. Rotations are
+/// counter-clockwise.
+///
+/// @ingroup go
+enum GoBoardSymmetry
+{
+  GoBoardSymmetryIdentity,          ///< @brief Every intersection is mapped onto itself.
+  GoBoardSymmetryRotate90,          ///< @brief A1 is mapped onto T1 on a 19x19 board.
+  GoBoardSymmetryRotate180,         ///< @brief A1 is mapped onto T19 on a 19x19 board.
+  GoBoardSymmetryRotate270,         ///< @brief A1 is mapped onto A19 on a 19x19 board.
+  GoBoardSymmetryMirrorHorizontal,  ///< @brief Reflection at the vertical axis. A1 is mapped onto T1 on a 19x19 board.
+  GoBoardSymmetryMirrorVertical,    ///< @brief Reflection at the horizontal axis. A1 is mapped onto A19 on a 19x19 board.
+  GoBoardSymmetryTranspose,         ///< @brief Reflection at the diagonal A1-T19. B1 is mapped onto A2.
+  GoBoardSymmetryAntiTranspose,     ///< @brief Reflection at the diagonal T1-A19. A1 is mapped onto T19 on a 19x19 board.
+  GoBoardSymmetryMax                ///< @brief Pseudo enum value, used to iterate over the other enum values.
+};
+
 /// @brief Enumerates the possible ko rules.
 ///
 /// @ingroup go
@@ -527,6 +551,16 @@ enum GoStoneGroupState
   GoStoneGroupStateSeki
 };
 
+/// @brief Enumerates the bits of an entry in a territory map. A territory map
+/// is returned by GoBoard::territoryMapWithScoringSystem:().
+///
+/// @ingroup go
+enum GoTerritoryMapEntry
+{
+  GoTerritoryMapEntryColorMask = 0x03,          ///< @brief The bits that hold the #GoColor value of the territory
+  GoTerritoryMapEntryInconsistentFlag = 0x80    ///< @brief Set if the territory is inconsistent. The color in this case is always #GoColorNone.
+};
+
 /// @brief Enumerates the modes the user can choose to mark stone groups.
 ///
 /// @ingroup go
@@ -836,6 +870,52 @@ enum GoNewMoveInsertPosition
   GoNewMoveInsertPositionNextBoardPosition,
 };
 
+/// @brief Enumerates the types of structural changes to the game tree that
+/// GoNodeModel records in its tree change journal.
+///
+/// @ingroup go
+enum GoNodeTreeChangeType
+{
+  /// @brief A node, together with the sub tree dangling from it, was inserted
+  /// into the game tree.
+  GoNodeTreeChangeTypeInsert,
+  /// @brief A node, together with the sub tree dangling from it, was removed
+  /// from the game tree.
+  GoNodeTreeChangeTypeRemove,
+};
+
+/// @brief Enumerates the kinds of nodes that GoNodeModel indexes so that
+/// clients can jump to the next or previous node of a kind without scanning
+/// the current variation.
+///
+/// @ingroup go
+enum GoNodeJumpTarget
+{
+  /// @brief A node for which GoUtilities::showInfoIndicatorForNode:() returns
+  /// true, e.g. because it has a comment or a move valuation.
+  GoNodeJumpTargetInfo,
+  /// @brief A node for which GoUtilities::showHotspotIndicatorForNode:()
+  /// returns true.
+  GoNodeJumpTargetHotspot,
+  /// @brief A node with markup.
+  GoNodeJumpTargetMarkup,
+  /// @brief A node with setup.
+  GoNodeJumpTargetSetup,
+  GoNodeJumpTargetMax  ///< @brief Pseudo enum value, used to iterate over the other enum values
+};
+
+/// @brief Enumerates the possible outcomes of solving a life-and-death
+/// problem with GoLifeAndDeathProblem.
+///
+/// @ingroup go
+enum GoLifeAndDeathStatus
+{
+  GoLifeAndDeathStatusNotSolved,   ///< @brief The problem has not been solved yet.
+  GoLifeAndDeathStatusDead,        ///< @brief The target stone group dies.
+  GoLifeAndDeathStatusAlive,       ///< @brief The target stone group lives, either unconditionally or in seki.
+  GoLifeAndDeathStatusUnknown      ///< @brief The solver gave up before it could reach a conclusion.
+};
+
 extern const enum GoGameType gDefaultGameType;
 extern const enum GoBoardSize gDefaultBoardSize;
 extern const int gNumberOfBoardSizes;
@@ -845,6 +925,9 @@ extern const enum GoScoringSystem gDefaultScoringSystem;
 extern const double gDefaultKomiAreaScoring;
 extern const double gDefaultKomiTerritoryScoring;
 extern const unsigned int gNoObjectReferenceNodeID;
+extern const int gDefaultBoardSnapshotInterval;
+extern const int gDefaultMaximumNumberOfBoardSnapshots;
+extern const unsigned long long gDefaultGameWorkspaceMemoryBudget;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -886,6 +969,34 @@ extern NSString* userManualFolderName;
 /// @brief Name of the marker file that is used during application launch to
 /// check whether the user manual is already set up.
 extern NSString* userManualSetupMarkerFileName;
+/// @brief Name of the folder that contains the cached thumbnail images of
+/// archived games. The folder is located in the Caches folder.
+extern NSString* archiveThumbnailsFolderName;
+/// @brief Name of the folder that contains the analysis results of archived
+/// games. The folder is located in the Application Support folder.
+extern NSString* analysisFolderName;
+/// @brief Name of the folder that contains the reports produced by
+/// RunSustainedLoadBenchmarkCommand. The folder is located in the Application
+/// Support folder.
+extern NSString* benchmarkFolderName;
+/// @brief Name of the folder that contains the pattern index of archived
+/// games. The folder is located in the Caches folder.
+extern NSString* archivePatternIndexFolderName;
+/// @brief Name of the folder that contains the files produced by
+/// ExportBoardDiagramsCommand. The folder is located in the temporary folder.
+extern NSString* boardDiagramExportFolderName;
+/// @brief Name of the file in which NodeTreeViewLayoutCache stores its
+/// content. The file is located in the Caches folder.
+extern NSString* nodeTreeViewLayoutCacheFileName;
+/// @brief Name of the file in which GtpResponseCache stores its content. The
+/// file is located in the Caches folder.
+extern NSString* gtpResponseCacheFileName;
+/// @brief Name of the file in which GoOpeningBook stores the compiled index
+/// of the opening book. The file is located in the Caches folder.
+extern NSString* openingBookIndexFileName;
+/// @brief Name of the extended file attribute in which SaveSgfCommand stores
+/// the content hash of an .sgf file that it has written.
+extern NSString* sgfContentHashAttributeName;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -906,6 +1017,10 @@ extern NSString* gtpResponseWasReceivedNotification;
 extern NSString* gtpEngineRunningNotification;
 /// @brief Is sent to indicate that the GTP engine is idle.
 extern NSString* gtpEngineIdleNotification;
+/// @brief Is sent after GtpSearchMetrics has recorded the metrics of a GTP
+/// engine search, or has discarded all metrics. The GtpSearchMetrics object is
+/// associated with the notification.
+extern NSString* gtpSearchMetricsDidChange;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -975,6 +1090,12 @@ extern NSString* computerPlayerThinkingStops;
 ///   the #moveSuggestionTypeKey and #moveSuggestionPointKey values are
 ///   undefined.
 extern NSString* computerPlayerGeneratedMoveSuggestion;
+/// @brief Is sent to indicate that PlayEngineTournamentCommand has finished
+/// playing a tournament between two GTP engine profiles.
+///
+/// The GtpEngineTournamentResult object is associated with the notification.
+/// The notification is delivered in the context of the main thread.
+extern NSString* engineTournamentDidFinish;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -994,10 +1115,13 @@ extern NSString* archiveContentChanged;
 /// GTP log has changed (e.g. a new GtpLogItem has been added, the log has
 /// been cleared, the log has rotated).
 extern NSString* gtpLogContentChanged;
-/// @brief Is sent to indicate that the information stored in a GtpLogItem
-/// object has changed.
+/// @brief Is sent to indicate that the information stored in an item of the
+/// GTP log has changed, typically because the response to the item's command
+/// has been received.
 ///
-//// The GtpLogItem object is associated with the notification.
+/// An NSNumber object with the index of the item is associated with the
+/// notification. Clients obtain the up-to-date GtpLogItem object via
+/// GtpLogModel::itemAtIndex:().
 extern NSString* gtpLogItemChanged;
 //@}
 
@@ -1038,7 +1162,10 @@ extern NSString* goScoreCalculationEnds;
 /// of dead stones is about to start. Is sent after #goScoreCalculationStarts.
 extern NSString* askGtpEngineForDeadStonesStarts;
 /// @brief Is sent to indicate that querying the GTP engine for an initial set
-/// of dead stones has ended. Is sent before #goScoreCalculationEnds.
+/// of dead stones has ended, or was aborted. The query does not block score
+/// calculation, so this is usually sent after #goScoreCalculationEnds. If the
+/// query was successful, another pair of #goScoreCalculationStarts and
+/// #goScoreCalculationEnds follows.
 extern NSString* askGtpEngineForDeadStonesEnds;
 //@}
 
@@ -1154,6 +1281,14 @@ extern NSString* boardViewSelectionRectangleDidChange;
 /// @brief Is sent to indicate that something about the layout of the tree of
 /// nodes in GoNodeModel has changed, i.e. one or more nodes were added, deleted
 /// or moved to a new location.
+///
+/// An NSArray object with GoNodeTreeChange objects is associated with the
+/// notification. The GoNodeTreeChange objects describe, in the order in which
+/// they occurred, the structural changes that were made since the previous
+/// notification was sent. Receivers can use this to update their models
+/// incrementally. If @e nil is associated with the notification instead of an
+/// NSArray, receivers must assume that the entire tree of nodes has changed
+/// (e.g. when a game is loaded).
 extern NSString* goNodeTreeLayoutDidChange;
 /// @brief Is sent to indicate that the state of an intersection has changed
 /// during board setup. The intersection now has a handicap stone, or a
@@ -1271,12 +1406,38 @@ extern NSString* numberOfBoardPositionsDidChange;
 /// value is the old current board position, the second value is the new
 /// current board position.
 ///
+/// A dictionary may in addition be associated with the notification as its
+/// user info. If present, the dictionary contains the following key/value
+/// pair:
+/// - #changedPointsKey: An NSArray object with the GoPoint objects whose stone
+///   state differs between the old and the new current board position. The
+///   array may contain additional GoPoint objects whose stone state changed
+///   and was then changed back. Observers can use this to update only the
+///   affected intersections.
+///
+/// If no dictionary is associated with the notification, observers must
+/// assume that the stone state of any intersection may have changed.
+///
 /// This notification is sent after the last #boardPositionChangeProgress.
 extern NSString* currentBoardPositionDidChange;
+/// @brief Key for the user info dictionary of #currentBoardPositionDidChange.
+extern NSString* changedPointsKey;
 /// @brief Is sent (B-A) times while the current board position in
 /// GoBoardPosition changes from A to B. Observers can use this notification to
 /// power a progress meter.
 extern NSString* boardPositionChangeProgress;
+/// @brief Is sent each time a different board position is previewed while the
+/// user scrubs through the board positions. The current board position in
+/// GoBoardPosition does not change.
+///
+/// An NSData object is associated with the notification that contains the
+/// stone states of the previewed board position, in the format of a board
+/// snapshot (see GoBoard::stoneStateSnapshot()).
+extern NSString* boardPositionPreviewDidChange;
+/// @brief Is sent when the user stops scrubbing through the board positions,
+/// after the last #boardPositionPreviewDidChange. If the user selected a board
+/// position, #currentBoardPositionDidChange is sent afterwards.
+extern NSString* boardPositionPreviewDidEnd;
 /// @brief Is sent to indicate that the current game variation in GoNodeModel
 /// is about to change.
 ///
@@ -1416,6 +1577,7 @@ extern const float iPhoneMaximumZoomScale;
 extern const float iPadMaximumZoomScale;
 extern const float moveNumbersPercentageDefault;
 extern const bool displayPlayerInfluenceDefault;
+extern const bool displayCapturableStonesDefault;
 extern const bool discardFutureNodesAlertDefault;
 extern const bool markNextMoveDefault;
 extern const bool discardMyLastMoveDefault;
@@ -1518,6 +1680,10 @@ extern NSString* moveSuggestionTypeKey;
 extern NSString* moveSuggestionPointKey;
 extern NSString* moveSuggestionErrorMessageKey;
 extern const int moveSuggestionAnimationRepeatCount;
+/// @brief The minimum interval in seconds between two UI updates while the
+/// computer plays against itself. Moves that are played within the interval
+/// are shown together in a single UI update.
+extern const double selfPlayUIRefreshInterval;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -1635,6 +1801,16 @@ enum NodeTreeViewFocusMode
   NodeTreeViewFocusModeMakeSelectedNodeCentered,         ///< @brief The view always scrolls to place the newly selected node at the center of the view (even if the node was already fully visible).
   NodeTreeViewFocusModeDisabled,                         ///< @brief Focusing on the selected node is disabled, i.e. when the selected node changes the node tree view does not scroll.
 };
+
+/// @brief The smallest absolute zoom scale of the node tree view. Zoom scales
+/// below 1.0 make the node tree smaller than its base size.
+extern const float nodeTreeViewMinimumZoomScale;
+/// @brief The node tree view is drawn with a reduced level of detail while its
+/// absolute zoom scale is below this value.
+extern const float nodeTreeViewReducedLevelOfDetailZoomScale;
+/// @brief The default maximum number of node tree layouts that
+/// NodeTreeViewLayoutCache holds.
+extern const int nodeTreeViewLayoutCacheMaximumNumberOfLayouts;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -1656,6 +1832,7 @@ extern const int fuegoMaxMemoryDefault;
 extern const int fuegoThreadCountMinimum;
 extern const int fuegoThreadCountMaximum;
 extern const int fuegoThreadCountDefault;
+extern const bool autoTuneFuegoThreadCountAndMaxMemoryDefault;
 extern const bool fuegoPonderingDefault;
 extern const unsigned int fuegoMaxPonderTimeMinimum;
 extern const unsigned int fuegoMaxPonderTimeMaximum;
@@ -1664,12 +1841,26 @@ extern const bool fuegoReuseSubtreeDefault;
 extern const unsigned int fuegoMaxThinkingTimeMinimum;
 extern const unsigned int fuegoMaxThinkingTimeMaximum;
 extern const unsigned int fuegoMaxThinkingTimeDefault;
+extern const unsigned int fuegoMaxGameTimeMinimum;
+extern const unsigned int fuegoMaxGameTimeMaximum;
+extern const unsigned int fuegoMaxGameTimeDefault;
 extern const unsigned long long fuegoMaxGamesMinimum;
 extern const unsigned long long fuegoMaxGamesMaximum;
 extern const unsigned long long fuegoMaxGamesDefault;
 extern const unsigned long long fuegoMaxGamesPlayingStrength1;
 extern const unsigned long long fuegoMaxGamesPlayingStrength2;
 extern const unsigned long long fuegoMaxGamesPlayingStrength3;
+/// @brief The number of playouts that GenerateTerritoryStatisticsCommand lets
+/// the GTP engine run to generate territory statistics.
+extern const unsigned long long territoryStatisticsMaxGames;
+/// @brief The Chebyshev distance from the last move within which territory
+/// statistics scores are replaced by the GTP engine's new scores. See
+/// GoOwnershipAccumulator.
+extern const int territoryStatisticsReweightRadius;
+/// @brief The weight that the accumulated territory statistics score of an
+/// intersection keeps if the intersection is not near the last move. See
+/// GoOwnershipAccumulator.
+extern const float territoryStatisticsPriorWeight;
 extern const bool autoSelectFuegoResignMinGamesDefault;
 extern const unsigned long long fuegoResignMinGamesDefault;
 extern const int arraySizeFuegoResignThresholdDefault;
@@ -1855,6 +2046,200 @@ extern const int gtpLogSizeMinimum;
 extern const int gtpLogSizeMaximum;
 //@}
 
+// -----------------------------------------------------------------------------
+/// @name Performance HUD constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief The interval in seconds at which PerformanceHUD updates the figures
+/// it displays.
+extern const CFTimeInterval performanceHUDUpdateInterval;
+/// @brief A frame that takes longer than this many seconds counts as a main
+/// thread stall in PerformanceHUD.
+extern const CFTimeInterval performanceHUDStallThreshold;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Memory budget constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief The interval in seconds at which MemoryBudgetManager compares the
+/// application's memory footprint against the memory budget.
+extern const NSTimeInterval memoryBudgetCheckInterval;
+/// @brief The fraction of the memory that the operating system allows the
+/// application to use that MemoryBudgetManager uses as the memory budget.
+extern const double memoryBudgetFractionOfMemoryLimit;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Deferred deallocation constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief The maximum time in seconds that DeferredDeallocationQueue spends
+/// releasing objects each time the main run loop is about to wait for events.
+/// The value is a fraction of the duration of a display frame so that the
+/// user does not notice the work.
+extern const NSTimeInterval deferredDeallocationTimeSlice;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Energy governor constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief While the device is not charging, GtpEnergyGovernor reduces
+/// pondering if the battery level is below this fraction.
+extern const float energyGovernorReducedBatteryLevel;
+/// @brief While the device is not charging, GtpEnergyGovernor turns off
+/// pondering and suspends background analysis if the battery level is below
+/// this fraction.
+extern const float energyGovernorSuspendedBatteryLevel;
+/// @brief The fraction of the maximum ponder time configured in the active GTP
+/// engine profile that GtpEnergyGovernor allows when pondering is reduced.
+extern const double energyGovernorReducedPonderTimeFraction;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Tactical reader constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief The maximum number of nodes that GoTacticalReader may visit when it
+/// reads a single stone group on behalf of GoBoard.
+extern const int tacticalReaderNodeBudget;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Life and death solver constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief The maximum number of nodes that GoLifeAndDeathSolver may visit when
+/// it solves a life-and-death problem on behalf of GoLifeAndDeathProblem.
+extern const int lifeAndDeathSolverNodeBudget;
+/// @brief The number of lines by which the bounding box of the target stone
+/// group is enlarged to find the region of a life-and-death problem.
+extern const int lifeAndDeathSolverRegionMargin;
+/// @brief The maximum number of empty intersections in the region of a
+/// life-and-death problem. Larger problems are not solved because the search
+/// would exhaust its node budget anyway.
+extern const int lifeAndDeathSolverMaximumRegionSize;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Diagram export constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief Enumerates the file formats into which ExportBoardDiagramsCommand
+/// can export board diagrams.
+enum BoardDiagramExportFormat
+{
+  BoardDiagramExportFormatPNG,           ///< @brief One .png file per board position.
+  BoardDiagramExportFormatPDF,           ///< @brief A single .pdf file with one page per board position.
+  BoardDiagramExportFormatAnimatedGIF,   ///< @brief A single animated .gif file with one frame per board position.
+};
+
+/// @brief The side length, in points, of an exported board diagram.
+extern const CGFloat boardDiagramExportSideLength;
+/// @brief The scale factor of exported bitmap images. With the default side
+/// length this results in images that can be printed in good quality.
+extern const CGFloat boardDiagramExportImageScale;
+/// @brief The time, in seconds, that each frame of an animated board diagram
+/// export is displayed.
+extern const double boardDiagramExportFrameDuration;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Session recording constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief Launch argument that causes the app to start recording the user
+/// session at launch. See SessionRecorder.
+extern NSString* recordSessionLaunchArgument;
+/// @brief Key of a session recording entry whose value is the entry type.
+extern NSString* sessionRecordingEntryTypeKey;
+/// @brief Key of a session recording entry whose value is the number of
+/// seconds since recording started.
+extern NSString* sessionRecordingEntryTimeKey;
+/// @brief Key of a session recording entry whose value is the command name or
+/// the GTP command string.
+extern NSString* sessionRecordingEntryContentKey;
+/// @brief Entry type of a session recording entry that records a command that
+/// was submitted to CommandProcessor.
+extern NSString* sessionRecordingEntryTypeCommand;
+/// @brief Entry type of a session recording entry that records a GTP command
+/// that was submitted to GtpClient.
+extern NSString* sessionRecordingEntryTypeGtpCommand;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Sustained load benchmark constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief Launch argument that causes the app to run
+/// RunSustainedLoadBenchmarkCommand after it has finished launching.
+extern NSString* sustainedLoadBenchmarkLaunchArgument;
+/// @brief Launch environment key whose value overrides the duration in seconds
+/// of the sustained load benchmark.
+extern NSString* sustainedLoadBenchmarkDurationLaunchEnvironmentKey;
+/// @brief Launch environment key whose value overrides the number of threads
+/// that the GTP engine uses during the sustained load benchmark.
+extern NSString* sustainedLoadBenchmarkThreadCountLaunchEnvironmentKey;
+/// @brief Launch environment key whose value overrides the quality of service
+/// of the searches of the sustained load benchmark. Valid values are
+/// "userInteractive", "userInitiated", "utility" and "background".
+extern NSString* sustainedLoadBenchmarkQualityOfServiceLaunchEnvironmentKey;
+/// @brief Launch environment key whose value, if "0", prevents the sustained
+/// load benchmark from cooperating with GtpEnergyGovernor.
+extern NSString* sustainedLoadBenchmarkEnergyGovernorLaunchEnvironmentKey;
+/// @brief The default duration in seconds of the sustained load benchmark.
+extern const double sustainedLoadBenchmarkDurationDefault;
+/// @brief The number of playouts of each search of the sustained load
+/// benchmark.
+extern const unsigned long long sustainedLoadBenchmarkMaxGames;
+/// @brief The length in seconds of the periods at the start and at the end of
+/// the sustained load benchmark whose playout rates are compared.
+extern const double sustainedLoadBenchmarkComparisonPeriod;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Thread scaling benchmark constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief Launch argument that causes the app to run
+/// RunThreadScalingBenchmarkCommand after it has finished launching.
+extern NSString* threadScalingBenchmarkLaunchArgument;
+/// @brief Launch environment key whose value overrides the time in seconds
+/// of each search of the thread scaling benchmark.
+extern NSString* threadScalingBenchmarkSearchTimeLaunchEnvironmentKey;
+/// @brief Launch environment key whose value overrides the number of searches
+/// that the thread scaling benchmark runs for each number of threads.
+extern NSString* threadScalingBenchmarkRepetitionsLaunchEnvironmentKey;
+/// @brief The default time in seconds of each search of the thread scaling
+/// benchmark.
+extern const unsigned int threadScalingBenchmarkSearchTimeDefault;
+/// @brief The default number of searches that the thread scaling benchmark
+/// runs for each number of threads.
+extern const int threadScalingBenchmarkRepetitionsDefault;
+/// @brief The efficiency per thread, relative to a single thread, that a
+/// number of threads must at least achieve to be recommended by the thread
+/// scaling benchmark.
+extern const double threadScalingBenchmarkMinimumEfficiency;
+/// @brief User defaults key under which the result of the most recent thread
+/// scaling benchmark is stored. The value is a dictionary with the keys
+/// "deviceModel" and "recommendedNumberOfThreads".
+extern NSString* threadScalingBenchmarkResultKey;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Remote GTP engine constants
+// -----------------------------------------------------------------------------
+//@{
+/// @brief The number of times the app tries to reconnect to the remote GTP
+/// engine after the connection has failed, before it falls back to the
+/// embedded GTP engine. At launch the app tries only once.
+extern const int remoteGtpEngineConnectAttempts;
+/// @brief The time in seconds that the app waits between two attempts to
+/// connect to the remote GTP engine.
+extern const double remoteGtpEngineConnectRetryDelay;
+//@}
+
 // -----------------------------------------------------------------------------
 /// @name Bug report constants
 // -----------------------------------------------------------------------------
@@ -1890,6 +2275,9 @@ extern NSString* bugReportBoardAsSeenByGtpEngineFileName;
 /// @brief Name of the .zip archive file that is used to collect the application
 /// log files.
 extern NSString* bugReportLogsArchiveFileName;
+/// @brief Name of the bug report file that stores the session recording, if
+/// the session is being recorded.
+extern NSString* bugReportSessionRecordingFileName;
 /// @brief Email address of the bug report email recipient.
 extern NSString* bugReportEmailRecipient;
 /// @brief Subject for the bug report email.
@@ -2030,6 +2418,7 @@ extern NSString* boardViewKey;
 extern NSString* markLastMoveKey;
 extern NSString* displayCoordinatesKey;
 extern NSString* displayPlayerInfluenceKey;
+extern NSString* displayCapturableStonesKey;
 extern NSString* moveNumbersPercentageKey;
 extern NSString* playSoundKey;
 extern NSString* vibrateKey;
@@ -2072,10 +2461,12 @@ extern NSString* gtpEngineProfileNameKey;
 extern NSString* gtpEngineProfileDescriptionKey;
 extern NSString* fuegoMaxMemoryKey;
 extern NSString* fuegoThreadCountKey;
+extern NSString* autoTuneFuegoThreadCountAndMaxMemoryKey;
 extern NSString* fuegoPonderingKey;
 extern NSString* fuegoMaxPonderTimeKey;
 extern NSString* fuegoReuseSubtreeKey;
 extern NSString* fuegoMaxThinkingTimeKey;
+extern NSString* fuegoMaxGameTimeKey;
 extern NSString* fuegoMaxGamesKey;
 extern NSString* autoSelectFuegoResignMinGamesKey;
 extern NSString* fuegoResignMinGamesKey;
@@ -2083,10 +2474,18 @@ extern NSString* fuegoResignThresholdKey;
 // GTP engine configuration not related to profiles
 extern NSString* gtpEngineConfigurationKey;
 extern NSString* additiveKnowledgeMemoryThresholdKey;
+// Remote GTP engine settings
+extern NSString* remoteGtpEngineKey;
+extern NSString* remoteGtpEngineEnabledKey;
+extern NSString* remoteGtpEngineHostKey;
+extern NSString* remoteGtpEnginePortKey;
+extern NSString* remoteGtpEngineConnectTimeoutKey;
+extern NSString* remoteGtpEngineResponseTimeoutKey;
 // Archive view settings
 extern NSString* archiveViewKey;
 extern NSString* sortCriteriaKey;
 extern NSString* sortAscendingKey;
+extern NSString* compressGamesKey;
 // SGF settings
 extern NSString* sgfSettingsKey;
 extern NSString* loadSuccessTypeKey;
@@ -2124,6 +2523,7 @@ extern NSString* discardMyLastMoveKey;
 // Logging settings
 extern NSString* loggingKey;
 extern NSString* loggingEnabledKey;
+extern NSString* signpostCategoriesKey;
 // User interface settings
 extern NSString* uiSettingsKey;
 extern NSString* visibleUIAreaKey;
@@ -2195,6 +2595,7 @@ extern NSString* goGameRulesKey;
 extern NSString* goGameDocumentKey;
 extern NSString* goGameScoreKey;
 extern NSString* goGameSetupFirstMoveColorKey;
+extern NSString* goGameZobristHashAfterHandicapKey;
 // GoPlayer keys
 extern NSString* goPlayerPlayerUUIDKey;
 extern NSString* goPlayerIsBlackKey;
@@ -2215,15 +2616,9 @@ extern NSString* goBoardVertexDictKey;
 extern NSString* goBoardStarPointsKey;
 // GoBoardRegion keys
 extern NSString* goBoardRegionPointsKey;
-extern NSString* goBoardRegionScoringModeKey;
 extern NSString* goBoardRegionTerritoryColorKey;
 extern NSString* goBoardRegionTerritoryInconsistencyFoundKey;
 extern NSString* goBoardRegionStoneGroupStateKey;
-extern NSString* goBoardRegionCachedSizeKey;
-extern NSString* goBoardRegionCachedIsStoneGroupKey;
-extern NSString* goBoardRegionCachedColorKey;
-extern NSString* goBoardRegionCachedLibertiesKey;
-extern NSString* goBoardRegionCachedAdjacentRegionsKey;
 // GoNode keys
 extern NSString* goNodeFirstChildKey;
 extern NSString* goNodeNextSiblingKey;
@@ -2232,6 +2627,7 @@ extern NSString* goNodeGoNodeSetupKey;
 extern NSString* goNodeGoMoveKey;
 extern NSString* goNodeGoNodeAnnotationKey;
 extern NSString* goNodeGoNodeMarkupKey;
+extern NSString* goNodeZobristHashKey;
 // GoNodeSetup keys
 extern NSString* goNodeSetupGameKey;
 extern NSString* goNodeSetupBlackSetupStonesKey;
@@ -2360,6 +2756,7 @@ extern NSString* annotationViewShortDescriptionLabelAccessibilityIdentifier;
 extern NSString* annotationViewLongDescriptionLabelAccessibilityIdentifier;
 extern NSString* annotationViewEditDescriptionButtonAccessibilityIdentifier;
 extern NSString* annotationViewRemoveDescriptionButtonAccessibilityIdentifier;
+extern NSString* nodeTreeViewAccessibilityIdentifier;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -2367,4 +2764,48 @@ extern NSString* annotationViewRemoveDescriptionButtonAccessibilityIdentifier;
 // -----------------------------------------------------------------------------
 //@{
 extern NSString* uiTestModeLaunchArgument;
+/// @brief The key of the launch environment variable that UI tests can use to
+/// pass SGF content to the app. If the app launches in UI test mode and the
+/// variable is present, the app restores the game from the SGF content.
+extern NSString* uiTestSgfContentLaunchEnvironmentKey;
+//@}
+
+// -----------------------------------------------------------------------------
+/// @name Signpost constants
+///
+/// @brief The app emits os_signpost intervals while it executes commands,
+/// exchanges commands and responses with the GTP engine, updates the Go model,
+/// draws the layers of the board view and the node tree view, and while it
+/// goes through the phases of application launch. Performance
+/// tests use these constants to measure the duration of the intervals. Each
+/// group of intervals is emitted in its own category, which the user can
+/// switch on and off (see LoggingModel).
+// -----------------------------------------------------------------------------
+//@{
+/// @brief Enumerates the categories of signposts that the app emits. The
+/// values are bits that can be combined.
+enum SignpostCategory
+{
+  SignpostCategoryNone = 0x00,
+  SignpostCategoryCommands = 0x01,   ///< @brief CommandProcessor executes a command
+  SignpostCategoryGtp = 0x02,        ///< @brief GtpClient processes a GTP command
+  SignpostCategoryGoModel = 0x04,    ///< @brief Go model operations, e.g. playing a move or scoring
+  SignpostCategoryDrawing = 0x08,    ///< @brief Canvas calculation and drawing of board view and node tree view
+  SignpostCategoryLaunch = 0x10,     ///< @brief Phases of application launch
+  SignpostCategoryAll = 0x1f
+};
+extern NSString* drawingSignpostSubsystem;
+extern NSString* drawingSignpostCategory;
+extern NSString* commandsSignpostCategory;
+extern NSString* gtpSignpostCategory;
+extern NSString* goModelSignpostCategory;
+extern NSString* launchSignpostCategory;
+extern NSString* boardViewDrawLayerSignpostName;
+extern NSString* nodeTreeViewDrawLayerSignpostName;
+extern NSString* launchSetupLoggingSignpostName;
+extern NSString* launchSetupUserDefaultsSignpostName;
+extern NSString* launchSetupFuegoSignpostName;
+extern NSString* launchSetupGUISignpostName;
+extern NSString* launchSetupApplicationSignpostName;
+extern NSString* launchRestoreApplicationStateSignpostName;
 //@}
@@ -27,7 +27,7 @@ const CGFloat uiAreaPlayResizablePaneMinimumSize = 0.1f;
 
 // Logging constants
 #ifndef LITTLEGO_UITESTS
-const DDLogLevel ddLogLevel = DDLogLevelAll;
+DDLogLevel ddLogLevel = DDLogLevelOff;
 #endif
 
 // Go constants
@@ -43,6 +43,12 @@ const double gDefaultKomiTerritoryScoring = 6.5;
 // value that NSCoder::decodeIntForKey:() returns if an archive does not contain
 // the specified key. See GoNode implementation for details.
 const unsigned int gNoObjectReferenceNodeID = 0;
+// With these values snapshots cover the first 1000 nodes of a variation, using
+// less than 15 KB of memory on a 19x19 board
+const int gDefaultBoardSnapshotInterval = 25;
+const int gDefaultMaximumNumberOfBoardSnapshots = 40;
+// Enough for a handful of typical games with a few hundred nodes each
+const unsigned long long gDefaultGameWorkspaceMemoryBudget = 8 * 1024 * 1024;
 
 // Filesystem related constants
 NSString* sgfTemporaryFileName = @"---tmp+++.sgf";
@@ -51,12 +57,22 @@ NSString* sgfBackupFileName = @"backup.sgf";
 NSString* inboxFolderName = @"Inbox";
 NSString* userManualFolderName = @"usermanual";
 NSString* userManualSetupMarkerFileName = @"usermanual.setupmarker";
+NSString* archiveThumbnailsFolderName = @"ArchiveThumbnails";
+NSString* analysisFolderName = @"Analysis";
+NSString* benchmarkFolderName = @"Benchmarks";
+NSString* archivePatternIndexFolderName = @"ArchivePatternIndex";
+NSString* boardDiagramExportFolderName = @"BoardDiagrams";
+NSString* nodeTreeViewLayoutCacheFileName = @"NodeTreeViewLayoutCache.plist";
+NSString* gtpResponseCacheFileName = @"GtpResponseCache.plist";
+NSString* openingBookIndexFileName = @"OpeningBookIndex.bin";
+NSString* sgfContentHashAttributeName = @"ch.herzbube.littlego.SgfContentHash";
 
 // GTP notifications
 NSString* gtpCommandWillBeSubmittedNotification = @"GtpCommandWillBeSubmitted";
 NSString* gtpResponseWasReceivedNotification = @"GtpResponseWasReceived";
 NSString* gtpEngineRunningNotification = @"GtpEngineRunning";
 NSString* gtpEngineIdleNotification = @"GtpEngineIdle";
+NSString* gtpSearchMetricsDidChange = @"GtpSearchMetricsDidChange";
 // GoGame notifications
 NSString* goGameWillCreate = @"GoGameWillCreate";
 NSString* goGameDidCreate = @"GoGameDidCreate";
@@ -65,6 +81,7 @@ NSString* goGameStateChanged = @"GoGameStateChanged";
 NSString* computerPlayerThinkingStarts = @"ComputerPlayerThinkingStarts";
 NSString* computerPlayerThinkingStops = @"ComputerPlayerThinkingStops";
 NSString* computerPlayerGeneratedMoveSuggestion = @"ComputerPlayerGeneratedMoveSuggestion";
+NSString* engineTournamentDidFinish = @"EngineTournamentDidFinish";
 // Archive related notifications
 NSString* archiveContentChanged = @"ArchiveContentChanged";
 // GTP log related notifications
@@ -97,7 +114,10 @@ NSString* allMarkupDidDiscard = @"AllMarkupDidDiscard";
 // Game variation notifications
 NSString* numberOfBoardPositionsDidChange = @"NumberOfBoardPositionsDidChange";
 NSString* currentBoardPositionDidChange = @"CurrentBoardPositionDidChange";
+NSString* changedPointsKey = @"ChangedPoints";
 NSString* boardPositionChangeProgress = @"BoardPositionChangeProgress";
+NSString* boardPositionPreviewDidChange = @"BoardPositionPreviewDidChange";
+NSString* boardPositionPreviewDidEnd = @"BoardPositionPreviewDidEnd";
 NSString* currentGameVariationWillChange = @"CurrentGameVariationWillChange";
 NSString* currentGameVariationDidChange = @"CurrentGameVariationDidChange";
 // Node tree view notifications
@@ -126,6 +146,12 @@ const float iPhoneMaximumZoomScale = 2.5;
 const float iPadMaximumZoomScale = 2.0;
 const float moveNumbersPercentageDefault = 0.0;
 const bool displayPlayerInfluenceDefault = false;
+const bool displayCapturableStonesDefault = false;
+
+// Node tree view constants
+const float nodeTreeViewMinimumZoomScale = 0.25;
+const float nodeTreeViewReducedLevelOfDetailZoomScale = 1.0;
+const int nodeTreeViewLayoutCacheMaximumNumberOfLayouts = 10;
 
 // Board position settings default values
 const bool discardFutureNodesAlertDefault = true;
@@ -142,6 +168,7 @@ NSString* moveSuggestionTypeKey = @"moveSuggestionType";;
 NSString* moveSuggestionPointKey = @"moveSuggestionPoint";
 NSString* moveSuggestionErrorMessageKey = @"moveSuggestionErrorMessage";
 const int moveSuggestionAnimationRepeatCount = 3;
+const double selfPlayUIRefreshInterval = 0.5;
 
 // GTP engine profile constants
 const int minimumPlayingStrength = 1;
@@ -157,6 +184,7 @@ const int fuegoMaxMemoryDefault = 32;
 const int fuegoThreadCountMinimum = 1;
 const int fuegoThreadCountMaximum = 8;
 const int fuegoThreadCountDefault = 1;
+const bool autoTuneFuegoThreadCountAndMaxMemoryDefault = false;
 const bool fuegoPonderingDefault = false;
 const unsigned int fuegoMaxPonderTimeMinimum = 60;     // assign only values that are full minutes because
                                                        // the UI lets the user pick minute values
@@ -167,6 +195,10 @@ const unsigned int fuegoMaxThinkingTimeMinimum = 1;
 const unsigned int fuegoMaxThinkingTimeMaximum = 120;  // not too high, user must be able to pick individual values
                                                        // in the range from 1-10 seconds in the Settings tab
 const unsigned int fuegoMaxThinkingTimeDefault = 10;
+const unsigned int fuegoMaxGameTimeMinimum = 0;        // 0 = no time budget for the game; assign only values that are
+                                                       // full minutes because the UI lets the user pick minute values
+const unsigned int fuegoMaxGameTimeMaximum = 3600;     // ditto
+const unsigned int fuegoMaxGameTimeDefault = 0;        // ditto
 const unsigned long long fuegoMaxGamesMinimum = 1;
 const unsigned long long fuegoMaxGamesMaximum = 18446744073709551615ULL;  // std::numeric_limits<unsigned long long>::max();
 const unsigned long long fuegoMaxGamesDefault = 18446744073709551615ULL;  // std::numeric_limits<unsigned long long>::max();
@@ -175,6 +207,9 @@ const unsigned long long fuegoMaxGamesPlayingStrength1 = 500;    // start with 5
 const unsigned long long fuegoMaxGamesPlayingStrength2 = 5000;
 const unsigned long long fuegoMaxGamesPlayingStrength3 = 10000;  // on fast CPUs this still imposes a noticable
                                                                  // limit (measurement made on a MacBook)
+const unsigned long long territoryStatisticsMaxGames = 5000;
+const int territoryStatisticsReweightRadius = 3;
+const float territoryStatisticsPriorWeight = 0.75f;
 const bool autoSelectFuegoResignMinGamesDefault = true;
 const unsigned long long fuegoResignMinGamesDefault = 5000;
 const int arraySizeFuegoResignThresholdDefault = (GoBoardSizeMax - GoBoardSizeMin) / 2 + 1;
@@ -209,8 +244,68 @@ const int gMaximumNumberMarkerValue = 9;
 const int gtpLogSizeMinimum = 5;
 const int gtpLogSizeMaximum = 1000;
 
+// Performance HUD constants
+const CFTimeInterval performanceHUDUpdateInterval = 0.5;
+const CFTimeInterval performanceHUDStallThreshold = 0.1;
+
+// Memory budget constants
+const NSTimeInterval memoryBudgetCheckInterval = 5.0;
+const double memoryBudgetFractionOfMemoryLimit = 0.75;
+
+// Deferred deallocation constants
+const NSTimeInterval deferredDeallocationTimeSlice = 0.004;
+
+// Energy governor constants
+const float energyGovernorReducedBatteryLevel = 0.5f;
+const float energyGovernorSuspendedBatteryLevel = 0.2f;
+const double energyGovernorReducedPonderTimeFraction = 0.25;
+
+// Tactical reader constants
+const int tacticalReaderNodeBudget = 500;
+
+// Life and death solver constants
+const int lifeAndDeathSolverNodeBudget = 100000;
+const int lifeAndDeathSolverRegionMargin = 2;
+const int lifeAndDeathSolverMaximumRegionSize = 24;
+
+// Diagram export constants
+const CGFloat boardDiagramExportSideLength = 400.0;
+const CGFloat boardDiagramExportImageScale = 3.0;
+const double boardDiagramExportFrameDuration = 1.0;
+
+// Session recording constants
+NSString* recordSessionLaunchArgument = @"--record-session";
+NSString* sessionRecordingEntryTypeKey = @"Type";
+NSString* sessionRecordingEntryTimeKey = @"Time";
+NSString* sessionRecordingEntryContentKey = @"Content";
+NSString* sessionRecordingEntryTypeCommand = @"Command";
+NSString* sessionRecordingEntryTypeGtpCommand = @"GtpCommand";
+
+// Sustained load benchmark constants
+NSString* sustainedLoadBenchmarkLaunchArgument = @"--sustained-load-benchmark";
+NSString* sustainedLoadBenchmarkDurationLaunchEnvironmentKey = @"SUSTAINED_LOAD_BENCHMARK_DURATION";
+NSString* sustainedLoadBenchmarkThreadCountLaunchEnvironmentKey = @"SUSTAINED_LOAD_BENCHMARK_THREAD_COUNT";
+NSString* sustainedLoadBenchmarkQualityOfServiceLaunchEnvironmentKey = @"SUSTAINED_LOAD_BENCHMARK_QOS";
+NSString* sustainedLoadBenchmarkEnergyGovernorLaunchEnvironmentKey = @"SUSTAINED_LOAD_BENCHMARK_ENERGY_GOVERNOR";
+const double sustainedLoadBenchmarkDurationDefault = 1200.0;
+const unsigned long long sustainedLoadBenchmarkMaxGames = 20000;
+const double sustainedLoadBenchmarkComparisonPeriod = 60.0;
+
+// Thread scaling benchmark constants
+NSString* threadScalingBenchmarkLaunchArgument = @"--thread-scaling-benchmark";
+NSString* threadScalingBenchmarkSearchTimeLaunchEnvironmentKey = @"THREAD_SCALING_BENCHMARK_SEARCH_TIME";
+NSString* threadScalingBenchmarkRepetitionsLaunchEnvironmentKey = @"THREAD_SCALING_BENCHMARK_REPETITIONS";
+const unsigned int threadScalingBenchmarkSearchTimeDefault = 10;
+const int threadScalingBenchmarkRepetitionsDefault = 3;
+const double threadScalingBenchmarkMinimumEfficiency = 0.7;
+NSString* threadScalingBenchmarkResultKey = @"ThreadScalingBenchmarkResult";
+
+// Remote GTP engine constants
+const int remoteGtpEngineConnectAttempts = 3;
+const double remoteGtpEngineConnectRetryDelay = 1.0;
+
 // Bug reports constants
-const int bugReportFormatVersion = 12;
+const int bugReportFormatVersion = 13;
 NSString* bugReportDiagnosticsInformationFileName = @"littlego-bugreport.zip";
 NSString* bugReportDiagnosticsInformationFileMimeType = @"application/zip";
 NSString* bugReportInfoFileName = @"bugreport-info.plist";
@@ -220,6 +315,7 @@ NSString* bugReportCurrentGameFileName = @ "currentgame.sgf";
 NSString* bugReportScreenshotFileName = @ "screenshot.png";
 NSString* bugReportBoardAsSeenByGtpEngineFileName = @ "showboard.txt";
 NSString* bugReportLogsArchiveFileName = @ "logs.zip";
+NSString* bugReportSessionRecordingFileName = @ "session-recording.plist";
 NSString* bugReportEmailRecipient = @"herzbube@herzbube.ch";
 NSString* bugReportEmailSubject = @"Little Go Bug Report";
 
@@ -320,6 +416,7 @@ NSString* boardViewKey = @"BoardView";
 NSString* markLastMoveKey = @"MarkLastMove";
 NSString* displayCoordinatesKey = @"DisplayCoordinates";
 NSString* displayPlayerInfluenceKey = @"DisplayPlayerInfluence";
+NSString* displayCapturableStonesKey = @"DisplayCapturableStones";
 NSString* moveNumbersPercentageKey = @"MoveNumbersPercentage";
 NSString* playSoundKey = @"PlaySound";
 NSString* vibrateKey = @"Vibrate";
@@ -362,10 +459,12 @@ NSString* gtpEngineProfileNameKey = @"Name";
 NSString* gtpEngineProfileDescriptionKey = @"Description";
 NSString* fuegoMaxMemoryKey = @"FuegoMaxMemory";
 NSString* fuegoThreadCountKey = @"FuegoThreadCount";
+NSString* autoTuneFuegoThreadCountAndMaxMemoryKey = @"AutoTuneFuegoThreadCountAndMaxMemory";
 NSString* fuegoPonderingKey = @"FuegoPondering";
 NSString* fuegoMaxPonderTimeKey = @"FuegoMaxPonderTime";
 NSString* fuegoReuseSubtreeKey = @"FuegoReuseSubtree";
 NSString* fuegoMaxThinkingTimeKey = @"FuegoMaxThinkingTime";
+NSString* fuegoMaxGameTimeKey = @"FuegoMaxGameTime";
 NSString* fuegoMaxGamesKey = @"FuegoMaxGames";
 NSString* autoSelectFuegoResignMinGamesKey = @"AutoSelectFuegoResignMinGames";
 NSString* fuegoResignMinGamesKey = @"FuegoResignMinGames";
@@ -373,10 +472,18 @@ NSString* fuegoResignThresholdKey = @"FuegoResignThreshold";
 // GTP engine configuration not related to profiles
 NSString* gtpEngineConfigurationKey = @"GtpEngineConfiguration";
 NSString* additiveKnowledgeMemoryThresholdKey = @"AdditiveKnowledgeMemoryThreshold";
+// Remote GTP engine settings
+NSString* remoteGtpEngineKey = @"RemoteGtpEngine";
+NSString* remoteGtpEngineEnabledKey = @"Enabled";
+NSString* remoteGtpEngineHostKey = @"Host";
+NSString* remoteGtpEnginePortKey = @"Port";
+NSString* remoteGtpEngineConnectTimeoutKey = @"ConnectTimeout";
+NSString* remoteGtpEngineResponseTimeoutKey = @"ResponseTimeout";
 // Archive view settings
 NSString* archiveViewKey = @"ArchiveView";
 NSString* sortCriteriaKey = @"SortCriteria";
 NSString* sortAscendingKey = @"SortAscending";
+NSString* compressGamesKey = @"CompressGames";
 // SGF settings
 NSString* sgfSettingsKey = @"Sgf";
 NSString* loadSuccessTypeKey = @"LoadSuccessType";
@@ -414,6 +521,7 @@ NSString* discardMyLastMoveKey = @"DiscardMyLastMove";
 // Logging settings
 NSString* loggingKey = @"Logging";
 NSString* loggingEnabledKey = @"LoggingEnabled";
+NSString* signpostCategoriesKey = @"SignpostCategories";
 // User interface settings
 NSString* uiSettingsKey = @"UiSettings";
 NSString* visibleUIAreaKey = @"VisibleUIArea";
@@ -459,7 +567,7 @@ NSString* newMoveInsertPositionKey = @"NewMoveInsertPosition";
 
 // Constants for NSCoding
 // General constants
-const int nscodingVersion = 12;  // if you change this, also change bugReportFormatVersion
+const int nscodingVersion = 13;  // if you change this, also change bugReportFormatVersion
 NSString* nscodingVersionKey = @"NSCodingVersion";
 // Top-level object keys
 NSString* nsCodingGoGameKey = @"GoGame";
@@ -481,6 +589,7 @@ NSString* goGameRulesKey = @"Rules";
 NSString* goGameDocumentKey = @"Document";
 NSString* goGameScoreKey = @"Score";
 NSString* goGameSetupFirstMoveColorKey = @"SetupFirstMoveColor";
+NSString* goGameZobristHashAfterHandicapKey = @"ZobristHashAfterHandicap";
 // GoPlayer keys
 NSString* goPlayerPlayerUUIDKey = @"PlayerUUID";
 NSString* goPlayerIsBlackKey = @"IsBlack";
@@ -501,15 +610,9 @@ NSString* goBoardVertexDictKey = @"VertexDict";
 NSString* goBoardStarPointsKey = @"StarPoints";
 // GoBoardRegion keys
 NSString* goBoardRegionPointsKey = @"Points";
-NSString* goBoardRegionScoringModeKey = @"ScoringMode";
 NSString* goBoardRegionTerritoryColorKey = @"TerritoryColor";
 NSString* goBoardRegionTerritoryInconsistencyFoundKey = @"TerritoryInconsistencyFound";
 NSString* goBoardRegionStoneGroupStateKey = @"StoneGroupState";
-NSString* goBoardRegionCachedSizeKey = @"CachedSize";
-NSString* goBoardRegionCachedIsStoneGroupKey = @"CachedIsStoneGroup";
-NSString* goBoardRegionCachedColorKey = @"CachedColor";
-NSString* goBoardRegionCachedLibertiesKey = @"CachedLiberties";
-NSString* goBoardRegionCachedAdjacentRegionsKey = @"CachedAdjacentRegions";
 // GoNode keys
 NSString* goNodeFirstChildKey = @"FirstChild";
 NSString* goNodeNextSiblingKey = @"NextSibling";
@@ -518,6 +621,7 @@ NSString* goNodeGoNodeSetupKey = @"GoNodeSetup";
 NSString* goNodeGoMoveKey = @"GoMove";
 NSString* goNodeGoNodeAnnotationKey = @"GoNodeAnnotation";
 NSString* goNodeGoNodeMarkupKey = @"GoNodeMarkup";
+NSString* goNodeZobristHashKey = @"ZobristHash";
 // GoNodeSetup keys
 NSString* goNodeSetupGameKey = @"Game";
 NSString* goNodeSetupBlackSetupStonesKey = @"BlackSetupStones";
@@ -641,6 +745,27 @@ NSString* annotationViewShortDescriptionLabelAccessibilityIdentifier = @"annotat
 NSString* annotationViewLongDescriptionLabelAccessibilityIdentifier = @"annotationViewLongDescriptionLabel";
 NSString* annotationViewEditDescriptionButtonAccessibilityIdentifier = @"annotationViewEditDescriptionButton";
 NSString* annotationViewRemoveDescriptionButtonAccessibilityIdentifier = @"annotationViewRemoveDescriptionButton";
+NSString* nodeTreeViewAccessibilityIdentifier = @"nodeTreeView";
 
 // Other UI testing constants
 NSString* uiTestModeLaunchArgument = @"--ui-test-mode";
+NSString* uiTestSgfContentLaunchEnvironmentKey = @"UI_TEST_SGF_CONTENT";
+
+// Signpost constants
+NSString* drawingSignpostSubsystem = @"ch.herzbube.littlego";
+NSString* drawingSignpostCategory = @"Drawing";
+NSString* commandsSignpostCategory = @"Commands";
+NSString* gtpSignpostCategory = @"GTP";
+NSString* goModelSignpostCategory = @"GoModel";
+NSString* launchSignpostCategory = @"Launch";
+// These must match the literal signpost names used by SignpostLayer
+NSString* boardViewDrawLayerSignpostName = @"BoardViewDrawLayer";
+NSString* nodeTreeViewDrawLayerSignpostName = @"NodeTreeViewDrawLayer";
+// These must match the literal signpost names used by ApplicationDelegate and
+// SetupApplicationCommand
+NSString* launchSetupLoggingSignpostName = @"SetupLogging";
+NSString* launchSetupUserDefaultsSignpostName = @"SetupUserDefaults";
+NSString* launchSetupFuegoSignpostName = @"SetupFuego";
+NSString* launchSetupGUISignpostName = @"SetupGUI";
+NSString* launchSetupApplicationSignpostName = @"SetupApplication";
+NSString* launchRestoreApplicationStateSignpostName = @"RestoreApplicationState";
@@ -45,6 +45,19 @@ enum BoardPositionCollectionViewCellType
   BoardPositionCollectionViewCellTypePositionNonZero
 };
 
+/// @brief Enumerates the content properties that influence the dynamic Auto
+/// Layout constraints. A combination of these flags describes the layout that
+/// the dynamic Auto Layout constraints were last configured for.
+enum BoardPositionCollectionViewCellLayoutFlag
+{
+  BoardPositionCollectionViewCellLayoutFlagDetailText = 0x01,
+  BoardPositionCollectionViewCellLayoutFlagInfoIcon = 0x02,
+  BoardPositionCollectionViewCellLayoutFlagHotspotIcon = 0x04,
+  BoardPositionCollectionViewCellLayoutFlagMarkupIcon = 0x08,
+  /// @brief The dynamic Auto Layout constraints have not been configured yet.
+  BoardPositionCollectionViewCellLayoutFlagsUndefined = -1
+};
+
 /// @brief A private implementation of the NodeTreeViewCanvasDataProvider
 /// protocol that provides data for a zero-size canvas. Used for drawing the
 /// node symbol images.
@@ -151,6 +164,7 @@ static UIFont* smallFont = nil;
 @interface BoardPositionCollectionViewCell()
 @property(nonatomic, assign) bool offscreenMode;
 @property(nonatomic, assign) bool didLayoutSubviewsBefore;
+@property(nonatomic, assign) int layoutFlagsOfDynamicAutoLayoutConstraints;
 @property(nonatomic, assign) UIImageView* nodeSymbolImageView;
 @property(nonatomic, assign) UILabel* textLabel;
 @property(nonatomic, assign) UILabel* detailTextLabel;
@@ -190,6 +204,7 @@ static UIFont* smallFont = nil;
 
   self.offscreenMode = false;
   self.didLayoutSubviewsBefore = false;
+  self.layoutFlagsOfDynamicAutoLayoutConstraints = BoardPositionCollectionViewCellLayoutFlagsUndefined;
 
   // Don't use self, we don't want to trigger the setter
   _boardPosition = -1;
@@ -227,6 +242,7 @@ static UIFont* smallFont = nil;
 
   self.offscreenMode = true;
   self.didLayoutSubviewsBefore = false;
+  self.layoutFlagsOfDynamicAutoLayoutConstraints = BoardPositionCollectionViewCellLayoutFlagsUndefined;
 
   // Don't use self, we don't want to trigger the setter
   if (cellType == BoardPositionCollectionViewCellTypePositionZero)
@@ -927,6 +943,13 @@ static UIFont* smallFont = nil;
 // -----------------------------------------------------------------------------
 /// @brief Updates dynamic layout constraints according to the current content
 /// of this cell.
+///
+/// layoutSubviews() invokes this method on every layout pass, also when the
+/// cell is reused for a board position with the same layout. Only those
+/// content properties that are examined below influence the constraints, so if
+/// they did not change since the last invocation the constraints are left
+/// untouched. This avoids the expensive deactivation and creation of
+/// constraints while the user scrolls through a long list of board positions.
 // -----------------------------------------------------------------------------
 - (void) updateDynamicAutoLayoutConstraints
 {
@@ -935,6 +958,19 @@ static UIFont* smallFont = nil;
   bool showHotspotIcon = self.hotspotIconImageView.image != nil;
   bool showMarkupIcon = self.markupIconImageView.image != nil;
 
+  int layoutFlags = 0;
+  if (showDetailText)
+    layoutFlags |= BoardPositionCollectionViewCellLayoutFlagDetailText;
+  if (showInfoIcon)
+    layoutFlags |= BoardPositionCollectionViewCellLayoutFlagInfoIcon;
+  if (showHotspotIcon)
+    layoutFlags |= BoardPositionCollectionViewCellLayoutFlagHotspotIcon;
+  if (showMarkupIcon)
+    layoutFlags |= BoardPositionCollectionViewCellLayoutFlagMarkupIcon;
+  if (layoutFlags == self.layoutFlagsOfDynamicAutoLayoutConstraints)
+    return;
+  self.layoutFlagsOfDynamicAutoLayoutConstraints = layoutFlags;
+
   // C021
   self.detailTextLabelYPositionConstraint.constant = showDetailText ? verticalSpacingLabels : 0.0f;
   // C024
@@ -53,6 +53,13 @@
 /// it. This results in the Go board being updated to display the selected board
 /// position.
 ///
+/// The user can also scrub through the board positions by long-pressing a
+/// cell, then dragging the finger over other cells. While the user scrubs, the
+/// Go board displays only the stones of the board position whose cell is under
+/// the finger (see GoBoardPositionPreview). The current board position does
+/// not change until the user lifts the finger, at which point the Go board
+/// is updated to display the board position that was previewed last.
+///
 ///
 /// @par Number of board positions changes
 ///
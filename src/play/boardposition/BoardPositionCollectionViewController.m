@@ -21,8 +21,10 @@
 #import "../model/BoardViewModel.h"
 #import "../../command/boardposition/ChangeBoardPositionCommand.h"
 #import "../../go/GoBoardPosition.h"
+#import "../../go/GoBoardPositionPreview.h"
 #import "../../go/GoGame.h"
 #import "../../go/GoNodeModel.h"
+#import "../../go/GoNodeTreeChange.h"
 #import "../../go/GoScore.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../shared/LongRunningActionCounter.h"
@@ -40,12 +42,19 @@
 @property(nonatomic, assign) bool allDataNeedsUpdate;
 @property(nonatomic, assign) bool currentBoardPositionNeedsUpdate;
 @property(nonatomic, assign) bool numberOfItemsNeedsUpdate;
+@property(nonatomic, assign) int firstChangedBoardPosition;
 @property(nonatomic, assign) bool userInteractionEnabledNeedsUpdate;
 @property(nonatomic, assign) bool boardPositionZeroNeedsUpdate;
 @property(nonatomic, assign) bool boardPositionDataNeedsUpdate;
 @property(nonatomic, assign) bool ignoreCurrentBoardPositionChange;
 @property(nonatomic, retain) NSIndexPath* indexPathForDelayedSelectItemOperation;
 @property(nonatomic, retain) NSMutableArray* boardPositionsWithChangedData;
+/// @brief Provides the stones of the previewed board positions while the user
+/// scrubs through the board positions. Is nil if the user does not scrub.
+@property(nonatomic, retain) GoBoardPositionPreview* boardPositionPreview;
+/// @brief The board position that is currently previewed. Is -1 if no board
+/// position is previewed.
+@property(nonatomic, assign) int previewedBoardPosition;
 @end
 
 
@@ -76,12 +85,15 @@
   self.allDataNeedsUpdate = false;
   self.currentBoardPositionNeedsUpdate = false;
   self.numberOfItemsNeedsUpdate = false;
+  self.firstChangedBoardPosition = -1;
   self.userInteractionEnabledNeedsUpdate = false;
   self.boardPositionZeroNeedsUpdate = false;
   self.boardPositionDataNeedsUpdate = false;
   self.ignoreCurrentBoardPositionChange = false;
   self.indexPathForDelayedSelectItemOperation = nil;
   self.boardPositionsWithChangedData = [NSMutableArray array];
+  self.boardPositionPreview = nil;
+  self.previewedBoardPosition = -1;
   [self setupNotificationResponders];
   return self;
 }
@@ -96,6 +108,7 @@
   self.reuseIdentifierCell = nil;
   self.indexPathForDelayedSelectItemOperation = nil;
   self.boardPositionsWithChangedData = nil;
+  self.boardPositionPreview = nil;
   [super dealloc];
 }
 
@@ -112,6 +125,10 @@
           forCellWithReuseIdentifier:self.reuseIdentifierCell];
   self.collectionView.accessibilityIdentifier = boardPositionCollectionViewAccessibilityIdentifier;
 
+  UILongPressGestureRecognizer* scrubGestureRecognizer = [[[UILongPressGestureRecognizer alloc] initWithTarget:self
+                                                                                                          action:@selector(handleScrubGesture:)] autorelease];
+  [self.collectionView addGestureRecognizer:scrubGestureRecognizer];
+
   [self updateCollectionViewBackgroundColor];
 
   // Make sure that the updater does its job the first time that it gets the
@@ -168,6 +185,7 @@
   [center addObserver:self selector:@selector(currentBoardPositionDidChange:) name:currentBoardPositionDidChange object:nil];
   [center addObserver:self selector:@selector(numberOfBoardPositionsDidChange:) name:numberOfBoardPositionsDidChange object:nil];
   [center addObserver:self selector:@selector(currentGameVariationDidChange:) name:currentGameVariationDidChange object:nil];
+  [center addObserver:self selector:@selector(goNodeTreeLayoutDidChange:) name:goNodeTreeLayoutDidChange object:nil];
   [center addObserver:self selector:@selector(longRunningActionEnds:) name:longRunningActionEnds object:nil];
 }
 
@@ -258,6 +276,15 @@
   // positions.
   int newBoardPosition = (int)indexPath.row;
 
+  [self changeToBoardPositionSelectedByUser:newBoardPosition];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for collectionView:didSelectItemAtIndexPath:() and
+/// handleScrubGesture:().
+// -----------------------------------------------------------------------------
+- (void) changeToBoardPositionSelectedByUser:(int)newBoardPosition
+{
   // The command posts currentBoardPositionDidChange, which we can ignore since
   // it was the user who made the selection
   self.ignoreCurrentBoardPositionChange = true;
@@ -265,6 +292,90 @@
   self.ignoreCurrentBoardPositionChange = false;
 }
 
+#pragma mark - Scrubbing
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the long press gesture that lets the user scrub through
+/// the board positions. See the class documentation for details.
+// -----------------------------------------------------------------------------
+- (void) handleScrubGesture:(UILongPressGestureRecognizer*)gestureRecognizer
+{
+  switch (gestureRecognizer.state)
+  {
+    case UIGestureRecognizerStateBegan:
+    {
+      self.boardPositionPreview = [[[GoBoardPositionPreview alloc] initWithGame:[GoGame sharedGame]] autorelease];
+      self.previewedBoardPosition = -1;
+      [self previewBoardPositionAtLocation:[gestureRecognizer locationInView:self.collectionView]];
+      break;
+    }
+    case UIGestureRecognizerStateChanged:
+    {
+      [self previewBoardPositionAtLocation:[gestureRecognizer locationInView:self.collectionView]];
+      break;
+    }
+    case UIGestureRecognizerStateEnded:
+    {
+      int previewedBoardPosition = self.previewedBoardPosition;
+      GoBoardPosition* boardPosition = [GoGame sharedGame].boardPosition;
+      if (previewedBoardPosition != -1 && previewedBoardPosition != boardPosition.currentBoardPosition)
+        [self changeToBoardPositionSelectedByUser:previewedBoardPosition];
+      // The preview ends only after the board position change so that the Go
+      // board does not briefly display the old board position
+      [self endScrubbing];
+      break;
+    }
+    case UIGestureRecognizerStateCancelled:
+    case UIGestureRecognizerStateFailed:
+    {
+      [self endScrubbing];
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for handleScrubGesture:(). Previews the board
+/// position whose cell is located at @a location. Does nothing if there is no
+/// cell at @a location, or if the board position is already previewed.
+// -----------------------------------------------------------------------------
+- (void) previewBoardPositionAtLocation:(CGPoint)location
+{
+  // Scrubbing was ended prematurely because the game changed
+  if (! self.boardPositionPreview)
+    return;
+
+  NSIndexPath* indexPath = [self.collectionView indexPathForItemAtPoint:location];
+  if (! indexPath)
+    return;
+
+  int boardPosition = (int)indexPath.row;
+  if (boardPosition == self.previewedBoardPosition)
+    return;
+  self.previewedBoardPosition = boardPosition;
+
+  NSData* stoneStates = [self.boardPositionPreview stoneStatesAtBoardPosition:boardPosition];
+  [[NSNotificationCenter defaultCenter] postNotificationName:boardPositionPreviewDidChange object:stoneStates];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for handleScrubGesture:(), and for notification
+/// responders that must stop scrubbing because the previewed stones are no
+/// longer valid.
+// -----------------------------------------------------------------------------
+- (void) endScrubbing
+{
+  bool boardPositionWasPreviewed = (self.previewedBoardPosition != -1);
+  self.boardPositionPreview = nil;
+  self.previewedBoardPosition = -1;
+  if (boardPositionWasPreviewed)
+    [[NSNotificationCenter defaultCenter] postNotificationName:boardPositionPreviewDidEnd object:nil];
+}
+
 #pragma mark - Notification responders
 
 // -----------------------------------------------------------------------------
@@ -272,6 +383,8 @@
 // -----------------------------------------------------------------------------
 - (void) goGameDidCreate:(NSNotification*)notification
 {
+  // The previewed stones are no longer valid
+  [self endScrubbing];
   [self.boardPositionsWithChangedData removeAllObjects];
   self.allDataNeedsUpdate = true;
   // currentBoardPosition also needs update to cover the case where the app
@@ -409,6 +522,8 @@
 // -----------------------------------------------------------------------------
 - (void) numberOfBoardPositionsDidChange:(NSNotification*)notification
 {
+  // The previewed stones are no longer valid
+  [self endScrubbing];
   self.numberOfItemsNeedsUpdate = true;
 
   NSArray* notificationObject = notification.object;
@@ -436,10 +551,51 @@
 // -----------------------------------------------------------------------------
 - (void) currentGameVariationDidChange:(NSNotification*)notification
 {
+  // The previewed stones are no longer valid
+  [self endScrubbing];
   self.allDataNeedsUpdate = true;
   [self delayedUpdate];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #goNodeTreeLayoutDidChange notification.
+///
+/// Examines the journal of tree changes to find the first board position that
+/// may have changed. updateNumberOfItems() uses this to update only the items
+/// from that board position onwards. A sub tree inserted below, or removed
+/// from, a node in the current game variation affects at most the board
+/// positions after the node. Changes below nodes that are not in the current
+/// game variation do not affect any board positions.
+///
+/// This does not trigger an update on its own - the number of board positions
+/// is what the collection view displays, so updates are triggered by
+/// #numberOfBoardPositionsDidChange. Recording a board position that is too
+/// low is harmless, it merely causes more items to be updated than necessary.
+// -----------------------------------------------------------------------------
+- (void) goNodeTreeLayoutDidChange:(NSNotification*)notification
+{
+  NSArray* treeChanges = notification.object;
+  if (! treeChanges)
+  {
+    // The entire tree has changed, updateNumberOfItems() must reload all items
+    self.firstChangedBoardPosition = 0;
+    return;
+  }
+
+  GoNodeModel* nodeModel = [GoGame sharedGame].nodeModel;
+  for (GoNodeTreeChange* treeChange in treeChanges)
+  {
+    int indexOfParent = [nodeModel indexOfNode:treeChange.parent];
+    if (indexOfParent == -1)
+      continue;
+
+    // Indexes of nodes and board positions are the same
+    int changedBoardPosition = indexOfParent + 1;
+    if (self.firstChangedBoardPosition == -1 || changedBoardPosition < self.firstChangedBoardPosition)
+      self.firstChangedBoardPosition = changedBoardPosition;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Responds to the #longRunningActionEnds notification.
 // -----------------------------------------------------------------------------
@@ -504,42 +660,61 @@
   if (! self.allDataNeedsUpdate)
     return;
   self.allDataNeedsUpdate = false;
+  self.firstChangedBoardPosition = -1;
   [self.collectionView reloadData];
 }
 
 // -----------------------------------------------------------------------------
 /// @brief Updater method.
 ///
-/// Reloads all data in the collection view managed by this controller.
+/// Deletes and inserts items in the collection view managed by this
+/// controller so that it displays the current number of board positions.
 ///
-/// We only know that the number of board positions has changed since the last
-/// update, but we don't know exactly what has changed. Because we don't know
-/// exactly what has changed, it is impossible to delete rows from
-/// UICollectionView, or insert rows into UICollectionView without making
-/// assumptions. For instance:
-/// - User discards 1 board position, then creates a new board position by
-///   playing a move. In this scenario, due to our delayed update scheme, two
-///   changes to the number of board positions are coalesced into a single
-///   update. When the update is finally performed, it appears as if the number
-///   of board positions has not actually changed (1 position was discarded,
-///   1 was added).
-/// - User discards 2 board positions, then creates a new board position by
-///   playing a move. Again, 2 changes are coalesced into one update so that
-///   when the update is finally performed it appears as if one new board
-///   position was added (2 positions were discarded, 1 was added).
+/// The number of board positions alone does not tell us what has changed. Due
+/// to our delayed update scheme several changes may be coalesced into a single
+/// update - e.g. the user discards 2 board positions, then creates a new board
+/// position by playing a move, so that when the update is finally performed
+/// it appears as if one new board position was added. For this reason we rely
+/// on the journal of tree changes (see goNodeTreeLayoutDidChange:()) to tell
+/// us the first board position that may have changed. All items from that
+/// board position onwards are deleted, then the items for the new board
+/// positions are inserted. When a move is played at the end of the game this
+/// touches a single item only, regardless of how long the game is.
 ///
-/// We don't want to make assumptions about such scenarios, because future
-/// changes to command implementations are bound to break them. The simplest
-/// solution is to reload the entire collection view. We rely on
-/// UICollectionView to perform smooth UI updates so that no flickering occurs
-/// for cells whose content has not actually changed.
+/// If no journal is available the entire collection view is reloaded. We rely
+/// on UICollectionView to perform smooth UI updates so that no flickering
+/// occurs for cells whose content has not actually changed.
 // -----------------------------------------------------------------------------
 - (void) updateNumberOfItems
 {
   if (! self.numberOfItemsNeedsUpdate)
     return;
   self.numberOfItemsNeedsUpdate = false;
-  [self.collectionView reloadData];
+
+  int firstChangedBoardPosition = self.firstChangedBoardPosition;
+  self.firstChangedBoardPosition = -1;
+  if (firstChangedBoardPosition == -1)
+  {
+    [self.collectionView reloadData];
+    return;
+  }
+
+  UICollectionView* collectionView = self.collectionView;
+  NSInteger oldNumberOfItems = [collectionView numberOfItemsInSection:0];
+  NSInteger newNumberOfItems = [self collectionView:collectionView numberOfItemsInSection:0];
+  NSInteger indexOfFirstChangedItem = MIN(firstChangedBoardPosition, MIN(oldNumberOfItems, newNumberOfItems));
+
+  NSMutableArray* indexPathsToDelete = [NSMutableArray array];
+  for (NSInteger indexOfItem = indexOfFirstChangedItem; indexOfItem < oldNumberOfItems; ++indexOfItem)
+    [indexPathsToDelete addObject:[NSIndexPath indexPathForItem:indexOfItem inSection:0]];
+  NSMutableArray* indexPathsToInsert = [NSMutableArray array];
+  for (NSInteger indexOfItem = indexOfFirstChangedItem; indexOfItem < newNumberOfItems; ++indexOfItem)
+    [indexPathsToInsert addObject:[NSIndexPath indexPathForItem:indexOfItem inSection:0]];
+
+  [collectionView performBatchUpdates:^{
+    [collectionView deleteItemsAtIndexPaths:indexPathsToDelete];
+    [collectionView insertItemsAtIndexPaths:indexPathsToInsert];
+  } completion:nil];
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class BoardViewCGLayerCache;
+@class GoBoardTopology;
+@class GoNode;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The BoardDiagram class stores everything that is needed to draw a
+/// static diagram of one board position: the stones, the markup of the node
+/// and the most recent move.
+///
+/// BoardDiagram objects are created on the main thread from the Go model.
+/// Once created they are immutable and independent of the Go model, so that
+/// drawWithContext:sideLength:() can be invoked on any thread, and several
+/// diagrams can be drawn concurrently. This makes BoardDiagram suitable for
+/// exporting many board positions in the background without involving the
+/// board view.
+///
+/// The drawing uses CoreGraphics only. It follows the board view where this
+/// makes sense, e.g. arrow connections are drawn with the same arrow path as
+/// in the board view, but it uses fixed colors and proportions that are
+/// suitable for printing instead of the user's board view preferences.
+///
+/// Diagrams that are drawn on screen, many times and with the same size (e.g.
+/// the panels of VariationComparisonController), can use
+/// drawWithContext:sideLength:contentsScale:layerCache:() instead. That method
+/// takes the board and the stones from CGLayer objects that all diagrams with
+/// the same geometry share.
+// -----------------------------------------------------------------------------
+@interface BoardDiagram : NSObject
+{
+}
+
+- (id) initWithNode:(GoNode*)node
+        stoneStates:(NSData*)stoneStates
+           topology:(GoBoardTopology*)topology;
+- (void) drawWithContext:(CGContextRef)context sideLength:(CGFloat)sideLength;
+- (void) drawWithContext:(CGContextRef)context
+              sideLength:(CGFloat)sideLength
+           contentsScale:(CGFloat)contentsScale
+              layerCache:(BoardViewCGLayerCache*)layerCache;
+
+/// @brief The topology of the board on which the diagram is drawn.
+@property(nonatomic, retain, readonly) GoBoardTopology* topology;
+/// @brief The stone states of the board position, in the format of a board
+/// snapshot (see GoBoard::stoneStateSnapshot()).
+@property(nonatomic, retain, readonly) NSData* stoneStates;
+/// @brief The index of the intersection on which the most recent move was
+/// played, or -1 if the board position has no move that was played on an
+/// intersection (e.g. the first board position, or a pass move).
+@property(nonatomic, assign, readonly) int lastMoveIndex;
+/// @brief Key = NSNumber with the index of an intersection, value = NSNumber
+/// with a value from the enumeration #GoMarkupSymbol.
+@property(nonatomic, retain, readonly) NSDictionary* symbols;
+/// @brief Key = NSNumber with the index of an intersection, value = NSString
+/// with the label text.
+@property(nonatomic, retain, readonly) NSDictionary* labels;
+/// @brief List of NSArray objects, each consisting of three NSNumber objects:
+/// The index of the start intersection, the index of the end intersection,
+/// and a value from the enumeration #GoMarkupConnection.
+@property(nonatomic, retain, readonly) NSArray* connections;
+
+@end
@@ -0,0 +1,666 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BoardDiagram.h"
+#import "layer/BoardViewCGLayerCache.h"
+#import "layer/BoardViewDrawingHelper.h"
+#import "../../go/GoBoardTopology.h"
+#import "../../go/GoMove.h"
+#import "../../go/GoNode.h"
+#import "../../go/GoNodeMarkup.h"
+#import "../../go/GoPoint.h"
+#import "../../go/GoVertex.h"
+#import "../../ui/CGDrawingHelper.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for BoardDiagram.
+// -----------------------------------------------------------------------------
+@interface BoardDiagram()
+@property(nonatomic, retain, readwrite) GoBoardTopology* topology;
+@property(nonatomic, retain, readwrite) NSData* stoneStates;
+@property(nonatomic, assign, readwrite) int lastMoveIndex;
+@property(nonatomic, retain, readwrite) NSDictionary* symbols;
+@property(nonatomic, retain, readwrite) NSDictionary* labels;
+@property(nonatomic, retain, readwrite) NSArray* connections;
+@end
+
+
+@implementation BoardDiagram
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a BoardDiagram object that shows the stones
+/// @a stoneStates, the markup of @a node and the most recent move of @a node
+/// or of one of its ancestors. @a stoneStates must have the format of a board
+/// snapshot for the board described by @a topology.
+///
+/// This initializer must be invoked on the main thread.
+///
+/// @note This is the designated initializer of BoardDiagram.
+// -----------------------------------------------------------------------------
+- (id) initWithNode:(GoNode*)node
+        stoneStates:(NSData*)stoneStates
+           topology:(GoBoardTopology*)topology
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.topology = topology;
+  self.stoneStates = stoneStates;
+
+  self.lastMoveIndex = -1;
+  GoMove* move = node.nodeWithMostRecentMove.goMove;
+  if (move && move.type == GoMoveTypePlay)
+    self.lastMoveIndex = [self indexOfNumericVertex:move.point.vertex.numeric];
+
+  GoNodeMarkup* nodeMarkup = node.goNodeMarkup;
+
+  NSMutableDictionary* symbols = [NSMutableDictionary dictionary];
+  [nodeMarkup.symbols enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* symbolAsNumber, BOOL* stop)
+  {
+    int index = [self indexOfNumericVertex:[GoVertex vertexFromString:vertexString].numeric];
+    symbols[[NSNumber numberWithInt:index]] = symbolAsNumber;
+  }];
+  self.symbols = symbols;
+
+  NSMutableDictionary* labels = [NSMutableDictionary dictionary];
+  [nodeMarkup enumerateLabelsUsingBlock:^(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop)
+  {
+    labels[[NSNumber numberWithInt:[self indexOfNumericVertex:vertex]]] = labelText;
+  }];
+  self.labels = labels;
+
+  NSMutableArray* connections = [NSMutableArray array];
+  [nodeMarkup enumerateConnectionsUsingBlock:^(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop)
+  {
+    [connections addObject:@[[NSNumber numberWithInt:[self indexOfNumericVertex:fromVertex]],
+                             [NSNumber numberWithInt:[self indexOfNumericVertex:toVertex]],
+                             [NSNumber numberWithInt:connection]]];
+  }];
+  self.connections = connections;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this BoardDiagram object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.topology = nil;
+  self.stoneStates = nil;
+  self.symbols = nil;
+  self.labels = nil;
+  self.connections = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Draws the diagram into @a context. The diagram is a square with
+/// side length @a sideLength whose origin is the origin of the user space of
+/// @a context.
+///
+/// The diagram consists of the board with coordinate labels along the upper
+/// and the left edge, the stones, the markup, and a marker for the most
+/// recent move if the intersection of that move has no other markup.
+///
+/// This method can be invoked on any thread.
+// -----------------------------------------------------------------------------
+- (void) drawWithContext:(CGContextRef)context sideLength:(CGFloat)sideLength
+{
+  // The board occupies all of the diagram except for a margin of one point
+  // distance on all sides. The coordinate labels are drawn into the upper and
+  // left margins.
+  CGFloat pointDistance = sideLength / (self.topology.boardSize + 1);
+
+  CGContextSaveGState(context);
+
+  [self drawBoardWithContext:context sideLength:sideLength pointDistance:pointDistance];
+  [self drawStonesWithContext:context pointDistance:pointDistance];
+  [self drawMarkupWithContext:context pointDistance:pointDistance];
+
+  CGContextRestoreGState(context);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Draws the diagram into @a context in the same way as
+/// drawWithContext:sideLength:(), but takes the parts of the diagram that do
+/// not depend on the board position from @a layerCache.
+///
+/// The board with its grid and coordinate labels, and one black and one white
+/// stone, are drawn into CGLayer objects that are stored in @a layerCache
+/// under a geometry key made up of @a sideLength, the board size and
+/// @a contentsScale. All diagrams with the same geometry share these layers,
+/// so drawing a diagram after the first one only composites the cached
+/// layers and draws the markup.
+///
+/// This method must be invoked on the main thread, because
+/// BoardViewCGLayerCache is not thread-safe.
+// -----------------------------------------------------------------------------
+- (void) drawWithContext:(CGContextRef)context
+              sideLength:(CGFloat)sideLength
+           contentsScale:(CGFloat)contentsScale
+              layerCache:(BoardViewCGLayerCache*)layerCache
+{
+  CGFloat pointDistance = sideLength / (self.topology.boardSize + 1);
+  NSString* geometryKey = [NSString stringWithFormat:@"BoardDiagram-%.2f-%d-%.2f",
+                           sideLength,
+                           self.topology.boardSize,
+                           contentsScale];
+
+  CGContextSaveGState(context);
+
+  CGRect boardRect = CGRectMake(0, 0, sideLength, sideLength);
+  CGLayerRef boardLayer = [self cachedLayerOfType:GridLayerType
+                                             size:boardRect.size
+                                      withContext:context
+                                    contentsScale:contentsScale
+                                       layerCache:layerCache
+                                      geometryKey:geometryKey
+                                     drawingBlock:^(CGContextRef layerContext)
+  {
+    [self drawBoardWithContext:layerContext sideLength:sideLength pointDistance:pointDistance];
+  }];
+  if (boardLayer)
+    CGContextDrawLayerInRect(context, boardRect, boardLayer);
+  else
+    [self drawBoardWithContext:context sideLength:sideLength pointDistance:pointDistance];
+
+  CGSize stoneSize = CGSizeMake(pointDistance, pointDistance);
+  CGPoint stoneCenter = CGPointMake(pointDistance / 2.0, pointDistance / 2.0);
+  CGLayerRef blackStoneLayer = [self cachedLayerOfType:BlackStoneLayerType
+                                                  size:stoneSize
+                                           withContext:context
+                                         contentsScale:contentsScale
+                                            layerCache:layerCache
+                                           geometryKey:geometryKey
+                                          drawingBlock:^(CGContextRef layerContext)
+  {
+    [self drawStoneWithContext:layerContext color:GoColorBlack center:stoneCenter pointDistance:pointDistance];
+  }];
+  CGLayerRef whiteStoneLayer = [self cachedLayerOfType:WhiteStoneLayerType
+                                                  size:stoneSize
+                                           withContext:context
+                                         contentsScale:contentsScale
+                                            layerCache:layerCache
+                                           geometryKey:geometryKey
+                                          drawingBlock:^(CGContextRef layerContext)
+  {
+    [self drawStoneWithContext:layerContext color:GoColorWhite center:stoneCenter pointDistance:pointDistance];
+  }];
+
+  int numberOfPoints = self.topology.numberOfPoints;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    enum GoColor stoneState = [self stoneStateAtIndex:index];
+    if (stoneState == GoColorNone)
+      continue;
+
+    CGPoint center = [self coordinatesOfIndex:index pointDistance:pointDistance];
+    CGLayerRef stoneLayer = (stoneState == GoColorBlack) ? blackStoneLayer : whiteStoneLayer;
+    if (stoneLayer)
+    {
+      CGRect stoneRect = CGRectMake(center.x - stoneCenter.x, center.y - stoneCenter.y, stoneSize.width, stoneSize.height);
+      CGContextDrawLayerInRect(context, stoneRect, stoneLayer);
+    }
+    else
+    {
+      [self drawStoneWithContext:context color:stoneState center:center pointDistance:pointDistance];
+    }
+  }
+
+  [self drawMarkupWithContext:context pointDistance:pointDistance];
+
+  CGContextRestoreGState(context);
+}
+
+#pragma mark - Private helpers - Layer cache
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// drawWithContext:sideLength:contentsScale:layerCache:(). Returns the layer
+/// of type @a layerType from @a layerCache. If the cache has no such layer,
+/// creates a layer of size @a size, invokes @a drawingBlock to draw its
+/// content, and stores the layer in the cache.
+///
+/// Returns NULL if the layer cannot be created, or if it does not fit into
+/// the memory budget of the cache. The caller must then draw the content
+/// itself.
+// -----------------------------------------------------------------------------
+- (CGLayerRef) cachedLayerOfType:(enum LayerType)layerType
+                            size:(CGSize)size
+                     withContext:(CGContextRef)context
+                   contentsScale:(CGFloat)contentsScale
+                      layerCache:(BoardViewCGLayerCache*)layerCache
+                     geometryKey:(NSString*)geometryKey
+                    drawingBlock:(void (^)(CGContextRef layerContext))drawingBlock
+{
+  BoardViewCGLayerCacheEntry entry = [layerCache layerOfType:layerType forGeometryKey:geometryKey];
+  if (entry.isValid)
+    return entry.layer;
+
+  CGLayerRef layer = NULL;
+  CGSize layerSize = CGSizeMake(size.width * contentsScale, size.height * contentsScale);
+  if ([layerCache canCacheLayerWithSize:layerSize])
+  {
+    layer = CGLayerCreateWithContext(context, layerSize, NULL);
+    if (layer)
+    {
+      CGContextRef layerContext = CGLayerGetContext(layer);
+      CGContextScaleCTM(layerContext, contentsScale, contentsScale);
+      drawingBlock(layerContext);
+    }
+  }
+
+  // Also remember a NULL layer, so that the decision is not made again for
+  // every diagram
+  // The cache retains the layer, so it remains valid after it is released
+  // here
+  [layerCache setLayer:layer ofType:layerType forGeometryKey:geometryKey];
+  if (layer)
+    CGLayerRelease(layer);
+  return layer;
+}
+
+#pragma mark - Private helpers - Drawing
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the drawing methods. Draws the parts of the
+/// diagram that do not depend on the board position: The board background,
+/// the grid and the coordinate labels.
+// -----------------------------------------------------------------------------
+- (void) drawBoardWithContext:(CGContextRef)context sideLength:(CGFloat)sideLength pointDistance:(CGFloat)pointDistance
+{
+  [CGDrawingHelper drawRectangleWithContext:context
+                                  rectangle:CGRectMake(0, 0, sideLength, sideLength)
+                                  fillColor:[BoardDiagram boardColor]
+                                strokeColor:nil
+                            strokeLineWidth:0];
+
+  [self drawGridWithContext:context pointDistance:pointDistance];
+  [self drawCoordinateLabelsWithContext:context pointDistance:pointDistance];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the drawing methods. Draws the markup and the
+/// marker for the most recent move.
+// -----------------------------------------------------------------------------
+- (void) drawMarkupWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  [self drawConnectionsWithContext:context pointDistance:pointDistance];
+  [self drawSymbolsWithContext:context pointDistance:pointDistance];
+  [self drawLabelsWithContext:context pointDistance:pointDistance];
+  [self drawLastMoveMarkerWithContext:context pointDistance:pointDistance];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawBoardWithContext:sideLength:pointDistance:().
+// -----------------------------------------------------------------------------
+- (void) drawGridWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  int boardSize = self.topology.boardSize;
+  CGFloat firstLineCoordinate = pointDistance;
+  CGFloat lastLineCoordinate = pointDistance * boardSize;
+
+  UIColor* lineColor = [UIColor blackColor];
+  CGFloat normalLineWidth = pointDistance * 0.03;
+  CGFloat boundingLineWidth = normalLineWidth * 2.0;
+
+  // Square caps close the corners where the bounding lines meet
+  CGContextSaveGState(context);
+  CGContextSetLineCap(context, kCGLineCapSquare);
+  for (int lineIndex = 0; lineIndex < boardSize; ++lineIndex)
+  {
+    CGFloat lineCoordinate = firstLineCoordinate + (lineIndex * pointDistance);
+    bool isBoundingLine = (lineIndex == 0 || lineIndex == boardSize - 1);
+    CGFloat lineWidth = isBoundingLine ? boundingLineWidth : normalLineWidth;
+    [CGDrawingHelper drawLineWithContext:context
+                               fromPoint:CGPointMake(firstLineCoordinate, lineCoordinate)
+                                 toPoint:CGPointMake(lastLineCoordinate, lineCoordinate)
+                             strokeColor:lineColor
+                         strokeLineWidth:lineWidth];
+    [CGDrawingHelper drawLineWithContext:context
+                               fromPoint:CGPointMake(lineCoordinate, firstLineCoordinate)
+                                 toPoint:CGPointMake(lineCoordinate, lastLineCoordinate)
+                             strokeColor:lineColor
+                         strokeLineWidth:lineWidth];
+  }
+  CGContextRestoreGState(context);
+
+  for (NSNumber* starPointIndex in self.topology.starPointIndexes)
+  {
+    [CGDrawingHelper drawCircleWithContext:context
+                                    center:[self coordinatesOfIndex:starPointIndex.intValue pointDistance:pointDistance]
+                                    radius:pointDistance * 0.1
+                                 fillColor:lineColor
+                               strokeColor:nil
+                           strokeLineWidth:0];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawBoardWithContext:sideLength:pointDistance:().
+// -----------------------------------------------------------------------------
+- (void) drawCoordinateLabelsWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  NSDictionary* textAttributes = @{ NSFontAttributeName : [UIFont systemFontOfSize:pointDistance * 0.35],
+                                     NSForegroundColorAttributeName : [UIColor blackColor] };
+
+  // Vertexes in the first column and in the bottom row of the board have the
+  // axis compounds that are needed for the labels
+  int boardSize = self.topology.boardSize;
+  for (int axisValue = 1; axisValue <= boardSize; ++axisValue)
+  {
+    GoVertex* columnVertex = [self.topology vertexAtIndex:axisValue - 1];
+    CGPoint columnCoordinates = [self coordinatesOfIndex:axisValue - 1 pointDistance:pointDistance];
+    CGRect columnLabelRect = CGRectMake(columnCoordinates.x - pointDistance / 2.0, 0, pointDistance, pointDistance / 2.0);
+    [CGDrawingHelper drawStringWithContext:context
+                            centeredInRect:columnLabelRect
+                                    string:columnVertex.letterAxisCompound
+                            textAttributes:textAttributes];
+
+    GoVertex* rowVertex = [self.topology vertexAtIndex:(axisValue - 1) * boardSize];
+    CGPoint rowCoordinates = [self coordinatesOfIndex:(axisValue - 1) * boardSize pointDistance:pointDistance];
+    CGRect rowLabelRect = CGRectMake(0, rowCoordinates.y - pointDistance / 2.0, pointDistance / 2.0, pointDistance);
+    [CGDrawingHelper drawStringWithContext:context
+                            centeredInRect:rowLabelRect
+                                    string:rowVertex.numberAxisCompound
+                            textAttributes:textAttributes];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawWithContext:sideLength:().
+// -----------------------------------------------------------------------------
+- (void) drawStonesWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  int numberOfPoints = self.topology.numberOfPoints;
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    enum GoColor stoneState = [self stoneStateAtIndex:index];
+    if (stoneState == GoColorNone)
+      continue;
+    [self drawStoneWithContext:context
+                         color:stoneState
+                        center:[self coordinatesOfIndex:index pointDistance:pointDistance]
+                 pointDistance:pointDistance];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the drawing methods. Draws a stone of color
+/// @a color centered at @a center.
+// -----------------------------------------------------------------------------
+- (void) drawStoneWithContext:(CGContextRef)context
+                        color:(enum GoColor)color
+                       center:(CGPoint)center
+                pointDistance:(CGFloat)pointDistance
+{
+  CGFloat stoneRadius = pointDistance * 0.48;
+  CGFloat strokeLineWidth = pointDistance * 0.03;
+  // Inset the stone so that the stroke of white stones is not clipped by the
+  // stones on neighbouring intersections
+  CGFloat radius = stoneRadius - (strokeLineWidth / 2.0);
+
+  if (color == GoColorBlack)
+  {
+    [CGDrawingHelper drawCircleWithContext:context
+                                    center:center
+                                    radius:radius
+                                 fillColor:[UIColor blackColor]
+                               strokeColor:nil
+                           strokeLineWidth:0];
+  }
+  else
+  {
+    [CGDrawingHelper drawCircleWithContext:context
+                                    center:center
+                                    radius:radius
+                                 fillColor:[UIColor whiteColor]
+                               strokeColor:[UIColor blackColor]
+                           strokeLineWidth:strokeLineWidth];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawMarkupWithContext:pointDistance:().
+// -----------------------------------------------------------------------------
+- (void) drawConnectionsWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  // Same proportions as in CreateConnectionLayer()
+  CGFloat tailWidth = pointDistance * 0.06 * 2.0;
+  CGFloat arrowHeadWidth = fmin(tailWidth * 4.0, pointDistance * 2.0 / 3.0);
+
+  for (NSArray* connection in self.connections)
+  {
+    CGPoint fromPointCoordinates = [self coordinatesOfIndex:[connection[0] intValue] pointDistance:pointDistance];
+    CGPoint toPointCoordinates = [self coordinatesOfIndex:[connection[1] intValue] pointDistance:pointDistance];
+    bool isArrow = ([connection[2] intValue] == GoMarkupConnectionArrow);
+    CGFloat headWidth = isArrow ? arrowHeadWidth : 0;
+
+    CGPathRef arrowPath = [BoardViewDrawingHelper newPathWithArrowFromPoint:fromPointCoordinates
+                                                                    toPoint:toPointCoordinates
+                                                                  tailWidth:tailWidth
+                                                                  headWidth:headWidth
+                                                                 headLength:headWidth];
+    CGContextAddPath(context, arrowPath);
+    [CGDrawingHelper fillOrStrokePathWithContext:context
+                                       fillColor:[UIColor blackColor]
+                                     strokeColor:[UIColor whiteColor]
+                                 strokeLineWidth:pointDistance * 0.02];
+    CGPathRelease(arrowPath);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawMarkupWithContext:pointDistance:().
+// -----------------------------------------------------------------------------
+- (void) drawSymbolsWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  // The symbol fits into the square that is inscribed in the stone
+  CGFloat symbolSideLength = pointDistance * 0.48 * M_SQRT2 * 0.8;
+  CGFloat strokeLineWidth = pointDistance * 0.06;
+
+  [self.symbols enumerateKeysAndObjectsUsingBlock:^(NSNumber* indexAsNumber, NSNumber* symbolAsNumber, BOOL* stop)
+  {
+    int index = indexAsNumber.intValue;
+    CGPoint center = [self coordinatesOfIndex:index pointDistance:pointDistance];
+    CGRect symbolRect = CGRectMake(center.x - symbolSideLength / 2.0,
+                                   center.y - symbolSideLength / 2.0,
+                                   symbolSideLength,
+                                   symbolSideLength);
+    UIColor* symbolColor = [self markupColorAtIndex:index];
+
+    switch (symbolAsNumber.intValue)
+    {
+      case GoMarkupSymbolCircle:
+      {
+        [CGDrawingHelper drawCircleWithContext:context
+                                        center:center
+                                        radius:symbolSideLength / 2.0
+                                     fillColor:nil
+                                   strokeColor:symbolColor
+                               strokeLineWidth:strokeLineWidth];
+        break;
+      }
+      case GoMarkupSymbolSquare:
+      {
+        [CGDrawingHelper drawRectangleWithContext:context
+                                        rectangle:symbolRect
+                                        fillColor:nil
+                                      strokeColor:symbolColor
+                                  strokeLineWidth:strokeLineWidth];
+        break;
+      }
+      case GoMarkupSymbolTriangle:
+      {
+        [CGDrawingHelper drawTriangleWithContext:context
+                                 insideRectangle:symbolRect
+                                       fillColor:nil
+                                     strokeColor:symbolColor
+                                 strokeLineWidth:strokeLineWidth];
+        break;
+      }
+      case GoMarkupSymbolX:
+      {
+        [CGDrawingHelper drawSymbolXWithContext:context
+                                insideRectangle:symbolRect
+                                    strokeColor:symbolColor
+                                strokeLineWidth:strokeLineWidth];
+        break;
+      }
+      case GoMarkupSymbolSelected:
+      {
+        [CGDrawingHelper drawCheckmarkWithContext:context
+                                  insideRectangle:symbolRect
+                                      strokeColor:symbolColor
+                                  strokeLineWidth:strokeLineWidth];
+        break;
+      }
+      default:
+      {
+        DDLogError(@"%@: Unexpected symbol %d", self, symbolAsNumber.intValue);
+        assert(0);
+        break;
+      }
+    }
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawMarkupWithContext:pointDistance:().
+// -----------------------------------------------------------------------------
+- (void) drawLabelsWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  [self.labels enumerateKeysAndObjectsUsingBlock:^(NSNumber* indexAsNumber, NSString* labelText, BOOL* stop)
+  {
+    int index = indexAsNumber.intValue;
+    CGPoint center = [self coordinatesOfIndex:index pointDistance:pointDistance];
+    CGRect labelRect = CGRectMake(center.x - pointDistance / 2.0,
+                                  center.y - pointDistance / 2.0,
+                                  pointDistance,
+                                  pointDistance);
+
+    // Long labels must not extend too far into neighbouring intersections
+    CGFloat fontSize = (labelText.length <= 2) ? pointDistance * 0.55 : pointDistance * 0.35;
+    NSDictionary* textAttributes = @{ NSFontAttributeName : [UIFont boldSystemFontOfSize:fontSize],
+                                       NSForegroundColorAttributeName : [self markupColorAtIndex:index] };
+
+    // Labels on empty intersections are easier to read without the grid
+    // lines running through them
+    if ([self stoneStateAtIndex:index] == GoColorNone)
+    {
+      CGSize labelSize = [labelText sizeWithAttributes:textAttributes];
+      CGRect backgroundRect = CGRectInset(labelRect, pointDistance * 0.15, pointDistance * 0.15);
+      backgroundRect = CGRectInset(backgroundRect, fmin(0, (backgroundRect.size.width - labelSize.width) / 2.0), 0);
+      [CGDrawingHelper drawRectangleWithContext:context
+                                      rectangle:backgroundRect
+                                      fillColor:[BoardDiagram boardColor]
+                                    strokeColor:nil
+                                strokeLineWidth:0];
+    }
+
+    [CGDrawingHelper drawStringWithContext:context
+                            centeredInRect:labelRect
+                                    string:labelText
+                            textAttributes:textAttributes];
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawMarkupWithContext:pointDistance:().
+// -----------------------------------------------------------------------------
+- (void) drawLastMoveMarkerWithContext:(CGContextRef)context pointDistance:(CGFloat)pointDistance
+{
+  int index = self.lastMoveIndex;
+  if (index < 0)
+    return;
+  // The stone may have been captured in the meantime
+  if ([self stoneStateAtIndex:index] == GoColorNone)
+    return;
+  NSNumber* indexAsNumber = [NSNumber numberWithInt:index];
+  if (self.symbols[indexAsNumber] || self.labels[indexAsNumber])
+    return;
+
+  [CGDrawingHelper drawCircleWithContext:context
+                                  center:[self coordinatesOfIndex:index pointDistance:pointDistance]
+                                  radius:pointDistance * 0.2
+                               fillColor:nil
+                             strokeColor:[self markupColorAtIndex:index]
+                         strokeLineWidth:pointDistance * 0.06];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection identified by @a vertex. The
+/// index has the same meaning as in GoBoardTopology.
+// -----------------------------------------------------------------------------
+- (int) indexOfNumericVertex:(struct GoVertexNumeric)vertex
+{
+  return ((vertex.y - 1) * self.topology.boardSize) + (vertex.x - 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the coordinates of the intersection with index @a index.
+/// Vertex y = 1 is the bottom row of the board.
+// -----------------------------------------------------------------------------
+- (CGPoint) coordinatesOfIndex:(int)index pointDistance:(CGFloat)pointDistance
+{
+  int boardSize = self.topology.boardSize;
+  int x = (index % boardSize) + 1;
+  int y = (index / boardSize) + 1;
+  return CGPointMake(x * pointDistance, (boardSize + 1 - y) * pointDistance);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone state of the intersection with index @a index.
+// -----------------------------------------------------------------------------
+- (enum GoColor) stoneStateAtIndex:(int)index
+{
+  return (enum GoColor)((const char*)self.stoneStates.bytes)[index];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the color in which markup is drawn on the intersection with
+/// index @a index, so that the markup contrasts with the stone on that
+/// intersection.
+// -----------------------------------------------------------------------------
+- (UIColor*) markupColorAtIndex:(int)index
+{
+  if ([self stoneStateAtIndex:index] == GoColorBlack)
+    return [UIColor whiteColor];
+  else
+    return [UIColor blackColor];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the background color of the board.
+// -----------------------------------------------------------------------------
++ (UIColor*) boardColor
+{
+  return [UIColor colorWithRed:0.86 green:0.70 blue:0.45 alpha:1.0];
+}
+
+@end
@@ -0,0 +1,41 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class BoardDiagram;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The BoardDiagramView class is a custom view that draws a
+/// BoardDiagram. The diagram is drawn as the largest square that fits into the
+/// view's bounds, centered in the view.
+///
+/// BoardDiagramView draws with
+/// BoardDiagram::drawWithContext:sideLength:contentsScale:layerCache:(), i.e.
+/// all BoardDiagramView objects of the same size share the CGLayer objects in
+/// BoardViewCGLayerCache. Changing the diagram therefore only costs drawing
+/// the stones and the markup of the new diagram.
+// -----------------------------------------------------------------------------
+@interface BoardDiagramView : UIView
+{
+}
+
+/// @brief The diagram that is drawn. Is @e nil if the view is empty. Setting
+/// this property causes the view to be redrawn.
+@property(nonatomic, retain) BoardDiagram* boardDiagram;
+
+@end
@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "BoardDiagramView.h"
+#import "BoardDiagram.h"
+#import "layer/BoardViewCGLayerCache.h"
+
+
+@implementation BoardDiagramView
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a BoardDiagramView object with frame rectangle @a frame.
+///
+/// @note This is the designated initializer of BoardDiagramView.
+// -----------------------------------------------------------------------------
+- (id) initWithFrame:(CGRect)frame
+{
+  // Call designated initializer of superclass (UIView)
+  self = [super initWithFrame:frame];
+  if (! self)
+    return nil;
+
+  _boardDiagram = nil;
+
+  // The diagram does not fill the view's bounds unless the view is square
+  self.opaque = NO;
+  // The diagram must be drawn again for the new size
+  self.contentMode = UIViewContentModeRedraw;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this BoardDiagramView object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.boardDiagram = nil;
+  [super dealloc];
+}
+
+#pragma mark - UIView overrides
+
+// -----------------------------------------------------------------------------
+/// @brief UIView method.
+// -----------------------------------------------------------------------------
+- (void) drawRect:(CGRect)rect
+{
+  [super drawRect:rect];
+
+  if (! self.boardDiagram)
+    return;
+
+  CGSize size = self.bounds.size;
+  // Whole points keep the geometry key of the layer cache stable when the
+  // view's size changes only by a fraction of a point
+  CGFloat sideLength = floor(fmin(size.width, size.height));
+  if (sideLength <= 0)
+    return;
+
+  CGContextRef context = UIGraphicsGetCurrentContext();
+  CGContextSaveGState(context);
+  CGContextTranslateCTM(context,
+                        floor((size.width - sideLength) / 2.0),
+                        floor((size.height - sideLength) / 2.0));
+  [self.boardDiagram drawWithContext:context
+                          sideLength:sideLength
+                       contentsScale:self.contentScaleFactor
+                          layerCache:[BoardViewCGLayerCache sharedCache]];
+  CGContextRestoreGState(context);
+}
+
+#pragma mark - Property accessors
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setBoardDiagram:(BoardDiagram*)boardDiagram
+{
+  if (_boardDiagram == boardDiagram)
+    return;
+  [_boardDiagram release];
+  _boardDiagram = [boardDiagram retain];
+  [self setNeedsDisplay];
+}
+
+@end
@@ -17,27 +17,35 @@
 
 // Project includes
 #import "BoardTileView.h"
+#import "layer/BoardViewCGLayerCache.h"
 #import "layer/CoordinatesLayerDelegate.h"
 #import "layer/CrossHairLinesLayerDelegate.h"
 #import "layer/GridLayerDelegate.h"
 #import "layer/InfluenceLayerDelegate.h"
+#import "layer/CapturableStonesLayerDelegate.h"
 #import "layer/LabelsLayerDelegate.h"
 #import "layer/RectangleLayerDelegate.h"
 #import "layer/StonesLayerDelegate.h"
+#import "layer/StoneSpritesLayerDelegate.h"
 #import "layer/SymbolsLayerDelegate.h"
 #import "layer/TerritoryLayerDelegate.h"
 #import "../model/BoardViewMetrics.h"
 #import "../model/BoardViewModel.h"
+#import "../../diagnostics/SignpostLog.h"
 #import "../../go/GoGame.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelChangeObserver.h"
 #import "../../ui/UiSettingsModel.h"
 
+// System includes
+#import <os/signpost.h>
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for BoardTileView.
 // -----------------------------------------------------------------------------
-@interface BoardTileView()
+@interface BoardTileView() <ModelChangeObserverDelegate>
 /// @brief Prevents double-unregistering of notification responders by
 /// willMoveToSuperview: followed by dealloc, or double-registering by two
 /// consecutive invocations of willMoveToSuperview: where the argument is not
@@ -49,13 +57,27 @@
 /// so we are playing it safe. Also, we guard against future implementation
 /// changes.
 @property(nonatomic, assign) bool notificationRespondersAreSetup;
+/// @brief Observes the properties of model objects that affect the layers of
+/// this BoardTileView. Exists only while notification responders are set up.
+@property(nonatomic, retain) ModelChangeObserver* modelChangeObserver;
 @property(nonatomic, assign) bool currentBoardPositionChangedWasDelayed;
+/// @brief The GoPoint objects whose stone state was changed by the board
+/// position changes that were coalesced into the delayed
+/// BVLDEventBoardPositionChanged event. Is @e nil if the changed points of at
+/// least one of the board position changes are unknown.
+@property(nonatomic, retain) NSMutableSet* changedPointsOfDelayedBoardPositionChange;
 @property(nonatomic, assign) bool drawLayersWasDelayed;
+/// @brief True while the user scrubs through the board positions. The layers
+/// that are stacked above the stones layer display information about the
+/// current board position, they are hidden while a different board position
+/// is previewed.
+@property(nonatomic, assign) bool boardPositionPreviewIsActive;
 @property(nonatomic, retain) NSArray* layerDelegates;
 @property(nonatomic, assign) GridLayerDelegate* gridLayerDelegate;
 @property(nonatomic, assign) CrossHairLinesLayerDelegate* crossHairLinesLayerDelegate;
-@property(nonatomic, assign) StonesLayerDelegate* stonesLayerDelegate;
+@property(nonatomic, assign) BoardViewLayerDelegateBase* stonesLayerDelegate;
 @property(nonatomic, assign) InfluenceLayerDelegate* influenceLayerDelegate;
+@property(nonatomic, assign) CapturableStonesLayerDelegate* capturableStonesLayerDelegate;
 @property(nonatomic, assign) SymbolsLayerDelegate* symbolsLayerDelegate;
 @property(nonatomic, assign) LabelsLayerDelegate* labelsLayerDelegate;
 @property(nonatomic, assign) TerritoryLayerDelegate* territoryLayerDelegate;
@@ -91,7 +113,9 @@
   self.column = -1;
   self.notificationRespondersAreSetup = false;
   self.currentBoardPositionChangedWasDelayed = false;
+  self.changedPointsOfDelayedBoardPositionChange = [NSMutableSet set];
   self.drawLayersWasDelayed = false;
+  self.boardPositionPreviewIsActive = false;
   return self;
 }
 
@@ -104,10 +128,12 @@
   for (id<BoardViewLayerDelegate> layerDelegate in self.layerDelegates)
     [layerDelegate.layer removeFromSuperlayer];
   self.layerDelegates = nil;
+  self.changedPointsOfDelayedBoardPositionChange = nil;
   self.gridLayerDelegate = nil;
   self.crossHairLinesLayerDelegate = nil;
   self.stonesLayerDelegate = nil;
   self.influenceLayerDelegate = nil;
+  self.capturableStonesLayerDelegate = nil;
   self.symbolsLayerDelegate = nil;
   self.labelsLayerDelegate = nil;
   self.territoryLayerDelegate = nil;
@@ -147,18 +173,22 @@
   [center addObserver:self selector:@selector(allMarkupDidDiscard:) name:allMarkupDidDiscard object:nil];
   [center addObserver:self selector:@selector(currentBoardPositionDidChange:) name:currentBoardPositionDidChange object:nil];
   [center addObserver:self selector:@selector(numberOfBoardPositionsDidChange:) name:numberOfBoardPositionsDidChange object:nil];
+  [center addObserver:self selector:@selector(boardPositionPreviewDidChange:) name:boardPositionPreviewDidChange object:nil];
+  [center addObserver:self selector:@selector(boardPositionPreviewDidEnd:) name:boardPositionPreviewDidEnd object:nil];
   [center addObserver:self selector:@selector(longRunningActionEnds:) name:longRunningActionEnds object:nil];
-  // KVO observing
-  [boardPositionModel addObserver:self forKeyPath:@"markNextMove" options:0 context:NULL];
-  [metrics addObserver:self forKeyPath:@"canvasSize" options:0 context:NULL];
-  [metrics addObserver:self forKeyPath:@"boardSize" options:0 context:NULL];
-  [metrics addObserver:self forKeyPath:@"displayCoordinates" options:0 context:NULL];
-  [boardViewModel addObserver:self forKeyPath:@"displayPlayerInfluence" options:0 context:NULL];
-  [boardViewModel addObserver:self forKeyPath:@"markLastMove" options:0 context:NULL];
-  [boardViewModel addObserver:self forKeyPath:@"moveNumbersPercentage" options:0 context:NULL];
-  [markupModel addObserver:self forKeyPath:@"selectedSymbolMarkupStyle" options:0 context:NULL];
-  [markupModel addObserver:self forKeyPath:@"markupPrecedence" options:0 context:NULL];
-  [scoringModel addObserver:self forKeyPath:@"inconsistentTerritoryMarkupType" options:0 context:NULL];
+  // Model changes are delivered in batches, once per run loop cycle
+  self.modelChangeObserver = [[[ModelChangeObserver alloc] initWithDelegate:self] autorelease];
+  [self.modelChangeObserver observeKeyPath:@"markNextMove" ofObject:boardPositionModel];
+  [self.modelChangeObserver observeKeyPath:@"canvasSize" ofObject:metrics];
+  [self.modelChangeObserver observeKeyPath:@"boardSize" ofObject:metrics];
+  [self.modelChangeObserver observeKeyPath:@"displayCoordinates" ofObject:metrics];
+  [self.modelChangeObserver observeKeyPath:@"displayPlayerInfluence" ofObject:boardViewModel];
+  [self.modelChangeObserver observeKeyPath:@"displayCapturableStones" ofObject:boardViewModel];
+  [self.modelChangeObserver observeKeyPath:@"markLastMove" ofObject:boardViewModel];
+  [self.modelChangeObserver observeKeyPath:@"moveNumbersPercentage" ofObject:boardViewModel];
+  [self.modelChangeObserver observeKeyPath:@"selectedSymbolMarkupStyle" ofObject:markupModel];
+  [self.modelChangeObserver observeKeyPath:@"markupPrecedence" ofObject:markupModel];
+  [self.modelChangeObserver observeKeyPath:@"inconsistentTerritoryMarkupType" ofObject:scoringModel];
 }
 
 // -----------------------------------------------------------------------------
@@ -170,25 +200,10 @@
     return;
   self.notificationRespondersAreSetup = false;
 
-  ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
-  BoardViewMetrics* metrics = appDelegate.boardViewMetrics;
-  BoardViewModel* boardViewModel = appDelegate.boardViewModel;
-  BoardPositionModel* boardPositionModel = appDelegate.boardPositionModel;
-  MarkupModel* markupModel = appDelegate.markupModel;
-  ScoringModel* scoringModel = appDelegate.scoringModel;
-
   NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
   [center removeObserver:self];
-  [boardPositionModel removeObserver:self forKeyPath:@"markNextMove"];
-  [metrics removeObserver:self forKeyPath:@"canvasSize"];
-  [metrics removeObserver:self forKeyPath:@"boardSize"];
-  [metrics removeObserver:self forKeyPath:@"displayCoordinates"];
-  [boardViewModel removeObserver:self forKeyPath:@"displayPlayerInfluence"];
-  [boardViewModel removeObserver:self forKeyPath:@"markLastMove"];
-  [boardViewModel removeObserver:self forKeyPath:@"moveNumbersPercentage"];
-  [markupModel removeObserver:self forKeyPath:@"selectedSymbolMarkupStyle"];
-  [markupModel removeObserver:self forKeyPath:@"markupPrecedence"];
-  [scoringModel removeObserver:self forKeyPath:@"inconsistentTerritoryMarkupType"];
+  [self.modelChangeObserver stopObserving];
+  self.modelChangeObserver = nil;
 }
 
 #pragma mark - Manage layers and layer delegates
@@ -214,6 +229,7 @@
   [self setupStonesLayerDelegate];
   [self setupCrossHairLinesLayerDelegateIsRequired:false];
   [self setupInfluenceLayerDelegate];
+  [self setupCapturableStonesLayerDelegate];
   [self setupSymbolsLayerDelegate];
   [self setupLabelsLayerDelegate];
   [self setupTerritoryLayerDelegate];
@@ -244,8 +260,16 @@
   if (self.stonesLayerDelegate)
     return;
   BoardViewMetrics* metrics = [ApplicationDelegate sharedDelegate].boardViewMetrics;
-  self.stonesLayerDelegate = [[[StonesLayerDelegate alloc] initWithTile:self
-                                                                metrics:metrics] autorelease];
+  if (metrics.useLayerSpritesToDrawStones)
+  {
+    self.stonesLayerDelegate = [[[StoneSpritesLayerDelegate alloc] initWithTile:self
+                                                                        metrics:metrics] autorelease];
+  }
+  else
+  {
+    self.stonesLayerDelegate = [[[StonesLayerDelegate alloc] initWithTile:self
+                                                                  metrics:metrics] autorelease];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -303,6 +327,28 @@
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Creates the capturable stones layer delegate, or resets it to nil,
+/// depending on the current application state.
+// -----------------------------------------------------------------------------
+- (void) setupCapturableStonesLayerDelegate
+{
+  ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
+  BoardViewModel* boardViewModel = appDelegate.boardViewModel;
+  if (appDelegate.uiSettingsModel.uiAreaPlayMode == UIAreaPlayModePlay && boardViewModel.displayCapturableStones)
+  {
+    if (self.capturableStonesLayerDelegate)
+      return;
+    self.capturableStonesLayerDelegate = [[[CapturableStonesLayerDelegate alloc] initWithTile:self
+                                                                                      metrics:appDelegate.boardViewMetrics
+                                                                               boardViewModel:boardViewModel] autorelease];
+  }
+  else
+  {
+    self.capturableStonesLayerDelegate = nil;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Creates the symbols layer delegate, or resets it to nil, depending
 /// on the current application state.
@@ -407,6 +453,8 @@
   [newLayerDelegates addObject:self.stonesLayerDelegate];
   if (self.influenceLayerDelegate)
     [newLayerDelegates addObject:self.influenceLayerDelegate];
+  if (self.capturableStonesLayerDelegate)
+    [newLayerDelegates addObject:self.capturableStonesLayerDelegate];
   if (self.symbolsLayerDelegate)
     [newLayerDelegates addObject:self.symbolsLayerDelegate];
   if (self.labelsLayerDelegate)
@@ -426,6 +474,32 @@
   // Replace the old array at the very end. The old array is now deallocated,
   // including any layer delegates that are no longer in newLayerDelegates
   self.layerDelegates = newLayerDelegates;
+
+  if (self.boardPositionPreviewIsActive)
+    [self updateLayerVisibilityForBoardPositionPreview];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Hides the layers that are stacked above the stones layer if
+/// @e boardPositionPreviewIsActive is true, shows them if it is false.
+// -----------------------------------------------------------------------------
+- (void) updateLayerVisibilityForBoardPositionPreview
+{
+  BOOL hidden = self.boardPositionPreviewIsActive ? YES : NO;
+  bool layerIsAboveStonesLayer = false;
+
+  // Layers must disappear and reappear immediately, without the implicit
+  // fade animation that Core Animation normally performs
+  [CATransaction begin];
+  [CATransaction setDisableActions:YES];
+  for (id<BoardViewLayerDelegate> layerDelegate in self.layerDelegates)
+  {
+    if (layerIsAboveStonesLayer)
+      layerDelegate.layer.hidden = hidden;
+    else if (layerDelegate == self.stonesLayerDelegate)
+      layerIsAboveStonesLayer = true;
+  }
+  [CATransaction commit];
 }
 
 #pragma mark - Handle delayed drawing
@@ -469,14 +543,27 @@
 
   self.drawLayersWasDelayed = false;
 
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryDrawing];
+  os_signpost_id_t signpostID = os_signpost_id_make_with_pointer(signpostLog, self);
+  os_signpost_interval_begin(signpostLog, signpostID, "BoardTileViewDrawLayers", "row %d column %d", self.row, self.column);
+
+  // Make sure that layer delegates get cached layers that match the current
+  // board geometry. Only the first tile that draws after a geometry change
+  // actually switches the layers.
+  [[BoardViewCGLayerCache sharedCache] activateLayersForMetrics:[ApplicationDelegate sharedDelegate].boardViewMetrics];
+
   if (self.currentBoardPositionChangedWasDelayed)
   {
     self.currentBoardPositionChangedWasDelayed = false;
-    [self notifyLayerDelegates:BVLDEventBoardPositionChanged eventInfo:nil];
+    NSArray* changedPoints = [self.changedPointsOfDelayedBoardPositionChange allObjects];
+    self.changedPointsOfDelayedBoardPositionChange = [NSMutableSet set];
+    [self notifyLayerDelegates:BVLDEventBoardPositionChanged eventInfo:changedPoints];
   }
 
   for (id<BoardViewLayerDelegate> layerDelegate in self.layerDelegates)
     [layerDelegate drawLayer];
+
+  os_signpost_interval_end(signpostLog, signpostID, "BoardTileViewDrawLayers");
 }
 
 // -----------------------------------------------------------------------------
@@ -510,6 +597,8 @@
 // -----------------------------------------------------------------------------
 - (void) goGameDidCreate:(NSNotification*)notification
 {
+  // GoPoint objects of the old game must not be passed on to layer delegates
+  self.changedPointsOfDelayedBoardPositionChange = nil;
   [self notifyLayerDelegates:BVLDEventGoGameStarted eventInfo:nil];
   [self delayedDrawLayers];
 }
@@ -520,6 +609,7 @@
 - (void) uiAreaPlayModeDidChange:(NSNotification*)notification
 {
   [self setupInfluenceLayerDelegate];
+  [self setupCapturableStonesLayerDelegate];
   [self setupSymbolsLayerDelegate];
   [self setupLabelsLayerDelegate];
   [self setupTerritoryLayerDelegate];
@@ -619,11 +709,46 @@
   // The board position changes many times when a game is loaded from the
   // archive. We don't want to notify our delegates each time because this
   // triggers expensive calculations, instead we coalesce multiple board
-  // position changes into a single notification
+  // position changes into a single notification. The changed points of all
+  // coalesced board position changes are combined.
+  NSArray* changedPoints = [notification.userInfo objectForKey:changedPointsKey];
+  if (! changedPoints)
+    self.changedPointsOfDelayedBoardPositionChange = nil;
+  else
+    [self.changedPointsOfDelayedBoardPositionChange addObjectsFromArray:changedPoints];
   self.currentBoardPositionChangedWasDelayed = true;
   [self delayedDrawLayers];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #boardPositionPreviewDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) boardPositionPreviewDidChange:(NSNotification*)notification
+{
+  if (! self.boardPositionPreviewIsActive)
+  {
+    self.boardPositionPreviewIsActive = true;
+    [self updateLayerVisibilityForBoardPositionPreview];
+  }
+
+  [self notifyLayerDelegates:BVLDEventBoardPositionPreviewChanged eventInfo:notification.object];
+  [self delayedDrawLayers];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #boardPositionPreviewDidEnd notification.
+// -----------------------------------------------------------------------------
+- (void) boardPositionPreviewDidEnd:(NSNotification*)notification
+{
+  if (! self.boardPositionPreviewIsActive)
+    return;
+  self.boardPositionPreviewIsActive = false;
+  [self updateLayerVisibilityForBoardPositionPreview];
+
+  [self notifyLayerDelegates:BVLDEventBoardPositionPreviewChanged eventInfo:nil];
+  [self delayedDrawLayers];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Responds to the #numberOfBoardPositionsDidChange notification.
 // -----------------------------------------------------------------------------
@@ -642,12 +767,14 @@
     [self drawLayers];
 }
 
-#pragma mark - KVO responder
+#pragma mark - ModelChangeObserverDelegate overrides
 
 // -----------------------------------------------------------------------------
-/// @brief Responds to KVO notifications.
+/// @brief ModelChangeObserverDelegate method. Notifies the layer delegates of
+/// all model changes that occurred during the current run loop cycle, then
+/// draws the layers once for all changes.
 // -----------------------------------------------------------------------------
-- (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet
 {
   ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
   BoardViewMetrics* metrics = appDelegate.boardViewMetrics;
@@ -656,77 +783,80 @@
   MarkupModel* markupModel = appDelegate.markupModel;
   ScoringModel* scoringModel = appDelegate.scoringModel;
 
-  if (object == scoringModel)
+  if ([changeSet containsChangeOfKeyPath:@"displayPlayerInfluence" ofObject:boardViewModel])
   {
-    if ([keyPath isEqualToString:@"inconsistentTerritoryMarkupType"])
-    {
-      if (appDelegate.uiSettingsModel.uiAreaPlayMode == UIAreaPlayModeScoring)
-      {
-        [self notifyLayerDelegates:BVLDEventInconsistentTerritoryMarkupTypeChanged eventInfo:nil];
-        [self delayedDrawLayers];
-      }
-    }
+    [self setupInfluenceLayerDelegate];
+    [self updateLayers];
   }
-  else if (object == boardPositionModel)
+
+  bool layersNeedDrawing = false;
+
+  if ([changeSet containsChangeOfKeyPath:@"displayCapturableStones" ofObject:boardViewModel])
   {
-    if ([keyPath isEqualToString:@"markNextMove"])
+    [self setupCapturableStonesLayerDelegate];
+    [self updateLayers];
+    // Unlike player influence, capturable stones are available immediately
+    if (self.capturableStonesLayerDelegate)
     {
-      [self notifyLayerDelegates:BVLDEventMarkNextMoveChanged eventInfo:nil];
-      [self delayedDrawLayers];
+      [self.capturableStonesLayerDelegate notify:BVLDEventInvalidateContent eventInfo:nil];
+      layersNeedDrawing = true;
     }
   }
-  else if (object == metrics)
+
+  if ([changeSet containsChangeOfKeyPath:@"inconsistentTerritoryMarkupType" ofObject:scoringModel])
   {
-    if ([keyPath isEqualToString:@"canvasSize"])
+    if (appDelegate.uiSettingsModel.uiAreaPlayMode == UIAreaPlayModeScoring)
     {
-      [self notifyLayerDelegates:BVLDEventBoardGeometryChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
-    else if ([keyPath isEqualToString:@"boardSize"])
-    {
-      [self notifyLayerDelegates:BVLDEventBoardSizeChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
-    else if ([keyPath isEqualToString:@"displayCoordinates"])
-    {
-      // Even though none of our layers draws coordinate labels, we still need
-      // to send a notification because showing/hiding coordinates fundamentally
-      // changes the geometry of the board
-      [self notifyLayerDelegates:BVLDEventDisplayCoordinatesChanged eventInfo:nil];
-      [self delayedDrawLayers];
+      [self notifyLayerDelegates:BVLDEventInconsistentTerritoryMarkupTypeChanged eventInfo:nil];
+      layersNeedDrawing = true;
     }
   }
-  else if (object == boardViewModel)
+  if ([changeSet containsChangeOfKeyPath:@"markNextMove" ofObject:boardPositionModel])
   {
-    if ([keyPath isEqualToString:@"markLastMove"])
-    {
-      [self notifyLayerDelegates:BVLDEventMarkLastMoveChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
-    else if ([keyPath isEqualToString:@"moveNumbersPercentage"])
-    {
-      [self notifyLayerDelegates:BVLDEventMoveNumbersPercentageChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
-    else if ([keyPath isEqualToString:@"displayPlayerInfluence"])
-    {
-      [self setupInfluenceLayerDelegate];
-      [self updateLayers];
-    }
+    [self notifyLayerDelegates:BVLDEventMarkNextMoveChanged eventInfo:nil];
+    layersNeedDrawing = true;
   }
-  else if (object == markupModel)
+  if ([changeSet containsChangeOfKeyPath:@"canvasSize" ofObject:metrics])
   {
-    if ([keyPath isEqualToString:@"selectedSymbolMarkupStyle"])
-    {
-      [self notifyLayerDelegates:BVLDEventSelectedSymbolMarkupStyleChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
-    else if ([keyPath isEqualToString:@"markupPrecedence"])
-    {
-      [self notifyLayerDelegates:BVLDEventMarkupPrecedenceChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
+    [self notifyLayerDelegates:BVLDEventBoardGeometryChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+  if ([changeSet containsChangeOfKeyPath:@"boardSize" ofObject:metrics])
+  {
+    [self notifyLayerDelegates:BVLDEventBoardSizeChanged eventInfo:nil];
+    layersNeedDrawing = true;
   }
+  if ([changeSet containsChangeOfKeyPath:@"displayCoordinates" ofObject:metrics])
+  {
+    // Even though none of our layers draws coordinate labels, we still need
+    // to send a notification because showing/hiding coordinates fundamentally
+    // changes the geometry of the board
+    [self notifyLayerDelegates:BVLDEventDisplayCoordinatesChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+  if ([changeSet containsChangeOfKeyPath:@"markLastMove" ofObject:boardViewModel])
+  {
+    [self notifyLayerDelegates:BVLDEventMarkLastMoveChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+  if ([changeSet containsChangeOfKeyPath:@"moveNumbersPercentage" ofObject:boardViewModel])
+  {
+    [self notifyLayerDelegates:BVLDEventMoveNumbersPercentageChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+  if ([changeSet containsChangeOfKeyPath:@"selectedSymbolMarkupStyle" ofObject:markupModel])
+  {
+    [self notifyLayerDelegates:BVLDEventSelectedSymbolMarkupStyleChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+  if ([changeSet containsChangeOfKeyPath:@"markupPrecedence" ofObject:markupModel])
+  {
+    [self notifyLayerDelegates:BVLDEventMarkupPrecedenceChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+
+  if (layersNeedDrawing)
+    [self delayedDrawLayers];
 }
 
 #pragma mark - UIView overrides
@@ -43,6 +43,10 @@
 
 - (id) initWithBoardView:(BoardView*)boardView;
 
+/// @brief The array of UIAccessibilityElement objects that BoardView exposes
+/// to the accessibility layer. The array is created lazily on first access
+/// after the board content changed, and then remains stable until the next
+/// change.
 @property(nonatomic, retain, readonly) NSArray* accessibilityElements;
 
 @end
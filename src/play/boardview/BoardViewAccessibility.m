@@ -34,6 +34,7 @@
 @property(nonatomic, assign) BoardView* boardView;
 // Public property is readonly, we re-declare it here as readwrite
 @property(nonatomic, retain) NSArray* accessibilityElements;
+@property(nonatomic, assign) bool accessibilityElementsAreValid;
 @property(nonatomic, assign) bool layoutChangedNotificationNeedsPosting;
 @end
 
@@ -55,13 +56,15 @@
     return nil;
 
   self.boardView = boardView;
-  self.accessibilityElements = @[];
+  self.accessibilityElements = nil;
+  // The elements are created only when the accessibility layer requests them
+  // for the first time. This costs nothing if no accessibility client is
+  // interested in the board.
+  self.accessibilityElementsAreValid = false;
   self.layoutChangedNotificationNeedsPosting = false;
 
   [self setupNotificationResponders];
 
-  [self updateAccessibilityElements];
-
   return self;
 }
 
@@ -126,6 +129,18 @@
   [self delayedUpdate];
 }
 
+#pragma mark - Property accessors
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSArray*) accessibilityElements
+{
+  if (! _accessibilityElementsAreValid)
+    [self updateAccessibilityElements];
+  return _accessibilityElements;
+}
+
 #pragma mark - Updaters
 
 // -----------------------------------------------------------------------------
@@ -155,14 +170,17 @@
     return;
   self.layoutChangedNotificationNeedsPosting = false;
 
-  // Update the content of the accessibilityElements array. It's important that
-  // this happens only once per #UIAccessibilityLayoutChangedNotification. The
-  // accessibility layer will request the array many times and expects the array
-  // content to remain stable in between requests. Experimentally determined:
-  // If the array content changes from one request to the next, only the last
-  // array element will become visible to an accessibility client such as a
-  // UI test.
-  [self updateAccessibilityElements];
+  // Invalidate the content of the accessibilityElements array. The array is
+  // rebuilt on demand when the accessibility layer requests it the next time,
+  // and then remains stable until the next
+  // #UIAccessibilityLayoutChangedNotification. It's important that the array is
+  // rebuilt only once per notification. The accessibility layer will request
+  // the array many times and expects the array content to remain stable in
+  // between requests. Experimentally determined: If the array content changes
+  // from one request to the next, only the last array element will become
+  // visible to an accessibility client such as a UI test.
+  self.accessibilityElementsAreValid = false;
+  self.accessibilityElements = nil;
 
   UIAccessibilityPostNotification(UIAccessibilityLayoutChangedNotification, nil);
 }
@@ -242,6 +260,7 @@
   }
 
   self.accessibilityElements = accessibilityElements;
+  self.accessibilityElementsAreValid = true;
 }
 
 @end
@@ -17,17 +17,19 @@
 
 // Project includes
 #import "CoordinateLabelsTileView.h"
+#import "layer/BoardViewCGLayerCache.h"
 #import "layer/CoordinatesLayerDelegate.h"
 #import "../model/BoardViewMetrics.h"
 #import "../../go/GoGame.h"
 #import "../../main/ApplicationDelegate.h"
 #import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelChangeObserver.h"
 
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for CoordinateLabelsTileView.
 // -----------------------------------------------------------------------------
-@interface CoordinateLabelsTileView()
+@interface CoordinateLabelsTileView() <ModelChangeObserverDelegate>
 /// @brief Prevents double-unregistering of notification responders by
 /// willMoveToSuperview: followed by dealloc, or double-registering by two
 /// consecutive invocations of willMoveToSuperview: where the argument is not
@@ -39,6 +41,9 @@
 /// so we are playing it safe. Also, we guard against future implementation
 /// changes.
 @property(nonatomic, assign) bool notificationRespondersAreSetup;
+/// @brief Observes the board geometry. Exists only while notification
+/// responders are set up.
+@property(nonatomic, retain) ModelChangeObserver* modelChangeObserver;
 @property(nonatomic, retain) CoordinatesLayerDelegate* layerDelegate;
 @property(nonatomic, assign) bool drawLayerWasDelayed;
 @end
@@ -115,10 +120,12 @@
 
   NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
   [center addObserver:self selector:@selector(longRunningActionEnds:) name:longRunningActionEnds object:nil];
+  // Model changes are delivered in batches, once per run loop cycle
   BoardViewMetrics* metrics = [ApplicationDelegate sharedDelegate].boardViewMetrics;
-  [metrics addObserver:self forKeyPath:@"canvasSize" options:0 context:NULL];
-  [metrics addObserver:self forKeyPath:@"boardSize" options:0 context:NULL];
-  [metrics addObserver:self forKeyPath:@"displayCoordinates" options:0 context:NULL];
+  self.modelChangeObserver = [[[ModelChangeObserver alloc] initWithDelegate:self] autorelease];
+  [self.modelChangeObserver observeKeyPath:@"canvasSize" ofObject:metrics];
+  [self.modelChangeObserver observeKeyPath:@"boardSize" ofObject:metrics];
+  [self.modelChangeObserver observeKeyPath:@"displayCoordinates" ofObject:metrics];
 }
 
 // -----------------------------------------------------------------------------
@@ -131,10 +138,8 @@
   self.notificationRespondersAreSetup = false;
 
   [[NSNotificationCenter defaultCenter] removeObserver:self];
-  BoardViewMetrics* metrics = [ApplicationDelegate sharedDelegate].boardViewMetrics;
-  [metrics removeObserver:self forKeyPath:@"canvasSize"];
-  [metrics removeObserver:self forKeyPath:@"boardSize"];
-  [metrics removeObserver:self forKeyPath:@"displayCoordinates"];
+  [self.modelChangeObserver stopObserving];
+  self.modelChangeObserver = nil;
 }
 
 #pragma mark - Handle delayed drawing
@@ -177,6 +182,12 @@
   }
 
   self.drawLayerWasDelayed = false;
+
+  // The layer delegate draws its part of a layer that is shared by all tiles
+  // of the strip. The strip may draw before the board tiles after a geometry
+  // change, so it cannot rely on the board tiles to activate the layers.
+  [[BoardViewCGLayerCache sharedCache] activateLayersForMetrics:[ApplicationDelegate sharedDelegate].boardViewMetrics];
+
   [self.layerDelegate drawLayer];
 }
 
@@ -202,32 +213,23 @@
     [self drawLayer];
 }
 
-#pragma mark - KVO responder
+#pragma mark - ModelChangeObserverDelegate overrides
 
 // -----------------------------------------------------------------------------
-/// @brief Responds to KVO notifications.
+/// @brief ModelChangeObserverDelegate method. Notifies the layer delegate of
+/// all board geometry changes that occurred during the current run loop cycle,
+/// then draws the layer once for all changes.
 // -----------------------------------------------------------------------------
-- (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet
 {
   BoardViewMetrics* metrics = [ApplicationDelegate sharedDelegate].boardViewMetrics;
-  if (object == metrics)
-  {
-    if ([keyPath isEqualToString:@"canvasSize"])
-    {
-      [self.layerDelegate notify:BVLDEventBoardGeometryChanged eventInfo:nil];
-      [self delayedDrawLayer];
-    }
-    else if ([keyPath isEqualToString:@"boardSize"])
-    {
-      [self.layerDelegate notify:BVLDEventBoardSizeChanged eventInfo:nil];
-      [self delayedDrawLayer];
-    }
-    else if ([keyPath isEqualToString:@"displayCoordinates"])
-    {
-      [self.layerDelegate notify:BVLDEventDisplayCoordinatesChanged eventInfo:nil];
-      [self delayedDrawLayer];
-    }
-  }
+  if ([changeSet containsChangeOfKeyPath:@"canvasSize" ofObject:metrics])
+    [self.layerDelegate notify:BVLDEventBoardGeometryChanged eventInfo:nil];
+  if ([changeSet containsChangeOfKeyPath:@"boardSize" ofObject:metrics])
+    [self.layerDelegate notify:BVLDEventBoardSizeChanged eventInfo:nil];
+  if ([changeSet containsChangeOfKeyPath:@"displayCoordinates" ofObject:metrics])
+    [self.layerDelegate notify:BVLDEventDisplayCoordinatesChanged eventInfo:nil];
+  [self delayedDrawLayer];
 }
 
 #pragma mark - UIView overrides
@@ -46,6 +46,9 @@ enum LayerType
   BlackSelectedSymbolLayerType,
   WhiteSelectedSymbolLayerType,
   SelectionRectangleLayerType,
+  GridLayerType,
+  LetterAxisCoordinateLabelsLayerType,
+  NumberAxisCoordinateLabelsLayerType,
   MaxLayerType  // Helper enum value used for iteration etc.
 };
 
@@ -68,9 +71,47 @@ typedef struct
 BoardViewCGLayerCacheEntry;
 
 
+// Forward declarations
+@class BoardViewMetrics;
+
+
 // -----------------------------------------------------------------------------
 /// @brief The BoardViewCGLayerCache class provides a cache of CGLayer objects
 /// that can be reused for drawing the Go board.
+///
+/// The size of most CGLayer objects depends on the board geometry, i.e. on
+/// the BoardViewMetrics properties @e canvasSize, @e boardSize,
+/// @e displayCoordinates and @e contentsScale. BoardViewCGLayerCache therefore
+/// keeps the layers of each board geometry in a separate set.
+/// layerOfType:(), setLayer:ofType:() and invalidateLayerOfType:() operate on
+/// the set of the board geometry that was last activated with
+/// activateLayersForMetrics:().
+///
+/// When a different board geometry is activated, the layers of the previous
+/// board geometry are not discarded but kept in reserve, so that going back to
+/// a zoom level that was recently used does not require all layers to be
+/// drawn again. The sets that are kept in reserve are subject to a memory
+/// budget. When the budget is exceeded, or when MemoryBudgetManager asks the
+/// cache to give up memory, the least recently used sets are discarded first. The layers of the
+/// active board geometry are never discarded automatically.
+///
+/// Some layers cover the entire canvas (e.g. the grid) or an entire coordinate
+/// label strip, so that tiles only have to draw their part of the layer instead
+/// of drawing the static content themselves. Because such a layer grows with
+/// the zoom level, clients must check with canCacheLayerWithSize:() whether
+/// the layer is within the memory budget before they create it.
+///
+/// A layer whose content becomes out-of-date for a reason other than the board
+/// geometry (e.g. a changed markup style) must be invalidated with
+/// invalidateLayerOfType:(). This invalidates the layer in all sets, because
+/// the changed content affects all board geometries.
+///
+/// Clients that draw small boards next to the board view (e.g. the panels of
+/// VariationComparisonController) can share the cache without disturbing the
+/// active board geometry. They use layerOfType:forGeometryKey:() and
+/// setLayer:ofType:forGeometryKey:() with a geometry key of their own. Such
+/// sets are kept together with the inactive sets, i.e. they are subject to the
+/// same memory budget and are discarded when they are no longer used.
 // -----------------------------------------------------------------------------
 @interface BoardViewCGLayerCache : NSObject
 {
@@ -79,9 +120,21 @@ BoardViewCGLayerCacheEntry;
 + (BoardViewCGLayerCache*) sharedCache;
 + (void) releaseSharedCache;
 
+- (void) activateLayersForMetrics:(BoardViewMetrics*)metrics;
+
 - (BoardViewCGLayerCacheEntry) layerOfType:(enum LayerType)layerType;
 - (void) setLayer:(CGLayerRef)layer ofType:(enum LayerType)layerType;
 - (void) invalidateLayerOfType:(enum LayerType)layerType;
 - (void) invalidateAllLayers;
+- (bool) canCacheLayerWithSize:(CGSize)layerSize;
+
+- (BoardViewCGLayerCacheEntry) layerOfType:(enum LayerType)layerType forGeometryKey:(NSString*)geometryKey;
+- (void) setLayer:(CGLayerRef)layer ofType:(enum LayerType)layerType forGeometryKey:(NSString*)geometryKey;
+
+/// @brief The number of times that layerOfType:() returned a valid layer. Is used
+/// to display the cache hit rate in the performance HUD.
+@property(nonatomic, assign, readonly) unsigned long long numberOfHits;
+/// @brief The number of times that layerOfType:() did not return a valid layer.
+@property(nonatomic, assign, readonly) unsigned long long numberOfMisses;
 
 @end
@@ -14,16 +14,112 @@
 // limitations under the License.
 // -----------------------------------------------------------------------------
 
-
 // Project includes
 #import "BoardViewCGLayerCache.h"
+#import "../../model/BoardViewMetrics.h"
+#import "../../../shared/MemoryBudgetManager.h"
 
 
 // Store layers in a global array variable because access is by simple indexing
 // and therefore very fast. Since only one instance of BoardViewCGLayerCache
-// can exist, there are no array access conflicts to solve.
+// can exist, there are no array access conflicts to solve. The array contains
+// the layers of the active board geometry.
 static const int arraySizeLayers = MaxLayerType;
 static BoardViewCGLayerCacheEntry layers[arraySizeLayers];
+// Like the array, the counters are global variables for speed
+static unsigned long long numberOfHits = 0;
+static unsigned long long numberOfMisses = 0;
+
+/// @brief The maximum number of bytes that the layers of inactive board
+/// geometries may occupy. 8 MB are enough to keep several zoom levels of a
+/// 19x19 board on a Retina display.
+static const size_t maximumNumberOfBytesInactiveLayers = 8 * 1024 * 1024;
+
+/// @brief The maximum number of bytes that a single layer may occupy. 20 MB
+/// are enough for a layer that covers the entire canvas of an unzoomed board
+/// on a Retina iPad. Zoomed-in boards exceed the budget.
+static const size_t maximumNumberOfBytesLayer = 20 * 1024 * 1024;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of bytes occupied by the bitmap of @a entry.
+// -----------------------------------------------------------------------------
+static size_t NumberOfBytesOfEntry(BoardViewCGLayerCacheEntry entry)
+{
+  if (! entry.isValid || ! entry.layer)
+    return 0;
+  // CGLayer sizes already include the contentsScale. Assume 4 bytes per pixel.
+  CGSize layerSize = CGLayerGetSize(entry.layer);
+  return (size_t)(layerSize.width * layerSize.height * 4);
+}
+
+
+// -----------------------------------------------------------------------------
+/// @brief The BoardViewCGLayerCacheGeometrySet class stores the layers of a
+/// board geometry that is currently not active.
+// -----------------------------------------------------------------------------
+@interface BoardViewCGLayerCacheGeometrySet : NSObject
+{
+@public
+  BoardViewCGLayerCacheEntry layers[MaxLayerType];
+}
+/// @brief Identifies the board geometry.
+@property(nonatomic, retain) NSString* geometryKey;
+/// @brief The number of bytes occupied by the layers in this set.
+@property(nonatomic, assign) size_t numberOfBytes;
+@end
+
+
+@implementation BoardViewCGLayerCacheGeometrySet
+
+- (id) initWithGeometryKey:(NSString*)geometryKey
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+  self.geometryKey = geometryKey;
+  self.numberOfBytes = 0;
+  for (int layerIndex = 0; layerIndex < MaxLayerType; ++layerIndex)
+    layers[layerIndex] = (BoardViewCGLayerCacheEntry){false, NULL};
+  return self;
+}
+
+- (void) dealloc
+{
+  for (int layerIndex = 0; layerIndex < MaxLayerType; ++layerIndex)
+    [self invalidateLayerOfType:layerIndex];
+  self.geometryKey = nil;
+  [super dealloc];
+}
+
+- (void) invalidateLayerOfType:(enum LayerType)layerType
+{
+  BoardViewCGLayerCacheEntry entry = layers[layerType];
+  self.numberOfBytes -= NumberOfBytesOfEntry(entry);
+  if (entry.isValid && entry.layer)
+    CGLayerRelease(entry.layer);
+  layers[layerType] = (BoardViewCGLayerCacheEntry){false, NULL};
+}
+
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for BoardViewCGLayerCache.
+// -----------------------------------------------------------------------------
+@interface BoardViewCGLayerCache() <MemoryBudgetClient>
+/// @brief Identifies the active board geometry. Is nil if no board geometry
+/// has been activated yet.
+@property(nonatomic, retain) NSString* activeGeometryKey;
+/// @brief BoardViewCGLayerCacheGeometrySet objects with the layers of
+/// inactive board geometries. The least recently used set is at the front of
+/// the array.
+@property(nonatomic, retain) NSMutableArray* inactiveGeometrySets;
+/// @brief The number of bytes occupied by the layers in
+/// @e inactiveGeometrySets.
+@property(nonatomic, assign) size_t numberOfBytesInactiveLayers;
+@end
 
 
 @implementation BoardViewCGLayerCache
@@ -58,14 +154,19 @@ static BoardViewCGLayerCache* sharedCache = nil;
     return nil;
   for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
     layers[layerIndex] = (BoardViewCGLayerCacheEntry){false, NULL};
-  [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didReceiveMemoryWarning:) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+  self.activeGeometryKey = nil;
+  self.inactiveGeometrySets = [NSMutableArray array];
+  self.numberOfBytesInactiveLayers = 0;
+  [[MemoryBudgetManager sharedManager] registerClient:self withPriority:MemoryBudgetEvictionPriorityNormal];
   return self;
 }
 
 - (void) dealloc
 {
-  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [[MemoryBudgetManager sharedManager] unregisterClient:self];
   [self invalidateAllLayers];
+  self.activeGeometryKey = nil;
+  self.inactiveGeometrySets = nil;
   if (sharedCache == self)
     sharedCache = nil;
   [super dealloc];
@@ -73,26 +174,165 @@ static BoardViewCGLayerCache* sharedCache = nil;
 
 #pragma mark - Memory management
 
-- (void) didReceiveMemoryWarning:(NSNotification*)notification
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method. Only the inactive layers count as
+/// evictable memory. The layers of the active board geometry are in use, they
+/// would have to be drawn again immediately.
+// -----------------------------------------------------------------------------
+- (unsigned long long) evictableMemoryUsage
 {
-  [self invalidateAllLayers];
+  return self.numberOfBytesInactiveLayers;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method.
+// -----------------------------------------------------------------------------
+- (void) reduceEvictableMemoryUsageTo:(unsigned long long)numberOfBytes
+{
+  [self discardInactiveGeometrySetsExceedingNumberOfBytes:(size_t)numberOfBytes];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Discards the least recently used sets of inactive layers until the
+/// inactive layers occupy no more than @a numberOfBytes.
+// -----------------------------------------------------------------------------
+- (void) discardInactiveGeometrySetsExceedingNumberOfBytes:(size_t)numberOfBytes
+{
+  while (self.numberOfBytesInactiveLayers > numberOfBytes && self.inactiveGeometrySets.count > 0)
+  {
+    BoardViewCGLayerCacheGeometrySet* geometrySet = self.inactiveGeometrySets.firstObject;
+    self.numberOfBytesInactiveLayers -= geometrySet.numberOfBytes;
+    [self.inactiveGeometrySets removeObjectAtIndex:0];
+  }
+}
+
+#pragma mark - Board geometry methods
+
+// -----------------------------------------------------------------------------
+/// @brief Makes the board geometry described by @a metrics the active board
+/// geometry. Does nothing if the board geometry is already active.
+///
+/// The layers of the previously active board geometry are kept in reserve. If
+/// layers of the newly active board geometry are in reserve they are
+/// reactivated.
+// -----------------------------------------------------------------------------
+- (void) activateLayersForMetrics:(BoardViewMetrics*)metrics
+{
+  NSString* geometryKey = [NSString stringWithFormat:@"%.2fx%.2f-%d-%d-%.2f",
+                           metrics.canvasSize.width,
+                           metrics.canvasSize.height,
+                           metrics.boardSize,
+                           metrics.displayCoordinates,
+                           metrics.contentsScale];
+  if ([geometryKey isEqualToString:self.activeGeometryKey])
+    return;
+
+  if (self.activeGeometryKey)
+  {
+    BoardViewCGLayerCacheGeometrySet* geometrySet = [[[BoardViewCGLayerCacheGeometrySet alloc] initWithGeometryKey:self.activeGeometryKey] autorelease];
+    for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
+    {
+      // Ownership of the layer passes to the set
+      geometrySet->layers[layerIndex] = layers[layerIndex];
+      geometrySet.numberOfBytes += NumberOfBytesOfEntry(layers[layerIndex]);
+      layers[layerIndex] = (BoardViewCGLayerCacheEntry){false, NULL};
+    }
+    if (geometrySet.numberOfBytes > 0)
+    {
+      [self.inactiveGeometrySets addObject:geometrySet];
+      self.numberOfBytesInactiveLayers += geometrySet.numberOfBytes;
+    }
+  }
+  else
+  {
+    // Layers that were created before any board geometry was activated
+    // cannot be attributed to a board geometry
+    [self invalidateAllLayers];
+  }
+
+  BoardViewCGLayerCacheGeometrySet* reactivatedGeometrySet = nil;
+  for (BoardViewCGLayerCacheGeometrySet* geometrySet in self.inactiveGeometrySets)
+  {
+    if ([geometrySet.geometryKey isEqualToString:geometryKey])
+    {
+      reactivatedGeometrySet = geometrySet;
+      break;
+    }
+  }
+  if (reactivatedGeometrySet)
+  {
+    for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
+    {
+      // Ownership of the layer passes back to the active layers
+      layers[layerIndex] = reactivatedGeometrySet->layers[layerIndex];
+      reactivatedGeometrySet->layers[layerIndex] = (BoardViewCGLayerCacheEntry){false, NULL};
+    }
+    self.numberOfBytesInactiveLayers -= reactivatedGeometrySet.numberOfBytes;
+    reactivatedGeometrySet.numberOfBytes = 0;
+    [self.inactiveGeometrySets removeObject:reactivatedGeometrySet];
+  }
+
+  self.activeGeometryKey = geometryKey;
+  [self discardInactiveGeometrySetsExceedingNumberOfBytes:maximumNumberOfBytesInactiveLayers];
 }
 
 #pragma mark - Caching methods
 
 - (BoardViewCGLayerCacheEntry) layerOfType:(enum LayerType)layerType
 {
-  return layers[layerType];
+  BoardViewCGLayerCacheEntry entry = layers[layerType];
+  if (entry.isValid)
+    ++numberOfHits;
+  else
+    ++numberOfMisses;
+  return entry;
 }
 
 - (void) setLayer:(CGLayerRef)layer ofType:(enum LayerType)layerType
 {
-  [self invalidateLayerOfType:layerType];
+  [self invalidateActiveLayerOfType:layerType];
   CGLayerRetain(layer);
   layers[layerType] = (BoardViewCGLayerCacheEntry){true, layer};
 }
 
 - (void) invalidateLayerOfType:(enum LayerType)layerType
+{
+  [self invalidateActiveLayerOfType:layerType];
+  for (BoardViewCGLayerCacheGeometrySet* geometrySet in self.inactiveGeometrySets)
+  {
+    size_t numberOfBytes = geometrySet.numberOfBytes;
+    [geometrySet invalidateLayerOfType:layerType];
+    self.numberOfBytesInactiveLayers -= (numberOfBytes - geometrySet.numberOfBytes);
+  }
+}
+
+- (void) invalidateAllLayers
+{
+  for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
+    [self invalidateActiveLayerOfType:layerIndex];
+  [self.inactiveGeometrySets removeAllObjects];
+  self.numberOfBytesInactiveLayers = 0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if a layer of size @a layerSize is within the memory
+/// budget of the cache. @a layerSize must already include the contentsScale.
+///
+/// Clients that get false should not create the layer. They should instead
+/// invoke setLayer:ofType:() with a NULL layer to remember the decision for
+/// the active board geometry, and draw the content without a cached layer.
+// -----------------------------------------------------------------------------
+- (bool) canCacheLayerWithSize:(CGSize)layerSize
+{
+  // Assume 4 bytes per pixel, like NumberOfBytesOfEntry()
+  return (layerSize.width * layerSize.height * 4 <= maximumNumberOfBytesLayer);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Invalidates the layer of type @a layerType of the
+/// active board geometry.
+// -----------------------------------------------------------------------------
+- (void) invalidateActiveLayerOfType:(enum LayerType)layerType
 {
   BoardViewCGLayerCacheEntry entry = layers[layerType];
   if (entry.isValid && entry.layer)
@@ -100,10 +340,109 @@ static BoardViewCGLayerCache* sharedCache = nil;
   layers[layerType] = (BoardViewCGLayerCacheEntry){false, NULL};
 }
 
-- (void) invalidateAllLayers
+#pragma mark - Caching methods for other board geometries
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the layer of type @a layerType of the board geometry
+/// identified by @a geometryKey. The board geometry does not have to be
+/// active.
+///
+/// If a set of layers exists for @a geometryKey it becomes the most recently
+/// used set, so that it is discarded last.
+// -----------------------------------------------------------------------------
+- (BoardViewCGLayerCacheEntry) layerOfType:(enum LayerType)layerType forGeometryKey:(NSString*)geometryKey
 {
-  for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
-    [self invalidateLayerOfType:layerIndex];
+  if ([geometryKey isEqualToString:self.activeGeometryKey])
+    return [self layerOfType:layerType];
+
+  BoardViewCGLayerCacheGeometrySet* geometrySet = [self inactiveGeometrySetWithKey:geometryKey];
+  if (geometrySet && geometrySet->layers[layerType].isValid)
+  {
+    ++numberOfHits;
+    return geometrySet->layers[layerType];
+  }
+  else
+  {
+    ++numberOfMisses;
+    return (BoardViewCGLayerCacheEntry){false, NULL};
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Stores @a layer as the layer of type @a layerType of the board
+/// geometry identified by @a geometryKey. The board geometry does not have to
+/// be active.
+///
+/// If the board geometry is not active, the layer counts towards the memory
+/// budget of the inactive layers. The least recently used sets are discarded
+/// if the budget is exceeded, but never the set that receives @a layer.
+// -----------------------------------------------------------------------------
+- (void) setLayer:(CGLayerRef)layer ofType:(enum LayerType)layerType forGeometryKey:(NSString*)geometryKey
+{
+  if ([geometryKey isEqualToString:self.activeGeometryKey])
+  {
+    [self setLayer:layer ofType:layerType];
+    return;
+  }
+
+  BoardViewCGLayerCacheGeometrySet* geometrySet = [self inactiveGeometrySetWithKey:geometryKey];
+  if (! geometrySet)
+  {
+    geometrySet = [[[BoardViewCGLayerCacheGeometrySet alloc] initWithGeometryKey:geometryKey] autorelease];
+    [self.inactiveGeometrySets addObject:geometrySet];
+  }
+
+  size_t numberOfBytes = geometrySet.numberOfBytes;
+  [geometrySet invalidateLayerOfType:layerType];
+  self.numberOfBytesInactiveLayers -= (numberOfBytes - geometrySet.numberOfBytes);
+  CGLayerRetain(layer);
+  BoardViewCGLayerCacheEntry entry = {true, layer};
+  geometrySet->layers[layerType] = entry;
+  geometrySet.numberOfBytes += NumberOfBytesOfEntry(entry);
+  self.numberOfBytesInactiveLayers += NumberOfBytesOfEntry(entry);
+
+  // The set is the most recently used set, i.e. the last one to be discarded
+  while (self.numberOfBytesInactiveLayers > maximumNumberOfBytesInactiveLayers && self.inactiveGeometrySets.firstObject != geometrySet)
+  {
+    BoardViewCGLayerCacheGeometrySet* leastRecentlyUsedGeometrySet = self.inactiveGeometrySets.firstObject;
+    self.numberOfBytesInactiveLayers -= leastRecentlyUsedGeometrySet.numberOfBytes;
+    [self.inactiveGeometrySets removeObjectAtIndex:0];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the set of inactive layers identified by
+/// @a geometryKey and makes it the most recently used set. Returns nil if no
+/// such set exists.
+// -----------------------------------------------------------------------------
+- (BoardViewCGLayerCacheGeometrySet*) inactiveGeometrySetWithKey:(NSString*)geometryKey
+{
+  NSMutableArray* inactiveGeometrySets = self.inactiveGeometrySets;
+  for (BoardViewCGLayerCacheGeometrySet* geometrySet in inactiveGeometrySets)
+  {
+    if (! [geometrySet.geometryKey isEqualToString:geometryKey])
+      continue;
+    if (geometrySet != inactiveGeometrySets.lastObject)
+    {
+      [[geometrySet retain] autorelease];
+      [inactiveGeometrySets removeObject:geometrySet];
+      [inactiveGeometrySets addObject:geometrySet];
+    }
+    return geometrySet;
+  }
+  return nil;
+}
+
+#pragma mark - Properties
+
+- (unsigned long long) numberOfHits
+{
+  return numberOfHits;
+}
+
+- (unsigned long long) numberOfMisses
+{
+  return numberOfMisses;
 }
 
 @end
@@ -49,6 +49,7 @@ CGLayerRef CreateConnectionLayer(CGContextRef context, enum GoMarkupConnection c
 CGLayerRef CreateSquareSymbolLayer(CGContextRef context, UIColor* symbolColor, BoardViewMetrics* metrics);
 CGLayerRef CreateDeadStoneSymbolLayer(CGContextRef context, BoardViewMetrics* metrics);
 CGLayerRef CreateTerritoryLayer(CGContextRef context, enum TerritoryMarkupStyle territoryMarkupStyle, BoardViewMetrics* metrics);
+CGLayerRef CreateTextLayer(CGContextRef context, NSString* string, NSDictionary* attributes, BoardViewMetrics* metrics);
 //@}
 
 /// @name Drawing helpers
@@ -29,6 +29,17 @@
 #import "../../../ui/UiUtilities.h"
 
 
+// ----------------------------------------
+// Objects
+// ----------------------------------------
+/// @brief Caches CGLayer objects that contain rendered text. Keys are
+/// generated by TextLayerCacheKey(), values are CGLayer objects.
+static NSCache* textLayerCache = nil;
+/// @brief The maximum number of CGLayer objects in @e textLayerCache. A 19x19
+/// board full of move numbers requires 361 layers.
+static const NSUInteger textLayerCacheCountLimit = 1000;
+
+
 @implementation BoardViewDrawingHelper
 
 // -----------------------------------------------------------------------------
@@ -635,6 +646,72 @@ CGLayerRef CreateTerritoryLayer(CGContextRef context, enum TerritoryMarkupStyle
   return layer;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Creates and returns a CGLayer object that is associated with graphics
+/// context @a context and contains the drawing operations to draw the text
+/// @a string with the attributes @a attributes.
+///
+/// The text is centered in the layer. The layer has a margin around the text
+/// so that a shadow and glyphs that extend beyond the text's bounding box are
+/// not cut off. The layer size includes the @e contentsScale from @a metrics.
+/// This function may return @e NULL instead of a CGLayer object if the text is
+/// empty.
+///
+/// @note Whoever invokes this function is responsible for releasing the
+/// returned CGLayer object using the function CGLayerRelease when the layer is
+/// no longer needed.
+// -----------------------------------------------------------------------------
+CGLayerRef CreateTextLayer(CGContextRef context, NSString* string, NSDictionary* attributes, BoardViewMetrics* metrics)
+{
+  CGSize textSize = [string sizeWithAttributes:attributes];
+  if (textSize.width <= 0.0f || textSize.height <= 0.0f)
+    return NULL;
+
+  CGFloat margin = 1.0f;
+  NSShadow* shadow = attributes[NSShadowAttributeName];
+  if (shadow)
+    margin += ceilf(shadow.shadowBlurRadius + fmaxf(fabs(shadow.shadowOffset.width), fabs(shadow.shadowOffset.height)));
+
+  CGSize layerSize = CGSizeMake(ceilf(textSize.width + 2 * margin) * metrics.contentsScale,
+                                ceilf(textSize.height + 2 * margin) * metrics.contentsScale);
+  CGLayerRef layer = CGLayerCreateWithContext(context, layerSize, NULL);
+  if (! layer)
+    return NULL;
+
+  CGContextRef layerContext = CGLayerGetContext(layer);
+  CGContextScaleCTM(layerContext, metrics.contentsScale, metrics.contentsScale);
+
+  CGRect textRect = CGRectMake(margin, margin, textSize.width, textSize.height);
+  UIGraphicsPushContext(layerContext);
+  [string drawInRect:textRect withAttributes:attributes];
+  UIGraphicsPopContext();
+
+  return layer;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the key under which the CGLayer that contains the text
+/// @a string with the attributes @a attributes is stored in
+/// @e textLayerCache.
+///
+/// Fonts are selected from a limited set of sizes (see BoardViewMetrics), so
+/// the text layers that are cached for one zoom level can usually also be
+/// used for neighbouring zoom levels.
+// -----------------------------------------------------------------------------
+static NSString* TextLayerCacheKey(NSString* string, NSDictionary* attributes, BoardViewMetrics* metrics)
+{
+  UIFont* font = attributes[NSFontAttributeName];
+  UIColor* color = attributes[NSForegroundColorAttributeName];
+  NSShadow* shadow = attributes[NSShadowAttributeName];
+  return [NSString stringWithFormat:@"%@|%@|%.2f|%@|%@|%.2f",
+          string,
+          font.fontName,
+          font.pointSize,
+          color,
+          shadow ? shadow : @"",
+          metrics.contentsScale];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Draws the layer @a layer using the specified drawing context so that
 /// the layer is centered at the intersection specified by @a point.
@@ -712,13 +789,22 @@ CGLayerRef CreateTerritoryLayer(CGContextRef context, enum TerritoryMarkupStyle
   if (! CGRectIntersectsRect(tileRect, textRect))
     return;
 
-  CGRect drawingRect = [CGDrawingHelper drawingRectFromCanvasRect:textRect
-                                                   inTileWithRect:tileRect];
+  // Laying out text is expensive, so the rendered text is cached and drawn
+  // with a single layer blit. The layer is centered on the same point as the
+  // text would be.
+  CGLayerRef textLayer = [BoardViewDrawingHelper cachedTextLayerForString:string
+                                                               attributes:attributes
+                                                              withContext:context
+                                                              withMetrics:metrics];
+  if (! textLayer)
+    return;
 
-  [CGDrawingHelper drawStringWithContext:context
-                          centeredInRect:drawingRect
-                                  string:string
-                          textAttributes:attributes];
+  CGRect layerRect = [BoardViewDrawingHelper canvasRectForScaledLayer:textLayer
+                                                      centeredAtPoint:point
+                                                              metrics:metrics];
+  CGRect drawingRect = [CGDrawingHelper drawingRectFromCanvasRect:layerRect
+                                                   inTileWithRect:tileRect];
+  CGContextDrawLayerInRect(context, drawingRect, textLayer);
 }
 
 // -----------------------------------------------------------------------------
@@ -1004,6 +1090,45 @@ CGLayerRef CreateTerritoryLayer(CGContextRef context, enum TerritoryMarkupStyle
   return crossHairStoneLayerEntry.layer;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns a layer from the cache in which the text @a string is drawn
+/// with the attributes @a attributes. If the cache does not contain the
+/// requested layer this method draws the layer and populates the cache with
+/// it. Returns @e NULL if @a string is empty.
+///
+/// Unlike the other layers, text layers are not cached by
+/// BoardViewCGLayerCache because there is an unbounded number of them. The
+/// cache that is used instead evicts layers on its own when memory becomes
+/// scarce.
+// -----------------------------------------------------------------------------
++ (CGLayerRef) cachedTextLayerForString:(NSString*)string
+                             attributes:(NSDictionary*)attributes
+                            withContext:(CGContextRef)context
+                            withMetrics:(BoardViewMetrics*)metrics
+{
+  if (! textLayerCache)
+  {
+    textLayerCache = [[NSCache alloc] init];
+    textLayerCache.countLimit = textLayerCacheCountLimit;
+  }
+
+  NSString* key = TextLayerCacheKey(string, attributes, metrics);
+  CGLayerRef textLayer = (CGLayerRef)[textLayerCache objectForKey:key];
+  if (! textLayer)
+  {
+    textLayer = CreateTextLayer(context, string, attributes, metrics);
+    if (! textLayer)
+      return NULL;
+    [textLayerCache setObject:(id)textLayer forKey:key];
+    CGLayerRelease(textLayer);
+  }
+
+  // NSCache may evict the layer at any time, so keep it alive until the
+  // caller has finished drawing
+  [[(id)textLayer retain] autorelease];
+  return textLayer;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns a CGPath object that describes an arrow between the two
 /// points @a startPoint and @a endPoint. The arrow characteristics are defined
@@ -37,7 +37,10 @@ enum BoardViewLayerDelegateEvent
   /// canvas.
   BVLDEventInvalidateContent,
   /// @brief Is sent whenever the board position changes. In some scenarios,
-  /// multiple board position changes are coalesced into a single event.
+  /// multiple board position changes are coalesced into a single event. The
+  /// event info object that accompanies this event type is an NSArray with
+  /// the GoPoint objects whose stone state changed, or @e nil if it is unknown
+  /// which intersections changed.
   BVLDEventBoardPositionChanged,
   BVLDEventNumberOfBoardPositionsChanged,
   BVLDEventMarkLastMoveChanged,
@@ -118,6 +121,15 @@ enum BoardViewLayerDelegateEvent
   /// event is sent continuously with updated information while the pan gesture
   /// is ongoing.
   BVLDEventSelectionRectangleDidChange,
+  /// @brief The event info object that accompanies this event type is an
+  /// NSData object with the stone states of the board position that is being
+  /// previewed, in the format of a board snapshot (see
+  /// GoBoard::stoneStateSnapshot()). This event is sent continuously with
+  /// updated information while the user scrubs through the board positions.
+  /// When scrubbing ends the event is sent a final time with an event info
+  /// object that is @e nil, to indicate that the stones of the current board
+  /// position must be displayed again.
+  BVLDEventBoardPositionPreviewChanged,
 };
 
 
@@ -30,7 +30,8 @@
 /// BoardViewLayerDelegateBase conveniently defines a property that stores a
 /// reference to a metrics object that will probably be used by all concrete
 /// delegate subclasses. BoardViewLayerDelegateBase also disables implicit
-/// animations that normally occur when a delegate draws into a CALayer.
+/// animations that normally occur when a delegate draws into a CALayer, and it
+/// configures the CALayer to rasterize its content asynchronously.
 ///
 /// In addition, BoardViewLayerDelegateBase provides the following simple
 /// implementation of the BoardViewLayerDelegate protocol:
@@ -68,6 +69,8 @@
 //@{
 - (NSArray*) calculateDrawingPointsOnTile;
 - (NSArray*) calculateDrawingPointsOnTileWithCallback:(bool (^)(GoPoint* point, bool* stop))callback;
+- (CGRect) dirtyRectForChangedDrawingPoints:(NSDictionary*)newDrawingPoints
+                           oldDrawingPoints:(NSDictionary*)oldDrawingPoints;
 //@}
 
 /// @brief Object that provides the metrics for drawing elements on the Play
@@ -23,6 +23,7 @@
 #import "../../../go/GoGame.h"
 #import "../../../go/GoPoint.h"
 #import "../../../ui/CGDrawingHelper.h"
+#import "../../../ui/SignpostLayer.h"
 
 
 @implementation BoardViewLayerDelegateBase
@@ -48,7 +49,7 @@
   if (! self)
     return nil;
 
-  self.layer = [CALayer layer];
+  self.layer = [SignpostLayer layerWithDrawingArea:SignpostDrawingAreaBoardView];
   self.tile = tile;
   self.boardViewMetrics = metrics;
   self.dirty = false;
@@ -68,6 +69,13 @@
   self.layer.actions = newActions;
   [newActions release];
 
+  // The delegate's drawing methods must still be invoked on the main thread
+  // because they access the Go model objects, but with this Core Animation
+  // queues the recorded drawing commands and rasterizes them on a background
+  // thread. The layer keeps displaying its previous content until the new
+  // content is ready.
+  self.layer.drawsAsynchronously = YES;
+
   return self;
 }
 
@@ -269,4 +277,46 @@
   return drawingPoints;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the union of the drawing rectangles of those intersections
+/// whose value differs between @a newDrawingPoints and @a oldDrawingPoints.
+/// This includes intersections that appear in only one of the two
+/// dictionaries. Returns CGRectZero if no intersection on this tile changed.
+///
+/// Dictionary keys must be NSString objects that contain an intersection
+/// vertex. Dictionary values can be any objects that implement isEqual:().
+/// Subclasses that keep the points they draw in such dictionaries can use the
+/// returned rectangle to redraw only the changed part of the layer with
+/// setNeedsDisplayInRect:().
+// -----------------------------------------------------------------------------
+- (CGRect) dirtyRectForChangedDrawingPoints:(NSDictionary*)newDrawingPoints
+                           oldDrawingPoints:(NSDictionary*)oldDrawingPoints
+{
+  CGRect dirtyRect = CGRectZero;
+  GoBoard* board = [GoGame sharedGame].board;
+  NSMutableSet* changedVertexStrings = [NSMutableSet set];
+  for (NSString* vertexString in newDrawingPoints)
+  {
+    if (! [[newDrawingPoints objectForKey:vertexString] isEqual:[oldDrawingPoints objectForKey:vertexString]])
+      [changedVertexStrings addObject:vertexString];
+  }
+  for (NSString* vertexString in oldDrawingPoints)
+  {
+    if (! [newDrawingPoints objectForKey:vertexString])
+      [changedVertexStrings addObject:vertexString];
+  }
+  for (NSString* vertexString in changedVertexStrings)
+  {
+    GoPoint* point = [board pointAtVertex:vertexString];
+    CGRect drawingRect = [BoardViewDrawingHelper drawingRectForTile:self.tile
+                                                    centeredAtPoint:point
+                                                        withMetrics:self.boardViewMetrics];
+    if (CGRectIsEmpty(dirtyRect))
+      dirtyRect = drawingRect;
+    else if (! CGRectIsEmpty(drawingRect))
+      dirtyRect = CGRectUnion(dirtyRect, drawingRect);
+  }
+  return dirtyRect;
+}
+
 @end
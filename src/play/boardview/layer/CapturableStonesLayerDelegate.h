@@ -0,0 +1,42 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BoardViewLayerDelegateBase.h"
+
+// Forward declarations
+@class BoardViewModel;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The CapturableStonesLayerDelegate class is responsible for marking
+/// the stones that the side to move can capture in a ladder or with a short
+/// capture sequence, and the stones of the side to move that cannot be saved.
+///
+/// The stones are determined by GoTacticalReader (via GoBoard), which does not
+/// depend on the GTP engine. The marks therefore appear immediately after each
+/// board position change.
+// -----------------------------------------------------------------------------
+@interface CapturableStonesLayerDelegate : BoardViewLayerDelegateBase
+{
+}
+
+- (id) initWithTile:(id<Tile>)tile
+            metrics:(BoardViewMetrics*)metrics
+     boardViewModel:(BoardViewModel*)boardViewModel;
+
+@end
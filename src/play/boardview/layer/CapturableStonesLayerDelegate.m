@@ -0,0 +1,244 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "CapturableStonesLayerDelegate.h"
+#import "BoardViewDrawingHelper.h"
+#import "../../model/BoardViewMetrics.h"
+#import "../../model/BoardViewModel.h"
+#import "../../../go/GoBoard.h"
+#import "../../../go/GoGame.h"
+#import "../../../go/GoPoint.h"
+#import "../../../go/GoVertex.h"
+#import "../../../main/ApplicationDelegate.h"
+#import "../../../ui/CGDrawingHelper.h"
+#import "../../../ui/UiSettingsModel.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The radius of the mark drawn on a capturable stone, as a percentage
+/// of the stone radius.
+// -----------------------------------------------------------------------------
+static const CGFloat capturableStoneMarkRadiusPercentage = 0.5f;
+/// @brief The line width of the mark drawn on a capturable stone, as a
+/// percentage of the stone radius.
+static const CGFloat capturableStoneMarkLineWidthPercentage = 0.15f;
+
+// -----------------------------------------------------------------------------
+/// @name Capturable stones cache
+///
+/// Every tile needs the capturable stones of the entire board, but they only
+/// need to be determined once per board position. The cache is keyed by the
+/// stone state snapshot of the board and the color of the side to move. It
+/// stores vertex strings, not GoPoint objects, so that it remains valid if a
+/// new game is started. The cache is only accessed on the main thread.
+// -----------------------------------------------------------------------------
+//@{
+static NSData* cachedStoneStateSnapshot = nil;
+static enum GoColor cachedNextMoveColor = GoColorNone;
+static NSArray* cachedCapturableStoneVertexes = nil;
+//@}
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// CapturableStonesLayerDelegate.
+// -----------------------------------------------------------------------------
+@interface CapturableStonesLayerDelegate()
+@property(nonatomic, assign) BoardViewModel* boardViewModel;
+/// @brief Store list of points to draw between notify:eventInfo:() and
+/// drawLayer:inContext:(), and also between drawing cycles.
+@property(nonatomic, retain) NSSet* drawingPoints;
+@end
+
+
+@implementation CapturableStonesLayerDelegate
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a CapturableStonesLayerDelegate object.
+///
+/// @note This is the designated initializer of CapturableStonesLayerDelegate.
+// -----------------------------------------------------------------------------
+- (id) initWithTile:(id<Tile>)tile
+            metrics:(BoardViewMetrics*)metrics
+     boardViewModel:(BoardViewModel*)boardViewModel
+{
+  // Call designated initializer of superclass (BoardViewLayerDelegateBase)
+  self = [super initWithTile:tile metrics:metrics];
+  if (! self)
+    return nil;
+  self.boardViewModel = boardViewModel;
+  self.drawingPoints = [NSSet set];
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this CapturableStonesLayerDelegate
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.boardViewModel = nil;
+  self.drawingPoints = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief BoardViewLayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) notify:(enum BoardViewLayerDelegateEvent)event eventInfo:(id)eventInfo
+{
+  switch (event)
+  {
+    case BVLDEventBoardGeometryChanged:
+    case BVLDEventBoardSizeChanged:
+    case BVLDEventGoGameStarted:
+    case BVLDEventInvalidateContent:
+    // The layer is removed/added dynamically as a result of play mode becoming
+    // enabled/disabled. This is the only event we get after being added, so we
+    // react to it to trigger a redraw.
+    case BVLDEventUIAreaPlayModeChanged:
+    {
+      self.drawingPoints = [self calculateDrawingPoints];
+      self.dirty = true;
+      break;
+    }
+    case BVLDEventBoardPositionChanged:
+    case BVLDEventHandicapPointChanged:
+    case BVLDEventSetupPointChanged:
+    case BVLDEventAllSetupStonesDiscarded:
+    {
+      NSSet* newDrawingPoints = [self calculateDrawingPoints];
+      if (! [self.drawingPoints isEqualToSet:newDrawingPoints])
+      {
+        self.drawingPoints = newDrawingPoints;
+        self.dirty = true;
+      }
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief BoardViewLayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) drawLayer
+{
+  if (self.dirty)
+  {
+    self.dirty = false;
+    [self.layer setNeedsDisplay];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief CALayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) drawLayer:(CALayer*)layer inContext:(CGContextRef)context
+{
+  CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
+                                              withSize:self.boardViewMetrics.tileSize];
+  CGFloat stoneRadius = self.boardViewMetrics.stoneRadius;
+  CGFloat markRadius = stoneRadius * capturableStoneMarkRadiusPercentage;
+  CGFloat markLineWidth = MAX(1.0f, stoneRadius * capturableStoneMarkLineWidthPercentage);
+  UIColor* markColor = [UIColor redColor];
+
+  GoBoard* board = [GoGame sharedGame].board;
+  for (NSString* vertexString in self.drawingPoints)
+  {
+    GoPoint* point = [board pointAtVertex:vertexString];
+    CGRect stoneRect = [BoardViewDrawingHelper canvasRectForStoneAtPoint:point
+                                                                 metrics:self.boardViewMetrics];
+    CGRect drawingRect = [CGDrawingHelper drawingRectFromCanvasRect:stoneRect
+                                                     inTileWithRect:tileRect];
+    CGPoint center = CGPointMake(CGRectGetMidX(drawingRect), CGRectGetMidY(drawingRect));
+    [CGDrawingHelper drawCircleWithContext:context
+                                    center:center
+                                    radius:markRadius
+                                 fillColor:nil
+                               strokeColor:markColor
+                           strokeLineWidth:markLineWidth];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a set with the vertex strings of the capturable stones whose
+/// intersections are located on this tile.
+///
+/// The set is empty if the current application state forbids the display of
+/// capturable stones, or if there are no capturable stones on this tile.
+// -----------------------------------------------------------------------------
+- (NSSet*) calculateDrawingPoints
+{
+  if (! self.boardViewModel.displayCapturableStones)
+    return [NSSet set];
+  if ([ApplicationDelegate sharedDelegate].uiSettingsModel.uiAreaPlayMode != UIAreaPlayModePlay)
+    return [NSSet set];
+
+  GoGame* game = [GoGame sharedGame];
+  GoBoard* board = game.board;
+  CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
+                                              withSize:self.boardViewMetrics.tileSize];
+  NSMutableSet* drawingPoints = [NSMutableSet set];
+  for (NSString* vertexString in [CapturableStonesLayerDelegate capturableStoneVertexesInGame:game])
+  {
+    GoPoint* point = [board pointAtVertex:vertexString];
+    CGRect stoneRect = [BoardViewDrawingHelper canvasRectForStoneAtPoint:point
+                                                                 metrics:self.boardViewMetrics];
+    if (CGRectIntersectsRect(tileRect, stoneRect))
+      [drawingPoints addObject:vertexString];
+  }
+  return drawingPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the vertex strings of all capturable stones in the current
+/// board position of @a game. Looks up the result in the capturable stones
+/// cache, and updates the cache if necessary.
+///
+/// This is a private helper for calculateDrawingPoints().
+// -----------------------------------------------------------------------------
++ (NSArray*) capturableStoneVertexesInGame:(GoGame*)game
+{
+  GoBoard* board = game.board;
+  NSData* stoneStateSnapshot = [board stoneStateSnapshot];
+  enum GoColor nextMoveColor = game.nextMoveColor;
+  if (cachedCapturableStoneVertexes &&
+      nextMoveColor == cachedNextMoveColor &&
+      [stoneStateSnapshot isEqualToData:cachedStoneStateSnapshot])
+  {
+    return cachedCapturableStoneVertexes;
+  }
+
+  NSMutableArray* capturableStoneVertexes = [NSMutableArray array];
+  for (GoPoint* point in [board capturableStonesWithNextMoveColor:nextMoveColor])
+    [capturableStoneVertexes addObject:point.vertex.string];
+
+  [cachedStoneStateSnapshot release];
+  cachedStoneStateSnapshot = [stoneStateSnapshot retain];
+  cachedNextMoveColor = nextMoveColor;
+  [cachedCapturableStoneVertexes release];
+  cachedCapturableStoneVertexes = [capturableStoneVertexes retain];
+
+  return cachedCapturableStoneVertexes;
+}
+
+@end
@@ -17,6 +17,8 @@
 
 // Project includes
 #import "CoordinatesLayerDelegate.h"
+#import "BoardViewCGLayerCache.h"
+#import "BoardViewDrawingHelper.h"
 #import "../../model/BoardViewMetrics.h"
 #import "../../../go/GoBoard.h"
 #import "../../../go/GoGame.h"
@@ -101,13 +103,101 @@
 // -----------------------------------------------------------------------------
 - (void) drawLayer:(CALayer*)layer inContext:(CGContextRef)context
 {
-  UIFont* coordinateLabelFont = self.boardViewMetrics.coordinateLabelFont;
-  if (! coordinateLabelFont)
+  if (! self.boardViewMetrics.coordinateLabelFont)
     return;
 
   CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
                                               withSize:self.boardViewMetrics.tileSize];
 
+  // The coordinate labels are static, so all tiles of a strip share one layer
+  // that covers the entire strip, and each tile draws only its own part of
+  // that layer. The layer is created by the first tile that draws after a
+  // board geometry change.
+  CGRect stripRect = [self stripRect];
+  CGLayerRef stripLayer = [self stripLayerWithContext:context stripRect:stripRect];
+  if (stripLayer)
+  {
+    [BoardViewDrawingHelper drawLayer:stripLayer
+                          withContext:context
+                         inCanvasRect:stripRect
+                       inTileWithRect:tileRect
+                          withMetrics:self.boardViewMetrics];
+  }
+  else
+  {
+    // The layer would exceed the memory budget
+    [self drawCoordinateLabelsWithContext:context inTileRect:tileRect];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawLayer:inContext:(). Returns the cached layer
+/// that contains the coordinate labels of the entire strip @a stripRect.
+/// Creates the layer if it does not exist yet. Returns NULL if the layer would
+/// exceed the memory budget of BoardViewCGLayerCache.
+// -----------------------------------------------------------------------------
+- (CGLayerRef) stripLayerWithContext:(CGContextRef)context stripRect:(CGRect)stripRect
+{
+  enum LayerType layerType = ((CoordinateLabelAxisLetter == self.coordinateLabelAxis)
+                              ? LetterAxisCoordinateLabelsLayerType
+                              : NumberAxisCoordinateLabelsLayerType);
+  BoardViewCGLayerCache* cache = [BoardViewCGLayerCache sharedCache];
+  BoardViewCGLayerCacheEntry stripLayerEntry = [cache layerOfType:layerType];
+  if (stripLayerEntry.isValid)
+    return stripLayerEntry.layer;
+
+  CGFloat contentsScale = self.boardViewMetrics.contentsScale;
+  CGSize layerSize = CGSizeMake(stripRect.size.width * contentsScale,
+                                stripRect.size.height * contentsScale);
+  CGLayerRef stripLayer = NULL;
+  if ([cache canCacheLayerWithSize:layerSize])
+  {
+    stripLayer = CGLayerCreateWithContext(context, layerSize, NULL);
+    if (stripLayer)
+    {
+      CGContextRef layerContext = CGLayerGetContext(stripLayer);
+      CGContextScaleCTM(layerContext, contentsScale, contentsScale);
+      [self drawCoordinateLabelsWithContext:layerContext inTileRect:stripRect];
+    }
+  }
+
+  // A NULL layer is also stored so that the memory budget is checked only
+  // once per board geometry
+  [cache setLayer:stripLayer ofType:layerType];
+  CGLayerRelease(stripLayer);
+  return stripLayer;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawLayer:inContext:(). Returns the rectangle,
+/// in the coordinate system of the strip's canvas, that is occupied by the
+/// entire strip that CoordinatesLayerDelegate is drawing.
+// -----------------------------------------------------------------------------
+- (CGRect) stripRect
+{
+  CGRect stripRect = CGRectZero;
+  if (CoordinateLabelAxisLetter == self.coordinateLabelAxis)
+  {
+    stripRect.size.width = self.boardViewMetrics.canvasSize.width;
+    stripRect.size.height = self.boardViewMetrics.coordinateLabelStripWidth;
+  }
+  else
+  {
+    stripRect.size.width = self.boardViewMetrics.coordinateLabelStripWidth;
+    stripRect.size.height = self.boardViewMetrics.canvasSize.height;
+  }
+  return stripRect;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawLayer:inContext:() and
+/// stripLayerWithContext:stripRect:(). Draws those coordinate labels that
+/// intersect with @a tileRect.
+// -----------------------------------------------------------------------------
+- (void) drawCoordinateLabelsWithContext:(CGContextRef)context inTileRect:(CGRect)tileRect
+{
+  UIFont* coordinateLabelFont = self.boardViewMetrics.coordinateLabelFont;
+
   NSDictionary* textAttributes = @{ NSFontAttributeName : coordinateLabelFont,
                                     NSForegroundColorAttributeName : self.textColor,
                                     NSShadowAttributeName: self.shadow,
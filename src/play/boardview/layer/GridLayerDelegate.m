@@ -62,7 +62,6 @@
     case BVLDEventBoardGeometryChanged:
     case BVLDEventBoardSizeChanged:
     {
-      [[BoardViewCGLayerCache sharedCache] invalidateLayerOfType:StarPointLayerType];
       self.dirty = true;
       break;
     }
@@ -85,12 +84,68 @@
 {
   CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
                                               withSize:self.boardViewMetrics.tileSize];
-  [self drawGridLinesWithContext:context inTileRect:tileRect];
-  [self drawStarPointsWithContext:context inTileRect:tileRect];
+
+  // The grid is static, so all tiles share one layer that covers the entire
+  // canvas, and each tile draws only its own part of that layer. The layer is
+  // created by the first tile that draws after a board geometry change.
+  CGRect canvasRect = CGRectZero;
+  canvasRect.size = self.boardViewMetrics.canvasSize;
+  CGLayerRef gridLayer = [self gridLayerWithContext:context canvasRect:canvasRect];
+  if (gridLayer)
+  {
+    [BoardViewDrawingHelper drawLayer:gridLayer
+                          withContext:context
+                         inCanvasRect:canvasRect
+                       inTileWithRect:tileRect
+                          withMetrics:self.boardViewMetrics];
+  }
+  else
+  {
+    // The layer would exceed the memory budget
+    [self drawGridLinesWithContext:context inTileRect:tileRect];
+    [self drawStarPointsWithContext:context inTileRect:tileRect];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawLayer:inContext:(). Returns the cached layer
+/// that contains the grid lines and star points of the entire canvas
+/// @a canvasRect. Creates the layer if it does not exist yet. Returns NULL if
+/// the layer would exceed the memory budget of BoardViewCGLayerCache.
+// -----------------------------------------------------------------------------
+- (CGLayerRef) gridLayerWithContext:(CGContextRef)context canvasRect:(CGRect)canvasRect
+{
+  BoardViewCGLayerCache* cache = [BoardViewCGLayerCache sharedCache];
+  BoardViewCGLayerCacheEntry gridLayerEntry = [cache layerOfType:GridLayerType];
+  if (gridLayerEntry.isValid)
+    return gridLayerEntry.layer;
+
+  CGFloat contentsScale = self.boardViewMetrics.contentsScale;
+  CGSize layerSize = CGSizeMake(canvasRect.size.width * contentsScale,
+                                canvasRect.size.height * contentsScale);
+  CGLayerRef gridLayer = NULL;
+  if ([cache canCacheLayerWithSize:layerSize])
+  {
+    gridLayer = CGLayerCreateWithContext(context, layerSize, NULL);
+    if (gridLayer)
+    {
+      CGContextRef layerContext = CGLayerGetContext(gridLayer);
+      CGContextScaleCTM(layerContext, contentsScale, contentsScale);
+      [self drawGridLinesWithContext:layerContext inTileRect:canvasRect];
+      [self drawStarPointsWithContext:layerContext inTileRect:canvasRect];
+    }
+  }
+
+  // A NULL layer is also stored so that the memory budget is checked only
+  // once per board geometry
+  [cache setLayer:gridLayer ofType:GridLayerType];
+  CGLayerRelease(gridLayer);
+  return gridLayer;
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for drawLayer:inContext:().
+/// @brief Private helper for drawLayer:inContext:() and
+/// gridLayerWithContext:canvasRect:().
 // -----------------------------------------------------------------------------
 - (void) drawGridLinesWithContext:(CGContextRef)context inTileRect:(CGRect)tileRect
 {
@@ -112,7 +167,8 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for drawLayer:inContext:().
+/// @brief Private helper for drawLayer:inContext:() and
+/// gridLayerWithContext:canvasRect:().
 // -----------------------------------------------------------------------------
 - (void) drawStarPointsWithContext:(CGContextRef)context inTileRect:(CGRect)tileRect
 {
@@ -29,6 +29,15 @@
 #import "../../../ui/UiSettingsModel.h"
 
 
+// -----------------------------------------------------------------------------
+/// @brief The number of steps into which the range of influence scores
+/// between 0.0 and 1.0 is divided. Influence scores are quantised to these
+/// steps before they are drawn, so that small score fluctuations between
+/// two territory statistics updates do not cause a redraw.
+// -----------------------------------------------------------------------------
+static const int numberOfInfluenceScoreSteps = 16;
+
+
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for InfluenceLayerDelegate.
 // -----------------------------------------------------------------------------
@@ -37,6 +46,11 @@
 /// @brief Store list of points to draw between notify:eventInfo:() and
 /// drawLayer:inContext:(), and also between drawing cycles.
 @property(nonatomic, retain) NSMutableDictionary* drawingPoints;
+/// @brief The dirty rect calculated by notify:eventInfo:() that later needs to
+/// be used by drawLayer(). Used only when drawing is required because of a
+/// territory statistics change. Is CGRectZero if the entire layer needs to be
+/// redrawn.
+@property(nonatomic, assign) CGRect dirtyRectForTerritoryStatistics;
 @end
 
 
@@ -57,6 +71,7 @@
     return nil;
   self.boardViewModel = boardViewModel;
   self.drawingPoints = [[[NSMutableDictionary alloc] initWithCapacity:0] autorelease];
+  self.dirtyRectForTerritoryStatistics = CGRectZero;
   return self;
 }
 
@@ -87,6 +102,7 @@
     case BVLDEventUIAreaPlayModeChanged:
     {
       self.drawingPoints = [self calculateDrawingPoints];
+      self.dirtyRectForTerritoryStatistics = CGRectZero;
       self.dirty = true;
       break;
     }
@@ -94,26 +110,37 @@
     {
       NSMutableDictionary* oldDrawingPoints = self.drawingPoints;
       NSMutableDictionary* newDrawingPoints = [self calculateDrawingPoints];
-      // The dictionary must contain the influence scores so that the dictionary
-      // comparison detects whether any scores changed since the last time.
+      // The dictionary must contain the quantised influence scores so that
+      // the dictionary comparison detects whether any scores changed since the
+      // last time.
       //
-      // Note: Currently this optimization pretty much never works because the
-      // influence scores almost always change between two updates. The reason
-      // is that the simulations played out by Fuego between two updates pretty
-      // much always result in scores that are different. Even if no moves are
-      // played between two updates, the results are different because we send
-      // Fuego a "reg_genmove" command to force it to update its territory
-      // statistics. This results in additional playouts which, of course, again
-      // change the influence scores. The only situation where there is no
-      // difference between updates is if a tile is entirely occupied by a stone
-      // group that is guaranteed to be alive (in which case the influence
-      // scores remain at +1.0f or -1.0f).
+      // Note: The raw influence scores almost always change between two
+      // updates. The reason is that the simulations played out by Fuego
+      // between two updates pretty much always result in scores that are
+      // different. Even if no moves are played between two updates, the
+      // results are different because we send Fuego a "reg_genmove" command to
+      // force it to update its territory statistics. This results in
+      // additional playouts which, of course, again change the influence
+      // scores. Because of the quantisation only those changes are detected
+      // that are actually visible.
       if (! [oldDrawingPoints isEqualToDictionary:newDrawingPoints])
       {
         self.drawingPoints = newDrawingPoints;
-        // Re-draw the entire layer. Further optimization could be made here
-        // by only drawing that rectangle which is actually affected by
-        // self.drawingPoints.
+        if (self.dirty && CGRectIsEmpty(self.dirtyRectForTerritoryStatistics))
+        {
+          // Some other event already requested a redraw of the entire layer
+        }
+        else
+        {
+          // Re-draw only the intersections whose quantised score changed. If
+          // several updates occur between two drawing cycles the dirty
+          // rectangles are combined.
+          CGRect dirtyRect = [self dirtyRectForChangedDrawingPoints:newDrawingPoints
+                                                   oldDrawingPoints:oldDrawingPoints];
+          if (self.dirty)
+            dirtyRect = CGRectUnion(dirtyRect, self.dirtyRectForTerritoryStatistics);
+          self.dirtyRectForTerritoryStatistics = dirtyRect;
+        }
         self.dirty = true;
       }
       break;
@@ -125,6 +152,26 @@
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief BoardViewLayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) drawLayer
+{
+  if (self.dirty)
+  {
+    self.dirty = false;
+    if (CGRectIsEmpty(self.dirtyRectForTerritoryStatistics))
+    {
+      [self.layer setNeedsDisplay];
+    }
+    else
+    {
+      [self.layer setNeedsDisplayInRect:self.dirtyRectForTerritoryStatistics];
+      self.dirtyRectForTerritoryStatistics = CGRectZero;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief CALayerDelegate method.
 // -----------------------------------------------------------------------------
@@ -132,10 +179,19 @@
 {
   CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
                                               withSize:self.boardViewMetrics.tileSize];
+  // If only a part of the layer is redrawn, intersections outside of the
+  // clipping area set up by setNeedsDisplayInRect:() are skipped
+  CGRect clipRect = CGContextGetClipBoundingBox(context);
   GoBoard* board = [GoGame sharedGame].board;
-  [self.drawingPoints enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* influenceScoreAsNumber, BOOL* stop){
+  [self.drawingPoints enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* quantisedInfluenceScoreAsNumber, BOOL* stop){
     GoPoint* point = [board pointAtVertex:vertexString];
-    float influenceScore = [influenceScoreAsNumber floatValue];
+    CGRect drawingRect = [BoardViewDrawingHelper drawingRectForTile:self.tile
+                                                    centeredAtPoint:point
+                                                        withMetrics:self.boardViewMetrics];
+    if (! CGRectIntersectsRect(clipRect, drawingRect))
+      return;
+    float influenceScore = ([quantisedInfluenceScoreAsNumber intValue]
+                            / (float)numberOfInfluenceScoreSteps);
     enum GoColor influenceColor = [self influenceColor:influenceScore];
     [self drawInfluenceRectWithContext:context
                                atPoint:point
@@ -236,9 +292,11 @@
 /// The vertex string can be used to get the GoPoint object that corresponds to
 /// the intersection.
 ///
-/// Dictionary values are NSNumber objects that store a float value, which
+/// Dictionary values are NSNumber objects that store an int value, which
 /// represents the influence score of the intersection identified by the
-/// dictionary key.
+/// dictionary key, quantised to #numberOfInfluenceScoreSteps steps (see
+/// quantisedInfluenceScore:()). Intersections whose quantised influence score
+/// is 0 do not appear in the dictionary.
 // -----------------------------------------------------------------------------
 - (NSMutableDictionary*) calculateDrawingPoints
 {
@@ -265,8 +323,8 @@
                                                                  metrics:self.boardViewMetrics];
     if (! CGRectIntersectsRect(tileRect, stoneRect))
       continue;
-    float influenceScore = point.territoryStatisticsScore;
-    enum GoColor influenceColor = [self influenceColor:influenceScore];
+    int quantisedInfluenceScore = [self quantisedInfluenceScore:point.territoryStatisticsScore];
+    enum GoColor influenceColor = [self influenceColor:quantisedInfluenceScore];
     if (GoColorNone == influenceColor)
       continue;
     enum GoColor intersectionOwner = [self intersectionOwner:point];
@@ -277,13 +335,25 @@
       // invisible against the stone's background)
       continue;
     }
-    NSNumber* influenceScoreAsNumber = [[[NSNumber alloc] initWithFloat:influenceScore] autorelease];
-    [drawingPoints setObject:influenceScoreAsNumber forKey:point.vertex.string];
+    NSNumber* quantisedInfluenceScoreAsNumber = [[[NSNumber alloc] initWithInt:quantisedInfluenceScore] autorelease];
+    [drawingPoints setObject:quantisedInfluenceScoreAsNumber forKey:point.vertex.string];
   }
 
   return drawingPoints;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns @a influenceScore, which is expected to be in the range
+/// between -1.0 and +1.0, quantised to the range between
+/// -#numberOfInfluenceScoreSteps and +#numberOfInfluenceScoreSteps.
+///
+/// This is a private helper for calculateDrawingPoints().
+// -----------------------------------------------------------------------------
+- (int) quantisedInfluenceScore:(float)influenceScore
+{
+  return (int)lroundf(influenceScore * numberOfInfluenceScoreSteps);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Private helper for calculateDrawingPoints().
 // -----------------------------------------------------------------------------
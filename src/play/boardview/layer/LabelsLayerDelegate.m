@@ -329,10 +329,10 @@
   GoNodeMarkup* nodeMarkup = currentNode.goNodeMarkup;
   // If a label is being moved with a panning gesture, it is temporarily removed
   // from GoNodeMarkup. If it's the only label in GoNodeMarkup then the
-  // GoNodeMarkup.labels property temporarily becomes nil - if that happens we
-  // don't want to abort here, so we need to also consult
+  // GoNodeMarkup temporarily has no labels - if that happens we don't want to
+  // abort here, so we need to also consult
   // self.shouldDrawRowWithTemporaryMarkup.
-  if (! nodeMarkup || (! nodeMarkup.labels && ! self.shouldDrawRowWithTemporaryMarkup))
+  if (! nodeMarkup || (! [nodeMarkup hasLabels] && ! self.shouldDrawRowWithTemporaryMarkup))
     return;
 
   CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
@@ -356,26 +356,19 @@
     }
   }
 
-  NSArray* pointsWithSymbols = nil;
-  if (self.markupModel.markupPrecedence == MarkupPrecedenceSymbols)
-  {
-    NSDictionary* symbols = nodeMarkup.symbols;
-    if (symbols)
-      pointsWithSymbols = symbols.allKeys;
-  }
+  bool symbolsHavePrecedence = (self.markupModel.markupPrecedence == MarkupPrecedenceSymbols);
 
-  [nodeMarkup.labels enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSArray* labelTypeAndText, BOOL* stop)
+  [nodeMarkup enumerateLabelsUsingBlock:^(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop)
   {
     // Marker labels are drawn on SymbolsLayerDelegate
-    NSNumber* labelTypeAsNumber = labelTypeAndText.firstObject;
-    enum GoMarkupLabel labelType = labelTypeAsNumber.intValue;
     if (labelType != GoMarkupLabelLabel)
         return;
 
-    if (pointsWithSymbols && [pointsWithSymbols containsObject:vertexString])
+    GoPoint* pointWithLabel = [board pointAtNumericVertex:vertex];
+
+    if (symbolsHavePrecedence && [nodeMarkup hasSymbolAtPoint:pointWithLabel symbol:NULL])
       return;
 
-    GoPoint* pointWithLabel = [board pointAtVertex:vertexString];
     int rowOfPointWithLabel = pointWithLabel.vertex.numeric.y;
 
     if (self.shouldDrawRowWithTemporaryMarkup || self.shouldDrawRowWithOriginalMarkup)
@@ -413,8 +406,6 @@
     if (! CGRectIntersectsRect(tileRect, canvasRect))
       return;
 
-    NSString* labelText = labelTypeAndText.lastObject;
-
     [self drawLabelMarkup:labelText
                 inContext:context
            inTileWithRect:tileRect
@@ -154,7 +154,6 @@ enum DrawingArtifactType
     case BVLDEventBoardGeometryChanged:
     case BVLDEventBoardSizeChanged:
     {
-      [self invalidateLayers];
       [self invalidateDrawingRectangle];
       [self invalidateDirtyRect];
       [self invalidatePointsOnTileInSelectionRectangle];
@@ -0,0 +1,44 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BoardViewLayerDelegateBase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The StoneSpritesLayerDelegate class is an alternative to
+/// StonesLayerDelegate that displays stones on the Go board without drawing
+/// them with Core Graphics.
+///
+/// StoneSpritesLayerDelegate manages one sublayer ("sprite") per intersection
+/// on its tile. The content of all sprites is taken from a small set of
+/// bitmap images (black stone, white stone, cross-hair stone) that are shared
+/// by all tiles and that are rendered only once per board geometry. Placing,
+/// capturing or moving a stone merely changes the @e contents property of a
+/// sprite, which is composited by the GPU. The expensive Core Graphics drawing
+/// on the main thread that StonesLayerDelegate performs for every tile when
+/// the board position or the board geometry changes (e.g. during a zoom
+/// gesture) is therefore avoided.
+///
+/// The BoardViewMetrics property @e useLayerSpritesToDrawStones determines
+/// whether StoneSpritesLayerDelegate or StonesLayerDelegate is used.
+// -----------------------------------------------------------------------------
+@interface StoneSpritesLayerDelegate : BoardViewLayerDelegateBase
+{
+}
+
+@end
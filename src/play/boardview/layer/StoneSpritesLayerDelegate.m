@@ -0,0 +1,358 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "StoneSpritesLayerDelegate.h"
+#import "BoardViewDrawingHelper.h"
+#import "../../model/BoardViewMetrics.h"
+#import "../../../go/GoBoard.h"
+#import "../../../go/GoGame.h"
+#import "../../../go/GoPoint.h"
+#import "../../../go/GoVertex.h"
+#import "../../../ui/CGDrawingHelper.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Enumerates the images that are used as the content of sprites.
+// -----------------------------------------------------------------------------
+enum StoneSpriteImage
+{
+  BlackStoneSpriteImage,
+  WhiteStoneSpriteImage,
+  CrossHairStoneSpriteImage,
+  NumberOfStoneSpriteImages    ///< @brief Not an image, used for array sizing.
+};
+
+// ----------------------------------------
+// Objects
+// ----------------------------------------
+/// @brief The images that are shared by the sprites of all tiles. Elements are
+/// UIImage objects, the array is indexed by values of the enumeration
+/// #StoneSpriteImage.
+static NSArray* stoneSpriteImages = nil;
+/// @brief The size in points of the images in @e stoneSpriteImages.
+static CGSize stoneSpriteImageSize = { 0.0f, 0.0f };
+/// @brief The scale factor of the images in @e stoneSpriteImages.
+static CGFloat stoneSpriteImageScale = 0.0f;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// StoneSpritesLayerDelegate.
+// -----------------------------------------------------------------------------
+@interface StoneSpritesLayerDelegate()
+/// @brief The sprites for the intersections on this tile. Dictionary keys are
+/// NSString objects that contain the intersection vertex, dictionary values
+/// are the CALayer objects that display a stone at the intersection.
+@property(nonatomic, retain) NSMutableDictionary* spriteLayers;
+/// @brief True if the sprites must be created anew during the next drawing
+/// cycle, because the board geometry or the tile changed.
+@property(nonatomic, assign) bool spriteLayersNeedSetup;
+/// @brief Refers to the GoPoint object that marks the current focus of the
+/// cross-hair (even if the point is not on this tile).
+@property(nonatomic, assign) GoPoint* currentCrossHairPoint;
+/// @brief The stone states of the board position that is being previewed, in
+/// the format of a board snapshot. Is @e nil if no board position is being
+/// previewed.
+@property(nonatomic, retain) NSData* previewStoneStates;
+@end
+
+
+@implementation StoneSpritesLayerDelegate
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a StoneSpritesLayerDelegate object.
+///
+/// @note This is the designated initializer of StoneSpritesLayerDelegate.
+// -----------------------------------------------------------------------------
+- (id) initWithTile:(id<Tile>)tile metrics:(BoardViewMetrics*)metrics
+{
+  // Call designated initializer of superclass (BoardViewLayerDelegateBase)
+  self = [super initWithTile:tile metrics:metrics];
+  if (! self)
+    return nil;
+  self.spriteLayers = [NSMutableDictionary dictionary];
+  self.spriteLayersNeedSetup = true;
+  self.currentCrossHairPoint = nil;
+  self.previewStoneStates = nil;
+  // Sprites of intersections on the tile edge extend beyond the tile. They
+  // must not cover the layers of neighbouring tiles.
+  self.layer.masksToBounds = YES;
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this StoneSpritesLayerDelegate
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.spriteLayers = nil;
+  self.currentCrossHairPoint = nil;
+  self.previewStoneStates = nil;
+  [super dealloc];
+}
+
+#pragma mark - BoardViewLayerDelegate overrides
+
+// -----------------------------------------------------------------------------
+/// @brief BoardViewLayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) notify:(enum BoardViewLayerDelegateEvent)event eventInfo:(id)eventInfo
+{
+  switch (event)
+  {
+    case BVLDEventBoardGeometryChanged:
+    case BVLDEventBoardSizeChanged:
+    {
+      self.currentCrossHairPoint = nil;
+      if (event == BVLDEventBoardSizeChanged)
+        self.previewStoneStates = nil;
+      self.spriteLayersNeedSetup = true;
+      self.dirty = true;
+      break;
+    }
+    case BVLDEventGoGameStarted:  // GoPoint objects are different
+    case BVLDEventInvalidateContent:  // tile displays a different part of the board
+    {
+      self.currentCrossHairPoint = nil;
+      // The preview stone states are for the entire board, they remain valid
+      // when the tile displays a different part of the board
+      if (event == BVLDEventGoGameStarted)
+        self.previewStoneStates = nil;
+      self.spriteLayersNeedSetup = true;
+      self.dirty = true;
+      break;
+    }
+    case BVLDEventBoardPositionChanged:
+    case BVLDEventAllSetupStonesDiscarded:
+    case BVLDEventHandicapPointChanged:
+    case BVLDEventSetupPointChanged:
+    {
+      // Updating sprites whose content did not change is a no-op, so there is
+      // no need to figure out which intersections are affected
+      self.currentCrossHairPoint = nil;
+      self.dirty = true;
+      break;
+    }
+    case BVLDEventBoardPositionPreviewChanged:
+    {
+      self.previewStoneStates = eventInfo;
+      self.currentCrossHairPoint = nil;
+      self.dirty = true;
+      break;
+    }
+    case BVLDEventPlayStoneDidChange:
+    {
+      GoPoint* newCrossHairPoint = eventInfo;
+      if (newCrossHairPoint == self.currentCrossHairPoint)
+        break;
+      self.currentCrossHairPoint = newCrossHairPoint;
+      self.dirty = true;
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief BoardViewLayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) drawLayer
+{
+  if (! self.dirty)
+    return;
+  self.dirty = false;
+
+  // Sprites must change their content and frame immediately, without the
+  // implicit animations that Core Animation normally performs
+  [CATransaction begin];
+  [CATransaction setDisableActions:YES];
+  if (self.spriteLayersNeedSetup)
+  {
+    self.spriteLayersNeedSetup = false;
+    [self setupSpriteLayers];
+  }
+  [self updateSpriteLayers];
+  [CATransaction commit];
+}
+
+#pragma mark - Sprite management
+
+// -----------------------------------------------------------------------------
+/// @brief Removes all existing sprites and creates a new sprite for each
+/// intersection on this tile.
+// -----------------------------------------------------------------------------
+- (void) setupSpriteLayers
+{
+  for (CALayer* spriteLayer in self.spriteLayers.allValues)
+    [spriteLayer removeFromSuperlayer];
+  [self.spriteLayers removeAllObjects];
+
+  CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
+                                              withSize:self.boardViewMetrics.tileSize];
+  for (GoPoint* point in [self calculateDrawingPointsOnTile])
+  {
+    CGRect stoneRect = [BoardViewDrawingHelper canvasRectForStoneAtPoint:point
+                                                                 metrics:self.boardViewMetrics];
+    CALayer* spriteLayer = [CALayer layer];
+    spriteLayer.frame = [CGDrawingHelper drawingRectFromCanvasRect:stoneRect
+                                                    inTileWithRect:tileRect];
+    spriteLayer.contentsScale = self.boardViewMetrics.contentsScale;
+    [self.layer addSublayer:spriteLayer];
+    [self.spriteLayers setObject:spriteLayer forKey:point.vertex.string];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the content of all sprites on this tile so that each sprite
+/// displays the current state of its intersection, or the state of its
+/// intersection in the board position that is being previewed.
+// -----------------------------------------------------------------------------
+- (void) updateSpriteLayers
+{
+  NSArray* images = [StoneSpritesLayerDelegate stoneSpriteImagesWithMetrics:self.boardViewMetrics];
+  GoGame* game = [GoGame sharedGame];
+  GoBoard* board = game.board;
+  const unsigned char* previewStoneStates = (const unsigned char*)self.previewStoneStates.bytes;
+
+  [self.spriteLayers enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, CALayer* spriteLayer, BOOL* stop)
+  {
+    GoPoint* point = [board pointAtVertex:vertexString];
+
+    enum GoColor stoneState;
+    if (previewStoneStates)
+      stoneState = (enum GoColor)previewStoneStates[[board indexOfPoint:point]];
+    else
+      stoneState = point.stoneState;
+
+    id image = nil;
+    if (point == self.currentCrossHairPoint)
+    {
+      if (stoneState != GoColorNone)
+        image = images[CrossHairStoneSpriteImage];
+      else if (GoColorBlack == game.nextMoveColor)
+        image = images[BlackStoneSpriteImage];
+      else
+        image = images[WhiteStoneSpriteImage];
+    }
+    else if (stoneState == GoColorBlack)
+    {
+      image = images[BlackStoneSpriteImage];
+    }
+    else if (stoneState == GoColorWhite)
+    {
+      image = images[WhiteStoneSpriteImage];
+    }
+
+    id contents = nil;
+    if (image && image != [NSNull null])
+      contents = (id)((UIImage*)image).CGImage;
+    if (spriteLayer.contents != contents)
+      spriteLayer.contents = contents;
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the images that are shared by the sprites of all tiles. The
+/// images are rendered anew if @a metrics describes a stone size that is
+/// different from the size of the current images.
+///
+/// If the board has extremely small dimensions the returned array contains
+/// NSNull objects instead of images.
+// -----------------------------------------------------------------------------
++ (NSArray*) stoneSpriteImagesWithMetrics:(BoardViewMetrics*)metrics
+{
+  CGSize imageSize = metrics.pointCellSize;
+  CGFloat imageScale = metrics.contentsScale;
+  if (stoneSpriteImages &&
+      CGSizeEqualToSize(imageSize, stoneSpriteImageSize) &&
+      imageScale == stoneSpriteImageScale)
+  {
+    return stoneSpriteImages;
+  }
+
+  NSMutableArray* images = [NSMutableArray arrayWithCapacity:NumberOfStoneSpriteImages];
+  for (int imageIndex = 0; imageIndex < NumberOfStoneSpriteImages; ++imageIndex)
+  {
+    UIImage* image = [StoneSpritesLayerDelegate renderStoneSpriteImage:(enum StoneSpriteImage)imageIndex
+                                                              withSize:imageSize
+                                                                 scale:imageScale
+                                                               metrics:metrics];
+    if (image)
+      [images addObject:image];
+    else
+      [images addObject:[NSNull null]];
+  }
+
+  [stoneSpriteImages release];
+  stoneSpriteImages = [images retain];
+  stoneSpriteImageSize = imageSize;
+  stoneSpriteImageScale = imageScale;
+  return stoneSpriteImages;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for stoneSpriteImagesWithMetrics:(). Renders the
+/// content of the cached stone layer that corresponds to @a spriteImage into
+/// a bitmap image. Returns nil if the board has extremely small dimensions.
+// -----------------------------------------------------------------------------
++ (UIImage*) renderStoneSpriteImage:(enum StoneSpriteImage)spriteImage
+                           withSize:(CGSize)imageSize
+                              scale:(CGFloat)imageScale
+                            metrics:(BoardViewMetrics*)metrics
+{
+  if (CGSizeEqualToSize(imageSize, CGSizeZero))
+    return nil;
+
+  BOOL opaque = NO;
+  UIGraphicsBeginImageContextWithOptions(imageSize, opaque, imageScale);
+  CGContextRef context = UIGraphicsGetCurrentContext();
+
+  CGLayerRef stoneLayer;
+  switch (spriteImage)
+  {
+    case BlackStoneSpriteImage:
+      stoneLayer = [BoardViewDrawingHelper cachedBlackStoneLayerWithContext:context withMetrics:metrics];
+      break;
+    case WhiteStoneSpriteImage:
+      stoneLayer = [BoardViewDrawingHelper cachedWhiteStoneLayerWithContext:context withMetrics:metrics];
+      break;
+    default:
+      stoneLayer = [BoardViewDrawingHelper cachedCrossHairStoneLayerWithContext:context withMetrics:metrics];
+      break;
+  }
+
+  UIImage* image = nil;
+  if (stoneLayer)
+  {
+    CGRect drawingRect = CGRectZero;
+    drawingRect.size = imageSize;
+    CGContextDrawLayerInRect(context, drawingRect, stoneLayer);
+    image = UIGraphicsGetImageFromCurrentImageContext();
+  }
+
+  UIGraphicsEndImageContext();
+  return image;
+}
+
+@end
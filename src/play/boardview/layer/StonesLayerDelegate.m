@@ -17,7 +17,6 @@
 
 // Project includes
 #import "StonesLayerDelegate.h"
-#import "BoardViewCGLayerCache.h"
 #import "BoardViewDrawingHelper.h"
 #import "../../model/BoardViewMetrics.h"
 #import "../../../go/GoBoard.h"
@@ -59,6 +58,19 @@
 /// used by drawLayer:inContext:(). Is nil if drawing is not triggered because
 /// of a setup point change.
 @property(nonatomic, retain) GoPoint* dirtySetupPoint;
+/// @brief The dirty rect calculated by notify:eventInfo:() that later needs to
+/// be used by drawLayer(). Used only when drawing is required because of a
+/// board position change.
+@property(nonatomic, assign) CGRect dirtyRectForBoardPosition;
+/// @brief The list of GoPoint objects whose stones intersect with
+/// @e dirtyRectForBoardPosition. Calculated by notify:eventInfo:() and later
+/// used by drawLayer:inContext:(). Is nil if drawing is not triggered because
+/// of a board position change.
+@property(nonatomic, retain) NSArray* dirtyPointsForBoardPosition;
+/// @brief The stone states of the board position that is being previewed, in
+/// the format of a board snapshot. Is @e nil if no board position is being
+/// previewed.
+@property(nonatomic, retain) NSData* previewStoneStates;
 @end
 
 
@@ -82,6 +94,9 @@
   self.dirtyPointsForCrossHairPoint = nil;
   self.dirtyRectForSetupPoint = CGRectZero;
   self.dirtySetupPoint = nil;
+  self.dirtyRectForBoardPosition = CGRectZero;
+  self.dirtyPointsForBoardPosition = nil;
+  self.previewStoneStates = nil;
   return self;
 }
 
@@ -94,20 +109,11 @@
   self.currentCrossHairPoint = nil;
   self.dirtyPointsForCrossHairPoint = nil;
   self.dirtySetupPoint = nil;
+  self.dirtyPointsForBoardPosition = nil;
+  self.previewStoneStates = nil;
   [super dealloc];
 }
 
-// -----------------------------------------------------------------------------
-/// @brief Invalidates the stone layers.
-// -----------------------------------------------------------------------------
-- (void) invalidateLayers
-{
-  BoardViewCGLayerCache* cache = [BoardViewCGLayerCache sharedCache];
-  [cache invalidateLayerOfType:BlackStoneLayerType];
-  [cache invalidateLayerOfType:WhiteStoneLayerType];
-  [cache invalidateLayerOfType:CrossHairStoneLayerType];
-}
-
 // -----------------------------------------------------------------------------
 /// @brief Invalidates the cross-hair point.
 // -----------------------------------------------------------------------------
@@ -142,6 +148,16 @@
   self.dirtyRectForSetupPoint = CGRectZero;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Invalidates the board position dirty rectangle and the points within
+/// that rectangle.
+// -----------------------------------------------------------------------------
+- (void) invalidateDirtyRectForBoardPosition
+{
+  self.dirtyRectForBoardPosition = CGRectZero;
+  self.dirtyPointsForBoardPosition = nil;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief BoardViewLayerDelegate method.
 // -----------------------------------------------------------------------------
@@ -152,11 +168,13 @@
     case BVLDEventBoardGeometryChanged:
     case BVLDEventBoardSizeChanged:
     {
-      [self invalidateLayers];
+      if (event == BVLDEventBoardSizeChanged)
+        self.previewStoneStates = nil;
       [self invalidateCrossHairPoint];
       [self invalidateDirtyRectForCrossHairPoint];
       [self invalidateDirtySetupPoint];
       [self invalidateDirtyRectForSetupPoint];
+      [self invalidateDirtyRectForBoardPosition];
       self.drawingPoints = [self calculateDrawingPoints];
       self.dirty = true;
       break;
@@ -164,31 +182,59 @@
     case BVLDEventGoGameStarted:  // place handicap stones
     case BVLDEventInvalidateContent:
     {
+      // The preview stone states are for the entire board, they remain valid
+      // when the tile displays a different part of the board
+      if (event == BVLDEventGoGameStarted)
+        self.previewStoneStates = nil;
       [self invalidateCrossHairPoint];
       [self invalidateDirtyRectForCrossHairPoint];
       [self invalidateDirtySetupPoint];
       [self invalidateDirtyRectForSetupPoint];
+      [self invalidateDirtyRectForBoardPosition];
       self.drawingPoints = [self calculateDrawingPoints];
       self.dirty = true;
       break;
     }
     case BVLDEventBoardPositionChanged:
     case BVLDEventAllSetupStonesDiscarded:
+    case BVLDEventBoardPositionPreviewChanged:
     {
+      if (event == BVLDEventBoardPositionPreviewChanged)
+        self.previewStoneStates = eventInfo;
       [self invalidateCrossHairPoint];
       [self invalidateDirtyRectForCrossHairPoint];
       [self invalidateDirtySetupPoint];
       [self invalidateDirtyRectForSetupPoint];
       NSMutableDictionary* oldDrawingPoints = self.drawingPoints;
-      NSMutableDictionary* newDrawingPoints = [self calculateDrawingPoints];
+      NSMutableDictionary* newDrawingPoints;
+      if (event == BVLDEventBoardPositionChanged && eventInfo && oldDrawingPoints)
+        newDrawingPoints = [self calculateDrawingPointsWithChangedPoints:eventInfo oldDrawingPoints:oldDrawingPoints];
+      else
+        newDrawingPoints = [self calculateDrawingPoints];
       // The dictionary must contain the intersection state so that the
       // dictionary comparison detects whether a stone was placed or captured
       if (! [oldDrawingPoints isEqualToDictionary:newDrawingPoints])
       {
         self.drawingPoints = newDrawingPoints;
-        // Re-draw the entire layer. Further optimization could be made here
-        // by only drawing that rectangle which is actually affected by
-        // self.drawingPoints.
+        if (self.dirty && CGRectIsEmpty(self.dirtyRectForBoardPosition))
+        {
+          // Some other event already requested a redraw of the entire layer.
+          // Also discard a pending cross-hair or setup point redraw, we have
+          // just invalidated the dirty points of those redraws.
+          [self invalidateDirtyRectForBoardPosition];
+        }
+        else
+        {
+          // Re-draw only the intersections whose state changed. If several
+          // board position changes occur between two drawing cycles the dirty
+          // rectangles are combined.
+          CGRect dirtyRect = [self dirtyRectForChangedDrawingPoints:newDrawingPoints
+                                                   oldDrawingPoints:oldDrawingPoints];
+          if (self.dirty)
+            dirtyRect = CGRectUnion(dirtyRect, self.dirtyRectForBoardPosition);
+          self.dirtyRectForBoardPosition = dirtyRect;
+          self.dirtyPointsForBoardPosition = [self drawingPointsIntersectingWithRect:dirtyRect];
+        }
         self.dirty = true;
       }
       break;
@@ -322,8 +368,30 @@
   {
     self.dirty = false;
 
-    if (CGRectIsEmpty(self.dirtyRectForCrossHairPoint) && CGRectIsEmpty(self.dirtyRectForSetupPoint))
+    if (! CGRectIsEmpty(self.dirtyRectForBoardPosition))
+    {
+      if (CGRectIsEmpty(self.dirtyRectForCrossHairPoint) && CGRectIsEmpty(self.dirtyRectForSetupPoint))
+      {
+        [self.layer setNeedsDisplayInRect:self.dirtyRectForBoardPosition];
+      }
+      else
+      {
+        // A cross-hair or setup point change occurred after the board position
+        // change. Combining the different dirty points is not worth the
+        // trouble, this is very rare.
+        self.dirtyPointsForCrossHairPoint = nil;
+        self.dirtySetupPoint = nil;
+        self.dirtyPointsForBoardPosition = nil;
+        [self.layer setNeedsDisplay];
+      }
+      // drawLayer:inContext:() still needs dirtyPointsForBoardPosition
+      self.dirtyRectForBoardPosition = CGRectZero;
+    }
+    else if (CGRectIsEmpty(self.dirtyRectForCrossHairPoint) && CGRectIsEmpty(self.dirtyRectForSetupPoint))
+    {
+      self.dirtyPointsForBoardPosition = nil;
       [self.layer setNeedsDisplay];
+    }
     else if (CGRectIsEmpty(self.dirtyRectForCrossHairPoint))
       [self.layer setNeedsDisplayInRect:self.dirtyRectForSetupPoint];
     else
@@ -351,8 +419,9 @@
   [self.drawingPoints enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* stoneStateAsNumber, BOOL* stop)
    {
      // Ignore stoneStateAsNumber, get the current values directly from the
-     // GoPoint object
+     // GoPoint object or the preview
      GoPoint* point = [board pointAtVertex:vertexString];
+     enum GoColor stoneState = [self stoneStateAtPoint:point];
 
      // If self.dirtyPointsForCrossHairPoint or self.dirtySetupPoint are set
      // they act as a filter: We don't want to draw more points than those that
@@ -368,11 +437,16 @@
        if (self.dirtySetupPoint != point)
          return;
      }
+     else if (self.dirtyPointsForBoardPosition)
+     {
+       if (! [self.dirtyPointsForBoardPosition containsObject:point])
+         return;
+     }
 
      CGLayerRef stoneLayer;
      if (point == self.currentCrossHairPoint)
      {
-       if (self.currentCrossHairPoint.hasStone)
+       if (stoneState != GoColorNone)
        {
          stoneLayer = crossHairStoneLayer;
        }
@@ -386,9 +460,9 @@
      }
      else
      {
-       if (! point.hasStone)
+       if (stoneState == GoColorNone)
          return;
-       if (point.blackStone)
+       if (stoneState == GoColorBlack)
          stoneLayer = blackStoneLayer;
        else
          stoneLayer = whiteStoneLayer;
@@ -402,6 +476,58 @@
 
   self.dirtyPointsForCrossHairPoint = nil;
   self.dirtySetupPoint = nil;
+  self.dirtyPointsForBoardPosition = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the union of the drawing rectangles of those intersections
+/// whose state differs between @a newDrawingPoints and @a oldDrawingPoints.
+///
+/// This is a private helper for notify:eventInfo:().
+// -----------------------------------------------------------------------------
+- (CGRect) dirtyRectForChangedDrawingPoints:(NSDictionary*)newDrawingPoints
+                           oldDrawingPoints:(NSDictionary*)oldDrawingPoints
+{
+  __block CGRect dirtyRect = CGRectZero;
+  GoBoard* board = [GoGame sharedGame].board;
+  [newDrawingPoints enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* stoneStateAsNumber, BOOL* stop)
+  {
+    NSNumber* oldStoneStateAsNumber = [oldDrawingPoints objectForKey:vertexString];
+    if (oldStoneStateAsNumber && [stoneStateAsNumber isEqualToNumber:oldStoneStateAsNumber])
+      return;
+    GoPoint* point = [board pointAtVertex:vertexString];
+    CGRect drawingRect = [BoardViewDrawingHelper drawingRectForTile:self.tile
+                                                    centeredAtPoint:point
+                                                        withMetrics:self.boardViewMetrics];
+    if (CGRectIsEmpty(dirtyRect))
+      dirtyRect = drawingRect;
+    else if (! CGRectIsEmpty(drawingRect))
+      dirtyRect = CGRectUnion(dirtyRect, drawingRect);
+  }];
+  return dirtyRect;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a list of GoPoint objects for those points in
+/// @e drawingPoints whose stones intersect with @a rect. These are the stones
+/// that must be drawn again when @a rect is redrawn.
+///
+/// This is a private helper for notify:eventInfo:().
+// -----------------------------------------------------------------------------
+- (NSArray*) drawingPointsIntersectingWithRect:(CGRect)rect
+{
+  NSMutableArray* points = [NSMutableArray array];
+  GoBoard* board = [GoGame sharedGame].board;
+  for (NSString* vertexString in self.drawingPoints)
+  {
+    GoPoint* point = [board pointAtVertex:vertexString];
+    CGRect drawingRect = [BoardViewDrawingHelper drawingRectForTile:self.tile
+                                                    centeredAtPoint:point
+                                                        withMetrics:self.boardViewMetrics];
+    if (CGRectIntersectsRect(rect, drawingRect))
+      [points addObject:point];
+  }
+  return points;
 }
 
 // -----------------------------------------------------------------------------
@@ -438,11 +564,52 @@
                                                                  metrics:self.boardViewMetrics];
     if (! CGRectIntersectsRect(tileRect, stoneRect))
       continue;
-    NSNumber* stoneStateAsNumber = [[[NSNumber alloc] initWithInt:point.stoneState] autorelease];
+    NSNumber* stoneStateAsNumber = [[[NSNumber alloc] initWithInt:[self stoneStateAtPoint:point]] autorelease];
     [drawingPoints setObject:stoneStateAsNumber forKey:point.vertex.string];
   }
 
   return drawingPoints;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns a dictionary that is the same as @a oldDrawingPoints, except
+/// that the stone states of the intersections in @a changedPoints are updated.
+/// Intersections in @a changedPoints that are not in @a oldDrawingPoints do not
+/// intersect with this tile and are ignored.
+///
+/// This is an alternative to calculateDrawingPoints() for board position
+/// changes that are accompanied by the intersections whose stone state
+/// changed. Unlike calculateDrawingPoints() it does not have to iterate over
+/// all points of the board.
+// -----------------------------------------------------------------------------
+- (NSMutableDictionary*) calculateDrawingPointsWithChangedPoints:(NSArray*)changedPoints
+                                                oldDrawingPoints:(NSDictionary*)oldDrawingPoints
+{
+  NSMutableDictionary* drawingPoints = [[oldDrawingPoints mutableCopy] autorelease];
+
+  for (GoPoint* point in changedPoints)
+  {
+    NSString* key = point.vertex.string;
+    if (! [oldDrawingPoints objectForKey:key])
+      continue;
+    NSNumber* stoneStateAsNumber = [[[NSNumber alloc] initWithInt:[self stoneStateAtPoint:point]] autorelease];
+    [drawingPoints setObject:stoneStateAsNumber forKey:key];
+  }
+
+  return drawingPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stone state of @a point in the board position that is
+/// being previewed, or the current stone state of @a point if no board
+/// position is being previewed.
+// -----------------------------------------------------------------------------
+- (enum GoColor) stoneStateAtPoint:(GoPoint*)point
+{
+  if (! self.previewStoneStates)
+    return point.stoneState;
+  const unsigned char* previewStoneStates = (const unsigned char*)self.previewStoneStates.bytes;
+  return (enum GoColor)previewStoneStates[[point.board indexOfPoint:point]];
+}
+
 @end
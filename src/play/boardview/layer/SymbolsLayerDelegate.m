@@ -54,6 +54,9 @@
 @property(nonatomic, retain) NSDictionary* whiteStrokeSymbolLayerTypes;
 /// @brief List of GoPoint objects for points that are on this tile.
 @property(nonatomic, retain) NSArray* drawingPointsOnTile;
+/// @brief The same GoPoint objects as in @e drawingPointsOnTile, for fast
+/// membership tests while drawing.
+@property(nonatomic, retain) NSSet* drawingPointsOnTileSet;
 @property(nonatomic, retain) GoPoint* drawingPoint;
 @property(nonatomic, retain) NSArray* pointsOnTileInConnectionRectangle;
 @property(nonatomic, assign) CGRect dirtyRect;
@@ -113,6 +116,7 @@
   };
 
   self.drawingPointsOnTile = @[];
+  self.drawingPointsOnTileSet = [NSSet set];
   self.pointsOnTileInConnectionRectangle = nil;
   self.drawingPoint = nil;
   self.dirtyRect = CGRectZero;
@@ -148,6 +152,7 @@
   self.markupModel = nil;
 
   self.drawingPointsOnTile = nil;
+  self.drawingPointsOnTileSet = nil;
   self.pointsOnTileInConnectionRectangle = nil;
   self.drawingPoint = nil;
   self.drawingPointTemporaryMarkup = nil;
@@ -228,11 +233,11 @@
     case BVLDEventBoardGeometryChanged:
     case BVLDEventBoardSizeChanged:
     {
-      [self invalidateLayers];
       [self invalidateDrawingRectangles];
       [self invalidateDirtyRects];
       [self invalidateDirtyData];
       self.drawingPointsOnTile = [self calculateDrawingPointsOnTile];
+      self.drawingPointsOnTileSet = [NSSet setWithArray:self.drawingPointsOnTile];
       self.dirty = true;
       break;
     }
@@ -248,6 +253,7 @@
       [self invalidateDirtyRects];
       [self invalidateDirtyData];
       self.drawingPointsOnTile = [self calculateDrawingPointsOnTile];
+      self.drawingPointsOnTileSet = [NSSet setWithArray:self.drawingPointsOnTile];
       self.dirty = true;
       break;
     }
@@ -487,12 +493,12 @@
   if (uiAreaPlayMode == UIAreaPlayModePlay || uiAreaPlayMode == UIAreaPlayModeEditMarkup)
   {
     // A method that wants to draw something on a GoPoint must first
-    // check this array if the GoPoint is already in the array. If not the
+    // check this set if the GoPoint is already in the set. If not the
     // method is allowed to draw on the GoPoint. The method must also add the
-    // GoPoint to the array, indicating to later methods that markup is already
+    // GoPoint to the set, indicating to later methods that markup is already
     // present on the GoPoint. Thus the order in which drawing methods are
     // invoked determines which markup has precedence.
-    NSMutableArray* pointsWithMarkup = [NSMutableArray array];
+    NSMutableSet* pointsWithMarkup = [NSMutableSet set];
 
     // A method that wants to draw something on a GoPoint must first check this
     // array if the GoPoint is in the array. If not the method is not allowed
@@ -635,7 +641,7 @@
 - (void) drawMoveNumbersInContext:(CGContextRef)context
                    inTileWithRect:(CGRect)tileRect
                    pointsToDrawOn:(NSArray*)pointsToDrawOn
-                 pointsWithMarkup:(NSMutableArray*)pointsWithMarkup
+                 pointsWithMarkup:(NSMutableSet*)pointsWithMarkup
 {
   UIFont* moveNumberFont = self.boardViewMetrics.moveNumberFont;
 
@@ -649,6 +655,13 @@
   if (! nodeWithMostRecentMove)
     return;
 
+  // The text attributes are the same for most numbers, so they are created
+  // only once instead of once per number
+  NSDictionary* textAttributesBlackStone = @{ NSFontAttributeName : moveNumberFont,
+                                              NSForegroundColorAttributeName : [UIColor whiteColor] };
+  NSDictionary* textAttributesWhiteStone = @{ NSFontAttributeName : moveNumberFont,
+                                              NSForegroundColorAttributeName : [UIColor blackColor] };
+
   GoMove* moveToBeNumbered = nodeWithMostRecentMove.goMove;
   GoMove* lastMove = moveToBeNumbered;
   for (;
@@ -666,38 +679,32 @@
       continue;  // during panning temporary markup is allowed to be drawn instead of a move number
     if (pointsToDrawOn && ! [pointsToDrawOn containsObject:pointToBeNumbered])
       continue;
-    if (! [self.drawingPointsOnTile containsObject:pointToBeNumbered])
+    if (! [self.drawingPointsOnTileSet containsObject:pointToBeNumbered])
       continue;
-    // TODO This lookup will take longer and longer the more moves have already
-    // been numbered. A full board redraw with the maximumNumberOfMoves takes a
-    // noticeable amount of time! Try to find an optimization for this problem.
-    // An attempt to optimize by using a dictionary/key lookup (key was obtained
-    // from pointToBeNumbered.vertex.string, which is not a very fast operation)
-    // instead of an array/linear search lookup had mixed results, so currently
-    // we still use array/linear search.
     if ([pointsWithMarkup containsObject:pointToBeNumbered])
       continue;
     [pointsWithMarkup addObject:pointToBeNumbered];
 
-    UIColor* textColor;
+    NSDictionary* textAttributes;
     if (moveToBeNumbered == lastMove && self.boardViewModel.markLastMove)
     {
+      UIColor* textColor;
       if (playerOfMoveToBeNumbered.isBlack)
         textColor = self.boardViewMetrics.lastMoveColorOnBlackStone;
       else
         textColor = self.boardViewMetrics.lastMoveColorOnWhiteStone;
+      textAttributes = @{ NSFontAttributeName : moveNumberFont,
+                          NSForegroundColorAttributeName : textColor };
     }
     else if (playerOfMoveToBeNumbered.isBlack)
     {
-      textColor = [UIColor whiteColor];
+      textAttributes = textAttributesBlackStone;
     }
     else
     {
-      textColor = [UIColor blackColor];
+      textAttributes = textAttributesWhiteStone;
     }
     NSString* moveNumberText = [NSString stringWithFormat:@"%d", moveToBeNumbered.moveNumber];
-    NSDictionary* textAttributes = @{ NSFontAttributeName : moveNumberFont,
-                                      NSForegroundColorAttributeName : textColor };
     [BoardViewDrawingHelper drawString:moveNumberText
                            withContext:context
                             attributes:textAttributes
@@ -754,7 +761,7 @@
 - (void) drawMarkupInContext:(CGContextRef)context
               inTileWithRect:(CGRect)tileRect
               pointsToDrawOn:(NSArray*)pointsToDrawOn
-            pointsWithMarkup:(NSMutableArray*)pointsWithMarkup
+            pointsWithMarkup:(NSMutableSet*)pointsWithMarkup
          drawConnectionsOnly:(bool)drawConnectionsOnly
 {
   GoGame* game = [GoGame sharedGame];
@@ -770,20 +777,20 @@
   // routine because all parts of connections that are on this tile have to be
   // re-drawn in full because we don't know how connection rectangles intersect
   // with any point cells on this tile.
-  [self drawConnectionsMarkup:nodeMarkup.connections inContext:context inTileWithRect:tileRect board:board];
+  [self drawConnectionsMarkup:nodeMarkup inContext:context inTileWithRect:tileRect board:board];
 
   if (drawConnectionsOnly)
     return;
 
   if (self.markupModel.markupPrecedence == MarkupPrecedenceSymbols)
   {
-    [self drawSymbolsMarkup:nodeMarkup.symbols inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
-    [self drawLabelsMarkup:nodeMarkup.labels inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
+    [self drawSymbolsMarkup:nodeMarkup inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
+    [self drawLabelsMarkup:nodeMarkup inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
   }
   else
   {
-    [self drawLabelsMarkup:nodeMarkup.labels inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
-    [self drawSymbolsMarkup:nodeMarkup.symbols inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
+    [self drawLabelsMarkup:nodeMarkup inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
+    [self drawSymbolsMarkup:nodeMarkup inContext:context inTileWithRect:tileRect board:board pointsToDrawOn:pointsToDrawOn pointsWithMarkup:pointsWithMarkup];
   }
 
   [self drawDimmingsMarkup:nodeMarkup.dimmings inContext:context inTileWithRect:tileRect board:board];
@@ -793,35 +800,37 @@
 /// @brief Private helper for
 /// drawMarkupInContext:inTileWithRect:pointsWithMarkup:().
 // -----------------------------------------------------------------------------
-- (void) drawSymbolsMarkup:(NSDictionary*)symbols
+- (void) drawSymbolsMarkup:(GoNodeMarkup*)nodeMarkup
                  inContext:(CGContextRef)context
             inTileWithRect:(CGRect)tileRect
                      board:(GoBoard*)board
             pointsToDrawOn:(NSArray*)pointsToDrawOn
-          pointsWithMarkup:(NSMutableArray*)pointsWithMarkup
+          pointsWithMarkup:(NSMutableSet*)pointsWithMarkup
 {
-  if (! symbols)
+  if (! [nodeMarkup hasSymbols])
     return;
 
   BoardViewCGLayerCache* cache = [BoardViewCGLayerCache sharedCache];
 
-  [symbols enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* symbolAsNumber, BOOL* stop)
+  // Instead of looking up the intersection of every symbol by its vertex
+  // string we query the symbol of every intersection that is to be drawn
+  for (GoPoint* point in (pointsToDrawOn ? pointsToDrawOn : self.drawingPointsOnTile))
   {
-    GoPoint* pointWithSymbol = [board pointAtVertex:vertexString];
-    if (pointsToDrawOn && ! [pointsToDrawOn containsObject:pointWithSymbol])
-      return;
-    if (! [self.drawingPointsOnTile containsObject:pointWithSymbol])
-      return;
-    if ([pointsWithMarkup containsObject:pointWithSymbol])
-      return;
-    [pointsWithMarkup addObject:pointWithSymbol];
+    enum GoMarkupSymbol symbol;
+    if (! [nodeMarkup hasSymbolAtPoint:point symbol:&symbol])
+      continue;
+    if (pointsToDrawOn && ! [self.drawingPointsOnTileSet containsObject:point])
+      continue;
+    if ([pointsWithMarkup containsObject:point])
+      continue;
+    [pointsWithMarkup addObject:point];
 
-    [self drawSymbolMarkup:symbolAsNumber
+    [self drawSymbolMarkup:[NSNumber numberWithInt:symbol]
                  inContext:context
             inTileWithRect:tileRect
-                   atPoint:pointWithSymbol
+                   atPoint:point
                  withCache:cache];
-  }];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -870,19 +879,18 @@
 /// @brief Private helper for
 /// drawMarkupInContext:inTileWithRect:pointsWithMarkup:().
 // -----------------------------------------------------------------------------
-- (void) drawConnectionsMarkup:(NSDictionary*)connections
+- (void) drawConnectionsMarkup:(GoNodeMarkup*)nodeMarkup
                      inContext:(CGContextRef)context
                 inTileWithRect:(CGRect)tileRect
                          board:(GoBoard*)board
 {
-  if (! connections)
+  if (! [nodeMarkup hasConnections])
     return;
 
-  [connections enumerateKeysAndObjectsUsingBlock:^(NSArray* vertexStrings, NSNumber* connectionAsNumber, BOOL* stop)
+  [nodeMarkup enumerateConnectionsUsingBlock:^(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop)
   {
-    enum GoMarkupConnection connection = connectionAsNumber.intValue;
-    GoPoint* fromPoint = [board pointAtVertex:[vertexStrings firstObject]];
-    GoPoint* toPoint = [board pointAtVertex:[vertexStrings lastObject]];
+    GoPoint* fromPoint = [board pointAtNumericVertex:fromVertex];
+    GoPoint* toPoint = [board pointAtNumericVertex:toVertex];
 
     // For symbols which have a fixed size and appearance we can use a
     // pre-drawn and cached layer. This is not possible for connections
@@ -919,14 +927,14 @@
 /// @brief Private helper for
 /// drawMarkupInContext:inTileWithRect:pointsWithMarkup:().
 // -----------------------------------------------------------------------------
-- (void) drawLabelsMarkup:(NSDictionary*)labels
+- (void) drawLabelsMarkup:(GoNodeMarkup*)nodeMarkup
                 inContext:(CGContextRef)context
            inTileWithRect:(CGRect)tileRect
                     board:(GoBoard*)board
            pointsToDrawOn:(NSArray*)pointsToDrawOn
-         pointsWithMarkup:(NSMutableArray*)pointsWithMarkup
+         pointsWithMarkup:(NSMutableSet*)pointsWithMarkup
 {
-  if (! labels)
+  if (! [nodeMarkup hasLabels])
     return;
 
   if (! self.boardViewMetrics.markupLetterMarkerFont &&
@@ -935,15 +943,18 @@
     return;
   }
 
-  [labels enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSArray* labelTypeAndText, BOOL* stop)
+  // Instead of looking up the intersection of every label by its vertex
+  // string we query the label of every intersection that is to be drawn
+  for (GoPoint* pointWithLabel in (pointsToDrawOn ? pointsToDrawOn : self.drawingPointsOnTile))
   {
-    GoPoint* pointWithLabel = [board pointAtVertex:vertexString];
-    if (pointsToDrawOn && ! [pointsToDrawOn containsObject:pointWithLabel])
-      return;
-    if (! [self.drawingPointsOnTile containsObject:pointWithLabel])
-      return;
+    enum GoMarkupLabel labelType;
+    NSString* labelText;
+    if (! [nodeMarkup hasLabelAtPoint:pointWithLabel labelType:&labelType labelText:&labelText])
+      continue;
+    if (pointsToDrawOn && ! [self.drawingPointsOnTileSet containsObject:pointWithLabel])
+      continue;
     if ([pointsWithMarkup containsObject:pointWithLabel])
-      return;
+      continue;
     [pointsWithMarkup addObject:pointWithLabel];
 
     // Non-marker labels are drawn on LabelsLayerDelegate. We abort the drawing
@@ -951,19 +962,15 @@
     // draw the non-marker label in this layer, we want to prevent this layer
     // from drawing other lower-precedence drawing artifacts (e.g. move
     // numbers).
-    NSNumber* labelTypeAsNumber = labelTypeAndText.firstObject;
-    enum GoMarkupLabel labelType = labelTypeAsNumber.intValue;
     if (labelType == GoMarkupLabelLabel)
-      return;
-
-    NSString* labelText = labelTypeAndText.lastObject;
+      continue;
 
     [self drawLabelMarkup:labelText
                 inContext:context
            inTileWithRect:tileRect
                   atPoint:pointWithLabel
                 labelType:labelType];
-  }];
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -1072,7 +1079,7 @@
 - (void) drawLastMoveSymbolInContext:(CGContextRef)context
                       inTileWithRect:(CGRect)tileRect
                       pointsToDrawOn:(NSArray*)pointsToDrawOn
-                    pointsWithMarkup:(NSMutableArray*)pointsWithMarkup
+                    pointsWithMarkup:(NSMutableSet*)pointsWithMarkup
 {
   GoGame* game = [GoGame sharedGame];
   GoNode* nodeWithMostRecentMove = [GoUtilities nodeWithMostRecentMove:game.boardPosition.currentNode];
@@ -1086,7 +1093,7 @@
   GoPoint* pointWithLastMoveSymbol = mostRecentMove.point;
   if (pointsToDrawOn && ! [pointsToDrawOn containsObject:pointWithLastMoveSymbol])
     return;
-  if (! [self.drawingPointsOnTile containsObject:pointWithLastMoveSymbol])
+  if (! [self.drawingPointsOnTileSet containsObject:pointWithLastMoveSymbol])
     return;
   if ([pointsWithMarkup containsObject:pointWithLastMoveSymbol])
     return;
@@ -1127,7 +1134,7 @@
 - (void) drawNextMoveLabelInContext:(CGContextRef)context
                      inTileWithRect:(CGRect)tileRect
                      pointsToDrawOn:(NSArray*)pointsToDrawOn
-                   pointsWithMarkup:(NSMutableArray*)pointsWithMarkup
+                   pointsWithMarkup:(NSMutableSet*)pointsWithMarkup
 {
   GoGame* game = [GoGame sharedGame];
   GoNode* nodeWithNextMove = [GoUtilities nodeWithNextMove:game.boardPosition.currentNode inCurrentGameVariation:game];
@@ -1141,7 +1148,7 @@
   GoPoint* pointWithNextMoveLabel = nextMove.point;
   if (pointsToDrawOn && ! [pointsToDrawOn containsObject:pointWithNextMoveLabel])
     return;
-  if (! [self.drawingPointsOnTile containsObject:pointWithNextMoveLabel])
+  if (! [self.drawingPointsOnTileSet containsObject:pointWithNextMoveLabel])
     return;
   if ([pointsWithMarkup containsObject:pointWithNextMoveLabel])
     return;
@@ -1195,7 +1202,7 @@
   {
     if (self.drawingPoint && self.drawingPoint != handicapPoint)
       continue;
-    if (! [self.drawingPointsOnTile containsObject:handicapPoint])
+    if (! [self.drawingPointsOnTileSet containsObject:handicapPoint])
       continue;
 
     // If the user is viewing a board position > 0 then handicap stones may
@@ -25,6 +25,7 @@
 #import "../../../go/GoBoardRegion.h"
 #import "../../../go/GoGame.h"
 #import "../../../go/GoPoint.h"
+#import "../../../go/GoScore.h"
 #import "../../../go/GoVertex.h"
 #import "../../../main/ApplicationDelegate.h"
 #import "../../../ui/CGDrawingHelper.h"
@@ -42,6 +43,11 @@
 /// @brief Store list of points to draw between notify:eventInfo:() and
 /// drawLayer:inContext:(), and also between drawing cycles.
 @property(nonatomic, retain) NSMutableDictionary* drawingPointsStoneGroupState;
+/// @brief The dirty rect calculated by notify:eventInfo:() that later needs to
+/// be used by drawLayer(). Used only when drawing is required because of a
+/// score calculation or a change of the inconsistent territory markup type.
+/// Is CGRectZero if the entire layer needs to be redrawn.
+@property(nonatomic, assign) CGRect dirtyRectForScoreChanges;
 @end
 
 
@@ -63,6 +69,7 @@
   self.scoringModel = scoringModel;
   self.drawingPointsTerritory = [[[NSMutableDictionary alloc] initWithCapacity:0] autorelease];
   self.drawingPointsStoneGroupState = [[[NSMutableDictionary alloc] initWithCapacity:0] autorelease];
+  self.dirtyRectForScoreChanges = CGRectZero;
   return self;
 }
 
@@ -110,9 +117,9 @@
     case BVLDEventBoardGeometryChanged:
     case BVLDEventBoardSizeChanged:
     {
-      [self invalidateLayers];
       self.drawingPointsTerritory = [self calculateDrawingPointsTerritory];
       self.drawingPointsStoneGroupState = [self calculateDrawingPointsStoneGroupState];
+      self.dirtyRectForScoreChanges = CGRectZero;
       self.dirty = true;
       break;
     }
@@ -120,6 +127,7 @@
     {
       self.drawingPointsTerritory = [self calculateDrawingPointsTerritory];
       self.drawingPointsStoneGroupState = [self calculateDrawingPointsStoneGroupState];
+      self.dirtyRectForScoreChanges = CGRectZero;
       self.dirty = true;
       break;
     }
@@ -134,10 +142,8 @@
       if (! [oldDrawingPointsTerritory isEqualToDictionary:newDrawingPointsTerritory])
       {
         self.drawingPointsTerritory = newDrawingPointsTerritory;
-        // Re-draw the entire layer. Further optimization could be made here
-        // by only drawing that rectangle which is actually affected by
-        // self.drawingPointsTerritory.
-        self.dirty = true;
+        [self addDirtyRectForChangedDrawingPoints:newDrawingPointsTerritory
+                                 oldDrawingPoints:oldDrawingPointsTerritory];
       }
 
       if (event != BVLDEventInconsistentTerritoryMarkupTypeChanged)
@@ -149,10 +155,8 @@
         if (! [oldDrawingPointsStoneGroupState isEqualToDictionary:newDrawingPointsStoneGroupState])
         {
           self.drawingPointsStoneGroupState = newDrawingPointsStoneGroupState;
-          // Re-draw the entire layer. Further optimization could be made here
-          // by only drawing that rectangle which is actually affected by
-          // self.drawingPointsStoneGroupState.
-          self.dirty = true;
+          [self addDirtyRectForChangedDrawingPoints:newDrawingPointsStoneGroupState
+                                   oldDrawingPoints:oldDrawingPointsStoneGroupState];
         }
       }
       break;
@@ -164,6 +168,50 @@
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for notify:eventInfo:(). Marks the layer dirty so
+/// that only the intersections are redrawn whose value differs between
+/// @a newDrawingPoints and @a oldDrawingPoints. If several changes occur
+/// between two drawing cycles the dirty rectangles are combined.
+// -----------------------------------------------------------------------------
+- (void) addDirtyRectForChangedDrawingPoints:(NSDictionary*)newDrawingPoints
+                            oldDrawingPoints:(NSDictionary*)oldDrawingPoints
+{
+  if (self.dirty && CGRectIsEmpty(self.dirtyRectForScoreChanges))
+  {
+    // Some other event already requested a redraw of the entire layer
+  }
+  else
+  {
+    CGRect dirtyRect = [self dirtyRectForChangedDrawingPoints:newDrawingPoints
+                                             oldDrawingPoints:oldDrawingPoints];
+    if (self.dirty)
+      dirtyRect = CGRectUnion(dirtyRect, self.dirtyRectForScoreChanges);
+    self.dirtyRectForScoreChanges = dirtyRect;
+  }
+  self.dirty = true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief BoardViewLayerDelegate method.
+// -----------------------------------------------------------------------------
+- (void) drawLayer
+{
+  if (self.dirty)
+  {
+    self.dirty = false;
+    if (CGRectIsEmpty(self.dirtyRectForScoreChanges))
+    {
+      [self.layer setNeedsDisplay];
+    }
+    else
+    {
+      [self.layer setNeedsDisplayInRect:self.dirtyRectForScoreChanges];
+      self.dirtyRectForScoreChanges = CGRectZero;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief CALayerDelegate method.
 // -----------------------------------------------------------------------------
@@ -245,6 +293,9 @@
 // -----------------------------------------------------------------------------
 - (void) drawTerritoryWithContext:(CGContextRef)context inTileRect:(CGRect)tileRect withBoard:(GoBoard*)board
 {
+  // If only a part of the layer is redrawn, intersections outside of the
+  // clipping area set up by setNeedsDisplayInRect:() are skipped
+  CGRect clipRect = CGContextGetClipBoundingBox(context);
   BoardViewCGLayerCache* cache = [BoardViewCGLayerCache sharedCache];
   BoardViewCGLayerCacheEntry blackTerritoryLayerEntry = [cache layerOfType:BlackTerritoryLayerType];
   BoardViewCGLayerCacheEntry whiteTerritoryLayerEntry = [cache layerOfType:WhiteTerritoryLayerType];
@@ -272,6 +323,8 @@
         return;
     }
     GoPoint* point = [board pointAtVertex:vertexString];
+    if (! [self isPoint:point insideClipRect:clipRect])
+      return;
     [BoardViewDrawingHelper drawLayer:layerToDraw
                           withContext:context
                       centeredAtPoint:point
@@ -285,6 +338,9 @@
 // -----------------------------------------------------------------------------
 - (void) drawStoneGroupStateWithContext:(CGContextRef)context inTileRect:(CGRect)tileRect withBoard:(GoBoard*)board
 {
+  // If only a part of the layer is redrawn, intersections outside of the
+  // clipping area set up by setNeedsDisplayInRect:() are skipped
+  CGRect clipRect = CGContextGetClipBoundingBox(context);
   BoardViewCGLayerCache* cache = [BoardViewCGLayerCache sharedCache];
   BoardViewCGLayerCacheEntry deadStoneSymbolLayerEntry = [cache layerOfType:DeadStoneSymbolLayerType];
   BoardViewCGLayerCacheEntry blackSekiStoneSymbolLayerEntry = [cache layerOfType:BlackSekiStoneSymbolLayerType];
@@ -292,6 +348,8 @@
 
   [self.drawingPointsStoneGroupState enumerateKeysAndObjectsUsingBlock:^(NSString* vertexString, NSNumber* stoneGroupStateAsNumber, BOOL* stop){
     GoPoint* point = [board pointAtVertex:vertexString];
+    if (! [self isPoint:point insideClipRect:clipRect])
+      return;
     enum GoStoneGroupState stoneGroupState = [stoneGroupStateAsNumber intValue];
     CGLayerRef layerToDraw = 0;
     switch (stoneGroupState)
@@ -336,6 +394,19 @@
   }];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawTerritoryWithContext:inTileRect:withBoard:()
+/// and drawStoneGroupStateWithContext:inTileRect:withBoard:(). Returns true if
+/// the drawing rectangle of @a point intersects with @a clipRect.
+// -----------------------------------------------------------------------------
+- (bool) isPoint:(GoPoint*)point insideClipRect:(CGRect)clipRect
+{
+  CGRect drawingRect = [BoardViewDrawingHelper drawingRectForTile:self.tile
+                                                  centeredAtPoint:point
+                                                      withMetrics:self.boardViewMetrics];
+  return CGRectIntersectsRect(clipRect, drawingRect);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns a dictionary that identifies the points whose intersections
 /// are located on this tile, and the markup style that should be used to draw
@@ -348,6 +419,9 @@
 /// Dictionary values are NSNumber objects that store a TerritoryMarkupStyle
 /// enum value. The value identifies the layer that needs to be drawn at the
 /// intersection.
+///
+/// The territory is taken from the territory map of the last score
+/// calculation, i.e. GoBoardRegion objects are not queried.
 // -----------------------------------------------------------------------------
 - (NSMutableDictionary*) calculateDrawingPointsTerritory
 {
@@ -355,6 +429,13 @@
   if ([ApplicationDelegate sharedDelegate].uiSettingsModel.uiAreaPlayMode != UIAreaPlayModeScoring)
     return drawingPoints;
 
+  GoGame* game = [GoGame sharedGame];
+  GoBoard* board = game.board;
+  NSData* territoryMap = game.score.territoryMap;
+  if (! territoryMap)
+    return drawingPoints;
+  const unsigned char* territoryMapEntries = territoryMap.bytes;
+
   enum InconsistentTerritoryMarkupType inconsistentTerritoryMarkupType = self.scoringModel.inconsistentTerritoryMarkupType;
 
   // TODO: Currently we always iterate over all points. This could be
@@ -365,7 +446,8 @@
   // on iPad where there are more tiles it is even worse.
   [self calculateDrawingPointsOnTileWithCallback:^bool(GoPoint* point, bool* stop)
   {
-    enum GoColor territoryColor = point.region.territoryColor;
+    unsigned char territoryMapEntry = territoryMapEntries[[board indexOfPoint:point]];
+    enum GoColor territoryColor = (enum GoColor)(territoryMapEntry & GoTerritoryMapEntryColorMask);
     enum TerritoryMarkupStyle territoryMarkupStyle;
     switch (territoryColor)
     {
@@ -381,7 +463,7 @@
       }
       case GoColorNone:
       {
-        if (! point.region.territoryInconsistencyFound)
+        if (! (territoryMapEntry & GoTerritoryMapEntryInconsistentFlag))
           return false;  // territory is truly neutral, no markup needed
         switch (inconsistentTerritoryMarkupType)
         {
@@ -401,7 +483,7 @@
       }
       default:
       {
-        DDLogError(@"Unknown value %d for property point.region.territoryColor", territoryColor);
+        DDLogError(@"Unknown territory color %d in territory map", territoryColor);
         return false;
       }
     }
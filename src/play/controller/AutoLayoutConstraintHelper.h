@@ -26,7 +26,7 @@
 {
 }
 
-+ (void) updateAutoLayoutConstraints:(NSMutableArray*)constraints
++ (void) updateAutoLayoutConstraints:(NSMutableDictionary*)constraintSets
                          ofBoardView:(UIView*)boardView
                              forAxis:(UILayoutConstraintAxis)axis
                     constraintHolder:(UIView*)constraintHolder;
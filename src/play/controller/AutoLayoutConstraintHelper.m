@@ -27,11 +27,17 @@
 /// @a boardView within its superview. The constraints are added to
 /// @a constraintHolder (which may or may not be the superview itself).
 ///
-/// @a constraints is expected to hold the current set of constraints that
-/// resulted from a previous invocation of this method. The current set of
-/// constraints is first removed from @a constraintHolder. @a constraints is
-/// then emptied and a new set of constraints is calculated and added to
-/// @a constraints. The new set is then added to @a constraintHolder.
+/// @a constraintSets is expected to hold the sets of constraints that resulted
+/// from previous invocations of this method. The dictionary key is an NSNumber
+/// with the UILayoutConstraintAxis value for which a set was created, the
+/// dictionary value is an NSArray with the constraints of that set. All sets
+/// that do not belong to @a axis are deactivated. If the dictionary already
+/// contains a set for @a axis the set is activated again, otherwise a new set
+/// of constraints is calculated, added to @a constraintHolder and stored in
+/// @a constraintSets. Switching back and forth between the two axes, e.g.
+/// when the user resizes the app window in multitasking mode, therefore does
+/// not create new constraints. Clients must provide a new empty dictionary when
+/// they set up a new view hierarchy.
 ///
 /// The generated constraints satisfy the following layout requirements:
 /// - The board view is square. This is important so that coordinate labels
@@ -58,13 +64,45 @@
 ///   dimension. The logic that determines the larger dimension is the inverse
 ///   of the logic that determines the smaller dimension.
 // -----------------------------------------------------------------------------
-+ (void) updateAutoLayoutConstraints:(NSMutableArray*)constraints
++ (void) updateAutoLayoutConstraints:(NSMutableDictionary*)constraintSets
                          ofBoardView:(UIView*)boardView
                              forAxis:(UILayoutConstraintAxis)axis
                     constraintHolder:(UIView*)constraintHolder;
 {
-  [constraintHolder removeConstraints:constraints];
-  [constraints removeAllObjects];
+  NSNumber* axisAsNumber = [NSNumber numberWithInteger:axis];
+
+  // Deactivate first so that the old and the new set are never active at the
+  // same time
+  for (NSNumber* key in constraintSets)
+  {
+    if (! [key isEqualToNumber:axisAsNumber])
+      [NSLayoutConstraint deactivateConstraints:constraintSets[key]];
+  }
+
+  NSArray* constraints = constraintSets[axisAsNumber];
+  if (constraints)
+  {
+    [NSLayoutConstraint activateConstraints:constraints];
+  }
+  else
+  {
+    constraints = [AutoLayoutConstraintHelper createAutoLayoutConstraintsOfBoardView:boardView
+                                                                             forAxis:axis
+                                                                    constraintHolder:constraintHolder];
+    constraintSets[axisAsNumber] = constraints;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// updateAutoLayoutConstraints:ofBoardView:forAxis:constraintHolder:().
+/// Creates and activates a new set of constraints for @a axis.
+// -----------------------------------------------------------------------------
++ (NSArray*) createAutoLayoutConstraintsOfBoardView:(UIView*)boardView
+                                            forAxis:(UILayoutConstraintAxis)axis
+                                   constraintHolder:(UIView*)constraintHolder
+{
+  NSMutableArray* constraints = [NSMutableArray array];
 
   UIView* superviewOfBoardView = boardView.superview;
 
@@ -107,7 +145,7 @@
 
   NSLayoutConstraint* aspectRatioConstraint = [AutoLayoutUtility makeSquare:boardView
                                                        widthDependsOnHeight:widthDependsOnHeight
-                                                           constraintHolder:superviewOfBoardView];
+                                                           constraintHolder:constraintHolder];
   [constraints addObject:aspectRatioConstraint];
 
   NSLayoutConstraint* constraintEdge1 = [boardViewEdge1 constraintEqualToAnchor:superviewEdge1];
@@ -121,6 +159,8 @@
                                                               inSuperview:superviewOfBoardView
                                                                    onAxis:centerConstraintAxis];
   [constraints addObject:centerConstraint];
+
+  return constraints;
 }
 
 @end
@@ -19,6 +19,7 @@
 #import "../../newgame/NewGameController.h"
 #import "../../ui/EditTextController.h"
 #import "../../ui/ItemPickerController.h"
+#import "VariationComparisonController.h"
 
 // Forward declarations
 @class MoreGameActionsController;
@@ -50,7 +51,7 @@
 /// - Managing sub-controllers for views that need to be displayed as part of
 ///   handling the tap on a button
 // -----------------------------------------------------------------------------
-@interface MoreGameActionsController : NSObject <NewGameControllerDelegate, EditTextDelegate, ItemPickerDelegate>
+@interface MoreGameActionsController : NSObject <NewGameControllerDelegate, EditTextDelegate, ItemPickerDelegate, VariationComparisonControllerDelegate>
 {
 }
 
@@ -25,6 +25,7 @@
 #import "../../command/game/SaveGameCommand.h"
 #import "../../command/game/NewGameCommand.h"
 #import "../../command/game/ResumePlayCommand.h"
+#import "../../command/node/SolveLifeAndDeathProblemCommand.h"
 #import "../../command/playerinfluence/GenerateTerritoryStatisticsCommand.h"
 #import "../../command/ChangeUIAreaPlayModeCommand.h"
 #import "../../go/GoBoardPosition.h"
@@ -232,6 +233,35 @@
         alertActionBlock = ^(UIAlertAction* action) { [self updatePlayerInfluence]; };
         break;
       }
+      case MoreGameActionsButtonSolveLifeAndDeath:
+      {
+        if (uiAreaPlayMode != UIAreaPlayModePlay)
+          continue;
+        if (GoGameStateGameHasEnded == game.state)
+          continue;
+        if (game.isComputerThinking || ! game.alternatingPlay)
+          continue;
+        // Life-and-death problems are set up, they don't arise from a game.
+        // Offering the option only if there is board setup keeps the menu
+        // short during normal games.
+        if (! [GoUtilities nodeWithMostRecentSetup:game.boardPosition.currentNode inCurrentGameVariation:game])
+          continue;
+        title = @"Solve life & death";
+        alertActionBlock = ^(UIAlertAction* action) { [self solveLifeAndDeath]; };
+        break;
+      }
+      case MoreGameActionsButtonCompareVariations:
+      {
+        if (uiAreaPlayMode != UIAreaPlayModePlay)
+          continue;
+        // Offering the option only if there are variations keeps the menu
+        // short in games without variations
+        if (! [VariationComparisonController nodesToCompareInGame:game])
+          continue;
+        title = @"Compare variations";
+        alertActionBlock = ^(UIAlertAction* action) { [self compareVariations]; };
+        break;
+      }
       case MoreGameActionsButtonSetBlackToMove:
       case MoreGameActionsButtonSetWhiteToMove:
       {
@@ -494,6 +524,42 @@
   [self.delegate moreGameActionsControllerDidFinish:self];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Reacts to a tap gesture on the "Solve life & death" button. Solves
+/// the life-and-death problem in the current board position in the
+/// background. The solution is added to the game tree as a new game
+/// variation.
+// -----------------------------------------------------------------------------
+- (void) solveLifeAndDeath
+{
+  [[[[SolveLifeAndDeathProblemCommand alloc] init] autorelease] submit];
+  [self.delegate moreGameActionsControllerDidFinish:self];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reacts to a tap gesture on the "Compare variations" button.
+/// Displays the variations that branch off closest to the current board
+/// position side by side, without changing the current board position.
+// -----------------------------------------------------------------------------
+- (void) compareVariations
+{
+  GoGame* game = [GoGame sharedGame];
+  NSArray* nodes = [VariationComparisonController nodesToCompareInGame:game];
+  VariationComparisonController* variationComparisonController = [VariationComparisonController controllerWithGame:game
+                                                                                                            nodes:nodes
+                                                                                                         delegate:self];
+  [self.modalMaster presentNavigationControllerWithRootViewController:variationComparisonController];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief VariationComparisonControllerDelegate protocol method
+// -----------------------------------------------------------------------------
+- (void) variationComparisonControllerDidFinish:(VariationComparisonController*)controller
+{
+  [self.modalMaster dismissViewControllerAnimated:YES completion:nil];
+  [self.delegate moreGameActionsControllerDidFinish:self];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Reacts to a tap gesture on the "Set color to <foo>" button. Changes
 /// the side that will play next from Black to White, or vice versa.
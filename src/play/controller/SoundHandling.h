@@ -32,6 +32,12 @@
 ///
 /// Sound and vibration may be temporarily disabled by setting a property to
 /// prevent any disturbances, e.g. while the user is answering a phone call.
+///
+/// The sound is played by an audio engine from a buffer that holds the already
+/// decoded samples of the sound file. Decoding, setting up the audio engine and
+/// triggering the sound all happen on a dedicated serial queue, so none of
+/// this takes main thread time. The audio engine is started when the sound is
+/// first played, and stopped while sound and vibration are disabled.
 // -----------------------------------------------------------------------------
 @interface SoundHandling : NSObject
 {
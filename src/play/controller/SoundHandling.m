@@ -22,6 +22,7 @@
 #import "../../go/GoGame.h"
 
 // System includes
+#import <AVFoundation/AVFoundation.h>
 #include <AudioToolbox/AudioServices.h>
 
 
@@ -30,7 +31,14 @@
 // -----------------------------------------------------------------------------
 @interface SoundHandling()
 @property(nonatomic, assign) BoardViewModel* model;
-@property(nonatomic, assign) SystemSoundID playStoneSystemSound;
+/// @brief Serial queue on which all interaction with the audio engine takes
+/// place, so that none of it takes main thread time.
+@property(nonatomic, retain) dispatch_queue_t audioQueue;
+@property(nonatomic, retain) AVAudioEngine* audioEngine;
+@property(nonatomic, retain) AVAudioPlayerNode* playStonePlayerNode;
+/// @brief The "play stone" sound, decoded into PCM samples. Is @e nil if the
+/// audio engine could not be set up.
+@property(nonatomic, retain) AVAudioPCMBuffer* playStoneBuffer;
 @end
 
 
@@ -49,19 +57,27 @@
     return nil;
 
   self.disabled = false;
-  // NSString and CFStringRef are toll-free bridged types, which allows to
-  // simply cast NSString* into a CFStringRef.
-  // TODO: We should use ApplicationDelegate.resourceBundle here, but how can
-  // we get from NSBundle to CFBundle? These are not toll-free bridged types...
-  CFURLRef playStoneURLRef = CFBundleCopyResourceURL(CFBundleGetMainBundle(), (CFStringRef)playStoneSoundFileResource, NULL, NULL);
-  AudioServicesCreateSystemSoundID(playStoneURLRef, &_playStoneSystemSound);
-  CFRelease(playStoneURLRef);
+  self.audioEngine = nil;
+  self.playStonePlayerNode = nil;
+  self.playStoneBuffer = nil;
 
   ApplicationDelegate* delegate = [ApplicationDelegate sharedDelegate];
   self.model = delegate.boardViewModel;
 
+  dispatch_queue_attr_t queueAttributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INTERACTIVE, 0);
+  dispatch_queue_t audioQueue = dispatch_queue_create("ch.herzbube.littlego.soundhandling", queueAttributes);
+  self.audioQueue = audioQueue;
+  dispatch_release(audioQueue);
+  // Decoding the sound file and setting up the audio engine is done in the
+  // background so that it does not delay the application launch
+  NSURL* playStoneURL = [delegate.resourceBundle URLForResource:playStoneSoundFileResource withExtension:nil];
+  dispatch_async(self.audioQueue, ^{
+    [self setupAudioEngineWithPlayStoneURL:playStoneURL];
+  });
+
   NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
   [center addObserver:self selector:@selector(computerPlayerThinkingStops:) name:computerPlayerThinkingStops object:nil];
+  [center addObserver:self selector:@selector(audioEngineConfigurationChange:) name:AVAudioEngineConfigurationChangeNotification object:nil];
 
   return self;
 }
@@ -72,11 +88,118 @@
 - (void) dealloc
 {
   [[NSNotificationCenter defaultCenter] removeObserver:self];
-  AudioServicesDisposeSystemSoundID(self.playStoneSystemSound);
+
+  // The audio engine is set up on audioQueue, so it must also be read there.
+  // Otherwise a setup that is still in progress may store its engine after we
+  // have looked, and the engine would never be stopped. dispatch_sync() does
+  // not copy the block, so the block does not retain self while self is being
+  // deallocated.
+  dispatch_sync(self.audioQueue, ^{
+    [_audioEngine stop];
+  });
+  self.audioQueue = nil;
+
+  self.audioEngine = nil;
+  self.playStonePlayerNode = nil;
+  self.playStoneBuffer = nil;
   self.model = nil;
   [super dealloc];
 }
 
+#pragma mark - Audio engine
+
+// -----------------------------------------------------------------------------
+/// @brief Decodes the "play stone" sound file at @a playStoneURL into a PCM
+/// buffer and sets up the audio engine that plays the buffer.
+///
+/// When the sound is later played the audio engine's render thread only has to
+/// copy the already decoded samples, so there is no file access or decoding
+/// between the trigger and the sound becoming audible.
+///
+/// This is invoked on @e audioQueue.
+// -----------------------------------------------------------------------------
+- (void) setupAudioEngineWithPlayStoneURL:(NSURL*)playStoneURL
+{
+  // The ambient category mixes with audio from other apps and is silenced by
+  // the ring/silent switch, just like the system sound that was used before
+  NSError* error = nil;
+  if (! [[AVAudioSession sharedInstance] setCategory:AVAudioSessionCategoryAmbient error:&error])
+    DDLogWarn(@"%@: Failed to set audio session category, error = %@", self, error);
+
+  AVAudioFile* playStoneFile = playStoneURL ? [[[AVAudioFile alloc] initForReading:playStoneURL error:&error] autorelease] : nil;
+  if (! playStoneFile)
+  {
+    DDLogError(@"%@: Failed to open sound file %@, error = %@", self, playStoneSoundFileResource, error);
+    return;
+  }
+
+  AVAudioPCMBuffer* playStoneBuffer = [[[AVAudioPCMBuffer alloc] initWithPCMFormat:playStoneFile.processingFormat
+                                                                      frameCapacity:(AVAudioFrameCount)playStoneFile.length] autorelease];
+  if (! [playStoneFile readIntoBuffer:playStoneBuffer error:&error])
+  {
+    DDLogError(@"%@: Failed to decode sound file %@, error = %@", self, playStoneSoundFileResource, error);
+    return;
+  }
+
+  AVAudioEngine* audioEngine = [[[AVAudioEngine alloc] init] autorelease];
+  AVAudioPlayerNode* playStonePlayerNode = [[[AVAudioPlayerNode alloc] init] autorelease];
+  [audioEngine attachNode:playStonePlayerNode];
+  [audioEngine connect:playStonePlayerNode to:audioEngine.mainMixerNode format:playStoneBuffer.format];
+  [audioEngine prepare];
+
+  self.audioEngine = audioEngine;
+  self.playStonePlayerNode = playStonePlayerNode;
+  self.playStoneBuffer = playStoneBuffer;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Plays the "play stone" sound. Starts the audio engine if it is not
+/// yet running.
+///
+/// The audio engine is started on demand, and not when it is set up, so that
+/// the audio hardware is not kept busy if the user has turned sound off.
+///
+/// This is invoked on @e audioQueue.
+// -----------------------------------------------------------------------------
+- (void) playStoneSound
+{
+  if (! self.playStoneBuffer)
+    return;
+
+  if (! self.audioEngine.isRunning)
+  {
+    NSError* error = nil;
+    if (! [self.audioEngine startAndReturnError:&error])
+    {
+      DDLogError(@"%@: Failed to start audio engine, error = %@", self, error);
+      return;
+    }
+  }
+
+  // The buffer interrupts the sound of a previous move if that is still
+  // playing, so sounds of moves in quick succession do not queue up
+  [self.playStonePlayerNode scheduleBuffer:self.playStoneBuffer
+                                    atTime:nil
+                                   options:AVAudioPlayerNodeBufferInterrupts
+                         completionHandler:nil];
+  if (! self.playStonePlayerNode.isPlaying)
+    [self.playStonePlayerNode play];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Stops the audio engine, so that it does not keep the audio hardware
+/// busy while sound is disabled.
+///
+/// This is invoked on @e audioQueue.
+// -----------------------------------------------------------------------------
+- (void) stopAudioEngine
+{
+  [self.playStonePlayerNode stop];
+  [self.audioEngine stop];
+}
+
+#pragma mark - Notification responders
+
 // -----------------------------------------------------------------------------
 /// @brief Responds to the #computerPlayerThinkingStops notification.
 // -----------------------------------------------------------------------------
@@ -117,7 +240,41 @@
 
   if (self.model.playSound)
   {
-    AudioServicesPlaySystemSound(self.playStoneSystemSound);
+    dispatch_async(self.audioQueue, ^{
+      [self playStoneSound];
+    });
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the @e AVAudioEngineConfigurationChangeNotification
+/// notification.
+///
+/// The audio engine stops itself when the audio hardware configuration
+/// changes, e.g. when headphones are plugged in or out. The engine is started
+/// again on demand the next time that a sound needs to be played.
+// -----------------------------------------------------------------------------
+- (void) audioEngineConfigurationChange:(NSNotification*)notification
+{
+  dispatch_async(self.audioQueue, ^{
+    if (notification.object == self.audioEngine)
+      [self stopAudioEngine];
+  });
+}
+
+#pragma mark - Property accessors
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setDisabled:(bool)disabled
+{
+  _disabled = disabled;
+  if (disabled && self.audioQueue)
+  {
+    dispatch_async(self.audioQueue, ^{
+      [self stopAudioEngine];
+    });
   }
 }
 
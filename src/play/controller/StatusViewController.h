@@ -24,6 +24,10 @@
 /// the GTP engine is taking a long time to calculate something (e.g. computer
 /// player makes its move), the status view also displays an activity indicator.
 ///
+/// While the game is being played the status view also displays a live score
+/// estimate (see GoScoreEstimator). The estimate is calculated in the
+/// background whenever the current board position changes.
+///
 /// StatusViewController is a child view controller.
 // -----------------------------------------------------------------------------
 @interface StatusViewController : UIViewController
@@ -26,6 +26,7 @@
 #import "../../go/GoPlayer.h"
 #import "../../go/GoPoint.h"
 #import "../../go/GoScore.h"
+#import "../../go/GoScoreEstimator.h"
 #import "../../go/GoUtilities.h"
 #import "../../go/GoVertex.h"
 #import "../../main/ApplicationDelegate.h"
@@ -53,12 +54,15 @@
 @property(nonatomic, retain) UIActivityIndicatorView* activityIndicator;
 @property(nonatomic, assign) bool activityIndicatorNeedsUpdate;
 @property(nonatomic, assign) bool statusLabelNeedsUpdate;
+@property(nonatomic, assign) bool statusViewUpdateIsScheduled;
+@property(nonatomic, assign) CFTimeInterval previousStatusViewUpdateTimestamp;
 @property(nonatomic, retain) NSArray* stonePlacementInformation;
 @property(nonatomic, retain) NSArray* markupPlacementInformation;
 @property(nonatomic, retain) NSArray* selectionRectangleInformation;
 @property(nonatomic, assign) bool shouldDisplayActivityIndicator;
 @property(nonatomic, retain) NSLayoutConstraint* activityIndicatorWidthConstraint;
 @property(nonatomic, retain) NSLayoutConstraint* activityIndicatorSpacingConstraint;
+@property(nonatomic, retain) GoScoreEstimator* scoreEstimator;
 @end
 
 
@@ -82,9 +86,12 @@
   self.autoLayoutConstraintsAreSetup = false;
   self.activityIndicatorNeedsUpdate = false;
   self.statusLabelNeedsUpdate = false;
+  self.statusViewUpdateIsScheduled = false;
+  self.previousStatusViewUpdateTimestamp = 0;
   self.shouldDisplayActivityIndicator = false;
   self.activityIndicatorWidthConstraint = nil;
   self.activityIndicatorSpacingConstraint = nil;
+  self.scoreEstimator = [[[GoScoreEstimator alloc] init] autorelease];
   return self;
 }
 
@@ -95,6 +102,7 @@
 {
   [self removeNotificationResponders];
   [self releaseObjects];
+  self.scoreEstimator = nil;
   [super dealloc];
 }
 
@@ -131,6 +139,7 @@
   self.statusLabelNeedsUpdate = true;
   self.activityIndicatorNeedsUpdate = true;
   [self delayedUpdate];
+  [self updateScoreEstimate];
 }
 
 // -----------------------------------------------------------------------------
@@ -365,6 +374,13 @@
 // -----------------------------------------------------------------------------
 /// @brief Internal helper that correctly handles delayed updates. See class
 /// documentation for details.
+///
+/// Updates are coalesced: The status view is not updated immediately, instead
+/// a single update is scheduled that evaluates the inputs that are current at
+/// the time when the update is performed. The update is scheduled no earlier
+/// than one frame after the previous update, so that rapid changes (e.g. while
+/// the user pans a stone across the board, or navigates through many board
+/// positions) do not cause more than one update per frame.
 // -----------------------------------------------------------------------------
 - (void) delayedUpdate
 {
@@ -375,9 +391,58 @@
     [self performSelectorOnMainThread:@selector(delayedUpdate) withObject:nil waitUntilDone:YES];
     return;
   }
+  if (self.statusViewUpdateIsScheduled)
+    return;
+  self.statusViewUpdateIsScheduled = true;
+
+  static const CFTimeInterval minimumUpdateInterval = 1.0 / 60.0;
+  CFTimeInterval timeSincePreviousUpdate = CACurrentMediaTime() - self.previousStatusViewUpdateTimestamp;
+  NSTimeInterval delay = MAX(0.0, minimumUpdateInterval - timeSincePreviousUpdate);
+  [self performSelector:@selector(scheduledUpdateStatusView) withObject:nil afterDelay:delay];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Performs the update scheduled by delayedUpdate().
+// -----------------------------------------------------------------------------
+- (void) scheduledUpdateStatusView
+{
+  self.statusViewUpdateIsScheduled = false;
+  // If a long-running action started in the meantime, the update is performed
+  // when the action ends
+  if ([LongRunningActionCounter sharedCounter].counter > 0)
+    return;
+  self.previousStatusViewUpdateTimestamp = CACurrentMediaTime();
   [self updateStatusView];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Starts calculating a new score estimate for the current board
+/// position. The status label is updated when the estimate is available.
+///
+/// The estimate is calculated in the background, so this does not delay move
+/// entry. While a long-running action is in progress (e.g. a game is being
+/// loaded) no estimate is calculated, instead a single estimate is calculated
+/// when the long-running action ends.
+// -----------------------------------------------------------------------------
+- (void) updateScoreEstimate
+{
+  if ([LongRunningActionCounter sharedCounter].counter > 0)
+    return;
+  if ([NSThread currentThread] != [NSThread mainThread])
+  {
+    [self performSelectorOnMainThread:@selector(updateScoreEstimate) withObject:nil waitUntilDone:NO];
+    return;
+  }
+  GoGame* game = [GoGame sharedGame];
+  if (! game)
+    return;
+  [self.scoreEstimator updateEstimateForGame:game completionHandler:^(void)
+  {
+    self.statusLabelNeedsUpdate = true;
+    [self delayedUpdate];
+  }];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Updates the status view with text that provides feedback to the user
 /// about what's going on. Also starts/stops animating the activity indicator.
@@ -627,6 +692,9 @@
             (GoGameStateGameHasEnded == gameState && [GoUtilities nodeWithNextMoveExists:game.boardPosition.currentNode inCurrentGameVariation:game]))
         {
           statusText = [self statusTextForMostRecentAndNextMove:game];
+          NSString* estimateString = self.scoreEstimator.estimateString;
+          if (estimateString)
+            statusText = [NSString stringWithFormat:@"%@ - Estimate: %@", statusText, estimateString];
         }
         else if (GoGameStateGameHasEnded == gameState)
         {
@@ -635,7 +703,10 @@
       }
     }
   }
-  self.statusLabel.text = statusText;
+  // Setting the text invalidates the label's layout even if the text is the
+  // same
+  if (! [self.statusLabel.text isEqualToString:statusText])
+    self.statusLabel.text = statusText;
 }
 
 // -----------------------------------------------------------------------------
@@ -798,6 +869,7 @@
   // initial state
   self.statusLabelNeedsUpdate = true;
   [self delayedUpdate];
+  [self updateScoreEstimate];
 }
 
 // -----------------------------------------------------------------------------
@@ -864,8 +936,9 @@
 - (void) askGtpEngineForDeadStonesEnds:(NSNotification*)notification
 {
   self.activityIndicatorNeedsUpdate = true;
-  // No label update here, the "scoring in progress..." message must remain
-  // until goScoreCalculationEnds is received.
+  // No label update here, the label depends only on whether a score
+  // calculation is in progress. The query does not block score calculation,
+  // so the label usually already displays the geometric score.
   [self delayedUpdate];
 }
 
@@ -918,6 +991,7 @@
 {
   self.statusLabelNeedsUpdate = true;
   [self delayedUpdate];
+  [self updateScoreEstimate];
 }
 
 // -----------------------------------------------------------------------------
@@ -941,6 +1015,7 @@
 - (void) longRunningActionEnds:(NSNotification*)notification
 {
   [self delayedUpdate];
+  [self updateScoreEstimate];
 }
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoGame;
+@class VariationComparisonController;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The VariationComparisonControllerDelegate protocol must be
+/// implemented by the delegate of VariationComparisonController.
+// -----------------------------------------------------------------------------
+@protocol VariationComparisonControllerDelegate
+/// @brief This method is invoked when the user has finished working with
+/// @a controller. The implementation is responsible for dismissing
+/// @a controller.
+- (void) variationComparisonControllerDidFinish:(VariationComparisonController*)controller;
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief The VariationComparisonController class is responsible for showing
+/// up to four game variations side by side, each on a small board.
+///
+/// The variations that are compared are the child nodes of a branching node,
+/// i.e. the alternatives that the game tree contains at one point of the
+/// game. nodesToCompareInGame:() finds the branching node that is closest to
+/// the current board position. Depending on the number of variations
+/// VariationComparisonController shows two panels side by side, or four
+/// panels in a 2x2 grid. If there are more than four variations, only the
+/// first four are shown.
+///
+/// Initially each panel shows the last board position of its variation. The
+/// user can step all panels back and forth in unison. A panel whose variation
+/// has no more board positions keeps showing its last board position.
+///
+/// Comparing variations does not change the current board position of
+/// GoBoardPosition and therefore does not synchronize the GTP engine. The
+/// stones of each board position are determined with GoBoardPositionPreview
+/// and are captured in an immutable BoardDiagram when the controller is
+/// created. Stepping back and forth only exchanges the diagrams, so a panel
+/// update costs only drawing. The panels are BoardDiagramView objects, which
+/// share the layers of the board and the stones in BoardViewCGLayerCache.
+/// Once created, VariationComparisonController is independent of the Go
+/// model, i.e. it keeps showing the variations as they were even if the game
+/// continues in the meantime (e.g. in a computer vs. computer game).
+// -----------------------------------------------------------------------------
+@interface VariationComparisonController : UIViewController
+{
+}
+
++ (NSArray*) nodesToCompareInGame:(GoGame*)game;
++ (VariationComparisonController*) controllerWithGame:(GoGame*)game
+                                                nodes:(NSArray*)nodes
+                                             delegate:(id<VariationComparisonControllerDelegate>)delegate;
+
+/// @brief This is the delegate that will be informed when the user has
+/// finished comparing variations.
+@property(nonatomic, assign) id<VariationComparisonControllerDelegate> delegate;
+
+@end
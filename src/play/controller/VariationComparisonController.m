@@ -0,0 +1,387 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Project includes
+#import "VariationComparisonController.h"
+#import "../boardview/BoardDiagram.h"
+#import "../boardview/BoardDiagramView.h"
+#import "../../go/GoBoard.h"
+#import "../../go/GoBoardPosition.h"
+#import "../../go/GoBoardPositionPreview.h"
+#import "../../go/GoGame.h"
+#import "../../go/GoMove.h"
+#import "../../go/GoNode.h"
+#import "../../go/GoPlayer.h"
+#import "../../go/GoPoint.h"
+#import "../../go/GoVertex.h"
+#import "../../ui/AutoLayoutUtility.h"
+#import "../../utility/NSStringAdditions.h"
+
+
+/// @brief The maximum number of variations that are compared.
+static const int maximumNumberOfPanels = 4;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// VariationComparisonController.
+// -----------------------------------------------------------------------------
+@interface VariationComparisonController()
+/// @brief One NSArray per panel, with the BoardDiagram objects of all board
+/// positions of the panel's variation.
+@property(nonatomic, retain) NSArray* panelDiagrams;
+/// @brief One NSArray per panel, with the titles of all board positions of the
+/// panel's variation.
+@property(nonatomic, retain) NSArray* panelTitles;
+/// @brief The number of board positions of the longest variation.
+@property(nonatomic, assign) int numberOfSteps;
+/// @brief The board position that the panels show, counting from the first
+/// node of each variation.
+@property(nonatomic, assign) int currentStep;
+@property(nonatomic, retain) NSArray* diagramViews;
+@property(nonatomic, retain) NSArray* titleLabels;
+@property(nonatomic, retain) UIBarButtonItem* backButton;
+@property(nonatomic, retain) UIBarButtonItem* forwardButton;
+@end
+
+
+@implementation VariationComparisonController
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the nodes whose variations should be compared in @a game,
+/// or nil if the game tree has no variations that can be compared.
+///
+/// The nodes are the child nodes of the branching node that is closest to the
+/// current board position, searching from the current node towards the root
+/// node. At most four nodes are returned.
+// -----------------------------------------------------------------------------
++ (NSArray*) nodesToCompareInGame:(GoGame*)game
+{
+  GoNode* branchingNode = game.boardPosition.currentNode;
+  while (branchingNode && ! branchingNode.isBranchingNode)
+    branchingNode = branchingNode.parent;
+  if (! branchingNode)
+    return nil;
+
+  NSArray* children = branchingNode.children;
+  if (children.count > maximumNumberOfPanels)
+    children = [children subarrayWithRange:NSMakeRange(0, maximumNumberOfPanels)];
+  return children;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a VariationComparisonController
+/// instance that compares the variations of @a game that start with the
+/// nodes in @a nodes. Each variation follows the first child nodes from its
+/// start node down to a leaf node.
+// -----------------------------------------------------------------------------
++ (VariationComparisonController*) controllerWithGame:(GoGame*)game
+                                                nodes:(NSArray*)nodes
+                                             delegate:(id<VariationComparisonControllerDelegate>)delegate
+{
+  VariationComparisonController* controller = [[VariationComparisonController alloc] initWithGame:game
+                                                                                             nodes:nodes
+                                                                                          delegate:delegate];
+  if (controller)
+    [controller autorelease];
+  return controller;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a VariationComparisonController object. See
+/// controllerWithGame:nodes:delegate:() for details.
+///
+/// @note This is the designated initializer of VariationComparisonController.
+// -----------------------------------------------------------------------------
+- (id) initWithGame:(GoGame*)game nodes:(NSArray*)nodes delegate:(id<VariationComparisonControllerDelegate>)delegate
+{
+  // Call designated initializer of superclass (UIViewController)
+  self = [super initWithNibName:nil bundle:nil];
+  if (! self)
+    return nil;
+
+  self.delegate = delegate;
+  self.diagramViews = nil;
+  self.titleLabels = nil;
+  self.backButton = nil;
+  self.forwardButton = nil;
+  [self setupDiagramsWithGame:game nodes:nodes];
+  self.currentStep = self.numberOfSteps - 1;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this VariationComparisonController
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.delegate = nil;
+  self.panelDiagrams = nil;
+  self.panelTitles = nil;
+  self.diagramViews = nil;
+  self.titleLabels = nil;
+  self.backButton = nil;
+  self.forwardButton = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the initializer. Captures the board positions of
+/// all variations in BoardDiagram objects.
+// -----------------------------------------------------------------------------
+- (void) setupDiagramsWithGame:(GoGame*)game nodes:(NSArray*)nodes
+{
+  GoBoardPositionPreview* preview = [[[GoBoardPositionPreview alloc] initWithGame:game] autorelease];
+  GoBoardTopology* topology = game.board.topology;
+
+  NSMutableArray* panelDiagrams = [NSMutableArray array];
+  NSMutableArray* panelTitles = [NSMutableArray array];
+  int numberOfSteps = 0;
+
+  for (GoNode* firstNode in nodes)
+  {
+    NSString* variationName = [self variationNameWithFirstNode:firstNode index:(int)panelDiagrams.count];
+    NSMutableArray* diagrams = [NSMutableArray array];
+    NSMutableArray* titles = [NSMutableArray array];
+    for (GoNode* node = firstNode; node; node = node.firstChild)
+    {
+      BoardDiagram* diagram = [[[BoardDiagram alloc] initWithNode:node
+                                                      stoneStates:[preview stoneStatesAtNode:node]
+                                                         topology:topology] autorelease];
+      [diagrams addObject:diagram];
+
+      GoMove* mostRecentMove = node.nodeWithMostRecentMove.goMove;
+      int moveNumber = mostRecentMove ? mostRecentMove.moveNumber : 0;
+      [titles addObject:[NSString stringWithFormat:@"%@ - Move %d", variationName, moveNumber]];
+    }
+
+    [panelDiagrams addObject:diagrams];
+    [panelTitles addObject:titles];
+    numberOfSteps = MAX(numberOfSteps, (int)diagrams.count);
+  }
+
+  self.panelDiagrams = panelDiagrams;
+  self.panelTitles = panelTitles;
+  self.numberOfSteps = numberOfSteps;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for setupDiagramsWithGame:nodes:(). Returns the
+/// name of the variation that starts with @a firstNode and that is shown in
+/// the panel with index @a index.
+// -----------------------------------------------------------------------------
+- (NSString*) variationNameWithFirstNode:(GoNode*)firstNode index:(int)index
+{
+  NSString* variationNumber = [NSString stringWithFormat:@"%d.", index + 1];
+  GoMove* move = firstNode.goMove;
+  if (! move)
+    return variationNumber;
+
+  NSString* colorName = [NSString stringWithGoColor:(move.player.isBlack ? GoColorBlack : GoColorWhite)];
+  if (move.type == GoMoveTypePlay)
+    return [NSString stringWithFormat:@"%@ %@ %@", variationNumber, colorName, move.point.vertex.string];
+  else
+    return [NSString stringWithFormat:@"%@ %@ passes", variationNumber, colorName];
+}
+
+#pragma mark - UIViewController overrides
+
+// -----------------------------------------------------------------------------
+/// @brief UIViewController method.
+// -----------------------------------------------------------------------------
+- (void) loadView
+{
+  [super loadView];
+
+  self.view.backgroundColor = [UIColor systemGroupedBackgroundColor];
+
+  NSMutableArray* diagramViews = [NSMutableArray array];
+  NSMutableArray* titleLabels = [NSMutableArray array];
+  // Three variations are shown in a 2x2 grid with one empty panel
+  NSUInteger numberOfPanels = (self.panelDiagrams.count <= 2) ? 2 : maximumNumberOfPanels;
+  for (NSUInteger indexOfPanel = 0; indexOfPanel < numberOfPanels; ++indexOfPanel)
+  {
+    BoardDiagramView* diagramView = [[[BoardDiagramView alloc] initWithFrame:CGRectZero] autorelease];
+    [self.view addSubview:diagramView];
+    [diagramViews addObject:diagramView];
+
+    UILabel* titleLabel = [[[UILabel alloc] initWithFrame:CGRectZero] autorelease];
+    titleLabel.textAlignment = NSTextAlignmentCenter;
+    titleLabel.font = [UIFont preferredFontForTextStyle:UIFontTextStyleFootnote];
+    titleLabel.adjustsFontSizeToFitWidth = YES;
+    [self.view addSubview:titleLabel];
+    [titleLabels addObject:titleLabel];
+  }
+  self.diagramViews = diagramViews;
+  self.titleLabels = titleLabels;
+
+  [self updatePanels];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief UIViewController method.
+// -----------------------------------------------------------------------------
+- (void) viewDidLoad
+{
+  [super viewDidLoad];
+
+  self.navigationItem.title = @"Compare variations";
+  self.backButton = [[[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemRewind
+                                                                   target:self
+                                                                   action:@selector(back:)] autorelease];
+  self.forwardButton = [[[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemFastForward
+                                                                      target:self
+                                                                      action:@selector(forward:)] autorelease];
+  self.navigationItem.leftBarButtonItems = @[self.backButton, self.forwardButton];
+  self.navigationItem.rightBarButtonItem = [[[UIBarButtonItem alloc] initWithBarButtonSystemItem:UIBarButtonSystemItemDone
+                                                                                          target:self
+                                                                                          action:@selector(done:)] autorelease];
+  [self updateButtons];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief UIViewController method.
+///
+/// Two panels are laid out side by side if the view is wider than it is high,
+/// otherwise one above the other. Four panels are laid out in a 2x2 grid.
+// -----------------------------------------------------------------------------
+- (void) viewDidLayoutSubviews
+{
+  [super viewDidLayoutSubviews];
+
+  CGRect layoutFrame = self.view.safeAreaLayoutGuide.layoutFrame;
+  CGFloat spacing = [AutoLayoutUtility horizontalSpacingSiblings];
+  layoutFrame = CGRectInset(layoutFrame, spacing, spacing);
+
+  NSUInteger numberOfPanels = self.diagramViews.count;
+  int numberOfColumns;
+  int numberOfRows;
+  if (numberOfPanels > 2)
+  {
+    numberOfColumns = 2;
+    numberOfRows = 2;
+  }
+  else if (layoutFrame.size.width >= layoutFrame.size.height)
+  {
+    numberOfColumns = 2;
+    numberOfRows = 1;
+  }
+  else
+  {
+    numberOfColumns = 1;
+    numberOfRows = 2;
+  }
+
+  CGFloat panelWidth = (layoutFrame.size.width - (numberOfColumns - 1) * spacing) / numberOfColumns;
+  CGFloat panelHeight = (layoutFrame.size.height - (numberOfRows - 1) * spacing) / numberOfRows;
+  CGFloat titleHeight = ceil([UIFont preferredFontForTextStyle:UIFontTextStyleFootnote].lineHeight);
+
+  for (NSUInteger indexOfPanel = 0; indexOfPanel < numberOfPanels; ++indexOfPanel)
+  {
+    int column = (int)indexOfPanel % numberOfColumns;
+    int row = (int)indexOfPanel / numberOfColumns;
+    CGRect panelFrame = CGRectMake(layoutFrame.origin.x + column * (panelWidth + spacing),
+                                   layoutFrame.origin.y + row * (panelHeight + spacing),
+                                   panelWidth,
+                                   panelHeight);
+    CGRect titleFrame;
+    CGRect diagramFrame;
+    CGRectDivide(panelFrame, &titleFrame, &diagramFrame, titleHeight, CGRectMinYEdge);
+
+    UILabel* titleLabel = self.titleLabels[indexOfPanel];
+    titleLabel.frame = titleFrame;
+    BoardDiagramView* diagramView = self.diagramViews[indexOfPanel];
+    diagramView.frame = diagramFrame;
+  }
+}
+
+#pragma mark - Action handlers
+
+// -----------------------------------------------------------------------------
+/// @brief Steps all panels one board position back.
+// -----------------------------------------------------------------------------
+- (void) back:(id)sender
+{
+  if (self.currentStep <= 0)
+    return;
+  self.currentStep--;
+  [self updatePanels];
+  [self updateButtons];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Steps all panels one board position forward.
+// -----------------------------------------------------------------------------
+- (void) forward:(id)sender
+{
+  if (self.currentStep >= self.numberOfSteps - 1)
+    return;
+  self.currentStep++;
+  [self updatePanels];
+  [self updateButtons];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Informs the delegate that the user has finished comparing
+/// variations.
+// -----------------------------------------------------------------------------
+- (void) done:(id)sender
+{
+  [self.delegate variationComparisonControllerDidFinish:self];
+}
+
+#pragma mark - Updaters
+
+// -----------------------------------------------------------------------------
+/// @brief Shows the diagrams of the current step in all panels.
+// -----------------------------------------------------------------------------
+- (void) updatePanels
+{
+  NSUInteger numberOfPanels = self.diagramViews.count;
+  for (NSUInteger indexOfPanel = 0; indexOfPanel < numberOfPanels; ++indexOfPanel)
+  {
+    BoardDiagramView* diagramView = self.diagramViews[indexOfPanel];
+    UILabel* titleLabel = self.titleLabels[indexOfPanel];
+    if (indexOfPanel >= self.panelDiagrams.count)
+    {
+      diagramView.boardDiagram = nil;
+      titleLabel.text = nil;
+      continue;
+    }
+
+    NSArray* diagrams = self.panelDiagrams[indexOfPanel];
+    NSArray* titles = self.panelTitles[indexOfPanel];
+    NSUInteger indexOfDiagram = MIN((NSUInteger)self.currentStep, diagrams.count - 1);
+    diagramView.boardDiagram = diagrams[indexOfDiagram];
+    titleLabel.text = titles[indexOfDiagram];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Updates the enabled state of the buttons that step through the
+/// board positions.
+// -----------------------------------------------------------------------------
+- (void) updateButtons
+{
+  self.backButton.enabled = (self.currentStep > 0) ? YES : NO;
+  self.forwardButton.enabled = (self.currentStep < self.numberOfSteps - 1) ? YES : NO;
+}
+
+@end
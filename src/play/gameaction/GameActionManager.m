@@ -63,6 +63,7 @@
 @property(nonatomic, assign) bool visibleStatesNeedUpdate;
 @property(nonatomic, assign) bool enabledStatesNeedUpdate;
 @property(nonatomic, assign) bool scoringModeNeedUpdate;
+@property(nonatomic, assign) bool gameActionStatesUpdateIsScheduled;
 @property(nonatomic, assign) bool gameVariationChangeInProgress;
 @property(nonatomic, assign) GameInfoViewController* gameInfoViewController;
 @property(nonatomic, retain) MoreGameActionsController* moreGameActionsController;
@@ -130,6 +131,7 @@ static GameActionManager* sharedGameActionManager = nil;
   self.visibleStatesNeedUpdate = false;
   self.enabledStatesNeedUpdate = false;
   self.scoringModeNeedUpdate = false;
+  self.gameActionStatesUpdateIsScheduled = false;
   self.gameVariationChangeInProgress = false;
   self.gameInfoViewController = nil;
   self.moreGameActionsController = nil;
@@ -1025,6 +1027,14 @@ static GameActionManager* sharedGameActionManager = nil;
 // -----------------------------------------------------------------------------
 /// @brief Internal helper that correctly handles delayed updates. See class
 /// documentation for details.
+///
+/// A single user action often posts several of the notifications observed by
+/// GameActionManager. Visible and enabled states are therefore not updated
+/// immediately. Instead an update is scheduled to run once at the end of the
+/// current run loop iteration, when all notifications have been processed.
+/// The "need update" flags set by the notification responders determine which
+/// states are then evaluated. Scoring mode is a change in application state
+/// rather than in UI state, so it is still updated immediately.
 // -----------------------------------------------------------------------------
 - (void) delayedUpdate
 {
@@ -1035,9 +1045,28 @@ static GameActionManager* sharedGameActionManager = nil;
     [self performSelectorOnMainThread:@selector(delayedUpdate) withObject:nil waitUntilDone:YES];
     return;
   }
+  [self updateScoringMode];
+
+  if (self.gameActionStatesUpdateIsScheduled)
+    return;
+  if (! self.visibleStatesNeedUpdate && ! self.enabledStatesNeedUpdate)
+    return;
+  self.gameActionStatesUpdateIsScheduled = true;
+  [self performSelector:@selector(scheduledUpdateGameActionStates) withObject:nil afterDelay:0];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Performs the update scheduled by delayedUpdate().
+// -----------------------------------------------------------------------------
+- (void) scheduledUpdateGameActionStates
+{
+  self.gameActionStatesUpdateIsScheduled = false;
+  // If a long-running action started in the meantime, the update is performed
+  // when the action ends
+  if ([LongRunningActionCounter sharedCounter].counter > 0)
+    return;
   [self updateVisibleStates];
   [self updateEnabledStates];
-  [self updateScoringMode];
 }
 
 #pragma mark - Game action visibility updating
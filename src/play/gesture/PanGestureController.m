@@ -29,6 +29,7 @@
 #import "../../main/MainUtility.h"
 #import "../../main/MagnifyingGlassOwner.h"
 #import "../../shared/LayoutManager.h"
+#import "../../shared/ModelChangeObserver.h"
 #import "../../ui/MagnifyingViewModel.h"
 #import "../../ui/UiSettingsModel.h"
 #import "../../utility/ExceptionUtility.h"
@@ -37,7 +38,7 @@
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for PanGestureController.
 // -----------------------------------------------------------------------------
-@interface PanGestureController()
+@interface PanGestureController() <ModelChangeObserverDelegate>
 @property(nonatomic, retain) UILongPressGestureRecognizer* longPressRecognizer;
 @property(nonatomic, assign, getter=isPanningEnabled) bool panningEnabled;
 /// @brief The GoPoint that identifies the intersection from which the panning
@@ -57,6 +58,7 @@
 /// @brief An object that is handling pan gestures for the current application
 /// state.
 @property(nonatomic, retain) PanGestureHandler* panGestureHandler;
+@property(nonatomic, retain) ModelChangeObserver* modelChangeObserver;
 @end
 
 
@@ -130,9 +132,10 @@
   [center addObserver:self selector:@selector(boardViewAnimationWillBegin:) name:boardViewAnimationWillBegin object:nil];
   [center addObserver:self selector:@selector(boardViewAnimationDidEnd:) name:boardViewAnimationDidEnd object:nil];
   [center addObserver:self selector:@selector(currentBoardPositionDidChange:) name:currentBoardPositionDidChange object:nil];
-  // KVO observing
+  // Model changes are delivered in batches, once per run loop cycle
   ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
-  [appDelegate.markupModel addObserver:self forKeyPath:@"markupTool" options:0 context:NULL];
+  self.modelChangeObserver = [[[ModelChangeObserver alloc] initWithDelegate:self] autorelease];
+  [self.modelChangeObserver observeKeyPath:@"markupTool" ofObject:appDelegate.markupModel];
 }
 
 // -----------------------------------------------------------------------------
@@ -141,8 +144,8 @@
 - (void) removeNotificationResponders
 {
   [[NSNotificationCenter defaultCenter] removeObserver:self];
-  ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
-  [appDelegate.markupModel removeObserver:self forKeyPath:@"markupTool"];
+  [self.modelChangeObserver stopObserving];
+  self.modelChangeObserver = nil;
 }
 
 #pragma mark - Property setter
@@ -381,12 +384,15 @@
   [self updatePanningEnabled];
 }
 
+#pragma mark - ModelChangeObserverDelegate overrides
+
 // -----------------------------------------------------------------------------
-/// @brief Responds to KVO notifications.
+/// @brief ModelChangeObserverDelegate method.
 // -----------------------------------------------------------------------------
-- (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet
 {
-  if ([keyPath isEqualToString:@"markupTool"])
+  ApplicationDelegate* appDelegate = [ApplicationDelegate sharedDelegate];
+  if ([changeSet containsChangeOfKeyPath:@"markupTool" ofObject:appDelegate.markupModel])
   {
     [self cancelPanningInProgress];
     [self updatePanningEnabled];
@@ -29,6 +29,7 @@
 #import "../../../go/GoPoint.h"
 #import "../../../go/GoUtilities.h"
 #import "../../../go/GoVertex.h"
+#import "../../../shared/MarkupEditingTransaction.h"
 #import "../../../utility/MarkupUtilities.h"
 
 
@@ -161,6 +162,12 @@ NS_ASSUME_NONNULL_BEGIN
 {
   [self findMarkupToMoveOnGestureStartPoint:gestureStartPoint];
 
+  // All markup changes made while the gesture is in progress are grouped into
+  // a single transaction, which is committed when the gesture ends or is
+  // canceled. This results in a single #nodeMarkupDataDidChange notification,
+  // game backup and save point for the entire gesture.
+  [[MarkupEditingTransaction sharedTransaction] begin];
+
   // An optimization idea that was not implemented was to do the temporary
   // removal only when the gesture moves away from the gesture start point.
   // The idea was abandoned when it turned out that the drawing logic in
@@ -328,6 +335,26 @@ NS_ASSUME_NONNULL_BEGIN
 - (void) handleGestureEndedWithGestureRecognizerState:(UIGestureRecognizerState)recognizerState
                                     gestureStartPoint:(GoPoint*)gestureStartPoint
                                   gestureCurrentPoint:(nullable GoPoint*)gestureCurrentPoint
+{
+  @try
+  {
+    [self placeOrRestoreMarkupWithGestureRecognizerState:recognizerState
+                                       gestureStartPoint:gestureStartPoint
+                                     gestureCurrentPoint:gestureCurrentPoint];
+  }
+  @finally
+  {
+    [[MarkupEditingTransaction sharedTransaction] commit];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// handleGestureEndedWithGestureRecognizerState:gestureStartPoint:gestureCurrentPoint:().
+// -----------------------------------------------------------------------------
+- (void) placeOrRestoreMarkupWithGestureRecognizerState:(UIGestureRecognizerState)recognizerState
+                                      gestureStartPoint:(GoPoint*)gestureStartPoint
+                                    gestureCurrentPoint:(nullable GoPoint*)gestureCurrentPoint
 {
   switch (self.markupCategoryToMove)
   {
@@ -414,7 +441,7 @@ NS_ASSUME_NONNULL_BEGIN
 
   NSArray* pointsWithChangedMarkup = @[gestureStartPoint];
   [center postNotificationName:markupOnPointsDidChange object:pointsWithChangedMarkup];
-  [center postNotificationName:nodeMarkupDataDidChange object:node];
+  [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
 }
 
 // -----------------------------------------------------------------------------
@@ -445,7 +472,7 @@ NS_ASSUME_NONNULL_BEGIN
     [center postNotificationName:markupOnPointsDidChange object:pointsWithChangedMarkup];
 
     GoNode* node = [self currentNode];
-    [center postNotificationName:nodeMarkupDataDidChange object:node];
+    [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
   }
 }
 
@@ -534,7 +561,7 @@ NS_ASSUME_NONNULL_BEGIN
   NSArray* pointsWithChangedMarkup = @[self.connectionToMoveStartPoint, self.connectionToMoveEndPoint, pointsInConnectionRectangle];
   [center postNotificationName:markupOnPointsDidChange object:pointsWithChangedMarkup];
 
-  [center postNotificationName:nodeMarkupDataDidChange object:node];
+  [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
 }
 
 // -----------------------------------------------------------------------------
@@ -582,7 +609,7 @@ NS_ASSUME_NONNULL_BEGIN
     [center postNotificationName:markupOnPointsDidChange object:pointsWithChangedMarkup];
 
     GoNode* node = [self currentNode];
-    [center postNotificationName:nodeMarkupDataDidChange object:node];
+    [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
   }
 }
 
@@ -632,7 +659,7 @@ NS_ASSUME_NONNULL_BEGIN
   NSArray* pointsWithChangedMarkup = @[gestureStartPoint, [NSNumber numberWithInt:label]];
   [center postNotificationName:markupOnPointsDidChange object:pointsWithChangedMarkup];
 
-  [center postNotificationName:nodeMarkupDataDidChange object:node];
+  [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
 }
 
 // -----------------------------------------------------------------------------
@@ -665,7 +692,7 @@ NS_ASSUME_NONNULL_BEGIN
     [center postNotificationName:markupOnPointsDidChange object:pointsWithChangedMarkup];
 
     GoNode* node = [self currentNode];
-    [center postNotificationName:nodeMarkupDataDidChange object:node];
+    [[MarkupEditingTransaction sharedTransaction] nodeMarkupDataDidChange:node];
   }
 }
 
@@ -20,6 +20,8 @@
 #import "../../boardview/BoardView.h"
 #import "../../gameaction/GameActionManager.h"
 #import "../../../go/GoGame.h"
+#import "../../../go/GoPoint.h"
+#import "../../../go/GoVertex.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
@@ -84,7 +86,17 @@ NS_ASSUME_NONNULL_BEGIN
   bool isLegalMove = false;
   enum GoMoveIsIllegalReason illegalReason = GoMoveIsIllegalReasonUnknown;
   if (gestureCurrentPoint)
-    isLegalMove = [[GoGame sharedGame] isLegalMove:gestureCurrentPoint isIllegalReason:&illegalReason];
+  {
+    // The legal move map is cached, so the legality of the intersections is
+    // determined only once for the entire gesture, not for every intersection
+    // that the gesture crosses
+    GoGame* game = [GoGame sharedGame];
+    NSDictionary* legalMoveMap = [game legalMoveMapForColor:game.nextMoveColor];
+    NSNumber* illegalReasonAsNumber = [legalMoveMap objectForKey:gestureCurrentPoint.vertex.string];
+    isLegalMove = (illegalReasonAsNumber == nil);
+    if (! isLegalMove)
+      illegalReason = [illegalReasonAsNumber intValue];
+  }
 
   if (recognizerState == UIGestureRecognizerStateEnded || recognizerState == UIGestureRecognizerStateCancelled)
   {
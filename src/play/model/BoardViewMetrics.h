@@ -396,6 +396,10 @@
 @property(nonatomic, retain) UIColor* connectionStrokeColor;
 @property(nonatomic, retain) NSShadow* whiteTextShadow;
 @property(nonatomic, assign) bool useImageFilesToDrawStones;
+/// @brief True if stones are displayed by layer sprites that are composited
+/// by the GPU (see StoneSpritesLayerDelegate), false if stones are drawn with
+/// Core Graphics (see StonesLayerDelegate).
+@property(nonatomic, assign) bool useLayerSpritesToDrawStones;
 //@}
 
 @end
@@ -32,6 +32,17 @@
 /// @brief Class extension with private properties for BoardViewMetrics.
 // -----------------------------------------------------------------------------
 @interface BoardViewMetrics()
+{
+@private
+  /// @brief Lookup table with the view coordinates of all intersections on a
+  /// board with size @e _pointCoordinatesTableBoardSize. The table is indexed
+  /// by point index, i.e. the intersection at vertex A1 has index 0, the
+  /// intersection to the right of A1 has index 1, and so on, row by row.
+  CGPoint _pointCoordinatesTable[GoBoardSizeMax * GoBoardSizeMax];
+  /// @brief The board size for which @e _pointCoordinatesTable was
+  /// calculated. #GoBoardSizeUndefined if the table is empty.
+  enum GoBoardSize _pointCoordinatesTableBoardSize;
+}
 @property(nonatomic, retain) FontRange* moveNumberFontRange;
 @property(nonatomic, retain) FontRange* coordinateLabelFontRange;
 @property(nonatomic, retain) FontRange* markupLetterMarkerFontRange;
@@ -150,6 +161,7 @@
   self.whiteTextShadow.shadowBlurRadius = 5.0;
   self.whiteTextShadow.shadowOffset = CGSizeMake(1.0, 1.0);
   self.useImageFilesToDrawStones = false;
+  self.useLayerSpritesToDrawStones = false;
 }
 
 // -----------------------------------------------------------------------------
@@ -400,6 +412,7 @@
     self.topLeftPointY = self.topLeftBoardCornerY;
     self.bottomRightPointX = self.topLeftPointX;
     self.bottomRightPointY = self.topLeftPointY;
+    _pointCoordinatesTableBoardSize = GoBoardSizeUndefined;
   }
   else
   {
@@ -550,6 +563,7 @@
     self.topLeftPointY = self.topLeftBoardCornerY + topLeftPointOffset;
     self.bottomRightPointX = self.topLeftPointX + (newBoardSize - 1) * self.pointDistance;
     self.bottomRightPointY = self.topLeftPointY + (newBoardSize - 1) * self.pointDistance;
+    [self updatePointCoordinatesTableWithBoardSize:newBoardSize];
 
     // Calculate self.pointCellSize. See property documentation for details
     // what we calculate here.
@@ -681,6 +695,8 @@
 - (CGPoint) coordinatesFromPoint:(GoPoint*)point withBoardSize:(enum GoBoardSize)boardSize
 {
   struct GoVertexNumeric numericVertex = point.vertex.numeric;
+  if (boardSize == _pointCoordinatesTableBoardSize)
+    return _pointCoordinatesTable[(numericVertex.y - 1) * boardSize + (numericVertex.x - 1)];
   return CGPointMake(self.topLeftPointX + (self.pointDistance * (numericVertex.x - 1)),
                      self.topLeftPointY + (self.pointDistance * (boardSize - numericVertex.y)));
 }
@@ -696,19 +712,14 @@
 // -----------------------------------------------------------------------------
 - (GoPoint*) pointFromCoordinates:(CGPoint)coordinates
 {
+  if (0 == self.pointDistance)
+    return nil;
   struct GoVertexNumeric numericVertex;
   numericVertex.x = 1 + (coordinates.x - self.topLeftPointX) / self.pointDistance;
   numericVertex.y = self.boardSize - (coordinates.y - self.topLeftPointY) / self.pointDistance;
-  GoVertex* vertex;
-  @try
-  {
-    vertex = [GoVertex vertexFromNumeric:numericVertex];
-  }
-  @catch (NSException* exception)
-  {
-    return nil;
-  }
-  return [[GoGame sharedGame].board pointAtVertex:vertex.string];
+  // GoBoard performs the range check and looks up the GoPoint object by
+  // index, so there is no need to create a GoVertex object
+  return [[GoGame sharedGame].board pointAtNumericVertex:numericVertex];
 }
 
 // -----------------------------------------------------------------------------
@@ -785,14 +796,18 @@
     return BoardViewIntersectionNull;
   else
   {
-    coordinates.x = (self.topLeftPointX
-                     + self.pointDistance * floor((coordinates.x - self.topLeftPointX) / self.pointDistance));
-    coordinates.y = (self.topLeftPointY
-                     + self.pointDistance * floor((coordinates.y - self.topLeftPointY) / self.pointDistance));
-    GoPoint* pointAtCoordinates = [self pointFromCoordinates:coordinates];
+    // Because of the range checks above both indexes are guaranteed to be
+    // within the board. The snapped coordinates are then a simple table lookup.
+    int columnIndex = floor((coordinates.x - self.topLeftPointX) / self.pointDistance);
+    int rowIndexCountingFromTopLeft = floor((coordinates.y - self.topLeftPointY) / self.pointDistance);
+    struct GoVertexNumeric numericVertex;
+    numericVertex.x = 1 + columnIndex;
+    numericVertex.y = self.boardSize - rowIndexCountingFromTopLeft;
+    GoPoint* pointAtCoordinates = [[GoGame sharedGame].board pointAtNumericVertex:numericVertex];
     if (pointAtCoordinates)
     {
-      return BoardViewIntersectionMake(pointAtCoordinates, coordinates);
+      return BoardViewIntersectionMake(pointAtCoordinates,
+                                       [self coordinatesFromPoint:pointAtCoordinates]);
     }
     else
     {
@@ -827,6 +842,30 @@
 
 #pragma mark - Private helpers
 
+// -----------------------------------------------------------------------------
+/// @brief Fills the lookup table that coordinatesFromPoint:withBoardSize:()
+/// uses with the view coordinates of all intersections on a board with size
+/// @a newBoardSize.
+///
+/// This is a private helper for
+/// updateWithCanvasSize:boardSize:displayCoordinates:(). It must be invoked
+/// after self.topLeftPointX, self.topLeftPointY and self.pointDistance have
+/// been calculated.
+// -----------------------------------------------------------------------------
+- (void) updatePointCoordinatesTableWithBoardSize:(enum GoBoardSize)newBoardSize
+{
+  for (int rowIndex = 0; rowIndex < newBoardSize; ++rowIndex)
+  {
+    CGFloat pointY = self.topLeftPointY + (self.pointDistance * (newBoardSize - 1 - rowIndex));
+    for (int columnIndex = 0; columnIndex < newBoardSize; ++columnIndex)
+    {
+      CGFloat pointX = self.topLeftPointX + (self.pointDistance * columnIndex);
+      _pointCoordinatesTable[rowIndex * newBoardSize + columnIndex] = CGPointMake(pointX, pointY);
+    }
+  }
+  _pointCoordinatesTableBoardSize = newBoardSize;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Calculates a list of rectangles that together make up all grid lines
 /// on the board.
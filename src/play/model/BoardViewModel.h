@@ -31,6 +31,9 @@
 @property(nonatomic, assign) bool markLastMove;
 @property(nonatomic, assign) bool displayCoordinates;
 @property(nonatomic, assign) bool displayPlayerInfluence;
+/// @brief True if the board view marks the stones that GoTacticalReader finds
+/// to be capturable in a ladder or with a short capture sequence.
+@property(nonatomic, assign) bool displayCapturableStones;
 @property(nonatomic, assign) float moveNumbersPercentage;
 @property(nonatomic, assign) bool playSound;
 @property(nonatomic, assign) bool vibrate;
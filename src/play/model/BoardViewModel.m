@@ -37,6 +37,7 @@
   self.markLastMove = false;
   self.displayCoordinates = false;
   self.displayPlayerInfluence = displayPlayerInfluenceDefault;
+  self.displayCapturableStones = displayCapturableStonesDefault;
   self.moveNumbersPercentage = 0.0;
   self.playSound = false;
   self.vibrate = false;
@@ -61,6 +62,7 @@
   self.markLastMove = [[dictionary valueForKey:markLastMoveKey] boolValue];
   self.displayCoordinates = [[dictionary valueForKey:displayCoordinatesKey] boolValue];
   self.displayPlayerInfluence = [[dictionary valueForKey:displayPlayerInfluenceKey] boolValue];
+  self.displayCapturableStones = [[dictionary valueForKey:displayCapturableStonesKey] boolValue];
   self.moveNumbersPercentage = [[dictionary valueForKey:moveNumbersPercentageKey] floatValue];
   self.playSound = [[dictionary valueForKey:playSoundKey] boolValue];
   self.vibrate = [[dictionary valueForKey:vibrateKey] boolValue];
@@ -86,6 +88,7 @@
   [dictionary setValue:[NSNumber numberWithBool:self.markLastMove] forKey:markLastMoveKey];
   [dictionary setValue:[NSNumber numberWithBool:self.displayCoordinates] forKey:displayCoordinatesKey];
   [dictionary setValue:[NSNumber numberWithBool:self.displayPlayerInfluence] forKey:displayPlayerInfluenceKey];
+  [dictionary setValue:[NSNumber numberWithBool:self.displayCapturableStones] forKey:displayCapturableStonesKey];
   [dictionary setValue:[NSNumber numberWithFloat:self.moveNumbersPercentage] forKey:moveNumbersPercentageKey];
   [dictionary setValue:[NSNumber numberWithBool:self.playSound] forKey:playSoundKey];
   [dictionary setValue:[NSNumber numberWithBool:self.vibrate] forKey:vibrateKey];
@@ -0,0 +1,57 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "layer/NodeTreeViewLayerDelegate.h"
+
+// Forward declarations
+@class NodeTreeViewCanvas;
+@class NodeTreeViewMetrics;
+@class NodeTreeViewModel;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The NodeTreeSelectionView class is a custom view that is responsible
+/// for drawing the selection marker around the node that represents the current
+/// board position.
+///
+/// NodeTreeSelectionView is placed on top of the tile views of the node tree
+/// view, in the same container view. Its frame covers exactly the cells of the
+/// selected node. When the selected node changes NodeTreeSelectionView merely
+/// moves to the cells of the newly selected node, which is why navigating
+/// through the board positions of a game does not cause any tile view to
+/// redraw its content. The selection marker itself needs to be redrawn only
+/// if the newly selected node occupies a differently sized canvas rectangle,
+/// e.g. when the selection moves from a condensed move node to an uncondensed
+/// node.
+///
+/// NodeTreeSelectionView uses long-running actions to delay view updates in
+/// the same way as NodeTreeTileView. See the NodeTreeTileView class
+/// documentation for details.
+// -----------------------------------------------------------------------------
+@interface NodeTreeSelectionView : UIView
+{
+}
+
+- (id) initWithMetrics:(NodeTreeViewMetrics*)nodeTreeViewMetrics
+                canvas:(NodeTreeViewCanvas*)nodeTreeViewCanvas
+                 model:(NodeTreeViewModel*)nodeTreeViewModel;
+
+- (void) updateColors;
+- (void) removeNotificationResponders;
+
+@end
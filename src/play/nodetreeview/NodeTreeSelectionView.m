@@ -0,0 +1,283 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "NodeTreeSelectionView.h"
+#import "NodeTreeViewMetrics.h"
+#import "layer/SelectedNodeLayerDelegate.h"
+#import "../../go/GoGame.h"
+#import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelChangeObserver.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for NodeTreeSelectionView.
+// -----------------------------------------------------------------------------
+@interface NodeTreeSelectionView() <ModelChangeObserverDelegate>
+@property(nonatomic, assign) NodeTreeViewMetrics* nodeTreeViewMetrics;
+@property(nonatomic, assign) bool notificationRespondersAreSetup;
+@property(nonatomic, retain) ModelChangeObserver* modelChangeObserver;
+@property(nonatomic, assign) bool drawLayerWasDelayed;
+@property(nonatomic, retain) SelectedNodeLayerDelegate* selectedNodeLayerDelegate;
+@end
+
+
+@implementation NodeTreeSelectionView
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a NodeTreeSelectionView object. The view is initially
+/// hidden, it becomes visible as soon as there is a selected node.
+///
+/// @note This is the designated initializer of NodeTreeSelectionView.
+// -----------------------------------------------------------------------------
+- (id) initWithMetrics:(NodeTreeViewMetrics*)nodeTreeViewMetrics
+                canvas:(NodeTreeViewCanvas*)nodeTreeViewCanvas
+                 model:(NodeTreeViewModel*)nodeTreeViewModel
+{
+  // Call designated initializer of superclass (UIView)
+  self = [super initWithFrame:CGRectZero];
+  if (! self)
+    return nil;
+
+  self.nodeTreeViewMetrics = nodeTreeViewMetrics;
+  self.notificationRespondersAreSetup = false;
+  self.drawLayerWasDelayed = false;
+  self.selectedNodeLayerDelegate = [[[SelectedNodeLayerDelegate alloc] initWithMetrics:nodeTreeViewMetrics
+                                                                                canvas:nodeTreeViewCanvas
+                                                                                 model:nodeTreeViewModel] autorelease];
+  [self.layer addSublayer:self.selectedNodeLayerDelegate.layer];
+
+  self.hidden = YES;
+  // Taps must reach the node tree view underneath
+  self.userInteractionEnabled = NO;
+  // Tile views are added to the container view while the user scrolls, the
+  // z-position keeps this view on top of them
+  self.layer.zPosition = 1;
+
+  [self setupNotificationResponders];
+  [self.selectedNodeLayerDelegate notify:NTVLDEventInvalidateContent eventInfo:nil];
+  [self delayedDrawLayer];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this NodeTreeSelectionView object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self removeNotificationResponders];
+
+  [self.selectedNodeLayerDelegate.layer removeFromSuperlayer];
+  self.selectedNodeLayerDelegate = nil;
+  self.nodeTreeViewMetrics = nil;
+
+  [super dealloc];
+}
+
+#pragma mark - Setup/remove notification responders
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the initializer.
+// -----------------------------------------------------------------------------
+- (void) setupNotificationResponders
+{
+  if (self.notificationRespondersAreSetup)
+    return;
+  self.notificationRespondersAreSetup = true;
+
+  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  [center addObserver:self selector:@selector(nodeTreeViewContentDidChange:) name:nodeTreeViewContentDidChange object:nil];
+  [center addObserver:self selector:@selector(nodeTreeViewCondenseMoveNodesDidChange:) name:nodeTreeViewCondenseMoveNodesDidChange object:nil];
+  [center addObserver:self selector:@selector(nodeTreeViewAlignMoveNodesDidChange:) name:nodeTreeViewAlignMoveNodesDidChange object:nil];
+  [center addObserver:self selector:@selector(nodeTreeViewBranchingStyleDidChange:) name:nodeTreeViewBranchingStyleDidChange object:nil];
+  [center addObserver:self selector:@selector(nodeTreeViewNodeSelectionStyleDidChange:) name:nodeTreeViewNodeSelectionStyleDidChange object:nil];
+  [center addObserver:self selector:@selector(nodeTreeViewSelectedNodeDidChange:) name:nodeTreeViewSelectedNodeDidChange object:nil];
+  [center addObserver:self selector:@selector(longRunningActionEnds:) name:longRunningActionEnds object:nil];
+
+  // Model changes are delivered in batches, once per run loop cycle
+  self.modelChangeObserver = [[[ModelChangeObserver alloc] initWithDelegate:self] autorelease];
+  [self.modelChangeObserver observeKeyPath:@"nodeTreeViewCellSize" ofObject:self.nodeTreeViewMetrics];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes all notification responders. This message is sent shortly
+/// before the node tree view is deallocated, when the objects that are
+/// observed are still around.
+// -----------------------------------------------------------------------------
+- (void) removeNotificationResponders
+{
+  if (! self.notificationRespondersAreSetup)
+    return;
+  self.notificationRespondersAreSetup = false;
+
+  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  [center removeObserver:self];
+
+  [self.modelChangeObserver stopObserving];
+  self.modelChangeObserver = nil;
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Redraws the selection marker with updated colors.
+// -----------------------------------------------------------------------------
+- (void) updateColors
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventUserInterfaceStyleChanged eventInfo:nil];
+  [self delayedDrawLayer];
+}
+
+#pragma mark - Handle delayed drawing
+
+// -----------------------------------------------------------------------------
+/// @brief Internal helper that correctly handles delayed drawing of the layer.
+/// See the NodeTreeTileView class documentation for details.
+// -----------------------------------------------------------------------------
+- (void) delayedDrawLayer
+{
+  if ([LongRunningActionCounter sharedCounter].counter > 0)
+    self.drawLayerWasDelayed = true;
+  else
+    [self drawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Moves this view to the cells of the selected node, then notifies the
+/// layer that it needs to update now if it is dirty.
+// -----------------------------------------------------------------------------
+- (void) drawLayer
+{
+  // No game -> no nodes -> no drawing. This situation exists right after the
+  // application has launched and the initial game is created only after a
+  // small delay.
+  if (! [GoGame sharedGame])
+    return;
+
+  if ([NSThread currentThread] != [NSThread mainThread])
+  {
+    [self performSelectorOnMainThread:@selector(drawLayer) withObject:nil waitUntilDone:YES];
+    return;
+  }
+
+  self.drawLayerWasDelayed = false;
+
+  CGRect canvasRectOfSelectedNode = self.selectedNodeLayerDelegate.canvasRectOfSelectedNode;
+  if (CGRectIsNull(canvasRectOfSelectedNode))
+  {
+    self.hidden = YES;
+    return;
+  }
+
+  // The selection marker must jump to the new node, an implicit animation of
+  // the layer frame would make it glide across the node tree
+  [CATransaction begin];
+  [CATransaction setDisableActions:YES];
+  self.frame = canvasRectOfSelectedNode;
+  self.selectedNodeLayerDelegate.layer.frame = self.bounds;
+  self.hidden = NO;
+  [CATransaction commit];
+
+  [self.selectedNodeLayerDelegate drawLayer];
+}
+
+#pragma mark - Notification responders
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #nodeTreeViewContentDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) nodeTreeViewContentDidChange:(NSNotification*)notification
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeContentChanged eventInfo:nil];
+  [self delayedDrawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #nodeTreeViewCondenseMoveNodesDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) nodeTreeViewCondenseMoveNodesDidChange:(NSNotification*)notification
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeCondenseMoveNodesChanged eventInfo:nil];
+  [self delayedDrawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #nodeTreeViewAlignMoveNodesDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) nodeTreeViewAlignMoveNodesDidChange:(NSNotification*)notification
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeAlignMoveNodesChanged eventInfo:nil];
+  [self delayedDrawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #nodeTreeViewBranchingStyleDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) nodeTreeViewBranchingStyleDidChange:(NSNotification*)notification
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeBranchingStyleChanged eventInfo:nil];
+  [self delayedDrawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #nodeTreeViewNodeSelectionStyleDidChange
+/// notification.
+// -----------------------------------------------------------------------------
+- (void) nodeTreeViewNodeSelectionStyleDidChange:(NSNotification*)notification
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeNodeSelectionStyleChanged eventInfo:nil];
+  [self delayedDrawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #nodeTreeViewSelectedNodeDidChange notification.
+// -----------------------------------------------------------------------------
+- (void) nodeTreeViewSelectedNodeDidChange:(NSNotification*)notification
+{
+  [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeSelectedNodeChanged eventInfo:notification.object];
+  [self delayedDrawLayer];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #longRunningActionEnds notification.
+// -----------------------------------------------------------------------------
+- (void) longRunningActionEnds:(NSNotification*)notification
+{
+  if (self.drawLayerWasDelayed)
+    [self drawLayer];
+}
+
+#pragma mark - ModelChangeObserverDelegate overrides
+
+// -----------------------------------------------------------------------------
+/// @brief ModelChangeObserverDelegate method.
+// -----------------------------------------------------------------------------
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet
+{
+  if ([changeSet containsChangeOfKeyPath:@"nodeTreeViewCellSize" ofObject:self.nodeTreeViewMetrics])
+  {
+    // Typical examples: The zoom scale did change, or the condense move nodes
+    // user preference did change
+    [self.selectedNodeLayerDelegate notify:NTVLDEventNodeTreeGeometryChanged eventInfo:nil];
+    [self delayedDrawLayer];
+  }
+}
+
+@end
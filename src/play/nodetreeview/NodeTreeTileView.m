@@ -20,15 +20,15 @@
 #import "NodeTreeViewMetrics.h"
 #import "layer/LinesLayerDelegate.h"
 #import "layer/NodeSymbolLayerDelegate.h"
-#import "layer/SelectedNodeLayerDelegate.h"
 #import "../../go/GoGame.h"
 #import "../../shared/LongRunningActionCounter.h"
+#import "../../shared/ModelChangeObserver.h"
 
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for NodeTreeTileView.
 // -----------------------------------------------------------------------------
-@interface NodeTreeTileView()
+@interface NodeTreeTileView() <ModelChangeObserverDelegate>
 @property(nonatomic, assign) NodeTreeViewMetrics* nodeTreeViewMetrics;
 @property(nonatomic, assign) NodeTreeViewCanvas* nodeTreeViewCanvas;
 @property(nonatomic, assign) NodeTreeViewModel* nodeTreeViewModel;
@@ -45,11 +45,14 @@
 /// so we are playing it safe. Also, we guard against future implementation
 /// changes.
 @property(nonatomic, assign) bool notificationRespondersAreSetup;
+/// @brief Observes the properties of model objects that affect the layers of
+/// this NodeTreeTileView. Exists only while notification responders are set
+/// up.
+@property(nonatomic, retain) ModelChangeObserver* modelChangeObserver;
 @property(nonatomic, assign) bool drawLayersWasDelayed;
 @property(nonatomic, retain) NSArray* layerDelegates;
 @property(nonatomic, assign) LinesLayerDelegate* linesLayerDelegate;
 @property(nonatomic, assign) NodeSymbolLayerDelegate* nodeSymbolLayerDelegate;
-@property(nonatomic, assign) SelectedNodeLayerDelegate* selectedNodeLayerDelegate;
 //@}
 @end
 
@@ -92,7 +95,6 @@
   self.layerDelegates = nil;
   self.linesLayerDelegate = nil;
   self.nodeSymbolLayerDelegate = nil;
-  self.selectedNodeLayerDelegate = nil;
 
   return self;
 }
@@ -114,7 +116,6 @@
   self.layerDelegates = nil;
   self.linesLayerDelegate = nil;
   self.nodeSymbolLayerDelegate = nil;
-  self.selectedNodeLayerDelegate = nil;
 
   [super dealloc];
 }
@@ -135,15 +136,14 @@
   [center addObserver:self selector:@selector(nodeTreeViewCondenseMoveNodesDidChange:) name:nodeTreeViewCondenseMoveNodesDidChange object:nil];
   [center addObserver:self selector:@selector(nodeTreeViewAlignMoveNodesDidChange:) name:nodeTreeViewAlignMoveNodesDidChange object:nil];
   [center addObserver:self selector:@selector(nodeTreeViewBranchingStyleDidChange:) name:nodeTreeViewBranchingStyleDidChange object:nil];
-  [center addObserver:self selector:@selector(nodeTreeViewNodeSelectionStyleDidChange:) name:nodeTreeViewNodeSelectionStyleDidChange object:nil];
   [center addObserver:self selector:@selector(nodeTreeViewSelectedGameVariationDidChange:) name:nodeTreeViewSelectedGameVariationDidChange object:nil];
-  [center addObserver:self selector:@selector(nodeTreeViewSelectedNodeDidChange:) name:nodeTreeViewSelectedNodeDidChange object:nil];
   [center addObserver:self selector:@selector(nodeTreeViewNodeSymbolDidChange:) name:nodeTreeViewNodeSymbolDidChange object:nil];
   [center addObserver:self selector:@selector(longRunningActionEnds:) name:longRunningActionEnds object:nil];
 
-  // KVO observing
-  [self.nodeTreeViewMetrics addObserver:self forKeyPath:@"abstractCanvasSize" options:0 context:NULL];
-  [self.nodeTreeViewMetrics addObserver:self forKeyPath:@"nodeTreeViewCellSize" options:0 context:NULL];
+  // Model changes are delivered in batches, once per run loop cycle
+  self.modelChangeObserver = [[[ModelChangeObserver alloc] initWithDelegate:self] autorelease];
+  [self.modelChangeObserver observeKeyPath:@"abstractCanvasSize" ofObject:self.nodeTreeViewMetrics];
+  [self.modelChangeObserver observeKeyPath:@"nodeTreeViewCellSize" ofObject:self.nodeTreeViewMetrics];
 }
 
 // -----------------------------------------------------------------------------
@@ -158,8 +158,8 @@
   NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
   [center removeObserver:self];
 
-  [self.nodeTreeViewMetrics removeObserver:self forKeyPath:@"abstractCanvasSize"];
-  [self.nodeTreeViewMetrics removeObserver:self forKeyPath:@"nodeTreeViewCellSize"];
+  [self.modelChangeObserver stopObserving];
+  self.modelChangeObserver = nil;
 }
 
 #pragma mark - Manage layers and layer delegates
@@ -183,7 +183,6 @@
 {
   [self setupLinesLayerDelegate];
   [self setupNodeSymbolLayerDelegate];
-  [self setupSelectedNodeLayerDelegate];
 
   [self updateLayers];
 }
@@ -216,21 +215,6 @@
                                                                          canvas:self.nodeTreeViewCanvas] autorelease];
 }
 
-// -----------------------------------------------------------------------------
-/// @brief Creates the node symbol layer delegate, or resets it to nil,
-/// depending on the current application state.
-// -----------------------------------------------------------------------------
-- (void) setupSelectedNodeLayerDelegate
-{
-  if (self.selectedNodeLayerDelegate)
-    return;
-
-  self.selectedNodeLayerDelegate = [[[SelectedNodeLayerDelegate alloc] initWithTile:self
-                                                                            metrics:self.nodeTreeViewMetrics
-                                                                             canvas:self.nodeTreeViewCanvas
-                                                                              model:self.nodeTreeViewModel] autorelease];
-}
-
 // -----------------------------------------------------------------------------
 /// @brief Updates the layers of this NodeTreeTileView based on the layer
 /// delegates that currently exist.
@@ -244,7 +228,6 @@
   // determines the order in which layers are stacked.
   [newLayerDelegates addObject:self.linesLayerDelegate];
   [newLayerDelegates addObject:self.nodeSymbolLayerDelegate];
-  [newLayerDelegates addObject:self.selectedNodeLayerDelegate];
 
   // Removing/adding layers does not cause them to redraw. Only layers that
   // are newly created are redrawn.
@@ -344,8 +327,9 @@
 - (void) nodeTreeViewCondenseMoveNodesDidChange:(NSNotification*)notification
 {
   // If the condense move nodes user preference changes the cell size also
-  // changes => see KVO responder. To avoid a dependency on event ordering it
-  // is best to handle the two things separately.
+  // changes => see modelChangeObserver:didObserveChanges:(). To avoid a
+  // dependency on event ordering it is best to handle the two things
+  // separately.
 
   [self notifyLayerDelegates:NTVLDEventNodeTreeCondenseMoveNodesChanged eventInfo:nil];
   [self delayedDrawLayers];
@@ -369,16 +353,6 @@
   [self delayedDrawLayers];
 }
 
-// -----------------------------------------------------------------------------
-/// @brief Responds to the #nodeTreeViewNodeSelectionStyleDidChange
-/// notification.
-// -----------------------------------------------------------------------------
-- (void) nodeTreeViewNodeSelectionStyleDidChange:(NSNotification*)notification
-{
-  [self notifyLayerDelegates:NTVLDEventNodeTreeNodeSelectionStyleChanged eventInfo:nil];
-  [self delayedDrawLayers];
-}
-
 // -----------------------------------------------------------------------------
 /// @brief Responds to the #nodeTreeViewSelectedGameVariationDidChange
 /// notification.
@@ -389,15 +363,6 @@
   [self delayedDrawLayers];
 }
 
-// -----------------------------------------------------------------------------
-/// @brief Responds to the #nodeTreeViewSelectedNodeDidChange notification.
-// -----------------------------------------------------------------------------
-- (void) nodeTreeViewSelectedNodeDidChange:(NSNotification*)notification
-{
-  [self notifyLayerDelegates:NTVLDEventNodeTreeSelectedNodeChanged eventInfo:notification.object];
-  [self delayedDrawLayers];
-}
-
 // -----------------------------------------------------------------------------
 /// @brief Responds to the #nodeTreeViewNodeSymbolDidChange notification.
 // -----------------------------------------------------------------------------
@@ -416,29 +381,33 @@
     [self drawLayers];
 }
 
-#pragma mark - KVO responder
+#pragma mark - ModelChangeObserverDelegate overrides
 
 // -----------------------------------------------------------------------------
-/// @brief Responds to KVO notifications.
+/// @brief ModelChangeObserverDelegate method. Notifies the layer delegates of
+/// all model changes that occurred during the current run loop cycle, then
+/// draws the layers once for all changes.
 // -----------------------------------------------------------------------------
-- (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet
 {
-  if (object == self.nodeTreeViewMetrics)
+  bool layersNeedDrawing = false;
+
+  if ([changeSet containsChangeOfKeyPath:@"abstractCanvasSize" ofObject:self.nodeTreeViewMetrics])
   {
-    if ([keyPath isEqualToString:@"abstractCanvasSize"])
-    {
-      [self notifyLayerDelegates:NTVLDEventAbstractCanvasSizeChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
-    else if ([keyPath isEqualToString:@"nodeTreeViewCellSize"])
-    {
-      // There are several reasons why the cell size could have changed.
-      // Typical examples: The zoom scale did change, or the condense move nodes
-      // user preference did change.
-      [self notifyLayerDelegates:NTVLDEventNodeTreeGeometryChanged eventInfo:nil];
-      [self delayedDrawLayers];
-    }
+    [self notifyLayerDelegates:NTVLDEventAbstractCanvasSizeChanged eventInfo:nil];
+    layersNeedDrawing = true;
   }
+  if ([changeSet containsChangeOfKeyPath:@"nodeTreeViewCellSize" ofObject:self.nodeTreeViewMetrics])
+  {
+    // There are several reasons why the cell size could have changed.
+    // Typical examples: The zoom scale did change, or the condense move nodes
+    // user preference did change.
+    [self notifyLayerDelegates:NTVLDEventNodeTreeGeometryChanged eventInfo:nil];
+    layersNeedDrawing = true;
+  }
+
+  if (layersNeedDrawing)
+    [self delayedDrawLayers];
 }
 
 #pragma mark - UIView overrides
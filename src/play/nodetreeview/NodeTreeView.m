@@ -80,7 +80,7 @@
 // -----------------------------------------------------------------------------
 - (void) updateColors
 {
-  [self notifyTiles:NTVLDEventInvalidateContent eventInfo:nil];
+  [self notifyTiles:NTVLDEventUserInterfaceStyleChanged eventInfo:nil];
 }
 
 // -----------------------------------------------------------------------------
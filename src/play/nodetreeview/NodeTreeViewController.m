@@ -19,12 +19,15 @@
 #import "NodeTreeViewController.h"
 #import "NodeNumbersTileView.h"
 #import "NodeNumbersView.h"
+#import "NodeTreeSelectionView.h"
 #import "NodeTreeTileView.h"
 #import "NodeTreeView.h"
 #import "NodeTreeViewMetrics.h"
 #import "NodeTreeViewMetricsUpdater.h"
 #import "NodeTreeViewTapGestureController.h"
 #import "canvas/NodeTreeViewCanvas.h"
+#import "canvas/NodeTreeViewLayoutCache.h"
+#import "layer/NodeTreeViewCGLayerCache.h"
 #import "layer/NodeTreeViewDrawingHelper.h"
 #import "../gesture/DoubleTapGestureController.h"
 #import "../gesture/TwoFingerTapGestureController.h"
@@ -33,6 +36,7 @@
 #import "../../ui/AutoLayoutUtility.h"
 #import "../../ui/UiUtilities.h"
 #import "../../utility/NSObjectAdditions.h"
+#import "../../utility/PathUtilities.h"
 
 
 // -----------------------------------------------------------------------------
@@ -47,6 +51,7 @@
 /// yet. Registering may not happen if the controller's view is never loaded.
 @property(nonatomic, assign) bool notificationRespondersAreSetup;
 @property(nonatomic, retain) NodeTreeView* nodeTreeView;
+@property(nonatomic, retain) NodeTreeSelectionView* nodeTreeSelectionView;
 @property(nonatomic, retain) NodeNumbersView* nodeNumbersView;
 @property(nonatomic, retain) NSArray* autoLayoutConstraintsWithoutNodeNumbersView;
 @property(nonatomic, retain) NSArray* autoLayoutConstraintsWithNodeNumbersView;
@@ -80,6 +85,7 @@
   self.nodeTreeViewMetricsUpdater = nil;
   self.notificationRespondersAreSetup = false;
   self.nodeTreeView = nil;
+  self.nodeTreeSelectionView = nil;
   self.nodeNumbersView = nil;
   self.autoLayoutConstraintsWithoutNodeNumbersView = nil;
   self.autoLayoutConstraintsWithNodeNumbersView = nil;
@@ -111,12 +117,14 @@
   // NodeTreeViewCanvas are still around.
   [self.nodeTreeViewMetricsUpdater removeNotificationResponders];
   [self.nodeTreeView removeNotificationResponders];
+  [self.nodeTreeSelectionView removeNotificationResponders];
   [self.nodeNumbersView removeNotificationResponders];
 
   self.autoLayoutConstraintsWithoutNodeNumbersView = nil;
   self.autoLayoutConstraintsWithNodeNumbersView = nil;
   self.autoLayoutConstraintNodeNumbersViewHeight = nil;
   self.nodeTreeView = nil;
+  self.nodeTreeSelectionView = nil;
   self.nodeNumbersView = nil;
   self.doubleTapGestureController = nil;
   self.twoFingerTapGestureController = nil;
@@ -176,10 +184,18 @@
 - (void) createCanvasAndMetrics
 {
   self.nodeTreeViewCanvas = [[[NodeTreeViewCanvas alloc] initWithModel:self.nodeTreeViewModel] autorelease];
+  // The cache is set before the initial calculation because that is where it
+  // pays off most, e.g. when a large game is restored after an app relaunch
+  self.nodeTreeViewCanvas.layoutCache = [[[NodeTreeViewLayoutCache alloc] initWithFilePath:[PathUtilities nodeTreeViewLayoutCacheFilePath]] autorelease];
   [self.nodeTreeViewCanvas recalculateCanvas];
+  // The initial calculation is synchronous so that the canvas data is
+  // available when the views are created. Later calculations of big trees of
+  // nodes should not block the main thread.
+  self.nodeTreeViewCanvas.calculatesCanvasInBackground = true;
   self.nodeTreeViewMetrics = [[[NodeTreeViewMetrics alloc] initWithModel:self.nodeTreeViewModel
                                                       canvasDataProvider:self.nodeTreeViewCanvas
                                                          traitCollection:self.traitCollection] autorelease];
+  [NodeTreeViewCGLayerCache sharedCache].lightUserInterfaceStyle = [UiUtilities isLightUserInterfaceStyle:self.traitCollection];
   self.nodeTreeViewMetricsUpdater = [[[NodeTreeViewMetricsUpdater alloc] initWithModel:self.nodeTreeViewModel
                                                                     canvasDataProvider:self.nodeTreeViewCanvas
                                                                                metrics:self.nodeTreeViewMetrics] autorelease];
@@ -191,6 +207,10 @@
 - (void) createSubviews
 {
   self.nodeTreeView = [[[NodeTreeView alloc] initWithFrame:CGRectZero nodeTreeViewMetrics:self.nodeTreeViewMetrics] autorelease];
+  self.nodeTreeView.accessibilityIdentifier = nodeTreeViewAccessibilityIdentifier;
+  self.nodeTreeSelectionView = [[[NodeTreeSelectionView alloc] initWithMetrics:self.nodeTreeViewMetrics
+                                                                        canvas:self.nodeTreeViewCanvas
+                                                                         model:self.nodeTreeViewModel] autorelease];
 }
 
 // -----------------------------------------------------------------------------
@@ -199,6 +219,9 @@
 - (void) setupViewHierarchy
 {
   [self.view addSubview:self.nodeTreeView];
+  // The selection view lives in the same coordinate system as the tiles, so
+  // that it scrolls and zooms together with them
+  [self.nodeTreeView.tileContainerView addSubview:self.nodeTreeSelectionView];
 }
 
 // -----------------------------------------------------------------------------
@@ -818,8 +841,12 @@
 - (void) updateColors
 {
   [self.nodeTreeViewMetrics updateWithTraitCollection:self.traitCollection];
+  // Switches to the set of cached layers that was drawn with the colors of the
+  // new user interface style, the other set is kept for switching back
+  [NodeTreeViewCGLayerCache sharedCache].lightUserInterfaceStyle = [UiUtilities isLightUserInterfaceStyle:self.traitCollection];
 
   [self.nodeTreeView updateColors];
+  [self.nodeTreeSelectionView updateColors];
   [self.nodeNumbersView updateColors];
 }
 
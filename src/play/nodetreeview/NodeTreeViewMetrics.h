@@ -213,6 +213,16 @@
 @property(nonatomic, retain) UIFont* singleCharacterNodeSymbolFont;
 @property(nonatomic, retain) UIFont* threeCharactersNodeSymbolFont;
 @property(nonatomic, retain) UIFont* twoLinesOfCharactersNodeSymbolFont;
+/// @brief True if the node tree is zoomed out so far that it should be drawn
+/// with a reduced level of detail, false if not.
+///
+/// When this is true, long linear runs of move nodes are drawn as a single
+/// connecting line instead of as individual node symbols. Node symbols that
+/// are not move nodes (e.g. the root node, setup nodes, nodes with
+/// annotations or markup) are still drawn so that they remain recognizable.
+/// The full level of detail reappears when the zoom scale increases again to
+/// at least @e nodeTreeViewReducedLevelOfDetailZoomScale.
+@property(nonatomic, assign) bool reducedLevelOfDetail;
 //@}
 
 // -----------------------------------------------------------------------------
@@ -116,7 +116,7 @@
 
   self.tileSize = CGSizeMake(128, 128);
 
-  self.minimumAbsoluteZoomScale = 1.0f;
+  self.minimumAbsoluteZoomScale = nodeTreeViewMinimumZoomScale;
   if ([LayoutManager sharedManager].uiType != UITypePad)
     self.maximumAbsoluteZoomScale = iPhoneMaximumZoomScale;
   else
@@ -205,6 +205,7 @@
   self.abstractCanvasSize = self.canvasDataProvider.canvasSize;
   self.condenseMoveNodes = nodeTreeViewModel.condenseMoveNodes;
   self.absoluteZoomScale = 1.0f;
+  self.reducedLevelOfDetail = false;
   self.nodeNumberViewIsOverlay = nodeTreeViewModel.nodeNumberViewIsOverlay;
   self.canvasSize = CGSizeZero;
 
@@ -408,6 +409,8 @@
   // properties is guaranteed to be not up-to-date.
   // ----------------------------------------------------------------------
 
+  self.reducedLevelOfDetail = (newAbsoluteZoomScale < nodeTreeViewReducedLevelOfDetailZoomScale);
+
   CGFloat nodeTreeViewCellCondensedWidth = floor(self.nodeTreeViewCellBaseSize * newAbsoluteZoomScale);
   CGFloat nodeTreeViewCellUncondensedWidth = nodeTreeViewCellCondensedWidth * self.numberOfCellsOfMultipartCell;
 
@@ -38,6 +38,10 @@
   /// tree view. The user preference "numbering style" determines the meaning
   /// of the node number.
   int nodeNumber;
+  /// @brief The move number of the move in @e node, or 0 if @e node does not
+  /// contain a move. Is captured when the NodeTreeViewBranchTuple is created so
+  /// that the layout can be calculated without accessing @e node.
+  int moveNumber;
   /// @brief The x-position on the canvas of the first cell that has content
   /// representing @e node.
   unsigned short xPositionOfFirstCell;
@@ -70,6 +74,12 @@
   /// @brief The next NodeTreeViewBranchTuple object in @e branch after this
   /// NodeTreeViewBranchTuple.
   NodeTreeViewBranchTuple* nextBranchTupleInBranch;
+  /// @brief List of NodeTreeViewCellPosition objects that indicate which cells
+  /// on the canvas display @e node. Is @e nil until the list is needed for the
+  /// first time after cells were generated for @e node. NodeTreeViewCanvas
+  /// resets the list to @e nil whenever it generates cells for @e node,
+  /// because only then can the positions change.
+  NSArray* positions;
 }
 
 @end
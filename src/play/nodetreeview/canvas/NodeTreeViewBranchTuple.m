@@ -54,6 +54,11 @@
     [self->childBranches release];
     self->childBranches = nil;
   }
+  if (self->positions)
+  {
+    [self->positions release];
+    self->positions = nil;
+  }
 
   [super dealloc];
 }
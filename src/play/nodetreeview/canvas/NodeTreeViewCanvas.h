@@ -23,6 +23,7 @@
 @class NodeNumbersViewCell;
 @class NodeTreeViewCell;
 @class NodeTreeViewCellPosition;
+@class NodeTreeViewLayoutCache;
 @class NodeTreeViewModel;
 
 
@@ -96,6 +97,9 @@
 - (void) recalculateCanvas;
 
 - (NodeTreeViewCell*) cellAtPosition:(NodeTreeViewCellPosition*)position;
+- (void) enumerateCellsFromPosition:(NodeTreeViewCellPosition*)fromPosition
+                         toPosition:(NodeTreeViewCellPosition*)toPosition
+                         usingBlock:(void (^)(NodeTreeViewCellPosition* position, NodeTreeViewCell* cell, GoNode* node))block;
 - (GoNode*) nodeAtPosition:(NodeTreeViewCellPosition*)position;
 - (NSArray*) positionsForNode:(GoNode*)node;
 - (NSArray*) selectedNodePositions;
@@ -107,4 +111,23 @@
 // Property is documented in the NodeTreeViewCanvasDataProvider header file.
 @property(nonatomic, assign, readonly) CGSize canvasSize;
 
+/// @brief True if full re-calculations of the canvas are performed
+/// asynchronously on a secondary thread. False if full re-calculations are
+/// performed synchronously on the main thread. The default is false.
+///
+/// While a re-calculation is in progress on the secondary thread the public
+/// API continues to provide the canvas data that was calculated previously.
+/// The new canvas data replaces the previous canvas data on the main thread
+/// when the re-calculation has finished. If the canvas needs another update
+/// before the re-calculation has finished, the re-calculation is cancelled and
+/// its result is discarded.
+///
+/// Incremental updates of the canvas are always performed synchronously.
+@property(nonatomic, assign) bool calculatesCanvasInBackground;
+/// @brief The cache in which NodeTreeViewCanvas looks up the layout of the node
+/// tree before it calculates the layout, and in which it stores the layout
+/// after it has calculated it. The default is @e nil, i.e. no cache is used
+/// and the layout is always calculated.
+@property(nonatomic, retain) NodeTreeViewLayoutCache* layoutCache;
+
 @end
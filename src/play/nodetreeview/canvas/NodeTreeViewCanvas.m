@@ -23,15 +23,23 @@
 #import "NodeTreeViewCanvasAdditions.h"
 #import "NodeTreeViewCanvasData.h"
 #import "NodeTreeViewCell.h"
+#import "NodeTreeViewCellGrid.h"
 #import "NodeTreeViewCellPosition.h"
+#import "NodeTreeViewLayoutCache.h"
 #import "../../model/NodeTreeViewModel.h"
 #import "../../../go/GoBoardPosition.h"
 #import "../../../go/GoGame.h"
 #import "../../../go/GoMove.h"
 #import "../../../go/GoNode.h"
 #import "../../../go/GoNodeModel.h"
+#import "../../../go/GoNodeTreeChange.h"
 #import "../../../go/GoUtilities.h"
+#import "../../../diagnostics/SignpostLog.h"
 #import "../../../shared/LongRunningActionCounter.h"
+#import "../../../shared/ModelChangeObserver.h"
+
+// System includes
+#import <os/signpost.h>
 
 
 // Currently the node numbers view canvas has only one row, so node numbers
@@ -42,10 +50,12 @@ static const unsigned short yPositionOfNodeNumber = 0;
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for NodeTreeViewCanvas.
 // -----------------------------------------------------------------------------
-@interface NodeTreeViewCanvas()
+@interface NodeTreeViewCanvas() <ModelChangeObserverDelegate>
 @property(nonatomic, assign, readwrite) CGSize canvasSize;
 @property(nonatomic, assign) NodeTreeViewModel* nodeTreeViewModel;
+@property(nonatomic, retain) ModelChangeObserver* modelChangeObserver;
 @property(nonatomic, assign) bool canvasNeedsUpdate;
+@property(nonatomic, retain) NSMutableArray* pendingTreeChanges;
 @property(nonatomic, retain) NSString* notificationToPostAfterCanvasUpdate;
 @property(nonatomic, retain) NodeTreeViewCanvasData* canvasData;
 @property(nonatomic, assign) bool selectedGameVariationNeedsUpdate;
@@ -55,6 +65,10 @@ static const unsigned short yPositionOfNodeNumber = 0;
 @property(nonatomic, assign) bool nodeSelectionStyleNeedsUpdate;
 @property(nonatomic, assign) bool nodeSymbolNeedsUpdate;
 @property(nonatomic, retain) GoNode* nodeWhoseSymbolNeedsUpdate;
+@property(nonatomic, retain) NSOperationQueue* canvasCalculationQueue;
+@property(nonatomic, retain) NSOperation* canvasCalculationOperation;
+@property(nonatomic, retain) NSString* notificationToPostAfterCanvasCalculation;
+@property(nonatomic, retain) NSMutableArray* treeChangesDuringCanvasCalculation;
 @end
 
 
@@ -77,6 +91,7 @@ static const unsigned short yPositionOfNodeNumber = 0;
   self.nodeTreeViewModel = nodeTreeViewModel;
 
   self.canvasNeedsUpdate = false;
+  self.pendingTreeChanges = nil;
   self.notificationToPostAfterCanvasUpdate = nil;
   self.canvasSize = CGSizeZero;
   self.canvasData = [[[NodeTreeViewCanvasData alloc] init] autorelease];
@@ -87,6 +102,15 @@ static const unsigned short yPositionOfNodeNumber = 0;
   self.nodeSelectionStyleNeedsUpdate = false;
   self.nodeSymbolNeedsUpdate = false;
   self.nodeWhoseSymbolNeedsUpdate = nil;
+  self.calculatesCanvasInBackground = false;
+  self.canvasCalculationQueue = [[[NSOperationQueue alloc] init] autorelease];
+  // Calculations must not overlap, a newer calculation always waits until the
+  // previous calculation has finished or was cancelled
+  self.canvasCalculationQueue.maxConcurrentOperationCount = 1;
+  self.canvasCalculationOperation = nil;
+  self.notificationToPostAfterCanvasCalculation = nil;
+  self.treeChangesDuringCanvasCalculation = nil;
+  self.layoutCache = nil;
 
   [self setupNotificationResponders];
 
@@ -100,12 +124,19 @@ static const unsigned short yPositionOfNodeNumber = 0;
 {
   [self removeNotificationResponders];
 
+  self.pendingTreeChanges = nil;
   self.notificationToPostAfterCanvasUpdate = nil;
   self.nodeTreeViewModel = nil;
   self.canvasData = nil;
   self.cachedSelectedNodePositions = nil;
   self.cachedSelectedNodeNodeNumbersViewPositions = nil;
   self.nodeWhoseSymbolNeedsUpdate = nil;
+  [self.canvasCalculationQueue cancelAllOperations];
+  self.canvasCalculationQueue = nil;
+  self.canvasCalculationOperation = nil;
+  self.notificationToPostAfterCanvasCalculation = nil;
+  self.treeChangesDuringCanvasCalculation = nil;
+  self.layoutCache = nil;
 
   [super dealloc];
 }
@@ -127,10 +158,13 @@ static const unsigned short yPositionOfNodeNumber = 0;
   [center addObserver:self selector:@selector(nodeMarkupDataDidChange:) name:nodeMarkupDataDidChange object:nil];
   [center addObserver:self selector:@selector(longRunningActionEnds:) name:longRunningActionEnds object:nil];
 
-  [self.nodeTreeViewModel addObserver:self forKeyPath:@"condenseMoveNodes" options:0 context:NULL];
-  [self.nodeTreeViewModel addObserver:self forKeyPath:@"alignMoveNodes" options:0 context:NULL];
-  [self.nodeTreeViewModel addObserver:self forKeyPath:@"branchingStyle" options:0 context:NULL];
-  [self.nodeTreeViewModel addObserver:self forKeyPath:@"nodeSelectionStyle" options:0 context:NULL];
+  // Model changes are delivered in batches, once per run loop cycle, so that
+  // changing several user preferences at once triggers only one update
+  self.modelChangeObserver = [[[ModelChangeObserver alloc] initWithDelegate:self] autorelease];
+  [self.modelChangeObserver observeKeyPath:@"condenseMoveNodes" ofObject:self.nodeTreeViewModel];
+  [self.modelChangeObserver observeKeyPath:@"alignMoveNodes" ofObject:self.nodeTreeViewModel];
+  [self.modelChangeObserver observeKeyPath:@"branchingStyle" ofObject:self.nodeTreeViewModel];
+  [self.modelChangeObserver observeKeyPath:@"nodeSelectionStyle" ofObject:self.nodeTreeViewModel];
 }
 
 // -----------------------------------------------------------------------------
@@ -140,10 +174,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
 {
   [[NSNotificationCenter defaultCenter] removeObserver:self];
 
-  [self.nodeTreeViewModel removeObserver:self forKeyPath:@"condenseMoveNodes"];
-  [self.nodeTreeViewModel removeObserver:self forKeyPath:@"alignMoveNodes"];
-  [self.nodeTreeViewModel removeObserver:self forKeyPath:@"branchingStyle"];
-  [self.nodeTreeViewModel removeObserver:self forKeyPath:@"nodeSelectionStyle"];
+  [self.modelChangeObserver stopObserving];
+  self.modelChangeObserver = nil;
 }
 
 #pragma mark - Notification responders
@@ -154,6 +186,7 @@ static const unsigned short yPositionOfNodeNumber = 0;
 - (void) goGameDidCreate:(NSNotification*)notification
 {
   self.canvasNeedsUpdate = true;
+  self.pendingTreeChanges = nil;
   self.notificationToPostAfterCanvasUpdate = nodeTreeViewContentDidChange;
   [self delayedUpdate];
 }
@@ -163,6 +196,25 @@ static const unsigned short yPositionOfNodeNumber = 0;
 // -----------------------------------------------------------------------------
 - (void) goNodeTreeLayoutDidChange:(NSNotification*)notification
 {
+  // Collect the tree changes so that updateCanvas() can attempt an incremental
+  // update. If the notification carries no tree changes, or if a full
+  // recalculation is already pending, then nothing is known about what changed
+  // and the tree changes cannot be used.
+  NSArray* treeChanges = notification.object;
+  if (! self.canvasNeedsUpdate)
+    self.pendingTreeChanges = treeChanges ? [NSMutableArray arrayWithArray:treeChanges] : nil;
+  else if (self.pendingTreeChanges && treeChanges)
+    [self.pendingTreeChanges addObjectsFromArray:treeChanges];
+  else
+    self.pendingTreeChanges = nil;
+
+  // A calculation that is in progress on a secondary thread may still examine
+  // the nodes of a sub tree that was removed. GoNodeTreeChange retains the
+  // removed nodes, so keeping the tree changes until the calculation has
+  // finished also keeps the nodes alive.
+  if (treeChanges)
+    [self.treeChangesDuringCanvasCalculation addObjectsFromArray:treeChanges];
+
   self.canvasNeedsUpdate = true;
   self.notificationToPostAfterCanvasUpdate = nodeTreeViewContentDidChange;
   [self delayedUpdate];
@@ -224,34 +276,37 @@ static const unsigned short yPositionOfNodeNumber = 0;
   [self delayedUpdate];
 }
 
+#pragma mark - ModelChangeObserverDelegate overrides
+
 // -----------------------------------------------------------------------------
-/// @brief Responds to KVO notifications.
+/// @brief ModelChangeObserverDelegate method. Performs a single update for all
+/// user preference changes that occurred during the current run loop cycle.
 // -----------------------------------------------------------------------------
-- (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet
 {
-  if ([keyPath isEqualToString:@"condenseMoveNodes"])
-  {
-    self.canvasNeedsUpdate = true;
-    self.notificationToPostAfterCanvasUpdate = nodeTreeViewCondenseMoveNodesDidChange;
-    [self delayedUpdate];
-  }
-  else if ([keyPath isEqualToString:@"alignMoveNodes"])
-  {
-    self.canvasNeedsUpdate = true;
-    self.notificationToPostAfterCanvasUpdate = nodeTreeViewAlignMoveNodesDidChange;
-    [self delayedUpdate];
-  }
-  else if ([keyPath isEqualToString:@"branchingStyle"])
+  // Only one notification can be posted after the canvas update. If several
+  // user preferences that affect the canvas layout changed, the notification
+  // for the condense move nodes user preference wins because it also changes
+  // the cell size and therefore has the most far-reaching consequences.
+  NSString* notificationToPostAfterCanvasUpdate = nil;
+  if ([changeSet containsChangeOfKeyPath:@"branchingStyle" ofObject:self.nodeTreeViewModel])
+    notificationToPostAfterCanvasUpdate = nodeTreeViewBranchingStyleDidChange;
+  if ([changeSet containsChangeOfKeyPath:@"alignMoveNodes" ofObject:self.nodeTreeViewModel])
+    notificationToPostAfterCanvasUpdate = nodeTreeViewAlignMoveNodesDidChange;
+  if ([changeSet containsChangeOfKeyPath:@"condenseMoveNodes" ofObject:self.nodeTreeViewModel])
+    notificationToPostAfterCanvasUpdate = nodeTreeViewCondenseMoveNodesDidChange;
+
+  if (notificationToPostAfterCanvasUpdate)
   {
     self.canvasNeedsUpdate = true;
-    self.notificationToPostAfterCanvasUpdate = nodeTreeViewBranchingStyleDidChange;
-    [self delayedUpdate];
+    self.pendingTreeChanges = nil;
+    self.notificationToPostAfterCanvasUpdate = notificationToPostAfterCanvasUpdate;
   }
-  else if ([keyPath isEqualToString:@"nodeSelectionStyle"])
-  {
+
+  if ([changeSet containsChangeOfKeyPath:@"nodeSelectionStyle" ofObject:self.nodeTreeViewModel])
     self.nodeSelectionStyleNeedsUpdate = true;
-    [self delayedUpdate];
-  }
+
+  [self delayedUpdate];
 }
 
 #pragma mark - Updaters
@@ -270,7 +325,22 @@ static const unsigned short yPositionOfNodeNumber = 0;
     return;
   }
 
+  // While a calculation is in progress on a secondary thread all updates must
+  // wait, because they would operate on canvas data that is about to be
+  // replaced. canvasCalculationDidFinish:() invokes delayedUpdate again when
+  // the calculation has finished. If the canvas needs another update the
+  // result of the calculation in progress is stale and the calculation can
+  // stop early.
+  if (self.canvasCalculationOperation)
+  {
+    if (self.canvasNeedsUpdate)
+      [self.canvasCalculationOperation cancel];
+    return;
+  }
+
   [self updateCanvas];
+  if (self.canvasCalculationOperation)
+    return;
   [self updateSelectedGameVariation];
   [self updateSelectedNodePositions];
   [self updateNodeSelectionStyle];
@@ -286,26 +356,52 @@ static const unsigned short yPositionOfNodeNumber = 0;
     return;
   self.canvasNeedsUpdate = false;
 
-  // Also reset all the other update flags that may have accumulated - a full
-  // canvas recalculation makes other updates redundant
-  self.selectedGameVariationNeedsUpdate = false;
-  self.selectedNodePositionsNeedsUpdate = false;
-  self.nodeSelectionStyleNeedsUpdate = false;
-  self.nodeSymbolNeedsUpdate = false;
+  NSArray* treeChanges = [[self.pendingTreeChanges retain] autorelease];
+  self.pendingTreeChanges = nil;
+
+  // An incremental update only patches the part of the canvas that is affected
+  // by the tree changes. The other updaters must still run afterwards because
+  // the canvas data they operate on is not brought up-to-date.
+  bool canvasWasUpdatedIncrementally = (treeChanges && [self updateCanvasIncrementallyWithTreeChanges:treeChanges]);
+  if (! canvasWasUpdatedIncrementally)
+  {
+    // Also reset all the other update flags that may have accumulated - a full
+    // canvas recalculation makes other updates redundant
+    self.selectedGameVariationNeedsUpdate = false;
+    self.selectedNodePositionsNeedsUpdate = false;
+    self.nodeSelectionStyleNeedsUpdate = false;
+    self.nodeSymbolNeedsUpdate = false;
+
+    if (self.calculatesCanvasInBackground && [GoGame sharedGame])
+    {
+      // canvasCalculationDidFinish:() posts the notification when the
+      // calculation has finished
+      self.notificationToPostAfterCanvasCalculation = self.notificationToPostAfterCanvasUpdate;
+      self.notificationToPostAfterCanvasUpdate = nil;
+      [self startCanvasCalculationInBackground];
+      return;
+    }
+
+    [self recalculateCanvasPrivate];
+  }
 
-  [self recalculateCanvasPrivate];
   [self invalidateCachedSelectedNodePositions];
   [self invalidateCachedSelectedNodeNodeNumbersViewPositions];
 
-  if (self.notificationToPostAfterCanvasUpdate)
-  {
-    [[NSNotificationCenter defaultCenter] postNotificationName:self.notificationToPostAfterCanvasUpdate object:nil];
-    self.notificationToPostAfterCanvasUpdate = nil;
-  }
+  [self postNotificationAfterCanvasUpdate:self.notificationToPostAfterCanvasUpdate];
+  self.notificationToPostAfterCanvasUpdate = nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Internal helper for updateCanvas() and canvasCalculationDidFinish:().
+/// Posts @a notificationToPost to the default notification centre.
+// -----------------------------------------------------------------------------
+- (void) postNotificationAfterCanvasUpdate:(NSString*)notificationToPost
+{
+  if (notificationToPost)
+    [[NSNotificationCenter defaultCenter] postNotificationName:notificationToPost object:nil];
   else
-  {
     DDLogError(@"No notification found to post after node tree view canvas update");
-  }
 }
 
 // -----------------------------------------------------------------------------
@@ -333,12 +429,17 @@ static const unsigned short yPositionOfNodeNumber = 0;
     return;
   self.selectedNodePositionsNeedsUpdate = false;
 
+  // If the node numbers have not been generated yet there is nothing to update,
+  // the node numbers will pick up the new selected state when they are
+  // generated
+  NSMutableDictionary* nodeNumbersViewCellsDictionary = self.canvasData.nodeNumbersNeedGeneration ? nil : self.canvasData.nodeNumbersViewCellsDictionary;
+
   GoNode* previousCurrentBoardPositionNode = self.canvasData.currentBoardPositionNode;
   [self updateSelectedStateOfCellsForNode:previousCurrentBoardPositionNode
                                toNewState:false
                                   nodeMap:self.canvasData.nodeMap
-                          cellsDictionary:self.canvasData.cellsDictionary
-           nodeNumbersViewCellsDictionary:self.canvasData.nodeNumbersViewCellsDictionary];
+                                 cellGrid:self.canvasData.cellGrid
+           nodeNumbersViewCellsDictionary:nodeNumbersViewCellsDictionary];
 
   // Update canvasData with the newly selected node NOW, to make sure that if
   // new node number cells are generated their "selected" state is set correctly
@@ -348,8 +449,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
   NSArray* positionsTupleOfNewlySelectedCells = [self updateSelectedStateOfCellsForNode:newCurrentBoardPositionNode
                                                                              toNewState:true
                                                                                 nodeMap:self.canvasData.nodeMap
-                                                                        cellsDictionary:self.canvasData.cellsDictionary
-                                                         nodeNumbersViewCellsDictionary:self.canvasData.nodeNumbersViewCellsDictionary];
+                                                                               cellGrid:self.canvasData.cellGrid
+                                                         nodeNumbersViewCellsDictionary:nodeNumbersViewCellsDictionary];
 
   NSArray* positionsOfNewlySelectedCells = positionsTupleOfNewlySelectedCells.firstObject;
   NSArray* nodeNumbersViewPositionsOfNewlySelectedCells = positionsTupleOfNewlySelectedCells.lastObject;
@@ -400,11 +501,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
   NSArray* positionsOfNodeWithChangedSymbol = [self positionsForBranchTuple:branchTuple];
   for (NodeTreeViewCellPosition* position in positionsOfNodeWithChangedSymbol)
   {
-    NSArray* tuple = [self.canvasData.cellsDictionary objectForKey:position];
-    NodeTreeViewCell* cell = tuple.firstObject;
+    NodeTreeViewCell* cell = [self.canvasData.cellGrid cellAtX:position.x y:position.y];
     cell.symbol = newNodeSymbol;
-
-    self.canvasData.cellsDictionary[position] = @[cell, tuple.lastObject];
   }
 
   [[NSNotificationCenter defaultCenter] postNotificationName:nodeTreeViewNodeSymbolDidChange object:positionsOfNodeWithChangedSymbol];
@@ -419,9 +517,9 @@ static const unsigned short yPositionOfNodeNumber = 0;
 // -----------------------------------------------------------------------------
 - (NodeTreeViewCell*) cellAtPosition:(NodeTreeViewCellPosition*)position;
 {
-  NSArray* tuple = [self.canvasData.cellsDictionary objectForKey:position];
-  if (tuple)
-    return tuple.firstObject;
+  NodeTreeViewCell* cell = [self.canvasData.cellGrid cellAtX:position.x y:position.y];
+  if (cell)
+    return cell;
 
   if (position.x < self.canvasSize.width && position.y < self.canvasSize.height)
     return [NodeTreeViewCell emptyCell];
@@ -429,16 +527,54 @@ static const unsigned short yPositionOfNodeNumber = 0;
     return nil;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Invokes @a block once for every cell on the canvas that is located
+/// within the rectangle that extends from @a fromPosition to @a toPosition
+/// (both inclusive) and that has content. Empty cells are skipped. The cells
+/// are enumerated row by row, and within a row from left to right.
+///
+/// The block parameter @a node is the GoNode that the cell represents, or
+/// @e nil if the cell contains only lines.
+///
+/// This is intended for drawing the cells of a single tile. The cost of the
+/// enumeration depends on the size of the rectangle, not on the size of the
+/// canvas.
+// -----------------------------------------------------------------------------
+- (void) enumerateCellsFromPosition:(NodeTreeViewCellPosition*)fromPosition
+                         toPosition:(NodeTreeViewCellPosition*)toPosition
+                         usingBlock:(void (^)(NodeTreeViewCellPosition* position, NodeTreeViewCell* cell, GoNode* node))block
+{
+  if (! fromPosition || ! toPosition)
+    return;
+
+  [self.canvasData.cellGrid enumerateCellsFromX:fromPosition.x
+                                            toX:toPosition.x
+                                          fromY:fromPosition.y
+                                            toY:toPosition.y
+                                     usingBlock:^(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple)
+  {
+    GoNode* node = nil;
+    if (y == branchTuple->branch->yPosition &&
+        x >= branchTuple->xPositionOfFirstCell &&
+        x < branchTuple->xPositionOfFirstCell + branchTuple->numberOfCellsForNode)
+    {
+      node = branchTuple->node;
+    }
+
+    NodeTreeViewCellPosition* position = [NodeTreeViewCellPosition positionWithX:x y:y];
+    block(position, cell, node);
+  }];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief NodeTreeViewCanvasDataProvider protocol method.
 // -----------------------------------------------------------------------------
 - (GoNode*) nodeAtPosition:(NodeTreeViewCellPosition*)position
 {
-  NSArray* tuple = [self.canvasData.cellsDictionary objectForKey:position];
-  if (! tuple)
+  NodeTreeViewBranchTuple* branchTuple = [self.canvasData.cellGrid branchTupleAtX:position.x y:position.y];
+  if (! branchTuple)
     return nil;
 
-  NodeTreeViewBranchTuple* branchTuple = tuple.lastObject;
   if (position.x < branchTuple->xPositionOfFirstCell ||
       position.x > branchTuple->xPositionOfFirstCell + branchTuple->numberOfCellsForNode - 1)
   {
@@ -486,6 +622,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
 // -----------------------------------------------------------------------------
 - (NodeNumbersViewCell*) nodeNumbersViewCellAtPosition:(NodeTreeViewCellPosition*)position
 {
+  [self generateNodeNumbersOnDemand];
+
   NodeNumbersViewCell* nodeNumbersViewCell = [self.canvasData.nodeNumbersViewCellsDictionary objectForKey:position];
   if (nodeNumbersViewCell)
     return nodeNumbersViewCell;
@@ -540,10 +678,16 @@ static const unsigned short yPositionOfNodeNumber = 0;
 /// If the re-calculation is performed synchronously, it is guaranteed that it
 /// will be performed on the main thread. Also the notification will be posted
 /// on the main thread.
+///
+/// If the property @e calculatesCanvasInBackground is @e true, the
+/// re-calculation is always performed asynchronously on a secondary thread.
+/// The notification is posted on the main thread after the re-calculation
+/// has finished.
 // -----------------------------------------------------------------------------
 - (void) recalculateCanvas
 {
   self.canvasNeedsUpdate = true;
+  self.pendingTreeChanges = nil;
   self.notificationToPostAfterCanvasUpdate = nodeTreeViewContentDidChange;
   [self delayedUpdate];
 }
@@ -593,7 +737,9 @@ static const unsigned short yPositionOfNodeNumber = 0;
 ///    connect a branching node to its successor nodes in child branches.
 /// 5. Iterate over the current game variation as well as the longest game
 ///    variation (if the two are not the same and the user preferences support
-///    it) and generate cells for node numbers.
+///    it) and generate cells for node numbers. This step is deferred until
+///    the node numbers are needed for the first time, which may be never if
+///    the node numbers view is not displayed.
 // -----------------------------------------------------------------------------
 - (void) recalculateCanvasPrivate
 {
@@ -604,52 +750,263 @@ static const unsigned short yPositionOfNodeNumber = 0;
 
   DDLogDebug(@"%@: Canvas calculation started", self);
 
-  GoNodeModel* nodeModel = game.nodeModel;
-  GoBoardPosition* boardPosition = game.boardPosition;
+  NodeTreeViewCanvasData* canvasData = [self calculateCanvasDataInGame:game
+                                           nodesInCurrentGameVariation:[self nodesInCurrentGameVariation:game.nodeModel]
+                                              currentBoardPositionNode:game.boardPosition.currentNode];
 
-  bool condenseMoveNodes = self.nodeTreeViewModel.condenseMoveNodes;
-  bool alignMoveNodes = self.nodeTreeViewModel.alignMoveNodes;
-  enum NodeTreeViewBranchingStyle branchingStyle = self.nodeTreeViewModel.branchingStyle;
-  int numberOfCellsOfMultipartCell = self.nodeTreeViewModel.numberOfCellsOfMultipartCell;
-  int numberOfNodeNumberCells = [self numberOfNodeNumberCells];
+  self.canvasData = canvasData;
+  self.canvasSize = CGSizeMake(canvasData.highestXPosition + 1, canvasData.highestYPosition + 1);
+
+  DDLogDebug(@"%@: Canvas calculation finished", self);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private back-end method to perform a full re-calculation of the
+/// node tree view canvas on a secondary thread. Returns immediately.
+///
+/// Step 1 of the algorithm is performed synchronously on the main thread. It
+/// is the only step that walks the tree of GoNode objects, and it produces a
+/// snapshot of the tree in the form of a new NodeTreeViewCanvasData object. The
+/// remaining steps of the layout are then performed on the secondary thread,
+/// exclusively on that snapshot. This is important because the main thread
+/// may modify or deallocate GoNode objects while the calculation is in
+/// progress. The snapshot is not visible to anyone until
+/// canvasCalculationDidFinish:() replaces the current canvas data with it on
+/// the main thread. The calculation is cancelled if the canvas needs another
+/// update before the calculation has finished.
+// -----------------------------------------------------------------------------
+- (void) startCanvasCalculationInBackground
+{
+  GoGame* game = [GoGame sharedGame];
+  NSArray* nodesInCurrentGameVariation = [self nodesInCurrentGameVariation:game.nodeModel];
+
+  self.treeChangesDuringCanvasCalculation = [NSMutableArray array];
+
+  DDLogDebug(@"%@: Background canvas calculation started", self);
+
+  NodeTreeViewCanvasData* canvasData = [self collectBranchDataInGame:game
+                                         nodesInCurrentGameVariation:nodesInCurrentGameVariation
+                                            currentBoardPositionNode:game.boardPosition.currentNode];
+  // Step 5 is performed later on the main thread but needs the leaf node. The
+  // block retains the node, it is never dereferenced on the secondary thread.
+  GoNode* leafNodeOfCurrentGameVariation = nodesInCurrentGameVariation.lastObject;
+
+  NSBlockOperation* operation = [[[NSBlockOperation alloc] init] autorelease];
+  // A __block variable is not retained by the block, this avoids a retain
+  // cycle between the operation and its execution block
+  __block NSBlockOperation* blockOperation = operation;
+  [operation addExecutionBlock:^{
+    NodeTreeViewCanvasData* layoutCanvasData = [self layoutCanvasData:canvasData
+                                       leafNodeOfCurrentGameVariation:leafNodeOfCurrentGameVariation
+                                                            operation:blockOperation];
+    [self performSelectorOnMainThread:@selector(canvasCalculationDidFinish:) withObject:layoutCanvasData waitUntilDone:NO];
+  }];
+
+  self.canvasCalculationOperation = operation;
+  [self.canvasCalculationQueue addOperation:operation];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked on the main thread when the calculation that was started
+/// by startCanvasCalculationInBackground() has finished. @a canvasData is the
+/// result of the calculation, or @e nil if the calculation was cancelled.
+///
+/// Replaces the current canvas data with @a canvasData and posts the
+/// notification that was requested for the canvas update. Discards
+/// @a canvasData if the canvas needs another update that arrived while the
+/// calculation was in progress.
+// -----------------------------------------------------------------------------
+- (void) canvasCalculationDidFinish:(NodeTreeViewCanvasData*)canvasData
+{
+  NSString* notificationToPost = [[self.notificationToPostAfterCanvasCalculation retain] autorelease];
+  self.canvasCalculationOperation = nil;
+  self.notificationToPostAfterCanvasCalculation = nil;
+  self.treeChangesDuringCanvasCalculation = nil;
+
+  if (! canvasData || self.canvasNeedsUpdate)
+  {
+    DDLogDebug(@"%@: Background canvas calculation discarded", self);
+
+    // The tree changes that arrived in the meantime cannot be applied
+    // incrementally to the canvas data, because the canvas data does not
+    // reflect the tree changes that triggered the discarded calculation
+    self.pendingTreeChanges = nil;
+    self.canvasNeedsUpdate = true;
+    if (! self.notificationToPostAfterCanvasUpdate)
+      self.notificationToPostAfterCanvasUpdate = notificationToPost;
+  }
+  else
+  {
+    self.canvasData = canvasData;
+    self.canvasSize = CGSizeMake(canvasData.highestXPosition + 1, canvasData.highestYPosition + 1);
+    [self invalidateCachedSelectedNodePositions];
+    [self invalidateCachedSelectedNodeNodeNumbersViewPositions];
+
+    DDLogDebug(@"%@: Background canvas calculation finished", self);
+
+    [self postNotificationAfterCanvasUpdate:notificationToPost];
+  }
+
+  // Perform the updates that had to wait while the calculation was in progress
+  [self delayedUpdate];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Calculates a new NodeTreeViewCanvasData object that represents the
+/// tree of nodes in @a game. @a nodesInCurrentGameVariation contains the nodes
+/// of the current game variation. @a currentBoardPositionNode is the node whose
+/// content is shown by the current board position.
+///
+/// This method performs all steps of the algorithm synchronously and must be
+/// invoked on the main thread. See the documentation of
+/// recalculateCanvasPrivate() for details about what each step of the
+/// algorithm does.
+// -----------------------------------------------------------------------------
+- (NodeTreeViewCanvasData*) calculateCanvasDataInGame:(GoGame*)game
+                          nodesInCurrentGameVariation:(NSArray*)nodesInCurrentGameVariation
+                             currentBoardPositionNode:(GoNode*)currentBoardPositionNode
+{
+  NodeTreeViewCanvasData* canvasData = [self collectBranchDataInGame:game
+                                         nodesInCurrentGameVariation:nodesInCurrentGameVariation
+                                            currentBoardPositionNode:currentBoardPositionNode];
+  return [self layoutCanvasData:canvasData
+ leafNodeOfCurrentGameVariation:nodesInCurrentGameVariation.lastObject
+                      operation:nil];
+}
 
+// -----------------------------------------------------------------------------
+/// @brief Performs step 1 of the algorithm and returns a new
+/// NodeTreeViewCanvasData object that contains the collected branch data. The
+/// object is a snapshot of the tree of nodes in @a game that can be laid out by
+/// layoutCanvasData:leafNodeOfCurrentGameVariation:operation:() without
+/// accessing any GoNode objects.
+///
+/// This method walks the tree of nodes and must therefore be invoked on the
+/// main thread.
+// -----------------------------------------------------------------------------
+- (NodeTreeViewCanvasData*) collectBranchDataInGame:(GoGame*)game
+                        nodesInCurrentGameVariation:(NSArray*)nodesInCurrentGameVariation
+                           currentBoardPositionNode:(GoNode*)currentBoardPositionNode
+{
   NodeTreeViewCanvasData* canvasData = [[[NodeTreeViewCanvasData alloc] init] autorelease];
-  canvasData.currentBoardPositionNode = boardPosition.currentNode;
+  canvasData.currentBoardPositionNode = currentBoardPositionNode;
 
   // Step 1: Collect data about branches
   [self collectBranchDataInCanvasData:canvasData
-                  fromNodeTreeInModel:nodeModel
+             fromNodeTreeWithRootNode:nodesInCurrentGameVariation.firstObject
+          nodesInCurrentGameVariation:nodesInCurrentGameVariation
                                inGame:game
-                    condenseMoveNodes:condenseMoveNodes
-         numberOfCellsOfMultipartCell:numberOfCellsOfMultipartCell
-                       alignMoveNodes:alignMoveNodes];
+                    condenseMoveNodes:self.nodeTreeViewModel.condenseMoveNodes
+         numberOfCellsOfMultipartCell:self.nodeTreeViewModel.numberOfCellsOfMultipartCell
+                       alignMoveNodes:self.nodeTreeViewModel.alignMoveNodes];
 
-  // Step 2: Align moves nodes
-  if (alignMoveNodes)
+  return canvasData;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Performs steps 2-4 of the algorithm on @a canvasData, which must
+/// contain the branch data collected by
+/// collectBranchDataInGame:nodesInCurrentGameVariation:currentBoardPositionNode:().
+/// Invalidates the node numbers so that step 5 is performed on the main thread
+/// when the node numbers are needed for the first time. Returns @a canvasData.
+///
+/// This method does not dereference any GoNode objects, and it does not modify
+/// the state of NodeTreeViewCanvas. It can therefore be invoked on a secondary
+/// thread. If @a operation is not @e nil, this method checks between the steps
+/// of the algorithm whether @a operation was cancelled, and returns @e nil if
+/// it was.
+///
+/// The calculation is wrapped in an os_signpost interval of category
+/// #SignpostCategoryDrawing.
+// -----------------------------------------------------------------------------
+- (NodeTreeViewCanvasData*) layoutCanvasData:(NodeTreeViewCanvasData*)canvasData
+              leafNodeOfCurrentGameVariation:(GoNode*)leafNodeOfCurrentGameVariation
+                                   operation:(NSOperation*)operation
+{
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryDrawing];
+  os_signpost_id_t signpostID = os_signpost_id_generate(signpostLog);
+  os_signpost_interval_begin(signpostLog, signpostID, "NodeTreeViewRecalculateCanvas", "%lu branches", (unsigned long)canvasData.branches.count);
+
+  bool layoutWasFinished = [self doLayoutCanvasData:canvasData
+                     leafNodeOfCurrentGameVariation:leafNodeOfCurrentGameVariation
+                                          operation:operation];
+
+  os_signpost_interval_end(signpostLog, signpostID, "NodeTreeViewRecalculateCanvas", "%{public}s", layoutWasFinished ? "finished" : "cancelled");
+  return layoutWasFinished ? canvasData : nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// layoutCanvasData:leafNodeOfCurrentGameVariation:operation:(). Performs the
+/// actual calculation. Returns @e false if @a operation was cancelled.
+// -----------------------------------------------------------------------------
+- (bool) doLayoutCanvasData:(NodeTreeViewCanvasData*)canvasData
+leafNodeOfCurrentGameVariation:(GoNode*)leafNodeOfCurrentGameVariation
+                  operation:(NSOperation*)operation
+{
+  bool alignMoveNodes = self.nodeTreeViewModel.alignMoveNodes;
+  enum NodeTreeViewBranchingStyle branchingStyle = self.nodeTreeViewModel.branchingStyle;
+
+  if (operation.isCancelled)
+    return false;
+
+  // Steps 2+3 are skipped if the layout cache already knows the result
+  NodeTreeViewLayoutCache* layoutCache = self.layoutCache;
+  bool layoutWasRestored = [layoutCache restoreLayoutInCanvasData:canvasData
+                                                   alignMoveNodes:alignMoveNodes
+                                                   branchingStyle:branchingStyle];
+  if (! layoutWasRestored)
   {
-    [self alignMoveNodes:canvasData];
-  }
+    // Step 2: Align moves nodes
+    if (alignMoveNodes)
+    {
+      [self alignMoveNodes:canvasData];
+      if (operation.isCancelled)
+        return false;
+    }
 
-  // Step 3: Determine y-coordinates of branches
-  [self determineYCoordinatesOfBranches:canvasData
-                         branchingStyle:branchingStyle];
+    // Step 3: Determine y-coordinates of branches
+    [self determineYCoordinatesOfBranches:canvasData
+                           branchingStyle:branchingStyle];
+    if (operation.isCancelled)
+      return false;
+
+    [layoutCache storeLayoutOfCanvasData:canvasData
+                          alignMoveNodes:alignMoveNodes
+                          branchingStyle:branchingStyle
+                  writeToFileImmediately:true];
+  }
 
   // Step 4: Generate cells
   [self generateCells:canvasData
        branchingStyle:branchingStyle];
+  if (operation.isCancelled)
+    return false;
 
-  // Step 5: Generate node numbers
-  [self generateNodeNumbers:canvasData
-                  nodeModel:nodeModel
-          condenseMoveNodes:condenseMoveNodes
-             alignMoveNodes:alignMoveNodes
-    numberOfNodeNumberCells:numberOfNodeNumberCells
-         nodeNumberInterval:self.nodeTreeViewModel.nodeNumberInterval];
+  // Step 5: Generate node numbers (deferred until they are needed). Node
+  // numbers are always generated on the main thread because the generation
+  // walks the tree of nodes.
+  [self invalidateNodeNumbers:canvasData
+leafNodeOfCurrentGameVariation:leafNodeOfCurrentGameVariation];
 
-  self.canvasData = canvasData;
-  self.canvasSize = CGSizeMake(canvasData.highestXPosition + 1, canvasData.highestYPosition + 1);
+  return true;
+}
 
-  DDLogDebug(@"%@: Canvas calculation finished", self);
+// -----------------------------------------------------------------------------
+/// @brief Returns an array with the nodes of the current game variation in
+/// @a nodeModel, in the order in which they appear in the game variation. The
+/// first element is the root node.
+///
+/// This is an internal helper for recalculateCanvasPrivate() and
+/// startCanvasCalculationInBackground().
+// -----------------------------------------------------------------------------
+- (NSArray*) nodesInCurrentGameVariation:(GoNodeModel*)nodeModel
+{
+  int numberOfNodes = nodeModel.numberOfNodes;
+  NSMutableArray* nodesInCurrentGameVariation = [NSMutableArray arrayWithCapacity:numberOfNodes];
+  for (int indexOfNode = 0; indexOfNode < numberOfNodes; indexOfNode++)
+    [nodesInCurrentGameVariation addObject:[nodeModel nodeAtIndex:indexOfNode]];
+  return nodesInCurrentGameVariation;
 }
 
 // -----------------------------------------------------------------------------
@@ -672,11 +1029,9 @@ static const unsigned short yPositionOfNodeNumber = 0;
   // regenerate without affecting the original data while regenerating is in
   // progress. When we are finished we replace the entire object.
   NodeTreeViewCanvasData* canvasData = [[self.canvasData copy] autorelease];
-  canvasData.cellsDictionary = [NSMutableDictionary dictionary];
+  canvasData.cellGrid = [[[NodeTreeViewCellGrid alloc] init] autorelease];
   canvasData.highestXPosition = -1;
   canvasData.highestXPositionNode = nil;
-  canvasData.nodeNumbersViewCellsDictionary = [NSMutableDictionary dictionary];
-  canvasData.nodeNumberingTuples = [NSMutableArray array];
 
   // Step 1: Update data about branches
   [self recalculateNodeIsInCurrentGameVariation:canvasData
@@ -686,13 +1041,9 @@ static const unsigned short yPositionOfNodeNumber = 0;
   [self generateCells:canvasData
        branchingStyle:self.nodeTreeViewModel.branchingStyle];
 
-  // Step 5: Generate node numbers
-  [self generateNodeNumbers:canvasData
-                  nodeModel:game.nodeModel
-          condenseMoveNodes:self.nodeTreeViewModel.condenseMoveNodes
-             alignMoveNodes:self.nodeTreeViewModel.alignMoveNodes
-    numberOfNodeNumberCells:[self numberOfNodeNumberCells]
-         nodeNumberInterval:self.nodeTreeViewModel.nodeNumberInterval];
+  // Step 5: Generate node numbers (deferred until they are needed)
+  [self invalidateNodeNumbers:canvasData
+leafNodeOfCurrentGameVariation:game.nodeModel.leafNode];
 
   self.canvasData = canvasData;
   self.canvasSize = CGSizeMake(canvasData.highestXPosition + 1, canvasData.highestYPosition + 1);
@@ -700,6 +1051,369 @@ static const unsigned short yPositionOfNodeNumber = 0;
   DDLogDebug(@"%@: Partial canvas calculation finished", self);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private back-end method to update the node tree view canvas
+/// incrementally after the tree of nodes provided by GoNodeModel has changed
+/// as described by @a treeChanges (an array of GoNodeTreeChange objects).
+/// Does not post a notification when finished.
+///
+/// Returns @e true if the update could be performed. Returns @e false if the
+/// tree changes are of a kind that require a full re-calculation. In that case
+/// the canvas data may already be partially modified and must be discarded by
+/// the caller.
+///
+/// Only the most common kind of tree change is handled incrementally, which is
+/// a sequence of nodes that is appended to the end of an existing branch (e.g.
+/// when a move is played at the end of a game variation). The other kinds of
+/// tree changes (creating a new branch, discarding nodes) change the linkage
+/// between branches, for which the full re-calculation is required.
+///
+/// The incremental update performs the steps of the full re-calculation
+/// algorithm only for the parts of the canvas that are affected by the tree
+/// changes:
+/// - Step 1 and 2 are performed only for the appended nodes. Move nodes are
+///   aligned only with the move nodes that have the same move number.
+/// - Step 3 is performed for all branches, because a longer branch may push
+///   down other branches.
+/// - Step 4 is performed only for the appended nodes and the node that was
+///   previously at the end of the branch. If step 3 changed the y-position of
+///   any branch, step 4 is performed for all branches.
+/// - Step 5 is performed in full, but only when the node numbers are needed
+///   for the first time.
+///
+/// See the documentation of recalculateCanvasPrivate() for details about what
+/// each step of the algorithm does.
+// -----------------------------------------------------------------------------
+- (bool) updateCanvasIncrementallyWithTreeChanges:(NSArray*)treeChanges
+{
+  GoGame* game = [GoGame sharedGame];
+  if (! game)
+    return false;
+
+  if (treeChanges.count == 0)
+    return false;
+
+  // Filter out tree changes that we cannot handle before modifying anything
+  for (GoNodeTreeChange* treeChange in treeChanges)
+  {
+    if (treeChange.changeType != GoNodeTreeChangeTypeInsert)
+      return false;
+  }
+
+  DDLogDebug(@"%@: Incremental canvas calculation started", self);
+
+  GoNodeModel* nodeModel = game.nodeModel;
+  bool condenseMoveNodes = self.nodeTreeViewModel.condenseMoveNodes;
+  bool alignMoveNodes = self.nodeTreeViewModel.alignMoveNodes;
+  enum NodeTreeViewBranchingStyle branchingStyle = self.nodeTreeViewModel.branchingStyle;
+  int numberOfCellsOfMultipartCell = self.nodeTreeViewModel.numberOfCellsOfMultipartCell;
+
+  NodeTreeViewCanvasData* canvasData = self.canvasData;
+
+  // Step 1+2: Append branch tuples to the end of existing branches and align
+  // them
+  NSMutableArray* affectedBranchTuples = [NSMutableArray array];
+  NSUInteger numberOfTreeChanges = treeChanges.count;
+  for (NSUInteger indexOfTreeChange = 0; indexOfTreeChange < numberOfTreeChanges; indexOfTreeChange++)
+  {
+    GoNodeTreeChange* treeChange = [treeChanges objectAtIndex:indexOfTreeChange];
+    GoNodeTreeChange* nextTreeChange = (indexOfTreeChange + 1 < numberOfTreeChanges) ? [treeChanges objectAtIndex:indexOfTreeChange + 1] : nil;
+
+    NodeTreeViewBranchTuple* branchTuple = [self appendBranchTupleForTreeChange:treeChange
+                                                                 nextTreeChange:nextTreeChange
+                                                                   toCanvasData:canvasData
+                                                                      nodeModel:nodeModel
+                                                                         inGame:game
+                                                              condenseMoveNodes:condenseMoveNodes
+                                                   numberOfCellsOfMultipartCell:numberOfCellsOfMultipartCell
+                                                                 alignMoveNodes:alignMoveNodes];
+    if (! branchTuple)
+      return false;
+
+    [affectedBranchTuples addObject:branchTuple];
+  }
+
+  // Step 3: Determine y-coordinates of branches
+  NSMutableArray* branches = canvasData.branches;
+  NSUInteger numberOfBranches = branches.count;
+  unsigned short previousYPositionOfBranch[numberOfBranches];
+  for (NSUInteger indexOfBranch = 0; indexOfBranch < numberOfBranches; indexOfBranch++)
+  {
+    NodeTreeViewBranch* branch = [branches objectAtIndex:indexOfBranch];
+    previousYPositionOfBranch[indexOfBranch] = branch->yPosition;
+  }
+
+  [self determineYCoordinatesOfBranches:canvasData
+                         branchingStyle:branchingStyle];
+
+  // Incremental updates occur frequently, so the layout cache writes the
+  // layout to its file only later
+  [self.layoutCache storeLayoutOfCanvasData:canvasData
+                             alignMoveNodes:alignMoveNodes
+                             branchingStyle:branchingStyle
+                     writeToFileImmediately:false];
+
+  bool yPositionOfAnyBranchDidChange = false;
+  for (NSUInteger indexOfBranch = 0; indexOfBranch < numberOfBranches; indexOfBranch++)
+  {
+    NodeTreeViewBranch* branch = [branches objectAtIndex:indexOfBranch];
+    if (previousYPositionOfBranch[indexOfBranch] != branch->yPosition)
+    {
+      yPositionOfAnyBranchDidChange = true;
+      break;
+    }
+  }
+
+  // Step 4: Generate cells
+  if (yPositionOfAnyBranchDidChange)
+  {
+    canvasData.cellGrid = [[[NodeTreeViewCellGrid alloc] init] autorelease];
+    [self generateCells:canvasData
+         branchingStyle:branchingStyle];
+  }
+  else
+  {
+    [self regenerateCellsForAppendedBranchTuples:affectedBranchTuples
+                                    inCanvasData:canvasData
+                                  branchingStyle:branchingStyle];
+  }
+
+  // Step 5: Generate node numbers (deferred until they are needed)
+  [self invalidateNodeNumbers:canvasData
+leafNodeOfCurrentGameVariation:nodeModel.leafNode];
+
+  self.canvasSize = CGSizeMake(canvasData.highestXPosition + 1, canvasData.highestYPosition + 1);
+
+  DDLogDebug(@"%@: Incremental canvas calculation finished", self);
+
+  return true;
+}
+
+#pragma mark - Private API - Canvas calculation - Incremental update
+
+// -----------------------------------------------------------------------------
+/// @brief Creates a new NodeTreeViewBranchTuple object for the node that was
+/// inserted by @a treeChange, and appends it to the end of the branch that
+/// contains the parent node. Also aligns the new NodeTreeViewBranchTuple
+/// object if @a alignMoveNodes is @e true. @a nextTreeChange is the tree
+/// change that follows @a treeChange, or @e nil if there is none.
+///
+/// Returns the new NodeTreeViewBranchTuple object. Returns @e nil if the tree
+/// change cannot be handled incrementally.
+///
+/// This is an internal helper for updateCanvasIncrementallyWithTreeChanges:().
+// -----------------------------------------------------------------------------
+- (NodeTreeViewBranchTuple*) appendBranchTupleForTreeChange:(GoNodeTreeChange*)treeChange
+                                             nextTreeChange:(GoNodeTreeChange*)nextTreeChange
+                                               toCanvasData:(NodeTreeViewCanvasData*)canvasData
+                                                  nodeModel:(GoNodeModel*)nodeModel
+                                                     inGame:(GoGame*)game
+                                          condenseMoveNodes:(bool)condenseMoveNodes
+                               numberOfCellsOfMultipartCell:(int)numberOfCellsOfMultipartCell
+                                             alignMoveNodes:(bool)alignMoveNodes
+{
+  GoNode* node = treeChange.node;
+  GoNode* parent = node.parent;
+  NSMutableDictionary* nodeMap = canvasData.nodeMap;
+
+  // The node must still be in the tree, at the place where it was inserted
+  if (! parent || parent != treeChange.parent)
+    return nil;
+  // The node must extend its parent's branch, i.e. it must not create a new
+  // branch
+  if (parent.firstChild != node || node.nextSibling)
+    return nil;
+  // The node must not have descendants that we don't know about. Descendants
+  // are acceptable only if they are inserted by the next tree change.
+  if (node.firstChild && (! nextTreeChange || nextTreeChange.node != node.firstChild))
+    return nil;
+
+  NSValue* key = [NSValue valueWithNonretainedObject:node];
+  if ([nodeMap objectForKey:key])
+    return nil;
+
+  NSValue* parentKey = [NSValue valueWithNonretainedObject:parent];
+  NodeTreeViewBranchTuple* parentBranchTuple = [nodeMap objectForKey:parentKey];
+  if (! parentBranchTuple)
+    return nil;
+  if (parentBranchTuple->nextBranchTupleInBranch || parentBranchTuple->childBranches.count > 0)
+    return nil;
+
+  // With "condense move nodes" enabled the parent node may now have to be
+  // condensed, which would pull in the parent node's center cell and require
+  // the alignment of the parent node to be redone
+  if (parentBranchTuple->numberOfCellsForNode != [self numberOfCellsForNode:parent condenseMoveNodes:condenseMoveNodes numberOfCellsOfMultipartCell:numberOfCellsOfMultipartCell])
+    return nil;
+
+  NodeTreeViewBranch* branch = parentBranchTuple->branch;
+
+  // The childBranches member variable is initialized by the
+  // NodeTreeViewBranchTuple initializer
+  NodeTreeViewBranchTuple* branchTuple = [[[NodeTreeViewBranchTuple alloc] init] autorelease];
+  branchTuple->xPositionOfFirstCell = parentBranchTuple->xPositionOfFirstCell + parentBranchTuple->numberOfCellsForNode;
+  branchTuple->node = node;
+  branchTuple->nodeNumber = parentBranchTuple->nodeNumber + 1;
+  branchTuple->moveNumber = node.goMove ? node.goMove.moveNumber : 0;
+  branchTuple->symbol = [GoUtilities symbolForNode:node inGame:game];
+  branchTuple->numberOfCellsForNode = [self numberOfCellsForNode:node condenseMoveNodes:condenseMoveNodes numberOfCellsOfMultipartCell:numberOfCellsOfMultipartCell];
+  // This assumes that numberOfCellsForNode is always an uneven number
+  branchTuple->indexOfCenterCell = floorf(branchTuple->numberOfCellsForNode / 2.0);
+  branchTuple->branch = branch;
+  branchTuple->nodeIsCurrentBoardPositionNode = (node == canvasData.currentBoardPositionNode);
+  branchTuple->nodeIsInCurrentGameVariation = [nodeModel indexOfNode:node] >= 0;
+
+  if (alignMoveNodes)
+  {
+    GoMove* move = node.goMove;
+    if (move && ! [self alignAppendedBranchTuple:branchTuple withMove:move inCanvasData:canvasData])
+      return nil;
+  }
+
+  [branch->branchTuples addObject:branchTuple];
+  parentBranchTuple->nextBranchTupleInBranch = branchTuple;
+  nodeMap[key] = branchTuple;
+
+  return branchTuple;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Aligns the newly created NodeTreeViewBranchTuple object
+/// @a branchTuple, which represents the node of @a move, with the other move
+/// nodes that have the same move number. Adds @a branchTuple to the move data
+/// in @a canvasData.
+///
+/// Returns @e true if the alignment could be performed. Returns @e false if
+/// @a branchTuple is positioned further to the right than the other move
+/// nodes. In that case the other move nodes and their descendants would have
+/// to be shifted, which requires a full re-calculation.
+///
+/// This is an internal helper for
+/// appendBranchTupleForTreeChange:nextTreeChange:toCanvasData:nodeModel:inGame:condenseMoveNodes:numberOfCellsOfMultipartCell:alignMoveNodes:().
+// -----------------------------------------------------------------------------
+- (bool) alignAppendedBranchTuple:(NodeTreeViewBranchTuple*)branchTuple
+                         withMove:(GoMove*)move
+                     inCanvasData:(NodeTreeViewCanvasData*)canvasData
+{
+  NSMutableArray* branchTuplesForMoveNumbers = canvasData.branchTuplesForMoveNumbers;
+
+  int moveNumber = move.moveNumber;
+  if (moveNumber <= branchTuplesForMoveNumbers.count)
+  {
+    // The move nodes that are already present are aligned among each other,
+    // so it is sufficient to look at the first one
+    NSMutableArray* branchTuplesForMoveNumber = [branchTuplesForMoveNumbers objectAtIndex:moveNumber - 1];
+    NodeTreeViewBranchTuple* alignedBranchTuple = branchTuplesForMoveNumber.firstObject;
+    unsigned short targetXPositionOfCenterCell = (alignedBranchTuple->xPositionOfFirstCell +
+                                                  alignedBranchTuple->indexOfCenterCell);
+    unsigned short xPositionOfCenterCell = (branchTuple->xPositionOfFirstCell +
+                                            branchTuple->indexOfCenterCell);
+    if (xPositionOfCenterCell > targetXPositionOfCenterCell)
+      return false;
+
+    // The new node has no descendants yet, so only the new node itself needs
+    // to be shifted
+    branchTuple->xPositionOfFirstCell += targetXPositionOfCenterCell - xPositionOfCenterCell;
+  }
+
+  int highestMoveNumberThatAppearsInAtLeastTwoBranches = canvasData.highestMoveNumberThatAppearsInAtLeastTwoBranches;
+  [self collectDataFromMove:move branch:branchTuple->branch branchTuple:branchTuple branchTuplesForMoveNumbers:branchTuplesForMoveNumbers highestMoveNumberThatAppearsInAtLeastTwoBranches:&highestMoveNumberThatAppearsInAtLeastTwoBranches];
+  canvasData.highestMoveNumberThatAppearsInAtLeastTwoBranches = highestMoveNumberThatAppearsInAtLeastTwoBranches;
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Generates the cells for the NodeTreeViewBranchTuple objects in
+/// @a appendedBranchTuples, which were appended to the end of their branch,
+/// and for the NodeTreeViewBranchTuple objects that were previously at the end
+/// of the branch. Cells that already exist in @a canvasData are replaced.
+///
+/// This is an internal helper for updateCanvasIncrementallyWithTreeChanges:().
+// -----------------------------------------------------------------------------
+- (void) regenerateCellsForAppendedBranchTuples:(NSArray*)appendedBranchTuples
+                                   inCanvasData:(NodeTreeViewCanvasData*)canvasData
+                                 branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
+{
+  NodeTreeViewCellGrid* cellGrid = canvasData.cellGrid;
+  unsigned short highestXPosition = canvasData.highestXPosition;
+  GoNode* highestXPositionNode = canvasData.highestXPositionNode;
+
+  for (NodeTreeViewBranchTuple* appendedBranchTuple in appendedBranchTuples)
+  {
+    NodeTreeViewBranch* branch = appendedBranchTuple->branch;
+    NSMutableArray* branchTuples = branch->branchTuples;
+    NodeTreeViewBranchTuple* firstBranchTupleOfBranch = branchTuples.firstObject;
+    NodeTreeViewBranchTuple* lastBranchTupleOfBranch = branchTuples.lastObject;
+
+    // The branch tuple that precedes the appended branch tuple gains a
+    // connecting line to its right. If it was itself appended it will be
+    // regenerated a second time, which is harmless.
+    NSUInteger indexOfAppendedBranchTuple = [branchTuples indexOfObjectWithOptions:NSEnumerationReverse
+                                                                      passingTest:^BOOL(id object, NSUInteger index, BOOL* stop)
+    {
+      return (object == appendedBranchTuple);
+    }];
+    NodeTreeViewBranchTuple* previousBranchTuple = [branchTuples objectAtIndex:indexOfAppendedBranchTuple - 1];
+
+    unsigned short xPositionAfterPreviousBranchTuple;
+    if (indexOfAppendedBranchTuple >= 2)
+    {
+      NodeTreeViewBranchTuple* branchTupleBeforePreviousBranchTuple = [branchTuples objectAtIndex:indexOfAppendedBranchTuple - 2];
+      xPositionAfterPreviousBranchTuple = (branchTupleBeforePreviousBranchTuple->xPositionOfFirstCell +
+                                           branchTupleBeforePreviousBranchTuple->numberOfCellsForNode);
+    }
+    else if (branch->parentBranch)
+    {
+      xPositionAfterPreviousBranchTuple = (branch->parentBranchTupleBranchingNode->xPositionOfFirstCell +
+                                           branch->parentBranchTupleBranchingNode->numberOfCellsForNode);
+    }
+    else
+    {
+      xPositionAfterPreviousBranchTuple = 0;
+    }
+
+    for (NodeTreeViewBranchTuple* branchTuple in @[previousBranchTuple, appendedBranchTuple])
+    {
+      xPositionAfterPreviousBranchTuple = [self generateCellsForBranchTuple:branchTuple
+                                          xPositionAfterPreviousBranchTuple:xPositionAfterPreviousBranchTuple
+                                                          yPositionOfBranch:branch->yPosition
+                                                   firstBranchTupleOfBranch:firstBranchTupleOfBranch
+                                                    lastBranchTupleOfBranch:lastBranchTupleOfBranch
+                                                             branchingStyle:branchingStyle
+                                                                   cellGrid:cellGrid
+                                                           highestXPosition:&highestXPosition
+                                                       highestXPositionNode:&highestXPositionNode];
+    }
+  }
+
+  // The full re-calculation visits branches in depth-first order and keeps the
+  // first node that reaches the highest x-position. If an appended node reaches
+  // the same x-position as the existing node, but is in a branch that comes
+  // earlier in depth-first order, the appended node must win.
+  NodeTreeViewBranchTuple* highestXPositionBranchTuple = [canvasData.nodeMap objectForKey:[NSValue valueWithNonretainedObject:canvasData.highestXPositionNode]];
+  if (highestXPositionNode == canvasData.highestXPositionNode && highestXPositionBranchTuple)
+  {
+    for (NodeTreeViewBranchTuple* appendedBranchTuple in appendedBranchTuples)
+    {
+      if (appendedBranchTuple->branch == highestXPositionBranchTuple->branch)
+        continue;
+      unsigned short xPositionOfLastCell = appendedBranchTuple->xPositionOfFirstCell + appendedBranchTuple->numberOfCellsForNode - 1;
+      if (xPositionOfLastCell != highestXPosition)
+        continue;
+
+      NSMutableArray* branches = canvasData.branches;
+      if ([branches indexOfObject:appendedBranchTuple->branch] < [branches indexOfObject:highestXPositionBranchTuple->branch])
+      {
+        highestXPositionNode = appendedBranchTuple->node;
+        highestXPositionBranchTuple = appendedBranchTuple;
+      }
+    }
+  }
+
+  canvasData.highestXPosition = highestXPosition;
+  canvasData.highestXPositionNode = highestXPositionNode;
+}
+
 #pragma mark - Private API - Canvas calculation - Part 1: Collect branch data
 
 // -----------------------------------------------------------------------------
@@ -707,7 +1421,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
 /// to collect information about branches.
 // -----------------------------------------------------------------------------
 - (void) collectBranchDataInCanvasData:(NodeTreeViewCanvasData*)canvasData
-                   fromNodeTreeInModel:(GoNodeModel*)nodeModel
+              fromNodeTreeWithRootNode:(GoNode*)rootNode
+           nodesInCurrentGameVariation:(NSArray*)nodesInCurrentGameVariation
                                 inGame:(GoGame*)game
                      condenseMoveNodes:(bool)condenseMoveNodes
           numberOfCellsOfMultipartCell:(int)numberOfCellsOfMultipartCell
@@ -721,7 +1436,7 @@ static const unsigned short yPositionOfNodeNumber = 0;
 
   NSMutableArray* stack = [NSMutableArray array];
 
-  GoNode* currentNode = nodeModel.rootNode;
+  GoNode* currentNode = rootNode;
 
   // If a new branch is created, this must be used as the new branch's parent
   // branch
@@ -729,7 +1444,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
   unsigned short xPosition = 0;
   unsigned short nodeNumber = 0;
   int indexOfNodeFromCurrentGameVariation = 0;
-  GoNode* nodeFromCurrentGameVariation = [nodeModel nodeAtIndex:indexOfNodeFromCurrentGameVariation];
+  NSUInteger numberOfNodesInCurrentGameVariation = nodesInCurrentGameVariation.count;
+  GoNode* nodeFromCurrentGameVariation = [nodesInCurrentGameVariation objectAtIndex:indexOfNodeFromCurrentGameVariation];
 
   while (true)
   {
@@ -753,6 +1469,7 @@ static const unsigned short yPositionOfNodeNumber = 0;
       branchTuple->xPositionOfFirstCell = xPosition;
       branchTuple->node = currentNode;
       branchTuple->nodeNumber = nodeNumber;
+      branchTuple->moveNumber = currentNode.goMove ? currentNode.goMove.moveNumber : 0;
       branchTuple->symbol = [GoUtilities symbolForNode:currentNode inGame:game];
       branchTuple->numberOfCellsForNode = [self numberOfCellsForNode:currentNode condenseMoveNodes:condenseMoveNodes numberOfCellsOfMultipartCell:numberOfCellsOfMultipartCell];
       // This assumes that numberOfCellsForNode is always an uneven number
@@ -765,8 +1482,8 @@ static const unsigned short yPositionOfNodeNumber = 0;
         branchTuple->nodeIsInCurrentGameVariation = true;
 
         indexOfNodeFromCurrentGameVariation++;
-        if (indexOfNodeFromCurrentGameVariation < nodeModel.numberOfNodes)
-          nodeFromCurrentGameVariation = [nodeModel nodeAtIndex:indexOfNodeFromCurrentGameVariation];
+        if (indexOfNodeFromCurrentGameVariation < numberOfNodesInCurrentGameVariation)
+          nodeFromCurrentGameVariation = [nodesInCurrentGameVariation objectAtIndex:indexOfNodeFromCurrentGameVariation];
         else
           nodeFromCurrentGameVariation = nil;
       }
@@ -1291,7 +2008,7 @@ highestMoveNumberThatAppearsInAtLeastTwoBranches:(int*)highestMoveNumberThatAppe
 {
   unsigned short highestXPosition = 0;
   GoNode* highestXPositionNode = nil;
-  NSMutableDictionary* cellsDictionary = canvasData.cellsDictionary;
+  NodeTreeViewCellGrid* cellGrid = canvasData.cellGrid;
 
   NSMutableArray* branches = canvasData.branches;
   for (NodeTreeViewBranch* branch in branches)
@@ -1310,7 +2027,7 @@ highestMoveNumberThatAppearsInAtLeastTwoBranches:(int*)highestMoveNumberThatAppe
     [self generateCellsForBranch:branch
 xPositionAfterLastCellInBranchingTuple:xPositionAfterLastCellInBranchingTuple
                   branchingStyle:branchingStyle
-                 cellsDictionary:cellsDictionary
+                        cellGrid:cellGrid
                 highestXPosition:&highestXPosition
             highestXPositionNode:&highestXPositionNode];
   }
@@ -1325,7 +2042,7 @@ xPositionAfterLastCellInBranchingTuple:xPositionAfterLastCellInBranchingTuple
        - (void) generateCellsForBranch:(NodeTreeViewBranch*)branch
 xPositionAfterLastCellInBranchingTuple:(unsigned short)xPositionAfterLastCellInBranchingTuple
                         branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                       cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                              cellGrid:(NodeTreeViewCellGrid*)cellGrid
                       highestXPosition:(unsigned short*)highestXPosition
                   highestXPositionNode:(GoNode**)highestXPositionNode
 {
@@ -1343,7 +2060,8 @@ xPositionAfterLastCellInBranchingTuple:(unsigned short)xPositionAfterLastCellInB
                                                         yPositionOfBranch:branch->yPosition
                                                  firstBranchTupleOfBranch:firstBranchTupleOfBranch
                                                   lastBranchTupleOfBranch:lastBranchTupleOfBranch
-                                                           branchingStyle:branchingStyle                 cellsDictionary:cellsDictionary
+                                                           branchingStyle:branchingStyle
+                                                                 cellGrid:cellGrid
                                                          highestXPosition:highestXPosition
                                                      highestXPositionNode:highestXPositionNode];
   }
@@ -1366,7 +2084,7 @@ xPositionAfterLastCellInBranchingTuple:(unsigned short)xPositionAfterLastCellInB
                       firstBranchTupleOfBranch:(NodeTreeViewBranchTuple*)firstBranchTupleOfBranch
                        lastBranchTupleOfBranch:(NodeTreeViewBranchTuple*)lastBranchTupleOfBranch
                                 branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                               cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                                      cellGrid:(NodeTreeViewCellGrid*)cellGrid
                               highestXPosition:(unsigned short*)highestXPosition
                           highestXPositionNode:(GoNode**)highestXPositionNode
 {
@@ -1375,14 +2093,14 @@ xPositionAfterLastCellInBranchingTuple:(unsigned short)xPositionAfterLastCellInB
                                                                          yPositionOfBranch:yPositionOfBranch
                                                                   firstBranchTupleOfBranch:firstBranchTupleOfBranch
                                                                             branchingStyle:branchingStyle
-                                                                           cellsDictionary:cellsDictionary];
+                                                                                  cellGrid:cellGrid];
 
   if (branchTuple->childBranches.count > 0)
   {
     [self generateCellsBelowBranchTuple:branchTuple
                       yPositionOfBranch:yPositionOfBranch
                          branchingStyle:branchingStyle
-                        cellsDictionary:cellsDictionary];
+                               cellGrid:cellGrid];
   }
 
   [self generateCellsForBranchTuple:branchTuple
@@ -1391,7 +2109,7 @@ xPositionAfterLastCellInBranchingTuple:(unsigned short)xPositionAfterLastCellInB
             lastBranchTupleOfBranch:(NodeTreeViewBranchTuple*)lastBranchTupleOfBranch
 diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEstablished
                      branchingStyle:branchingStyle
-                    cellsDictionary:cellsDictionary
+                           cellGrid:cellGrid
                    highestXPosition:highestXPosition
                highestXPositionNode:highestXPositionNode];
 
@@ -1415,7 +2133,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
                       yPositionOfBranch:(unsigned short)yPositionOfBranch
                firstBranchTupleOfBranch:(NodeTreeViewBranchTuple*)firstBranchTupleOfBranch
                          branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                        cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                               cellGrid:(NodeTreeViewCellGrid*)cellGrid
 {
   bool diagonalConnectionToBranchingLineEstablished = false;
 
@@ -1445,8 +2163,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
     if (branchTuple->nodeIsInCurrentGameVariation)
       cell.linesSelectedGameVariation = cell.lines;
 
-    NodeTreeViewCellPosition* position = [NodeTreeViewCellPosition positionWithX:xPositionOfCell y:yPositionOfBranch];
-    cellsDictionary[position] = @[cell, branchTuple];
+    [cellGrid setCell:cell branchTuple:branchTuple atX:xPositionOfCell y:yPositionOfBranch];
   }
 
   return diagonalConnectionToBranchingLineEstablished;
@@ -1505,7 +2222,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
 - (void) generateCellsBelowBranchTuple:(NodeTreeViewBranchTuple*)branchTuple
                      yPositionOfBranch:(unsigned short)yPositionOfBranch
                         branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                       cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                              cellGrid:(NodeTreeViewCellGrid*)cellGrid
 {
   NodeTreeViewBranch* lastChildBranch = branchTuple->childBranches.lastObject;
 
@@ -1547,7 +2264,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
      nextChildBranchToDiagonallyConnect:nextChildBranchToDiagonallyConnect
       childBranchInCurrentGameVariation:childBranchInCurrentGameVariation
                          branchingStyle:branchingStyle
-                        cellsDictionary:cellsDictionary];
+                               cellGrid:cellGrid];
 
     if (yPosition == nextChildBranchToHorizontallyConnect->yPosition)
     {
@@ -1600,7 +2317,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
     nextChildBranchToDiagonallyConnect:(NodeTreeViewBranch*)nextChildBranchToDiagonallyConnect
      childBranchInCurrentGameVariation:(NodeTreeViewBranch*)childBranchInCurrentGameVariation
                         branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                       cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                              cellGrid:(NodeTreeViewCellGrid*)cellGrid
 {
   [self generateVerticalLineCellBelowBranchTuple:branchTuple
                                        xPosition:xPositionOfVerticalLineCell
@@ -1610,7 +2327,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
               nextChildBranchToDiagonallyConnect:nextChildBranchToDiagonallyConnect
                childBranchInCurrentGameVariation:childBranchInCurrentGameVariation
                                   branchingStyle:branchingStyle
-                                 cellsDictionary:cellsDictionary];
+                                        cellGrid:cellGrid];
 
   // If the branching node occupies more than one cell then we need to
   // create additional cells if there is a branch on the y-position
@@ -1622,7 +2339,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
                    xPositionOfVerticalLineCell:xPositionOfVerticalLineCell
          successorNodeIsInCurrentGameVariation:(nextChildBranchToHorizontallyConnect == childBranchInCurrentGameVariation)
                                 branchingStyle:branchingStyle
-                               cellsDictionary:cellsDictionary];
+                                      cellGrid:cellGrid];
   }
 }
 
@@ -1639,7 +2356,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
                nextChildBranchToDiagonallyConnect:(NodeTreeViewBranch*)nextChildBranchToDiagonallyConnect
                 childBranchInCurrentGameVariation:(NodeTreeViewBranch*)childBranchInCurrentGameVariation
                                    branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                                  cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                                         cellGrid:(NodeTreeViewCellGrid*)cellGrid
 {
   NodeTreeViewCellLines lines = NodeTreeViewCellLineNone;
   NodeTreeViewCellLines linesSelectedGameVariation = NodeTreeViewCellLineNone;
@@ -1696,8 +2413,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
     cell.lines = lines;
     cell.linesSelectedGameVariation = linesSelectedGameVariation;
 
-    NodeTreeViewCellPosition* position = [NodeTreeViewCellPosition positionWithX:xPosition y:yPosition];
-    cellsDictionary[position] = @[cell, branchTuple];
+    [cellGrid setCell:cell branchTuple:branchTuple atX:xPosition y:yPosition];
   }
 }
 
@@ -1712,7 +2428,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
                   xPositionOfVerticalLineCell:(unsigned short)xPositionOfVerticalLineCell
         successorNodeIsInCurrentGameVariation:(bool)successorNodeIsInCurrentGameVariation
                                branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                              cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                                     cellGrid:(NodeTreeViewCellGrid*)cellGrid
 {
   NodeTreeViewCellLines linesOfFirstCell;
   if (branchingStyle == NodeTreeViewBranchingStyleDiagonal)
@@ -1733,8 +2449,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
     if (successorNodeIsInCurrentGameVariation)
       cell.linesSelectedGameVariation = cell.lines;
 
-    NodeTreeViewCellPosition* position = [NodeTreeViewCellPosition positionWithX:xPosition y:yPosition];
-    cellsDictionary[position] = @[cell, branchTuple];
+    [cellGrid setCell:cell branchTuple:branchTuple atX:xPosition y:yPosition];
   }
 }
 
@@ -1747,10 +2462,17 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
              lastBranchTupleOfBranch:(NodeTreeViewBranchTuple*)lastBranchTupleOfBranch
 diagonalConnectionToBranchingLineEstablished:(bool)diagonalConnectionToBranchingLineEstablished
                       branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
-                     cellsDictionary:(NSMutableDictionary*)cellsDictionary
+                            cellGrid:(NodeTreeViewCellGrid*)cellGrid
                     highestXPosition:(unsigned short*)highestXPosition
                 highestXPositionNode:(GoNode**)highestXPositionNode
 {
+  // The cells may be generated at new positions
+  if (branchTuple->positions)
+  {
+    [branchTuple->positions release];
+    branchTuple->positions = nil;
+  }
+
   for (unsigned int indexOfCell = 0; indexOfCell < branchTuple->numberOfCellsForNode; indexOfCell++)
   {
     NodeTreeViewCell* cell = [NodeTreeViewCell emptyCell];
@@ -1769,8 +2491,7 @@ diagonalConnectionToBranchingLineEstablished:diagonalConnectionToBranchingLineEs
     cell.selected = branchTuple->nodeIsCurrentBoardPositionNode;
 
     unsigned short xPosition = branchTuple->xPositionOfFirstCell + indexOfCell;
-    NodeTreeViewCellPosition* position = [NodeTreeViewCellPosition positionWithX:xPosition y:yPositionOfBranch];
-    cellsDictionary[position] = @[cell, branchTuple];
+    [cellGrid setCell:cell branchTuple:branchTuple atX:xPosition y:yPositionOfBranch];
   }
 
   unsigned short xPositionOfLastCell = branchTuple->xPositionOfFirstCell + branchTuple->numberOfCellsForNode - 1;
@@ -1998,6 +2719,63 @@ diagonalConnectionToBranchingLineEstablished:(bool)diagonalConnectionToBranching
 
 #pragma mark - Private API - Canvas calculation - Part 5: Generate node numbers
 
+// -----------------------------------------------------------------------------
+/// @brief Discards the node numbers in @a canvasData and marks them as needing
+/// to be generated for the game variation whose leaf node is
+/// @a leafNodeOfCurrentGameVariation.
+///
+/// The node numbering algorithm numbers a game variation greedily, starting at
+/// the root node (see rule 4 in the documentation of generateNodeNumbers:()),
+/// and the node numbers in the longest game variation depend on the node
+/// numbers in the current game variation. The node numbers for a part of the
+/// canvas therefore cannot be generated in isolation. Instead the node numbers
+/// are generated as a whole, but only when they are needed for the first time.
+/// They then remain valid until the next canvas calculation discards them.
+// -----------------------------------------------------------------------------
+- (void) invalidateNodeNumbers:(NodeTreeViewCanvasData*)canvasData
+leafNodeOfCurrentGameVariation:(GoNode*)leafNodeOfCurrentGameVariation
+{
+  canvasData.nodeNumbersViewCellsDictionary = [NSMutableDictionary dictionary];
+  canvasData.nodeNumberingTuples = [NSMutableArray array];
+  canvasData.leafNodeOfCurrentGameVariation = leafNodeOfCurrentGameVariation;
+  canvasData.nodeNumbersNeedGeneration = true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Generates the node numbers in @a canvasData if they were discarded
+/// by invalidateNodeNumbers:leafNodeOfCurrentGameVariation:(). Does nothing
+/// if the node numbers are already up-to-date.
+// -----------------------------------------------------------------------------
+- (void) generateNodeNumbersIfNecessary:(NodeTreeViewCanvasData*)canvasData
+{
+  if (! canvasData.nodeNumbersNeedGeneration)
+    return;
+  canvasData.nodeNumbersNeedGeneration = false;
+
+  [self generateNodeNumbers:canvasData
+leafNodeOfCurrentGameVariation:canvasData.leafNodeOfCurrentGameVariation
+          condenseMoveNodes:self.nodeTreeViewModel.condenseMoveNodes
+             alignMoveNodes:self.nodeTreeViewModel.alignMoveNodes
+    numberOfNodeNumberCells:[self numberOfNodeNumberCells]
+         nodeNumberInterval:self.nodeTreeViewModel.nodeNumberInterval];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Generates the node numbers in the current canvas data if they are
+/// needed by a client of the public API and have not been generated yet.
+///
+/// Does nothing if the current canvas data is about to be replaced, because
+/// in that case the canvas data may refer to nodes that no longer exist. The
+/// node numbers remain empty until the canvas has been updated.
+// -----------------------------------------------------------------------------
+- (void) generateNodeNumbersOnDemand
+{
+  if (self.canvasNeedsUpdate || self.canvasCalculationOperation)
+    return;
+
+  [self generateNodeNumbersIfNecessary:self.canvasData];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Generates node numbers to horizontally label some or all of the cells
 /// that represent the nodes on the canvas.
@@ -2077,19 +2855,19 @@ diagonalConnectionToBranchingLineEstablished:(bool)diagonalConnectionToBranching
 ///   behind the rule: The user should not see other node numbers
 ///   appear/disappear only because the node selection changes.
 // -----------------------------------------------------------------------------
-- (void) generateNodeNumbers:(NodeTreeViewCanvasData*)canvasData
-                   nodeModel:(GoNodeModel*)nodeModel
-           condenseMoveNodes:(bool)condenseMoveNodes
-              alignMoveNodes:(bool)alignMoveNodes
-     numberOfNodeNumberCells:(int)numberOfNodeNumberCells
-          nodeNumberInterval:(int)nodeNumberInterval
+  - (void) generateNodeNumbers:(NodeTreeViewCanvasData*)canvasData
+leafNodeOfCurrentGameVariation:(GoNode*)leafNodeOfCurrentGameVariation
+             condenseMoveNodes:(bool)condenseMoveNodes
+                alignMoveNodes:(bool)alignMoveNodes
+       numberOfNodeNumberCells:(int)numberOfNodeNumberCells
+            nodeNumberInterval:(int)nodeNumberInterval
 {
   NSDictionary* nodeMap = canvasData.nodeMap;
   NSMutableDictionary* nodeNumbersViewCellsDictionary = canvasData.nodeNumbersViewCellsDictionary;
   int numberOfNodeNumberCellsExtendingFromCenter = [self numberOfNodeNumberCellsExtendingFromCenter];
 
   // Rule 5: Number the current game variation
-  NSMutableArray* nodeNumberingTuplesCurrentGameVariation = [self generateNodeNumbersForGameVariation:nodeModel.leafNode
+  NSMutableArray* nodeNumberingTuplesCurrentGameVariation = [self generateNodeNumbersForGameVariation:leafNodeOfCurrentGameVariation
                                                                   gameVariationIsCurrentGameVariation:true
                                                                  nodeNumberingTuplesPreviousVariation:nil
                                                                                               nodeMap:nodeMap
@@ -2102,7 +2880,7 @@ diagonalConnectionToBranchingLineEstablished:(bool)diagonalConnectionToBranching
 
   // Rule 9: Number the longest game variation, unless the user preferences
   // prevent it
-  if (nodeModel.leafNode != canvasData.highestXPositionNode && ! (condenseMoveNodes || alignMoveNodes))
+  if (leafNodeOfCurrentGameVariation != canvasData.highestXPositionNode && ! (condenseMoveNodes || alignMoveNodes))
   {
     NSMutableArray* nodeNumberingTuplesLongestGameVariation = [self generateNodeNumbersForGameVariation:canvasData.highestXPositionNode
                                                                     gameVariationIsCurrentGameVariation:false
@@ -2704,13 +3482,20 @@ numberOfNodeNumberCellsExtendingFromCenter:(int)numberOfNodeNumberCellsExtending
 /// objects that indicate which cells on the node tree view canvas display the
 /// node represented by @a branchTuple. The list is empty if @a branchTuple is
 /// @e nil, or if no positions exist for @a branchTuple.
+///
+/// The list is cached in @a branchTuple, so that together with the
+/// NodeTreeViewBranchTuple lookup in the node map finding the positions of a
+/// node is a constant-time operation that does not allocate any objects.
 // -----------------------------------------------------------------------------
 - (NSArray*) positionsForBranchTuple:(NodeTreeViewBranchTuple*)branchTuple
 {
-  NSMutableArray* positions = [NSMutableArray array];
-
   if (! branchTuple)
-    return positions;
+    return @[];
+
+  if (branchTuple->positions)
+    return branchTuple->positions;
+
+  NSMutableArray* positions = [NSMutableArray array];
 
   unsigned short xPositionOfFirstCell = branchTuple->xPositionOfFirstCell;
   unsigned short xPositionOfLastCell = branchTuple->xPositionOfFirstCell + branchTuple->numberOfCellsForNode - 1;
@@ -2721,7 +3506,8 @@ numberOfNodeNumberCellsExtendingFromCenter:(int)numberOfNodeNumberCellsExtending
     [positions addObject:position];
   }
 
-  return positions;
+  branchTuple->positions = [positions copy];
+  return branchTuple->positions;
 }
 
 // -----------------------------------------------------------------------------
@@ -2769,11 +3555,15 @@ numberOfNodeNumberCellsExtendingFromCenter:(int)numberOfNodeNumberCellsExtending
 /// NodeTreeViewCellPosition objects in the second list may refer to cells for
 /// which there no longer are any NodeNumbersViewCell objects. This happens if
 /// the node number for @a node existed purely to mark @a node as selected.
+///
+/// If @a nodeNumbersViewCellsDictionary is @e nil the node numbers have not
+/// been generated yet. In that case no NodeNumbersViewCell objects are updated,
+/// but the second list is still returned.
 // -----------------------------------------------------------------------------
 - (NSArray*) updateSelectedStateOfCellsForNode:(GoNode*)node
                                     toNewState:(bool)newSelectedState
                                        nodeMap:(NSDictionary*)nodeMap
-                               cellsDictionary:(NSDictionary*)cellsDictionary
+                                      cellGrid:(NodeTreeViewCellGrid*)cellGrid
                 nodeNumbersViewCellsDictionary:(NSMutableDictionary*)nodeNumbersViewCellsDictionary
 {
   NodeTreeViewBranchTuple* branchTuple = [self branchTupleForNode:node];
@@ -2782,18 +3572,18 @@ numberOfNodeNumberCellsExtendingFromCenter:(int)numberOfNodeNumberCellsExtending
   NSArray* positions = [self positionsForBranchTuple:branchTuple];
   for (NodeTreeViewCellPosition* position in positions)
   {
-    NSArray* tuple = [cellsDictionary objectForKey:position];
-    if (tuple)
-    {
-      NodeTreeViewCell* cell = tuple.firstObject;
+    NodeTreeViewCell* cell = [cellGrid cellAtX:position.x y:position.y];
+    if (cell)
       cell.selected = newSelectedState;
-    }
   }
 
+  NSArray* nodeNumbersViewPositions = [self nodeNumbersViewPositionsForBranchTuple:branchTuple];
+  if (! nodeNumbersViewCellsDictionary)
+    return @[positions, nodeNumbersViewPositions];
+
   int numberOfNodeNumberCells = [self numberOfNodeNumberCells];
   int numberOfNodeNumberCellsExtendingFromCenter = [self numberOfNodeNumberCellsExtendingFromCenter];
 
-  NSArray* nodeNumbersViewPositions = [self nodeNumbersViewPositionsForBranchTuple:branchTuple];
   for (NodeTreeViewCellPosition* position in nodeNumbersViewPositions)
   {
     NodeNumbersViewCell* cell = [nodeNumbersViewCellsDictionary objectForKey:position];
@@ -2885,7 +3675,13 @@ numberOfNodeNumberCellsExtendingFromCenter:(int)numberOfNodeNumberCellsExtending
 // -----------------------------------------------------------------------------
 - (NSDictionary*) getCellsDictionary
 {
-  return self.canvasData.cellsDictionary;
+  NSMutableDictionary* cellsDictionary = [NSMutableDictionary dictionary];
+  [self.canvasData.cellGrid enumerateCellsUsingBlock:^(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple)
+  {
+    NodeTreeViewCellPosition* position = [NodeTreeViewCellPosition positionWithX:x y:y];
+    cellsDictionary[position] = @[cell, branchTuple];
+  }];
+  return cellsDictionary;
 }
 
 // -----------------------------------------------------------------------------
@@ -2893,6 +3689,7 @@ numberOfNodeNumberCellsExtendingFromCenter:(int)numberOfNodeNumberCellsExtending
 // -----------------------------------------------------------------------------
 - (NSDictionary*) getNodeNumbersViewCellsDictionary
 {
+  [self generateNodeNumbersOnDemand];
   return self.canvasData.nodeNumbersViewCellsDictionary;
 }
 
@@ -17,6 +17,7 @@
 
 // Forward declarations
 @class GoNode;
+@class NodeTreeViewCellGrid;
 
 
 // -----------------------------------------------------------------------------
@@ -56,22 +57,23 @@
 /// the current board position.
 @property(nonatomic, retain) GoNode* currentBoardPositionNode;
 
-/// @brief Maps NodeTreeViewCellPosition objects to tuples consisting of
-/// a NodeTreeViewCell object and a NodeTreeViewBranchTuple object.
+/// @brief Stores NodeTreeViewCell objects, together with the
+/// NodeTreeViewBranchTuple objects they belong to, at their x/y positions on
+/// the canvas.
 ///
-/// This dictionary provides the data that is consumed by the node tree view's
+/// This grid provides the data that is consumed by the node tree view's
 /// drawing routines.
-@property(nonatomic, retain) NSMutableDictionary* cellsDictionary;
+@property(nonatomic, retain) NodeTreeViewCellGrid* cellGrid;
 
-/// @brief The highest x-position of any cell in @a cellsDictionary, i.e. the
+/// @brief The highest x-position of any cell in @a cellGrid, i.e. the
 /// zero-based width of the canvas.
 @property(nonatomic, assign) unsigned short highestXPosition;
 
-/// @brief A GoNode object which is represented by a cell in @a cellsDictionary
+/// @brief A GoNode object which is represented by a cell in @a cellGrid
 /// whose x-position is equal to @e highestXPosition.
 @property(nonatomic, assign) GoNode* highestXPositionNode;
 
-/// @brief The highest y-position of any cell in @a cellsDictionary, i.e. the
+/// @brief The highest y-position of any cell in @a cellGrid, i.e. the
 /// zero-based height of the canvas.
 @property(nonatomic, assign) unsigned short highestYPosition;
 
@@ -104,4 +106,17 @@
 /// the tuple value 2.
 @property(nonatomic, retain) NSMutableArray* nodeNumberingTuples;
 
+/// @brief Stores a reference to the leaf node of the game variation that was
+/// the current game variation when the canvas data was calculated. Node numbers
+/// are generated for this game variation.
+@property(nonatomic, retain) GoNode* leafNodeOfCurrentGameVariation;
+
+/// @brief True if @e nodeNumbersViewCellsDictionary and @e nodeNumberingTuples
+/// are empty and must be generated before they can be used. False if they are
+/// up-to-date.
+///
+/// Node numbers are generated only when they are needed for the first time,
+/// not as part of the canvas calculation.
+@property(nonatomic, assign) bool nodeNumbersNeedGeneration;
+
 @end
@@ -17,6 +17,7 @@
 
 // Project includes
 #import "NodeTreeViewCanvasData.h"
+#import "NodeTreeViewCellGrid.h"
 
 
 @implementation NodeTreeViewCanvasData
@@ -40,12 +41,14 @@
   self.branchTuplesForMoveNumbers = [NSMutableArray array];
   self.highestMoveNumberThatAppearsInAtLeastTwoBranches = -1;
   self.currentBoardPositionNode = nil;
-  self.cellsDictionary = [NSMutableDictionary dictionary];
+  self.cellGrid = [[[NodeTreeViewCellGrid alloc] init] autorelease];
   self.highestXPosition = -1;
   self.highestXPositionNode = nil;
   self.highestYPosition = -1;
   self.nodeNumbersViewCellsDictionary = [NSMutableDictionary dictionary];
   self.nodeNumberingTuples = [NSMutableArray array];
+  self.leafNodeOfCurrentGameVariation = nil;
+  self.nodeNumbersNeedGeneration = false;
 
   return self;
 }
@@ -59,10 +62,11 @@
   self.branches = nil;
   self.branchTuplesForMoveNumbers = nil;
   self.currentBoardPositionNode = nil;
-  self.cellsDictionary = nil;
+  self.cellGrid = nil;
   self.highestXPositionNode = nil;
   self.nodeNumbersViewCellsDictionary = nil;
   self.nodeNumberingTuples = nil;
+  self.leafNodeOfCurrentGameVariation = nil;
   
   [super dealloc];
 }
@@ -86,12 +90,14 @@
     copy.branchTuplesForMoveNumbers = [NSMutableArray arrayWithArray:_branchTuplesForMoveNumbers];
     copy.highestMoveNumberThatAppearsInAtLeastTwoBranches = _highestMoveNumberThatAppearsInAtLeastTwoBranches;
     copy.currentBoardPositionNode = _currentBoardPositionNode;
-    copy.cellsDictionary = [NSMutableDictionary dictionaryWithDictionary:_cellsDictionary];
+    copy.cellGrid = [[_cellGrid copy] autorelease];
     copy.highestXPosition = _highestXPosition;
     copy.highestXPositionNode = _highestXPositionNode;
     copy.highestYPosition = _highestYPosition;
     copy.nodeNumbersViewCellsDictionary = [NSMutableDictionary dictionaryWithDictionary:_nodeNumbersViewCellsDictionary];
     copy.nodeNumberingTuples = [NSMutableArray arrayWithArray:_nodeNumberingTuples];
+    copy.leafNodeOfCurrentGameVariation = _leafNodeOfCurrentGameVariation;
+    copy.nodeNumbersNeedGeneration = _nodeNumbersNeedGeneration;
   }
   return copy;
 }
@@ -0,0 +1,65 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class NodeTreeViewBranchTuple;
+@class NodeTreeViewCell;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The NodeTreeViewCellGrid class stores the NodeTreeViewCell objects
+/// that make up the node tree view canvas, together with the
+/// NodeTreeViewBranchTuple objects that the cells belong to. Cells are
+/// addressed by their integer x/y coordinates on the canvas.
+///
+/// The grid is sparse and organized in rows. Each row is divided into chunks
+/// of a fixed number of horizontally adjacent cells. A chunk is allocated only
+/// when the first cell is stored in it, so large empty areas of the canvas
+/// (e.g. to the right of a short branch) do not use memory. Looking up a cell
+/// requires no hashing and no key object, only two array index operations.
+/// Cells that are drawn on the same tile are mostly stored in the same chunk,
+/// which makes the lookups performed during drawing cache-friendly.
+///
+/// NodeTreeViewCellGrid retains the NodeTreeViewCell and
+/// NodeTreeViewBranchTuple objects that are stored in it.
+///
+/// NodeTreeViewCellGrid is not thread-safe.
+// -----------------------------------------------------------------------------
+@interface NodeTreeViewCellGrid : NSObject <NSCopying>
+{
+}
+
+- (id) init;
+
+- (void) setCell:(NodeTreeViewCell*)cell
+     branchTuple:(NodeTreeViewBranchTuple*)branchTuple
+             atX:(unsigned short)x
+               y:(unsigned short)y;
+- (NodeTreeViewCell*) cellAtX:(unsigned short)x y:(unsigned short)y;
+- (NodeTreeViewBranchTuple*) branchTupleAtX:(unsigned short)x y:(unsigned short)y;
+- (void) removeAllCells;
+- (void) enumerateCellsUsingBlock:(void (^)(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple))block;
+- (void) enumerateCellsFromX:(unsigned short)fromX
+                         toX:(unsigned short)toX
+                       fromY:(unsigned short)fromY
+                         toY:(unsigned short)toY
+                  usingBlock:(void (^)(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple))block;
+
+/// @brief The number of cells that are stored in the grid.
+@property(nonatomic, assign, readonly) NSUInteger numberOfCells;
+
+@end
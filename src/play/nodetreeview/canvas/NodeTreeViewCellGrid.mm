@@ -0,0 +1,279 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "NodeTreeViewCellGrid.h"
+
+// C++ standard library
+#include <climits>
+#include <vector>
+
+
+/// @brief The number of horizontally adjacent cells that are stored together
+/// in one chunk.
+static const unsigned short numberOfCellsPerChunk = 64;
+
+/// @brief A single slot of the grid. Both members are @e nil if the slot is
+/// empty.
+struct NodeTreeViewCellGridEntry
+{
+  NodeTreeViewCell* cell;
+  NodeTreeViewBranchTuple* branchTuple;
+};
+
+/// @brief A chunk of horizontally adjacent slots.
+struct NodeTreeViewCellGridChunk
+{
+  NodeTreeViewCellGridEntry entries[numberOfCellsPerChunk];
+};
+
+/// @brief A row of the grid. Elements are @e nullptr for chunks that were
+/// never allocated.
+typedef std::vector<NodeTreeViewCellGridChunk*> NodeTreeViewCellGridRow;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for NodeTreeViewCellGrid.
+// -----------------------------------------------------------------------------
+@interface NodeTreeViewCellGrid()
+@property(nonatomic, assign, readwrite) NSUInteger numberOfCells;
+@property(nonatomic, assign) std::vector<NodeTreeViewCellGridRow>* rows;
+@end
+
+
+@implementation NodeTreeViewCellGrid
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes an empty NodeTreeViewCellGrid object.
+///
+/// @note This is the designated initializer of NodeTreeViewCellGrid.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  _numberOfCells = 0;
+  _rows = new std::vector<NodeTreeViewCellGridRow>();
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this NodeTreeViewCellGrid object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self removeAllCells];
+  delete _rows;
+  _rows = nullptr;
+
+  [super dealloc];
+}
+
+#pragma mark - NSCopying protocol
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a newly allocated NodeTreeViewCellGrid object that is a copy
+/// of the receiver and that is owned by the sender. The returned instance
+/// shares the NodeTreeViewCell and NodeTreeViewBranchTuple objects with the
+/// receiver.
+// -----------------------------------------------------------------------------
+- (instancetype) copyWithZone:(NSZone*)zone
+{
+  NodeTreeViewCellGrid* copy = [[[self class] allocWithZone:zone] init];
+  if (copy)
+  {
+    [self enumerateCellsUsingBlock:^(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple)
+    {
+      [copy setCell:cell branchTuple:branchTuple atX:x y:y];
+    }];
+  }
+  return copy;
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Stores @a cell and @a branchTuple at position @a x / @a y. Replaces
+/// the cell and branch tuple that were previously stored at that position.
+// -----------------------------------------------------------------------------
+- (void) setCell:(NodeTreeViewCell*)cell
+     branchTuple:(NodeTreeViewBranchTuple*)branchTuple
+             atX:(unsigned short)x
+               y:(unsigned short)y
+{
+  if (y >= _rows->size())
+    _rows->resize(y + 1);
+  NodeTreeViewCellGridRow& row = (*_rows)[y];
+
+  size_t indexOfChunk = x / numberOfCellsPerChunk;
+  if (indexOfChunk >= row.size())
+    row.resize(indexOfChunk + 1, nullptr);
+  NodeTreeViewCellGridChunk* chunk = row[indexOfChunk];
+  if (! chunk)
+  {
+    // Value-initialization sets all entries to nil
+    chunk = new NodeTreeViewCellGridChunk();
+    row[indexOfChunk] = chunk;
+  }
+
+  NodeTreeViewCellGridEntry& entry = chunk->entries[x % numberOfCellsPerChunk];
+  if (! entry.cell)
+    _numberOfCells++;
+
+  // Retain before release in case the same objects are stored again
+  [cell retain];
+  [branchTuple retain];
+  [entry.cell release];
+  [entry.branchTuple release];
+  entry.cell = cell;
+  entry.branchTuple = branchTuple;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the NodeTreeViewCell object that is stored at position
+/// @a x / @a y. Returns @e nil if no cell is stored at that position.
+// -----------------------------------------------------------------------------
+- (NodeTreeViewCell*) cellAtX:(unsigned short)x y:(unsigned short)y
+{
+  NodeTreeViewCellGridEntry* entry = [self entryAtX:x y:y];
+  return entry ? entry->cell : nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the NodeTreeViewBranchTuple object that is stored at position
+/// @a x / @a y. Returns @e nil if no cell is stored at that position.
+// -----------------------------------------------------------------------------
+- (NodeTreeViewBranchTuple*) branchTupleAtX:(unsigned short)x y:(unsigned short)y
+{
+  NodeTreeViewCellGridEntry* entry = [self entryAtX:x y:y];
+  return entry ? entry->branchTuple : nil;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes all cells from the grid and releases the memory that was
+/// used to store them.
+// -----------------------------------------------------------------------------
+- (void) removeAllCells
+{
+  for (NodeTreeViewCellGridRow& row : *_rows)
+  {
+    for (NodeTreeViewCellGridChunk* chunk : row)
+    {
+      if (! chunk)
+        continue;
+      for (NodeTreeViewCellGridEntry& entry : chunk->entries)
+      {
+        [entry.cell release];
+        [entry.branchTuple release];
+      }
+      delete chunk;
+    }
+  }
+
+  _rows->clear();
+  _numberOfCells = 0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Invokes @a block once for every cell that is stored in the grid. The
+/// cells are enumerated row by row, and within a row from left to right.
+// -----------------------------------------------------------------------------
+- (void) enumerateCellsUsingBlock:(void (^)(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple))block
+{
+  [self enumerateCellsFromX:0
+                        toX:USHRT_MAX
+                      fromY:0
+                        toY:USHRT_MAX
+                 usingBlock:block];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Invokes @a block once for every cell that is stored in the grid
+/// within the rectangle that extends from @a fromX / @a fromY to @a toX /
+/// @a toY (both inclusive). The cells are enumerated row by row, and within a
+/// row from left to right.
+///
+/// Only rows and chunks that intersect with the rectangle are examined, and
+/// chunks that were never allocated are skipped entirely. The cost of the
+/// enumeration therefore depends on the size of the rectangle, not on the
+/// size of the grid.
+// -----------------------------------------------------------------------------
+- (void) enumerateCellsFromX:(unsigned short)fromX
+                         toX:(unsigned short)toX
+                       fromY:(unsigned short)fromY
+                         toY:(unsigned short)toY
+                  usingBlock:(void (^)(unsigned short x, unsigned short y, NodeTreeViewCell* cell, NodeTreeViewBranchTuple* branchTuple))block
+{
+  if (fromX > toX || fromY > toY)
+    return;
+
+  size_t numberOfRows = _rows->size();
+  for (size_t y = fromY; y <= toY && y < numberOfRows; y++)
+  {
+    NodeTreeViewCellGridRow& row = (*_rows)[y];
+    size_t numberOfChunks = row.size();
+    size_t indexOfLastChunk = toX / numberOfCellsPerChunk;
+    for (size_t indexOfChunk = fromX / numberOfCellsPerChunk; indexOfChunk <= indexOfLastChunk && indexOfChunk < numberOfChunks; indexOfChunk++)
+    {
+      NodeTreeViewCellGridChunk* chunk = row[indexOfChunk];
+      if (! chunk)
+        continue;
+
+      size_t xOfFirstEntry = indexOfChunk * numberOfCellsPerChunk;
+      size_t indexOfFirstEntry = (fromX > xOfFirstEntry) ? fromX - xOfFirstEntry : 0;
+      size_t indexOfLastEntry = (toX < xOfFirstEntry + numberOfCellsPerChunk - 1) ? toX - xOfFirstEntry : numberOfCellsPerChunk - 1;
+      for (size_t indexOfEntry = indexOfFirstEntry; indexOfEntry <= indexOfLastEntry; indexOfEntry++)
+      {
+        NodeTreeViewCellGridEntry& entry = chunk->entries[indexOfEntry];
+        if (entry.cell)
+          block(xOfFirstEntry + indexOfEntry, y, entry.cell, entry.branchTuple);
+      }
+    }
+  }
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the grid entry at position @a x / @a y. Returns @e nullptr
+/// if the chunk that would contain the entry was never allocated. The
+/// members of the returned entry are @e nil if no cell is stored at that
+/// position.
+// -----------------------------------------------------------------------------
+- (NodeTreeViewCellGridEntry*) entryAtX:(unsigned short)x y:(unsigned short)y
+{
+  if (y >= _rows->size())
+    return nullptr;
+  NodeTreeViewCellGridRow& row = (*_rows)[y];
+
+  size_t indexOfChunk = x / numberOfCellsPerChunk;
+  if (indexOfChunk >= row.size())
+    return nullptr;
+  NodeTreeViewCellGridChunk* chunk = row[indexOfChunk];
+  if (! chunk)
+    return nullptr;
+
+  return &chunk->entries[x % numberOfCellsPerChunk];
+}
+
+@end
@@ -0,0 +1,77 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class NodeTreeViewCanvasData;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The NodeTreeViewLayoutCache class stores the layout of node trees
+/// calculated by NodeTreeViewCanvas, so that the layout does not have to be
+/// calculated again when the same node tree is displayed again, e.g. when a
+/// large game is restored after the app was relaunched.
+///
+/// The layout of a node tree consists of the final x-position of every node
+/// (after move nodes were aligned) and the y-position of every branch. These
+/// are the results of steps 2 and 3 of the canvas calculation algorithm (see
+/// NodeTreeViewCanvas::recalculateCanvasPrivate()), which are the steps whose
+/// cost grows fastest with the size of the node tree. The cells are not
+/// cached because they consist of many objects, and generating them from the
+/// restored layout is cheap.
+///
+/// The layout is stored under a key that is derived from the branch data
+/// that step 1 of the algorithm collects. The key covers the structure of the
+/// node tree, the number of cells of each node (which reflects the user
+/// preferences "condense move nodes" and "number of cells of multipart
+/// cell"), the move numbers, and the user preferences "align move nodes" and
+/// "branching style". Any edit of the node tree or any change of these user
+/// preferences therefore results in a different key, so a cached layout never
+/// has to be invalidated explicitly. Least recently used layouts are
+/// discarded when the cache holds more than @e maximumNumberOfLayouts
+/// layouts.
+///
+/// NodeTreeViewLayoutCache stores its content in a file in the Caches folder.
+/// Layouts that are stored after a full canvas calculation are written to the
+/// file immediately. Layouts that are stored after an incremental canvas
+/// update are written to the file only when the app enters the background,
+/// because incremental updates occur frequently, e.g. every time a move is
+/// played.
+///
+/// All methods of NodeTreeViewLayoutCache are thread-safe.
+// -----------------------------------------------------------------------------
+@interface NodeTreeViewLayoutCache : NSObject
+{
+}
+
+- (id) initWithFilePath:(NSString*)filePath;
+
+- (bool) restoreLayoutInCanvasData:(NodeTreeViewCanvasData*)canvasData
+                    alignMoveNodes:(bool)alignMoveNodes
+                    branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle;
+- (void) storeLayoutOfCanvasData:(NodeTreeViewCanvasData*)canvasData
+                  alignMoveNodes:(bool)alignMoveNodes
+                  branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
+          writeToFileImmediately:(bool)writeToFileImmediately;
+- (void) writeToFileIfNecessary;
+
+/// @brief The full path of the file in which the cache stores its content.
+@property(nonatomic, retain, readonly) NSString* filePath;
+/// @brief The maximum number of layouts that the cache holds. The default is
+/// #nodeTreeViewLayoutCacheMaximumNumberOfLayouts.
+@property(nonatomic, assign) int maximumNumberOfLayouts;
+
+@end
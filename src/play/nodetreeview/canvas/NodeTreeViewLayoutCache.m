@@ -0,0 +1,381 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "NodeTreeViewLayoutCache.h"
+#import "NodeTreeViewBranch.h"
+#import "NodeTreeViewBranchTuple.h"
+#import "NodeTreeViewCanvasData.h"
+
+
+// Keys of the dictionary that is stored in the cache file
+static NSString* layoutKeysKey = @"LayoutKeys";
+static NSString* layoutsKey = @"Layouts";
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for NodeTreeViewLayoutCache.
+// -----------------------------------------------------------------------------
+@interface NodeTreeViewLayoutCache()
+@property(nonatomic, retain, readwrite) NSString* filePath;
+/// @brief Keys of the cached layouts, ordered from least recently used to
+/// most recently used. Is @e nil until the cache file has been read.
+@property(nonatomic, retain) NSMutableArray* layoutKeys;
+/// @brief Key = Layout key, value = NSData object with the layout.
+@property(nonatomic, retain) NSMutableDictionary* layouts;
+/// @brief True if the in-memory content has changes that have not yet been
+/// written to the cache file.
+@property(nonatomic, assign) bool needsWriteToFile;
+@end
+
+
+@implementation NodeTreeViewLayoutCache
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a NodeTreeViewLayoutCache object that stores its content
+/// in the file @a filePath. The file is read lazily when the first layout is
+/// restored or stored.
+///
+/// @note This is the designated initializer of NodeTreeViewLayoutCache.
+// -----------------------------------------------------------------------------
+- (id) initWithFilePath:(NSString*)filePath
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.filePath = filePath;
+  self.maximumNumberOfLayouts = nodeTreeViewLayoutCacheMaximumNumberOfLayouts;
+  self.layoutKeys = nil;
+  self.layouts = nil;
+  self.needsWriteToFile = false;
+
+  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  [center addObserver:self selector:@selector(applicationDidEnterBackground:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this NodeTreeViewLayoutCache object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+
+  self.filePath = nil;
+  self.layoutKeys = nil;
+  self.layouts = nil;
+
+  [super dealloc];
+}
+
+#pragma mark - Notification responders
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #UIApplicationDidEnterBackgroundNotification
+/// notification.
+// -----------------------------------------------------------------------------
+- (void) applicationDidEnterBackground:(NSNotification*)notification
+{
+  [self writeToFileIfNecessary];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Looks up the layout of the node tree whose branch data is stored in
+/// @a canvasData. If the cache contains a layout, assigns the x-positions of
+/// all nodes and the y-positions of all branches from the layout to the
+/// objects in @a canvasData, updates the @e highestYPosition property of
+/// @a canvasData and returns true. Returns false if the cache contains no
+/// layout.
+///
+/// @a canvasData must contain the result of step 1 of the canvas calculation
+/// algorithm.
+// -----------------------------------------------------------------------------
+- (bool) restoreLayoutInCanvasData:(NodeTreeViewCanvasData*)canvasData
+                    alignMoveNodes:(bool)alignMoveNodes
+                    branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
+{
+  NSString* layoutKey = [self layoutKeyForCanvasData:canvasData
+                                      alignMoveNodes:alignMoveNodes
+                                      branchingStyle:branchingStyle];
+
+  NSData* layout;
+  @synchronized(self)
+  {
+    [self readFromFileIfNecessary];
+
+    layout = [self.layouts objectForKey:layoutKey];
+    if (! layout)
+      return false;
+
+    [self markLayoutKeyAsMostRecentlyUsed:layoutKey];
+    // Keep the layout alive even if another thread discards it
+    [[layout retain] autorelease];
+  }
+
+  NSArray* branches = canvasData.branches;
+  NSUInteger numberOfBranches = branches.count;
+  NSUInteger numberOfBranchTuples = 0;
+  for (NodeTreeViewBranch* branch in branches)
+    numberOfBranchTuples += branch->branchTuples.count;
+
+  // The counts are part of the layout key, so a mismatch can only be caused by
+  // a corrupt cache file
+  NSUInteger expectedLength = (2 + numberOfBranches + numberOfBranchTuples) * sizeof(unsigned short);
+  const unsigned short* values = (const unsigned short*)layout.bytes;
+  if (layout.length != expectedLength || values[0] != numberOfBranches || values[1] != numberOfBranchTuples)
+  {
+    DDLogError(@"%@: Discarding corrupt layout %@", self, layoutKey);
+    @synchronized(self)
+    {
+      [self.layouts removeObjectForKey:layoutKey];
+      [self.layoutKeys removeObject:layoutKey];
+      self.needsWriteToFile = true;
+    }
+    return false;
+  }
+
+  const unsigned short* yPositions = values + 2;
+  const unsigned short* xPositions = yPositions + numberOfBranches;
+
+  unsigned short highestYPosition = 0;
+  NSUInteger indexOfBranchTuple = 0;
+  for (NSUInteger indexOfBranch = 0; indexOfBranch < numberOfBranches; indexOfBranch++)
+  {
+    NodeTreeViewBranch* branch = [branches objectAtIndex:indexOfBranch];
+    branch->yPosition = yPositions[indexOfBranch];
+    if (branch->yPosition > highestYPosition)
+      highestYPosition = branch->yPosition;
+
+    for (NodeTreeViewBranchTuple* branchTuple in branch->branchTuples)
+      branchTuple->xPositionOfFirstCell = xPositions[indexOfBranchTuple++];
+  }
+
+  canvasData.highestYPosition = highestYPosition;
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Stores the layout of the node tree whose data is stored in
+/// @a canvasData. @a canvasData must contain the results of steps 1-3 of the
+/// canvas calculation algorithm.
+///
+/// If @a writeToFileImmediately is true the cache file is written before this
+/// method returns. If @a writeToFileImmediately is false the cache file is
+/// written later, either when writeToFileIfNecessary() is invoked or when the
+/// app enters the background.
+// -----------------------------------------------------------------------------
+- (void) storeLayoutOfCanvasData:(NodeTreeViewCanvasData*)canvasData
+                  alignMoveNodes:(bool)alignMoveNodes
+                  branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
+          writeToFileImmediately:(bool)writeToFileImmediately
+{
+  NSString* layoutKey = [self layoutKeyForCanvasData:canvasData
+                                      alignMoveNodes:alignMoveNodes
+                                      branchingStyle:branchingStyle];
+
+  NSArray* branches = canvasData.branches;
+  NSUInteger numberOfBranches = branches.count;
+  NSUInteger numberOfBranchTuples = 0;
+  for (NodeTreeViewBranch* branch in branches)
+    numberOfBranchTuples += branch->branchTuples.count;
+
+  // The layout stores positions as unsigned short, the same type that the
+  // canvas uses, so the counts are bound to fit as well
+  if (numberOfBranches > USHRT_MAX || numberOfBranchTuples > USHRT_MAX)
+    return;
+
+  NSMutableData* layout = [NSMutableData dataWithLength:(2 + numberOfBranches + numberOfBranchTuples) * sizeof(unsigned short)];
+  unsigned short* values = (unsigned short*)layout.mutableBytes;
+  values[0] = (unsigned short)numberOfBranches;
+  values[1] = (unsigned short)numberOfBranchTuples;
+  unsigned short* yPositions = values + 2;
+  unsigned short* xPositions = yPositions + numberOfBranches;
+
+  NSUInteger indexOfBranchTuple = 0;
+  for (NSUInteger indexOfBranch = 0; indexOfBranch < numberOfBranches; indexOfBranch++)
+  {
+    NodeTreeViewBranch* branch = [branches objectAtIndex:indexOfBranch];
+    yPositions[indexOfBranch] = branch->yPosition;
+
+    for (NodeTreeViewBranchTuple* branchTuple in branch->branchTuples)
+      xPositions[indexOfBranchTuple++] = branchTuple->xPositionOfFirstCell;
+  }
+
+  @synchronized(self)
+  {
+    [self readFromFileIfNecessary];
+
+    [self.layouts setObject:layout forKey:layoutKey];
+    [self markLayoutKeyAsMostRecentlyUsed:layoutKey];
+
+    while (self.layoutKeys.count > (NSUInteger)self.maximumNumberOfLayouts)
+    {
+      [self.layouts removeObjectForKey:self.layoutKeys.firstObject];
+      [self.layoutKeys removeObjectAtIndex:0];
+    }
+
+    self.needsWriteToFile = true;
+
+    if (writeToFileImmediately)
+      [self writeToFileIfNecessary];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Writes the content of the cache to the cache file if the content has
+/// changed since the file was last written. Does nothing if the content has
+/// not changed.
+// -----------------------------------------------------------------------------
+- (void) writeToFileIfNecessary
+{
+  @synchronized(self)
+  {
+    if (! self.needsWriteToFile)
+      return;
+
+    NSDictionary* fileContent = @{layoutKeysKey: self.layoutKeys, layoutsKey: self.layouts};
+    NSError* error;
+    NSData* data = [NSPropertyListSerialization dataWithPropertyList:fileContent
+                                                              format:NSPropertyListBinaryFormat_v1_0
+                                                             options:0
+                                                               error:&error];
+    if (! data)
+    {
+      DDLogError(@"%@: Failed to serialize layout cache, error: %@", self, error);
+      return;
+    }
+
+    NSString* folderPath = [self.filePath stringByDeletingLastPathComponent];
+    [[NSFileManager defaultManager] createDirectoryAtPath:folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+
+    if ([data writeToFile:self.filePath atomically:YES])
+      self.needsWriteToFile = false;
+    else
+      DDLogError(@"%@: Failed to write layout cache file %@", self, self.filePath);
+  }
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Reads the cache file if it has not been read yet. A missing or
+/// unreadable cache file results in an empty cache.
+///
+/// The caller must synchronize on self.
+// -----------------------------------------------------------------------------
+- (void) readFromFileIfNecessary
+{
+  if (self.layouts)
+    return;
+
+  self.layoutKeys = [NSMutableArray array];
+  self.layouts = [NSMutableDictionary dictionary];
+
+  NSData* data = [NSData dataWithContentsOfFile:self.filePath];
+  if (! data)
+    return;
+
+  NSDictionary* fileContent = [NSPropertyListSerialization propertyListWithData:data
+                                                                        options:NSPropertyListImmutable
+                                                                         format:NULL
+                                                                          error:nil];
+  if (! [fileContent isKindOfClass:[NSDictionary class]])
+    return;
+
+  NSArray* layoutKeys = [fileContent objectForKey:layoutKeysKey];
+  NSDictionary* layouts = [fileContent objectForKey:layoutsKey];
+  if (! [layoutKeys isKindOfClass:[NSArray class]] || ! [layouts isKindOfClass:[NSDictionary class]])
+    return;
+
+  for (NSString* layoutKey in layoutKeys)
+  {
+    NSData* layout = [layouts objectForKey:layoutKey];
+    if (! [layout isKindOfClass:[NSData class]])
+      continue;
+
+    [self.layoutKeys addObject:layoutKey];
+    [self.layouts setObject:layout forKey:layoutKey];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Moves @a layoutKey to the end of the list of layout keys.
+///
+/// The caller must synchronize on self.
+// -----------------------------------------------------------------------------
+- (void) markLayoutKeyAsMostRecentlyUsed:(NSString*)layoutKey
+{
+  [self.layoutKeys removeObject:layoutKey];
+  [self.layoutKeys addObject:layoutKey];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the key under which the layout of the node tree whose branch
+/// data is stored in @a canvasData is cached.
+///
+/// The key consists of the number of branches, the number of branch tuples,
+/// and a 64-bit FNV-1a hash over the data that has an influence on the
+/// layout. The branches in @a canvasData are in depth-first order, so hashing
+/// them in that order also covers the structure of the node tree.
+// -----------------------------------------------------------------------------
+- (NSString*) layoutKeyForCanvasData:(NodeTreeViewCanvasData*)canvasData
+                      alignMoveNodes:(bool)alignMoveNodes
+                      branchingStyle:(enum NodeTreeViewBranchingStyle)branchingStyle
+{
+  __block unsigned long long hash = 14695981039346656037ULL;
+  void (^hashValue)(unsigned long long) = ^(unsigned long long value)
+  {
+    for (int byteIndex = 0; byteIndex < 8; byteIndex++)
+    {
+      hash ^= (value >> (byteIndex * 8)) & 0xff;
+      hash *= 1099511628211ULL;
+    }
+  };
+
+  hashValue(alignMoveNodes ? 1 : 0);
+  hashValue(branchingStyle);
+
+  NSUInteger numberOfBranchTuples = 0;
+  for (NodeTreeViewBranch* branch in canvasData.branches)
+  {
+    NSArray* branchTuples = branch->branchTuples;
+    hashValue(branchTuples.count);
+    numberOfBranchTuples += branchTuples.count;
+
+    for (NodeTreeViewBranchTuple* branchTuple in branchTuples)
+    {
+      hashValue(branchTuple->numberOfCellsForNode);
+      hashValue(branchTuple->moveNumber);
+      hashValue(branchTuple->childBranches.count);
+    }
+  }
+
+  return [NSString stringWithFormat:@"%lu-%lu-%016llx",
+          (unsigned long)canvasData.branches.count,
+          (unsigned long)numberOfBranchTuples,
+          hash];
+}
+
+@end
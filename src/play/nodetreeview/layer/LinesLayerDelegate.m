@@ -14,7 +14,6 @@
 // limitations under the License.
 // -----------------------------------------------------------------------------
 
-
 // Project includes
 #import "LinesLayerDelegate.h"
 #import "NodeTreeViewDrawingHelper.h"
@@ -33,6 +32,17 @@
 @interface LinesLayerDelegate()
 @property(nonatomic, assign) NodeTreeViewCanvas* nodeTreeViewCanvas;
 @property(nonatomic, retain) NSArray* drawingCellsOnTile;
+/// @brief All line segments on this tile that are not part of the selected
+/// game variation, in canvas coordinates. Is NULL if the paths need to be
+/// rebuilt.
+@property(nonatomic, assign) CGMutablePathRef normalLinesPath;
+/// @brief All line segments on this tile that are part of the selected game
+/// variation, in canvas coordinates. Is NULL if the paths need to be rebuilt.
+@property(nonatomic, assign) CGMutablePathRef selectedLinesPath;
+/// @brief Clipping path that prevents lines from being drawn within the area
+/// of node symbols, in canvas coordinates. Is NULL if no node symbol on this
+/// tile requires clipping.
+@property(nonatomic, assign) CGMutablePathRef clippingPath;
 @end
 
 
@@ -54,6 +64,9 @@
 
   self.nodeTreeViewCanvas = nodeTreeViewCanvas;
   self.drawingCellsOnTile = @[];
+  self.normalLinesPath = NULL;
+  self.selectedLinesPath = NULL;
+  self.clippingPath = NULL;
 
   return self;
 }
@@ -65,6 +78,7 @@
 {
   self.nodeTreeViewCanvas = nil;
   self.drawingCellsOnTile = nil;
+  [self invalidateLinePaths];
 
   [super dealloc];
 }
@@ -77,9 +91,26 @@
   switch (event)
   {
     case NTVLDEventNodeTreeGeometryChanged:
-    case NTVLDEventInvalidateContent:
     {
       self.drawingCellsOnTile = [self calculateNodeTreeViewDrawingCellsOnTile];
+      [self invalidateLinePaths];
+      self.dirty = true;
+      break;
+    }
+    case NTVLDEventInvalidateContent:
+    {
+      NSArray* newDrawingCellsOnTile = [self calculateNodeTreeViewDrawingCellsOnTile];
+      if (! [self.drawingCellsOnTile isEqualToArray:newDrawingCellsOnTile])
+      {
+        self.drawingCellsOnTile = newDrawingCellsOnTile;
+        [self invalidateLinePaths];
+      }
+      self.dirty = true;
+      break;
+    }
+    case NTVLDEventUserInterfaceStyleChanged:
+    {
+      // Only the colors change, the line paths can be reused
       self.dirty = true;
       break;
     }
@@ -89,6 +120,7 @@
       if (! [self.drawingCellsOnTile isEqualToArray:newDrawingCellsOnTile])
       {
         self.drawingCellsOnTile = newDrawingCellsOnTile;
+        [self invalidateLinePaths];
         self.dirty = true;
       }
       break;
@@ -99,6 +131,7 @@
     case NTVLDEventNodeTreeBranchingStyleChanged:
     case NTVLDEventNodeTreeSelectedGameVariationChanged:
     {
+      [self invalidateLinePaths];
       self.dirty = true;
       break;
     }
@@ -111,30 +144,135 @@
 
 // -----------------------------------------------------------------------------
 /// @brief CALayerDelegate method.
+///
+/// Strokes all line segments on this tile with two stroke operations, one for
+/// the normal lines and one for the lines of the selected game variation. The
+/// line segments are collected into cached paths only when the canvas data for
+/// this tile changes, so a redraw that is caused by something else (e.g. a
+/// color change) does not have to enumerate the cells again.
 // -----------------------------------------------------------------------------
 - (void) drawLayer:(CALayer*)layer inContext:(CGContextRef)context
 {
-  bool condenseMoveNodes = self.nodeTreeViewMetrics.condenseMoveNodes;
   CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
                                               withSize:self.nodeTreeViewMetrics.tileSize];
 
-  UIColor* normalLineColor = self.nodeTreeViewMetrics.normalLineColor;
-  UIColor* selectedLineColor = self.nodeTreeViewMetrics.selectedLineColor;
+  if (! self.normalLinesPath)
+    [self buildLinePathsForTileWithRect:tileRect];
+
+  CGContextSaveGState(context);
+
+  // The paths are in canvas coordinates
+  CGContextTranslateCTM(context, -tileRect.origin.x, -tileRect.origin.y);
 
-  CGFloat normalLineWidth = self.nodeTreeViewMetrics.normalLineWidth;
+  if (self.clippingPath)
+  {
+    CGContextAddPath(context, self.clippingPath);
+    CGContextEOClip(context);
+  }
+
+  if (! CGPathIsEmpty(self.normalLinesPath))
+  {
+    CGContextAddPath(context, self.normalLinesPath);
+    [CGDrawingHelper fillOrStrokePathWithContext:context
+                                       fillColor:nil
+                                     strokeColor:self.nodeTreeViewMetrics.normalLineColor
+                                 strokeLineWidth:self.nodeTreeViewMetrics.normalLineWidth];
+  }
+
+  if (! CGPathIsEmpty(self.selectedLinesPath))
+  {
+    CGContextAddPath(context, self.selectedLinesPath);
+    [CGDrawingHelper fillOrStrokePathWithContext:context
+                                       fillColor:nil
+                                     strokeColor:self.nodeTreeViewMetrics.selectedLineColor
+                                 strokeLineWidth:self.nodeTreeViewMetrics.selectedLineWidth];
+  }
+
+  CGContextRestoreGState(context);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawLayer:inContext:().
+///
+/// Collects the line segments of all cells on the tile with the canvas
+/// rectangle @a tileRect into the paths @e normalLinesPath and
+/// @e selectedLinesPath, and the areas of node symbols that lines must not be
+/// drawn into into @e clippingPath.
+// -----------------------------------------------------------------------------
+- (void) buildLinePathsForTileWithRect:(CGRect)tileRect
+{
+  [self invalidateLinePaths];
+
+  CGMutablePathRef normalLinesPath = CGPathCreateMutable();
+  CGMutablePathRef selectedLinesPath = CGPathCreateMutable();
+  self.normalLinesPath = normalLinesPath;
+  self.selectedLinesPath = selectedLinesPath;
+
+  bool condenseMoveNodes = self.nodeTreeViewMetrics.condenseMoveNodes;
   CGFloat selectedLineWidth = self.nodeTreeViewMetrics.selectedLineWidth;
 
-  for (NodeTreeViewCellPosition* position in self.drawingCellsOnTile)
+  // The parts of a multipart cell share the same node symbol. The clipping
+  // path uses the even-odd rule, so the node symbol area of a multipart cell
+  // must be added only once, otherwise it would cancel itself out.
+  NSMutableSet* clippingCenters = [NSMutableSet set];
+  __block CGMutablePathRef clippingPath = NULL;
+
+  // With a reduced level of detail, consecutive cells in the same row that
+  // contain nothing but a horizontal line are collapsed into a run that is
+  // added to the path as a single line segment instead of two segments per
+  // cell.
+  bool reducedLevelOfDetail = self.nodeTreeViewMetrics.reducedLevelOfDetail;
+  __block int runLength = 0;
+  __block unsigned short runY = 0;
+  __block unsigned short runLastX = 0;
+  __block bool runIsSelected = false;
+  __block CGRect runCanvasRect = CGRectZero;
+
+  // The positions in drawingCellsOnTile are ordered row by row, so the first
+  // and the last position span the rectangle of cells on this tile. Only
+  // cells that have content are enumerated.
+  [self.nodeTreeViewCanvas enumerateCellsFromPosition:self.drawingCellsOnTile.firstObject
+                                           toPosition:self.drawingCellsOnTile.lastObject
+                                           usingBlock:^(NodeTreeViewCellPosition* position, NodeTreeViewCell* cell, GoNode* node)
   {
-    NodeTreeViewCell* cell = [self.nodeTreeViewCanvas cellAtPosition:position];
-    if (! cell || cell.lines == NodeTreeViewCellLineNone)
-      continue;
+    if (cell.lines == NodeTreeViewCellLineNone)
+      return;
 
     NodeTreeViewCellLines lines = cell.lines;
     NodeTreeViewCellLines linesSelected = cell.linesSelectedGameVariation;
 
     CGRect canvasRectForCell = [NodeTreeViewDrawingHelper canvasRectForCellAtPosition:position metrics:self.nodeTreeViewMetrics];
 
+    if (reducedLevelOfDetail && [self isHorizontalRunCell:cell])
+    {
+      bool isLineSelected = (linesSelected != NodeTreeViewCellLineNone);
+      bool continuesRun = (runLength > 0 &&
+                           position.y == runY &&
+                           position.x == runLastX + 1 &&
+                           isLineSelected == runIsSelected);
+      if (continuesRun)
+      {
+        runCanvasRect = CGRectUnion(runCanvasRect, canvasRectForCell);
+        runLength++;
+      }
+      else
+      {
+        if (runLength > 0)
+          [self addHorizontalLineInCanvasRect:runCanvasRect toPath:runIsSelected ? selectedLinesPath : normalLinesPath];
+        runCanvasRect = canvasRectForCell;
+        runY = position.y;
+        runIsSelected = isLineSelected;
+        runLength = 1;
+      }
+      runLastX = position.x;
+      return;
+    }
+    else if (runLength > 0)
+    {
+      [self addHorizontalLineInCanvasRect:runCanvasRect toPath:runIsSelected ? selectedLinesPath : normalLinesPath];
+      runLength = 0;
+    }
+
     // If we are drawing exactly within the cell boundaries then diagonal
     // branching lines of two diagonally adjacent cells do not join seamlessly
     // at the corner points because the joining is clipped by the cell rectangle
@@ -165,8 +303,8 @@
     // line width, so both line types can be safely drawn.
     //
     // Notes:
-    // - We have to enlarge the canvas rect, not the drawing rect, because the
-    //   canvas rect may be used for setting up a clipping path.
+    // - We have to enlarge the canvas rect, not only the line end points,
+    //   because the canvas rect is also used for the clipping path.
     // - Enlarging the cell rectangle is necessary only if diagonally adjacent
     //   cell rectangles are square, because only then are lines joined in the
     //   corners of the cell rectangles. If "condense move nodes" is enabled,
@@ -176,106 +314,137 @@
     if (! condenseMoveNodes)
       canvasRectForCell = CGRectInset(canvasRectForCell, -selectedLineWidth, -selectedLineWidth);
 
-    CGRect drawingRectForCell = [CGDrawingHelper drawingRectFromCanvasRect:canvasRectForCell
-                                                            inTileWithRect:tileRect];
-    CGPoint centerOfDrawingRectForCell = CGPointMake(CGRectGetMidX(drawingRectForCell), CGRectGetMidY(drawingRectForCell));
+    CGPoint centerOfCanvasRectForCell = CGPointMake(CGRectGetMidX(canvasRectForCell), CGRectGetMidY(canvasRectForCell));
 
-    bool didSetClippingPath = false;
     enum NodeTreeViewCellSymbol symbol = cell.symbol;
     if (symbol != NodeTreeViewCellSymbolNone &&
         symbol != NodeTreeViewCellSymbolBlackMove &&
         symbol != NodeTreeViewCellSymbolWhiteMove)
     {
-      [self setClippingPathInContext:context
-                                cell:cell
-                            position:position
-                   canvasRectForCell:canvasRectForCell
-                   condenseMoveNodes:condenseMoveNodes
-                            tileRect:tileRect];
-      didSetClippingPath = true;
+      if (! clippingPath)
+      {
+        // The outer rectangle must cover everything that can be drawn on the
+        // tile, including the overlap of lines from cells on the tile edges
+        clippingPath = CGPathCreateMutable();
+        CGPathAddRect(clippingPath, NULL, CGRectInset(tileRect, -2 * selectedLineWidth, -2 * selectedLineWidth));
+      }
+      [self addClippingAreaToPath:clippingPath
+                             cell:cell
+                         position:position
+                canvasRectForCell:canvasRectForCell
+                condenseMoveNodes:condenseMoveNodes
+                  clippingCenters:clippingCenters];
     }
 
     if (lines & NodeTreeViewCellLineCenterToLeft)
     {
-      bool isLineSelected = linesSelected & NodeTreeViewCellLineCenterToLeft;
-      [CGDrawingHelper drawLineWithContext:context
-                                 fromPoint:CGPointMake(drawingRectForCell.origin.x, centerOfDrawingRectForCell.y)
-                                   toPoint:centerOfDrawingRectForCell
-                               strokeColor:isLineSelected ? selectedLineColor : normalLineColor
-                           strokeLineWidth:isLineSelected ? selectedLineWidth : normalLineWidth];
+      CGMutablePathRef path = (linesSelected & NodeTreeViewCellLineCenterToLeft) ? selectedLinesPath : normalLinesPath;
+      CGPathMoveToPoint(path, NULL, canvasRectForCell.origin.x, centerOfCanvasRectForCell.y);
+      CGPathAddLineToPoint(path, NULL, centerOfCanvasRectForCell.x, centerOfCanvasRectForCell.y);
     }
 
     if (lines & NodeTreeViewCellLineCenterToRight)
     {
-      bool isLineSelected = linesSelected & NodeTreeViewCellLineCenterToRight;
-      [CGDrawingHelper drawLineWithContext:context
-                                 fromPoint:centerOfDrawingRectForCell
-                                   toPoint:CGPointMake(CGRectGetMaxX(drawingRectForCell), centerOfDrawingRectForCell.y)
-                               strokeColor:isLineSelected ? selectedLineColor : normalLineColor
-                           strokeLineWidth:isLineSelected ? selectedLineWidth : normalLineWidth];
+      CGMutablePathRef path = (linesSelected & NodeTreeViewCellLineCenterToRight) ? selectedLinesPath : normalLinesPath;
+      CGPathMoveToPoint(path, NULL, centerOfCanvasRectForCell.x, centerOfCanvasRectForCell.y);
+      CGPathAddLineToPoint(path, NULL, CGRectGetMaxX(canvasRectForCell), centerOfCanvasRectForCell.y);
     }
 
     if (lines & NodeTreeViewCellLineCenterToTop)
     {
-      bool isLineSelected = linesSelected & NodeTreeViewCellLineCenterToTop;
-      [CGDrawingHelper drawLineWithContext:context
-                                 fromPoint:CGPointMake(centerOfDrawingRectForCell.x, drawingRectForCell.origin.y)
-                                   toPoint:centerOfDrawingRectForCell
-                               strokeColor:isLineSelected ? selectedLineColor : normalLineColor
-                           strokeLineWidth:isLineSelected ? selectedLineWidth : normalLineWidth];
+      CGMutablePathRef path = (linesSelected & NodeTreeViewCellLineCenterToTop) ? selectedLinesPath : normalLinesPath;
+      CGPathMoveToPoint(path, NULL, centerOfCanvasRectForCell.x, canvasRectForCell.origin.y);
+      CGPathAddLineToPoint(path, NULL, centerOfCanvasRectForCell.x, centerOfCanvasRectForCell.y);
     }
 
     if (lines & NodeTreeViewCellLineCenterToBottom)
     {
-      bool isLineSelected = linesSelected & NodeTreeViewCellLineCenterToBottom;
-      [CGDrawingHelper drawLineWithContext:context
-                                 fromPoint:centerOfDrawingRectForCell
-                                   toPoint:CGPointMake(centerOfDrawingRectForCell.x, CGRectGetMaxY(drawingRectForCell))
-                               strokeColor:isLineSelected ? selectedLineColor : normalLineColor
-                           strokeLineWidth:isLineSelected ? selectedLineWidth : normalLineWidth];
+      CGMutablePathRef path = (linesSelected & NodeTreeViewCellLineCenterToBottom) ? selectedLinesPath : normalLinesPath;
+      CGPathMoveToPoint(path, NULL, centerOfCanvasRectForCell.x, centerOfCanvasRectForCell.y);
+      CGPathAddLineToPoint(path, NULL, centerOfCanvasRectForCell.x, CGRectGetMaxY(canvasRectForCell));
     }
 
     if (lines & NodeTreeViewCellLineCenterToTopLeft)
     {
-      bool isLineSelected = linesSelected & NodeTreeViewCellLineCenterToTopLeft;
-      [CGDrawingHelper drawLineWithContext:context
-                                 fromPoint:drawingRectForCell.origin
-                                   toPoint:centerOfDrawingRectForCell
-                               strokeColor:isLineSelected ? selectedLineColor : normalLineColor
-                           strokeLineWidth:isLineSelected ? selectedLineWidth : normalLineWidth];
+      CGMutablePathRef path = (linesSelected & NodeTreeViewCellLineCenterToTopLeft) ? selectedLinesPath : normalLinesPath;
+      CGPathMoveToPoint(path, NULL, canvasRectForCell.origin.x, canvasRectForCell.origin.y);
+      CGPathAddLineToPoint(path, NULL, centerOfCanvasRectForCell.x, centerOfCanvasRectForCell.y);
     }
 
     if (lines & NodeTreeViewCellLineCenterToBottomRight)
     {
-      bool isLineSelected = linesSelected & NodeTreeViewCellLineCenterToBottomRight;
-      [CGDrawingHelper drawLineWithContext:context
-                                 fromPoint:centerOfDrawingRectForCell
-                                   toPoint:CGPointMake(CGRectGetMaxX(drawingRectForCell), CGRectGetMaxY(drawingRectForCell))
-                               strokeColor:isLineSelected ? selectedLineColor : normalLineColor
-                           strokeLineWidth:isLineSelected ? selectedLineWidth : normalLineWidth];
+      CGMutablePathRef path = (linesSelected & NodeTreeViewCellLineCenterToBottomRight) ? selectedLinesPath : normalLinesPath;
+      CGPathMoveToPoint(path, NULL, centerOfCanvasRectForCell.x, centerOfCanvasRectForCell.y);
+      CGPathAddLineToPoint(path, NULL, CGRectGetMaxX(canvasRectForCell), CGRectGetMaxY(canvasRectForCell));
     }
+  }];
 
-    if (didSetClippingPath)
-    {
-      [self removeClippingPathInContext:context];
-    }
+  if (runLength > 0)
+    [self addHorizontalLineInCanvasRect:runCanvasRect toPath:runIsSelected ? selectedLinesPath : normalLinesPath];
+
+  self.clippingPath = clippingPath;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for buildLinePathsForTileWithRect:().
+///
+/// Returns true if @a cell can be part of a horizontal run that is collapsed
+/// into a single line segment when the node tree is drawn with a reduced level
+/// of detail. This is the case if the cell contains only a horizontal line
+/// that crosses the entire cell, if the line is either entirely selected or
+/// entirely unselected, and if the cell contains no node symbol other than a
+/// move node symbol (move node symbols are not drawn with a reduced level of
+/// detail).
+// -----------------------------------------------------------------------------
+- (bool) isHorizontalRunCell:(NodeTreeViewCell*)cell
+{
+  NodeTreeViewCellLines horizontalLines = NodeTreeViewCellLineCenterToLeft | NodeTreeViewCellLineCenterToRight;
+  if (cell.lines != horizontalLines)
+    return false;
+  if (cell.linesSelectedGameVariation != NodeTreeViewCellLineNone &&
+      cell.linesSelectedGameVariation != horizontalLines)
+  {
+    return false;
   }
+
+  enum NodeTreeViewCellSymbol symbol = cell.symbol;
+  return (symbol == NodeTreeViewCellSymbolNone ||
+          symbol == NodeTreeViewCellSymbolBlackMove ||
+          symbol == NodeTreeViewCellSymbolWhiteMove);
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for drawLayer:inContext:().
+/// @brief Private helper for buildLinePathsForTileWithRect:().
+///
+/// Adds a single horizontal line segment through the vertical center of
+/// @a canvasRect that spans the entire width of @a canvasRect to @a path.
+// -----------------------------------------------------------------------------
+- (void) addHorizontalLineInCanvasRect:(CGRect)canvasRect
+                                toPath:(CGMutablePathRef)path
+{
+  CGFloat centerY = CGRectGetMidY(canvasRect);
+  CGPathMoveToPoint(path, NULL, CGRectGetMinX(canvasRect), centerY);
+  CGPathAddLineToPoint(path, NULL, CGRectGetMaxX(canvasRect), centerY);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for buildLinePathsForTileWithRect:().
 ///
-/// This method set a clipping path that prevents lines (or anything else) from
-/// being drawn within the area where the node symbol is drawn by the node
-/// symbol layer. We can't rely on the symbol covering any lines that are drawn
-/// within the symbol area because many symbols contain transparent parts.
+/// Adds the area where the node symbol of @a cell is drawn by the node symbol
+/// layer to @a clippingPath, which prevents lines (or anything else) from
+/// being drawn within that area. We can't rely on the symbol covering any
+/// lines that are drawn within the symbol area because many symbols contain
+/// transparent parts.
+///
+/// Does nothing if the center of the area is already in @a clippingCenters.
+/// Adds the center to @a clippingCenters otherwise.
 // -----------------------------------------------------------------------------
-- (void) setClippingPathInContext:(CGContextRef)context
-                             cell:(NodeTreeViewCell*)cell
-                         position:(NodeTreeViewCellPosition*)position
-                canvasRectForCell:(CGRect)canvasRectForCell
-                condenseMoveNodes:(bool)condenseMoveNodes
-                         tileRect:(CGRect)tileRect
+- (void) addClippingAreaToPath:(CGMutablePathRef)clippingPath
+                          cell:(NodeTreeViewCell*)cell
+                      position:(NodeTreeViewCellPosition*)position
+             canvasRectForCell:(CGRect)canvasRectForCell
+             condenseMoveNodes:(bool)condenseMoveNodes
+               clippingCenters:(NSMutableSet*)clippingCenters
 {
   CGRect canvasRectForFullCell;
   CGSize symbolSize;
@@ -295,30 +464,41 @@
       symbolSize = self.nodeTreeViewMetrics.uncondensedNodeSymbolSize;
   }
 
-  CGRect drawingRectForFullCell = [CGDrawingHelper drawingRectFromCanvasRect:canvasRectForFullCell
-                                                              inTileWithRect:tileRect];
-  CGPoint centerOfDrawingRectForFullCell = CGPointMake(CGRectGetMidX(drawingRectForFullCell),
-                                                       CGRectGetMidY(drawingRectForFullCell));
-  CGFloat clippingRadius = MIN(symbolSize.width, symbolSize.height) / 2.0;
+  CGPoint centerOfCanvasRectForFullCell = CGPointMake(CGRectGetMidX(canvasRectForFullCell),
+                                                      CGRectGetMidY(canvasRectForFullCell));
+  NSValue* clippingCenter = [NSValue valueWithCGPoint:centerOfCanvasRectForFullCell];
+  if ([clippingCenters containsObject:clippingCenter])
+    return;
+  [clippingCenters addObject:clippingCenter];
 
-  [CGDrawingHelper setCircularClippingPathWithContext:context
-                                               center:centerOfDrawingRectForFullCell
-                                               radius:clippingRadius
-                                       outerRectangle:drawingRectForFullCell];
+  CGFloat clippingRadius = MIN(symbolSize.width, symbolSize.height) / 2.0;
+  CGPathAddEllipseInRect(clippingPath, NULL, CGRectMake(centerOfCanvasRectForFullCell.x - clippingRadius,
+                                                        centerOfCanvasRectForFullCell.y - clippingRadius,
+                                                        2 * clippingRadius,
+                                                        2 * clippingRadius));
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for drawLayer:inContext:().
-///
-/// Removes a previously configured node symbol clipping path from the
-/// drawing context @a context. Invocation of this method balances a previous
-/// invocation of the
-/// setClippingPathInContext:cell:position:canvasRectForCell:condenseMoveNodes:tileRect:()
-/// method.
+/// @brief Releases the cached line paths so that they are rebuilt the next
+/// time the layer is drawn.
 // -----------------------------------------------------------------------------
-- (void) removeClippingPathInContext:(CGContextRef)context
+- (void) invalidateLinePaths
 {
-  [CGDrawingHelper removeClippingPathWithContext:context];
+  if (self.normalLinesPath)
+  {
+    CGPathRelease(self.normalLinesPath);
+    self.normalLinesPath = NULL;
+  }
+  if (self.selectedLinesPath)
+  {
+    CGPathRelease(self.selectedLinesPath);
+    self.selectedLinesPath = NULL;
+  }
+  if (self.clippingPath)
+  {
+    CGPathRelease(self.clippingPath);
+    self.clippingPath = NULL;
+  }
 }
 
 @end
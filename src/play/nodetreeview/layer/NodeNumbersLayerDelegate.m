@@ -89,6 +89,11 @@
       self.dirty = true;
       break;
     }
+    case NTVLDEventUserInterfaceStyleChanged:
+    {
+      self.dirty = true;
+      break;
+    }
     case NTVLDEventAbstractCanvasSizeChanged:
     {
       NSArray* newDrawingCellsOnTile = [self calculateNodeNumberViewDrawingCellsOnTile];
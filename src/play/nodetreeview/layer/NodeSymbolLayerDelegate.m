@@ -118,6 +118,14 @@
       self.dirty = true;
       break;
     }
+    case NTVLDEventUserInterfaceStyleChanged:
+    {
+      // The drawing cells did not change, but the entire tile must be redrawn
+      [self invalidateDirtyRectForNodeSymbolChanged];
+      self.nodeSymbolChangedPositionsOnTile = nil;
+      self.dirty = true;
+      break;
+    }
     case NTVLDEventAbstractCanvasSizeChanged:
     {
       NSArray* newDrawingCellsOnTile = [self calculateNodeTreeViewDrawingCellsOnTile];
@@ -195,100 +203,154 @@
 // -----------------------------------------------------------------------------
 - (void) drawLayer:(CALayer*)layer inContext:(CGContextRef)context
 {
-  [self createLayersIfNecessaryWithContext:context];
-
   bool condenseMoveNodes = self.nodeTreeViewMetrics.condenseMoveNodes;
   NodeTreeViewCGLayerCache* cache = [NodeTreeViewCGLayerCache sharedCache];
   CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
                                               withSize:self.nodeTreeViewMetrics.tileSize];
 
-  NSArray* positionsToDraw;
+  NSMutableDictionary* nodeSymbolsAlreadyDrawn = [NSMutableDictionary dictionary];
+
   if (self.nodeSymbolChangedPositionsOnTile)
   {
-    positionsToDraw = [[self.nodeSymbolChangedPositionsOnTile retain] autorelease];
+    NSArray* positionsToDraw = [[self.nodeSymbolChangedPositionsOnTile retain] autorelease];
     self.nodeSymbolChangedPositionsOnTile = nil;
+
+    for (NodeTreeViewCellPosition* position in positionsToDraw)
+    {
+      NodeTreeViewCell* cell = [self.nodeTreeViewCanvas cellAtPosition:position];
+      if (! cell || cell.symbol == NodeTreeViewCellSymbolNone)
+        continue;
+
+      GoNode* node = cell.isMultipart ? [self.nodeTreeViewCanvas nodeAtPosition:position] : nil;
+      [self drawSymbolOfCell:cell
+                  atPosition:position
+                     forNode:node
+     nodeSymbolsAlreadyDrawn:nodeSymbolsAlreadyDrawn
+           condenseMoveNodes:condenseMoveNodes
+                       cache:cache
+                 withContext:context
+              inTileWithRect:tileRect];
+    }
   }
   else
   {
-    positionsToDraw = self.drawingCellsOnTile;
+    // The positions in drawingCellsOnTile are ordered row by row, so the first
+    // and the last position span the rectangle of cells on this tile. Only
+    // cells that have content are enumerated.
+    [self.nodeTreeViewCanvas enumerateCellsFromPosition:self.drawingCellsOnTile.firstObject
+                                             toPosition:self.drawingCellsOnTile.lastObject
+                                             usingBlock:^(NodeTreeViewCellPosition* position, NodeTreeViewCell* cell, GoNode* node)
+    {
+      if (cell.symbol == NodeTreeViewCellSymbolNone)
+        return;
+
+      [self drawSymbolOfCell:cell
+                  atPosition:position
+                     forNode:node
+     nodeSymbolsAlreadyDrawn:nodeSymbolsAlreadyDrawn
+           condenseMoveNodes:condenseMoveNodes
+                       cache:cache
+                 withContext:context
+              inTileWithRect:tileRect];
+    }];
   }
+}
 
-  NSMutableDictionary* nodeSymbolsAlreadyDrawn = [NSMutableDictionary dictionary];
+// -----------------------------------------------------------------------------
+/// @brief Private helper for drawLayer:inContext:(). Draws the symbol of
+/// @a cell, which is located at @a position and represents @a node.
+// -----------------------------------------------------------------------------
+- (void) drawSymbolOfCell:(NodeTreeViewCell*)cell
+               atPosition:(NodeTreeViewCellPosition*)position
+                  forNode:(GoNode*)node
+  nodeSymbolsAlreadyDrawn:(NSMutableDictionary*)nodeSymbolsAlreadyDrawn
+        condenseMoveNodes:(bool)condenseMoveNodes
+                    cache:(NodeTreeViewCGLayerCache*)cache
+              withContext:(CGContextRef)context
+           inTileWithRect:(CGRect)tileRect
+{
+  // With a reduced level of detail the symbols of move nodes are too small to
+  // be useful. Only the connecting lines remain visible so that long linear
+  // runs of move nodes collapse into a single line. Symbols of other nodes
+  // are still drawn because they mark points of interest in the tree.
+  if (self.nodeTreeViewMetrics.reducedLevelOfDetail)
+  {
+    enum NodeTreeViewCellSymbol symbol = cell.symbol;
+    if (symbol == NodeTreeViewCellSymbolBlackMove || symbol == NodeTreeViewCellSymbolWhiteMove)
+      return;
+  }
 
-  for (NodeTreeViewCellPosition* position in positionsToDraw)
+  // If the cell is a sub-cell that belongs to a multipart cell then there is
+  // a good chance that other sub-cells from the same multipart cell are also
+  // on this tile, which would cause the symbol to be drawn multiple times.
+  // We prevent drawing multiple times by remembering which symbols were
+  // already drawn. Alas there is some overhead involved in the optimization
+  // (lookup of the GoNode that the symbol represents) because the
+  // NodeTreeViewCell does not contain any data that allows to uniquely
+  // identify the symbol. No measuring was done how much speed is gained by
+  // the optimization, but it is reasonable to expect that the time saved for
+  // not drawing the same symbol far outweighs the optimization overhead.
+  if (cell.isMultipart && node)
   {
-    NodeTreeViewCell* cell = [self.nodeTreeViewCanvas cellAtPosition:position];
-    if (! cell || cell.symbol == NodeTreeViewCellSymbolNone)
-      continue;
-
-    // If the cell is a sub-cell that belongs to a multipart cell then there is
-    // a good chance that other sub-cells from the same multipart cell are also
-    // on this tile, which would cause the symbol to be drawn multiple times.
-    // We prevent drawing multiple times by remembering which symbols were
-    // already drawn. Alas there is some overhead involved in the optimization
-    // (lookup of the GoNode that the symbol represents) because the
-    // NodeTreeViewCell does not contain any data that allows to uniquely
-    // identify the symbol. No measuring was done how much speed is gained by
-    // the optimization, but it is reasonable to expect that the time saved for
-    // not drawing the same symbol far outweighs the optimization overhead.
-    if (cell.isMultipart)
-    {
-      GoNode* node = [self.nodeTreeViewCanvas nodeAtPosition:position];
-      if (node)
-      {
-        NSValue* key = [NSValue valueWithNonretainedObject:node];
-        if ([nodeSymbolsAlreadyDrawn objectForKey:key])
-          continue;
-        nodeSymbolsAlreadyDrawn[key] = key;
-      }
-    }
+    NSValue* key = [NSValue valueWithNonretainedObject:node];
+    if ([nodeSymbolsAlreadyDrawn objectForKey:key])
+      return;
+    nodeSymbolsAlreadyDrawn[key] = key;
+  }
 
-    enum NodeTreeViewLayerType layerType = [self layerTypeForSymbol:cell.symbol
-                                                cellIsMultipartCell:cell.isMultipart
-                                                  condenseMoveNodes:condenseMoveNodes];
-    CGLayerRef layer = [cache layerOfType:layerType];
+  enum NodeTreeViewLayerType layerType = [self layerTypeForSymbol:cell.symbol
+                                              cellIsMultipartCell:cell.isMultipart
+                                                condenseMoveNodes:condenseMoveNodes];
+  CGLayerRef layer = [self layerOfType:layerType cache:cache withContext:context];
+  if (! layer)
+    return;
 
-    if (cell.isMultipart)
-    {
-      [NodeTreeViewDrawingHelper drawLayer:layer
-                               withContext:context
-                                      part:cell.part
-                              partPosition:position
-                            inTileWithRect:tileRect
-                               withMetrics:self.nodeTreeViewMetrics];
-    }
-    else
-    {
-      [NodeTreeViewDrawingHelper drawLayer:layer
-                               withContext:context
-                                centeredAt:position
-                            inTileWithRect:tileRect
-                               withMetrics:self.nodeTreeViewMetrics];
-    }
+  if (cell.isMultipart)
+  {
+    [NodeTreeViewDrawingHelper drawLayer:layer
+                             withContext:context
+                                    part:cell.part
+                            partPosition:position
+                          inTileWithRect:tileRect
+                             withMetrics:self.nodeTreeViewMetrics];
+  }
+  else
+  {
+    [NodeTreeViewDrawingHelper drawLayer:layer
+                             withContext:context
+                              centeredAt:position
+                          inTileWithRect:tileRect
+                             withMetrics:self.nodeTreeViewMetrics];
   }
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Private helper for drawLayer:inContext:().
+/// @brief Private helper for drawSymbolOfCell:atPosition:forNode:nodeSymbolsAlreadyDrawn:condenseMoveNodes:cache:withContext:inTileWithRect:().
+///
+/// Returns the pre-rendered layer of type @a layerType from @a cache. If the
+/// cache does not contain the layer yet, the layer is rendered now and added
+/// to the cache. Rendering layers on demand instead of all at once means that
+/// after the cache was invalidated (e.g. because the zoom scale changed) only
+/// those node symbols are rendered that actually appear on screen. Returns
+/// @e NULL if the layer cannot be created.
 // -----------------------------------------------------------------------------
-- (void) createLayersIfNecessaryWithContext:(CGContextRef)context
+- (CGLayerRef) layerOfType:(enum NodeTreeViewLayerType)layerType
+                     cache:(NodeTreeViewCGLayerCache*)cache
+               withContext:(CGContextRef)context
 {
-  NodeTreeViewCGLayerCache* cache = [NodeTreeViewCGLayerCache sharedCache];
-
-  for (enum NodeTreeViewLayerType layerType = NodeTreeViewLayerTypeNodeSymbolFirst;
-       layerType <= NodeTreeViewLayerTypeNodeSymbolLast;
-       layerType++)
+  CGLayerRef layer = [cache layerOfType:layerType];
+  if (! layer)
   {
-    CGLayerRef layer = [cache layerOfType:layerType];
+    enum NodeTreeViewCellSymbol symbolType = [self symbolTypeForLayerType:layerType];
+    bool condensed = layerType == NodeTreeViewLayerTypeBlackMoveCondensed || layerType == NodeTreeViewLayerTypeWhiteMoveCondensed;
+    layer = CreateNodeSymbolLayer(context, symbolType, condensed, self.nodeTreeViewMetrics);
     if (! layer)
-    {
-      enum NodeTreeViewCellSymbol symbolType = [self symbolTypeForLayerType:layerType];
-      bool condensed = layerType == NodeTreeViewLayerTypeBlackMoveCondensed || layerType == NodeTreeViewLayerTypeWhiteMoveCondensed;
-      layer = CreateNodeSymbolLayer(context, symbolType, condensed, self.nodeTreeViewMetrics);
-      [cache setLayer:layer ofType:layerType];
-      CGLayerRelease(layer);
-    }
+      return NULL;
+    [cache setLayer:layer ofType:layerType];
+    CGLayerRelease(layer);
   }
+
+  return layer;
 }
 
 // -----------------------------------------------------------------------------
@@ -58,6 +58,16 @@ enum NodeTreeViewLayerType
 // -----------------------------------------------------------------------------
 /// @brief The NodeTreeViewCGLayerCache class provides a cache of CGLayer
 /// objects that can be reused for drawing the node tree.
+///
+/// The content of the layers depends on the colors used for drawing, which in
+/// turn depend on the UIUserInterfaceStyle (light/dark mode). The cache
+/// therefore maintains one set of layers per user interface style. Only the set
+/// that matches the value of property @e lightUserInterfaceStyle is accessible
+/// to clients at any given time. When the user interface style changes, the
+/// layers of the previously active set are retained so that switching back
+/// does not require drawing them again. The invalidate...() methods discard
+/// layers from both sets, because clients invoke them when the node tree
+/// geometry changes.
 // -----------------------------------------------------------------------------
 @interface NodeTreeViewCGLayerCache : NSObject
 {
@@ -72,4 +82,14 @@ enum NodeTreeViewLayerType
 - (void) invalidateAllNodeSymbolLayers;
 - (void) invalidateAllLayers;
 
+/// @brief True if the set of layers for the light user interface style is
+/// active, false if the set of layers for the dark user interface style is
+/// active. The default is true.
+@property(nonatomic, assign) bool lightUserInterfaceStyle;
+/// @brief The number of times that layerOfType:() returned a layer. Is used
+/// to display the cache hit rate in the performance HUD.
+@property(nonatomic, assign, readonly) unsigned long long numberOfHits;
+/// @brief The number of times that layerOfType:() did not return a layer.
+@property(nonatomic, assign, readonly) unsigned long long numberOfMisses;
+
 @end
@@ -17,13 +17,28 @@
 
 // Project includes
 #import "NodeTreeViewCGLayerCache.h"
+#import "../../../shared/MemoryBudgetManager.h"
 
 
 // Store layers in a global array variable because access is by simple indexing
 // and therefore very fast. Since only one instance of NodeTreeViewCGLayerCache
-// can exist, there are no array access conflicts to solve.
+// can exist, there are no array access conflicts to solve. The first dimension
+// is the user interface style (0 = light, 1 = dark).
+static const int arraySizeUserInterfaceStyles = 2;
 static const int arraySizeLayers = NodeTreeViewLayerTypeMax;
-static CGLayerRef layers[arraySizeLayers];
+static CGLayerRef layers[arraySizeUserInterfaceStyles][arraySizeLayers];
+// Index of the currently active set of layers in the first array dimension
+static int activeUserInterfaceStyleIndex = 0;
+// Like the array, the counters are global variables for speed
+static unsigned long long numberOfHits = 0;
+static unsigned long long numberOfMisses = 0;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private methods for NodeTreeViewCGLayerCache.
+// -----------------------------------------------------------------------------
+@interface NodeTreeViewCGLayerCache() <MemoryBudgetClient>
+@end
 
 
 @implementation NodeTreeViewCGLayerCache
@@ -57,17 +72,21 @@ static NodeTreeViewCGLayerCache* sharedCache = nil;
   if (! self)
     return nil;
 
-  for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
-    layers[layerIndex] = NULL;
+  for (int styleIndex = 0; styleIndex < arraySizeUserInterfaceStyles; ++styleIndex)
+  {
+    for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
+      layers[styleIndex][layerIndex] = NULL;
+  }
+  activeUserInterfaceStyleIndex = 0;
 
-  [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didReceiveMemoryWarning:) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+  [[MemoryBudgetManager sharedManager] registerClient:self withPriority:MemoryBudgetEvictionPriorityNormal];
 
   return self;
 }
 
 - (void) dealloc
 {
-  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [[MemoryBudgetManager sharedManager] unregisterClient:self];
 
   [self invalidateAllLayers];
 
@@ -79,58 +98,145 @@ static NodeTreeViewCGLayerCache* sharedCache = nil;
 
 #pragma mark - Memory management
 
-- (void) didReceiveMemoryWarning:(NSNotification*)notification
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method.
+// -----------------------------------------------------------------------------
+- (unsigned long long) evictableMemoryUsage
 {
-  [self invalidateAllLayers];
+  unsigned long long evictableMemoryUsage = 0;
+  for (int styleIndex = 0; styleIndex < arraySizeUserInterfaceStyles; ++styleIndex)
+    evictableMemoryUsage += [self memoryUsageOfLayersWithUserInterfaceStyleIndex:styleIndex];
+  return evictableMemoryUsage;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method. The layers of the inactive user interface
+/// style are discarded first. Within a set the layers are small and there is
+/// no order in which they could sensibly be discarded, so either all layers of
+/// the active set are kept or none.
+// -----------------------------------------------------------------------------
+- (void) reduceEvictableMemoryUsageTo:(unsigned long long)numberOfBytes
+{
+  if ([self evictableMemoryUsage] <= numberOfBytes)
+    return;
+
+  int inactiveUserInterfaceStyleIndex = 1 - activeUserInterfaceStyleIndex;
+  [self invalidateLayersWithUserInterfaceStyleIndex:inactiveUserInterfaceStyleIndex
+                                     fromLayerIndex:NodeTreeViewLayerTypeFirst
+                                        toLayerIndex:NodeTreeViewLayerTypeLast];
+
+  if ([self evictableMemoryUsage] > numberOfBytes)
+    [self invalidateAllLayers];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for evictableMemoryUsage().
+// -----------------------------------------------------------------------------
+- (unsigned long long) memoryUsageOfLayersWithUserInterfaceStyleIndex:(int)styleIndex
+{
+  unsigned long long memoryUsage = 0;
+  for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
+  {
+    if (! layers[styleIndex][layerIndex])
+      continue;
+    // CGLayer sizes already include the contentsScale. Assume 4 bytes per
+    // pixel.
+    CGSize layerSize = CGLayerGetSize(layers[styleIndex][layerIndex]);
+    memoryUsage += (unsigned long long)(layerSize.width * layerSize.height * 4);
+  }
+  return memoryUsage;
 }
 
 #pragma mark - Caching methods
 
 - (CGLayerRef) layerOfType:(enum NodeTreeViewLayerType)nodeTreeViewLayerType
 {
-  return layers[nodeTreeViewLayerType];
+  CGLayerRef layer = layers[activeUserInterfaceStyleIndex][nodeTreeViewLayerType];
+  if (layer)
+    ++numberOfHits;
+  else
+    ++numberOfMisses;
+  return layer;
 }
 
 - (void) setLayer:(CGLayerRef)layer ofType:(enum NodeTreeViewLayerType)nodeTreeViewLayerType
 {
-  [self invalidateLayerOfType:nodeTreeViewLayerType];
+  CGLayerRef oldLayer = layers[activeUserInterfaceStyleIndex][nodeTreeViewLayerType];
+  if (oldLayer)
+    CGLayerRelease(oldLayer);
   CGLayerRetain(layer);
-  layers[nodeTreeViewLayerType] = layer;
+  layers[activeUserInterfaceStyleIndex][nodeTreeViewLayerType] = layer;
 }
 
 - (void) invalidateLayerOfType:(enum NodeTreeViewLayerType)nodeTreeViewLayerType
 {
-  if (layers[nodeTreeViewLayerType])
+  for (int styleIndex = 0; styleIndex < arraySizeUserInterfaceStyles; ++styleIndex)
   {
-    CGLayerRelease(layers[nodeTreeViewLayerType]);
-    layers[nodeTreeViewLayerType] = NULL;
+    [self invalidateLayersWithUserInterfaceStyleIndex:styleIndex
+                                       fromLayerIndex:nodeTreeViewLayerType
+                                          toLayerIndex:nodeTreeViewLayerType];
   }
 }
 
 - (void) invalidateAllNodeSymbolLayers
 {
-  for (int layerIndex = NodeTreeViewLayerTypeNodeSymbolFirst;
-       layerIndex <= NodeTreeViewLayerTypeNodeSymbolLast;
-       ++layerIndex)
+  for (int styleIndex = 0; styleIndex < arraySizeUserInterfaceStyles; ++styleIndex)
   {
-    if (layers[layerIndex])
-    {
-      CGLayerRelease(layers[layerIndex]);
-      layers[layerIndex] = NULL;
-    }
+    [self invalidateLayersWithUserInterfaceStyleIndex:styleIndex
+                                       fromLayerIndex:NodeTreeViewLayerTypeNodeSymbolFirst
+                                          toLayerIndex:NodeTreeViewLayerTypeNodeSymbolLast];
   }
 }
 
 - (void) invalidateAllLayers
 {
-  for (int layerIndex = 0; layerIndex < arraySizeLayers; ++layerIndex)
+  for (int styleIndex = 0; styleIndex < arraySizeUserInterfaceStyles; ++styleIndex)
+  {
+    [self invalidateLayersWithUserInterfaceStyleIndex:styleIndex
+                                       fromLayerIndex:NodeTreeViewLayerTypeFirst
+                                          toLayerIndex:NodeTreeViewLayerTypeLast];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Discards the layers in the range
+/// [@a fromLayerIndex, @a toLayerIndex] of the set of layers for the user
+/// interface style that has index @a styleIndex.
+// -----------------------------------------------------------------------------
+- (void) invalidateLayersWithUserInterfaceStyleIndex:(int)styleIndex
+                                      fromLayerIndex:(int)fromLayerIndex
+                                        toLayerIndex:(int)toLayerIndex
+{
+  for (int layerIndex = fromLayerIndex; layerIndex <= toLayerIndex; ++layerIndex)
   {
-    if (layers[layerIndex])
+    if (layers[styleIndex][layerIndex])
     {
-      CGLayerRelease(layers[layerIndex]);
-      layers[layerIndex] = NULL;
+      CGLayerRelease(layers[styleIndex][layerIndex]);
+      layers[styleIndex][layerIndex] = NULL;
     }
   }
 }
 
+#pragma mark - Properties
+
+- (bool) lightUserInterfaceStyle
+{
+  return (activeUserInterfaceStyleIndex == 0);
+}
+
+- (void) setLightUserInterfaceStyle:(bool)lightUserInterfaceStyle
+{
+  activeUserInterfaceStyleIndex = lightUserInterfaceStyle ? 0 : 1;
+}
+
+- (unsigned long long) numberOfHits
+{
+  return numberOfHits;
+}
+
+- (unsigned long long) numberOfMisses
+{
+  return numberOfMisses;
+}
+
 @end
@@ -34,6 +34,12 @@ enum NodeTreeViewLayerDelegateEvent
   /// tiling mechanism reuses a tile to display content at a different position
   /// on the canvas.
   NTVLDEventInvalidateContent,
+  /// @brief Is sent whenever the UIUserInterfaceStyle (light/dark mode)
+  /// changed. The layer must redraw its content with the new colors found in
+  /// NodeTreeViewMetrics, but the drawing cells and the node tree geometry did
+  /// not change. Cached CGLayers are kept because NodeTreeViewCGLayerCache
+  /// maintains a separate set of layers per user interface style.
+  NTVLDEventUserInterfaceStyleChanged,
   /// @brief Is sent whenever the abstract canvas size changed. The layer's
   /// drawing cells may have changed, and because of that also the content
   /// drawn by the layer. The event is sent only after NodeTreeViewCanvas and
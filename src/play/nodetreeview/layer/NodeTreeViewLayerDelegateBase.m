@@ -20,6 +20,7 @@
 #import "../NodeTreeViewMetrics.h"
 #import "../canvas/NodeTreeViewCellPosition.h"
 #import "../../../ui/CGDrawingHelper.h"
+#import "../../../ui/SignpostLayer.h"
 
 
 @implementation NodeTreeViewLayerDelegateBase
@@ -45,7 +46,7 @@
   if (! self)
     return nil;
 
-  self.layer = [CALayer layer];
+  self.layer = [SignpostLayer layerWithDrawingArea:SignpostDrawingAreaNodeTreeView];
   self.tile = tile;
   self.nodeTreeViewMetrics = metrics;
   self.dirty = false;
@@ -26,14 +26,26 @@
 // -----------------------------------------------------------------------------
 /// @brief The SelectedNodeLayerDelegate class is responsible for drawing the
 /// selection marker around the node that represents the current board position.
+///
+/// Unlike the other node tree view layer delegates, SelectedNodeLayerDelegate
+/// is not associated with a tile. Its layer covers only the cells of the
+/// selected node and is displayed by NodeTreeSelectionView, which moves the
+/// layer to the canvas rectangle @e canvasRectOfSelectedNode whenever the
+/// selected node changes. As long as the new selected node occupies a canvas
+/// rectangle of the same size as the previously selected node the layer
+/// content does not have to be redrawn, and no tile of the node tree view has
+/// to be redrawn either.
 // -----------------------------------------------------------------------------
 @interface SelectedNodeLayerDelegate : NodeTreeViewLayerDelegateBase
 {
 }
 
-- (id) initWithTile:(id<Tile>)tile
-            metrics:(NodeTreeViewMetrics*)metrics
-             canvas:(NodeTreeViewCanvas*)nodeTreeViewCanvas
-              model:(NodeTreeViewModel*)nodeTreeViewModel;
+- (id) initWithMetrics:(NodeTreeViewMetrics*)metrics
+                canvas:(NodeTreeViewCanvas*)nodeTreeViewCanvas
+                 model:(NodeTreeViewModel*)nodeTreeViewModel;
+
+/// @brief The canvas rectangle that is covered by the cells of the selected
+/// node. Is @e CGRectNull if there is no selected node.
+@property(nonatomic, assign, readonly) CGRect canvasRectOfSelectedNode;
 
 @end
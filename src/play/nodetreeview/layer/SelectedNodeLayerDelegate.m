@@ -22,7 +22,6 @@
 #import "../NodeTreeViewMetrics.h"
 #import "../canvas/NodeTreeViewCanvas.h"
 #import "../canvas/NodeTreeViewCell.h"
-#import "../../../ui/CGDrawingHelper.h"
 
 
 // -----------------------------------------------------------------------------
@@ -32,7 +31,8 @@
 @interface SelectedNodeLayerDelegate()
 @property(nonatomic, assign) NodeTreeViewCanvas* nodeTreeViewCanvas;
 @property(nonatomic, assign) NodeTreeViewModel* nodeTreeViewModel;
-@property(nonatomic, retain) NSArray* selectedNodePositionsOnTile;
+@property(nonatomic, retain) NSArray* selectedNodePositions;
+@property(nonatomic, assign, readwrite) CGRect canvasRectOfSelectedNode;
 @end
 
 
@@ -43,19 +43,19 @@
 ///
 /// @note This is the designated initializer of SelectedNodeLayerDelegate.
 // -----------------------------------------------------------------------------
-- (id) initWithTile:(id<Tile>)tile
-            metrics:(NodeTreeViewMetrics*)metrics
-             canvas:(NodeTreeViewCanvas*)nodeTreeViewCanvas
-              model:(NodeTreeViewModel*)nodeTreeViewModel
+- (id) initWithMetrics:(NodeTreeViewMetrics*)metrics
+                canvas:(NodeTreeViewCanvas*)nodeTreeViewCanvas
+                 model:(NodeTreeViewModel*)nodeTreeViewModel
 {
   // Call designated initializer of superclass (NodeTreeViewLayerDelegateBase)
-  self = [super initWithTile:tile metrics:metrics];
+  self = [super initWithTile:nil metrics:metrics];
   if (! self)
     return nil;
 
   self.nodeTreeViewCanvas = nodeTreeViewCanvas;
   self.nodeTreeViewModel = nodeTreeViewModel;
-  self.selectedNodePositionsOnTile = @[];
+  self.selectedNodePositions = @[];
+  self.canvasRectOfSelectedNode = CGRectNull;
 
   return self;
 }
@@ -73,7 +73,7 @@
   [self invalidateLayers];
 
   self.nodeTreeViewCanvas = nil;
-  self.selectedNodePositionsOnTile = nil;
+  self.selectedNodePositions = nil;
 
   [super dealloc];
 }
@@ -99,7 +99,12 @@
     case NTVLDEventInvalidateContent:
     {
       [self invalidateLayers];
-      self.selectedNodePositionsOnTile = [self calculateSelectedNodePositionsOnTile];
+      [self updateSelectedNodePositions:[self.nodeTreeViewCanvas selectedNodePositions]];
+      self.dirty = true;
+      break;
+    }
+    case NTVLDEventUserInterfaceStyleChanged:
+    {
       self.dirty = true;
       break;
     }
@@ -108,30 +113,24 @@
     case NTVLDEventNodeTreeAlignMoveNodesChanged:
     case NTVLDEventNodeTreeBranchingStyleChanged:
     {
-      self.selectedNodePositionsOnTile = [self calculateSelectedNodePositionsOnTile];
-      self.dirty = true;
+      if ([self updateSelectedNodePositions:[self.nodeTreeViewCanvas selectedNodePositions]])
+        self.dirty = true;
       break;
     }
     case NTVLDEventNodeTreeSelectedNodeChanged:
     {
       NSArray* newSelectedNodePositionsTuple = eventInfo;
       NSArray* newSelectedNodeTreeViewPositions = newSelectedNodePositionsTuple.firstObject;
-      NSArray* newSelectedNodePositionsOnTile = [self calculateSelectedNodePositionsOnTile:newSelectedNodeTreeViewPositions];
-      if (! [self.selectedNodePositionsOnTile isEqualToArray:newSelectedNodePositionsOnTile])
-      {
-        self.selectedNodePositionsOnTile = newSelectedNodePositionsOnTile;
-        // Instead of redrawing the entire tile, we could only redraw the cells
-        // for the de-selected node and for the newly selected node. See
-        // handling of NTVLDEventNodeTreeNodeSymbolChanged for an example how
-        // to calculate the dirty rect for a node's cells.
+      // Moving the layer is sufficient if the newly selected node occupies a
+      // canvas rectangle of the same size as the previously selected node
+      if ([self updateSelectedNodePositions:newSelectedNodeTreeViewPositions])
         self.dirty = true;
-      }
       break;
     }
     case NTVLDEventNodeTreeNodeSelectionStyleChanged:
     {
       [self invalidateLayers];
-      if (self.selectedNodePositionsOnTile.count > 0)
+      if (self.selectedNodePositions.count > 0)
         self.dirty = true;
       break;
     }
@@ -147,17 +146,18 @@
 // -----------------------------------------------------------------------------
 - (void) drawLayer:(CALayer*)layer inContext:(CGContextRef)context
 {
-  if (self.selectedNodePositionsOnTile.count == 0)
+  if (self.selectedNodePositions.count == 0)
     return;
 
   [self createLayersIfNecessaryWithContext:context];
 
   bool condenseMoveNodes = self.nodeTreeViewMetrics.condenseMoveNodes;
   NodeTreeViewCGLayerCache* cache = [NodeTreeViewCGLayerCache sharedCache];
-  CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
-                                              withSize:self.nodeTreeViewMetrics.tileSize];
+  // The layer covers exactly the selected node, so the selected node's canvas
+  // rectangle takes the role that the tile rectangle has for other layers
+  CGRect canvasRect = self.canvasRectOfSelectedNode;
 
-  for (NodeTreeViewCellPosition* position in self.selectedNodePositionsOnTile)
+  for (NodeTreeViewCellPosition* position in self.selectedNodePositions)
   {
     NodeTreeViewCell* cell = [self.nodeTreeViewCanvas cellAtPosition:position];
     if (! cell || ! cell.selected)
@@ -170,7 +170,7 @@
                                withContext:context
                                       part:cell.part
                               partPosition:position
-                            inTileWithRect:tileRect
+                            inTileWithRect:canvasRect
                                withMetrics:self.nodeTreeViewMetrics];
     }
     else
@@ -179,7 +179,7 @@
       [NodeTreeViewDrawingHelper drawLayer:layer
                                withContext:context
                                 centeredAt:position
-                            inTileWithRect:tileRect
+                            inTileWithRect:canvasRect
                                withMetrics:self.nodeTreeViewMetrics];
     }
   }
@@ -210,37 +210,29 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Examines all NodeTreeViewCellPosition objects in
-/// @a selectedNodePositions and returns only those whose canvas rectangle
-/// intersects with this tile.
+/// @brief Stores @a selectedNodePositions and updates
+/// @e canvasRectOfSelectedNode to the union of the canvas rectangles of all
+/// cells in @a selectedNodePositions. Returns true if the size of
+/// @e canvasRectOfSelectedNode changed, i.e. if the layer content must be
+/// redrawn. Returns false if the layer content can be reused, even if the
+/// layer has to be moved.
 // -----------------------------------------------------------------------------
-- (NSArray*) calculateSelectedNodePositionsOnTile:(NSArray*)selectedNodePositions
+- (bool) updateSelectedNodePositions:(NSArray*)selectedNodePositions
 {
-  CGRect tileRect = [CGDrawingHelper canvasRectForTile:self.tile
-                                              withSize:self.nodeTreeViewMetrics.tileSize];
-
-  NSMutableArray* selectedNodePositionsOnTile = [NSMutableArray array];
-
+  CGRect canvasRectOfSelectedNode = CGRectNull;
   for (NodeTreeViewCellPosition* position in selectedNodePositions)
   {
     CGRect canvasRectForCell = [NodeTreeViewDrawingHelper canvasRectForCellAtPosition:position metrics:self.nodeTreeViewMetrics];
-    if (CGRectIntersectsRect(tileRect, canvasRectForCell))
-      [selectedNodePositionsOnTile addObject:position];
+    canvasRectOfSelectedNode = CGRectUnion(canvasRectOfSelectedNode, canvasRectForCell);
   }
 
-  return selectedNodePositionsOnTile;
-}
+  CGRect previousCanvasRectOfSelectedNode = self.canvasRectOfSelectedNode;
+  self.selectedNodePositions = selectedNodePositions ? selectedNodePositions : @[];
+  self.canvasRectOfSelectedNode = canvasRectOfSelectedNode;
 
-// -----------------------------------------------------------------------------
-/// @brief Returns a list of NodeTreeViewCellPosition objects which refer to the
-/// currently selected node on the node tree view canvas and whose canvas
-/// rectangle intersects with this tile.
-// -----------------------------------------------------------------------------
-- (NSArray*) calculateSelectedNodePositionsOnTile
-{
-  NSArray* selectedNodePositions = [self.nodeTreeViewCanvas selectedNodePositions];
-  NSArray* newSelectedNodePositionsOnTile = [self calculateSelectedNodePositionsOnTile:selectedNodePositions];
-  return newSelectedNodePositionsOnTile;
+  if (CGRectIsNull(previousCanvasRectOfSelectedNode) || CGRectIsNull(canvasRectOfSelectedNode))
+    return ! (CGRectIsNull(previousCanvasRectOfSelectedNode) && CGRectIsNull(canvasRectOfSelectedNode));
+  return ! CGSizeEqualToSize(previousCanvasRectOfSelectedNode.size, canvasRectOfSelectedNode.size);
 }
 
 @end
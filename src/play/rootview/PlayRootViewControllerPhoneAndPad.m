@@ -75,7 +75,7 @@
 @property(nonatomic, retain) NodeTreeViewIntegration* nodeTreeViewIntegration;
 // Other properties
 @property(nonatomic, assign) UILayoutConstraintAxis boardViewSmallerDimension;
-@property(nonatomic, retain) NSMutableArray* boardViewAutoLayoutConstraints;
+@property(nonatomic, retain) NSMutableDictionary* boardViewAutoLayoutConstraints;
 @property(nonatomic, assign) CGFloat boardPositionCollectionViewBorderWidth;
 //@}
 
@@ -841,7 +841,7 @@
 // -----------------------------------------------------------------------------
 - (void) setupAutoLayoutConstraintsPortraitBoardContainerView
 {
-  self.boardViewAutoLayoutConstraints = [NSMutableArray array];
+  self.boardViewAutoLayoutConstraints = [NSMutableDictionary dictionary];
 
   self.boardViewController.view.translatesAutoresizingMaskIntoConstraints = NO;
   
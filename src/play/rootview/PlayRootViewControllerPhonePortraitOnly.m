@@ -59,7 +59,7 @@
 @property(nonatomic, retain) BoardPositionCollectionViewController* boardPositionCollectionViewController;
 @property(nonatomic, retain) NodeTreeViewIntegration* nodeTreeViewIntegration;
 @property(nonatomic, assign) UILayoutConstraintAxis boardViewSmallerDimension;
-@property(nonatomic, retain) NSMutableArray* boardViewAutoLayoutConstraints;
+@property(nonatomic, retain) NSMutableDictionary* boardViewAutoLayoutConstraints;
 @property(nonatomic, assign) CGFloat boardPositionCollectionViewBorderWidth;
 @end
 
@@ -538,7 +538,7 @@
 // -----------------------------------------------------------------------------
 - (void) setupAutoLayoutConstraintsBoardContainerView
 {
-  self.boardViewAutoLayoutConstraints = [NSMutableArray array];
+  self.boardViewAutoLayoutConstraints = [NSMutableDictionary dictionary];
 
   self.boardViewController.view.translatesAutoresizingMaskIntoConstraints = NO;
 
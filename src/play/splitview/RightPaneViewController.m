@@ -58,7 +58,7 @@
 @property(nonatomic, retain) GameActionButtonBoxDataSource* gameActionButtonBoxDataSource;
 // Other properties
 @property(nonatomic, assign) UILayoutConstraintAxis boardViewSmallerDimension;
-@property(nonatomic, retain) NSMutableArray* boardViewAutoLayoutConstraints;
+@property(nonatomic, retain) NSMutableDictionary* boardViewAutoLayoutConstraints;
 @property(nonatomic, retain) NSArray* gameActionButtonBoxAutoLayoutConstraints;
 @end
 
@@ -86,7 +86,7 @@
   self.boardPositionButtonBoxContainerView = nil;
   self.boardContainerView = nil;
   self.boardViewSmallerDimension = UILayoutConstraintAxisVertical;
-  self.boardViewAutoLayoutConstraints = [NSMutableArray array];
+  self.boardViewAutoLayoutConstraints = [NSMutableDictionary dictionary];
   self.gameActionButtonBoxAutoLayoutConstraints = nil;
   return self;
 }
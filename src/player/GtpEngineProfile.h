@@ -90,13 +90,19 @@
 - (id) initWithDictionary:(NSDictionary*)dictionary;
 - (NSDictionary*) asDictionary;
 - (void) applyProfile;
+- (NSArray*) searchParameterCommandStringsForBoardSize:(enum GoBoardSize)boardSize;
 - (bool) isFallbackProfile;
 - (void) resetPlayingStrengthPropertiesToDefaultValues;
 - (void) resetResignBehaviourPropertiesToDefaultValues;
 - (int) resignThresholdForBoardSize:(enum GoBoardSize)boardSize;
 - (void) setResignThreshold:(int)threshold forBoardSize:(enum GoBoardSize)boardSize;
+- (int) effectiveFuegoThreadCount;
+- (int) effectiveFuegoMaxMemory;
 
 + (unsigned long long) fuegoResignMinGamesForMaxGames:(unsigned long long)maxGames;
++ (int) autoTunedFuegoThreadCount;
++ (int) benchmarkedFuegoThreadCount;
++ (int) autoTunedFuegoMaxMemory;
 
 
 // -----------------------------------------------------------------------------
@@ -158,6 +164,20 @@
 /// @brief The number of threads that the Fuego GTP engine should use for its
 /// calculations.
 @property(nonatomic, assign) int fuegoThreadCount;
+/// @brief The value of this flag decides whether the number of threads and the
+/// maximum amount of memory are automatically selected to suit the device
+/// (flag is true), or whether @e fuegoThreadCount and @e fuegoMaxMemory are
+/// used (flag is false).
+///
+/// This flag is false by default. If the flag is true, the values are selected
+/// when the profile is applied, based on the number of CPU cores and the
+/// amount of physical memory of the device. The number of threads is reduced
+/// while the device is under thermal pressure. @e fuegoThreadCount and
+/// @e fuegoMaxMemory keep their values, they are used again when the flag is
+/// turned off.
+///
+/// @see autoTunedFuegoThreadCount(), autoTunedFuegoMaxMemory().
+@property(nonatomic, assign) bool autoTuneFuegoThreadCountAndMaxMemory;
 /// @brief True if Fuego should play with pondering on.
 @property(nonatomic, assign) bool fuegoPondering;
 /// @brief Maximum time in seconds that Fuego is allowed to ponder (i.e. think
@@ -168,6 +188,14 @@
 /// @brief Maximum time in seconds that Fuego is allowed to think on its own
 /// turn.
 @property(nonatomic, assign) unsigned int fuegoMaxThinkingTime;
+/// @brief Time budget in seconds that Fuego may spend on all of its moves in a
+/// game. 0 means that there is no time budget for the game.
+///
+/// If there is a time budget, the GTP engine is told before each move how much
+/// of the budget is left, and Fuego's time management distributes the
+/// remaining time over the remaining moves. Each individual move is still
+/// limited by @e fuegoMaxThinkingTime.
+@property(nonatomic, assign) unsigned int fuegoMaxGameTime;
 /// @brief Maximum number of games that Fuego is allowed to play before it must
 /// decide on a best move.
 @property(nonatomic, assign) unsigned long long fuegoMaxGames;
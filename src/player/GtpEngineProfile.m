@@ -20,10 +20,17 @@
 #import "GtpEngineProfileModel.h"
 #import "../go/GoBoard.h"
 #import "../go/GoGame.h"
+#import "../gtp/GtpClient.h"
 #import "../gtp/GtpCommand.h"
+#import "../gtp/GtpEnergyGovernor.h"
+#import "../gtp/GtpEngineState.h"
 #import "../gtp/GtpUtilities.h"
 #import "../main/ApplicationDelegate.h"
 #import "../utility/NSStringAdditions.h"
+#import "../utility/UIDeviceAdditions.h"
+
+// System includes
+#include <sys/sysctl.h>
 
 
 // -----------------------------------------------------------------------------
@@ -94,10 +101,12 @@
     self.profileDescription = [dictionary valueForKey:gtpEngineProfileDescriptionKey];
     self.fuegoMaxMemory = [[dictionary valueForKey:fuegoMaxMemoryKey] intValue];
     self.fuegoThreadCount = [[dictionary valueForKey:fuegoThreadCountKey] intValue];
+    self.autoTuneFuegoThreadCountAndMaxMemory = [[dictionary valueForKey:autoTuneFuegoThreadCountAndMaxMemoryKey] boolValue];
     self.fuegoPondering = [[dictionary valueForKey:fuegoPonderingKey] boolValue];
     self.fuegoMaxPonderTime = [[dictionary valueForKey:fuegoMaxPonderTimeKey] unsignedIntValue];
     self.fuegoReuseSubtree = [[dictionary valueForKey:fuegoReuseSubtreeKey] boolValue];
     self.fuegoMaxThinkingTime = [[dictionary valueForKey:fuegoMaxThinkingTimeKey] unsignedIntValue];
+    self.fuegoMaxGameTime = [[dictionary valueForKey:fuegoMaxGameTimeKey] unsignedIntValue];
     self.fuegoMaxGames = [[dictionary valueForKey:fuegoMaxGamesKey] unsignedLongLongValue];
     self.autoSelectFuegoResignMinGames = [[dictionary valueForKey:autoSelectFuegoResignMinGamesKey] boolValue];
     self.fuegoResignMinGames = [[dictionary valueForKey:fuegoResignMinGamesKey] unsignedLongLongValue];
@@ -147,10 +156,12 @@
   [dictionary setValue:self.profileDescription forKey:gtpEngineProfileDescriptionKey];
   [dictionary setValue:[NSNumber numberWithInt:self.fuegoMaxMemory] forKey:fuegoMaxMemoryKey];
   [dictionary setValue:[NSNumber numberWithInt:self.fuegoThreadCount] forKey:fuegoThreadCountKey];
+  [dictionary setValue:[NSNumber numberWithBool:self.autoTuneFuegoThreadCountAndMaxMemory] forKey:autoTuneFuegoThreadCountAndMaxMemoryKey];
   [dictionary setValue:[NSNumber numberWithBool:self.fuegoPondering] forKey:fuegoPonderingKey];
   [dictionary setValue:[NSNumber numberWithUnsignedInt:self.fuegoMaxPonderTime] forKey:fuegoMaxPonderTimeKey];
   [dictionary setValue:[NSNumber numberWithBool:self.fuegoReuseSubtree] forKey:fuegoReuseSubtreeKey];
   [dictionary setValue:[NSNumber numberWithUnsignedInt:self.fuegoMaxThinkingTime] forKey:fuegoMaxThinkingTimeKey];
+  [dictionary setValue:[NSNumber numberWithUnsignedInt:self.fuegoMaxGameTime] forKey:fuegoMaxGameTimeKey];
   [dictionary setValue:[NSNumber numberWithUnsignedLongLong:self.fuegoMaxGames] forKey:fuegoMaxGamesKey];
   [dictionary setValue:[NSNumber numberWithBool:self.autoSelectFuegoResignMinGames] forKey:autoSelectFuegoResignMinGamesKey];
   [dictionary setValue:[NSNumber numberWithUnsignedLongLong:self.fuegoResignMinGames] forKey:fuegoResignMinGamesKey];
@@ -170,52 +181,35 @@
 /// processed. This is so that the UI is not blocked if another lengthy GTP
 /// command (e.g. "genmove") is already being executed at the time that the
 /// profile settings are changed
+///
+/// Only those parameters are sent to the GTP engine that differ from the
+/// parameters that the GTP engine already has (see GtpEngineState). The GTP
+/// commands are submitted as a pipeline so that they take only one
+/// round-trip to the GTP engine.
 // -----------------------------------------------------------------------------
 - (void) applyProfile
 {
   DDLogInfo(@"Applying GTP profile settings: %@", [self description]);
 
-  NSString* commandString;
-  GtpCommand* command;
-
-  long long fuegoMaxMemoryInBytes = self.fuegoMaxMemory * 1000000;
-  commandString = [NSString stringWithFormat:@"uct_max_memory %lld", fuegoMaxMemoryInBytes];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  commandString = [NSString stringWithFormat:@"uct_param_search number_threads %d", self.fuegoThreadCount];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  commandString = [NSString stringWithFormat:@"uct_param_player reuse_subtree %d", (self.fuegoReuseSubtree ? 1 : 0)];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  if (self.fuegoPondering)
-    [GtpUtilities startPondering];
-  else
-    [GtpUtilities stopPondering];
-  commandString = [NSString stringWithFormat:@"uct_param_player max_ponder_time %u", self.fuegoMaxPonderTime];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  commandString = [NSString stringWithFormat:@"go_param timelimit %u", self.fuegoMaxThinkingTime];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  commandString = [NSString stringWithFormat:@"uct_param_player max_games %llu", self.fuegoMaxGames];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  commandString = [NSString stringWithFormat:@"uct_param_player resign_min_games %llu", self.fuegoResignMinGames];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
-  int resignThreshold = [self resignThresholdForBoardSize:[GoGame sharedGame].board.size];
-  commandString = [NSString stringWithFormat:@"uct_param_player resign_threshold %f", resignThreshold / 100.0];
-  command = [GtpCommand command:commandString];
-  command.waitUntilDone = false;
-  [command submit];
+  bool shouldPonder = [[GtpEnergyGovernor sharedGovernor] shouldPonderWithProfile:self];
+  NSMutableArray* commandStrings = [NSMutableArray arrayWithObject:[GtpUtilities ponderingCommandString:shouldPonder]];
+  enum GoBoardSize boardSize = [GoGame sharedGame].board.size;
+  [commandStrings addObjectsFromArray:[self searchParameterCommandStringsForBoardSize:boardSize]];
+
+  GtpEngineState* engineState = [ApplicationDelegate sharedDelegate].gtpClient.engineState;
+  NSArray* unappliedCommandStrings = [engineState unappliedParameterCommands:commandStrings];
+  DDLogVerbose(@"%@: %lu of %lu GTP commands change the engine's parameters", [self description], (unsigned long)unappliedCommandStrings.count, (unsigned long)commandStrings.count);
+  if (unappliedCommandStrings.count > 0)
+  {
+    NSMutableArray* commands = [NSMutableArray arrayWithCapacity:unappliedCommandStrings.count];
+    for (NSString* commandString in unappliedCommandStrings)
+    {
+      GtpCommand* command = [GtpCommand command:commandString];
+      command.waitUntilDone = false;
+      [commands addObject:command];
+    }
+    [GtpCommand submitCommands:commands];
+  }
 
   self.hasUnappliedChanges = false;
   if (! self.isActiveProfile)
@@ -234,6 +228,39 @@
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the GTP commands that configure the search of the GTP engine
+/// with the settings in this profile, for a game on a board of size
+/// @a boardSize. Pondering is not included. The maximum ponder time is the
+/// one that GtpEnergyGovernor currently allows for this profile.
+///
+/// This is used by applyProfile(), and by clients that need to configure the
+/// GTP engine with this profile's settings without activating the profile.
+// -----------------------------------------------------------------------------
+- (NSArray*) searchParameterCommandStringsForBoardSize:(enum GoBoardSize)boardSize
+{
+  NSMutableArray* commandStrings = [NSMutableArray array];
+
+  long long fuegoMaxMemoryInBytes = [self effectiveFuegoMaxMemory] * 1000000LL;
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_max_memory %lld", fuegoMaxMemoryInBytes]];
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_param_search number_threads %d", [self effectiveFuegoThreadCount]]];
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_param_player reuse_subtree %d", (self.fuegoReuseSubtree ? 1 : 0)]];
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_param_player max_ponder_time %u", [[GtpEnergyGovernor sharedGovernor] maxPonderTimeWithProfile:self]]];
+  [commandStrings addObject:[NSString stringWithFormat:@"go_param timelimit %u", self.fuegoMaxThinkingTime]];
+  // According to the GTP specification, a byo yomi time > 0 combined with
+  // 0 byo yomi stones means "no time limit"
+  if (self.fuegoMaxGameTime > 0)
+    [commandStrings addObject:[NSString stringWithFormat:@"time_settings %u 0 0", self.fuegoMaxGameTime]];
+  else
+    [commandStrings addObject:@"time_settings 0 1 0"];
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_param_player max_games %llu", self.fuegoMaxGames]];
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_param_player resign_min_games %llu", self.fuegoResignMinGames]];
+  int resignThreshold = [self resignThresholdForBoardSize:boardSize];
+  [commandStrings addObject:[NSString stringWithFormat:@"uct_param_player resign_threshold %f", resignThreshold / 100.0]];
+
+  return commandStrings;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns true if this GtpEngineProfile object is the fallback profile.
 // -----------------------------------------------------------------------------
@@ -251,8 +278,10 @@
 
   if (fuegoMaxMemoryDefault == self.fuegoMaxMemory
       && fuegoThreadCountDefault == self.fuegoThreadCount
+      && autoTuneFuegoThreadCountAndMaxMemoryDefault == self.autoTuneFuegoThreadCountAndMaxMemory
       && fuegoMaxPonderTimeDefault == self.fuegoMaxPonderTime
-      && fuegoMaxThinkingTimeDefault == self.fuegoMaxThinkingTime)
+      && fuegoMaxThinkingTimeDefault == self.fuegoMaxThinkingTime
+      && fuegoMaxGameTimeDefault == self.fuegoMaxGameTime)
   {
     if (fuegoMaxGamesPlayingStrength1 == self.fuegoMaxGames)
       playingStrength = 1;
@@ -356,10 +385,12 @@
 {
   self.fuegoMaxMemory = fuegoMaxMemoryDefault;
   self.fuegoThreadCount = fuegoThreadCountDefault;
+  self.autoTuneFuegoThreadCountAndMaxMemory = autoTuneFuegoThreadCountAndMaxMemoryDefault;
   self.fuegoPondering = fuegoPonderingDefault;
   self.fuegoMaxPonderTime = fuegoMaxPonderTimeDefault;
   self.fuegoReuseSubtree = fuegoReuseSubtreeDefault;
   self.fuegoMaxThinkingTime = fuegoMaxThinkingTimeDefault;
+  self.fuegoMaxGameTime = fuegoMaxGameTimeDefault;
   self.fuegoMaxGames = fuegoMaxGamesDefault;
 }
 
@@ -477,6 +508,18 @@
     self.hasUnappliedChanges = true;
 }
 
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setAutoTuneFuegoThreadCountAndMaxMemory:(bool)newValue
+{
+  if (_autoTuneFuegoThreadCountAndMaxMemory == newValue)
+    return;
+  _autoTuneFuegoThreadCountAndMaxMemory = newValue;
+  if (self.isActiveProfile)
+    self.hasUnappliedChanges = true;
+}
+
 // -----------------------------------------------------------------------------
 // Property is documented in the header file.
 // -----------------------------------------------------------------------------
@@ -525,6 +568,18 @@
     self.hasUnappliedChanges = true;
 }
 
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (void) setFuegoMaxGameTime:(unsigned int)newValue
+{
+  if (_fuegoMaxGameTime == newValue)
+    return;
+  _fuegoMaxGameTime = newValue;
+  if (self.isActiveProfile)
+    self.hasUnappliedChanges = true;
+}
+
 // -----------------------------------------------------------------------------
 // Property is documented in the header file.
 // -----------------------------------------------------------------------------
@@ -556,6 +611,121 @@
     return (maxGames - 1);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of threads that applyProfile() configures the GTP
+/// engine with. This is either @e fuegoThreadCount, or the auto-tuned number
+/// of threads.
+///
+/// @see Property @e autoTuneFuegoThreadCountAndMaxMemory.
+// -----------------------------------------------------------------------------
+- (int) effectiveFuegoThreadCount
+{
+  if (self.autoTuneFuegoThreadCountAndMaxMemory)
+    return [GtpEngineProfile autoTunedFuegoThreadCount];
+  else
+    return self.fuegoThreadCount;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the maximum amount of memory in MB that applyProfile()
+/// configures the GTP engine with. This is either @e fuegoMaxMemory, or the
+/// auto-tuned maximum amount of memory.
+///
+/// @see Property @e autoTuneFuegoThreadCountAndMaxMemory.
+// -----------------------------------------------------------------------------
+- (int) effectiveFuegoMaxMemory
+{
+  if (self.autoTuneFuegoThreadCountAndMaxMemory)
+    return [GtpEngineProfile autoTunedFuegoMaxMemory];
+  else
+    return self.fuegoMaxMemory;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a number of threads that is appropriate for the device
+/// according to the auto-tuning rules.
+///
+/// If RunThreadScalingBenchmarkCommand has measured the device, the number of
+/// threads is the one that the benchmark recommends (see
+/// benchmarkedFuegoThreadCount()). Otherwise the number of threads is the
+/// number of performance cores, so that Fuego does not spread its search to
+/// efficiency cores, which contribute little to the search but a lot to the
+/// energy consumption. If the number of performance cores cannot be
+/// determined, all active cores are used. The number is halved while the
+/// device's thermal state is serious, and reduced to a single thread while the
+/// thermal state is critical.
+///
+/// @see Property @e autoTuneFuegoThreadCountAndMaxMemory.
+// -----------------------------------------------------------------------------
++ (int) autoTunedFuegoThreadCount
+{
+  NSProcessInfo* processInfo = [NSProcessInfo processInfo];
+
+  int numberOfPerformanceCores = 0;
+  size_t size = sizeof(numberOfPerformanceCores);
+  int threadCount = [GtpEngineProfile benchmarkedFuegoThreadCount];
+  if (threadCount > 0)
+    ;  // the measurement has precedence over the rule of thumb
+  else if (0 == sysctlbyname("hw.perflevel0.logicalcpu", &numberOfPerformanceCores, &size, NULL, 0) && numberOfPerformanceCores > 0)
+    threadCount = numberOfPerformanceCores;
+  else
+    threadCount = (int)processInfo.activeProcessorCount;
+
+  switch (processInfo.thermalState)
+  {
+    case NSProcessInfoThermalStateSerious:
+      threadCount /= 2;
+      break;
+    case NSProcessInfoThermalStateCritical:
+      threadCount = 1;
+      break;
+    default:
+      break;
+  }
+
+  if (threadCount < fuegoThreadCountMinimum)
+    return fuegoThreadCountMinimum;
+  else if (threadCount > fuegoThreadCountMaximum)
+    return fuegoThreadCountMaximum;
+  else
+    return threadCount;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of threads that the most recent run of
+/// RunThreadScalingBenchmarkCommand recommends for the device. Returns 0 if
+/// the benchmark has never been run, or if it was run on a different device
+/// model (e.g. because the user defaults were restored from a backup of a
+/// different device).
+// -----------------------------------------------------------------------------
++ (int) benchmarkedFuegoThreadCount
+{
+  NSDictionary* benchmarkResult = [[NSUserDefaults standardUserDefaults] dictionaryForKey:threadScalingBenchmarkResultKey];
+  if (! benchmarkResult)
+    return 0;
+  if (! [benchmarkResult[@"deviceModel"] isEqualToString:[UIDevice hardwareModel]])
+    return 0;
+  return [benchmarkResult[@"recommendedNumberOfThreads"] intValue];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a maximum amount of memory in MB that is appropriate for the
+/// device according to the auto-tuning rules.
+///
+/// The maximum amount of memory is 1/16 of the device's physical memory, but
+/// never less than the default value.
+///
+/// @see Property @e autoTuneFuegoThreadCountAndMaxMemory.
+// -----------------------------------------------------------------------------
++ (int) autoTunedFuegoMaxMemory
+{
+  int maxMemory = [UIDevice physicalMemoryMegabytes] / 16;
+  if (maxMemory < fuegoMaxMemoryDefault)
+    return fuegoMaxMemoryDefault;
+  else
+    return maxMemory;
+}
+
 // -----------------------------------------------------------------------------
 // Property is documented in the header file.
 // -----------------------------------------------------------------------------
@@ -18,6 +18,7 @@
 // Project includes
 #import "GtpEngineProfileModel.h"
 #import "GtpEngineProfile.h"
+#import "../gtp/GtpCommand.h"
 
 
 @implementation GtpEngineProfileModel
@@ -36,6 +37,10 @@
   self.profileCount = 0;
   self.profileList = [NSMutableArray arrayWithCapacity:self.profileCount];
   self.activeProfile = nil;
+  [[NSNotificationCenter defaultCenter] addObserver:self
+                                           selector:@selector(thermalStateDidChange:)
+                                               name:NSProcessInfoThermalStateDidChangeNotification
+                                             object:nil];
   return self;
 }
 
@@ -44,6 +49,7 @@
 // -----------------------------------------------------------------------------
 - (void) dealloc
 {
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
   self.profileList = nil;
   self.activeProfile = nil;
   [super dealloc];
@@ -166,4 +172,35 @@
   return nil;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #NSProcessInfoThermalStateDidChangeNotification
+/// notification. Configures the GTP engine with a new number of threads if the
+/// active profile auto-tunes the number of threads, so that the number of
+/// threads matches the new thermal state.
+///
+/// This method is invoked in the context of the main thread, regardless of
+/// the thread in which the notification is posted.
+// -----------------------------------------------------------------------------
+- (void) thermalStateDidChange:(NSNotification*)notification
+{
+  if (! [NSThread isMainThread])
+  {
+    [self performSelectorOnMainThread:@selector(thermalStateDidChange:) withObject:notification waitUntilDone:NO];
+    return;
+  }
+
+  GtpEngineProfile* profile = self.activeProfile;
+  if (! profile || ! profile.autoTuneFuegoThreadCountAndMaxMemory)
+    return;
+
+  // Don't invoke applyProfile, that would also apply any unapplied changes
+  // that the user has made to the profile
+  int threadCount = [profile effectiveFuegoThreadCount];
+  DDLogInfo(@"Thermal state changed to %ld, changing number of GTP engine threads to %d", (long)[NSProcessInfo processInfo].thermalState, threadCount);
+  NSString* commandString = [NSString stringWithFormat:@"uct_param_search number_threads %d", threadCount];
+  GtpCommand* command = [GtpCommand command:commandString];
+  command.waitUntilDone = false;
+  [command submit];
+}
+
 @end
@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GtpEngineProfile;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpEngineTournamentResult class collects the outcome of a
+/// tournament played by PlayEngineTournamentCommand between two
+/// GtpEngineProfile objects.
+///
+/// The two profiles are referred to as the "first" and the "second" profile.
+/// All values that describe the relative strength of the profiles are from the
+/// point of view of the first profile.
+// -----------------------------------------------------------------------------
+@interface GtpEngineTournamentResult : NSObject
+{
+}
+
+- (id) initWithFirstProfile:(GtpEngineProfile*)firstProfile secondProfile:(GtpEngineProfile*)secondProfile;
+
+/// @brief The first profile.
+@property(nonatomic, retain, readonly) GtpEngineProfile* firstProfile;
+/// @brief The second profile.
+@property(nonatomic, retain, readonly) GtpEngineProfile* secondProfile;
+/// @brief How many games have been played.
+@property(nonatomic, assign) int gamesPlayed;
+/// @brief How many games the first profile has won.
+@property(nonatomic, assign) int gamesWonByFirstProfile;
+/// @brief How many games the second profile has won.
+@property(nonatomic, assign) int gamesWonBySecondProfile;
+/// @brief How many games ended without a winner, either because they were tied
+/// or because they exceeded the maximum number of moves.
+@property(nonatomic, assign) int gamesTied;
+/// @brief The number of moves generated by the first profile.
+@property(nonatomic, assign) int numberOfMovesByFirstProfile;
+/// @brief The number of moves generated by the second profile.
+@property(nonatomic, assign) int numberOfMovesBySecondProfile;
+/// @brief The total time in seconds that the first profile spent generating
+/// moves.
+@property(nonatomic, assign) double thinkingTimeOfFirstProfile;
+/// @brief The total time in seconds that the second profile spent generating
+/// moves.
+@property(nonatomic, assign) double thinkingTimeOfSecondProfile;
+/// @brief The total number of playouts of all searches of the first profile.
+@property(nonatomic, assign) unsigned long long playoutsOfFirstProfile;
+/// @brief The total number of playouts of all searches of the second profile.
+@property(nonatomic, assign) unsigned long long playoutsOfSecondProfile;
+/// @brief The total duration in seconds of all searches of the first profile.
+@property(nonatomic, assign) double searchTimeOfFirstProfile;
+/// @brief The total duration in seconds of all searches of the second profile.
+@property(nonatomic, assign) double searchTimeOfSecondProfile;
+
+/// @brief The estimated Elo rating difference between the first and the second
+/// profile. A positive value means that the first profile is stronger.
+@property(nonatomic, assign, readonly) double eloDifference;
+/// @brief The mean time in seconds that the first profile needed per move.
+@property(nonatomic, assign, readonly) double meanTimePerMoveOfFirstProfile;
+/// @brief The mean time in seconds that the second profile needed per move.
+@property(nonatomic, assign, readonly) double meanTimePerMoveOfSecondProfile;
+/// @brief The mean number of playouts per second of the first profile.
+@property(nonatomic, assign, readonly) double playoutsPerSecondOfFirstProfile;
+/// @brief The mean number of playouts per second of the second profile.
+@property(nonatomic, assign, readonly) double playoutsPerSecondOfSecondProfile;
+
+@end
@@ -0,0 +1,165 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "GtpEngineTournamentResult.h"
+#import "GtpEngineProfile.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// GtpEngineTournamentResult.
+// -----------------------------------------------------------------------------
+@interface GtpEngineTournamentResult()
+/// @name Re-declaration of properties to make them readwrite privately
+//@{
+@property(nonatomic, retain, readwrite) GtpEngineProfile* firstProfile;
+@property(nonatomic, retain, readwrite) GtpEngineProfile* secondProfile;
+//@}
+@end
+
+
+@implementation GtpEngineTournamentResult
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpEngineTournamentResult object for a tournament
+/// between @a firstProfile and @a secondProfile in which no games have been
+/// played yet.
+///
+/// @note This is the designated initializer of GtpEngineTournamentResult.
+// -----------------------------------------------------------------------------
+- (id) initWithFirstProfile:(GtpEngineProfile*)firstProfile secondProfile:(GtpEngineProfile*)secondProfile
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.firstProfile = firstProfile;
+  self.secondProfile = secondProfile;
+  self.gamesPlayed = 0;
+  self.gamesWonByFirstProfile = 0;
+  self.gamesWonBySecondProfile = 0;
+  self.gamesTied = 0;
+  self.numberOfMovesByFirstProfile = 0;
+  self.numberOfMovesBySecondProfile = 0;
+  self.thinkingTimeOfFirstProfile = 0.0;
+  self.thinkingTimeOfSecondProfile = 0.0;
+  self.playoutsOfFirstProfile = 0;
+  self.playoutsOfSecondProfile = 0;
+  self.searchTimeOfFirstProfile = 0.0;
+  self.searchTimeOfSecondProfile = 0.0;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GtpEngineTournamentResult
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.firstProfile = nil;
+  self.secondProfile = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a description for this GtpEngineTournamentResult object.
+///
+/// This method is invoked when GtpEngineTournamentResult needs to be
+/// represented as a string, i.e. by NSLog, or when the debugger command "po"
+/// is used on the object.
+// -----------------------------------------------------------------------------
+- (NSString*) description
+{
+  return [NSString stringWithFormat:@"GtpEngineTournamentResult(%p): %@ vs. %@, games = %d, +%d -%d =%d, Elo difference = %.0f, time per move = %.2f / %.2f, playouts per second = %.0f / %.0f",
+          self,
+          self.firstProfile.name,
+          self.secondProfile.name,
+          self.gamesPlayed,
+          self.gamesWonByFirstProfile,
+          self.gamesWonBySecondProfile,
+          self.gamesTied,
+          self.eloDifference,
+          self.meanTimePerMoveOfFirstProfile,
+          self.meanTimePerMoveOfSecondProfile,
+          self.playoutsPerSecondOfFirstProfile,
+          self.playoutsPerSecondOfSecondProfile];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+//
+// The estimate is based on the logistic Elo model, where a score s (wins count
+// 1, ties count 1/2) corresponds to a rating difference of
+// -400 * log10(1/s - 1). A score of 0 or 1 would result in an infinite
+// difference, so in that case half a game is taken away from, or given to, the
+// first profile.
+// -----------------------------------------------------------------------------
+- (double) eloDifference
+{
+  if (0 == self.gamesPlayed)
+    return 0.0;
+
+  double score = (self.gamesWonByFirstProfile + 0.5 * self.gamesTied) / self.gamesPlayed;
+  double minimumScore = 0.5 / self.gamesPlayed;
+  score = fmax(minimumScore, fmin(1.0 - minimumScore, score));
+  return -400.0 * log10(1.0 / score - 1.0);
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (double) meanTimePerMoveOfFirstProfile
+{
+  if (0 == self.numberOfMovesByFirstProfile)
+    return 0.0;
+  return self.thinkingTimeOfFirstProfile / self.numberOfMovesByFirstProfile;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (double) meanTimePerMoveOfSecondProfile
+{
+  if (0 == self.numberOfMovesBySecondProfile)
+    return 0.0;
+  return self.thinkingTimeOfSecondProfile / self.numberOfMovesBySecondProfile;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (double) playoutsPerSecondOfFirstProfile
+{
+  if (0.0 == self.searchTimeOfFirstProfile)
+    return 0.0;
+  return self.playoutsOfFirstProfile / self.searchTimeOfFirstProfile;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (double) playoutsPerSecondOfSecondProfile
+{
+  if (0.0 == self.searchTimeOfSecondProfile)
+    return 0.0;
+  return self.playoutsOfSecondProfile / self.searchTimeOfSecondProfile;
+}
+
+@end
@@ -47,6 +47,7 @@ enum ViewSectionItem
 {
   MarkLastMoveItem,
   DisplayCoordinatesItem,
+  DisplayCapturableStonesItem,
   MaxViewSectionItem
 };
 
@@ -156,7 +157,7 @@ enum DisplayPlayerInfluenceSectionItem
   switch (section)
   {
     case ViewSection:
-      return @"On the iPhone you may need to zoom in to see coordinate labels.";
+      return @"On the iPhone you may need to zoom in to see coordinate labels. Capturable stones are stones that the side to move can capture in a ladder or with a short sequence of moves.";
     case DisplayMoveNumbersSection:
       return @"The lowest setting displays no move numbers, the highest setting displays all move numbers. On the iPhone you may need to zoom in to see move numbers.";
     case DisplayPlayerInfluenceSection:
@@ -197,6 +198,15 @@ enum DisplayPlayerInfluenceSectionItem
           [accessoryView addTarget:self action:@selector(toggleDisplayCoordinates:) forControlEvents:UIControlEventValueChanged];
           break;
         }
+        case DisplayCapturableStonesItem:
+        {
+          cell = [TableViewCellFactory cellWithType:SwitchCellType tableView:tableView];
+          UISwitch* accessoryView = (UISwitch*)cell.accessoryView;
+          cell.textLabel.text = @"Mark capturable stones";
+          accessoryView.on = self.boardViewModel.displayCapturableStones;
+          [accessoryView addTarget:self action:@selector(toggleDisplayCapturableStones:) forControlEvents:UIControlEventValueChanged];
+          break;
+        }
         default:
         {
           assert(0);
@@ -286,6 +296,16 @@ enum DisplayPlayerInfluenceSectionItem
   self.boardViewModel.displayCoordinates = accessoryView.on;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Reacts to a tap gesture on the "Mark capturable stones" switch.
+/// Writes the new value to the appropriate model.
+// -----------------------------------------------------------------------------
+- (void) toggleDisplayCapturableStones:(id)sender
+{
+  UISwitch* accessoryView = (UISwitch*)sender;
+  self.boardViewModel.displayCapturableStones = accessoryView.on;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Reacts to the user changing the "display move numbers" setting.
 // -----------------------------------------------------------------------------
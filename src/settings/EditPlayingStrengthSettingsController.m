@@ -29,6 +29,7 @@
 // -----------------------------------------------------------------------------
 enum EditPlayingStrengthSettingsTableViewSection
 {
+  AutoTuneSection,
   MaxMemorySection,
   ThreadsSection,
   PonderingSection,
@@ -38,6 +39,15 @@ enum EditPlayingStrengthSettingsTableViewSection
   MaxSection
 };
 
+// -----------------------------------------------------------------------------
+/// @brief Enumerates items in the AutoTuneSection.
+// -----------------------------------------------------------------------------
+enum AutoTuneSectionItem
+{
+  AutoTuneFuegoThreadCountAndMaxMemoryItem,
+  MaxAutoTuneSectionItem
+};
+
 // -----------------------------------------------------------------------------
 /// @brief Enumerates items in the MaxMemorySection.
 // -----------------------------------------------------------------------------
@@ -81,6 +91,7 @@ enum ReuseSubtreeSectionItem
 enum PlayoutLimitsSectionItem
 {
   FuegoMaxThinkingTimeItem,
+  FuegoMaxGameTimeItem,
   FuegoMaxGamesItem,
   MaxPlayoutLimitsSectionItem
 };
@@ -186,6 +197,8 @@ enum MaxGamesCategory
 {
   switch (section)
   {
+    case AutoTuneSection:
+      return MaxAutoTuneSectionItem;
     case MaxMemorySection:
       return MaxMaxMemorySectionItem;
     case ThreadsSection:
@@ -213,12 +226,26 @@ enum MaxGamesCategory
   UITableViewCell* cell = nil;
   switch (indexPath.section)
   {
+    case AutoTuneSection:
+    {
+      cell = [TableViewCellFactory cellWithType:SwitchCellType tableView:tableView];
+      UISwitch* accessoryView = (UISwitch*)cell.accessoryView;
+      cell.textLabel.text = @"Auto-tune for device";
+      accessoryView.on = self.profile.autoTuneFuegoThreadCountAndMaxMemory;
+      [accessoryView addTarget:self action:@selector(toggleAutoTune:) forControlEvents:UIControlEventValueChanged];
+      break;
+    }
     case MaxMemorySection:
     {
       cell = [TableViewCellFactory cellWithType:Value1CellType tableView:tableView];
       cell.textLabel.text = @"Maximum memory";
-      cell.detailTextLabel.text = [NSString stringWithFormat:@"%d MB", self.profile.fuegoMaxMemory];
-      cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
+      // If auto-tuning is on, the user must not change the value
+      bool autoTune = self.profile.autoTuneFuegoThreadCountAndMaxMemory;
+      int maxMemory = autoTune ? [GtpEngineProfile autoTunedFuegoMaxMemory] : self.profile.fuegoMaxMemory;
+      cell.detailTextLabel.text = [NSString stringWithFormat:@"%d MB", maxMemory];
+      cell.textLabel.enabled = ! autoTune;
+      cell.selectionStyle = autoTune ? UITableViewCellSelectionStyleNone : UITableViewCellSelectionStyleDefault;
+      cell.accessoryType = autoTune ? UITableViewCellAccessoryNone : UITableViewCellAccessoryDisclosureIndicator;
       break;
     }
     case ThreadsSection:
@@ -229,7 +256,10 @@ enum MaxGamesCategory
       sliderCell.descriptionLabel.text = @"Number of threads";
       sliderCell.slider.minimumValue = fuegoThreadCountMinimum;
       sliderCell.slider.maximumValue = fuegoThreadCountMaximum;
-      sliderCell.value = self.profile.fuegoThreadCount;
+      // If auto-tuning is on, the user must not change the value
+      bool autoTune = self.profile.autoTuneFuegoThreadCountAndMaxMemory;
+      sliderCell.value = autoTune ? [GtpEngineProfile autoTunedFuegoThreadCount] : self.profile.fuegoThreadCount;
+      sliderCell.slider.enabled = ! autoTune;
       break;
     }
     case PonderingSection:
@@ -295,6 +325,17 @@ enum MaxGamesCategory
           sliderCell.value = self.profile.fuegoMaxThinkingTime;
           break;
         }
+        case FuegoMaxGameTimeItem:
+        {
+          cell = [TableViewCellFactory cellWithType:SliderWithValueLabelCellType tableView:tableView];
+          TableViewSliderCell* sliderCell = (TableViewSliderCell*)cell;
+          [sliderCell setDelegate:self actionValueDidChange:nil actionSliderValueDidChange:@selector(maxGameTimeDidChange:)];
+          sliderCell.descriptionLabel.text = @"Game time (minutes)";
+          sliderCell.slider.minimumValue = fuegoMaxGameTimeMinimum / 60;
+          sliderCell.slider.maximumValue = fuegoMaxGameTimeMaximum / 60;
+          sliderCell.value = self.profile.fuegoMaxGameTime / 60;
+          break;
+        }
         case FuegoMaxGamesItem:
         {
           enum TableViewCellType cellType = Value1CellType;
@@ -344,6 +385,8 @@ enum MaxGamesCategory
 
   if (MaxMemorySection == indexPath.section)
   {
+    if (self.profile.autoTuneFuegoThreadCountAndMaxMemory)
+      return;
     MaxMemoryController* modalController = [[[MaxMemoryController alloc] init] autorelease];
     modalController.delegate = self;
     modalController.maxMemory = self.profile.fuegoMaxMemory;
@@ -466,6 +509,22 @@ enum MaxGamesCategory
   self.reuseSubtreeSwitch.enabled = ! self.profile.fuegoPondering;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Reacts to a tap gesture on the "Auto-tune for device" switch.
+/// Updates the profile object with the new value.
+// -----------------------------------------------------------------------------
+- (void) toggleAutoTune:(id)sender
+{
+  UISwitch* accessoryView = (UISwitch*)sender;
+  self.profile.autoTuneFuegoThreadCountAndMaxMemory = accessoryView.on;
+
+  [self.delegate didChangeProfile:self];
+
+  NSMutableIndexSet* indexSet = [NSMutableIndexSet indexSetWithIndex:MaxMemorySection];
+  [indexSet addIndex:ThreadsSection];
+  [self.tableView reloadSections:indexSet withRowAnimation:UITableViewRowAnimationNone];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Reacts to a tap gesture on the "Reuse subtree" switch. Updates the
 /// profile object with the new value.
@@ -511,6 +570,17 @@ enum MaxGamesCategory
   [self.delegate didChangeProfile:self];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Reacts to the user changing Fuego's time budget for the game.
+// -----------------------------------------------------------------------------
+- (void) maxGameTimeDidChange:(id)sender
+{
+  TableViewSliderCell* sliderCell = (TableViewSliderCell*)sender;
+  self.profile.fuegoMaxGameTime = sliderCell.value * 60;
+
+  [self.delegate didChangeProfile:self];
+}
+
 #pragma mark - Private helpers
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,53 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class SGFCDocumentReader;
+@class SGFCDocumentReadResult;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SgfFileCompression class is a container for functions that
+/// deal with .sgf files whose content is stored in compressed form.
+///
+/// @ingroup sgf
+///
+/// If the user enables compressed storage, games in the archive are stored
+/// as gzip compressed .sgf files. The files keep their .sgf extension so that
+/// the archive can treat compressed and uncompressed files alike. Whether a
+/// file is compressed is determined by looking at its content, not at its
+/// name.
+///
+/// SgfcKit can only read uncompressed files, so a compressed file is
+/// decompressed to a temporary file before it is read. Decompression streams
+/// the data in small chunks, so a large file is never held in memory as a
+/// whole. Uncompressed files are read directly.
+///
+/// All functions in SgfFileCompression are class methods, so there is no need
+/// to create an instance of SgfFileCompression.
+// -----------------------------------------------------------------------------
+@interface SgfFileCompression : NSObject
+{
+}
+
++ (bool) isCompressedSgfFile:(NSString*)sgfFilePath;
++ (bool) copySgfFile:(NSString*)sourceFilePath toPath:(NSString*)destinationFilePath compressed:(bool)compressed;
++ (SGFCDocumentReadResult*) readSgfFile:(NSString*)sgfFilePath withDocumentReader:(SGFCDocumentReader*)documentReader;
++ (NSString*) uncompressedSgfFileForSgfFile:(NSString*)sgfFilePath;
++ (void) removeUncompressedSgfFile:(NSString*)uncompressedFilePath;
+
+@end
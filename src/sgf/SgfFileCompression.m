@@ -0,0 +1,173 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "SgfFileCompression.h"
+#import "../utility/PathUtilities.h"
+
+// System includes
+#include <zlib.h>
+
+/// @brief The size of the chunks in which data is compressed and decompressed.
+static const int chunkSize = 64 * 1024;
+
+
+@implementation SgfFileCompression
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the file @a sgfFilePath is gzip compressed. Returns
+/// false if the file is not compressed, or if it cannot be read.
+// -----------------------------------------------------------------------------
++ (bool) isCompressedSgfFile:(NSString*)sgfFilePath
+{
+  NSFileHandle* fileHandle = [NSFileHandle fileHandleForReadingAtPath:sgfFilePath];
+  if (! fileHandle)
+    return false;
+  NSData* magicBytes = [fileHandle readDataOfLength:2];
+  [fileHandle closeFile];
+
+  if (magicBytes.length != 2)
+    return false;
+  // The two bytes with which every gzip stream starts, see RFC 1952
+  const unsigned char* bytes = magicBytes.bytes;
+  return (bytes[0] == 0x1f && bytes[1] == 0x8b);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Copies the .sgf file @a sourceFilePath to @a destinationFilePath.
+/// The destination file is gzip compressed if @a compressed is true, and
+/// uncompressed if @a compressed is false, regardless of whether the source
+/// file is compressed or not. Returns true if successful, false if not.
+///
+/// If the destination file already exists it is overwritten. If copying fails
+/// the destination file is removed.
+// -----------------------------------------------------------------------------
++ (bool) copySgfFile:(NSString*)sourceFilePath toPath:(NSString*)destinationFilePath compressed:(bool)compressed
+{
+  // gzread() reads uncompressed data transparently, so the same loop handles
+  // both cases of the source file
+  gzFile sourceFile = gzopen(sourceFilePath.fileSystemRepresentation, "rb");
+  if (! sourceFile)
+  {
+    DDLogError(@"%@: Failed to open %@ for reading", self, sourceFilePath);
+    return false;
+  }
+
+  // "T" makes gzwrite() write uncompressed data
+  const char* destinationMode = compressed ? "wb9" : "wbT";
+  gzFile destinationFile = gzopen(destinationFilePath.fileSystemRepresentation, destinationMode);
+  if (! destinationFile)
+  {
+    DDLogError(@"%@: Failed to open %@ for writing", self, destinationFilePath);
+    gzclose(sourceFile);
+    return false;
+  }
+
+  bool success = true;
+  char* buffer = malloc(chunkSize);
+  while (true)
+  {
+    int numberOfBytesRead = gzread(sourceFile, buffer, chunkSize);
+    if (numberOfBytesRead < 0)
+    {
+      int errorNumber;
+      DDLogError(@"%@: Failed to read %@: %s", self, sourceFilePath, gzerror(sourceFile, &errorNumber));
+      success = false;
+      break;
+    }
+    else if (numberOfBytesRead == 0)
+    {
+      break;
+    }
+
+    if (gzwrite(destinationFile, buffer, numberOfBytesRead) != numberOfBytesRead)
+    {
+      int errorNumber;
+      DDLogError(@"%@: Failed to write %@: %s", self, destinationFilePath, gzerror(destinationFile, &errorNumber));
+      success = false;
+      break;
+    }
+  }
+  free(buffer);
+
+  gzclose(sourceFile);
+  // Closing flushes the remaining compressed data, so this can fail, too
+  if (gzclose(destinationFile) != Z_OK)
+    success = false;
+
+  if (! success)
+    [PathUtilities deleteItemIfExists:destinationFilePath];
+
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reads the .sgf file @a sgfFilePath with @a documentReader and
+/// returns the result. The file is decompressed first if it is compressed.
+/// Returns nil if decompression fails.
+// -----------------------------------------------------------------------------
++ (SGFCDocumentReadResult*) readSgfFile:(NSString*)sgfFilePath withDocumentReader:(SGFCDocumentReader*)documentReader
+{
+  if (! [SgfFileCompression isCompressedSgfFile:sgfFilePath])
+    return [documentReader readSgfContentFromFile:sgfFilePath];
+
+  NSString* uncompressedFilePath = [SgfFileCompression uncompressedSgfFileForSgfFile:sgfFilePath];
+  if (! uncompressedFilePath)
+    return nil;
+
+  SGFCDocumentReadResult* readResult = [documentReader readSgfContentFromFile:uncompressedFilePath];
+  [SgfFileCompression removeUncompressedSgfFile:uncompressedFilePath];
+  return readResult;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Decompresses the .sgf file @a sgfFilePath into a new temporary file
+/// and returns the full path of the temporary file. The temporary file has
+/// the same name as @a sgfFilePath, so that it can be handed out to other
+/// apps. Returns nil if decompression fails.
+///
+/// The caller is responsible for removing the temporary file with
+/// removeUncompressedSgfFile:().
+// -----------------------------------------------------------------------------
++ (NSString*) uncompressedSgfFileForSgfFile:(NSString*)sgfFilePath
+{
+  // A unique folder per invocation allows several threads to decompress files
+  // with the same name at the same time
+  NSString* temporaryFolderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+  [PathUtilities createFolder:temporaryFolderPath removeIfExists:true];
+  NSString* uncompressedFilePath = [temporaryFolderPath stringByAppendingPathComponent:sgfFilePath.lastPathComponent];
+
+  bool success = [SgfFileCompression copySgfFile:sgfFilePath toPath:uncompressedFilePath compressed:false];
+  if (! success)
+  {
+    [PathUtilities deleteItemIfExists:temporaryFolderPath];
+    return nil;
+  }
+
+  return uncompressedFilePath;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the temporary file @a uncompressedFilePath that was created
+/// by uncompressedSgfFileForSgfFile:().
+// -----------------------------------------------------------------------------
++ (void) removeUncompressedSgfFile:(NSString*)uncompressedFilePath
+{
+  [PathUtilities deleteItemIfExists:[uncompressedFilePath stringByDeletingLastPathComponent]];
+}
+
+@end
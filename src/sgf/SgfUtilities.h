@@ -34,6 +34,8 @@
 
 + (bool) isLoadOperationSuccessful:(SGFCDocumentReadResult*)readResult
                withLoadSuccessType:(enum SgfLoadSuccessType)loadSuccessType;
++ (bool) writeContentHashToSgfFile:(NSString*)sgfFilePath;
++ (bool) hasSgfFileValidContentHash:(NSString*)sgfFilePath;
 
 + (NSString*) stringForSgfBoardSize:(SGFCBoardSize)sgfBoardSize;
 + (enum GoBoardSize) goBoardSizeForSgfBoardSize:(SGFCBoardSize)sgfBoardSize errorMessage:(NSString**)errorMessage;
@@ -43,6 +45,7 @@
 + (UIColor*) colorForLoadResultWithNoMessages;
 + (UIColor*) colorForLoadResultWithMessagesOfType:(SGFCMessageType)messageType isCriticalMessage:(bool)isCriticalMessage;
 + (UIImage*) coloredIndicatorForLoadResult:(SGFCDocumentReadResult*)loadResult;
++ (UIImage*) coloredIndicatorForLoadResultMessages:(NSArray*)messages;
 + (UIColor*) colorForMessageType:(SGFCMessageType)messageType isCriticalMessage:(bool)isCriticalMessage;
 + (UIImage*) coloredIndicatorForMessage:(SGFCMessage*)message;
 + (SGFCGameResult) gameResultForGoGameHasEndedReason:(enum GoGameHasEndedReason)goGameHasEndedReason;
@@ -20,6 +20,10 @@
 #import "../ui/UiUtilities.h"
 #import "../utility/UIColorAdditions.h"
 
+// System includes
+#import <CommonCrypto/CommonDigest.h>
+#import <sys/xattr.h>
+
 
 @implementation SgfUtilities
 
@@ -53,6 +57,79 @@
   return true;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Computes the content hash of the .sgf file @a sgfFilePath and stores
+/// it in an extended attribute of the file. Returns true if successful,
+/// returns false if the file cannot be read or the attribute cannot be written.
+///
+/// The content hash marks the file as having been written by the app. See
+/// hasSgfFileValidContentHash:() for details.
+// -----------------------------------------------------------------------------
++ (bool) writeContentHashToSgfFile:(NSString*)sgfFilePath
+{
+  NSData* contentHash = [SgfUtilities contentHashOfFile:sgfFilePath];
+  if (! contentHash)
+    return false;
+
+  int result = setxattr(sgfFilePath.fileSystemRepresentation,
+                        sgfContentHashAttributeName.UTF8String,
+                        contentHash.bytes,
+                        contentHash.length,
+                        0,
+                        0);
+  if (result != 0)
+  {
+    DDLogError(@"Failed to write content hash to %@, errno = %d", sgfFilePath, errno);
+    return false;
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the .sgf file @a sgfFilePath has a content hash that
+/// was stored by writeContentHashToSgfFile:(), and if the content hash matches
+/// the current content of the file. Returns false if the file has no content
+/// hash, or if the file was modified after the content hash was stored.
+///
+/// If this returns true the file was written by the app and has not been
+/// tampered with since, so the file can be trusted to contain valid SGF data.
+// -----------------------------------------------------------------------------
++ (bool) hasSgfFileValidContentHash:(NSString*)sgfFilePath
+{
+  unsigned char storedContentHash[CC_SHA256_DIGEST_LENGTH];
+  ssize_t storedContentHashLength = getxattr(sgfFilePath.fileSystemRepresentation,
+                                             sgfContentHashAttributeName.UTF8String,
+                                             storedContentHash,
+                                             sizeof(storedContentHash),
+                                             0,
+                                             0);
+  if (storedContentHashLength != CC_SHA256_DIGEST_LENGTH)
+    return false;
+
+  NSData* contentHash = [SgfUtilities contentHashOfFile:sgfFilePath];
+  if (! contentHash)
+    return false;
+
+  return (memcmp(contentHash.bytes, storedContentHash, CC_SHA256_DIGEST_LENGTH) == 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for writeContentHashToSgfFile:() and
+/// hasSgfFileValidContentHash:(). Returns the SHA-256 hash of the content of
+/// the file @a filePath. Returns nil if the file cannot be read.
+// -----------------------------------------------------------------------------
++ (NSData*) contentHashOfFile:(NSString*)filePath
+{
+  NSData* content = [NSData dataWithContentsOfFile:filePath options:NSDataReadingMappedIfSafe error:nil];
+  if (! content)
+    return nil;
+
+  unsigned char contentHash[CC_SHA256_DIGEST_LENGTH];
+  CC_SHA256(content.bytes, (CC_LONG)content.length, contentHash);
+  return [NSData dataWithBytes:contentHash length:CC_SHA256_DIGEST_LENGTH];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns a string representation of the content of @a sgfBoardSize.
 /// Returns an empty string if the board size is not valid.
@@ -293,6 +370,19 @@
 /// of @a loadResult.
 // -----------------------------------------------------------------------------
 + (UIImage*) coloredIndicatorForLoadResult:(SGFCDocumentReadResult*)loadResult
+{
+  return [SgfUtilities coloredIndicatorForLoadResultMessages:loadResult.parseResult];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a colored indicator that shows an overall classification of
+/// the load result messages in @a messages. The array is expected to contain
+/// SGFCMessage objects, as obtained from SGFCDocumentReadResult::parseResult().
+///
+/// This variant exists so that clients can classify a load result that they
+/// have memoized without keeping the SGFCDocumentReadResult object around.
+// -----------------------------------------------------------------------------
++ (UIImage*) coloredIndicatorForLoadResultMessages:(NSArray*)messages
 {
   static UIImage* noWarningsAndErrorsImage = nil;
   static UIImage* someNonCriticalWarningsImage = nil;
@@ -303,7 +393,7 @@
   int numberOfNonCriticalErrors = 0;
   int numberCriticalMessages = 0;
   int numberOfFatalErrors = 0;
-  for (SGFCMessage* message in loadResult.parseResult)
+  for (SGFCMessage* message in messages)
   {
     if (message.isCriticalMessage)
       numberCriticalMessages++;
@@ -315,7 +405,7 @@
       numberOfFatalErrors++;
   }
 
-  if (loadResult.parseResult.count == 0)
+  if (messages.count == 0)
   {
     if (! noWarningsAndErrorsImage)
     {
@@ -99,13 +99,35 @@
 /// is created and the application state is saved immediately, in the context of
 /// whatever thread has invoked commitSavePoint. Not using any delay is the only
 /// way how ApplicationStateManager can guarantee that a save point is created
-/// without any interruption by some other agent invoking beginSavePoint.
+/// without any interruption by some other agent invoking beginSavePoint. The
+/// exception is when the previous save was only a short while ago, see the
+/// section "Coalescing of saves" below.
 ///
 /// If an agent invokes beginSavePoint from another thread context while
 /// ApplicationStateManager is in the process of saving the application state,
 /// that agent is blocked until the process is complete.
 ///
 ///
+/// @par Coalescing of saves
+///
+/// Some user interactions (e.g. painting markup, quickly navigating through
+/// the board positions) cause many save points in rapid succession. To avoid
+/// writing the full NSCoding archive for every one of them,
+/// ApplicationStateManager saves the application state at most once within a
+/// short minimum interval. If a save point is committed before the interval
+/// has passed since the last save, ApplicationStateManager does not save
+/// immediately but schedules a single delayed save on the main thread for the
+/// end of the interval. Any further save points committed in the meantime are
+/// saved together by that delayed save. The delayed save is skipped if an
+/// agent holds an unfinished save point at that time, because the agent will
+/// trigger a save when it commits its save point.
+///
+/// Going to the background saves a pending change immediately as described in
+/// the next section, so coalescing never delays a save beyond the moment when
+/// the application is suspended. If the application crashes, changes made
+/// within the last interval may be lost.
+///
+///
 /// @par Application foreground and background
 ///
 /// The application delegate notifies ApplicationStateManager when the
@@ -139,6 +161,25 @@
 /// save points are lost.
 ///
 ///
+/// @par Delayed .sgf backup
+///
+/// Besides the NSCoding archive, the application state is also backed up to an
+/// .sgf file, which is used only as a fallback if the NSCoding archive cannot
+/// be restored (see restoreApplicationState()). Because the .sgf file is not
+/// needed as long as the NSCoding archive is intact, and the NSCoding archive
+/// becomes unusable only when the application is upgraded to a version with a
+/// different NSCoding version, writing the .sgf file is delayed until the
+/// application goes to the background. Agents that have changed the game
+/// invoke sgfBackupDidBecomeStale() (via BackupGameToSgfCommand) instead of
+/// rewriting the entire .sgf file after every change. When the application
+/// goes to the background, ApplicationStateManager writes the .sgf file once
+/// under the same conditions under which it saves a delayed application state
+/// change.
+/// If the game has not changed since it was last saved to the archive, the
+/// backup .sgf file is a copy of the archive file (see SaveSgfCommand), so
+/// going to the background does not serialize the game again.
+///
+///
 /// @par Application launch
 ///
 /// The application delegate notifies ApplicationStateManager when the
@@ -172,6 +213,7 @@
 - (void) saveApplicationState;
 - (void) restoreApplicationState;
 - (void) applicationStateDidChange;
+- (void) sgfBackupDidBecomeStale;
 - (void) applicationDidEnterBackground;
 - (void) applicationWillEnterForeground;
 
@@ -20,9 +20,13 @@
 #import "../command/CommandProcessor.h"
 #import "../command/applicationstate/RestoreApplicationStateCommand.h"
 #import "../command/applicationstate/SaveApplicationStateCommand.h"
+#import "../command/backup/BackupGameToSgfCommand.h"
 #import "../command/backup//RestoreGameFromSgfCommand.h"
 #import "../command/game/NewGameCommand.h"
 
+// Constants
+static const NSTimeInterval minimumIntervalBetweenApplicationStateSaves = 2.0;
+
 
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for ApplicationStateManager.
@@ -32,6 +36,12 @@
 @property(nonatomic, assign) int numberOfOutstandingCommits;
 /// @brief Is protected by @synchronized(self)
 @property(nonatomic, assign) bool applicationStateIsDirty;
+/// @brief Is protected by @synchronized(self)
+@property(nonatomic, assign) bool sgfBackupIsStale;
+/// @brief Is protected by @synchronized(self)
+@property(nonatomic, assign) CFAbsoluteTime lastApplicationStateSaveTime;
+/// @brief Is protected by @synchronized(self)
+@property(nonatomic, assign) bool delayedApplicationStateSaveIsScheduled;
 /// @brief Is created during initialization, so no need for atomic.
 @property(nonatomic, retain) NSLock* applicationStateSaveLock;
 /// @brief Does not need protection, is accessed only by methods that are
@@ -91,6 +101,9 @@ static ApplicationStateManager* sharedManager = nil;
     return nil;
   self.numberOfOutstandingCommits = 0;
   self.applicationStateIsDirty = false;
+  self.sgfBackupIsStale = false;
+  self.lastApplicationStateSaveTime = 0;
+  self.delayedApplicationStateSaveIsScheduled = false;
   self.applicationStateSaveLock = [[[NSLock alloc] init] autorelease];
   self.applicationStateSaveLockAcquiredForBackground = false;
   self.applicationStateRestoreInProgress = false;
@@ -127,7 +140,9 @@ static ApplicationStateManager* sharedManager = nil;
 /// invoked to balance a previous invocation of beginSavePoint.
 ///
 /// Invokes saveApplicationState if no other commitSavePoint messages are
-/// outstanding.
+/// outstanding, unless the application state was saved only a short while ago.
+/// In that case a delayed save is scheduled. See class documentation for
+/// details.
 ///
 /// See class documentation for details.
 ///
@@ -143,7 +158,70 @@ static ApplicationStateManager* sharedManager = nil;
     [self throwIfNumberOfOutstandingCommitsIsZero];
     self.numberOfOutstandingCommits--;
     if (0 == self.numberOfOutstandingCommits)
-      [self saveApplicationState];
+      [self saveApplicationStateOrScheduleDelayedSave];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for commitSavePoint(). Must be invoked while
+/// @synchronized(self) is held.
+///
+/// Invokes saveApplicationState if at least
+/// #minimumIntervalBetweenApplicationStateSaves seconds have passed since the
+/// application state was last saved. Otherwise schedules a delayed save for
+/// the time when the interval has passed, so that a burst of state changes
+/// results in only one more save.
+// -----------------------------------------------------------------------------
+- (void) saveApplicationStateOrScheduleDelayedSave
+{
+  if (! self.applicationStateIsDirty)
+    return;
+
+  NSTimeInterval timeSinceLastSave = CFAbsoluteTimeGetCurrent() - self.lastApplicationStateSaveTime;
+  if (timeSinceLastSave >= minimumIntervalBetweenApplicationStateSaves)
+  {
+    [self saveApplicationState];
+    return;
+  }
+
+  if (self.delayedApplicationStateSaveIsScheduled)
+    return;
+  self.delayedApplicationStateSaveIsScheduled = true;
+
+  // The delayed save is performed on the main thread because agents that use
+  // delayed state saving (e.g. ChangeBoardPositionCommand) modify the
+  // application state on the main thread without holding a save point
+  NSTimeInterval delay = minimumIntervalBetweenApplicationStateSaves - timeSinceLastSave;
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+    [self performDelayedApplicationStateSave];
+  });
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for saveApplicationStateOrScheduleDelayedSave().
+/// Is invoked on the main thread.
+// -----------------------------------------------------------------------------
+- (void) performDelayedApplicationStateSave
+{
+  @synchronized(self)
+  {
+    self.delayedApplicationStateSaveIsScheduled = false;
+
+    // An agent that holds a save point will save the application state when
+    // it invokes commitSavePoint
+    if (0 != self.numberOfOutstandingCommits)
+      return;
+
+    // If the lock cannot be acquired, applicationDidEnterBackground has
+    // acquired it. saveApplicationState would block the main thread, and with
+    // it applicationWillEnterForeground which is responsible for releasing the
+    // lock. The application state remains dirty and is saved with the next
+    // save point.
+    if (! [self.applicationStateSaveLock tryLock])
+      return;
+    [self.applicationStateSaveLock unlock];
+
+    [self saveApplicationState];
   }
 }
 
@@ -189,6 +267,7 @@ static ApplicationStateManager* sharedManager = nil;
     [self.applicationStateSaveLock unlock];
 
     self.applicationStateIsDirty = false;
+    self.lastApplicationStateSaveTime = CFAbsoluteTimeGetCurrent();
     [[[[SaveApplicationStateCommand alloc] init] autorelease] submit];
   }
 }
@@ -285,6 +364,23 @@ static ApplicationStateManager* sharedManager = nil;
   }
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Notifies this ApplicationStateManager that the .sgf backup file no
+/// longer matches the current game and needs to be rewritten when the
+/// application goes to the background the next time.
+///
+/// See class documentation for details.
+// -----------------------------------------------------------------------------
+- (void) sgfBackupDidBecomeStale
+{
+  if (self.applicationStateRestoreInProgress)
+    return;
+  @synchronized(self)
+  {
+    self.sgfBackupIsStale = true;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Notifies this ApplicationStateManager that the application has just
 /// entered the background and will be suspended soon after this method returns.
@@ -312,6 +408,14 @@ static ApplicationStateManager* sharedManager = nil;
         // now.
         [self saveApplicationState];
       }
+
+      if (self.sgfBackupIsStale)
+      {
+        BackupGameToSgfCommand* command = [[[BackupGameToSgfCommand alloc] init] autorelease];
+        command.writeImmediately = true;
+        [command submit];
+        self.sgfBackupIsStale = false;
+      }
     }
 
     // We need to make sure that saveApplicationState is not executed after we
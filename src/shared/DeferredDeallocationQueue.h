@@ -0,0 +1,71 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The DeferredDeallocationQueue class is a singleton that deallocates
+/// large object graphs, such as discarded game trees or entire GoGame objects,
+/// piece by piece on the main thread while the main thread is idle.
+///
+/// Releasing the last reference to a large object graph triggers a cascade of
+/// dealloc invocations that can take a noticeable amount of time (e.g. a game
+/// tree with thousands of nodes, or a GoBoard whose GoPoint objects must
+/// first break their retain cycles in GoPoint::prepareForDealloc()). If this
+/// happens in one go while the user is waiting, the application becomes
+/// unresponsive.
+///
+/// An agent that is about to give up its reference to such an object graph
+/// instead hands the objects of the graph over to DeferredDeallocationQueue by
+/// invoking releaseObjectsWhenIdle:(). DeferredDeallocationQueue retains every
+/// object individually, so giving up the agent's reference does not trigger a
+/// cascade. DeferredDeallocationQueue then releases the objects in the order
+/// in which they were handed over, each time the main run loop is about to
+/// wait for events, but only for #deferredDeallocationTimeSlice seconds per
+/// pass. As long as objects are pending, DeferredDeallocationQueue wakes up
+/// the main run loop after each pass so that the next pass follows as soon as
+/// there are no more events to process. Because every object is released
+/// individually, an object's dealloc cascades at most into objects that are
+/// also pending, which are merely released, not deallocated. The agent is
+/// responsible for handing over the objects in an order where an object comes
+/// before the objects that it retains, e.g. a game tree in depth-first
+/// pre-order.
+///
+/// Objects are always deallocated on the main thread, so their dealloc
+/// implementation may remove KVO and notification registrations and touch
+/// other objects of the model. If someone else still holds a reference to an
+/// object, nothing bad happens - the object is simply deallocated when that
+/// other reference goes away, as it would have been without
+/// DeferredDeallocationQueue. Agents that run on a secondary thread may
+/// still hand over objects; the handover is then forwarded to the main thread.
+///
+/// The run loop observer only runs in the default run loop mode. While the
+/// user is scrolling or tracking a gesture, no objects are released.
+// -----------------------------------------------------------------------------
+@interface DeferredDeallocationQueue : NSObject
+{
+}
+
++ (DeferredDeallocationQueue*) sharedQueue;
++ (void) releaseSharedQueue;
+
+- (void) releaseObjectsWhenIdle:(NSArray*)objects;
+- (void) releaseAllPendingObjects;
+
+/// @brief The number of objects that were handed over and that have not yet
+/// been released.
+@property(nonatomic, assign, readonly) NSUInteger numberOfPendingObjects;
+
+@end
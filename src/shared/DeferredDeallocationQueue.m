@@ -0,0 +1,232 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "DeferredDeallocationQueue.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// DeferredDeallocationQueue.
+// -----------------------------------------------------------------------------
+@interface DeferredDeallocationQueue()
+/// @brief The objects that were handed over by releaseObjectsWhenIdle:()
+/// and that have not yet been released, in the order in which they must be
+/// released.
+@property(nonatomic, retain) NSMutableArray* pendingObjects;
+/// @brief The run loop observer that releases pending objects. Is NULL while
+/// no objects are pending.
+@property(nonatomic, assign) CFRunLoopObserverRef runLoopObserver;
+@end
+
+
+@implementation DeferredDeallocationQueue
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of DeferredDeallocationQueue.
+// -----------------------------------------------------------------------------
+static DeferredDeallocationQueue* sharedQueue = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared DeferredDeallocationQueue object.
+///
+/// This method may be invoked in the context of any thread.
+// -----------------------------------------------------------------------------
++ (DeferredDeallocationQueue*) sharedQueue
+{
+  @synchronized(self)
+  {
+    if (! sharedQueue)
+      sharedQueue = [[DeferredDeallocationQueue alloc] init];
+    return sharedQueue;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared DeferredDeallocationQueue object. Objects that
+/// are still pending are released immediately.
+///
+/// This method must be invoked in the context of the main thread.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedQueue
+{
+  @synchronized(self)
+  {
+    if (sharedQueue)
+    {
+      [sharedQueue releaseAllPendingObjects];
+      [sharedQueue release];
+      sharedQueue = nil;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a DeferredDeallocationQueue object.
+///
+/// @note This is the designated initializer of DeferredDeallocationQueue.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+  self.pendingObjects = [NSMutableArray array];
+  self.runLoopObserver = NULL;
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this DeferredDeallocationQueue
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  // The run loop observer retains self, so it must already have been removed
+  assert(self.runLoopObserver == NULL);
+  self.pendingObjects = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Retains the objects in @a objects and releases them one by one,
+/// in the order in which they appear in @a objects, while the main thread is
+/// idle. Does nothing if @a objects is empty.
+///
+/// This method may be invoked in the context of any thread. If it is not
+/// invoked in the context of the main thread, the objects are handed over to
+/// the main thread asynchronously. @a objects keeps the objects alive until
+/// then, so the caller may give up its own references immediately.
+// -----------------------------------------------------------------------------
+- (void) releaseObjectsWhenIdle:(NSArray*)objects
+{
+  if (objects.count == 0)
+    return;
+
+  if (! [NSThread isMainThread])
+  {
+    dispatch_async(dispatch_get_main_queue(), ^{
+      [self releaseObjectsWhenIdle:objects];
+    });
+    return;
+  }
+
+  [self.pendingObjects addObjectsFromArray:objects];
+  if (self.runLoopObserver)
+    return;
+
+  // Run after Core Animation has committed the current transaction, so that
+  // releasing objects never delays the display of a frame
+  CFIndex order = 2000001;
+  // The observer block retains self until the observer is removed
+  self.runLoopObserver = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault,
+                                                            kCFRunLoopBeforeWaiting,
+                                                            true,
+                                                            order,
+                                                            ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity)
+  {
+    [self releasePendingObjectsForTimeSlice];
+  });
+  CFRunLoopAddObserver(CFRunLoopGetMain(), self.runLoopObserver, kCFRunLoopDefaultMode);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases all pending objects immediately.
+///
+/// This method must be invoked in the context of the main thread.
+// -----------------------------------------------------------------------------
+- (void) releaseAllPendingObjects
+{
+  while (self.pendingObjects.count > 0)
+  {
+    @autoreleasepool
+    {
+      [self releaseNextPendingObject];
+    }
+  }
+  [self removeRunLoopObserver];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSUInteger) numberOfPendingObjects
+{
+  return self.pendingObjects.count;
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked by the run loop observer each time the main run loop is
+/// about to wait for events. Releases pending objects until either no more
+/// objects are pending, or #deferredDeallocationTimeSlice seconds have
+/// elapsed.
+// -----------------------------------------------------------------------------
+- (void) releasePendingObjectsForTimeSlice
+{
+  CFAbsoluteTime endTime = CFAbsoluteTimeGetCurrent() + deferredDeallocationTimeSlice;
+  @autoreleasepool
+  {
+    while (self.pendingObjects.count > 0 && CFAbsoluteTimeGetCurrent() < endTime)
+      [self releaseNextPendingObject];
+  }
+
+  if (self.pendingObjects.count > 0)
+  {
+    // Without this the run loop would go to sleep and the next pass would not
+    // take place before the next event arrives
+    CFRunLoopWakeUp(CFRunLoopGetMain());
+  }
+  else
+  {
+    [self removeRunLoopObserver];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the pending object that is next in line.
+// -----------------------------------------------------------------------------
+- (void) releaseNextPendingObject
+{
+  // The object is removed from the array before it is released, so that its
+  // dealloc can safely hand over more objects. If we hold the last reference
+  // this deallocates the object. Objects that the object retains are either
+  // also pending, or small.
+  id object = [[self.pendingObjects objectAtIndex:0] retain];
+  [self.pendingObjects removeObjectAtIndex:0];
+  [object release];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the run loop observer, if there is one. This releases the
+/// reference that the observer block holds to self.
+// -----------------------------------------------------------------------------
+- (void) removeRunLoopObserver
+{
+  if (! self.runLoopObserver)
+    return;
+  CFRunLoopObserverRef runLoopObserver = self.runLoopObserver;
+  self.runLoopObserver = NULL;
+  CFRunLoopObserverInvalidate(runLoopObserver);
+  CFRelease(runLoopObserver);
+}
+
+@end
@@ -0,0 +1,73 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class GoNode;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The MarkupEditingTransaction class is a singleton that groups the
+/// markup changes made during a single user interaction (e.g. a pan gesture
+/// that moves markup around) into one transaction.
+///
+/// Without a transaction every individual markup change posts
+/// #nodeMarkupDataDidChange, creates a backup of the current game and causes
+/// a save point. A gesture that makes several changes therefore produces a
+/// burst of notifications, backups and save points, although only the final
+/// outcome of the gesture is interesting.
+///
+/// These are the mechanics:
+/// - The agent that handles the interaction invokes begin() before it makes
+///   the first change, and commit() after it has made the last change. Calls
+///   to begin() and commit() must be balanced. Transactions can be nested, the
+///   outermost commit() ends the transaction.
+/// - begin() also begins a save point with ApplicationStateManager, so that all
+///   save points that are created during the transaction are coalesced into
+///   the save point that commit() concludes.
+/// - While a transaction is in progress, #markupOnPointsDidChange is still
+///   posted for every change so that the board view can immediately redraw the
+///   affected intersections. #nodeMarkupDataDidChange and the game backup,
+///   however, are deferred: Agents invoke nodeMarkupDataDidChange:() and
+///   backupGameWhenCommitted() instead of posting the notification or
+///   submitting the backup command themselves.
+/// - commit() posts #nodeMarkupDataDidChange once for every node whose markup
+///   changed, submits a single BackupGameToSgfCommand if at least one change
+///   requested a backup, and then commits the save point.
+///
+/// If no transaction is in progress, nodeMarkupDataDidChange:() posts the
+/// notification immediately, and backupGameWhenCommitted() submits the backup
+/// command immediately. Agents therefore don't have to know whether they are
+/// executed as part of a transaction.
+///
+/// MarkupEditingTransaction must only be used from the main thread.
+// -----------------------------------------------------------------------------
+@interface MarkupEditingTransaction : NSObject
+{
+}
+
++ (MarkupEditingTransaction*) sharedTransaction;
++ (void) releaseSharedTransaction;
+
+- (void) begin;
+- (void) commit;
+- (void) nodeMarkupDataDidChange:(GoNode*)node;
+- (void) backupGameWhenCommitted;
+
+/// @brief Is true if a transaction is currently in progress.
+@property(nonatomic, assign, readonly) bool inProgress;
+
+@end
@@ -0,0 +1,212 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "MarkupEditingTransaction.h"
+#import "ApplicationStateManager.h"
+#import "../command/backup/BackupGameToSgfCommand.h"
+#import "../go/GoGame.h"
+#import "../go/GoNodeModel.h"
+#import "../go/GoNodeTextIndex.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// MarkupEditingTransaction.
+// -----------------------------------------------------------------------------
+@interface MarkupEditingTransaction()
+/// @brief The number of begin() messages that have not yet been balanced by a
+/// commit() message.
+@property(nonatomic, assign) int numberOfOutstandingCommits;
+/// @brief The nodes for which #nodeMarkupDataDidChange must be posted when the
+/// transaction is committed, in the order in which they changed.
+@property(nonatomic, retain) NSMutableArray* nodesWithChangedMarkupData;
+/// @brief Is true if a game backup must be made when the transaction is
+/// committed.
+@property(nonatomic, assign) bool backupIsRequired;
+@end
+
+
+@implementation MarkupEditingTransaction
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of MarkupEditingTransaction.
+// -----------------------------------------------------------------------------
+static MarkupEditingTransaction* sharedTransaction = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared MarkupEditingTransaction object.
+// -----------------------------------------------------------------------------
++ (MarkupEditingTransaction*) sharedTransaction
+{
+  @synchronized(self)
+  {
+    if (! sharedTransaction)
+      sharedTransaction = [[MarkupEditingTransaction alloc] init];
+    return sharedTransaction;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared MarkupEditingTransaction object.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedTransaction
+{
+  @synchronized(self)
+  {
+    if (sharedTransaction)
+    {
+      [sharedTransaction release];
+      sharedTransaction = nil;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a MarkupEditingTransaction object.
+///
+/// @note This is the designated initializer of MarkupEditingTransaction.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+  self.numberOfOutstandingCommits = 0;
+  self.nodesWithChangedMarkupData = [NSMutableArray array];
+  self.backupIsRequired = false;
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this MarkupEditingTransaction
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.nodesWithChangedMarkupData = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (bool) inProgress
+{
+  return (self.numberOfOutstandingCommits > 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Begins a transaction, or a nested transaction if a transaction is
+/// already in progress. Invocation of this method must be balanced by also
+/// invoking commit().
+// -----------------------------------------------------------------------------
+- (void) begin
+{
+  if (self.numberOfOutstandingCommits == 0)
+    [[ApplicationStateManager sharedManager] beginSavePoint];
+  self.numberOfOutstandingCommits++;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Concludes a transaction. This method must be invoked to balance a
+/// previous invocation of begin(). If no other commit() messages are
+/// outstanding, the deferred notifications are posted, the deferred backup is
+/// made and the save point is committed.
+///
+/// Raises an @e NSGenericException if this method is invoked without a previous
+/// invocation of begin().
+// -----------------------------------------------------------------------------
+- (void) commit
+{
+  if (self.numberOfOutstandingCommits == 0)
+  {
+    NSString* errorMessage = @"Unbalanced call to commit, number of outstanding commits is already 0";
+    DDLogError(@"%@: %@", self, errorMessage);
+    NSException* exception = [NSException exceptionWithName:NSGenericException
+                                                     reason:errorMessage
+                                                   userInfo:nil];
+    @throw exception;
+  }
+
+  self.numberOfOutstandingCommits--;
+  if (self.numberOfOutstandingCommits > 0)
+    return;
+
+  // Take ownership of the deferred data before acting on it, so that an
+  // observer of the notification can safely start a new transaction
+  NSArray* nodesWithChangedMarkupData = [[self.nodesWithChangedMarkupData copy] autorelease];
+  [self.nodesWithChangedMarkupData removeAllObjects];
+  bool backupIsRequired = self.backupIsRequired;
+  self.backupIsRequired = false;
+
+  @try
+  {
+    NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+    for (GoNode* node in nodesWithChangedMarkupData)
+      [center postNotificationName:nodeMarkupDataDidChange object:node];
+
+    if (backupIsRequired)
+      [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
+  }
+  @finally
+  {
+    [[ApplicationStateManager sharedManager] commitSavePoint];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Notifies MarkupEditingTransaction that the markup data of @a node has
+/// changed. Posts #nodeMarkupDataDidChange immediately if no transaction is
+/// in progress, otherwise defers the notification until the transaction is
+/// committed. The notification is posted only once per node and transaction.
+// -----------------------------------------------------------------------------
+- (void) nodeMarkupDataDidChange:(GoNode*)node
+{
+  // The jump target indexes and the full-text index must be up-to-date even
+  // while the notification is deferred
+  GoGame* game = [GoGame sharedGame];
+  [game.nodeModel updateJumpTargetsOfNode:node];
+  [game.nodeTextIndex updateNode:node];
+
+  if (! self.inProgress)
+  {
+    [[NSNotificationCenter defaultCenter] postNotificationName:nodeMarkupDataDidChange object:node];
+    return;
+  }
+
+  if ([self.nodesWithChangedMarkupData indexOfObjectIdenticalTo:node] == NSNotFound)
+    [self.nodesWithChangedMarkupData addObject:node];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Notifies MarkupEditingTransaction that the current game must be
+/// backed up because its markup data has changed. Submits a
+/// BackupGameToSgfCommand immediately if no transaction is in progress,
+/// otherwise defers the backup until the transaction is committed. Only one
+/// backup is made per transaction.
+// -----------------------------------------------------------------------------
+- (void) backupGameWhenCommitted
+{
+  if (! self.inProgress)
+    [[[[BackupGameToSgfCommand alloc] init] autorelease] submit];
+  else
+    self.backupIsRequired = true;
+}
+
+@end
@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+/// @brief Enumerates the priorities with which MemoryBudgetManager asks its
+/// clients to give up memory. Clients with a lower priority are asked first.
+enum MemoryBudgetEvictionPriority
+{
+  /// @brief The client holds memory that is cheap to recreate, e.g. reusable
+  /// views or thumbnails.
+  MemoryBudgetEvictionPriorityFirst,
+  /// @brief The client holds memory that requires a moderate amount of work to
+  /// recreate, e.g. drawing caches.
+  MemoryBudgetEvictionPriorityNormal,
+  /// @brief The client holds memory that is expensive to recreate, e.g. entire
+  /// games that would have to be loaded again.
+  MemoryBudgetEvictionPriorityLast,
+};
+
+
+// -----------------------------------------------------------------------------
+/// @brief The MemoryBudgetClient protocol must be implemented by objects that
+/// hold memory which they can give up when MemoryBudgetManager asks them to.
+// -----------------------------------------------------------------------------
+@protocol MemoryBudgetClient <NSObject>
+/// @brief Returns the number of bytes that the client currently uses and is
+/// able to give up. The number may be an estimate.
+- (unsigned long long) evictableMemoryUsage;
+/// @brief Asks the client to give up memory until its evictable memory usage
+/// is no more than @a numberOfBytes.
+- (void) reduceEvictableMemoryUsageTo:(unsigned long long)numberOfBytes;
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief The MemoryBudgetManager class enforces a memory budget for the
+/// entire application by asking caches to give up memory in a defined order.
+///
+/// Without MemoryBudgetManager each cache manages its memory on its own, and
+/// all caches are emptied at the same time when the system issues a memory
+/// warning. MemoryBudgetManager instead compares the application's memory
+/// footprint against @e memoryBudget at regular intervals (see
+/// #memoryBudgetCheckInterval). If the footprint exceeds the budget, the
+/// clients are asked to give up the excess, the clients with the lowest
+/// #MemoryBudgetEvictionPriority first. Clients that hold memory which is
+/// expensive to recreate are therefore asked only if giving up cheap memory is
+/// not sufficient.
+///
+/// If the footprint still exceeds the budget after all clients have given up
+/// their evictable memory, the culprit is most likely the GTP engine, whose
+/// search tree uses by far the most memory in the application.
+/// MemoryBudgetManager then halves the maximum amount of memory that the GTP
+/// engine is allowed to use for its search tree, but not below
+/// #fuegoMaxMemoryMinimum. This happens only once, because the GTP engine
+/// releases memory only when it starts its next search.
+///
+/// When the system issues a memory warning, all clients are asked to give up
+/// all of their evictable memory, and the GTP engine memory is halved.
+///
+/// The default memory budget is a fraction (see
+/// #memoryBudgetFractionOfMemoryLimit) of the amount of memory that the
+/// operating system allows the application to use on the current device.
+///
+/// MemoryBudgetManager does not retain its clients. A client must unregister
+/// before it is deallocated.
+///
+///
+/// @par MemoryBudgetManager life-cycle
+///
+/// MemoryBudgetManager is a singleton. Its shared instance is created when the
+/// manager is accessed for the first time, and deallocated when the
+/// application terminates. MemoryBudgetManager must be used from the main
+/// thread only.
+// -----------------------------------------------------------------------------
+@interface MemoryBudgetManager : NSObject
+{
+}
+
++ (MemoryBudgetManager*) sharedManager;
++ (void) releaseSharedManager;
+
+- (void) registerClient:(id<MemoryBudgetClient>)client withPriority:(enum MemoryBudgetEvictionPriority)priority;
+- (void) unregisterClient:(id<MemoryBudgetClient>)client;
+- (void) enforceMemoryBudget;
+
+/// @brief The number of bytes that the application's memory footprint should
+/// not exceed.
+@property(nonatomic, assign) unsigned long long memoryBudget;
+/// @brief The sum of the evictable memory usage of all clients.
+@property(nonatomic, assign, readonly) unsigned long long evictableMemoryUsage;
+
+@end
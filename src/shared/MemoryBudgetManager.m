@@ -0,0 +1,288 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "MemoryBudgetManager.h"
+#import "../gtp/GtpCommand.h"
+#import "../gtp/GtpResponse.h"
+#import "../main/ApplicationDelegate.h"
+#import "../player/GtpEngineProfile.h"
+#import "../player/GtpEngineProfileModel.h"
+#import "../utility/UIDeviceAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for MemoryBudgetManager.
+// -----------------------------------------------------------------------------
+@interface MemoryBudgetManager()
+/// @brief Contains one NSMutableArray for each #MemoryBudgetEvictionPriority,
+/// in ascending order of priority. The arrays contain NSValue objects that
+/// refer to the clients without retaining them.
+@property(nonatomic, retain) NSArray* clientsByPriority;
+@property(nonatomic, retain) NSTimer* checkTimer;
+/// @brief The maximum amount of memory in MB to which the GTP engine was last
+/// reduced. Is 0 if the GTP engine memory was never reduced.
+@property(nonatomic, assign) int reducedGtpEngineMaxMemory;
+@end
+
+
+@implementation MemoryBudgetManager
+
+#pragma mark - Handle shared object
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of MemoryBudgetManager.
+// -----------------------------------------------------------------------------
+static MemoryBudgetManager* sharedManager = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared MemoryBudgetManager object.
+// -----------------------------------------------------------------------------
++ (MemoryBudgetManager*) sharedManager
+{
+  if (! sharedManager)
+    sharedManager = [[MemoryBudgetManager alloc] init];
+  return sharedManager;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared MemoryBudgetManager object.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedManager
+{
+  if (sharedManager)
+  {
+    // The timer retains its target, so we must invalidate the timer before the
+    // manager can be deallocated
+    [sharedManager.checkTimer invalidate];
+    sharedManager.checkTimer = nil;
+    [sharedManager release];
+    sharedManager = nil;
+  }
+}
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a MemoryBudgetManager object.
+///
+/// @note This is the designated initializer of MemoryBudgetManager.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.memoryBudget = [UIDevice applicationMemoryLimit] * memoryBudgetFractionOfMemoryLimit;
+  self.clientsByPriority = @[[NSMutableArray array],
+                             [NSMutableArray array],
+                             [NSMutableArray array]];
+  self.reducedGtpEngineMaxMemory = 0;
+  self.checkTimer = [NSTimer scheduledTimerWithTimeInterval:memoryBudgetCheckInterval
+                                                     target:self
+                                                   selector:@selector(checkTimerDidFire:)
+                                                   userInfo:nil
+                                                    repeats:YES];
+  // The check is not time-critical, allow the system to coalesce the timer
+  // with other timers to save energy
+  self.checkTimer.tolerance = memoryBudgetCheckInterval / 2;
+
+  [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didReceiveMemoryWarning:) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+
+  DDLogInfo(@"%@: Memory budget is %llu bytes", self, self.memoryBudget);
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this MemoryBudgetManager object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [self.checkTimer invalidate];
+  self.checkTimer = nil;
+  self.clientsByPriority = nil;
+  [super dealloc];
+}
+
+#pragma mark - Client management
+
+// -----------------------------------------------------------------------------
+/// @brief Registers @a client so that it is asked to give up memory with
+/// priority @a priority. @a client is not retained.
+// -----------------------------------------------------------------------------
+- (void) registerClient:(id<MemoryBudgetClient>)client withPriority:(enum MemoryBudgetEvictionPriority)priority
+{
+  NSMutableArray* clients = self.clientsByPriority[priority];
+  [clients addObject:[NSValue valueWithNonretainedObject:client]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Unregisters @a client. Does nothing if @a client is not registered.
+// -----------------------------------------------------------------------------
+- (void) unregisterClient:(id<MemoryBudgetClient>)client
+{
+  NSValue* clientValue = [NSValue valueWithNonretainedObject:client];
+  for (NSMutableArray* clients in self.clientsByPriority)
+    [clients removeObject:clientValue];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (unsigned long long) evictableMemoryUsage
+{
+  unsigned long long evictableMemoryUsage = 0;
+  for (NSArray* clients in self.clientsByPriority)
+  {
+    for (NSValue* clientValue in clients)
+    {
+      id<MemoryBudgetClient> client = clientValue.nonretainedObjectValue;
+      evictableMemoryUsage += [client evictableMemoryUsage];
+    }
+  }
+  return evictableMemoryUsage;
+}
+
+#pragma mark - Budget enforcement
+
+// -----------------------------------------------------------------------------
+/// @brief Compares the application's memory footprint against
+/// @e memoryBudget. If the footprint exceeds the budget, asks the clients to
+/// give up the excess. If this is not sufficient, reduces the GTP engine
+/// memory.
+///
+/// This method is invoked periodically, but clients may also invoke it, e.g.
+/// after they have allocated a large amount of memory.
+// -----------------------------------------------------------------------------
+- (void) enforceMemoryBudget
+{
+  unsigned long long memoryFootprint = [UIDevice applicationMemoryFootprint];
+  if (memoryFootprint <= self.memoryBudget)
+    return;
+
+  unsigned long long numberOfBytesToEvict = memoryFootprint - self.memoryBudget;
+  DDLogInfo(@"%@: Memory footprint %llu exceeds memory budget by %llu bytes", self, memoryFootprint, numberOfBytesToEvict);
+
+  unsigned long long numberOfBytesNotEvicted = [self evictNumberOfBytes:numberOfBytesToEvict];
+  if (numberOfBytesNotEvicted > 0 && self.reducedGtpEngineMaxMemory == 0)
+    [self reduceGtpEngineMaxMemory];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Asks the clients to give up a total of @a numberOfBytes, the clients
+/// with the lowest priority first. Returns the number of bytes that the
+/// clients were unable to give up.
+// -----------------------------------------------------------------------------
+- (unsigned long long) evictNumberOfBytes:(unsigned long long)numberOfBytes
+{
+  for (NSArray* clients in self.clientsByPriority)
+  {
+    // Make a copy in case a client unregisters while it gives up memory
+    for (NSValue* clientValue in [[clients copy] autorelease])
+    {
+      if (numberOfBytes == 0)
+        return 0;
+
+      id<MemoryBudgetClient> client = clientValue.nonretainedObjectValue;
+      unsigned long long evictableMemoryUsageBefore = [client evictableMemoryUsage];
+      if (evictableMemoryUsageBefore == 0)
+        continue;
+
+      unsigned long long numberOfBytesToEvict = MIN(numberOfBytes, evictableMemoryUsageBefore);
+      [client reduceEvictableMemoryUsageTo:evictableMemoryUsageBefore - numberOfBytesToEvict];
+
+      unsigned long long evictableMemoryUsageAfter = [client evictableMemoryUsage];
+      if (evictableMemoryUsageAfter >= evictableMemoryUsageBefore)
+        continue;
+      unsigned long long numberOfBytesEvicted = evictableMemoryUsageBefore - evictableMemoryUsageAfter;
+      numberOfBytes -= MIN(numberOfBytes, numberOfBytesEvicted);
+    }
+  }
+
+  return numberOfBytes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Halves the maximum amount of memory that the GTP engine is allowed
+/// to use for its search tree, but not below #fuegoMaxMemoryMinimum.
+///
+/// The GTP engine profile is not modified, so the next time that the profile
+/// is applied the GTP engine is again configured with the maximum amount of
+/// memory stored in the profile.
+// -----------------------------------------------------------------------------
+- (void) reduceGtpEngineMaxMemory
+{
+  GtpEngineProfile* profile = [ApplicationDelegate sharedDelegate].gtpEngineProfileModel.activeProfile;
+  if (! profile)
+    return;
+
+  int currentMaxMemory = [profile effectiveFuegoMaxMemory];
+  if (self.reducedGtpEngineMaxMemory > 0)
+    currentMaxMemory = MIN(currentMaxMemory, self.reducedGtpEngineMaxMemory);
+  int reducedMaxMemory = MAX(currentMaxMemory / 2, fuegoMaxMemoryMinimum);
+  if (reducedMaxMemory >= currentMaxMemory)
+    return;
+
+  DDLogWarn(@"%@: Reducing GTP engine max. memory from %d to %d MB", self, currentMaxMemory, reducedMaxMemory);
+  self.reducedGtpEngineMaxMemory = reducedMaxMemory;
+
+  long long reducedMaxMemoryInBytes = reducedMaxMemory * 1000000LL;
+  NSString* commandString = [NSString stringWithFormat:@"uct_max_memory %lld", reducedMaxMemoryInBytes];
+  GtpCommand* command = [GtpCommand asynchronousCommand:commandString
+                                        completionQueue:dispatch_get_main_queue()
+                                      completionHandler:^(GtpResponse* response)
+  {
+    if (! response.status)
+      DDLogError(@"%@: Failed to reduce GTP engine max. memory: %@", self, response.rawResponse);
+  }];
+  [command submit];
+}
+
+#pragma mark - Notification and timer handlers
+
+// -----------------------------------------------------------------------------
+/// @brief Is invoked periodically by @e checkTimer.
+// -----------------------------------------------------------------------------
+- (void) checkTimerDidFire:(NSTimer*)timer
+{
+  [self enforceMemoryBudget];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to the #UIApplicationDidReceiveMemoryWarningNotification
+/// notification. Asks all clients to give up all of their evictable memory,
+/// and reduces the GTP engine memory.
+// -----------------------------------------------------------------------------
+- (void) didReceiveMemoryWarning:(NSNotification*)notification
+{
+  for (NSArray* clients in self.clientsByPriority)
+  {
+    for (NSValue* clientValue in [[clients copy] autorelease])
+    {
+      id<MemoryBudgetClient> client = clientValue.nonretainedObjectValue;
+      [client reduceEvictableMemoryUsageTo:0];
+    }
+  }
+
+  [self reduceGtpEngineMaxMemory];
+}
+
+@end
@@ -0,0 +1,97 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Forward declarations
+@class ModelChangeObserver;
+@class ModelChangeSet;
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ModelChangeObserverDelegate protocol must be implemented by the
+/// delegate of ModelChangeObserver.
+// -----------------------------------------------------------------------------
+@protocol ModelChangeObserverDelegate <NSObject>
+/// @brief Is invoked on the main thread once per run loop cycle in which at
+/// least one of the properties observed by @a observer changed. @a changeSet
+/// contains each changed property exactly once, regardless of how many times
+/// the property changed during the run loop cycle.
+- (void) modelChangeObserver:(ModelChangeObserver*)observer didObserveChanges:(ModelChangeSet*)changeSet;
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ModelChangeSet class represents the coalesced set of property
+/// changes that ModelChangeObserver delivers to its delegate.
+// -----------------------------------------------------------------------------
+@interface ModelChangeSet : NSObject
+{
+}
+
+- (bool) containsChangeOfKeyPath:(NSString*)keyPath ofObject:(id)object;
+- (bool) containsChangeOfObject:(id)object;
+
+/// @brief The number of distinct properties that changed.
+@property(nonatomic, assign, readonly) NSUInteger count;
+
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ModelChangeObserver class observes properties of model objects
+/// and delivers the changes to its delegate in batches, once per run loop
+/// cycle, instead of one callback per property change.
+///
+/// ModelChangeObserver uses KVO internally. Clients that observe model objects
+/// directly with KVO receive a synchronous callback for each property change.
+/// A compound operation that changes several properties, or the same property
+/// several times, therefore causes the client to perform redundant work such
+/// as laying out or drawing the same view several times. A client that uses
+/// ModelChangeObserver instead receives a single callback with a ModelChangeSet
+/// that contains every changed property exactly once, and can perform its work
+/// once for all changes.
+///
+/// The changes are delivered before the current run loop cycle ends, i.e.
+/// before Core Animation commits the changes made to the view hierarchy during
+/// the cycle. Views that update in response to the changes are therefore
+/// redrawn in the same frame as if they had responded synchronously.
+///
+/// Properties may change on any thread, the changes are always delivered on the
+/// main thread. A client that needs the changes collected so far before the
+/// end of the run loop cycle can invoke deliverPendingChanges().
+///
+/// ModelChangeObserver retains the observed objects until stopObserving() is
+/// invoked, so that the observed objects cannot be deallocated while they are
+/// still being observed. The client must invoke stopObserving() before it
+/// releases the ModelChangeObserver. The delegate is not retained.
+///
+/// Long-running actions (see LongRunningActionCounter) are not taken into
+/// account, clients continue to delay their expensive updates themselves.
+// -----------------------------------------------------------------------------
+@interface ModelChangeObserver : NSObject
+{
+}
+
+- (id) initWithDelegate:(id<ModelChangeObserverDelegate>)delegate;
+
+- (void) observeKeyPath:(NSString*)keyPath ofObject:(id)object;
+- (void) stopObserving;
+- (void) deliverPendingChanges;
+
+/// @brief The delegate that receives the changes. Is not retained.
+@property(nonatomic, assign) id<ModelChangeObserverDelegate> delegate;
+
+@end
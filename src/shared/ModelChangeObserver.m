@@ -0,0 +1,251 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ModelChangeObserver.h"
+
+
+/// @brief The KVO context that ModelChangeObserver uses to distinguish its own
+/// observations from observations made by a superclass.
+static void* modelChangeObserverContext = &modelChangeObserverContext;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for ModelChangeSet.
+// -----------------------------------------------------------------------------
+@interface ModelChangeSet()
+/// @brief Contains an NSArray object for each change. The first element of the
+/// array is the object whose property changed, the second element is the key
+/// path of the property.
+@property(nonatomic, retain) NSArray* changes;
+@end
+
+
+@implementation ModelChangeSet
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a ModelChangeSet object with @a changes.
+///
+/// @note This is the designated initializer of ModelChangeSet.
+// -----------------------------------------------------------------------------
+- (id) initWithChanges:(NSArray*)changes
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.changes = changes;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ModelChangeSet object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.changes = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if the property with key path @a keyPath of @a object
+/// changed. Returns false if not.
+// -----------------------------------------------------------------------------
+- (bool) containsChangeOfKeyPath:(NSString*)keyPath ofObject:(id)object
+{
+  for (NSArray* change in self.changes)
+  {
+    if (change[0] == object && [change[1] isEqualToString:keyPath])
+      return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns true if at least one observed property of @a object changed.
+/// Returns false if not.
+// -----------------------------------------------------------------------------
+- (bool) containsChangeOfObject:(id)object
+{
+  for (NSArray* change in self.changes)
+  {
+    if (change[0] == object)
+      return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (NSUInteger) count
+{
+  return self.changes.count;
+}
+
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for ModelChangeObserver.
+// -----------------------------------------------------------------------------
+@interface ModelChangeObserver()
+/// @brief Contains an NSArray object for each observation. The first element
+/// of the array is the observed object, the second element is the key path.
+@property(nonatomic, retain) NSMutableArray* observations;
+/// @brief Contains the changes that have not yet been delivered, in the same
+/// format as ModelChangeSet. Must only be accessed while holding a lock on
+/// @e pendingChanges.
+@property(nonatomic, retain) NSMutableArray* pendingChanges;
+/// @brief True if a delivery of @e pendingChanges is scheduled on the main
+/// run loop. Must only be accessed while holding a lock on @e pendingChanges.
+@property(nonatomic, assign) bool deliveryIsScheduled;
+@end
+
+
+@implementation ModelChangeObserver
+
+#pragma mark - Initialization and deallocation
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a ModelChangeObserver object that delivers changes to
+/// @a delegate.
+///
+/// @note This is the designated initializer of ModelChangeObserver.
+// -----------------------------------------------------------------------------
+- (id) initWithDelegate:(id<ModelChangeObserverDelegate>)delegate
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+
+  self.delegate = delegate;
+  self.observations = [NSMutableArray array];
+  self.pendingChanges = [NSMutableArray array];
+  self.deliveryIsScheduled = false;
+
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ModelChangeObserver object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  [self stopObserving];
+  self.delegate = nil;
+  self.observations = nil;
+  self.pendingChanges = nil;
+  [super dealloc];
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Starts observing the property with key path @a keyPath of
+/// @a object. @a object is retained until stopObserving() is invoked.
+// -----------------------------------------------------------------------------
+- (void) observeKeyPath:(NSString*)keyPath ofObject:(id)object
+{
+  [self.observations addObject:@[object, keyPath]];
+  [object addObserver:self forKeyPath:keyPath options:0 context:modelChangeObserverContext];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Stops observing all properties and discards the changes that have
+/// not yet been delivered.
+// -----------------------------------------------------------------------------
+- (void) stopObserving
+{
+  for (NSArray* observation in self.observations)
+    [observation[0] removeObserver:self forKeyPath:observation[1] context:modelChangeObserverContext];
+  [self.observations removeAllObjects];
+
+  @synchronized(self.pendingChanges)
+  {
+    [self.pendingChanges removeAllObjects];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Delivers the changes that were collected so far to the delegate,
+/// without waiting for the end of the current run loop cycle. Does nothing if
+/// no changes were collected.
+///
+/// This method must be invoked on the main thread.
+// -----------------------------------------------------------------------------
+- (void) deliverPendingChanges
+{
+  NSArray* changes;
+  @synchronized(self.pendingChanges)
+  {
+    self.deliveryIsScheduled = false;
+    if (self.pendingChanges.count == 0)
+      return;
+    changes = [NSArray arrayWithArray:self.pendingChanges];
+    [self.pendingChanges removeAllObjects];
+  }
+
+  if (! self.delegate)
+    return;
+
+  ModelChangeSet* changeSet = [[[ModelChangeSet alloc] initWithChanges:changes] autorelease];
+  [self.delegate modelChangeObserver:self didObserveChanges:changeSet];
+}
+
+#pragma mark - Key-Value Observing
+
+// -----------------------------------------------------------------------------
+/// @brief Responds to KVO notifications. Records the change and schedules its
+/// delivery on the main run loop.
+// -----------------------------------------------------------------------------
+- (void) observeValueForKeyPath:(NSString*)keyPath ofObject:(id)object change:(NSDictionary*)change context:(void*)context
+{
+  if (context != modelChangeObserverContext)
+  {
+    [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+    return;
+  }
+
+  @synchronized(self.pendingChanges)
+  {
+    for (NSArray* pendingChange in self.pendingChanges)
+    {
+      if (pendingChange[0] == object && [pendingChange[1] isEqualToString:keyPath])
+        return;
+    }
+    [self.pendingChanges addObject:@[object, keyPath]];
+
+    if (self.deliveryIsScheduled)
+      return;
+    self.deliveryIsScheduled = true;
+  }
+
+  // The block retains self, so this ModelChangeObserver lives at least until
+  // the delivery. The common modes make sure that the delivery also takes
+  // place while the user is scrolling or zooming.
+  CFRunLoopRef mainRunLoop = CFRunLoopGetMain();
+  CFRunLoopPerformBlock(mainRunLoop, kCFRunLoopCommonModes, ^{
+    [self deliverPendingChanges];
+  });
+  CFRunLoopWakeUp(mainRunLoop);
+}
+
+@end
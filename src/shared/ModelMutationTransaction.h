@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ModelMutationTransaction class is a singleton that groups the
+/// changes that an agent makes to GoGame and its associated object cluster
+/// into one transaction, so that observers are notified only once about the
+/// combined outcome.
+///
+/// LongRunningActionCounter already allows views to delay expensive UI updates
+/// until a long-running action ends. The Go model, however, still posts its
+/// fine-grained notifications while the action is in progress, which means
+/// that observers must still process every intermediate change (e.g. the node
+/// tree view canvas must incorporate every single tree change, the board view
+/// must collect every single set of changed points). ModelMutationTransaction
+/// closes this gap.
+///
+/// These are the mechanics:
+/// - The agent that mutates the model invokes begin() before it makes the
+///   first change, and commit() after it has made the last change. Calls to
+///   begin() and commit() must be balanced. Transactions can be nested, the
+///   outermost commit() ends the transaction.
+/// - The outermost begin() begins a save point with ApplicationStateManager
+///   and increments the LongRunningActionCounter. A transaction therefore is
+///   also a long-running action, and all save points that are created during
+///   the transaction are coalesced into the save point that commit()
+///   concludes.
+/// - The Go model and the agents post model notifications via
+///   postNotificationName:object:userInfo:() instead of posting them directly
+///   to the default NSNotificationCenter. While a transaction is in progress
+///   the notifications are collected and merged, see below.
+/// - Agents that would invoke applicationStateDidChange() on
+///   ApplicationStateManager invoke applicationStateDidChange() on
+///   ModelMutationTransaction instead. The dirty flag is forwarded to
+///   ApplicationStateManager only once, when the transaction is committed.
+/// - The outermost commit() first posts the merged notifications, then marks
+///   the application state as changed if required, commits the save point and
+///   finally decrements the LongRunningActionCounter. Because the merged
+///   notifications are posted while the long-running action is still in
+///   progress, observers that delay their work until the long-running action
+///   ends (e.g. the node tree view canvas recalculation) still do so only once.
+///
+/// If no transaction is in progress, all messages take effect immediately.
+/// Agents therefore don't have to know whether they are executed as part of a
+/// transaction.
+///
+///
+/// @par Merging notifications
+///
+/// Notifications are posted in the order in which they were first posted
+/// during the transaction. A notification that is posted several times is
+/// posted only once, with its associated data merged:
+/// - #goNodeTreeLayoutDidChange: The arrays with GoNodeTreeChange objects are
+///   concatenated. If one of the notifications has no array associated, the
+///   merged notification also has none, i.e. observers must assume that the
+///   entire tree of nodes has changed.
+/// - #numberOfBoardPositionsDidChange and #currentBoardPositionDidChange: The
+///   merged notification carries the old value of the first notification and
+///   the new value of the last notification. #numberOfBoardPositionsDidChange
+///   is dropped if the number of board positions has not changed in the end.
+///   The changed points of #currentBoardPositionDidChange are combined. If one
+///   of the notifications has no changed points associated, the merged
+///   notification also has none.
+/// - All other notifications: Notifications with the same name and the same
+///   associated object are posted only once. Their user info dictionaries are
+///   not merged, the first one wins.
+///
+///
+/// @par Multi-threading
+///
+/// ModelMutationTransaction is thread-safe. The merged notifications are posted
+/// in the context of the thread that invokes the outermost commit(), which is
+/// the same thread that would have posted them without a transaction.
+// -----------------------------------------------------------------------------
+@interface ModelMutationTransaction : NSObject
+{
+}
+
++ (ModelMutationTransaction*) sharedTransaction;
++ (void) releaseSharedTransaction;
+
+- (void) begin;
+- (void) commit;
+- (void) postNotificationName:(NSString*)notificationName object:(id)object;
+- (void) postNotificationName:(NSString*)notificationName object:(id)object userInfo:(NSDictionary*)userInfo;
+- (void) applicationStateDidChange;
+
+/// @brief Is true if a transaction is currently in progress.
+@property(atomic, assign, readonly) bool inProgress;
+
+@end
@@ -0,0 +1,359 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "ModelMutationTransaction.h"
+#import "ApplicationStateManager.h"
+#import "LongRunningActionCounter.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The ModelMutationTransactionNotification class is a private helper
+/// of ModelMutationTransaction that stores the data of a notification whose
+/// posting has been deferred until the transaction is committed.
+// -----------------------------------------------------------------------------
+@interface ModelMutationTransactionNotification : NSObject
+{
+}
+
+@property(nonatomic, retain) NSString* name;
+@property(nonatomic, retain) id object;
+@property(nonatomic, retain) NSDictionary* userInfo;
+@end
+
+
+@implementation ModelMutationTransactionNotification
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this
+/// ModelMutationTransactionNotification object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.name = nil;
+  self.object = nil;
+  self.userInfo = nil;
+  [super dealloc];
+}
+
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for
+/// ModelMutationTransaction.
+// -----------------------------------------------------------------------------
+@interface ModelMutationTransaction()
+/// @brief The number of begin() messages that have not yet been balanced by a
+/// commit() message.
+@property(atomic, assign) int numberOfOutstandingCommits;
+/// @brief The ModelMutationTransactionNotification objects that must be posted
+/// when the transaction is committed, in the order in which they were first
+/// posted.
+@property(nonatomic, retain) NSMutableArray* pendingNotifications;
+/// @brief Is true if ApplicationStateManager must be notified about an
+/// application state change when the transaction is committed.
+@property(nonatomic, assign) bool applicationStateDidChangeIsRequired;
+@end
+
+
+@implementation ModelMutationTransaction
+
+// -----------------------------------------------------------------------------
+/// @brief Shared instance of ModelMutationTransaction.
+// -----------------------------------------------------------------------------
+static ModelMutationTransaction* sharedTransaction = nil;
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the shared ModelMutationTransaction object.
+// -----------------------------------------------------------------------------
++ (ModelMutationTransaction*) sharedTransaction
+{
+  @synchronized(self)
+  {
+    if (! sharedTransaction)
+      sharedTransaction = [[ModelMutationTransaction alloc] init];
+    return sharedTransaction;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Releases the shared ModelMutationTransaction object.
+// -----------------------------------------------------------------------------
++ (void) releaseSharedTransaction
+{
+  @synchronized(self)
+  {
+    if (sharedTransaction)
+    {
+      [sharedTransaction release];
+      sharedTransaction = nil;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a ModelMutationTransaction object.
+///
+/// @note This is the designated initializer of ModelMutationTransaction.
+// -----------------------------------------------------------------------------
+- (id) init
+{
+  // Call designated initializer of superclass (NSObject)
+  self = [super init];
+  if (! self)
+    return nil;
+  self.numberOfOutstandingCommits = 0;
+  self.pendingNotifications = [NSMutableArray array];
+  self.applicationStateDidChangeIsRequired = false;
+  return self;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this ModelMutationTransaction
+/// object.
+// -----------------------------------------------------------------------------
+- (void) dealloc
+{
+  self.pendingNotifications = nil;
+  [super dealloc];
+}
+
+// -----------------------------------------------------------------------------
+// Property is documented in the header file.
+// -----------------------------------------------------------------------------
+- (bool) inProgress
+{
+  return (self.numberOfOutstandingCommits > 0);
+}
+
+#pragma mark - Public API
+
+// -----------------------------------------------------------------------------
+/// @brief Begins a transaction, or a nested transaction if a transaction is
+/// already in progress. Invocation of this method must be balanced by also
+/// invoking commit().
+// -----------------------------------------------------------------------------
+- (void) begin
+{
+  bool isOutermostTransaction;
+  @synchronized(self)
+  {
+    isOutermostTransaction = (self.numberOfOutstandingCommits == 0);
+    self.numberOfOutstandingCommits++;
+  }
+
+  if (isOutermostTransaction)
+  {
+    [[ApplicationStateManager sharedManager] beginSavePoint];
+    [[LongRunningActionCounter sharedCounter] increment];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Concludes a transaction. This method must be invoked to balance a
+/// previous invocation of begin(). If no other commit() messages are
+/// outstanding, the merged notifications are posted, the save point is
+/// committed and the long-running action ends.
+///
+/// Raises an @e NSGenericException if this method is invoked without a previous
+/// invocation of begin().
+// -----------------------------------------------------------------------------
+- (void) commit
+{
+  NSArray* pendingNotifications;
+  bool applicationStateDidChangeIsRequired;
+
+  @synchronized(self)
+  {
+    if (self.numberOfOutstandingCommits == 0)
+    {
+      NSString* errorMessage = @"Unbalanced call to commit, number of outstanding commits is already 0";
+      DDLogError(@"%@: %@", self, errorMessage);
+      NSException* exception = [NSException exceptionWithName:NSGenericException
+                                                       reason:errorMessage
+                                                     userInfo:nil];
+      @throw exception;
+    }
+
+    if (self.numberOfOutstandingCommits > 1)
+    {
+      self.numberOfOutstandingCommits--;
+      return;
+    }
+
+    // Take ownership of the deferred data before acting on it. The counter is
+    // decremented only after the notifications have been posted, so that
+    // model changes made by observers are still part of the transaction.
+    pendingNotifications = [[self.pendingNotifications copy] autorelease];
+    [self.pendingNotifications removeAllObjects];
+    applicationStateDidChangeIsRequired = self.applicationStateDidChangeIsRequired;
+    self.applicationStateDidChangeIsRequired = false;
+  }
+
+  @try
+  {
+    NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+    for (ModelMutationTransactionNotification* notification in pendingNotifications)
+      [center postNotificationName:notification.name object:notification.object userInfo:notification.userInfo];
+  }
+  @finally
+  {
+    @synchronized(self)
+    {
+      // Notifications that observers posted while we were posting the merged
+      // notifications are not lost, they are simply posted immediately
+      pendingNotifications = [[self.pendingNotifications copy] autorelease];
+      [self.pendingNotifications removeAllObjects];
+      applicationStateDidChangeIsRequired = applicationStateDidChangeIsRequired || self.applicationStateDidChangeIsRequired;
+      self.applicationStateDidChangeIsRequired = false;
+      self.numberOfOutstandingCommits--;
+    }
+
+    NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+    for (ModelMutationTransactionNotification* notification in pendingNotifications)
+      [center postNotificationName:notification.name object:notification.object userInfo:notification.userInfo];
+
+    if (applicationStateDidChangeIsRequired)
+      [[ApplicationStateManager sharedManager] applicationStateDidChange];
+    [[ApplicationStateManager sharedManager] commitSavePoint];
+    [[LongRunningActionCounter sharedCounter] decrement];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Posts the notification @a notificationName with the associated
+/// object @a object. See postNotificationName:object:userInfo:() for details.
+// -----------------------------------------------------------------------------
+- (void) postNotificationName:(NSString*)notificationName object:(id)object
+{
+  [self postNotificationName:notificationName object:object userInfo:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Posts the notification @a notificationName with the associated
+/// object @a object and the user info dictionary @a userInfo to the default
+/// NSNotificationCenter. Posts the notification immediately if no transaction
+/// is in progress, otherwise merges the notification into the notifications
+/// that are posted when the transaction is committed.
+// -----------------------------------------------------------------------------
+- (void) postNotificationName:(NSString*)notificationName object:(id)object userInfo:(NSDictionary*)userInfo
+{
+  @synchronized(self)
+  {
+    if (self.inProgress)
+    {
+      [self mergeNotificationName:notificationName object:object userInfo:userInfo];
+      return;
+    }
+  }
+
+  [[NSNotificationCenter defaultCenter] postNotificationName:notificationName object:object userInfo:userInfo];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Notifies ApplicationStateManager that the application state has
+/// changed. Forwards the message immediately if no transaction is in progress,
+/// otherwise defers it until the transaction is committed. The message is
+/// forwarded only once per transaction.
+// -----------------------------------------------------------------------------
+- (void) applicationStateDidChange
+{
+  @synchronized(self)
+  {
+    if (self.inProgress)
+    {
+      self.applicationStateDidChangeIsRequired = true;
+      return;
+    }
+  }
+
+  [[ApplicationStateManager sharedManager] applicationStateDidChange];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for postNotificationName:object:userInfo:(). Merges
+/// the notification into the list of pending notifications. See the class
+/// documentation for the merge rules.
+///
+/// Must be invoked while holding the lock on the receiver.
+// -----------------------------------------------------------------------------
+- (void) mergeNotificationName:(NSString*)notificationName object:(id)object userInfo:(NSDictionary*)userInfo
+{
+  bool mergesByName = ([notificationName isEqualToString:goNodeTreeLayoutDidChange] ||
+                       [notificationName isEqualToString:numberOfBoardPositionsDidChange] ||
+                       [notificationName isEqualToString:currentBoardPositionDidChange]);
+
+  ModelMutationTransactionNotification* pendingNotification = nil;
+  for (ModelMutationTransactionNotification* notification in self.pendingNotifications)
+  {
+    if (! [notification.name isEqualToString:notificationName])
+      continue;
+    if (mergesByName || notification.object == object)
+    {
+      pendingNotification = notification;
+      break;
+    }
+  }
+
+  if (! pendingNotification)
+  {
+    pendingNotification = [[[ModelMutationTransactionNotification alloc] init] autorelease];
+    pendingNotification.name = notificationName;
+    pendingNotification.object = object;
+    pendingNotification.userInfo = userInfo;
+    [self.pendingNotifications addObject:pendingNotification];
+    return;
+  }
+
+  if ([notificationName isEqualToString:goNodeTreeLayoutDidChange])
+  {
+    NSArray* treeChanges = pendingNotification.object;
+    if (treeChanges && object)
+      pendingNotification.object = [treeChanges arrayByAddingObjectsFromArray:object];
+    else
+      pendingNotification.object = nil;
+  }
+  else if ([notificationName isEqualToString:numberOfBoardPositionsDidChange])
+  {
+    NSArray* oldAndNewValues = @[pendingNotification.object[0], object[1]];
+    pendingNotification.object = oldAndNewValues;
+    if ([oldAndNewValues[0] isEqualToNumber:oldAndNewValues[1]])
+      [self.pendingNotifications removeObjectIdenticalTo:pendingNotification];
+  }
+  else if ([notificationName isEqualToString:currentBoardPositionDidChange])
+  {
+    pendingNotification.object = @[pendingNotification.object[0], object[1]];
+
+    NSArray* changedPoints = pendingNotification.userInfo[changedPointsKey];
+    NSArray* additionalChangedPoints = userInfo[changedPointsKey];
+    if (changedPoints && additionalChangedPoints)
+    {
+      NSMutableOrderedSet* mergedChangedPoints = [NSMutableOrderedSet orderedSetWithArray:changedPoints];
+      [mergedChangedPoints addObjectsFromArray:additionalChangedPoints];
+      pendingNotification.userInfo = @{changedPointsKey: mergedChangedPoints.array};
+    }
+    else
+    {
+      pendingNotification.userInfo = nil;
+    }
+  }
+}
+
+@end
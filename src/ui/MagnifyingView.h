@@ -16,13 +16,19 @@
 
 
 // -----------------------------------------------------------------------------
-/// @brief The MagnifyingView class draws a provided UIImage so that it appears
+/// @brief The MagnifyingView class displays a provided view so that it appears
 /// as if inside a circular loupe.
 ///
-/// The circular loupe effect is achieved simply by clipping the provided image
-/// to a circular path whose diameter is equal to the size of the
-/// MagnifyingView. If MagnifyingView is rectangular, the lesser dimension of
-/// the rectangle is used as the diameter.
+/// The provided view is scaled so that it fills MagnifyingView. The circular
+/// loupe effect is achieved simply by clipping the provided view to a circle
+/// whose diameter is equal to the size of the MagnifyingView. If
+/// MagnifyingView is rectangular, the lesser dimension of the rectangle is
+/// used as the diameter.
+///
+/// The provided view typically is a snapshot view whose content is supplied
+/// by the render server (see UIView::resizableSnapshotViewFromRect...()).
+/// MagnifyingView therefore does not redraw anything when the provided view
+/// changes. The decorations described below are drawn only once.
 ///
 /// MagnifyingView also has several optional features to make the loupe look
 /// great:
@@ -73,7 +79,7 @@
 {
 }
 
-@property(nonatomic, retain) UIImage* magnifiedImage;
+@property(nonatomic, retain) UIView* magnifiedContentView;
 
 @property(nonatomic, assign) bool gradientEnabled;
 @property(nonatomic, retain) UIColor* gradientOuterColor;
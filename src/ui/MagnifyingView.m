@@ -20,6 +20,33 @@
 #import "UiUtilities.h"
 
 
+// -----------------------------------------------------------------------------
+/// @brief The MagnifyingLoupeView class is a private helper class of
+/// MagnifyingView. It draws the loupe decorations (gradient, border and
+/// hotspot) on top of the magnified content.
+///
+/// The decorations do not depend on the magnified content, so
+/// MagnifyingLoupeView draws them only once and not every time the magnified
+/// content changes.
+// -----------------------------------------------------------------------------
+@interface MagnifyingLoupeView : UIView
+{
+}
+
+@property(nonatomic, assign) MagnifyingView* magnifyingView;
+
+@end
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for MagnifyingView.
+// -----------------------------------------------------------------------------
+@interface MagnifyingView()
+@property(nonatomic, retain) UIView* magnifiedContentContainerView;
+@property(nonatomic, retain) MagnifyingLoupeView* loupeView;
+@end
+
+
 @implementation MagnifyingView
 
 #pragma mark - Initialization and deallocation
@@ -34,7 +61,7 @@
   self = [super initWithFrame:rect];
   if (! self)
     return nil;
-  self.magnifiedImage = nil;
+  self.magnifiedContentView = nil;
   self.gradientEnabled = true;
 
   // The amount of alpha that we set here influences how dark the loupe appears.
@@ -57,6 +84,7 @@
   self.hotspotEnabled = true;
   self.hotspotColor = [UIColor redColor];
   self.hotspotRadius = 2.0f;
+  [self setupSubviews];
   return self;
 }
 
@@ -65,29 +93,110 @@
 // -----------------------------------------------------------------------------
 - (void) dealloc
 {
-  self.magnifiedImage = nil;
+  self.magnifiedContentView = nil;
   self.gradientOuterColor = nil;
   self.gradientInnerColor = nil;
   self.borderColor = nil;
   self.hotspotColor = nil;
+  self.loupeView.magnifyingView = nil;
+  self.loupeView = nil;
+  self.magnifiedContentContainerView = nil;
   [super dealloc];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Private helper for the initializer.
+// -----------------------------------------------------------------------------
+- (void) setupSubviews
+{
+  // The container clips the magnified content to a circle
+  self.magnifiedContentContainerView = [[[UIView alloc] initWithFrame:self.bounds] autorelease];
+  self.magnifiedContentContainerView.clipsToBounds = YES;
+  self.magnifiedContentContainerView.userInteractionEnabled = NO;
+  [self addSubview:self.magnifiedContentContainerView];
+
+  self.loupeView = [[[MagnifyingLoupeView alloc] initWithFrame:self.bounds] autorelease];
+  self.loupeView.magnifyingView = self;
+  self.loupeView.opaque = NO;
+  self.loupeView.backgroundColor = [UIColor clearColor];
+  self.loupeView.userInteractionEnabled = NO;
+  [self addSubview:self.loupeView];
+}
+
 #pragma mark - Setter implementation
 
 // -----------------------------------------------------------------------------
-/// @brief Updates the content of the view, causing the view to redraw itself.
+/// @brief Replaces the content of the view. The new content is scaled so that
+/// it fills the loupe.
+///
+/// This does not cause the view to redraw itself. The loupe decorations are
+/// drawn only once, and @a magnifiedContentView typically is a snapshot view
+/// whose content is provided by the render server.
+// -----------------------------------------------------------------------------
+- (void) setMagnifiedContentView:(UIView*)magnifiedContentView
+{
+  if (_magnifiedContentView == magnifiedContentView)
+    return;
+  if (_magnifiedContentView)
+  {
+    [_magnifiedContentView removeFromSuperview];
+    [_magnifiedContentView autorelease];
+  }
+  _magnifiedContentView = magnifiedContentView;
+  if (_magnifiedContentView)
+  {
+    [_magnifiedContentView retain];
+    [self.magnifiedContentContainerView addSubview:_magnifiedContentView];
+    [self setNeedsLayout];
+  }
+}
+
+#pragma mark - UIView overrides
+
+// -----------------------------------------------------------------------------
+/// @brief UIView method.
+// -----------------------------------------------------------------------------
+- (void) layoutSubviews
+{
+  [super layoutSubviews];
+
+  CGRect bounds = self.bounds;
+  self.magnifiedContentContainerView.frame = bounds;
+  self.loupeView.frame = bounds;
+  // Take the lesser dimension as the radius, in case the view is, for some
+  // reason, rectangular instead of square
+  self.magnifiedContentContainerView.layer.cornerRadius = MIN(bounds.size.width, bounds.size.height) / 2.0f;
+
+  if (_magnifiedContentView)
+  {
+    CGSize contentSize = _magnifiedContentView.bounds.size;
+    if (contentSize.width > 0.0f && contentSize.height > 0.0f)
+    {
+      _magnifiedContentView.transform = CGAffineTransformMakeScale(bounds.size.width / contentSize.width,
+                                                                   bounds.size.height / contentSize.height);
+    }
+    _magnifiedContentView.center = CGPointMake(CGRectGetMidX(bounds), CGRectGetMidY(bounds));
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief UIView method.
+///
+/// Forwards the request to the view that draws the loupe decorations, so that
+/// clients can still use this method after they changed one of the decoration
+/// properties.
 // -----------------------------------------------------------------------------
-- (void) setMagnifiedImage:(UIImage*)magnifiedImage
+- (void) setNeedsDisplay
 {
-  if (_magnifiedImage)
-    [_magnifiedImage autorelease];
-  _magnifiedImage = magnifiedImage;
-  if (_magnifiedImage)
-    [_magnifiedImage retain];
-  [self setNeedsDisplay];
+  [super setNeedsDisplay];
+  [self.loupeView setNeedsDisplay];
 }
 
+@end
+
+
+@implementation MagnifyingLoupeView
+
 #pragma mark - UIView overrides
 
 // -----------------------------------------------------------------------------
@@ -115,8 +224,8 @@
   // clipping path we are going to create next
   CGContextSaveGState(context);
 
-  // The clipping path we create here will remain in effect both for drawing
-  // the image with the magnified content, and for the gradient
+  // The clipping path we create here is for the gradient. The magnified
+  // content is clipped separately by MagnifyingView.
   CGContextAddArc(context,
                   magnifyingGlassCenter.x,
                   magnifyingGlassCenter.y,
@@ -126,12 +235,10 @@
                   clockwise);
   CGContextClip(context);
 
-  [_magnifiedImage drawInRect:rect];
-
-  if (self.gradientEnabled)
+  if (self.magnifyingView.gradientEnabled)
   {
     CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
-    NSArray* colors = [NSArray arrayWithObjects:(id)self.gradientOuterColor.CGColor, (id)self.gradientInnerColor.CGColor, nil];
+    NSArray* colors = [NSArray arrayWithObjects:(id)self.magnifyingView.gradientOuterColor.CGColor, (id)self.magnifyingView.gradientInnerColor.CGColor, nil];
     CGFloat locations[] = { 0.0f, 1.0f };
     // NSArray is toll-free bridged, so we can simply cast to CGArrayRef
     CGGradientRef gradient = CGGradientCreateWithColors(colorSpace,
@@ -143,8 +250,8 @@
 
     CGPoint gradientInnerCircleCenter;
     gradientInnerCircleCenter.x = magnifyingGlassCenter.x;
-    gradientInnerCircleCenter.y = CGRectGetMaxY(rect) - self.gradientInnerCircleCenterDistanceFromBottom;
-    CGFloat gradientInnerCircleRadius = self.gradientInnerCircleCenterDistanceFromBottom - self.gradientInnerCircleEdgeDistanceFromBottom;
+    gradientInnerCircleCenter.y = CGRectGetMaxY(rect) - self.magnifyingView.gradientInnerCircleCenterDistanceFromBottom;
+    CGFloat gradientInnerCircleRadius = self.magnifyingView.gradientInnerCircleCenterDistanceFromBottom - self.magnifyingView.gradientInnerCircleEdgeDistanceFromBottom;
     CGContextDrawRadialGradient(context,
                                 gradient,
                                 gradientOuterCircleCenter,
@@ -163,31 +270,31 @@
   // the clipping path.
   CGContextRestoreGState(context);
 
-  if (self.borderEnabled)
+  if (self.magnifyingView.borderEnabled)
   {
     CGContextAddArc(context,
                     magnifyingGlassCenter.x,
                     magnifyingGlassCenter.y,
                     // Reduce the radius because the circle will be stroked
-                    magnifyingGlassRadius - (self.borderWidth / 2.0f),
+                    magnifyingGlassRadius - (self.magnifyingView.borderWidth / 2.0f),
                     startRadius,
                     endRadius,
                     clockwise);
-    CGContextSetStrokeColorWithColor(context, self.borderColor.CGColor);
-    CGContextSetLineWidth(context, self.borderWidth);
+    CGContextSetStrokeColorWithColor(context, self.magnifyingView.borderColor.CGColor);
+    CGContextSetLineWidth(context, self.magnifyingView.borderWidth);
     CGContextStrokePath(context);
   }
 
-  if (self.hotspotEnabled)
+  if (self.magnifyingView.hotspotEnabled)
   {
     CGContextAddArc(context,
                     magnifyingGlassCenter.x,
                     magnifyingGlassCenter.y,
-                    self.hotspotRadius,
+                    self.magnifyingView.hotspotRadius,
                     startRadius,
                     endRadius,
                     clockwise);
-    CGContextSetFillColorWithColor(context, self.hotspotColor.CGColor);
+    CGContextSetFillColorWithColor(context, self.magnifyingView.hotspotColor.CGColor);
     CGContextFillPath(context);
   }
 }
@@ -19,7 +19,6 @@
 #import "MagnifyingViewController.h"
 #import "MagnifyingView.h"
 #import "MagnifyingViewModel.h"
-#import "UiUtilities.h"
 #import "../utility/ExceptionUtility.h"
 
 
@@ -90,7 +89,7 @@
 #pragma mark - Public API
 
 // -----------------------------------------------------------------------------
-/// @brief Grabs the screen content at and around @a magnificationCenter and
+/// @brief Grabs the content of @a view at and around @a magnificationCenter and
 /// magnifies it. Also places the magnifying view at a position that is relative
 /// to @a magnificationCenter, according to the rules specified in the class
 /// documentation. @a view is the view with @a magnificationCenter in its
@@ -111,24 +110,30 @@
   self.currentMagnificationCenter = flooredMagnificationCenter;
   self.currentMagnificationCenterView = magnificationCenterView;
 
-  // Hide the magnifying view because we don't want to capture the magnifying
-  // glass itself
-  self.magnifyingView.hidden = YES;
-
-  UIView* superviewOfMagnifyingView = self.view.superview;
-  UIView* viewWithContentToMagnify = superviewOfMagnifyingView;
-  CGPoint convertedMagnificationCenter = [viewWithContentToMagnify convertPoint:self.currentMagnificationCenter fromView:self.currentMagnificationCenterView];
-  // floor-ing prevents potential rounding errors and anti-aliasing
-  convertedMagnificationCenter = CGPointMake(floorf(convertedMagnificationCenter.x), floorf(convertedMagnificationCenter.y));
+  // The content to magnify is taken from the view that contains the
+  // magnification center, not from our superview. This has two advantages:
+  // 1) The magnifying glass itself is not part of the captured content, so
+  //    it does not need to be hidden while the content is captured.
+  // 2) The snapshot view is created by the render server from the content
+  //    that is already on screen (e.g. the rendered board view tiles). The
+  //    content is neither rendered again nor copied into an image, and the
+  //    snapshot view is scaled by Core Animation instead of by drawRect:.
+  UIView* viewWithContentToMagnify = self.currentMagnificationCenterView;
   CGSize sizeToCapture = CGSizeMake(self.magnifyingViewSize.width / self.magnifyingViewModel.magnification,
                                     self.magnifyingViewSize.height / self.magnifyingViewModel.magnification);
-  CGRect frameToCapture = CGRectMake(convertedMagnificationCenter.x - (sizeToCapture.width / 2.0f),
-                                     convertedMagnificationCenter.y - (sizeToCapture.height / 2.0f),
+  CGRect frameToCapture = CGRectMake(self.currentMagnificationCenter.x - (sizeToCapture.width / 2.0f),
+                                     self.currentMagnificationCenter.y - (sizeToCapture.height / 2.0f),
                                      sizeToCapture.width,
                                      sizeToCapture.height);
-  UIImage* capturedImage = [UiUtilities captureFrame:frameToCapture
-                                              inView:viewWithContentToMagnify];
-  self.magnifyingView.magnifiedImage = capturedImage;
+  UIView* snapshotView = [viewWithContentToMagnify resizableSnapshotViewFromRect:frameToCapture
+                                                              afterScreenUpdates:NO
+                                                                   withCapInsets:UIEdgeInsetsZero];
+  self.magnifyingView.magnifiedContentView = snapshotView;
+
+  UIView* superviewOfMagnifyingView = self.view.superview;
+  CGPoint convertedMagnificationCenter = [superviewOfMagnifyingView convertPoint:self.currentMagnificationCenter fromView:self.currentMagnificationCenterView];
+  // floor-ing prevents potential rounding errors and anti-aliasing
+  convertedMagnificationCenter = CGPointMake(floorf(convertedMagnificationCenter.x), floorf(convertedMagnificationCenter.y));
 
   // Place the magnifying glass above the intersection identified by the
   // specified GoPoint
@@ -139,9 +144,6 @@
   magnifyingViewFrame = [self magnifyingViewFrameByVeeringAwayFromFrame:magnifyingViewFrame
                                                       inSuperviewBounds:superviewOfMagnifyingView.bounds];
   self.magnifyingView.frame = magnifyingViewFrame;
-
-  // Show the magnifying view again after all updates were made
-  self.magnifyingView.hidden = NO;
 }
 
 // -----------------------------------------------------------------------------
@@ -1238,7 +1238,7 @@ struct GestureInfo createGestureInfo(void)
     sizingConstraint.active = NO;
   }
 
-  self.arrangingAutoLayoutConstraints = [NSMutableArray array];
+  self.sizingAutoLayoutConstraints = [NSMutableArray array];
 }
 
 #pragma mark - Drag handle view handling
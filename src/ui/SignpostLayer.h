@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+/// @brief Enumerates the drawing areas whose layers a SignpostLayer can
+/// measure.
+// -----------------------------------------------------------------------------
+enum SignpostDrawingArea
+{
+  SignpostDrawingAreaBoardView,
+  SignpostDrawingAreaNodeTreeView
+};
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SignpostLayer class is a CALayer that emits an os_signpost
+/// interval each time it draws its content.
+///
+/// @ingroup ui
+///
+/// Layer delegates draw their content in drawLayer:inContext:(), which CALayer
+/// invokes from drawInContext:(). SignpostLayer wraps drawInContext:() so that
+/// performance tools (Instruments, XCTOSSignpostMetric) can measure how long
+/// each layer takes to draw. The interval name depends on the drawing area,
+/// the interval message contains the class name of the layer delegate.
+///
+/// See the Constants.h section "Signpost constants" for the subsystem,
+/// category and names of the signposts.
+// -----------------------------------------------------------------------------
+@interface SignpostLayer : CALayer
+{
+}
+
++ (SignpostLayer*) layerWithDrawingArea:(enum SignpostDrawingArea)drawingArea;
+
+@property(nonatomic, assign) enum SignpostDrawingArea drawingArea;
+
+@end
@@ -0,0 +1,77 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "SignpostLayer.h"
+#import "../diagnostics/SignpostLog.h"
+
+// System includes
+#import <objc/runtime.h>
+#import <os/signpost.h>
+
+
+@implementation SignpostLayer
+
+// -----------------------------------------------------------------------------
+/// @brief Convenience constructor. Creates a SignpostLayer object that emits
+/// signposts for @a drawingArea.
+// -----------------------------------------------------------------------------
++ (SignpostLayer*) layerWithDrawingArea:(enum SignpostDrawingArea)drawingArea
+{
+  SignpostLayer* layer = [SignpostLayer layer];
+  layer.drawingArea = drawingArea;
+  return layer;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief CALayer method.
+///
+/// The signpost names must be string literals, this is a requirement of the
+/// os_signpost API. The literals must match the constants
+/// boardViewDrawLayerSignpostName and nodeTreeViewDrawLayerSignpostName.
+// -----------------------------------------------------------------------------
+- (void) drawInContext:(CGContextRef)context
+{
+  os_log_t signpostLog = [SignpostLog logForCategory:SignpostCategoryDrawing];
+  if (! os_signpost_enabled(signpostLog))
+  {
+    [super drawInContext:context];
+    return;
+  }
+
+  os_signpost_id_t signpostID = os_signpost_id_make_with_pointer(signpostLog, self);
+  const char* delegateClassName = object_getClassName(self.delegate);
+
+  switch (self.drawingArea)
+  {
+    case SignpostDrawingAreaBoardView:
+      os_signpost_interval_begin(signpostLog, signpostID, "BoardViewDrawLayer", "%{public}s", delegateClassName);
+      [super drawInContext:context];
+      os_signpost_interval_end(signpostLog, signpostID, "BoardViewDrawLayer");
+      break;
+    case SignpostDrawingAreaNodeTreeView:
+      os_signpost_interval_begin(signpostLog, signpostID, "NodeTreeViewDrawLayer", "%{public}s", delegateClassName);
+      [super drawInContext:context];
+      os_signpost_interval_end(signpostLog, signpostID, "NodeTreeViewDrawLayer");
+      break;
+    default:
+      [super drawInContext:context];
+      break;
+  }
+}
+
+@end
@@ -50,6 +50,15 @@
 /// placing tiles that are no longer visible into a "reusable queue" from where
 /// they can be taken by TiledScrollViewDataSource when a new tile is requested.
 /// This is the same mechanism as in the well-known class UITableView.
+/// The reusable queue holds at most as many tiles as are required to fill the
+/// bounds rectangle, any further tiles that are no longer visible are
+/// discarded. The reusable queue is the first thing that is given up when
+/// MemoryBudgetManager asks for memory.
+///
+/// To avoid blank tiles while the content scrolls quickly, TiledScrollView
+/// also acquires the tiles that are adjacent to the visible bounds rectangle in
+/// the direction in which the content is scrolling. These tiles are drawn
+/// before they become visible.
 ///
 ///
 /// @par Maximum number of tiles
@@ -61,6 +70,15 @@
 /// The formula for calculating the maximum number of tiles is this:
 ///   ceilf(boundsSize.width / tileSize.width) * ceilf(boundsSize.height / tileSize.height)
 ///
+/// While the user is zooming out, tiles keep the resolution of the zoom scale
+/// at which the zoom operation started, so the content that becomes visible
+/// requires more tiles. TiledScrollView acquires these additional tiles only
+/// up to a budget of twice the number of tiles in each dimension that are
+/// required at the zoom scale at which the zoom operation started. If more
+/// tiles would be required, only the tiles around the center of the visible
+/// part are acquired. When the zoom operation ends the content is redrawn at
+/// the new resolution and the normal maximum applies again.
+///
 ///
 /// @par Credits
 ///
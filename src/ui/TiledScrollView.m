@@ -17,24 +17,35 @@
 
 // Project includes
 #import "TiledScrollView.h"
+#import "../shared/MemoryBudgetManager.h"
 
 // C library
 #include <math.h>
 
 
+// -----------------------------------------------------------------------------
+/// @brief While the user is zooming out, TiledScrollView acquires at most this
+/// many times the number of tiles that are required to fill its bounds at the
+/// zoom scale at which the zoom operation started.
+// -----------------------------------------------------------------------------
+static const int zoomOutTileBudgetFactor = 2;
+/// @brief The number of tiles beyond the visible bounds that TiledScrollView
+/// acquires in the direction in which the content is scrolling.
+static const int numberOfPrefetchedTiles = 1;
+
+
 // -----------------------------------------------------------------------------
 /// @brief Class extension with private properties for TiledScrollView.
 // -----------------------------------------------------------------------------
-@interface TiledScrollView()
+@interface TiledScrollView() <MemoryBudgetClient>
 // Public property is readonly, we re-declare it here as readwrite
 @property(nonatomic, retain, readwrite) UIView* tileContainerView;
 /// @brief Tile views that are no longer visible are placed into this container.
 @property(nonatomic, retain) NSMutableSet* reusableTiles;
 @property(nonatomic, assign) Class tileViewClass;
-@property(nonatomic, assign) int indexOfFirstVisibleRow;
-@property(nonatomic, assign) int indexOfFirstVisibleColumn;
-@property(nonatomic, assign) int indexOfLastVisibleRow;
-@property(nonatomic, assign) int indexOfLastVisibleColumn;
+/// @brief The content offset at the time of the previous layout cycle. Is
+/// used to determine the direction in which the content is scrolling.
+@property(nonatomic, assign) CGPoint previousContentOffset;
 @end
 
 
@@ -63,12 +74,11 @@
   self.annotateTiles = false;
   self.reusableTiles = [[[NSMutableSet alloc] init] autorelease];
   self.tileViewClass = tileViewClass;
-  self.indexOfFirstVisibleRow = pow(2, 31);     // just any number higher than can ever occur in reality
-  self.indexOfFirstVisibleColumn = pow(2, 31);  // ditto
-  self.indexOfLastVisibleRow = -1;              // just any number lower than can ever occur in reality
-  self.indexOfLastVisibleColumn  = -1;          // ditto
+  self.previousContentOffset = CGPointZero;
 
-  [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didReceiveMemoryWarning:) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+  // Reusable tiles can be recreated cheaply, so they are among the first
+  // things that we want to give up
+  [[MemoryBudgetManager sharedManager] registerClient:self withPriority:MemoryBudgetEvictionPriorityFirst];
 
   return self;
 }
@@ -78,6 +88,7 @@
 // -----------------------------------------------------------------------------
 - (void) dealloc
 {
+  [[MemoryBudgetManager sharedManager] unregisterClient:self];
   self.dataSource = nil;
   self.reusableTiles = nil;
   self.tileContainerView = nil;
@@ -87,13 +98,40 @@
 #pragma mark - Memory management
 
 // -----------------------------------------------------------------------------
-/// @brief Responds to the system notification
-/// UIApplicationDidReceiveMemoryWarningNotification. Clears the queue of
-/// reusable tiles.
+/// @brief MemoryBudgetClient method. Returns an estimate of the number of bytes
+/// used by the tiles in the queue of reusable tiles.
 // -----------------------------------------------------------------------------
-- (void) didReceiveMemoryWarning:(NSNotification*)notification
+- (unsigned long long) evictableMemoryUsage
 {
-  [self.reusableTiles removeAllObjects];
+  return self.reusableTiles.count * [self estimatedMemoryUsagePerTile];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief MemoryBudgetClient method. Removes tiles from the queue of reusable
+/// tiles.
+// -----------------------------------------------------------------------------
+- (void) reduceEvictableMemoryUsageTo:(unsigned long long)numberOfBytes
+{
+  unsigned long long estimatedMemoryUsagePerTile = [self estimatedMemoryUsagePerTile];
+  if (estimatedMemoryUsagePerTile == 0)
+  {
+    [self.reusableTiles removeAllObjects];
+    return;
+  }
+
+  while (self.reusableTiles.count * estimatedMemoryUsagePerTile > numberOfBytes)
+    [self.reusableTiles removeObject:[self.reusableTiles anyObject]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns an estimate of the number of bytes used by the backing store
+/// of a single tile view.
+// -----------------------------------------------------------------------------
+- (unsigned long long) estimatedMemoryUsagePerTile
+{
+  // Assume 4 bytes per pixel
+  CGFloat scale = self.contentScaleFactor;
+  return (unsigned long long)(self.tileSize.width * scale * self.tileSize.height * scale * 4);
 }
 
 #pragma mark - Public interface
@@ -130,13 +168,9 @@
     if (! [tile isKindOfClass:self.tileViewClass])
       continue;
 
-    [self.reusableTiles addObject:tile];
+    [self enqueueReusableTileView:tile];
     [tile removeFromSuperview];
   }
-  self.indexOfFirstVisibleRow = pow(2, 31);     // just any number higher than can ever occur in reality
-  self.indexOfFirstVisibleColumn = pow(2, 31);  // ditto
-  self.indexOfLastVisibleRow = -1;              // just any number lower than can ever occur in reality
-  self.indexOfLastVisibleColumn  = -1;          // ditto
   [self setNeedsLayout];
 }
 
@@ -164,29 +198,25 @@
   //   enlarged by the current zoom scale
   // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
-  if (self.zooming)
-  {
-    // While the user is zooming out, larger parts of the scroll view content
-    // become visible and more tiles are required to display the visible part.
-    // If the user zooms out to the minimum zoom scale, the full content becomes
-    // visible AT THE CURRENT RESOLUTION! This is the exact opposite of what we
-    // want, namely conserve memory. A relatively simple way to work around this
-    // is not to acquire additional tiles if the user is zooming out. Since we
-    // don't know ourselves at which zoom scale the zoom operation started, we
-    // ask the data source.
-    // TODO: The problem with this solution is that it looks very ugly because
-    // now no additional content becomes visible during zooming out. Try to
-    // find a solution that somehow draws content appropriate for the zoom scale
-    // but with fewer tiles.
-    if (self.zoomScale < [self.dataSource tiledScrollViewZoomScaleAtZoomStart:self])
-      return;
-  }
-
   // The bounds rectangle is the visible part of the (possibly zoomed) content
   // of the scroll view
   CGRect visibleBounds = self.bounds;
 
-  // Check if any tiles are no longer visible
+  // In order to compare the tile size with the transformed frame of
+  // self.tileContainerView, we need to take the zoom scale into account
+  CGFloat scaledTileWidth  = self.tileSize.width  * self.zoomScale;
+  CGFloat scaledTileHeight = self.tileSize.height * self.zoomScale;
+
+  // Tiles are needed for the visible bounds, plus a few tiles ahead in the
+  // direction in which the content is scrolling, so that the tiles are already
+  // drawn when they become visible
+  CGRect neededBounds = [self neededBoundsForVisibleBounds:visibleBounds
+                                           scaledTileWidth:scaledTileWidth
+                                          scaledTileHeight:scaledTileHeight];
+  self.previousContentOffset = self.contentOffset;
+
+  // Check if any tiles are no longer needed. Remember the tiles that remain.
+  NSMutableSet* indexesOfRemainingTiles = [NSMutableSet set];
   for (UIView* tile in [self.tileContainerView subviews])
   {
     if (! [tile isKindOfClass:self.tileViewClass])
@@ -197,18 +227,21 @@
     // Important: The tile view frame takes the current zoom scale into account
     // because of the transform that is in effect on self.tileContainerView.
     CGRect scaledTileFrame = [self.tileContainerView convertRect:tile.frame toView:self];
-    if (! CGRectIntersectsRect(scaledTileFrame, visibleBounds))
+    if (! CGRectIntersectsRect(scaledTileFrame, neededBounds))
     {
-      [self.reusableTiles addObject:tile];
+      [self enqueueReusableTileView:tile];
       [tile removeFromSuperview];
     }
+    else
+    {
+      // The tile view center is in the coordinate system of
+      // self.tileContainerView, i.e. it is not affected by the zoom scale
+      int rowIndex = floorf(tile.center.y / self.tileSize.height);
+      int columnIndex = floorf(tile.center.x / self.tileSize.width);
+      [indexesOfRemainingTiles addObject:[self keyForTileWithRow:rowIndex column:columnIndex]];
+    }
   }
 
-  // In order to compare the tile size with the transformed frame of
-  // self.tileContainerView, we need to take the zoom scale into account
-  CGFloat scaledTileWidth  = self.tileSize.width  * self.zoomScale;
-  CGFloat scaledTileHeight = self.tileSize.height * self.zoomScale;
-
   // We take the container view size from its frame, not from its bounds, to
   // get the transformed size that takes the zoom scale into account
   CGSize tileContainerViewSize = self.tileContainerView.frame.size;
@@ -218,17 +251,17 @@
   int maximumColumnIndex = totalNumberOfColumns - 1;
 
   // Calculate the 0-based indexes of the tiles that we need
-  int indexOfFirstNeededRow = MAX(0, floorf(visibleBounds.origin.y / scaledTileHeight));
-  int indexOfFirstNeededCol = MAX(0, floorf(visibleBounds.origin.x / scaledTileWidth));
+  int indexOfFirstNeededRow = MAX(0, floorf(neededBounds.origin.y / scaledTileHeight));
+  int indexOfFirstNeededCol = MAX(0, floorf(neededBounds.origin.x / scaledTileWidth));
   // The -1.0f adjustment makes sure that we don't get one tile too many if the
-  // right and/or bottom edge of visibleBounds is exactly aligned with the right
+  // right and/or bottom edge of neededBounds is exactly aligned with the right
   // and/or bottom edge of a tile. Example:
   // - Tile size = 128,128
-  // - visibleBounds = 0,0,128,128
-  // - In other words: The visible bounds displays exactly 1 tile
+  // - neededBounds = 0,0,128,128
+  // - In other words: The needed bounds contain exactly 1 tile
   // - The value for indexOfLastNeededRow and indexOfLastNeededColumn is
   //   therefore expected to be 0 (because they hold 0-based index values)
-  // - CGRectGetMaxX(visibleBounds) and CGRectGetMaxY(visibleBounds) will both
+  // - CGRectGetMaxX(neededBounds) and CGRectGetMaxY(neededBounds) will both
   //   give us 128
   // - Without the -1.0f adjustment, the division would be floorf(128 / 128) = 1
   // - In other words: indexOfLastNeededRow and indexOfLastNeededColumn would
@@ -236,8 +269,33 @@
   // - With the -1.0f adjustment, the division is floorf(127 / 128) = 0
   // - The -1.0f adjustment therefore compensates for the results of
   //   CGRectGetMaxX and CGRectGetMaxY
-  int indexOfLastNeededRow = MIN(maximumRowIndex, floorf((CGRectGetMaxY(visibleBounds) - 1.0f) / scaledTileHeight));
-  int indexOfLastNeededColumn = MIN(maximumColumnIndex, floor((CGRectGetMaxX(visibleBounds) - 1.0f) / scaledTileWidth));
+  int indexOfLastNeededRow = MIN(maximumRowIndex, floorf((CGRectGetMaxY(neededBounds) - 1.0f) / scaledTileHeight));
+  int indexOfLastNeededColumn = MIN(maximumColumnIndex, floor((CGRectGetMaxX(neededBounds) - 1.0f) / scaledTileWidth));
+
+  // While the user is zooming out, larger parts of the scroll view content
+  // become visible and more tiles are required to display the visible part.
+  // If the user zooms out to the minimum zoom scale, the full content becomes
+  // visible AT THE CURRENT RESOLUTION! This is the exact opposite of what we
+  // want, namely conserve memory. We therefore acquire additional tiles only
+  // up to a budget. If the visible part requires more tiles, only the tiles
+  // around the center of the visible part are acquired. Since we don't know
+  // ourselves at which zoom scale the zoom operation started, we ask the data
+  // source.
+  if (self.zooming)
+  {
+    CGFloat zoomScaleAtZoomStart = [self.dataSource tiledScrollViewZoomScaleAtZoomStart:self];
+    if (self.zoomScale < zoomScaleAtZoomStart)
+    {
+      int maximumNumberOfRows = zoomOutTileBudgetFactor * (ceilf(visibleBounds.size.height / (self.tileSize.height * zoomScaleAtZoomStart)) + 1);
+      int maximumNumberOfColumns = zoomOutTileBudgetFactor * (ceilf(visibleBounds.size.width / (self.tileSize.width * zoomScaleAtZoomStart)) + 1);
+      [self limitIndexOfFirstTile:&indexOfFirstNeededRow
+                  indexOfLastTile:&indexOfLastNeededRow
+                 toNumberOfTiles:maximumNumberOfRows];
+      [self limitIndexOfFirstTile:&indexOfFirstNeededCol
+                  indexOfLastTile:&indexOfLastNeededColumn
+                 toNumberOfTiles:maximumNumberOfColumns];
+    }
+  }
 
   // Acquire any tiles that are missing from the data source and add them to
   // self.tileContainerView
@@ -245,8 +303,11 @@
   {
     for (int columnIndex = indexOfFirstNeededCol; columnIndex <= indexOfLastNeededColumn; ++columnIndex)
     {
-      bool tileIsMissing = (self.indexOfFirstVisibleRow > rowIndex || self.indexOfFirstVisibleColumn > columnIndex ||
-                            self.indexOfLastVisibleRow  < rowIndex || self.indexOfLastVisibleColumn  < columnIndex);
+      // We check the tiles that actually exist instead of the range of tiles
+      // that was needed by the previous layout cycle, because the budget for
+      // zooming out may have caused tiles to be skipped that are now needed,
+      // or to be kept although they are outside the range that is now needed
+      bool tileIsMissing = ! [indexesOfRemainingTiles containsObject:[self keyForTileWithRow:rowIndex column:columnIndex]];
       if (tileIsMissing)
       {
         UIView* tileView = [self.dataSource tiledScrollView:self
@@ -265,16 +326,100 @@
       }
     }
   }
-
-  // Remember which tiles are visible
-  self.indexOfFirstVisibleRow = indexOfFirstNeededRow;
-  self.indexOfFirstVisibleColumn = indexOfFirstNeededCol;
-  self.indexOfLastVisibleRow = indexOfLastNeededRow;
-  self.indexOfLastVisibleColumn = indexOfLastNeededColumn;
 }
 
 #pragma mark - Private helpers
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the rectangle for which tiles are needed. This is
+/// @a visibleBounds, extended by #numberOfPrefetchedTiles tiles in the
+/// direction in which the content has scrolled since the previous layout
+/// cycle. While the user is zooming no tiles are prefetched.
+///
+/// This is a private helper for layoutSubviews().
+// -----------------------------------------------------------------------------
+- (CGRect) neededBoundsForVisibleBounds:(CGRect)visibleBounds
+                        scaledTileWidth:(CGFloat)scaledTileWidth
+                       scaledTileHeight:(CGFloat)scaledTileHeight
+{
+  if (self.zooming)
+    return visibleBounds;
+
+  CGRect neededBounds = visibleBounds;
+  CGFloat prefetchWidth = numberOfPrefetchedTiles * scaledTileWidth;
+  CGFloat prefetchHeight = numberOfPrefetchedTiles * scaledTileHeight;
+  CGPoint contentOffset = self.contentOffset;
+
+  if (contentOffset.x > self.previousContentOffset.x)
+  {
+    neededBounds.size.width += prefetchWidth;
+  }
+  else if (contentOffset.x < self.previousContentOffset.x)
+  {
+    neededBounds.origin.x -= prefetchWidth;
+    neededBounds.size.width += prefetchWidth;
+  }
+
+  if (contentOffset.y > self.previousContentOffset.y)
+  {
+    neededBounds.size.height += prefetchHeight;
+  }
+  else if (contentOffset.y < self.previousContentOffset.y)
+  {
+    neededBounds.origin.y -= prefetchHeight;
+    neededBounds.size.height += prefetchHeight;
+  }
+
+  return neededBounds;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Places @a tileView into the pool of reusable tile views, unless the
+/// pool already contains as many tile views as are needed to fill the bounds
+/// of TiledScrollView. In that case @a tileView is discarded.
+// -----------------------------------------------------------------------------
+- (void) enqueueReusableTileView:(UIView*)tileView
+{
+  CGFloat scaledTileWidth  = self.tileSize.width  * self.zoomScale;
+  CGFloat scaledTileHeight = self.tileSize.height * self.zoomScale;
+  if (scaledTileWidth > 0.0f && scaledTileHeight > 0.0f)
+  {
+    NSUInteger maximumNumberOfReusableTiles = ((ceilf(self.bounds.size.width / scaledTileWidth) + 1) *
+                                               (ceilf(self.bounds.size.height / scaledTileHeight) + 1));
+    if (self.reusableTiles.count >= maximumNumberOfReusableTiles)
+      return;
+  }
+  [self.reusableTiles addObject:tileView];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a key that uniquely identifies the tile at @a row and
+/// @a column.
+// -----------------------------------------------------------------------------
+- (NSNumber*) keyForTileWithRow:(int)row column:(int)column
+{
+  return [NSNumber numberWithLongLong:((long long)row << 32) | (unsigned int)column];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reduces the range of tile indexes delimited by @a indexOfFirstTile
+/// and @a indexOfLastTile so that it contains no more than @a numberOfTiles
+/// tiles. The range is reduced equally on both ends so that its center
+/// remains the same.
+///
+/// This is a private helper for layoutSubviews().
+// -----------------------------------------------------------------------------
+- (void) limitIndexOfFirstTile:(int*)indexOfFirstTile
+               indexOfLastTile:(int*)indexOfLastTile
+               toNumberOfTiles:(int)numberOfTiles
+{
+  int excessNumberOfTiles = (*indexOfLastTile - *indexOfFirstTile + 1) - numberOfTiles;
+  if (excessNumberOfTiles <= 0)
+    return;
+  *indexOfFirstTile += excessNumberOfTiles / 2;
+  *indexOfLastTile -= excessNumberOfTiles - excessNumberOfTiles / 2;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Annotates the specified tile view to make it visible. This is a
 /// debugging aid. See the @e annotateTiles property documentation.
@@ -23,11 +23,6 @@
 #import "../go/GoPoint.h"
 #import "../go/GoVertex.h"
 
-// C++ standard library
-#include <set>
-#include <utility>  // for std::pair
-#include <vector>
-
 
 @implementation MarkupUtilities
 
@@ -234,8 +229,10 @@
 }
 
 // -----------------------------------------------------------------------------
-/// @brief Analyzes all label texts in @a nodeMarkup and returns a marker label
-/// text of the label type @a labelType. Raises an exception if @a labelType
+/// @brief Returns the next free marker label text of the label type
+/// @a labelType in @a nodeMarkup. If @a fillMarkerGaps is true the lowest
+/// unused marker is returned, otherwise the marker that follows the highest
+/// used marker is returned. Raises an exception if @a labelType
 /// does not refer to a marker type. Returns @e nil if all markers of the
 /// requested type are already in use.
 ///
@@ -252,101 +249,44 @@
     return nil;  // dummy return to make compiler happy
   }
 
-  char nextFreeLetterMarkerValue = 'a';
-  int nextFreeNumberMarkerValue = gMinimumNumberMarkerValue;
-  bool canUseNextFreeMarkerValue = false;
-
-  NSDictionary* labels = nodeMarkup.labels;
-  if (labels)
-  {
-    std::set<char> usedLetterMarkerValues;
-    std::set<char> usedNumberMarkerValues;
-    for (NSArray* existingLabelTypeAndText in labels.allValues)
-    {
-      NSNumber* existingLabelTypeAsNumber = existingLabelTypeAndText.firstObject;
-      enum GoMarkupLabel existingLabelType = static_cast<enum GoMarkupLabel>(existingLabelTypeAsNumber.intValue);
-      if (existingLabelType != labelType)
-        continue;
-
-      NSString* labelText = existingLabelTypeAndText.lastObject;
-
-      char letterMarkerValue;
-      int numberMarkerValue;
-      [GoNodeMarkup labelTypeOfLabel:labelText
-                   letterMarkerValue:&letterMarkerValue
-                   numberMarkerValue:&numberMarkerValue];
+  // Letter markers: Prefer lowercase characters as these seem to be used more
+  // often. Also lowercase characters are less likely to be confused with other
+  // stuff on the board (e.g. coordinate labels which are all drawn with
+  // uppercase characters, also the "next move" marker is drawn as an uppercase
+  // "A" character). GoNodeMarkup orders the used markers bitset accordingly.
+  int numberOfMarkerValues;
+  if (labelType == GoMarkupLabelMarkerLetter)
+    numberOfMarkerValues = 26 + 26;
+  else
+    numberOfMarkerValues = gMaximumNumberMarkerValue - gMinimumNumberMarkerValue + 1;
 
-      if (existingLabelType == GoMarkupLabelMarkerLetter)
-        usedLetterMarkerValues.insert(letterMarkerValue);
-      else if (existingLabelType == GoMarkupLabelMarkerNumber)
-        usedNumberMarkerValues.insert(numberMarkerValue);
-    }
+  unsigned long long usedMarkers = nodeMarkup ? [nodeMarkup usedMarkersOfType:labelType] : 0;
 
-    if (labelType == GoMarkupLabelMarkerLetter)
-    {
-      std::vector<std::pair<char, char> > letterMarkerValueRanges;
-      // Prefer lowercase characters as these seem to be used more often. Also
-      // lowercase characters are less likely to be confused with other stuff on
-      // the board (e.g. coordinate labels which are all drawn with uppercase
-      // characters, also the "next move" marker is drawn as an uppercase "A"
-      // character).
-      letterMarkerValueRanges.push_back(std::make_pair('a', 'z'));
-      letterMarkerValueRanges.push_back(std::make_pair('A', 'Z'));
+  int nextFreeMarkerIndex;
+  if (usedMarkers == 0)
+    nextFreeMarkerIndex = 0;
+  else if (fillMarkerGaps)
+    nextFreeMarkerIndex = __builtin_ctzll(~usedMarkers);  // the lowest unused marker
+  else
+    nextFreeMarkerIndex = 64 - __builtin_clzll(usedMarkers);  // the marker after the highest used marker
 
-      for (auto letterMarkerValueRange : letterMarkerValueRanges)
-      {
-        nextFreeLetterMarkerValue = letterMarkerValueRange.first;
-        while (nextFreeLetterMarkerValue <= letterMarkerValueRange.second && ! canUseNextFreeMarkerValue)
-        {
-          bool nextFreeLetterMarkerValueIsUsed = (usedLetterMarkerValues.erase(nextFreeLetterMarkerValue) != 0);
-          if (nextFreeLetterMarkerValueIsUsed)
-          {
-            nextFreeLetterMarkerValue++;
-          }
-          else
-          {
-            if (fillMarkerGaps || usedLetterMarkerValues.empty())
-              canUseNextFreeMarkerValue = true;
-            else
-              nextFreeLetterMarkerValue++;
-          }
-        }
+  if (nextFreeMarkerIndex >= numberOfMarkerValues)
+    return nil;
 
-        if (canUseNextFreeMarkerValue)
-          break;
-      }
-    }
+  NSString* nextFreeMarker;
+  if (labelType == GoMarkupLabelMarkerLetter)
+  {
+    char nextFreeLetterMarkerValue;
+    if (nextFreeMarkerIndex < 26)
+      nextFreeLetterMarkerValue = 'a' + nextFreeMarkerIndex;
     else
-    {
-      while (nextFreeNumberMarkerValue <= gMaximumNumberMarkerValue && ! canUseNextFreeMarkerValue)
-      {
-        bool nextFreeNumberMarkerValueIsUsed = (usedNumberMarkerValues.erase(nextFreeNumberMarkerValue) != 0);
-        if (nextFreeNumberMarkerValueIsUsed)
-        {
-          nextFreeNumberMarkerValue++;
-        }
-        else
-        {
-          if (fillMarkerGaps || usedNumberMarkerValues.empty())
-            canUseNextFreeMarkerValue = true;
-          else
-            nextFreeNumberMarkerValue++;
-        }
-      }
-    }
+      nextFreeLetterMarkerValue = 'A' + nextFreeMarkerIndex - 26;
+    nextFreeMarker = [NSString stringWithFormat:@"%c" , nextFreeLetterMarkerValue];
   }
   else
   {
-    canUseNextFreeMarkerValue = true;
-  }
-
-  NSString* nextFreeMarker = nil;
-  if (canUseNextFreeMarkerValue)
-  {
-    if (labelType == GoMarkupLabelMarkerLetter)
-      nextFreeMarker = [NSString stringWithFormat:@"%c" , nextFreeLetterMarkerValue];
-    else
-      nextFreeMarker = [NSString stringWithFormat:@"%d" , nextFreeNumberMarkerValue];
+    int nextFreeNumberMarkerValue = gMinimumNumberMarkerValue + nextFreeMarkerIndex;
+    nextFreeMarker = [NSString stringWithFormat:@"%d" , nextFreeNumberMarkerValue];
   }
   return nextFreeMarker;
 }
@@ -446,51 +386,50 @@
   if (! nodeMarkup)
     return false;
 
-  NSString* intersection = point.vertex.string;
+  enum GoMarkupSymbol symbol;
+  if ([nodeMarkup hasSymbolAtPoint:point symbol:&symbol])
+  {
+    *firstMarkupType = [MarkupUtilities markupTypeForSymbol:symbol];
+    *firstMarkupInfo = nil;
+    return true;
+  }
 
-  NSDictionary* symbols = nodeMarkup.symbols;
-  if (symbols)
+  enum GoMarkupLabel existingLabelType;
+  NSString* existingLabelText;
+  if ([nodeMarkup hasLabelAtPoint:point labelType:&existingLabelType labelText:&existingLabelText])
   {
-    NSNumber* symbolAsNumber = symbols[intersection];
-    if (symbolAsNumber)
+    if (existingLabelType != GoMarkupLabelLabel || (existingLabelType == GoMarkupLabelLabel && ! ignoreLabels))
     {
-      enum GoMarkupSymbol symbol = static_cast<enum GoMarkupSymbol>(symbolAsNumber.intValue);
-      *firstMarkupType = [MarkupUtilities markupTypeForSymbol:symbol];
-      *firstMarkupInfo = nil;
+      *firstMarkupType = [MarkupUtilities markupTypeForLabel:existingLabelType];
+      *firstMarkupInfo = existingLabelText;
       return true;
     }
   }
 
-  NSDictionary* labels = nodeMarkup.labels;
-  if (labels)
+  if ([nodeMarkup hasConnections])
   {
-    NSArray* existingLabelTypeAndText = labels[intersection];
-    if (existingLabelTypeAndText)
+    struct GoVertexNumeric numericVertex = point.vertex.numeric;
+    __block bool connectionFound = false;
+    __block enum GoMarkupConnection foundConnection;
+    __block NSArray* foundConnectionVertices = nil;
+    [nodeMarkup enumerateConnectionsUsingBlock:^(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop)
     {
-      NSNumber* existingLabelTypeAsNumber = existingLabelTypeAndText.firstObject;
-      enum GoMarkupLabel existingLabelType = static_cast<enum GoMarkupLabel>(existingLabelTypeAsNumber.intValue);
-      if (existingLabelType != GoMarkupLabelLabel || (existingLabelType == GoMarkupLabelLabel && ! ignoreLabels))
+      if ((fromVertex.x == numericVertex.x && fromVertex.y == numericVertex.y) ||
+          (toVertex.x == numericVertex.x && toVertex.y == numericVertex.y))
       {
-        *firstMarkupType = [MarkupUtilities markupTypeForLabel:existingLabelType];
-        *firstMarkupInfo = existingLabelTypeAndText.lastObject;
-        return true;
+        connectionFound = true;
+        foundConnection = connection;
+        foundConnectionVertices = @[[GoVertex vertexFromNumeric:fromVertex].string,
+                                    [GoVertex vertexFromNumeric:toVertex].string];
+        *stop = true;
       }
-    }
-  }
+    }];
 
-  NSDictionary* connections = nodeMarkup.connections;
-  if (connections)
-  {
-    for (NSArray* key in connections.allKeys)
+    if (connectionFound)
     {
-      if ([key containsObject:intersection])
-      {
-        NSNumber* connectionAsNumber = connections[key];
-        enum GoMarkupConnection connection = static_cast<enum GoMarkupConnection>(connectionAsNumber.intValue);
-        *firstMarkupType = [MarkupUtilities markupTypeForConnection:connection];
-        *firstMarkupInfo = key;
-        return true;
-      }
+      *firstMarkupType = [MarkupUtilities markupTypeForConnection:foundConnection];
+      *firstMarkupInfo = foundConnectionVertices;
+      return true;
     }
   }
 
@@ -39,6 +39,14 @@
 + (NSString*) filePathForBackupFileNamed:(NSString*)fileName fileExists:(BOOL*)fileExists;
 + (NSString*) inboxFolderPath;
 + (NSString*) archiveFolderPath;
++ (NSString*) thumbnailCacheFolderPath;
++ (NSString*) analysisFolderPath;
++ (NSString*) benchmarkFolderPath;
++ (NSString*) patternIndexFolderPath;
++ (NSString*) boardDiagramExportFolderPath;
++ (NSString*) nodeTreeViewLayoutCacheFilePath;
++ (NSString*) gtpResponseCacheFilePath;
++ (NSString*) openingBookIndexFilePath;
 + (NSString*) filePathForFileNamed:(NSString*)fileName folderPath:(NSString*)folderPath fileExists:(BOOL*)fileExists;
 
 @end
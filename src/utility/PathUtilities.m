@@ -325,6 +325,109 @@
   return [paths objectAtIndex:0];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the folder that contains the cached
+/// thumbnail images of archived games. The folder is located in the Caches
+/// folder, so the system may purge it at any time.
+// -----------------------------------------------------------------------------
++ (NSString*) thumbnailCacheFolderPath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, expandTilde);
+  NSString* cachesDirectory = [paths objectAtIndex:0];
+  return [cachesDirectory stringByAppendingPathComponent:archiveThumbnailsFolderName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the folder that contains the analysis
+/// results produced by AnalyzeSgfFileCommand. The folder is located in the
+/// Application Support folder, so that it does not appear in the archive.
+// -----------------------------------------------------------------------------
++ (NSString*) analysisFolderPath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, expandTilde);
+  NSString* applicationSupportDirectory = [paths objectAtIndex:0];
+  return [applicationSupportDirectory stringByAppendingPathComponent:analysisFolderName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the folder that contains the reports
+/// produced by RunSustainedLoadBenchmarkCommand and
+/// RunThreadScalingBenchmarkCommand. The folder is located in the
+/// Application Support folder, so that it does not appear in the archive.
+// -----------------------------------------------------------------------------
++ (NSString*) benchmarkFolderPath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSApplicationSupportDirectory, NSUserDomainMask, expandTilde);
+  NSString* applicationSupportDirectory = [paths objectAtIndex:0];
+  return [applicationSupportDirectory stringByAppendingPathComponent:benchmarkFolderName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the folder that contains the pattern index
+/// of archived games (see ArchivePatternIndex). The folder is located in the
+/// Caches folder, so the system may purge it at any time.
+// -----------------------------------------------------------------------------
++ (NSString*) patternIndexFolderPath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, expandTilde);
+  NSString* cachesDirectory = [paths objectAtIndex:0];
+  return [cachesDirectory stringByAppendingPathComponent:archivePatternIndexFolderName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the folder that contains the files produced
+/// by ExportBoardDiagramsCommand. The folder is located in the temporary
+/// folder, so that exported files do not appear in the archive and are
+/// eventually removed by the system after they have been shared.
+// -----------------------------------------------------------------------------
++ (NSString*) boardDiagramExportFolderPath
+{
+  return [NSTemporaryDirectory() stringByAppendingPathComponent:boardDiagramExportFolderName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the file in which NodeTreeViewLayoutCache
+/// stores its content. The file is located in the Caches folder, so the system
+/// may purge it at any time.
+// -----------------------------------------------------------------------------
++ (NSString*) nodeTreeViewLayoutCacheFilePath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, expandTilde);
+  NSString* cachesDirectory = [paths objectAtIndex:0];
+  return [cachesDirectory stringByAppendingPathComponent:nodeTreeViewLayoutCacheFileName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the file in which GtpResponseCache stores
+/// its content. The file is located in the Caches folder, so the system may
+/// purge it at any time.
+// -----------------------------------------------------------------------------
++ (NSString*) gtpResponseCacheFilePath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, expandTilde);
+  NSString* cachesDirectory = [paths objectAtIndex:0];
+  return [cachesDirectory stringByAppendingPathComponent:gtpResponseCacheFileName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the full path to the file in which GoOpeningBook stores the
+/// compiled index of the opening book. The file is located in the Caches
+/// folder, so the system may purge it at any time.
+// -----------------------------------------------------------------------------
++ (NSString*) openingBookIndexFilePath
+{
+  BOOL expandTilde = YES;
+  NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, expandTilde);
+  NSString* cachesDirectory = [paths objectAtIndex:0];
+  return [cachesDirectory stringByAppendingPathComponent:openingBookIndexFileName];
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns the full path to the Inbox folder, i.e. the folder used by
 /// the document interaction system to pass files into the app.
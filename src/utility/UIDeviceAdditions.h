@@ -30,4 +30,9 @@
 + (NSString*) currentDeviceSuffix;
 + (int) systemVersionMajor;
 + (int) physicalMemoryMegabytes;
++ (unsigned long long) applicationMemoryFootprint;
++ (unsigned long long) applicationMemoryLimit;
++ (double) applicationCpuTime;
++ (unsigned long long) applicationEnergy;
++ (NSString*) hardwareModel;
 @end
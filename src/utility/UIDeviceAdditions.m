@@ -18,6 +18,12 @@
 // Project includes
 #import "UIDeviceAdditions.h"
 
+// System includes
+#import <mach/mach.h>
+#import <os/proc.h>
+#import <sys/resource.h>
+#import <sys/utsname.h>
+
 
 @implementation UIDevice(UIDeviceAdditions)
 
@@ -87,4 +93,87 @@
   return (int)physicalMemoryMegaBytes;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the application's current memory footprint in bytes, i.e.
+/// the amount of memory that counts towards the limit at which the operating
+/// system terminates the application. Returns 0 if the memory footprint cannot
+/// be determined.
+// -----------------------------------------------------------------------------
++ (unsigned long long) applicationMemoryFootprint
+{
+  task_vm_info_data_t vmInfo;
+  mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+  kern_return_t result = task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&vmInfo, &count);
+  if (result != KERN_SUCCESS)
+    return 0;
+  return vmInfo.phys_footprint;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the number of bytes that the application's memory footprint
+/// may reach before the operating system terminates the application.
+///
+/// The limit is the sum of the current memory footprint and the amount of
+/// memory that is still available to the application. If the operating system
+/// does not provide the latter, half of the physical memory of the device is
+/// returned as a conservative estimate.
+// -----------------------------------------------------------------------------
++ (unsigned long long) applicationMemoryLimit
+{
+  unsigned long long availableMemory = os_proc_available_memory();
+  if (availableMemory == 0)
+    return [UIDevice physicalMemoryMegabytes] * 1024ULL * 1024ULL / 2;
+  return [UIDevice applicationMemoryFootprint] + availableMemory;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the CPU time in seconds (user and system time of all
+/// threads) that the application has consumed since it was launched. Returns
+/// 0 if the CPU time cannot be determined.
+// -----------------------------------------------------------------------------
++ (double) applicationCpuTime
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0.0;
+  return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+          (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the energy in nanojoules that the application has consumed
+/// since it was launched. Returns 0 if the energy cannot be determined.
+///
+/// The kernel provides this information only on ARM hardware, so on other
+/// hardware (e.g. the simulator) this method always returns 0.
+// -----------------------------------------------------------------------------
++ (unsigned long long) applicationEnergy
+{
+#if defined(__arm__) || defined(__arm64__)
+  task_power_info_v2_data_t powerInfo;
+  mach_msg_type_number_t count = TASK_POWER_INFO_V2_COUNT;
+  kern_return_t result = task_info(mach_task_self(), TASK_POWER_INFO_V2, (task_info_t)&powerInfo, &count);
+  if (result != KERN_SUCCESS)
+    return 0;
+  return powerInfo.task_energy;
+#else
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the hardware model identifier of the device (e.g.
+/// "iPhone15,2"). Unlike UIDevice's @e model property, the identifier
+/// distinguishes between device generations. Returns "unknown" if the
+/// identifier cannot be determined.
+// -----------------------------------------------------------------------------
++ (NSString*) hardwareModel
+{
+  struct utsname systemInfo;
+  if (uname(&systemInfo) != 0)
+    return @"unknown";
+  NSString* hardwareModel = [NSString stringWithCString:systemInfo.machine encoding:NSUTF8StringEncoding];
+  return hardwareModel ? hardwareModel : @"unknown";
+}
+
 @end
@@ -57,6 +57,13 @@
 /// multiple versions of user defaults data (not just from the previous
 /// version). Upgrades are performed incrementally to make this task easier.
 ///
+/// The incremental upgrades do not operate on the user defaults system
+/// directly. They operate on a mutable copy of the application domain, which
+/// is written back to the user defaults system in a single operation after
+/// the last incremental upgrade has been performed. If the user defaults are
+/// already in the current format, which is the case on almost every launch,
+/// UserDefaultsUpdater does nothing beyond comparing the version numbers.
+///
 ///
 /// @par The user defaults format version number
 ///
@@ -102,6 +109,10 @@
 /// automatically finds and invokes all upgrade methods that are named
 /// according to the above scheme.
 ///
+/// An upgrade method obtains the application domain to work on from the
+/// private class method applicationDomainBeingUpgraded(). It must not access
+/// NSUserDefaults directly.
+///
 /// The implementation of an upgrade method must not rely on any data defined
 /// outside of UserDefaultsUpdater (e.g. global constants, registration domain
 /// defaults data) because this data could change over time, which would cause
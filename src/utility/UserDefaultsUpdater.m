@@ -71,6 +71,11 @@ NSString* crashDataContactAllowKey = @"CrashDataContactAllowKey";
 NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 //@}
 
+/// @brief The application domain that is being upgraded. Is a mutable copy of
+/// the persistent domain while upgradeToRegistrationDomainDefaults:() runs
+/// incremental upgrades, and @e nil otherwise.
+static NSMutableDictionary* stagedApplicationDomain = nil;
+
 
 @implementation UserDefaultsUpdater
 
@@ -123,12 +128,12 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 
   int registrationDomainVersion = [[registrationDomainDefaults valueForKey:userDefaultsVersionRegistrationDomainKey] intValue];
   int applicationDomainVersion = [[userDefaults valueForKey:userDefaultsVersionApplicationDomainKey] intValue];
-  int numberOfUpgradesPerformed = 0;  // aka the return value :-)
+  // Fast path that is taken on almost every launch
   if (applicationDomainVersion == registrationDomainVersion)
-  {
-    // nothing to do
-  }
-  else if (0 == applicationDomainVersion)
+    return 0;
+
+  int numberOfUpgradesPerformed = 0;  // aka the return value :-)
+  if (0 == applicationDomainVersion)
   {
     // Theoretically, applicationDomainVersion could also be 0 if an extremely
     // old version of the source code were built & run, i.e. one before user
@@ -150,6 +155,13 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
   }
   else
   {
+    // All incremental upgrades operate on a mutable copy of the application
+    // domain. The result is written back in a single operation, regardless of
+    // how many incremental upgrades are performed.
+    NSString* applicationDomainName = [[NSBundle mainBundle] bundleIdentifier];
+    NSDictionary* applicationDomain = [userDefaults persistentDomainForName:applicationDomainName];
+    stagedApplicationDomain = [NSMutableDictionary dictionaryWithDictionary:applicationDomain];
+
     while (applicationDomainVersion < registrationDomainVersion)
     {
       // Incrementally perform upgrades. We allow for gaps in the user defaults
@@ -183,10 +195,13 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 
         ++numberOfUpgradesPerformed;
         // Update the application domain version number
-        [userDefaults setValue:[NSNumber numberWithInt:applicationDomainVersion]
-                        forKey:userDefaultsVersionApplicationDomainKey];
+        [stagedApplicationDomain setValue:[NSNumber numberWithInt:applicationDomainVersion]
+                                          forKey:userDefaultsVersionApplicationDomainKey];
       }
     }
+
+    [userDefaults setPersistentDomain:stagedApplicationDomain forName:applicationDomainName];
+    stagedApplicationDomain = nil;
   }
 
   // Perform final check if the cumulative effect of all upgrades had the
@@ -205,13 +220,27 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
   return numberOfUpgradesPerformed;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the application domain that the incremental upgrade methods
+/// must read from and write to.
+///
+/// This is an internal helper for the incremental upgrade methods. The
+/// returned dictionary responds to the same key-based accessors as
+/// NSUserDefaults, so the upgrade methods treat it as if it were the user
+/// defaults object.
+// -----------------------------------------------------------------------------
++ (NSMutableDictionary*) applicationDomainBeingUpgraded
+{
+  return stagedApplicationDomain;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Performs the incremental upgrade to the user defaults format
 /// version 1.
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion1:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   id playViewDictionary = [userDefaults objectForKey:playViewKey];
   if (playViewDictionary)  // is nil if the key is not present
@@ -243,7 +272,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion2:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // The previous app version had a bug that might have allowed the user to
   // select a handicap for new games that was greater than the maximum handicap
@@ -275,7 +304,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion3:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Numeric values for enumerated board sizes now correspond to natural board
   // sizes (e.g. the numeric value for BoardSize9 is now 9), whereas previously
@@ -338,7 +367,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion4:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Every GTP engine profile now has a number of additional keys
   id profileListArray = [userDefaults objectForKey:gtpEngineProfileListKey];
@@ -364,7 +393,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 + (void) upgradeToVersion5:(NSDictionary*)registrationDomainDefaults
 {
   // New top-level key
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
   [userDefaults setValue:[NSNumber numberWithBool:NO] forKey:loggingEnabledKey];
 
   // Add new dictionary with board position settings.
@@ -443,7 +472,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion6:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Add new keys to / change existing keys in "PlayView" dictionary
   id playViewDictionary = [userDefaults objectForKey:playViewKey];
@@ -493,7 +522,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion7:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Every GTP engine profile now has a number of additional keys
   id profileListArray = [userDefaults objectForKey:gtpEngineProfileListKey];
@@ -547,7 +576,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion8:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Add new key to "PlayView" dictionary
   id playViewDictionary = [userDefaults objectForKey:playViewKey];
@@ -614,7 +643,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion9:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Remove obsolete keys from "PlayView" dictionary, and rename "PlayView"
   // to "BoardView" dictionary
@@ -685,7 +714,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion10:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Just remove the value, we don't bother converting to the new key
   // "VisibleUIArea"
@@ -761,7 +790,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion11:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
   
   // Add two new GTP commands to "GtpCannedCommands" array
   id cannedCommandsArray = [userDefaults objectForKey:gtpCannedCommandsKey];
@@ -804,7 +833,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion12:(NSDictionary*)registrationDomainDefaults
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   NSArray* userDefaultsPlayers = [userDefaults objectForKey:playerListKey];
   if (! userDefaultsPlayers)
@@ -915,7 +944,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 // -----------------------------------------------------------------------------
 + (void) upgradeToVersion13
 {
-  NSUserDefaults* userDefaults = [NSUserDefaults standardUserDefaults];
+  NSMutableDictionary* userDefaults = [UserDefaultsUpdater applicationDomainBeingUpgraded];
 
   // Rename key in "BoardPosition" dictionary
   id boardPositionDictionary = [userDefaults objectForKey:boardPositionKey];
@@ -1016,7 +1045,7 @@ NSString* crashDataContactEmailKey = @"CrashDataContactEmailKey";
 /// parameter. If a player is found which refers to one of the old profile UUIDs
 /// in the dictionary, the reference is changed to the profile's new UUID.
 // -----------------------------------------------------------------------------
-+ (bool) addToUserDefaults:(NSUserDefaults*)userDefaults
++ (bool) addToUserDefaults:(NSMutableDictionary*)userDefaults
     fromRegistrationDomain:(NSDictionary*)registrationDomainDefaults
                addProfiles:(bool)addProfiles
            renamedProfiles:(NSMutableDictionary**)renamedProfiles
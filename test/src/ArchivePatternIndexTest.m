@@ -0,0 +1,262 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "ArchivePatternIndexTest.h"
+
+// Application includes
+#import <archive/ArchivePatternIndex.h>
+#import <utility/PathUtilities.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for ArchivePatternIndexTest.
+// -----------------------------------------------------------------------------
+@interface ArchivePatternIndexTest()
+@property(nonatomic, retain) NSString* archiveFolder;
+/// @brief Black stone on the 3-3 point of any corner.
+@property(nonatomic, retain) NSArray* cornerPattern;
+@end
+
+
+@implementation ArchivePatternIndexTest
+
+// -----------------------------------------------------------------------------
+/// @brief Creates an empty archive folder.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+
+  self.archiveFolder = [NSTemporaryDirectory() stringByAppendingPathComponent:NSStringFromClass([self class])];
+  [PathUtilities createFolder:self.archiveFolder removeIfExists:true];
+  self.cornerPattern = @[@"|..X",
+                         @"|...",
+                         @"|...",
+                         @"+---"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the archive folder and the index files of the .sgf files
+/// that the tests write.
+// -----------------------------------------------------------------------------
+- (void) tearDown
+{
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSString* indexFolder = [PathUtilities patternIndexFolderPath];
+  for (NSString* sgfFileName in @[@"ArchivePatternIndexTest-1.sgf", @"ArchivePatternIndexTest-2.sgf"])
+    [fileManager removeItemAtPath:[self indexFilePathForSgfFileName:sgfFileName inFolder:indexFolder] error:nil];
+  [fileManager removeItemAtPath:self.archiveFolder error:nil];
+  self.archiveFolder = nil;
+  self.cornerPattern = nil;
+
+  [super tearDown];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the isValidPattern:errorMessage:() method.
+// -----------------------------------------------------------------------------
+- (void) testIsValidPattern
+{
+  NSString* errorMessage = nil;
+  XCTAssertTrue([ArchivePatternIndex isValidPattern:self.cornerPattern errorMessage:&errorMessage]);
+  XCTAssertTrue([ArchivePatternIndex isValidPattern:@[@"X O ?"] errorMessage:&errorMessage]);
+  XCTAssertTrue([ArchivePatternIndex isValidPattern:@[@"+---+", @"|x.o|", @"+---+"] errorMessage:&errorMessage]);
+
+  errorMessage = nil;
+  XCTAssertFalse([ArchivePatternIndex isValidPattern:@[] errorMessage:&errorMessage]);
+  XCTAssertNotNil(errorMessage);
+
+  errorMessage = nil;
+  XCTAssertFalse([ArchivePatternIndex isValidPattern:@[@"+---"] errorMessage:&errorMessage]);
+  XCTAssertNotNil(errorMessage);
+
+  errorMessage = nil;
+  XCTAssertFalse([ArchivePatternIndex isValidPattern:@[@"X.", @"..."] errorMessage:&errorMessage]);
+  XCTAssertNotNil(errorMessage);
+
+  errorMessage = nil;
+  XCTAssertFalse([ArchivePatternIndex isValidPattern:@[@"X.Z"] errorMessage:&errorMessage]);
+  XCTAssertNotNil(errorMessage);
+
+  // The error message is optional
+  XCTAssertFalse([ArchivePatternIndex isValidPattern:@[@"X.Z"] errorMessage:nil]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the updateWithProgressHandler:() method.
+// -----------------------------------------------------------------------------
+- (void) testUpdate
+{
+  [self writeArchiveFiles];
+
+  ArchivePatternIndex* patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  XCTAssertEqualObjects(patternIndex.archiveFolder, self.archiveFolder);
+  XCTAssertEqual(patternIndex.numberOfGames, 0);
+
+  NSMutableArray* progress = [NSMutableArray array];
+  [patternIndex updateWithProgressHandler:^(int numberOfFilesUpdated, int numberOfFiles)
+  {
+    [progress addObject:[NSString stringWithFormat:@"%d/%d", numberOfFilesUpdated, numberOfFiles]];
+  }];
+
+  // The .txt file is not part of the index
+  XCTAssertEqualObjects(progress, (@[@"1/2", @"2/2"]));
+  XCTAssertEqual(patternIndex.numberOfGames, 3);
+
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSString* indexFolder = [PathUtilities patternIndexFolderPath];
+  XCTAssertTrue([fileManager fileExistsAtPath:[self indexFilePathForSgfFileName:@"ArchivePatternIndexTest-1.sgf" inFolder:indexFolder]]);
+  XCTAssertTrue([fileManager fileExistsAtPath:[self indexFilePathForSgfFileName:@"ArchivePatternIndexTest-2.sgf" inFolder:indexFolder]]);
+
+  // Files that disappear from the archive disappear from the index
+  [fileManager removeItemAtPath:[self.archiveFolder stringByAppendingPathComponent:@"ArchivePatternIndexTest-2.sgf"] error:nil];
+  [patternIndex updateWithProgressHandler:nil];
+  XCTAssertEqual(patternIndex.numberOfGames, 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the searchPattern:matchSwappedColors:() method.
+// -----------------------------------------------------------------------------
+- (void) testSearchPattern
+{
+  [self writeArchiveFiles];
+
+  ArchivePatternIndex* patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  XCTAssertEqualObjects([patternIndex searchPattern:self.cornerPattern matchSwappedColors:false], @[]);
+
+  [patternIndex updateWithProgressHandler:nil];
+
+  // Only game 2 in file 2 has a black stone on a 3-3 point. The game is played
+  // on a 19x19 board, the stone is in the upper left corner.
+  NSArray* expectedSearchResults = @[@{@"fileName" : @"ArchivePatternIndexTest-2.sgf", @"gameNumber" : @2, @"boardPosition" : @3}];
+  XCTAssertEqualObjects([patternIndex searchPattern:self.cornerPattern matchSwappedColors:false], expectedSearchResults);
+
+  // With swapped colors the white stone on a 3-3 point in file 1 also
+  // matches. The results are sorted by file name.
+  expectedSearchResults = @[@{@"fileName" : @"ArchivePatternIndexTest-1.sgf", @"gameNumber" : @1, @"boardPosition" : @2},
+                            @{@"fileName" : @"ArchivePatternIndexTest-2.sgf", @"gameNumber" : @2, @"boardPosition" : @3}];
+  XCTAssertEqualObjects([patternIndex searchPattern:self.cornerPattern matchSwappedColors:true], expectedSearchResults);
+
+  // Board position 0 contains the setup stones of the root node
+  expectedSearchResults = @[@{@"fileName" : @"ArchivePatternIndexTest-1.sgf", @"gameNumber" : @1, @"boardPosition" : @0}];
+  XCTAssertEqualObjects([patternIndex searchPattern:@[@"XXX"] matchSwappedColors:false], expectedSearchResults);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the searchPattern:matchSwappedColors:() method with a
+/// pattern that is not valid.
+// -----------------------------------------------------------------------------
+- (void) testSearchPatternWithInvalidPattern
+{
+  [self writeArchiveFiles];
+
+  ArchivePatternIndex* patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  [patternIndex updateWithProgressHandler:nil];
+
+  XCTAssertNil([patternIndex searchPattern:@[@"X.Z"] matchSwappedColors:false]);
+  XCTAssertNil([patternIndex searchPattern:@[] matchSwappedColors:false]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the reuse of index files. An index file is used as long
+/// as it is not older than its .sgf file and its content is valid.
+// -----------------------------------------------------------------------------
+- (void) testIndexFileReuse
+{
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSString* sgfFileName = @"ArchivePatternIndexTest-1.sgf";
+  NSString* sgfFilePath = [self.archiveFolder stringByAppendingPathComponent:sgfFileName];
+  NSString* indexFilePath = [self indexFilePathForSgfFileName:sgfFileName inFolder:[PathUtilities patternIndexFolderPath]];
+  NSDate* pastDate = [NSDate dateWithTimeIntervalSinceNow:-3600];
+
+  [self writeSgfFileWithName:sgfFileName content:@"(;FF[4]GM[1]SZ[9];B[cg])" modificationDate:pastDate];
+  ArchivePatternIndex* patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  [patternIndex updateWithProgressHandler:nil];
+  XCTAssertEqual([patternIndex searchPattern:self.cornerPattern matchSwappedColors:false].count, 1);
+  XCTAssertTrue([fileManager fileExistsAtPath:indexFilePath]);
+
+  // The game changes, but the index file is newer than the .sgf file, so the
+  // search still sees the old game
+  [self writeSgfFileWithName:sgfFileName content:@"(;FF[4]GM[1]SZ[9];B[ee])" modificationDate:pastDate];
+  patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  [patternIndex updateWithProgressHandler:nil];
+  XCTAssertEqual([patternIndex searchPattern:self.cornerPattern matchSwappedColors:false].count, 1);
+
+  // A damaged index file is rebuilt
+  [[NSData dataWithBytes:"x" length:1] writeToFile:indexFilePath atomically:YES];
+  patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  [patternIndex updateWithProgressHandler:nil];
+  XCTAssertEqual(patternIndex.numberOfGames, 1);
+  XCTAssertEqual([patternIndex searchPattern:self.cornerPattern matchSwappedColors:false].count, 0);
+
+  // An index file that is older than the .sgf file is rebuilt
+  [self writeSgfFileWithName:sgfFileName content:@"(;FF[4]GM[1]SZ[9];B[gc])" modificationDate:[NSDate dateWithTimeIntervalSinceNow:3600]];
+  patternIndex = [[[ArchivePatternIndex alloc] initWithArchiveFolder:self.archiveFolder] autorelease];
+  [patternIndex updateWithProgressHandler:nil];
+  XCTAssertEqual([patternIndex searchPattern:self.cornerPattern matchSwappedColors:false].count, 1);
+}
+
+#pragma mark - Helper methods
+
+// -----------------------------------------------------------------------------
+/// @brief Writes the .sgf files that most tests use to the archive folder.
+///
+/// - ArchivePatternIndexTest-1.sgf contains one 9x9 game with three black
+///   setup stones in a row, and a white stone on a 3-3 point in board
+///   position 2.
+/// - ArchivePatternIndexTest-2.sgf contains two games. The 9x9 game has no
+///   stone on a 3-3 point. The 19x19 game has a black stone on a 3-3 point in
+///   board position 3.
+/// - ArchivePatternIndexTest.txt is not an .sgf file.
+// -----------------------------------------------------------------------------
+- (void) writeArchiveFiles
+{
+  [self writeSgfFileWithName:@"ArchivePatternIndexTest-1.sgf"
+                     content:@"(;FF[4]GM[1]SZ[9]AB[ae][be][ce];B[ee];W[cg])"
+            modificationDate:nil];
+  [self writeSgfFileWithName:@"ArchivePatternIndexTest-2.sgf"
+                     content:@"(;FF[4]GM[1]SZ[9];B[ee];W[dd])(;FF[4]GM[1]SZ[19];B[pd];W[dp];B[cc])"
+            modificationDate:nil];
+  [self writeSgfFileWithName:@"ArchivePatternIndexTest.txt"
+                     content:@"(;FF[4]GM[1]SZ[9];B[cg])"
+            modificationDate:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Writes @a content to the file @a fileName in the archive folder. If
+/// @a modificationDate is not nil it becomes the modification date of the
+/// file.
+// -----------------------------------------------------------------------------
+- (void) writeSgfFileWithName:(NSString*)fileName content:(NSString*)content modificationDate:(NSDate*)modificationDate
+{
+  NSString* filePath = [self.archiveFolder stringByAppendingPathComponent:fileName];
+  [content writeToFile:filePath atomically:YES encoding:NSUTF8StringEncoding error:nil];
+  if (modificationDate)
+    [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate: modificationDate} ofItemAtPath:filePath error:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the path of the index file that ArchivePatternIndex writes
+/// for the .sgf file @a sgfFileName to @a indexFolder.
+// -----------------------------------------------------------------------------
+- (NSString*) indexFilePathForSgfFileName:(NSString*)sgfFileName inFolder:(NSString*)indexFolder
+{
+  return [indexFolder stringByAppendingPathComponent:[sgfFileName stringByAppendingPathExtension:@"index"]];
+}
+
+@end
@@ -0,0 +1,93 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "ComputerSuggestMoveCommandTest.h"
+
+// Application includes
+#import <command/move/ComputerSuggestMoveCommand.h>
+#import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
+#import <go/GoGame.h>
+#import <go/GoNode.h>
+#import <go/GoPoint.h>
+
+
+@implementation ComputerSuggestMoveCommandTest
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a move suggestion for @a color to play on @a vertex.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) moveSuggestionForColor:(enum GoColor)color vertex:(NSString*)vertex
+{
+  return @{
+    moveSuggestionColorKey : [NSNumber numberWithInt:color],
+    moveSuggestionTypeKey : [NSNumber numberWithInt:MoveSuggestionTypePlay],
+    moveSuggestionPointKey : [m_game.board pointAtVertex:vertex],
+    moveSuggestionErrorMessageKey : [NSNull null],
+  };
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that ComputerSuggestMoveCommand delivers the move suggestion
+/// that is stored in the current GoNode without asking the GTP engine.
+// -----------------------------------------------------------------------------
+- (void) testStoredMoveSuggestionIsReused
+{
+  GoNode* currentNode = m_game.boardPosition.currentNode;
+  NSDictionary* moveSuggestion = [self moveSuggestionForColor:GoColorBlack vertex:@"D4"];
+  [currentNode storeMoveSuggestion:moveSuggestion komi:m_game.komi];
+
+  [self registerForNotification:computerPlayerGeneratedMoveSuggestion];
+  XCTAssertTrue([[[[ComputerSuggestMoveCommand alloc] initWithColor:GoColorBlack] autorelease] submit]);
+
+  XCTAssertEqual([self numberOfNotificationsReceived:computerPlayerGeneratedMoveSuggestion], 1);
+  XCTAssertEqual(m_game.reasonForComputerIsThinking, GoGameComputerIsThinkingReasonIsNotThinking);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that ComputerSuggestMoveCommand delivers the move suggestion
+/// of the node that is current after the user navigated back to a board
+/// position, and not the move suggestion of the node that was current before.
+// -----------------------------------------------------------------------------
+- (void) testStoredMoveSuggestionAfterNavigation
+{
+  GoNode* rootNode = m_game.boardPosition.currentNode;
+  [rootNode storeMoveSuggestion:[self moveSuggestionForColor:GoColorBlack vertex:@"D4"]
+                           komi:m_game.komi];
+
+  [m_game play:[m_game.board pointAtVertex:@"D4"]];
+  GoNode* nodeWithMove = m_game.boardPosition.currentNode;
+  XCTAssertNotEqual(nodeWithMove, rootNode);
+  [nodeWithMove storeMoveSuggestion:[self moveSuggestionForColor:GoColorWhite vertex:@"Q16"]
+                               komi:m_game.komi];
+
+  m_game.boardPosition.currentBoardPosition = 0;
+  XCTAssertEqual(m_game.boardPosition.currentNode, rootNode);
+
+  [self registerForNotification:computerPlayerGeneratedMoveSuggestion];
+  XCTAssertTrue([[[[ComputerSuggestMoveCommand alloc] initWithColor:GoColorBlack] autorelease] submit]);
+  XCTAssertEqual([self numberOfNotificationsReceived:computerPlayerGeneratedMoveSuggestion], 1);
+  XCTAssertEqual(m_game.reasonForComputerIsThinking, GoGameComputerIsThinkingReasonIsNotThinking);
+
+  m_game.boardPosition.currentBoardPosition = 1;
+  XCTAssertTrue([[[[ComputerSuggestMoveCommand alloc] initWithColor:GoColorWhite] autorelease] submit]);
+  XCTAssertEqual([self numberOfNotificationsReceived:computerPlayerGeneratedMoveSuggestion], 2);
+  XCTAssertEqual(m_game.reasonForComputerIsThinking, GoGameComputerIsThinkingReasonIsNotThinking);
+}
+
+@end
@@ -0,0 +1,109 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "DeferredDeallocationQueueTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoGame.h>
+#import <go/GoNode.h>
+#import <go/GoNodeModel.h>
+#import <go/GoUtilities.h>
+#import <shared/DeferredDeallocationQueue.h>
+
+
+@implementation DeferredDeallocationQueueTest
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the releaseObjectsWhenIdle:() method.
+// -----------------------------------------------------------------------------
+- (void) testReleaseObjectsWhenIdle
+{
+  DeferredDeallocationQueue* queue = [DeferredDeallocationQueue sharedQueue];
+  [queue releaseAllPendingObjects];
+  XCTAssertEqual(queue.numberOfPendingObjects, 0);
+
+  NSObject* object = [[NSObject alloc] init];
+  NSUInteger retainCount = object.retainCount;
+  [queue releaseObjectsWhenIdle:@[object]];
+  XCTAssertEqual(queue.numberOfPendingObjects, 1);
+  XCTAssertEqual(object.retainCount, retainCount + 1);
+
+  [queue releaseObjectsWhenIdle:@[]];
+  XCTAssertEqual(queue.numberOfPendingObjects, 1);
+
+  // Let the main run loop go idle so that the run loop observer gets a chance
+  // to release the object
+  NSDate* timeoutDate = [NSDate dateWithTimeIntervalSinceNow:5.0];
+  while (queue.numberOfPendingObjects > 0 && [timeoutDate timeIntervalSinceNow] > 0)
+    [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+  XCTAssertEqual(queue.numberOfPendingObjects, 0);
+  XCTAssertEqual(object.retainCount, retainCount);
+  [object release];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the releaseAllPendingObjects() method.
+// -----------------------------------------------------------------------------
+- (void) testReleaseAllPendingObjects
+{
+  DeferredDeallocationQueue* queue = [DeferredDeallocationQueue sharedQueue];
+  [queue releaseAllPendingObjects];
+
+  NSObject* object1 = [[NSObject alloc] init];
+  NSObject* object2 = [[NSObject alloc] init];
+  NSUInteger retainCount = object1.retainCount;
+  [queue releaseObjectsWhenIdle:@[object1, object2]];
+  XCTAssertEqual(queue.numberOfPendingObjects, 2);
+
+  [queue releaseAllPendingObjects];
+  XCTAssertEqual(queue.numberOfPendingObjects, 0);
+  XCTAssertEqual(object1.retainCount, retainCount);
+  XCTAssertEqual(object2.retainCount, retainCount);
+  [object1 release];
+  [object2 release];
+
+  // Must not crash if nothing is pending
+  [queue releaseAllPendingObjects];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the GoUtilities method that prepares a game for handover
+/// to DeferredDeallocationQueue.
+// -----------------------------------------------------------------------------
+- (void) testObjectsInDeallocationOrderForGame
+{
+  [m_game play:[m_game.board pointAtVertex:@"A1"]];
+  [m_game play:[m_game.board pointAtVertex:@"B1"]];
+
+  NSArray* objects = [GoUtilities objectsInDeallocationOrderForGame:m_game];
+  XCTAssertEqual(objects.count, 4);
+  XCTAssertEqual(objects[0], m_game);
+  GoNode* rootNode = m_game.nodeModel.rootNode;
+  XCTAssertEqual(objects[1], rootNode);
+  XCTAssertEqual(objects[2], rootNode.firstChild);
+  XCTAssertEqual(objects[3], rootNode.firstChild.firstChild);
+
+  objects = [GoUtilities objectsInDeallocationOrderForSubtree:rootNode.firstChild];
+  XCTAssertEqual(objects.count, 2);
+  XCTAssertEqual(objects[0], rootNode.firstChild);
+
+  XCTAssertEqual([GoUtilities objectsInDeallocationOrderForGame:nil].count, 0);
+}
+
+@end
@@ -35,5 +35,8 @@
 - (void) testIsLastPosition;
 - (void) testNumberOfBoardPositions;
 - (void) testBoardPositionChangeProgress;
+- (void) testBoardSnapshots;
+- (void) testFinishChangedPointsBatch;
+- (void) testBoardPositionPreview;
 
 @end
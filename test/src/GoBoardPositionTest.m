@@ -21,6 +21,7 @@
 // Application includes
 #import <go/GoBoard.h>
 #import <go/GoBoardPosition.h>
+#import <go/GoBoardPositionPreview.h>
 #import <go/GoGame.h>
 #import <go/GoGameAdditions.h>
 #import <go/GoNode.h>
@@ -356,9 +357,144 @@
   [center removeObserver:self];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Verifies that jumps between distant board positions that restore a
+/// board snapshot result in the same board state as replaying all nodes.
+// -----------------------------------------------------------------------------
+- (void) testBoardSnapshots
+{
+  GoBoardPosition* boardPosition = m_game.boardPosition;
+  GoNodeModel* nodeModel = m_game.nodeModel;
+  GoBoard* board = m_game.board;
+
+  // Play moves without snapshots and record the reference board state after
+  // each move. Move 3 captures a stone.
+  nodeModel.boardSnapshotInterval = 0;
+  NSArray* vertices = @[@"B1", @"A1", @"A2", @"D4", @"E5", @"F6", @"G7", @"H8"];
+  NSMutableArray* referenceSnapshots = [NSMutableArray arrayWithObject:[board stoneStateSnapshot]];
+  NSMutableArray* referenceNumberOfRegions = [NSMutableArray arrayWithObject:[NSNumber numberWithUnsignedInteger:board.regions.count]];
+  for (NSString* vertex in vertices)
+  {
+    [m_game play:[board pointAtVertex:vertex]];
+    [referenceSnapshots addObject:[board stoneStateSnapshot]];
+    [referenceNumberOfRegions addObject:[NSNumber numberWithUnsignedInteger:board.regions.count]];
+  }
+
+  // Going back to the start and forward again creates the snapshots
+  nodeModel.boardSnapshotInterval = 2;
+  boardPosition.currentBoardPosition = 0;
+  boardPosition.currentBoardPosition = 8;
+  XCTAssertEqual(6, [nodeModel indexOfBoardSnapshotNearestToIndex:7]);
+
+  NSNotificationCenter* center = [NSNotificationCenter defaultCenter];
+  [center addObserver:self selector:@selector(boardPositionChangeProgress:) name:boardPositionChangeProgress object:nil];
+
+  // Jumps forward and backward, with and without snapshot
+  NSArray* newBoardPositions = @[@1, @7, @3, @8, @0, @6, @2];
+  for (NSNumber* newBoardPositionAsNumber in newBoardPositions)
+  {
+    int oldBoardPosition = boardPosition.currentBoardPosition;
+    int newBoardPosition = newBoardPositionAsNumber.intValue;
+    self.numberOfNotificationsReceived = 0;
+    boardPosition.currentBoardPosition = newBoardPosition;
+    XCTAssertEqual(abs(newBoardPosition - oldBoardPosition), self.numberOfNotificationsReceived);
+    XCTAssertEqualObjects(referenceSnapshots[newBoardPosition], [board stoneStateSnapshot]);
+    XCTAssertEqual([referenceNumberOfRegions[newBoardPosition] unsignedIntegerValue], board.regions.count);
+  }
+
+  [center removeObserver:self];
+
+  // The GoMove objects must still be usable for undoing the moves one by one
+  for (int newBoardPosition = boardPosition.currentBoardPosition + 1; newBoardPosition <= 8; ++newBoardPosition)
+    boardPosition.currentBoardPosition = newBoardPosition;
+  for (int newBoardPosition = 7; newBoardPosition >= 0; --newBoardPosition)
+  {
+    boardPosition.currentBoardPosition = newBoardPosition;
+    XCTAssertEqualObjects(referenceSnapshots[newBoardPosition], [board stoneStateSnapshot]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the finishChangedPointsBatch() method.
+// -----------------------------------------------------------------------------
+- (void) testFinishChangedPointsBatch
+{
+  GoBoardPosition* boardPosition = m_game.boardPosition;
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+
+  XCTAssertEqual(0, [boardPosition finishChangedPointsBatch].count);
+
+  // Move 3 captures a stone
+  [m_game play:pointB1];
+  [m_game play:pointA1];
+  [m_game play:pointA2];
+  NSSet* changedPoints = [NSSet setWithArray:[boardPosition finishChangedPointsBatch]];
+  NSSet* expectedChangedPoints = [NSSet setWithObjects:pointA1, pointA2, pointB1, nil];
+  XCTAssertEqualObjects(expectedChangedPoints, changedPoints);
+  XCTAssertEqual(0, [boardPosition finishChangedPointsBatch].count);
+
+  // Board position change that reverts the capture
+  boardPosition.currentBoardPosition = 2;
+  changedPoints = [NSSet setWithArray:[boardPosition finishChangedPointsBatch]];
+  expectedChangedPoints = [NSSet setWithObjects:pointA1, pointA2, nil];
+  XCTAssertEqualObjects(expectedChangedPoints, changedPoints);
+
+  // Several board position changes are combined into one batch
+  boardPosition.currentBoardPosition = 1;
+  boardPosition.currentBoardPosition = 2;
+  changedPoints = [NSSet setWithArray:[boardPosition finishChangedPointsBatch]];
+  expectedChangedPoints = [NSSet setWithObjects:pointA1, nil];
+  XCTAssertEqualObjects(expectedChangedPoints, changedPoints);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Verifies that GoBoardPositionPreview returns the same stone states
+/// as changing the current board position, without changing it.
+// -----------------------------------------------------------------------------
+- (void) testBoardPositionPreview
+{
+  GoBoardPosition* boardPosition = m_game.boardPosition;
+  GoNodeModel* nodeModel = m_game.nodeModel;
+  GoBoard* board = m_game.board;
+
+  // Move 3 captures a stone
+  nodeModel.boardSnapshotInterval = 2;
+  NSArray* vertices = @[@"B1", @"A1", @"A2", @"D4", @"E5", @"F6", @"G7", @"H8"];
+  NSMutableArray* referenceSnapshots = [NSMutableArray arrayWithObject:[board stoneStateSnapshot]];
+  for (NSString* vertex in vertices)
+  {
+    [m_game play:[board pointAtVertex:vertex]];
+    [referenceSnapshots addObject:[board stoneStateSnapshot]];
+  }
+  boardPosition.currentBoardPosition = 0;
+  boardPosition.currentBoardPosition = 4;
+
+  GoBoardPositionPreview* preview = [[[GoBoardPositionPreview alloc] initWithGame:m_game] autorelease];
+
+  // Previews forward and backward, starting from the current board position,
+  // from a snapshot, from the start of the game and from the previous preview
+  NSArray* previewBoardPositions = @[@5, @8, @1, @0, @3, @2, @7, @6];
+  for (NSNumber* previewBoardPositionAsNumber in previewBoardPositions)
+  {
+    int previewBoardPosition = previewBoardPositionAsNumber.intValue;
+    XCTAssertEqualObjects(referenceSnapshots[previewBoardPosition], [preview stoneStatesAtBoardPosition:previewBoardPosition]);
+    XCTAssertEqual(4, boardPosition.currentBoardPosition);
+    XCTAssertEqualObjects(referenceSnapshots[4], [board stoneStateSnapshot]);
+  }
+
+  XCTAssertThrowsSpecificNamed([preview stoneStatesAtBoardPosition:-1],
+                               NSException, NSRangeException, @"negative board position");
+  XCTAssertThrowsSpecificNamed([preview stoneStatesAtBoardPosition:9],
+                               NSException, NSRangeException, @"board position too high");
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Responds to the #boardPositionChangeProgress notification. This is
-/// a private helper for testBoardPositionChangeProgress().
+/// a private helper for testBoardPositionChangeProgress() and
+/// testBoardSnapshots().
 // -----------------------------------------------------------------------------
 - (void) boardPositionChangeProgress:(NSNotification*)notification
 {
@@ -36,6 +36,9 @@
 - (void) testIsStoneGroup;
 - (void) testColor;
 - (void) testLiberties;
+- (void) testLibertiesAfterCapture;
+- (void) testRegionSplitByStonePlacement;
+- (void) testRegionMergeOnCapture;
 - (void) testAdjacentRegions;
 - (void) testIsStoneConnectingSuicidalSubgroups;
 - (void) testScoringMode;
@@ -21,6 +21,7 @@
 // Application includes
 #import <go/GoGame.h>
 #import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
 #import <go/GoBoardRegion.h>
 #import <go/GoPoint.h>
 
@@ -379,6 +380,147 @@
                               NSException, NSInternalInconsistencyException, @"region is no stone group");
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the liberties() method when stones are captured, and when
+/// the capture is undone and redone.
+// -----------------------------------------------------------------------------
+- (void) testLibertiesAfterCapture
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+
+  [m_game play:pointB1];
+  XCTAssertEqual(3, [pointB1.region liberties]);
+  [m_game play:pointA1];
+  XCTAssertEqual(1, [pointA1.region liberties]);
+  XCTAssertEqual(2, [pointB1.region liberties]);
+
+  // Black captures the white stone on A1
+  [m_game play:pointA2];
+  XCTAssertEqual(3, [pointA2.region liberties]);
+  XCTAssertEqual(3, [pointB1.region liberties]);
+
+  // Undo the capture
+  m_game.boardPosition.currentBoardPosition = 2;
+  XCTAssertEqual(GoColorWhite, pointA1.stoneState);
+  XCTAssertEqual(1, [pointA1.region liberties]);
+  XCTAssertEqual(2, [pointB1.region liberties]);
+
+  // Redo the capture
+  m_game.boardPosition.currentBoardPosition = 3;
+  XCTAssertEqual(GoColorNone, pointA1.stoneState);
+  XCTAssertEqual(3, [pointA2.region liberties]);
+  XCTAssertEqual(3, [pointB1.region liberties]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that placing a stone splits an empty region, and that
+/// removing the stone joins the split regions again. Also checks the size and
+/// color of the regions after each step.
+// -----------------------------------------------------------------------------
+- (void) testRegionSplitByStonePlacement
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointT19 = [board pointAtVertex:@"T19"];
+  GoPoint* pointK10 = [board pointAtVertex:@"K10"];
+
+  [m_game play:pointB1];
+  [m_game play:pointT19];
+  XCTAssertEqual(pointA1.region, pointK10.region);
+  XCTAssertEqual(359, [pointA1.region size]);
+
+  // Black cuts off the corner point A1 from the rest of the empty board
+  [m_game play:pointA2];
+  GoBoardRegion* cornerRegion = pointA1.region;
+  GoBoardRegion* mainRegion = pointK10.region;
+  XCTAssertTrue(cornerRegion != mainRegion);
+  XCTAssertEqual(1, [cornerRegion size]);
+  XCTAssertEqual(GoColorNone, [cornerRegion color]);
+  XCTAssertFalse([cornerRegion isStoneGroup]);
+  XCTAssertEqual(357, [mainRegion size]);
+  XCTAssertEqual(GoColorNone, [mainRegion color]);
+  XCTAssertEqual(1, [pointA2.region size]);
+  XCTAssertEqual(GoColorBlack, [pointA2.region color]);
+  XCTAssertEqual(1, [pointT19.region size]);
+  XCTAssertEqual(GoColorWhite, [pointT19.region color]);
+
+  // Taking back the cutting stone joins the two empty regions again
+  m_game.boardPosition.currentBoardPosition = 2;
+  XCTAssertEqual(pointA1.region, pointK10.region);
+  XCTAssertEqual(pointA1.region, pointA2.region);
+  XCTAssertEqual(359, [pointA1.region size]);
+  XCTAssertEqual(GoColorNone, [pointA1.region color]);
+
+  // Redoing the move splits the empty region again
+  m_game.boardPosition.currentBoardPosition = 3;
+  XCTAssertTrue(pointA1.region != pointK10.region);
+  XCTAssertEqual(1, [pointA1.region size]);
+  XCTAssertEqual(357, [pointK10.region size]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that a capturing stone merges the stone groups it connects,
+/// that the captured stones become an empty region of their own, and that
+/// undoing the capture restores the previous regions. Also checks the size and
+/// color of the regions after each step.
+// -----------------------------------------------------------------------------
+- (void) testRegionMergeOnCapture
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointB2 = [board pointAtVertex:@"B2"];
+  GoPoint* pointC1 = [board pointAtVertex:@"C1"];
+  GoPoint* pointK10 = [board pointAtVertex:@"K10"];
+
+  [m_game play:pointA2];
+  [m_game play:pointA1];
+  [m_game play:pointC1];
+  [m_game play:pointB1];
+  XCTAssertEqual(pointA1.region, pointB1.region);
+  XCTAssertEqual(2, [pointA1.region size]);
+  XCTAssertEqual(GoColorWhite, [pointA1.region color]);
+  XCTAssertEqual(1, [pointA1.region liberties]);
+  XCTAssertEqual(1, [pointA2.region size]);
+  XCTAssertEqual(357, [pointK10.region size]);
+
+  // Black captures the two white stones and connects to the stone on A2
+  [m_game play:pointB2];
+  GoBoardRegion* blackRegion = pointB2.region;
+  XCTAssertEqual(blackRegion, pointA2.region);
+  XCTAssertEqual(2, [blackRegion size]);
+  XCTAssertEqual(GoColorBlack, [blackRegion color]);
+  XCTAssertEqual(5, [blackRegion liberties]);
+  XCTAssertTrue(blackRegion != pointC1.region);
+  XCTAssertEqual(1, [pointC1.region size]);
+  XCTAssertEqual(GoColorBlack, [pointC1.region color]);
+  // The captured stones are surrounded by black stones, so they form an empty
+  // region of their own
+  GoBoardRegion* capturedRegion = pointA1.region;
+  XCTAssertEqual(capturedRegion, pointB1.region);
+  XCTAssertTrue(capturedRegion != pointK10.region);
+  XCTAssertEqual(2, [capturedRegion size]);
+  XCTAssertEqual(GoColorNone, [capturedRegion color]);
+  XCTAssertEqual(356, [pointK10.region size]);
+
+  // Undo the capture
+  m_game.boardPosition.currentBoardPosition = 4;
+  XCTAssertTrue(pointA2.region != pointB2.region);
+  XCTAssertEqual(1, [pointA2.region size]);
+  XCTAssertEqual(GoColorBlack, [pointA2.region color]);
+  XCTAssertEqual(pointA1.region, pointB1.region);
+  XCTAssertEqual(2, [pointA1.region size]);
+  XCTAssertEqual(GoColorWhite, [pointA1.region color]);
+  XCTAssertEqual(pointB2.region, pointK10.region);
+  XCTAssertEqual(357, [pointK10.region size]);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the adjacentRegions() method.
 // -----------------------------------------------------------------------------
@@ -33,9 +33,12 @@
 - (void) testStringForSize;
 - (void) testPointEnumerator;
 - (void) testPointAtVertex;
+- (void) testPointAtIndex;
 - (void) testNeighbourOfInDirection;
 - (void) testPointAtCorner;
 - (void) testStarPoints;
 - (void) testRegions;
+- (void) testBoardStateQueries;
+- (void) testStonesWithoutLiberties;
 
 @end
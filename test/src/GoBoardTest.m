@@ -21,6 +21,8 @@
 // Application includes
 #import <go/GoGame.h>
 #import <go/GoBoard.h>
+#import <go/GoBoardRegion.h>
+#import <go/GoBoardTopology.h>
 #import <go/GoPoint.h>
 #import <go/GoVertex.h>
 #import <main/ApplicationDelegate.h>
@@ -144,6 +146,56 @@
                               NSException, NSInvalidArgumentException, @"nil used for vertex");
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the pointAtNumericVertex:() method.
+// -----------------------------------------------------------------------------
+- (void) testPointAtNumericVertex
+{
+  GoBoard* board = m_game.board;
+  struct GoVertexNumeric numericVertex;
+
+  // A few valid vertexes
+  numericVertex.x = 1;
+  numericVertex.y = 1;
+  XCTAssertEqual([board pointAtNumericVertex:numericVertex], [board pointAtVertex:@"A1"], @"A1");
+  numericVertex.x = 9;
+  numericVertex.y = 4;
+  XCTAssertEqual([board pointAtNumericVertex:numericVertex], [board pointAtVertex:@"J4"], @"J4");
+  numericVertex.x = 19;
+  numericVertex.y = 19;
+  XCTAssertEqual([board pointAtNumericVertex:numericVertex], [board pointAtVertex:@"T19"], @"T19");
+
+  // A few invalid vertexes
+  numericVertex.x = 0;
+  numericVertex.y = 1;
+  XCTAssertNil([board pointAtNumericVertex:numericVertex], @"x = 0");
+  numericVertex.x = 1;
+  numericVertex.y = 20;
+  XCTAssertNil([board pointAtNumericVertex:numericVertex], @"y = 20");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the pointAtIndex:() method.
+// -----------------------------------------------------------------------------
+- (void) testPointAtIndex
+{
+  GoBoard* board = m_game.board;
+
+  // A few valid indexes
+  XCTAssertEqual([board pointAtIndex:0], [board pointAtVertex:@"A1"], @"A1");
+  XCTAssertEqual([board pointAtIndex:1], [board pointAtVertex:@"B1"], @"B1");
+  XCTAssertEqual([board pointAtIndex:19], [board pointAtVertex:@"A2"], @"A2");
+  XCTAssertEqual([board pointAtIndex:360], [board pointAtVertex:@"T19"], @"T19");
+
+  // Round trip for all points
+  for (GoPoint* point = [board pointAtVertex:@"A1"]; point != nil; point = point.next)
+    XCTAssertEqual([board pointAtIndex:[board indexOfPoint:point]], point, @"%@", point.vertex.string);
+
+  // A few invalid indexes
+  XCTAssertNil([board pointAtIndex:-1], @"index = -1");
+  XCTAssertNil([board pointAtIndex:361], @"index = 361");
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the neighbourOf:inDirection() method.
 // -----------------------------------------------------------------------------
@@ -243,6 +295,48 @@
   XCTAssertEqual(expectedNumberOfStarPoints, starPoints.count);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the @e topology property.
+// -----------------------------------------------------------------------------
+- (void) testTopology
+{
+  GoBoard* board = m_game.board;
+  GoBoardTopology* topology = board.topology;
+  XCTAssertNotNil(topology);
+  XCTAssertEqual(topology, [GoBoardTopology sharedTopologyForBoardSize:board.size]);
+  XCTAssertEqual(topology, [GoBoard boardWithSize:board.size].topology);
+  XCTAssertNotEqual(topology, [GoBoardTopology sharedTopologyForBoardSize:GoBoardSize9]);
+  XCTAssertEqual(board.size, topology.boardSize);
+  XCTAssertEqual(board.size * board.size, topology.numberOfPoints);
+  XCTAssertEqual(board.starPoints.count, topology.starPointIndexes.count);
+
+  // Boards of the same size share vertexes
+  GoPoint* point = [board pointAtVertex:@"C4"];
+  int index = [board indexOfPoint:point];
+  XCTAssertEqual(point.vertex, [topology vertexAtIndex:index]);
+  XCTAssertEqual(point.vertex, [[GoBoard boardWithSize:board.size] pointAtVertex:@"C4"].vertex);
+
+  XCTAssertEqual([board indexOfPoint:point.left], [topology indexOfNeighbourOfIndex:index inDirection:GoBoardDirectionLeft]);
+  XCTAssertEqual([board indexOfPoint:point.above], [topology indexOfNeighbourOfIndex:index inDirection:GoBoardDirectionUp]);
+  XCTAssertEqual(-1, [topology indexOfNeighbourOfIndex:0 inDirection:GoBoardDirectionLeft]);
+  XCTAssertEqual(-1, [topology indexOfNeighbourOfIndex:0 inDirection:GoBoardDirectionPrevious]);
+  XCTAssertEqual(-1, [topology indexOfNeighbourOfIndex:topology.numberOfPoints - 1 inDirection:GoBoardDirectionNext]);
+
+  XCTAssertFalse([topology isEdgeAtIndex:index]);
+  XCTAssertFalse([topology isCornerAtIndex:index]);
+  int indexOfEdge = [board indexOfPoint:[board pointAtVertex:@"A4"]];
+  XCTAssertTrue([topology isEdgeAtIndex:indexOfEdge]);
+  XCTAssertFalse([topology isCornerAtIndex:indexOfEdge]);
+  int indexOfCorner = [topology indexOfCorner:GoBoardCornerTopRight];
+  XCTAssertEqual([board pointAtCorner:GoBoardCornerTopRight], [board pointAtIndex:indexOfCorner]);
+  XCTAssertTrue([topology isEdgeAtIndex:indexOfCorner]);
+  XCTAssertTrue([topology isCornerAtIndex:indexOfCorner]);
+
+  for (GoPoint* starPoint in board.starPoints)
+    XCTAssertTrue([topology isStarPointAtIndex:[board indexOfPoint:starPoint]]);
+  XCTAssertFalse([topology isStarPointAtIndex:0]);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the @e regions property.
 // -----------------------------------------------------------------------------
@@ -263,6 +357,295 @@
   XCTAssertEqual(expectedNumberOfRegions, m_game.board.regions.count);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the board state query methods.
+// -----------------------------------------------------------------------------
+- (void) testBoardStateQueries
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointB2 = [board pointAtVertex:@"B2"];
+
+  XCTAssertEqual(2, [board numberOfEmptyNeighboursOfPoint:pointA1]);
+  XCTAssertEqual(0, [board numberOfLibertiesOfStoneGroupAtPoint:pointA1]);
+  XCTAssertEqual(0, [board numberOfStonesWithColor:GoColorBlack]);
+  XCTAssertEqual(0, [board numberOfStonesWithColor:GoColorWhite]);
+  XCTAssertThrowsSpecificNamed([board numberOfStonesWithColor:GoColorNone],
+                               NSException, NSInvalidArgumentException, @"GoColorNone");
+
+  [m_game play:pointB1];  // black
+  [m_game play:pointA1];  // white
+  XCTAssertEqual(1, [board numberOfStonesWithColor:GoColorBlack]);
+  XCTAssertEqual(1, [board numberOfStonesWithColor:GoColorWhite]);
+  XCTAssertEqual(1, [board numberOfEmptyNeighboursOfPoint:pointA2]);
+  XCTAssertEqual(1, [board numberOfLibertiesOfStoneGroupAtPoint:pointA1]);
+  XCTAssertEqual(2, [board numberOfLibertiesOfStoneGroupAtPoint:pointB1]);
+
+  NSArray* capturedStones = [board stonesCapturedByStoneWithColor:GoColorBlack atPoint:pointA2];
+  XCTAssertEqual(1, capturedStones.count);
+  XCTAssertEqual(pointA1, capturedStones.firstObject);
+  capturedStones = [board stonesCapturedByStoneWithColor:GoColorWhite atPoint:pointA2];
+  XCTAssertEqual(0, capturedStones.count);
+
+  bool simpleKoIsPossible = true;
+  XCTAssertFalse([board isSuicideMoveAtPoint:pointB2 byColor:GoColorWhite simpleKoIsPossible:&simpleKoIsPossible]);
+  XCTAssertFalse(simpleKoIsPossible);
+
+  [m_game play:pointA2];  // black captures
+  XCTAssertEqual(GoColorNone, pointA1.stoneState);
+  XCTAssertEqual(2, [board numberOfStonesWithColor:GoColorBlack]);
+  XCTAssertEqual(0, [board numberOfStonesWithColor:GoColorWhite]);
+  XCTAssertEqual(0, [board numberOfEmptyNeighboursOfPoint:pointA1]);
+  XCTAssertTrue([board isSuicideMoveAtPoint:pointA1 byColor:GoColorWhite simpleKoIsPossible:&simpleKoIsPossible]);
+  XCTAssertFalse([board isSuicideMoveAtPoint:pointA1 byColor:GoColorBlack simpleKoIsPossible:&simpleKoIsPossible]);
+  XCTAssertFalse(simpleKoIsPossible);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the stonesWithoutLiberties() method.
+// -----------------------------------------------------------------------------
+- (void) testStonesWithoutLiberties
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointB2 = [board pointAtVertex:@"B2"];
+  GoPoint* pointC1 = [board pointAtVertex:@"C1"];
+
+  XCTAssertEqual(0, [board stonesWithoutLiberties].count);
+
+  // Setting the stone state directly, as during board setup, bypasses all
+  // legality checks
+  pointA1.stoneState = GoColorBlack;
+  pointB1.stoneState = GoColorBlack;
+  pointA2.stoneState = GoColorWhite;
+  XCTAssertEqual(0, [board stonesWithoutLiberties].count);
+
+  // The black stone group A1/B1 loses its last liberty
+  pointC1.stoneState = GoColorWhite;
+  pointB2.stoneState = GoColorWhite;
+  NSArray* expectedStones = @[pointA1, pointB1];
+  XCTAssertEqualObjects(expectedStones, [board stonesWithoutLiberties]);
+  // Repeated queries without changes must return the same result
+  XCTAssertEqualObjects(expectedStones, [board stonesWithoutLiberties]);
+
+  // Removing one of the surrounding stones gives back a liberty
+  pointC1.stoneState = GoColorNone;
+  XCTAssertEqual(0, [board stonesWithoutLiberties].count);
+
+  // Removing one stone of the group while the group has no liberties
+  pointC1.stoneState = GoColorWhite;
+  XCTAssertEqual(2, [board stonesWithoutLiberties].count);
+  pointB1.stoneState = GoColorNone;
+  XCTAssertEqual(0, [board stonesWithoutLiberties].count);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the stonesInAtariWithColor:() and
+/// stonesWithColor:inAtariWithLibertyAtPoint:() methods.
+// -----------------------------------------------------------------------------
+- (void) testStonesInAtari
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointB2 = [board pointAtVertex:@"B2"];
+  GoPoint* pointC1 = [board pointAtVertex:@"C1"];
+
+  XCTAssertEqual(0, [board stonesInAtariWithColor:GoColorBlack].count);
+  XCTAssertEqual(0, [board stonesInAtariWithColor:GoColorWhite].count);
+
+  // The black stone group A1/B1 has the liberties A2 and C1
+  pointA1.stoneState = GoColorBlack;
+  pointB1.stoneState = GoColorBlack;
+  pointB2.stoneState = GoColorWhite;
+  XCTAssertEqual(0, [board stonesInAtariWithColor:GoColorBlack].count);
+  XCTAssertEqual(0, [board stonesWithColor:GoColorBlack inAtariWithLibertyAtPoint:pointA2].count);
+
+  // The black stone group A1/B1 is left with the single liberty A2
+  pointC1.stoneState = GoColorWhite;
+  NSArray* expectedStones = @[pointA1, pointB1];
+  XCTAssertEqualObjects(expectedStones, [board stonesInAtariWithColor:GoColorBlack]);
+  XCTAssertEqual(0, [board stonesInAtariWithColor:GoColorWhite].count);
+  XCTAssertEqualObjects(expectedStones, [board stonesWithColor:GoColorBlack inAtariWithLibertyAtPoint:pointA2]);
+  XCTAssertEqual(0, [board stonesWithColor:GoColorWhite inAtariWithLibertyAtPoint:pointA2].count);
+  XCTAssertEqualObjects(expectedStones, [board stonesCapturedByStoneWithColor:GoColorWhite atPoint:pointA2]);
+
+  // Capturing the group removes it from the atari index
+  pointA2.stoneState = GoColorWhite;
+  XCTAssertEqualObjects(expectedStones, [board stonesCapturedByStoneWithColor:GoColorWhite atPoint:pointA2]);
+  pointA1.stoneState = GoColorNone;
+  pointB1.stoneState = GoColorNone;
+  XCTAssertEqual(0, [board stonesInAtariWithColor:GoColorBlack].count);
+  XCTAssertEqual(0, [board stonesInAtariWithColor:GoColorWhite].count);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the isStoneGroupAtPointCapturableInLadder:() and
+/// capturableStonesWithNextMoveColor:() methods.
+// -----------------------------------------------------------------------------
+- (void) testTacticalReading
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointK10 = [board pointAtVertex:@"K10"];
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+
+  XCTAssertThrowsSpecificNamed([board isStoneGroupAtPointCapturableInLadder:pointK10],
+                               NSException, NSInvalidArgumentException, @"point without stone");
+  XCTAssertThrowsSpecificNamed([board capturableStonesWithNextMoveColor:GoColorNone],
+                               NSException, NSInvalidArgumentException, @"GoColorNone");
+
+  // The white stone K10 has two liberties and runs in a ladder towards the
+  // upper-right corner
+  pointK10.stoneState = GoColorWhite;
+  [board pointAtVertex:@"J10"].stoneState = GoColorBlack;
+  [board pointAtVertex:@"K9"].stoneState = GoColorBlack;
+  [board pointAtVertex:@"L9"].stoneState = GoColorBlack;
+  XCTAssertTrue([board isStoneGroupAtPointCapturableInLadder:pointK10]);
+  NSArray* expectedStones = @[pointK10];
+  XCTAssertEqualObjects(expectedStones, [board capturableStonesWithNextMoveColor:GoColorBlack]);
+  XCTAssertEqual(0, [board capturableStonesWithNextMoveColor:GoColorWhite].count);
+
+  // A white stone on the ladder's path breaks the ladder
+  [board pointAtVertex:@"Q16"].stoneState = GoColorWhite;
+  XCTAssertFalse([board isStoneGroupAtPointCapturableInLadder:pointK10]);
+
+  // A stone in atari that cannot escape is capturable for both sides to move
+  pointA1.stoneState = GoColorWhite;
+  [board pointAtVertex:@"A2"].stoneState = GoColorBlack;
+  expectedStones = @[pointA1];
+  XCTAssertEqualObjects(expectedStones, [board capturableStonesWithNextMoveColor:GoColorBlack]);
+  XCTAssertEqualObjects(expectedStones, [board capturableStonesWithNextMoveColor:GoColorWhite]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the territoryMapWithScoringSystem:() method.
+// -----------------------------------------------------------------------------
+- (void) testTerritoryMap
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointK10 = [board pointAtVertex:@"K10"];
+  GoPoint* pointT19 = [board pointAtVertex:@"T19"];
+
+  [m_game play:pointB1];   // black
+  [m_game play:pointT19];  // white
+  [m_game play:pointA2];   // black
+
+  // All stones alive: A1 is surrounded by black, the rest of the board is dame
+  NSData* territoryMap = [board territoryMapWithScoringSystem:GoScoringSystemAreaScoring];
+  XCTAssertEqual(board.size * board.size, territoryMap.length);
+  const unsigned char* territoryMapEntries = territoryMap.bytes;
+  XCTAssertEqual(GoColorBlack, territoryMapEntries[[board indexOfPoint:pointA1]]);
+  XCTAssertEqual(GoColorBlack, territoryMapEntries[[board indexOfPoint:pointB1]]);
+  XCTAssertEqual(GoColorWhite, territoryMapEntries[[board indexOfPoint:pointT19]]);
+  XCTAssertEqual(GoColorNone, territoryMapEntries[[board indexOfPoint:pointK10]]);
+
+  // White stone dead: The entire board belongs to black
+  pointT19.region.stoneGroupState = GoStoneGroupStateDead;
+  territoryMap = [board territoryMapWithScoringSystem:GoScoringSystemAreaScoring];
+  territoryMapEntries = territoryMap.bytes;
+  XCTAssertEqual(GoColorBlack, territoryMapEntries[[board indexOfPoint:pointT19]]);
+  XCTAssertEqual(GoColorBlack, territoryMapEntries[[board indexOfPoint:pointK10]]);
+
+  // White stone in seki next to alive black stones is inconsistent. Under
+  // territory scoring the white stone itself is neutral.
+  pointT19.region.stoneGroupState = GoStoneGroupStateSeki;
+  territoryMap = [board territoryMapWithScoringSystem:GoScoringSystemTerritoryScoring];
+  territoryMapEntries = territoryMap.bytes;
+  XCTAssertEqual(GoColorNone, territoryMapEntries[[board indexOfPoint:pointT19]]);
+  XCTAssertEqual(GoColorNone | GoTerritoryMapEntryInconsistentFlag, territoryMapEntries[[board indexOfPoint:pointK10]]);
+  XCTAssertEqual(GoColorBlack, territoryMapEntries[[board indexOfPoint:pointA1]]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the stonesInSeki() method.
+// -----------------------------------------------------------------------------
+- (void) testStonesInSeki
+{
+  GoBoard* board = m_game.board;
+
+  // No stones, no seki
+  XCTAssertEqual(0, [board stonesInSeki].count);
+
+  // A black group and a single white stone share the liberties A1 and C1,
+  // enclosed by a white wall. Neither side can fill a shared liberty without
+  // putting itself into atari.
+  NSArray* blackVertexes = @[@"A2", @"B2", @"C2", @"D2", @"D1"];
+  NSArray* whiteVertexes = @[@"B1", @"E1", @"E2", @"A3", @"B3", @"C3", @"D3", @"E3",
+                             @"A4", @"B4", @"C4", @"D4", @"E4", @"F4"];
+  for (NSString* vertex in blackVertexes)
+    [m_game changeSetupPoint:[board pointAtVertex:vertex] toStoneState:GoColorBlack];
+  for (NSString* vertex in whiteVertexes)
+    [m_game changeSetupPoint:[board pointAtVertex:vertex] toStoneState:GoColorWhite];
+
+  NSArray* stonesInSeki = [board stonesInSeki];
+  XCTAssertEqual(blackVertexes.count + 1, stonesInSeki.count);
+  for (NSString* vertex in blackVertexes)
+    XCTAssertTrue([stonesInSeki containsObject:[board pointAtVertex:vertex]]);
+  XCTAssertTrue([stonesInSeki containsObject:[board pointAtVertex:@"B1"]]);
+  XCTAssertFalse([stonesInSeki containsObject:[board pointAtVertex:@"E1"]]);
+
+  // If the white stone is dead the black group has an eye, and there is no
+  // seki anymore
+  [board pointAtVertex:@"B1"].region.stoneGroupState = GoStoneGroupStateDead;
+  XCTAssertEqual(0, [board stonesInSeki].count);
+
+  // If White fills the shared liberty C1 the black group is in atari, and
+  // there is no seki anymore
+  [board pointAtVertex:@"B1"].region.stoneGroupState = GoStoneGroupStateAlive;
+  [m_game changeSetupPoint:[board pointAtVertex:@"C1"] toStoneState:GoColorWhite];
+  XCTAssertEqual(0, [board stonesInSeki].count);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the
+/// accumulateTerritoryStatisticsScores:lastMovePoint:zobristHash:previousZobristHash:()
+/// and resetTerritoryStatisticsScores() methods.
+// -----------------------------------------------------------------------------
+- (void) testTerritoryStatistics
+{
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointB2 = [board pointAtVertex:@"B2"];
+  GoPoint* pointK10 = [board pointAtVertex:@"K10"];
+  int numberOfPoints = board.size * board.size;
+  float blackScores[GoBoardSizeMax * GoBoardSizeMax];
+  float whiteScores[GoBoardSizeMax * GoBoardSizeMax];
+  for (int index = 0; index < numberOfPoints; ++index)
+  {
+    blackScores[index] = 1.0f;
+    whiteScores[index] = -1.0f;
+  }
+
+  // Without a prior the scores are taken over
+  [board accumulateTerritoryStatisticsScores:blackScores lastMovePoint:nil zobristHash:1 previousZobristHash:0];
+  XCTAssertEqual(1.0f, pointA1.territoryStatisticsScore);
+  XCTAssertEqual(1.0f, pointK10.territoryStatisticsScore);
+
+  // The next board position: Only intersections near the last move take over
+  // the new scores, the others keep most of the prior
+  [board accumulateTerritoryStatisticsScores:whiteScores lastMovePoint:pointA1 zobristHash:2 previousZobristHash:1];
+  XCTAssertEqual(-1.0f, pointA1.territoryStatisticsScore);
+  XCTAssertEqual(-1.0f, pointB2.territoryStatisticsScore);
+  float expectedScore = 1.0f + (1.0f - territoryStatisticsPriorWeight) * (-1.0f - 1.0f);
+  XCTAssertEqualWithAccuracy(expectedScore, pointK10.territoryStatisticsScore, 0.0001f);
+
+  // An unrelated board position: The prior is discarded
+  [board accumulateTerritoryStatisticsScores:blackScores lastMovePoint:pointA1 zobristHash:42 previousZobristHash:41];
+  XCTAssertEqual(1.0f, pointK10.territoryStatisticsScore);
+
+  [board resetTerritoryStatisticsScores];
+  XCTAssertEqual(0.0f, pointA1.territoryStatisticsScore);
+  XCTAssertEqual(0.0f, pointK10.territoryStatisticsScore);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Internal helper that checks the initial state of @a board after
 /// its creation.
@@ -0,0 +1,117 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "GoGameEvaluationTimelineTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoGameEvaluationTimeline.h>
+
+
+@implementation GoGameEvaluationTimelineTest
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the evaluateGame:progressHandler:() method.
+// -----------------------------------------------------------------------------
+- (void) testEvaluateGame
+{
+  GoGameEvaluationTimeline* timeline = [[[GoGameEvaluationTimeline alloc] init] autorelease];
+  XCTAssertEqual(0, timeline.numberOfBoardPositions);
+  XCTAssertFalse(timeline.isEvaluating);
+
+  [m_game play:[m_game.board pointAtVertex:@"D4"]];
+  [m_game play:[m_game.board pointAtVertex:@"Q16"]];
+  [self evaluateGame:m_game withTimeline:timeline];
+
+  XCTAssertEqual(3, timeline.numberOfBoardPositions);
+  XCTAssertEqual(3, timeline.numberOfEvaluations);
+  XCTAssertFalse(timeline.isEvaluating);
+  // Empty board: No territory for anyone
+  XCTAssertEqual(-m_game.komi, [timeline blackLeadAtBoardPosition:0]);
+  // A single black stone owns the entire board
+  XCTAssertEqual(361 - m_game.komi, [timeline blackLeadAtBoardPosition:1]);
+  // After the white reply the empty area is neutral
+  XCTAssertEqual(-m_game.komi, [timeline blackLeadAtBoardPosition:2]);
+  XCTAssertFalse([timeline hasEvaluationAtBoardPosition:3]);
+  XCTAssertThrowsSpecificNamed([timeline blackLeadAtBoardPosition:3],
+                               NSException, NSRangeException, @"board position outside of game");
+
+  // Evaluations of earlier board positions are found in the cache
+  [m_game play:[m_game.board pointAtVertex:@"D5"]];
+  __block int numberOfProgressHandlerInvocations = 0;
+  [timeline evaluateGame:m_game progressHandler:^(void)
+  {
+    ++numberOfProgressHandlerInvocations;
+  }];
+  XCTAssertEqual(4, timeline.numberOfBoardPositions);
+  XCTAssertEqual(3, timeline.numberOfEvaluations);
+  XCTAssertTrue(timeline.isEvaluating);
+  [self waitUntilTimelineHasFinishedEvaluating:timeline];
+  XCTAssertEqual(1, numberOfProgressHandlerInvocations);
+  XCTAssertEqual(1 - m_game.komi, [timeline blackLeadAtBoardPosition:3]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the boardPositionsWithLargestSwings:() method.
+// -----------------------------------------------------------------------------
+- (void) testBoardPositionsWithLargestSwings
+{
+  GoGameEvaluationTimeline* timeline = [[[GoGameEvaluationTimeline alloc] init] autorelease];
+  XCTAssertEqualObjects(@[], [timeline boardPositionsWithLargestSwings:3]);
+
+  [m_game play:[m_game.board pointAtVertex:@"D4"]];
+  [m_game play:[m_game.board pointAtVertex:@"Q16"]];
+  [m_game play:[m_game.board pointAtVertex:@"D5"]];
+  [self evaluateGame:m_game withTimeline:timeline];
+
+  // Board positions 1 and 2 swing by the entire board, board position 3 by a
+  // single stone. Equal swings are ordered by board position.
+  NSArray* expectedBoardPositions = @[@1, @2];
+  XCTAssertEqualObjects(expectedBoardPositions, [timeline boardPositionsWithLargestSwings:2]);
+  expectedBoardPositions = @[@1, @2, @3];
+  XCTAssertEqualObjects(expectedBoardPositions, [timeline boardPositionsWithLargestSwings:10]);
+  XCTAssertEqualObjects(@[], [timeline boardPositionsWithLargestSwings:0]);
+}
+
+#pragma mark - Helper methods
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Evaluates @a game with @a timeline and waits until
+/// all evaluations are available.
+// -----------------------------------------------------------------------------
+- (void) evaluateGame:(GoGame*)game withTimeline:(GoGameEvaluationTimeline*)timeline
+{
+  [timeline evaluateGame:game progressHandler:^(void) {}];
+  [self waitUntilTimelineHasFinishedEvaluating:timeline];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Runs the main run loop until @a timeline has
+/// finished evaluating. Results are delivered via the main queue, so they are
+/// processed only while the run loop runs.
+// -----------------------------------------------------------------------------
+- (void) waitUntilTimelineHasFinishedEvaluating:(GoGameEvaluationTimeline*)timeline
+{
+  NSDate* timeoutDate = [NSDate dateWithTimeIntervalSinceNow:5.0];
+  while (timeline.isEvaluating && [timeoutDate timeIntervalSinceNow] > 0)
+    [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  XCTAssertFalse(timeline.isEvaluating);
+}
+
+@end
@@ -55,8 +55,10 @@
 - (void) testIsLegalBoardSetupAt;
 - (void) testIsLegalBoardSetup;
 - (void) testIsLegalMove;
+- (void) testLegalMoveMapForColor;
 - (void) testIsLegalMovePositionalSuperko;
 - (void) testIsLegalMoveSituationalSuperko;
+- (void) testIsLegalMoveSuperkoAfterBoardPositionChange;
 - (void) testIsLegalPassMoveIllegalReason;
 - (void) testEndGameDueToPassMovesIfGameRulesRequireIt;
 - (void) testRevertStateFromEndedToInProgress;
@@ -73,5 +75,6 @@
 - (void) testSetupAndSimpleKo;
 - (void) testSetupAndPositionalSuperko;
 - (void) testSetupAndSituationalSuperko;
+- (void) testSnapshotAtCurrentNode;
 
 @end
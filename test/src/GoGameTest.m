@@ -25,6 +25,7 @@
 #import <go/GoGame.h>
 #import <go/GoGameAdditions.h>
 #import <go/GoGameDocument.h>
+#import <go/GoGameSnapshot.h>
 #import <go/GoMove.h>
 #import <go/GoMoveAdditions.h>
 #import <go/GoMoveNodeCreationOptions.h>
@@ -38,6 +39,7 @@
 #import <go/GoPoint.h>
 #import <go/GoScore.h>
 #import <go/GoUtilities.h>
+#import <go/GoVertex.h>
 #import <command/game/NewGameCommand.h>
 #import <main/ApplicationDelegate.h>
 #import <newgame/NewGameModel.h>
@@ -151,7 +153,6 @@
 /// - board: GoBoard
 /// - region: GoBoardRegion
 ///   - points: NSMutableArray of GoPoint
-///   - cachedAdjacentRegions: NSArray of GoBoardRegion
 /// @endverbatim
 // -----------------------------------------------------------------------------
 - (void) testInitWithCoder
@@ -219,7 +220,7 @@
   // Create any kind of node that can be discarded during the Assert phase
   [archivedGame play:pointG7];
 
-  // GoBoardRegion cachedAdjacentRegions
+  // GoBoardRegion scoringMode and territory information
   // Do this only after all moves have been played, otherwise the cached values
   // in some GoBoardRegions will be wrong
   [archivedGame.score enableScoring];
@@ -273,6 +274,7 @@
   XCTAssertNotNil(unarchivedGameDocument);
   GoScore* unarchivedScore = unarchivedGame.score;
   XCTAssertNotNil(unarchivedScore);
+  XCTAssertEqual(unarchivedGame.zobristHashAfterHandicap, archivedGame.zobristHashAfterHandicap);
 
   // GoBoard
   // Indirectly proves that m_vertexDict in GoBoard has been unarchived
@@ -293,6 +295,8 @@
   XCTAssertNotNil(unarchivedNodeModel.rootNode.firstChild);
   // Indirectly proves that nodeList in GoNodeModel has been unarchived
   XCTAssertNotNil([unarchivedNodeModel nodeAtIndex:2]);
+  // Zobrist hashes are archived and need not be re-calculated
+  XCTAssertEqual(unarchivedNodeModel.leafNode.zobristHash, archivedGame.nodeModel.leafNode.zobristHash);
   // Indirectly proves that game in GoNodeModel has been unarchived
   unarchivedGameDocument.dirty = false;
   unarchivedBoardPosition.currentBoardPosition -= 1;  // prepare for the discard
@@ -366,10 +370,14 @@
   GoBoardRegion* unarchivedBoardRegion = topLeftCornerPoint.region;
   XCTAssertNotNil(unarchivedBoardRegion.points);
   XCTAssertGreaterThan(unarchivedBoardRegion.points.count, 0);
-  // Indirectly proves that cachedAdjacentRegions in GoBoardRegion has been
-  // unarchived. If it had not been unarchived, then the two array objects would
-  // not be equal, because then each property access would return a newly
+  // Scoring mode and the cached information are not archived, scoring mode
+  // must be enabled again after unarchiving
+  XCTAssertFalse(unarchivedBoardRegion.scoringMode);
+  // Indirectly proves that enabling scoring mode rebuilds cachedAdjacentRegions
+  // in GoBoardRegion. If it had not been rebuilt, then the two array objects
+  // would not be equal, because then each property access would return a newly
   // created array object.
+  unarchivedBoardRegion.scoringMode = true;
   NSArray* adjacentRegions1 = unarchivedBoardRegion.adjacentRegions;
   NSArray* adjacentRegions2 = unarchivedBoardRegion.adjacentRegions;
   XCTAssertEqual(adjacentRegions1, adjacentRegions2);
@@ -1549,6 +1557,12 @@
   [GoUtilities movePointToNewRegion:pointA2];
   XCTAssertFalse([m_game isLegalBoardSetup:&suicidalIntersectionsString]);
   XCTAssertTrue([suicidalIntersectionsString isEqualToString:@"A1"]);
+
+  // Removing the stone on A2 gives back a liberty to the black stone on A1
+  pointA2.stoneState = GoColorNone;
+  [GoUtilities movePointToNewRegion:pointA2];
+  XCTAssertTrue([m_game isLegalBoardSetup:&suicidalIntersectionsString]);
+  XCTAssertTrue([suicidalIntersectionsString isEqualToString:@""]);
 }
 
 // -----------------------------------------------------------------------------
@@ -1682,6 +1696,37 @@
   XCTAssertEqual(illegalReason, GoMoveIsIllegalReasonTooManyMoves);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the legalMoveMapForColor:() method.
+// -----------------------------------------------------------------------------
+- (void) testLegalMoveMapForColor
+{
+  NSDictionary* legalMoveMap = [m_game legalMoveMapForColor:GoColorBlack];
+  XCTAssertNotNil(legalMoveMap);
+  XCTAssertEqual(legalMoveMap.count, 0);
+  // Cached result
+  XCTAssertEqual(legalMoveMap, [m_game legalMoveMapForColor:GoColorBlack]);
+
+  [m_game play:[m_game.board pointAtVertex:@"A2"]];
+  [m_game play:[m_game.board pointAtVertex:@"K10"]];
+  [m_game play:[m_game.board pointAtVertex:@"B1"]];
+
+  legalMoveMap = [m_game legalMoveMapForColor:GoColorWhite];
+  XCTAssertEqual(legalMoveMap.count, 4);
+  XCTAssertEqual([[legalMoveMap objectForKey:@"A2"] intValue], GoMoveIsIllegalReasonIntersectionOccupied);
+  XCTAssertEqual([[legalMoveMap objectForKey:@"K10"] intValue], GoMoveIsIllegalReasonIntersectionOccupied);
+  XCTAssertEqual([[legalMoveMap objectForKey:@"B1"] intValue], GoMoveIsIllegalReasonIntersectionOccupied);
+  XCTAssertEqual([[legalMoveMap objectForKey:@"A1"] intValue], GoMoveIsIllegalReasonSuicide);
+
+  // Black may fill its own eye
+  legalMoveMap = [m_game legalMoveMapForColor:GoColorBlack];
+  XCTAssertEqual(legalMoveMap.count, 3);
+  XCTAssertNil([legalMoveMap objectForKey:@"A1"]);
+
+  XCTAssertThrowsSpecificNamed([m_game legalMoveMapForColor:GoColorNone],
+                               NSException, NSInvalidArgumentException, @"color is GoColorNone");
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the isLegalMove:isIllegalReason:() method (only positional
 /// superko scenarios).
@@ -1732,6 +1777,40 @@
   XCTAssertEqual(illegalReason, GoMoveIsIllegalReasonSuperko);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the isLegalMove:isIllegalReason:() method (superko
+/// scenarios after the current board position has changed).
+// -----------------------------------------------------------------------------
+- (void) testIsLegalMoveSuperkoAfterBoardPositionChange
+{
+  NewGameModel* newGameModel = m_delegate.theNewGameModel;
+  newGameModel.koRule = GoKoRuleSuperkoPositional;
+  [[[[NewGameCommand alloc] init] autorelease] submit];
+  m_game = m_delegate.game;
+  enum GoMoveIsIllegalReason illegalReason;
+  GoBoardPosition* boardPosition = m_game.boardPosition;
+  GoPoint* point = [m_game.board pointAtVertex:@"B1"];
+
+  [self playUntilAlmostPositionalSuperko];
+  XCTAssertFalse([m_game isLegalMove:point isIllegalReason:&illegalReason]);
+  XCTAssertEqual(illegalReason, GoMoveIsIllegalReasonSuperko);
+
+  // Rewinding must forget the board positions after the new current board
+  // position. Playing move 7 again recreates a board position that exists in
+  // the game variation, but only after the new current board position.
+  boardPosition.currentBoardPosition = 6;
+  XCTAssertTrue([m_game isLegalMove:[m_game.board pointAtVertex:@"A1"] isIllegalReason:&illegalReason]);
+
+  // Returning to the end of the game variation must detect superko again
+  boardPosition.currentBoardPosition = 8;
+  XCTAssertFalse([m_game isLegalMove:point isIllegalReason:&illegalReason]);
+  XCTAssertEqual(illegalReason, GoMoveIsIllegalReasonSuperko);
+
+  // Same as above, but rewinding by only one board position
+  boardPosition.currentBoardPosition = 7;
+  XCTAssertTrue([m_game isLegalMove:[m_game.board pointAtVertex:@"C1"] isIllegalReason:&illegalReason]);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Private helper method of testIsLegalMovePositionalSuperko() and
 /// testIsLegalMoveSituationalSuperko().
@@ -2749,4 +2828,45 @@
   [m_game.nodeModel discardLeafNode];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the snapshotAtCurrentNode() method.
+// -----------------------------------------------------------------------------
+- (void) testSnapshotAtCurrentNode
+{
+  GoPoint* pointA1 = [m_game.board pointAtVertex:@"A1"];
+  GoPoint* pointB1 = [m_game.board pointAtVertex:@"B1"];
+
+  [m_game play:pointA1];
+  [m_game pass];
+  GoGameSnapshot* snapshot = [m_game snapshotAtCurrentNode];
+  [m_game play:pointB1];
+
+  // The snapshot is not affected by changes made after it was taken
+  XCTAssertEqual(m_game.board.size, snapshot.boardSize);
+  XCTAssertEqual(m_game.komi, snapshot.komi);
+  XCTAssertEqual(GoColorBlack, snapshot.nextMoveColor);
+  XCTAssertEqual(2, snapshot.boardPosition);
+  XCTAssertEqual(GoColorBlack, [snapshot stoneStateAtVertex:pointA1.vertex]);
+  XCTAssertEqual(GoColorNone, [snapshot stoneStateAtVertex:pointB1.vertex]);
+  XCTAssertEqual(GoColorBlack, pointB1.stoneState);
+
+  XCTAssertEqual(2, snapshot.numberOfMoves);
+  struct GoGameSnapshotMove move1 = [snapshot moveAtIndex:0];
+  XCTAssertEqual(GoMoveTypePlay, move1.type);
+  XCTAssertEqual(GoColorBlack, move1.color);
+  XCTAssertEqual(1, move1.vertex.x);
+  XCTAssertEqual(1, move1.vertex.y);
+  struct GoGameSnapshotMove move2 = [snapshot moveAtIndex:1];
+  XCTAssertEqual(GoMoveTypePass, move2.type);
+  XCTAssertEqual(GoColorWhite, move2.color);
+  XCTAssertThrowsSpecificNamed([snapshot moveAtIndex:2],
+                               NSException, NSRangeException, @"move index out of range");
+
+  struct GoVertexNumeric outsideVertex;
+  outsideVertex.x = 0;
+  outsideVertex.y = 1;
+  XCTAssertThrowsSpecificNamed([snapshot stoneStateAtNumericVertex:outsideVertex],
+                               NSException, NSRangeException, @"vertex outside board");
+}
+
 @end
@@ -0,0 +1,191 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "GoGameWorkspaceTest.h"
+
+// Application includes
+#import <go/GoGame.h>
+#import <go/GoGameDocument.h>
+#import <go/GoGameWorkspace.h>
+#import <shared/MemoryBudgetManager.h>
+
+
+@implementation GoGameWorkspaceTest
+
+// -----------------------------------------------------------------------------
+/// @brief Checks the initial state of a GoGameWorkspace object after a new
+/// instance has been created.
+// -----------------------------------------------------------------------------
+- (void) testInitialState
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+  XCTAssertEqual(workspace.memoryBudget, gDefaultGameWorkspaceMemoryBudget);
+  XCTAssertEqual(workspace.memoryUsage, 0);
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertNil(workspace.activeGameKey);
+  XCTAssertFalse([workspace hasResidentGameForKey:@"foo"]);
+  XCTAssertFalse([workspace hasResidentGameForKey:nil]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the activateGame:forKey:() and deactivateGame:() methods.
+// -----------------------------------------------------------------------------
+- (void) testActivateAndDeactivateGame
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+
+  [workspace activateGame:m_game forKey:@"foo"];
+  XCTAssertEqualObjects(workspace.activeGameKey, @"foo");
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+
+  // Deactivating a game that is not the active game has no effect
+  [workspace deactivateGame:nil];
+  XCTAssertEqualObjects(workspace.activeGameKey, @"foo");
+
+  [workspace deactivateGame:m_game];
+  XCTAssertNil(workspace.activeGameKey);
+  XCTAssertEqual(workspace.numberOfResidentGames, 1);
+  XCTAssertTrue([workspace hasResidentGameForKey:@"foo"]);
+  XCTAssertEqual(workspace.memoryUsage, [GoGameWorkspace estimatedMemoryUsageOfGame:m_game]);
+
+  // Activating a game with the same key supersedes the resident game
+  [workspace activateGame:m_game forKey:@"foo"];
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertEqual(workspace.memoryUsage, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the deactivateGame:() method with a game that has no key.
+// -----------------------------------------------------------------------------
+- (void) testDeactivateGameWithoutKey
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+
+  [workspace activateGame:m_game forKey:nil];
+  [workspace deactivateGame:m_game];
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertEqual(workspace.memoryUsage, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the deactivateGame:() method with a game whose document
+/// is dirty.
+// -----------------------------------------------------------------------------
+- (void) testDeactivateDirtyGame
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+
+  m_game.document.dirty = true;
+  [workspace activateGame:m_game forKey:@"foo"];
+  [workspace deactivateGame:m_game];
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertFalse([workspace hasResidentGameForKey:@"foo"]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the takeResidentGameForKey:() method.
+// -----------------------------------------------------------------------------
+- (void) testTakeResidentGameForKey
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+
+  XCTAssertNil([workspace takeResidentGameForKey:@"foo"]);
+  XCTAssertNil([workspace takeResidentGameForKey:nil]);
+
+  [workspace activateGame:m_game forKey:@"foo"];
+  [workspace deactivateGame:m_game];
+  XCTAssertNil([workspace takeResidentGameForKey:@"bar"]);
+  XCTAssertEqual([workspace takeResidentGameForKey:@"foo"], m_game);
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertEqual(workspace.memoryUsage, 0);
+  XCTAssertNil([workspace takeResidentGameForKey:@"foo"]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the @e memoryBudget property.
+// -----------------------------------------------------------------------------
+- (void) testMemoryBudget
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+  unsigned long long estimatedMemoryUsage = [GoGameWorkspace estimatedMemoryUsageOfGame:m_game];
+
+  // A game that exceeds the budget on its own is not kept resident
+  workspace.memoryBudget = estimatedMemoryUsage - 1;
+  [workspace activateGame:m_game forKey:@"foo"];
+  [workspace deactivateGame:m_game];
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+
+  // The least recently used game is discarded first
+  workspace.memoryBudget = 2 * estimatedMemoryUsage - 1;
+  [workspace activateGame:m_game forKey:@"foo"];
+  [workspace deactivateGame:m_game];
+  [workspace activateGame:m_game forKey:@"bar"];
+  [workspace deactivateGame:m_game];
+  XCTAssertEqual(workspace.numberOfResidentGames, 1);
+  XCTAssertFalse([workspace hasResidentGameForKey:@"foo"]);
+  XCTAssertTrue([workspace hasResidentGameForKey:@"bar"]);
+
+  // Lowering the budget discards resident games immediately
+  workspace.memoryBudget = 0;
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertEqual(workspace.memoryUsage, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the discardAllResidentGames() method.
+// -----------------------------------------------------------------------------
+- (void) testDiscardAllResidentGames
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+
+  [workspace activateGame:m_game forKey:@"foo"];
+  [workspace deactivateGame:m_game];
+  [workspace activateGame:m_game forKey:@"bar"];
+  [workspace discardAllResidentGames];
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertEqual(workspace.memoryUsage, 0);
+  XCTAssertEqualObjects(workspace.activeGameKey, @"bar");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the MemoryBudgetClient methods of GoGameWorkspace.
+// -----------------------------------------------------------------------------
+- (void) testMemoryBudgetClient
+{
+  GoGameWorkspace* workspace = [[[GoGameWorkspace alloc] init] autorelease];
+  id<MemoryBudgetClient> client = (id<MemoryBudgetClient>)workspace;
+  unsigned long long estimatedMemoryUsage = [GoGameWorkspace estimatedMemoryUsageOfGame:m_game];
+
+  [workspace activateGame:m_game forKey:@"foo"];
+  [workspace deactivateGame:m_game];
+  [workspace activateGame:m_game forKey:@"bar"];
+  [workspace deactivateGame:m_game];
+  XCTAssertEqual([client evictableMemoryUsage], 2 * estimatedMemoryUsage);
+
+  // The least recently used game is discarded first
+  [client reduceEvictableMemoryUsageTo:estimatedMemoryUsage];
+  XCTAssertEqual(workspace.numberOfResidentGames, 1);
+  XCTAssertFalse([workspace hasResidentGameForKey:@"foo"]);
+  XCTAssertTrue([workspace hasResidentGameForKey:@"bar"]);
+
+  [client reduceEvictableMemoryUsageTo:0];
+  XCTAssertEqual(workspace.numberOfResidentGames, 0);
+  XCTAssertEqual([client evictableMemoryUsage], 0);
+}
+
+@end
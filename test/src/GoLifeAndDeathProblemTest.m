@@ -0,0 +1,131 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "GoLifeAndDeathProblemTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoGame.h>
+#import <go/GoLifeAndDeathProblem.h>
+#import <go/GoPoint.h>
+
+
+@implementation GoLifeAndDeathProblemTest
+
+// -----------------------------------------------------------------------------
+/// @brief Places a white stone group in the lower-left corner with the
+/// straight three-point eye space A1, B1 and C1, surrounded by black stones.
+// -----------------------------------------------------------------------------
+- (void) setupStraightThreeProblem
+{
+  GoBoard* board = m_game.board;
+  for (NSString* vertex in @[@"A3", @"B3", @"C3", @"D3", @"E3", @"E2", @"E1"])
+    [board pointAtVertex:vertex].stoneState = GoColorBlack;
+  for (NSString* vertex in @[@"A2", @"B2", @"C2", @"D2", @"D1"])
+    [board pointAtVertex:vertex].stoneState = GoColorWhite;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks the initial state of a GoLifeAndDeathProblem object after it
+/// has been initialized, and the exceptions raised by the initializer.
+// -----------------------------------------------------------------------------
+- (void) testInitialState
+{
+  [self setupStraightThreeProblem];
+  GoBoard* board = m_game.board;
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+
+  GoLifeAndDeathProblem* problem = [[[GoLifeAndDeathProblem alloc] initWithBoard:board
+                                                                     targetPoint:pointA2
+                                                                     colorToMove:GoColorBlack] autorelease];
+  XCTAssertEqualObjects(@"A2", problem.targetVertex);
+  XCTAssertEqual(GoColorWhite, problem.targetColor);
+  XCTAssertEqual(GoColorBlack, problem.colorToMove);
+  XCTAssertEqual(3, problem.regionSize);
+  XCTAssertEqual(GoLifeAndDeathStatusNotSolved, problem.status);
+  XCTAssertEqual(0, problem.mainLine.count);
+  XCTAssertEqual(0, problem.numberOfNodes);
+
+  XCTAssertThrowsSpecificNamed([[[GoLifeAndDeathProblem alloc] initWithBoard:nil targetPoint:pointA2 colorToMove:GoColorBlack] autorelease],
+                               NSException, NSInvalidArgumentException, @"board is nil");
+  XCTAssertThrowsSpecificNamed([[[GoLifeAndDeathProblem alloc] initWithBoard:board targetPoint:pointA2 colorToMove:GoColorNone] autorelease],
+                               NSException, NSInvalidArgumentException, @"GoColorNone");
+  XCTAssertThrowsSpecificNamed([[[GoLifeAndDeathProblem alloc] initWithBoard:board targetPoint:[board pointAtVertex:@"A1"] colorToMove:GoColorBlack] autorelease],
+                               NSException, NSInvalidArgumentException, @"point without stone");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the problemWithBoard:colorToMove:() convenience
+/// constructor.
+// -----------------------------------------------------------------------------
+- (void) testProblemWithBoard
+{
+  GoBoard* board = m_game.board;
+  XCTAssertNil([GoLifeAndDeathProblem problemWithBoard:board colorToMove:GoColorBlack]);
+
+  // The white stone group has the smallest eye space, so it is selected
+  // regardless of the side to move
+  [self setupStraightThreeProblem];
+  GoLifeAndDeathProblem* problem = [GoLifeAndDeathProblem problemWithBoard:board colorToMove:GoColorBlack];
+  XCTAssertEqualObjects(@"A2", problem.targetVertex);
+  problem = [GoLifeAndDeathProblem problemWithBoard:board colorToMove:GoColorWhite];
+  XCTAssertEqualObjects(@"A2", problem.targetVertex);
+
+  XCTAssertThrowsSpecificNamed([GoLifeAndDeathProblem problemWithBoard:nil colorToMove:GoColorBlack],
+                               NSException, NSInvalidArgumentException, @"board is nil");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the solve() method with a problem in which the attacker
+/// can kill by playing on the vital point.
+// -----------------------------------------------------------------------------
+- (void) testSolveKill
+{
+  [self setupStraightThreeProblem];
+  GoBoard* board = m_game.board;
+  GoLifeAndDeathProblem* problem = [[[GoLifeAndDeathProblem alloc] initWithBoard:board
+                                                                     targetPoint:[board pointAtVertex:@"A2"]
+                                                                     colorToMove:GoColorBlack] autorelease];
+  [problem solve];
+  XCTAssertEqual(GoLifeAndDeathStatusDead, problem.status);
+  XCTAssertTrue(problem.mainLine.count > 0);
+  XCTAssertEqualObjects(@"B1", problem.mainLine.firstObject);
+  XCTAssertTrue(problem.numberOfNodes > 0);
+
+  // The board is not modified by solving the problem
+  XCTAssertFalse([board pointAtVertex:@"B1"].hasStone);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the solve() method with a problem in which the defender
+/// can live by playing on the vital point.
+// -----------------------------------------------------------------------------
+- (void) testSolveLive
+{
+  [self setupStraightThreeProblem];
+  GoBoard* board = m_game.board;
+  GoLifeAndDeathProblem* problem = [[[GoLifeAndDeathProblem alloc] initWithBoard:board
+                                                                     targetPoint:[board pointAtVertex:@"A2"]
+                                                                     colorToMove:GoColorWhite] autorelease];
+  [problem solve];
+  XCTAssertEqual(GoLifeAndDeathStatusAlive, problem.status);
+  NSArray* expectedMainLine = @[@"B1"];
+  XCTAssertEqualObjects(expectedMainLine, problem.mainLine);
+}
+
+@end
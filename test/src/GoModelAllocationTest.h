@@ -0,0 +1,48 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BaseTestCase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoModelAllocationTest class contains unit tests that check that
+/// hot operations of the Go model do not grow the heap, or at least do not
+/// grow it more as the game grows.
+///
+/// The tests measure the number of heap blocks in use before and after an
+/// operation, using the public malloc_zone_statistics() function. Queries
+/// that are invoked many times per user action (legality checks, liberties,
+/// Zobrist hashes) must leave the heap unchanged once they have been invoked
+/// for the first time. Operations that change the model (playing a move,
+/// undoing and redoing a move, changing the board position) may grow the
+/// heap, but the growth must not depend on the size of the stone groups
+/// involved or on the length of the game. The tests compare an operation
+/// early in a game with the same operation later in the game.
+// -----------------------------------------------------------------------------
+@interface GoModelAllocationTest : BaseTestCase
+{
+}
+
+- (void) testIsLegalMoveDoesNotGrowHeap;
+- (void) testLibertiesDoNotGrowHeap;
+- (void) testZobristHashDoesNotGrowHeap;
+- (void) testPlayHeapGrowthIsConstant;
+- (void) testUndoAndRedoHeapGrowthIsConstant;
+- (void) testBoardPositionChangeHeapGrowthIsConstant;
+
+@end
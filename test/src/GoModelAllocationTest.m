@@ -0,0 +1,366 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "GoModelAllocationTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoGameRules.h>
+#import <go/GoMove.h>
+#import <go/GoPoint.h>
+#import <go/GoZobristTable.h>
+
+// System includes
+#include <malloc/malloc.h>
+
+
+// The number of move pairs (one black move, one white move) that the tests
+// play. Black plays a single snake-like stone group that starts on row 1 and
+// grows by one stone with each move. White plays isolated stones in the
+// upper half of the board. No move captures anything.
+static const int numberOfMovePairs = 50;
+// The move pair at which the early measurements begin, and the move pair at
+// which the late measurements begin. Both are chosen so that the measured
+// board positions avoid the positions at which the node model stores board
+// snapshots.
+static const int earlyMovePair = 5;
+static const int lateMovePair = 40;
+// The number of operations that each measurement covers
+static const int numberOfMeasuredOperations = 5;
+// The number of heap blocks by which a late measurement may exceed the early
+// measurement of the same operation. Mutable collections that grow with the
+// game occasionally reallocate their storage, and other threads may allocate
+// while a measurement is running, which makes measurements differ slightly.
+static const long long heapBlockSlack = 8;
+// The number of times that an operation that is expected to leave the heap
+// unchanged is measured. Heap statistics are process-wide, so a measurement
+// can be disturbed by other threads. The smallest result is used.
+static const int numberOfRepeatedMeasurements = 3;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GoModelAllocationTest.
+// -----------------------------------------------------------------------------
+@interface GoModelAllocationTest()
+@property(nonatomic, retain) NSArray* blackMovePoints;
+@property(nonatomic, retain) NSArray* whiteMovePoints;
+@end
+
+
+@implementation GoModelAllocationTest
+
+#pragma mark - Setup and teardown
+
+// -----------------------------------------------------------------------------
+/// @brief Sets up the environment for a test case method.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+
+  // Simple ko does not need the Zobrist hash of the hypothetical move to
+  // check the legality of a move that cannot be a ko
+  m_game.rules.koRule = GoKoRuleSimple;
+
+  // Look up points in advance so that measurements do not count the
+  // allocations of vertex strings
+  NSString* columnLetters = @"ABCDEFGHJKLMNOPQRST";
+  NSMutableArray* blackMovePoints = [NSMutableArray array];
+  NSMutableArray* whiteMovePoints = [NSMutableArray array];
+  for (int movePair = 0; movePair < numberOfMovePairs; ++movePair)
+  {
+    int blackRow = movePair / 19 + 1;
+    int blackColumn = movePair % 19;
+    if (blackRow % 2 == 0)
+      blackColumn = 18 - blackColumn;
+    NSString* blackVertex = [NSString stringWithFormat:@"%C%d", [columnLetters characterAtIndex:blackColumn], blackRow];
+    [blackMovePoints addObject:[m_game.board pointAtVertex:blackVertex]];
+
+    int whiteRow = 11 + (movePair / 10) * 2;
+    int whiteColumn = (movePair % 10) * 2;
+    NSString* whiteVertex = [NSString stringWithFormat:@"%C%d", [columnLetters characterAtIndex:whiteColumn], whiteRow];
+    [whiteMovePoints addObject:[m_game.board pointAtVertex:whiteVertex]];
+  }
+  self.blackMovePoints = blackMovePoints;
+  self.whiteMovePoints = whiteMovePoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Tears down the environment previously set up for a test case method.
+// -----------------------------------------------------------------------------
+- (void) tearDown
+{
+  self.blackMovePoints = nil;
+  self.whiteMovePoints = nil;
+
+  [super tearDown];
+}
+
+#pragma mark - Tests
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that isLegalMove:isIllegalReason:() does not grow the heap.
+// -----------------------------------------------------------------------------
+- (void) testIsLegalMoveDoesNotGrowHeap
+{
+  [self playMovePairsFrom:0 to:lateMovePair];
+  NSArray* emptyPoints = [self emptyPoints];
+
+  void (^checkLegality)(void) = ^
+  {
+    for (GoPoint* point in emptyPoints)
+    {
+      enum GoMoveIsIllegalReason illegalReason;
+      [m_game isLegalMove:point isIllegalReason:&illegalReason];
+    }
+  };
+  checkLegality();
+
+  long long heapGrowth = [self minimumHeapGrowthOfRepeatedBlock:checkLegality];
+  XCTAssertLessThanOrEqual(heapGrowth, 0ll, @"%d x isLegalMove", (int)emptyPoints.count);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that querying the liberties of stones and empty
+/// intersections does not grow the heap.
+// -----------------------------------------------------------------------------
+- (void) testLibertiesDoNotGrowHeap
+{
+  [self playMovePairsFrom:0 to:lateMovePair];
+  GoBoard* board = m_game.board;
+
+  void (^queryLiberties)(void) = ^
+  {
+    for (GoPoint* point = [board pointAtIndex:0]; point; point = point.next)
+    {
+      [point liberties];
+      if ([point hasStone])
+        [board numberOfLibertiesOfStoneGroupAtPoint:point];
+    }
+  };
+  queryLiberties();
+
+  long long heapGrowth = [self minimumHeapGrowthOfRepeatedBlock:queryLiberties];
+  XCTAssertLessThanOrEqual(heapGrowth, 0ll);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that the incremental Zobrist hash update for a move does not
+/// grow the heap.
+// -----------------------------------------------------------------------------
+- (void) testZobristHashDoesNotGrowHeap
+{
+  [self playMovePairsFrom:0 to:lateMovePair];
+  NSArray* emptyPoints = [self emptyPoints];
+  GoZobristTable* zobristTable = m_game.board.zobristTable;
+  GoNode* currentNode = m_game.boardPosition.currentNode;
+
+  void (^calculateHashes)(void) = ^
+  {
+    for (GoPoint* point in emptyPoints)
+    {
+      [zobristTable hashForStonePlayedByColor:GoColorBlack
+                                      atPoint:point
+                              capturingStones:nil
+                                    afterNode:currentNode
+                                       inGame:m_game];
+    }
+  };
+  calculateHashes();
+
+  long long heapGrowth = [self minimumHeapGrowthOfRepeatedBlock:calculateHashes];
+  XCTAssertLessThanOrEqual(heapGrowth, 0ll, @"%d x Zobrist hash", (int)emptyPoints.count);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that playing a move that extends a large stone group does
+/// not grow the heap more than playing a move that extends a small stone
+/// group.
+// -----------------------------------------------------------------------------
+- (void) testPlayHeapGrowthIsConstant
+{
+  [self playMovePairsFrom:0 to:earlyMovePair];
+  long long earlyHeapGrowth = [self heapGrowthOfBlock:^
+  {
+    [self playMovePairsFrom:earlyMovePair to:earlyMovePair + numberOfMeasuredOperations];
+  }];
+
+  [self playMovePairsFrom:earlyMovePair + numberOfMeasuredOperations to:lateMovePair];
+  long long lateHeapGrowth = [self heapGrowthOfBlock:^
+  {
+    [self playMovePairsFrom:lateMovePair to:lateMovePair + numberOfMeasuredOperations];
+  }];
+
+  XCTAssertLessThanOrEqual(lateHeapGrowth, earlyHeapGrowth + heapBlockSlack);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that undoing and redoing a move that extends a large stone
+/// group does not grow the heap more than undoing and redoing a move that
+/// extends a small stone group.
+// -----------------------------------------------------------------------------
+- (void) testUndoAndRedoHeapGrowthIsConstant
+{
+  [self playMovePairsFrom:0 to:earlyMovePair];
+  [m_game play:self.blackMovePoints[earlyMovePair]];
+  long long earlyHeapGrowth = [self heapGrowthOfUndoAndRedoOfMove:m_game.lastMove];
+
+  [m_game play:self.whiteMovePoints[earlyMovePair]];
+  [self playMovePairsFrom:earlyMovePair + 1 to:lateMovePair];
+  [m_game play:self.blackMovePoints[lateMovePair]];
+  long long lateHeapGrowth = [self heapGrowthOfUndoAndRedoOfMove:m_game.lastMove];
+
+  XCTAssertLessThanOrEqual(lateHeapGrowth, earlyHeapGrowth + heapBlockSlack);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that changing the board position late in a game does not
+/// grow the heap more than changing the board position early in the game.
+// -----------------------------------------------------------------------------
+- (void) testBoardPositionChangeHeapGrowthIsConstant
+{
+  [self playMovePairsFrom:0 to:numberOfMovePairs];
+
+  // Each move pair consists of two board positions
+  long long earlyHeapGrowth = [self heapGrowthOfBoardPositionChangesFrom:(2 * earlyMovePair + 1)];
+  long long lateHeapGrowth = [self heapGrowthOfBoardPositionChangesFrom:(2 * lateMovePair + 1)];
+
+  XCTAssertLessThanOrEqual(lateHeapGrowth, earlyHeapGrowth + heapBlockSlack);
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Plays the move pairs with indexes @a firstMovePair
+/// up to but not including @a endMovePair.
+// -----------------------------------------------------------------------------
+- (void) playMovePairsFrom:(int)firstMovePair to:(int)endMovePair
+{
+  for (int movePair = firstMovePair; movePair < endMovePair; ++movePair)
+  {
+    [m_game play:self.blackMovePoints[movePair]];
+    [m_game play:self.whiteMovePoints[movePair]];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the empty GoPoint objects of the board.
+// -----------------------------------------------------------------------------
+- (NSArray*) emptyPoints
+{
+  NSMutableArray* emptyPoints = [NSMutableArray array];
+  for (GoPoint* point = [m_game.board pointAtIndex:0]; point; point = point.next)
+  {
+    if (! [point hasStone])
+      [emptyPoints addObject:point];
+  }
+  return emptyPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Undoes and redoes @a move numberOfMeasuredOperations
+/// times and returns the heap growth. Undoes and redoes @a move once before
+/// measuring.
+// -----------------------------------------------------------------------------
+- (long long) heapGrowthOfUndoAndRedoOfMove:(GoMove*)move
+{
+  [move undo];
+  [move doIt];
+
+  return [self heapGrowthOfBlock:^
+  {
+    for (int operation = 0; operation < numberOfMeasuredOperations; ++operation)
+    {
+      [move undo];
+      [move doIt];
+    }
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Changes the board position step by step from
+/// @a boardPosition forward by numberOfMeasuredOperations positions and back
+/// again, and returns the heap growth. Makes the same changes once before
+/// measuring.
+// -----------------------------------------------------------------------------
+- (long long) heapGrowthOfBoardPositionChangesFrom:(int)boardPosition
+{
+  GoBoardPosition* goBoardPosition = m_game.boardPosition;
+  void (^changeBoardPositions)(void) = ^
+  {
+    for (int position = boardPosition + 1; position <= boardPosition + numberOfMeasuredOperations; ++position)
+      goBoardPosition.currentBoardPosition = position;
+    for (int position = boardPosition + numberOfMeasuredOperations - 1; position >= boardPosition; --position)
+      goBoardPosition.currentBoardPosition = position;
+  };
+
+  goBoardPosition.currentBoardPosition = boardPosition;
+  changeBoardPositions();
+
+  return [self heapGrowthOfBlock:changeBoardPositions];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Executes @a block and returns the number of heap
+/// blocks that are in use afterwards, minus the number of heap blocks that
+/// were in use before. The result is negative if more blocks were freed than
+/// allocated.
+///
+/// The numbers are taken from malloc_zone_statistics() and cover all malloc
+/// zones. Objective-C objects, Core Foundation objects and C/C++ heap memory
+/// are all allocated via malloc, so they are all covered. @a block is
+/// executed in its own autorelease pool, so temporary objects that @a block
+/// autoreleases are freed before the second measurement.
+///
+/// Operations often allocate on first use, e.g. to fill a cache. To check that
+/// an operation does not grow the heap in the steady state, a test should
+/// execute the operation once before it measures the operation.
+// -----------------------------------------------------------------------------
+- (long long) heapGrowthOfBlock:(void (^)(void))block
+{
+  malloc_statistics_t statisticsBefore;
+  malloc_zone_statistics(NULL, &statisticsBefore);
+
+  @autoreleasepool
+  {
+    block();
+  }
+
+  malloc_statistics_t statisticsAfter;
+  malloc_zone_statistics(NULL, &statisticsAfter);
+
+  return ((long long)statisticsAfter.blocks_in_use - (long long)statisticsBefore.blocks_in_use);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Measures the heap growth of @a block
+/// numberOfRepeatedMeasurements times and returns the smallest result.
+/// @a block must be an operation that can be repeated without changing the
+/// model.
+// -----------------------------------------------------------------------------
+- (long long) minimumHeapGrowthOfRepeatedBlock:(void (^)(void))block
+{
+  long long minimumHeapGrowth = LLONG_MAX;
+  for (int measurement = 0; measurement < numberOfRepeatedMeasurements; ++measurement)
+    minimumHeapGrowth = MIN(minimumHeapGrowth, [self heapGrowthOfBlock:block]);
+  return minimumHeapGrowth;
+}
+
+@end
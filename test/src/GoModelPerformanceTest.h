@@ -0,0 +1,42 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BaseTestCase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoModelPerformanceTest class contains performance tests that
+/// measure the Go model with reproducible workloads.
+///
+/// Every test uses XCTest's measurement API, so Xcode records a baseline for
+/// the wall clock time and the memory usage of each workload. In addition
+/// each test logs the average time per operation and the number of heap
+/// blocks that were allocated and are still in use at the end of the
+/// measured operations.
+// -----------------------------------------------------------------------------
+@interface GoModelPerformanceTest : BaseTestCase
+{
+}
+
+- (void) testPerformanceReplayFamousGame;
+- (void) testPerformanceRandomPlayout;
+- (void) testPerformanceNavigateBoardPositions;
+- (void) testPerformanceSuperkoCheck;
+- (void) testPerformanceScoreEndgame;
+
+@end
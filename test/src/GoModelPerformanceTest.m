@@ -0,0 +1,378 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "GoModelPerformanceTest.h"
+
+// Application includes
+#import <main/ApplicationDelegate.h>
+#import <command/game/NewGameCommand.h>
+#import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoGameRules.h>
+#import <go/GoPoint.h>
+#import <go/GoScore.h>
+#import <play/model/ScoringModel.h>
+#import <ui/UiSettingsModel.h>
+
+// System includes
+#import <QuartzCore/QuartzCore.h>
+#include <malloc/malloc.h>
+
+
+// The moves of the "Ear-reddening game" (Honinbo Shusaku vs. Gennan Inseki,
+// 1846). This is the same game that is in the sgf folder. The moves are
+// embedded here so that the workload does not depend on the SGF parser.
+static NSString* famousGameMoves =
+  @"R16 D17 Q3 P17 C4 C14 E4 R5 Q15 O4 Q5 Q4 P4 R4 P3 P5 Q6 R3 O3 P6 Q7 P7 "
+  @"Q8 N4 N3 P8 Q9 M3 M2 L2 M4 L3 R2 S2 S1 N2 O2 Q2 Q1 R1 O5 N5 R2 S7 S8 R1 "
+  @"M5 N6 R2 R7 P2 R8 R10 S10 S11 S9 M6 N7 R11 S3 K6 M1 O1 G3 G5 C9 L17 J17 "
+  @"Q17 O10 L15 P13 P12 Q18 R18 O13 N11 N10 O16 Q12 R13 Q13 H3 H2 J2 J3 H4 "
+  @"K2 F17 M17 M16 N17 M18 N18 N16 R14 Q14 R12 S13 S12 T12 S14 T13 Q10 Q11 "
+  @"P11 P10 O11 R9 P9 R15 L18 K18 L19 K17 P18 K19 M19 D18 C17 F15 C6 G2 J1 "
+  @"F3 J5 K11 E18 F18 E13 D10 D9 E10 C10 D12 J10 H7 G10 E12 F8 F13 E2 D7 F6 "
+  @"D6 G6 K10 K9 L9 J11 J9 K8 L8 J8 K12 C5 D5 J12 H6 H8 B8 D13 G12 C12 J13 "
+  @"E17 C2 F16 G16 E16 G17 B9 C7 G1 G4 M11 L13 J6 M10 M13 G7 K14 K13 J7 F7 "
+  @"L14 M14 N14 M15 G14 H14 F14 G13 M9 L10 L7 M7 M8 K7 G15 H15 E14 E19 C18 "
+  @"F2 F1 D2 R19 S19 Q19 S18 D19 G11 F10 F11 F19 G19 G8 E9 E7 H5 E8 E6 K5 L6 "
+  @"C11 M12 N12 N13 D11 E11 M13 R6 S6 S15 T8 N13 B7 A7 M13 E3 E1 N13 H19 G18 "
+  @"M13 D1 H1 N13 T10 T11 M13 T2 T3 N13 H16 H18 M13 S5 T5 N13 T1 R1 M13 T6 "
+  @"S4 N13 C8 B6 M13 N8 N9 N13 Q10 T14 M13 O6 O8 N13 J18 J19 M13 O17 O18 N13 "
+  @"K16 L16 M13 N19 O19 N13 R17 S17 M13 K1 L1 N13 H17 J16 M13 F9 H10 N13 H12 "
+  @"H13 M13 G9 H9 N13 A9 M13 A8 B7 O14 P16 L11 N1 L4 J4 K4 M2 P10 N2 E19 T2";
+
+// The seed for the pseudo random number generator used by
+// testPerformanceRandomPlayout(). A fixed seed makes the workload
+// reproducible.
+static const unsigned int randomPlayoutSeed = 42;
+// The maximum number of moves that testPerformanceRandomPlayout() plays
+static const int randomPlayoutMaximumNumberOfMoves = 250;
+
+
+// -----------------------------------------------------------------------------
+/// @brief A snapshot of the clock and the heap that is taken at the beginning
+/// of a measured block of operations.
+// -----------------------------------------------------------------------------
+struct GoModelPerformanceSnapshot
+{
+  CFTimeInterval time;
+  size_t blocksInUse;
+};
+
+
+@implementation GoModelPerformanceTest
+
+#pragma mark - Performance tests
+
+// -----------------------------------------------------------------------------
+/// @brief Measures replaying a complete professional game move by move.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceReplayFamousGame
+{
+  NSArray* vertexes = [self famousGameVertexes];
+
+  [self measureWithMetrics:[self performanceMetrics] options:[self manualMeasureOptions] block:^
+  {
+    GoGame* game = [self newGameWithKoRule:GoKoRuleSimple];
+
+    struct GoModelPerformanceSnapshot snapshot = [self startMeasuringWithSnapshot];
+    [self replayVertexes:vertexes inGame:game];
+    [self stopMeasuringAndReportOperation:@"play move" count:(int)vertexes.count sinceSnapshot:snapshot];
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures a pseudo random playout with a fixed seed. Every move is
+/// checked for legality before it is played.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceRandomPlayout
+{
+  [self measureWithMetrics:[self performanceMetrics] options:[self manualMeasureOptions] block:^
+  {
+    GoGame* game = [self newGameWithKoRule:GoKoRuleSimple];
+    srandom(randomPlayoutSeed);
+
+    struct GoModelPerformanceSnapshot snapshot = [self startMeasuringWithSnapshot];
+    int numberOfMovesPlayed = [self playRandomMovesInGame:game];
+    [self stopMeasuringAndReportOperation:@"random move" count:numberOfMovesPlayed sinceSnapshot:snapshot];
+
+    XCTAssertTrue(numberOfMovesPlayed > 0);
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures navigating through all board positions of a complete
+/// professional game, first backward to the beginning of the game, then
+/// forward again to the end of the game.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceNavigateBoardPositions
+{
+  NSArray* vertexes = [self famousGameVertexes];
+
+  [self measureWithMetrics:[self performanceMetrics] options:[self manualMeasureOptions] block:^
+  {
+    GoGame* game = [self newGameWithKoRule:GoKoRuleSimple];
+    [self replayVertexes:vertexes inGame:game];
+    GoBoardPosition* boardPosition = game.boardPosition;
+    int lastBoardPosition = boardPosition.numberOfBoardPositions - 1;
+
+    struct GoModelPerformanceSnapshot snapshot = [self startMeasuringWithSnapshot];
+    for (int position = lastBoardPosition - 1; position >= 0; --position)
+      boardPosition.currentBoardPosition = position;
+    for (int position = 1; position <= lastBoardPosition; ++position)
+      boardPosition.currentBoardPosition = position;
+    [self stopMeasuringAndReportOperation:@"board position change" count:(2 * lastBoardPosition) sinceSnapshot:snapshot];
+
+    XCTAssertEqual(boardPosition.currentBoardPosition, lastBoardPosition);
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures checking the legality of a move on every empty
+/// intersection at the end of a long game, with the positional superko rule
+/// in effect.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceSuperkoCheck
+{
+  NSArray* vertexes = [self famousGameVertexes];
+
+  [self measureWithMetrics:[self performanceMetrics] options:[self manualMeasureOptions] block:^
+  {
+    GoGame* game = [self newGameWithKoRule:GoKoRuleSuperkoPositional];
+    [self replayVertexes:vertexes inGame:game];
+    NSArray* emptyPoints = [self emptyPointsInGame:game];
+
+    struct GoModelPerformanceSnapshot snapshot = [self startMeasuringWithSnapshot];
+    for (GoPoint* point in emptyPoints)
+    {
+      enum GoMoveIsIllegalReason illegalReason;
+      [game isLegalMove:point isIllegalReason:&illegalReason];
+    }
+    [self stopMeasuringAndReportOperation:@"superko legality check" count:(int)emptyPoints.count sinceSnapshot:snapshot];
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures a full score calculation at the end of a complete 19x19
+/// professional game.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceScoreEndgame
+{
+  NSArray* vertexes = [self famousGameVertexes];
+  // The GTP engine must not participate in the workload
+  m_delegate.scoringModel.askGtpEngineForDeadStones = false;
+  m_delegate.uiSettingsModel.uiAreaPlayMode = UIAreaPlayModeScoring;
+  const int numberOfScoreCalculations = 10;
+
+  [self measureWithMetrics:[self performanceMetrics] options:[self manualMeasureOptions] block:^
+  {
+    GoGame* game = [self newGameWithKoRule:GoKoRuleSimple];
+    [self replayVertexes:vertexes inGame:game];
+    GoScore* score = game.score;
+
+    struct GoModelPerformanceSnapshot snapshot = [self startMeasuringWithSnapshot];
+    for (int calculation = 0; calculation < numberOfScoreCalculations; ++calculation)
+    {
+      // Enabling scoring discards all scoring information, so the calculation
+      // that follows is a full calculation and not an incremental one
+      [score enableScoring];
+      [score calculateWaitUntilDone:true];
+      [score disableScoring];
+    }
+    [self stopMeasuringAndReportOperation:@"score calculation" count:numberOfScoreCalculations sinceSnapshot:snapshot];
+
+    XCTAssertTrue(score.territoryBlack > 0);
+    XCTAssertTrue(score.territoryWhite > 0);
+  }];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the metrics that are recorded by all
+/// performance tests.
+// -----------------------------------------------------------------------------
+- (NSArray*) performanceMetrics
+{
+  return @[[[[XCTClockMetric alloc] init] autorelease],
+           [[[XCTMemoryMetric alloc] init] autorelease]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns measure options that let the performance
+/// tests exclude the preparation of each workload from the measurement.
+// -----------------------------------------------------------------------------
+- (XCTMeasureOptions*) manualMeasureOptions
+{
+  XCTMeasureOptions* options = [[[XCTMeasureOptions alloc] init] autorelease];
+  options.invocationOptions = XCTMeasurementInvocationManuallyStart | XCTMeasurementInvocationManuallyStop;
+  return options;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Starts a new game with @a koRule and returns the new
+/// GoGame object.
+// -----------------------------------------------------------------------------
+- (GoGame*) newGameWithKoRule:(enum GoKoRule)koRule
+{
+  [[[[NewGameCommand alloc] init] autorelease] submit];
+  GoGame* game = m_delegate.game;
+  XCTAssertEqual(game.board.size, GoBoardSize19);
+  game.rules.koRule = koRule;
+  return game;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the moves of famousGameMoves as an array of
+/// NSString objects, each of which is either a vertex or the string "pass".
+// -----------------------------------------------------------------------------
+- (NSArray*) famousGameVertexes
+{
+  return [famousGameMoves componentsSeparatedByString:@" "];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Plays the moves in @a vertexes in @a game.
+// -----------------------------------------------------------------------------
+- (void) replayVertexes:(NSArray*)vertexes inGame:(GoGame*)game
+{
+  GoBoard* board = game.board;
+  for (NSString* vertex in vertexes)
+  {
+    if ([vertex isEqualToString:@"pass"])
+      [game pass];
+    else
+      [game play:[board pointAtVertex:vertex]];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Plays pseudo random legal moves in @a game until
+/// either randomPlayoutMaximumNumberOfMoves moves have been played, or the
+/// player whose turn it is has no legal move that does not fill one of
+/// their own single-point eyes. Returns the number of moves played.
+// -----------------------------------------------------------------------------
+- (int) playRandomMovesInGame:(GoGame*)game
+{
+  int numberOfMovesPlayed = 0;
+  while (numberOfMovesPlayed < randomPlayoutMaximumNumberOfMoves)
+  {
+    NSMutableArray* candidatePoints = [NSMutableArray arrayWithArray:[self emptyPointsInGame:game]];
+    GoPoint* pointToPlay = nil;
+    while (candidatePoints.count > 0)
+    {
+      NSUInteger index = random() % candidatePoints.count;
+      GoPoint* candidatePoint = [candidatePoints objectAtIndex:index];
+      [candidatePoints removeObjectAtIndex:index];
+
+      enum GoMoveIsIllegalReason illegalReason;
+      if (! [game isLegalMove:candidatePoint isIllegalReason:&illegalReason])
+        continue;
+      if ([self isSinglePointEye:candidatePoint ofColor:game.nextMoveColor])
+        continue;
+      pointToPlay = candidatePoint;
+      break;
+    }
+
+    if (! pointToPlay)
+      break;
+    [game play:pointToPlay];
+    ++numberOfMovesPlayed;
+  }
+  return numberOfMovesPlayed;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns true if all neighbours of @a point are
+/// occupied by stones of color @a color.
+// -----------------------------------------------------------------------------
+- (bool) isSinglePointEye:(GoPoint*)point ofColor:(enum GoColor)color
+{
+  for (GoPoint* neighbour in point.neighbours)
+  {
+    if (neighbour.stoneState != color)
+      return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the empty GoPoint objects of @a game's
+/// board, in the order in which GoBoard enumerates them.
+// -----------------------------------------------------------------------------
+- (NSArray*) emptyPointsInGame:(GoGame*)game
+{
+  NSMutableArray* emptyPoints = [NSMutableArray array];
+  NSEnumerator* enumerator = [game.board pointEnumerator];
+  GoPoint* point;
+  while (point = [enumerator nextObject])
+  {
+    if (! [point hasStone])
+      [emptyPoints addObject:point];
+  }
+  return emptyPoints;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Starts measuring and returns a snapshot that can
+/// later be passed to stopMeasuringAndReportOperation:count:sinceSnapshot:().
+// -----------------------------------------------------------------------------
+- (struct GoModelPerformanceSnapshot) startMeasuringWithSnapshot
+{
+  struct GoModelPerformanceSnapshot snapshot;
+  snapshot.blocksInUse = [self numberOfHeapBlocksInUse];
+  [self startMeasuring];
+  snapshot.time = CACurrentMediaTime();
+  return snapshot;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Stops measuring and logs the average time per
+/// operation and the number of heap blocks that were allocated since
+/// @a snapshot was taken and that are still in use.
+// -----------------------------------------------------------------------------
+- (void) stopMeasuringAndReportOperation:(NSString*)operationName
+                                   count:(int)numberOfOperations
+                           sinceSnapshot:(struct GoModelPerformanceSnapshot)snapshot
+{
+  CFTimeInterval elapsedTime = CACurrentMediaTime() - snapshot.time;
+  [self stopMeasuring];
+  long long blocksAllocated = (long long)[self numberOfHeapBlocksInUse] - (long long)snapshot.blocksInUse;
+
+  double microsecondsPerOperation = (numberOfOperations > 0) ? (elapsedTime * 1000000.0 / numberOfOperations) : 0.0;
+  NSLog(@"%@: %d x %@, %.1f us per operation, %lld heap blocks allocated",
+        self,
+        numberOfOperations,
+        operationName,
+        microsecondsPerOperation,
+        blocksAllocated);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the number of heap blocks that are currently
+/// in use in all malloc zones of the process.
+// -----------------------------------------------------------------------------
+- (size_t) numberOfHeapBlocksInUse
+{
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(NULL, &statistics);
+  return statistics.blocks_in_use;
+}
+
+@end
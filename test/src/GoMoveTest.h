@@ -33,6 +33,7 @@
 - (void) testCapturedStonesHandicapAndSetup;
 - (void) testDoIt;
 - (void) testUndo;
+- (void) testRedo;
 - (void) testMoveNumber;
 - (void) testGoMoveValuation;
 
@@ -393,6 +393,53 @@
   [move6 undo];
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the doIt() method when it is invoked after undo(), i.e.
+/// when a move is redone.
+// -----------------------------------------------------------------------------
+- (void) testRedo
+{
+  // White playing A1, black playing B1 and A2 and capturing A1
+  GoMove* move1 = [GoMove move:GoMoveTypePlay by:m_game.playerWhite after:nil];
+  GoPoint* point1 = [m_game.board pointAtVertex:@"A1"];
+  move1.point = point1;
+  [move1 doIt];
+  GoMove* move2 = [GoMove move:GoMoveTypePlay by:m_game.playerBlack after:move1];
+  GoPoint* point2 = [m_game.board pointAtVertex:@"B1"];
+  move2.point = point2;
+  [move2 doIt];
+  GoMove* move3 = [GoMove move:GoMoveTypePlay by:m_game.playerBlack after:move2];
+  GoPoint* point3 = [m_game.board pointAtVertex:@"A2"];
+  move3.point = point3;
+  [move3 doIt];
+  NSArray* capturedStones = move3.capturedStones;
+  XCTAssertEqual(1, capturedStones.count);
+  XCTAssertEqual(GoColorNone, point1.stoneState);
+
+  // Redo the capturing move. The captured stones array must remain the same
+  // object with the same content.
+  [move3 undo];
+  XCTAssertEqual(GoColorWhite, point1.stoneState);
+  [move3 doIt];
+  XCTAssertEqual(capturedStones, move3.capturedStones);
+  XCTAssertEqual(1, move3.capturedStones.count);
+  XCTAssertTrue([move3.capturedStones containsObject:point1]);
+  XCTAssertEqual(GoColorNone, point1.stoneState);
+  XCTAssertEqual(GoColorBlack, point3.stoneState);
+
+  // Redo a move that captures nothing
+  [move3 undo];
+  [move2 undo];
+  [move2 doIt];
+  XCTAssertEqual(0, move2.capturedStones.count);
+  XCTAssertEqual(GoColorWhite, point1.stoneState);
+
+  // Redo the capturing move when the board no longer matches
+  [move1 undo];
+  XCTAssertThrowsSpecificNamed([move3 doIt],
+                              NSException, NSInternalInconsistencyException, @"redo with different captured stones");
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the @e moveNumber property
 // -----------------------------------------------------------------------------
@@ -49,5 +49,10 @@
 - (void) testReplaceDimmings;
 - (void) testUndimEverything;
 - (void) testRemoveAllDimmings;
+- (void) testHasSymbolAtPointSymbol;
+- (void) testHasLabelAtPointLabelTypeLabelText;
+- (void) testEnumerateLabelsUsingBlock;
+- (void) testEnumerateConnectionsUsingBlock;
+- (void) testUsedMarkersOfType;
 
 @end
@@ -19,7 +19,11 @@
 #import "GoNodeMarkupTest.h"
 
 // Application includes
+#import <go/GoBoard.h>
+#import <go/GoGame.h>
 #import <go/GoNodeMarkup.h>
+#import <go/GoPoint.h>
+#import <go/GoVertex.h>
 
 
 @implementation GoNodeMarkupTest
@@ -712,4 +716,174 @@
   XCTAssertNil(testee.dimmings);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the hasSymbolAtPoint:symbol:() method.
+// -----------------------------------------------------------------------------
+- (void) testHasSymbolAtPointSymbol
+{
+  GoNodeMarkup* testee = [[[GoNodeMarkup alloc] init] autorelease];
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointB1 = [board pointAtVertex:@"B1"];
+  GoPoint* pointA2 = [board pointAtVertex:@"A2"];
+  enum GoMarkupSymbol symbol;
+
+  XCTAssertFalse([testee hasSymbols]);
+  XCTAssertFalse([testee hasSymbolAtPoint:pointA1 symbol:&symbol]);
+
+  [testee setSymbol:GoMarkupSymbolCircle atVertex:@"A1"];
+  [testee setSymbol:GoMarkupSymbolSquare atVertex:@"A2"];
+  XCTAssertTrue([testee hasSymbols]);
+  XCTAssertTrue([testee hasSymbolAtPoint:pointA1 symbol:&symbol]);
+  XCTAssertEqual(symbol, GoMarkupSymbolCircle);
+  XCTAssertTrue([testee hasSymbolAtPoint:pointA2 symbol:&symbol]);
+  XCTAssertEqual(symbol, GoMarkupSymbolSquare);
+  XCTAssertFalse([testee hasSymbolAtPoint:pointB1 symbol:&symbol]);
+  XCTAssertTrue([testee hasSymbolAtPoint:pointA1 symbol:NULL]);
+
+  [testee removeSymbolAtVertex:@"A1"];
+  XCTAssertFalse([testee hasSymbolAtPoint:pointA1 symbol:NULL]);
+  XCTAssertTrue([testee hasSymbols]);
+
+  [testee removeSymbolAtVertex:@"A2"];
+  XCTAssertFalse([testee hasSymbols]);
+  XCTAssertNil(testee.symbols);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the hasLabelAtPoint:labelType:labelText:() method.
+// -----------------------------------------------------------------------------
+- (void) testHasLabelAtPointLabelTypeLabelText
+{
+  GoNodeMarkup* testee = [[[GoNodeMarkup alloc] init] autorelease];
+  GoBoard* board = m_game.board;
+  GoPoint* pointA1 = [board pointAtVertex:@"A1"];
+  GoPoint* pointT19 = [board pointAtVertex:@"T19"];
+  enum GoMarkupLabel labelType;
+  NSString* labelText;
+
+  XCTAssertFalse([testee hasLabels]);
+  XCTAssertFalse([testee hasLabelAtPoint:pointA1 labelType:&labelType labelText:&labelText]);
+
+  [testee setLabel:GoMarkupLabelLabel labelText:@"foo" atVertex:@"A1"];
+  [testee setLabel:GoMarkupLabelMarkerNumber labelText:@"42" atVertex:@"T19"];
+  XCTAssertTrue([testee hasLabels]);
+  XCTAssertTrue([testee hasLabelAtPoint:pointA1 labelType:&labelType labelText:&labelText]);
+  XCTAssertEqual(labelType, GoMarkupLabelLabel);
+  XCTAssertEqualObjects(labelText, @"foo");
+  XCTAssertTrue([testee hasLabelAtPoint:pointT19 labelType:&labelType labelText:&labelText]);
+  XCTAssertEqual(labelType, GoMarkupLabelMarkerNumber);
+  XCTAssertEqualObjects(labelText, @"42");
+  XCTAssertTrue([testee hasLabelAtPoint:pointA1 labelType:NULL labelText:NULL]);
+
+  [testee setLabel:GoMarkupLabelLabel labelText:@"bar" atVertex:@"A1"];
+  XCTAssertTrue([testee hasLabelAtPoint:pointA1 labelType:&labelType labelText:&labelText]);
+  XCTAssertEqualObjects(labelText, @"bar");
+
+  [testee removeAllLabels];
+  XCTAssertFalse([testee hasLabels]);
+  XCTAssertFalse([testee hasLabelAtPoint:pointT19 labelType:NULL labelText:NULL]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the enumerateLabelsUsingBlock:() method.
+// -----------------------------------------------------------------------------
+- (void) testEnumerateLabelsUsingBlock
+{
+  GoNodeMarkup* testee = [[[GoNodeMarkup alloc] init] autorelease];
+
+  NSDictionary* expectedLabels = @{ @"A1": @[[NSNumber numberWithInt:GoMarkupLabelLabel], @"foo"],
+                                    @"C3": @[[NSNumber numberWithInt:GoMarkupLabelMarkerLetter], @"A"]};
+  [testee replaceLabels:expectedLabels];
+
+  NSMutableDictionary* enumeratedLabels = [NSMutableDictionary dictionary];
+  [testee enumerateLabelsUsingBlock:^(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop)
+  {
+    NSString* vertexString = [GoVertex vertexFromNumeric:vertex].string;
+    enumeratedLabels[vertexString] = @[[NSNumber numberWithInt:labelType], labelText];
+  }];
+  XCTAssertEqualObjects(enumeratedLabels, expectedLabels);
+
+  __block int numberOfInvocations = 0;
+  [testee enumerateLabelsUsingBlock:^(struct GoVertexNumeric vertex, enum GoMarkupLabel labelType, NSString* labelText, bool* stop)
+  {
+    numberOfInvocations++;
+    *stop = true;
+  }];
+  XCTAssertEqual(numberOfInvocations, 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the enumerateConnectionsUsingBlock:() method.
+// -----------------------------------------------------------------------------
+- (void) testEnumerateConnectionsUsingBlock
+{
+  GoNodeMarkup* testee = [[[GoNodeMarkup alloc] init] autorelease];
+
+  [testee enumerateConnectionsUsingBlock:^(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop)
+  {
+    XCTFail(@"Block must not be invoked if there are no connections");
+  }];
+
+  NSDictionary* expectedConnections = @{ @[@"A1", @"B1"]: @((int)GoMarkupConnectionArrow),
+                                         @[@"B1", @"A1"]: @((int)GoMarkupConnectionLine),
+                                         @[@"A1", @"T19"]: @((int)GoMarkupConnectionLine)};
+  [testee replaceConnections:expectedConnections];
+  XCTAssertTrue([testee hasConnections]);
+
+  NSMutableDictionary* enumeratedConnections = [NSMutableDictionary dictionary];
+  [testee enumerateConnectionsUsingBlock:^(struct GoVertexNumeric fromVertex, struct GoVertexNumeric toVertex, enum GoMarkupConnection connection, bool* stop)
+  {
+    NSArray* vertices = @[[GoVertex vertexFromNumeric:fromVertex].string, [GoVertex vertexFromNumeric:toVertex].string];
+    enumeratedConnections[vertices] = @((int)connection);
+  }];
+  XCTAssertEqualObjects(enumeratedConnections, expectedConnections);
+
+  [testee removeConnectionFromVertex:@"A1" toVertex:@"B1"];
+  [testee removeConnectionFromVertex:@"B1" toVertex:@"A1"];
+  [testee removeConnectionFromVertex:@"A1" toVertex:@"T19"];
+  XCTAssertFalse([testee hasConnections]);
+  XCTAssertNil(testee.connections);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the usedMarkersOfType:() method.
+// -----------------------------------------------------------------------------
+- (void) testUsedMarkersOfType
+{
+  GoNodeMarkup* testee = [[[GoNodeMarkup alloc] init] autorelease];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerLetter], 0ULL);
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerNumber], 0ULL);
+
+  [testee setLabel:GoMarkupLabelMarkerLetter labelText:@"a" atVertex:@"A1"];
+  [testee setLabel:GoMarkupLabelMarkerLetter labelText:@"C" atVertex:@"B1"];
+  [testee setLabel:GoMarkupLabelMarkerNumber labelText:@"3" atVertex:@"C1"];
+  [testee setLabel:GoMarkupLabelLabel labelText:@"foo" atVertex:@"D1"];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerLetter], (1ULL << 0) | (1ULL << 28));
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerNumber], 1ULL << (3 - gMinimumNumberMarkerValue));
+
+  // A marker that is used on two intersections remains in use until both
+  // labels are gone
+  [testee setLabel:GoMarkupLabelMarkerLetter labelText:@"a" atVertex:@"E1"];
+  [testee removeLabelAtVertex:@"A1"];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerLetter], (1ULL << 0) | (1ULL << 28));
+  [testee removeLabelAtVertex:@"E1"];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerLetter], 1ULL << 28);
+
+  // Replacing a label releases the marker of the old label
+  [testee setLabel:GoMarkupLabelMarkerNumber labelText:@"5" atVertex:@"C1"];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerNumber], 1ULL << (5 - gMinimumNumberMarkerValue));
+  [testee setLabel:GoMarkupLabelLabel labelText:@"bar" atVertex:@"C1"];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerNumber], 0ULL);
+
+  [testee replaceLabels:@{ @"A1": @[[NSNumber numberWithInt:GoMarkupLabelMarkerLetter], @"b"]}];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerLetter], 1ULL << 1);
+
+  [testee removeAllLabels];
+  XCTAssertEqual([testee usedMarkersOfType:GoMarkupLabelMarkerLetter], 0ULL);
+
+  XCTAssertThrowsSpecificNamed([testee usedMarkersOfType:GoMarkupLabelLabel],
+                               NSException, NSInvalidArgumentException, @"usedMarkersOfType: with label type that is not a marker type");
+}
+
 @end
@@ -31,6 +31,7 @@
 - (void) testCreateVariationWithNodeNextSiblingParent;
 - (void) testChangeToMainVariation;
 - (void) testChangeToVariationContainingNode;
+- (void) testChangeToVariationContainingNodeSplicesDivergentSuffix;
 - (void) testAncestorOfNodeInCurrentVariation;
 - (void) testNodeAtIndex;
 - (void) testIndexOfNode;
@@ -48,5 +49,8 @@
 - (void) testNumberOfMoves;
 - (void) testRootNode;
 - (void) testLeafNode;
+- (void) testBoardSnapshots;
+- (void) testFinishTreeChangeBatch;
+- (void) testJumpTargets;
 
 @end
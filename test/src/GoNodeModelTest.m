@@ -25,7 +25,9 @@
 #import <go/GoMove.h>
 #import <go/GoNode.h>
 #import <go/GoNodeAdditions.h>
+#import <go/GoNodeAnnotation.h>
 #import <go/GoNodeModel.h>
+#import <go/GoNodeTreeChange.h>
 #import <go/GoPoint.h>
 
 
@@ -212,6 +214,95 @@
                                NSException, NSInvalidArgumentException, @"changeToVariationContainingNode with node that is not in the game tree");
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the changeToVariationContainingNode:() method when
+/// switching between variations that share a common prefix. Only the
+/// divergent suffix is replaced, but the node indexes and the number of nodes
+/// and moves must be the same as if the node list had been rebuilt.
+// -----------------------------------------------------------------------------
+- (void) testChangeToVariationContainingNodeSplicesDivergentSuffix
+{
+  GoNodeModel* nodeModel = m_game.nodeModel;
+  GoNode* rootNode = nodeModel.rootNode;
+
+  // Schema of tree being built (nodes with a move are marked with *):
+  // R--M1--M2--M3*--M4--M5
+  //         +--S3*--S4
+  //             +---D4--D5*--D6
+  GoNode* nodeM1 = [GoNode node];
+  GoNode* nodeM2 = [GoNode node];
+  GoNode* nodeM3 = [GoNode node];
+  GoNode* nodeM4 = [GoNode node];
+  GoNode* nodeM5 = [GoNode node];
+  GoNode* nodeS3 = [GoNode node];
+  GoNode* nodeS4 = [GoNode node];
+  GoNode* nodeD4 = [GoNode node];
+  GoNode* nodeD5 = [GoNode node];
+  GoNode* nodeD6 = [GoNode node];
+  nodeM3.goMove = [GoMove move:GoMoveTypePass by:m_game.playerBlack after:nil];
+  nodeS3.goMove = [GoMove move:GoMoveTypePass by:m_game.playerBlack after:nil];
+  nodeD5.goMove = [GoMove move:GoMoveTypePass by:m_game.playerWhite after:nil];
+  [rootNode setFirstChild:nodeM1];
+  [nodeM1 setFirstChild:nodeM2];
+  [nodeM2 setFirstChild:nodeM3];
+  [nodeM3 setFirstChild:nodeM4];
+  [nodeM4 setFirstChild:nodeM5];
+  [nodeM2 appendChild:nodeS3];
+  [nodeS3 setFirstChild:nodeS4];
+  [nodeS3 appendChild:nodeD4];
+  [nodeD4 setFirstChild:nodeD5];
+  [nodeD5 setFirstChild:nodeD6];
+
+  [nodeModel changeToMainVariation];
+  [self verifyNodeModel:nodeModel containsVariation:@[rootNode, nodeM1, nodeM2, nodeM3, nodeM4, nodeM5] numberOfMoves:1];
+
+  // Switch to the sibling variation that branches off at M2
+  [nodeModel changeToVariationContainingNode:nodeS4];
+  [self verifyNodeModel:nodeModel containsVariation:@[rootNode, nodeM1, nodeM2, nodeS3, nodeS4] numberOfMoves:1];
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeM3]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeM4]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeM5]);
+
+  // Switch to the deeper variation that branches off at S3
+  [nodeModel changeToVariationContainingNode:nodeD5];
+  [self verifyNodeModel:nodeModel containsVariation:@[rootNode, nodeM1, nodeM2, nodeS3, nodeD4, nodeD5, nodeD6] numberOfMoves:2];
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeS4]);
+
+  // Switching to a node that is already in the current variation does not
+  // change anything
+  [nodeModel changeToVariationContainingNode:nodeM2];
+  [self verifyNodeModel:nodeModel containsVariation:@[rootNode, nodeM1, nodeM2, nodeS3, nodeD4, nodeD5, nodeD6] numberOfMoves:2];
+
+  // Switch back to the main line
+  [nodeModel changeToVariationContainingNode:nodeM4];
+  [self verifyNodeModel:nodeModel containsVariation:@[rootNode, nodeM1, nodeM2, nodeM3, nodeM4, nodeM5] numberOfMoves:1];
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeS3]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeD4]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeD5]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:nodeD6]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for
+/// testChangeToVariationContainingNodeSplicesDivergentSuffix(). Verifies that
+/// the current variation of @a nodeModel consists of the nodes in
+/// @a variation, that each node's index matches its position, and that the
+/// number of nodes and moves are correct.
+// -----------------------------------------------------------------------------
+- (void) verifyNodeModel:(GoNodeModel*)nodeModel containsVariation:(NSArray*)variation numberOfMoves:(int)numberOfMoves
+{
+  XCTAssertEqual(nodeModel.numberOfNodes, (int)variation.count);
+  XCTAssertEqual(nodeModel.numberOfMoves, numberOfMoves);
+  XCTAssertEqual(nodeModel.leafNode, variation.lastObject);
+  int indexOfNode = 0;
+  for (GoNode* node in variation)
+  {
+    XCTAssertEqual(node, [nodeModel nodeAtIndex:indexOfNode]);
+    XCTAssertEqual(indexOfNode, [nodeModel indexOfNode:node]);
+    indexOfNode++;
+  }
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the ancestorOfNodeInCurrentVariation:() method.
 // -----------------------------------------------------------------------------
@@ -340,6 +431,20 @@
   GoNode* nodeNotInVariation = [GoNode node];
   XCTAssertEqual(-1, [nodeModel indexOfNode:nodeNotInVariation]);
 
+  // Indexes follow the current variation when it changes
+  GoNode* node4 = [GoNode node];
+  [nodeModel createVariationWithNode:node4 nextSibling:nil parent:node1];
+  [nodeModel changeToVariationContainingNode:node4];
+  XCTAssertEqual(1, [nodeModel indexOfNode:node1]);
+  XCTAssertEqual(2, [nodeModel indexOfNode:node4]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:node2]);
+  XCTAssertEqual(-1, [nodeModel indexOfNode:node3]);
+  // Discarding node4 makes its previous sibling node2 part of the variation
+  [nodeModel discardLeafNode];
+  XCTAssertEqual(-1, [nodeModel indexOfNode:node4]);
+  XCTAssertEqual(2, [nodeModel indexOfNode:node2]);
+  XCTAssertEqual(3, [nodeModel indexOfNode:node3]);
+
   XCTAssertThrowsSpecificNamed([nodeModel indexOfNode:nil],
                                NSException, NSInvalidArgumentException, @"indexOfNode with nil object");
 }
@@ -892,4 +997,169 @@
   XCTAssertEqual(nodeModel.leafNode, rootNode);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the board snapshot methods.
+// -----------------------------------------------------------------------------
+- (void) testBoardSnapshots
+{
+  GoNodeModel* nodeModel = m_game.nodeModel;
+  nodeModel.boardSnapshotInterval = 2;
+  nodeModel.maximumNumberOfBoardSnapshots = 2;
+  for (int indexOfNode = 1; indexOfNode <= 6; ++indexOfNode)
+    [nodeModel appendNode:[GoNode node]];
+  NSData* snapshot = [NSData dataWithBytes:"x" length:1];
+
+  XCTAssertFalse([nodeModel shouldStoreBoardSnapshotAtIndex:0]);
+  XCTAssertFalse([nodeModel shouldStoreBoardSnapshotAtIndex:1]);
+  XCTAssertTrue([nodeModel shouldStoreBoardSnapshotAtIndex:2]);
+  XCTAssertEqual(-1, [nodeModel indexOfBoardSnapshotNearestToIndex:6]);
+  XCTAssertNil([nodeModel boardSnapshotAtIndex:2]);
+
+  [nodeModel storeBoardSnapshot:snapshot atIndex:2];
+  XCTAssertFalse([nodeModel shouldStoreBoardSnapshotAtIndex:2]);
+  XCTAssertEqual(snapshot, [nodeModel boardSnapshotAtIndex:2]);
+  XCTAssertEqual(-1, [nodeModel indexOfBoardSnapshotNearestToIndex:1]);
+  XCTAssertEqual(2, [nodeModel indexOfBoardSnapshotNearestToIndex:2]);
+  XCTAssertEqual(2, [nodeModel indexOfBoardSnapshotNearestToIndex:5]);
+
+  // The maximum number of snapshots displaces the snapshot with the smallest
+  // index position
+  [nodeModel storeBoardSnapshot:snapshot atIndex:4];
+  [nodeModel storeBoardSnapshot:snapshot atIndex:6];
+  XCTAssertNil([nodeModel boardSnapshotAtIndex:2]);
+  XCTAssertEqual(4, [nodeModel indexOfBoardSnapshotNearestToIndex:5]);
+  XCTAssertEqual(6, [nodeModel indexOfBoardSnapshotNearestToIndex:6]);
+  [nodeModel storeBoardSnapshot:snapshot atIndex:2];
+  XCTAssertNil([nodeModel boardSnapshotAtIndex:2]);
+
+  // Discarding nodes discards their snapshots
+  [nodeModel discardNodesFromIndex:5];
+  XCTAssertNil([nodeModel boardSnapshotAtIndex:6]);
+  XCTAssertEqual(4, [nodeModel indexOfBoardSnapshotNearestToIndex:6]);
+  [nodeModel discardBoardSnapshotsFromIndex:0];
+  XCTAssertEqual(-1, [nodeModel indexOfBoardSnapshotNearestToIndex:6]);
+
+  // Changing the variation discards the snapshots beyond the branching node
+  [nodeModel storeBoardSnapshot:snapshot atIndex:2];
+  [nodeModel storeBoardSnapshot:snapshot atIndex:4];
+  GoNode* nodeInNewVariation = [GoNode node];
+  [nodeModel createVariationWithNode:nodeInNewVariation nextSibling:nil parent:[nodeModel nodeAtIndex:2]];
+  [nodeModel changeToVariationContainingNode:nodeInNewVariation];
+  XCTAssertEqual(snapshot, [nodeModel boardSnapshotAtIndex:2]);
+  XCTAssertNil([nodeModel boardSnapshotAtIndex:4]);
+
+  // Changing the configuration discards all snapshots
+  nodeModel.boardSnapshotInterval = 3;
+  XCTAssertNil([nodeModel boardSnapshotAtIndex:2]);
+  nodeModel.boardSnapshotInterval = 0;
+  XCTAssertFalse([nodeModel shouldStoreBoardSnapshotAtIndex:3]);
+
+  XCTAssertThrowsSpecificNamed([nodeModel storeBoardSnapshot:nil atIndex:2],
+                               NSException, NSInvalidArgumentException, @"snapshot is nil");
+  XCTAssertThrowsSpecificNamed([nodeModel storeBoardSnapshot:snapshot atIndex:0],
+                               NSException, NSRangeException, @"index is root node");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the finishTreeChangeBatch() method.
+// -----------------------------------------------------------------------------
+- (void) testFinishTreeChangeBatch
+{
+  GoNodeModel* nodeModel = m_game.nodeModel;
+  GoNode* rootNode = nodeModel.rootNode;
+  XCTAssertEqual([nodeModel finishTreeChangeBatch].count, 0);
+
+  GoNode* node1 = [GoNode node];
+  GoNode* node2 = [GoNode node];
+  GoNode* node3 = [GoNode node];
+  [nodeModel appendNode:node1];
+  [nodeModel appendNode:node2];
+  [nodeModel createVariationWithNode:node3 nextSibling:nil parent:node1];
+  NSArray* treeChanges = [nodeModel finishTreeChangeBatch];
+  XCTAssertEqual(treeChanges.count, 3);
+  GoNodeTreeChange* treeChange = treeChanges[0];
+  XCTAssertEqual(treeChange.changeType, GoNodeTreeChangeTypeInsert);
+  XCTAssertEqual(treeChange.node, node1);
+  XCTAssertEqual(treeChange.parent, rootNode);
+  treeChange = treeChanges[1];
+  XCTAssertEqual(treeChange.changeType, GoNodeTreeChangeTypeInsert);
+  XCTAssertEqual(treeChange.node, node2);
+  XCTAssertEqual(treeChange.parent, node1);
+  treeChange = treeChanges[2];
+  XCTAssertEqual(treeChange.changeType, GoNodeTreeChangeTypeInsert);
+  XCTAssertEqual(treeChange.node, node3);
+  XCTAssertEqual(treeChange.parent, node1);
+
+  // A new batch starts empty
+  XCTAssertEqual([nodeModel finishTreeChangeBatch].count, 0);
+
+  [nodeModel discardNodesFromIndex:2];
+  treeChanges = [nodeModel finishTreeChangeBatch];
+  XCTAssertEqual(treeChanges.count, 1);
+  treeChange = treeChanges[0];
+  XCTAssertEqual(treeChange.changeType, GoNodeTreeChangeTypeRemove);
+  XCTAssertEqual(treeChange.node, node2);
+  XCTAssertEqual(treeChange.parent, node1);
+  XCTAssertNil(treeChange.node.parent);
+  XCTAssertEqual(node1.firstChild, node3);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the jump target methods.
+// -----------------------------------------------------------------------------
+- (void) testJumpTargets
+{
+  GoNodeModel* nodeModel = m_game.nodeModel;
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetInfo afterIndex:-1], -1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:1], -1);
+
+  GoNode* node1 = [GoNode node];
+  node1.goMove = [GoMove move:GoMoveTypePass by:m_game.playerBlack after:nil];
+  GoNode* node2 = [GoNode node];
+  GoNodeAnnotation* nodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+  nodeAnnotation.shortDescription = @"foo";
+  node2.goNodeAnnotation = nodeAnnotation;
+  GoNode* node3 = [GoNode node];
+  node3.goMove = [GoMove move:GoMoveTypePass by:m_game.playerWhite after:node1.goMove];
+  [nodeModel appendNode:node1];
+  [nodeModel appendNode:node2];
+  [nodeModel appendNode:node3];
+
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetInfo afterIndex:-1], 2);
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetInfo afterIndex:2], -1);
+  XCTAssertEqual([nodeModel indexOfPreviousNodeWithJumpTarget:GoNodeJumpTargetInfo beforeIndex:3], 2);
+  XCTAssertEqual([nodeModel indexOfPreviousNodeWithJumpTarget:GoNodeJumpTargetInfo beforeIndex:2], -1);
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetHotspot afterIndex:-1], -1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:0], -1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:1], 1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:2], 3);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:3], -1);
+
+  // Changing the content of a node requires an explicit update
+  nodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+  nodeAnnotation.goBoardPositionHotspotDesignation = GoBoardPositionHotspotDesignationYes;
+  node1.goNodeAnnotation = nodeAnnotation;
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetHotspot afterIndex:-1], -1);
+  [nodeModel updateJumpTargetsOfNode:node1];
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetHotspot afterIndex:-1], 1);
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetInfo afterIndex:-1], 2);
+
+  // Changing the variation updates the indexes of the divergent nodes
+  GoNode* node4 = [GoNode node];
+  [nodeModel createVariationWithNode:node4 nextSibling:nil parent:node1];
+  [nodeModel changeToVariationContainingNode:node4];
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetHotspot afterIndex:-1], 1);
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetInfo afterIndex:-1], -1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:1], 1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:2], -1);
+
+  [nodeModel changeToMainVariation];
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetInfo afterIndex:-1], 2);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:2], 3);
+
+  [nodeModel discardAllNodes];
+  XCTAssertEqual([nodeModel indexOfNextNodeWithJumpTarget:GoNodeJumpTargetHotspot afterIndex:-1], -1);
+  XCTAssertEqual([nodeModel indexOfNodeWithMoveNumber:1], -1);
+}
+
 @end
@@ -41,5 +41,8 @@
 - (void) testStoneStateAfterSetup;
 - (void) testStoneStatePreviousToSetup;
 - (void) testEmpty;
+- (void) testSetupStonesRoundTrip;
+- (void) testSetupStonesRoundTripAfterReplacingArrays;
+- (void) testSetupStonesRoundTripThroughNSCoding;
 
 @end
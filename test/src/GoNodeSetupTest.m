@@ -748,4 +748,189 @@
   XCTAssertTrue(testee.isEmpty);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the round trip from a black setup stone to a white setup
+/// stone to no setup stone and back again, both on an intersection that is
+/// empty in the previous setup and on an intersection that has a stone in the
+/// previous setup. The stone state queries and the setup arrays must agree at
+/// every step.
+// -----------------------------------------------------------------------------
+- (void) testSetupStonesRoundTrip
+{
+  GoBoard* board = m_game.board;
+  GoPoint* point1 = [board pointAtVertex:@"A1"];
+  GoPoint* point2 = [board pointAtVertex:@"B1"];
+
+  point2.stoneState = GoColorBlack;
+
+  GoNodeSetup* testee = [GoNodeSetup nodeSetupWithPreviousSetupCapturedFromGame:m_game];
+
+  // Intersection that is empty in the previous setup
+  [testee setupBlackStone:point1];
+  XCTAssertEqualObjects(testee.blackSetupStones, @[point1]);
+  XCTAssertNil(testee.whiteSetupStones);
+  XCTAssertNil(testee.noSetupStones);
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorBlack);
+  XCTAssertEqual([testee stoneStatePreviousToSetup:point1], GoColorNone);
+
+  // Replace the black stone with a white stone
+  [testee setupWhiteStone:point1];
+  XCTAssertNil(testee.blackSetupStones);
+  XCTAssertEqualObjects(testee.whiteSetupStones, @[point1]);
+  XCTAssertNil(testee.noSetupStones);
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorWhite);
+  XCTAssertEqual([testee stoneStatePreviousToSetup:point1], GoColorNone);
+
+  [testee setupNoStone:point1];
+  XCTAssertNil(testee.blackSetupStones);
+  XCTAssertNil(testee.whiteSetupStones);
+  XCTAssertNil(testee.noSetupStones);
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorNone);
+  XCTAssertTrue(testee.isEmpty);
+
+  [testee setupBlackStone:point1];
+  XCTAssertEqualObjects(testee.blackSetupStones, @[point1]);
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorBlack);
+
+  // Intersection that has a black stone in the previous setup
+  [testee setupWhiteStone:point2];
+  XCTAssertEqualObjects(testee.blackSetupStones, @[point1]);
+  XCTAssertEqualObjects(testee.whiteSetupStones, @[point2]);
+  XCTAssertNil(testee.noSetupStones);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorWhite);
+  XCTAssertEqual([testee stoneStatePreviousToSetup:point2], GoColorBlack);
+
+  [testee setupNoStone:point2];
+  XCTAssertNil(testee.whiteSetupStones);
+  XCTAssertEqualObjects(testee.noSetupStones, @[point2]);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorNone);
+  XCTAssertEqual([testee stoneStatePreviousToSetup:point2], GoColorBlack);
+
+  [testee setupBlackStone:point2];
+  XCTAssertEqualObjects(testee.blackSetupStones, @[point1]);
+  XCTAssertNil(testee.whiteSetupStones);
+  XCTAssertNil(testee.noSetupStones);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorBlack);
+  XCTAssertEqual([testee stoneStatePreviousToSetup:point2], GoColorBlack);
+
+  // Applying and reverting the setup must produce the same board as the
+  // stone state queries
+  [testee setupWhiteStone:point1];
+  [testee setupNoStone:point2];
+  [testee applySetup];
+  XCTAssertEqual(point1.stoneState, [testee stoneStateAfterSetup:point1]);
+  XCTAssertEqual(point2.stoneState, [testee stoneStateAfterSetup:point2]);
+  [testee revertSetup];
+  XCTAssertEqual(point1.stoneState, [testee stoneStatePreviousToSetup:point1]);
+  XCTAssertEqual(point2.stoneState, [testee stoneStatePreviousToSetup:point2]);
+  [testee applySetup];
+  XCTAssertEqual(GoColorWhite, point1.stoneState);
+  XCTAssertEqual(GoColorNone, point2.stoneState);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the stone state queries after the setup arrays were
+/// replaced wholesale with the setupValidated...() methods. Points that are no
+/// longer listed in an array must no longer be reported as set up.
+// -----------------------------------------------------------------------------
+- (void) testSetupStonesRoundTripAfterReplacingArrays
+{
+  GoBoard* board = m_game.board;
+  GoPoint* point1 = [board pointAtVertex:@"A1"];
+  GoPoint* point2 = [board pointAtVertex:@"B1"];
+
+  GoNodeSetup* testee = [GoNodeSetup nodeSetupWithPreviousSetupCapturedFromGame:m_game];
+
+  [testee setupValidatedBlackStones:@[point1]];
+  [testee setupValidatedWhiteStones:@[point2]];
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorBlack);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorWhite);
+
+  // Replace the black stone with a white stone
+  [testee setupValidatedBlackStones:@[]];
+  [testee setupValidatedWhiteStones:@[point1, point2]];
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorWhite);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorWhite);
+
+  [testee setupValidatedWhiteStones:@[]];
+  [testee setupValidatedNoStones:@[point1]];
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorNone);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorNone);
+
+  [testee setupValidatedNoStones:@[]];
+  [testee setupValidatedBlackStones:@[point2]];
+  XCTAssertEqual([testee stoneStateAfterSetup:point1], GoColorNone);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorBlack);
+
+  // The setup... methods must see the state left behind by the
+  // setupValidated...() methods
+  [testee setupWhiteStone:point2];
+  XCTAssertNil(testee.blackSetupStones);
+  XCTAssertEqualObjects(testee.whiteSetupStones, @[point2]);
+  XCTAssertEqual([testee stoneStateAfterSetup:point2], GoColorWhite);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the stone state queries after a GoNodeSetup object with
+/// black, white and no setup stones was archived and unarchived.
+// -----------------------------------------------------------------------------
+- (void) testSetupStonesRoundTripThroughNSCoding
+{
+  GoBoard* board = m_game.board;
+  GoPoint* point1 = [board pointAtVertex:@"A1"];
+  GoPoint* point2 = [board pointAtVertex:@"B1"];
+  GoPoint* point3 = [board pointAtVertex:@"C1"];
+  GoPoint* point4 = [board pointAtVertex:@"D1"];
+
+  point3.stoneState = GoColorBlack;
+  point4.stoneState = GoColorWhite;
+
+  GoNodeSetup* archivedNodeSetup = [GoNodeSetup nodeSetupWithPreviousSetupCapturedFromGame:m_game];
+  [archivedNodeSetup setupBlackStone:point1];
+  // Replace the black stone with a white stone
+  [archivedNodeSetup setupWhiteStone:point1];
+  [archivedNodeSetup setupBlackStone:point2];
+  [archivedNodeSetup setupNoStone:point3];
+  [archivedNodeSetup setupBlackStone:point4];
+
+  Class nodeSetupClass = [GoNodeSetup class];
+  NSString* topLevelKey = @"the top level key";
+
+  NSKeyedArchiver* archiver = [[NSKeyedArchiver alloc] initRequiringSecureCoding:YES];
+  [archiver encodeObject:archivedNodeSetup forKey:topLevelKey];
+  [archiver finishEncoding];
+  NSData* data = archiver.encodedData;
+  [archiver release];
+
+  NSKeyedUnarchiver* unarchiver = [[NSKeyedUnarchiver alloc] initForReadingFromData:data
+                                                                              error:nil];
+  unarchiver.decodingFailurePolicy = NSDecodingFailurePolicyRaiseException;
+  GoNodeSetup* unarchivedNodeSetup = [unarchiver decodeObjectOfClass:nodeSetupClass forKey:topLevelKey];
+  [unarchiver finishDecoding];
+  [unarchiver release];
+
+  XCTAssertNotNil(unarchivedNodeSetup);
+  XCTAssertEqual(unarchivedNodeSetup.blackSetupStones.count, 2);
+  XCTAssertEqual(unarchivedNodeSetup.whiteSetupStones.count, 1);
+  XCTAssertEqual(unarchivedNodeSetup.noSetupStones.count, 1);
+
+  // The unarchived GoNodeSetup refers to GoPoint objects that belong to the
+  // unarchived board
+  GoBoard* unarchivedBoard = ((GoPoint*)unarchivedNodeSetup.whiteSetupStones.firstObject).board;
+  XCTAssertNotNil(unarchivedBoard);
+  NSArray* vertexes = @[@"A1", @"B1", @"C1", @"D1", @"E1"];
+  for (NSString* vertex in vertexes)
+  {
+    GoPoint* archivedPoint = [board pointAtVertex:vertex];
+    GoPoint* unarchivedPoint = [unarchivedBoard pointAtVertex:vertex];
+    XCTAssertEqual([unarchivedNodeSetup stoneStateAfterSetup:unarchivedPoint],
+                   [archivedNodeSetup stoneStateAfterSetup:archivedPoint], @"%@", vertex);
+    XCTAssertEqual([unarchivedNodeSetup stoneStatePreviousToSetup:unarchivedPoint],
+                   [archivedNodeSetup stoneStatePreviousToSetup:archivedPoint], @"%@", vertex);
+  }
+  XCTAssertEqual([unarchivedNodeSetup stoneStateAfterSetup:[unarchivedBoard pointAtVertex:@"A1"]], GoColorWhite);
+  XCTAssertEqual([unarchivedNodeSetup stoneStateAfterSetup:[unarchivedBoard pointAtVertex:@"C1"]], GoColorNone);
+  XCTAssertEqual([unarchivedNodeSetup stoneStateAfterSetup:[unarchivedBoard pointAtVertex:@"D1"]], GoColorBlack);
+}
+
 @end
@@ -64,14 +64,19 @@
 - (void) testSetParent;
 - (void) testIsDescendantOfNode;
 - (void) testIsAncestorOfNode;
+- (void) testCommonAncestorWithNode;
+- (void) testAncestorRelationshipsInDeepNodeTree;
 - (void) testHasNextSibling;
 - (void) testHasPreviousSibling;
 - (void) testHasParent;
 - (void) testIsRoot;
 - (void) testIsLeaf;
 - (void) testEmpty;
+- (void) testAncestorInformation;
 - (void) testModifyBoard;
 - (void) testRevertBoard;
 - (void) testCalculateZobristHash;
+- (void) testUpdateZobristHashAndPropagateToSubtree;
+- (void) testMoveSuggestion;
 
 @end
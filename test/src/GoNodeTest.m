@@ -889,6 +889,89 @@
                                NSException, NSInvalidArgumentException, @"isAncestorOfNode: node cannot be nil");
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the commonAncestorWithNode:() method.
+// -----------------------------------------------------------------------------
+- (void) testCommonAncestorWithNode
+{
+  [self setupNodeTree];
+
+  XCTAssertEqual([self.nodeA2a commonAncestorWithNode:self.nodeA2c], self.nodeA2);
+  XCTAssertEqual([self.nodeA2a commonAncestorWithNode:self.nodeA3], self.nodeA);
+  XCTAssertEqual([self.nodeA3 commonAncestorWithNode:self.nodeA2a], self.nodeA);
+  XCTAssertEqual([self.nodeA2b commonAncestorWithNode:self.nodeC], self.rootNode);
+  XCTAssertEqual([self.nodeA2b commonAncestorWithNode:self.nodeA], self.nodeA);
+  XCTAssertEqual([self.nodeA commonAncestorWithNode:self.nodeA2b], self.nodeA);
+  XCTAssertEqual([self.nodeA commonAncestorWithNode:self.nodeA], self.nodeA);
+  XCTAssertEqual([self.rootNode commonAncestorWithNode:self.rootNode], self.rootNode);
+
+  XCTAssertNil([self.nodeA2a commonAncestorWithNode:self.freeNode1]);
+  XCTAssertNil([self.freeNode1 commonAncestorWithNode:self.freeNode2]);
+
+  // Moving a sub tree changes the result
+  [self.nodeC appendChild:self.nodeA2];
+  XCTAssertEqual([self.nodeA2a commonAncestorWithNode:self.nodeA3], self.rootNode);
+  XCTAssertEqual([self.nodeA2a commonAncestorWithNode:self.nodeC], self.nodeC);
+
+  XCTAssertThrowsSpecificNamed([self.rootNode commonAncestorWithNode:nil],
+                               NSException, NSInvalidArgumentException, @"commonAncestorWithNode: node cannot be nil");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the @e numberOfAncestors property and the ancestor
+/// relationship methods in a node tree that is deep enough for the jump
+/// pointers to skip many nodes.
+// -----------------------------------------------------------------------------
+- (void) testAncestorRelationshipsInDeepNodeTree
+{
+  int numberOfNodesInMainVariation = 1000;
+  int numberOfAncestorsOfBranchingNode = 333;
+
+  GoNode* rootNode = [GoNode node];
+  NSMutableArray* mainVariation = [NSMutableArray arrayWithObject:rootNode];
+  for (int indexOfNode = 1; indexOfNode < numberOfNodesInMainVariation; ++indexOfNode)
+  {
+    GoNode* node = [GoNode node];
+    [mainVariation.lastObject setFirstChild:node];
+    [mainVariation addObject:node];
+  }
+
+  GoNode* branchingNode = [mainVariation objectAtIndex:numberOfAncestorsOfBranchingNode];
+  GoNode* nodeInOtherVariation = branchingNode;
+  for (int indexOfNode = 0; indexOfNode < 100; ++indexOfNode)
+  {
+    GoNode* node = [GoNode node];
+    [nodeInOtherVariation appendChild:node];
+    nodeInOtherVariation = node;
+  }
+
+  GoNode* leafNode = mainVariation.lastObject;
+  XCTAssertEqual(rootNode.numberOfAncestors, 0);
+  XCTAssertEqual(leafNode.numberOfAncestors, numberOfNodesInMainVariation - 1);
+  XCTAssertEqual(nodeInOtherVariation.numberOfAncestors, numberOfAncestorsOfBranchingNode + 100);
+
+  for (int indexOfNode = 0; indexOfNode < numberOfNodesInMainVariation; ++indexOfNode)
+  {
+    GoNode* node = [mainVariation objectAtIndex:indexOfNode];
+    XCTAssertEqual(node.numberOfAncestors, indexOfNode);
+    XCTAssertEqual([node isAncestorOfNode:leafNode], node != leafNode);
+    XCTAssertEqual([leafNode isDescendantOfNode:node], node != leafNode);
+    XCTAssertEqual([node isAncestorOfNode:nodeInOtherVariation], indexOfNode <= numberOfAncestorsOfBranchingNode);
+    GoNode* expectedCommonAncestor = (indexOfNode <= numberOfAncestorsOfBranchingNode) ? node : branchingNode;
+    XCTAssertEqual([node commonAncestorWithNode:nodeInOtherVariation], expectedCommonAncestor);
+    XCTAssertEqual([nodeInOtherVariation commonAncestorWithNode:node], expectedCommonAncestor);
+  }
+
+  // Removing a sub tree discards the cached values of the entire sub tree
+  GoNode* newRootNode = [mainVariation objectAtIndex:500];
+  [[mainVariation objectAtIndex:499] setFirstChild:nil];
+  XCTAssertEqual(newRootNode.numberOfAncestors, 0);
+  XCTAssertEqual(leafNode.numberOfAncestors, numberOfNodesInMainVariation - 1 - 500);
+  XCTAssertTrue([newRootNode isAncestorOfNode:leafNode]);
+  XCTAssertFalse([rootNode isAncestorOfNode:leafNode]);
+  XCTAssertNil([rootNode commonAncestorWithNode:leafNode]);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the @e hasNextSibling property.
 // -----------------------------------------------------------------------------
@@ -1019,6 +1102,142 @@
   XCTAssertTrue(nextSibling.isLeaf);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the @e previousSibling back-link after a series of tree
+/// manipulations.
+// -----------------------------------------------------------------------------
+- (void) testPreviousSiblingBackLink
+{
+  [self setupNodeTree];
+
+  XCTAssertNil(self.nodeA2a.previousSibling);
+  XCTAssertEqual(self.nodeA2b.previousSibling, self.nodeA2a);
+  XCTAssertEqual(self.nodeA2c.previousSibling, self.nodeA2b);
+
+  // Removing a node in the middle relinks its neighbours
+  [self.nodeA2 removeChild:self.nodeA2b];
+  XCTAssertEqual(self.nodeA2c.previousSibling, self.nodeA2a);
+
+  // Inserting a node in front of the first child
+  [self.nodeA2 insertChild:self.freeNode1 beforeReferenceChild:self.nodeA2a];
+  XCTAssertNil(self.freeNode1.previousSibling);
+  XCTAssertEqual(self.nodeA2a.previousSibling, self.freeNode1);
+
+  // Removing the first child makes the next sibling the new first child
+  [self.nodeA2 removeChild:self.freeNode1];
+  XCTAssertNil(self.freeNode1.previousSibling);
+  XCTAssertNil(self.nodeA2a.previousSibling);
+
+  // Moving a node to a different parent
+  [self.nodeB appendChild:self.nodeA2c];
+  XCTAssertNil(self.nodeA2c.previousSibling);
+  XCTAssertFalse(self.nodeA2a.hasNextSibling);
+
+  // Replacing a child
+  [self.nodeA replaceChild:self.nodeA2 withNewChild:self.freeNode2];
+  XCTAssertEqual(self.freeNode2.previousSibling, self.nodeA1);
+  XCTAssertEqual(self.nodeA3.previousSibling, self.freeNode2);
+  XCTAssertNil(self.nodeA2.previousSibling);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the enumerateChildrenUsingBlock:() method.
+// -----------------------------------------------------------------------------
+- (void) testEnumerateChildrenUsingBlock
+{
+  [self setupNodeTree];
+
+  NSMutableArray* enumeratedNodes = [NSMutableArray array];
+  [self.nodeA enumerateChildrenUsingBlock:^(GoNode* child, bool* stop)
+  {
+    [enumeratedNodes addObject:child];
+  }];
+  NSArray* expectedNodes = @[self.nodeA1, self.nodeA2, self.nodeA3];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+
+  [enumeratedNodes removeAllObjects];
+  [self.nodeA enumerateChildrenUsingBlock:^(GoNode* child, bool* stop)
+  {
+    [enumeratedNodes addObject:child];
+    *stop = (child == self.nodeA2);
+  }];
+  expectedNodes = @[self.nodeA1, self.nodeA2];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+
+  [enumeratedNodes removeAllObjects];
+  [self.nodeA1 enumerateChildrenUsingBlock:^(GoNode* child, bool* stop)
+  {
+    [enumeratedNodes addObject:child];
+  }];
+  XCTAssertEqual(enumeratedNodes.count, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the enumerateSubtreeInPreorderUsingBlock:() method.
+// -----------------------------------------------------------------------------
+- (void) testEnumerateSubtreeInPreorderUsingBlock
+{
+  [self setupNodeTree];
+
+  NSMutableArray* enumeratedNodes = [NSMutableArray array];
+  [self.rootNode enumerateSubtreeInPreorderUsingBlock:^(GoNode* node, bool* stop)
+  {
+    [enumeratedNodes addObject:node];
+  }];
+  NSArray* expectedNodes = @[self.rootNode, self.nodeA, self.nodeA1, self.nodeA2, self.nodeA2a, self.nodeA2b, self.nodeA2c, self.nodeA3, self.nodeB, self.nodeC];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+
+  // The siblings of the node where the enumeration starts are not part of the
+  // sub tree
+  [enumeratedNodes removeAllObjects];
+  [self.nodeA2 enumerateSubtreeInPreorderUsingBlock:^(GoNode* node, bool* stop)
+  {
+    [enumeratedNodes addObject:node];
+  }];
+  expectedNodes = @[self.nodeA2, self.nodeA2a, self.nodeA2b, self.nodeA2c];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+
+  [enumeratedNodes removeAllObjects];
+  [self.nodeA3 enumerateSubtreeInPreorderUsingBlock:^(GoNode* node, bool* stop)
+  {
+    [enumeratedNodes addObject:node];
+  }];
+  expectedNodes = @[self.nodeA3];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+
+  [enumeratedNodes removeAllObjects];
+  [self.rootNode enumerateSubtreeInPreorderUsingBlock:^(GoNode* node, bool* stop)
+  {
+    [enumeratedNodes addObject:node];
+    *stop = (node == self.nodeA2a);
+  }];
+  expectedNodes = @[self.rootNode, self.nodeA, self.nodeA1, self.nodeA2, self.nodeA2a];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the enumerateAncestorsUsingBlock:() method.
+// -----------------------------------------------------------------------------
+- (void) testEnumerateAncestorsUsingBlock
+{
+  [self setupNodeTree];
+
+  NSMutableArray* enumeratedNodes = [NSMutableArray array];
+  [self.nodeA2b enumerateAncestorsUsingBlock:^(GoNode* ancestor, bool* stop)
+  {
+    [enumeratedNodes addObject:ancestor];
+  }];
+  NSArray* expectedNodes = @[self.nodeA2, self.nodeA, self.rootNode];
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+
+  [enumeratedNodes removeAllObjects];
+  [self.rootNode enumerateAncestorsUsingBlock:^(GoNode* ancestor, bool* stop)
+  {
+    [enumeratedNodes addObject:ancestor];
+  }];
+  XCTAssertEqual(enumeratedNodes.count, 0);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the @e empty property.
 // -----------------------------------------------------------------------------
@@ -1057,6 +1276,71 @@
   XCTAssertTrue(testee.isEmpty);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the @e numberOfMovesBeforeNode, @e nodeWithMostRecentMove
+/// and @e nodeWithMostRecentBoardStateChange properties, in particular that
+/// their cached values are discarded when the game tree changes.
+// -----------------------------------------------------------------------------
+- (void) testAncestorInformation
+{
+  GoNode* rootNode = [GoNode node];
+  GoNode* setupNode = [GoNode node];
+  GoNode* moveNode1 = [GoNode node];
+  GoNode* emptyNode = [GoNode node];
+  GoNode* moveNode2 = [GoNode node];
+  [rootNode setFirstChild:setupNode];
+  [setupNode setFirstChild:moveNode1];
+  [moveNode1 setFirstChild:emptyNode];
+  [emptyNode setFirstChild:moveNode2];
+
+  XCTAssertEqual(moveNode2.numberOfMovesBeforeNode, 0);
+  XCTAssertNil(moveNode2.nodeWithMostRecentMove);
+  XCTAssertNil(moveNode2.nodeWithMostRecentBoardStateChange);
+
+  // Changing node data discards the cached values of descendants
+  setupNode.goNodeSetup = [[[GoNodeSetup alloc] init] autorelease];
+  moveNode1.goMove = [GoMove move:GoMoveTypePass by:m_game.playerBlack after:nil];
+  moveNode2.goMove = [GoMove move:GoMoveTypePass by:m_game.playerWhite after:moveNode1.goMove];
+  XCTAssertEqual(rootNode.numberOfMovesBeforeNode, 0);
+  XCTAssertNil(rootNode.nodeWithMostRecentMove);
+  XCTAssertNil(rootNode.nodeWithMostRecentBoardStateChange);
+  XCTAssertEqual(setupNode.numberOfMovesBeforeNode, 0);
+  XCTAssertNil(setupNode.nodeWithMostRecentMove);
+  XCTAssertEqual(setupNode.nodeWithMostRecentBoardStateChange, setupNode);
+  XCTAssertEqual(moveNode1.numberOfMovesBeforeNode, 0);
+  XCTAssertEqual(moveNode1.nodeWithMostRecentMove, moveNode1);
+  XCTAssertEqual(moveNode1.nodeWithMostRecentBoardStateChange, moveNode1);
+  XCTAssertEqual(emptyNode.numberOfMovesBeforeNode, 1);
+  XCTAssertEqual(emptyNode.nodeWithMostRecentMove, moveNode1);
+  XCTAssertEqual(emptyNode.nodeWithMostRecentBoardStateChange, moveNode1);
+  XCTAssertEqual(moveNode2.numberOfMovesBeforeNode, 1);
+  XCTAssertEqual(moveNode2.nodeWithMostRecentMove, moveNode2);
+
+  moveNode1.goMove = nil;
+  XCTAssertEqual(emptyNode.numberOfMovesBeforeNode, 0);
+  XCTAssertNil(emptyNode.nodeWithMostRecentMove);
+  XCTAssertEqual(emptyNode.nodeWithMostRecentBoardStateChange, setupNode);
+  XCTAssertEqual(moveNode2.numberOfMovesBeforeNode, 0);
+
+  // Moving a sub tree discards the cached values of the entire sub tree
+  GoNode* otherMoveNode = [GoNode node];
+  otherMoveNode.goMove = [GoMove move:GoMoveTypePass by:m_game.playerBlack after:nil];
+  [rootNode appendChild:otherMoveNode];
+  XCTAssertEqual(otherMoveNode.numberOfMovesBeforeNode, 0);
+  [otherMoveNode appendChild:emptyNode];
+  XCTAssertEqual(emptyNode.numberOfMovesBeforeNode, 1);
+  XCTAssertEqual(emptyNode.nodeWithMostRecentMove, otherMoveNode);
+  XCTAssertEqual(emptyNode.nodeWithMostRecentBoardStateChange, otherMoveNode);
+  XCTAssertEqual(moveNode2.numberOfMovesBeforeNode, 1);
+  XCTAssertEqual(moveNode2.nodeWithMostRecentMove, moveNode2);
+
+  [otherMoveNode removeChild:emptyNode];
+  XCTAssertEqual(emptyNode.numberOfMovesBeforeNode, 0);
+  XCTAssertNil(emptyNode.nodeWithMostRecentMove);
+  XCTAssertNil(emptyNode.nodeWithMostRecentBoardStateChange);
+  XCTAssertEqual(moveNode2.numberOfMovesBeforeNode, 0);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the modifyBoard() method.
 // -----------------------------------------------------------------------------
@@ -1251,4 +1535,110 @@
   XCTAssertEqual(zobristHashAnnotationsAndMarkup, zobristHashMove);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the updateZobristHashAndPropagateToSubtree:() method.
+// -----------------------------------------------------------------------------
+- (void) testUpdateZobristHashAndPropagateToSubtree
+{
+  GoBoard* board = m_game.board;
+  GoPoint* point1 = [board pointAtVertex:@"A1"];
+  GoPoint* point2 = [board pointAtVertex:@"B1"];
+  GoPoint* point3 = [board pointAtVertex:@"C1"];
+
+  [m_game addEmptyNodeToCurrentGameVariation];
+  GoNode* nodeWithSetupInformation = m_game.nodeModel.leafNode;
+  nodeWithSetupInformation.goNodeSetup = [GoNodeSetup nodeSetupWithPreviousSetupCapturedFromGame:m_game];
+  [nodeWithSetupInformation.goNodeSetup setupBlackStone:point1];
+  [nodeWithSetupInformation modifyBoard];
+  [nodeWithSetupInformation calculateZobristHash:m_game];
+
+  [m_game addEmptyNodeToCurrentGameVariation];
+  GoNode* emptyNode = m_game.nodeModel.leafNode;
+  [emptyNode modifyBoard];
+  [emptyNode calculateZobristHash:m_game];
+
+  [m_game addEmptyNodeToCurrentGameVariation];
+  GoNode* nodeWithMove = m_game.nodeModel.leafNode;
+  nodeWithMove.goMove = [GoMove move:GoMoveTypePlay by:m_game.playerWhite after:nil];
+  nodeWithMove.goMove.point = point2;
+  [nodeWithMove modifyBoard];
+  [nodeWithMove calculateZobristHash:m_game];
+
+  // A second branch below the setup node
+  GoNode* siblingNode = [GoNode node];
+  [nodeWithSetupInformation appendChild:siblingNode];
+  [siblingNode calculateZobristHash:m_game];
+
+  long long zobristHashMoveBeforeChange = nodeWithMove.zobristHash;
+
+  // Nothing changed - hashes must remain the same
+  [nodeWithSetupInformation updateZobristHashAndPropagateToSubtree:m_game];
+  XCTAssertEqual(nodeWithMove.zobristHash, zobristHashMoveBeforeChange);
+
+  [nodeWithSetupInformation.goNodeSetup setupBlackStone:point3];
+  [nodeWithSetupInformation updateZobristHashAndPropagateToSubtree:m_game];
+  XCTAssertNotEqual(nodeWithMove.zobristHash, zobristHashMoveBeforeChange);
+
+  // The propagated hashes must be the same as hashes that are calculated
+  // from scratch
+  NSArray* descendantNodes = @[emptyNode, nodeWithMove, siblingNode];
+  for (GoNode* descendantNode in descendantNodes)
+  {
+    long long propagatedZobristHash = descendantNode.zobristHash;
+    [descendantNode calculateZobristHash:m_game];
+    XCTAssertEqual(descendantNode.zobristHash, propagatedZobristHash);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the storeMoveSuggestion:komi:(),
+/// moveSuggestionForColor:komi:() and discardMoveSuggestion() methods.
+// -----------------------------------------------------------------------------
+- (void) testMoveSuggestion
+{
+  GoBoard* board = m_game.board;
+  GoPoint* point1 = [board pointAtVertex:@"A1"];
+  GoPoint* point2 = [board pointAtVertex:@"Q16"];
+
+  [m_game addEmptyNodeToCurrentGameVariation];
+  GoNode* node = m_game.nodeModel.leafNode;
+  node.goNodeSetup = [GoNodeSetup nodeSetupWithPreviousSetupCapturedFromGame:m_game];
+  [node.goNodeSetup setupBlackStone:point1];
+  [node modifyBoard];
+  [node calculateZobristHash:m_game];
+
+  double komi = 6.5;
+  XCTAssertNil([node moveSuggestionForColor:GoColorBlack komi:komi]);
+
+  NSDictionary* moveSuggestion =
+  @{
+    moveSuggestionColorKey : [NSNumber numberWithInt:GoColorBlack],
+    moveSuggestionTypeKey : [NSNumber numberWithInt:MoveSuggestionTypePlay],
+    moveSuggestionPointKey : point2,
+    moveSuggestionErrorMessageKey : [NSNull null],
+  };
+  [node storeMoveSuggestion:moveSuggestion komi:komi];
+  XCTAssertEqual([node moveSuggestionForColor:GoColorBlack komi:komi], moveSuggestion);
+  XCTAssertNil([node moveSuggestionForColor:GoColorWhite komi:komi]);
+  XCTAssertNil([node moveSuggestionForColor:GoColorBlack komi:komi + 1.0]);
+
+  // Nodes do not share move suggestions, even if they have the same board
+  // position
+  GoNode* siblingNode = [GoNode node];
+  [node.parent appendChild:siblingNode];
+  siblingNode.zobristHash = node.zobristHash;
+  XCTAssertNil([siblingNode moveSuggestionForColor:GoColorBlack komi:komi]);
+
+  // Changing the setup changes the board position, so the move suggestion is
+  // no longer valid
+  [node.goNodeSetup setupWhiteStone:point2];
+  [node updateZobristHashAndPropagateToSubtree:m_game];
+  XCTAssertNil([node moveSuggestionForColor:GoColorBlack komi:komi]);
+
+  [node storeMoveSuggestion:moveSuggestion komi:komi];
+  XCTAssertEqual([node moveSuggestionForColor:GoColorBlack komi:komi], moveSuggestion);
+  [node discardMoveSuggestion];
+  XCTAssertNil([node moveSuggestionForColor:GoColorBlack komi:komi]);
+}
+
 @end
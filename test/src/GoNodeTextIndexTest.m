@@ -0,0 +1,175 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "GoNodeTextIndexTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoNode.h>
+#import <go/GoNodeAnnotation.h>
+#import <go/GoNodeMarkup.h>
+#import <go/GoNodeModel.h>
+#import <go/GoNodeTextIndex.h>
+
+
+@implementation GoNodeTextIndexTest
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the nodesMatchingText:() method.
+// -----------------------------------------------------------------------------
+- (void) testNodesMatchingText
+{
+  GoNode* node1 = [self playMove:@"D4" withComment:@"A classic Opening move"];
+  GoNode* node2 = [self playMove:@"Q16" withComment:@"The opponent's reply is also an opening move, but it is slow"];
+  GoNode* node3 = [self playMove:@"C3" withComment:@"Der Gegner spielt hier sehr langsam. Ein schöner Zug!"];
+  [self playMove:@"R17" withComment:nil];
+  GoNode* node5 = [m_game.nodeModel leafNode];
+  node5.goNodeMarkup = [[[GoNodeMarkup alloc] init] autorelease];
+  [node5.goNodeMarkup setLabel:GoMarkupLabelLabel labelText:@"tesuji" atVertex:@"C4"];
+  [node5.goNodeMarkup setLabel:GoMarkupLabelMarkerLetter labelText:@"A" atVertex:@"C5"];
+
+  // The index is built on the first search
+  GoNodeTextIndex* nodeTextIndex = m_game.nodeTextIndex;
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"opening"], (@[node1, node2]));
+
+  // Case and diacritics are ignored
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"OPENING"], (@[node1, node2]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"schoner"], (@[node3]));
+
+  // All words must match, each of them as a prefix
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"opening slow"], (@[node2]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"op"], (@[node1, node2]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"opening fast"], (@[]));
+
+  // Labels are indexed, but markers are not
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"tesuji"], (@[node5]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"a"], (@[node1, node2]));
+
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@""], (@[]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"  "], (@[]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:nil], (@[]));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the updateNode:() method.
+// -----------------------------------------------------------------------------
+- (void) testUpdateNode
+{
+  GoNodeTextIndex* nodeTextIndex = m_game.nodeTextIndex;
+  GoNode* node1 = [self playMove:@"D4" withComment:@"Joseki"];
+
+  // Updates are ignored as long as the index has not been built
+  [nodeTextIndex updateNode:node1];
+  [nodeTextIndex buildIndex];
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"joseki"], (@[node1]));
+
+  // A node that gets its first comment after the index was built
+  GoNode* node2 = [self playMove:@"Q16" withComment:@"Joseki again"];
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"joseki"], (@[node1]));
+  [nodeTextIndex updateNode:node2];
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"joseki"], (@[node1, node2]));
+
+  // Changing a comment replaces the indexed words
+  node1.goNodeAnnotation.longDescription = @"Fuseki";
+  [nodeTextIndex updateNode:node1];
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"joseki"], (@[node2]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"fuseki"], (@[node1]));
+
+  // Removing a comment removes the indexed words
+  node2.goNodeAnnotation = nil;
+  [nodeTextIndex updateNode:node2];
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"joseki"], (@[]));
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"again"], (@[]));
+
+  // Building the index again picks up all comments, regardless of whether
+  // updateNode:() was invoked
+  node2.goNodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+  node2.goNodeAnnotation.longDescription = @"Fuseki again";
+  [nodeTextIndex buildIndex];
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"fuseki"], (@[node1, node2]));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that nodes which were discarded from the game tree after they
+/// were indexed are not found.
+// -----------------------------------------------------------------------------
+- (void) testDiscardedNodesAreNotFound
+{
+  GoNode* node1 = [self playMove:@"D4" withComment:@"Good move"];
+  [self playMove:@"Q16" withComment:@"Another good move"];
+  GoNodeTextIndex* nodeTextIndex = m_game.nodeTextIndex;
+  [nodeTextIndex buildIndex];
+
+  m_game.boardPosition.currentBoardPosition--;
+  m_game.boardPosition.numberOfBoardPositions--;
+  [m_game.nodeModel discardLeafNode];
+
+  XCTAssertEqualObjects([nodeTextIndex nodesMatchingText:@"good"], (@[node1]));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the searchForText:completionHandler:() method.
+// -----------------------------------------------------------------------------
+- (void) testSearchForText
+{
+  GoNode* node1 = [self playMove:@"D4" withComment:@"Ladder breaker"];
+  GoNodeTextIndex* nodeTextIndex = m_game.nodeTextIndex;
+
+  __block NSArray* nodesFound = nil;
+  __block int numberOfCompletionHandlerInvocations = 0;
+  void (^completionHandler)(NSArray* nodes) = ^(NSArray* nodes)
+  {
+    ++numberOfCompletionHandlerInvocations;
+    nodesFound = [[nodes retain] autorelease];
+  };
+
+  // The completion handler of a search that is superseded by a newer search is
+  // not invoked
+  [nodeTextIndex searchForText:@"la" completionHandler:completionHandler];
+  [nodeTextIndex searchForText:@"ladder" completionHandler:completionHandler];
+
+  NSDate* timeoutDate = [NSDate dateWithTimeIntervalSinceNow:5.0];
+  while (numberOfCompletionHandlerInvocations == 0 && [timeoutDate timeIntervalSinceNow] > 0)
+    [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+
+  XCTAssertEqual(numberOfCompletionHandlerInvocations, 1);
+  XCTAssertEqualObjects(nodesFound, (@[node1]));
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Plays a move at @a vertex, then sets @a comment as
+/// the long description of the node that contains the move. Returns the node.
+// -----------------------------------------------------------------------------
+- (GoNode*) playMove:(NSString*)vertex withComment:(NSString*)comment
+{
+  [m_game play:[m_game.board pointAtVertex:vertex]];
+  GoNode* node = m_game.nodeModel.leafNode;
+  if (comment)
+  {
+    node.goNodeAnnotation = [[[GoNodeAnnotation alloc] init] autorelease];
+    node.goNodeAnnotation.longDescription = comment;
+  }
+  return node;
+}
+
+@end
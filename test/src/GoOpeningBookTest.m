@@ -0,0 +1,149 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "GoOpeningBookTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoOpeningBook.h>
+#import <go/GoPoint.h>
+#import <go/GoVertex.h>
+
+
+@implementation GoOpeningBookTest
+
+// -----------------------------------------------------------------------------
+/// @brief Writes @a bookContent to a temporary file and returns a
+/// GoOpeningBook object that has loaded the file.
+// -----------------------------------------------------------------------------
+- (GoOpeningBook*) openingBookWithContent:(NSString*)bookContent
+{
+  NSString* bookFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"GoOpeningBookTest.dat"];
+  [bookContent writeToFile:bookFilePath atomically:YES encoding:NSUTF8StringEncoding error:nil];
+  GoOpeningBook* openingBook = [[[GoOpeningBook alloc] init] autorelease];
+  XCTAssertTrue([openingBook loadBookFileAtPath:bookFilePath]);
+  [[NSFileManager defaultManager] removeItemAtPath:bookFilePath error:nil];
+  return openingBook;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the loadBookFileAtPath:() method.
+// -----------------------------------------------------------------------------
+- (void) testLoadBookFile
+{
+  GoOpeningBook* openingBook = [[[GoOpeningBook alloc] init] autorelease];
+  XCTAssertEqual(openingBook.numberOfPositions, 0);
+  XCTAssertNil([openingBook moveForGame:m_game]);
+  XCTAssertFalse([openingBook loadBookFileAtPath:@"/nonexistent/book.dat"]);
+
+  // Lines with unsupported board sizes or invalid vertexes are skipped. The
+  // two 9x9 lines lead to board positions that are rotations of each other.
+  NSString* bookContent = @"19 | Q4\n19 Q4 | Q16\n9 C3 | G7\n9 G7 | C3\n5 | C3\n19 Z9 | Q4\n";
+  openingBook = [self openingBookWithContent:bookContent];
+  XCTAssertEqual(openingBook.numberOfPositions, 3);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the loadBookFileAtPath:indexFilePath:() method.
+// -----------------------------------------------------------------------------
+- (void) testLoadBookFileWithIndexFile
+{
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  NSString* bookFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"GoOpeningBookTest.dat"];
+  NSString* indexFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"GoOpeningBookTest.idx"];
+  [fileManager removeItemAtPath:indexFilePath error:nil];
+
+  // The first load compiles the index and writes it to the index file
+  [@"19 | Q4\n" writeToFile:bookFilePath atomically:YES encoding:NSUTF8StringEncoding error:nil];
+  GoOpeningBook* openingBook = [[[GoOpeningBook alloc] init] autorelease];
+  XCTAssertTrue([openingBook loadBookFileAtPath:bookFilePath indexFilePath:indexFilePath]);
+  XCTAssertTrue([fileManager fileExistsAtPath:indexFilePath]);
+  XCTAssertEqual(openingBook.numberOfPositions, 1);
+  XCTAssertEqualObjects([openingBook moveForGame:m_game].vertex.string, @"Q4");
+
+  // Replace the book with a book of the same size and modification date. The
+  // index file still matches, so the second load uses the index file and
+  // does not parse the book.
+  NSDate* modificationDate = [[fileManager attributesOfItemAtPath:bookFilePath error:nil] fileModificationDate];
+  [@"19 | D4\n" writeToFile:bookFilePath atomically:YES encoding:NSUTF8StringEncoding error:nil];
+  [fileManager setAttributes:@{NSFileModificationDate: modificationDate} ofItemAtPath:bookFilePath error:nil];
+  openingBook = [[[GoOpeningBook alloc] init] autorelease];
+  XCTAssertTrue([openingBook loadBookFileAtPath:bookFilePath indexFilePath:indexFilePath]);
+  XCTAssertEqual(openingBook.numberOfPositions, 1);
+  XCTAssertEqualObjects([openingBook moveForGame:m_game].vertex.string, @"Q4");
+
+  // A different modification date invalidates the index file
+  [fileManager setAttributes:@{NSFileModificationDate: [modificationDate dateByAddingTimeInterval:60]} ofItemAtPath:bookFilePath error:nil];
+  openingBook = [[[GoOpeningBook alloc] init] autorelease];
+  XCTAssertTrue([openingBook loadBookFileAtPath:bookFilePath indexFilePath:indexFilePath]);
+  XCTAssertEqualObjects([openingBook moveForGame:m_game].vertex.string, @"D4");
+
+  // A damaged index file is ignored and replaced
+  [[NSData dataWithBytes:"garbage" length:7] writeToFile:indexFilePath atomically:YES];
+  openingBook = [[[GoOpeningBook alloc] init] autorelease];
+  XCTAssertTrue([openingBook loadBookFileAtPath:bookFilePath indexFilePath:indexFilePath]);
+  XCTAssertEqualObjects([openingBook moveForGame:m_game].vertex.string, @"D4");
+
+  [fileManager removeItemAtPath:bookFilePath error:nil];
+  [fileManager removeItemAtPath:indexFilePath error:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the moveForGame:() method.
+// -----------------------------------------------------------------------------
+- (void) testMoveForGame
+{
+  GoOpeningBook* openingBook = [self openingBookWithContent:@"19 | Q4\n19 Q4 | Q16\n"];
+
+  GoPoint* point = [openingBook moveForGame:m_game];
+  XCTAssertNotNil(point);
+  XCTAssertEqualObjects(point.vertex.string, @"Q4");
+
+  [m_game play:point];
+  point = [openingBook moveForGame:m_game];
+  XCTAssertNotNil(point);
+  XCTAssertEqualObjects(point.vertex.string, @"Q16");
+
+  // Out of book
+  [m_game play:point];
+  XCTAssertNil([openingBook moveForGame:m_game]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the moveForGame:() method with a board position that is a
+/// rotation or reflection of a board position in the opening book.
+// -----------------------------------------------------------------------------
+- (void) testMoveForGameInSymmetricBoardPosition
+{
+  GoOpeningBook* openingBook = [self openingBookWithContent:@"19 Q4 | Q16\n"];
+
+  // D16 is the book move Q4 rotated by 180 degrees, but also Q4 reflected at
+  // the diagonal A1-T19. The book reply Q16 is therefore transformed into
+  // either D4 or Q16.
+  [m_game play:[m_game.board pointAtVertex:@"D16"]];
+  GoPoint* point = [openingBook moveForGame:m_game];
+  XCTAssertNotNil(point);
+  XCTAssertTrue([point.vertex.string isEqualToString:@"D4"] || [point.vertex.string isEqualToString:@"Q16"]);
+
+  // Out of book
+  [m_game play:[m_game.board pointAtVertex:@"K10"]];
+  XCTAssertNil([openingBook moveForGame:m_game]);
+}
+
+@end
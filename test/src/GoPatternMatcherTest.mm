@@ -0,0 +1,269 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "GoPatternMatcherTest.h"
+
+// Application includes
+#import <go/GoPatternMatcher.h>
+
+// C++ standard library
+#include <stdexcept>
+#include <vector>
+
+
+/// @brief The board size used by most tests.
+static const int boardSize = 9;
+
+
+@implementation GoPatternMatcherTest
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the GoPatternMatcher constructor with invalid arguments.
+// -----------------------------------------------------------------------------
+- (void) testInvalidArguments
+{
+  std::vector<GoPatternMatcher::PatternCell> patternCells = { GoPatternMatcher::PatternCellBlack };
+
+  bool didThrow = false;
+  try
+  {
+    GoPatternMatcher patternMatcher(boardSize, 0, 1, patternCells, GoPatternMatcher::PatternEdgeNone, false);
+  }
+  catch (std::invalid_argument&)
+  {
+    didThrow = true;
+  }
+  XCTAssertTrue(didThrow, @"pattern width 0");
+
+  didThrow = false;
+  try
+  {
+    GoPatternMatcher patternMatcher(boardSize, 2, 1, patternCells, GoPatternMatcher::PatternEdgeNone, false);
+  }
+  catch (std::invalid_argument&)
+  {
+    didThrow = true;
+  }
+  XCTAssertTrue(didThrow, @"number of cells does not match pattern dimensions");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the getNumberOfPlacements() method. The number of
+/// placements reveals how many distinct orientations of a pattern the
+/// GoPatternMatcher has generated.
+// -----------------------------------------------------------------------------
+- (void) testNumberOfPlacements
+{
+  // A single cell is identical in all 8 orientations
+  GoPatternMatcher singleCell(boardSize, 1, 1, { GoPatternMatcher::PatternCellBlack }, GoPatternMatcher::PatternEdgeNone, false);
+  XCTAssertEqual(singleCell.getBoardSize(), boardSize);
+  XCTAssertEqual(singleCell.getNumberOfPlacements(), 81);
+  GoPatternMatcher singleCellSwapped(boardSize, 1, 1, { GoPatternMatcher::PatternCellBlack }, GoPatternMatcher::PatternEdgeNone, true);
+  XCTAssertEqual(singleCellSwapped.getNumberOfPlacements(), 162);
+
+  // Two different cells side by side have 4 distinct orientations, 2
+  // horizontal and 2 vertical ones. Each of them has 8 x 9 placements.
+  GoPatternMatcher twoCells(boardSize, 2, 1, { GoPatternMatcher::PatternCellBlack, GoPatternMatcher::PatternCellEmpty }, GoPatternMatcher::PatternEdgeNone, false);
+  XCTAssertEqual(twoCells.getNumberOfPlacements(), 4 * 72);
+
+  // A corner pattern fits into each of the 4 corners exactly once
+  GoPatternMatcher corner(boardSize, 1, 1, { GoPatternMatcher::PatternCellBlack }, GoPatternMatcher::PatternEdgeLeft | GoPatternMatcher::PatternEdgeBottom, false);
+  XCTAssertEqual(corner.getNumberOfPlacements(), 4);
+
+  // A side pattern fits along each of the 4 sides
+  GoPatternMatcher side(boardSize, 1, 1, { GoPatternMatcher::PatternCellBlack }, GoPatternMatcher::PatternEdgeBottom, false);
+  XCTAssertEqual(side.getNumberOfPlacements(), 4 * 9);
+
+  // Patterns that do not fit onto the board have no placements
+  std::vector<GoPatternMatcher::PatternCell> largePatternCells(10 * 1, GoPatternMatcher::PatternCellAny);
+  GoPatternMatcher tooLarge(boardSize, 10, 1, largePatternCells, GoPatternMatcher::PatternEdgeNone, false);
+  XCTAssertEqual(tooLarge.getNumberOfPlacements(), 0);
+  GoPatternMatcher oppositeEdges(boardSize, 1, 1, { GoPatternMatcher::PatternCellBlack }, GoPatternMatcher::PatternEdgeLeft | GoPatternMatcher::PatternEdgeRight, false);
+  XCTAssertEqual(oppositeEdges.getNumberOfPlacements(), 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the findFirstMatch() method with a pattern that must be
+/// rotated or reflected to match.
+// -----------------------------------------------------------------------------
+- (void) testSymmetricMatches
+{
+  // Black stone with a white stone to the right
+  GoPatternMatcher patternMatcher(boardSize, 2, 1, { GoPatternMatcher::PatternCellBlack, GoPatternMatcher::PatternCellWhite }, GoPatternMatcher::PatternEdgeNone, false);
+
+  // As specified
+  std::vector<unsigned short> gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E5"], @[@"W F5"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+
+  // Reflected: White is to the left
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E5"], @[@"W D5"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+
+  // Rotated: White is above and below
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E5"], @[@"W E6"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E5"], @[@"W E4"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+
+  // Diagonal is not a match
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E5"], @[@"W F6"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), -1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the findFirstMatch() method with and without swapped
+/// colors.
+// -----------------------------------------------------------------------------
+- (void) testSwappedColors
+{
+  std::vector<GoPatternMatcher::PatternCell> patternCells = { GoPatternMatcher::PatternCellBlack, GoPatternMatcher::PatternCellBlack, GoPatternMatcher::PatternCellWhite };
+  GoPatternMatcher patternMatcher(boardSize, 3, 1, patternCells, GoPatternMatcher::PatternEdgeNone, false);
+  GoPatternMatcher patternMatcherSwapped(boardSize, 3, 1, patternCells, GoPatternMatcher::PatternEdgeNone, true);
+
+  std::vector<unsigned short> gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B C3"], @[@"W E3"], @[@"B D3"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 3);
+  XCTAssertEqual(patternMatcherSwapped.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 3);
+
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"W C3", @"W D3"], @[@"B E3"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), -1);
+  XCTAssertEqual(patternMatcherSwapped.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the findFirstMatch() method with a pattern that must lie
+/// on one edge of the board.
+// -----------------------------------------------------------------------------
+- (void) testEdgePatterns
+{
+  // Black stone on the first line, with an empty intersection above it
+  std::vector<GoPatternMatcher::PatternCell> patternCells = { GoPatternMatcher::PatternCellBlack, GoPatternMatcher::PatternCellEmpty };
+  GoPatternMatcher patternMatcher(boardSize, 1, 2, patternCells, GoPatternMatcher::PatternEdgeBottom, false);
+
+  std::vector<unsigned short> gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E2"], @[@"B E5"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), -1);
+
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E2"], @[@"B E1"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), -1, @"the intersection next to the edge stone must be empty");
+
+  // The other three edges
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"W E5"], @[@"B A5"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B J5"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 1);
+  gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E9"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 1);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the findFirstMatch() method with a pattern that must lie
+/// in a corner of the board.
+// -----------------------------------------------------------------------------
+- (void) testCornerPatterns
+{
+  // Black stone on the 3-3 point
+  std::vector<GoPatternMatcher::PatternCell> patternCells(3 * 3, GoPatternMatcher::PatternCellAny);
+  patternCells[2 * 3 + 2] = GoPatternMatcher::PatternCellBlack;
+  GoPatternMatcher patternMatcher(boardSize, 3, 3, patternCells, GoPatternMatcher::PatternEdgeLeft | GoPatternMatcher::PatternEdgeBottom, false);
+
+  NSArray* matchingVertexes = @[@"C3", @"G3", @"C7", @"G7"];
+  for (NSString* vertex in matchingVertexes)
+  {
+    NSString* move = [@"B " stringByAppendingString:vertex];
+    std::vector<unsigned short> gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"W E5"], @[move]]];
+    XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2, @"%@", vertex);
+  }
+
+  NSArray* nonMatchingVertexes = @[@"C4", @"D3", @"C5", @"B2", @"E5"];
+  for (NSString* vertex in nonMatchingVertexes)
+  {
+    NSString* move = [@"B " stringByAppendingString:vertex];
+    std::vector<unsigned short> gameRecord = [self gameRecordWithBoardPositions:@[@[], @[move]]];
+    XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), -1, @"%@", vertex);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the interpretation of game records by findFirstMatch():
+/// removed stones, changes after the last board position, and an empty game
+/// record.
+// -----------------------------------------------------------------------------
+- (void) testGameRecord
+{
+  // Black stone with an empty intersection to the right
+  GoPatternMatcher patternMatcher(boardSize, 2, 1, { GoPatternMatcher::PatternCellBlack, GoPatternMatcher::PatternCellEmpty }, GoPatternMatcher::PatternEdgeNone, false);
+
+  // Black E5 is surrounded in board position 1, the white stone on F5 is
+  // captured in board position 2
+  std::vector<unsigned short> gameRecord = [self gameRecordWithBoardPositions:@[@[], @[@"B E5", @"W D5", @"W F5", @"W E4", @"W E6"], @[@"E F5"]]];
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), 2);
+
+  // Changes after the last board position are ignored
+  gameRecord = [self gameRecordWithBoardPositions:@[@[]]];
+  gameRecord.push_back(GoPatternMatcher::getGameRecordEntry([self indexOfVertex:@"E5"], GoBoardCore::StoneStateBlack));
+  XCTAssertEqual(patternMatcher.findFirstMatch(gameRecord.data(), static_cast<int>(gameRecord.size())), -1);
+
+  XCTAssertEqual(patternMatcher.findFirstMatch(nullptr, 0), -1);
+}
+
+#pragma mark - Helper methods
+
+// -----------------------------------------------------------------------------
+/// @brief Returns a game record for a 9x9 board. @a boardPositions contains
+/// one array per board position. Each element of such an array is a string
+/// that consists of a color ("B", "W", or "E" for empty), a space, and a
+/// vertex, e.g. "B C3".
+// -----------------------------------------------------------------------------
+- (std::vector<unsigned short>) gameRecordWithBoardPositions:(NSArray*)boardPositions
+{
+  std::vector<unsigned short> gameRecord;
+  for (NSArray* changes in boardPositions)
+  {
+    for (NSString* change in changes)
+    {
+      NSArray* components = [change componentsSeparatedByString:@" "];
+      NSString* color = components[0];
+      GoBoardCore::StoneState stoneState;
+      if ([color isEqualToString:@"B"])
+        stoneState = GoBoardCore::StoneStateBlack;
+      else if ([color isEqualToString:@"W"])
+        stoneState = GoBoardCore::StoneStateWhite;
+      else
+        stoneState = GoBoardCore::StoneStateNone;
+      gameRecord.push_back(GoPatternMatcher::getGameRecordEntry([self indexOfVertex:components[1]], stoneState));
+    }
+    gameRecord.push_back(GoPatternMatcher::endOfBoardPosition);
+  }
+  return gameRecord;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the index of the intersection identified by @a vertex on a
+/// 9x9 board, e.g. "C3". The letter "I" is not used.
+// -----------------------------------------------------------------------------
+- (int) indexOfVertex:(NSString*)vertex
+{
+  unichar letter = [vertex characterAtIndex:0];
+  int x = letter - 'A' + 1;
+  if (letter > 'I')
+    --x;
+  int y = [vertex substringFromIndex:1].intValue;
+  GoBoardCore boardCore(boardSize);
+  return boardCore.getIndexOfVertex(x, y);
+}
+
+@end
@@ -0,0 +1,41 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BaseTestCase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GoScoreTest class contains unit tests that exercise the GoScore
+/// class.
+///
+/// The tests toggle the state of stone groups and check that the incremental
+/// score calculation that follows each toggle operation arrives at the same
+/// result as a full calculation. The full calculation is done by the test
+/// itself, based on the territory map that GoBoard's territory kernel
+/// calculates for the entire board.
+// -----------------------------------------------------------------------------
+@interface GoScoreTest : BaseTestCase
+{
+}
+
+- (void) testToggleDeadState;
+- (void) testToggleDeadStateIntelligently;
+- (void) testToggleSekiState;
+- (void) testToggleWithTerritoryScoring;
+
+@end
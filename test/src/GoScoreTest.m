@@ -0,0 +1,275 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "GoScoreTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoBoardRegion.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoGameRules.h>
+#import <go/GoPoint.h>
+#import <go/GoScore.h>
+#import <main/ApplicationDelegate.h>
+#import <play/model/ScoringModel.h>
+#import <ui/UiSettingsModel.h>
+
+
+@implementation GoScoreTest
+
+// -----------------------------------------------------------------------------
+/// @brief Sets up scoring so that the GTP engine does not participate, and so
+/// that toggling a stone group does not toggle other stone groups.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+
+  m_delegate.scoringModel.askGtpEngineForDeadStones = false;
+  m_delegate.scoringModel.markDeadStonesIntelligently = false;
+}
+
+#pragma mark - Tests
+
+// -----------------------------------------------------------------------------
+/// @brief Toggles stone groups from alive to dead and back.
+// -----------------------------------------------------------------------------
+- (void) testToggleDeadState
+{
+  GoScore* score = [self setupPositionAndEnableScoring];
+
+  int territoryBlackBefore = score.territoryBlack;
+  [self toggleDeadStateAtVertex:@"B2" score:score];
+  XCTAssertEqual([self stoneGroupAtVertex:@"B2"].stoneGroupState, GoStoneGroupStateDead);
+  XCTAssertTrue(score.territoryBlack > territoryBlackBefore);
+  XCTAssertEqual(score.deadWhite, 1);
+
+  [self toggleDeadStateAtVertex:@"S19" score:score];
+  XCTAssertEqual(score.deadBlack, 1);
+
+  // Toggling back must restore the original counts
+  [self toggleDeadStateAtVertex:@"B2" score:score];
+  XCTAssertEqual(score.deadWhite, 0);
+  [self toggleDeadStateAtVertex:@"S19" score:score];
+  XCTAssertEqual(score.deadBlack, 0);
+  XCTAssertEqual(score.territoryBlack, territoryBlackBefore);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Toggles stone groups from alive to dead and back while the user
+/// preference "mark dead stones intelligently" is enabled, so that a single
+/// toggle operation may change the state of several stone groups.
+// -----------------------------------------------------------------------------
+- (void) testToggleDeadStateIntelligently
+{
+  m_delegate.scoringModel.markDeadStonesIntelligently = true;
+  GoScore* score = [self setupPositionAndEnableScoring];
+
+  [self toggleDeadStateAtVertex:@"B2" score:score];
+  [self toggleDeadStateAtVertex:@"S19" score:score];
+  [self toggleDeadStateAtVertex:@"C3" score:score];
+  [self toggleDeadStateAtVertex:@"C3" score:score];
+  [self toggleDeadStateAtVertex:@"Q19" score:score];
+  [self toggleDeadStateAtVertex:@"B2" score:score];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Toggles stone groups into and out of seki, and toggles between dead
+/// and seki.
+// -----------------------------------------------------------------------------
+- (void) testToggleSekiState
+{
+  GoScore* score = [self setupPositionAndEnableScoring];
+
+  [self toggleSekiStateAtVertex:@"S19" score:score];
+  XCTAssertEqual([self stoneGroupAtVertex:@"S19"].stoneGroupState, GoStoneGroupStateSeki);
+
+  [self toggleDeadStateAtVertex:@"S19" score:score];
+  XCTAssertEqual([self stoneGroupAtVertex:@"S19"].stoneGroupState, GoStoneGroupStateDead);
+
+  [self toggleSekiStateAtVertex:@"S19" score:score];
+  XCTAssertEqual([self stoneGroupAtVertex:@"S19"].stoneGroupState, GoStoneGroupStateSeki);
+
+  [self toggleSekiStateAtVertex:@"B2" score:score];
+  [self toggleSekiStateAtVertex:@"C3" score:score];
+  [self toggleSekiStateAtVertex:@"C3" score:score];
+  [self toggleSekiStateAtVertex:@"B2" score:score];
+
+  [self toggleSekiStateAtVertex:@"S19" score:score];
+  XCTAssertEqual([self stoneGroupAtVertex:@"S19"].stoneGroupState, GoStoneGroupStateAlive);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Repeats a mix of toggle operations with territory scoring, where
+/// stones in seki and the empty regions next to them do not count.
+// -----------------------------------------------------------------------------
+- (void) testToggleWithTerritoryScoring
+{
+  m_game.rules.scoringSystem = GoScoringSystemTerritoryScoring;
+  GoScore* score = [self setupPositionAndEnableScoring];
+
+  [self toggleDeadStateAtVertex:@"B2" score:score];
+  [self toggleSekiStateAtVertex:@"S19" score:score];
+  [self toggleSekiStateAtVertex:@"B2" score:score];
+  [self toggleDeadStateAtVertex:@"S19" score:score];
+  [self toggleSekiStateAtVertex:@"Q19" score:score];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Plays the moves that set up the following position
+/// in the lower-left and in the upper-right corner of the board, then enables
+/// scoring and performs a first, full calculation. Returns the GoScore object
+/// of the game.
+///
+/// The black stones in the lower-left corner enclose a white stone on B2, the
+/// white stones in the upper-right corner enclose a black stone on S19.
+///
+/// @verbatim
+///    Q R S T                 A B C
+/// 19 O . X .              3  X X X
+/// 18 O O O O              2  . O X
+///                         1  . . X
+/// @endverbatim
+// -----------------------------------------------------------------------------
+- (GoScore*) setupPositionAndEnableScoring
+{
+  NSArray* vertexes = @[@"A3", @"Q19", @"B3", @"Q18", @"C3", @"R18",
+                        @"C2", @"S18", @"C1", @"T18", @"S19", @"B2"];
+  for (NSString* vertex in vertexes)
+    [m_game play:[m_game.board pointAtVertex:vertex]];
+
+  m_delegate.uiSettingsModel.uiAreaPlayMode = UIAreaPlayModeScoring;
+  GoScore* score = m_game.score;
+  [score enableScoring];
+  [score calculateWaitUntilDone:true];
+  [self assertScoreMatchesFullCalculation:score];
+
+  // The first calculation may have marked stone groups as being in seki. The
+  // tests want to start with all stone groups alive.
+  for (GoBoardRegion* region in m_game.board.regions)
+  {
+    if (region.stoneGroupState == GoStoneGroupStateSeki)
+      [score toggleSekiStateOfStoneGroup:region];
+  }
+  [score calculateWaitUntilDone:true];
+  [self assertScoreMatchesFullCalculation:score];
+
+  return score;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the stone group that contains the stone on
+/// the intersection @a vertex.
+// -----------------------------------------------------------------------------
+- (GoBoardRegion*) stoneGroupAtVertex:(NSString*)vertex
+{
+  return [m_game.board pointAtVertex:vertex].region;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Toggles the dead state of the stone group on the
+/// intersection @a vertex, recalculates the score and checks the result.
+// -----------------------------------------------------------------------------
+- (void) toggleDeadStateAtVertex:(NSString*)vertex score:(GoScore*)score
+{
+  [score toggleDeadStateOfStoneGroup:[self stoneGroupAtVertex:vertex]];
+  [score calculateWaitUntilDone:true];
+  [self assertScoreMatchesFullCalculation:score];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Toggles the seki state of the stone group on the
+/// intersection @a vertex, recalculates the score and checks the result.
+// -----------------------------------------------------------------------------
+- (void) toggleSekiStateAtVertex:(NSString*)vertex score:(GoScore*)score
+{
+  [score toggleSekiStateOfStoneGroup:[self stoneGroupAtVertex:vertex]];
+  [score calculateWaitUntilDone:true];
+  [self assertScoreMatchesFullCalculation:score];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Checks that the territory color of every
+/// GoBoardRegion and the area, territory and dead stone counts of @a score
+/// are the same as the ones that a full calculation produces.
+///
+/// The full calculation classifies every region of the board according to the
+/// territory map of the entire board, and then counts the regions in the same
+/// way as GoScore.
+// -----------------------------------------------------------------------------
+- (void) assertScoreMatchesFullCalculation:(GoScore*)score
+{
+  GoBoard* board = m_game.board;
+  NSData* territoryMap = [board territoryMapWithScoringSystem:m_game.rules.scoringSystem];
+  const unsigned char* territoryMapEntries = territoryMap.bytes;
+  XCTAssertEqualObjects(score.territoryMap, territoryMap);
+
+  int territoryBlack = 0;
+  int territoryWhite = 0;
+  int aliveBlack = 0;
+  int aliveWhite = 0;
+  int deadBlack = 0;
+  int deadWhite = 0;
+  for (GoBoardRegion* region in board.regions)
+  {
+    unsigned char territoryMapEntry = territoryMapEntries[[board indexOfPoint:region.points.firstObject]];
+    enum GoColor territoryColor = (enum GoColor)(territoryMapEntry & GoTerritoryMapEntryColorMask);
+    bool territoryInconsistencyFound = (territoryMapEntry & GoTerritoryMapEntryInconsistentFlag) != 0;
+    XCTAssertEqual(region.territoryColor, territoryColor, @"%@", region);
+    XCTAssertEqual(region.territoryInconsistencyFound, territoryInconsistencyFound, @"%@", region);
+
+    int regionSize = [region size];
+    if (! [region isStoneGroup])
+    {
+      if (territoryColor == GoColorBlack)
+        territoryBlack += regionSize;
+      else if (territoryColor == GoColorWhite)
+        territoryWhite += regionSize;
+    }
+    else if (region.stoneGroupState == GoStoneGroupStateDead)
+    {
+      if (territoryColor == GoColorBlack)
+        territoryBlack += regionSize;
+      else if (territoryColor == GoColorWhite)
+        territoryWhite += regionSize;
+      if ([region color] == GoColorBlack)
+        deadBlack += regionSize;
+      else
+        deadWhite += regionSize;
+    }
+    else
+    {
+      if (territoryColor == GoColorBlack)
+        aliveBlack += regionSize;
+      else if (territoryColor == GoColorWhite)
+        aliveWhite += regionSize;
+    }
+  }
+
+  XCTAssertEqual(score.territoryBlack, territoryBlack);
+  XCTAssertEqual(score.territoryWhite, territoryWhite);
+  XCTAssertEqual(score.aliveBlack, aliveBlack);
+  XCTAssertEqual(score.aliveWhite, aliveWhite);
+  XCTAssertEqual(score.deadBlack, deadBlack);
+  XCTAssertEqual(score.deadWhite, deadWhite);
+}
+
+@end
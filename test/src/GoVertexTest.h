@@ -30,5 +30,6 @@
 - (void) testLowerCaseString;
 - (void) testBorderCases;
 - (void) testIllegalInputValues;
+- (void) testInterning;
 
 @end
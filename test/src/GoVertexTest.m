@@ -238,4 +238,28 @@
                               NSException, NSInvalidArgumentException, @"test 17");
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Tests that convenience constructors return interned GoVertex
+/// objects.
+// -----------------------------------------------------------------------------
+- (void) testInterning
+{
+  struct GoVertexNumeric inputNumericVertex;
+  inputNumericVertex.x = 10;
+  inputNumericVertex.y = 11;
+
+  GoVertex* vertex1 = [GoVertex vertexFromNumeric:inputNumericVertex];
+  GoVertex* vertex2 = [GoVertex vertexFromNumeric:inputNumericVertex];
+  GoVertex* vertex3 = [GoVertex vertexFromString:@"K11"];
+  GoVertex* vertex4 = [GoVertex vertexFromString:@"k11"];
+  XCTAssertEqual(vertex1, vertex2);
+  XCTAssertEqual(vertex1, vertex3);
+  XCTAssertEqual(vertex1, vertex4);
+  XCTAssertEqual(vertex1.string, vertex3.string);
+  XCTAssertTrue([vertex1.string isEqualToString:@"K11"]);
+
+  GoVertex* vertex5 = [GoVertex vertexFromString:@"K12"];
+  XCTAssertNotEqual(vertex1, vertex5);
+}
+
 @end
@@ -28,13 +28,18 @@
 }
 
 - (void) testInitialState;
+- (void) testSharedZobristTableForBoardSize;
+- (void) testHashIsReproducible;
 - (void) testHashForBoard;
 - (void) testHashForHandicapStonesInGame;
+- (void) testHashForFixedHandicapLayout;
 - (void) testHashForNodeInGame;
 - (void) testHashForSetup;
 - (void) testHashForStone;
 - (void) testHashForLastMoveEqualsHashForBoard;
 - (void) testHashAfterPass;
 - (void) testHashAfterUndoAndRedo;
+- (void) testSymmetryHashes;
+- (void) testCanonicalHashIsInvariantUnderSymmetries;
 
 @end
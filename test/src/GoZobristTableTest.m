@@ -20,6 +20,7 @@
 
 // Application includes
 #import <go/GoBoard.h>
+#import <go/GoBoardTopology.h>
 #import <go/GoGame.h>
 #import <go/GoGameAdditions.h>
 #import <go/GoMove.h>
@@ -28,6 +29,7 @@
 #import <go/GoNodeSetup.h>
 #import <go/GoPlayer.h>
 #import <go/GoPoint.h>
+#import <go/GoUtilities.h>
 #import <go/GoZobristTable.h>
 
 
@@ -42,6 +44,44 @@
   XCTAssertNotNil(m_game.board.zobristTable);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the sharedZobristTableForBoardSize:() class method.
+// -----------------------------------------------------------------------------
+- (void) testSharedZobristTableForBoardSize
+{
+  GoZobristTable* zobristTable = m_game.board.zobristTable;
+  XCTAssertEqual(zobristTable, [GoZobristTable sharedZobristTableForBoardSize:m_game.board.size]);
+
+  enum GoBoardSize otherBoardSize = (m_game.board.size == GoBoardSize7 ? GoBoardSize9 : GoBoardSize7);
+  GoZobristTable* otherZobristTable = [GoZobristTable sharedZobristTableForBoardSize:otherBoardSize];
+  XCTAssertNotNil(otherZobristTable);
+  XCTAssertTrue(otherZobristTable != zobristTable);
+  XCTAssertEqual(otherZobristTable, [GoZobristTable sharedZobristTableForBoardSize:otherBoardSize]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that Zobrist hashes are reproducible, i.e. that they do not
+/// depend on which GoZobristTable object calculates them, nor on when they are
+/// calculated.
+// -----------------------------------------------------------------------------
+- (void) testHashIsReproducible
+{
+  GoBoard* board = m_game.board;
+  GoZobristTable* zobristTable = board.zobristTable;
+  GoZobristTable* otherZobristTable = [[[GoZobristTable alloc] initWithBoardSize:board.size] autorelease];
+
+  [m_game play:[board pointAtVertex:@"A1"]];
+  // This is the first value generated by the pseudo random number generator.
+  // If this test fails then Zobrist hashes that were persisted by an earlier
+  // version of the app are no longer valid.
+  long long expectedHash = -855962197472104183LL;
+  XCTAssertEqual(expectedHash, [zobristTable hashForBoard:board]);
+  XCTAssertEqual(expectedHash, [otherZobristTable hashForBoard:board]);
+
+  [m_game play:[board pointAtVertex:@"Q16"]];
+  XCTAssertEqual([zobristTable hashForBoard:board], [otherZobristTable hashForBoard:board]);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the hashForBoard:() method.
 // -----------------------------------------------------------------------------
@@ -106,6 +146,36 @@
                                NSException, NSGenericException, @"hashForHandicapStonesInGame:() accepts wrong board size");
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the hashForHandicapStonesInGame:() method with handicap
+/// stones in the fixed handicap layout, for which a precomputed hash is used.
+// -----------------------------------------------------------------------------
+- (void) testHashForFixedHandicapLayout
+{
+  GoBoard* board = m_game.board;
+  GoZobristTable* zobristTable = board.zobristTable;
+  int maximumHandicap = [GoUtilities maximumHandicapForBoardSize:board.size];
+
+  for (int handicap = 2; handicap <= maximumHandicap; ++handicap)
+  {
+    NSArray* handicapPoints = [GoUtilities pointsForHandicap:handicap inGame:m_game];
+    XCTAssertEqual(handicapPoints.count, handicap);
+
+    // The reversed order does not match the fixed handicap layout, so the hash
+    // is calculated from the individual handicap stones
+    m_game.handicapPoints = handicapPoints.reverseObjectEnumerator.allObjects;
+    long long hashCalculated = [zobristTable hashForHandicapStonesInGame:m_game];
+
+    m_game.handicapPoints = handicapPoints;
+    long long hashPrecomputed = [zobristTable hashForHandicapStonesInGame:m_game];
+    XCTAssertEqual(hashPrecomputed, hashCalculated);
+    XCTAssertEqual(m_game.zobristHashAfterHandicap, hashPrecomputed);
+  }
+
+  m_game.handicapPoints = @[];
+  XCTAssertEqual([zobristTable hashForHandicapStonesInGame:m_game], 0);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the hashForNode:inGame:() method.
 // -----------------------------------------------------------------------------
@@ -484,6 +554,98 @@
   XCTAssertEqual(hashForMove2, hash);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the symmetryHashes:forBoard:() and
+/// updateSymmetryHashes:forStoneAtIndex:withColor:() methods.
+// -----------------------------------------------------------------------------
+- (void) testSymmetryHashes
+{
+  GoBoard* board = m_game.board;
+  GoZobristTable* zobristTable = board.zobristTable;
+  long long symmetryHashes[GoBoardSymmetryMax];
+
+  [zobristTable symmetryHashes:symmetryHashes forBoard:board];
+  for (int symmetry = 0; symmetry < GoBoardSymmetryMax; ++symmetry)
+    XCTAssertEqual(symmetryHashes[symmetry], 0);
+
+  [m_game play:[board pointAtVertex:@"B2"]];
+  [m_game play:[board pointAtVertex:@"F7"]];
+  [m_game play:[board pointAtVertex:@"C5"]];
+  [zobristTable symmetryHashes:symmetryHashes forBoard:board];
+  XCTAssertEqual(symmetryHashes[GoBoardSymmetryIdentity], [zobristTable hashForBoard:board]);
+  for (int symmetry = 1; symmetry < GoBoardSymmetryMax; ++symmetry)
+    XCTAssertTrue(symmetryHashes[symmetry] != symmetryHashes[GoBoardSymmetryIdentity]);
+
+  // The incrementally updated symmetry hashes of the board must match the
+  // symmetry hashes calculated from scratch
+  enum GoBoardSymmetry symmetry;
+  long long canonicalHash = [GoZobristTable canonicalHashForSymmetryHashes:symmetryHashes symmetry:&symmetry];
+  enum GoBoardSymmetry boardSymmetry;
+  XCTAssertEqual([board canonicalZobristHashWithSymmetry:&boardSymmetry], canonicalHash);
+  XCTAssertEqual(boardSymmetry, symmetry);
+
+  // Removing a stone is the same operation as adding it
+  int index = [board indexOfPoint:[board pointAtVertex:@"C5"]];
+  [zobristTable updateSymmetryHashes:symmetryHashes forStoneAtIndex:index withColor:GoColorBlack];
+  [m_game.lastMove undo];
+  long long expectedSymmetryHashes[GoBoardSymmetryMax];
+  [zobristTable symmetryHashes:expectedSymmetryHashes forBoard:board];
+  for (int symmetry = 0; symmetry < GoBoardSymmetryMax; ++symmetry)
+    XCTAssertEqual(symmetryHashes[symmetry], expectedSymmetryHashes[symmetry]);
+  XCTAssertEqual([board canonicalZobristHashWithSymmetry:NULL],
+                 [GoZobristTable canonicalHashForSymmetryHashes:expectedSymmetryHashes symmetry:NULL]);
+
+  GoZobristTable* zobristTableWithDifferentBoardSize = [self zobristTableWithBoardSizeDifferentFromGame:m_game];
+  XCTAssertThrowsSpecificNamed([zobristTableWithDifferentBoardSize symmetryHashes:symmetryHashes forBoard:board],
+                               NSException, NSGenericException, @"symmetryHashes:forBoard:() accepts wrong board size");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that the canonical Zobrist hash is the same for all rotations
+/// and reflections of a board position, and that the symmetry returned
+/// together with the canonical Zobrist hash maps the board position onto the
+/// same canonical board position.
+// -----------------------------------------------------------------------------
+- (void) testCanonicalHashIsInvariantUnderSymmetries
+{
+  GoBoard* board = m_game.board;
+  GoBoardTopology* topology = board.topology;
+  NSArray* blackVertexes = @[@"B2", @"C5", @"Q16"];
+  NSArray* whiteVertexes = @[@"F7", @"R3"];
+  for (NSString* vertex in blackVertexes)
+    [board pointAtVertex:vertex].stoneState = GoColorBlack;
+  for (NSString* vertex in whiteVertexes)
+    [board pointAtVertex:vertex].stoneState = GoColorWhite;
+  enum GoBoardSymmetry symmetry;
+  long long canonicalHash = [board canonicalZobristHashWithSymmetry:&symmetry];
+  int canonicalIndex = [topology indexOfIndex:[board indexOfPoint:[board pointAtVertex:@"B2"]]
+                        transformedBySymmetry:symmetry];
+
+  for (int transformation = 0; transformation < GoBoardSymmetryMax; ++transformation)
+  {
+    GoBoard* transformedBoard = [GoBoard boardWithSize:board.size];
+    for (NSString* vertex in [blackVertexes arrayByAddingObjectsFromArray:whiteVertexes])
+    {
+      GoPoint* point = [board pointAtVertex:vertex];
+      int transformedIndex = [topology indexOfIndex:[board indexOfPoint:point]
+                              transformedBySymmetry:(enum GoBoardSymmetry)transformation];
+      [transformedBoard pointAtIndex:transformedIndex].stoneState = point.stoneState;
+    }
+
+    enum GoBoardSymmetry transformedSymmetry;
+    XCTAssertEqual([transformedBoard canonicalZobristHashWithSymmetry:&transformedSymmetry], canonicalHash);
+    int transformedIndex = [topology indexOfIndex:[board indexOfPoint:[board pointAtVertex:@"B2"]]
+                            transformedBySymmetry:(enum GoBoardSymmetry)transformation];
+    XCTAssertEqual([topology indexOfIndex:transformedIndex transformedBySymmetry:transformedSymmetry], canonicalIndex);
+    enum GoBoardSymmetry inverseSymmetry = [GoBoardTopology inverseOfSymmetry:(enum GoBoardSymmetry)transformation];
+    XCTAssertEqual([topology indexOfIndex:transformedIndex transformedBySymmetry:inverseSymmetry],
+                   [board indexOfPoint:[board pointAtVertex:@"B2"]]);
+  }
+
+  [board pointAtVertex:@"R3"].stoneState = GoColorNone;
+  XCTAssertTrue([board canonicalZobristHashWithSymmetry:NULL] != canonicalHash);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns a newly allocated GoZobristTable object that was initialized
 /// with a board size that is different from the size of the board in @a game.
@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "GtpEngineStateTest.h"
+
+// Application includes
+#import <gtp/GtpCommand.h>
+#import <gtp/GtpEngineState.h>
+#import <gtp/GtpResponse.h>
+
+
+@implementation GtpEngineStateTest
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the willSubmitCommand:() and unappliedParameterCommands:()
+/// methods.
+// -----------------------------------------------------------------------------
+- (void) testUnappliedParameterCommands
+{
+  GtpEngineState* engineState = [[[GtpEngineState alloc] init] autorelease];
+  NSArray* commandStrings = @[@"uct_max_memory 256000000",
+                              @"uct_param_player max_games 1000",
+                              @"time_settings 0 1 0"];
+
+  // Nothing is known initially
+  XCTAssertEqualObjects(commandStrings, [engineState unappliedParameterCommands:commandStrings]);
+
+  [engineState willSubmitCommand:[GtpCommand command:@"uct_max_memory 256000000"]];
+  [engineState willSubmitCommand:[GtpCommand command:@"UCT_PARAM_PLAYER  max_games 1000"]];
+  [engineState willSubmitCommand:[GtpCommand command:@"time_settings 0 1 0"]];
+  // "time_settings" is never omitted
+  NSArray* expectedCommandStrings = @[@"time_settings 0 1 0"];
+  XCTAssertEqualObjects(expectedCommandStrings, [engineState unappliedParameterCommands:commandStrings]);
+
+  // A different value
+  [engineState willSubmitCommand:[GtpCommand command:@"uct_param_player max_games 5000"]];
+  expectedCommandStrings = @[@"uct_param_player max_games 1000", @"time_settings 0 1 0"];
+  XCTAssertEqualObjects(expectedCommandStrings, [engineState unappliedParameterCommands:commandStrings]);
+
+  // Queries and board state changes do not affect the parameters
+  [engineState willSubmitCommand:[GtpCommand command:@"uct_param_player max_games"]];
+  [engineState willSubmitCommand:[GtpCommand command:@"boardsize 19"]];
+  XCTAssertEqualObjects(expectedCommandStrings, [engineState unappliedParameterCommands:commandStrings]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the updateWithResponse:() method with failed parameter
+/// commands.
+// -----------------------------------------------------------------------------
+- (void) testFailedParameterCommand
+{
+  GtpEngineState* engineState = [[[GtpEngineState alloc] init] autorelease];
+  NSArray* commandStrings = @[@"uct_param_search number_threads 2"];
+
+  GtpCommand* command = [GtpCommand command:@"uct_param_search number_threads 2"];
+  [engineState willSubmitCommand:command];
+  [engineState updateWithResponse:[GtpResponse response:@"= " toCommand:command]];
+  XCTAssertEqual(0, [engineState unappliedParameterCommands:commandStrings].count);
+
+  [engineState willSubmitCommand:command];
+  [engineState updateWithResponse:[GtpResponse response:@"? failed" toCommand:command]];
+  XCTAssertEqualObjects(commandStrings, [engineState unappliedParameterCommands:commandStrings]);
+}
+
+@end
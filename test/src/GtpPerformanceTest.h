@@ -0,0 +1,55 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BaseTestCase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpPerformanceTest class contains performance tests that
+/// measure the round-trip latency and the throughput of GTP commands that
+/// travel between GtpClient and a GTP engine through PipeStreamBuffer.
+///
+/// The tests use representative command mixes: many "play" commands, long
+/// "gogui-play_sequence" commands, "uct_stat_territory" and "genmove" with a
+/// fixed number of playouts.
+///
+/// Fuego is not linked into the unit test target. The counterpart of
+/// GtpClient therefore is a stand-in engine that reads commands from the
+/// command stream and writes responses with realistic sizes to the response
+/// stream. The stand-in engine takes timestamps when it has received a
+/// command and when it has finished producing the response. The difference
+/// is the engine time, the remainder of the round-trip latency is the
+/// transport time (thread hand-offs, pipe I/O, response parsing). The
+/// transport time is what optimizations of PipeStreamBuffer and GtpClient
+/// can affect.
+///
+/// At the end of each test a JSON report with the latency distribution per
+/// command type is attached to the test result.
+// -----------------------------------------------------------------------------
+@interface GtpPerformanceTest : BaseTestCase
+{
+}
+
+- (void) testPerformancePlayCommands;
+- (void) testPerformancePipelinedPlayCommands;
+- (void) testPerformancePlaySequenceCommand;
+- (void) testPerformanceTerritoryStatisticsCommand;
+- (void) testPerformanceGenmoveCommand;
+- (void) testPerformanceCommandMix;
+
+@end
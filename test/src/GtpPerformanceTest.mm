@@ -0,0 +1,631 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+
+// Test includes
+#import "GtpPerformanceTest.h"
+
+// Application includes
+#import <gtp/GtpClient.h>
+#import <gtp/GtpCommand.h>
+#import <gtp/GtpResponse.h>
+#import <gtp/PipeStreamBuffer.h>
+
+// System includes
+#include <chrono>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/// @brief The board size used by all tests.
+static const int boardSize = 19;
+/// @brief The column letters of a 19x19 board. GTP skips the letter "I".
+static const char* columnLetters = "ABCDEFGHJKLMNOPQRST";
+/// @brief The number of moves in a "gogui-play_sequence" command.
+static const int numberOfMovesInPlaySequence = 300;
+/// @brief The number of playouts that "genmove" is configured to use.
+static const int numberOfPlayoutsPerGenmove = 1000;
+
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the current time in seconds. The time is taken from a
+/// monotonic clock whose readings can be compared across threads.
+// -----------------------------------------------------------------------------
+static double currentTimeInSeconds()
+{
+  std::chrono::steady_clock::duration timeSinceEpoch = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration<double>(timeSinceEpoch).count();
+}
+
+
+// -----------------------------------------------------------------------------
+/// @brief The GtpStandInEngine class is a minimal GTP engine that takes the
+/// place of Fuego in GtpPerformanceTest.
+///
+/// GtpStandInEngine reads commands from a PipeStreamBuffer in its own thread
+/// and answers every command immediately with a response of realistic size.
+/// For every command that is answered GtpStandInEngine records the time when
+/// the command was received and the time when the response was ready to be
+/// flushed to the response stream.
+// -----------------------------------------------------------------------------
+class GtpStandInEngine
+{
+public:
+  /// @brief The engine-side timestamps of a single command.
+  struct Timing
+  {
+    double receivedTime;
+    double respondedTime;
+  };
+
+public:
+  GtpStandInEngine();
+  ~GtpStandInEngine();
+
+  NSArray* getStreamBuffers();
+  void start();
+  void join();
+  std::vector<Timing> takeTimings();
+
+private:
+  void mainLoop();
+  std::string responseToCommand(const std::string& command, bool& quit) const;
+
+private:
+  PipeStreamBuffer commandStreamBuffer;
+  PipeStreamBuffer responseStreamBuffer;
+  std::thread thread;
+  std::mutex timingsMutex;
+  std::vector<Timing> timings;
+  std::string territoryStatisticsResponse;
+};
+
+// -----------------------------------------------------------------------------
+/// @brief Initializes a GtpStandInEngine object. Does not start the engine
+/// thread.
+// -----------------------------------------------------------------------------
+GtpStandInEngine::GtpStandInEngine()
+{
+  // Fuego responds to "uct_stat_territory" with one line per board row, each
+  // line consisting of one number per intersection
+  std::ostringstream response;
+  response << "= ";
+  for (int row = 0; row < boardSize; ++row)
+  {
+    response << "\n";
+    for (int column = 0; column < boardSize; ++column)
+    {
+      if (column > 0)
+        response << " ";
+      response << (((row * boardSize + column) % 201) - 100) / 100.0;
+    }
+  }
+  this->territoryStatisticsResponse = response.str();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Deallocates memory allocated by this GtpStandInEngine object.
+// -----------------------------------------------------------------------------
+GtpStandInEngine::~GtpStandInEngine()
+{
+  join();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the stream buffers in the form expected by
+/// GtpClient::clientWithStreamBuffers:().
+// -----------------------------------------------------------------------------
+NSArray* GtpStandInEngine::getStreamBuffers()
+{
+  return [NSArray arrayWithObjects:
+          [NSValue valueWithPointer:&this->commandStreamBuffer],
+          [NSValue valueWithPointer:&this->responseStreamBuffer],
+          nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Starts the engine thread.
+// -----------------------------------------------------------------------------
+void GtpStandInEngine::start()
+{
+  this->thread = std::thread(&GtpStandInEngine::mainLoop, this);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Waits until the engine thread has terminated. The engine thread
+/// terminates after it has answered the "quit" command.
+// -----------------------------------------------------------------------------
+void GtpStandInEngine::join()
+{
+  if (this->thread.joinable())
+    this->thread.join();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the timings of all commands that were answered since the
+/// last invocation of this method, in the order in which the commands were
+/// answered.
+// -----------------------------------------------------------------------------
+std::vector<GtpStandInEngine::Timing> GtpStandInEngine::takeTimings()
+{
+  std::lock_guard<std::mutex> lock(this->timingsMutex);
+  std::vector<Timing> takenTimings;
+  takenTimings.swap(this->timings);
+  return takenTimings;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief The engine thread's main loop method. Returns after the "quit"
+/// command has been answered.
+// -----------------------------------------------------------------------------
+void GtpStandInEngine::mainLoop()
+{
+  std::istream commandStream(&this->commandStreamBuffer);
+  std::ostream responseStream(&this->responseStreamBuffer);
+
+  std::string command;
+  while (getline(commandStream, command))
+  {
+    // GTP engines ignore empty lines and comments. GtpClient sends an
+    // interrupt in the form of a comment.
+    if (command.empty() || command[0] == '#')
+      continue;
+
+    double receivedTime = currentTimeInSeconds();
+    bool quit = false;
+    responseStream << responseToCommand(command, quit) << "\n\n";
+    double respondedTime = currentTimeInSeconds();
+
+    {
+      std::lock_guard<std::mutex> lock(this->timingsMutex);
+      this->timings.push_back({receivedTime, respondedTime});
+    }
+
+    // Making the response available to the client is part of the transport
+    // time, so we flush only after the timestamp was taken
+    responseStream.flush();
+
+    if (quit)
+      break;
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper for mainLoop(). Returns the response to @a command,
+/// without the empty line that terminates a GTP response. Sets @a quit to
+/// true if @a command is the "quit" command.
+// -----------------------------------------------------------------------------
+std::string GtpStandInEngine::responseToCommand(const std::string& command, bool& quit) const
+{
+  std::string commandName = command.substr(0, command.find(' '));
+  if (commandName == "uct_stat_territory")
+    return this->territoryStatisticsResponse;
+  else if (commandName == "genmove")
+    return "= D4";
+
+  quit = (commandName == "quit");
+  return "= ";
+}
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for GtpPerformanceTest.
+// -----------------------------------------------------------------------------
+@interface GtpPerformanceTest()
+@property(nonatomic, assign) GtpStandInEngine* engine;
+@property(nonatomic, retain) GtpClient* client;
+/// @brief Key = Command name (NSString), value = NSDictionary. The dictionary
+/// has three keys (@e roundTrip, @e engine, @e transport), the value of each
+/// key is an NSMutableArray with one duration in microseconds (NSNumber) for
+/// each command that was measured.
+@property(nonatomic, retain) NSMutableDictionary* samples;
+@end
+
+
+@implementation GtpPerformanceTest
+
+// -----------------------------------------------------------------------------
+/// @brief Sets up the stand-in engine and a GtpClient that communicates with
+/// the stand-in engine.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+
+  self.engine = new GtpStandInEngine();
+  self.client = [GtpClient clientWithStreamBuffers:self.engine->getStreamBuffers()];
+  self.engine->start();
+  self.samples = [NSMutableDictionary dictionary];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Shuts down the stand-in engine and the GtpClient.
+// -----------------------------------------------------------------------------
+- (void) tearDown
+{
+  [self submitSetupCommand:@"quit"];
+  self.engine->join();
+  delete self.engine;
+  self.engine = nullptr;
+  self.client = nil;
+  self.samples = nil;
+
+  [super tearDown];
+}
+
+#pragma mark - Tests
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the latency of many individual "play" commands, as they
+/// are sent while a game is played.
+// -----------------------------------------------------------------------------
+- (void) testPerformancePlayCommands
+{
+  NSArray* commandStrings = [self playCommandStringsWithNumberOfMoves:200];
+
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    [self submitSetupCommand:@"clear_board"];
+    for (NSString* commandString in commandStrings)
+      [self submitCommand:commandString];
+  }];
+
+  [self attachReportWithName:@"PlayCommands"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the throughput of "play" commands that are submitted as a
+/// pipeline via GtpClient::submitCommands:().
+// -----------------------------------------------------------------------------
+- (void) testPerformancePipelinedPlayCommands
+{
+  NSArray* commandStrings = [self playCommandStringsWithNumberOfMoves:200];
+
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    [self submitSetupCommand:@"clear_board"];
+    [self submitPipelinedCommands:commandStrings];
+  }];
+
+  [self attachReportWithName:@"PipelinedPlayCommands"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the latency of "gogui-play_sequence" commands with 300
+/// moves, as they are sent when the GTP engine is synchronized with a game
+/// that was loaded from an .sgf file.
+// -----------------------------------------------------------------------------
+- (void) testPerformancePlaySequenceCommand
+{
+  NSString* commandString = [self playSequenceCommandStringWithNumberOfMoves:numberOfMovesInPlaySequence];
+
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    for (int index = 0; index < 20; ++index)
+    {
+      [self submitSetupCommand:@"clear_board"];
+      [self submitCommand:commandString];
+    }
+  }];
+
+  [self attachReportWithName:@"PlaySequenceCommand"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the latency of "uct_stat_territory" commands, including
+/// the time it takes to parse the response.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceTerritoryStatisticsCommand
+{
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    for (int index = 0; index < 50; ++index)
+      [self submitCommand:@"uct_stat_territory"];
+  }];
+
+  [self attachReportWithName:@"TerritoryStatisticsCommand"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the latency of "genmove" commands with a fixed number of
+/// playouts.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceGenmoveCommand
+{
+  [self configureFixedPlayouts];
+
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    [self submitSetupCommand:@"clear_board"];
+    for (int index = 0; index < 20; ++index)
+      [self submitCommand:(index % 2 == 0) ? @"genmove B" : @"genmove W"];
+  }];
+
+  [self attachReportWithName:@"GenmoveCommand"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the latency of a command mix that resembles a typical
+/// session in the app: The GTP engine is synchronized with a loaded game,
+/// then moves are played, territory statistics are updated after each move
+/// and the computer player generates a move every now and then.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceCommandMix
+{
+  [self configureFixedPlayouts];
+  NSString* playSequenceCommandString = [self playSequenceCommandStringWithNumberOfMoves:numberOfMovesInPlaySequence];
+  NSArray* playCommandStrings = [self playCommandStringsWithNumberOfMoves:30];
+
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    [self submitCommand:@"clear_board"];
+    [self submitCommand:playSequenceCommandString];
+    int moveIndex = 0;
+    for (NSString* commandString in playCommandStrings)
+    {
+      [self submitCommand:commandString];
+      [self submitCommand:@"uct_stat_territory"];
+      if (++moveIndex % 10 == 0)
+        [self submitCommand:@"genmove B"];
+    }
+  }];
+
+  [self attachReportWithName:@"CommandMix"];
+}
+
+#pragma mark - Command submission
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the command @a commandString, waits for the
+/// response, and records the round-trip latency, the engine time and the
+/// transport time of the command.
+// -----------------------------------------------------------------------------
+- (void) submitCommand:(NSString*)commandString
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+
+  double startTime = currentTimeInSeconds();
+  [self.client submit:command];
+  [self parseResponseToCommand:command];
+  double roundTripDuration = currentTimeInSeconds() - startTime;
+
+  XCTAssertTrue(command.response.status);
+  std::vector<GtpStandInEngine::Timing> timings = self.engine->takeTimings();
+  XCTAssertEqual(timings.size(), (size_t)1);
+  if (timings.size() != 1)
+    return;
+
+  double engineDuration = timings[0].respondedTime - timings[0].receivedTime;
+  [self recordSampleForCommand:commandString roundTripDuration:roundTripDuration engineDuration:engineDuration];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the commands in @a commandStrings as a
+/// pipeline, waits for all responses, and records the latencies of the
+/// commands.
+///
+/// The round-trip latency of a single pipelined command cannot be observed,
+/// because the responses are processed in a batch. The round-trip latency
+/// that is recorded is therefore the duration of the entire batch divided by
+/// the number of commands.
+// -----------------------------------------------------------------------------
+- (void) submitPipelinedCommands:(NSArray*)commandStrings
+{
+  NSMutableArray* commands = [NSMutableArray arrayWithCapacity:commandStrings.count];
+  for (NSString* commandString in commandStrings)
+    [commands addObject:[GtpCommand command:commandString]];
+
+  double startTime = currentTimeInSeconds();
+  [self.client submitCommands:commands];
+  double batchDuration = currentTimeInSeconds() - startTime;
+
+  std::vector<GtpStandInEngine::Timing> timings = self.engine->takeTimings();
+  XCTAssertEqual(timings.size(), (size_t)commands.count);
+  if (timings.size() != commands.count)
+    return;
+
+  double roundTripDuration = batchDuration / commands.count;
+  for (NSUInteger index = 0; index < commands.count; ++index)
+  {
+    GtpCommand* command = [commands objectAtIndex:index];
+    XCTAssertTrue(command.response.status);
+    double engineDuration = timings[index].respondedTime - timings[index].receivedTime;
+    [self recordSampleForCommand:command.command roundTripDuration:roundTripDuration engineDuration:engineDuration];
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Submits the command @a commandString and waits for
+/// the response. The latency of the command is not recorded.
+// -----------------------------------------------------------------------------
+- (void) submitSetupCommand:(NSString*)commandString
+{
+  GtpCommand* command = [GtpCommand command:commandString];
+  [self.client submit:command];
+  XCTAssertTrue(command.response.status);
+  self.engine->takeTimings();
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Configures "genmove" so that it uses a fixed number
+/// of playouts regardless of the time settings. With Fuego this makes the
+/// compute time of "genmove" comparable from run to run.
+// -----------------------------------------------------------------------------
+- (void) configureFixedPlayouts
+{
+  [self submitSetupCommand:[NSString stringWithFormat:@"uct_param_player max_games %d", numberOfPlayoutsPerGenmove]];
+  [self submitSetupCommand:@"uct_param_player ignore_clock 1"];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Parses the response to @a command in the same way
+/// as the app does. Parsing is considered to be part of the transport.
+// -----------------------------------------------------------------------------
+- (void) parseResponseToCommand:(GtpCommand*)command
+{
+  if (! [command.command isEqualToString:@"uct_stat_territory"])
+    return;
+
+  float values[boardSize * boardSize];
+  bool success = [command.response parseNumberMatrixWithNumberOfRows:boardSize
+                                                     numberOfColumns:boardSize
+                                                              values:values];
+  XCTAssertTrue(success);
+}
+
+#pragma mark - Command generation
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the GTP vertex of the move with index
+/// @a moveIndex. Consecutive moves occupy consecutive intersections.
+// -----------------------------------------------------------------------------
+- (NSString*) vertexForMoveAtIndex:(int)moveIndex
+{
+  int pointIndex = moveIndex % (boardSize * boardSize);
+  return [NSString stringWithFormat:@"%c%d", columnLetters[pointIndex % boardSize], pointIndex / boardSize + 1];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns an array with @a numberOfMoves "play"
+/// command strings. Black and White alternate.
+// -----------------------------------------------------------------------------
+- (NSArray*) playCommandStringsWithNumberOfMoves:(int)numberOfMoves
+{
+  NSMutableArray* commandStrings = [NSMutableArray arrayWithCapacity:numberOfMoves];
+  for (int moveIndex = 0; moveIndex < numberOfMoves; ++moveIndex)
+  {
+    NSString* color = (moveIndex % 2 == 0) ? @"B" : @"W";
+    [commandStrings addObject:[NSString stringWithFormat:@"play %@ %@", color, [self vertexForMoveAtIndex:moveIndex]]];
+  }
+  return commandStrings;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a "gogui-play_sequence" command string with
+/// @a numberOfMoves moves. Black and White alternate.
+// -----------------------------------------------------------------------------
+- (NSString*) playSequenceCommandStringWithNumberOfMoves:(int)numberOfMoves
+{
+  NSMutableString* commandString = [NSMutableString stringWithString:@"gogui-play_sequence"];
+  for (int moveIndex = 0; moveIndex < numberOfMoves; ++moveIndex)
+  {
+    NSString* color = (moveIndex % 2 == 0) ? @"B" : @"W";
+    [commandString appendFormat:@" %@ %@", color, [self vertexForMoveAtIndex:moveIndex]];
+  }
+  return commandString;
+}
+
+#pragma mark - Reporting
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Records the durations of a single command. The
+/// command name (i.e. the first word of @a commandString) identifies the
+/// command type under which the durations are recorded.
+// -----------------------------------------------------------------------------
+- (void) recordSampleForCommand:(NSString*)commandString
+              roundTripDuration:(double)roundTripDuration
+                 engineDuration:(double)engineDuration
+{
+  NSString* commandName = [[commandString componentsSeparatedByString:@" "] objectAtIndex:0];
+  NSDictionary* samplesForCommand = self.samples[commandName];
+  if (! samplesForCommand)
+  {
+    samplesForCommand = @{
+      @"roundTrip": [NSMutableArray array],
+      @"engine": [NSMutableArray array],
+      @"transport": [NSMutableArray array],
+    };
+    self.samples[commandName] = samplesForCommand;
+  }
+
+  // The engine time cannot be larger than the round-trip latency, but the
+  // amortized round-trip latency of pipelined commands can be smaller than
+  // the engine time of an individual command
+  double transportDuration = MAX(roundTripDuration - engineDuration, 0.0);
+  [samplesForCommand[@"roundTrip"] addObject:[NSNumber numberWithDouble:roundTripDuration * 1000000.0]];
+  [samplesForCommand[@"engine"] addObject:[NSNumber numberWithDouble:engineDuration * 1000000.0]];
+  [samplesForCommand[@"transport"] addObject:[NSNumber numberWithDouble:transportDuration * 1000000.0]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns a dictionary that describes the
+/// distribution of the durations in @a durations.
+// -----------------------------------------------------------------------------
+- (NSDictionary*) distributionOfDurations:(NSArray*)durations
+{
+  NSArray* sortedDurations = [durations sortedArrayUsingSelector:@selector(compare:)];
+  NSUInteger count = sortedDurations.count;
+  NSNumber* (^percentile)(double) = ^(double fraction)
+  {
+    NSUInteger index = MIN((NSUInteger)(fraction * count), count - 1);
+    return (NSNumber*)[sortedDurations objectAtIndex:index];
+  };
+
+  return @{
+    @"minimumMicroseconds": sortedDurations.firstObject,
+    @"medianMicroseconds": percentile(0.5),
+    @"p90Microseconds": percentile(0.9),
+    @"p99Microseconds": percentile(0.99),
+    @"maximumMicroseconds": sortedDurations.lastObject,
+  };
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Attaches a JSON report with the latency
+/// distribution of each command type to the test result. The report is also
+/// logged.
+// -----------------------------------------------------------------------------
+- (void) attachReportWithName:(NSString*)reportName
+{
+  NSMutableDictionary* commands = [NSMutableDictionary dictionary];
+  for (NSString* commandName in self.samples)
+  {
+    NSDictionary* samplesForCommand = self.samples[commandName];
+    NSArray* roundTripDurations = samplesForCommand[@"roundTrip"];
+    double totalRoundTripDuration = [[roundTripDurations valueForKeyPath:@"@sum.self"] doubleValue];
+    commands[commandName] = @{
+      @"count": @(roundTripDurations.count),
+      @"commandsPerSecond": @(roundTripDurations.count / (totalRoundTripDuration / 1000000.0)),
+      @"roundTrip": [self distributionOfDurations:roundTripDurations],
+      @"engine": [self distributionOfDurations:samplesForCommand[@"engine"]],
+      @"transport": [self distributionOfDurations:samplesForCommand[@"transport"]],
+    };
+  }
+
+  NSDictionary* report = @{
+    @"commandMix": reportName,
+    @"commands": commands,
+  };
+
+  NSData* reportData = [NSJSONSerialization dataWithJSONObject:report
+                                                       options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys
+                                                         error:nil];
+  XCTAssertNotNil(reportData);
+  NSLog(@"%@: %@", self, [[[NSString alloc] initWithData:reportData encoding:NSUTF8StringEncoding] autorelease]);
+
+  XCTAttachment* attachment = [XCTAttachment attachmentWithData:reportData uniformTypeIdentifier:@"public.json"];
+  attachment.name = [NSString stringWithFormat:@"GtpPerformance-%@.json", reportName];
+  attachment.lifetime = XCTAttachmentLifetimeKeepAlways;
+  [self addAttachment:attachment];
+}
+
+@end
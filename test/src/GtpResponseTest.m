@@ -0,0 +1,141 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "GtpResponseTest.h"
+
+// Application includes
+#import <gtp/GtpResponse.h>
+
+
+@implementation GtpResponseTest
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the @e status property.
+// -----------------------------------------------------------------------------
+- (void) testStatus
+{
+  XCTAssertTrue([GtpResponse responseWithCString:"= " toCommand:nil].status);
+  XCTAssertTrue([GtpResponse responseWithCString:"= C3" toCommand:nil].status);
+  XCTAssertFalse([GtpResponse responseWithCString:"? unknown command" toCommand:nil].status);
+  XCTAssertFalse([GtpResponse responseWithCString:"" toCommand:nil].status);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the parsedResponse() method and the @e rawResponse
+/// property.
+// -----------------------------------------------------------------------------
+- (void) testParsedResponse
+{
+  GtpResponse* response = [GtpResponse responseWithCString:"= foo\nbar" toCommand:nil];
+  XCTAssertEqualObjects(response.rawResponse, @"= foo\nbar");
+  XCTAssertEqualObjects(response.parsedResponse, @"foo\nbar");
+  // The string is created only once
+  XCTAssertTrue(response.parsedResponse == response.parsedResponse);
+
+  XCTAssertEqualObjects([GtpResponse responseWithCString:"= " toCommand:nil].parsedResponse, @"");
+  XCTAssertEqualObjects([GtpResponse responseWithCString:"=" toCommand:nil].parsedResponse, @"");
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the response:toCommand:() convenience constructor.
+// -----------------------------------------------------------------------------
+- (void) testResponseFromString
+{
+  NSString* rawResponse = @"= D4";
+  GtpResponse* response = [GtpResponse response:rawResponse toCommand:nil];
+  XCTAssertTrue(response.status);
+  XCTAssertTrue(response.rawResponse == rawResponse);
+  XCTAssertEqualObjects(response.parsedResponse, @"D4");
+
+  enum GtpResponseMoveType moveType;
+  struct GoVertexNumeric vertex;
+  XCTAssertTrue([response parseMoveType:&moveType vertex:&vertex]);
+  XCTAssertEqual(moveType, GtpResponseMoveTypePlay);
+  XCTAssertEqual(vertex.x, 4);
+  XCTAssertEqual(vertex.y, 4);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the parseMoveType:vertex:() method.
+// -----------------------------------------------------------------------------
+- (void) testParseMove
+{
+  enum GtpResponseMoveType moveType;
+  struct GoVertexNumeric vertex;
+
+  XCTAssertTrue([[GtpResponse responseWithCString:"= Q16" toCommand:nil] parseMoveType:&moveType vertex:&vertex]);
+  XCTAssertEqual(moveType, GtpResponseMoveTypePlay);
+  XCTAssertEqual(vertex.x, 15);
+  XCTAssertEqual(vertex.y, 16);
+
+  XCTAssertTrue([[GtpResponse responseWithCString:"= a1\n" toCommand:nil] parseMoveType:&moveType vertex:&vertex]);
+  XCTAssertEqual(moveType, GtpResponseMoveTypePlay);
+  XCTAssertEqual(vertex.x, 1);
+  XCTAssertEqual(vertex.y, 1);
+
+  XCTAssertTrue([[GtpResponse responseWithCString:"= PASS" toCommand:nil] parseMoveType:&moveType vertex:&vertex]);
+  XCTAssertEqual(moveType, GtpResponseMoveTypePass);
+  XCTAssertTrue([[GtpResponse responseWithCString:"= pass" toCommand:nil] parseMoveType:&moveType vertex:&vertex]);
+  XCTAssertEqual(moveType, GtpResponseMoveTypePass);
+
+  XCTAssertTrue([[GtpResponse responseWithCString:"= resign" toCommand:nil] parseMoveType:&moveType vertex:&vertex]);
+  XCTAssertEqual(moveType, GtpResponseMoveTypeResign);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the parseMoveType:vertex:() method with responses that
+/// do not contain a single move.
+// -----------------------------------------------------------------------------
+- (void) testParseMoveIllegalInputValues
+{
+  enum GtpResponseMoveType moveType;
+  struct GoVertexNumeric vertex;
+
+  const char* illegalResponses[] = { "=", "= ", "= I5", "= A0", "= A20", "= Z1", "= C3 D4", "= passed", "= 1A" };
+  int numberOfIllegalResponses = sizeof(illegalResponses) / sizeof(illegalResponses[0]);
+  for (int index = 0; index < numberOfIllegalResponses; ++index)
+  {
+    GtpResponse* response = [GtpResponse responseWithCString:illegalResponses[index] toCommand:nil];
+    XCTAssertFalse([response parseMoveType:&moveType vertex:&vertex], @"%s", illegalResponses[index]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the parseVertexListWithMaximumNumberOfVertexes:vertexes:numberOfVertexes:()
+/// method.
+// -----------------------------------------------------------------------------
+- (void) testParseVertexList
+{
+  struct GoVertexNumeric vertexes[3];
+  int numberOfVertexes;
+
+  GtpResponse* response = [GtpResponse responseWithCString:"= A1 J9\nT19" toCommand:nil];
+  XCTAssertTrue([response parseVertexListWithMaximumNumberOfVertexes:3 vertexes:vertexes numberOfVertexes:&numberOfVertexes]);
+  XCTAssertEqual(numberOfVertexes, 3);
+  XCTAssertEqual(vertexes[1].x, 9);
+  XCTAssertEqual(vertexes[1].y, 9);
+  XCTAssertEqual(vertexes[2].x, 19);
+  XCTAssertEqual(vertexes[2].y, 19);
+
+  XCTAssertFalse([response parseVertexListWithMaximumNumberOfVertexes:2 vertexes:vertexes numberOfVertexes:&numberOfVertexes]);
+
+  response = [GtpResponse responseWithCString:"= " toCommand:nil];
+  XCTAssertTrue([response parseVertexListWithMaximumNumberOfVertexes:3 vertexes:vertexes numberOfVertexes:&numberOfVertexes]);
+  XCTAssertEqual(numberOfVertexes, 0);
+}
+
+@end
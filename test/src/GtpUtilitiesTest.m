@@ -0,0 +1,157 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "GtpUtilitiesTest.h"
+
+// Application includes
+#import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
+#import <go/GoGame.h>
+#import <go/GoGameAdditions.h>
+#import <go/GoGameRules.h>
+#import <gtp/GtpCommand.h>
+#import <gtp/GtpUtilities.h>
+#import <main/ApplicationDelegate.h>
+#import <player/GtpEngineProfileModel.h>
+
+
+@implementation GtpUtilitiesTest
+
+// -----------------------------------------------------------------------------
+/// @brief Makes the fallback profile the active GTP engine profile, because
+/// a human vs. human game has no active profile.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+
+  GtpEngineProfileModel* model = m_delegate.gtpEngineProfileModel;
+  model.activeProfile = [model fallbackProfile];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the cache key that GtpUtilities sets up for a "reg_genmove"
+/// command in the current board position of m_game.
+// -----------------------------------------------------------------------------
+- (NSString*) cacheKey
+{
+  GtpCommand* command = [GtpCommand command:@"reg_genmove B"];
+  [GtpUtilities setupResponseCachingForCommand:command game:m_game];
+  return command.cacheKey;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Plays moves on the intersections in @a vertexes, alternating the
+/// colors.
+// -----------------------------------------------------------------------------
+- (void) playMoves:(NSArray*)vertexes
+{
+  for (NSString* vertex in vertexes)
+    [m_game play:[m_game.board pointAtVertex:vertex]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that no cache key is set up if there is no active GTP engine
+/// profile.
+// -----------------------------------------------------------------------------
+- (void) testCacheKeyWithoutActiveProfile
+{
+  m_delegate.gtpEngineProfileModel.activeProfile = nil;
+  XCTAssertNil([self cacheKey]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that the cache key changes when a game rule changes that is
+/// submitted to the GTP engine.
+// -----------------------------------------------------------------------------
+- (void) testCacheKeyDependsOnGameRules
+{
+  NSMutableSet* cacheKeys = [NSMutableSet set];
+  [cacheKeys addObject:[self cacheKey]];
+
+  m_game.komi = m_game.komi + 1.0;
+  [cacheKeys addObject:[self cacheKey]];
+
+  m_game.rules.scoringSystem = (m_game.rules.scoringSystem == GoScoringSystemAreaScoring
+                                ? GoScoringSystemTerritoryScoring
+                                : GoScoringSystemAreaScoring);
+  [cacheKeys addObject:[self cacheKey]];
+
+  m_game.rules.koRule = GoKoRuleSuperkoPositional;
+  [cacheKeys addObject:[self cacheKey]];
+
+  m_game.rules.koRule = GoKoRuleSuperkoSituational;
+  [cacheKeys addObject:[self cacheKey]];
+
+  XCTAssertEqual(cacheKeys.count, 5);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that the cache key distinguishes a board position in which
+/// the opponent's stone must not be retaken because of ko from the same board
+/// position in which the stone can be retaken.
+// -----------------------------------------------------------------------------
+- (void) testCacheKeyDependsOnKoState
+{
+  m_game.rules.koRule = GoKoRuleSimple;
+
+  // Black captures the white stone on D4 by playing E4. White must not
+  // retake on D4 immediately.
+  [self playMoves:@[@"C4", @"E5", @"D5", @"F4", @"D3", @"E3", @"Q16", @"D4", @"E4"]];
+  long long zobristHashAfterCapture = m_game.boardPosition.currentNode.zobristHash;
+  NSString* cacheKeyAfterCapture = [self cacheKey];
+
+  // After both players passed, the retake is legal
+  [m_game pass];
+  [m_game pass];
+  XCTAssertEqual(m_game.boardPosition.currentNode.zobristHash, zobristHashAfterCapture);
+  NSString* cacheKeyAfterPasses = [self cacheKey];
+  XCTAssertNotEqualObjects(cacheKeyAfterCapture, cacheKeyAfterPasses);
+
+  // Navigating back to the capture restores the ko state
+  m_game.boardPosition.currentBoardPosition = m_game.boardPosition.currentBoardPosition - 2;
+  XCTAssertEqualObjects([self cacheKey], cacheKeyAfterCapture);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Checks that the cache key distinguishes the same board position if
+/// it was reached via different moves and a superko rule is in effect.
+// -----------------------------------------------------------------------------
+- (void) testCacheKeyDependsOnSuperkoHistory
+{
+  m_game.rules.koRule = GoKoRuleSuperkoPositional;
+
+  [self playMoves:@[@"D4", @"Q16", @"Q4"]];
+  NSString* cacheKeyFirstOrder = [self cacheKey];
+  XCTAssertEqualObjects([self cacheKey], cacheKeyFirstOrder);
+
+  // Same stones, but Black played them in a different order, so different
+  // board positions are in the history
+  m_game.boardPosition.currentBoardPosition = 0;
+  [self playMoves:@[@"Q4", @"Q16", @"D4"]];
+  XCTAssertNotEqualObjects([self cacheKey], cacheKeyFirstOrder);
+
+  // With the simple ko rule the history is irrelevant
+  m_game.rules.koRule = GoKoRuleSimple;
+  NSString* cacheKeySecondOrder = [self cacheKey];
+  m_game.boardPosition.currentBoardPosition = 0;
+  [self playMoves:@[@"D4", @"Q16", @"Q4"]];
+  XCTAssertEqualObjects([self cacheKey], cacheKeySecondOrder);
+}
+
+@end
@@ -0,0 +1,40 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BaseTestCase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The MergeGamesCommandTest class contains unit tests that exercise the
+/// MergeGamesCommand class.
+///
+/// The tests write small .sgf files to a temporary folder which they configure
+/// as the archive folder, merge the games, and then examine the SGF data of
+/// the merged game.
+// -----------------------------------------------------------------------------
+@interface MergeGamesCommandTest : BaseTestCase
+{
+}
+
+- (void) testFewerThanTwoGames;
+- (void) testIdenticalPrefixes;
+- (void) testDivergentVariations;
+- (void) testConflictingSetup;
+- (void) testConflictingAnnotations;
+
+@end
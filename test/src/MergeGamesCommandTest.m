@@ -0,0 +1,325 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "MergeGamesCommandTest.h"
+
+// Application includes
+#import <archive/ArchiveGame.h>
+#import <archive/ArchiveViewModel.h>
+#import <command/game/MergeGamesCommand.h>
+#import <main/ApplicationDelegate.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for MergeGamesCommandTest.
+// -----------------------------------------------------------------------------
+@interface MergeGamesCommandTest()
+@property(nonatomic, retain) NSString* originalArchiveFolder;
+@end
+
+
+@implementation MergeGamesCommandTest
+
+// -----------------------------------------------------------------------------
+/// @brief Replaces the archive folder with an empty temporary folder.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+
+  ArchiveViewModel* model = m_delegate.archiveViewModel;
+  self.originalArchiveFolder = model.archiveFolder;
+  NSString* archiveFolder = [NSTemporaryDirectory() stringByAppendingPathComponent:NSStringFromClass([self class])];
+  [[NSFileManager defaultManager] removeItemAtPath:archiveFolder error:nil];
+  [[NSFileManager defaultManager] createDirectoryAtPath:archiveFolder withIntermediateDirectories:YES attributes:nil error:nil];
+  model.archiveFolder = archiveFolder;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Removes the temporary archive folder and restores the original
+/// archive folder.
+// -----------------------------------------------------------------------------
+- (void) tearDown
+{
+  ArchiveViewModel* model = m_delegate.archiveViewModel;
+  [[NSFileManager defaultManager] removeItemAtPath:model.archiveFolder error:nil];
+  model.archiveFolder = self.originalArchiveFolder;
+  self.originalArchiveFolder = nil;
+
+  [super tearDown];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the merge of fewer than two games.
+// -----------------------------------------------------------------------------
+- (void) testFewerThanTwoGames
+{
+  ArchiveGame* game = [self archiveGameWithName:@"A" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee])"];
+
+  MergeGamesCommand* command = [[[MergeGamesCommand alloc] initWithGames:@[game] preferredGameName:@"Merged"] autorelease];
+  XCTAssertFalse([command submit]);
+  XCTAssertNotNil(command.errorMessage);
+  XCTAssertNil(command.mergedGameName);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the merge of games that share all of their moves. The
+/// merged game must not contain any variations.
+// -----------------------------------------------------------------------------
+- (void) testIdenticalPrefixes
+{
+  ArchiveGame* game1 = [self archiveGameWithName:@"A" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee]C[Review A];W[cc];B[gg])"];
+  ArchiveGame* game2 = [self archiveGameWithName:@"B" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee]C[Review B];W[cc]C[Nice move];B[gg])"];
+  // A prefix of the other two games
+  ArchiveGame* game3 = [self archiveGameWithName:@"C" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee])"];
+
+  MergeGamesCommand* command = [[[MergeGamesCommand alloc] initWithGames:@[game1, game2, game3] preferredGameName:@"Merged"] autorelease];
+  XCTAssertTrue([command submit]);
+  XCTAssertNil(command.errorMessage);
+  XCTAssertEqualObjects(command.mergedGameName, @"Merged");
+
+  SGFCNode* rootNode = [self mergedGameOfCommand:command].rootNode;
+  NSArray* mainVariation = [self nodesInMainVariationStartingWithNode:rootNode];
+  XCTAssertEqual(mainVariation.count, 4);
+  for (SGFCNode* node in mainVariation)
+    XCTAssertNil(node.nextSibling);
+
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeB inNode:mainVariation[1]], @"ee");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeW inNode:mainVariation[2]], @"cc");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeB inNode:mainVariation[3]], @"gg");
+  XCTAssertEqualObjects([self commentInNode:mainVariation[1]], @"Review A\n\nReview B");
+  XCTAssertEqualObjects([self commentInNode:mainVariation[2]], @"Nice move");
+  XCTAssertNil([self commentInNode:mainVariation[3]]);
+
+  // The source games are not modified
+  XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:[self filePathOfArchiveGame:game1]]);
+  XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:[self filePathOfArchiveGame:game2]]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the merge of games that diverge after a common prefix. The
+/// moves that do not match become new variations, together with all of their
+/// descendants.
+// -----------------------------------------------------------------------------
+- (void) testDivergentVariations
+{
+  ArchiveGame* game1 = [self archiveGameWithName:@"A" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee];W[cc];B[gg])"];
+  // Diverges with White's first move
+  ArchiveGame* game2 = [self archiveGameWithName:@"B" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee];W[gc];B[cg];W[gg])"];
+  // Diverges with Black's second move, and has a variation of its own
+  ArchiveGame* game3 = [self archiveGameWithName:@"C" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee];W[cc](;B[cg])(;B[gg]C[Same as A]))"];
+
+  MergeGamesCommand* command = [[[MergeGamesCommand alloc] initWithGames:@[game1, game2, game3] preferredGameName:@"Merged"] autorelease];
+  XCTAssertTrue([command submit]);
+
+  SGFCNode* rootNode = [self mergedGameOfCommand:command].rootNode;
+  SGFCNode* nodeBlack1 = rootNode.firstChild;
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeB inNode:nodeBlack1], @"ee");
+  XCTAssertNil(nodeBlack1.nextSibling);
+
+  // The variations of the base come first, in their original order
+  NSArray* whiteMoves = [self childrenOfNode:nodeBlack1];
+  XCTAssertEqual(whiteMoves.count, 2);
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeW inNode:whiteMoves[0]], @"cc");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeW inNode:whiteMoves[1]], @"gc");
+
+  // The variation from game 2 was moved together with all of its descendants
+  NSArray* game2Variation = [self nodesInMainVariationStartingWithNode:whiteMoves[1]];
+  XCTAssertEqual(game2Variation.count, 3);
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeB inNode:game2Variation[1]], @"cg");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeW inNode:game2Variation[2]], @"gg");
+
+  // Game 3 matches the base up to White's first move, its B[gg] variation
+  // matches the base, its B[cg] variation is new
+  NSArray* blackMoves = [self childrenOfNode:whiteMoves[0]];
+  XCTAssertEqual(blackMoves.count, 2);
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeB inNode:blackMoves[0]], @"gg");
+  XCTAssertEqualObjects([self commentInNode:blackMoves[0]], @"Same as A");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeB inNode:blackMoves[1]], @"cg");
+  XCTAssertNil([self commentInNode:blackMoves[1]]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the merge of games whose setup differs.
+// -----------------------------------------------------------------------------
+- (void) testConflictingSetup
+{
+  NSFileManager* fileManager = [NSFileManager defaultManager];
+  ArchiveViewModel* model = m_delegate.archiveViewModel;
+
+  // The order of the values of a setup property is irrelevant
+  ArchiveGame* game1 = [self archiveGameWithName:@"A" sgfContent:@"(;FF[4]GM[1]SZ[9]AB[cc][gg]AW[cg];B[ee])"];
+  ArchiveGame* game2 = [self archiveGameWithName:@"B" sgfContent:@"(;FF[4]GM[1]SZ[9]AW[cg]AB[gg][cc];W[gc])"];
+  MergeGamesCommand* command = [[[MergeGamesCommand alloc] initWithGames:@[game1, game2] preferredGameName:@"Merged"] autorelease];
+  XCTAssertTrue([command submit]);
+  XCTAssertEqual([self childrenOfNode:[self mergedGameOfCommand:command].rootNode].count, 2);
+
+  // Different setup in the root node
+  ArchiveGame* game3 = [self archiveGameWithName:@"C" sgfContent:@"(;FF[4]GM[1]SZ[9]AB[cc][gg];B[ee])"];
+  command = [[[MergeGamesCommand alloc] initWithGames:@[game1, game3] preferredGameName:@"Conflict"] autorelease];
+  XCTAssertFalse([command submit]);
+  XCTAssertNotNil(command.errorMessage);
+  XCTAssertNil(command.mergedGameName);
+  XCTAssertFalse([fileManager fileExistsAtPath:[model filePathForGameWithName:@"Conflict"]]);
+
+  // Different board size
+  ArchiveGame* game4 = [self archiveGameWithName:@"D" sgfContent:@"(;FF[4]GM[1]SZ[13]AB[cc][gg]AW[cg];B[ee])"];
+  command = [[[MergeGamesCommand alloc] initWithGames:@[game1, game4] preferredGameName:@"Conflict"] autorelease];
+  XCTAssertFalse([command submit]);
+  XCTAssertNotNil(command.errorMessage);
+  XCTAssertFalse([fileManager fileExistsAtPath:[model filePathForGameWithName:@"Conflict"]]);
+
+  // Different setup in a node other than the root node is a new variation
+  ArchiveGame* game5 = [self archiveGameWithName:@"E" sgfContent:@"(;FF[4]GM[1]SZ[9];AB[ee];W[cc])"];
+  ArchiveGame* game6 = [self archiveGameWithName:@"F" sgfContent:@"(;FF[4]GM[1]SZ[9];AB[ee][ef];W[cc])"];
+  command = [[[MergeGamesCommand alloc] initWithGames:@[game5, game6] preferredGameName:@"Setup"] autorelease];
+  XCTAssertTrue([command submit]);
+  NSArray* setupNodes = [self childrenOfNode:[self mergedGameOfCommand:command].rootNode];
+  XCTAssertEqual(setupNodes.count, 2);
+  XCTAssertEqualObjects([self valuesOfPropertyWithType:SGFCPropertyTypeAB inNode:setupNodes[0]], (@[@"ee"]));
+  XCTAssertEqualObjects([self valuesOfPropertyWithType:SGFCPropertyTypeAB inNode:setupNodes[1]], (@[@"ee", @"ef"]));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the merge of matching nodes whose annotations, comments
+/// and markup differ.
+// -----------------------------------------------------------------------------
+- (void) testConflictingAnnotations
+{
+  ArchiveGame* game1 = [self archiveGameWithName:@"A" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee]N[Base]GB[1]C[Good]CR[aa];W[cc]C[Good move])"];
+  ArchiveGame* game2 = [self archiveGameWithName:@"B" sgfContent:@"(;FF[4]GM[1]SZ[9];B[ee]N[Other]GB[2]V[0.5]C[Good move]CR[aa][bb]TR[cc];W[cc]C[Good])"];
+
+  MergeGamesCommand* command = [[[MergeGamesCommand alloc] initWithGames:@[game1, game2] preferredGameName:@"Merged"] autorelease];
+  XCTAssertTrue([command submit]);
+
+  NSArray* mainVariation = [self nodesInMainVariationStartingWithNode:[self mergedGameOfCommand:command].rootNode];
+  XCTAssertEqual(mainVariation.count, 3);
+  SGFCNode* node1 = mainVariation[1];
+  SGFCNode* node2 = mainVariation[2];
+
+  // The base has precedence for properties that cannot be combined.
+  // Properties that are missing in the base are taken from the other game.
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeN inNode:node1], @"Base");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeGB inNode:node1], @"1");
+  XCTAssertEqualObjects([self valueOfPropertyWithType:SGFCPropertyTypeV inNode:node1], @"0.5");
+
+  // A comment that contains the other comment replaces it
+  XCTAssertEqualObjects([self commentInNode:node1], @"Good move");
+  XCTAssertEqualObjects([self commentInNode:node2], @"Good move");
+
+  // Markup is combined without duplicates
+  XCTAssertEqualObjects([self valuesOfPropertyWithType:SGFCPropertyTypeCR inNode:node1], (@[@"aa", @"bb"]));
+  XCTAssertEqualObjects([self valuesOfPropertyWithType:SGFCPropertyTypeTR inNode:node1], (@[@"cc"]));
+}
+
+#pragma mark - Helper methods
+
+// -----------------------------------------------------------------------------
+/// @brief Writes @a sgfContent to the file "<name>.sgf" in the archive folder
+/// and returns an ArchiveGame object that represents the file.
+// -----------------------------------------------------------------------------
+- (ArchiveGame*) archiveGameWithName:(NSString*)name sgfContent:(NSString*)sgfContent
+{
+  NSString* sgfFilePath = [m_delegate.archiveViewModel filePathForGameWithName:name];
+  [sgfContent writeToFile:sgfFilePath atomically:YES encoding:NSUTF8StringEncoding error:nil];
+  NSDictionary* fileAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:sgfFilePath error:nil];
+  return [[[ArchiveGame alloc] initWithFileName:sgfFilePath.lastPathComponent fileAttributes:fileAttributes] autorelease];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the path of the .sgf file that @a archiveGame represents.
+// -----------------------------------------------------------------------------
+- (NSString*) filePathOfArchiveGame:(ArchiveGame*)archiveGame
+{
+  return [m_delegate.archiveViewModel.archiveFolder stringByAppendingPathComponent:archiveGame.fileName];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Reads the game that @a command has merged and saved in the archive.
+// -----------------------------------------------------------------------------
+- (SGFCGame*) mergedGameOfCommand:(MergeGamesCommand*)command
+{
+  NSString* sgfFilePath = [m_delegate.archiveViewModel filePathForGameWithName:command.mergedGameName];
+  SGFCDocumentReader* documentReader = [SGFCDocumentReader documentReader];
+  SGFCDocumentReadResult* readResult = [documentReader readSgfContentFromFile:sgfFilePath];
+  XCTAssertTrue(readResult.isSgfDataValid);
+  SGFCGame* sgfGame = readResult.document.games.firstObject;
+  XCTAssertNotNil(sgfGame);
+  return sgfGame;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns @a node and all of its first children, i.e. the main
+/// variation of the game tree that starts with @a node.
+// -----------------------------------------------------------------------------
+- (NSArray*) nodesInMainVariationStartingWithNode:(SGFCNode*)node
+{
+  NSMutableArray* nodes = [NSMutableArray array];
+  for (; node; node = node.firstChild)
+    [nodes addObject:node];
+  return nodes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the children of @a node, in the order in which they appear
+/// in the game tree.
+// -----------------------------------------------------------------------------
+- (NSArray*) childrenOfNode:(SGFCNode*)node
+{
+  NSMutableArray* children = [NSMutableArray array];
+  for (SGFCNode* child = node.firstChild; child; child = child.nextSibling)
+    [children addObject:child];
+  return children;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the raw value of the single-value property of type
+/// @a propertyType in @a node, or nil if @a node has no such property.
+// -----------------------------------------------------------------------------
+- (NSString*) valueOfPropertyWithType:(enum SGFCPropertyType)propertyType inNode:(SGFCNode*)node
+{
+  SGFCProperty* property = [node propertyWithType:propertyType];
+  return property.propertyValue.toSingleValue.rawValue;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the sorted raw values of the property of type
+/// @a propertyType in @a node, or nil if @a node has no such property.
+// -----------------------------------------------------------------------------
+- (NSArray*) valuesOfPropertyWithType:(enum SGFCPropertyType)propertyType inNode:(SGFCNode*)node
+{
+  SGFCProperty* property = [node propertyWithType:propertyType];
+  if (! property)
+    return nil;
+  NSMutableArray* values = [NSMutableArray array];
+  for (id<SGFCPropertyValue> propertyValue in property.propertyValues)
+    [values addObject:propertyValue.toSingleValue.rawValue];
+  [values sortUsingSelector:@selector(compare:)];
+  return values;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the comment in @a node, or nil if @a node has no comment.
+// -----------------------------------------------------------------------------
+- (NSString*) commentInNode:(SGFCNode*)node
+{
+  SGFCProperty* property = [node propertyWithType:SGFCPropertyTypeC];
+  return property.propertyValue.toSingleValue.toTextValue.textValue;
+}
+
+@end
@@ -51,11 +51,15 @@
 - (void) testRecalculateCanvas_NodeNumbers_CondenseMoveNodes_Rule3;
 - (void) testCellAtPosition;
 - (void) testNodeAtPosition;
+- (void) testEnumerateCellsFromPosition;
 - (void) testPositionsForNode;
 - (void) testSelectedNodePositions;
 - (void) testNodeNumbersViewCellAtPosition;
 - (void) testNodeNumbersViewPositionsForNode;
 - (void) testSelectedNodeNodeNumbersViewPositions;
 - (void) testCanvasSize;
+- (void) testIncrementalUpdate_AppendMoveNode_AlignMoves;
+- (void) testRecalculateCanvas_RestoresLayoutFromLayoutCache;
+- (void) testRecalculateCanvas_CalculatesCanvasInBackground;
 
 @end
@@ -37,6 +37,7 @@
 #import <play/nodetreeview/canvas/NodeTreeViewCanvasAdditions.h>
 #import <play/nodetreeview/canvas/NodeTreeViewCell.h>
 #import <play/nodetreeview/canvas/NodeTreeViewCellPosition.h>
+#import <play/nodetreeview/canvas/NodeTreeViewLayoutCache.h>
 
 
 @implementation NodeTreeViewCanvasTest
@@ -2255,6 +2256,45 @@
   XCTAssertNil(nodeAtCellOutsideOfCanvas);
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the enumerateCellsFromPosition:toPosition:usingBlock:()
+/// method.
+// -----------------------------------------------------------------------------
+- (void) testEnumerateCellsFromPosition
+{
+  // Arrange
+  //
+  // Root--NodeA--NodeB
+  //          \---NodeC                                                         |
+  GoNode* rootNode = m_game.nodeModel.rootNode;
+  GoNode* nodeA = [self parentNode:rootNode appendChildNode:[self createEmptyNode]];
+  GoNode* nodeB = [self parentNode:nodeA appendChildNode:[self createEmptyNode]];
+  GoNode* nodeC = [self parentNode:nodeA appendChildNode:[self createEmptyNode]];
+
+  NodeTreeViewModel* nodeTreeViewModel = m_delegate.nodeTreeViewModel;
+  NodeTreeViewCanvas* testee = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  [testee recalculateCanvas];
+  NSMutableArray* enumeratedPositions = [NSMutableArray array];
+  NSMutableArray* enumeratedNodes = [NSMutableArray array];
+
+  // Act
+  [testee enumerateCellsFromPosition:[self positionWithX:1 y:0]
+                          toPosition:[self positionWithX:5 y:5]
+                          usingBlock:^(NodeTreeViewCellPosition* position, NodeTreeViewCell* cell, GoNode* node)
+  {
+    XCTAssertEqualObjects(cell, [testee cellAtPosition:position]);
+    [enumeratedPositions addObject:position];
+    [enumeratedNodes addObject:node];
+  }];
+
+  // Assert
+  // The empty cell at position 1/1 is not enumerated
+  NSArray* expectedPositions = @[[self positionWithX:1 y:0], [self positionWithX:2 y:0], [self positionWithX:2 y:1]];
+  NSArray* expectedNodes = @[nodeA, nodeB, nodeC];
+  XCTAssertEqualObjects(enumeratedPositions, expectedPositions);
+  XCTAssertEqualObjects(enumeratedNodes, expectedNodes);
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Exercises the positionsForNode:() method.
 // -----------------------------------------------------------------------------
@@ -2532,6 +2572,126 @@
   XCTAssertTrue(CGSizeEqualToSize(calculatedCanvasSize, CGSizeMake(13, 2)));
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Exercises the incremental update of the canvas that is performed
+/// when a move is played at the end of a game variation. The move node must be
+/// aligned with the existing move node that has the same move number. The
+/// result of the incremental update must be the same as the result of a full
+/// re-calculation.
+// -----------------------------------------------------------------------------
+- (void) testIncrementalUpdate_AppendMoveNode_AlignMoves
+{
+  // Arrange
+  //
+  // Root--NodeMove1--NodeMove2--Node3--NodeMove3
+  //           +------NodeMove2a--------NodeMove3a   <-- NodeMove3a is played in the act phase
+  GoMoveNodeCreationOptions* moveNodeCreationOptions = [GoMoveNodeCreationOptions moveNodeCreationOptions];
+  [m_game play:[m_game.board pointAtVertex:@"A1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove1
+  [m_game play:[m_game.board pointAtVertex:@"B1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove2
+  [m_game addEmptyNodeToCurrentGameVariation];  // Node3
+  [m_game play:[m_game.board pointAtVertex:@"C1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove3
+  m_game.boardPosition.currentBoardPosition = 1;  // select NodeMove1
+  [m_game play:[m_game.board pointAtVertex:@"D1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove2a
+
+  NodeTreeViewModel* nodeTreeViewModel = m_delegate.nodeTreeViewModel;
+  [self setupModel:nodeTreeViewModel condenseMoveNodes:false alignMoveNodes:true branchingStyle:NodeTreeViewBranchingStyleRightAngle];
+  NodeTreeViewCanvas* testee = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  [testee recalculateCanvas];
+
+  // Act
+  [m_game play:[m_game.board pointAtVertex:@"E1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove3a
+
+  // Assert
+  NSArray* expectedPositionsNodeMove3a = @[[self positionWithX:4 y:1]];
+  XCTAssertEqualObjects([testee positionsForNode:m_game.nodeModel.leafNode], expectedPositionsNodeMove3a);
+
+  NodeTreeViewCanvas* recalculatedCanvas = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  [recalculatedCanvas recalculateCanvas];
+  NSMutableDictionary* expectedCellsDictionary = [NSMutableDictionary dictionary];
+  [[recalculatedCanvas getCellsDictionary] enumerateKeysAndObjectsUsingBlock:^(NodeTreeViewCellPosition* position, NSArray* tuple, BOOL* stop)
+  {
+    expectedCellsDictionary[position] = tuple.firstObject;
+  }];
+  [self assertCells:[testee getCellsDictionary] areEqualToExpectedCells:expectedCellsDictionary];
+  [self assertNodeNumbersViewCells:[testee getNodeNumbersViewCellsDictionary] areEqualToExpectedCells:[recalculatedCanvas getNodeNumbersViewCellsDictionary]];
+  XCTAssertTrue(CGSizeEqualToSize(testee.canvasSize, recalculatedCanvas.canvasSize));
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the canvas calculation with a layout that was stored in
+/// the layout cache file by a previous canvas calculation. The result must be
+/// the same as the result of a calculation without layout cache.
+// -----------------------------------------------------------------------------
+- (void) testRecalculateCanvas_RestoresLayoutFromLayoutCache
+{
+  // Arrange
+  //
+  // Root--NodeMove1--NodeMove2--Node3--NodeMove3
+  //           +------NodeMove2a--------NodeMove3a
+  GoMoveNodeCreationOptions* moveNodeCreationOptions = [GoMoveNodeCreationOptions moveNodeCreationOptions];
+  [m_game play:[m_game.board pointAtVertex:@"A1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove1
+  [m_game play:[m_game.board pointAtVertex:@"B1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove2
+  [m_game addEmptyNodeToCurrentGameVariation];  // Node3
+  [m_game play:[m_game.board pointAtVertex:@"C1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove3
+  m_game.boardPosition.currentBoardPosition = 1;  // select NodeMove1
+  [m_game play:[m_game.board pointAtVertex:@"D1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove2a
+  [m_game play:[m_game.board pointAtVertex:@"E1"] withMoveNodeCreationOptions:moveNodeCreationOptions];  // NodeMove3a
+
+  NodeTreeViewModel* nodeTreeViewModel = m_delegate.nodeTreeViewModel;
+  [self setupModel:nodeTreeViewModel condenseMoveNodes:false alignMoveNodes:true branchingStyle:NodeTreeViewBranchingStyleRightAngle];
+
+  NSString* layoutCacheFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+  NodeTreeViewCanvas* cachingCanvas = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  cachingCanvas.layoutCache = [[[NodeTreeViewLayoutCache alloc] initWithFilePath:layoutCacheFilePath] autorelease];
+  [cachingCanvas recalculateCanvas];
+  XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:layoutCacheFilePath]);
+
+  NodeTreeViewCanvas* testee = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  testee.layoutCache = [[[NodeTreeViewLayoutCache alloc] initWithFilePath:layoutCacheFilePath] autorelease];
+
+  // Act
+  [testee recalculateCanvas];
+
+  // Assert
+  NodeTreeViewCanvas* recalculatedCanvas = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  [recalculatedCanvas recalculateCanvas];
+  NSMutableDictionary* expectedCellsDictionary = [NSMutableDictionary dictionary];
+  [[recalculatedCanvas getCellsDictionary] enumerateKeysAndObjectsUsingBlock:^(NodeTreeViewCellPosition* position, NSArray* tuple, BOOL* stop)
+  {
+    expectedCellsDictionary[position] = tuple.firstObject;
+  }];
+  [self assertCells:[testee getCellsDictionary] areEqualToExpectedCells:expectedCellsDictionary];
+  XCTAssertTrue(CGSizeEqualToSize(testee.canvasSize, recalculatedCanvas.canvasSize));
+
+  [[NSFileManager defaultManager] removeItemAtPath:layoutCacheFilePath error:nil];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the canvas calculation on a secondary thread. The canvas
+/// data must be replaced only when the calculation has finished.
+// -----------------------------------------------------------------------------
+- (void) testRecalculateCanvas_CalculatesCanvasInBackground
+{
+  // Arrange
+  [m_game play:[m_game.board pointAtVertex:@"A1"] withMoveNodeCreationOptions:[GoMoveNodeCreationOptions moveNodeCreationOptions]];
+  NodeTreeViewModel* nodeTreeViewModel = m_delegate.nodeTreeViewModel;
+  [self setupModel:nodeTreeViewModel condenseMoveNodes:false];
+  NodeTreeViewCanvas* testee = [[[NodeTreeViewCanvas alloc] initWithModel:nodeTreeViewModel] autorelease];
+  testee.calculatesCanvasInBackground = true;
+  [self expectationForNotification:nodeTreeViewContentDidChange object:nil handler:nil];
+
+  // Act
+  [testee recalculateCanvas];
+  CGSize canvasSizeBeforeCalculationHasFinished = testee.canvasSize;
+  [self waitForExpectationsWithTimeout:5.0 handler:nil];
+
+  // Assert
+  XCTAssertTrue(CGSizeEqualToSize(canvasSizeBeforeCalculationHasFinished, CGSizeZero));
+  XCTAssertTrue(CGSizeEqualToSize(testee.canvasSize, CGSizeMake(2, 1)));
+  NSArray* expectedPositionsNodeMove1 = @[[self positionWithX:1 y:0]];
+  XCTAssertEqualObjects([testee selectedNodePositions], expectedPositionsNodeMove1);
+}
+
 #pragma mark - Helper methods - Configure NodeTreeViewModel
 
 // -----------------------------------------------------------------------------
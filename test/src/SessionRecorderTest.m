@@ -0,0 +1,137 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+// Test includes
+#import "SessionRecorderTest.h"
+
+// Application includes
+#import <command/CommandBase.h>
+#import <diagnostics/SessionRecorder.h>
+#import <diagnostics/SessionReplay.h>
+
+
+@implementation SessionRecorderTest
+
+// -----------------------------------------------------------------------------
+/// @brief Checks the initial state of a SessionRecorder object after a new
+/// instance has been created.
+// -----------------------------------------------------------------------------
+- (void) testInitialState
+{
+  SessionRecorder* sessionRecorder = [[[SessionRecorder alloc] init] autorelease];
+  XCTAssertFalse(sessionRecorder.isRecording);
+  XCTAssertEqual(sessionRecorder.recordedEntries.count, 0);
+
+  // Nothing is recorded while not recording
+  [sessionRecorder recordGtpCommand:@"play b a1"];
+  XCTAssertEqual(sessionRecorder.recordedEntries.count, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the recordCommand:() and recordGtpCommand:() methods.
+// -----------------------------------------------------------------------------
+- (void) testRecording
+{
+  SessionRecorder* sessionRecorder = [[[SessionRecorder alloc] init] autorelease];
+  [sessionRecorder startRecording];
+  XCTAssertTrue(sessionRecorder.isRecording);
+
+  CommandBase* command = [[[CommandBase alloc] init] autorelease];
+  [sessionRecorder recordCommand:command];
+  [sessionRecorder recordGtpCommand:@"play b a1"];
+  [sessionRecorder recordGtpCommand:nil];
+
+  NSArray* recordedEntries = sessionRecorder.recordedEntries;
+  XCTAssertEqual(recordedEntries.count, 2);
+  NSDictionary* firstEntry = recordedEntries[0];
+  XCTAssertEqualObjects(firstEntry[sessionRecordingEntryTypeKey], sessionRecordingEntryTypeCommand);
+  XCTAssertEqualObjects(firstEntry[sessionRecordingEntryContentKey], command.name);
+  NSDictionary* secondEntry = recordedEntries[1];
+  XCTAssertEqualObjects(secondEntry[sessionRecordingEntryTypeKey], sessionRecordingEntryTypeGtpCommand);
+  XCTAssertEqualObjects(secondEntry[sessionRecordingEntryContentKey], @"play b a1");
+  XCTAssertLessThanOrEqual([firstEntry[sessionRecordingEntryTimeKey] doubleValue],
+                           [secondEntry[sessionRecordingEntryTimeKey] doubleValue]);
+
+  // Starting again discards the previous recording
+  [sessionRecorder startRecording];
+  XCTAssertEqual(sessionRecorder.recordedEntries.count, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the stopRecording() method.
+// -----------------------------------------------------------------------------
+- (void) testStopRecording
+{
+  SessionRecorder* sessionRecorder = [[[SessionRecorder alloc] init] autorelease];
+  XCTAssertEqual([sessionRecorder stopRecording].count, 0);
+
+  [sessionRecorder startRecording];
+  [sessionRecorder recordGtpCommand:@"play b a1"];
+  NSArray* recording = [sessionRecorder stopRecording];
+  XCTAssertEqual(recording.count, 1);
+  XCTAssertFalse(sessionRecorder.isRecording);
+  XCTAssertEqual(sessionRecorder.recordedEntries.count, 0);
+
+  [sessionRecorder recordGtpCommand:@"play w b2"];
+  XCTAssertEqual(recording.count, 1);
+  XCTAssertEqual(sessionRecorder.recordedEntries.count, 0);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the writeRecording:toFile:() and
+/// recordingWithContentsOfFile:() methods.
+// -----------------------------------------------------------------------------
+- (void) testWriteAndReadRecording
+{
+  SessionRecorder* sessionRecorder = [[[SessionRecorder alloc] init] autorelease];
+  [sessionRecorder startRecording];
+  [sessionRecorder recordCommand:[[[CommandBase alloc] init] autorelease]];
+  [sessionRecorder recordGtpCommand:@"play b a1"];
+  NSArray* recording = [sessionRecorder stopRecording];
+
+  NSString* filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"SessionRecorderTest.plist"];
+  XCTAssertTrue([SessionRecorder writeRecording:recording toFile:filePath]);
+  NSArray* readRecording = [SessionRecorder recordingWithContentsOfFile:filePath];
+  XCTAssertEqualObjects(readRecording, recording);
+  [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+
+  XCTAssertNil([SessionRecorder recordingWithContentsOfFile:filePath]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Exercises the initWithRecording:() initializer of SessionReplay.
+// -----------------------------------------------------------------------------
+- (void) testReplayInitialization
+{
+  NSArray* recording = @[
+    @{ sessionRecordingEntryTypeKey : sessionRecordingEntryTypeCommand, sessionRecordingEntryTimeKey : @0.5, sessionRecordingEntryContentKey : @"PlayMoveCommand" },
+    @{ sessionRecordingEntryTypeKey : sessionRecordingEntryTypeGtpCommand, sessionRecordingEntryTimeKey : @0.75, sessionRecordingEntryContentKey : @"play b a1" },
+    @{ sessionRecordingEntryTypeKey : sessionRecordingEntryTypeGtpCommand, sessionRecordingEntryTimeKey : @2.5, sessionRecordingEntryContentKey : @"genmove w" },
+  ];
+
+  SessionReplay* sessionReplay = [[[SessionReplay alloc] initWithRecording:recording] autorelease];
+  XCTAssertEqualObjects(sessionReplay.recordedCommandNames, @[@"PlayMoveCommand"]);
+  XCTAssertEqualWithAccuracy(sessionReplay.recordedDuration, 2.0, 0.0001);
+  XCTAssertEqual(sessionReplay.randomSeed, 1);
+  XCTAssertEqual(sessionReplay.maxGames, 1000);
+  XCTAssertEqual(sessionReplay.numberOfReplayedGtpCommands, 0);
+
+  sessionReplay = [[[SessionReplay alloc] initWithRecording:@[]] autorelease];
+  XCTAssertEqual(sessionReplay.recordedCommandNames.count, 0);
+  XCTAssertEqual(sessionReplay.recordedDuration, 0.0);
+}
+
+@end
@@ -0,0 +1,47 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Project includes
+#import "BaseTestCase.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The SgfPerformanceTest class contains performance tests that
+/// measure the throughput of writing and reading SGF files of different
+/// sizes.
+///
+/// Each test generates a synthetic game tree whose shape is described by a
+/// workload: the length of the main variation, how often and how many
+/// variations branch off, how long these variations are, and the fraction of
+/// nodes that have markup. The game tree is then saved with SaveSgfCommand
+/// and the resulting file is read with LoadSgfCommand.
+///
+/// The time spent in each phase (model build, validation, write, parse) is
+/// recorded separately for every iteration of the measurement. At the end of
+/// the test a JSON report with the phase timings is attached to the test
+/// result, so that the timings of different builds can be compared with
+/// tools that read the test results.
+// -----------------------------------------------------------------------------
+@interface SgfPerformanceTest : BaseTestCase
+{
+}
+
+- (void) testPerformanceSmallFile;
+- (void) testPerformanceLargeFile;
+- (void) testPerformanceHugeFile;
+
+@end
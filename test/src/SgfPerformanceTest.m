@@ -0,0 +1,412 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+// Test includes
+#import "SgfPerformanceTest.h"
+
+// Application includes
+#import <main/ApplicationDelegate.h>
+#import <command/game/NewGameCommand.h>
+#import <command/sgf/LoadSgfCommand.h>
+#import <command/sgf/SaveSgfCommand.h>
+#import <go/GoBoard.h>
+#import <go/GoBoardPosition.h>
+#import <go/GoGame.h>
+#import <go/GoMoveNodeCreationOptions.h>
+#import <go/GoNode.h>
+#import <go/GoNodeMarkup.h>
+#import <go/GoPoint.h>
+#import <go/GoVertex.h>
+
+// System includes
+#import <QuartzCore/QuartzCore.h>
+
+
+// -----------------------------------------------------------------------------
+/// @brief Describes the shape of the synthetic game tree that is generated by
+/// a performance test.
+// -----------------------------------------------------------------------------
+struct SgfPerformanceWorkload
+{
+  /// @brief The name of the workload. Is used in the report.
+  const char* name;
+  /// @brief The number of moves in the main variation.
+  int depth;
+  /// @brief A branching point exists on every n-th node of the main
+  /// variation. 0 means that there are no branching points.
+  int branchingInterval;
+  /// @brief The number of child nodes of each branching point. The first
+  /// child node continues the main variation, the remaining child nodes each
+  /// start a new variation.
+  int branchingFactor;
+  /// @brief The maximum number of moves in each variation that branches off
+  /// from the main variation.
+  int variationDepth;
+  /// @brief The fraction of nodes that have markup, between 0.0 and 1.0.
+  double markupDensity;
+};
+
+static const struct SgfPerformanceWorkload smallFileWorkload = { "small", 60, 0, 1, 0, 0.1 };
+static const struct SgfPerformanceWorkload largeFileWorkload = { "large", 200, 10, 3, 20, 0.3 };
+static const struct SgfPerformanceWorkload hugeFileWorkload = { "huge", 250, 5, 5, 40, 0.8 };
+
+// The seed for the pseudo random number generator that chooses moves and
+// markup. A fixed seed makes the generated game trees reproducible.
+static const unsigned int gameTreeSeed = 4711;
+
+// The names of the phases that appear in the report
+static NSString* modelBuildPhase = @"modelBuild";
+static NSString* writePhase = @"write";
+static NSString* validationPhase = @"validation";
+static NSString* parsePhase = @"parse";
+
+
+// -----------------------------------------------------------------------------
+/// @brief Class extension with private properties for SgfPerformanceTest.
+// -----------------------------------------------------------------------------
+@interface SgfPerformanceTest()
+/// @brief Key = phase name, value = NSMutableArray with one NSNumber for each
+/// iteration of the measurement. The NSNumber is the phase's duration in
+/// milliseconds.
+@property(nonatomic, retain) NSMutableDictionary* phaseDurations;
+@property(nonatomic, assign) int numberOfNodesInGameTree;
+@property(nonatomic, assign) unsigned long long fileSize;
+@end
+
+
+@implementation SgfPerformanceTest
+
+#pragma mark - Setup and teardown
+
+// -----------------------------------------------------------------------------
+/// @brief Sets up the environment for a test case method.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  [super setUp];
+  self.phaseDurations = [NSMutableDictionary dictionary];
+  self.numberOfNodesInGameTree = 0;
+  self.fileSize = 0;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Tears down the environment previously set up for a test case method.
+// -----------------------------------------------------------------------------
+- (void) tearDown
+{
+  self.phaseDurations = nil;
+  [super tearDown];
+}
+
+#pragma mark - Performance tests
+
+// -----------------------------------------------------------------------------
+/// @brief Measures a game tree that consists of a short main variation with
+/// little markup.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceSmallFile
+{
+  [self measureWorkload:smallFileWorkload];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures a game tree that consists of a long main variation with a
+/// moderate number of variations and markup.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceLargeFile
+{
+  [self measureWorkload:largeFileWorkload];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures a game tree with thousands of nodes in many variations,
+/// most of which have markup.
+// -----------------------------------------------------------------------------
+- (void) testPerformanceHugeFile
+{
+  [self measureWorkload:hugeFileWorkload];
+}
+
+#pragma mark - Measurement
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Measures a full build/write/parse cycle for
+/// @a workload, then attaches the report to the test result.
+// -----------------------------------------------------------------------------
+- (void) measureWorkload:(struct SgfPerformanceWorkload)workload
+{
+  NSString* folderPath = [NSTemporaryDirectory() stringByAppendingPathComponent:NSStringFromClass([self class])];
+  [[NSFileManager defaultManager] createDirectoryAtPath:folderPath withIntermediateDirectories:YES attributes:nil error:nil];
+  NSString* sgfFilePath = [folderPath stringByAppendingPathComponent:@"write.sgf"];
+  NSString* validatedSgfFilePath = [folderPath stringByAppendingPathComponent:@"validate.sgf"];
+
+  [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:YES forBlock:^
+  {
+    [[[[NewGameCommand alloc] init] autorelease] submit];
+    GoGame* game = m_delegate.game;
+
+    CFTimeInterval startTime = CACurrentMediaTime();
+    self.numberOfNodesInGameTree = [self buildGameTreeInGame:game workload:workload];
+    [self recordPhase:modelBuildPhase sinceTime:startTime];
+
+    startTime = CACurrentMediaTime();
+    XCTAssertTrue([self saveGameToSgfFile:sgfFilePath validateSgfContent:false]);
+    CFTimeInterval writeDuration = CACurrentMediaTime() - startTime;
+    [self recordPhase:writePhase sinceTime:startTime];
+
+    // SaveSgfCommand's validation is a dry run of the full write cycle. Its
+    // cost therefore is the difference between a save operation with and a
+    // save operation without validation.
+    startTime = CACurrentMediaTime();
+    XCTAssertTrue([self saveGameToSgfFile:validatedSgfFilePath validateSgfContent:true]);
+    [self recordPhase:validationPhase sinceTime:(startTime + writeDuration)];
+
+    startTime = CACurrentMediaTime();
+    XCTAssertTrue([self loadSgfFile:sgfFilePath]);
+    [self recordPhase:parsePhase sinceTime:startTime];
+  }];
+
+  NSDictionary* fileAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:sgfFilePath error:nil];
+  self.fileSize = fileAttributes.fileSize;
+  [[NSFileManager defaultManager] removeItemAtPath:folderPath error:nil];
+
+  [self attachReportForWorkload:workload];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Adds the time elapsed since @a startTime to the
+/// list of durations of the phase named @a phaseName.
+// -----------------------------------------------------------------------------
+- (void) recordPhase:(NSString*)phaseName sinceTime:(CFTimeInterval)startTime
+{
+  NSMutableArray* durations = self.phaseDurations[phaseName];
+  if (! durations)
+  {
+    durations = [NSMutableArray array];
+    self.phaseDurations[phaseName] = durations;
+  }
+  double durationInMilliseconds = (CACurrentMediaTime() - startTime) * 1000.0;
+  [durations addObject:[NSNumber numberWithDouble:durationInMilliseconds]];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Attaches a JSON report with the parameters of
+/// @a workload, the size of the generated game tree and file, and the
+/// minimum and median duration of each phase to the test result. The report
+/// is also logged.
+// -----------------------------------------------------------------------------
+- (void) attachReportForWorkload:(struct SgfPerformanceWorkload)workload
+{
+  NSString* workloadName = [NSString stringWithUTF8String:workload.name];
+
+  NSMutableDictionary* phases = [NSMutableDictionary dictionary];
+  for (NSString* phaseName in self.phaseDurations)
+  {
+    NSArray* durations = [self.phaseDurations[phaseName] sortedArrayUsingSelector:@selector(compare:)];
+    phases[phaseName] = @{
+      @"iterations": @(durations.count),
+      @"minimumMilliseconds": durations.firstObject,
+      @"medianMilliseconds": [durations objectAtIndex:(durations.count / 2)],
+    };
+  }
+
+  NSDictionary* report = @{
+    @"workload": workloadName,
+    @"parameters": @{
+      @"depth": @(workload.depth),
+      @"branchingInterval": @(workload.branchingInterval),
+      @"branchingFactor": @(workload.branchingFactor),
+      @"variationDepth": @(workload.variationDepth),
+      @"markupDensity": @(workload.markupDensity),
+    },
+    @"numberOfNodes": @(self.numberOfNodesInGameTree),
+    @"fileSizeBytes": @(self.fileSize),
+    @"phases": phases,
+  };
+
+  NSData* reportData = [NSJSONSerialization dataWithJSONObject:report
+                                                       options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys
+                                                         error:nil];
+  XCTAssertNotNil(reportData);
+  NSLog(@"%@: %@", self, [[[NSString alloc] initWithData:reportData encoding:NSUTF8StringEncoding] autorelease]);
+
+  XCTAttachment* attachment = [XCTAttachment attachmentWithData:reportData uniformTypeIdentifier:@"public.json"];
+  attachment.name = [NSString stringWithFormat:@"SgfPerformance-%@.json", workloadName];
+  attachment.lifetime = XCTAttachmentLifetimeKeepAlways;
+  [self addAttachment:attachment];
+}
+
+#pragma mark - Phases
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Generates a game tree in @a game whose shape is
+/// described by @a workload. Returns the number of nodes that were created.
+///
+/// Variations are generated after the main variation, starting with the
+/// branching point nearest to the end of the main variation. Because every
+/// new variation shares all nodes up to its branching point with the main
+/// variation, earlier branching points can be selected simply by changing the
+/// current board position.
+// -----------------------------------------------------------------------------
+- (int) buildGameTreeInGame:(GoGame*)game workload:(struct SgfPerformanceWorkload)workload
+{
+  srandom(gameTreeSeed);
+  GoMoveNodeCreationOptions* appendOptions = [GoMoveNodeCreationOptions moveNodeCreationOptions];
+  GoMoveNodeCreationOptions* newVariationOptions = [GoMoveNodeCreationOptions moveNodeCreationOptionsWithInsertPolicyRetainFutureBoardPositionsAndInsertPosition:GoNewMoveInsertPositionNewVariationAtBottom];
+
+  int numberOfNodes = 0;
+  for (int moveNumber = 0; moveNumber < workload.depth; ++moveNumber)
+  {
+    if (! [self playRandomMoveInGame:game withMoveNodeCreationOptions:appendOptions markupDensity:workload.markupDensity])
+      break;
+    ++numberOfNodes;
+  }
+
+  if (workload.branchingInterval <= 0)
+    return numberOfNodes;
+
+  int lastBranchingPoint = numberOfNodes - (numberOfNodes % workload.branchingInterval);
+  for (int branchingPoint = lastBranchingPoint; branchingPoint > 0; branchingPoint -= workload.branchingInterval)
+  {
+    for (int variation = 1; variation < workload.branchingFactor; ++variation)
+    {
+      game.boardPosition.currentBoardPosition = branchingPoint;
+      GoMoveNodeCreationOptions* options = newVariationOptions;
+      for (int moveNumber = 0; moveNumber < workload.variationDepth; ++moveNumber)
+      {
+        if (! [self playRandomMoveInGame:game withMoveNodeCreationOptions:options markupDensity:workload.markupDensity])
+          break;
+        ++numberOfNodes;
+        options = appendOptions;
+      }
+    }
+  }
+
+  return numberOfNodes;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Saves the current game to @a sgfFilePath. Returns
+/// true if the file was saved successfully.
+// -----------------------------------------------------------------------------
+- (bool) saveGameToSgfFile:(NSString*)sgfFilePath validateSgfContent:(bool)validateSgfContent
+{
+  bool sgfFileAlreadyExists = [[NSFileManager defaultManager] fileExistsAtPath:sgfFilePath];
+  SaveSgfCommand* command = [[[SaveSgfCommand alloc] initWithSgfFilePath:sgfFilePath sgfFileAlreadyExists:sgfFileAlreadyExists] autorelease];
+  command.validateSgfContent = validateSgfContent;
+  bool success = [command submit];
+  if (! success)
+    NSLog(@"%@: SaveSgfCommand failed: %@", self, command.errorMessage);
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Reads the SGF file at @a sgfFilePath. Returns true
+/// if the file was read and contains valid SGF data.
+// -----------------------------------------------------------------------------
+- (bool) loadSgfFile:(NSString*)sgfFilePath
+{
+  LoadSgfCommand* command = [[[LoadSgfCommand alloc] initWithSgfFilePath:sgfFilePath] autorelease];
+  command.ignoreSgfSettings = true;
+  if (! [command submit])
+    return false;
+  return command.sgfDocumentReadResultSingleEncoding.isSgfDataValid;
+}
+
+#pragma mark - Game tree generation
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Plays a pseudo random legal move in @a game that
+/// does not fill one of the player's own single-point eyes. With probability
+/// @a markupDensity the new node also gets markup. Returns false if no such
+/// move exists.
+// -----------------------------------------------------------------------------
+- (bool) playRandomMoveInGame:(GoGame*)game
+  withMoveNodeCreationOptions:(GoMoveNodeCreationOptions*)moveNodeCreationOptions
+                markupDensity:(double)markupDensity
+{
+  NSMutableArray* candidatePoints = [self emptyPointsInGame:game];
+  while (candidatePoints.count > 0)
+  {
+    NSUInteger index = random() % candidatePoints.count;
+    GoPoint* point = [candidatePoints objectAtIndex:index];
+    [candidatePoints removeObjectAtIndex:index];
+
+    enum GoMoveIsIllegalReason illegalReason;
+    if (! [game isLegalMove:point isIllegalReason:&illegalReason])
+      continue;
+    if ([self isSinglePointEye:point ofColor:game.nextMoveColor])
+      continue;
+
+    [game play:point withMoveNodeCreationOptions:moveNodeCreationOptions];
+    if ((random() % 1000) < (long)(markupDensity * 1000))
+      [self addMarkupToNode:game.boardPosition.currentNode aroundPoint:point];
+    return true;
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Adds a symbol, a label, a connection and a dimming
+/// to @a node, all located on or next to @a point.
+// -----------------------------------------------------------------------------
+- (void) addMarkupToNode:(GoNode*)node aroundPoint:(GoPoint*)point
+{
+  GoNodeMarkup* nodeMarkup = [[[GoNodeMarkup alloc] init] autorelease];
+  [nodeMarkup setSymbol:GoMarkupSymbolTriangle atVertex:point.vertex.string];
+
+  GoPoint* firstNeighbour = [point.neighbours firstObject];
+  GoPoint* lastNeighbour = [point.neighbours lastObject];
+  [nodeMarkup setLabel:GoMarkupLabelLabel labelText:@"synthetic" atVertex:firstNeighbour.vertex.string];
+  [nodeMarkup setConnection:GoMarkupConnectionArrow fromVertex:point.vertex.string toVertex:firstNeighbour.vertex.string];
+  [nodeMarkup setDimmingAtVertex:lastNeighbour.vertex.string];
+
+  node.goNodeMarkup = nodeMarkup;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns true if all neighbours of @a point are
+/// occupied by stones of color @a color.
+// -----------------------------------------------------------------------------
+- (bool) isSinglePointEye:(GoPoint*)point ofColor:(enum GoColor)color
+{
+  for (GoPoint* neighbour in point.neighbours)
+  {
+    if (neighbour.stoneState != color)
+      return false;
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the empty GoPoint objects of @a game's
+/// board, in the order in which GoBoard enumerates them.
+// -----------------------------------------------------------------------------
+- (NSMutableArray*) emptyPointsInGame:(GoGame*)game
+{
+  NSMutableArray* emptyPoints = [NSMutableArray array];
+  NSEnumerator* enumerator = [game.board pointEnumerator];
+  GoPoint* point;
+  while (point = [enumerator nextObject])
+  {
+    if (! [point hasStone])
+      [emptyPoints addObject:point];
+  }
+  return emptyPoints;
+}
+
+@end
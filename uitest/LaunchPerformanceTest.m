@@ -0,0 +1,271 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+
+// Project includes
+#import "UiElementFinder.h"
+#import "UiTestDeviceInfo.h"
+#import "../src/utility/UIDeviceAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The LaunchPerformanceTest class measures how long it takes to launch
+/// the app.
+///
+/// Each test launches the app several times. A launch is considered to be
+/// complete only when the board view displays the restored game, so that the
+/// measurement covers not only the work done in
+/// application:didFinishLaunchingWithOptions:() but also the GTP engine boot
+/// and the restore of the application state that happen afterwards in
+/// SetupApplicationCommand.
+///
+/// The tests measure the following metrics:
+/// - The launch duration as seen by the system.
+/// - The duration of the os_signpost intervals that the app emits for each
+///   launch phase.
+/// - Wall clock time.
+///
+/// The fixture game used by testLaunchWithLargeGame() is passed to the app as
+/// SGF content via the launch environment. The app restores the game via the
+/// same mechanism that it uses to restore a backup game at startup. The game
+/// is designed to make the restore expensive:
+/// - The board size is 19x19.
+/// - The main line consists of #mainLineLength moves.
+/// - #numberOfVariations variations with #variationLength moves each branch
+///   off the main line.
+///
+/// See the section "Automated UI tests" in the document TESTING for details
+/// about how UI testing works.
+// -----------------------------------------------------------------------------
+@interface LaunchPerformanceTest : XCTestCase
+@end
+
+
+/// @brief The number of moves in the main line of the generated game.
+static const int mainLineLength = 170;
+/// @brief The number of variations in the generated game.
+static const int numberOfVariations = 120;
+/// @brief The number of moves in each variation of the generated game.
+static const int variationLength = 40;
+/// @brief Variations branch off at a board position below this value.
+static const int maximumBranchingBoardPosition = 100;
+/// @brief The board size of the generated game.
+static const int boardDimension = 19;
+
+
+@implementation LaunchPerformanceTest
+
+#pragma mark - setUp and tearDown
+
+// -----------------------------------------------------------------------------
+/// @brief Sets the environment up for a test.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  self.continueAfterFailure = NO;
+
+  if ([UIDevice systemVersionMajor] < 14)
+  {
+    XCTFail(@"For unknown reasons tests are unable to find the status label on iOS versions below 14. Possibly other limitations exist, so to be on the safe side running tests on iOS versions that are too low is disabled entirely.");
+  }
+}
+
+#pragma mark - Tests
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the launch performance when the app starts with a new game.
+// -----------------------------------------------------------------------------
+- (void) testLaunchWithNewGame
+{
+  [self measureLaunchWithSgfContent:nil boardSize:GoBoardSize9];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the launch performance when the app restores a large game.
+// -----------------------------------------------------------------------------
+- (void) testLaunchWithLargeGame
+{
+  [self measureLaunchWithSgfContent:[self generateSgfContent] boardSize:GoBoardSize19];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Launches the app repeatedly and measures the launch
+/// performance. The app restores the game in @a sgfContent, or starts with a
+/// new game if @a sgfContent is nil. A launch is complete when the board view
+/// displays a board of size @a boardSize.
+// -----------------------------------------------------------------------------
+- (void) measureLaunchWithSgfContent:(NSString*)sgfContent boardSize:(enum GoBoardSize)boardSize
+{
+  [self measureWithMetrics:[self launchMetrics]
+                   options:[self measureOptions]
+                     block:^
+  {
+    XCUIApplication* app = [[XCUIApplication alloc] init];
+    app.launchArguments = @[uiTestModeLaunchArgument];
+    if (sgfContent)
+      app.launchEnvironment = @{ uiTestSgfContentLaunchEnvironmentKey : sgfContent };
+    [app launch];
+
+    UiTestDeviceInfo* uiTestDeviceInfo = [[UiTestDeviceInfo alloc] initWithUiApplication:app];
+    UiElementFinder* uiElementFinder = [[UiElementFinder alloc] initWithUiTestDeviceInfo:uiTestDeviceInfo];
+    XCUIElement* lineGrid = [uiElementFinder findLineGridOnBoardWithSize:boardSize withUiApplication:app];
+    XCTAssertTrue([lineGrid waitForExistenceWithTimeout:60]);
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the metrics to measure.
+// -----------------------------------------------------------------------------
+- (NSArray<id<XCTMetric>>*) launchMetrics
+{
+  NSMutableArray<id<XCTMetric>>* metrics = [NSMutableArray array];
+
+  [metrics addObject:[[XCTApplicationLaunchMetric alloc] initWithWaitUntilResponsive:YES]];
+
+  NSArray<NSString*>* launchPhaseSignpostNames = @[launchSetupLoggingSignpostName,
+                                                   launchSetupUserDefaultsSignpostName,
+                                                   launchSetupFuegoSignpostName,
+                                                   launchSetupGUISignpostName,
+                                                   launchSetupApplicationSignpostName,
+                                                   launchRestoreApplicationStateSignpostName];
+  for (NSString* signpostName in launchPhaseSignpostNames)
+  {
+    [metrics addObject:[[XCTOSSignpostMetric alloc] initWithSubsystem:drawingSignpostSubsystem
+                                                              category:launchSignpostCategory
+                                                                  name:signpostName]];
+  }
+
+  [metrics addObject:[[XCTClockMetric alloc] init]];
+
+  return metrics;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the options to use for measuring.
+// -----------------------------------------------------------------------------
+- (XCTMeasureOptions*) measureOptions
+{
+  XCTMeasureOptions* options = [XCTMeasureOptions defaultOptions];
+  options.iterationCount = 5;
+  return options;
+}
+
+#pragma mark - Private helpers - Game generation
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Generates the SGF content of the fixture game that
+/// is used by testLaunchWithLargeGame().
+///
+/// All moves are chosen from a checkerboard pattern so that stones never touch
+/// each other. As a result no stones are ever captured and every move is
+/// legal. Black plays in the lower half of the board, White in the upper half,
+/// the row in the middle of the board always remains empty.
+// -----------------------------------------------------------------------------
+- (NSString*) generateSgfContent
+{
+  NSArray<NSString*>* blackPoints = [self movePointsInRowsFrom:0 to:boardDimension / 2 - 1];
+  NSArray<NSString*>* whitePoints = [self movePointsInRowsFrom:boardDimension / 2 + 1 to:boardDimension - 1];
+
+  // The moves of a variation consume the move points from the back. Because
+  // variations branch off early enough, the points that a variation uses are
+  // never occupied in the board position where the variation branches off.
+  NSMutableDictionary<NSNumber*, NSMutableArray<NSString*>*>* variationsByMoveIndex = [NSMutableDictionary dictionary];
+  for (int variationIndex = 0; variationIndex < numberOfVariations; ++variationIndex)
+  {
+    // 7 and maximumBranchingBoardPosition are coprime, so the branching
+    // positions spread evenly over the early part of the main line
+    int firstMoveIndex = (variationIndex * 7) % maximumBranchingBoardPosition;
+
+    NSMutableString* variation = [NSMutableString stringWithString:@"("];
+    for (int variationMoveIndex = 0; variationMoveIndex < variationLength; ++variationMoveIndex)
+    {
+      int moveIndex = firstMoveIndex + variationMoveIndex;
+      bool isBlackMove = (moveIndex % 2 == 0);
+      NSArray<NSString*>* movePoints = isBlackMove ? blackPoints : whitePoints;
+      NSString* movePoint = movePoints[movePoints.count - 1 - variationMoveIndex / 2];
+      [variation appendFormat:@";%@[%@]", isBlackMove ? @"B" : @"W", movePoint];
+    }
+    [variation appendString:@")"];
+
+    NSMutableArray<NSString*>* variations = variationsByMoveIndex[@(firstMoveIndex)];
+    if (! variations)
+    {
+      variations = [NSMutableArray array];
+      variationsByMoveIndex[@(firstMoveIndex)] = variations;
+    }
+    [variations addObject:variation];
+  }
+
+  // The moves of the main line consume the move points from the front. In
+  // SGF a variation is written after the sub-tree that contains the remainder
+  // of the main line.
+  NSMutableString* sgfContent = [NSMutableString stringWithFormat:@"(;FF[4]GM[1]CA[UTF-8]SZ[%d]KM[6.5]", boardDimension];
+  NSMutableArray<NSArray<NSString*>*>* pendingVariations = [NSMutableArray array];
+  for (int moveIndex = 0; moveIndex < mainLineLength; ++moveIndex)
+  {
+    NSArray<NSString*>* variations = variationsByMoveIndex[@(moveIndex)];
+    if (variations)
+    {
+      [sgfContent appendString:@"("];
+      [pendingVariations addObject:variations];
+    }
+    bool isBlackMove = (moveIndex % 2 == 0);
+    NSArray<NSString*>* movePoints = isBlackMove ? blackPoints : whitePoints;
+    [sgfContent appendFormat:@";%@[%@]", isBlackMove ? @"B" : @"W", movePoints[moveIndex / 2]];
+  }
+  for (NSArray<NSString*>* variations in pendingVariations.reverseObjectEnumerator)
+  {
+    [sgfContent appendString:@")"];
+    for (NSString* variation in variations)
+      [sgfContent appendString:variation];
+  }
+  [sgfContent appendString:@")"];
+
+  return sgfContent;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the SGF points in rows @a firstRow to
+/// @a lastRow (zero-based, inclusive) whose coordinates add up to an even
+/// number.
+// -----------------------------------------------------------------------------
+- (NSArray<NSString*>*) movePointsInRowsFrom:(int)firstRow to:(int)lastRow
+{
+  NSMutableArray<NSString*>* points = [NSMutableArray array];
+  for (int row = firstRow; row <= lastRow; ++row)
+  {
+    for (int column = 0; column < boardDimension; ++column)
+    {
+      if ((column + row) % 2 == 0)
+        [points addObject:[self sgfPointWithColumn:column row:row]];
+    }
+  }
+  return points;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the SGF point with zero-based coordinates
+/// @a column and @a row.
+// -----------------------------------------------------------------------------
+- (NSString*) sgfPointWithColumn:(int)column row:(int)row
+{
+  return [NSString stringWithFormat:@"%c%c", 'a' + column, 'a' + row];
+}
+
+@end
@@ -0,0 +1,432 @@
+// -----------------------------------------------------------------------------
+// Copyright 2024 Patrick Näf (herzbube@herzbube.ch)
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// -----------------------------------------------------------------------------
+
+
+
+// Project includes
+#import "UiElementFinder.h"
+#import "UiTestDeviceInfo.h"
+#import "UiTestHelper.h"
+#import "../src/utility/UIDeviceAdditions.h"
+
+
+// -----------------------------------------------------------------------------
+/// @brief The PortraitRenderingPerformanceTest class measures the rendering
+/// performance of the board view and the node tree view when in interface
+/// orientation Portrait.
+///
+/// Each test launches the app with a generated game that is designed to make
+/// drawing expensive:
+/// - The board size is 19x19.
+/// - The main line consists of #mainLineLength moves. Every node of the main
+///   line has heavy markup (symbols, labels, arrows, lines and dimmings).
+/// - #numberOfVariations variations with #variationLength moves each branch
+///   off the main line, so that the node tree contains roughly 5,000 nodes.
+///
+/// The game is passed to the app as SGF content via the launch environment.
+/// The app restores the game via the same mechanism that it uses to restore a
+/// backup game at startup.
+///
+/// The tests script gestures (pinch zoom, pan, board position scrubbing) and
+/// measure the following metrics:
+/// - Frame rate and hitches during scrolling and deceleration.
+/// - The duration of the os_signpost intervals that the app emits each time
+///   it draws a board view or node tree view layer.
+/// - Wall clock time.
+///
+/// See the section "Automated UI tests" in the document TESTING for details
+/// about how UI testing works.
+// -----------------------------------------------------------------------------
+@interface PortraitRenderingPerformanceTest : XCTestCase
+@property(nonatomic, strong) XCUIApplication* app;
+@property(nonatomic, strong) UiTestDeviceInfo* uiTestDeviceInfo;
+@property(nonatomic, strong) UiElementFinder* uiElementFinder;
+@property(nonatomic, strong) UiTestHelper* uiTestHelper;
+@end
+
+
+/// @brief The number of moves in the main line of the generated game.
+static const int mainLineLength = 170;
+/// @brief The number of variations in the generated game.
+static const int numberOfVariations = 120;
+/// @brief The number of moves in each variation of the generated game.
+static const int variationLength = 40;
+/// @brief Variations branch off at a board position below this value.
+static const int maximumBranchingBoardPosition = 100;
+/// @brief The board size of the generated game.
+static const int boardDimension = 19;
+/// @brief The number of times that each gesture sequence is repeated within a
+/// single measurement.
+static const int numberOfGestureRepetitions = 3;
+/// @brief The number of board positions to scrub through in a single
+/// measurement.
+static const int numberOfScrubbedBoardPositions = 20;
+
+
+@implementation PortraitRenderingPerformanceTest
+
+#pragma mark - setUp and tearDown
+
+// -----------------------------------------------------------------------------
+/// @brief Sets the environment up for a test.
+// -----------------------------------------------------------------------------
+- (void) setUp
+{
+  self.continueAfterFailure = NO;
+
+  if ([UIDevice systemVersionMajor] < 14)
+  {
+    XCTFail(@"For unknown reasons tests are unable to find the status label on iOS versions below 14. Possibly other limitations exist, so to be on the safe side running tests on iOS versions that are too low is disabled entirely.");
+  }
+
+  XCUIApplication* app = [[XCUIApplication alloc] init];
+  app.launchArguments = @[uiTestModeLaunchArgument];
+  app.launchEnvironment = @{ uiTestSgfContentLaunchEnvironmentKey : [self generateSgfContent] };
+  [app launch];
+
+  [XCUIDevice sharedDevice].orientation = UIDeviceOrientationPortrait;
+
+  self.app = app;
+  self.uiTestDeviceInfo = [[UiTestDeviceInfo alloc] initWithUiApplication:app];
+  self.uiElementFinder = [[UiElementFinder alloc] initWithUiTestDeviceInfo:self.uiTestDeviceInfo];
+  self.uiTestHelper = [[UiTestHelper alloc] initWithUiElementFinder:self.uiElementFinder];
+
+  // Restoring a game with this many nodes takes a while
+  XCUIElement* lineGrid = [self.uiElementFinder findLineGridOnBoardWithSize:GoBoardSize19 withUiApplication:app];
+  XCTAssertTrue([lineGrid waitForExistenceWithTimeout:60]);
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Tears the environment down after a test.
+// -----------------------------------------------------------------------------
+- (void) tearDown
+{
+  self.uiTestHelper = nil;
+  self.uiElementFinder = nil;
+  self.uiTestDeviceInfo = nil;
+  self.app = nil;
+}
+
+#pragma mark - Tests
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the rendering performance of the board view while the user
+/// zooms in, pans around and zooms out again.
+// -----------------------------------------------------------------------------
+- (void) testBoardViewPinchZoomAndPan
+{
+  XCUIElement* lineGrid = [self.uiElementFinder findLineGridOnBoardWithSize:GoBoardSize19 withUiApplication:self.app];
+
+  [self measureWithMetrics:[self metricsWithScrollingAndDeceleration:true]
+                   options:[self measureOptions]
+                     block:^
+  {
+    for (int repetition = 0; repetition < numberOfGestureRepetitions; ++repetition)
+    {
+      [lineGrid pinchWithScale:3.0 velocity:2.0];
+      [lineGrid swipeLeft];
+      [lineGrid swipeUp];
+      [lineGrid swipeRight];
+      [lineGrid swipeDown];
+      [lineGrid pinchWithScale:0.3 velocity:-2.0];
+    }
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the rendering performance of the node tree view while the
+/// user zooms in, pans around and zooms out again.
+// -----------------------------------------------------------------------------
+- (void) testNodeTreeViewPinchZoomAndPan
+{
+  XCUIElement* nodeTreeView = [self findNodeTreeView];
+
+  [self measureWithMetrics:[self metricsWithScrollingAndDeceleration:true]
+                   options:[self measureOptions]
+                     block:^
+  {
+    for (int repetition = 0; repetition < numberOfGestureRepetitions; ++repetition)
+    {
+      [nodeTreeView pinchWithScale:3.0 velocity:2.0];
+      [nodeTreeView swipeLeft];
+      [nodeTreeView swipeUp];
+      [nodeTreeView swipeRight];
+      [nodeTreeView swipeDown];
+      [nodeTreeView pinchWithScale:0.3 velocity:-2.0];
+    }
+  }];
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Measures the rendering performance of the board view and the node
+/// tree view while the user scrubs through board positions with heavy markup.
+// -----------------------------------------------------------------------------
+- (void) testBoardPositionScrubbing
+{
+  XCUIElement* previousButton = [self.uiElementFinder findBoardPositionNavigationButton:BoardPositionNavigationButtonPrevious
+                                                                      withUiApplication:self.app];
+  XCUIElement* nextButton = [self.uiElementFinder findBoardPositionNavigationButton:BoardPositionNavigationButtonNext
+                                                                  withUiApplication:self.app];
+  XCTAssertTrue(previousButton.exists);
+  XCTAssertTrue(nextButton.exists);
+
+  // After the game is restored the last board position of the main line is
+  // the current board position. Scrubbing backwards and then forwards again
+  // leaves the app in the same state after each measurement iteration.
+  [self measureWithMetrics:[self metricsWithScrollingAndDeceleration:false]
+                   options:[self measureOptions]
+                     block:^
+  {
+    for (int boardPosition = 0; boardPosition < numberOfScrubbedBoardPositions; ++boardPosition)
+      [previousButton tap];
+    for (int boardPosition = 0; boardPosition < numberOfScrubbedBoardPositions; ++boardPosition)
+      [nextButton tap];
+  }];
+}
+
+#pragma mark - Private helpers
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the node tree view. Skips the test if the
+/// node tree view is not displayed on the device that runs the test.
+// -----------------------------------------------------------------------------
+- (XCUIElement*) findNodeTreeView
+{
+  XCUIElement* nodeTreeView = [self.uiElementFinder findNodeTreeViewWithUiApplication:self.app];
+  if (! [nodeTreeView waitForExistenceWithTimeout:10])
+    XCTSkip(@"The node tree view is not displayed on this device");
+  return nodeTreeView;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the metrics to measure. Includes the frame
+/// rate and hitch metrics if @a scrollingAndDeceleration is true.
+// -----------------------------------------------------------------------------
+- (NSArray<id<XCTMetric>>*) metricsWithScrollingAndDeceleration:(bool)scrollingAndDeceleration
+{
+  NSMutableArray<id<XCTMetric>>* metrics = [NSMutableArray array];
+
+  if (scrollingAndDeceleration)
+    [metrics addObject:XCTOSSignpostMetric.scrollingAndDecelerationMetric];
+
+  [metrics addObject:[[XCTOSSignpostMetric alloc] initWithSubsystem:drawingSignpostSubsystem
+                                                            category:drawingSignpostCategory
+                                                                name:boardViewDrawLayerSignpostName]];
+  [metrics addObject:[[XCTOSSignpostMetric alloc] initWithSubsystem:drawingSignpostSubsystem
+                                                            category:drawingSignpostCategory
+                                                                name:nodeTreeViewDrawLayerSignpostName]];
+  [metrics addObject:[[XCTClockMetric alloc] init]];
+
+  return metrics;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the options to use for measuring.
+// -----------------------------------------------------------------------------
+- (XCTMeasureOptions*) measureOptions
+{
+  XCTMeasureOptions* options = [XCTMeasureOptions defaultOptions];
+  options.iterationCount = 5;
+  return options;
+}
+
+#pragma mark - Private helpers - Game generation
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Generates the SGF content of the game that is used
+/// by all tests.
+///
+/// All moves are chosen from a checkerboard pattern so that stones never touch
+/// each other. As a result no stones are ever captured and every move is
+/// legal. Black plays in the lower half of the board, White in the upper half,
+/// the row in the middle of the board always remains empty.
+// -----------------------------------------------------------------------------
+- (NSString*) generateSgfContent
+{
+  NSArray<NSString*>* blackPoints = [self movePointsInRowsFrom:0 to:boardDimension / 2 - 1];
+  NSArray<NSString*>* whitePoints = [self movePointsInRowsFrom:boardDimension / 2 + 1 to:boardDimension - 1];
+  NSArray<NSString*>* markupPoints = [self markupPoints];
+
+  // The moves of the main line consume the move points from the front
+  NSMutableArray<NSString*>* mainLineNodes = [NSMutableArray array];
+  for (int moveIndex = 0; moveIndex < mainLineLength; ++moveIndex)
+  {
+    bool isBlackMove = (moveIndex % 2 == 0);
+    NSArray<NSString*>* movePoints = isBlackMove ? blackPoints : whitePoints;
+    NSString* movePoint = movePoints[moveIndex / 2];
+    NSString* node = [NSString stringWithFormat:@";%@[%@]%@",
+                      isBlackMove ? @"B" : @"W",
+                      movePoint,
+                      [self markupForNodeAtIndex:moveIndex markupPoints:markupPoints]];
+    [mainLineNodes addObject:node];
+  }
+
+  // The moves of a variation consume the move points from the back. Because
+  // variations branch off early enough, the points that a variation uses are
+  // never occupied in the board position where the variation branches off.
+  NSMutableDictionary<NSNumber*, NSMutableArray<NSString*>*>* variationsByMoveIndex = [NSMutableDictionary dictionary];
+  for (int variationIndex = 0; variationIndex < numberOfVariations; ++variationIndex)
+  {
+    // 7 and maximumBranchingBoardPosition are coprime, so the branching
+    // positions spread evenly over the early part of the main line
+    int firstMoveIndex = (variationIndex * 7) % maximumBranchingBoardPosition;
+
+    NSMutableString* variation = [NSMutableString stringWithString:@"("];
+    for (int variationMoveIndex = 0; variationMoveIndex < variationLength; ++variationMoveIndex)
+    {
+      int moveIndex = firstMoveIndex + variationMoveIndex;
+      bool isBlackMove = (moveIndex % 2 == 0);
+      NSArray<NSString*>* movePoints = isBlackMove ? blackPoints : whitePoints;
+      NSString* movePoint = movePoints[movePoints.count - 1 - variationMoveIndex / 2];
+      [variation appendFormat:@";%@[%@]", isBlackMove ? @"B" : @"W", movePoint];
+    }
+    [variation appendString:@")"];
+
+    NSMutableArray<NSString*>* variations = variationsByMoveIndex[@(firstMoveIndex)];
+    if (! variations)
+    {
+      variations = [NSMutableArray array];
+      variationsByMoveIndex[@(firstMoveIndex)] = variations;
+    }
+    [variations addObject:variation];
+  }
+
+  // In SGF a variation is written after the sub-tree that contains the
+  // remainder of the main line
+  NSMutableString* sgfContent = [NSMutableString stringWithFormat:@"(;FF[4]GM[1]CA[UTF-8]SZ[%d]KM[6.5]", boardDimension];
+  NSMutableArray<NSArray<NSString*>*>* pendingVariations = [NSMutableArray array];
+  for (int moveIndex = 0; moveIndex < mainLineLength; ++moveIndex)
+  {
+    NSArray<NSString*>* variations = variationsByMoveIndex[@(moveIndex)];
+    if (variations)
+    {
+      [sgfContent appendString:@"("];
+      [pendingVariations addObject:variations];
+    }
+    [sgfContent appendString:mainLineNodes[moveIndex]];
+  }
+  for (NSArray<NSString*>* variations in pendingVariations.reverseObjectEnumerator)
+  {
+    [sgfContent appendString:@")"];
+    for (NSString* variation in variations)
+      [sgfContent appendString:variation];
+  }
+  [sgfContent appendString:@")"];
+
+  return sgfContent;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the SGF points in rows @a firstRow to
+/// @a lastRow (zero-based, inclusive) whose coordinates add up to an even
+/// number.
+// -----------------------------------------------------------------------------
+- (NSArray<NSString*>*) movePointsInRowsFrom:(int)firstRow to:(int)lastRow
+{
+  NSMutableArray<NSString*>* points = [NSMutableArray array];
+  for (int row = firstRow; row <= lastRow; ++row)
+  {
+    for (int column = 0; column < boardDimension; ++column)
+    {
+      if ((column + row) % 2 == 0)
+        [points addObject:[self sgfPointWithColumn:column row:row]];
+    }
+  }
+  return points;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the SGF points whose coordinates add up to
+/// an odd number. These points never contain a stone.
+// -----------------------------------------------------------------------------
+- (NSArray<NSString*>*) markupPoints
+{
+  NSMutableArray<NSString*>* points = [NSMutableArray array];
+  for (int row = 0; row < boardDimension; ++row)
+  {
+    for (int column = 0; column < boardDimension; ++column)
+    {
+      if ((column + row) % 2 == 1)
+        [points addObject:[self sgfPointWithColumn:column row:row]];
+    }
+  }
+  return points;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the SGF markup properties of the node at
+/// index @a nodeIndex in the main line. Symbols and labels are placed on
+/// distinct points from @a markupPoints, the selection shifts from node to
+/// node so that every board position looks different.
+// -----------------------------------------------------------------------------
+- (NSString*) markupForNodeAtIndex:(int)nodeIndex markupPoints:(NSArray<NSString*>*)markupPoints
+{
+  static const int numberOfPointsPerSymbol = 4;
+  static const int numberOfLabels = 4;
+  NSArray<NSString*>* symbolProperties = @[@"CR", @"SQ", @"TR", @"MA"];
+
+  NSMutableString* markup = [NSMutableString string];
+  NSUInteger markupPointIndex = (nodeIndex * 11) % markupPoints.count;
+
+  for (NSString* symbolProperty in symbolProperties)
+  {
+    [markup appendString:symbolProperty];
+    for (int pointIndex = 0; pointIndex < numberOfPointsPerSymbol; ++pointIndex)
+    {
+      [markup appendFormat:@"[%@]", markupPoints[markupPointIndex]];
+      markupPointIndex = (markupPointIndex + 1) % markupPoints.count;
+    }
+  }
+
+  [markup appendString:@"LB"];
+  for (int labelIndex = 0; labelIndex < numberOfLabels; ++labelIndex)
+  {
+    [markup appendFormat:@"[%@:%d]", markupPoints[markupPointIndex], nodeIndex + labelIndex];
+    markupPointIndex = (markupPointIndex + 1) % markupPoints.count;
+  }
+
+  int middleRow = boardDimension / 2;
+  int column = nodeIndex % boardDimension;
+  int mirroredColumn = boardDimension - 1 - column;
+  [markup appendFormat:@"AR[%@:%@]LN[%@:%@]",
+   [self sgfPointWithColumn:column row:0],
+   [self sgfPointWithColumn:mirroredColumn row:boardDimension - 1],
+   [self sgfPointWithColumn:0 row:middleRow],
+   [self sgfPointWithColumn:boardDimension - 1 row:middleRow]];
+
+  // Every other node dims the entire board except the middle row
+  if (nodeIndex % 2 == 0)
+  {
+    [markup appendFormat:@"DD[%@:%@][%@:%@]",
+     [self sgfPointWithColumn:0 row:0],
+     [self sgfPointWithColumn:boardDimension - 1 row:middleRow - 1],
+     [self sgfPointWithColumn:0 row:middleRow + 1],
+     [self sgfPointWithColumn:boardDimension - 1 row:boardDimension - 1]];
+  }
+
+  return markup;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Private helper. Returns the SGF point with zero-based coordinates
+/// @a column and @a row.
+// -----------------------------------------------------------------------------
+- (NSString*) sgfPointWithColumn:(int)column row:(int)row
+{
+  return [NSString stringWithFormat:@"%c%c", 'a' + column, 'a' + row];
+}
+
+@end
@@ -43,6 +43,9 @@
 
 - (XCUIElement*) findStatusLabelWithUiApplication:(XCUIApplication*)app;
 
+- (XCUIElement*) findLineGridOnBoardWithSize:(enum GoBoardSize)boardSize withUiApplication:(XCUIApplication*)app;
+- (XCUIElement*) findNodeTreeViewWithUiApplication:(XCUIApplication*)app;
+
 - (XCUIElement*) findBoardPositionCellContainerWithUiApplication:(XCUIApplication*)app;
 - (NSArray<XCUIElement*>*) findBoardPositionCellsWithUiApplication:(XCUIApplication*)app;
 - (XCUIElement*) findTextLabelInBoardPositionCell:(XCUIElement*)boardPositionCell;
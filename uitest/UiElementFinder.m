@@ -154,6 +154,12 @@
     case MoreGameActionsButtonUpdatePlayerInfluence:
       buttonName = @"Update player influence";
       break;
+    case MoreGameActionsButtonSolveLifeAndDeath:
+      buttonName = @"Solve life & death";
+      break;
+    case MoreGameActionsButtonCompareVariations:
+      buttonName = @"Compare variations";
+      break;
     case MoreGameActionsButtonSetBlackToMove:
       buttonName = @"Set black to move";
       break;
@@ -361,6 +367,27 @@
   return statusLabel;
 }
 
+// -----------------------------------------------------------------------------
+/// @brief Returns the UI element that represents the line grid on a board with
+/// size @a boardSize.
+// -----------------------------------------------------------------------------
+- (XCUIElement*) findLineGridOnBoardWithSize:(enum GoBoardSize)boardSize withUiApplication:(XCUIApplication*)app
+{
+  UIAccessibilityElement* lineGridAccessibilityElement =
+    [AccessibilityUtility uiAccessibilityElementInContainer:self forLineGridWithSize:boardSize];
+  XCUIElement* lineGridUiElement = app.otherElements[lineGridAccessibilityElement.accessibilityIdentifier];
+  return lineGridUiElement;
+}
+
+// -----------------------------------------------------------------------------
+/// @brief Returns the node tree view.
+// -----------------------------------------------------------------------------
+- (XCUIElement*) findNodeTreeViewWithUiApplication:(XCUIApplication*)app
+{
+  XCUIElement* nodeTreeView = app.scrollViews[nodeTreeViewAccessibilityIdentifier];
+  return nodeTreeView;
+}
+
 // -----------------------------------------------------------------------------
 /// @brief Returns the container that lists board positions.
 // -----------------------------------------------------------------------------